@@ -0,0 +1,21 @@
+# Precompiles the Lua files of a data tree with luac, keeping their names,
+# so that the game loads them the same way without parsing them.
+# Only the files changed since the last run are compiled again.
+#
+# Usage: cmake -DLUAC=<luac> -DSOURCE_DIR=<data dir> -DBINARY_DIR=<output dir> -P precompile_lua.cmake
+
+FILE(GLOB_RECURSE LUA_FILES RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/*.lua")
+
+FOREACH(LUA_FILE ${LUA_FILES})
+    SET(OUTPUT_FILE "${BINARY_DIR}/${LUA_FILE}")
+    IF("${SOURCE_DIR}/${LUA_FILE}" IS_NEWER_THAN "${OUTPUT_FILE}")
+        GET_FILENAME_COMPONENT(OUTPUT_DIR "${OUTPUT_FILE}" PATH)
+        FILE(MAKE_DIRECTORY "${OUTPUT_DIR}")
+        # The debug information is kept for the script error messages.
+        EXECUTE_PROCESS(COMMAND "${LUAC}" -o "${OUTPUT_FILE}" "${SOURCE_DIR}/${LUA_FILE}"
+                        RESULT_VARIABLE LUAC_RESULT)
+        IF(NOT LUAC_RESULT EQUAL 0)
+            MESSAGE(FATAL_ERROR "Couldn't precompile ${LUA_FILE}")
+        ENDIF()
+    ENDIF()
+ENDFOREACH()
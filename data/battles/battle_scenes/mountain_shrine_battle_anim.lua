@@ -6,48 +6,34 @@ setfenv(1, ns);
 local Battle = nil
 local Script = nil
 
-local fire = nil
-local torch = nil
-local flare = nil
+local torch_color = vt_video.Color(0.85, 0.32, 0.0, 0.5);
+local flare_color = vt_video.Color(0.99, 1.0, 0.27, 0.3);
+local white_color = vt_video.Color(1.0, 1.0, 1.0, 0.7);
+
+-- Creates a layer drawn by the engine each frame.
+function _CreateLayer(image, x, y, blend_mode, color)
+    local layer = Script:CreateLayer(image, vt_mode_manager.ScriptSupervisor.SCRIPT_LAYER_BACKGROUND);
+    layer:SetPosition(x, y);
+    layer:SetBlendMode(blend_mode);
+    layer:SetColor(color);
+end
 
 function Initialize(battle_instance)
     Battle = battle_instance;
     Script = Battle:GetScriptSupervisor();
 
-    fire = Script:CreateAnimation("data/entities/map/objects/flame1.lua");
+    local fire = Script:CreateAnimation("data/entities/map/objects/flame1.lua");
     fire:SetDimensions(32.0, 48.0);
-    torch = Script:CreateAnimation("data/visuals/lights/torch_light_mask2.lua");
+    local torch = Script:CreateAnimation("data/visuals/lights/torch_light_mask2.lua");
     torch:SetDimensions(340.0, 340.0);
-    flare = Script:CreateImage("data/visuals/lights/sun_flare_light.png");
+    local flare = Script:CreateImage("data/visuals/lights/sun_flare_light.png");
     flare:SetDimensions(154.0, 161.0);
-end
-
-
-function Update()
-    -- Updates the animations
-    fire:Update();
-    torch:Update();
-end
-
-local torch_color = vt_video.Color(0.85, 0.32, 0.0, 0.5);
-local flare_color = vt_video.Color(0.99, 1.0, 0.27, 0.3);
-local white_color = vt_video.Color(1.0, 1.0, 1.0, 0.7);
-
-function DrawBackground()
-    Script:SetDrawFlag(vt_video.GameVideo.VIDEO_BLEND);
-    VideoManager:Move(95.0, 25.0);
-    fire:Draw(white_color);
-    VideoManager:Move(688.0, 25.0);
-    fire:Draw(white_color);
-
-    Script:SetDrawFlag(vt_video.GameVideo.VIDEO_BLEND_ADD);
-    VideoManager:Move(-50.0, -50.0);
-    torch:Draw(torch_color);
-    VideoManager:Move(540.0, -50.0);
-    torch:Draw(torch_color);
 
-    VideoManager:Move(30.0, -20.0);
-    flare:Draw(flare_color);
-    VideoManager:Move(620.0, -20.0);
-    flare:Draw(flare_color);
+    -- The layers are updated and drawn natively, and their animations updated once per frame.
+    _CreateLayer(fire, 95.0, 25.0, vt_video.GameVideo.VIDEO_BLEND, white_color);
+    _CreateLayer(fire, 688.0, 25.0, vt_video.GameVideo.VIDEO_BLEND, white_color);
+    _CreateLayer(torch, -50.0, -50.0, vt_video.GameVideo.VIDEO_BLEND_ADD, torch_color);
+    _CreateLayer(torch, 540.0, -50.0, vt_video.GameVideo.VIDEO_BLEND_ADD, torch_color);
+    _CreateLayer(flare, 30.0, -20.0, vt_video.GameVideo.VIDEO_BLEND_ADD, flare_color);
+    _CreateLayer(flare, 620.0, -20.0, vt_video.GameVideo.VIDEO_BLEND_ADD, flare_color);
 end
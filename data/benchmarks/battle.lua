@@ -0,0 +1,36 @@
+-- Benchmark scenario: A full party fights a large group of enemies, in auto battle.
+-- See src/engine/benchmark.h for the scenario values.
+
+frames = 1800
+warmup_frames = 120
+update_time = 16
+
+function StartBenchmark()
+    local character_handler = GlobalManager:GetCharacterHandler()
+    character_handler:AddCharacter(BRONANN)
+    character_handler:AddCharacter(KALYA)
+    character_handler:AddCharacter(SYLVE)
+    character_handler:AddCharacter(THANIS)
+
+    -- The party must survive the whole benchmark.
+    for _, id in pairs({ BRONANN, KALYA, SYLVE, THANIS }) do
+        local character = character_handler:GetCharacter(id)
+        character:SetMaxHitPoints(9999)
+        character:SetHitPoints(9999)
+    end
+
+    local battle = vt_battle.BattleMode()
+    battle:AddEnemy(1, 0, 0)
+    battle:AddEnemy(2, 0, 0)
+    battle:AddEnemy(4, 0, 0)
+    battle:AddEnemy(5, 0, 0)
+    battle:AddEnemy(1, 0, 0)
+    battle:AddEnemy(2, 0, 0)
+    battle:AddEnemy(4, 0, 0)
+    battle:AddEnemy(5, 0, 0)
+    battle:GetScriptSupervisor():AddScript("data/battles/battle_scenes/desert_cave_battle_anim.lua")
+    GlobalManager:GetBattleMedia():SetBackgroundImage("data/battles/battle_scenes/desert_cave/desert_cave.png")
+    battle:SetAutoBattleActive(true)
+
+    ModeManager:Push(battle, false, false)
+end
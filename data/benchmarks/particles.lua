@@ -0,0 +1,12 @@
+-- Benchmark scenario: Many particle effects running at once on a map.
+-- See src/engine/benchmark.h for the scenario values.
+
+frames = 1800
+warmup_frames = 120
+update_time = 16
+
+function StartBenchmark()
+    local map_mode = vt_map.MapMode("data/story/ep1/layna_forest/layna_forest_crystal_map.lua",
+                                    "data/benchmarks/subscripts/particles_script.lua");
+    ModeManager:Push(map_mode, false, false);
+end
@@ -0,0 +1,58 @@
+-- Set the namespace according to the map name.
+local ns = {};
+setmetatable(ns, {__index = _G});
+dialogue_script = ns;
+setfenv(1, ns);
+
+-- The map name, subname and location image
+map_name = ""
+map_image_filename = ""
+map_subname = ""
+
+-- The music file used as default background music on this map.
+music_filename = "data/sounds/wind.ogg"
+
+-- c++ objects instances
+local Map = nil
+local EventManager = nil
+
+local bronann = nil
+
+-- the main map loading code
+function Load(m)
+
+    Map = m;
+    EventManager = Map:GetEventSupervisor();
+
+    Map:SetUnlimitedStamina(true)
+    Map:SetRunningEnabled(false) -- Hide the stamina bar
+
+    bronann = CreateSprite(Map, "Bronann", 32, 43, vt_map.MapMode.GROUND_OBJECT);
+    bronann:SetDirection(vt_map.MapMode.SOUTH);
+
+    _CreateEvents();
+
+    Map:SetCamera(bronann);
+    Map:PushState(vt_map.MapMode.STATE_SCENE);
+
+    EventManager:StartEvent("Bronann speaks");
+end
+
+-- Creates the dialogue, looping on itself.
+function _CreateEvents()
+    local event = nil
+    local text = nil
+    local dialogue = nil
+
+    -- The lines go on by themselves, and are long enough to wrap on several lines.
+    dialogue = vt_map.SpriteDialogue.Create();
+    dialogue:SetInputBlocked(true);
+    text = "Dear chosen one, the time has finally come. For us, it will be but an instant. For you, it might be decades.";
+    dialogue:AddLineTimed(text, bronann, 2000);
+    text = "May you bring a happy end to this foolish destiny of ours. The crystal shines brighter than ever before, and the forest is quiet.";
+    dialogue:AddLineTimed(text, bronann, 2000);
+    text = "As you wish. Follow me. We'll have to cross the whole forest before the night falls, and the path is long.";
+    dialogue:AddLineTimed(text, bronann, 2000);
+    event = vt_map.DialogueEvent.Create("Bronann speaks", dialogue);
+    event:AddEventLinkAtEnd("Bronann speaks");
+end
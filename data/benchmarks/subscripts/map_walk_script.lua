@@ -0,0 +1,71 @@
+-- Set the namespace according to the map name.
+local ns = {};
+setmetatable(ns, {__index = _G});
+map_walk_script = ns;
+setfenv(1, ns);
+
+-- The map name, subname and location image
+map_name = ""
+map_image_filename = ""
+map_subname = ""
+
+-- The music file used as default background music on this map.
+music_filename = "data/sounds/wind.ogg"
+
+-- c++ objects instances
+local Map = nil
+local EventManager = nil
+
+local bronann = nil
+
+-- The path walked over and over, as map coordinates.
+local walk_path = {
+    { 32, 43 },
+    { 50, 45 },
+    { 60, 62 },
+    { 42, 75 },
+    { 20, 64 },
+    { 14, 48 },
+}
+
+-- the main map loading code
+function Load(m)
+
+    Map = m;
+    EventManager = Map:GetEventSupervisor();
+
+    Map:SetUnlimitedStamina(true)
+    Map:SetRunningEnabled(false) -- Hide the stamina bar
+
+    bronann = CreateSprite(Map, "Bronann", walk_path[1][1], walk_path[1][2], vt_map.MapMode.GROUND_OBJECT);
+    bronann:SetDirection(vt_map.MapMode.SOUTH);
+    bronann:SetMovementSpeed(vt_map.MapMode.NORMAL_SPEED);
+
+    _CreateEvents();
+
+    -- Add clouds overlay
+    Map:GetEffectSupervisor():EnableAmbientOverlay("data/visuals/ambient/clouds.png", 15.0, -5.0, true);
+
+    -- Set the camera focus on Bronann
+    Map:SetCamera(bronann);
+
+    -- A scene map only
+    Map:PushState(vt_map.MapMode.STATE_SCENE);
+
+    EventManager:StartEvent("Walk 1");
+end
+
+-- Creates the walk events, the last one looping to the first one.
+function _CreateEvents()
+    local event = nil
+
+    for index, point in ipairs(walk_path) do
+        local next_index = index + 1;
+        if (next_index > #walk_path) then
+            next_index = 1;
+        end
+        event = vt_map.PathMoveSpriteEvent.Create("Walk " .. index, bronann,
+                                                  walk_path[next_index][1], walk_path[next_index][2], false);
+        event:AddEventLinkAtEnd("Walk " .. next_index);
+    end
+end
@@ -0,0 +1,49 @@
+-- Set the namespace according to the map name.
+local ns = {};
+setmetatable(ns, {__index = _G});
+particles_script = ns;
+setfenv(1, ns);
+
+-- The map name, subname and location image
+map_name = ""
+map_image_filename = ""
+map_subname = ""
+
+-- The music file used as default background music on this map.
+music_filename = "data/sounds/wind.ogg"
+
+-- c++ objects instances
+local Map = nil
+
+local bronann = nil
+
+-- The particle effects spread around the camera.
+local particle_effects = {
+    "data/visuals/particle_effects/fireflies.lua",
+    "data/visuals/particle_effects/waterfall_steam.lua",
+    "data/visuals/particle_effects/bubble_steam.lua",
+    "data/visuals/particle_effects/heal_particle.lua",
+}
+
+-- the main map loading code
+function Load(m)
+
+    Map = m;
+
+    Map:SetUnlimitedStamina(true)
+    Map:SetRunningEnabled(false) -- Hide the stamina bar
+
+    bronann = CreateSprite(Map, "Bronann", 32, 43, vt_map.MapMode.GROUND_OBJECT);
+    bronann:SetDirection(vt_map.MapMode.SOUTH);
+
+    -- A grid of effects covering the screen
+    for x = 0, 7 do
+        for y = 0, 5 do
+            local effect = particle_effects[((x + y) % #particle_effects) + 1];
+            vt_map.ParticleObject.Create(effect, 14 + x * 5, 30 + y * 5, vt_map.MapMode.GROUND_OBJECT);
+        end
+    end
+
+    Map:SetCamera(bronann);
+    Map:PushState(vt_map.MapMode.STATE_SCENE);
+end
@@ -0,0 +1,3155 @@
+-- Generated by tools/gen-asset-manifest.py: Edit the map scripts, or record the assets, instead.
+
+asset_manifest = {
+    ["battle:data/story/ep1/layna_forest/layna_forest_cave1_1_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_cave1_2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_cave2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_entrance_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/battles/battle_scenes/forest_background_evening.png",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight_battles.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_north_east_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/battles/battle_scenes/forest_background_evening.png",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight_battles.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_north_west_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/battles/battle_scenes/forest_background_evening.png",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight_battles.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_south_east_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/battles/battle_scenes/forest_background_evening.png",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight_battles.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_forest/layna_forest_south_west_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/battles/battle_scenes/forest_background_evening.png",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight_battles.lua",
+        },
+    },
+    ["battle:data/story/ep1/layna_village/layna_village_well_underground_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/entities/portraits/bronann.png",
+            "data/gui/menus/hand.png",
+            "data/gui/menus/hand_down.png",
+            "data/visuals/ambient/fog.png",
+            "data/visuals/lights/sun_flare_light.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+            "data/battles/battle_scenes/oil_lamp.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/common/lost_in_darkness.lua",
+            "data/story/ep1/layna_village/tutorial_battle_dialogs.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_cave1_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_cave2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_cave3_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_path1_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_background.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/dark_soldier.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/ripples.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/rain.lua",
+        },
+        sounds = {
+            "data/sounds/thunder.wav",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/common/rain_in_battles_script.lua",
+            "data/story/common/soft_lightnings_script.lua",
+            "data/story/ep1/mt_elbrus/battle_with_dark_soldiers_script.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_path2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_background.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/ripples.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/rain.lua",
+        },
+        sounds = {
+            "data/sounds/thunder.wav",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/common/rain_in_battles_script.lua",
+            "data/story/common/soft_lightnings_script.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_path3_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_background.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/ripples.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/rain.lua",
+        },
+        sounds = {
+            "data/sounds/thunder.wav",
+        },
+        music = {
+            "data/music/Welcome to Com-Mecha-Mattew_Pablo_OGA.ogg",
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/common/rain_in_battles_script.lua",
+            "data/story/common/soft_lightnings_script.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/visuals/lights/sun_flare_light.png",
+        },
+        animations = {
+            "data/entities/map/objects/flame1.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_shrine3_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/visuals/lights/sun_flare_light.png",
+        },
+        animations = {
+            "data/entities/map/objects/flame1.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/battles_in_trap_map_script.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_shrine5_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/visuals/lights/sun_flare_light.png",
+        },
+        animations = {
+            "data/entities/map/objects/flame1.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_shrine6_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/visuals/lights/sun_flare_light.png",
+        },
+        animations = {
+            "data/entities/map/objects/flame1.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_ne_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/visuals/lights/sun_flare_light.png",
+        },
+        animations = {
+            "data/entities/map/objects/flame1.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/battles/battle_scenes/rock.png",
+            "data/visuals/ambient/fog.png",
+        },
+        animations = {
+            "data/battles/battle_scenes/desert_cave/desert_cave_creatures.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes1.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_eyes2.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_water.lua",
+            "data/battles/battle_scenes/desert_cave/desert_cave_waterdrop.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+        },
+    },
+    ["battle:data/story/ep2/overworld/present/dev_overworld_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/plains_background.png",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_cave1_1_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/desert_cave.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_cave1_1_minimap.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+            "data/entities/map/triggers/stone_trigger1_off.lua",
+            "data/entities/map/triggers/stone_trigger1_on.lua",
+            "data/gui/map/heal_anim.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+        },
+        sounds = {
+            "data/sounds/cave-in.ogg",
+            "data/sounds/falling_tree.ogg",
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/shrine-OGA-yd.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_caves_background_anim.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_cave1_2_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/desert_cave.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_cave1_2_minimap.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock3.lua",
+            "data/entities/map/objects/stone_sign1.lua",
+            "data/gui/map/exit_anim.lua",
+            "data/visuals/lights/right_ray_light.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        sounds = {
+            "data/sounds/cave-in.ogg",
+        },
+        music = {
+            "data/music/shrine-OGA-yd.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/layna_forest_cave1_1_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_1_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_stone_sign_image.lua",
+            "data/story/ep1/layna_forest/layna_forest_caves_background_anim.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_wolf_cave_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_wolf_cave_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_cave2_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/desert_cave.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        music = {
+            "data/music/shrine-OGA-yd.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/layna_forest_crystal_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_crystal_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_crystal_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/boot_menu/ep1/crystal.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/enemies/fenrir_spritesheet.png",
+            "data/entities/map/npcs/crystal_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/layna_forest.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/gui/map/exit_anim.lua",
+            "data/gui/map/heal_anim.lua",
+            "data/visuals/lights/sun_flare_light_secondary.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+            "data/visuals/particle_effects/inactive_save_point.lua",
+        },
+        sounds = {
+            "data/sounds/crystal_chime.wav",
+            "data/sounds/heal_spell.wav",
+            "data/sounds/rumble.wav",
+            "data/sounds/wind.ogg",
+            "data/story/ep1/layna_forest/crystal_appearance/crystal-sentence1.ogg",
+            "data/story/ep1/layna_forest/crystal_appearance/crystal-sentence2.ogg",
+            "data/story/ep1/layna_forest/crystal_appearance/crystal-sentence3.ogg",
+            "data/story/ep1/layna_forest/crystal_appearance/crystal-sentence4.ogg",
+            "data/story/ep1/layna_forest/crystal_appearance/crystal-sentence5.ogg",
+            "data/story/ep1/layna_forest/crystal_appearance/crystal-sentence6.ogg",
+        },
+        music = {
+            "data/music/Zander Noriega - School of Quirks.ogg",
+            "data/music/accion-OGA-djsaryon.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight.lua",
+            "data/story/ep1/layna_forest/crystal_appearance/layna_forest_crystal_appearance_anim.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave2_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave2_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_entrance_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/map/scening/squirrel_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/layna_forest.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_entrance_minimap.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_little1.lua",
+            "data/entities/map/objects/tree_little2.lua",
+            "data/entities/map/objects/tree_little3.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/entities/map/objects/tree_small2.lua",
+            "data/entities/map/objects/tree_small3.lua",
+            "data/entities/map/objects/tree_small4.lua",
+            "data/entities/map/objects/tree_small5.lua",
+            "data/entities/map/objects/tree_small6.lua",
+            "data/entities/map/objects/tree_tiny3.lua",
+            "data/entities/map/objects/tree_tiny4.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+            "data/gui/map/heal_anim.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/fireflies.lua",
+            "data/visuals/particle_effects/heal_particle.lua",
+        },
+        sounds = {
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/forest_at_night.ogg",
+            "data/music/house_in_a_forest_loop_horrorpen_oga.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_at_night_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_north_east_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/enemies/fenrir_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/map/scening/squirrel_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/layna_forest.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_north_east_minimap.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+        },
+        sounds = {
+            "data/sounds/footstep_grass1.wav",
+            "data/sounds/growl1_IFartInUrGeneralDirection_freesound.wav",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/house_in_a_forest_loop_horrorpen_oga.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_north_west_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/forest_background.png",
+            "data/battles/battle_scenes/forest_background_evening.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/map/scening/squirrel_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/layna_forest.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_north_west_minimap.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/tree_small3.lua",
+            "data/entities/map/objects/tree_small3_tilting.lua",
+            "data/entities/map/objects/tree_small4.lua",
+            "data/entities/map/objects/tree_small5.lua",
+            "data/entities/map/objects/tree_small5_fallen.lua",
+            "data/entities/map/objects/tree_small6.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+            "data/music/house_in_a_forest_loop_horrorpen_oga.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight.lua",
+            "data/story/ep1/layna_forest/after_crystal_twilight_battles.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_1_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_1_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_entrance_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_entrance_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_east_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_west_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_west_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_south_east_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/npcs/friendly_mushroom_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/map/scening/squirrel_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/layna_forest.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_south_east_minimap.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+            "data/gui/map/heal_anim.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+        },
+        sounds = {
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/house_in_a_forest_loop_horrorpen_oga.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave2_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave2_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_east_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_west_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_west_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_wolf_cave_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_wolf_cave_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_south_west_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/map/scening/squirrel_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/layna_forest.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_south_west_minimap.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+        },
+        music = {
+            "data/music/house_in_a_forest_loop_horrorpen_oga.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/after_crystal_twilight.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_north_west_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_forest/layna_forest_wolf_cave_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/enemies/fenrir_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/desert_cave.png",
+            "data/story/ep1/layna_forest/minimaps/layna_forest_wolf_cave_minimap.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/story/ep1/layna_forest/wolfpain_necklace.lua",
+            "data/visuals/lights/light_reverb.lua",
+            "data/visuals/lights/right_ray_light.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_sp_particle.lua",
+        },
+        sounds = {
+            "data/sounds/fountain_small.ogg",
+            "data/sounds/growl1_IFartInUrGeneralDirection_freesound.wav",
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/shrine-OGA-yd.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_cave1_2_script.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_south_east_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_bronanns_home_first_floor_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_bed_animation.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bed1.lua",
+            "data/entities/map/objects/bed2.lua",
+            "data/entities/map/objects/book1.lua",
+            "data/entities/map/objects/box1.lua",
+            "data/entities/map/objects/candle1.lua",
+            "data/entities/map/objects/chair1.lua",
+            "data/entities/map/objects/chair1_inverted.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/paper_feather.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/cloth_sound.wav",
+        },
+        music = {
+            "data/music/koertes-ccby-birdsongloop16s.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/in_game_move_and_interact_anim.lua",
+            "data/story/ep1/layna_village/layna_village_bronanns_home_map.lua",
+            "data/story/ep1/layna_village/layna_village_bronanns_home_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_bronanns_home_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/npcs/story/carson_spritesheet.png",
+            "data/entities/map/npcs/story/malta_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/npcs/carson.png",
+            "data/entities/portraits/npcs/malta.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/bread1.lua",
+            "data/entities/map/objects/chair1.lua",
+            "data/entities/map/objects/chair1_inverted.lua",
+            "data/entities/map/objects/chair1_north.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/green_pepper1.lua",
+            "data/entities/map/objects/knife1.lua",
+            "data/entities/map/objects/plate_pile1.lua",
+            "data/entities/map/objects/salad1.lua",
+            "data/entities/map/objects/sauce_pot1.lua",
+            "data/entities/map/objects/table1.lua",
+            "data/entities/map/objects/vase1.lua",
+            "data/entities/map/objects/wooden_sword1.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+            "data/sounds/rumble.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_bronanns_home_first_floor_map.lua",
+            "data/story/ep1/layna_village/layna_village_bronanns_home_first_floor_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_center_at_night_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/entities/map/objects/tree_small2.lua",
+            "data/entities/map/objects/vase1.lua",
+            "data/entities/map/objects/well.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+        },
+        music = {
+            "data/music/Welcome to Com-Mecha-Mattew_Pablo_OGA.ogg",
+            "data/music/forest_at_night.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_script.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_at_night_script.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_center_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/carson_spritesheet.png",
+            "data/entities/map/npcs/story/herth_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/carson.png",
+            "data/entities/portraits/npcs/herth.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/cat1.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/entities/map/objects/tree_small2.lua",
+            "data/entities/map/objects/vase1.lua",
+            "data/entities/map/objects/well.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/sun_flare_light_secondary.lua",
+            "data/visuals/lights/sun_flare_light_small_main.lua",
+            "data/visuals/lights/sun_flare_light_small_secondary.lua",
+        },
+        sounds = {
+            "data/sounds/cave-in.ogg",
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+            "data/sounds/meow.wav",
+            "data/sounds/rumble.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/credits/episode1_credits.lua",
+            "data/story/ep1/layna_forest/layna_forest_entrance_map.lua",
+            "data/story/ep1/layna_forest/layna_forest_entrance_script.lua",
+            "data/story/ep1/layna_village/layna_village_bronanns_home_map.lua",
+            "data/story/ep1/layna_village/layna_village_bronanns_home_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_shop_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_shop_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_sophia_house_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_sophia_house_script.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_script.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_map.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_script.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_script.lua",
+            "data/story/ep1/layna_village/layna_village_well_underground_map.lua",
+            "data/story/ep1/layna_village/layna_village_well_underground_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_center_shop_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/flower_pot2.lua",
+            "data/entities/map/objects/table1.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+            "data/story/ep1/layna_village/tutorial_shop_dialogs.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_center_sophia_house_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bed1.lua",
+            "data/entities/map/objects/chair1_inverted.lua",
+            "data/entities/map/objects/flower_pot2.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_kalya_house_exterior_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/scening/chicken_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/entities/map/objects/tree_small2.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/gentle_stream.ogg",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/credits/episode1_credits.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_kalya_house_path_at_night_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/bench1.lua",
+            "data/entities/map/objects/fence1-horizontal.lua",
+            "data/entities/map/objects/fence1-l-bottom-left.lua",
+            "data/entities/map/objects/fence1-l-bottom-right.lua",
+            "data/entities/map/objects/fence1-l-top-left.lua",
+            "data/entities/map/objects/fence1-l-top-right.lua",
+            "data/entities/map/objects/fence1-vertical.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/entities/map/objects/tree_small2.lua",
+        },
+        music = {
+            "data/music/Welcome to Com-Mecha-Mattew_Pablo_OGA.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_kalya_house_path_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/scening/chicken_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/bench1.lua",
+            "data/entities/map/objects/fence1-horizontal.lua",
+            "data/entities/map/objects/fence1-l-bottom-left.lua",
+            "data/entities/map/objects/fence1-l-bottom-right.lua",
+            "data/entities/map/objects/fence1-l-top-left.lua",
+            "data/entities/map/objects/fence1-l-top-right.lua",
+            "data/entities/map/objects/fence1-vertical.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/entities/map/objects/tree_small2.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/credits/episode1_credits.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_exterior_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_exterior_script.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_small_house_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_small_house_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_kalya_house_path_small_house_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bed1.lua",
+            "data/entities/map/objects/box1.lua",
+            "data/entities/map/objects/chair1_inverted.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/flower_pot2.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_kalya_house_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/story/ep1/layna_village/kalya_house_fake_wall.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/box1.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/cave-in.ogg",
+            "data/sounds/menu_click_01.wav",
+        },
+        music = {
+            "data/music/Welcome to Com-Mecha-Mattew_Pablo_OGA.ogg",
+            "data/music/sad_moment.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_path1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path1_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_riverbank_at_night_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_village_single_house.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/carson_spritesheet.png",
+            "data/entities/map/npcs/story/herth_spritesheet.png",
+            "data/entities/map/npcs/story/malta_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/carson.png",
+            "data/entities/portraits/npcs/herth.png",
+            "data/entities/portraits/npcs/malta.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/campfire1.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/fireflies.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/door_close.wav",
+            "data/sounds/gentle_stream.ogg",
+        },
+        music = {
+            "data/music/Welcome to Com-Mecha-Mattew_Pablo_OGA.ogg",
+            "data/music/the_recon_mission.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/ep1/layna_village/battle_with_banesore/battle_with_banesore_script.lua",
+            "data/story/ep1/layna_village/battle_with_banesore/show_crystals_script.lua",
+            "data/story/ep1/layna_village/battle_with_banesore/show_smoke_cloud_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_at_night_script.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_at_night_script.lua",
+            "data/story/ep1/layna_village/layna_village_kalya_house_path_map.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_at_night_script.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_map.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_riverbank_house_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/scening/chicken_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/bed1.lua",
+            "data/entities/map/objects/bench2.lua",
+            "data/entities/map/objects/box1.lua",
+            "data/entities/map/objects/candle1.lua",
+            "data/entities/map/objects/chair1.lua",
+            "data/entities/map/objects/chair1_inverted.lua",
+            "data/entities/map/objects/clock1.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/table1.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_riverbank_map.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_riverbank_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/barrel1.lua",
+            "data/entities/map/objects/dog1.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/entities/map/objects/tree_big2.lua",
+            "data/entities/map/objects/tree_small1.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/sun_flare_light_secondary.lua",
+            "data/visuals/lights/sun_flare_light_small_main.lua",
+            "data/visuals/lights/sun_flare_light_small_secondary.lua",
+        },
+        sounds = {
+            "data/sounds/dog_barking.wav",
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+            "data/sounds/gentle_stream.ogg",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/credits/episode1_credits.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_house_map.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_house_script.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_south_entrance_left_house_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bed1.lua",
+            "data/entities/map/objects/box1.lua",
+            "data/entities/map/objects/chair1.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/paper_feather.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_south_entrance_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_south_entrance_right_house_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bed1.lua",
+            "data/entities/map/objects/box1.lua",
+            "data/entities/map/objects/candle1.lua",
+            "data/entities/map/objects/chair1.lua",
+            "data/entities/map/objects/flower_pot1.lua",
+            "data/entities/map/objects/wooden_table_small.lua",
+            "data/visuals/lights/left_window_light.lua",
+            "data/visuals/lights/right_window_light.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_village/layna_village_south_entrance_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_south_entrance_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/npcs/story/herth_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/map/scening/chicken_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/npcs/herth.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_village.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/tree_big1.lua",
+            "data/visuals/lights/sun_flare_light_small_main.lua",
+            "data/visuals/lights/sun_flare_light_small_secondary.lua",
+        },
+        sounds = {
+            "data/sounds/door_close.wav",
+            "data/sounds/door_open2.wav",
+        },
+        music = {
+            "data/music/Caketown_1-OGA-mat-pablo.ogg",
+        },
+        scripts = {
+            "data/credits/episode1_credits.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_map.lua",
+            "data/story/ep1/layna_village/layna_village_riverbank_script.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_left_house_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_left_house_script.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_right_house_map.lua",
+            "data/story/ep1/layna_village/layna_village_south_entrance_right_house_script.lua",
+        },
+    },
+    ["map:data/story/ep1/layna_village/layna_village_well_underground_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_village.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/oil_lamp.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/wood_sign_info.lua",
+            "data/gui/map/heal_anim.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+        },
+        sounds = {
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/shrine-OGA-yd.ogg",
+        },
+        scripts = {
+            "data/story/common/lost_in_darkness.lua",
+            "data/story/ep1/layna_village/layna_village_center_map.lua",
+            "data/story/ep1/layna_village/layna_village_center_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_cave1_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/enemies/spiky_mushroom.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/enemies/spiky_mushroom_dead.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        sounds = {
+            "data/sounds/footstep_grass2.wav",
+        },
+        music = {
+            "data/music/awareness_el_corleo.ogg",
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+            "data/music/rain_indoors.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path1_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_cave2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/enemies/spiky_mushroom.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/enemies/spiky_mushroom_dead.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_off.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_on.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        sounds = {
+            "data/sounds/cave-in.ogg",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+            "data/sounds/trigger_on.wav",
+        },
+        music = {
+            "data/music/awareness_el_corleo.ogg",
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+            "data/music/rain_indoors.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_cave3_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/enemies/spiky_mushroom.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/enemies/spiky_mushroom_dead.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_off.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_on.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        sounds = {
+            "data/sounds/cave-in.ogg",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/awareness_el_corleo.ogg",
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+            "data/music/rain_indoors.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_north_east_exit_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/particle_effects/outlined_circle_small.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+        },
+        particle_effects = {
+            "data/story/ep1/mt_elbrus/particles_fire_smoke.lua",
+        },
+        sounds = {
+            "data/sounds/wind.ogg",
+        },
+        music = {
+            "data/music/Zander Noriega - School of Quirks.ogg",
+            "data/music/sad_moment.ogg",
+        },
+        scripts = {
+            "data/credits/end_credits.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_landscape_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_basement_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_basement_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_path1_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/gui/map/heal_anim.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+            "data/visuals/particle_effects/rain.lua",
+        },
+        sounds = {
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/Ove Melaa - Rainy.ogg",
+            "data/music/awareness_el_corleo.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/common/soft_lightnings_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_cave1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_cave1_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_path2_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/friendly_mushroom_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/gui/map/heal_anim.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+            "data/visuals/particle_effects/rain.lua",
+        },
+        sounds = {
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/Ove Melaa - Rainy.ogg",
+            "data/music/awareness_el_corleo.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/common/soft_lightnings_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_cave2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_cave2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_cave3_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_cave3_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path1_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path3_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path3_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_path3_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_background.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/map/scening/butterfly_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/clouds.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/gate1_closed.lua",
+            "data/entities/map/objects/gate1_open.lua",
+            "data/entities/map/objects/harlequin.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/rock2.lua",
+            "data/gui/map/heal_anim.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+            "data/visuals/particle_effects/rain.lua",
+        },
+        sounds = {
+            "data/sounds/crystal_chime.wav",
+            "data/sounds/heal_spell.wav",
+            "data/sounds/opening_sword_unsheathe.wav",
+        },
+        music = {
+            "data/music/Ove Melaa - Rainy.ogg",
+            "data/music/Welcome to Com-Mecha-Mattew_Pablo_OGA.ogg",
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/awareness_el_corleo.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/common/rain_in_battles_script.lua",
+            "data/story/common/soft_lightnings_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path4_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path4_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_path4_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/snow_fog.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/bridge_down.lua",
+            "data/entities/map/objects/bridge_middle.lua",
+            "data/entities/map/objects/bridge_up.lua",
+            "data/entities/map/objects/rock1.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/snow.lua",
+        },
+        sounds = {
+            "data/sounds/footstep_grass2.wav",
+            "data/sounds/heavy_bump.wav",
+            "data/sounds/sword_swipe.wav",
+            "data/sounds/wind.ogg",
+        },
+        music = {
+            "data/music/Zander Noriega - School of Quirks.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_background_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine1_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine1_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/friendly_mushroom_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/story/ep1/mt_elbrus/shrine_entrance_light.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/ancient_sign.lua",
+            "data/entities/map/objects/door_big1.lua",
+            "data/entities/map/objects/door_big1_open.lua",
+            "data/entities/map/objects/door_big1_opening.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/gui/map/heal_anim.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/story/ep1/mt_elbrus/particles_snow_south_entrance.lua",
+            "data/visuals/particle_effects/fire_spiral.lua",
+            "data/visuals/particle_effects/heal_particle.lua",
+        },
+        sounds = {
+            "data/sounds/ancient_invocation.wav",
+            "data/sounds/campfire.ogg",
+            "data/sounds/cave-in.ogg",
+            "data/sounds/heal_spell.wav",
+            "data/sounds/heartbeat_slow.wav",
+        },
+        music = {
+            "data/music/icy_wind.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_path4_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path4_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua",
+            "data/story/ep1/mt_elbrus/shrine_entrance_show_crystal_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/enemies/skeleton_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/story/ep1/mt_elbrus/fake_wall.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/bubble.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/flame_pot1.lua",
+            "data/entities/map/objects/jar1.lua",
+            "data/entities/map/objects/parchment.lua",
+            "data/entities/map/objects/vase2.lua",
+            "data/entities/map/objects/vase3.lua",
+            "data/entities/map/objects/vase4.lua",
+            "data/entities/map/objects/water_light1.lua",
+            "data/entities/map/objects/waterfall2.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/bubble_steam.lua",
+            "data/visuals/particle_effects/waterfall_steam.lua",
+            "data/visuals/particle_effects/waterfall_steam_big.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/fountain_large.ogg",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_scent_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine1_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine3_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine3_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine4_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine4_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine9_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine9_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine3_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/story/ep1/mt_elbrus/spike_wall.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bones1.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/spikes_broken1.lua",
+            "data/entities/map/objects/stone_fence1.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        sounds = {
+            "data/sounds/battle_encounter_03.ogg",
+            "data/sounds/campfire.ogg",
+            "data/sounds/magic_blast.ogg",
+            "data/sounds/opening_sword_unsheathe.wav",
+            "data/sounds/rumble_continuous.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine9_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine9_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine4_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bubble.lua",
+            "data/entities/map/objects/dorver1_left.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/flame_pot1.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/water_light1.lua",
+            "data/entities/map/triggers/stone_trigger1_off.lua",
+            "data/entities/map/triggers/stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/bubble_steam.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/cave-in.ogg",
+            "data/sounds/opening_sword_unsheathe.wav",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_scent_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine5_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/candle_holder1.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/gate1_closed.lua",
+            "data/entities/map/objects/jar1.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/stone_fence1.lua",
+            "data/entities/map/objects/vase2.lua",
+            "data/entities/map/objects/vase3.lua",
+            "data/entities/map/objects/vase4.lua",
+            "data/entities/map/objects/waterfall1.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_off.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/waterfall_steam.lua",
+            "data/visuals/particle_effects/waterfall_steam_big.lua",
+        },
+        sounds = {
+            "data/sounds/bump.wav",
+            "data/sounds/campfire.ogg",
+            "data/sounds/falling.ogg",
+            "data/sounds/fountain_large.ogg",
+            "data/sounds/opening_sword_unsheathe.wav",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine6_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine6_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine8_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine8_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine6_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/candle_holder1.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/objects/stone_fence1.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_off.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+            "data/sounds/trigger_on.wav",
+        },
+        music = {
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine7_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine7_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine7_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/mountain_shrine.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/candle_holder1.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/jar1.lua",
+            "data/entities/map/objects/parchment.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/stone_fence1.lua",
+            "data/entities/map/objects/vase4.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/heroism-OGA-Edward-J-Blakeley.ogg",
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/mountain_shrine_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine6_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine6_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine8_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine8_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine8_script.lua"] = {
+        images = {
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/water_light1.lua",
+            "data/entities/map/objects/waterfall1.lua",
+            "data/entities/map/objects/waterfall2.lua",
+            "data/entities/map/triggers/stone_trigger1_off.lua",
+            "data/entities/map/triggers/stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/waterfall_steam.lua",
+            "data/visuals/particle_effects/waterfall_steam_big.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/fountain_large.ogg",
+            "data/sounds/trigger_on.wav",
+        },
+        music = {
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine7_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine7_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine8_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine8_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine9_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/story/ep1/mt_elbrus/falling_hole.png",
+            "data/story/ep1/mt_elbrus/falling_hole_above.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/gui/map/heal_anim.lua",
+            "data/visuals/lights/right_ray_light.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/heal_particle.lua",
+        },
+        sounds = {
+            "data/sounds/falling.ogg",
+            "data/sounds/heal_spell.wav",
+            "data/sounds/heavy_bump.wav",
+        },
+        music = {
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/layna_forest/layna_forest_caves_background_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine3_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine3_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_basement_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_basement_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_ne_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/candle_holder1.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/stone_fence1.lua",
+            "data/entities/map/objects/vase3.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_off.lua",
+            "data/entities/map/triggers/rolling_stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/story/ep1/mt_elbrus/particles_snow_south_entrance.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/opening_sword_unsheathe.wav",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s1_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s1_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/snow_fog.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/bridge_down.lua",
+            "data/entities/map/objects/bridge_middle.lua",
+            "data/entities/map/objects/bridge_up.lua",
+        },
+        particle_effects = {
+            "data/story/ep1/mt_elbrus/particles_snow_pushing.lua",
+            "data/visuals/particle_effects/snow.lua",
+        },
+        sounds = {
+            "data/sounds/falling.ogg",
+            "data/sounds/mountain_wind.ogg",
+            "data/sounds/wind.ogg",
+        },
+        scripts = {
+            "data/story/common/at_night.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_background_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path4_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_path4_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_ne_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_ne_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/objects/dorver1.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/rock1.lua",
+            "data/entities/map/objects/rolling_stone2.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/spikes_broken1.lua",
+            "data/entities/map/triggers/stone_trigger1_off.lua",
+            "data/entities/map/triggers/stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/story/ep1/mt_elbrus/particles_snow_south_entrance.lua",
+        },
+        sounds = {
+            "data/sounds/battle_encounter_03.ogg",
+            "data/sounds/campfire.ogg",
+            "data/sounds/cave-in.ogg",
+            "data/sounds/heavy_bump.wav",
+            "data/sounds/magic_blast.ogg",
+            "data/sounds/opening_sword_unsheathe.wav",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/icy_wind.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s1_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s1_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine_3rd_script.lua"] = {
+        images = {
+            "data/entities/map/enemies/andromalius_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/enemies/andromalius_openmouth_left.lua",
+            "data/entities/map/enemies/andromalius_openmouth_right.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/rolling_stone1.lua",
+            "data/entities/map/objects/spikes1.lua",
+            "data/entities/map/objects/stone_fence1.lua",
+            "data/entities/map/triggers/stone_trigger1_off.lua",
+            "data/entities/map/triggers/stone_trigger1_on.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/visuals/particle_effects/fire.lua",
+            "data/visuals/particle_effects/slow_burst_particles.lua",
+        },
+        sounds = {
+            "data/sounds/battle_encounter_03.ogg",
+            "data/sounds/campfire.ogg",
+            "data/sounds/cave-in.ogg",
+            "data/sounds/falling.ogg",
+            "data/sounds/fire1_spell.ogg",
+            "data/sounds/fountain_large.ogg",
+            "data/sounds/heavy_bump.wav",
+            "data/sounds/low_scream.ogg",
+            "data/sounds/low_scream_long.ogg",
+            "data/sounds/opening_sword_unsheathe.wav",
+            "data/sounds/rumble_continuous.ogg",
+            "data/sounds/stone_bump.ogg",
+            "data/sounds/stone_roll.wav",
+        },
+        music = {
+            "data/music/dont_close_your_eyes.ogg",
+            "data/music/mountain_shrine.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_3rd_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_3rd_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine_basement_script.lua"] = {
+        images = {
+            "data/battles/battle_scenes/desert_cave/desert_cave.png",
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/enemies/andromalius_spritesheet.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mt_elbrus.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/enemies/andromalius_openmouth_left.lua",
+            "data/entities/map/enemies/andromalius_openmouth_right.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/visuals/lights/right_ray_light.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+        },
+        sounds = {
+            "data/sounds/heavy_bump.wav",
+        },
+        music = {
+            "data/music/accion-OGA-djsaryon.ogg",
+            "data/music/dont_close_your_eyes.ogg",
+            "data/music/icy_wind.ogg",
+        },
+        scripts = {
+            "data/battles/battle_scenes/desert_cave_battle_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_north_east_exit_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_north_east_exit_script.lua",
+        },
+    },
+    ["map:data/story/ep1/mt_elbrus/mt_elbrus_shrine_stairs_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_run_unarmed.png",
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/map/characters/kalya_run.png",
+            "data/entities/map/characters/kalya_walk.png",
+            "data/entities/map/npcs/story/orlinn_spritesheet.png",
+            "data/entities/portraits/bronann.png",
+            "data/entities/portraits/kalya.png",
+            "data/entities/portraits/npcs/orlinn.png",
+            "data/story/common/locations/mountain_shrine.png",
+            "data/visuals/ambient/dark.png",
+        },
+        animations = {
+            "data/entities/map/characters/bronann_attack_south.lua",
+            "data/entities/map/characters/bronann_dead.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed.lua",
+            "data/entities/map/characters/bronann_frightened_unarmed_fixed.lua",
+            "data/entities/map/characters/bronann_hero_stance_unarmed.lua",
+            "data/entities/map/characters/bronann_hurt_unarmed.lua",
+            "data/entities/map/characters/bronann_jump_south.lua",
+            "data/entities/map/characters/bronann_kneeling.lua",
+            "data/entities/map/characters/bronann_kneeling_left.lua",
+            "data/entities/map/characters/bronann_laughing_unarmed.lua",
+            "data/entities/map/characters/bronann_searching_unarmed.lua",
+            "data/entities/map/characters/kalya_frightened_fixed.lua",
+            "data/entities/map/characters/kalya_hurt.lua",
+            "data/entities/map/characters/kalya_jump_south.lua",
+            "data/entities/map/characters/kalya_kneeling.lua",
+            "data/entities/map/characters/kalya_laughing.lua",
+            "data/entities/map/characters/kalya_struggling.lua",
+            "data/entities/map/npcs/story/orlinn_frightened_fixed.lua",
+            "data/entities/map/npcs/story/orlinn_laughing.lua",
+            "data/entities/map/objects/ancient_sign.lua",
+            "data/entities/map/objects/bubble.lua",
+            "data/entities/map/objects/flame1.lua",
+            "data/entities/map/objects/layna_statue.lua",
+            "data/entities/map/objects/water_light1.lua",
+            "data/entities/map/objects/waterfall2.lua",
+            "data/gui/map/heal_anim.lua",
+            "data/visuals/lights/sun_flare_light_main.lua",
+            "data/visuals/lights/torch_light_mask.lua",
+            "data/visuals/lights/torch_light_mask2.lua",
+        },
+        particle_effects = {
+            "data/story/ep1/mt_elbrus/particles_snow_south_entrance.lua",
+            "data/visuals/particle_effects/bubble_steam.lua",
+            "data/visuals/particle_effects/heal_particle.lua",
+            "data/visuals/particle_effects/waterfall_steam.lua",
+            "data/visuals/particle_effects/waterfall_steam_big.lua",
+        },
+        sounds = {
+            "data/sounds/campfire.ogg",
+            "data/sounds/fountain_large.ogg",
+            "data/sounds/heal_spell.wav",
+        },
+        music = {
+            "data/music/Zander Noriega - School of Quirks.ogg",
+            "data/music/icy_wind.ogg",
+        },
+        scripts = {
+            "data/story/ep1/mt_elbrus/mt_elbrus_scent_anim.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine5_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_ne_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_ne_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_2nd_s2_script.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_3rd_map.lua",
+            "data/story/ep1/mt_elbrus/mt_elbrus_shrine_3rd_script.lua",
+        },
+    },
+    ["map:data/story/ep2/overworld/present/dev_overworld_script.lua"] = {
+        images = {
+            "data/entities/map/characters/bronann_walk_unarmed.png",
+            "data/entities/portraits/bronann.png",
+            "data/visuals/ambient/clouds_overworld.png",
+        },
+        music = {
+            "data/music/overworld_present.ogg",
+        },
+    },
+}
@@ -12,6 +12,8 @@ fonts = {
     -- Fonts loaded for every languages.
     ["default"] = {
         -- Text style internal name = { "font file path", font size }
+        -- The text is drawn from distance field glyphs shared by every size of a font file.
+        -- Add 'distance_field = false' to a text style to rasterize its glyphs at its own size instead.
         -- TODO: Rename the text style to some non size dependant name.
         ["title20"] = {font = "data/fonts/LinLibertine_aBS.ttf", size = 18},
         ["title22"] = {font = "data/fonts/LinLibertine_aBS.ttf", size = 20},
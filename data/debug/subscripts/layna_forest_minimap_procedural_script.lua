@@ -408,6 +408,11 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     forest_entrance_exit_zone = vt_map.CameraZone.Create(0, 1, 26, 34);
     to_forest_nw_zone = vt_map.CameraZone.Create(62, 64, 29, 35);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("exit forest"):SetPrefetchZone(forest_entrance_exit_zone);
+    EventManager:GetEvent("exit forest at night"):SetPrefetchZone(forest_entrance_exit_zone);
+    EventManager:GetEvent("to forest NW"):SetPrefetchZone(to_forest_nw_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -465,6 +465,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_NW_zone = vt_map.CameraZone.Create(114, 118, 95, 97);
     to_cave_1_2_zone = vt_map.CameraZone.Create(126, 128, 3, 13);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest NW"):SetPrefetchZone(to_forest_NW_zone);
+    EventManager:GetEvent("to cave 1-2"):SetPrefetchZone(to_cave_1_2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -440,6 +440,11 @@ function _CreateZones()
 
     to_wolf_cave_zone = vt_map.CameraZone.Create(122, 124, 12, 14);
     seeing_the_exit_zone = vt_map.CameraZone.Create(99, 122, 80, 96);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to cave 1-1"):SetPrefetchZone(to_cave_1_1_zone);
+    EventManager:GetEvent("to south east exit"):SetPrefetchZone(to_cave_exit_zone);
+    EventManager:GetEvent("to wolf cave"):SetPrefetchZone(to_wolf_cave_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
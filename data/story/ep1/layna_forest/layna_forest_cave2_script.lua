@@ -246,6 +246,10 @@ function _CreateZones()
     to_8_2_zone = vt_map.CameraZone.Create(22, 24, 57, 58);
     to_9_1_zone = vt_map.CameraZone.Create(118, 120, 7, 8);
     to_9_2_zone = vt_map.CameraZone.Create(78, 80, 69, 70);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest SE"):SetPrefetchZone(to_forest_SE_zone);
+    EventManager:GetEvent("to forest crystal"):SetPrefetchZone(to_forest_crystal_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
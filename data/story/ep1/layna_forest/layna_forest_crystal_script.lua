@@ -733,6 +733,9 @@ function _CreateZones()
     to_forest_cave2_zone:SetInteractionIcon("data/gui/map/exit_anim.lua")
 
     wolf_battle_zone = vt_map.CameraZone.Create(38, 46, 63, 66);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest cave 2"):SetPrefetchZone(to_forest_cave2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -728,6 +728,10 @@ function _CreateZones()
     music_fade_out_zone = vt_map.CameraZone.Create(48, 50, 8, 17);
     warning_zone = vt_map.CameraZone.Create(91, 93, 4, 18);
     boss_fight1_zone = vt_map.CameraZone.Create(103, 105, 4, 18);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest NW"):SetPrefetchZone(to_forest_NW_zone);
+    EventManager:GetEvent("to forest SE"):SetPrefetchZone(to_forest_SE_zone);
 end
 
 -- A simple boolean permiting to trigger the dialogue only once...
@@ -862,6 +862,12 @@ function _CreateZones()
     to_forest_SW_zone = vt_map.CameraZone.Create(111, 119, 95, 97);
     to_cave_entrance_zone = vt_map.CameraZone.Create(74, 78, 36, 38);
     orlinn_scene_zone = vt_map.CameraZone.Create(81, 83, 18, 28);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest entrance"):SetPrefetchZone(to_forest_entrance_zone);
+    EventManager:GetEvent("to forest NE"):SetPrefetchZone(to_forest_NE_zone);
+    EventManager:GetEvent("to forest SW"):SetPrefetchZone(to_forest_SW_zone);
+    EventManager:GetEvent("to cave entrance"):SetPrefetchZone(to_cave_entrance_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -774,6 +774,13 @@ function _CreateZones()
     to_cave1_2_zone = vt_map.CameraZone.Create(12, 16, 39, 40);
     to_cave2_1_zone = vt_map.CameraZone.Create(64, 68, 69, 70);
     to_wolf_cave_zone = vt_map.CameraZone.Create(30, 34, 17, 18);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest NE"):SetPrefetchZone(to_forest_NE_zone);
+    EventManager:GetEvent("to forest SW"):SetPrefetchZone(to_forest_SW_zone);
+    EventManager:GetEvent("to cave 1_2"):SetPrefetchZone(to_cave1_2_zone);
+    EventManager:GetEvent("to wolf cave"):SetPrefetchZone(to_wolf_cave_zone);
+    EventManager:GetEvent("to cave 2"):SetPrefetchZone(to_cave2_1_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -693,6 +693,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_forest_SE_zone = vt_map.CameraZone.Create(126, 128, 82, 87);
     to_forest_NW_zone = vt_map.CameraZone.Create(52, 59, 0, 2);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to forest SE"):SetPrefetchZone(to_forest_SE_zone);
+    EventManager:GetEvent("to forest NW"):SetPrefetchZone(to_forest_NW_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -359,6 +359,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_cave_1_2_zone = vt_map.CameraZone.Create(0, 1, 24, 28);
     to_cave_exit_zone = vt_map.CameraZone.Create(24, 29, 47, 48);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to cave 1-2"):SetPrefetchZone(to_cave_1_2_zone);
+    EventManager:GetEvent("to south east exit"):SetPrefetchZone(to_cave_exit_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -203,6 +203,9 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     room_exit_zone = vt_map.CameraZone.Create(38, 39, 16, 19);
     save_point_zone = vt_map.CameraZone.Create(32, 36, 31, 35);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("exit floor"):SetPrefetchZone(room_exit_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
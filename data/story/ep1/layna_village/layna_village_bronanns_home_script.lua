@@ -335,6 +335,9 @@ function _CreateZones()
     to_bronanns_room_zone = vt_map.CameraZone.Create(44, 47, 8, 9);
 
     quest2_start_scene = false;
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Bronann's 1st floor"):SetPrefetchZone(to_bronanns_room_zone);
 end
 
 function _CheckZones()
@@ -425,18 +428,24 @@ function _UpdateCarsonDialogue()
         dialogue:SetEventAtDialogueEnd("Show sword start event")
         carson:AddDialogueReference(dialogue)
 
+        -- The scene events are only played once, so they are freed once ended.
         event = vt_map.ScriptedEvent.Create("Show sword start event", "StartSwordShowScene", "")
+        event:SetRecycledOnEnd(true)
         event:AddEventLinkAtEnd("Bronann goes in front of Carson")
         event:AddEventLinkAtEnd("Carson goes in front of Bronann")
 
         event = vt_map.PathMoveSpriteEvent.Create("Carson goes in front of Bronann", carson, 34, 12, false)
+        event:SetRecycledOnEnd(true)
         event:AddEventLinkAtEnd("Carson looks at Bronann 2")
-        vt_map.ChangeDirectionSpriteEvent.Create("Carson looks at Bronann 2", carson, vt_map.MapMode.EAST)
+        event = vt_map.ChangeDirectionSpriteEvent.Create("Carson looks at Bronann 2", carson, vt_map.MapMode.EAST)
+        event:SetRecycledOnEnd(true)
 
         event = vt_map.PathMoveSpriteEvent.Create("Bronann goes in front of Carson", bronann, 36, 12, false)
+        event:SetRecycledOnEnd(true)
         event:AddEventLinkAtEnd("Bronann looks at Carson")
 
         event = vt_map.ChangeDirectionSpriteEvent.Create("Bronann looks at Carson", bronann, vt_map.MapMode.WEST)
+        event:SetRecycledOnEnd(true)
         event:AddEventLinkAtEnd("Carson gives sword to Bronann dialogue")
 
         dialogue = vt_map.SpriteDialogue.Create()
@@ -446,6 +455,7 @@ function _UpdateCarsonDialogue()
 
         -- Show Wooden Sword
         event = vt_map.ScriptedEvent.Create("Show sword event", "ShowSwordEvent", "ShowSwordEventUpdate")
+        event:SetRecycledOnEnd(true)
         event:AddEventLinkAtEnd("Carson gives sword part 2")
 
         dialogue = vt_map.SpriteDialogue.Create()
@@ -457,6 +467,7 @@ function _UpdateCarsonDialogue()
 
         -- Hide Wooden Sword
         event = vt_map.ScriptedEvent.Create("Carson hide sword event", "HideSwordEvent", "")
+        event:SetRecycledOnEnd(true)
         event:AddEventLinkAtEnd("Add the wooden sword in inventory")
 
         event = vt_map.TreasureEvent.Create("Add the wooden sword in inventory");
@@ -469,6 +480,7 @@ function _UpdateCarsonDialogue()
         vt_map.DialogueEvent.Create("Carson gives sword part 3", dialogue)
 
         event = vt_map.ScriptedEvent.Create("End Sword Giving scene event", "EndSwordShowEvent", "")
+        event:SetRecycledOnEnd(true)
     end
 end
 
@@ -495,7 +507,9 @@ function _UpdateMotherDialogue()
         dialogue:AddLineEvent(text, malta, "", "Prepare item giving scene");
         malta:AddDialogueReference(dialogue);
 
+        -- The scene events are only played once, so they are freed once ended.
         event = vt_map.ScriptedEvent.Create("Prepare item giving scene", "StartItemGivingScene", "");
+        event:SetRecycledOnEnd(true);
         event:AddEventLinkAtEnd("Malta gives items")
 
         event = vt_map.TreasureEvent.Create("Malta gives items");
@@ -513,6 +527,7 @@ function _UpdateMotherDialogue()
         event:AddEventLinkAtEnd("Update Malta's dialogue after giving items");
 
         event = vt_map.ScriptedEvent.Create("Update Malta's dialogue after giving items", "EndItemGivingScene", "");
+        event:SetRecycledOnEnd(true);
         return;
     end
     if (GlobalManager:GetGameEvents():DoesEventExist("story", "quest1_barley_meal_done") == true
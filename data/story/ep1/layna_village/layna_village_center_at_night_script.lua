@@ -384,6 +384,9 @@ function _CreateZones()
     secret_path_zone = vt_map.CameraZone.Create(0, 1, 55, 61);
     to_layna_forest_zone = vt_map.CameraZone.Create(117, 119, 30, 43);
     sophia_house_entrance_zone = vt_map.CameraZone.Create(21, 23, 21, 22);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Riverbank"):SetPrefetchZone(to_riverbank_zone);
 end
 
 function _CheckZones()
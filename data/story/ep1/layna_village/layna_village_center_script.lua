@@ -708,6 +708,17 @@ function _CreateZones()
     to_layna_forest_zone = vt_map.CameraZone.Create(117, 119, 30, 43);
     sophia_house_entrance_zone = vt_map.CameraZone.Create(21, 23, 21, 22);
     to_well_undergrounds_zone = vt_map.CameraZone.Create(62, 64, 29, 30)
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Bronann's home"):SetPrefetchZone(bronanns_home_entrance_zone);
+    EventManager:GetEvent("to Riverbank"):SetPrefetchZone(to_riverbank_zone);
+    EventManager:GetEvent("to Village south entrance"):SetPrefetchZone(to_village_entrance_zone);
+    EventManager:GetEvent("to Kalya house path"):SetPrefetchZone(to_kalya_house_path_zone);
+    EventManager:GetEvent("to secret cliff"):SetPrefetchZone(secret_path_zone);
+    EventManager:GetEvent("to layna forest entrance"):SetPrefetchZone(to_layna_forest_zone);
+    EventManager:GetEvent("to Flora's Shop"):SetPrefetchZone(shop_entrance_zone);
+    EventManager:GetEvent("to sophia house"):SetPrefetchZone(sophia_house_entrance_zone);
+    EventManager:GetEvent("To well underground"):SetPrefetchZone(to_well_undergrounds_zone);
 end
 
 function _CheckZones()
@@ -799,19 +810,26 @@ function _UpdateOliviaDialogue()
             olivia:AddDialogueReference(dialogue)
 
             -- Event to go to the well.
+            -- The scene events are only played once, so they are freed once ended.
             event = vt_map.ScriptedEvent.Create("Olivia goes to well with Bronann", "Well_event_scene_start", "")
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Olivia moves to the well")
             event:AddEventLinkAtEnd("Bronann looks at Olivia for a few seconds")
             event = vt_map.PathMoveSpriteEvent.Create("Olivia moves to the well", olivia, 57, 27, true)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Olivia looks at Bronann 1")
             event = vt_map.LookAtSpriteEvent.Create("Olivia looks at Bronann 1", olivia, bronann)
+            event:SetRecycledOnEnd(true)
 
             event = vt_map.ScriptedEvent.Create("Bronann looks at Olivia for a few seconds", "bronann_watch_olivia_start", "bronann_watch_olivia_update")
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Bronann moves to the well")
 
             event = vt_map.PathMoveSpriteEvent.Create("Bronann moves to the well", bronann, 61, 27, true)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Olivia looks at Bronann")
             event = vt_map.LookAtSpriteEvent.Create("Olivia looks at Bronann", olivia, bronann)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Olivia opens path to well underground")
             dialogue = vt_map.SpriteDialogue.Create()
             text = vt_system.Translate("Here we go!")
@@ -820,8 +838,10 @@ function _UpdateOliviaDialogue()
             event:AddEventLinkAtEnd("Olivia moves close to the well")
 
             event = vt_map.PathMoveSpriteEvent.Create("Olivia moves close to the well", olivia, 59, 28.5, false)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Olivia opens well path")
             event = vt_map.ScriptedEvent.Create("Olivia opens well path", "well_open_trigger_start", "well_open_trigger_update")
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Olivia speech before entering well")
 
             dialogue = vt_map.SpriteDialogue.Create()
@@ -832,10 +852,13 @@ function _UpdateOliviaDialogue()
             event = vt_map.DialogueEvent.Create("Olivia speech before entering well", dialogue)
             event:AddEventLinkAtEnd("Olivia enters the well")
             event = vt_map.PathMoveSpriteEvent.Create("Olivia enters the well", olivia, 63, 32, false)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Set Olivia invisible")
             event = vt_map.ScriptedEvent.Create("Set Olivia invisible", "set_olivia_invisible", "")
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Bronann enters the well")
             event = vt_map.PathMoveSpriteEvent.Create("Bronann enters the well", bronann, 63, 32, false)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("To well underground") -- map transition
         else
             olivia:AddDialogueReference(default_dialogue)
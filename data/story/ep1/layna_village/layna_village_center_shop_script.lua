@@ -122,6 +122,9 @@ local shop_exit_zone = nil
 function _CreateZones()
     -- N.B.: left, right, top, bottom
     shop_exit_zone = vt_map.CameraZone.Create(30, 34, 28, 29);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to village"):SetPrefetchZone(shop_exit_zone);
 end
 
 function _CheckZones()
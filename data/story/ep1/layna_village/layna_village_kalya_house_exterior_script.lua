@@ -177,6 +177,10 @@ function _CreateZones()
     kalya_house_path_zone = vt_map.CameraZone.Create(28, 58, 46, 47);
     kalya_house_path_small_passage_zone = vt_map.CameraZone.Create(0, 1, 0, 33);
     kalya_house_entrance_zone = vt_map.CameraZone.Create(42, 46, 16, 17);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Kalya house path"):SetPrefetchZone(kalya_house_path_zone);
+    EventManager:GetEvent("to kalya house path small passage"):SetPrefetchZone(kalya_house_path_small_passage_zone);
 end
 
 function _CheckZones()
@@ -307,6 +307,12 @@ function _CreateZones()
     kalya_house_exterior_zone = vt_map.CameraZone.Create(26, 56, 0, 2);
     grandma_house_entrance_zone = vt_map.CameraZone.Create(11, 13, 7, 8);
     kalya_house_small_passage_zone = vt_map.CameraZone.Create(3, 8, 0, 1);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Village center"):SetPrefetchZone(village_center_zone);
+    EventManager:GetEvent("to Kalya house exterior"):SetPrefetchZone(kalya_house_exterior_zone);
+    EventManager:GetEvent("to grandma house"):SetPrefetchZone(grandma_house_entrance_zone);
+    EventManager:GetEvent("to Kalya house small passage"):SetPrefetchZone(kalya_house_small_passage_zone);
 end
 
 function _CheckZones()
@@ -89,6 +89,9 @@ local room_exit_zone = nil
 function _CreateZones()
     -- N.B.: left, right, top, bottom
     room_exit_zone = vt_map.CameraZone.Create(26, 30, 12, 13);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("exit floor"):SetPrefetchZone(room_exit_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
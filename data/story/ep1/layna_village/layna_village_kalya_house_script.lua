@@ -385,6 +385,9 @@ function _CreateZones()
     downstairs_zone = vt_map.CameraZone.Create(38, 42, 20, 22);
     upstairs_zone = vt_map.CameraZone.Create(38, 42, 26, 28);
     to_mt_elbrus_zone = vt_map.CameraZone.Create(30, 36, 12, 14);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Mt Elbrus"):SetPrefetchZone(to_mt_elbrus_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -692,6 +692,9 @@ function _CreateZones()
     soldier22_watching_north_zone = vt_map.CameraZone.Create(78, 80, 12, 17);
     soldier22_watching_west_zone = vt_map.CameraZone.Create(64, 74, 20, 32);
     battle_dialogue_start_zone = vt_map.CameraZone.Create(64, 86, 39, 40);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Village center"):SetPrefetchZone(village_center_zone);
 end
 
 function _CheckZones()
@@ -433,6 +433,12 @@ function _CreateZones()
     to_riverbank_house_entrance_zone = vt_map.CameraZone.Create(96, 100, 46, 47);
     to_secret_path_entrance_zone = vt_map.CameraZone.Create(60, 72, 0, 2);
     orlinn_hide_n_seek2_zone = vt_map.CameraZone.Create(75, 80, 0, 7);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Village center"):SetPrefetchZone(village_center_zone);
+    EventManager:GetEvent("to Village south entrance"):SetPrefetchZone(to_village_entrance_zone);
+    EventManager:GetEvent("to Riverbank house"):SetPrefetchZone(to_riverbank_house_entrance_zone);
+    EventManager:GetEvent("to secret path entrance"):SetPrefetchZone(to_secret_path_entrance_zone);
 end
 
 function _CheckZones()
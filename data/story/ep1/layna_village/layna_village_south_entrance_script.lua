@@ -198,6 +198,12 @@ function _CreateZones()
     to_village_riverbank_zone = vt_map.CameraZone.Create(0, 1, 26, 43);
     to_left_house_zone = vt_map.CameraZone.Create(18, 22, 32, 33);
     to_right_house_zone = vt_map.CameraZone.Create(46, 50, 32, 33);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to Village center"):SetPrefetchZone(village_center_zone);
+    EventManager:GetEvent("to Village riverbank"):SetPrefetchZone(to_village_riverbank_zone);
+    EventManager:GetEvent("to left house"):SetPrefetchZone(to_left_house_zone);
+    EventManager:GetEvent("to right house"):SetPrefetchZone(to_right_house_zone);
 end
 
 function _CheckZones()
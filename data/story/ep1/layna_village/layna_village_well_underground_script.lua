@@ -233,10 +233,13 @@ function _CheckMonstersState()
             event:AddItem(40002, 1) -- Long leather gloves
             event:AddEventLinkAtEnd("Olivia leaves");
 
+            -- The scene events are only played once, so they are freed once ended.
             event = vt_map.PathMoveSpriteEvent.Create("Olivia leaves", olivia, 18, 1, false)
+            event:SetRecycledOnEnd(true)
             event:AddEventLinkAtEnd("Set Olivia invisible")
 
             event = vt_map.ScriptedEvent.Create("Set Olivia invisible", "make_olivia_invisible", "")
+            event:SetRecycledOnEnd(true)
 
             -- Set intro event as done
             GlobalManager:GetGameEvents():SetEventValue("story", "well_rats_beaten", 1);
@@ -368,6 +371,9 @@ local room_exit_zone = nil
 function _CreateZones()
     -- N.B.: left, right, top, bottom
     room_exit_zone = vt_map.CameraZone.Create(16, 18, 0, 1)
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("exit floor"):SetPrefetchZone(room_exit_zone)
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
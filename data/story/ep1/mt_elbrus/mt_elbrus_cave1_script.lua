@@ -273,6 +273,12 @@ function _CreateZones()
     exit4_zone = vt_map.CameraZone.Create(90, 92, 7, 8);
     left_jump_zone = vt_map.CameraZone.Create(4, 8, 63, 64);
     right_jump_zone = vt_map.CameraZone.Create(77, 81, 29, 30);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to exit 1"):SetPrefetchZone(exit1_zone);
+    EventManager:GetEvent("to exit 2"):SetPrefetchZone(exit2_zone);
+    EventManager:GetEvent("to exit 3"):SetPrefetchZone(exit3_zone);
+    EventManager:GetEvent("to exit 4"):SetPrefetchZone(exit4_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -201,6 +201,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     exit2_1_zone = vt_map.CameraZone.Create(42, 50, 46, 48);
     exit2_2_zone = vt_map.CameraZone.Create(42, 48, 15, 17);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to exit 2-1"):SetPrefetchZone(exit2_1_zone);
+    EventManager:GetEvent("to exit 2-2"):SetPrefetchZone(exit2_2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -287,6 +287,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     exit3_1_zone = vt_map.CameraZone.Create(46, 58, 17, 19);
     exit3_2_zone = vt_map.CameraZone.Create(0, 8, 21, 23);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to exit 3-1"):SetPrefetchZone(exit3_1_zone);
+    EventManager:GetEvent("to exit 3-2"):SetPrefetchZone(exit3_2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -284,6 +284,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_basement_zone = vt_map.CameraZone.Create(29, 31, 12, 14);
     to_overworld_zone = vt_map.CameraZone.Create(0, 2, 34, 44);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine basement"):SetPrefetchZone(to_basement_zone);
+    EventManager:GetEvent("to overworld"):SetPrefetchZone(to_overworld_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -650,6 +650,13 @@ function _CreateZones()
     to_cave3_zone = vt_map.CameraZone.Create(116, 120, 29, 30);
     to_cave4_zone = vt_map.CameraZone.Create(100, 104, 19, 20);
     to_path2_zone = vt_map.CameraZone.Create(0, 2, 16, 26);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to cave 1"):SetPrefetchZone(to_cave1_zone);
+    EventManager:GetEvent("to cave 2"):SetPrefetchZone(to_cave2_zone);
+    EventManager:GetEvent("to cave 3"):SetPrefetchZone(to_cave3_zone);
+    EventManager:GetEvent("to cave 4"):SetPrefetchZone(to_cave4_zone);
+    EventManager:GetEvent("to mountain path 2"):SetPrefetchZone(to_path2_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
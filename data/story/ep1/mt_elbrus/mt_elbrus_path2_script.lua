@@ -408,6 +408,15 @@ function _CreateZones()
     to_path1_zone = vt_map.CameraZone.Create(78, 80, 13, 30);
     to_path3_zone = vt_map.CameraZone.Create(29, 48, 0, 2);
     to_path3_bis_zone = vt_map.CameraZone.Create(0, 9, 0, 2);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to cave 2-1"):SetPrefetchZone(to_cave2_1_zone);
+    EventManager:GetEvent("to cave 2-2"):SetPrefetchZone(to_cave2_2_zone);
+    EventManager:GetEvent("to cave 3-1"):SetPrefetchZone(to_cave3_1_zone);
+    EventManager:GetEvent("to cave 3-2"):SetPrefetchZone(to_cave3_2_zone);
+    EventManager:GetEvent("to mountain path 1"):SetPrefetchZone(to_path1_zone);
+    EventManager:GetEvent("to mountain path 3"):SetPrefetchZone(to_path3_zone);
+    EventManager:GetEvent("to mountain path 3bis"):SetPrefetchZone(to_path3_bis_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -766,6 +766,11 @@ function _CreateZones()
     cemetery_west_gate_dialogue_zone = vt_map.CameraZone.Create(7, 31, 46, 48);
     -- cemetery gates closed
     cemetery_gates_closed_zone = vt_map.CameraZone.Create(44, 92, 52, 54);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain path 4"):SetPrefetchZone(to_path4_zone);
+    EventManager:GetEvent("to mountain path 2"):SetPrefetchZone(to_path2_zone);
+    EventManager:GetEvent("to mountain path 2bis"):SetPrefetchZone(to_path2_bis_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -465,6 +465,9 @@ function _CreateZones()
 
     bridge_south_zone = vt_map.CameraZone.Create(33, 39, 39, 41);
     bridge_middle_zone = vt_map.CameraZone.Create(33, 39, 24, 26);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine entrance"):SetPrefetchZone(to_shrine_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -447,6 +447,11 @@ function _CreateZones()
     to_shrine_zone = vt_map.CameraZone.Create(40, 44, 2, 4);
     to_mountain_bridge_zone = vt_map.CameraZone.Create(26, 32, 46, 48);
     shrine_door_opening_zone = vt_map.CameraZone.Create(40, 44, 8, 10);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine"):SetPrefetchZone(to_shrine_zone);
+    EventManager:GetEvent("to mountain shrine-waterfalls"):SetPrefetchZone(to_shrine_zone);
+    EventManager:GetEvent("to mountain bridge"):SetPrefetchZone(to_mountain_bridge_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
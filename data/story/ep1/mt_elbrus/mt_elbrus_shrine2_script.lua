@@ -467,6 +467,13 @@ function _CreateZones()
     to_shrine_first_floor_zone = vt_map.CameraZone.Create(12, 16, 0, 2);
     to_shrine_stairs_room_zone = vt_map.CameraZone.Create(46, 54, 0, 2);
     shrine_skeleton_trap_zone = vt_map.CameraZone.Create(4, 24, 10, 12);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine entrance"):SetPrefetchZone(to_shrine_entrance_zone);
+    EventManager:GetEvent("to mountain shrine trap room"):SetPrefetchZone(to_shrine_trap_room_zone);
+    EventManager:GetEvent("to mountain shrine enigma room"):SetPrefetchZone(to_shrine_enigma_room_zone);
+    EventManager:GetEvent("to mountain shrine first floor"):SetPrefetchZone(to_shrine_first_floor_zone);
+    EventManager:GetEvent("to mountain shrine stairs"):SetPrefetchZone(to_shrine_stairs_room_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
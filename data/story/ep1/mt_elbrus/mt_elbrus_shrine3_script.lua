@@ -448,6 +448,11 @@ function _CreateZones()
     to_shrine_main_room_zone = vt_map.CameraZone.Create(0, 2, 34, 38);
     to_shrine_treasure_room_zone = vt_map.CameraZone.Create(18, 20, 9, 10);
     trap_zone = vt_map.CameraZone.Create(10, 34, 10, 44);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine main room"):SetPrefetchZone(to_shrine_main_room_zone);
+    EventManager:GetEvent("to mountain shrine main room-waterfalls"):SetPrefetchZone(to_shrine_main_room_zone);
+    EventManager:GetEvent("to mountain shrine treasure room"):SetPrefetchZone(to_shrine_treasure_room_zone);
 end
 
 local trap_started = false;
@@ -370,6 +370,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_main_room_zone = vt_map.CameraZone.Create(62, 64, 32, 36);
     mini_boss_zone = vt_map.CameraZone.Create(40, 42, 6, 11);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine main room"):SetPrefetchZone(to_shrine_main_room_zone);
+    EventManager:GetEvent("to mountain shrine main room-waterfalls"):SetPrefetchZone(to_shrine_main_room_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -574,6 +574,14 @@ function _CreateZones()
     to_shrine_SW_right_door_room_zone = vt_map.CameraZone.Create(26, 30, 38, 40);
     to_shrine_NE_room_zone = vt_map.CameraZone.Create(46, 48, 8, 12);
     monster_trap_zone = vt_map.CameraZone.Create(11, 21, 29, 38);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine main room"):SetPrefetchZone(to_shrine_main_room_zone);
+    EventManager:GetEvent("to mountain shrine main room-waterfalls"):SetPrefetchZone(to_shrine_main_room_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor"):SetPrefetchZone(to_shrine_2nd_floor_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor SW room - left door"):SetPrefetchZone(to_shrine_SW_left_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor SW room - right door"):SetPrefetchZone(to_shrine_SW_right_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor NE room"):SetPrefetchZone(to_shrine_NE_room_zone);
 end
 
 local trap_triggered = false;
@@ -260,6 +260,12 @@ function _CreateZones()
     to_shrine_NW_right_door_room_zone = vt_map.CameraZone.Create(26, 30, 7, 9);
     to_shrine_SE_top_door_room_zone = vt_map.CameraZone.Create(45, 47, 22, 26);
     to_shrine_SE_bottom_door_room_zone = vt_map.CameraZone.Create(45, 47, 32, 36);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 1st floor NW room - left door"):SetPrefetchZone(to_shrine_NW_left_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor NW room - right door"):SetPrefetchZone(to_shrine_NW_right_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor SE room - top door"):SetPrefetchZone(to_shrine_SE_top_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor SE room - bottom door"):SetPrefetchZone(to_shrine_SE_bottom_door_room_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
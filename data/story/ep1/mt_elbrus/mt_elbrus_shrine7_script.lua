@@ -285,6 +285,11 @@ function _CreateZones()
     to_shrine_SW_top_door_room_zone = vt_map.CameraZone.Create(1, 3, 22, 26);
     to_shrine_SW_bottom_door_room_zone = vt_map.CameraZone.Create(1, 3, 32, 36);
     to_shrine_NE_room_zone = vt_map.CameraZone.Create(24, 32, 0, 2);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 1st floor SW room - top door"):SetPrefetchZone(to_shrine_SW_top_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor SW room - bottom door"):SetPrefetchZone(to_shrine_SW_bottom_door_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor NE room"):SetPrefetchZone(to_shrine_NE_room_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -226,6 +226,10 @@ function _CreateZones()
     -- N.B.: left, right, top, bottom
     to_shrine_NW_room_zone = vt_map.CameraZone.Create(0, 2, 8, 12);
     to_shrine_SE_room_zone = vt_map.CameraZone.Create(24, 32, 38, 40);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 1st floor NW room"):SetPrefetchZone(to_shrine_NW_room_zone);
+    EventManager:GetEvent("to mountain shrine 1st floor SE room"):SetPrefetchZone(to_shrine_SE_room_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
@@ -220,6 +220,10 @@ function _CreateZones()
     to_shrine_entrance_zone = vt_map.CameraZone.Create(20, 24, 46, 48);
     to_shrine_trap_zone = vt_map.CameraZone.Create(50, 52, 46, 48);
     falling_event_zone = vt_map.CameraZone.Create(19, 25, 26, 28);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine entrance"):SetPrefetchZone(to_shrine_entrance_zone);
+    EventManager:GetEvent("to mountain shrine trap room"):SetPrefetchZone(to_shrine_trap_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
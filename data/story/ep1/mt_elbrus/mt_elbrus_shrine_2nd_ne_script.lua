@@ -288,6 +288,10 @@ function _CreateZones()
     to_shrine_1st_floor_room_zone = vt_map.CameraZone.Create(22, 26, 9, 11);
     to_shrine_SE_room_zone = vt_map.CameraZone.Create(24, 32, 38, 42);
     spike_trap_zone = vt_map.CameraZone.Create(24, 26, 22, 24);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 1st floor"):SetPrefetchZone(to_shrine_1st_floor_room_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor South"):SetPrefetchZone(to_shrine_SE_room_zone);
 end
 
 local trap_triggered = false;
@@ -240,6 +240,12 @@ function _CreateZones()
     falling_zone:AddSection(43, 47, 48, 52);
 
     windy3_zone = vt_map.CameraZone.Create(85, 89, 10, 29);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 2nd floor NE"):SetPrefetchZone(to_shrine_ne_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor north east"):SetPrefetchZone(to_grotto_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor north west"):SetPrefetchZone(to_shrine_nw_zone);
+    EventManager:GetEvent("To mountain shrine entrance"):SetPrefetchZone(falling_zone);
 end
 
 -- Tells whether the winds are on.
@@ -432,6 +432,11 @@ function _CreateZones()
     trap_zone:AddSection(27, 32, 20, 25);
 
     mini_boss_zone = vt_map.CameraZone.Create(36, 38, 5, 10);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 2nd floor South left"):SetPrefetchZone(to_shrine_sw_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor South right"):SetPrefetchZone(to_shrine_se_zone);
+    EventManager:GetEvent("to mountain shrine stairs"):SetPrefetchZone(to_stairs_zone);
 end
 
 -- Trigger damages on the characters present on the battle front.
@@ -470,6 +470,9 @@ function _CreateZones()
     to_shrine_stairs_zone = vt_map.CameraZone.Create(30, 34, 46, 48);
     start_boss_zone = vt_map.CameraZone.Create(30, 34, 38, 40);
     boss_zone = vt_map.CameraZone.Create(28, 36, 20, 28);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine stairs"):SetPrefetchZone(to_shrine_stairs_zone);
 end
 
 function _CheckBossZone(stone)
@@ -317,6 +317,9 @@ function _CreateZones()
     see_exit_zone = vt_map.CameraZone.Create(56, 61, 40, 45);
     final_boss_zone = vt_map.CameraZone.Create(21, 36, 3, 22);
     to_mountain_exit_zone = vt_map.CameraZone.Create(0, 2, 15, 34);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine exit"):SetPrefetchZone(to_mountain_exit_zone);
 end
 
 -- Booleans preventing from starting the even more than once.
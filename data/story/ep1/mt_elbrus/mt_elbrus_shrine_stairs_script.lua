@@ -495,6 +495,12 @@ function _CreateZones()
     to_shrine_2nd_floor_grotto_zone = vt_map.CameraZone.Create(9, 12, 14, 17);
     to_shrine_3rd_floor_zone = vt_map.CameraZone.Create(34, 40, 5, 7);
     before_3rd_floor_zone = vt_map.CameraZone.Create(28, 46, 7, 10);
+
+    -- Prefetch the destination maps once the camera gets near their zones.
+    EventManager:GetEvent("to mountain shrine 1st floor"):SetPrefetchZone(to_shrine_1st_floor_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor"):SetPrefetchZone(to_shrine_2nd_floor_zone);
+    EventManager:GetEvent("to mountain shrine 2nd floor grotto"):SetPrefetchZone(to_shrine_2nd_floor_grotto_zone);
+    EventManager:GetEvent("to mountain shrine 3rd floor"):SetPrefetchZone(to_shrine_3rd_floor_zone);
 end
 
 -- Check whether the active camera has entered a zone. To be called within Update()
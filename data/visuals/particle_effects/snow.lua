@@ -101,6 +101,9 @@ systems[0] =
     modify_stencil = false,
     stencil_op = 'INCR',
     use_stencil = false,
-    random_initial_angle = true
+    random_initial_angle = true,
+
+    -- Lets the GPU emit and move the particles, when it can.
+    gpu_simulated = true
 }
 
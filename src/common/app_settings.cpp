@@ -155,6 +155,57 @@ static const std::string _SetupUserConfigPath()
     return "data/";
 }
 
+//! \brief Finds the OS specific directory path of the user data which can be regenerated
+static const std::string _SetupUserCachePath()
+{
+#if defined _WIN32
+    char path[MAX_PATH];
+    // %LOCALAPPDATA% (%USERPROFILE%\Local Settings\Application Data)
+    if(SUCCEEDED(SHGetFolderPathA(nullptr, CSIDL_LOCAL_APPDATA, nullptr, 0, path))) {
+        std::string user_path = std::string(path) + "/" APPUPCASEDIRNAME "/";
+        if(!DoesFileExist(user_path))
+            MakeDirectory(user_path);
+        return user_path;
+    }
+
+#elif defined __APPLE__
+    passwd *pw = getpwuid(getuid());
+    if(pw) {
+        std::string path = std::string(pw->pw_dir) + "/Library/Caches/" APPUPCASEDIRNAME "/";
+        if(!DoesFileExist(path))
+            MakeDirectory(path);
+        return path;
+    }
+
+#else // Linux, BSD, other POSIX systems
+    // $XDG_CACHE_HOME/valyriatear/
+    // equals to: ~/.cache/valyriatear/ most of the time
+    if (getenv("XDG_CACHE_HOME")) {
+        std::string path = std::string(getenv("XDG_CACHE_HOME")) + "/" APPSHORTNAME "/";
+        if(!DoesFileExist(path))
+            MakeDirectory(path);
+
+        return path;
+    }
+
+    // We create a sane default: ~/.cache/valyriatear
+    passwd *pw = getpwuid(getuid());
+    if(pw) {
+        std::string path = std::string(pw->pw_dir) + "/.cache/";
+        if(!DoesFileExist(path))
+            MakeDirectory(path);
+        path += "/" APPSHORTNAME "/";
+        if(!DoesFileExist(path))
+            MakeDirectory(path);
+
+        return path;
+    }
+#endif
+
+    // The cache is then kept along with the user data.
+    return GetUserDataPath();
+}
+
 //! \brief Retrieves the path and filename of the settings file to use
 //! \return A string with the settings filename, or an empty string
 //! if the settings file could not be found
@@ -178,6 +229,7 @@ static const std::string _SetupSettingsFilename()
 //! \brief Static variables storing the user data and config paths
 static std::string _data_path;
 static std::string _config_path;
+static std::string _cache_path;
 static std::string _config_filename;
 
 const std::string GetUserDataPath()
@@ -196,6 +248,14 @@ const std::string GetUserConfigPath()
     return _config_path;
 }
 
+const std::string GetUserCachePath()
+{
+    if (_cache_path.empty())
+        _cache_path = _SetupUserCachePath();
+
+    return _cache_path;
+}
+
 const std::string GetSettingsFilename()
 {
     if (_config_filename.empty())
@@ -22,6 +22,9 @@ const std::string GetUserDataPath();
 //! \brief Gives the OS specific directory path to save and retrieve user config data
 const std::string GetUserConfigPath();
 
+//! \brief Gives the OS specific directory path of the data which can be regenerated, like the shaders cache
+const std::string GetUserCachePath();
+
 //! \brief Gives the path and filename of the settings file to use
 //! \return A string with the settings filename, or an empty string if the settings file could not be found
 const std::string GetSettingsFilename();
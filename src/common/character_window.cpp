@@ -62,7 +62,7 @@ void CharacterWindow::SetCharacter(vt_global::GlobalCharacter* character)
         _portrait.SetDimensions(100.0f, 100.0f);
 
     // the characters' name is already translated.
-    _character_name.SetText(character->GetName(), TextStyle("title22"));
+    _character_name = vt_global::GlobalManager->Media().GetCharacterNameText(character, "title22");
 
     // And the rest of the data
     /// tr: level
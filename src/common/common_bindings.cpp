@@ -35,6 +35,8 @@
 #include "common/global/global_skills.h"
 #include "common/global/actors/global_character.h"
 #include "common/global/actors/global_enemy.h"
+#include "engine/mode_manager.h"
+
 #include "modes/battle/battle_target.h"
 
 #include "utils/utils_random.h"
@@ -374,6 +376,11 @@ void BindCommonCode()
             .def("DoesEventExist", &GameEvents::DoesEventExist)
             .def("GetEventValue", &GameEvents::GetEventValue)
             .def("SetEventValue", &GameEvents::SetEventValue)
+            .def("GetEventHandle", &GameEvents::GetEventHandle)
+            .def("DoesEventExistFromHandle", &GameEvents::DoesEventExistFromHandle)
+            .def("GetEventValueFromHandle", &GameEvents::GetEventValueFromHandle)
+            .def("SetEventValueFromHandle", &GameEvents::SetEventValueFromHandle)
+            .def("WatchEvent", &GameEvents::WatchEventFromScript)
         ];
 
         luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_global")
@@ -261,6 +261,12 @@ void DialogueWindow::Clear()
     _portrait_image = nullptr;
 }
 
+void DialogueWindow::PrepareDialogue(const Dialogue& dialogue)
+{
+    for(uint32_t i = 0; i < dialogue.GetLineCount(); ++i)
+        _display_textbox.PrepareText(dialogue.GetLineText(i));
+}
+
 void DialogueWindow::Draw()
 {
     VideoManager->PushState();
@@ -328,6 +334,12 @@ DialogueSupervisor::~DialogueSupervisor()
         delete it->second;
     }
     _dialogues.clear();
+
+    // Cancel the decoding of the portraits never shown.
+    for(std::map<std::string, Speaker>::iterator it = _speakers.begin(); it != _speakers.end(); ++it) {
+        if(!it->second.portrait_filename.empty())
+            TextureManager->CancelPrefetchedImage(it->second.portrait_filename);
+    }
     _speakers.clear();
 }
 
@@ -375,6 +387,23 @@ void DialogueSupervisor::AddDialogue(Dialogue* dialogue)
         return;
     }
     _dialogues.insert(std::make_pair(dialogue->GetDialogueID(), dialogue));
+    _unprepared_dialogues.push_back(dialogue->GetDialogueID());
+}
+
+void DialogueSupervisor::PrepareDialogues()
+{
+    for(size_t i = 0; i < _unprepared_dialogues.size(); ++i) {
+        Dialogue* dialogue = GetDialogue(_unprepared_dialogues[i]);
+        if(dialogue != nullptr)
+            _dialogue_window.PrepareDialogue(*dialogue);
+    }
+    _unprepared_dialogues.clear();
+
+    // Upload the portraits already decoded now rather than on the first lines.
+    for(std::map<std::string, Speaker>::iterator it = _speakers.begin(); it != _speakers.end(); ++it) {
+        if(!it->second.portrait_filename.empty() && TextureManager->IsImageReady(it->second.portrait_filename))
+            _LoadSpeakerPortrait(it->second);
+    }
 }
 
 void DialogueSupervisor::AddSpeaker(const std::string& speaker_id, const std::string& name, const std::string& portrait)
@@ -386,13 +415,10 @@ void DialogueSupervisor::AddSpeaker(const std::string& speaker_id, const std::st
 
     Speaker new_speaker;
     new_speaker.name = MakeUnicodeString(name);
+    // The portrait is decoded in the background, and loaded later on.
     if(!portrait.empty()) {
-        if(!new_speaker.portrait.Load(portrait)) {
-            IF_PRINT_WARNING(COMMON_DEBUG) << "invalid image filename for new portrait: " << portrait << std::endl;
-        }
-        // Make sure the portrait doesn't go over the screen edge.
-        if(new_speaker.portrait.GetHeight() > 130.0f)
-            new_speaker.portrait.SetHeightKeepRatio(130.0f);
+        new_speaker.portrait_filename = portrait;
+        TextureManager->PrefetchImage(portrait);
     }
 
     _speakers[speaker_id] = new_speaker;
@@ -426,13 +452,18 @@ void DialogueSupervisor::ChangeSpeakerPortrait(const std::string& speaker_id, co
         return;
     }
 
-    // Note: we don't have to also check whether or not the active portrait on the dialogue window needs to be
-    // updated since the dialogue window simply retains a pointer to the image object. We only update the StillImage
+    // The previous portrait may not have been loaded yet.
+    Speaker& speaker = it->second;
+    if(!speaker.portrait_filename.empty() && speaker.portrait_filename != portrait)
+        TextureManager->CancelPrefetchedImage(speaker.portrait_filename);
+    speaker.portrait_filename = portrait;
+    TextureManager->PrefetchImage(portrait);
+
+    // Note: the dialogue window simply retains a pointer to the image object, so only the portrait of the current
+    // line speaker has to be loaded right away for the window to show it. We only update the StillImage
     // class object contents in this function, not its address.
-    if(!it->second.portrait.Load(portrait)) {
-        PRINT_WARNING << "Invalid image filename for new portrait: " << portrait << std::endl;
-        return;
-    }
+    if(_current_dialogue != nullptr && _current_dialogue->GetLineSpeaker(_line_counter) == speaker_id)
+        _LoadSpeakerPortrait(speaker);
 }
 
 void DialogueSupervisor::StartDialogue(const std::string& dialogue_id)
@@ -598,10 +629,27 @@ void DialogueSupervisor::_BeginLine()
         _dialogue_window.SetPortraitImage(nullptr);
     } else {
         _dialogue_window.GetNameText().SetText(line_speaker->name);
+        _LoadSpeakerPortrait(*line_speaker);
         _dialogue_window.SetPortraitImage(&(line_speaker->portrait));
     }
 }
 
+void DialogueSupervisor::_LoadSpeakerPortrait(Speaker& speaker)
+{
+    if(speaker.portrait_filename.empty())
+        return;
+
+    // Takes the decoded image, if still requested.
+    if(!speaker.portrait.Load(speaker.portrait_filename)) {
+        PRINT_WARNING << "Invalid image filename for portrait: " << speaker.portrait_filename << std::endl;
+    }
+    // Make sure the portrait doesn't go over the screen edge.
+    else if(speaker.portrait.GetHeight() > 130.0f) {
+        speaker.portrait.SetHeightKeepRatio(130.0f);
+    }
+    speaker.portrait_filename.clear();
+}
+
 void DialogueSupervisor::_EndLine()
 {
     // Determine the next line to read
@@ -79,6 +79,12 @@ public:
     *** member will simply remain a blank image that is drawn to the screen.
     **/
     vt_video::StillImage portrait;
+
+    /** \brief The portrait image file, until the portrait is loaded
+    *** The file is decoded in the background from the moment the portrait is set, and only
+    *** loaded once decoded when the dialogues are prepared, or when the speaker first talks.
+    **/
+    std::string portrait_filename;
 }; // class Speaker
 
 /** ****************************************************************************
@@ -389,6 +395,9 @@ public:
     //! \brief Clears all text from the window
     void Clear();
 
+    //! \brief Lays the lines of a dialogue out ahead of time, so that beginning them doesn't stall.
+    void PrepareDialogue(const Dialogue& dialogue);
+
     //! \brief Draws the dialogue window and all other visuals
     void Draw();
 
@@ -513,6 +522,12 @@ public:
     **/
     virtual void AddDialogue(Dialogue *dialogue);
 
+    /** \brief Lays the lines of the dialogues added since the last call out ahead of time
+    *** This is to be called once the mode scripts are loaded, since the dialogue lines are
+    *** only added after the dialogue itself. The speaker portraits decoded by then are also loaded.
+    **/
+    void PrepareDialogues();
+
     /** \brief Prepares the dialogue manager to begin processing a new dialogue
     *** \param dialogue_id The id number of the dialogue to begin
     **/
@@ -585,6 +600,14 @@ protected:
     //! \brief Holds the text and graphics that should be displayed for the dialogue
     DialogueWindow _dialogue_window;
 
+    //! \brief The ids of the dialogues added but not prepared yet
+    std::vector<std::string> _unprepared_dialogues;
+
+    /** \brief Loads the portrait of a speaker if it isn't already
+    *** This waits for the end of its decoding, if it is still being decoded.
+    **/
+    void _LoadSpeakerPortrait(Speaker& speaker);
+
     //! \brief Updates the dialogue when it is in the line state
     void _UpdateLine();
 
@@ -15,6 +15,7 @@
 #include "common/global/objects/global_armor.h"
 #include "common/global/objects/global_weapon.h"
 
+#include "engine/asset_archive.h"
 #include "script/script_read.h"
 #include "utils/utils_files.h"
 
@@ -69,7 +70,7 @@ GlobalCharacter::GlobalCharacter(uint32_t id, bool initial) :
 
     // Load all the graphic data
     std::string portrait_filename = char_script.ReadString("portrait");
-    if(DoesFileExist(portrait_filename)) {
+    if(vt_system::DoesAssetExist(portrait_filename)) {
         _portrait.Load(portrait_filename);
     }
     else if(!portrait_filename.empty()) {
@@ -78,7 +79,7 @@ GlobalCharacter::GlobalCharacter(uint32_t id, bool initial) :
     }
 
     std::string full_portrait_filename = char_script.ReadString("full_portrait");
-    if(DoesFileExist(full_portrait_filename)) {
+    if(vt_system::DoesAssetExist(full_portrait_filename)) {
         _full_portrait.Load(full_portrait_filename);
     }
     else if(!full_portrait_filename.empty()) {
@@ -88,7 +89,7 @@ GlobalCharacter::GlobalCharacter(uint32_t id, bool initial) :
 
     std::string stamina_icon_filename = char_script.ReadString("stamina_icon");
     bool stamina_icon_loaded = false;
-    if(DoesFileExist(stamina_icon_filename)) {
+    if(vt_system::DoesAssetExist(stamina_icon_filename)) {
         if(_stamina_icon.Load(stamina_icon_filename, 45.0f, 45.0f))
             stamina_icon_loaded = true;
     } else {
@@ -570,6 +571,129 @@ bool GlobalCharacter::SaveCharacter(WriteScriptDescriptor& file)
     return true;
 }
 
+bool GlobalCharacter::LoadCharacter(SaveFileReader& file)
+{
+    Enable(file.ReadBool());
+
+    SetExperienceLevel(static_cast<uint32_t>(file.ReadUInt()));
+    SetUnspentExperiencePoints(static_cast<uint32_t>(file.ReadUInt()));
+    SetTotalExperiencePoints(static_cast<uint32_t>(file.ReadUInt()));
+    _experience_for_next_level = static_cast<int32_t>(file.ReadInt());
+
+    SetMaxHitPoints(static_cast<uint32_t>(file.ReadUInt()));
+    SetHitPoints(static_cast<uint32_t>(file.ReadUInt()));
+    SetMaxSkillPoints(static_cast<uint32_t>(file.ReadUInt()));
+    SetSkillPoints(static_cast<uint32_t>(file.ReadUInt()));
+
+    SetPhysAtk(static_cast<uint32_t>(file.ReadUInt()));
+    SetMagAtk(static_cast<uint32_t>(file.ReadUInt()));
+    SetPhysDef(static_cast<uint32_t>(file.ReadUInt()));
+    SetMagDef(static_cast<uint32_t>(file.ReadUInt()));
+    SetStamina(static_cast<uint32_t>(file.ReadUInt()));
+    SetEvade(file.ReadFloat());
+
+    // Weapon, then head, torso, arm and leg armors. 0 means nothing is equipped.
+    uint32_t equip_id = static_cast<uint32_t>(file.ReadUInt());
+    if (equip_id != 0)
+        EquipWeapon(std::make_shared<GlobalWeapon>(equip_id));
+    for (uint32_t i = 0; i < 4; ++i) {
+        equip_id = static_cast<uint32_t>(file.ReadUInt());
+        if (equip_id != 0)
+            EquipArmor(std::make_shared<GlobalArmor>(equip_id));
+    }
+
+    std::vector<uint32_t> skill_ids;
+    file.ReadUIntVector(skill_ids);
+    for (uint32_t i = 0; i < skill_ids.size(); ++i)
+        AddSkill(skill_ids[i]);
+
+    ResetObtainedSkillNodes();
+    std::vector<uint32_t> skill_node_ids;
+    file.ReadUIntVector(skill_node_ids);
+    SetObtainedSkillNodes(skill_node_ids);
+
+    // Add the current node position as obtained if it is not in the data
+    uint32_t current_character_location = static_cast<uint32_t>(file.ReadUInt());
+    if (current_character_location != std::numeric_limits<uint32_t>::max()) {
+        SetSkillNodeLocation(current_character_location);
+        if (!IsSkillNodeObtained(current_character_location))
+            _obtained_skill_nodes.push_back(current_character_location);
+    }
+
+    ResetActiveStatusEffects();
+    const uint64_t status_effects_count = file.ReadUInt();
+    for (uint64_t i = 0; i < status_effects_count && !file.IsErrorDetected(); ++i) {
+        int32_t status_effect = static_cast<int32_t>(file.ReadInt());
+        int32_t intensity = static_cast<int32_t>(file.ReadInt());
+        uint32_t duration = static_cast<uint32_t>(file.ReadUInt());
+        uint32_t elapsed_time = static_cast<uint32_t>(file.ReadUInt());
+
+        // Check the status effect and intensity validity
+        if (status_effect <= (int32_t)GLOBAL_STATUS_INVALID || status_effect >= (int32_t)GLOBAL_STATUS_TOTAL)
+            continue;
+        if (intensity <= GLOBAL_INTENSITY_INVALID || intensity >= GLOBAL_INTENSITY_TOTAL)
+            continue;
+
+        SetActiveStatusEffect((GLOBAL_STATUS)status_effect,
+                              (GLOBAL_INTENSITY)intensity,
+                              duration, elapsed_time);
+    }
+
+    return !file.IsErrorDetected();
+}
+
+void GlobalCharacter::SaveCharacter(SaveFileWriter& file)
+{
+    file.WriteBool(IsEnabled());
+
+    file.WriteUInt(GetExperienceLevel());
+    file.WriteUInt(GetUnspentExperiencePoints());
+    file.WriteUInt(GetTotalExperiencePoints());
+    file.WriteInt(GetExperienceForNextLevel());
+
+    // The values stored are the unmodified ones.
+    file.WriteUInt(GetMaxHitPoints());
+    file.WriteUInt(GetHitPoints());
+    file.WriteUInt(GetMaxSkillPoints());
+    file.WriteUInt(GetSkillPoints());
+
+    file.WriteUInt(GetPhysAtkBase());
+    file.WriteUInt(GetMagAtkBase());
+    file.WriteUInt(GetPhysDefBase());
+    file.WriteUInt(GetMagDefBase());
+    file.WriteUInt(GetStaminaBase());
+    file.WriteFloat(GetEvadeBase());
+
+    file.WriteUInt(GetEquippedWeapon() ? GetEquippedWeapon()->GetID() : 0);
+    const GLOBAL_OBJECT armor_types[4] = { GLOBAL_OBJECT_HEAD_ARMOR, GLOBAL_OBJECT_TORSO_ARMOR,
+                                           GLOBAL_OBJECT_ARM_ARMOR, GLOBAL_OBJECT_LEG_ARMOR };
+    for (uint32_t i = 0; i < 4; ++i)
+        file.WriteUInt(GetEquippedArmor(armor_types[i]) ? GetEquippedArmor(armor_types[i])->GetID() : 0);
+
+    // The equipment skills will be reloaded through equipment.
+    file.WriteUIntVector(GetPermanentSkills());
+    file.WriteUIntVector(GetObtainedSkillNodes());
+    file.WriteUInt(GetSkillNodeLocation());
+
+    uint32_t status_effects_count = 0;
+    for (uint32_t i = 0; i < _active_status_effects.size(); ++i) {
+        if (_active_status_effects[i].IsActive())
+            ++status_effects_count;
+    }
+
+    file.WriteUInt(status_effects_count);
+    for (uint32_t i = 0; i < _active_status_effects.size(); ++i) {
+        const ActiveStatusEffect& effect = _active_status_effects[i];
+        if (!effect.IsActive())
+            continue;
+
+        file.WriteInt(effect.GetEffect());
+        file.WriteInt(effect.GetIntensity());
+        file.WriteUInt(effect.GetEffectTime());
+        file.WriteUInt(effect.GetElapsedTime());
+    }
+}
+
 bool GlobalCharacter::AddExperiencePoints(uint32_t xp)
 {
     _total_experience_points += xp;
@@ -780,11 +904,20 @@ void GlobalCharacter::_UpdateEquipmentStatusEffects()
         }
     }
 
-    // Actually apply the effects on the character now
+    // Actually apply the effects on the character now.
+    // The passive effects only set the stat modifiers, so the unchanged ones are skipped.
+    const bool apply_all = (_applied_equipment_status_effects.size() != _equipment_status_effects.size());
+    if (apply_all)
+        _applied_equipment_status_effects = _equipment_status_effects;
+
     ReadScriptDescriptor &script_file = vt_global::GlobalManager->GetStatusEffectsScript();
     for (uint32_t i = 0; i < _equipment_status_effects.size(); ++i) {
         GLOBAL_INTENSITY intensity = _equipment_status_effects[i];
 
+        if (!apply_all && _applied_equipment_status_effects[i] == intensity)
+            continue;
+        _applied_equipment_status_effects[i] = intensity;
+
         if (!script_file.OpenTable(i)) {
             PRINT_WARNING << "No status effect defined for this status value: " << i << std::endl;
             continue;
@@ -911,11 +1044,10 @@ bool GlobalCharacter::AddSkill(uint32_t skill_id, bool permanently)
 
 void GlobalCharacter::_UpdatesAvailableSkills()
 {
-    // Clears out the skills <and parse the current equipment to tells which ones are available.
-    for (uint32_t i = 0; i < _skills.size(); ++i) {
-        delete _skills[i];
-    }
-    _skills.clear();
+    // Clears out the skills and parse the current equipment to tells which ones are available.
+    // The previous skills are kept aside to be reused, as loading a skill runs its script.
+    std::vector<GlobalSkill *> previous_skills;
+    previous_skills.swap(_skills);
     _skills_id.clear();
 
     _bare_hands_skills.clear();
@@ -926,7 +1058,7 @@ void GlobalCharacter::_UpdatesAvailableSkills()
     // First readd the permanent ones
     for (uint32_t i = 0; i < _permanent_skills.size(); ++i) {
         // As the skill is already permanent, don't readd it as one.
-        AddSkill(_permanent_skills[i], false);
+        _AddAvailableSkill(_permanent_skills[i], previous_skills);
     }
 
     // Now, add skill obtained through current equipment.
@@ -934,7 +1066,7 @@ void GlobalCharacter::_UpdatesAvailableSkills()
         const std::vector<uint32_t>& wpn_skills = _equipped_weapon->GetEquipmentSkills();
 
         for (uint32_t i = 0; i < wpn_skills.size(); ++i)
-            AddSkill(wpn_skills[i], false);
+            _AddAvailableSkill(wpn_skills[i], previous_skills);
     }
 
     for (uint32_t i = 0; i < _equipped_armors.size(); ++i) {
@@ -944,8 +1076,55 @@ void GlobalCharacter::_UpdatesAvailableSkills()
         const std::vector<uint32_t>& armor_skills = _equipped_armors[i]->GetEquipmentSkills();
 
         for (uint32_t j = 0; j < armor_skills.size(); ++j)
-            AddSkill(armor_skills[j], false);
+            _AddAvailableSkill(armor_skills[j], previous_skills);
+    }
+
+    // Deletes the skills no longer available.
+    for (uint32_t i = 0; i < previous_skills.size(); ++i)
+        delete previous_skills[i];
+}
+
+void GlobalCharacter::_AddAvailableSkill(uint32_t skill_id, std::vector<GlobalSkill *>& previous_skills)
+{
+    if (HasSkill(skill_id))
+        return;
+
+    GlobalSkill* skill = nullptr;
+    for (uint32_t i = 0; i < previous_skills.size(); ++i) {
+        if (previous_skills[i]->GetID() != skill_id)
+            continue;
+
+        skill = previous_skills[i];
+        previous_skills.erase(previous_skills.begin() + i);
+        break;
+    }
+
+    if (skill == nullptr) {
+        AddSkill(skill_id, false);
+        return;
+    }
+
+    switch(skill->GetType()) {
+    case GLOBAL_SKILL_WEAPON:
+        _weapon_skills.push_back(skill);
+        break;
+    case GLOBAL_SKILL_MAGIC:
+        _magic_skills.push_back(skill);
+        break;
+    case GLOBAL_SKILL_SPECIAL:
+        _special_skills.push_back(skill);
+        break;
+    case GLOBAL_SKILL_BARE_HANDS:
+        _bare_hands_skills.push_back(skill);
+        break;
+    default:
+        // Already warned about when the skill was first added.
+        delete skill;
+        return;
     }
+
+    _skills_id.push_back(skill_id);
+    _skills.push_back(skill);
 }
 
 vt_video::AnimatedImage* GlobalCharacter::RetrieveBattleAnimation(const std::string &name)
@@ -17,6 +17,8 @@
 #include "common/global/status_effects/global_active_effect.h"
 #include "global_attack_point.h"
 
+#include "common/global/global_save_file.h"
+
 #include <memory>
 #include <map>
 
@@ -78,6 +80,11 @@ public:
     **/
     bool SaveCharacter(vt_script::WriteScriptDescriptor& file);
 
+    //! \brief Binary saved game versions of the functions above.
+    //! The id is handled by the character handler.
+    bool LoadCharacter(SaveFileReader& file);
+    void SaveCharacter(SaveFileWriter& file);
+
     //! \brief Tells whether a character is in the visible game formation
     void Enable(bool enable) {
         _enabled = enable;
@@ -460,6 +467,12 @@ protected:
     **/
     std::vector<GLOBAL_INTENSITY> _equipment_status_effects;
 
+    /** \brief The equipment status effect intensities last applied on the character stats.
+    *** Only the status effects whose intensity changed since are applied again on equipping,
+    *** as each one costs a status effect script call. Empty until applied once.
+    **/
+    std::vector<GLOBAL_INTENSITY> _applied_equipment_status_effects;
+
     /** \brief Active status effects currently applied on the character.
     *** Active status effects are effects not applied through equipment, but rather through
     *** battle wounds, dungeon trap, potions from the menu, ...
@@ -472,9 +485,17 @@ protected:
     //! \brief Updates the equipment status effects.
     void _UpdateEquipmentStatusEffects();
 
-    //! \brief Recomputes which skills are available, based on equipment and permanent skills.
+    /** \brief Recomputes which skills are available, based on equipment and permanent skills.
+    *** The skills still available are kept, so that only the new ones are loaded from their scripts.
+    **/
     void _UpdatesAvailableSkills();
 
+    /** \brief Makes a skill available, reusing it if it was among the previous skills.
+    *** \param skill_id The id of the skill to make available.
+    *** \param previous_skills The skills available before, the reused one being removed from it.
+    **/
+    void _AddAvailableSkill(uint32_t skill_id, std::vector<GlobalSkill *>& previous_skills);
+
 private:
     //! \brief The amount of XP the character can spend to buy skill nodes
     uint32_t _unspent_experience_points;
@@ -141,13 +141,24 @@ void CharacterHandler::SwapCharactersByIndex(uint32_t first_index, uint32_t seco
 void CharacterHandler::ClearAllData()
 {
     for(std::map<uint32_t, GlobalCharacter *>::iterator it = _characters.begin(); it != _characters.end(); ++it) {
-        delete it->second;
+        if(_keep_cleared_characters)
+            _kept_characters.push_back(it->second);
+        else
+            delete it->second;
     }
     _characters.clear();
     _ordered_characters.clear();
     _active_party.RemoveAllCharacters();
 }
 
+void CharacterHandler::ReleaseKeptCharacters()
+{
+    for(uint32_t i = 0; i < _kept_characters.size(); ++i)
+        delete _kept_characters[i];
+    _kept_characters.clear();
+    _keep_cleared_characters = false;
+}
+
 bool CharacterHandler::LoadCharacters(vt_script::ReadScriptDescriptor& file)
 {
     // Load characters into the party in the correct order
@@ -221,4 +232,35 @@ void CharacterHandler::SaveCharacters(vt_script::WriteScriptDescriptor& file)
     file.WriteLine("},"); // characters
 }
 
+bool CharacterHandler::LoadCharacters(SaveFileReader& file)
+{
+    // The characters are saved in the party order
+    const uint64_t count = file.ReadUInt();
+    for (uint64_t i = 0; i < count && !file.IsErrorDetected(); ++i) {
+        uint32_t id = static_cast<uint32_t>(file.ReadUInt());
+        GlobalCharacter* character = new GlobalCharacter(id, false);
+        if (!character->LoadCharacter(file)) {
+            delete character;
+            PRINT_ERROR << "Invalid character id " << id << " in " << file.GetFilename() << std::endl;
+            return false;
+        }
+        AddCharacter(character);
+    }
+
+    if (_characters.empty()) {
+        PRINT_ERROR << "No characters were added by save game file: " << file.GetFilename() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CharacterHandler::SaveCharacters(SaveFileWriter& file)
+{
+    file.WriteUInt(_ordered_characters.size());
+    for (uint32_t i = 0; i < _ordered_characters.size(); ++i) {
+        file.WriteUInt(_ordered_characters[i]->GetID());
+        _ordered_characters[i]->SaveCharacter(file);
+    }
+}
+
 } // namespace vt_global
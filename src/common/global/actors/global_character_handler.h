@@ -16,6 +16,8 @@
 #include "script/script_read.h"
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
 #include <map>
 
 namespace vt_global
@@ -30,11 +32,14 @@ class GlobalCharacter;
 class CharacterHandler
 {
 public:
-    explicit CharacterHandler()
+    explicit CharacterHandler() :
+        _keep_cleared_characters(false)
     {}
 
     ~CharacterHandler()
-    {}
+    {
+        ReleaseKeptCharacters();
+    }
 
     /** \brief Adds a new character to the party with its initial settings
     *** \param id The ID number of the character to add to the party.
@@ -101,9 +106,24 @@ public:
     //! \brief Resets the data. Used in new games
     void ClearAllData();
 
+    /** \brief Makes ClearAllData() keep the characters it removes alive, until ReleaseKeptCharacters().
+    *** Used when loading a game, so that the images the loaded characters share with the previous ones
+    *** aren't freed and loaded again.
+    **/
+    void KeepClearedCharacters() {
+        _keep_cleared_characters = true;
+    }
+
+    //! \brief Deletes the characters kept by ClearAllData(), and stops keeping them.
+    void ReleaseKeptCharacters();
+
     bool LoadCharacters(vt_script::ReadScriptDescriptor& file);
     void SaveCharacters(vt_script::WriteScriptDescriptor& file);
 
+    //! \brief Binary saved game versions of the functions above.
+    bool LoadCharacters(SaveFileReader& file);
+    void SaveCharacters(SaveFileWriter& file);
+
 private:
     /** \brief A map containing all characters that the player has discovered
     *** This map contains all characters that the player has met with, regardless of whether or not they are in the active party.
@@ -121,6 +141,10 @@ private:
     *** This party can be up to four characters, and should always contain at least one character.
     **/
     GlobalParty _active_party;
+
+    //! \brief Whether ClearAllData() keeps the characters, and the characters it kept.
+    bool _keep_cleared_characters;
+    std::vector<GlobalCharacter *> _kept_characters;
 };
 
 } // namespace vt_global
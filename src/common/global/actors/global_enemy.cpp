@@ -26,34 +26,40 @@ namespace vt_global
 
 extern bool GLOBAL_DEBUG;
 
-GlobalEnemy::GlobalEnemy(uint32_t id) :
-    GlobalActor(),
-    _experience_points(0),
-    _sprite_width(0),
-    _sprite_height(0),
-    _drunes_dropped(0)
+std::map<uint32_t, std::shared_ptr<const GlobalEnemyArchetype> > GlobalEnemy::_archetypes;
+
+GlobalEnemyArchetype::GlobalEnemyArchetype() :
+    sprite_width(0),
+    sprite_height(0),
+    hit_points(0),
+    skill_points(0),
+    experience_points(0),
+    phys_atk(0),
+    mag_atk(0),
+    phys_def(0),
+    mag_def(0),
+    stamina(0),
+    evade(0.0f),
+    drunes(0)
 {
-    _id = id;
-
-    if(_id == 0) {
-        PRINT_ERROR << "invalid id for loading enemy data: " << _id << std::endl;
-        return;
-    }
+}
 
+bool GlobalEnemyArchetype::Load(uint32_t id)
+{
     // Open the script file and table that store the enemy data
     ReadScriptDescriptor& enemy_data = GlobalManager->GetEnemiesScript();
 
-    if (!enemy_data.OpenTable(_id)) {
-        PRINT_ERROR << "Failed to open the enemies[" << _id << "] table in: "
+    if (!enemy_data.OpenTable(id)) {
+        PRINT_ERROR << "Failed to open the enemies[" << id << "] table in: "
             << enemy_data.GetFilename() << std::endl;
-        return;
+        return false;
     }
 
     // Load the enemy's name and sprite data
-    _name = MakeUnicodeString(enemy_data.ReadString("name"));
+    name = MakeUnicodeString(enemy_data.ReadString("name"));
 
     // Attempt to load the animations for each harm levels
-    _battle_animations.assign(GLOBAL_ENEMY_HURT_TOTAL, AnimatedImage());
+    battle_animations.assign(GLOBAL_ENEMY_HURT_TOTAL, AnimatedImage());
     if (enemy_data.OpenTable("battle_animations" )) {
 
         std::vector<uint32_t> animations_id;
@@ -62,67 +68,65 @@ GlobalEnemy::GlobalEnemy(uint32_t id) :
             uint32_t anim_id = animations_id[i];
             if (anim_id >= GLOBAL_ENEMY_HURT_TOTAL) {
                 PRINT_WARNING << "Invalid table id in 'battle_animations' table for enemy: "
-                    << _id << std::endl;
+                    << id << std::endl;
                 continue;
             }
 
-            _battle_animations[anim_id].LoadFromAnimationScript(enemy_data.ReadString(anim_id));
+            battle_animations[anim_id].LoadFromAnimationScript(enemy_data.ReadString(anim_id));
 
             // Updates the sprite dimensions
-            if (_battle_animations[anim_id].GetWidth() > _sprite_width)
-                _sprite_width =_battle_animations[anim_id].GetWidth();
-            if (_battle_animations[anim_id].GetHeight() > _sprite_height)
-                _sprite_height =_battle_animations[anim_id].GetHeight();
+            if (battle_animations[anim_id].GetWidth() > sprite_width)
+                sprite_width = battle_animations[anim_id].GetWidth();
+            if (battle_animations[anim_id].GetHeight() > sprite_height)
+                sprite_height = battle_animations[anim_id].GetHeight();
         }
 
         enemy_data.CloseTable(); // battle_animations
     }
     else {
-        PRINT_WARNING << "No 'battle_animations' table for enemy: " << _id << std::endl;
+        PRINT_WARNING << "No 'battle_animations' table for enemy: " << id << std::endl;
     }
 
     std::string stamina_icon_filename = enemy_data.ReadString("stamina_icon");
     if(!stamina_icon_filename.empty()) {
-        if(!_stamina_icon.Load(stamina_icon_filename)) {
+        if(!stamina_icon.Load(stamina_icon_filename)) {
             PRINT_WARNING << "Invalid stamina icon image: " << stamina_icon_filename
-                          << " for enemy: " << MakeStandardString(_name) << ". Loading default one." << std::endl;
+                          << " for enemy: " << MakeStandardString(name) << ". Loading default one." << std::endl;
 
-            _stamina_icon.Load("data/battles/stamina_icons/default_stamina_icon.png");
+            stamina_icon.Load("data/battles/stamina_icons/default_stamina_icon.png");
         }
     } else {
-        _stamina_icon.Load("data/battles/stamina_icons/default_stamina_icon.png");
+        stamina_icon.Load("data/battles/stamina_icons/default_stamina_icon.png");
     }
 
     // Loads enemy battle animation scripts
     if (enemy_data.OpenTable("scripts")) {
-        _death_script_filename = enemy_data.ReadString("death");
-        _ai_script_filename = enemy_data.ReadString("battle_ai");
+        death_script_filename = enemy_data.ReadString("death");
+        ai_script_filename = enemy_data.ReadString("battle_ai");
         enemy_data.CloseTable();
     }
 
     if (enemy_data.OpenTable("base_stats")) {
-        _max_hit_points = enemy_data.ReadUInt("hit_points");
-        _hit_points = _max_hit_points;
-        _max_skill_points = enemy_data.ReadUInt("skill_points");
-        _skill_points = _max_skill_points;
-        _experience_points = enemy_data.ReadUInt("experience_points");
-        _char_phys_atk.SetBase(enemy_data.ReadUInt("phys_atk"));
-        _char_mag_atk.SetBase(enemy_data.ReadUInt("mag_atk"));
-        _char_phys_def.SetBase(enemy_data.ReadUInt("phys_def"));
-        _char_mag_def.SetBase(enemy_data.ReadUInt("mag_def"));
-        _stamina.SetBase(enemy_data.ReadUInt("stamina"));
-        _evade.SetBase(enemy_data.ReadFloat("evade"));
-        _drunes_dropped = enemy_data.ReadUInt("drunes");
+        hit_points = enemy_data.ReadUInt("hit_points");
+        skill_points = enemy_data.ReadUInt("skill_points");
+        experience_points = enemy_data.ReadUInt("experience_points");
+        phys_atk = enemy_data.ReadUInt("phys_atk");
+        mag_atk = enemy_data.ReadUInt("mag_atk");
+        phys_def = enemy_data.ReadUInt("phys_def");
+        mag_def = enemy_data.ReadUInt("mag_def");
+        stamina = enemy_data.ReadUInt("stamina");
+        evade = enemy_data.ReadFloat("evade");
+        drunes = enemy_data.ReadUInt("drunes");
         enemy_data.CloseTable();
     }
 
-    // Create the attack points for the enemy
+    // Read the attack points, whose owners are set by each enemy
     if (enemy_data.OpenTable("attack_points")) {
         uint32_t ap_size = enemy_data.GetTableSize();
         for(uint32_t i = 1; i <= ap_size; ++i) {
-            _attack_points.push_back(new GlobalAttackPoint(this));
+            attack_points.push_back(GlobalAttackPoint(nullptr));
             if (enemy_data.OpenTable(i)) {
-                if(_attack_points.back()->LoadData(enemy_data) == false) {
+                if(attack_points.back().LoadData(enemy_data) == false) {
                     IF_PRINT_WARNING(GLOBAL_DEBUG) << "Failed to load data for an attack point: "
                         << i << std::endl;
                 }
@@ -135,7 +139,7 @@ GlobalEnemy::GlobalEnemy(uint32_t id) :
     // Add the set of skills for the enemy
     if (enemy_data.OpenTable("skills")) {
         for(uint32_t i = 1; i <= enemy_data.GetTableSize(); ++i) {
-            _skill_set.push_back(enemy_data.ReadUInt(i));
+            skill_set.push_back(enemy_data.ReadUInt(i));
         }
         enemy_data.CloseTable();
     }
@@ -144,19 +148,86 @@ GlobalEnemy::GlobalEnemy(uint32_t id) :
     if (enemy_data.OpenTable("drop_objects")) {
         for(uint32_t i = 1; i <= enemy_data.GetTableSize(); ++i) {
             enemy_data.OpenTable(i);
-            _dropped_objects.push_back(enemy_data.ReadUInt(1));
-            _dropped_chance.push_back(enemy_data.ReadFloat(2));
+            dropped_objects.push_back(enemy_data.ReadUInt(1));
+            dropped_chance.push_back(enemy_data.ReadFloat(2));
             enemy_data.CloseTable();
         }
         enemy_data.CloseTable();
     }
 
-    enemy_data.CloseTable(); // enemies[_id]
+    enemy_data.CloseTable(); // enemies[id]
 
     if(enemy_data.IsErrorDetected()) {
         PRINT_WARNING << "One or more errors occurred while reading the enemy data - they are listed below"
                       << std::endl << enemy_data.GetErrorMessages() << std::endl;
     }
+    return true;
+}
+
+std::shared_ptr<const GlobalEnemyArchetype> GlobalEnemy::GetArchetype(uint32_t id)
+{
+    std::map<uint32_t, std::shared_ptr<const GlobalEnemyArchetype> >::const_iterator it = _archetypes.find(id);
+    if(it != _archetypes.end())
+        return it->second;
+
+    std::shared_ptr<GlobalEnemyArchetype> archetype = std::make_shared<GlobalEnemyArchetype>();
+    if(!archetype->Load(id))
+        return nullptr;
+
+    _archetypes[id] = archetype;
+    return archetype;
+}
+
+void GlobalEnemy::ClearArchetypes()
+{
+    _archetypes.clear();
+}
+
+GlobalEnemy::GlobalEnemy(uint32_t id) :
+    GlobalActor(),
+    _experience_points(0),
+    _sprite_width(0),
+    _sprite_height(0),
+    _drunes_dropped(0)
+{
+    _id = id;
+
+    if(_id == 0) {
+        PRINT_ERROR << "invalid id for loading enemy data: " << _id << std::endl;
+        return;
+    }
+
+    _archetype = GetArchetype(_id);
+    if(!_archetype)
+        return;
+    const GlobalEnemyArchetype& archetype = *_archetype;
+
+    _name = archetype.name;
+    _battle_animations = archetype.battle_animations;
+    _sprite_width = archetype.sprite_width;
+    _sprite_height = archetype.sprite_height;
+    _stamina_icon = archetype.stamina_icon;
+    _death_script_filename = archetype.death_script_filename;
+    _ai_script_filename = archetype.ai_script_filename;
+
+    _max_hit_points = archetype.hit_points;
+    _hit_points = _max_hit_points;
+    _max_skill_points = archetype.skill_points;
+    _skill_points = _max_skill_points;
+    _experience_points = archetype.experience_points;
+    _char_phys_atk.SetBase(archetype.phys_atk);
+    _char_mag_atk.SetBase(archetype.mag_atk);
+    _char_phys_def.SetBase(archetype.phys_def);
+    _char_mag_def.SetBase(archetype.mag_def);
+    _stamina.SetBase(archetype.stamina);
+    _evade.SetBase(archetype.evade);
+    _drunes_dropped = archetype.drunes;
+
+    for(uint32_t i = 0; i < archetype.attack_points.size(); ++i) {
+        GlobalAttackPoint* attack_point = new GlobalAttackPoint(archetype.attack_points[i]);
+        attack_point->SetActorOwner(this);
+        _attack_points.push_back(attack_point);
+    }
 
     // stats and skills.
     _Initialize();
@@ -195,8 +266,8 @@ void GlobalEnemy::_Initialize()
 {
     // Add all new skills that should be available at the current experience level
     _skills.clear();
-    for(uint32_t i = 0; i < _skill_set.size(); ++i)
-        AddSkill(_skill_set[i]);
+    for(uint32_t i = 0; i < _archetype->skill_set.size(); ++i)
+        AddSkill(_archetype->skill_set[i]);
 
     if(_skills.empty())
         PRINT_WARNING << "No skills were added for the enemy: " << _id << std::endl;
@@ -226,9 +297,12 @@ std::vector<std::shared_ptr<GlobalObject>> GlobalEnemy::DetermineDroppedObjects(
 {
     std::vector<std::shared_ptr<GlobalObject>> result;
 
-    for (uint32_t i = 0; i < _dropped_objects.size(); ++i) {
-        if (RandomFloat() < _dropped_chance[i]) {
-            std::shared_ptr<GlobalObject> global_object = GlobalCreateNewObject(_dropped_objects[i]);
+    if(!_archetype)
+        return result;
+
+    for (uint32_t i = 0; i < _archetype->dropped_objects.size(); ++i) {
+        if (RandomFloat() < _archetype->dropped_chance[i]) {
+            std::shared_ptr<GlobalObject> global_object = GlobalCreateNewObject(_archetype->dropped_objects[i]);
             result.push_back(global_object);
         }
     }
@@ -12,8 +12,10 @@
 #define __GLOBAL_ENEMY_HEADER__
 
 #include "global_actor.h"
+#include "global_attack_point.h"
 #include "common/global/objects/global_object.h"
 
+#include <map>
 #include <memory>
 
 namespace vt_script
@@ -33,6 +35,65 @@ enum GLOBAL_ENEMY_HURT {
     GLOBAL_ENEMY_HURT_TOTAL    = 4,
 };
 
+/** ****************************************************************************
+*** \brief The data of an enemy type, as read from the enemies script
+***
+*** It is parsed once per enemy id and shared by every GlobalEnemy of that
+*** type: The battle animations copied from it share its frames textures.
+*** ***************************************************************************/
+class GlobalEnemyArchetype
+{
+public:
+    GlobalEnemyArchetype();
+
+    //! \brief Reads the enemies[id] table of the enemies script.
+    //! \return False if the table couldn't be opened.
+    bool Load(uint32_t id);
+
+    vt_utils::ustring name;
+
+    //! \brief The animations of each harm level, GLOBAL_ENEMY_HURT_TOTAL of them.
+    std::vector<vt_video::AnimatedImage> battle_animations;
+
+    //! \brief The largest dimensions of the battle animations in pixels
+    uint32_t sprite_width, sprite_height;
+
+    vt_video::StillImage stamina_icon;
+
+    std::string death_script_filename;
+    std::string ai_script_filename;
+
+    //! \brief The base stats, before their randomization
+    //@{
+    uint32_t hit_points;
+    uint32_t skill_points;
+    uint32_t experience_points;
+    uint32_t phys_atk;
+    uint32_t mag_atk;
+    uint32_t phys_def;
+    uint32_t mag_def;
+    uint32_t stamina;
+    float evade;
+    uint32_t drunes;
+    //@}
+
+    //! \brief The attack points, without owners: Each enemy copies them.
+    std::vector<GlobalAttackPoint> attack_points;
+
+    //! \brief The IDs of the skills the enemy can use.
+    std::vector<uint32_t> skill_set;
+
+    /** \brief Dropped object containers
+    *** These two vectors are of the same size. dropped_objects contains the IDs of the objects that the enemy
+    *** may drop. dropped_chance contains a value from 0.0f to 1.0f that determines the probability of the
+    *** enemy dropping that object.
+    **/
+    //@{
+    std::vector<uint32_t> dropped_objects;
+    std::vector<float> dropped_chance;
+    //@}
+};
+
 /** ****************************************************************************
 *** \brief Representation of enemies that fight in battles
 ***
@@ -98,7 +159,20 @@ public:
     }
     //@}
 
+    /** \brief Returns the shared data of an enemy type, parsing it on first use.
+    *** \return nullptr if the enemy data couldn't be read.
+    **/
+    static std::shared_ptr<const GlobalEnemyArchetype> GetArchetype(uint32_t id);
+
+    /** \brief Frees the enemy types parsed, when their enemies won't be met anymore.
+    *** The enemies still alive keep their own type data.
+    **/
+    static void ClearArchetypes();
+
 protected:
+    //! \brief The data of the enemy type, with its skills and dropped objects.
+    std::shared_ptr<const GlobalEnemyArchetype> _archetype;
+
     //! \brief The Amount of XP the enemy holds
     uint32_t _experience_points;
 
@@ -108,22 +182,6 @@ protected:
     //! \brief The amount of drunes that the enemy will drop
     uint32_t _drunes_dropped;
 
-    /** \brief Dropped object containers
-    *** These two vectors are of the same size. _dropped_objects contains the IDs of the objects that the enemy
-    *** may drop. _dropped_chance contains a value from 0.0f to 1.0f that determines the probability of the
-    *** enemy dropping that object.
-    **/
-    //@{
-    std::vector<uint32_t> _dropped_objects;
-    std::vector<float> _dropped_chance;
-    //@}
-
-    /** \brief Contains all of the possible skills that the enemy may possess
-    *** This container holds the IDs of all skills that the enemy may execute in battle.
-    *** The Initialize() function uses this data to populates the GlobalActor _skills container.
-    **/
-    std::vector<uint32_t> _skill_set;
-
     /** \brief The battle sprite animations for the enemy
     *** Each enemy has four animations representing damage levels of 0%, 33%, 66%, and 100%. This vector thus
     *** always has a size of four holding each of these image frames. The first element contains the 0%
@@ -139,6 +197,9 @@ protected:
     *** \note Certain enemies can skip the stat randomization step.
     **/
     void _Initialize();
+
+    //! \brief The enemy types parsed, by enemy id.
+    static std::map<uint32_t, std::shared_ptr<const GlobalEnemyArchetype> > _archetypes;
 }; // class GlobalEnemy : public GlobalActor
 
 } // namespace vt_global
@@ -10,41 +10,84 @@
 
 #include "global_event_group.h"
 
-#include "utils/utils_common.h"
-
 namespace vt_global {
 
-extern bool GLOBAL_DEBUG;
+//! \brief The initial number of slots of the event handle tables.
+const uint32_t EVENT_HANDLE_TABLE_MIN_SLOTS = 64;
+
+EventHandleTable::EventHandleTable() :
+    _slots(EVENT_HANDLE_TABLE_MIN_SLOTS),
+    _size(0)
+{
+}
 
-void GlobalEventGroup::AddNewEvent(const std::string &event_name, int32_t event_value)
+uint32_t EventHandleTable::Find(uint32_t scope, const std::string& name) const
 {
-    if(DoesEventExist(event_name)) {
-        IF_PRINT_WARNING(GLOBAL_DEBUG) << "an event with the desired name \"" << event_name << "\" already existed in this group: "
-                                       << _group_name << std::endl;
-        return;
+    const uint32_t hash = _Hash(scope, name);
+    const uint32_t mask = _slots.size() - 1;
+
+    // The table is never full, so an empty slot ends the search.
+    for (uint32_t i = hash & mask; _slots[i].handle != INVALID_EVENT_HANDLE; i = (i + 1) & mask) {
+        const _Slot& slot = _slots[i];
+        if (slot.hash == hash && slot.scope == scope && slot.name == name)
+            return slot.handle;
     }
-    _events.insert(std::make_pair(event_name, event_value));
+    return INVALID_EVENT_HANDLE;
 }
 
-int32_t GlobalEventGroup::GetEvent(const std::string &event_name)
+void EventHandleTable::Insert(uint32_t scope, const std::string& name, uint32_t handle)
 {
-    std::map<std::string, int32_t>::iterator event_iter = _events.find(event_name);
-    if(event_iter == _events.end()) {
-        IF_PRINT_WARNING(GLOBAL_DEBUG) << "an event with the specified name \"" << event_name << "\" did not exist in this group: "
-                                       << _group_name << std::endl;
-        return 0;
+    // Keep the table at most three quarters full.
+    if ((_size + 1) * 4 > _slots.size() * 3)
+        _Grow();
+
+    const uint32_t hash = _Hash(scope, name);
+    const uint32_t mask = _slots.size() - 1;
+    uint32_t i = hash & mask;
+    while (_slots[i].handle != INVALID_EVENT_HANDLE)
+        i = (i + 1) & mask;
+
+    _Slot& slot = _slots[i];
+    slot.handle = handle;
+    slot.scope = scope;
+    slot.hash = hash;
+    slot.name = name;
+    ++_size;
+}
+
+uint32_t EventHandleTable::_Hash(uint32_t scope, const std::string& name)
+{
+    // FNV-1a, over the scope and then the name.
+    uint32_t hash = 2166136261u;
+    for (uint32_t i = 0; i < 4; ++i) {
+        hash ^= (scope >> (8 * i)) & 0xFF;
+        hash *= 16777619u;
     }
-    return event_iter->second;
+    for (size_t i = 0; i < name.size(); ++i) {
+        hash ^= static_cast<uint8_t>(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
 }
 
-void GlobalEventGroup::SetEvent(const std::string &event_name, int32_t event_value)
+void EventHandleTable::_Grow()
 {
-    std::map<std::string, int32_t>::iterator event_iter = _events.find(event_name);
-    if(event_iter == _events.end()) {
-        AddNewEvent(event_name, event_value);
-        return;
+    std::vector<_Slot> old_slots(_slots.size() * 2);
+    old_slots.swap(_slots);
+
+    const uint32_t mask = _slots.size() - 1;
+    for (uint32_t j = 0; j < old_slots.size(); ++j) {
+        if (old_slots[j].handle == INVALID_EVENT_HANDLE)
+            continue;
+
+        uint32_t i = old_slots[j].hash & mask;
+        while (_slots[i].handle != INVALID_EVENT_HANDLE)
+            i = (i + 1) & mask;
+        _slots[i].handle = old_slots[j].handle;
+        _slots[i].scope = old_slots[j].scope;
+        _slots[i].hash = old_slots[j].hash;
+        _slots[i].name.swap(old_slots[j].name);
     }
-    event_iter->second = event_value;
 }
 
 } // namespace vt_global
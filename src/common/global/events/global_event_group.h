@@ -11,14 +11,66 @@
 #ifndef __GLOBAL_EVENT_GROUP_HEADER__
 #define __GLOBAL_EVENT_GROUP_HEADER__
 
+#include <cstdint>
 #include <string>
-#include <map>
+#include <vector>
 
 namespace vt_global
 {
 
+//! \brief The handle given to unknown events and event groups.
+const uint32_t INVALID_EVENT_HANDLE = 0xFFFFFFFF;
+
+/** ****************************************************************************
+*** \brief An open-addressing hash table giving the handles of event and group names
+***
+*** Each name is looked up within a scope, so that event names are told apart
+*** by group without building a combined key: The group handle is used as the
+*** scope of its events. The handles themselves are chosen by the caller, and
+*** are indices in its dense storage.
+*** ***************************************************************************/
+class EventHandleTable
+{
+public:
+    EventHandleTable();
+
+    //! \brief Returns the handle of a name, or INVALID_EVENT_HANDLE when it was never inserted.
+    uint32_t Find(uint32_t scope, const std::string& name) const;
+
+    //! \brief Inserts a name which isn't in the table yet.
+    void Insert(uint32_t scope, const std::string& name, uint32_t handle);
+
+private:
+    class _Slot
+    {
+    public:
+        _Slot() :
+            handle(INVALID_EVENT_HANDLE),
+            scope(0),
+            hash(0)
+        {}
+
+        //! \brief INVALID_EVENT_HANDLE when the slot is empty.
+        uint32_t handle;
+        uint32_t scope;
+        uint32_t hash;
+        std::string name;
+    };
+
+    //! \brief The slots, probed linearly. Their number is a power of two.
+    std::vector<_Slot> _slots;
+
+    //! \brief The number of used slots.
+    uint32_t _size;
+
+    static uint32_t _Hash(uint32_t scope, const std::string& name);
+
+    //! \brief Doubles the number of slots, keeping every handle.
+    void _Grow();
+};
+
 /** ****************************************************************************
-*** \brief A container that manages the occurences of several related game events
+*** \brief A group of related game events
 ***
 *** Events are nothing more than a string-integer pair. The string
 *** represents the name of the event while the integer takes on various meanings
@@ -29,78 +81,54 @@ namespace vt_global
 *** possible actions to take, in which the integer value would represent the
 *** option taken.
 ***
-*** Because we want to continually look-up whether or not an event has occured,
-*** it is not efficient to store all game events in a single container (the
-*** larger the number of events, the longer the event search time). Instead,
-*** this class collectively represents a group of related events. A typical
-*** event group could represent all of the events that occured on a particular
-*** map, for instance.
+*** The events values are stored by the GameEvents class, each group only
+*** listing the handles of its events. A typical event group could represent
+*** all of the events that occured on a particular map, for instance.
 ***
 *** \note Other parts of the code should not have a need to construct objects of
-*** this class. The GameGlobal class maintains a container of GlobalEventGroup
+*** this class. The GameEvents class maintains a container of GlobalEventGroup
 *** objects and provides methods to allow the creation, modification, and
-*** retrieval of these objects.
+*** retrieval of the events.
 *** ***************************************************************************/
 class GlobalEventGroup
 {
 public:
     //! \param group_name The name of the group to create (this can not be changed)
     explicit GlobalEventGroup(const std::string &group_name) :
-        _group_name(group_name) {}
+        _group_name(group_name),
+        _used(false)
+    {}
 
-    ~GlobalEventGroup() {}
+    const std::string& GetGroupName() const {
+        return _group_name;
+    }
 
-    /** \brief Queries whether or not an event of a given name exists in the group
-    *** \param event_name The name of the event to check for
-    *** \return True if the event name was found in the group, false if it was not
-    **/
-    bool DoesEventExist(const std::string &event_name) {
-        if(_events.find(event_name) != _events.end()) return true;
-        else return false;
+    //! \brief The handles of the events known in this group, set or not, in creation order.
+    const std::vector<uint32_t>& GetEventHandles() const {
+        return _event_handles;
     }
 
-    /** \brief Adds a new event to the group
-    *** \param event_name The name of the event to add
-    *** \param event_value The value of the event to add (default value is zero)
-    *** \note If an event by the given name already exists, a warning will be printed and no addition
-    *** or modification of any kind will take place
-    **/
-    void AddNewEvent(const std::string &event_name, int32_t event_value = 0);
-
-    /** \brief Retrieves the value of a specific event in the group
-    *** \param event_name The name of the event to retrieve
-    *** \return The value of the event, or 0 if there is no event corresponding to
-    *** the requested event named
-    **/
-    int32_t GetEvent(const std::string &event_name);
-
-    /** \brief Sets the value for an existing event
-    *** \param event_name The name of the event whose value should be changed
-    *** \param event_value The value to set for the event.
-    *** \note If the event by the given name is not found, the event group will be created.
-    **/
-    void SetEvent(const std::string &event_name, int32_t event_value);
-
-    //! \brief Returns a copy of the name of this group
-    std::string GetGroupName() const {
-        return _group_name;
+    void AddEventHandle(uint32_t event_handle) {
+        _event_handles.push_back(event_handle);
     }
 
-    //! \brief Returns an immutable reference to the private _events container
-    const std::map<std::string, int32_t>& GetEvents() const {
-        return _events;
+    //! \brief Whether the group is part of the game data, even without any event set.
+    bool IsUsed() const {
+        return _used;
+    }
+
+    void SetUsed(bool used) {
+        _used = used;
     }
 
 private:
     //! \brief The name given to this group of events
     std::string _group_name;
 
-    /** \brief The map container for all the events in the group
-    *** The string is the name of the event, which is unique within the group. The integer value
-    *** represents the event's state and can take on multiple meanings depending on the context
-    *** of this specific event.
-    **/
-    std::map<std::string, int32_t> _events;
+    //! \brief The handles of the events of this group
+    std::vector<uint32_t> _event_handles;
+
+    bool _used;
 }; // class GlobalEventGroup
 
 } // namespace vt_global
@@ -10,70 +10,147 @@
 
 #include "global_events.h"
 
+#include "script/script.h"
+
 using namespace vt_utils;
 using namespace vt_script;
 
 namespace vt_global
 {
 
-GameEvents::GameEvents()
+GameEvents::GameEvents() :
+    _next_watch_id(0),
+    _generation(0)
 {
 }
 
 GameEvents::~GameEvents()
 {
+    // The watchers may already be gone.
+    _watches.clear();
     Clear();
 }
 
 void GameEvents::Clear()
 {
-    // Delete all event groups
-    for(std::map<std::string, GlobalEventGroup *>::iterator it = _event_groups.begin(); it != _event_groups.end(); ++it) {
-        delete(it->second);
+    // The handles may still be held by the code and the scripts.
+    for(uint32_t i = 0; i < _events.size(); ++i) {
+        const bool value_changed = (_events[i].value != 0);
+        _events[i].value = 0;
+        _events[i].exists = false;
+        if(value_changed && _events[i].watched)
+            _NotifyWatches(i);
     }
-    _event_groups.clear();
+    for(uint32_t i = 0; i < _event_groups.size(); ++i)
+        _event_groups[i].SetUsed(false);
+    ++_generation;
 }
 
 bool GameEvents::DoesEventExist(const std::string& group_name, const std::string& event_name) const
 {
-    std::map<std::string, GlobalEventGroup *>::const_iterator group_iter = _event_groups.find(group_name);
-    if(group_iter == _event_groups.end())
-        return false;
+    return DoesEventExistFromHandle(_FindEventHandle(group_name, event_name));
+}
+
+int32_t GameEvents::GetEventValue(const std::string& group_name, const std::string& event_name) const
+{
+    return GetEventValueFromHandle(_FindEventHandle(group_name, event_name));
+}
 
-    std::map<std::string, int32_t>::const_iterator event_iter = group_iter->second->GetEvents().find(event_name);
-    if(event_iter == group_iter->second->GetEvents().end())
-        return false;
+void GameEvents::SetEventValue(const std::string& group_name,
+                               const std::string& event_name,
+                               int32_t event_value)
+{
+    _SetEvent(GetEventHandle(group_name, event_name), event_value);
+}
 
-    return true;
+uint32_t GameEvents::GetEventHandle(const std::string& group_name, const std::string& event_name)
+{
+    const uint32_t group_handle = _GetEventGroupHandle(group_name);
+    uint32_t event_handle = _event_handles.Find(group_handle, event_name);
+    if(event_handle != INVALID_EVENT_HANDLE)
+        return event_handle;
+
+    event_handle = _events.size();
+    _events.push_back(_Event(group_handle, event_name));
+    _event_handles.Insert(group_handle, event_name, event_handle);
+    _event_groups[group_handle].AddEventHandle(event_handle);
+    return event_handle;
 }
 
-int32_t GameEvents::GetEventValue(const std::string& group_name, const std::string& event_name) const
+bool GameEvents::DoesEventExistFromHandle(uint32_t event_handle) const
 {
-    std::map<std::string, GlobalEventGroup *>::const_iterator group_iter = _event_groups.find(group_name);
-    if(group_iter == _event_groups.end())
-        return 0;
+    return event_handle < _events.size() && _events[event_handle].exists;
+}
 
-    std::map<std::string, int32_t>::const_iterator event_iter = group_iter->second->GetEvents().find(event_name);
-    if(event_iter == group_iter->second->GetEvents().end())
+int32_t GameEvents::GetEventValueFromHandle(uint32_t event_handle) const
+{
+    // A cleared event is back to 0.
+    if(event_handle >= _events.size())
         return 0;
+    return _events[event_handle].value;
+}
 
-    return event_iter->second;
+void GameEvents::SetEventValueFromHandle(uint32_t event_handle, int32_t event_value)
+{
+    if(event_handle >= _events.size()) {
+        PRINT_WARNING << "Invalid event handle: " << event_handle << std::endl;
+        return;
+    }
+    _SetEvent(event_handle, event_value);
 }
 
-void GameEvents::SetEventValue(const std::string& group_name,
-                               const std::string& event_name,
-                               int32_t event_value)
+void GameEvents::WatchEvent(uint32_t event_handle, const void* owner, const EventWatchCallback& callback)
 {
-    GlobalEventGroup* geg = nullptr;
-    std::map<std::string, GlobalEventGroup *>::const_iterator group_iter = _event_groups.find(group_name);
-    if(group_iter == _event_groups.end()) {
-        geg = new GlobalEventGroup(group_name);
-        _event_groups.insert(std::make_pair(group_name, geg));
-    } else {
-        geg = group_iter->second;
+    if(event_handle >= _events.size()) {
+        PRINT_WARNING << "Invalid event handle: " << event_handle << std::endl;
+        return;
     }
+    _watches.push_back(_EventWatch(_next_watch_id++, event_handle, owner, callback));
+    _events[event_handle].watched = true;
+}
 
-    geg->SetEvent(event_name, event_value);
+uint32_t GameEvents::WatchEvent(const std::string& group_name, const std::string& event_name,
+                                const void* owner, const EventWatchCallback& callback)
+{
+    const uint32_t event_handle = GetEventHandle(group_name, event_name);
+    WatchEvent(event_handle, owner, callback);
+    return event_handle;
+}
+
+void GameEvents::WatchEventFromScript(vt_mode_manager::GameMode* mode,
+                                      const std::string& group_name, const std::string& event_name,
+                                      const luabind::object& function)
+{
+    if(!function.is_valid()) {
+        PRINT_WARNING << "Invalid script function given to watch the event: "
+                      << group_name << "." << event_name << std::endl;
+        return;
+    }
+
+    WatchEvent(group_name, event_name, mode, [function](int32_t value) {
+        try {
+            luabind::call_function<void>(function, value);
+        } catch(const luabind::error& err) {
+            vt_script::ScriptManager->HandleLuaError(err);
+        } catch(const luabind::cast_failed& e) {
+            vt_script::ScriptManager->HandleCastError(e);
+        }
+    });
+}
+
+void GameEvents::UnwatchEvents(const void* owner)
+{
+    for(uint32_t i = 0; i < _watches.size();) {
+        if(_watches[i].owner == owner)
+            _watches.erase(_watches.begin() + i);
+        else
+            ++i;
+    }
+
+    for(uint32_t i = 0; i < _events.size(); ++i)
+        _events[i].watched = false;
+    for(uint32_t i = 0; i < _watches.size(); ++i)
+        _events[_watches[i].event_handle].watched = true;
 }
 
 void GameEvents::SaveEvents(WriteScriptDescriptor& file)
@@ -85,14 +162,21 @@ void GameEvents::SaveEvents(WriteScriptDescriptor& file)
 
     file.InsertNewLine();
     file.WriteLine("event_groups = {");
-    for(auto it = _event_groups.begin(); it != _event_groups.end(); ++it) {
-        GlobalEventGroup* event_group = it->second;
+    for(uint32_t j = 0; j < _event_groups.size(); ++j) {
+        const GlobalEventGroup& event_group = _event_groups[j];
+        if(!event_group.IsUsed())
+            continue;
 
-        file.WriteLine("\t" + event_group->GetGroupName() + " = {");
+        file.WriteLine("\t" + event_group.GetGroupName() + " = {");
 
         uint32_t i = 0;
-        for(auto it = event_group->GetEvents().begin(); it != event_group->GetEvents().end(); ++it) {
-            if(it == event_group->GetEvents().begin())
+        const std::vector<uint32_t>& event_handles = event_group.GetEventHandles();
+        for(uint32_t k = 0; k < event_handles.size(); ++k) {
+            const _Event& event = _events[event_handles[k]];
+            if(!event.exists)
+                continue;
+
+            if(i == 0)
                 file.WriteLine("\t\t", false);
             else
                 file.WriteLine(", ", false);
@@ -103,7 +187,7 @@ void GameEvents::SaveEvents(WriteScriptDescriptor& file)
                 file.WriteLine("\t\t", false);
             }
 
-            file.WriteLine("[\"" + it->first + "\"] = " + NumberToString(it->second), false);
+            file.WriteLine("[\"" + event.name + "\"] = " + NumberToString(event.value), false);
 
             ++i;
         }
@@ -130,16 +214,16 @@ void GameEvents::LoadEvents(ReadScriptDescriptor& file)
     file.ReadTableKeys(group_names);
     for(uint32_t i = 0; i < group_names.size(); i++) {
         std::string group_name = group_names[i];
-        _AddNewEventGroup(group_name);
-        // new_group is guaranteed not to be nullptr
-        GlobalEventGroup* new_group = _GetEventGroup(group_name);
+        const uint32_t group_handle = _GetEventGroupHandle(group_name);
+        _event_groups[group_handle].SetUsed(true);
+        ++_generation;
 
         std::vector<std::string> event_names;
 
         if (file.OpenTable(group_name)) {
             file.ReadTableKeys(event_names);
             for(uint32_t i = 0; i < event_names.size(); i++) {
-                new_group->AddNewEvent(event_names[i], file.ReadInt(event_names[i]));
+                _SetEvent(GetEventHandle(group_name, event_names[i]), file.ReadInt(event_names[i]));
             }
             file.CloseTable();
         }
@@ -151,26 +235,106 @@ void GameEvents::LoadEvents(ReadScriptDescriptor& file)
     file.CloseTable(); // event_groups
 }
 
-void GameEvents::_AddNewEventGroup(const std::string& group_name)
+void GameEvents::SaveEvents(SaveFileWriter& file)
 {
-    if(_DoesEventGroupExist(group_name)) {
-        PRINT_WARNING << "failed because there was already an event group that existed for "
-                      << "the requested group name: " << group_name << std::endl;
-        return;
+    uint32_t group_count = 0;
+    for(uint32_t i = 0; i < _event_groups.size(); ++i) {
+        if(_event_groups[i].IsUsed())
+            ++group_count;
+    }
+
+    file.WriteUInt(group_count);
+    for(uint32_t i = 0; i < _event_groups.size(); ++i) {
+        const GlobalEventGroup& event_group = _event_groups[i];
+        if(!event_group.IsUsed())
+            continue;
+        file.WriteString(event_group.GetGroupName());
+
+        const std::vector<uint32_t>& event_handles = event_group.GetEventHandles();
+        uint32_t event_count = 0;
+        for(uint32_t j = 0; j < event_handles.size(); ++j) {
+            if(_events[event_handles[j]].exists)
+                ++event_count;
+        }
+
+        file.WriteUInt(event_count);
+        for(uint32_t j = 0; j < event_handles.size(); ++j) {
+            const _Event& event = _events[event_handles[j]];
+            if(!event.exists)
+                continue;
+            file.WriteString(event.name);
+            file.WriteInt(event.value);
+        }
     }
+}
+
+void GameEvents::LoadEvents(SaveFileReader& file)
+{
+    const uint64_t group_count = file.ReadUInt();
+    for(uint64_t i = 0; i < group_count && !file.IsErrorDetected(); ++i) {
+        std::string group_name = file.ReadString();
+        const uint32_t group_handle = _GetEventGroupHandle(group_name);
+        _event_groups[group_handle].SetUsed(true);
+        ++_generation;
+
+        const uint64_t event_count = file.ReadUInt();
+        for(uint64_t j = 0; j < event_count && !file.IsErrorDetected(); ++j) {
+            std::string event_name = file.ReadString();
+            int32_t event_value = static_cast<int32_t>(file.ReadInt());
+            _SetEvent(GetEventHandle(group_name, event_name), event_value);
+        }
+    }
+}
 
-    GlobalEventGroup* geg = new GlobalEventGroup(group_name);
-    _event_groups.insert(std::make_pair(group_name, geg));
+uint32_t GameEvents::_GetEventGroupHandle(const std::string& group_name)
+{
+    uint32_t group_handle = _group_handles.Find(0, group_name);
+    if(group_handle != INVALID_EVENT_HANDLE)
+        return group_handle;
+
+    group_handle = _event_groups.size();
+    _event_groups.push_back(GlobalEventGroup(group_name));
+    _group_handles.Insert(0, group_name, group_handle);
+    return group_handle;
 }
 
-GlobalEventGroup* GameEvents::_GetEventGroup(const std::string& group_name) const
+uint32_t GameEvents::_FindEventHandle(const std::string& group_name, const std::string& event_name) const
 {
-    std::map<std::string, GlobalEventGroup *>::const_iterator group_iter = _event_groups.find(group_name);
-    if(group_iter == _event_groups.end()) {
-        PRINT_WARNING << "could not find any event group by the requested name: " << group_name << std::endl;
-        return nullptr;
+    const uint32_t group_handle = _group_handles.Find(0, group_name);
+    if(group_handle == INVALID_EVENT_HANDLE)
+        return INVALID_EVENT_HANDLE;
+    return _event_handles.Find(group_handle, event_name);
+}
+
+void GameEvents::_SetEvent(uint32_t event_handle, int32_t event_value)
+{
+    _Event& event = _events[event_handle];
+    const bool value_changed = (event.value != event_value);
+    event.value = event_value;
+    event.exists = true;
+    _event_groups[event.group].SetUsed(true);
+    ++_generation;
+
+    if(value_changed && event.watched)
+        _NotifyWatches(event_handle);
+}
+
+void GameEvents::_NotifyWatches(uint32_t event_handle)
+{
+    const int32_t event_value = _events[event_handle].value;
+    std::vector<_EventWatch> watches;
+    for(uint32_t i = 0; i < _watches.size(); ++i) {
+        if(_watches[i].event_handle == event_handle)
+            watches.push_back(_watches[i]);
+    }
+
+    for(uint32_t i = 0; i < watches.size(); ++i) {
+        bool watching = false;
+        for(uint32_t j = 0; j < _watches.size() && !watching; ++j)
+            watching = (_watches[j].id == watches[i].id);
+        if(watching)
+            watches[i].callback(event_value);
     }
-    return (group_iter->second);
 }
 
 } // namespace vt_global
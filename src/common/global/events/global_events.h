@@ -14,13 +14,33 @@
 #include "script/script_read.h"
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
 #include "global_event_group.h"
 
+#include <functional>
+
+namespace vt_mode_manager
+{
+class GameMode;
+}
+
 //! \brief All calls to global code are wrapped inside this namespace.
 namespace vt_global
 {
 
-//! \brief Handle in-game events dictionary.
+//! \brief Called with the new value of a watched event.
+typedef std::function<void(int32_t)> EventWatchCallback;
+
+/** ****************************************************************************
+*** \brief Handle in-game events dictionary.
+***
+*** The event values are stored densely, and found through handles given to
+*** each group and event name, so that the code and the scripts checking the
+*** same events over and over can get their handles once and skip the name
+*** lookups. The handles stay valid for the whole game, even once the events
+*** are cleared.
+*** ***************************************************************************/
 class GameEvents
 {
 
@@ -28,7 +48,7 @@ public:
     GameEvents();
     ~GameEvents();
 
-    //! \brief Deletes all data.
+    //! \brief Deletes all the events and event groups. Their handles are kept.
     void Clear();
 
     /** \brief Determines if an event of a given name exists within a given group
@@ -53,9 +73,46 @@ public:
     **/
     void SetEventValue(const std::string& group_name, const std::string& event_name, int32_t event_value);
 
+    /** \brief Returns the handle of an event, whether it exists or not.
+    *** \param group_name The name of the event group where the event is contained
+    *** \param event_name The name of the event
+    **/
+    uint32_t GetEventHandle(const std::string& group_name, const std::string& event_name);
+
+    //! \brief The functions above, for an event handle given by GetEventHandle().
+    bool DoesEventExistFromHandle(uint32_t event_handle) const;
+    int32_t GetEventValueFromHandle(uint32_t event_handle) const;
+    void SetEventValueFromHandle(uint32_t event_handle, int32_t event_value);
+
+    /** \brief Calls a function whenever the value of an event changes, the events being
+    *** cleared or loaded included, so that the state derived from events can be kept up to date.
+    *** \param event_handle The event to watch, given by GetEventHandle().
+    *** \param owner Identifies the watches of a same owner, so that they can be removed together.
+    *** \param callback The function called with the new event value.
+    **/
+    void WatchEvent(uint32_t event_handle, const void* owner, const EventWatchCallback& callback);
+
+    //! \brief The function above, for an event given by name.
+    //! \return The handle of the event watched.
+    uint32_t WatchEvent(const std::string& group_name, const std::string& event_name,
+                        const void* owner, const EventWatchCallback& callback);
+
+    /** \brief Calls a script function with the new value of an event whenever it changes.
+    *** \param mode The game mode owning the watch, usually the map mode of the calling map script.
+    *** The game modes remove their watches when deleted.
+    *** \param group_name The name of the event group where the event is contained
+    *** \param event_name The name of the event to watch
+    *** \param function The script function, called with the new event value.
+    **/
+    void WatchEventFromScript(vt_mode_manager::GameMode* mode,
+                              const std::string& group_name, const std::string& event_name,
+                              const luabind::object& function);
+
+    //! \brief Removes all of the event watches of an owner.
+    void UnwatchEvents(const void* owner);
+
     /** \brief A helper function to GameGlobal::SaveGame() that writes a group of event data to the saved game file
     *** \param file A reference to the open and valid file where to write the event data
-    *** This method will need to be called once for each GlobalEventGroup contained by this class.
     **/
     void SaveEvents(vt_script::WriteScriptDescriptor& file);
 
@@ -64,34 +121,90 @@ public:
     **/
     void LoadEvents(vt_script::ReadScriptDescriptor& file);
 
-private:
-    /** \brief Queries whether or not an event group of a given name exists
-    *** \param group_name The name of the event group to check for
-    *** \return True if the event group name was found, false if it was not
-    **/
-    bool _DoesEventGroupExist(const std::string& group_name) const {
-        return (_event_groups.find(group_name) != _event_groups.end());
+    //! \brief Binary saved game versions of the functions above.
+    void SaveEvents(SaveFileWriter& file);
+    void LoadEvents(SaveFileReader& file);
+
+    //! \brief Changes whenever the saved data changes, so that its encoded saved game section can be reused.
+    uint32_t GetGeneration() const {
+        return _generation;
     }
 
-    /** \brief Adds a new event group for the class to manage
-    *** \param group_name The name of the new event group to add
-    *** \note If an event group  by the given name already exists, the function will abort
-    *** and not add the new event group. Otherwise, this class will automatically construct
-    *** a new event group of the given name and place it in its map of event groups.
+private:
+    //! \brief An event value, and what it is known by.
+    class _Event
+    {
+    public:
+        _Event(uint32_t event_group, const std::string& event_name) :
+            group(event_group),
+            name(event_name),
+            value(0),
+            exists(false),
+            watched(false)
+        {}
+
+        //! \brief The handle of the event group.
+        uint32_t group;
+        std::string name;
+        int32_t value;
+        bool exists;
+
+        //! \brief Whether the event has watches, to only look for them when needed.
+        bool watched;
+    };
+
+    //! \brief A function called when an event value changes.
+    class _EventWatch
+    {
+    public:
+        _EventWatch(uint32_t watch_id, uint32_t handle, const void* watch_owner, const EventWatchCallback& watch_callback) :
+            id(watch_id),
+            event_handle(handle),
+            owner(watch_owner),
+            callback(watch_callback)
+        {}
+
+        //! \brief The watch unique id, to know whether it was removed while notifying.
+        uint32_t id;
+        uint32_t event_handle;
+        const void* owner;
+        EventWatchCallback callback;
+    };
+
+    //! \brief Returns the handle of an event group, creating it when needed.
+    uint32_t _GetEventGroupHandle(const std::string& group_name);
+
+    //! \brief Returns the handle of an event, or INVALID_EVENT_HANDLE when it is unknown.
+    uint32_t _FindEventHandle(const std::string& group_name, const std::string& event_name) const;
+
+    //! \brief Sets an event, and makes its group used.
+    void _SetEvent(uint32_t event_handle, int32_t event_value);
+
+    /** \brief Calls the watches of an event whose value changed.
+    *** The callbacks may add and remove watches, so the ones to call are copied beforehand,
+    *** and the ones removed meanwhile are skipped.
     **/
-    void _AddNewEventGroup(const std::string& group_name);
+    void _NotifyWatches(uint32_t event_handle);
 
-    /** \brief Returns a pointer to an event group of the specified name
-    *** \param group_name The name of the event group to retreive
-    *** \return A pointer to the GlobalEventGroup that represents the event group, or nullptr if no event group
-    *** of the specified name was found.
-    **/
-    GlobalEventGroup* _GetEventGroup(const std::string& group_name) const;
+    //! \brief Finds the event group handles by name.
+    EventHandleTable _group_handles;
 
-    /** \brief The container which stores all of the groups of events that have occured in the game
-    *** The name of each GlobalEventGroup object serves as its key in this map data structure.
-    **/
-    std::map<std::string, GlobalEventGroup*> _event_groups;
+    //! \brief Finds the event handles by name, using their group handle as scope.
+    EventHandleTable _event_handles;
+
+    //! \brief The event groups, the group handles being indices in it.
+    std::vector<GlobalEventGroup> _event_groups;
+
+    //! \brief The events, the event handles being indices in it.
+    std::vector<_Event> _events;
+
+    //! \brief The event watches, few enough to be simply scanned.
+    std::vector<_EventWatch> _watches;
+
+    //! \brief The id given to the next watch.
+    uint32_t _next_watch_id;
+
+    uint32_t _generation;
 };
 
 } // namespace vt_global
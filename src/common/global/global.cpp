@@ -16,11 +16,16 @@
 #include "objects/global_armor.h"
 #include "objects/global_spirit.h"
 
+#include "engine/performance_telemetry.h"
 #include "engine/system.h"
+#include "engine/video/texture_controller.h"
 #include "modes/map/map_mode.h"
+#include "modes/map/map_prefetcher.h"
 
 #include "common/app_settings.h"
 
+#include "utils/utils_files.h"
+
 using namespace vt_utils;
 using namespace vt_common;
 
@@ -57,9 +62,20 @@ bool GameGlobal::SingletonInitialize()
     _global_media.Initialize();
     _battle_media.Initialize();
 
+    // The prefetched images not taken by the media, such as those already loaded, are forgotten.
+    for(uint32_t i = 0; i < _prefetched_media_images.size(); ++i)
+        vt_video::TextureManager->CancelPrefetchedImage(_prefetched_media_images[i]);
+    _prefetched_media_images.clear();
+
     return _LoadGlobalScripts();
 }
 
+void GameGlobal::PrefetchMediaImages()
+{
+    _global_media.PrefetchImages(_prefetched_media_images);
+    _battle_media.PrefetchImages(_prefetched_media_images);
+}
+
 void GameGlobal::_CloseGlobalScripts() {
     // Close all persistent script files
     _global_script.CloseFile();
@@ -186,11 +202,13 @@ bool GameGlobal::NewGame()
 
 bool GameGlobal::AutoSave(const std::string& map_data_file,
                           const std::string& map_script_file,
+                          const std::string& map_name,
+                          const std::string& map_image_filename,
                           uint32_t stamina,
                           uint32_t x_position, uint32_t y_position)
 {
     // Don't autosave when the save slot was not yet chosen
-    if (GetGameSlotId() == std::numeric_limits<uint32_t>::max())
+    if (GetGameSlotId() >= SystemManager->GetGameSaveSlots())
         return false;
 
     std::ostringstream filename;
@@ -205,13 +223,38 @@ bool GameGlobal::AutoSave(const std::string& map_data_file,
     _map_data_handler.SetMapScriptFilename(map_script_file);
     _map_data_handler.SetSaveStamina(stamina);
 
-    bool save_completed = SaveGame(filename.str(), GetGameSlotId(), x_position, y_position);
+    // Only the snapshot is done now. The Lua autosave is left for the worker to remove
+    // once the binary one is written, so that a failure keeps the previous autosave.
+    SaveFileWriter* snapshot = new SaveFileWriter();
+    _WriteBinaryGame(*snapshot, x_position, y_position, -1);
+
+    // The preview describes the binary autosave alone, the Lua one being removed.
+    SavePreview preview;
+    _BuildSavePreview(preview, map_name, map_image_filename);
+    preview.binary_file_size = static_cast<int64_t>(snapshot->GetFileSize());
+    SaveFileWriter* preview_snapshot = new SaveFileWriter();
+    preview.Write(*preview_snapshot);
+
+    _autosave_writer.Queue(snapshot, GetBinarySaveFilename(filename.str()),
+                           preview_snapshot, GetSavePreviewFilename(filename.str()),
+                           filename.str());
 
     // Restore previous map data
     _map_data_handler.SetMapDataFilename(previous_map_data);
     _map_data_handler.SetMapScriptFilename(previous_map_script);
 
-    return save_completed;
+    return true;
+}
+
+void GameGlobal::UpdateAutoSave()
+{
+    bool success = false;
+    while (_autosave_writer.PopResult(success)) {
+        if (!success)
+            PRINT_WARNING << "The autosave couldn't be written." << std::endl;
+        if (_autosave_callback)
+            _autosave_callback(success);
+    }
 }
 
 bool GameGlobal::SaveGame(const std::string& filename,
@@ -222,6 +265,8 @@ bool GameGlobal::SaveGame(const std::string& filename,
     if (slot_id >= SystemManager->GetGameSaveSlots())
         return false;
 
+    vt_system::TelemetryTimer telemetry_timer("save", filename);
+
     WriteScriptDescriptor file;
     if(file.OpenFile(filename) == false) {
         return false;
@@ -262,6 +307,22 @@ bool GameGlobal::SaveGame(const std::string& filename,
 
     file.CloseFile();
 
+    // The Lua file is kept for older versions.
+    SaveFileWriter binary_file;
+    _WriteBinaryGame(binary_file, x_position, y_position, GetSaveFileSize(filename));
+    const std::string binary_filename = GetBinarySaveFilename(filename);
+    if (!binary_file.SaveFile(binary_filename)) {
+        // Don't leave an outdated binary file next to the new Lua one.
+        DeleteAFile(binary_filename);
+    }
+
+    // Written last, once the sizes of the files it describes are known.
+    SavePreview preview;
+    _BuildSavePreview(preview, _map_data_handler.GetMapName(), _map_data_handler.GetMapImage().GetFilename());
+    preview.SetFileSizes(filename);
+    if (!preview.SaveFile(filename))
+        DeleteAFile(GetSavePreviewFilename(filename));
+
     // Store the game slot the game is coming from.
     _game_slot_id = slot_id;
 
@@ -270,6 +331,34 @@ bool GameGlobal::SaveGame(const std::string& filename,
 
 bool GameGlobal::LoadGame(const std::string &filename, uint32_t slot_id)
 {
+    vt_system::TelemetryTimer telemetry_timer("load", filename);
+
+    // Don't read an autosave being written.
+    _autosave_writer.Wait();
+
+    // Keep the characters played until the saved ones are loaded. They mostly are the same ones,
+    // so their portraits and battle images stay loaded instead of being read again.
+    _character_handler.KeepClearedCharacters();
+    const bool success = _LoadGameFile(filename);
+    _character_handler.ReleaseKeptCharacters();
+
+    // Store the game slot the game is coming from.
+    if (success)
+        _game_slot_id = slot_id;
+
+    return success;
+}
+
+bool GameGlobal::_LoadGameFile(const std::string& filename)
+{
+    // Prefer the binary saved game, when it is up to date.
+    SaveFileReader binary_file;
+    if (OpenBinarySaveFile(binary_file, filename)) {
+        if (_LoadBinaryGame(binary_file))
+            return true;
+        IF_PRINT_WARNING(GLOBAL_DEBUG) << "Importing the Lua saved game instead of the binary one: " << filename << std::endl;
+    }
+
     ReadScriptDescriptor file;
     if(!file.OpenFile(filename))
         return false;
@@ -283,6 +372,7 @@ bool GameGlobal::LoadGame(const std::string &filename, uint32_t slot_id)
     }
 
     _map_data_handler.Load(file);
+    _PrefetchSavedMap();
 
     uint8_t hours, minutes, seconds;
     hours = file.ReadUInt("play_hours");
@@ -315,10 +405,154 @@ bool GameGlobal::LoadGame(const std::string &filename, uint32_t slot_id)
 
     file.CloseFile();
 
-    // Store the game slot the game is coming from.
-    _game_slot_id = slot_id;
+    return true;
+}
+
+void GameGlobal::_PrefetchSavedMap()
+{
+    const std::string& map_data_filename = _map_data_handler.GetMapDataFilename();
+    if (!map_data_filename.empty())
+        vt_map::private_map::MapPrefetcher::Prefetch(map_data_filename);
+}
+
+bool GameGlobal::_WriteCachedSection(SaveFileWriter& file, SAVE_SECTION section,
+                                     const _SaveSectionCache& cache, uint32_t generation)
+{
+    if (!cache.valid || cache.generation != generation)
+        return false;
+
+    file.WriteSection(section, cache.data);
+    return true;
+}
+
+void GameGlobal::_EndCachedSection(SaveFileWriter& file, _SaveSectionCache& cache, uint32_t generation)
+{
+    file.EndSection(cache.data);
+    cache.generation = generation;
+    cache.valid = true;
+}
+
+void GameGlobal::_BuildSavePreview(SavePreview& preview, const std::string& map_name,
+                                   const std::string& map_image_filename)
+{
+    preview.play_hours = SystemManager->GetPlayHours();
+    preview.play_minutes = SystemManager->GetPlayMinutes();
+    preview.play_seconds = SystemManager->GetPlaySeconds();
+    preview.drunes = _drunes;
+
+    preview.map_data_filename = _map_data_handler.GetMapDataFilename();
+    preview.map_script_filename = _map_data_handler.GetMapScriptFilename();
+    preview.map_name = map_name;
+    preview.map_image_filename = map_image_filename;
+
+    std::vector<GlobalCharacter*>* characters = _character_handler.GetOrderedCharacters();
+    for (uint32_t i = 0; i < characters->size(); ++i)
+        preview.AddCharacter(*characters->at(i));
+}
+
+void GameGlobal::_WriteBinaryGame(SaveFileWriter& file, uint32_t x_position, uint32_t y_position,
+                                  int64_t lua_file_size)
+{
+    file.BeginSection(SAVE_SECTION_PLAY_DATA);
+    file.WriteUInt(SystemManager->GetPlayHours());
+    file.WriteUInt(SystemManager->GetPlayMinutes());
+    file.WriteUInt(SystemManager->GetPlaySeconds());
+    file.WriteUInt(_drunes);
+    file.WriteInt(lua_file_size);
+    file.EndSection();
+
+    file.BeginSection(SAVE_SECTION_MAP_DATA);
+    _map_data_handler.Save(file, x_position, y_position);
+    file.EndSection();
+
+    file.BeginSection(SAVE_SECTION_INVENTORY);
+    _inventory_handler.SaveInventory(file);
+    file.EndSection();
+
+    file.BeginSection(SAVE_SECTION_CHARACTERS);
+    _character_handler.SaveCharacters(file);
+    file.EndSection();
+
+    if (!_WriteCachedSection(file, SAVE_SECTION_EVENTS, _events_section, _game_events.GetGeneration())) {
+        file.BeginSection(SAVE_SECTION_EVENTS);
+        _game_events.SaveEvents(file);
+        _EndCachedSection(file, _events_section, _game_events.GetGeneration());
+    }
+
+    if (!_WriteCachedSection(file, SAVE_SECTION_QUESTS, _quests_section, _game_quests.GetGeneration())) {
+        file.BeginSection(SAVE_SECTION_QUESTS);
+        _game_quests.SaveQuests(file);
+        _EndCachedSection(file, _quests_section, _game_quests.GetGeneration());
+    }
+
+    if (!_WriteCachedSection(file, SAVE_SECTION_WORLD_MAP, _world_map_section, _worldmap_handler.GetGeneration())) {
+        file.BeginSection(SAVE_SECTION_WORLD_MAP);
+        _worldmap_handler.SaveWorldMap(file);
+        _EndCachedSection(file, _world_map_section, _worldmap_handler.GetGeneration());
+    }
+
+    if (!_WriteCachedSection(file, SAVE_SECTION_SHOP_DATA, _shop_data_section, _shop_data_handler.GetGeneration())) {
+        file.BeginSection(SAVE_SECTION_SHOP_DATA);
+        _shop_data_handler.SaveShopData(file);
+        _EndCachedSection(file, _shop_data_section, _shop_data_handler.GetGeneration());
+    }
+}
+
+bool GameGlobal::_LoadBinaryGame(SaveFileReader& file)
+{
+    if (!file.OpenSection(SAVE_SECTION_PLAY_DATA))
+        return false;
+
+    uint8_t hours = static_cast<uint8_t>(file.ReadUInt());
+    uint8_t minutes = static_cast<uint8_t>(file.ReadUInt());
+    uint8_t seconds = static_cast<uint8_t>(file.ReadUInt());
+    uint32_t drunes = static_cast<uint32_t>(file.ReadUInt());
+    if (file.IsErrorDetected())
+        return false;
+
+    ClearAllData();
+
+    bool success = file.OpenSection(SAVE_SECTION_MAP_DATA) && _map_data_handler.Load(file);
+    if (success)
+        _PrefetchSavedMap();
+
+    if (success && file.OpenSection(SAVE_SECTION_INVENTORY))
+        _inventory_handler.LoadInventory(file);
+    else
+        success = false;
 
+    success = success && file.OpenSection(SAVE_SECTION_CHARACTERS) && _character_handler.LoadCharacters(file);
+
+    if (success && file.OpenSection(SAVE_SECTION_EVENTS))
+        _game_events.LoadEvents(file);
+    else
+        success = false;
+
+    if (success && file.OpenSection(SAVE_SECTION_QUESTS))
+        _game_quests.LoadQuests(file);
+    else
+        success = false;
+
+    if (success && file.OpenSection(SAVE_SECTION_WORLD_MAP))
+        _worldmap_handler.LoadWorldMap(file);
+    else
+        success = false;
+
+    if (success && file.OpenSection(SAVE_SECTION_SHOP_DATA))
+        _shop_data_handler.LoadShopData(file);
+    else
+        success = false;
+
+    if (!success || file.IsErrorDetected()) {
+        PRINT_WARNING << "Invalid binary saved game file: " << file.GetFilename() << std::endl;
+        ClearAllData();
+        return false;
+    }
+
+    SystemManager->SetPlayTime(hours, minutes, seconds);
+    _drunes = drunes;
     return true;
 }
 
 } // namespace vt_global
+
@@ -13,6 +13,8 @@
 
 #include "utils/utils_strings.h"
 
+#include <functional>
+
 #include "script/script_read.h"
 #include "script/script_write.h"
 
@@ -29,6 +31,9 @@
 #include "objects/global_weapon.h"
 
 #include "global_skills.h"
+#include "global_save_file.h"
+#include "global_async_save.h"
+#include "global_save_preview.h"
 
 #include "events/global_events.h"
 #include "quests/quests.h"
@@ -69,6 +74,12 @@ public:
 
     bool SingletonInitialize();
 
+    /** \brief Starts decoding the common media images in the background.
+    *** Called once the texture manager is ready, so that they are decoded while
+    *** the rest of the engine is initialized, before SingletonInitialize() loads them.
+    **/
+    void PrefetchMediaImages();
+
     //! Reloads the persistent scripts. Used when changing the language for instance.
     bool ReloadGlobalScripts()
     { _CloseGlobalScripts(); return _LoadGlobalScripts(); }
@@ -100,11 +111,35 @@ public:
     **/
     bool SaveGame(const std::string &filename, uint32_t slot_id, uint32_t x_position = 0, uint32_t y_position = 0);
 
-    //! \brief Attempts an autosave on the current slot, using given map and location.
+    /** \brief Attempts an autosave on the current slot, using given map and location.
+    *** The game state is captured at once, but written in the background.
+    *** \param map_name The untranslated map name and the map image filename, for the preview.
+    *** \return False if the autosave couldn't be started.
+    **/
     bool AutoSave(const std::string& map_data_file, const std::string& map_script_file,
+                  const std::string& map_name, const std::string& map_image_filename,
                   uint32_t stamina,
                   uint32_t x_position = 0, uint32_t y_position = 0);
 
+    //! \brief Whether an autosave is being written.
+    bool IsAutoSaving() {
+        return _autosave_writer.IsBusy();
+    }
+
+    //! \brief Returns once the autosaves being written are done.
+    void WaitForAutoSave() {
+        _autosave_writer.Wait();
+    }
+
+    //! \brief Sets the function called with whether each autosave was written,
+    //! from UpdateAutoSave(). An empty function removes it.
+    void SetAutoSaveCallback(const std::function<void(bool)>& callback) {
+        _autosave_callback = callback;
+    }
+
+    //! \brief Reports the autosaves written since the last call. Called once per frame.
+    void UpdateAutoSave();
+
     //! \brief Gets the last load/save position.
     uint32_t GetGameSlotId() const {
         return _game_slot_id;
@@ -233,6 +268,12 @@ private:
     //! \brief The amount of financial resources (drunes) that the party currently has
     uint32_t _drunes;
 
+    //! \brief Writes the autosaves in the background.
+    AsyncSaveWriter _autosave_writer;
+
+    //! \brief Called once each autosave is written, if set.
+    std::function<void(bool)> _autosave_callback;
+
     /** \brief Set the max level that can be reached by a character
     *** This equals 100 by default, @see Set/GetMaxExperienceLevel()
     **/
@@ -263,6 +304,9 @@ private:
     //! \brief member storing all the common battle media files.
     BattleMedia _battle_media;
 
+    //! \brief The media images prefetched, until they are loaded.
+    std::vector<std::string> _prefetched_media_images;
+
     //! \name Global data and function script files
     //@{
     //! \brief Contains character ID definitions and a number of useful functions
@@ -304,6 +348,60 @@ private:
 
     //! \brief Unloads every persistent scripts by closing their files.
     void _CloseGlobalScripts();
+
+    /** \brief Captures all global data into a binary saved game.
+    *** \param lua_file_size The size of the Lua saved game written along, or -1 if none is.
+    **/
+    void _WriteBinaryGame(SaveFileWriter& file, uint32_t x_position, uint32_t y_position,
+                          int64_t lua_file_size);
+
+    //! \brief An encoded binary saved game section, reused as long as its handler is unchanged.
+    class _SaveSectionCache
+    {
+    public:
+        _SaveSectionCache() :
+            generation(0),
+            valid(false)
+        {}
+
+        //! \brief The generation of the handler when the section was encoded.
+        uint32_t generation;
+        bool valid;
+        std::vector<uint8_t> data;
+    };
+
+    //! \brief The last encoded sections of the handlers rarely changing.
+    _SaveSectionCache _events_section;
+    _SaveSectionCache _quests_section;
+    _SaveSectionCache _world_map_section;
+    _SaveSectionCache _shop_data_section;
+
+    /** \brief Writes a cached section when its handler is unchanged.
+    *** \return False when the section must be encoded again, and ended with _EndCachedSection().
+    **/
+    static bool _WriteCachedSection(SaveFileWriter& file, SAVE_SECTION section,
+                                    const _SaveSectionCache& cache, uint32_t generation);
+
+    //! \brief Ends a section encoded again, and caches it.
+    static void _EndCachedSection(SaveFileWriter& file, _SaveSectionCache& cache, uint32_t generation);
+
+    //! \brief Captures what the save menu shows of the current game, the file sizes aside.
+    void _BuildSavePreview(SavePreview& preview, const std::string& map_name,
+                           const std::string& map_image_filename);
+
+    /** \brief Loads all global data from a binary saved game file opened with OpenBinarySaveFile().
+    *** \return False if the binary file couldn't be loaded, in which case the
+    *** Lua file must be imported instead.
+    **/
+    bool _LoadBinaryGame(SaveFileReader& file);
+
+    //! \brief Loads the binary saved game when up to date, or the Lua one. Used by LoadGame().
+    bool _LoadGameFile(const std::string& filename);
+
+    /** \brief Starts reading the saved game map in the background, once its map data is known,
+    *** so that its tilesets are decoded while the rest of the saved game is parsed.
+    **/
+    void _PrefetchSavedMap();
 };
 
 } // namespace vt_global
@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    global_async_save.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for writing saved games without stalling the game.
+*** ***************************************************************************/
+
+#include "global_async_save.h"
+
+#include "global_save_file.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+#include "utils/exception.h"
+
+#include <SDL2/SDL.h>
+
+namespace vt_global
+{
+
+extern bool GLOBAL_DEBUG;
+
+AsyncSaveWriter::AsyncSaveWriter() :
+    _pending_jobs(0),
+    _thread(nullptr),
+    _mutex(SDL_CreateMutex()),
+    _job_queued(SDL_CreateCond()),
+    _jobs_done(SDL_CreateCond()),
+    _quit(false)
+{
+    if (_mutex == nullptr || _job_queued == nullptr || _jobs_done == nullptr) {
+        PRINT_ERROR << "Couldn't create the save writer synchronization objects: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    _thread = SDL_CreateThread(_WorkerThread, "AsyncSaveWriter", this);
+    if (_thread == nullptr)
+        IF_PRINT_WARNING(GLOBAL_DEBUG) << "Couldn't create the save writer thread: " << SDL_GetError() << std::endl;
+}
+
+AsyncSaveWriter::~AsyncSaveWriter()
+{
+    // The worker saves the queued snapshots before stopping.
+    if (_thread != nullptr) {
+        SDL_LockMutex(_mutex);
+        _quit = true;
+        SDL_CondSignal(_job_queued);
+        SDL_UnlockMutex(_mutex);
+
+        SDL_WaitThread(_thread, nullptr);
+        _thread = nullptr;
+    }
+
+    for (auto it = _jobs.begin(); it != _jobs.end(); ++it) {
+        delete it->snapshot;
+        delete it->preview;
+    }
+    _jobs.clear();
+
+    if (_jobs_done != nullptr)
+        SDL_DestroyCond(_jobs_done);
+    if (_job_queued != nullptr)
+        SDL_DestroyCond(_job_queued);
+    if (_mutex != nullptr)
+        SDL_DestroyMutex(_mutex);
+}
+
+void AsyncSaveWriter::Queue(SaveFileWriter* snapshot, const std::string& filename,
+                            SaveFileWriter* preview, const std::string& preview_filename,
+                            const std::string& obsolete_filename)
+{
+    _Job job;
+    job.snapshot = snapshot;
+    job.filename = filename;
+    job.preview = preview;
+    job.preview_filename = preview_filename;
+    job.obsolete_filename = obsolete_filename;
+
+    if (_thread == nullptr) {
+        _results.push_back(_Save(job));
+        return;
+    }
+
+    SDL_LockMutex(_mutex);
+
+    // Only the latest state of a file matters.
+    for (auto it = _jobs.begin(); it != _jobs.end(); ++it) {
+        if (it->filename == filename) {
+            delete it->snapshot;
+            delete it->preview;
+            *it = job;
+            SDL_UnlockMutex(_mutex);
+            return;
+        }
+    }
+
+    _jobs.push_back(job);
+    ++_pending_jobs;
+    SDL_CondSignal(_job_queued);
+
+    SDL_UnlockMutex(_mutex);
+}
+
+bool AsyncSaveWriter::IsBusy()
+{
+    if (_thread == nullptr)
+        return false;
+
+    SDL_LockMutex(_mutex);
+    const bool busy = _pending_jobs > 0;
+    SDL_UnlockMutex(_mutex);
+    return busy;
+}
+
+void AsyncSaveWriter::Wait()
+{
+    if (_thread == nullptr)
+        return;
+
+    SDL_LockMutex(_mutex);
+    while (_pending_jobs > 0)
+        SDL_CondWait(_jobs_done, _mutex);
+    SDL_UnlockMutex(_mutex);
+}
+
+bool AsyncSaveWriter::PopResult(bool& success)
+{
+    if (_mutex != nullptr)
+        SDL_LockMutex(_mutex);
+
+    const bool popped = !_results.empty();
+    if (popped) {
+        success = _results.front();
+        _results.pop_front();
+    }
+
+    if (_mutex != nullptr)
+        SDL_UnlockMutex(_mutex);
+    return popped;
+}
+
+bool AsyncSaveWriter::_Save(const _Job& job)
+{
+    const bool success = job.snapshot->SaveFile(job.filename);
+    delete job.snapshot;
+
+    if (success && !job.obsolete_filename.empty() && vt_utils::DoesFileExist(job.obsolete_filename))
+        vt_utils::DeleteAFile(job.obsolete_filename);
+
+    // The preview goes last, so that it is never older than the files it describes.
+    if (job.preview != nullptr) {
+        if (success && !job.preview->SaveFile(job.preview_filename) && vt_utils::DoesFileExist(job.preview_filename))
+            vt_utils::DeleteAFile(job.preview_filename);
+        delete job.preview;
+    }
+    return success;
+}
+
+int AsyncSaveWriter::_WorkerThread(void* async_save_writer)
+{
+    static_cast<AsyncSaveWriter*>(async_save_writer)->_Work();
+    return 0;
+}
+
+void AsyncSaveWriter::_Work()
+{
+    SDL_LockMutex(_mutex);
+
+    while (true) {
+        while (!_quit && _jobs.empty())
+            SDL_CondWait(_job_queued, _mutex);
+
+        if (_jobs.empty())
+            break;
+
+        _Job job = _jobs.front();
+        _jobs.pop_front();
+
+        // Save without holding the lock, so that new snapshots can be queued.
+        SDL_UnlockMutex(_mutex);
+        const bool success = _Save(job);
+        SDL_LockMutex(_mutex);
+
+        _results.push_back(success);
+        --_pending_jobs;
+        if (_pending_jobs == 0)
+            SDL_CondBroadcast(_jobs_done);
+    }
+
+    SDL_UnlockMutex(_mutex);
+}
+
+AsyncSaveWriter::AsyncSaveWriter(const AsyncSaveWriter&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+AsyncSaveWriter& AsyncSaveWriter::operator=(const AsyncSaveWriter&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_global
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    global_async_save.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for writing saved games without stalling the game.
+***
+*** The global state is captured into a binary saved game on the main thread,
+*** which only encodes it in memory. The checksum and the file writing, slow
+*** on some storage devices, are then left to a worker thread.
+*** ***************************************************************************/
+
+#ifndef __GLOBAL_ASYNC_SAVE_HEADER__
+#define __GLOBAL_ASYNC_SAVE_HEADER__
+
+#include <cstdint>
+#include <deque>
+#include <string>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+namespace vt_global
+{
+
+class SaveFileWriter;
+
+/** ****************************************************************************
+*** \brief Saves binary saved game snapshots in a worker thread.
+*** ***************************************************************************/
+class AsyncSaveWriter
+{
+public:
+    AsyncSaveWriter();
+
+    //! \brief Saves the pending snapshots before returning.
+    ~AsyncSaveWriter();
+
+    /** \brief Queues a snapshot to save. A pending snapshot of the same file is replaced.
+    *** \param snapshot The snapshot to save, owned by the writer from now on.
+    *** \param filename The binary saved game file to write.
+    *** \param preview The preview of the snapshot, saved after it and owned by the writer. Can be nullptr.
+    *** \param preview_filename The preview file to write.
+    *** \param obsolete_filename A file removed once the snapshot is saved, if not empty.
+    *** \note The snapshot is saved right away when the worker couldn't be created.
+    **/
+    void Queue(SaveFileWriter* snapshot, const std::string& filename,
+               SaveFileWriter* preview, const std::string& preview_filename,
+               const std::string& obsolete_filename);
+
+    //! \brief Whether snapshots are queued or being saved.
+    bool IsBusy();
+
+    //! \brief Returns once every queued snapshot is saved.
+    void Wait();
+
+    /** \brief Gives the result of a saved snapshot, oldest first.
+    *** \param success Set to whether the snapshot was saved.
+    *** \return False when no snapshot was saved since the last call.
+    **/
+    bool PopResult(bool& success);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    AsyncSaveWriter(const AsyncSaveWriter& async_save_writer);
+    AsyncSaveWriter& operator=(const AsyncSaveWriter& async_save_writer);
+
+    //! \brief A snapshot to save, owned by the worker once queued.
+    class _Job
+    {
+    public:
+        _Job() :
+            snapshot(nullptr),
+            preview(nullptr)
+        {}
+
+        SaveFileWriter* snapshot;
+        std::string filename;
+        SaveFileWriter* preview;
+        std::string preview_filename;
+        std::string obsolete_filename;
+    };
+
+    //! \brief The snapshots to save, oldest first.
+    std::deque<_Job> _jobs;
+
+    //! \brief The number of snapshots queued or being saved.
+    uint32_t _pending_jobs;
+
+    //! \brief The results of the saved snapshots, not popped yet.
+    std::deque<bool> _results;
+
+    //! \brief The thread saving the snapshots, or nullptr when it couldn't be created.
+    SDL_Thread* _thread;
+
+    //! \brief Protects all the members above and the quit flag.
+    SDL_mutex* _mutex;
+
+    //! \brief Signaled when a job is queued, or when the worker must stop.
+    SDL_cond* _job_queued;
+
+    //! \brief Signaled when the last pending job is done.
+    SDL_cond* _jobs_done;
+
+    //! \brief Tells the worker to stop once all the jobs are saved.
+    bool _quit;
+
+    //! \brief Saves a snapshot and its preview, and deletes them.
+    static bool _Save(const _Job& job);
+
+    //! \brief The entry point of the worker thread.
+    static int _WorkerThread(void* async_save_writer);
+
+    //! \brief Saves the queued snapshots until told to stop.
+    void _Work();
+};
+
+} // namespace vt_global
+
+#endif // __GLOBAL_ASYNC_SAVE_HEADER__
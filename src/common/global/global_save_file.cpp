@@ -0,0 +1,635 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    global_save_file.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the binary saved game files.
+*** ***************************************************************************/
+
+#include "global_save_file.h"
+
+#include "utils/utils_common.h"
+
+#include "utils/utils_files.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace vt_global
+{
+
+//! \brief The size of the header of the binary saved game files, in bytes.
+const size_t SAVE_FILE_HEADER_SIZE = 16;
+
+//! \brief The magic at the start of the binary saved game files.
+const char SAVE_FILE_MAGIC[4] = { 'V', 'T', 'S', 'V' };
+
+//! \brief The longest variable-length integer, in bytes.
+const uint32_t SAVE_FILE_MAX_VARINT_SIZE = 10;
+
+//! \brief Computes the CRC-32 (IEEE 802.3) of some data.
+//! The saved games are small enough for the bitwise version to do.
+static uint32_t _ComputeCRC32(const std::vector<uint8_t>& data)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < data.size(); ++i) {
+        crc ^= data[i];
+        for (uint32_t j = 0; j < 8; ++j)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void _WriteFixedUInt(uint32_t value, uint32_t size, std::vector<uint8_t>& data)
+{
+    for (uint32_t i = 0; i < size; ++i)
+        data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static uint32_t _ReadFixedUInt(const uint8_t* data, uint32_t size)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < size; ++i)
+        value |= static_cast<uint32_t>(data[i]) << (8 * i);
+    return value;
+}
+
+//! \brief The shortest match of the compressed payloads, in bytes.
+const size_t SAVE_FILE_MIN_MATCH = 4;
+
+//! \brief The farthest match of the compressed payloads, their offsets taking 2 bytes.
+const size_t SAVE_FILE_MAX_MATCH_OFFSET = 0xFFFF;
+
+//! \brief The number of bits of the hash table finding the matches when compressing.
+const uint32_t SAVE_FILE_MATCH_HASH_BITS = 12;
+
+static uint32_t _ReadSequence(const uint8_t* data)
+{
+    return _ReadFixedUInt(data, SAVE_FILE_MIN_MATCH);
+}
+
+//! \brief Appends the part of a literals or match length not fitting in the token.
+static void _WriteExtraLength(size_t length, std::vector<uint8_t>& data)
+{
+    while (length >= 255) {
+        data.push_back(255);
+        length -= 255;
+    }
+    data.push_back(static_cast<uint8_t>(length));
+}
+
+//! \brief Reads the part of a length not fitting in the token, adding it to the length.
+static bool _ReadExtraLength(const std::vector<uint8_t>& data, size_t& position, size_t& length)
+{
+    uint8_t byte = 255;
+    while (byte == 255) {
+        if (position >= data.size())
+            return false;
+        byte = data[position++];
+        length += byte;
+    }
+    return true;
+}
+
+//! \brief Appends a compressed sequence. The last one has no match, its match length being 0.
+static void _WriteSequence(const uint8_t* literals, size_t literals_length,
+                           size_t match_length, size_t match_offset, std::vector<uint8_t>& data)
+{
+    const size_t extra_match_length = match_length > 0 ? match_length - SAVE_FILE_MIN_MATCH : 0;
+    const uint8_t token = static_cast<uint8_t>((std::min<size_t>(literals_length, 15) << 4) |
+                                               std::min<size_t>(extra_match_length, 15));
+    data.push_back(token);
+    if (literals_length >= 15)
+        _WriteExtraLength(literals_length - 15, data);
+    data.insert(data.end(), literals, literals + literals_length);
+
+    if (match_length == 0)
+        return;
+
+    _WriteFixedUInt(static_cast<uint32_t>(match_offset), 2, data);
+    if (extra_match_length >= 15)
+        _WriteExtraLength(extra_match_length - 15, data);
+}
+
+//! \brief Compresses a payload, see the file format in the header.
+//! The matches are found through a single entry hash table, favoring the speed.
+static void _Compress(const std::vector<uint8_t>& data, std::vector<uint8_t>& compressed_data)
+{
+    compressed_data.clear();
+    compressed_data.reserve(data.size() / 2);
+    _WriteFixedUInt(static_cast<uint32_t>(data.size()), 4, compressed_data);
+
+    // The positions plus one of the last sequences seen, 0 meaning none.
+    std::vector<size_t> last_positions(static_cast<size_t>(1) << SAVE_FILE_MATCH_HASH_BITS, 0);
+
+    size_t literals_start = 0;
+    size_t position = 0;
+    while (position + SAVE_FILE_MIN_MATCH <= data.size()) {
+        const uint32_t sequence = _ReadSequence(&data[position]);
+        const uint32_t hash = (sequence * 2654435761u) >> (32 - SAVE_FILE_MATCH_HASH_BITS);
+        const size_t candidate = last_positions[hash];
+        last_positions[hash] = position + 1;
+
+        if (candidate == 0 || position - (candidate - 1) > SAVE_FILE_MAX_MATCH_OFFSET ||
+                _ReadSequence(&data[candidate - 1]) != sequence) {
+            ++position;
+            continue;
+        }
+
+        const size_t match = candidate - 1;
+        size_t match_length = SAVE_FILE_MIN_MATCH;
+        while (position + match_length < data.size() && data[match + match_length] == data[position + match_length])
+            ++match_length;
+
+        _WriteSequence(data.data() + literals_start, position - literals_start,
+                       match_length, position - match, compressed_data);
+        position += match_length;
+        literals_start = position;
+    }
+
+    _WriteSequence(data.data() + literals_start, data.size() - literals_start, 0, 0, compressed_data);
+}
+
+//! \brief Uncompresses a payload, checking every length and offset.
+//! \return False if the compressed data is malformed.
+static bool _Uncompress(const std::vector<uint8_t>& compressed_data, std::vector<uint8_t>& data)
+{
+    data.clear();
+    if (compressed_data.size() < 4)
+        return false;
+
+    // A sequence can't expand more than 255 times, which also bounds the allocation.
+    const size_t size = _ReadFixedUInt(&compressed_data[0], 4);
+    if (size / 255 > compressed_data.size())
+        return false;
+    data.reserve(size);
+
+    size_t position = 4;
+    while (position < compressed_data.size()) {
+        const uint8_t token = compressed_data[position++];
+
+        size_t literals_length = token >> 4;
+        if (literals_length == 15 && !_ReadExtraLength(compressed_data, position, literals_length))
+            return false;
+        if (literals_length > compressed_data.size() - position || literals_length > size - data.size())
+            return false;
+        data.insert(data.end(), compressed_data.begin() + position, compressed_data.begin() + position + literals_length);
+        position += literals_length;
+
+        // The last sequence has no match.
+        if (position == compressed_data.size())
+            break;
+
+        if (compressed_data.size() - position < 2)
+            return false;
+        const size_t match_offset = _ReadFixedUInt(&compressed_data[position], 2);
+        position += 2;
+
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !_ReadExtraLength(compressed_data, position, match_length))
+            return false;
+        match_length += SAVE_FILE_MIN_MATCH;
+        if (match_offset == 0 || match_offset > data.size() || match_length > size - data.size())
+            return false;
+
+        // The match can overlap the bytes it copies.
+        const size_t match = data.size() - match_offset;
+        for (size_t i = 0; i < match_length; ++i) {
+            const uint8_t byte = data[match + i];
+            data.push_back(byte);
+        }
+    }
+
+    return data.size() == size;
+}
+
+//! \brief Moves a file over another one, replacing it at once.
+static bool _ReplaceFile(const std::string& source, const std::string& destination)
+{
+#ifdef _WIN32
+    // rename() fails on Windows when the destination exists.
+    return MoveFileExA(source.c_str(), destination.c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(source.c_str(), destination.c_str()) == 0;
+#endif
+}
+
+//! \brief Replaces the ".lua" extension of a saved game filename, or appends the new one.
+static std::string _ReplaceLuaExtension(const std::string& lua_filename, const std::string& extension)
+{
+    const std::string lua_extension(".lua");
+    if (lua_filename.size() > lua_extension.size() &&
+            lua_filename.compare(lua_filename.size() - lua_extension.size(), lua_extension.size(), lua_extension) == 0)
+        return lua_filename.substr(0, lua_filename.size() - lua_extension.size()) + extension;
+    return lua_filename + extension;
+}
+
+std::string GetBinarySaveFilename(const std::string& lua_filename)
+{
+    return _ReplaceLuaExtension(lua_filename, ".sav");
+}
+
+std::string GetSavePreviewFilename(const std::string& lua_filename)
+{
+    return _ReplaceLuaExtension(lua_filename, ".preview");
+}
+
+int64_t GetSaveFileSize(const std::string& filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return -1;
+    return static_cast<int64_t>(file.tellg());
+}
+
+bool OpenBinarySaveFile(SaveFileReader& file, const std::string& lua_filename)
+{
+    const std::string binary_filename = GetBinarySaveFilename(lua_filename);
+    if (!vt_utils::DoesFileExist(binary_filename) || !file.OpenFile(binary_filename))
+        return false;
+
+    // The play data starts with the play time (3 values) and the drunes,
+    // followed by the size of the Lua file written along.
+    if (!file.OpenSection(SAVE_SECTION_PLAY_DATA))
+        return false;
+    for (uint32_t i = 0; i < 4; ++i)
+        file.ReadUInt();
+    const int64_t lua_file_size = file.ReadInt();
+    if (file.IsErrorDetected())
+        return false;
+
+    if (lua_file_size >= 0)
+        return GetSaveFileSize(lua_filename) == lua_file_size;
+
+    // Written alone: The Lua file, if any, must be the older one.
+    return !vt_utils::DoesFileExist(lua_filename) ||
+           vt_utils::GetFileModTime(lua_filename) <= vt_utils::GetFileModTime(binary_filename);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SaveFileWriter class
+////////////////////////////////////////////////////////////////////////////////
+
+SaveFileWriter::SaveFileWriter() :
+    _compressed_payload_valid(false),
+    _section(SAVE_SECTION_INVALID)
+{
+}
+
+void SaveFileWriter::BeginSection(SAVE_SECTION section)
+{
+    if (_section != SAVE_SECTION_INVALID) {
+        PRINT_WARNING << "The previous section wasn't ended: " << _section << std::endl;
+        EndSection();
+    }
+
+    _section = section;
+    _section_data.clear();
+}
+
+void SaveFileWriter::EndSection()
+{
+    if (_section == SAVE_SECTION_INVALID) {
+        PRINT_WARNING << "No section was started." << std::endl;
+        return;
+    }
+
+    _WriteVarInt(_section, _payload);
+    _WriteVarInt(_section_data.size(), _payload);
+    _payload.insert(_payload.end(), _section_data.begin(), _section_data.end());
+    _compressed_payload_valid = false;
+
+    _section = SAVE_SECTION_INVALID;
+    _section_data.clear();
+}
+
+void SaveFileWriter::EndSection(std::vector<uint8_t>& section_data)
+{
+    section_data = _section_data;
+    EndSection();
+}
+
+void SaveFileWriter::WriteSection(SAVE_SECTION section, const std::vector<uint8_t>& section_data)
+{
+    BeginSection(section);
+    _section_data = section_data;
+    EndSection();
+}
+
+void SaveFileWriter::WriteUInt(uint64_t value)
+{
+    _WriteVarInt(value, _section_data);
+}
+
+void SaveFileWriter::WriteInt(int64_t value)
+{
+    // Zigzag encoding, so that the small negative values stay short.
+    const uint64_t bits = static_cast<uint64_t>(value);
+    _WriteVarInt((bits << 1) ^ (value < 0 ? ~static_cast<uint64_t>(0) : 0), _section_data);
+}
+
+void SaveFileWriter::WriteBool(bool value)
+{
+    _section_data.push_back(value ? 1 : 0);
+}
+
+void SaveFileWriter::WriteFloat(float value)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    _WriteFixedUInt(bits, 4, _section_data);
+}
+
+void SaveFileWriter::WriteString(const std::string& value)
+{
+    _WriteVarInt(value.size(), _section_data);
+    _section_data.insert(_section_data.end(), value.begin(), value.end());
+}
+
+void SaveFileWriter::WriteUIntVector(const std::vector<uint32_t>& values)
+{
+    _WriteVarInt(values.size(), _section_data);
+    for (uint32_t i = 0; i < values.size(); ++i)
+        _WriteVarInt(values[i], _section_data);
+}
+
+bool SaveFileWriter::SaveFile(const std::string& filename)
+{
+    if (_section != SAVE_SECTION_INVALID)
+        EndSection();
+
+    uint16_t flags = 0;
+    const std::vector<uint8_t>& payload = _GetStoredPayload(flags);
+
+    std::vector<uint8_t> header(SAVE_FILE_MAGIC, SAVE_FILE_MAGIC + 4);
+    _WriteFixedUInt(SAVE_FILE_VERSION, 2, header);
+    _WriteFixedUInt(flags, 2, header);
+    _WriteFixedUInt(payload.size(), 4, header);
+    _WriteFixedUInt(_ComputeCRC32(payload), 4, header);
+
+    const std::string temp_filename = filename + ".tmp";
+    std::ofstream file(temp_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        PRINT_WARNING << "Couldn't open the binary saved game file for writing: " << temp_filename << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header[0]), header.size());
+    if (!payload.empty())
+        file.write(reinterpret_cast<const char*>(&payload[0]), payload.size());
+    file.close();
+
+    if (file.fail() || !_ReplaceFile(temp_filename, filename)) {
+        PRINT_WARNING << "Couldn't write the binary saved game file: " << filename << std::endl;
+        std::remove(temp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t SaveFileWriter::GetFileSize()
+{
+    if (_section != SAVE_SECTION_INVALID)
+        EndSection();
+
+    uint16_t flags = 0;
+    return SAVE_FILE_HEADER_SIZE + _GetStoredPayload(flags).size();
+}
+
+const std::vector<uint8_t>& SaveFileWriter::_GetStoredPayload(uint16_t& flags)
+{
+    if (!_compressed_payload_valid) {
+        _Compress(_payload, _compressed_payload);
+        _compressed_payload_valid = true;
+    }
+
+    if (_compressed_payload.size() < _payload.size()) {
+        flags = SAVE_FILE_FLAG_COMPRESSED;
+        return _compressed_payload;
+    }
+
+    flags = 0;
+    return _payload;
+}
+
+void SaveFileWriter::_WriteVarInt(uint64_t value, std::vector<uint8_t>& data)
+{
+    while (value >= 0x80) {
+        data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<uint8_t>(value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SaveFileReader class
+////////////////////////////////////////////////////////////////////////////////
+
+SaveFileReader::SaveFileReader() :
+    _version(0),
+    _position(0),
+    _section_end(0),
+    _error(false)
+{
+}
+
+bool SaveFileReader::OpenFile(const std::string& filename)
+{
+    _filename = filename;
+    _version = 0;
+    _payload.clear();
+    _sections.clear();
+    _position = 0;
+    _section_end = 0;
+    _error = false;
+
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    uint8_t header[SAVE_FILE_HEADER_SIZE];
+    file.read(reinterpret_cast<char*>(header), SAVE_FILE_HEADER_SIZE);
+    if (!file.good() || memcmp(header, SAVE_FILE_MAGIC, 4) != 0) {
+        PRINT_WARNING << "Not a binary saved game file: " << filename << std::endl;
+        return false;
+    }
+
+    _version = static_cast<uint16_t>(_ReadFixedUInt(header + 4, 2));
+    if (_version == 0 || _version > SAVE_FILE_VERSION) {
+        PRINT_WARNING << "Unsupported binary saved game file version " << _version
+                      << ": " << filename << std::endl;
+        return false;
+    }
+
+    // The flags were reserved before the version 2.
+    const uint16_t flags = _version >= 2 ? static_cast<uint16_t>(_ReadFixedUInt(header + 6, 2)) : 0;
+    if ((flags & ~SAVE_FILE_FLAG_COMPRESSED) != 0) {
+        PRINT_WARNING << "Unsupported binary saved game file flags " << flags
+                      << ": " << filename << std::endl;
+        return false;
+    }
+
+    const uint32_t payload_size = _ReadFixedUInt(header + 8, 4);
+    const uint32_t crc = _ReadFixedUInt(header + 12, 4);
+
+    // Check the size before allocating anything.
+    file.seekg(0, std::ios::end);
+    const std::streamoff file_size = file.tellg();
+    file.seekg(SAVE_FILE_HEADER_SIZE, std::ios::beg);
+    if (file_size != static_cast<std::streamoff>(SAVE_FILE_HEADER_SIZE + payload_size)) {
+        PRINT_WARNING << "Truncated binary saved game file: " << filename << std::endl;
+        return false;
+    }
+
+    // Uncompressed payloads are read in place.
+    std::vector<uint8_t>& stored_payload = (flags & SAVE_FILE_FLAG_COMPRESSED) ? _stored_payload : _payload;
+    stored_payload.resize(payload_size);
+    if (payload_size > 0)
+        file.read(reinterpret_cast<char*>(&stored_payload[0]), payload_size);
+    if (!file.good() || _ComputeCRC32(stored_payload) != crc) {
+        PRINT_WARNING << "Corrupted binary saved game file: " << filename << std::endl;
+        stored_payload.clear();
+        return false;
+    }
+
+    if ((flags & SAVE_FILE_FLAG_COMPRESSED) && !_Uncompress(_stored_payload, _payload)) {
+        PRINT_WARNING << "Malformed compressed binary saved game file: " << filename << std::endl;
+        _payload.clear();
+        return false;
+    }
+
+    // Index the sections.
+    size_t position = 0;
+    while (position < _payload.size()) {
+        uint64_t section = 0;
+        uint64_t size = 0;
+        _position = position;
+        if (!_ReadVarInt(_payload.size(), section) || !_ReadVarInt(_payload.size(), size) ||
+                size > _payload.size() - _position) {
+            PRINT_WARNING << "Malformed binary saved game file sections: " << filename << std::endl;
+            _payload.clear();
+            _sections.clear();
+            return false;
+        }
+
+        _sections[static_cast<uint32_t>(section)] = std::make_pair(_position, _position + static_cast<size_t>(size));
+        position = _position + static_cast<size_t>(size);
+    }
+
+    _position = 0;
+    return true;
+}
+
+bool SaveFileReader::OpenSection(SAVE_SECTION section)
+{
+    std::map<uint32_t, std::pair<size_t, size_t> >::const_iterator it = _sections.find(section);
+    if (it == _sections.end()) {
+        _position = 0;
+        _section_end = 0;
+        return false;
+    }
+
+    _position = it->second.first;
+    _section_end = it->second.second;
+    return true;
+}
+
+uint64_t SaveFileReader::ReadUInt()
+{
+    uint64_t value = 0;
+    if (!_ReadVarInt(_section_end, value)) {
+        _error = true;
+        return 0;
+    }
+    return value;
+}
+
+int64_t SaveFileReader::ReadInt()
+{
+    const uint64_t bits = ReadUInt();
+    return static_cast<int64_t>((bits >> 1) ^ (0 - (bits & 1)));
+}
+
+bool SaveFileReader::ReadBool()
+{
+    if (_position >= _section_end) {
+        _error = true;
+        return false;
+    }
+    return _payload[_position++] != 0;
+}
+
+float SaveFileReader::ReadFloat()
+{
+    if (_section_end - _position < 4) {
+        _error = true;
+        return 0.0f;
+    }
+
+    const uint32_t bits = _ReadFixedUInt(&_payload[_position], 4);
+    _position += 4;
+
+    float value = 0.0f;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string SaveFileReader::ReadString()
+{
+    const uint64_t size = ReadUInt();
+    if (size > _section_end - _position) {
+        _error = true;
+        return std::string();
+    }
+
+    std::string value(reinterpret_cast<const char*>(&_payload[0]) + _position, static_cast<size_t>(size));
+    _position += static_cast<size_t>(size);
+    return value;
+}
+
+void SaveFileReader::ReadUIntVector(std::vector<uint32_t>& values)
+{
+    values.clear();
+
+    // Each value takes one byte at least.
+    const uint64_t size = ReadUInt();
+    if (size > _section_end - _position) {
+        _error = true;
+        return;
+    }
+
+    values.reserve(static_cast<size_t>(size));
+    for (uint64_t i = 0; i < size && !_error; ++i)
+        values.push_back(static_cast<uint32_t>(ReadUInt()));
+}
+
+bool SaveFileReader::_ReadVarInt(size_t end, uint64_t& value)
+{
+    value = 0;
+    for (uint32_t i = 0; i < SAVE_FILE_MAX_VARINT_SIZE; ++i) {
+        if (_position >= end)
+            return false;
+
+        const uint8_t byte = _payload[_position++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+} // namespace vt_global
@@ -0,0 +1,230 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    global_save_file.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the binary saved game files.
+***
+*** A binary saved game file is written next to each Lua one, with the same
+*** name and the ".sav" extension. It starts with a fixed size header:
+***
+*** - The "VTSV" magic,
+*** - The format version (2 bytes),
+*** - The flags (2 bytes, reserved in the version 1),
+*** - The size of the stored payload (4 bytes),
+*** - The CRC-32 of the stored payload (4 bytes).
+***
+*** All of those are little endian. When the SAVE_FILE_FLAG_COMPRESSED flag is
+*** set, the stored payload is the size of the payload (4 bytes) followed by
+*** the payload compressed as a list of LZ77 sequences, in the LZ4 block way:
+*** A token giving the literals length (upper 4 bits) and the match length
+*** minus 4 (lower 4 bits), each one continued by 255 valued bytes when 15,
+*** the literals, then the match offset (2 bytes). The last sequence has no
+*** match. The checksum is checked before uncompressing anything.
+***
+*** The payload is a list of sections, each
+*** one being its type and its size in bytes followed by its content, so that
+*** unknown sections can be skipped. Every integer of the payload is a
+*** variable-length integer, using 7 bits per byte, the signed ones being
+*** zigzag encoded. The strings are their size followed by their bytes.
+***
+*** The files are written to a temporary file first, and then renamed over the
+*** previous one, so that a failure while writing never corrupts it.
+*** ***************************************************************************/
+
+#ifndef __GLOBAL_SAVE_FILE_HEADER__
+#define __GLOBAL_SAVE_FILE_HEADER__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vt_global
+{
+
+//! \brief The version of the binary saved game files written.
+const uint16_t SAVE_FILE_VERSION = 2;
+
+//! \brief The flags of the binary saved game files header.
+enum SAVE_FILE_FLAGS {
+    //! The payload is compressed. Since the version 2.
+    SAVE_FILE_FLAG_COMPRESSED = 1
+};
+
+//! \brief The sections of a binary saved game file. Never renumber them.
+enum SAVE_SECTION {
+    SAVE_SECTION_INVALID    = 0,
+    SAVE_SECTION_PLAY_DATA  = 1,
+    SAVE_SECTION_MAP_DATA   = 2,
+    SAVE_SECTION_INVENTORY  = 3,
+    SAVE_SECTION_CHARACTERS = 4,
+    SAVE_SECTION_EVENTS     = 5,
+    SAVE_SECTION_QUESTS     = 6,
+    SAVE_SECTION_WORLD_MAP  = 7,
+    SAVE_SECTION_SHOP_DATA  = 8,
+    //! Only found in the preview files, see global_save_preview.h.
+    SAVE_SECTION_PREVIEW    = 9
+};
+
+//! \brief Returns the binary saved game filename corresponding to a Lua one.
+std::string GetBinarySaveFilename(const std::string& lua_filename);
+
+//! \brief Returns the saved game preview filename corresponding to a Lua one.
+std::string GetSavePreviewFilename(const std::string& lua_filename);
+
+class SaveFileReader;
+
+/** \brief Opens the binary saved game file corresponding to a Lua one, if it is up to date.
+*** \param file The reader to open the binary file with.
+*** \param lua_filename The Lua saved game filename.
+*** \return False if there is no valid binary file, or if the Lua file is more recent.
+*** The Lua file must be imported then.
+**/
+bool OpenBinarySaveFile(SaveFileReader& file, const std::string& lua_filename);
+
+/** \brief Returns the size of a file in bytes, or -1 if it can't be opened.
+*** The binary saved games store the size of the Lua one written along, -1
+*** meaning none was, to detect whether it was overwritten since.
+**/
+int64_t GetSaveFileSize(const std::string& filename);
+
+/** ****************************************************************************
+*** \brief Writes a binary saved game file.
+***
+*** The data is kept in memory until the file is saved. Everything is written
+*** within sections, which can't be nested.
+*** ***************************************************************************/
+class SaveFileWriter
+{
+public:
+    SaveFileWriter();
+
+    //! \brief Starts a new section. The previous one must be ended.
+    void BeginSection(SAVE_SECTION section);
+
+    //! \brief Ends the current section.
+    void EndSection();
+
+    //! \brief Ends the current section, and gives its content so that it can be reused.
+    void EndSection(std::vector<uint8_t>& section_data);
+
+    //! \brief Writes a whole section, with the content given by EndSection().
+    void WriteSection(SAVE_SECTION section, const std::vector<uint8_t>& section_data);
+
+    void WriteUInt(uint64_t value);
+    void WriteInt(int64_t value);
+    void WriteBool(bool value);
+    void WriteFloat(float value);
+    void WriteString(const std::string& value);
+    void WriteUIntVector(const std::vector<uint32_t>& values);
+
+    /** \brief Writes the header and the sections to a file, replacing it once fully written.
+    *** \return False if the file couldn't be written. The previous file is left untouched then.
+    *** \note This doesn't use anything global, so any thread can save the file.
+    **/
+    bool SaveFile(const std::string& filename);
+
+    //! \brief The size of the file written by SaveFile(), the current section being ended.
+    //! \note This compresses the payload, which SaveFile() then reuses.
+    uint64_t GetFileSize();
+
+private:
+    //! \brief The ended sections, in order.
+    std::vector<uint8_t> _payload;
+
+    //! \brief The compressed payload, valid until a section is ended.
+    std::vector<uint8_t> _compressed_payload;
+    bool _compressed_payload_valid;
+
+    //! \brief The content of the current section.
+    std::vector<uint8_t> _section_data;
+
+    //! \brief The current section. SAVE_SECTION_INVALID when none is started.
+    SAVE_SECTION _section;
+
+    //! \brief Appends a variable-length integer to the given data.
+    void _WriteVarInt(uint64_t value, std::vector<uint8_t>& data);
+
+    /** \brief Gives the payload as written in the file, compressing it if not done yet.
+    *** \param flags Set to the header flags describing the stored payload.
+    *** \note The payload is stored uncompressed when compressing it doesn't make it smaller.
+    **/
+    const std::vector<uint8_t>& _GetStoredPayload(uint16_t& flags);
+};
+
+/** ****************************************************************************
+*** \brief Reads a binary saved game file.
+***
+*** The whole file is checked when opened. The reads never go past the end of
+*** the current section: They return zero values and set the error flag instead,
+*** so that a truncated or corrupted section is detected once read.
+*** ***************************************************************************/
+class SaveFileReader
+{
+public:
+    SaveFileReader();
+
+    /** \brief Reads a file and checks its header and checksum.
+    *** \return False if the file is missing, corrupted or from a newer version.
+    **/
+    bool OpenFile(const std::string& filename);
+
+    //! \brief Starts reading a section. Returns false when it isn't in the file.
+    bool OpenSection(SAVE_SECTION section);
+
+    uint64_t ReadUInt();
+    int64_t ReadInt();
+    bool ReadBool();
+    float ReadFloat();
+    std::string ReadString();
+    void ReadUIntVector(std::vector<uint32_t>& values);
+
+    //! \brief Whether a read went past the end of its section, or a value was malformed.
+    bool IsErrorDetected() const {
+        return _error;
+    }
+
+    //! \brief The format version of the file, for the fields added later on.
+    uint16_t GetVersion() const {
+        return _version;
+    }
+
+    const std::string& GetFilename() const {
+        return _filename;
+    }
+
+private:
+    std::string _filename;
+
+    uint16_t _version;
+
+    //! \brief The payload of the file.
+    std::vector<uint8_t> _payload;
+
+    //! \brief The payload as stored in the file, kept to reuse its memory when compressed.
+    std::vector<uint8_t> _stored_payload;
+
+    //! \brief The start and end offsets of each section in the payload.
+    std::map<uint32_t, std::pair<size_t, size_t> > _sections;
+
+    //! \brief The read offset, and the end of the current section.
+    size_t _position;
+    size_t _section_end;
+
+    bool _error;
+
+    //! \brief Reads a variable-length integer, from the payload up to the given end.
+    bool _ReadVarInt(size_t end, uint64_t& value);
+};
+
+} // namespace vt_global
+
+#endif // __GLOBAL_SAVE_FILE_HEADER__
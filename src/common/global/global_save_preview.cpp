@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    global_save_preview.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the saved game previews.
+*** ***************************************************************************/
+
+#include "global_save_preview.h"
+
+#include "global_save_file.h"
+#include "actors/global_character.h"
+
+#include "utils/utils_files.h"
+
+namespace vt_global
+{
+
+SavePreview::SavePreview() :
+    play_hours(0),
+    play_minutes(0),
+    play_seconds(0),
+    drunes(0),
+    lua_file_size(-1),
+    binary_file_size(-1)
+{
+}
+
+void SavePreview::AddCharacter(const GlobalCharacter& character)
+{
+    if (characters.size() >= SAVE_PREVIEW_CHARACTERS)
+        return;
+
+    SavePreviewCharacter preview;
+    preview.id = character.GetID();
+    preview.experience_level = character.GetExperienceLevel();
+    preview.total_experience_points = character.GetTotalExperiencePoints();
+    preview.unspent_experience_points = character.GetUnspentExperiencePoints();
+    preview.experience_for_next_level = character.GetExperienceForNextLevel();
+    preview.max_hit_points = character.GetMaxHitPoints();
+    preview.hit_points = character.GetHitPoints();
+    preview.max_skill_points = character.GetMaxSkillPoints();
+    preview.skill_points = character.GetSkillPoints();
+    characters.push_back(preview);
+}
+
+void SavePreview::SetFileSizes(const std::string& lua_filename)
+{
+    lua_file_size = GetSaveFileSize(lua_filename);
+    binary_file_size = GetSaveFileSize(GetBinarySaveFilename(lua_filename));
+}
+
+void SavePreview::Write(SaveFileWriter& file) const
+{
+    file.BeginSection(SAVE_SECTION_PREVIEW);
+    file.WriteUInt(play_hours);
+    file.WriteUInt(play_minutes);
+    file.WriteUInt(play_seconds);
+    file.WriteUInt(drunes);
+    file.WriteInt(lua_file_size);
+    file.WriteInt(binary_file_size);
+
+    file.WriteString(map_data_filename);
+    file.WriteString(map_script_filename);
+    file.WriteString(map_name);
+    file.WriteString(map_image_filename);
+
+    file.WriteUInt(characters.size());
+    for (uint32_t i = 0; i < characters.size(); ++i) {
+        const SavePreviewCharacter& character = characters[i];
+        file.WriteUInt(character.id);
+        file.WriteUInt(character.experience_level);
+        file.WriteUInt(character.total_experience_points);
+        file.WriteUInt(character.unspent_experience_points);
+        file.WriteInt(character.experience_for_next_level);
+        file.WriteUInt(character.max_hit_points);
+        file.WriteUInt(character.hit_points);
+        file.WriteUInt(character.max_skill_points);
+        file.WriteUInt(character.skill_points);
+    }
+    file.EndSection();
+}
+
+bool SavePreview::Read(SaveFileReader& file)
+{
+    if (!file.OpenSection(SAVE_SECTION_PREVIEW))
+        return false;
+
+    play_hours = static_cast<uint32_t>(file.ReadUInt());
+    play_minutes = static_cast<uint32_t>(file.ReadUInt());
+    play_seconds = static_cast<uint32_t>(file.ReadUInt());
+    drunes = static_cast<uint32_t>(file.ReadUInt());
+    lua_file_size = file.ReadInt();
+    binary_file_size = file.ReadInt();
+
+    map_data_filename = file.ReadString();
+    map_script_filename = file.ReadString();
+    map_name = file.ReadString();
+    map_image_filename = file.ReadString();
+
+    characters.clear();
+    const uint64_t character_count = file.ReadUInt();
+    for (uint64_t i = 0; i < character_count && i < SAVE_PREVIEW_CHARACTERS && !file.IsErrorDetected(); ++i) {
+        SavePreviewCharacter character;
+        character.id = static_cast<uint32_t>(file.ReadUInt());
+        character.experience_level = static_cast<uint32_t>(file.ReadUInt());
+        character.total_experience_points = static_cast<uint32_t>(file.ReadUInt());
+        character.unspent_experience_points = static_cast<uint32_t>(file.ReadUInt());
+        character.experience_for_next_level = static_cast<int32_t>(file.ReadInt());
+        character.max_hit_points = static_cast<uint32_t>(file.ReadUInt());
+        character.hit_points = static_cast<uint32_t>(file.ReadUInt());
+        character.max_skill_points = static_cast<uint32_t>(file.ReadUInt());
+        character.skill_points = static_cast<uint32_t>(file.ReadUInt());
+        characters.push_back(character);
+    }
+
+    return !file.IsErrorDetected();
+}
+
+bool SavePreview::LoadFile(const std::string& lua_filename)
+{
+    const std::string preview_filename = GetSavePreviewFilename(lua_filename);
+    if (!vt_utils::DoesFileExist(preview_filename))
+        return false;
+
+    SaveFileReader file;
+    if (!file.OpenFile(preview_filename) || !Read(file))
+        return false;
+
+    // A preview left alone doesn't describe anything.
+    if (lua_file_size < 0 && binary_file_size < 0)
+        return false;
+
+    // The saved game files must be the ones written along.
+    const std::string binary_filename = GetBinarySaveFilename(lua_filename);
+    if (GetSaveFileSize(lua_filename) != lua_file_size ||
+            GetSaveFileSize(binary_filename) != binary_file_size)
+        return false;
+
+    // The preview is written last, so it is never older than them.
+    if (lua_file_size >= 0 &&
+            vt_utils::GetFileModTime(lua_filename) > vt_utils::GetFileModTime(preview_filename))
+        return false;
+    if (binary_file_size >= 0 &&
+            vt_utils::GetFileModTime(binary_filename) > vt_utils::GetFileModTime(preview_filename))
+        return false;
+
+    return true;
+}
+
+bool SavePreview::SaveFile(const std::string& lua_filename) const
+{
+    SaveFileWriter file;
+    Write(file);
+    return file.SaveFile(GetSavePreviewFilename(lua_filename));
+}
+
+} // namespace vt_global
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    global_save_preview.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the saved game previews.
+***
+*** A small file is written next to each saved game, with the same name and
+*** the ".preview" extension, holding only what the save menu shows. It uses
+*** the binary saved game format, with a single preview section.
+***
+*** The preview stores the sizes of the saved game files it was written along.
+*** It is ignored when they don't match anymore, or when it is older than them.
+*** ***************************************************************************/
+
+#ifndef __GLOBAL_SAVE_PREVIEW_HEADER__
+#define __GLOBAL_SAVE_PREVIEW_HEADER__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vt_global
+{
+
+class GlobalCharacter;
+class SaveFileReader;
+class SaveFileWriter;
+
+//! \brief The maximum number of characters stored in a saved game preview.
+const uint32_t SAVE_PREVIEW_CHARACTERS = 4;
+
+//! \brief The character data shown in the save menu.
+class SavePreviewCharacter
+{
+public:
+    SavePreviewCharacter() :
+        id(0),
+        experience_level(0),
+        total_experience_points(0),
+        unspent_experience_points(0),
+        experience_for_next_level(0),
+        max_hit_points(0),
+        hit_points(0),
+        max_skill_points(0),
+        skill_points(0)
+    {}
+
+    uint32_t id;
+    uint32_t experience_level;
+    uint32_t total_experience_points;
+    uint32_t unspent_experience_points;
+    int32_t experience_for_next_level;
+    uint32_t max_hit_points;
+    uint32_t hit_points;
+    uint32_t max_skill_points;
+    uint32_t skill_points;
+};
+
+/** ****************************************************************************
+*** \brief The data of a saved game shown in the save menu.
+*** ***************************************************************************/
+class SavePreview
+{
+public:
+    SavePreview();
+
+    //! \brief Adds a character, once the maximum isn't reached yet.
+    void AddCharacter(const GlobalCharacter& character);
+
+    /** \brief Stores the sizes of the saved game files currently on disk.
+    *** \param lua_filename The Lua saved game filename, the binary one being deduced from it.
+    **/
+    void SetFileSizes(const std::string& lua_filename);
+
+    void Write(SaveFileWriter& file) const;
+
+    //! \return False when the preview section is missing or invalid.
+    bool Read(SaveFileReader& file);
+
+    /** \brief Loads the preview of a saved game.
+    *** \param lua_filename The Lua saved game filename.
+    *** \return False when there is no preview, or when it doesn't match the saved game files.
+    **/
+    bool LoadFile(const std::string& lua_filename);
+
+    //! \brief Saves the preview of a saved game, for the given Lua saved game filename.
+    bool SaveFile(const std::string& lua_filename) const;
+
+    uint32_t play_hours;
+    uint32_t play_minutes;
+    uint32_t play_seconds;
+    uint32_t drunes;
+
+    std::string map_data_filename;
+    std::string map_script_filename;
+
+    //! \brief The untranslated map name, and the map image filename.
+    std::string map_name;
+    std::string map_image_filename;
+
+    //! \brief The first characters of the party, in order.
+    std::vector<SavePreviewCharacter> characters;
+
+    //! \brief The sizes of the Lua and binary saved game files, -1 for a missing one.
+    int64_t lua_file_size;
+    int64_t binary_file_size;
+};
+
+} // namespace vt_global
+
+#endif // __GLOBAL_SAVE_PREVIEW_HEADER__
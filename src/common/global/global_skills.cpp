@@ -19,6 +19,8 @@
 
 #include "modes/battle/battle_target.h"
 
+#include "common/script_call_profiler.h"
+
 #include "script/script.h"
 #include "engine/video/video.h"
 
@@ -172,6 +174,7 @@ void GlobalSkill::ExecuteBattleWarmupFunction(private_battle::BattleActor* battl
     }
 
     try {
+        vt_common::ScriptCallTimer timer("skill BattleWarmup", _id, _battle_warmup_function);
         luabind::call_function<void>(_battle_warmup_function, battle_actor, target);
     } catch(const luabind::error& err) {
         ScriptManager->HandleLuaError(err);
@@ -189,6 +192,7 @@ bool GlobalSkill::ExecuteBattleFunction(private_battle::BattleActor* battle_acto
     }
 
     try {
+        vt_common::ScriptCallTimer timer("skill BattleExecute", _id, _battle_execute_function);
         luabind::call_function<void>(_battle_execute_function, battle_actor, target);
     } catch(const luabind::error& err) {
         ScriptManager->HandleLuaError(err);
@@ -40,6 +40,7 @@ void MapDataHandler::Clear()
     _map_data_filename.clear();
     _map_script_filename.clear();
     _map_hud_name.clear();
+    _map_name.clear();
 
     // Show the minimap by default when available
     _show_minimap = true;
@@ -111,10 +112,55 @@ bool MapDataHandler::Save(vt_script::WriteScriptDescriptor& file,
     return true;
 }
 
+bool MapDataHandler::Load(SaveFileReader& file)
+{
+    Clear();
+
+    _map_data_filename = file.ReadString();
+    _map_script_filename = file.ReadString();
+    _x_save_map_position = static_cast<uint32_t>(file.ReadUInt());
+    _y_save_map_position = static_cast<uint32_t>(file.ReadUInt());
+    _save_stamina = static_cast<uint32_t>(file.ReadUInt());
+
+    if (file.ReadBool()) {
+        std::string home_map_data = file.ReadString();
+        std::string home_map_script = file.ReadString();
+        float x_pos = file.ReadFloat();
+        float y_pos = file.ReadFloat();
+
+        _home_map = vt_map::MapLocation(home_map_data,
+                                        home_map_script,
+                                        x_pos, y_pos);
+    }
+
+    return !file.IsErrorDetected();
+}
+
+void MapDataHandler::Save(SaveFileWriter& file,
+                          uint32_t x_position,
+                          uint32_t y_position)
+{
+    file.WriteString(_map_data_filename);
+    file.WriteString(_map_script_filename);
+    //! \note Coords are in map tiles
+    file.WriteUInt(x_position);
+    file.WriteUInt(y_position);
+    file.WriteUInt(_save_stamina);
+
+    file.WriteBool(_home_map.IsValid());
+    if (_home_map.IsValid()) {
+        file.WriteString(_home_map.GetMapDataFilename());
+        file.WriteString(_home_map.GetMapScriptFilename());
+        file.WriteFloat(_home_map.GetMapPosition().x);
+        file.WriteFloat(_home_map.GetMapPosition().y);
+    }
+}
+
 void MapDataHandler::SetMap(const std::string &map_data_filename,
                             const std::string &map_script_filename,
                             const std::string &map_image_filename,
-                            const vt_utils::ustring &map_hud_name)
+                            const vt_utils::ustring &map_hud_name,
+                            const std::string &map_name)
 {
     _map_data_filename = map_data_filename;
     _map_script_filename = map_script_filename;
@@ -126,6 +172,7 @@ void MapDataHandler::SetMap(const std::string &map_data_filename,
     _previous_map_hud_name = _map_hud_name;
     _map_hud_name = map_hud_name;
     _same_map_hud_name_as_previous = (MakeStandardString(_previous_map_hud_name) == MakeStandardString(_map_hud_name));
+    _map_name = map_name;
 }
 
 } // namespace vt_global
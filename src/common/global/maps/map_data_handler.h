@@ -15,6 +15,8 @@
 #include "script/script_read.h"
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
 #include "modes/map/map_location.h"
 #include "engine/video/image.h"
 
@@ -40,6 +42,12 @@ public:
               uint32_t x_position,
               uint32_t y_position);
 
+    //! \brief Binary saved game versions of the functions above.
+    bool Load(SaveFileReader& file);
+    void Save(SaveFileWriter& file,
+              uint32_t x_position,
+              uint32_t y_position);
+
     //! \brief Tells whether the map mode minimap should be shown, if any.
     bool ShouldShowMinimap() const {
         return _show_minimap;
@@ -54,11 +62,13 @@ public:
     *** \param map_script_filename The string that contains the name of the current map script file.
     *** \param map_image_filename The filename of the image that presents this map
     *** \param map_hud_name The UTF16 map name shown at map intro time.
+    *** \param map_name The untranslated map name, stored in the saved game previews.
     **/
     void SetMap(const std::string& map_data_filename,
                 const std::string& map_script_filename,
                 const std::string& map_image_filename,
-                const vt_utils::ustring& map_hud_name);
+                const vt_utils::ustring& map_hud_name,
+                const std::string& map_name);
 
     const std::string& GetMapDataFilename() const {
         return _map_data_filename;
@@ -98,6 +108,14 @@ public:
         _save_stamina = stamina;
     }
 
+    /** \brief Sets the location the next map loaded places the character at, as when loading a game.
+    *** It is unset by the map once loaded.
+    **/
+    void SetSaveLocation(uint32_t x_position, uint32_t y_position) {
+        _x_save_map_position = x_position;
+        _y_save_map_position = y_position;
+    }
+
     const std::string& GetPreviousLocation() const {
         return _previous_location;
     }
@@ -153,6 +171,10 @@ public:
         return _map_hud_name;
     }
 
+    const std::string& GetMapName() const {
+        return _map_name;
+    }
+
 private:
     //! \brief The map data and script filename the current party is on.
     std::string _map_data_filename;
@@ -183,6 +205,9 @@ private:
     vt_utils::ustring _map_hud_name;
     bool _same_map_hud_name_as_previous;
 
+    //! \brief The untranslated current map name.
+    std::string _map_name;
+
     //! \brief Stores whether the map mode minimap should be shown.
     bool _show_minimap;
 };
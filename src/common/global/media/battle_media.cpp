@@ -10,10 +10,16 @@
 
 #include "battle_media.h"
 
+#include "common/global/global.h"
+#include "common/global/actors/global_character.h"
+
+#include "engine/asset_archive.h"
 #include "engine/system.h"
 #include "engine/audio/audio.h"
+#include "engine/video/video.h"
 
 #include "utils/utils_common.h"
+#include "utils/utils_files.h"
 
 namespace vt_global
 {
@@ -25,6 +31,31 @@ const std::string DEFAULT_VICTORY_MUSIC  = "data/music/Fanfare.ogg";
 const std::string DEFAULT_DEFEAT_MUSIC   = "data/music/Battle_lost-OGA-Mumu.ogg";
 //@}
 
+//! \brief The images loaded by BattleMedia::Initialize().
+static const char* const BATTLE_MEDIA_IMAGES[] = {
+    "data/battles/battle_scenes/desert_cave/desert_cave.png",
+    "data/gui/battle/stamina_icon_selected.png",
+    "data/gui/battle/attack_point_target.png",
+    "data/gui/battle/stamina_bar.png",
+    "data/gui/battle/character_selector.png",
+    "data/gui/battle/battle_character_selection.png",
+    "data/gui/battle/battle_character_command.png",
+    "data/gui/battle/battle_bottom_menu.png",
+    "data/gui/battle/battle_command_buttons.png",
+    "data/skills/targets.png",
+    "data/entities/emotes/zzz.png",
+    "data/gui/battle/escape.png",
+    "data/gui/battle/auto_battle.png"
+};
+
+void BattleMedia::PrefetchImages(std::vector<std::string>& filenames)
+{
+    for(uint32_t i = 0; i < sizeof(BATTLE_MEDIA_IMAGES) / sizeof(BATTLE_MEDIA_IMAGES[0]); ++i) {
+        filenames.push_back(BATTLE_MEDIA_IMAGES[i]);
+        vt_video::TextureManager->PrefetchImage(filenames.back());
+    }
+}
+
 void BattleMedia::Initialize()
 {
     if(!background_image.Load("data/battles/battle_scenes/desert_cave/desert_cave.png"))
@@ -102,6 +133,131 @@ void BattleMedia::SetBattleMusic(const std::string& filename)
         PRINT_WARNING << "Failed to load battle music file: " << filename << std::endl;
 }
 
+void BattleMedia::PreloadBattleResources(const std::vector<uint32_t>& enemy_ids)
+{
+    // Don't let the cache grow unbounded when battling on a single map for long.
+    if(_preloaded_animations.size() + _preloaded_images.size() >= BATTLE_PRELOAD_MAX_RESOURCES)
+        ClearPreloadedResources();
+
+    vt_script::ReadScriptDescriptor& enemy_data = GlobalManager->GetEnemiesScript();
+    for(uint32_t i = 0; i < enemy_ids.size(); ++i) {
+        if(!enemy_data.OpenTable(enemy_ids[i]))
+            continue;
+
+        if(enemy_data.OpenTable("battle_animations")) {
+            std::vector<uint32_t> animations_id;
+            enemy_data.ReadTableKeys(animations_id);
+            for(uint32_t j = 0; j < animations_id.size(); ++j)
+                _QueueAnimation(enemy_data.ReadString(animations_id[j]));
+            enemy_data.CloseTable(); // battle_animations
+        }
+
+        _QueueImage(enemy_data.ReadString("stamina_icon"));
+        enemy_data.CloseTable(); // enemy id
+    }
+
+    GlobalParty& party = GlobalManager->GetCharacterHandler().GetActiveParty();
+    for(uint32_t i = 0; i < party.GetPartySize(); ++i) {
+        GlobalCharacter* character = party.GetCharacterAtIndex(i);
+        if(character == nullptr)
+            continue;
+
+        std::shared_ptr<GlobalWeapon> weapon = character->GetEquippedWeapon();
+        if(weapon != nullptr) {
+            std::vector<std::string> animation_files;
+            weapon->GetWeaponAnimationFiles(character->GetID(), animation_files);
+            for(uint32_t j = 0; j < animation_files.size(); ++j)
+                _QueueAnimation(animation_files[j]);
+            _QueueAnimation(weapon->GetAmmoAnimationFile());
+        }
+
+        const std::vector<GlobalSkill *>& skills = character->GetSkills();
+        for(uint32_t j = 0; j < skills.size(); ++j)
+            _QueueImage(skills[j]->GetIconFilename());
+    }
+}
+
+void BattleMedia::UpdatePreloading()
+{
+    // Only upload a few textures per frame, to keep the transition smooth.
+    const uint32_t MAX_LOADS_PER_UPDATE = 4;
+
+    uint32_t loads = 0;
+    for(std::deque<_PreloadedResource>::iterator it = _preload_queue.begin();
+            it != _preload_queue.end() && loads < MAX_LOADS_PER_UPDATE;) {
+        if(!vt_video::TextureManager->IsImageReady(it->image_filename)) {
+            ++it;
+            continue;
+        }
+
+        _LoadPreloadedResource(*it);
+        it = _preload_queue.erase(it);
+        ++loads;
+    }
+}
+
+void BattleMedia::FinishPreloading()
+{
+    while(!_preload_queue.empty()) {
+        _LoadPreloadedResource(_preload_queue.front());
+        _preload_queue.pop_front();
+    }
+}
+
+void BattleMedia::ClearPreloadedResources()
+{
+    for(uint32_t i = 0; i < _preload_queue.size(); ++i)
+        vt_video::TextureManager->CancelPrefetchedImage(_preload_queue[i].image_filename);
+    _preload_queue.clear();
+    _preloaded_animations.clear();
+    _preloaded_images.clear();
+}
+
+void BattleMedia::_QueueAnimation(const std::string& filename)
+{
+    if(filename.empty() || _IsPreloaded(filename))
+        return;
+
+    std::string image_filename = vt_video::AnimatedImage::PrefetchAnimationScript(filename);
+    if(image_filename.empty())
+        return;
+
+    _preload_queue.push_back(_PreloadedResource(filename, image_filename, true));
+}
+
+void BattleMedia::_QueueImage(const std::string& filename)
+{
+    if(filename.empty() || _IsPreloaded(filename) || !vt_system::DoesAssetExist(filename))
+        return;
+
+    vt_video::TextureManager->PrefetchImage(filename);
+    _preload_queue.push_back(_PreloadedResource(filename, filename, false));
+}
+
+bool BattleMedia::_IsPreloaded(const std::string& filename) const
+{
+    if(_preloaded_animations.find(filename) != _preloaded_animations.end() ||
+            _preloaded_images.find(filename) != _preloaded_images.end())
+        return true;
+
+    for(uint32_t i = 0; i < _preload_queue.size(); ++i) {
+        if(_preload_queue[i].filename == filename)
+            return true;
+    }
+    return false;
+}
+
+void BattleMedia::_LoadPreloadedResource(const _PreloadedResource& resource)
+{
+    if(resource.is_animation) {
+        if(!_preloaded_animations[resource.filename].LoadFromAnimationScript(resource.filename))
+            _preloaded_animations.erase(resource.filename);
+    }
+    else if(!_preloaded_images[resource.filename].Load(resource.filename)) {
+        _preloaded_images.erase(resource.filename);
+    }
+}
+
 vt_video::StillImage* BattleMedia::GetCharacterActionButton(uint32_t index)
 {
     if(index >= character_action_buttons.size()) {
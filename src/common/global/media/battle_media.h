@@ -18,8 +18,14 @@
 
 #include "engine/audio/audio_descriptor.h"
 
+#include <deque>
+#include <map>
+
 namespace vt_global {
 
+//! \brief The most resources kept preloaded for the battles, before the cache is emptied.
+const uint32_t BATTLE_PRELOAD_MAX_RESOURCES = 256;
+
 /** ****************************************************************************
 *** \brief A specialized class to BattleMode that holds various related multimedia data
 ***
@@ -42,6 +48,11 @@ public:
     //! the texture manager is ready only afterward.
     void Initialize();
 
+    /** \brief Starts decoding the images loaded by Initialize() in the background.
+    *** \param filenames Filled with the images requested, to cancel the ones finally not loaded.
+    **/
+    void PrefetchImages(std::vector<std::string>& filenames);
+
     ///! \brief Updates the different animations and media
     void Update();
 
@@ -55,6 +66,24 @@ public:
     **/
     void SetBattleMusic(const std::string& filename);
 
+    /** \brief Starts preloading the resources of a battle, their images being decoded in the background.
+    *** \param enemy_ids The enemies of the battle.
+    *** The manifest holds the enemies animations and stamina icons, and the active party
+    *** equipped weapons animations and skill icons. The preloaded resources are kept until
+    *** ClearPreloadedResources() is called, so that consecutive battles on the same map
+    *** don't load them again.
+    **/
+    void PreloadBattleResources(const std::vector<uint32_t>& enemy_ids);
+
+    //! \brief Loads a few of the preloaded resources whose images are decoded, without waiting for the others.
+    void UpdatePreloading();
+
+    //! \brief Loads the preloaded resources left, waiting for their images if needed.
+    void FinishPreloading();
+
+    //! \brief Forgets the preloaded resources, e.g. when leaving the map they were preloaded on.
+    void ClearPreloadedResources();
+
     /** \brief Retrieves a specific button icon for character action
     *** \param index The index of the button to retrieve
     *** \return A pointer to the appropriate button image, or nullptr if the index argument was out of bounds
@@ -154,6 +183,44 @@ private:
 
     //! \brief The escape icon.
     vt_video::StillImage _escape_icon;
+
+    //! \brief A resource of a battle preload manifest.
+    class _PreloadedResource
+    {
+    public:
+        _PreloadedResource(const std::string& filename, const std::string& image_filename, bool is_animation) :
+            filename(filename),
+            image_filename(image_filename),
+            is_animation(is_animation)
+        {}
+
+        //! \brief The animation script or image file.
+        std::string filename;
+
+        //! \brief The image file decoded in the background.
+        std::string image_filename;
+
+        bool is_animation;
+    };
+
+    //! \brief The resources to load, the oldest first.
+    std::deque<_PreloadedResource> _preload_queue;
+
+    //! \brief The preloaded resources, keeping their textures loaded. By filename.
+    //@{
+    std::map<std::string, vt_video::AnimatedImage> _preloaded_animations;
+    std::map<std::string, vt_video::StillImage> _preloaded_images;
+    //@}
+
+    //! \brief Adds an animation script or an image to the preload queue, if not preloaded yet.
+    void _QueueAnimation(const std::string& filename);
+    void _QueueImage(const std::string& filename);
+
+    //! \brief Tells whether a resource is preloaded or queued.
+    bool _IsPreloaded(const std::string& filename) const;
+
+    //! \brief Loads a queued resource into the preloaded ones.
+    void _LoadPreloadedResource(const _PreloadedResource& resource);
 }; // class BattleMedia
 
 } // namespace vt_global
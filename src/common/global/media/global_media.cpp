@@ -10,11 +10,51 @@
 
 #include "global_media.h"
 
+#include "common/global/actors/global_character.h"
+
 #include "engine/audio/audio_descriptor.h"
+#include "engine/video/texture_controller.h"
 
 namespace vt_global
 {
 
+//! \brief The images loaded by GlobalMedia::Initialize().
+static const char* const GLOBAL_MEDIA_IMAGES[] = {
+    "data/inventory/drunes.png",
+    "data/gui/menus/star.png",
+    "data/gui/menus/green_check.png",
+    "data/gui/menus/red_x.png",
+    "data/gui/menus/spirit.png",
+    "data/gui/menus/equip.png",
+    "data/gui/menus/key.png",
+    "data/gui/menus/clock.png",
+    "data/gui/map/stamina_bar_background.png",
+    "data/gui/map/stamina_bar_map.png",
+    "data/gui/map/stamina_bar_infinite_overlay.png",
+    "data/entities/status_effects/status.png",
+    "data/inventory/object_category_icons.png",
+    "data/inventory/category_icons.png"
+};
+
+// The media common to all the maps
+const std::string DIALOGUE_ICON_FILE = "data/entities/emotes/dialogue_icon.lua";
+const std::string ACTIVE_SAVE_POINT_FILE1 = "data/entities/map/save_point/save_point3.lua";
+const std::string ACTIVE_SAVE_POINT_FILE2 = "data/entities/map/save_point/save_point2.lua";
+const std::string INACTIVE_SAVE_POINT_FILE1 = "data/entities/map/save_point/save_point1.lua";
+const std::string INACTIVE_SAVE_POINT_FILE2 = "data/entities/map/save_point/save_point2.lua";
+const std::string ACTIVE_ESCAPE_POINT_FILE = "data/entities/map/escape_point/escape_point_active.lua";
+const std::string INACTIVE_ESCAPE_POINT_FILE = "data/entities/map/escape_point/escape_point_inactive.lua";
+const std::string MINIMAP_BACKGROUND_FILE = "data/gui/map/minimap_background.png";
+const std::string MINIMAP_LOCATION_MARKER_FILE = "data/gui/map/minimap_arrows.lua";
+
+void GlobalMedia::PrefetchImages(std::vector<std::string>& filenames)
+{
+    for(uint32_t i = 0; i < sizeof(GLOBAL_MEDIA_IMAGES) / sizeof(GLOBAL_MEDIA_IMAGES[0]); ++i) {
+        filenames.push_back(GLOBAL_MEDIA_IMAGES[i]);
+        vt_video::TextureManager->PrefetchImage(filenames.back());
+    }
+}
+
 void GlobalMedia::Initialize()
 {
     // Load common images
@@ -70,6 +110,40 @@ void GlobalMedia::Initialize()
     _LoadSoundFile("item_pickup", "data/sounds/itempick2_michel_baradari_oga.wav");
 }
 
+void GlobalMedia::LoadMapMedia()
+{
+    if(_map_media_loaded)
+        return;
+    _map_media_loaded = true;
+
+    if(!_map_dialogue_icon.LoadFromAnimationScript(DIALOGUE_ICON_FILE))
+        PRINT_WARNING << "Failed to load the map dialogue icon: " << DIALOGUE_ICON_FILE << std::endl;
+
+    const std::string active_save_point_files[] = { ACTIVE_SAVE_POINT_FILE1, ACTIVE_SAVE_POINT_FILE2 };
+    const std::string inactive_save_point_files[] = { INACTIVE_SAVE_POINT_FILE1, INACTIVE_SAVE_POINT_FILE2 };
+    for(uint32_t i = 0; i < 2; ++i) {
+        vt_video::AnimatedImage animation;
+        if(!animation.LoadFromAnimationScript(active_save_point_files[i]))
+            PRINT_WARNING << "Failed to load the save point animation: " << active_save_point_files[i] << std::endl;
+        _active_save_point_animations.push_back(animation);
+
+        animation.Clear();
+        if(!animation.LoadFromAnimationScript(inactive_save_point_files[i]))
+            PRINT_WARNING << "Failed to load the save point animation: " << inactive_save_point_files[i] << std::endl;
+        _inactive_save_point_animations.push_back(animation);
+    }
+
+    if(!_active_escape_point_animation.LoadFromAnimationScript(ACTIVE_ESCAPE_POINT_FILE))
+        PRINT_WARNING << "Failed to load the escape point animation: " << ACTIVE_ESCAPE_POINT_FILE << std::endl;
+    if(!_inactive_escape_point_animation.LoadFromAnimationScript(INACTIVE_ESCAPE_POINT_FILE))
+        PRINT_WARNING << "Failed to load the escape point animation: " << INACTIVE_ESCAPE_POINT_FILE << std::endl;
+
+    if(!_minimap_background.Load(MINIMAP_BACKGROUND_FILE))
+        PRINT_WARNING << "Failed to load the minimap background image: " << MINIMAP_BACKGROUND_FILE << std::endl;
+    if(!_minimap_location_marker.LoadFromAnimationScript(MINIMAP_LOCATION_MARKER_FILE))
+        PRINT_ERROR << "Could not load marker image!" << std::endl;
+}
+
 GlobalMedia::~GlobalMedia()
 {
     // Clear up sounds
@@ -229,6 +303,19 @@ vt_video::StillImage* GlobalMedia::GetSmallItemCategoryIcon(ITEM_CATEGORY object
     return &(_small_category_icons[index]);
 }
 
+const vt_video::TextImage& GlobalMedia::GetCharacterNameText(GlobalCharacter* character,
+                                                             const std::string& text_style)
+{
+    static const vt_video::TextImage empty_text;
+    if(character == nullptr)
+        return empty_text;
+
+    vt_video::TextImage& name_text = _character_name_texts[std::make_pair(character->GetID(), text_style)];
+    if(name_text.GetString() != character->GetName())
+        name_text.SetText(character->GetName(), vt_video::TextStyle(text_style));
+    return name_text;
+}
+
 void GlobalMedia::PlaySound(const std::string &identifier)
 {
     std::map<std::string, vt_audio::SoundDescriptor *>::iterator sound = _sounds.find(identifier);
@@ -242,6 +329,7 @@ void GlobalMedia::_LoadSoundFile(const std::string& sound_name, const std::strin
         return;
 
     _sounds[sound_name] = new vt_audio::SoundDescriptor();
+    _sounds[sound_name]->SetPriority(vt_audio::AUDIO_PRIORITY_UI);
     if(!_sounds[sound_name]->LoadAudio(filename))
         PRINT_WARNING << "Failed to load '" << filename << "' needed by shop mode" << std::endl;
 }
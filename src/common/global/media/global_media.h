@@ -15,6 +15,7 @@
 #include "common/global/objects/global_item.h"
 
 #include "engine/video/image.h"
+#include "engine/video/text.h"
 
 namespace vt_audio {
 class SoundDescriptor;
@@ -23,12 +24,16 @@ class SoundDescriptor;
 namespace vt_global
 {
 
+class GlobalCharacter;
+
 /** \brief A simple class used to store commonly used media files.
 *** It is used as a member of the game global class.
 **/
 class GlobalMedia {
 public:
-    GlobalMedia() {}
+    GlobalMedia() :
+        _map_media_loaded(false)
+    {}
 
     ~GlobalMedia();
 
@@ -37,6 +42,11 @@ public:
     //! the texture manager is ready only afterward.
     void Initialize();
 
+    /** \brief Starts decoding the images loaded by Initialize() in the background.
+    *** \param filenames Filled with the images requested, to cancel the ones finally not loaded.
+    **/
+    void PrefetchImages(std::vector<std::string>& filenames);
+
     vt_video::StillImage* GetDrunesIcon() {
         return &_drunes_icon;
     }
@@ -85,6 +95,46 @@ public:
         return &_stamina_bar_infinite_overlay;
     }
 
+    /** \brief Loads the media common to all the maps, if not done yet.
+    *** They are kept from one map to the next, so that the maps don't load them again.
+    **/
+    void LoadMapMedia();
+
+    /** \name Map Media Accessors
+    *** The maps copy them, as they scale them and bind them to their own animation clock.
+    *** The copies share the frames textures.
+    *** \note LoadMapMedia() must have been called beforehand.
+    **/
+    //@{
+    const vt_video::AnimatedImage& GetMapDialogueIcon() const {
+        return _map_dialogue_icon;
+    }
+
+    const std::vector<vt_video::AnimatedImage>& GetActiveSavePointAnimations() const {
+        return _active_save_point_animations;
+    }
+
+    const std::vector<vt_video::AnimatedImage>& GetInactiveSavePointAnimations() const {
+        return _inactive_save_point_animations;
+    }
+
+    const vt_video::AnimatedImage& GetActiveEscapePointAnimation() const {
+        return _active_escape_point_animation;
+    }
+
+    const vt_video::AnimatedImage& GetInactiveEscapePointAnimation() const {
+        return _inactive_escape_point_animation;
+    }
+
+    const vt_video::StillImage& GetMinimapBackgroundImage() const {
+        return _minimap_background;
+    }
+
+    const vt_video::AnimatedImage& GetMinimapLocationMarker() const {
+        return _minimap_location_marker;
+    }
+    //@}
+
     std::vector<vt_video::StillImage>* GetAllItemCategoryIcons() {
         return &_all_category_icons;
     }
@@ -120,6 +170,15 @@ public:
     **/
     vt_video::StillImage* GetStatusIcon(GLOBAL_STATUS status_type, GLOBAL_INTENSITY intensity);
 
+    /** \brief Retrieves the name of a character rendered with a text style.
+    *** \param character The character, whose name is rendered once for all the game modes.
+    *** \param text_style The name of the text style.
+    *** \return The name text, to copy: The copies share its rendered text.
+    *** \note The name is rendered again when the character name changes, with the language for instance.
+    **/
+    const vt_video::TextImage& GetCharacterNameText(GlobalCharacter* character,
+                                                    const std::string& text_style);
+
     /** \brief Plays a sound object previously loaded
     *** \param identifier The string identifier for the sound to play
     **/
@@ -171,9 +230,30 @@ private:
     //! \brief The battle and boot bottom image
     vt_video::StillImage _bottom_menu_image;
 
+    //! \brief Whether the map media were loaded.
+    bool _map_media_loaded;
+
+    //! \brief The dialogue icon shown over the map sprites having something to say
+    vt_video::AnimatedImage _map_dialogue_icon;
+
+    //! \brief The save points animations, when the character is in or not
+    std::vector<vt_video::AnimatedImage> _active_save_point_animations;
+    std::vector<vt_video::AnimatedImage> _inactive_save_point_animations;
+
+    //! \brief The escape points animations, when the character is in or not
+    vt_video::AnimatedImage _active_escape_point_animation;
+    vt_video::AnimatedImage _inactive_escape_point_animation;
+
+    //! \brief The minimap window background and location marker
+    vt_video::StillImage _minimap_background;
+    vt_video::AnimatedImage _minimap_location_marker;
+
     //! \brief A map of the sounds used in different game modes
     std::map<std::string, vt_audio::SoundDescriptor*> _sounds;
 
+    //! \brief The character names rendered, by character id and text style.
+    std::map<std::pair<uint32_t, std::string>, vt_video::TextImage> _character_name_texts;
+
     //! \brief Loads a sound file and add it to the sound map
     void _LoadSoundFile(const std::string& sound_name, const std::string& filename);
 };
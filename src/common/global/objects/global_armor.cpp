@@ -18,69 +18,38 @@ using namespace vt_script;
 namespace vt_global
 {
 
+void GlobalArmorDefinition::_LoadTypeData(uint32_t id, ReadScriptDescriptor& script)
+{
+    _LoadStatusEffects(script);
+    _LoadEquipmentSkills(script);
+
+    physical_defense = script.ReadUInt("physical_defense");
+    magical_defense = script.ReadUInt("magical_defense");
+
+    usable_by = script.ReadUInt("usable_by");
+
+    spirit_slots = script.ReadUInt("slots");
+    // Only permit a max of 5 spirits for equipment
+    if (spirit_slots > 5) {
+        spirit_slots = 5;
+        PRINT_WARNING << "More than 5 spirit slots declared in item " << id << std::endl;
+    }
+}
+
 GlobalArmor::GlobalArmor(uint32_t id, uint32_t count) :
     GlobalObject(id, count)
 {
     if((_id <= MAX_WEAPON_ID) || (_id > MAX_LEG_ARMOR_ID)) {
         IF_PRINT_WARNING(GLOBAL_DEBUG) << "invalid id in constructor: " << _id << std::endl;
         _InvalidateObject();
-        return;
     }
 
-    // Figure out the appropriate script reference to grab based on the id value
-    ReadScriptDescriptor* script_file = nullptr;
-    InventoryHandler& inventory = GlobalManager->GetInventoryHandler();
-    switch(GetObjectType()) {
-    case GLOBAL_OBJECT_HEAD_ARMOR:
-        script_file = &(inventory.GetHeadArmorScript());
-        break;
-    case GLOBAL_OBJECT_TORSO_ARMOR:
-        script_file = &(inventory.GetTorsoArmorScript());
-        break;
-    case GLOBAL_OBJECT_ARM_ARMOR:
-        script_file = &(inventory.GetArmArmorScript());
-        break;
-    case GLOBAL_OBJECT_LEG_ARMOR:
-        script_file = &(inventory.GetLegArmorScript());
-        break;
-    default:
-        IF_PRINT_WARNING(GLOBAL_DEBUG) << "could not determine armor type: " << _id << std::endl;
-        _InvalidateObject();
+    if(!IsValid() || !_LoadDefinition()) {
+        _definition = std::make_shared<GlobalArmorDefinition>();
         return;
     }
 
-    if(script_file->DoesTableExist(_id) == false) {
-        PRINT_WARNING << "no valid data for armor in definition file: " << _id << std::endl;
-        _InvalidateObject();
-        return;
-    }
-
-    // Load the armor data from the script
-    script_file->OpenTable(_id);
-    _LoadObjectData(*script_file);
-
-    _LoadStatusEffects(*script_file);
-    _LoadEquipmentSkills(*script_file);
-
-    _physical_defense = script_file->ReadUInt("physical_defense");
-    _magical_defense = script_file->ReadUInt("magical_defense");
-
-    _usable_by = script_file->ReadUInt("usable_by");
-
-    uint32_t spirits_number = script_file->ReadUInt("slots");
-    // Only permit a max of 5 spirits for equipment
-    if (spirits_number > 5) {
-        spirits_number = 5;
-        PRINT_WARNING << "More than 5 spirit slots declared in item " << _id << std::endl;
-    }
-    _spirit_slots.resize(spirits_number, nullptr);
-
-    script_file->CloseTable();
-    if(script_file->IsErrorDetected()) {
-        PRINT_WARNING << "one or more errors occurred while reading armor data - they are listed below"
-                      << std::endl << script_file->GetErrorMessages() << std::endl;
-        _InvalidateObject();
-    }
+    _spirit_slots.resize(_GetDefinition().spirit_slots, nullptr);
 }
 
 GLOBAL_OBJECT GlobalArmor::GetObjectType() const
@@ -18,6 +18,36 @@ namespace vt_global
 
 class GlobalSpirit;
 
+//! \brief The definition shared by the armors of an id.
+class GlobalArmorDefinition : public GlobalObjectDefinition
+{
+public:
+    GlobalArmorDefinition() :
+        physical_defense(0),
+        magical_defense(0),
+        usable_by(0),
+        spirit_slots(0)
+    {
+    }
+
+    //! \brief The amount of physical defense that the armor provides
+    uint32_t physical_defense;
+
+    //! \brief The amount of magical defense that the armor provides against each elements
+    uint32_t magical_defense;
+
+    /** \brief A bit-mask that determines which characters can use or equip the object
+    *** See the game character ID constants in global_actors.h for more information
+    **/
+    uint32_t usable_by;
+
+    //! \brief The number of spirit slots of the armors.
+    uint32_t spirit_slots;
+
+protected:
+    void _LoadTypeData(uint32_t id, vt_script::ReadScriptDescriptor& script) override;
+};
+
 /** ****************************************************************************
 *** \brief Represents all types of armor that may be equipped on characters and enemies
 ***
@@ -46,15 +76,15 @@ public:
     GLOBAL_OBJECT GetObjectType() const override;
 
     uint32_t GetPhysicalDefense() const {
-        return _physical_defense;
+        return _GetDefinition().physical_defense;
     }
 
     uint32_t GetMagicalDefense() const {
-        return _magical_defense;
+        return _GetDefinition().magical_defense;
     }
 
     uint32_t GetUsableBy() const {
-        return _usable_by;
+        return _GetDefinition().usable_by;
     }
 
     const std::vector<GlobalSpirit *>& GetSpiritSlots() const {
@@ -63,27 +93,20 @@ public:
 
     //! \brief Gives the list of learned skill thanks to this piece of equipment.
     const std::vector<uint32_t>& GetEquipmentSkills() const {
-        return _equipment_skills;
+        return _definition->equipment_skills;
     }
 
 private:
-    //! \brief The amount of physical defense that the armor provides
-    uint32_t _physical_defense;
-
-    //! \brief The amount of magical defense that the armor provides against each elements
-    uint32_t _magical_defense;
-
-    /** \brief A bit-mask that determines which characters can use or equip the object
-    *** See the game character ID constants in global_actors.h for more information
-    **/
-    uint32_t _usable_by;
-
     /** \brief Sockets which may be used to place spirits on the armor
     *** Armor may have no sockets, so it is not uncommon for the size of this vector to be zero.
     *** When a socket is available but empty (has no attached spirit), the pointer at that index
     *** will be nullptr.
     **/
     std::vector<GlobalSpirit *> _spirit_slots;
+
+    const GlobalArmorDefinition& _GetDefinition() const {
+        return static_cast<const GlobalArmorDefinition&>(*_definition);
+    }
 }; // class GlobalArmor : public GlobalObject
 
 } // namespace vt_global
@@ -24,6 +24,9 @@ InventoryHandler::~InventoryHandler()
 
 bool InventoryHandler::LoadScripts()
 {
+    // The definitions hold the translated texts of the scripts.
+    _object_definitions.clear();
+
     // Open up the persistent script files
     if(!_items_script.OpenFile("data/inventory/items.lua") || !_items_script.OpenTable("items"))
         return false;
@@ -51,6 +54,8 @@ bool InventoryHandler::LoadScripts()
 
 void InventoryHandler::CloseScripts()
 {
+    _object_definitions.clear();
+
     // Close all persistent script files
     _items_script.CloseTable();
     _items_script.CloseFile();
@@ -85,9 +90,80 @@ void InventoryHandler::ClearAllData()
     _inventory_leg_armors.clear();
     _inventory_spirits.clear();
     _inventory_key_items.clear();
+    ++_revision;
+}
+
+//! \brief Returns the type of an object from its id, key items being items.
+static GLOBAL_OBJECT _GetObjectType(uint32_t obj_id)
+{
+    if((obj_id > 0 && obj_id <= MAX_ITEM_ID) ||
+       (obj_id > MAX_SPIRIT_ID && obj_id <= MAX_KEY_ITEM_ID))
+        return GLOBAL_OBJECT_ITEM;
+    else if((obj_id > MAX_ITEM_ID) && (obj_id <= MAX_WEAPON_ID))
+        return GLOBAL_OBJECT_WEAPON;
+    else if((obj_id > MAX_WEAPON_ID) && (obj_id <= MAX_HEAD_ARMOR_ID))
+        return GLOBAL_OBJECT_HEAD_ARMOR;
+    else if((obj_id > MAX_HEAD_ARMOR_ID) && (obj_id <= MAX_TORSO_ARMOR_ID))
+        return GLOBAL_OBJECT_TORSO_ARMOR;
+    else if((obj_id > MAX_TORSO_ARMOR_ID) && (obj_id <= MAX_ARM_ARMOR_ID))
+        return GLOBAL_OBJECT_ARM_ARMOR;
+    else if((obj_id > MAX_ARM_ARMOR_ID) && (obj_id <= MAX_LEG_ARMOR_ID))
+        return GLOBAL_OBJECT_LEG_ARMOR;
+    else if((obj_id > MAX_LEG_ARMOR_ID) && (obj_id <= MAX_SPIRIT_ID))
+        return GLOBAL_OBJECT_SPIRIT;
+    return GLOBAL_OBJECT_INVALID;
 }
 
-std::vector<std::shared_ptr<GlobalArmor>>& InventoryHandler::GetInventoryArmors(GLOBAL_OBJECT object_type)
+std::shared_ptr<const GlobalObjectDefinition> InventoryHandler::GetObjectDefinition(uint32_t obj_id)
+{
+    auto it = _object_definitions.find(obj_id);
+    if(it != _object_definitions.end())
+        return it->second;
+
+    std::shared_ptr<GlobalObjectDefinition> definition = nullptr;
+    vt_script::ReadScriptDescriptor* script = nullptr;
+    switch(_GetObjectType(obj_id)) {
+    case GLOBAL_OBJECT_ITEM:
+        definition = std::make_shared<GlobalItemDefinition>();
+        script = &_items_script;
+        break;
+    case GLOBAL_OBJECT_WEAPON:
+        definition = std::make_shared<GlobalWeaponDefinition>();
+        script = &_weapons_script;
+        break;
+    case GLOBAL_OBJECT_HEAD_ARMOR:
+        definition = std::make_shared<GlobalArmorDefinition>();
+        script = &_head_armor_script;
+        break;
+    case GLOBAL_OBJECT_TORSO_ARMOR:
+        definition = std::make_shared<GlobalArmorDefinition>();
+        script = &_torso_armor_script;
+        break;
+    case GLOBAL_OBJECT_ARM_ARMOR:
+        definition = std::make_shared<GlobalArmorDefinition>();
+        script = &_arm_armor_script;
+        break;
+    case GLOBAL_OBJECT_LEG_ARMOR:
+        definition = std::make_shared<GlobalArmorDefinition>();
+        script = &_leg_armor_script;
+        break;
+    case GLOBAL_OBJECT_SPIRIT:
+        definition = std::make_shared<GlobalObjectDefinition>();
+        script = &_spirits_script;
+        break;
+    default:
+        PRINT_WARNING << "invalid object id: " << obj_id << std::endl;
+        break;
+    }
+
+    if(definition != nullptr && !definition->Load(obj_id, *script))
+        definition = nullptr;
+
+    _object_definitions[obj_id] = definition;
+    return definition;
+}
+
+const std::vector<std::shared_ptr<GlobalArmor>>& InventoryHandler::GetInventoryArmors(GLOBAL_OBJECT object_type) const
 {
     switch(object_type) {
     default:
@@ -104,6 +180,45 @@ std::vector<std::shared_ptr<GlobalArmor>>& InventoryHandler::GetInventoryArmors(
     }
 }
 
+const std::vector<uint32_t>& InventoryHandler::GetEquipableObjects(GLOBAL_OBJECT object_type, uint32_t character_id)
+{
+    if(_equipable_views_revision != _revision) {
+        _equipable_views.clear();
+        _equipable_views_revision = _revision;
+    }
+
+    auto it = _equipable_views.find(std::make_pair(object_type, character_id));
+    if(it != _equipable_views.end())
+        return it->second;
+
+    std::vector<uint32_t>& view = _equipable_views[std::make_pair(object_type, character_id)];
+    if(object_type == GLOBAL_OBJECT_WEAPON) {
+        for(uint32_t i = 0; i < _inventory_weapons.size(); ++i) {
+            if(_inventory_weapons[i]->GetUsableBy() & character_id)
+                view.push_back(i);
+        }
+    } else {
+        const std::vector<std::shared_ptr<GlobalArmor>>& armors = GetInventoryArmors(object_type);
+        for(uint32_t i = 0; i < armors.size(); ++i) {
+            if(armors[i]->GetUsableBy() & character_id)
+                view.push_back(i);
+        }
+    }
+    return view;
+}
+
+void InventoryHandler::GetInventoryObjects(std::vector<std::shared_ptr<GlobalObject>>& objects) const
+{
+    objects.reserve(objects.size() + _inventory.size());
+    objects.insert(objects.end(), _inventory_items.begin(), _inventory_items.end());
+    objects.insert(objects.end(), _inventory_weapons.begin(), _inventory_weapons.end());
+    objects.insert(objects.end(), _inventory_head_armors.begin(), _inventory_head_armors.end());
+    objects.insert(objects.end(), _inventory_torso_armors.begin(), _inventory_torso_armors.end());
+    objects.insert(objects.end(), _inventory_arm_armors.begin(), _inventory_arm_armors.end());
+    objects.insert(objects.end(), _inventory_leg_armors.begin(), _inventory_leg_armors.end());
+    objects.insert(objects.end(), _inventory_spirits.begin(), _inventory_spirits.end());
+}
+
 void InventoryHandler::AddToInventory(uint32_t obj_id, uint32_t obj_count)
 {
     // Don't add object instance without at least one actual item.
@@ -111,51 +226,61 @@ void InventoryHandler::AddToInventory(uint32_t obj_id, uint32_t obj_count)
         return;
 
     // If the object is already in the inventory, increment the count of the object.
-    if (_inventory.find(obj_id) != _inventory.end()) {
-        _inventory[obj_id]->IncrementCount(obj_count);
+    auto it = _inventory.find(obj_id);
+    if (it != _inventory.end()) {
+        it->second.object->IncrementCount(obj_count);
+        ++_revision;
         return;
     }
 
     // Otherwise, create a new object instance and add it to the inventory.
     std::shared_ptr<GlobalObject> new_object = nullptr;
-    if ((obj_id > 0 && obj_id <= MAX_ITEM_ID) ||
-        (obj_id > MAX_SPIRIT_ID && obj_id <= MAX_KEY_ITEM_ID)) {
+    switch(_GetObjectType(obj_id)) {
+    case GLOBAL_OBJECT_ITEM: {
         auto new_item = std::make_shared<GlobalItem>(obj_id, obj_count);
         new_object = new_item;
-        _inventory.insert(std::make_pair(obj_id, new_object));
-        _inventory_items.push_back(new_item);
-    } else if ((obj_id > MAX_ITEM_ID) && (obj_id <= MAX_WEAPON_ID)) {
+        _AddToInventory(new_item, _inventory_items);
+        break;
+    }
+    case GLOBAL_OBJECT_WEAPON: {
         auto new_wpn = std::make_shared<GlobalWeapon>(obj_id, obj_count);
         new_object = new_wpn;
-        _inventory.insert(std::make_pair(obj_id, new_wpn));
-        _inventory_weapons.push_back(new_wpn);
-    } else if ((obj_id > MAX_WEAPON_ID) && (obj_id <= MAX_HEAD_ARMOR_ID)) {
+        _AddToInventory(new_wpn, _inventory_weapons);
+        break;
+    }
+    case GLOBAL_OBJECT_HEAD_ARMOR: {
         auto new_arm = std::make_shared<GlobalArmor>(obj_id, obj_count);
         new_object = new_arm;
-        _inventory.insert(std::make_pair(obj_id, new_arm));
-        _inventory_head_armors.push_back(new_arm);
-    } else if ((obj_id > MAX_HEAD_ARMOR_ID) && (obj_id <= MAX_TORSO_ARMOR_ID)) {
+        _AddToInventory(new_arm, _inventory_head_armors);
+        break;
+    }
+    case GLOBAL_OBJECT_TORSO_ARMOR: {
         auto new_arm = std::make_shared<GlobalArmor>(obj_id, obj_count);
         new_object = new_arm;
-        _inventory.insert(std::make_pair(obj_id, new_arm));
-        _inventory_torso_armors.push_back(new_arm);
-    } else if ((obj_id > MAX_TORSO_ARMOR_ID) && (obj_id <= MAX_ARM_ARMOR_ID)) {
+        _AddToInventory(new_arm, _inventory_torso_armors);
+        break;
+    }
+    case GLOBAL_OBJECT_ARM_ARMOR: {
         auto new_arm = std::make_shared<GlobalArmor>(obj_id, obj_count);
         new_object = new_arm;
-        _inventory.insert(std::make_pair(obj_id, new_arm));
-        _inventory_arm_armors.push_back(new_arm);
-    } else if ((obj_id > MAX_ARM_ARMOR_ID) && (obj_id <= MAX_LEG_ARMOR_ID)) {
+        _AddToInventory(new_arm, _inventory_arm_armors);
+        break;
+    }
+    case GLOBAL_OBJECT_LEG_ARMOR: {
         auto new_arm = std::make_shared<GlobalArmor>(obj_id, obj_count);
         new_object = new_arm;
-        _inventory.insert(std::make_pair(obj_id, new_arm));
-        _inventory_leg_armors.push_back(new_arm);
-    } else if ((obj_id > MAX_LEG_ARMOR_ID) && (obj_id <= MAX_SPIRIT_ID)) {
+        _AddToInventory(new_arm, _inventory_leg_armors);
+        break;
+    }
+    case GLOBAL_OBJECT_SPIRIT: {
         auto new_spirit = std::make_shared<GlobalSpirit>(obj_id, obj_count);
         new_object = new_spirit;
-        _inventory.insert(std::make_pair(obj_id, new_spirit));
-        _inventory_spirits.push_back(new_spirit);
-    } else {
+        _AddToInventory(new_spirit, _inventory_spirits);
+        break;
+    }
+    default:
         PRINT_WARNING << "attempted to add invalid object to inventory with id: " << obj_id << std::endl;
+        break;
     }
 
     // Update the key items list.
@@ -181,42 +306,37 @@ void InventoryHandler::AddToInventory(const std::shared_ptr<GlobalObject>& objec
     }
 
     // If an instance of the same object is already inside the inventory, just increment the count.
-    if (_inventory.find(obj_id) != _inventory.end()) {
-        _inventory[obj_id]->IncrementCount(obj_count);
+    auto it = _inventory.find(obj_id);
+    if (it != _inventory.end()) {
+        it->second.object->IncrementCount(obj_count);
+        ++_revision;
         return;
     }
 
     // Figure out which type of object this is, cast it to the correct type, and add it to the inventory
-    if((obj_id > 0 && obj_id <= MAX_ITEM_ID) ||
-       (obj_id > MAX_SPIRIT_ID && obj_id <= MAX_KEY_ITEM_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalItem>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_items.push_back(new_obj);
-    } else if((obj_id > MAX_ITEM_ID) && (obj_id <= MAX_WEAPON_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalWeapon>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_weapons.push_back(new_obj);
-    } else if((obj_id > MAX_WEAPON_ID) && (obj_id <= MAX_HEAD_ARMOR_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalArmor>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_head_armors.push_back(new_obj);
-    } else if((obj_id > MAX_HEAD_ARMOR_ID) && (obj_id <= MAX_TORSO_ARMOR_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalArmor>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_torso_armors.push_back(new_obj);
-    } else if((obj_id > MAX_TORSO_ARMOR_ID) && (obj_id <= MAX_ARM_ARMOR_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalArmor>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_arm_armors.push_back(new_obj);
-    } else if((obj_id > MAX_ARM_ARMOR_ID) && (obj_id <= MAX_LEG_ARMOR_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalArmor>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_leg_armors.push_back(new_obj);
-    } else if((obj_id > MAX_LEG_ARMOR_ID) && (obj_id <= MAX_SPIRIT_ID)) {
-        auto new_obj = std::dynamic_pointer_cast<GlobalSpirit>(object);
-        _inventory.insert(std::make_pair(obj_id, new_obj));
-        _inventory_spirits.push_back(new_obj);
-    } else {
+    switch(_GetObjectType(obj_id)) {
+    case GLOBAL_OBJECT_ITEM:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalItem>(object), _inventory_items);
+        break;
+    case GLOBAL_OBJECT_WEAPON:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalWeapon>(object), _inventory_weapons);
+        break;
+    case GLOBAL_OBJECT_HEAD_ARMOR:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalArmor>(object), _inventory_head_armors);
+        break;
+    case GLOBAL_OBJECT_TORSO_ARMOR:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalArmor>(object), _inventory_torso_armors);
+        break;
+    case GLOBAL_OBJECT_ARM_ARMOR:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalArmor>(object), _inventory_arm_armors);
+        break;
+    case GLOBAL_OBJECT_LEG_ARMOR:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalArmor>(object), _inventory_leg_armors);
+        break;
+    case GLOBAL_OBJECT_SPIRIT:
+        _AddToInventory(std::dynamic_pointer_cast<GlobalSpirit>(object), _inventory_spirits);
+        break;
+    default:
         PRINT_WARNING << "attempted to add invalid object to inventory with id: " << obj_id << std::endl;
         return;
     }
@@ -236,8 +356,7 @@ void InventoryHandler::RemoveFromInventory(uint32_t obj_id)
     }
 
     // Check whether the item is a key item to remove.
-    auto object = it->second;
-    if (object != nullptr && object->IsKeyItem()) {
+    if (it->second.object->IsKeyItem()) {
         for (auto it2 = _inventory_key_items.begin(); it2 != _inventory_key_items.end(); ++it2) {
 
             if ((*it2)->GetID() != obj_id)
@@ -249,104 +368,96 @@ void InventoryHandler::RemoveFromInventory(uint32_t obj_id)
     }
 
     // Use the id value to figure out what type of object it is, and remove it from the object vector
-    if((obj_id > 0 && obj_id <= MAX_ITEM_ID) ||
-       (obj_id > MAX_SPIRIT_ID && obj_id <= MAX_KEY_ITEM_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_items) == false)
-            PRINT_WARNING << "object to remove was not found in inventory items: " << obj_id << std::endl;
-    } else if((obj_id > MAX_ITEM_ID) && (obj_id <= MAX_WEAPON_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_weapons) == false)
-            PRINT_WARNING << "object to remove was not found in inventory weapons: " << obj_id << std::endl;
-    } else if((obj_id > MAX_WEAPON_ID) && (obj_id <= MAX_HEAD_ARMOR_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_head_armors) == false)
-            PRINT_WARNING << "object to remove was not found in inventory head armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_HEAD_ARMOR_ID) && (obj_id <= MAX_TORSO_ARMOR_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_torso_armors) == false)
-            PRINT_WARNING << "object to remove was not found in inventory torso armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_TORSO_ARMOR_ID) && (obj_id <= MAX_ARM_ARMOR_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_arm_armors) == false)
-            PRINT_WARNING << "object to remove was not found in inventory arm armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_ARM_ARMOR_ID) && (obj_id <= MAX_LEG_ARMOR_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_leg_armors) == false)
-            PRINT_WARNING << "object to remove was not found in inventory leg armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_LEG_ARMOR_ID) && (obj_id <= MAX_SPIRIT_ID)) {
-        if(_RemoveFromInventory(obj_id, _inventory_spirits) == false)
-            PRINT_WARNING << "object to remove was not found in inventory spirits: " << obj_id << std::endl;
-    } else {
+    const uint32_t position = it->second.position;
+    switch(_GetObjectType(obj_id)) {
+    case GLOBAL_OBJECT_ITEM:
+        _RemoveFromInventory(position, _inventory_items);
+        break;
+    case GLOBAL_OBJECT_WEAPON:
+        _RemoveFromInventory(position, _inventory_weapons);
+        break;
+    case GLOBAL_OBJECT_HEAD_ARMOR:
+        _RemoveFromInventory(position, _inventory_head_armors);
+        break;
+    case GLOBAL_OBJECT_TORSO_ARMOR:
+        _RemoveFromInventory(position, _inventory_torso_armors);
+        break;
+    case GLOBAL_OBJECT_ARM_ARMOR:
+        _RemoveFromInventory(position, _inventory_arm_armors);
+        break;
+    case GLOBAL_OBJECT_LEG_ARMOR:
+        _RemoveFromInventory(position, _inventory_leg_armors);
+        break;
+    case GLOBAL_OBJECT_SPIRIT:
+        _RemoveFromInventory(position, _inventory_spirits);
+        break;
+    default:
         PRINT_WARNING << "attempted to remove an object from inventory with an invalid id: " << obj_id << std::endl;
+        break;
     }
 }
 
 std::shared_ptr<GlobalObject> InventoryHandler::GetGlobalObject(uint32_t obj_id)
 {
-    if (_inventory.find(obj_id) == _inventory.end()) {
+    auto it = _inventory.find(obj_id);
+    if (it == _inventory.end()) {
         return nullptr;
     }
 
-    std::shared_ptr<GlobalObject> return_object = nullptr;
-    // Use the id value to figure out what type of object it is, and remove it from the object vector
-    if((obj_id > 0 && obj_id <= MAX_ITEM_ID) ||
-       (obj_id > MAX_SPIRIT_ID && obj_id <= MAX_KEY_ITEM_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_items);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory items: " << obj_id << std::endl;
-    } else if((obj_id > MAX_ITEM_ID) && (obj_id <= MAX_WEAPON_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_weapons);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory weapons: " << obj_id << std::endl;
-    } else if((obj_id > MAX_WEAPON_ID) && (obj_id <= MAX_HEAD_ARMOR_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_head_armors);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory head armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_HEAD_ARMOR_ID) && (obj_id <= MAX_TORSO_ARMOR_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_torso_armors);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory torso armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_TORSO_ARMOR_ID) && (obj_id <= MAX_ARM_ARMOR_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_arm_armors);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory arm armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_ARM_ARMOR_ID) && (obj_id <= MAX_LEG_ARMOR_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_leg_armors);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory leg armor: " << obj_id << std::endl;
-    } else if((obj_id > MAX_LEG_ARMOR_ID) && (obj_id <= MAX_SPIRIT_ID)) {
-        return_object = _GetFromInventory(obj_id, _inventory_spirits);
-        if(return_object == nullptr)
-            PRINT_WARNING << "object to retrieve was not found in inventory spirits: " << obj_id << std::endl;
-    } else {
+    // Use the id value to figure out what type of object it is, and copy it from the object vector
+    const uint32_t position = it->second.position;
+    switch(_GetObjectType(obj_id)) {
+    case GLOBAL_OBJECT_ITEM:
+        return _GetFromInventory(position, _inventory_items);
+    case GLOBAL_OBJECT_WEAPON:
+        return _GetFromInventory(position, _inventory_weapons);
+    case GLOBAL_OBJECT_HEAD_ARMOR:
+        return _GetFromInventory(position, _inventory_head_armors);
+    case GLOBAL_OBJECT_TORSO_ARMOR:
+        return _GetFromInventory(position, _inventory_torso_armors);
+    case GLOBAL_OBJECT_ARM_ARMOR:
+        return _GetFromInventory(position, _inventory_arm_armors);
+    case GLOBAL_OBJECT_LEG_ARMOR:
+        return _GetFromInventory(position, _inventory_leg_armors);
+    case GLOBAL_OBJECT_SPIRIT:
+        return _GetFromInventory(position, _inventory_spirits);
+    default:
         PRINT_WARNING << "attempted to retrieve an object from inventory with an invalid id: " << obj_id << std::endl;
+        return nullptr;
     }
-
-    return return_object;
 }
 
 void InventoryHandler::IncrementItemCount(uint32_t obj_id, uint32_t count)
 {
     // Do nothing if the item does not exist in the inventory
-    if(_inventory.find(obj_id) == _inventory.end()) {
+    GlobalObject* object = GetInventoryObject(obj_id);
+    if(object == nullptr) {
         PRINT_WARNING << "attempted to increment count for an object that was not present in the inventory: " << obj_id << std::endl;
         return;
     }
-
-    _inventory[obj_id]->IncrementCount(count);
+    object->IncrementCount(count);
+    ++_revision;
 }
 
 void InventoryHandler::DecrementItemCount(uint32_t obj_id, uint32_t count)
 {
     // Do nothing if the item does not exist in the inventory
-    if(_inventory.find(obj_id) == _inventory.end()) {
+    GlobalObject* object = GetInventoryObject(obj_id);
+    if(object == nullptr) {
         PRINT_WARNING << "attempted to decrement count for an object that was not present in the inventory: " << obj_id << std::endl;
         return;
     }
 
     // Print a warning if the amount to decrement by exceeds the object's current count
-    if(count > _inventory[obj_id]->GetCount()) {
+    if(count > object->GetCount()) {
         PRINT_WARNING << "amount to decrement count by exceeded available count: " << obj_id << std::endl;
     }
 
     // Decrement the number of objects so long as the number to decrement by does not equal or exceed the count
-    if(count < _inventory[obj_id]->GetCount())
-        _inventory[obj_id]->DecrementCount(count);
+    if(count < object->GetCount()) {
+        object->DecrementCount(count);
+        ++_revision;
+    }
     // Otherwise remove the object from the inventory completely
     else
         RemoveFromInventory(obj_id);
@@ -379,6 +490,26 @@ void InventoryHandler::LoadInventory(vt_script::ReadScriptDescriptor& file)
     _LoadInventory(file, "spirits");
 }
 
+void InventoryHandler::SaveInventory(SaveFileWriter& file)
+{
+    _SaveInventory(file, _inventory_items);
+    _SaveInventory(file, _inventory_weapons);
+    _SaveInventory(file, _inventory_head_armors);
+    _SaveInventory(file, _inventory_torso_armors);
+    _SaveInventory(file, _inventory_arm_armors);
+    _SaveInventory(file, _inventory_leg_armors);
+    _SaveInventory(file, _inventory_spirits);
+}
+
+void InventoryHandler::LoadInventory(SaveFileReader& file)
+{
+    ClearAllData();
+
+    // items, weapons, head, torso, arm and leg armors, then spirits.
+    for (uint32_t i = 0; i < 7; ++i)
+        _LoadInventory(file);
+}
+
 void InventoryHandler::_LoadInventory(ReadScriptDescriptor& file, const std::string& category_name)
 {
     if(file.IsFileOpen() == false) {
@@ -397,4 +528,15 @@ void InventoryHandler::_LoadInventory(ReadScriptDescriptor& file, const std::str
     }
 }
 
+void InventoryHandler::_LoadInventory(SaveFileReader& file)
+{
+    const uint64_t count = file.ReadUInt();
+    for (uint64_t i = 0; i < count && !file.IsErrorDetected(); ++i) {
+        const uint32_t object_id = static_cast<uint32_t>(file.ReadUInt());
+        const uint32_t object_count = static_cast<uint32_t>(file.ReadUInt());
+        if (!file.IsErrorDetected())
+            AddToInventory(object_id, object_count);
+    }
+}
+
 } // namespace vt_global
@@ -18,13 +18,20 @@
 
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
+#include <map>
+#include <unordered_map>
+
 namespace vt_global
 {
 
 class InventoryHandler
 {
 public:
-    InventoryHandler()
+    InventoryHandler() :
+        _revision(0),
+        _equipable_views_revision(0)
     {}
 
     ~InventoryHandler();
@@ -96,7 +103,7 @@ public:
     *** \param id The id of the object (item, weapon, armor, etc.) to check for
     *** \return True if the object was found in the inventor, or false if it was not found
     **/
-    bool IsItemInInventory(uint32_t id) {
+    bool IsItemInInventory(uint32_t id) const {
         return (_inventory.find(id) != _inventory.end());
     }
 
@@ -104,36 +111,70 @@ public:
     *** \param id The id of the object (item, weapon, armor, etc.) to check for
     *** \return The number of the object found in the inventory
     **/
-    uint32_t HowManyObjectsInInventory(uint32_t id) {
-        return (_inventory.find(id) != _inventory.end()) ? _inventory.at(id)->GetCount() : 0;
+    uint32_t HowManyObjectsInInventory(uint32_t id) const {
+        auto it = _inventory.find(id);
+        return (it != _inventory.end()) ? it->second.object->GetCount() : 0;
+    }
+
+    /** \brief Gives an object of the inventory, without copying it.
+    *** \return The object, or nullptr if it isn't in the inventory.
+    *** \note The pointer isn't valid anymore once the object is removed.
+    **/
+    GlobalObject* GetInventoryObject(uint32_t id) const {
+        auto it = _inventory.find(id);
+        return (it != _inventory.end()) ? it->second.object : nullptr;
+    }
+
+    bool IsInventoryEmpty() const {
+        return _inventory.empty();
     }
 
+    //! \brief Adds every object of the inventory to the given list, category by category.
+    void GetInventoryObjects(std::vector<std::shared_ptr<GlobalObject>>& objects) const;
+
     void LoadInventory(vt_script::ReadScriptDescriptor& file);
     void SaveInventory(vt_script::WriteScriptDescriptor& file);
 
-    std::map<uint32_t, std::shared_ptr<GlobalObject>>& GetInventory() {
-        return _inventory;
-    }
+    //! \brief Binary saved game versions of the functions above.
+    void LoadInventory(SaveFileReader& file);
+    void SaveInventory(SaveFileWriter& file);
 
-    std::vector<std::shared_ptr<GlobalItem>>& GetInventoryItems() {
+    //! \brief The inventory categories, in the order the objects were added.
+    //! They are indexed, and must only be changed through the functions above.
+    const std::vector<std::shared_ptr<GlobalItem>>& GetInventoryItems() const {
         return _inventory_items;
     }
 
-    std::vector<std::shared_ptr<GlobalWeapon>>& GetInventoryWeapons() {
+    const std::vector<std::shared_ptr<GlobalWeapon>>& GetInventoryWeapons() const {
         return _inventory_weapons;
     }
 
     //! \brief Returns the armor inventory depending on the item type.
-    std::vector<std::shared_ptr<GlobalArmor>>& GetInventoryArmors(GLOBAL_OBJECT object_type);
+    const std::vector<std::shared_ptr<GlobalArmor>>& GetInventoryArmors(GLOBAL_OBJECT object_type) const;
 
-    std::vector<std::shared_ptr<GlobalSpirit>>& GetInventorySpirits() {
+    const std::vector<std::shared_ptr<GlobalSpirit>>& GetInventorySpirits() const {
         return _inventory_spirits;
     }
 
-    std::vector<std::shared_ptr<GlobalObject>>& GetInventoryKeyItems() {
+    const std::vector<std::shared_ptr<GlobalObject>>& GetInventoryKeyItems() const {
         return _inventory_key_items;
     }
 
+    /** \brief Returns a number changing whenever the inventory does, through the functions above.
+    *** The menu windows compare it to the one of their lists, so that they only rebuild them when needed.
+    **/
+    uint32_t GetRevision() const {
+        return _revision;
+    }
+
+    /** \brief Returns the equipment of a type a character can equip.
+    *** \param object_type The weapon or armor type.
+    *** \param character_id The character id, as found in the objects usable by bitmask.
+    *** \return The positions of the equipment in the container returned by GetInventoryWeapons()
+    *** or GetInventoryArmors(), in that container order. The view is kept until the inventory changes.
+    **/
+    const std::vector<uint32_t>& GetEquipableObjects(GLOBAL_OBJECT object_type, uint32_t character_id);
+
     vt_script::ReadScriptDescriptor &GetItemsScript() {
         return _items_script;
     }
@@ -162,15 +203,37 @@ public:
         return _spirits_script;
     }
 
-private:
+    /** \brief Returns the definition of an object, loaded from its script on first use.
+    *** \param obj_id The id of the object. The definition is of the type matching its id range.
+    *** \return The definition shared by all of the objects of that id, or nullptr when the id is
+    *** invalid or its definition couldn't be loaded.
+    **/
+    std::shared_ptr<const GlobalObjectDefinition> GetObjectDefinition(uint32_t obj_id);
 
-    /** \brief Retains a list of all of the objects currently stored in the player's inventory
-    *** This map is used to quickly check if an item is in the inventory or not. The key to the map is the object's
+private:
+    //! \brief Where an object is stored in the inventory containers.
+    class _InventorySlot
+    {
+    public:
+        _InventorySlot(GlobalObject* inventory_object, uint32_t inventory_position) :
+            object(inventory_object),
+            position(inventory_position)
+        {}
+
+        //! \brief The object, owned by its inventory container.
+        GlobalObject* object;
+
+        //! \brief The position of the object in the container of its type.
+        uint32_t position;
+    };
+
+    /** \brief Indexes all of the objects currently stored in the player's inventory
+    *** This map is used to quickly find an object in the inventory. The key to the map is the object's
     *** identification number. When an object is added to the inventory, if it already exists then the object counter
     *** is simply increased instead of adding an entire new class object. When the object count becomes zero, the object
-    *** is removed from the inventory. Duplicates of all objects are retained in the various inventory containers below.
+    *** is removed from the inventory. The objects themselves are stored in the various inventory containers below.
     **/
-    std::map<uint32_t, std::shared_ptr<GlobalObject>> _inventory;
+    std::unordered_map<uint32_t, _InventorySlot> _inventory;
 
     /** \brief Inventory containers
     *** These vectors contain the inventory of the entire party. The vectors are sorted according to the player's personal preferences.
@@ -210,19 +273,40 @@ private:
     //! \brief Contains data definitions for all spirits
     vt_script::ReadScriptDescriptor _spirits_script;
 
-    /** \brief A helper template function that finds and removes an object from the inventory
-    *** \param obj_id The ID of the object to remove from the inventory
+    /** \brief The object definitions loaded, by object id
+    *** The ids whose definition couldn't be loaded are kept with a null definition,
+    *** so that they are only reported once. Cleared when the scripts are (re)loaded.
+    **/
+    std::unordered_map<uint32_t, std::shared_ptr<const GlobalObjectDefinition>> _object_definitions;
+
+    //! \brief Incremented each time an object is added, removed, or its count changed.
+    uint32_t _revision;
+
+    /** \brief The equipment positions a character can equip, by equipment type and character id
+    *** Built on demand, and cleared when the inventory revision differs from the one they were built at.
+    **/
+    std::map<std::pair<GLOBAL_OBJECT, uint32_t>, std::vector<uint32_t>> _equipable_views;
+    uint32_t _equipable_views_revision;
+
+    /** \brief A helper template function that adds an object at the end of its inventory container, and indexes it
+    *** \param object The object to add, not in the inventory yet
     *** \param inv The vector container of the appropriate inventory type
-    *** \return True if the object was successfully removed, or false if it was not
     **/
-    template <class T> bool _RemoveFromInventory(uint32_t obj_id, std::vector<std::shared_ptr<T>>& inv);
+    template <class T> void _AddToInventory(const std::shared_ptr<T>& object, std::vector<std::shared_ptr<T>>& inv);
 
-    /** \brief A helper template function that finds and returns a copy of an object from the inventory
-    *** \param obj_id The ID of the object to obtain from the inventory
+    /** \brief A helper template function that removes an object from the inventory
+    *** \param position The position of the object in its inventory container
     *** \param inv The vector container of the appropriate inventory type
-    *** \return A pointer to the newly created copy of the object, or nullptr if the object could not be found
+    *** \note The next objects are moved back by one, so that the order seen by the player is kept.
     **/
-    template <class T> std::shared_ptr<T> _GetFromInventory(uint32_t obj_id, const std::vector<std::shared_ptr<T>>& inv);
+    template <class T> void _RemoveFromInventory(uint32_t position, std::vector<std::shared_ptr<T>>& inv);
+
+    /** \brief A helper template function that returns a copy of an object from the inventory
+    *** \param position The position of the object in its inventory container
+    *** \param inv The vector container of the appropriate inventory type
+    *** \return A pointer to the newly created copy of the object
+    **/
+    template <class T> std::shared_ptr<T> _GetFromInventory(uint32_t position, const std::vector<std::shared_ptr<T>>& inv);
 
     /** \brief A helper function to GameGlobal::SaveGame() that stores the contents of a type of inventory to the saved game file
     *** \param file A reference to the open and valid file where to write the inventory list
@@ -240,36 +324,44 @@ private:
     **/
     void _LoadInventory(vt_script::ReadScriptDescriptor& file, const std::string& category_name);
 
+    //! \brief Binary saved game versions of the functions above, the categories being in the save order.
+    template <class T> void _SaveInventory(SaveFileWriter& file,
+                                           const std::vector<std::shared_ptr<T>>& inv);
+    void _LoadInventory(SaveFileReader& file);
+
 };
 
-template <class T> bool InventoryHandler::_RemoveFromInventory(uint32_t obj_id,
-                                                               std::vector<std::shared_ptr<T>>& inv)
+template <class T> void InventoryHandler::_AddToInventory(const std::shared_ptr<T>& object,
+                                                          std::vector<std::shared_ptr<T>>& inv)
 {
-    for (auto i = inv.begin(); i != inv.end(); i++) {
-        if ((*i)->GetID() == obj_id) {
-            inv.erase(i);
-            _inventory.erase(obj_id);
-            return true;
-        }
+    if (object == nullptr) {
+        PRINT_WARNING << "attempted to add an object of the wrong type to the inventory" << std::endl;
+        return;
     }
 
-    return false;
+    _inventory.insert(std::make_pair(object->GetID(), _InventorySlot(object.get(), inv.size())));
+    inv.push_back(object);
+    ++_revision;
 }
 
-template <class T> std::shared_ptr<T> InventoryHandler::_GetFromInventory(uint32_t obj_id,
-                                                                          const std::vector<std::shared_ptr<T>>& inv)
+template <class T> void InventoryHandler::_RemoveFromInventory(uint32_t position,
+                                                               std::vector<std::shared_ptr<T>>& inv)
 {
-    for (auto it = inv.begin(); it != inv.end(); ++it) {
-
-        if ((*it)->GetID() != obj_id)
-            continue;
+    _inventory.erase(inv[position]->GetID());
+    inv.erase(inv.begin() + position);
+    ++_revision;
 
-        auto return_object = std::make_shared<T>(**it);
-        return_object->SetCount(1);
-        return return_object;
-    }
+    // Only the objects after the removed one have moved.
+    for (uint32_t i = position; i < inv.size(); ++i)
+        _inventory.at(inv[i]->GetID()).position = i;
+}
 
-    return nullptr;
+template <class T> std::shared_ptr<T> InventoryHandler::_GetFromInventory(uint32_t position,
+                                                                          const std::vector<std::shared_ptr<T>>& inv)
+{
+    auto return_object = std::make_shared<T>(*inv[position]);
+    return_object->SetCount(1);
+    return return_object;
 }
 
 template <class T> void InventoryHandler::_SaveInventory(vt_script::WriteScriptDescriptor& file,
@@ -308,6 +400,25 @@ template <class T> void InventoryHandler::_SaveInventory(vt_script::WriteScriptD
     file.WriteLine("},");
 }
 
+template <class T> void InventoryHandler::_SaveInventory(SaveFileWriter& file,
+                                                         const std::vector<std::shared_ptr<T>>& inv)
+{
+    // Don't save inventory items with 0 count
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < inv.size(); ++i) {
+        if (inv[i]->GetCount() > 0)
+            ++count;
+    }
+
+    file.WriteUInt(count);
+    for (uint32_t i = 0; i < inv.size(); ++i) {
+        if (inv[i]->GetCount() == 0)
+            continue;
+        file.WriteUInt(inv[i]->GetID());
+        file.WriteUInt(inv[i]->GetCount());
+    }
+}
+
 } // namespace vt_global
 
 #endif // __GLOBAL_INVENTORY_HANDLER_HEADER__
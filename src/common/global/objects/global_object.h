@@ -18,6 +18,7 @@
 #include "utils/ustring.h"
 
 #include <memory>
+#include <vector>
 
 namespace vt_script {
 class ReadScriptDescriptor;
@@ -78,6 +79,86 @@ const uint32_t OBJECT_ID_EXCEEDS   = 80001;
 **/
 std::shared_ptr<GlobalObject> GlobalCreateNewObject(uint32_t id, uint32_t count = 1);
 
+/** ****************************************************************************
+*** \brief The data of an object type, as read from its definition script
+***
+*** The definitions are parsed once per object id, on first use, and are shared
+*** by all of the objects of that id: Creating an object only copies a pointer
+*** to its definition, and the objects only hold their own count and state.
+***
+*** \note The definitions are cached by the InventoryHandler, and must not be
+*** modified once loaded.
+*** ***************************************************************************/
+class GlobalObjectDefinition
+{
+public:
+    GlobalObjectDefinition() :
+        is_key_item(false),
+        price(0),
+        trade_price(0)
+    {
+    }
+
+    virtual ~GlobalObjectDefinition()
+    {
+    }
+
+    /** \brief Loads the definition of an object from its open definition script.
+    *** \param id The id of the object, whose table is opened and closed in the script.
+    *** \return False if the object isn't defined, or its definition has errors.
+    **/
+    bool Load(uint32_t id, vt_script::ReadScriptDescriptor& script);
+
+    //! \brief The name of the object as it would be displayed on a screen
+    vt_utils::ustring name;
+
+    //! \brief A short description of the item to display on the screen
+    vt_utils::ustring description;
+
+    //! \brief Tells whether an item is a key item, preventing from being consumed or sold.
+    bool is_key_item;
+
+    //! \brief The base price of the object for purchase/sale in the game
+    uint32_t price;
+
+    //! \brief The additional price of the object requested when trading it.
+    uint32_t trade_price;
+
+    //! \brief The trade conditions of the item <item_id, number>
+    //! There is an exception: If the item_id is zero, the second value is the trade price.
+    std::vector<std::pair<uint32_t, uint32_t> > trade_conditions;
+
+    //! \brief A loaded icon image of the object at its original size of 60x60 pixels
+    vt_video::StillImage icon_image;
+
+    /** \brief Container that holds the intensity of each type of status effect of the object
+    *** Effects with an intensity of GLOBAL_INTENSITY_NEUTRAL indicate no status effect bonus
+    **/
+    std::vector<std::pair<GLOBAL_STATUS, GLOBAL_INTENSITY> > status_effects;
+
+    //! \brief The skills that can be learned when equipping that piece of equipment.
+    std::vector<uint32_t> equipment_skills;
+
+protected:
+    //! \brief Reads the data specific to the object type, from the object table opened.
+    virtual void _LoadTypeData(uint32_t /*id*/, vt_script::ReadScriptDescriptor& /*script*/)
+    {
+    }
+
+    //! \brief Loads status effects data
+    void _LoadStatusEffects(vt_script::ReadScriptDescriptor& script);
+
+    //! \brief Loads the object linked skills (used by equipment only)
+    void _LoadEquipmentSkills(vt_script::ReadScriptDescriptor& script);
+
+private:
+    //! \brief Reads the data common to all objects, from the object table opened.
+    void _LoadObjectData(uint32_t id, vt_script::ReadScriptDescriptor& script);
+
+    //! \brief Loads trading conditions data
+    void _LoadTradeConditions(vt_script::ReadScriptDescriptor& script);
+};
+
 /** ****************************************************************************
 *** \brief An abstract base class for representing a game object
 ***
@@ -100,21 +181,9 @@ std::shared_ptr<GlobalObject> GlobalCreateNewObject(uint32_t id, uint32_t count
 class GlobalObject
 {
 public:
-    GlobalObject() :
-        _id(0),
-        _is_key_item(false),
-        _count(0),
-        _price(0),
-        _trade_price(0)
-    {
-    }
-
     explicit GlobalObject(uint32_t id, uint32_t count = 1) :
         _id(id),
-        _is_key_item(false),
-        _count(count),
-        _price(0),
-        _trade_price(0)
+        _count(count)
     {
     }
 
@@ -129,7 +198,7 @@ public:
 
     //! \brief Returns true if the object is properly initialized and ready to be used
     bool IsKeyItem() const {
-        return _is_key_item;
+        return _definition->is_key_item;
     }
 
     /** \brief Purely virtual function used to distinguish between object types
@@ -161,11 +230,11 @@ public:
     }
 
     const vt_utils::ustring &GetName() const {
-        return _name;
+        return _definition->name;
     }
 
     const vt_utils::ustring &GetDescription() const {
-        return _description;
+        return _definition->description;
     }
 
     void SetCount(uint32_t count) {
@@ -177,23 +246,23 @@ public:
     }
 
     uint32_t GetPrice() const {
-        return _price;
+        return _definition->price;
     }
 
     uint32_t GetTradingPrice() const {
-        return _trade_price;
+        return _definition->trade_price;
     }
 
     const std::vector<std::pair<uint32_t, uint32_t> >& GetTradeConditions() const {
-        return _trade_conditions;
+        return _definition->trade_conditions;
     }
 
     const vt_video::StillImage& GetIconImage() const {
-        return _icon_image;
+        return _definition->icon_image;
     }
 
     const std::vector<std::pair<GLOBAL_STATUS, GLOBAL_INTENSITY> >& GetStatusEffects() const {
-        return _status_effects;
+        return _definition->status_effects;
     }
     //@}
 
@@ -203,62 +272,25 @@ protected:
     **/
     uint32_t _id;
 
-    //! \brief The name of the object as it would be displayed on a screen
-    vt_utils::ustring _name;
-
-    //! \brief A short description of the item to display on the screen
-    vt_utils::ustring _description;
-
-    //! \brief Tells whether an item is a key item, preventing from being consumed or sold.
-    bool _is_key_item;
-
     //! \brief Retains how many occurences of the object are represented by this class object instance
     uint32_t _count;
 
-    //! \brief The base price of the object for purchase/sale in the game
-    uint32_t _price;
-
-    //! \brief The additional price of the object requested when trading it.
-    uint32_t _trade_price;
-
-    //! \brief The trade conditions of the item <item_id, number>
-    //! There is an exception: If the item_id is zero, the second value is the trade price.
-    std::vector<std::pair<uint32_t, uint32_t> > _trade_conditions;
-
-    //! \brief A loaded icon image of the object at its original size of 60x60 pixels
-    vt_video::StillImage _icon_image;
-
-    /** \brief Container that holds the intensity of each type of status effect of the object
-    *** Effects with an intensity of GLOBAL_INTENSITY_NEUTRAL indicate no status effect bonus
+    /** \brief The definition shared by all of the objects of that id
+    *** It is set by the derived classes constructors, to a definition of their own type,
+    *** and is never null once constructed.
     **/
-    std::vector<std::pair<GLOBAL_STATUS, GLOBAL_INTENSITY> > _status_effects;
+    std::shared_ptr<const GlobalObjectDefinition> _definition;
 
-    //! \brief The skills that can be learned when equipping that piece of equipment.
-    std::vector<uint32_t> _equipment_skills;
+    /** \brief Sets the cached definition of the object, or invalidates the object when it has none.
+    *** \return False when the object was invalidated. Its derived class must then set an empty
+    *** definition of its own type.
+    **/
+    bool _LoadDefinition();
 
     //! \brief Causes the object to become invalid due to a loading error or other significant issue
     void _InvalidateObject() {
         _id = 0;
     }
-
-    /** \brief Reads object data from an open script file
-    *** \param script A reference to a script file that has been opened and prepared
-    ***
-    *** This method does not do any of its own error case checking. Only derived classes may call this
-    *** protected function and they are expected to have the script file successfully opened and the correct
-    *** table context prepared. This function will do nothing more but read the expected key/values of
-    *** the open table in the script file and return.
-    **/
-    void _LoadObjectData(vt_script::ReadScriptDescriptor &script);
-
-    //! \brief Loads status effects data
-    void _LoadStatusEffects(vt_script::ReadScriptDescriptor &script);
-
-    //! \brief Loads trading conditions data
-    void _LoadTradeConditions(vt_script::ReadScriptDescriptor &script);
-
-    //! \brief Loads the object linked skills (used by equipment only)
-    void _LoadEquipmentSkills(vt_script::ReadScriptDescriptor &script);
 }; // class GlobalObject
 
 } // namespace vt_global
@@ -24,27 +24,10 @@ GlobalSpirit::GlobalSpirit(uint32_t id, uint32_t count) :
     if((_id <= MAX_LEG_ARMOR_ID) || (_id > MAX_SPIRIT_ID)) {
         IF_PRINT_WARNING(GLOBAL_DEBUG) << "invalid id in constructor: " << _id << std::endl;
         _InvalidateObject();
-        return;
     }
 
-    ReadScriptDescriptor& script_file = GlobalManager->GetInventoryHandler().GetSpiritsScript();
-    if (script_file.DoesTableExist(_id) == false) {
-        IF_PRINT_WARNING(GLOBAL_DEBUG) << "No valid data for spirit id: " << _id << std::endl;
-        _InvalidateObject();
-        return;
-    }
-
-    // Load the spirit data from the script
-    script_file.OpenTable(_id);
-    _LoadObjectData(script_file);
-
-    script_file.CloseTable();
-    if (script_file.IsErrorDetected()) {
-        IF_PRINT_WARNING(GLOBAL_DEBUG) << "one or more errors occurred while reading spirit data - they are listed below" << std::endl
-            << script_file.GetErrorMessages() << std::endl;
-
-        _InvalidateObject();
-    }
+    if(!IsValid() || !_LoadDefinition())
+        _definition = std::make_shared<GlobalObjectDefinition>();
 }
 
 } // namespace vt_global
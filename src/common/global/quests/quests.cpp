@@ -31,6 +31,8 @@ bool GameQuests::LoadQuestsScript(const std::string& quests_script_filename)
 {
     // First clear the existing quests entries in case of a reloading.
     _quest_log_info.clear();
+    _quest_states.clear();
+    GlobalManager->GetGameEvents().UnwatchEvents(this);
 
     vt_script::ReadScriptDescriptor quests_script;
     if(!quests_script.OpenFile(quests_script_filename)) {
@@ -84,6 +86,7 @@ bool GameQuests::LoadQuestsScript(const std::string& quests_script_filename)
                 info.SetNotCompletableIf(quest_info[9], quest_info[10]);
             }
             _quest_log_info[quest_id] = info;
+            _WatchQuestEvents(quest_id, info);
         }
         //malformed quest log
         else
@@ -105,6 +108,8 @@ void GameQuests::Clear()
     for(auto itr = _quest_log_entries.begin(); itr != _quest_log_entries.end(); ++itr)
         delete itr->second;
     _quest_log_entries.clear();
+    _active_quest_entries.clear();
+    ++_generation;
 }
 
 bool GameQuests::AddQuestLog(const std::string& quest_id)
@@ -125,41 +130,43 @@ const QuestLogInfo& GameQuests::GetQuestInfo(const std::string& quest_id) const
     return itr->second;
 }
 
-std::vector<QuestLogEntry *> GameQuests::GetActiveQuestIds() const
+bool GameQuests::IsQuestCompleted(const std::string& quest_id) const
 {
-    std::vector<QuestLogEntry *> keys;
-    for(std::map<std::string, QuestLogEntry *>::const_iterator itr = _quest_log_entries.begin();
-            itr != _quest_log_entries.end(); ++itr) {
-        if (itr->second)
-            keys.push_back(itr->second);
-    }
-    return keys;
+    auto it = _quest_states.find(quest_id);
+    if (it == _quest_states.end())
+        return false;
+    return it->second.completed;
 }
 
-bool GameQuests::IsQuestCompleted(const std::string& quest_id)
+bool GameQuests::IsQuestCompletable(const std::string& quest_id) const
 {
-    std::map<std::string, vt_global::QuestLogInfo>::iterator it = _quest_log_info.find(quest_id);
-    if (it == _quest_log_info.end())
-        return false;
-    const QuestLogInfo& info = it->second;
-    if (info._completion_event_group.empty() || info._completion_event_name.empty())
+    auto it = _quest_states.find(quest_id);
+    if (it == _quest_states.end())
         return true;
-
-    GameEvents &events = GlobalManager->GetGameEvents();
-    return (events.GetEventValue(info._completion_event_group, info._completion_event_name) == 1);
+    return it->second.completable;
 }
 
-bool GameQuests::IsQuestCompletable(const std::string& quest_id)
+void GameQuests::_WatchQuestEvents(const std::string& quest_id, const QuestLogInfo& info)
 {
-    std::map<std::string, vt_global::QuestLogInfo>::iterator it = _quest_log_info.find(quest_id);
-    if (it == _quest_log_info.end())
-        return true;
-    const QuestLogInfo& info = it->second;
-    if (info._not_completable_event_group.empty() || info._not_completable_event_name.empty())
-        return true;
+    // The states are stored in the nodes of an unordered map, so their address is stable.
+    _QuestState* state = &_quest_states[quest_id];
+    GameEvents& events = GlobalManager->GetGameEvents();
+
+    if (!info._completion_event_group.empty() && !info._completion_event_name.empty()) {
+        const uint32_t event_handle = events.GetEventHandle(info._completion_event_group, info._completion_event_name);
+        state->completed = (events.GetEventValueFromHandle(event_handle) == 1);
+        events.WatchEvent(event_handle, this, [state](int32_t value) {
+            state->completed = (value == 1);
+        });
+    }
 
-    GameEvents &events = GlobalManager->GetGameEvents();
-    return (events.GetEventValue(info._not_completable_event_group, info._not_completable_event_name) == 0);
+    if (!info._not_completable_event_group.empty() && !info._not_completable_event_name.empty()) {
+        const uint32_t event_handle = events.GetEventHandle(info._not_completable_event_group, info._not_completable_event_name);
+        state->completable = (events.GetEventValueFromHandle(event_handle) == 0);
+        events.WatchEvent(event_handle, this, [state](int32_t value) {
+            state->completable = (value == 0);
+        });
+    }
 }
 
 void GameQuests::LoadQuests(ReadScriptDescriptor& file)
@@ -248,7 +255,56 @@ bool GameQuests::_AddQuestLog(const std::string& quest_id,
     _quest_log_entries[quest_id] = new QuestLogEntry(quest_id,
                                                      quest_log_number,
                                                      is_read);
+
+    // Quests are seldom added: The view is simply rebuilt in the map order.
+    _active_quest_entries.clear();
+    for(auto itr = _quest_log_entries.begin(); itr != _quest_log_entries.end(); ++itr)
+        _active_quest_entries.push_back(itr->second);
+    ++_generation;
     return true;
 }
 
+void GameQuests::SetQuestLogRead(QuestLogEntry* quest_log_entry)
+{
+    if (quest_log_entry == nullptr || quest_log_entry->IsRead())
+        return;
+    quest_log_entry->SetRead();
+    ++_generation;
+}
+
+void GameQuests::LoadQuests(SaveFileReader& file)
+{
+    const uint64_t count = file.ReadUInt();
+    for(uint64_t i = 0; i < count && !file.IsErrorDetected(); ++i) {
+        std::string quest_id = file.ReadString();
+        uint32_t quest_log_number = static_cast<uint32_t>(file.ReadUInt());
+        bool is_read = file.ReadBool();
+
+        if(!_AddQuestLog(quest_id, quest_log_number, is_read)) {
+            PRINT_WARNING << "save file has duplicate quest log id entries" << std::endl;
+            return;
+        }
+    }
+}
+
+void GameQuests::SaveQuests(SaveFileWriter& file)
+{
+    uint32_t count = 0;
+    for(auto itr = _quest_log_entries.begin(); itr != _quest_log_entries.end(); ++itr) {
+        if (itr->second != nullptr)
+            ++count;
+    }
+
+    file.WriteUInt(count);
+    for(auto itr = _quest_log_entries.begin(); itr != _quest_log_entries.end(); ++itr) {
+        const QuestLogEntry* quest_log_entry = itr->second;
+        if (quest_log_entry == nullptr)
+            continue;
+
+        file.WriteString(quest_log_entry->GetQuestId());
+        file.WriteUInt(quest_log_entry->GetQuestLogNumber());
+        file.WriteBool(quest_log_entry->IsRead());
+    }
+}
+
 } // namespace vt_global
@@ -17,9 +17,12 @@
 #include "script/script_read.h"
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 namespace vt_global
 {
@@ -29,7 +32,9 @@ class GameQuests
 {
 
 public:
-    GameQuests() {}
+    GameQuests() :
+        _generation(0)
+    {}
     ~GameQuests();
 
     //! \brief (Re)Loads the quest entries into the GlobalManager
@@ -43,12 +48,12 @@ public:
     //! \brief Tells whether a quest id is completed, based on the internal quest info
     //! and the current game event values.
     //! \param quest_id the string id into quests table for this quest
-    bool IsQuestCompleted(const std::string& quest_id);
+    bool IsQuestCompleted(const std::string& quest_id) const;
 
     //! \brief Tells whether a quest id is completed, based on the internal quest info
     //! and the current game event values.
     //! \param quest_id the string id into quests table for this quest
-    bool IsQuestCompletable(const std::string& quest_id);
+    bool IsQuestCompletable(const std::string& quest_id) const;
 
     /** \brief adds a new quest log entry into the quest log entries table
     *** \param quest_id the string id into quests table for this quest
@@ -62,9 +67,11 @@ public:
     uint32_t GetNumberQuestLogEntries() const;
 
     /** \brief get a list of all the currently active quest log entries
-    *** \return a vector of valid quest log entries
+    *** \return a vector of valid quest log entries, sorted by quest id
     **/
-    std::vector<QuestLogEntry *> GetActiveQuestIds() const;
+    const std::vector<QuestLogEntry *>& GetActiveQuestIds() const {
+        return _active_quest_entries;
+    }
 
     /** \brief gets a pointer to the description for the quest string id,
     *** \param quest_id the quest id
@@ -83,6 +90,18 @@ public:
     **/
     void SaveQuests(vt_script::WriteScriptDescriptor& file);
 
+    //! \brief Binary saved game versions of the functions above.
+    void LoadQuests(SaveFileReader& file);
+    void SaveQuests(SaveFileWriter& file);
+
+    //! \brief Sets a quest log entry as read by the player.
+    void SetQuestLogRead(QuestLogEntry* quest_log_entry);
+
+    //! \brief Changes whenever the saved data changes, so that its encoded saved game section can be reused.
+    uint32_t GetGeneration() const {
+        return _generation;
+    }
+
 private:
     /** \brief The container which stores the quest log entries in the game. the quest log key
     *** acts as the key for this quest
@@ -91,9 +110,30 @@ private:
     **/
     std::map<std::string, QuestLogEntry *> _quest_log_entries;
 
+    //! \brief The quest log entries of the container above, in the same order.
+    std::vector<QuestLogEntry *> _active_quest_entries;
+
     //! \brief a map of the quest string ids to their info
     std::map<std::string, QuestLogInfo> _quest_log_info;
 
+    //! \brief The completion state of a quest, kept up to date by watching its events.
+    class _QuestState
+    {
+    public:
+        _QuestState() :
+            completed(true),
+            completable(true)
+        {}
+
+        bool completed;
+        bool completable;
+    };
+
+    //! \brief The state of each quest of the quest info, by quest id.
+    std::unordered_map<std::string, _QuestState> _quest_states;
+
+    uint32_t _generation;
+
     /** \brief adds a new quest log entry into the quest log entries table. also updates the quest log number
     *** \param quest_id for the quest
     *** \param the quest entry's log number
@@ -103,6 +143,9 @@ private:
     bool _AddQuestLog(const std::string& quest_id,
                       uint32_t quest_log_number,
                       bool is_read = false);
+
+    //! \brief Watches the completion events of a quest, and sets its current state.
+    void _WatchQuestEvents(const std::string& quest_id, const QuestLogInfo& info);
 };
 
 } // namespace vt_global
@@ -23,11 +23,16 @@ ShopDataHandler::~ShopDataHandler()
 void ShopDataHandler::Clear()
 {
     _shop_data.clear();
+    ++_generation;
 }
 
 const ShopData& ShopDataHandler::GetShopData(const std::string& shop_id) {
-    if (_shop_data.find(shop_id) == _shop_data.end())
+    if (_shop_data.find(shop_id) == _shop_data.end()) {
+        // The default empty shop data is added, and saved from then on.
+        if (_shop_data.find(std::string()) == _shop_data.end())
+            ++_generation;
         return _shop_data[std::string()]; // Return default empty shop data
+    }
     return _shop_data.at(shop_id);
 }
 
@@ -38,6 +43,7 @@ bool ShopDataHandler::HasShopData(const std::string& shop_id) const {
 void ShopDataHandler::SetShopData(const std::string& shop_id, const ShopData& shop_data)
 {
     _shop_data[shop_id] = shop_data;
+    ++_generation;
 }
 
 void ShopDataHandler::LoadShopData(vt_script::ReadScriptDescriptor& file)
@@ -50,6 +56,7 @@ void ShopDataHandler::LoadShopData(vt_script::ReadScriptDescriptor& file)
     if (!file.OpenTable("shop_data")) {
         return;
     }
+    ++_generation;
 
     std::vector<std::string> shop_ids;
     file.ReadTableKeys(shop_ids);
@@ -128,4 +135,49 @@ void ShopDataHandler::SaveShopData(vt_script::WriteScriptDescriptor& file)
     file.InsertNewLine();
 }
 
+//! \brief Reads item id + count pairs into a shop data map.
+static void _LoadShopItems(SaveFileReader& file, std::map<uint32_t, uint32_t>& items)
+{
+    const uint64_t count = file.ReadUInt();
+    for (uint64_t i = 0; i < count && !file.IsErrorDetected(); ++i) {
+        uint32_t item_id = static_cast<uint32_t>(file.ReadUInt());
+        items[item_id] = static_cast<uint32_t>(file.ReadUInt());
+    }
+}
+
+//! \brief Writes the item id + count pairs of a shop data map.
+static void _SaveShopItems(SaveFileWriter& file, const std::map<uint32_t, uint32_t>& items)
+{
+    file.WriteUInt(items.size());
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        file.WriteUInt(it->first);
+        file.WriteUInt(it->second);
+    }
+}
+
+void ShopDataHandler::LoadShopData(SaveFileReader& file)
+{
+    ++_generation;
+
+    const uint64_t count = file.ReadUInt();
+    for (uint64_t i = 0; i < count && !file.IsErrorDetected(); ++i) {
+        std::string shop_id = file.ReadString();
+
+        ShopData shop_data;
+        _LoadShopItems(file, shop_data._available_buy);
+        _LoadShopItems(file, shop_data._available_trade);
+        _shop_data[shop_id] = shop_data;
+    }
+}
+
+void ShopDataHandler::SaveShopData(SaveFileWriter& file)
+{
+    file.WriteUInt(_shop_data.size());
+    for (auto it = _shop_data.begin(); it != _shop_data.end(); ++it) {
+        file.WriteString(it->first);
+        _SaveShopItems(file, it->second._available_buy);
+        _SaveShopItems(file, it->second._available_trade);
+    }
+}
+
 } // namespace vt_global
@@ -16,6 +16,8 @@
 #include "script/script_read.h"
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
 #include <string>
 #include <map>
 
@@ -26,7 +28,9 @@ class ShopDataHandler
 {
 
 public:
-    ShopDataHandler() {}
+    ShopDataHandler() :
+        _generation(0)
+    {}
     ~ShopDataHandler();
 
     //! \brief Clear all shop data
@@ -51,10 +55,21 @@ public:
     **/
     void SaveShopData(vt_script::WriteScriptDescriptor& file);
 
+    //! \brief Binary saved game versions of the functions above.
+    void LoadShopData(SaveFileReader& file);
+    void SaveShopData(SaveFileWriter& file);
+
+    //! \brief Changes whenever the saved data changes, so that its encoded saved game section can be reused.
+    uint32_t GetGeneration() const {
+        return _generation;
+    }
+
 private:
     //! \brief A map of the curent shop data.
     //! shop_id, corresponding shop data
     std::map<std::string, ShopData> _shop_data;
+
+    uint32_t _generation;
 };
 
 } // namespace vt_global
@@ -10,22 +10,31 @@
 
 #include "worldmap_handler.h"
 
+#include "engine/video/texture_controller.h"
+
+#include <algorithm>
+
 namespace vt_global
 {
 
 WorldMapHandler::WorldMapHandler() :
-    _world_map_image(nullptr)
+    _current_world_location(INVALID_WORLD_LOCATION),
+    _generation(0)
 {
 }
 
 WorldMapHandler::~WorldMapHandler()
 {
-    ClearWorldMapImage();
+    UnloadImages();
 }
 
 bool WorldMapHandler::LoadScript(const std::string& world_locations_filename)
 {
+    UnloadImages();
     _world_map_locations.clear();
+    _world_location_indices.clear();
+    _viewable_world_locations.clear();
+    _current_world_location = INVALID_WORLD_LOCATION;
 
     vt_script::ReadScriptDescriptor world_locations_script;
     if(!world_locations_script.OpenFile(world_locations_filename)) {
@@ -49,6 +58,7 @@ bool WorldMapHandler::LoadScript(const std::string& world_locations_filename)
         return false;
     }
 
+    _world_map_locations.reserve(world_location_ids.size());
     world_locations_script.OpenTable("world_locations");
     for(uint32_t i = 0; i < world_location_ids.size(); ++i)
     {
@@ -57,19 +67,22 @@ bool WorldMapHandler::LoadScript(const std::string& world_locations_filename)
         world_locations_script.ReadStringVector(id,values);
 
         //check for existing location
-        if(_world_map_locations.find(id) != _world_map_locations.end())
+        if(_world_location_indices.find(id) != _world_location_indices.end())
         {
             PRINT_WARNING << "duplicate world map location id found: " << id << std::endl;
             continue;
         }
+        if(values.size() < 4) {
+            PRINT_WARNING << "Invalid world map location: " << id << std::endl;
+            continue;
+        }
 
         float x = atof(values[0].c_str());
         float y = atof(values[1].c_str());
         const std::string &location_name = values[2];
         const std::string &image_path = values[3];
-        WorldMapLocation location(x, y, location_name, image_path, id);
-
-        _world_map_locations[id] = location;
+        _world_location_indices[id] = _world_map_locations.size();
+        _world_map_locations.push_back(WorldMapLocation(x, y, location_name, image_path, id));
     }
     world_locations_script.CloseFile();
 
@@ -79,28 +92,91 @@ bool WorldMapHandler::LoadScript(const std::string& world_locations_filename)
 void WorldMapHandler::ClearWorldMapImage()
 {
     // Clear global world map file
-    if (_world_map_image) {
-        delete _world_map_image;
-        _world_map_image = nullptr;
+    _world_map_image.Clear();
+    if (!_world_map_image_filename.empty()) {
+        _world_map_image_filename.clear();
+        ++_generation;
     }
 }
 
-const std::string& WorldMapHandler::GetWorldMapImageFilename() const
+const vt_video::StillImage* WorldMapHandler::GetWorldMapImage()
 {
-    if (_world_map_image)
-        return _world_map_image->GetFilename();
-    else
-        return vt_utils::_empty_string;
+    if (_world_map_image_filename.empty())
+        return nullptr;
+
+    if (_world_map_image.GetFilename().empty() && !_world_map_image.Load(_world_map_image_filename))
+        PRINT_WARNING << "Couldn't load the world map image: " << _world_map_image_filename << std::endl;
+    return &_world_map_image;
+}
+
+void WorldMapHandler::PrefetchImages()
+{
+    if (!_world_map_image_filename.empty() && _world_map_image.GetFilename().empty()) {
+        vt_video::TextureManager->PrefetchImage(_world_map_image_filename);
+        _prefetched_image_filenames.push_back(_world_map_image_filename);
+    }
+
+    for (uint32_t i = 0; i < _viewable_world_locations.size(); ++i) {
+        const WorldMapLocation& location = _world_map_locations[_viewable_world_locations[i]];
+        if (!location._image_filename.empty() && location._image.GetFilename().empty()) {
+            vt_video::TextureManager->PrefetchImage(location._image_filename);
+            _prefetched_image_filenames.push_back(location._image_filename);
+        }
+    }
+}
+
+void WorldMapHandler::UnloadImages()
+{
+    _world_map_image.Clear();
+    for (uint32_t i = 0; i < _world_map_locations.size(); ++i)
+        _world_map_locations[i]._image.Clear();
+
+    // The images shown were taken from the decoder already, the others aren't needed anymore.
+    if (vt_video::TextureManager != nullptr) {
+        for (uint32_t i = 0; i < _prefetched_image_filenames.size(); ++i)
+            vt_video::TextureManager->CancelPrefetchedImage(_prefetched_image_filenames[i]);
+    }
+    _prefetched_image_filenames.clear();
+}
+
+const vt_video::StillImage* WorldMapHandler::GetLocationImage(uint32_t index)
+{
+    if (index >= _world_map_locations.size())
+        return nullptr;
+
+    WorldMapLocation& location = _world_map_locations[index];
+    if (location._image.GetFilename().empty() && !location._image_filename.empty()) {
+        if (!location._image.Load(location._image_filename))
+            PRINT_WARNING << "Couldn't load the world location image: " << location._image_filename << std::endl;
+    }
+    return &location._image;
 }
 
 void WorldMapHandler::SetWorldMapImage(const std::string& world_map_filename)
 {
-    ClearWorldMapImage();
+    _world_map_image.Clear();
+    _world_map_image_filename = world_map_filename;
 
     _viewable_world_locations.clear();
-    _current_world_location_id.clear();
-    _world_map_image = new vt_video::StillImage();
-    _world_map_image->Load(world_map_filename);
+    _current_world_location = INVALID_WORLD_LOCATION;
+    ++_generation;
+}
+
+const std::string& WorldMapHandler::GetCurrentLocationId() const
+{
+    if (_current_world_location >= _world_map_locations.size())
+        return vt_utils::_empty_string;
+    return _world_map_locations[_current_world_location]._world_map_location_id;
+}
+
+void WorldMapHandler::SetCurrentLocationId(const std::string& location_id)
+{
+    const uint32_t location = GetLocationIndex(location_id);
+    if (location == INVALID_WORLD_LOCATION && !location_id.empty())
+        PRINT_WARNING << "Unknown world map location id: " << location_id << std::endl;
+
+    _current_world_location = location;
+    ++_generation;
 }
 
 void WorldMapHandler::ShowWorldLocation(const std::string& location_id)
@@ -109,12 +185,21 @@ void WorldMapHandler::ShowWorldLocation(const std::string& location_id)
     // If you want to remove an id, call HideWorldLocation
     if(location_id.empty())
         return;
+
+    const uint32_t location = GetLocationIndex(location_id);
+    if (location == INVALID_WORLD_LOCATION) {
+        PRINT_WARNING << "location for id: " << location_id
+            << " is not loaded into global manager" << std::endl;
+        return;
+    }
+
     // Check to make sure this location isn't already visible
     if(std::find(_viewable_world_locations.begin(),
                  _viewable_world_locations.end(),
-                 location_id) == _viewable_world_locations.end())
+                 location) == _viewable_world_locations.end())
     {
-        _viewable_world_locations.push_back(location_id);
+        _viewable_world_locations.push_back(location);
+        ++_generation;
     }
 }
 
@@ -122,9 +207,11 @@ void WorldMapHandler::HideWorldLocation(const std::string &location_id)
 {
     auto rem_iterator = std::find(_viewable_world_locations.begin(),
                                   _viewable_world_locations.end(),
-                                  location_id);
-    if(rem_iterator != _viewable_world_locations.end())
+                                  GetLocationIndex(location_id));
+    if(rem_iterator != _viewable_world_locations.end()) {
         _viewable_world_locations.erase((rem_iterator));
+        ++_generation;
+    }
 }
 
 void WorldMapHandler::LoadWorldMap(vt_script::ReadScriptDescriptor& file)
@@ -167,7 +254,7 @@ void WorldMapHandler::SaveWorldMap(vt_script::WriteScriptDescriptor& file)
     // Write the viewable locations
     file.WriteLine("\tviewable_locations = {");
     for(uint32_t i = 0; i < _viewable_world_locations.size(); ++i)
-        file.WriteLine("\t\t\"" + _viewable_world_locations[i]+"\",");
+        file.WriteLine("\t\t\"" + _world_map_locations[_viewable_world_locations[i]]._world_map_location_id + "\",");
     file.WriteLine("\t},");
     file.InsertNewLine();
 
@@ -177,4 +264,28 @@ void WorldMapHandler::SaveWorldMap(vt_script::WriteScriptDescriptor& file)
     file.InsertNewLine();
 }
 
+void WorldMapHandler::LoadWorldMap(SaveFileReader& file)
+{
+    SetWorldMapImage(file.ReadString());
+
+    const uint64_t count = file.ReadUInt();
+    for(uint64_t i = 0; i < count && !file.IsErrorDetected(); ++i)
+        ShowWorldLocation(file.ReadString());
+
+    std::string current_location = file.ReadString();
+    if (!current_location.empty())
+        SetCurrentLocationId(current_location);
+}
+
+void WorldMapHandler::SaveWorldMap(SaveFileWriter& file)
+{
+    file.WriteString(GetWorldMapImageFilename());
+
+    file.WriteUInt(_viewable_world_locations.size());
+    for(uint32_t i = 0; i < _viewable_world_locations.size(); ++i)
+        file.WriteString(_world_map_locations[_viewable_world_locations[i]]._world_map_location_id);
+
+    file.WriteString(GetCurrentLocationId());
+}
+
 } // namespace vt_global
@@ -16,35 +16,60 @@
 #include "script/script_read.h"
 #include "script/script_write.h"
 
+#include "common/global/global_save_file.h"
+
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <map>
 
 namespace vt_global
 {
 
+//! \brief The index of no world location, as returned for unknown location ids.
+const uint32_t INVALID_WORLD_LOCATION = 0xFFFFFFFF;
+
+/** ****************************************************************************
+*** \brief Handles the world map image and the locations shown on it.
+***
+*** The world locations are read at boot in an indexed table, but neither their
+*** banner images nor the world map image are loaded then: The images are
+*** prefetched when the menu opens, loaded when first drawn, and released when
+*** the menu closes.
+*** ***************************************************************************/
 class WorldMapHandler
 {
 public:
     WorldMapHandler();
     ~WorldMapHandler();
 
-    //! \brief Loads each world location from the script into the world location entry map
+    //! \brief Loads each world location from the script into the world locations table
     //! \param file Path to the file to world locations script
     //! \return true if successfully loaded
+    //! \note The location images aren't loaded here, but by GetLocationImage().
     bool LoadScript(const std::string& world_locations_filename);
 
     //! \brief Clear worldmap image
     void ClearWorldMapImage();
 
-    //! \brief gets the current world map image
-    //! \return a pointer to the currently viewable World Map Image.
-    //! \note returns nullptr if the filename has been set to ""
-    vt_video::StillImage* GetWorldMapImage() const {
-        return _world_map_image;
+    /** \brief gets the current world map image, loading it if needed
+    *** \return a pointer to the currently viewable World Map Image.
+    *** \note returns nullptr if the filename has been set to ""
+    **/
+    const vt_video::StillImage* GetWorldMapImage();
+
+    const std::string& GetWorldMapImageFilename() const {
+        return _world_map_image_filename;
     }
 
-    const std::string& GetWorldMapImageFilename() const;
+    /** \brief Starts decoding the world map image and the viewable locations images,
+    *** so that the world map menu doesn't stall when showing them.
+    *** \note Called when the menu opens.
+    **/
+    void PrefetchImages();
+
+    //! \brief Releases the world map and location images, and forgets the prefetched ones.
+    //! Called when the menu closes.
+    void UnloadImages();
 
     /** \brief sets the current viewable world map
     *** empty strings are valid, and will cause the return
@@ -56,20 +81,21 @@ public:
     /** \brief Gets a reference to the current world location id
     *** \return Reference to the current id. this value always exists, but could be "" if
     *** the location is not set, or if the world map is cleared
-    *** the value could also not currently exist, if HideWorldLocation was called on an
+    *** the location could also not currently be viewable, if HideWorldLocation was called on an
     *** id that was also set as the current location. the calling code should check for this
     **/
-    const std::string& GetCurrentLocationId() const {
-        return _current_world_location_id;
+    const std::string& GetCurrentLocationId() const;
+
+    //! \brief Gets the index of the current world location, or INVALID_WORLD_LOCATION.
+    uint32_t GetCurrentLocation() const {
+        return _current_world_location;
     }
 
     /** \brief Sets the current location id
     *** \param the location id of the world location that is defaulted to as "here"
     *** when the world map menu is opened
     **/
-    void SetCurrentLocationId(const std::string& location_id) {
-        _current_world_location_id = location_id;
-    }
+    void SetCurrentLocationId(const std::string& location_id);
 
     /** \brief adds a viewable location string id to the currently viewable
     *** set. This string IDs are maintained in the data/config/world_location.lua file.
@@ -83,24 +109,32 @@ public:
     **/
     void HideWorldLocation(const std::string &location_id);
 
-    /** \brief gets a reference to the current viewable location ids
-    *** \return reference to the current viewable location ids
+    /** \brief gets a reference to the current viewable locations
+    *** \return reference to the indices of the current viewable locations
     **/
-    const std::vector<std::string>& GetViewableLocationIds() const {
+    const std::vector<uint32_t>& GetViewableLocations() const {
         return _viewable_world_locations;
     }
 
-    /** \brief get a pointer to the associated world location for the id
-    *** \param string Reference if for the world map location
+    //! \brief Gets the index of a world location, or INVALID_WORLD_LOCATION if it doesn't exist.
+    uint32_t GetLocationIndex(const std::string& id) const {
+        auto it = _world_location_indices.find(id);
+        return it == _world_location_indices.end() ? INVALID_WORLD_LOCATION : it->second;
+    }
+
+    /** \brief get a pointer to the world location of an index
     *** \return nullptr if the location does not exist. otherwise, return a const pointer
     *** to the location
     **/
-    WorldMapLocation* GetWorldLocation(const std::string &id)
-    {
-        std::map<std::string, WorldMapLocation>::iterator itr = _world_map_locations.find(id);
-        return itr == _world_map_locations.end() ? nullptr : &(itr->second);
+    const WorldMapLocation* GetWorldLocation(uint32_t index) const {
+        return index < _world_map_locations.size() ? &_world_map_locations[index] : nullptr;
     }
 
+    /** \brief Gets the banner image of a world location, loading it if needed.
+    *** \return nullptr if the location does not exist.
+    **/
+    const vt_video::StillImage* GetLocationImage(uint32_t index);
+
     //! \brief Load world map and viewable information from the save game
     //! \param file Reference to an open file for reading save game data
     void LoadWorldMap(vt_script::ReadScriptDescriptor& file);
@@ -109,25 +143,43 @@ public:
     //! \param file Reference to open and valid file for writting the data
     void SaveWorldMap(vt_script::WriteScriptDescriptor& file);
 
+    //! \brief Binary saved game versions of the functions above.
+    void LoadWorldMap(SaveFileReader& file);
+    void SaveWorldMap(SaveFileWriter& file);
+
+    //! \brief Changes whenever the saved data changes, so that its encoded saved game section can be reused.
+    uint32_t GetGeneration() const {
+        return _generation;
+    }
+
 private:
-    //! \brief The current graphical world map. If the filename is empty,
+    //! \brief The current graphical world map filename. If it is empty,
     //! then we are "hiding" the map
-    vt_video::StillImage* _world_map_image;
+    std::string _world_map_image_filename;
+
+    //! \brief The current graphical world map, only loaded while the world map is shown.
+    vt_video::StillImage _world_map_image;
 
-    //! \brief The current viewable location ids on the current world map image
+    //! \brief The images prefetched when the menu opened, cancelled when it closes if never shown.
+    std::vector<std::string> _prefetched_image_filenames;
+
+    //! \brief The indices of the current viewable locations on the current world map image
     //! \note this list is cleared when we call SetWorldMap. It is up to the
     //! script writter to maintain the properties of the map by either
     //!  1) call CopyViewableLocationList()
     //!  2) maintain in some other fashion the list
-    std::vector<std::string> _viewable_world_locations;
+    std::vector<uint32_t> _viewable_world_locations;
 
-    /** \brief the container which stores all the available world locations in the game.
-    *** the world_location_id acts as the key
-    **/
-    std::map<std::string, WorldMapLocation> _world_map_locations;
+    //! \brief All the available world locations in the game, in the script order.
+    std::vector<WorldMapLocation> _world_map_locations;
+
+    //! \brief The index in _world_map_locations of each world location id.
+    std::unordered_map<std::string, uint32_t> _world_location_indices;
+
+    //! \brief the index of the current world map location, which indicates where the player is
+    uint32_t _current_world_location;
 
-    //! \brief the current world map location id that indicates where the player is
-    std::string _current_world_location_id;
+    uint32_t _generation;
 };
 
 } // namespace vt_global
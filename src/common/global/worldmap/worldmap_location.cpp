@@ -21,10 +21,9 @@ WorldMapLocation::WorldMapLocation(float x,
                                    const std::string& world_map_location_id) :
     _pos(x, y),
     _location_name(location_name),
-    _world_map_location_id(world_map_location_id)
+    _world_map_location_id(world_map_location_id),
+    _image_filename(image_path)
 {
-    if(!_image.Load(image_path))
-        PRINT_ERROR << "image: " << image_path << " not able to load" << std::endl;
 }
 
 } // namespace vt_global
@@ -17,7 +17,8 @@ namespace vt_global {
 
 /** *****************************************************************************
 *** \brief Struct for world map locations
-*** the parameters are all immutable and loaded at creation time
+*** the parameters are all immutable and loaded at creation time, except the
+*** banner image, which is loaded by the world map handler when shown
 *** there should be no reason for these to be created outside the global manager
 *** the key is the unique location id set in the script as a string
 *** there is no need for accesor functions because this is just a storage struct
@@ -36,6 +37,7 @@ public:
         _pos(other._pos),
         _location_name(other._location_name),
         _world_map_location_id(other._world_map_location_id),
+        _image_filename(other._image_filename),
         _image(other._image)
     {}
 
@@ -46,6 +48,7 @@ public:
         _pos = other._pos;
         _location_name = other._location_name;
         _world_map_location_id = other._world_map_location_id;
+        _image_filename = other._image_filename;
         _image = other._image;
         return *this;
     }
@@ -57,6 +60,9 @@ public:
     vt_common::Position2D _pos;
     std::string _location_name;
     std::string _world_map_location_id;
+    std::string _image_filename;
+
+    //! \brief The banner image, empty until loaded by WorldMapHandler::GetLocationImage().
     vt_video::StillImage _image;
 };
 
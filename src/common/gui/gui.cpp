@@ -97,9 +97,9 @@ void GUIElement::CalculateAlignedRect(float &left, float &right, float &bottom,
 
     float x_off, y_off;
 
-    x_off = _position.x + ((VideoManager->_current_context.x_align + 1) * width)  * 0.5f *
+    x_off = _position.x + ((VideoManager->_current_context.draw_state.GetXAlign() + 1) * width)  * 0.5f *
             -VideoManager->_current_context.coordinate_system.GetHorizontalDirection();
-    y_off = _position.y + ((VideoManager->_current_context.y_align + 1) * height) * 0.5f *
+    y_off = _position.y + ((VideoManager->_current_context.draw_state.GetYAlign() + 1) * height) * 0.5f *
             -VideoManager->_current_context.coordinate_system.GetVerticalDirection();
 
     left   += x_off;
@@ -63,6 +63,9 @@ bool MenuWindow::Create(float w, float h, int32_t visible_flags, int32_t shared_
     _edge_visible_flags = visible_flags;
     _edge_shared_flags = shared_flags;
 
+    // The window borders and background tiles are then drawn as a single sprite.
+    _menu_image.Flatten();
+
     if(_skin == nullptr)
         _skin = GUIManager->_GetDefaultMenuSkin();
 
@@ -254,6 +257,9 @@ bool MenuWindow::_RecreateImage()
         _menu_image.AddImage(_skin->borders[1][1], left_border_size, bottom_border_size);
     }
 
+    // The borders don't overlap each other, so they can be drawn in any order.
+    const uint32_t first_border_element = _menu_image.GetNumElements();
+
     // First create the corners of the image
     float max_x = left_border_size + inum_x_tiles * top_width;
     float max_y = bottom_border_size + inum_y_tiles * left_height;
@@ -354,6 +360,9 @@ bool MenuWindow::_RecreateImage()
             _menu_image.AddImage(_skin->borders[1][1], max_x, bottom_border_size + left_height * tile_y);
     }
 
+    // Draw the tiles sharing a texture sheet in a row, so that they are batched.
+    _menu_image.SortElementsByTexture(first_border_element);
+
     return true;
 }
 
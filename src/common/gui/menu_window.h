@@ -217,12 +217,16 @@ public:
 
     //! \note This call is somewhat expensive since it has to recreate the menu window image.
     void SetEdgeVisibleFlags(int32_t flags) {
+        if(_edge_visible_flags == flags)
+            return;
         _edge_visible_flags = flags;
         _RecreateImage();
     }
 
     //! \note This call is somewhat expensive since it has to recreate the menu window image.
     void SetEdgeSharedFlags(int32_t flags) {
+        if(_edge_shared_flags == flags)
+            return;
         _edge_shared_flags = flags;
         _RecreateImage();
     }
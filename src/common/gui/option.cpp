@@ -55,7 +55,8 @@ Option::~Option()
 Option::Option(const Option &copy) :
     disabled(copy.disabled),
     elements(copy.elements),
-    text(copy.text)
+    text(copy.text),
+    text_images(copy.text_images)
 {
     if(copy.image == nullptr) {
         image = nullptr;
@@ -76,6 +77,7 @@ Option &Option::operator=(const Option &copy)
     disabled = copy.disabled;
     elements = copy.elements;
     text = copy.text;
+    text_images = copy.text_images;
     if(copy.image == nullptr) {
         image = nullptr;
     } else {
@@ -92,6 +94,7 @@ void Option::Clear()
     disabled = false;
     elements.clear();
     text.clear();
+    text_images.clear();
     if(image != nullptr) {
         delete image;
         image = nullptr;
@@ -117,6 +120,8 @@ OptionBox::OptionBox() :
     _enable_switching(false),
     _draw_left_column(0),
     _draw_top_row(0),
+    _released_left_column(0),
+    _released_top_row(0),
     _cursor_offset(0.0f, 0.0f),
     _scroll_offset(0.0f),
     _option_xalign(VIDEO_X_LEFT),
@@ -148,6 +153,9 @@ void OptionBox::Update(uint32_t frame_time)
     // Clear all of the events.
     _event = 0;
 
+    // Free the text of the options scrolled away.
+    _ReleaseFarOptionText();
+
     if (!_scrolling) {
         return;
     }
@@ -462,13 +470,34 @@ void OptionBox::AddOptionElementText(uint32_t option_index, const ustring &text)
     new_element.type = VIDEO_OPTION_ELEMENT_TEXT;
     new_element.value = static_cast<int32_t>(this_option.text.size());
 
-    TextImage text_image(text, _text_style);
-    this_option.text.push_back(text_image);
+    this_option.text.push_back(text);
+    this_option.text_images.clear();
     this_option.elements.push_back(new_element);
 }
 
 
 
+void OptionBox::SetOptionElementText(uint32_t option_index, uint32_t text_index, const ustring &text)
+{
+    if(option_index >= GetNumberOptions()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "out-of-range option_index argument: " << option_index << std::endl;
+        return;
+    }
+
+    Option &this_option = _options[option_index];
+    if(text_index >= this_option.text.size()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "out-of-range text_index argument: " << text_index << std::endl;
+        return;
+    }
+
+    this_option.text[text_index] = text;
+    // Only render the changed text again when the option text was already rendered.
+    if(text_index < this_option.text_images.size())
+        this_option.text_images[text_index].SetText(text);
+}
+
+
+
 void OptionBox::AddOptionElementImage(uint32_t option_index, const std::string &image_filename)
 {
     if(option_index >= GetNumberOptions()) {
@@ -824,10 +853,10 @@ void OptionBox::SetTextStyle(const TextStyle &style)
 
     _text_style = style;
 
-    // Update any existing TextImage texts with new font style
+    // Update any rendered TextImage texts with new font style
     for (uint32_t i = 0; i < _options.size(); ++i) {
-        for (uint32_t j = 0; j < _options[i].text.size(); ++j) {
-            _options[i].text[j].SetStyle(style);
+        for (uint32_t j = 0; j < _options[i].text_images.size(); ++j) {
+            _options[i].text_images[j].SetStyle(style);
         }
     }
 }
@@ -945,12 +974,10 @@ bool OptionBox::_ConstructOption(const ustring &format_string, Option &op)
             size_t tag_begin = tmp.find(OPEN_TAG);
 
             if(tag_begin == ustring::npos) {  // There are no more tags remaining, so extract the entire string
-                TextImage text_image(tmp, _text_style);
-                op.text.push_back(text_image);
+                op.text.push_back(tmp);
                 tmp.clear();
             } else { // Another tag remains to be processed, so extract the text substring
-                TextImage text_image(tmp.substr(0, tag_begin), _text_style);
-                op.text.push_back(text_image);
+                op.text.push_back(tmp.substr(0, tag_begin));
                 tmp = tmp.substr(tag_begin, tmp.length() - tag_begin);
             }
         }
@@ -963,6 +990,42 @@ bool OptionBox::_ConstructOption(const ustring &format_string, Option &op)
 
 
 
+void OptionBox::_RenderOptionText(Option &op)
+{
+    if (op.text_images.size() == op.text.size())
+        return;
+
+    op.text_images.clear();
+    op.text_images.reserve(op.text.size());
+    for (uint32_t i = 0; i < op.text.size(); ++i)
+        op.text_images.push_back(TextImage(op.text[i], _text_style));
+}
+
+
+
+void OptionBox::_ReleaseFarOptionText()
+{
+    if (_draw_top_row == _released_top_row && _draw_left_column == _released_left_column)
+        return;
+
+    _released_top_row = _draw_top_row;
+    _released_left_column = _draw_left_column;
+
+    // Keep the options of the visible cells, and of as many cells before and after them,
+    // so that scrolling back and forth doesn't render them again.
+    const uint32_t visible_cells = _number_cell_rows * _number_cell_columns;
+    const uint32_t first_visible = _draw_top_row * _number_cell_columns + _draw_left_column;
+    const uint32_t first_kept = first_visible > visible_cells ? first_visible - visible_cells : 0;
+    const uint32_t last_kept = first_visible + 2 * visible_cells;
+
+    for (uint32_t i = 0; i < _options.size(); ++i) {
+        if (i < first_kept || i > last_kept)
+            _options[i].text_images.clear();
+    }
+}
+
+
+
 bool OptionBox::_ChangeSelection(int32_t offset, bool horizontal)
 {
     // Do nothing if the movement is horizontal and there is only one column with no horizontal wrap shifting
@@ -1232,7 +1295,7 @@ void OptionBox::_DetermineScrollArrows()
 
 
 
-void OptionBox::_DrawOption(const Option &op, const OptionCellBounds &bounds, float &left_edge)
+void OptionBox::_DrawOption(Option &op, const OptionCellBounds &bounds, float &left_edge)
 {
     float x, y;
     int32_t xalign = _option_xalign;
@@ -1284,7 +1347,9 @@ void OptionBox::_DrawOption(const Option &op, const OptionCellBounds &bounds, fl
             int32_t text_index = op.elements[element].value;
 
             if(text_index >= 0 && text_index < static_cast<int32_t>(op.text.size())) {
-                float width = op.text[text_index].GetWidth();
+                _RenderOptionText(op);
+                const TextImage& text_image = op.text_images[text_index];
+                float width = text_image.GetWidth();
                 float edge = x - bounds.x_left; // edge value for VIDEO_X_LEFT
 
                 if(xalign == VIDEO_X_CENTER)
@@ -1296,9 +1361,9 @@ void OptionBox::_DrawOption(const Option &op, const OptionCellBounds &bounds, fl
                     left_edge = edge;
 
                 if(op.disabled)
-                    op.text[text_index].Draw(Color::gray);
+                    text_image.Draw(Color::gray);
                 else
-                    op.text[text_index].Draw();
+                    text_image.Draw();
             }
 
             break;
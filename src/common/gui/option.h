@@ -213,8 +213,14 @@ public:
     //! \brief The elements that this option is composed of
     std::vector<OptionElement> elements;
 
-    //! \brief Contains all pieces of text for this option (as pre-rendered images)
-    std::vector<vt_video::TextImage> text;
+    //! \brief Contains all pieces of text for this option
+    std::vector<vt_utils::ustring> text;
+
+    /** \brief The pieces of text rendered as images, one for each text piece.
+    *** They are only rendered once the option is drawn, and released by the option
+    *** box when it is scrolled far away, so that it is empty most of the time.
+    **/
+    std::vector<vt_video::TextImage> text_images;
 
     //! \brief Contains all images used for this option
     vt_video::StillImage *image;
@@ -300,6 +306,14 @@ public:
     **/
     void AddOptionElementText(uint32_t option_index, const vt_utils::ustring &text);
 
+    /** \brief Replaces the string of a text element of an existing option
+    *** \param option_index The index of the option to change the text element of
+    *** \param text_index The index of the text element among the option ones, in the order they were added
+    *** \param text The unicode string replacing the text, treated as pure text
+    *** \note Unlike SetOptionText(), the other elements are kept and only this text is rendered again.
+    **/
+    void SetOptionElementText(uint32_t option_index, uint32_t text_index, const vt_utils::ustring &text);
+
     /** \brief Appends an image element to an existing option
     *** \param option_index The index of the option to append the image element to
     *** \param filename The name of the image file to load for use in this option
@@ -540,6 +554,9 @@ private:
     //! \brief The column of row of data that is drawn in the top-left cell
     uint32_t _draw_left_column, _draw_top_row;
 
+    //! \brief The top row and left column when the text images far from them were last released
+    uint32_t _released_left_column, _released_top_row;
+
     //! \brief Retains the x and y offsets for where the cursor should be drawn relative to the selected option
     vt_common::Position2D _cursor_offset;
 
@@ -609,6 +626,15 @@ private:
     **/
     bool _ConstructOption(const vt_utils::ustring &format_string, private_gui::Option &option);
 
+    //! \brief Renders the text images of an option, if not done yet.
+    void _RenderOptionText(private_gui::Option &option);
+
+    /** \brief Releases the text images of the options far from the visible ones.
+    *** Only done once the option box was scrolled, so that long lists keep
+    *** a few rendered text images only.
+    **/
+    void _ReleaseFarOptionText();
+
     /** \brief Changes the selected option by making a movement relative to the current selection
     *** \param offset The amount to move in specified direction (ie 1 row up, 1 column right, etc.)
     *** \param horizontal true if moving horizontally, false if moving vertically
@@ -645,7 +671,7 @@ private:
     *** \param bounds The boundary coordinates for the information cell
     *** \param left_edge Returns a coordinate that represents the left edge of the cell content (as opposed to strictly the cell boundary)
     **/
-    void _DrawOption(const private_gui::Option &op, const private_gui::OptionCellBounds &bounds, float &left_edge);
+    void _DrawOption(private_gui::Option &op, const private_gui::OptionCellBounds &bounds, float &left_edge);
 
     /** \brief Draws the cursor
     *** \param op The option contents to draw within the cell
@@ -226,11 +226,26 @@ void TextBox::SetDisplayText(const ustring &text)
 
 }
 
+void TextBox::PrepareText(const ustring &text)
+{
+    // The instant mode renders the whole text in a single image instead.
+    if(text.empty() || _mode == VIDEO_TEXT_INSTANT)
+        return;
+
+    FontProperties* fp = _text_style.GetFontProperties();
+    if(fp == nullptr || fp->ttf_font == nullptr)
+        return;
+
+    TextManager->WrapText(text, fp->ttf_font, _width);
+    TextManager->PrepareGlyphs(text, _text_style);
+}
+
 void TextBox::_ReformatText()
 {
     // Go through the text ustring and determine where the newline characters can be found,
     // examining one line at a time and adding it to the _text vector.
     _text.clear();
+    _char_offsets.clear();
     _num_chars = 0;
 
     FontProperties* fp = _text_style.GetFontProperties();
@@ -261,6 +276,11 @@ void TextBox::_ReformatText()
             startline_pos = newline_pos + 1;
         }
         _num_chars = _text_save.length() - new_lines;
+
+        // Cache the characters offsets, so that drawing the text doesn't need to measure it.
+        _char_offsets.resize(_text.size());
+        for (size_t line = 0; line < _text.size(); ++line)
+            TextManager->CalculateCharOffsets(fp->ttf_font, _text[line], _char_offsets[line]);
     }
 
     // Update the scissor cache.
@@ -338,7 +358,6 @@ float TextBox::_CalculateTextHeight()
 void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect)
 {
     FontProperties* fp = _text_style.GetFontProperties();
-    TTF_Font* ttf_font = fp->ttf_font;
     int32_t num_chars_drawn = 0;
 
     // Calculate the fraction of the text to display
@@ -351,7 +370,8 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
     // Iterate through the loop for every line of text and draw it
     for(int32_t line = 0; line < static_cast<int32_t>(_text.size()); ++line) {
         // (1): Calculate the x draw offset for this line and move to that position
-        float line_width = static_cast<float>(TextManager->CalculateTextWidth(ttf_font, _text[line]));
+        const std::vector<float>& char_offsets = _char_offsets[line];
+        float line_width = char_offsets.back();
         int32_t x_align = VideoManager->_ConvertXAlign(_text_xalign);
         float x_offset = text_x + ((x_align + 1) * line_width) * 0.5f * VideoManager->_current_context.coordinate_system.GetHorizontalDirection();
 
@@ -374,10 +394,8 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
             // The current character to draw is on this line: figure out which characters on this line should be drawn
             else {
                 int32_t num_completed_chars = cur_char - num_chars_drawn;
-                if(num_completed_chars > 0) {
-                    ustring substring = _text[line].substr(0, num_completed_chars);
-                    TextManager->Draw(substring);
-                }
+                if(num_completed_chars > 0)
+                    TextManager->Draw(_text[line], 0, num_completed_chars, _text_style);
             }
         } // else if (_mode == VIDEO_TEXT_CHAR)
 
@@ -397,13 +415,9 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
 
                 // Continue only if this line has at least one character that should be drawn
                 if(num_completed_chars >= 0) {
-                    ustring substring;
-
                     // Draw any fully completed characters at full opacity
-                    if(num_completed_chars > 0) {
-                        substring = _text[line].substr(0, num_completed_chars);
-                        TextManager->Draw(substring, _text_style);
-                    }
+                    if(num_completed_chars > 0)
+                        TextManager->Draw(_text[line], 0, num_completed_chars, _text_style);
 
                     // Draw the current character that is being faded in at the appropriate alpha level
                     Color saved_color = _text_style.GetColor();
@@ -411,8 +425,8 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
                     current_color[3] *= cur_percent;
                     _text_style.SetColor(current_color);
 
-                    VideoManager->MoveRelative(static_cast<float>(TextManager->CalculateTextWidth(ttf_font, substring)), 0.0f);
-                    TextManager->Draw(_text[line].substr(num_completed_chars, 1), _text_style);
+                    VideoManager->MoveRelative(char_offsets[num_completed_chars], 0.0f);
+                    TextManager->Draw(_text[line], num_completed_chars, 1, _text_style);
                     _text_style.SetColor(saved_color);
                 }
             }
@@ -453,21 +467,17 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
             }
             // If the line contains the current character, draw all previous characters as well as the current one
             else if(num_completed_chars >= 0) {
-                ustring substring;
-
                 // If there are already completed characters on this line, draw them in full
-                if(num_completed_chars > 0) {
-                    substring = _text[line].substr(0, num_completed_chars);
-                    TextManager->Draw(substring, _text_style);
-                }
+                if(num_completed_chars > 0)
+                    TextManager->Draw(_text[line], 0, num_completed_chars, _text_style);
 
                 // Now draw the current character from the line, partially scissored according to the amount that is complete
-                ustring cur_char_string = _text[line].substr(num_completed_chars, 1);
+                const float completed_width = char_offsets[num_completed_chars];
 
                 // Create a rectangle for the current character, in window coordinates
                 int32_t char_x, char_y, char_w, char_h;
                 char_x = static_cast<int32_t>(x_offset + VideoManager->_current_context.coordinate_system.GetHorizontalDirection()
-                                            * TextManager->CalculateTextWidth(ttf_font, substring));
+                                            * completed_width);
                 char_y = static_cast<int32_t>(text_y - VideoManager->_current_context.coordinate_system.GetVerticalDirection()
                                             * (fp->height + fp->descent));
 
@@ -477,13 +487,13 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
                 if(VideoManager->_current_context.coordinate_system.GetVerticalDirection() < 0.0f)
                     char_x = static_cast<int32_t>(VideoManager->_current_context.coordinate_system.GetLeft()) - char_x;
 
-                char_w = TextManager->CalculateTextWidth(ttf_font, cur_char_string);
+                char_w = static_cast<int32_t>(char_offsets[num_completed_chars + 1] - completed_width);
                 char_h = fp->height;
 
                 // Multiply the width by percentage done to determine the scissoring dimensions
                 char_w = static_cast<int32_t>(cur_percent * char_w);
                 VideoManager->MoveRelative(VideoManager->_current_context.coordinate_system.GetHorizontalDirection()
-                                           * TextManager->CalculateTextWidth(ttf_font, substring), 0.0f);
+                                           * completed_width, 0.0f);
 
                 // Construct the scissor rectangle using the character dimensions and draw the revealing character.
                 VideoManager->PushState();
@@ -500,7 +510,7 @@ void TextBox::_DrawTextLines(float text_x, float text_y, ScreenRect scissor_rect
                 scissor_rect.height = static_cast<int32_t>(scissor_rect.height / VIDEO_STANDARD_RES_HEIGHT * VideoManager->_current_context.viewport.height);
                 VideoManager->SetScissorRect(scissor_rect);
 
-                TextManager->Draw(cur_char_string, _text_style);
+                TextManager->Draw(_text[line], num_completed_chars, 1, _text_style);
 
                 VideoManager->PopState();
             }
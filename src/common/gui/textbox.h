@@ -153,6 +153,12 @@ public:
     **/
     void SetDisplayText(const std::string &text);
 
+    /** \brief Lays a text out ahead of time, so that displaying it later doesn't stall.
+    *** \param text The text to be displayed later on in the box.
+    *** The wrapped lines end up in the text layout cache, and the glyphs in the glyph atlas.
+    **/
+    void PrepareText(const vt_utils::ustring &text);
+
     /** \brief Retrieve the current x and y alignments for the text
     *** \param xalign The member to hold the x alignment (e.g. VIDEO_X_LEFT).
     *** \param yalign The member to hold the y alignment (e.g. VIDEO_Y_TOP).
@@ -228,6 +234,10 @@ private:
     //! \brief An array of wide strings, one for each line of text.
     std::vector<vt_utils::ustring> _text;
 
+    //! \brief The x offset of each character of each line, in pixels from the line start.
+    //! Each line has one more offset, the line width. Recomputed in _ReformatText().
+    std::vector<std::vector<float> > _char_offsets;
+
     //! \brief The unedited text for reformatting
     vt_utils::ustring _text_save;
 
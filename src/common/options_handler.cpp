@@ -20,6 +20,8 @@
 #include "engine/system.h"
 #include "engine/input.h"
 #include "engine/audio/audio.h"
+#include "engine/hitch_recorder.h"
+#include "engine/performance_telemetry.h"
 #include "script/script_write.h"
 
 #include "engine/mode_manager.h"
@@ -132,6 +134,24 @@ void OptionMenu::InputRight()
 }
 
 const uint16_t SKIN_MENU_INDEX = 4;
+const uint16_t UPSCALING_MENU_INDEX = 5;
+
+//! \brief The performance options menu indices.
+const uint16_t GRAPHICS_QUALITY_MENU_INDEX = 0;
+const uint16_t RENDER_SCALE_MENU_INDEX = 1;
+const uint16_t PARTICLE_DENSITY_MENU_INDEX = 2;
+const uint16_t LIGHT_FLARES_MENU_INDEX = 3;
+const uint16_t AMBIENT_OVERLAYS_MENU_INDEX = 4;
+const uint16_t FRAME_CAP_MENU_INDEX = 5;
+const uint16_t TELEMETRY_MENU_INDEX = 6;
+
+//! \brief The frame caps offered, in frames per second.
+const uint32_t FRAME_CAPS[] = { VIDEO_FRAME_CAP_NONE, 30, 60, 120 };
+const uint32_t FRAME_CAP_COUNT = sizeof(FRAME_CAPS) / sizeof(FRAME_CAPS[0]);
+
+//! \brief The graphics quality presets offered, in order. The custom one is set by changing a setting.
+const uint32_t GRAPHICS_QUALITIES[] = { VIDEO_QUALITY_LOW, VIDEO_QUALITY_MEDIUM, VIDEO_QUALITY_HIGH, VIDEO_QUALITY_AUTO };
+const uint32_t GRAPHICS_QUALITY_COUNT = sizeof(GRAPHICS_QUALITIES) / sizeof(GRAPHICS_QUALITIES[0]);
 
 GameOptionsMenuHandler::GameOptionsMenuHandler(vt_mode_manager::GameMode* parent_mode):
     _first_run(false),
@@ -158,6 +178,7 @@ GameOptionsMenuHandler::GameOptionsMenuHandler(vt_mode_manager::GameMode* parent
     _SetupKeySettingsMenu();
     _SetupJoySettingsMenu();
     _SetupResolutionMenu();
+    _SetupPerformanceOptionsMenu();
 
     // make sure message window is not visible
     _message_window.Hide();
@@ -325,6 +346,8 @@ void GameOptionsMenuHandler::Update()
             _active_menu = &_options_menu;
         } else if(_active_menu == &_resolution_menu) {
             _active_menu = &_video_options_menu;
+        } else if(_active_menu == &_performance_options_menu) {
+            _active_menu = &_video_options_menu;
         }
 
         // Play cancel sound
@@ -364,6 +387,7 @@ void GameOptionsMenuHandler::ReloadTranslatableMenus()
     _SetupKeySettingsMenu();
     _SetupJoySettingsMenu();
     _SetupResolutionMenu();
+    _SetupPerformanceOptionsMenu();
 
     // Make the parent game mode reload its translated text
     if (_parent_mode)
@@ -410,7 +434,7 @@ void GameOptionsMenuHandler::_SetupVideoOptionsMenu()
 {
     _video_options_menu.ClearOptions();
     _video_options_menu.SetPosition(512.0f, 338.0f);
-    _video_options_menu.SetDimensions(350.0f, 400.0f, 1, 6, 1, 6);
+    _video_options_menu.SetDimensions(350.0f, 460.0f, 1, 7, 1, 7);
     _video_options_menu.SetTextStyle(TextStyle("title22"));
     _video_options_menu.SetAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
     _video_options_menu.SetOptionAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
@@ -430,10 +454,44 @@ void GameOptionsMenuHandler::_SetupVideoOptionsMenu()
                                   &GameOptionsMenuHandler::_OnChangeVSyncRight);
     _video_options_menu.AddOption(UTranslate("UI Theme: "), this, &GameOptionsMenuHandler::_OnUIThemeRight, nullptr, nullptr,
                                   &GameOptionsMenuHandler::_OnUIThemeLeft, &GameOptionsMenuHandler::_OnUIThemeRight);
+    _video_options_menu.AddOption(UTranslate("Upscaling: "), this, &GameOptionsMenuHandler::_OnToggleSharpUpscaling, nullptr, nullptr,
+                                  &GameOptionsMenuHandler::_OnToggleSharpUpscaling, &GameOptionsMenuHandler::_OnToggleSharpUpscaling);
+    _video_options_menu.AddOption(UTranslate("Performance"), this, &GameOptionsMenuHandler::_OnPerformanceOptions);
 
     _video_options_menu.SetSelection(0);
 }
 
+void GameOptionsMenuHandler::_SetupPerformanceOptionsMenu()
+{
+    _performance_options_menu.ClearOptions();
+    _performance_options_menu.SetPosition(512.0f, 338.0f);
+    _performance_options_menu.SetDimensions(350.0f, 400.0f, 1, 7, 1, 7);
+    _performance_options_menu.SetTextStyle(TextStyle("title22"));
+    _performance_options_menu.SetAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
+    _performance_options_menu.SetOptionAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
+    _performance_options_menu.SetSelectMode(VIDEO_SELECT_SINGLE);
+    _performance_options_menu.SetVerticalWrapMode(VIDEO_WRAP_MODE_STRAIGHT);
+    _performance_options_menu.SetCursorOffset(-50.0f, -28.0f);
+    _performance_options_menu.SetSkipDisabled(true);
+
+    _performance_options_menu.AddOption(UTranslate("Quality: "), this, &GameOptionsMenuHandler::_OnGraphicsQualityRight, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnGraphicsQualityLeft, &GameOptionsMenuHandler::_OnGraphicsQualityRight);
+    _performance_options_menu.AddOption(UTranslate("Render Scale: "), this, &GameOptionsMenuHandler::_OnRenderScaleRight, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnRenderScaleLeft, &GameOptionsMenuHandler::_OnRenderScaleRight);
+    _performance_options_menu.AddOption(UTranslate("Particles: "), this, &GameOptionsMenuHandler::_OnParticleDensityRight, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnParticleDensityLeft, &GameOptionsMenuHandler::_OnParticleDensityRight);
+    _performance_options_menu.AddOption(UTranslate("Light Effects: "), this, &GameOptionsMenuHandler::_OnToggleLightFlares, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnToggleLightFlares, &GameOptionsMenuHandler::_OnToggleLightFlares);
+    _performance_options_menu.AddOption(UTranslate("Ambient Overlays: "), this, &GameOptionsMenuHandler::_OnToggleAmbientOverlays, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnToggleAmbientOverlays, &GameOptionsMenuHandler::_OnToggleAmbientOverlays);
+    _performance_options_menu.AddOption(UTranslate("Frame Cap: "), this, &GameOptionsMenuHandler::_OnFrameCapRight, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnFrameCapLeft, &GameOptionsMenuHandler::_OnFrameCapRight);
+    _performance_options_menu.AddOption(UTranslate("Telemetry: "), this, &GameOptionsMenuHandler::_OnToggleTelemetry, nullptr, nullptr,
+                                        &GameOptionsMenuHandler::_OnToggleTelemetry, &GameOptionsMenuHandler::_OnToggleTelemetry);
+
+    _performance_options_menu.SetSelection(0);
+}
+
 void GameOptionsMenuHandler::_SetupAudioOptionsMenu()
 {
     _audio_options_menu.ClearOptions();
@@ -714,6 +772,69 @@ void GameOptionsMenuHandler::_RefreshVideoOptions()
 
     // Update the UI theme.
     _video_options_menu.SetOptionText(SKIN_MENU_INDEX, UTranslate("UI Theme: ") + GUIManager->GetDefaultMenuSkinName());
+
+    /// tr: Do not translate the part before the '|'.
+    /// It is used for contextual translation support.
+    std::string upscaling_str = VideoManager->IsSharpUpscaling() ?
+        CTranslate("Upscaling|Sharp") : CTranslate("Upscaling|Smooth");
+    _video_options_menu.SetOptionText(UPSCALING_MENU_INDEX, UTranslate("Upscaling: ") + MakeUnicodeString(upscaling_str));
+}
+
+void GameOptionsMenuHandler::_RefreshPerformanceOptions()
+{
+    // Update the graphics quality preset.
+    std::string quality_str;
+    /// tr: Do not translate the part before the '|'.
+    /// It is used for contextual translation support.
+    switch(VideoManager->GetGraphicsQuality()) {
+    default:
+    case VIDEO_QUALITY_CUSTOM:
+        quality_str = CTranslate("Graphics_quality|Custom");
+        break;
+    case VIDEO_QUALITY_LOW:
+        quality_str = CTranslate("Graphics_quality|Low");
+        break;
+    case VIDEO_QUALITY_MEDIUM:
+        quality_str = CTranslate("Graphics_quality|Medium");
+        break;
+    case VIDEO_QUALITY_HIGH:
+        quality_str = CTranslate("Graphics_quality|High");
+        break;
+    case VIDEO_QUALITY_AUTO:
+        quality_str = CTranslate("Graphics_quality|Auto");
+        break;
+    }
+    _performance_options_menu.SetOptionText(GRAPHICS_QUALITY_MENU_INDEX, UTranslate("Quality: ") + MakeUnicodeString(quality_str));
+
+    // Update the resolution the game world is drawn at.
+    uint32_t render_scale = VideoManager->GetRenderScale();
+    if (render_scale == VIDEO_RENDER_SCALE_DYNAMIC)
+        _performance_options_menu.SetOptionText(RENDER_SCALE_MENU_INDEX, UTranslate("Render Scale: ") + UTranslate("Dynamic"));
+    else
+        _performance_options_menu.SetOptionText(RENDER_SCALE_MENU_INDEX, UTranslate("Render Scale: ")
+                                                + MakeUnicodeString(NumberToString(render_scale) + " %"));
+
+    _performance_options_menu.SetOptionText(PARTICLE_DENSITY_MENU_INDEX, UTranslate("Particles: ")
+                                            + MakeUnicodeString(NumberToString(VideoManager->GetParticleDensity()) + " %"));
+
+    /// tr: Do not translate the part before the '|'.
+    /// It is used for contextual translation support.
+    std::string light_str = VideoManager->AreLightFlaresEnabled() ?
+        CTranslate("Light_effects|Full") : CTranslate("Light_effects|Simple");
+    _performance_options_menu.SetOptionText(LIGHT_FLARES_MENU_INDEX, UTranslate("Light Effects: ") + MakeUnicodeString(light_str));
+
+    _performance_options_menu.SetOptionText(AMBIENT_OVERLAYS_MENU_INDEX, UTranslate("Ambient Overlays: ")
+                                            + UTranslate(VideoManager->AreAmbientOverlaysEnabled() ? "Enabled" : "Disabled"));
+
+    uint32_t frame_cap = VideoManager->GetFrameCap();
+    if (frame_cap == VIDEO_FRAME_CAP_NONE)
+        _performance_options_menu.SetOptionText(FRAME_CAP_MENU_INDEX, UTranslate("Frame Cap: ") + UTranslate("Display"));
+    else
+        _performance_options_menu.SetOptionText(FRAME_CAP_MENU_INDEX, UTranslate("Frame Cap: ")
+                                                + MakeUnicodeString(VTranslate("%u FPS", frame_cap)));
+
+    _performance_options_menu.SetOptionText(TELEMETRY_MENU_INDEX, UTranslate("Telemetry: ")
+                                            + UTranslate(vt_system::PerformanceTelemetry::IsEnabled() ? "Enabled" : "Disabled"));
 }
 
 void GameOptionsMenuHandler::_RefreshLanguageOptions()
@@ -936,6 +1057,147 @@ void GameOptionsMenuHandler::_OnChangeVSyncRight()
     _has_modified_settings = true;
 }
 
+void GameOptionsMenuHandler::_OnRenderScaleLeft()
+{
+    // The dynamic scale follows the lowest one.
+    uint32_t render_scale = VideoManager->GetRenderScale();
+    if (render_scale == VIDEO_RENDER_SCALE_DYNAMIC)
+        render_scale = VIDEO_RENDER_SCALE_MAX;
+    else if (render_scale == VIDEO_RENDER_SCALE_MIN)
+        render_scale = VIDEO_RENDER_SCALE_DYNAMIC;
+    else
+        render_scale -= VIDEO_RENDER_SCALE_STEP;
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetRenderScale(render_scale);
+    VideoManager->ApplySettings();
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnRenderScaleRight()
+{
+    uint32_t render_scale = VideoManager->GetRenderScale();
+    if (render_scale == VIDEO_RENDER_SCALE_DYNAMIC)
+        render_scale = VIDEO_RENDER_SCALE_MIN;
+    else if (render_scale == VIDEO_RENDER_SCALE_MAX)
+        render_scale = VIDEO_RENDER_SCALE_DYNAMIC;
+    else
+        render_scale += VIDEO_RENDER_SCALE_STEP;
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetRenderScale(render_scale);
+    VideoManager->ApplySettings();
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnToggleSharpUpscaling()
+{
+    VideoManager->SetSharpUpscaling(!VideoManager->IsSharpUpscaling());
+    VideoManager->ApplySettings();
+    _RefreshVideoOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnPerformanceOptions()
+{
+    _active_menu = &_performance_options_menu;
+    _RefreshPerformanceOptions();
+}
+
+void GameOptionsMenuHandler::_OnGraphicsQualityLeft()
+{
+    // The custom settings cycle from the last preset.
+    uint32_t index = 0;
+    while (index < GRAPHICS_QUALITY_COUNT && GRAPHICS_QUALITIES[index] != VideoManager->GetGraphicsQuality())
+        ++index;
+    index = (index == 0 || index >= GRAPHICS_QUALITY_COUNT) ? GRAPHICS_QUALITY_COUNT - 1 : index - 1;
+    VideoManager->SetGraphicsQuality(GRAPHICS_QUALITIES[index]);
+    VideoManager->ApplySettings();
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnGraphicsQualityRight()
+{
+    // The custom settings cycle from the first preset.
+    uint32_t index = 0;
+    while (index < GRAPHICS_QUALITY_COUNT && GRAPHICS_QUALITIES[index] != VideoManager->GetGraphicsQuality())
+        ++index;
+    index = (index + 1 >= GRAPHICS_QUALITY_COUNT) ? 0 : index + 1;
+    VideoManager->SetGraphicsQuality(GRAPHICS_QUALITIES[index]);
+    VideoManager->ApplySettings();
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnParticleDensityLeft()
+{
+    uint32_t density = VideoManager->GetParticleDensity();
+    density = (density > VIDEO_PARTICLE_DENSITY_MIN) ? density - VIDEO_PARTICLE_DENSITY_STEP : VIDEO_PARTICLE_DENSITY_MAX;
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetParticleDensity(density);
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnParticleDensityRight()
+{
+    uint32_t density = VideoManager->GetParticleDensity();
+    density = (density < VIDEO_PARTICLE_DENSITY_MAX) ? density + VIDEO_PARTICLE_DENSITY_STEP : VIDEO_PARTICLE_DENSITY_MIN;
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetParticleDensity(density);
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnToggleLightFlares()
+{
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetLightFlares(!VideoManager->AreLightFlaresEnabled());
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnToggleAmbientOverlays()
+{
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetAmbientOverlays(!VideoManager->AreAmbientOverlaysEnabled());
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnFrameCapLeft()
+{
+    uint32_t index = 0;
+    while (index < FRAME_CAP_COUNT && FRAME_CAPS[index] != VideoManager->GetFrameCap())
+        ++index;
+    index = (index == 0 || index >= FRAME_CAP_COUNT) ? FRAME_CAP_COUNT - 1 : index - 1;
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetFrameCap(FRAME_CAPS[index]);
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnFrameCapRight()
+{
+    uint32_t index = 0;
+    while (index < FRAME_CAP_COUNT && FRAME_CAPS[index] != VideoManager->GetFrameCap())
+        ++index;
+    index = (index + 1 >= FRAME_CAP_COUNT) ? 0 : index + 1;
+    VideoManager->SetGraphicsQuality(VIDEO_QUALITY_CUSTOM);
+    VideoManager->SetFrameCap(FRAME_CAPS[index]);
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
+void GameOptionsMenuHandler::_OnToggleTelemetry()
+{
+    // Not a graphics setting: The quality preset is kept.
+    vt_system::PerformanceTelemetry::SetEnabled(!vt_system::PerformanceTelemetry::IsEnabled());
+    _RefreshPerformanceOptions();
+    _has_modified_settings = true;
+}
+
 void GameOptionsMenuHandler::_OnUIThemeLeft()
 {
     GUIManager->SetPreviousDefaultMenuSkin();
@@ -1166,6 +1428,37 @@ void GameOptionsMenuHandler::_UpdateExplanationText()
         case 4:
             _explanation_window.SetText(UTranslate("Permits to change the in-game GUI theme."));
             break;
+        case 6:
+            _explanation_window.SetText(UTranslate("Here you can trade the visual effects for a smoother frame rate on slower computers."));
+            break;
+        default:
+            _explanation_window.Hide();
+            break;
+        }
+    }
+    else if (_active_menu == &_performance_options_menu) {
+        switch(_performance_options_menu.GetSelection()) {
+        case GRAPHICS_QUALITY_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Sets all the options below at once. Auto lowers the effects while the game runs too slowly, and raises them back once it runs smoothly."));
+            break;
+        case RENDER_SCALE_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Sets the resolution the game world is drawn at. Dynamic lowers it only while the graphics card is too slow."));
+            break;
+        case PARTICLE_DENSITY_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Sets the share of the particles the fire, smoke and magic effects may emit."));
+            break;
+        case LIGHT_FLARES_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Sets whether the lights draw their lens flares."));
+            break;
+        case AMBIENT_OVERLAYS_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Sets whether the fog and clouds are drawn over the maps."));
+            break;
+        case FRAME_CAP_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Caps the frame rate, even with the vertical synchronization, to save power and keep it steady."));
+            break;
+        case TELEMETRY_MENU_INDEX:
+            _explanation_window.SetText(UTranslate("Saves the frame rates of each map and battle in performance_telemetry.json, which you may share to help optimizing the game. Nothing is sent."));
+            break;
         default:
             _explanation_window.Hide();
             break;
@@ -1308,6 +1601,26 @@ bool GameOptionsMenuHandler::_SaveSettingsFile(const std::string& filename)
     settings_lua.WriteBool("full_screen", VideoManager->IsFullscreen());
     settings_lua.WriteComment("Get the desired VSync mode. 0: No VSync, 1: VSync, 2: Swap Tearing");
     settings_lua.WriteUInt("vsync_mode", VideoManager->GetVSyncMode());
+    settings_lua.WriteComment("The resolution the game world is drawn at, in percents of the screen one: [50 - 100], 0: Dynamic");
+    settings_lua.WriteUInt("render_scale", VideoManager->GetRenderScale());
+    settings_lua.WriteComment("Upscale the game world with its nearest pixels rather than bilinearly");
+    settings_lua.WriteBool("sharp_upscaling", VideoManager->IsSharpUpscaling());
+    settings_lua.WriteComment("The graphics quality preset. 0: Custom, 1: Low, 2: Medium, 3: High, 4: Auto");
+    settings_lua.WriteUInt("graphics_quality", VideoManager->GetGraphicsQuality());
+    settings_lua.WriteComment("The custom settings: The share of the particles emitted: [25 - 100],");
+    settings_lua.WriteComment("the light flares and ambient overlays, and the frame cap in FPS, 0: The display one");
+    settings_lua.WriteUInt("particle_density", VideoManager->GetParticleDensity());
+    settings_lua.WriteBool("light_flares", VideoManager->AreLightFlaresEnabled());
+    settings_lua.WriteBool("ambient_overlays", VideoManager->AreAmbientOverlaysEnabled());
+    settings_lua.WriteUInt("frame_cap", VideoManager->GetFrameCap());
+    settings_lua.WriteComment("The KiB of images reuploaded per frame when the texture sheets are reloaded, 0: All at once");
+    settings_lua.WriteUInt("texture_upload_budget", TextureManager->GetUploadBudget() / 1024);
+    settings_lua.WriteComment("The video memory in MiB the texture sheets may use before the unused ones are evicted, 0: No limit");
+    settings_lua.WriteUInt("texture_memory_budget", TextureManager->GetTextureMemoryBudget() / (1024 * 1024));
+    settings_lua.WriteComment("The frame duration in milliseconds beyond which a report is written in the hitches folder, 0: Never");
+    settings_lua.WriteUInt("hitch_threshold", vt_system::HitchRecorder::GetThreshold());
+    settings_lua.WriteComment("Whether the frame rates, loading times and memory peaks are saved in performance_telemetry.json");
+    settings_lua.WriteBool("performance_telemetry", vt_system::PerformanceTelemetry::IsEnabled());
     settings_lua.WriteComment("The UI Theme to load.");
     settings_lua.WriteString("ui_theme", GUIManager->GetDefaultMenuSkinId());
     settings_lua.EndTable(); // video_settings
@@ -175,6 +175,7 @@ private:
     OptionMenu _options_menu;
     OptionMenu _video_options_menu;
     OptionMenu _resolution_menu;
+    OptionMenu _performance_options_menu;
     OptionMenu _audio_options_menu;
     OptionMenu _game_options_menu;
     OptionMenu _language_options_menu;
@@ -219,9 +220,11 @@ private:
     void _SetupKeySettingsMenu();
     void _SetupJoySettingsMenu();
     void _SetupResolutionMenu();
+    void _SetupPerformanceOptionsMenu();
 
     //! \brief Refreshes the option text displays on various option menus
     void _RefreshVideoOptions();
+    void _RefreshPerformanceOptions();
     void _RefreshAudioOptions();
     void _RefreshGameOptions();
     void _RefreshLanguageOptions();
@@ -248,6 +251,23 @@ private:
     void _OnChangeVSyncRight();
     void _OnUIThemeLeft();
     void _OnUIThemeRight();
+    void _OnRenderScaleLeft();
+    void _OnRenderScaleRight();
+    void _OnToggleSharpUpscaling();
+    void _OnPerformanceOptions();
+    //@}
+
+    //! \brief Handler methods for the performance options menu
+    //@{
+    void _OnGraphicsQualityLeft();
+    void _OnGraphicsQualityRight();
+    void _OnParticleDensityLeft();
+    void _OnParticleDensityRight();
+    void _OnToggleLightFlares();
+    void _OnToggleAmbientOverlays();
+    void _OnFrameCapLeft();
+    void _OnFrameCapRight();
+    void _OnToggleTelemetry();
     //@}
 
     //! \brief Handler methods for the audio options menu
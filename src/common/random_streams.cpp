@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    random_streams.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the seedable random number streams.
+*** ***************************************************************************/
+
+#include "common/random_streams.h"
+
+#include <cassert>
+
+namespace vt_common
+{
+
+//! \brief Returns the next value of a splitmix64 sequence, used to expand the seeds.
+static uint64_t _SplitMix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void RandomStream::Seed(uint64_t seed)
+{
+    // The state must never be all zeros, which splitmix64 can't give for two values in a row.
+    uint64_t splitmix_state = seed;
+    const uint64_t first = _SplitMix64(splitmix_state);
+    const uint64_t second = _SplitMix64(splitmix_state);
+    _state[0] = static_cast<uint32_t>(first);
+    _state[1] = static_cast<uint32_t>(first >> 32);
+    _state[2] = static_cast<uint32_t>(second);
+    _state[3] = static_cast<uint32_t>(second >> 32);
+}
+
+int32_t RandomStream::BoundedInteger(int32_t lower, int32_t upper)
+{
+    if (lower > upper) {
+        const int32_t swap = lower;
+        lower = upper;
+        upper = swap;
+    }
+
+    // Mapping the 32 bits onto the range keeps the bias negligible for the small ranges used.
+    const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(upper) - lower) + 1;
+    return static_cast<int32_t>(lower + static_cast<int64_t>((NextUInt32() * range) >> 32));
+}
+
+void RandomStream::Floats(float *values, uint32_t count, float a, float b)
+{
+    const float scale = (b - a) / 16777216.0f;
+    for (uint32_t i = 0; i < count; ++i)
+        values[i] = a + static_cast<float>(NextUInt32() >> 8) * scale;
+}
+
+//! \brief The streams of the subsystems, and the seed they were derived from.
+static RandomStream _streams[RANDOM_STREAM_TOTAL];
+static uint64_t _seed = 0;
+static bool _seeded = false;
+
+void SeedRandomStreams(uint64_t seed)
+{
+    // Each stream gets its own seed, so that drawing more numbers in a subsystem
+    // doesn't change the numbers drawn by the others.
+    RandomStream seeds(seed);
+    for (uint32_t i = 0; i < RANDOM_STREAM_TOTAL; ++i)
+        _streams[i].Seed(seeds.NextUInt64());
+
+    _seed = seed;
+    _seeded = true;
+}
+
+uint64_t GetRandomSeed()
+{
+    return _seed;
+}
+
+RandomStream &GetRandomStream(RandomStreamType type)
+{
+    assert(type >= 0 && type < RANDOM_STREAM_TOTAL);
+    if (!_seeded)
+        SeedRandomStreams(0);
+    return _streams[type];
+}
+
+} // namespace vt_common
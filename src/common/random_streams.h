@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    random_streams.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the seedable random number streams.
+***
+*** The engine code drawing many random numbers doesn't go through rand(),
+*** which is slow, shared by everything and can't be used from several threads.
+*** Each subsystem draws from its own xoshiro128** stream instead, and every
+*** stream is derived from a single seed, so that a run can be reproduced by
+*** giving the same seed again. Code running in worker threads seeds its own
+*** streams from one of those, on the main thread.
+*** ***************************************************************************/
+
+#ifndef __RANDOM_STREAMS_HEADER__
+#define __RANDOM_STREAMS_HEADER__
+
+#include <cstdint>
+
+namespace vt_common
+{
+
+//! \brief The subsystems drawing from their own stream.
+enum RandomStreamType {
+    RANDOM_STREAM_GENERAL = 0,
+    RANDOM_STREAM_PARTICLES = 1,
+    RANDOM_STREAM_ANIMATIONS = 2,
+    RANDOM_STREAM_MAP = 3,
+    RANDOM_STREAM_BATTLE = 4,
+    RANDOM_STREAM_TOTAL = 5
+};
+
+/** ****************************************************************************
+*** \brief A xoshiro128** pseudo random number generator.
+***
+*** It is cheap to copy and to draw from, so that every user needing its own
+*** sequence, like each particle system, can own one.
+*** ***************************************************************************/
+class RandomStream
+{
+public:
+    explicit RandomStream(uint64_t seed = 0) {
+        Seed(seed);
+    }
+
+    //! \brief Restarts the stream. Two streams given the same seed draw the same numbers.
+    void Seed(uint64_t seed);
+
+    //! \brief Returns 32 random bits.
+    uint32_t NextUInt32() {
+        const uint32_t result = _RotateLeft(_state[1] * 5, 7) * 9;
+        const uint32_t t = _state[1] << 9;
+
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = _RotateLeft(_state[3], 11);
+
+        return result;
+    }
+
+    //! \brief Returns 64 random bits, used to seed other streams.
+    uint64_t NextUInt64() {
+        const uint64_t high = NextUInt32();
+        return (high << 32) | NextUInt32();
+    }
+
+    //! \brief Returns a random float in [0.0f, 1.0f).
+    float Float() {
+        return static_cast<float>(NextUInt32() >> 8) / 16777216.0f;
+    }
+
+    //! \brief Returns a random float between a and b.
+    float Float(float a, float b) {
+        return a + (b - a) * Float();
+    }
+
+    //! \brief Returns either -1.0f or 1.0f.
+    float Sign() {
+        return (NextUInt32() & 0x80000000) ? 1.0f : -1.0f;
+    }
+
+    /** \brief Returns a random integer between lower and upper, both included.
+    *** The bounds may be given in any order, as with vt_utils::RandomBoundedInteger().
+    **/
+    int32_t BoundedInteger(int32_t lower, int32_t upper);
+
+    //! \brief Fills the array with count random floats between a and b.
+    void Floats(float *values, uint32_t count, float a, float b);
+
+private:
+    static uint32_t _RotateLeft(uint32_t x, uint32_t k) {
+        return (x << k) | (x >> (32 - k));
+    }
+
+    uint32_t _state[4];
+};
+
+/** \brief Reseeds every subsystem stream from the given seed.
+*** When never called, the streams are seeded with zero.
+**/
+void SeedRandomStreams(uint64_t seed);
+
+//! \brief Returns the seed the subsystem streams were last seeded with.
+uint64_t GetRandomSeed();
+
+/** \brief Returns the stream of a subsystem.
+*** \note The subsystem streams must only be used by the main thread.
+**/
+RandomStream &GetRandomStream(RandomStreamType type);
+
+} // namespace vt_common
+
+#endif // __RANDOM_STREAMS_HEADER__
@@ -0,0 +1,364 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    script_call_profiler.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for timing the calls to the game scripts functions.
+*** ***************************************************************************/
+
+#include "common/script_call_profiler.h"
+
+#include "engine/frame_profiler.h"
+
+#include "utils/exception.h"
+#include "utils/utils_strings.h"
+
+#include <luabind/lua_include.hpp>
+
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vt_common
+{
+
+bool ScriptCallProfiler::_enabled = false;
+
+//! \brief A kind of function, the id it belongs to and the script function called.
+class ScriptCallKey
+{
+public:
+    ScriptCallKey(const char* function_, uint32_t id_, const char* location_) :
+        function(function_),
+        id(id_),
+        location(location_)
+    {}
+
+    const char* function;
+    uint32_t id;
+
+    //! \brief Interned, so that it can be compared by address.
+    const char* location;
+};
+
+//! \brief Orders the timed functions by kind, comparing their names rather than their addresses.
+class ScriptCallKeyCompare
+{
+public:
+    bool operator()(const ScriptCallKey& one, const ScriptCallKey& other) const {
+        int32_t compare = strcmp(one.function, other.function);
+        if(compare != 0)
+            return compare < 0;
+        if(one.id != other.id)
+            return one.id < other.id;
+        return one.location < other.location;
+    }
+};
+
+//! \brief The calls of a function.
+class ScriptCallStats
+{
+public:
+    ScriptCallStats() :
+        calls(0),
+        total_ticks(0),
+        max_ticks(0)
+    {}
+
+    uint32_t calls;
+    uint64_t total_ticks;
+    uint64_t max_ticks;
+};
+
+typedef std::map<ScriptCallKey, ScriptCallStats, ScriptCallKeyCompare> ScriptCallMap;
+
+//! \brief The timed calls, by kind of function, id and script function.
+static ScriptCallMap _script_calls;
+
+//! \brief Orders the script functions by source, comparing the sources text.
+class ScriptSourceCompare
+{
+public:
+    bool operator()(const std::pair<const char*, int32_t>& one,
+                    const std::pair<const char*, int32_t>& other) const {
+        int32_t compare = strcmp(one.first, other.first);
+        return compare < 0 || (compare == 0 && one.second < other.second);
+    }
+};
+
+//! \brief The script function names, by source file and line defined at.
+static std::map<std::pair<const char*, int32_t>, const char*, ScriptSourceCompare> _script_locations;
+
+//! \brief The texts the maps above point to, never freed as the frame profiler may keep pointers to them.
+static std::deque<std::string> _interned_texts;
+
+//! \brief Keeps a text for as long as the game runs.
+static const char* InternText(const std::string& text)
+{
+    _interned_texts.push_back(text);
+    return _interned_texts.back().c_str();
+}
+
+/** \brief Returns the key of a table whose value is the function, leaving the stack unchanged.
+*** \param function_index The absolute stack index of the function. The table is on top of the stack.
+**/
+static std::string FindFunctionKey(lua_State* state, int32_t function_index)
+{
+    lua_pushnil(state);
+    while(lua_next(state, -2) != 0) {
+        if(lua_type(state, -2) == LUA_TSTRING && lua_rawequal(state, -1, function_index)) {
+            std::string key = lua_tostring(state, -2);
+            lua_pop(state, 2);
+            return key;
+        }
+        lua_pop(state, 1);
+    }
+    return std::string();
+}
+
+/** \brief Finds the name of a function in its environment, or in the tables of it, like map_functions.
+*** The Lua functions have no name of their own. Leaves the stack unchanged.
+**/
+static std::string FindFunctionName(lua_State* state, int32_t function_index)
+{
+    lua_getfenv(state, function_index);
+    if(!lua_istable(state, -1)) {
+        lua_pop(state, 1);
+        return std::string();
+    }
+
+    std::string name = FindFunctionKey(state, function_index);
+    if(name.empty()) {
+        lua_pushnil(state);
+        while(lua_next(state, -2) != 0) {
+            if(lua_type(state, -2) == LUA_TSTRING && lua_istable(state, -1)) {
+                const std::string key = FindFunctionKey(state, function_index);
+                if(!key.empty())
+                    name = std::string(lua_tostring(state, -2)) + "." + key;
+            }
+            lua_pop(state, 1);
+            if(!name.empty()) {
+                lua_pop(state, 1);
+                break;
+            }
+        }
+    }
+
+    lua_pop(state, 1);
+    return name;
+}
+
+//! \brief Returns the name and the source of a script function, like "Update (dat/maps/layna_village.lua:120)".
+static const char* GetScriptLocation(const luabind::object& script_function)
+{
+    lua_State* state = script_function.interpreter();
+    if(state == nullptr)
+        return nullptr;
+
+    script_function.push(state);
+    if(!lua_isfunction(state, -1)) {
+        lua_pop(state, 1);
+        return nullptr;
+    }
+
+    lua_Debug info;
+    lua_pushvalue(state, -1);
+    lua_getinfo(state, ">S", &info);
+
+    const std::pair<const char*, int32_t> source(info.short_src, info.linedefined);
+    auto it = _script_locations.find(source);
+    if(it == _script_locations.end()) {
+        std::string location = std::string(info.short_src) + ":" + vt_utils::NumberToString(info.linedefined);
+        const std::string name = FindFunctionName(state, lua_gettop(state));
+        if(!name.empty())
+            location = name + " (" + location + ")";
+
+        const std::pair<const char*, int32_t> key(InternText(info.short_src), info.linedefined);
+        it = _script_locations.insert(std::make_pair(key, InternText(location))).first;
+    }
+
+    lua_pop(state, 1);
+    return it->second;
+}
+
+#ifdef DEBUG_FEATURES
+//! \brief The frame profiler scope names, by kind of function and script function.
+static std::map<std::pair<const char*, const char*>, const char*> _scope_names;
+
+//! \brief Returns the name of the frame profiler scope of a call, like "scene Update: Update (dat/...:12)".
+static const char* GetScopeName(const char* function, const char* location)
+{
+    if(location == nullptr)
+        return function;
+
+    const std::pair<const char*, const char*> key(function, location);
+    auto it = _scope_names.find(key);
+    if(it == _scope_names.end())
+        it = _scope_names.insert(std::make_pair(key, InternText(std::string(function) + ": " + location))).first;
+    return it->second;
+}
+#endif
+
+//! \brief Writes a text as a JSON string.
+static void WriteJSONString(std::ostream& file, const char* text)
+{
+    file << '"';
+    for(const char* c = text; *c != '\0'; ++c) {
+        if(*c == '"' || *c == '\\')
+            file << '\\';
+        file << *c;
+    }
+    file << '"';
+}
+
+void ScriptCallProfiler::AddCall(const char* function, uint32_t id, const char* location, uint64_t ticks)
+{
+    ScriptCallStats& stats = _script_calls[ScriptCallKey(function, id, location)];
+    ++stats.calls;
+    stats.total_ticks += ticks;
+    stats.max_ticks = std::max(stats.max_ticks, ticks);
+}
+
+void ScriptCallProfiler::Reset()
+{
+    _script_calls.clear();
+}
+
+//! \brief Orders the timed functions, the most expensive first.
+static bool CompareTotalTicks(const ScriptCallMap::const_iterator& one, const ScriptCallMap::const_iterator& other)
+{
+    return one->second.total_ticks > other->second.total_ticks;
+}
+
+//! \brief Returns the timed functions, the most expensive first.
+static std::vector<ScriptCallMap::const_iterator> SortScriptCalls()
+{
+    std::vector<ScriptCallMap::const_iterator> functions;
+    for(ScriptCallMap::const_iterator it = _script_calls.begin(); it != _script_calls.end(); ++it)
+        functions.push_back(it);
+    std::sort(functions.begin(), functions.end(), CompareTotalTicks);
+    return functions;
+}
+
+void ScriptCallProfiler::PrintReport()
+{
+    if(_script_calls.empty())
+        return;
+
+    const std::vector<ScriptCallMap::const_iterator> functions = SortScriptCalls();
+
+    const double ticks_per_ms = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+    std::cout << "Script calls, the most expensive first (times in milliseconds):" << std::endl
+              << std::setw(28) << std::left << "function" << std::right
+              << std::setw(8) << "id" << std::setw(10) << "calls" << std::setw(12) << "total"
+              << std::setw(10) << "average" << std::setw(10) << "max" << "  script" << std::endl;
+    for(uint32_t i = 0; i < functions.size(); ++i) {
+        const ScriptCallKey& key = functions[i]->first;
+        const ScriptCallStats& stats = functions[i]->second;
+        std::cout << std::setw(28) << std::left << key.function << std::right << std::setw(8);
+        if(key.id == SCRIPT_CALL_NO_ID)
+            std::cout << "-";
+        else
+            std::cout << key.id;
+        std::cout << std::setw(10) << stats.calls
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << stats.total_ticks / ticks_per_ms
+                  << std::setw(10) << stats.total_ticks / ticks_per_ms / stats.calls
+                  << std::setw(10) << stats.max_ticks / ticks_per_ms
+                  << "  " << (key.location != nullptr ? key.location : "?") << std::endl;
+    }
+}
+
+void ScriptCallProfiler::WriteJSON(std::ostream& file)
+{
+    const std::vector<ScriptCallMap::const_iterator> functions = SortScriptCalls();
+
+    const double ticks_per_ms = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+    file << "[";
+    for(uint32_t i = 0; i < functions.size(); ++i) {
+        const ScriptCallKey& key = functions[i]->first;
+        const ScriptCallStats& stats = functions[i]->second;
+        file << (i == 0 ? "\n" : ",\n") << "    { \"function\": ";
+        WriteJSONString(file, key.function);
+        if(key.id != SCRIPT_CALL_NO_ID)
+            file << ", \"id\": " << key.id;
+        if(key.location != nullptr) {
+            file << ", \"script\": ";
+            WriteJSONString(file, key.location);
+        }
+        file << ", \"calls\": " << stats.calls
+             << ", \"total_ms\": " << stats.total_ticks / ticks_per_ms
+             << ", \"max_ms\": " << stats.max_ticks / ticks_per_ms << " }";
+    }
+    file << (functions.empty() ? "]" : "\n  ]");
+}
+
+ScriptCallTimer::ScriptCallTimer(const char* function, uint32_t id, const luabind::object& script_function) :
+    _function(function),
+    _id(id),
+    _location(nullptr),
+    _start(0)
+#ifdef DEBUG_FEATURES
+    , _frame_start(0)
+#endif
+{
+    bool frame_profiled = false;
+#ifdef DEBUG_FEATURES
+    frame_profiled = vt_system::FrameProfiler::IsEnabled();
+#endif
+    if(!ScriptCallProfiler::IsEnabled() && !frame_profiled)
+        return;
+
+    _location = GetScriptLocation(script_function);
+
+    const uint64_t start = SDL_GetPerformanceCounter();
+    if(ScriptCallProfiler::IsEnabled())
+        _start = start;
+#ifdef DEBUG_FEATURES
+    if(frame_profiled)
+        _frame_start = start;
+#endif
+}
+
+ScriptCallTimer::ScriptCallTimer(const char* function, const luabind::object& script_function) :
+    ScriptCallTimer(function, SCRIPT_CALL_NO_ID, script_function)
+{
+}
+
+ScriptCallTimer::~ScriptCallTimer()
+{
+    if(_start != 0)
+        ScriptCallProfiler::AddCall(_function, _id, _location, SDL_GetPerformanceCounter() - _start);
+
+#ifdef DEBUG_FEATURES
+    if(_frame_start != 0)
+        vt_system::FrameProfiler::AddScope(GetScopeName(_function, _location), _frame_start, SDL_GetPerformanceCounter());
+#endif
+}
+
+ScriptCallTimer::ScriptCallTimer(const ScriptCallTimer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+ScriptCallTimer& ScriptCallTimer::operator=(const ScriptCallTimer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_common
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    script_call_profiler.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for timing the calls to the game scripts functions.
+***
+*** The script function handles are read once, when their skill, item, actor,
+*** map event or scene script is loaded. Each call to them can be timed by a
+*** ScriptCallTimer, so that the slow scripts show up in the frame profiler
+*** overlay, in a report printed when the game exits and in the benchmark results.
+***
+*** The calls are told apart by the script file and line the called function
+*** is defined at, and by its name when found in the script tables.
+*** ***************************************************************************/
+
+#ifndef __SCRIPT_CALL_PROFILER_HEADER__
+#define __SCRIPT_CALL_PROFILER_HEADER__
+
+#include "luabind/object.hpp"
+
+#include <cstdint>
+#include <ostream>
+
+namespace vt_common
+{
+
+//! \brief The id of the calls not belonging to a skill, item or actor.
+const uint32_t SCRIPT_CALL_NO_ID = 0xFFFFFFFF;
+
+/** ****************************************************************************
+*** \brief Accumulates the time spent in the script functions.
+***
+*** The calls are grouped by kind of function, like "skill BattleExecute", by
+*** the id of the skill, item or actor the function belongs to, and by the
+*** script function called.
+*** ***************************************************************************/
+class ScriptCallProfiler
+{
+public:
+    //! \brief Starts or stops timing the calls. Nothing is timed by default.
+    static void SetEnabled(bool enabled) {
+        _enabled = enabled;
+    }
+
+    static bool IsEnabled() {
+        return _enabled;
+    }
+
+    /** \brief Adds a call to the report.
+    *** \param function The kind of function called. Must be a string literal.
+    *** \param id The id of the skill, item or actor the function belongs to, or SCRIPT_CALL_NO_ID.
+    *** \param location The script function called, as given by ScriptCallTimer, or nullptr if unknown.
+    *** \param ticks The call duration, in performance counter ticks.
+    **/
+    static void AddCall(const char* function, uint32_t id, const char* location, uint64_t ticks);
+
+    //! \brief Forgets the calls timed so far.
+    static void Reset();
+
+    //! \brief Prints the timed calls, the most expensive first.
+    static void PrintReport();
+
+    //! \brief Writes the timed calls as a JSON array, the most expensive first.
+    static void WriteJSON(std::ostream& file);
+
+private:
+    static bool _enabled;
+};
+
+/** ****************************************************************************
+*** \brief Times a script function call for the profiler, from its creation to its destruction.
+***
+*** It does nothing when the profiler is disabled, and still times the calls
+*** ending with a Lua error. The calls are shown by the frame profiler as well,
+*** with the script function called.
+***
+*** \note The script function is only looked up when a profiler is enabled,
+*** out of the timed duration.
+*** ***************************************************************************/
+class ScriptCallTimer
+{
+public:
+    /** \param function The kind of function called. Must be a string literal.
+    *** \param id The id of the skill, item or actor the function belongs to.
+    *** \param script_function The script function called.
+    **/
+    ScriptCallTimer(const char* function, uint32_t id, const luabind::object& script_function);
+
+    //! \brief Times a call not belonging to a skill, item or actor.
+    ScriptCallTimer(const char* function, const luabind::object& script_function);
+
+    ~ScriptCallTimer();
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ScriptCallTimer(const ScriptCallTimer& timer);
+    ScriptCallTimer& operator=(const ScriptCallTimer& timer);
+
+    const char* _function;
+    uint32_t _id;
+
+    //! \brief The script function called, nullptr when unknown or when no profiler is enabled.
+    const char* _location;
+
+    //! \brief The performance counter at creation, 0 when the profiler is disabled.
+    uint64_t _start;
+
+#ifdef DEBUG_FEATURES
+    //! \brief The performance counter at creation, 0 when the frame profiler is disabled.
+    uint64_t _frame_start;
+#endif
+};
+
+} // namespace vt_common
+
+#endif // __SCRIPT_CALL_PROFILER_HEADER__
@@ -0,0 +1,283 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    asset_archive.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the packed asset archive.
+*** ***************************************************************************/
+
+#include "engine/asset_archive.h"
+
+#include "engine/system.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+#include "utils/exception.h"
+
+#include <SDL2/SDL_rwops.h>
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vt_system
+{
+
+//! \brief The archive header size, the index starting after the files content.
+const size_t ASSET_ARCHIVE_HEADER_SIZE = 32;
+
+//! \brief The archive mounted, if any.
+static AssetArchive _mounted_archive;
+
+std::string NormalizeAssetPath(const std::string& filename)
+{
+    std::string path;
+    path.reserve(filename.size());
+    for(size_t i = 0; i < filename.size(); ++i) {
+        const char character = filename[i] == '\\' ? '/' : filename[i];
+        // Skips the repeated slashes, and the "./" directories.
+        if(character == '/' && (path.empty() || path[path.size() - 1] == '/'))
+            continue;
+        if(character == '.' && (path.empty() || path[path.size() - 1] == '/') &&
+                i + 1 < filename.size() && (filename[i + 1] == '/' || filename[i + 1] == '\\')) {
+            ++i;
+            continue;
+        }
+        path.push_back(character);
+    }
+    return path;
+}
+
+AssetArchive::AssetArchive() :
+    _data(nullptr),
+    _size(0),
+    _file_handle(nullptr),
+    _mapping_handle(nullptr)
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const std::string& filename)
+{
+    Close();
+
+    if(!_MapFile(filename))
+        return false;
+
+    if(!_ReadIndex()) {
+        PRINT_ERROR << "Invalid asset archive: " << filename << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    _index.clear();
+    _UnmapFile();
+}
+
+bool AssetArchive::FindFile(const std::string& filename, const uint8_t*& data, size_t& size) const
+{
+    std::unordered_map<std::string, PackedFile>::const_iterator it = _index.find(filename);
+    if(it == _index.end())
+        return false;
+
+    data = it->second.data;
+    size = it->second.size;
+    return true;
+}
+
+bool AssetArchive::_ReadIndex()
+{
+    if(_size < ASSET_ARCHIVE_HEADER_SIZE || std::memcmp(_data, "VTASSETS", 8) != 0)
+        return false;
+
+    uint32_t version = 0;
+    uint32_t file_count = 0;
+    uint64_t index_offset = 0;
+    uint64_t archive_size = 0;
+    std::memcpy(&version, _data + 8, sizeof(uint32_t));
+    std::memcpy(&file_count, _data + 12, sizeof(uint32_t));
+    std::memcpy(&index_offset, _data + 16, sizeof(uint64_t));
+    std::memcpy(&archive_size, _data + 24, sizeof(uint64_t));
+    if(version != ASSET_ARCHIVE_VERSION) {
+        PRINT_WARNING << "Unsupported asset archive version: " << version << std::endl;
+        return false;
+    }
+    if(archive_size != _size || index_offset < ASSET_ARCHIVE_HEADER_SIZE || index_offset > _size)
+        return false;
+
+    _index.reserve(file_count);
+    uint64_t offset = index_offset;
+    for(uint32_t i = 0; i < file_count; ++i) {
+        uint64_t content_offset = 0;
+        uint64_t content_size = 0;
+        uint32_t path_length = 0;
+        if(offset + 20 > _size)
+            return false;
+        std::memcpy(&content_offset, _data + offset, sizeof(uint64_t));
+        std::memcpy(&content_size, _data + offset + 8, sizeof(uint64_t));
+        std::memcpy(&path_length, _data + offset + 16, sizeof(uint32_t));
+        offset += 20;
+
+        if(offset + path_length > _size || content_offset < ASSET_ARCHIVE_HEADER_SIZE ||
+                content_offset > index_offset || content_size > index_offset - content_offset)
+            return false;
+
+        PackedFile& file = _index[std::string(reinterpret_cast<const char *>(_data + offset), path_length)];
+        file.data = _data + content_offset;
+        file.size = static_cast<size_t>(content_size);
+        offset += path_length;
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+bool AssetArchive::_MapFile(const std::string& filename)
+{
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    _data = static_cast<const uint8_t *>(data);
+    _size = static_cast<size_t>(size.QuadPart);
+    _file_handle = file;
+    _mapping_handle = mapping;
+    return true;
+}
+
+void AssetArchive::_UnmapFile()
+{
+    if(_data)
+        UnmapViewOfFile(_data);
+    if(_mapping_handle)
+        CloseHandle(static_cast<HANDLE>(_mapping_handle));
+    if(_file_handle)
+        CloseHandle(static_cast<HANDLE>(_file_handle));
+    _data = nullptr;
+    _size = 0;
+    _file_handle = nullptr;
+    _mapping_handle = nullptr;
+}
+
+#else
+
+bool AssetArchive::_MapFile(const std::string& filename)
+{
+    const int file = open(filename.c_str(), O_RDONLY);
+    if(file < 0)
+        return false;
+
+    struct stat file_stat;
+    if(fstat(file, &file_stat) != 0 || file_stat.st_size <= 0) {
+        close(file);
+        return false;
+    }
+
+    // The mapping stays valid once the file is closed.
+    void* data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
+        return false;
+
+    _data = static_cast<const uint8_t *>(data);
+    _size = static_cast<size_t>(file_stat.st_size);
+    return true;
+}
+
+void AssetArchive::_UnmapFile()
+{
+    if(_data)
+        munmap(const_cast<uint8_t *>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
+
+AssetArchive::AssetArchive(const AssetArchive&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+AssetArchive& AssetArchive::operator=(const AssetArchive&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+bool MountAssetArchive(const std::string& filename)
+{
+    if(!_mounted_archive.Open(filename))
+        return false;
+
+    IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Mounted " << _mounted_archive.GetFileCount()
+                                 << " files from the asset archive: " << filename << std::endl;
+    return true;
+}
+
+void UnmountAssetArchive()
+{
+    _mounted_archive.Close();
+}
+
+bool DoesAssetExist(const std::string& filename)
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if(_mounted_archive.IsOpen() && _mounted_archive.FindFile(NormalizeAssetPath(filename), data, size))
+        return true;
+    return vt_utils::DoesFileExist(filename);
+}
+
+SDL_RWops* OpenAsset(const std::string& filename)
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if(_mounted_archive.IsOpen() && _mounted_archive.FindFile(NormalizeAssetPath(filename), data, size))
+        return SDL_RWFromConstMem(data, static_cast<int>(size));
+    return SDL_RWFromFile(filename.c_str(), "rb");
+}
+
+} // namespace vt_system
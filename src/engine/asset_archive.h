@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    asset_archive.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the packed asset archive.
+***
+*** The images, fonts and sounds of the data folder can be packed by
+*** tools/pack-assets.py into a single archive, memory mapped at startup. The
+*** packed files are then read from memory through SDL_RWops, and their
+*** existence checked in a hashed path index, without opening nor stating any
+*** file. The files not packed are still read from the disk.
+***
+*** \note When the archive exists, its files are used instead of the loose ones:
+*** Pack the assets again after editing them, or simply delete the archive.
+***
+*** The format is little endian, with every section aligned on 8 bytes:
+*** - The header: "VTASSETS", then the uint32 version and number of files,
+***   the uint64 index offset and the uint64 archive size.
+*** - The files content, one after the other.
+*** - The index, each file being its uint64 content offset and size, then its
+***   path as a uint32 length followed by the characters, like "data/fonts/a.ttf".
+*** ***************************************************************************/
+
+#ifndef __ASSET_ARCHIVE_HEADER__
+#define __ASSET_ARCHIVE_HEADER__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+struct SDL_RWops;
+
+namespace vt_system
+{
+
+//! \brief The asset archive format version, to change whenever the format does.
+const uint32_t ASSET_ARCHIVE_VERSION = 1;
+
+//! \brief The archive mounted at startup, next to the data folder.
+const std::string ASSET_ARCHIVE_FILENAME = "data.vtassets";
+
+/** \brief Returns the path of a file as stored in the archive index,
+*** without the "./" prefixes, with forward slashes and no repeated slash.
+**/
+std::string NormalizeAssetPath(const std::string& filename);
+
+/** ****************************************************************************
+*** \brief A memory mapped archive of files, indexed by path.
+***
+*** The index is only written when opening the archive, and may then be read
+*** from any thread.
+*** ***************************************************************************/
+class AssetArchive
+{
+public:
+    AssetArchive();
+
+    ~AssetArchive();
+
+    /** \brief Maps an archive in memory, and reads its index.
+    *** \return False if the file doesn't exist, or isn't a valid archive.
+    **/
+    bool Open(const std::string& filename);
+
+    //! \brief Unmaps the archive. The files content must not be used anymore.
+    void Close();
+
+    bool IsOpen() const {
+        return _data != nullptr;
+    }
+
+    uint32_t GetFileCount() const {
+        return static_cast<uint32_t>(_index.size());
+    }
+
+    /** \brief Finds a packed file content.
+    *** \param filename The normalized file path, see NormalizeAssetPath().
+    *** \return False if the file isn't packed.
+    **/
+    bool FindFile(const std::string& filename, const uint8_t*& data, size_t& size) const;
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    AssetArchive(const AssetArchive& archive);
+    AssetArchive& operator=(const AssetArchive& archive);
+
+    //! \brief A packed file, in the mapped memory.
+    class PackedFile
+    {
+    public:
+        const uint8_t* data;
+        size_t size;
+    };
+
+    //! \brief The mapped archive.
+    const uint8_t* _data;
+    size_t _size;
+
+    //! \brief The platform handles of the mapping.
+    void* _file_handle;
+    void* _mapping_handle;
+
+    //! \brief The packed files, by normalized path.
+    std::unordered_map<std::string, PackedFile> _index;
+
+    //! \brief Reads and validates the index of the mapped archive.
+    bool _ReadIndex();
+
+    //! \brief Maps and unmaps the file in memory.
+    bool _MapFile(const std::string& filename);
+    void _UnmapFile();
+};
+
+/** \brief Mounts the archive, whose files are then read by OpenAsset() and DoesAssetExist().
+*** \return False if there is no valid archive, the files being then read from the disk.
+*** \note To be called before any file is loaded, and before starting the threads loading files.
+**/
+bool MountAssetArchive(const std::string& filename);
+
+//! \brief Unmounts the archive, once every asset opened from it is closed.
+void UnmountAssetArchive();
+
+//! \brief Tells whether a file exists, looking it up in the archive before checking the disk.
+bool DoesAssetExist(const std::string& filename);
+
+/** \brief Opens a file for reading, from the archive memory when packed.
+*** \return The SDL stream, to be closed by the caller or the SDL function using it, or nullptr.
+**/
+SDL_RWops* OpenAsset(const std::string& filename);
+
+} // namespace vt_system
+
+#endif // __ASSET_ARCHIVE_HEADER__
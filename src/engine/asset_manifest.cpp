@@ -0,0 +1,255 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    asset_manifest.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the assets manifest of each map and battle.
+*** ***************************************************************************/
+
+#include "engine/asset_manifest.h"
+
+#include "engine/asset_archive.h"
+#include "engine/audio/audio.h"
+#include "engine/system.h"
+#include "engine/video/image.h"
+#include "engine/video/particle_manager.h"
+#include "engine/video/video.h"
+
+#include "script/script_read.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace vt_audio;
+using namespace vt_video;
+
+namespace vt_system
+{
+
+bool AssetManifest::_recording = false;
+std::string AssetManifest::_recording_key;
+std::string AssetManifest::_recording_filename;
+
+namespace
+{
+
+//! \brief The assets of a manifest entry, by type.
+class AssetList
+{
+public:
+    std::vector<std::string> files[ASSET_TYPE_TOTAL];
+};
+
+bool _manifest_loaded = false;
+
+//! \brief The manifest entries, by key.
+std::map<std::string, AssetList> _manifest;
+
+//! \brief The images prefetched for each mode, until it has loaded.
+std::map<const vt_mode_manager::GameMode*, std::vector<std::string> > _prefetched_images;
+
+//! \brief The images prefetched for a mode not created yet, and its key.
+std::string _pending_images_key;
+std::vector<std::string> _pending_images;
+
+//! \brief The assets recorded, by key, type and file.
+std::map<std::string, std::set<std::pair<uint32_t, std::string> > > _recorded_assets;
+
+} // namespace
+
+const char* GetAssetTypeName(AssetType type)
+{
+    switch(type) {
+    case ASSET_IMAGE:
+        return "images";
+    case ASSET_ANIMATION:
+        return "animations";
+    case ASSET_PARTICLE_EFFECT:
+        return "particle_effects";
+    case ASSET_SOUND:
+        return "sounds";
+    case ASSET_MUSIC:
+        return "music";
+    case ASSET_SCRIPT:
+        return "scripts";
+    default:
+        return "unknown";
+    }
+}
+
+void AssetManifest::Prefetch(const std::string& key, vt_mode_manager::GameMode* owner)
+{
+    SetRecordingKey(key);
+
+    if(!_manifest_loaded)
+        _LoadManifest();
+
+    std::map<std::string, AssetList>::const_iterator it = _manifest.find(key);
+    if(it == _manifest.end())
+        return;
+    const AssetList& assets = it->second;
+
+    // The images and sounds are decoded by the worker threads, so they are requested first.
+    const std::vector<std::string>& images = assets.files[ASSET_IMAGE];
+    std::vector<std::string>& prefetched_images = _prefetched_images[owner];
+    if(key == _pending_images_key) {
+        // The images are already requested, and the mode cancels them from now on.
+        prefetched_images.insert(prefetched_images.end(), _pending_images.begin(), _pending_images.end());
+        _pending_images_key.clear();
+        _pending_images.clear();
+    }
+    for(uint32_t i = 0; i < images.size(); ++i) {
+        if(DoesAssetExist(images[i])) {
+            TextureManager->PrefetchImage(images[i]);
+            prefetched_images.push_back(images[i]);
+        }
+    }
+
+    const std::vector<std::string>& sounds = assets.files[ASSET_SOUND];
+    for(uint32_t i = 0; i < sounds.size(); ++i)
+        AudioManager->LoadSound(sounds[i], owner);
+
+    const std::vector<std::string>& music = assets.files[ASSET_MUSIC];
+    for(uint32_t i = 0; i < music.size(); ++i)
+        AudioManager->LoadMusic(music[i], owner);
+
+    // The scripts are read by the main thread, meanwhile.
+    const std::vector<std::string>& animations = assets.files[ASSET_ANIMATION];
+    for(uint32_t i = 0; i < animations.size(); ++i)
+        AnimatedImage::PrefetchAnimationScript(animations[i]);
+
+    const std::vector<std::string>& particle_effects = assets.files[ASSET_PARTICLE_EFFECT];
+    for(uint32_t i = 0; i < particle_effects.size(); ++i)
+        vt_mode_manager::ParticleManager::GetEffectDef(particle_effects[i]);
+
+    IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Prefetched " << images.size() << " images, " << sounds.size() + music.size()
+                                 << " sounds and " << animations.size() + particle_effects.size()
+                                 << " animations and particle effects for: " << key << std::endl;
+}
+
+void AssetManifest::PrefetchImages(const std::string& key)
+{
+    if(key == _pending_images_key)
+        return;
+
+    for(uint32_t i = 0; i < _pending_images.size(); ++i)
+        TextureManager->CancelPrefetchedImage(_pending_images[i]);
+    _pending_images.clear();
+    _pending_images_key = key;
+
+    if(!_manifest_loaded)
+        _LoadManifest();
+
+    std::map<std::string, AssetList>::const_iterator it = _manifest.find(key);
+    if(it == _manifest.end())
+        return;
+
+    const std::vector<std::string>& images = it->second.files[ASSET_IMAGE];
+    for(uint32_t i = 0; i < images.size(); ++i) {
+        if(DoesAssetExist(images[i])) {
+            TextureManager->PrefetchImage(images[i]);
+            _pending_images.push_back(images[i]);
+        }
+    }
+}
+
+void AssetManifest::CancelUnusedImages(const vt_mode_manager::GameMode* owner)
+{
+    std::map<const vt_mode_manager::GameMode*, std::vector<std::string> >::iterator it = _prefetched_images.find(owner);
+    if(it == _prefetched_images.end())
+        return;
+
+    // The images loaded meanwhile were taken from the decoder already.
+    const std::vector<std::string>& images = it->second;
+    for(uint32_t i = 0; i < images.size(); ++i)
+        TextureManager->CancelPrefetchedImage(images[i]);
+    _prefetched_images.erase(it);
+}
+
+void AssetManifest::StartRecording(const std::string& filename)
+{
+    _recording = true;
+    _recording_filename = filename;
+    _recorded_assets.clear();
+}
+
+bool AssetManifest::StopRecording()
+{
+    if(!_recording)
+        return true;
+    _recording = false;
+
+    std::ofstream file(_recording_filename.c_str(), std::ios::out | std::ios::trunc);
+    if(!file.is_open()) {
+        PRINT_ERROR << "Couldn't open the assets recording file: " << _recording_filename << std::endl;
+        return false;
+    }
+
+    for(auto it = _recorded_assets.begin(); it != _recorded_assets.end(); ++it) {
+        for(auto asset = it->second.begin(); asset != it->second.end(); ++asset)
+            file << it->first << '\t' << GetAssetTypeName(static_cast<AssetType>(asset->first))
+                 << '\t' << asset->second << std::endl;
+    }
+
+    file.close();
+    if(file.fail()) {
+        PRINT_ERROR << "Couldn't write the assets recording file: " << _recording_filename << std::endl;
+        return false;
+    }
+    _recorded_assets.clear();
+    return true;
+}
+
+void AssetManifest::_RecordAsset(AssetType type, const std::string& filename)
+{
+    _recorded_assets[_recording_key].insert(std::make_pair(static_cast<uint32_t>(type), filename));
+}
+
+void AssetManifest::_LoadManifest()
+{
+    _manifest_loaded = true;
+    if(!vt_utils::DoesFileExist(ASSET_MANIFEST_FILENAME))
+        return;
+
+    vt_script::ReadScriptDescriptor manifest_script;
+    if(!manifest_script.OpenFile(ASSET_MANIFEST_FILENAME))
+        return;
+
+    std::vector<std::string> keys;
+    manifest_script.ReadTableKeys("asset_manifest", keys);
+    if(!manifest_script.OpenTable("asset_manifest")) {
+        PRINT_WARNING << "No asset_manifest table in: " << ASSET_MANIFEST_FILENAME << std::endl;
+        manifest_script.CloseFile();
+        return;
+    }
+
+    for(uint32_t i = 0; i < keys.size(); ++i) {
+        if(!manifest_script.OpenTable(keys[i]))
+            continue;
+
+        AssetList& assets = _manifest[keys[i]];
+        for(uint32_t type = 0; type < ASSET_TYPE_TOTAL; ++type) {
+            const char* type_name = GetAssetTypeName(static_cast<AssetType>(type));
+            if(manifest_script.DoesTableExist(type_name))
+                manifest_script.ReadStringVector(type_name, assets.files[type]);
+        }
+        manifest_script.CloseTable(); // keys[i]
+    }
+
+    manifest_script.CloseTable(); // asset_manifest
+    manifest_script.CloseFile();
+}
+
+} // namespace vt_system
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    asset_manifest.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the assets manifest of each map and battle.
+***
+*** The manifest lists the assets each map, and the battles started from it,
+*** will load. It is generated by tools/gen-asset-manifest.py, from the assets
+*** named by the map scripts and the sprites and objects they create, and from
+*** the assets recorded while playing with --record-assets.
+***
+*** When a map or battle mode is created, its assets are requested at once:
+*** The images and sounds are then decoded by the worker threads while the
+*** mode constructs its objects, instead of being discovered one after another.
+***
+*** \note The manifest only speeds the loading up: A missing or outdated
+*** manifest only means the unlisted assets are loaded when needed, as before.
+*** ***************************************************************************/
+
+#ifndef __ASSET_MANIFEST_HEADER__
+#define __ASSET_MANIFEST_HEADER__
+
+#include <cstdint>
+#include <string>
+
+namespace vt_mode_manager
+{
+class GameMode;
+}
+
+namespace vt_system
+{
+
+//! \brief The manifest generated by tools/gen-asset-manifest.py.
+const std::string ASSET_MANIFEST_FILENAME = "data/config/asset_manifest.lua";
+
+//! \brief The kinds of assets listed, each being a table of the manifest entries.
+enum AssetType {
+    ASSET_IMAGE = 0,
+    ASSET_ANIMATION = 1,
+    ASSET_PARTICLE_EFFECT = 2,
+    ASSET_SOUND = 3,
+    ASSET_MUSIC = 4,
+    //! Listed for the tools only: The Lua state can't load them in the background.
+    ASSET_SCRIPT = 5,
+    ASSET_TYPE_TOTAL = 6
+};
+
+//! \brief Returns the manifest table name of an asset type, like "images".
+const char* GetAssetTypeName(AssetType type);
+
+/** ****************************************************************************
+*** \brief Requests the assets listed for a mode, and records the ones it loads.
+***
+*** The entries are keyed by mode, like "map:<map script file>" and
+*** "battle:<map script file>" for the battles started from that map.
+***
+*** \note To be used by the main thread only.
+*** ***************************************************************************/
+class AssetManifest
+{
+public:
+    //! \brief Returns the manifest key of a map, and of the battles started from it.
+    static std::string GetMapKey(const std::string& map_script_filename) {
+        return "map:" + map_script_filename;
+    }
+
+    static std::string GetBattleKey(const std::string& map_script_filename) {
+        return "battle:" + map_script_filename;
+    }
+
+    /** \brief Starts loading the assets of a mode in the background, and records the
+    *** assets loaded from now on for it.
+    *** \param key The manifest key of the mode.
+    *** \param owner The mode the sounds are loaded for, or nullptr if it doesn't exist yet.
+    *** \note The manifest is read on the first call.
+    **/
+    static void Prefetch(const std::string& key, vt_mode_manager::GameMode* owner);
+
+    /** \brief Starts decoding the images of a mode not created yet, like while the previous one fades out.
+    *** \param key The manifest key of the mode.
+    *** The mode takes the images over when calling Prefetch() with the same key. The images of
+    *** a previous call no mode took over are cancelled.
+    **/
+    static void PrefetchImages(const std::string& key);
+
+    /** \brief Forgets the images prefetched for a mode which it didn't load.
+    *** A manifest entry lists the images of every variant of the mode, like the evening
+    *** battle backgrounds, so the ones not taken would otherwise stay decoded.
+    *** \param owner The mode given to Prefetch(), once it has loaded or when it is destroyed.
+    **/
+    static void CancelUnusedImages(const vt_mode_manager::GameMode* owner);
+
+    /** \brief Records the assets loaded from now on for a mode, when it becomes active again.
+    *** \param key The manifest key of the mode, or an empty string to record nothing.
+    **/
+    static void SetRecordingKey(const std::string& key) {
+        _recording_key = key;
+    }
+
+    /** \brief Starts recording the assets loaded by each mode.
+    *** \param filename The file the recording is written to by StopRecording().
+    **/
+    static void StartRecording(const std::string& filename);
+
+    //! \brief Adds an asset loaded to the recording of the current mode.
+    static void RecordAsset(AssetType type, const std::string& filename) {
+        if(_recording && !_recording_key.empty() && !filename.empty())
+            _RecordAsset(type, filename);
+    }
+
+    /** \brief Writes the recorded assets, one "key<TAB>type<TAB>file" line each,
+    *** for tools/gen-asset-manifest.py --recording to merge them in the manifest.
+    *** \return False if the recording couldn't be written.
+    **/
+    static bool StopRecording();
+
+private:
+    static bool _recording;
+    static std::string _recording_key;
+    static std::string _recording_filename;
+
+    static void _RecordAsset(AssetType type, const std::string& filename);
+
+    //! \brief Reads the manifest. A missing manifest is no error.
+    static void _LoadManifest();
+};
+
+} // namespace vt_system
+
+#endif // __ASSET_MANIFEST_HEADER__
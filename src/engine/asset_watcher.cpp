@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    asset_watcher.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the reloading of the assets changed on disk.
+*** ***************************************************************************/
+
+#ifdef DEBUG_FEATURES
+
+#include "engine/asset_watcher.h"
+
+#include "engine/mode_manager.h"
+#include "engine/system.h"
+#include "engine/video/image.h"
+#include "engine/video/particle_manager.h"
+#include "engine/video/texture_controller.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+
+#include <algorithm>
+
+namespace vt_system
+{
+
+std::vector<AssetWatcher::WatchedFile> AssetWatcher::_files;
+std::set<std::string> AssetWatcher::_filenames;
+uint32_t AssetWatcher::_next_file = 0;
+
+void AssetWatcher::Watch(AssetType type, const std::string& filename)
+{
+    if(filename.empty() || _filenames.find(filename) != _filenames.end())
+        return;
+    if(!vt_utils::DoesFileExist(filename))
+        return;
+
+    WatchedFile file;
+    file.filename = filename;
+    file.type = type;
+    file.modification_time = vt_utils::GetFileModTime(filename);
+    _files.push_back(file);
+    _filenames.insert(filename);
+}
+
+void AssetWatcher::Update()
+{
+    if(_files.empty())
+        return;
+
+    const uint32_t count = std::min(ASSET_WATCH_FILES_PER_FRAME, static_cast<uint32_t>(_files.size()));
+    for(uint32_t i = 0; i < count; ++i) {
+        if(_next_file >= _files.size())
+            _next_file = 0;
+        WatchedFile& file = _files[_next_file++];
+
+        // Files being replaced may briefly be missing: They are checked again later.
+        if(!vt_utils::DoesFileExist(file.filename))
+            continue;
+        const std::time_t modification_time = vt_utils::GetFileModTime(file.filename);
+        if(modification_time == file.modification_time)
+            continue;
+
+        file.modification_time = modification_time;
+        IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Reloading the changed file: " << file.filename << std::endl;
+        _Reload(file);
+    }
+}
+
+void AssetWatcher::_Reload(const WatchedFile& file)
+{
+    switch(file.type) {
+    case ASSET_IMAGE:
+        vt_video::TextureManager->DEBUG_ReloadImageFile(file.filename);
+        break;
+    case ASSET_ANIMATION:
+        vt_video::AnimatedImage::InvalidateAnimationScript(file.filename);
+        break;
+    case ASSET_PARTICLE_EFFECT:
+        vt_mode_manager::ParticleManager::InvalidateEffectDef(file.filename);
+        break;
+    case ASSET_SCRIPT: {
+        vt_mode_manager::GameMode* mode = vt_mode_manager::ModeManager->GetTop();
+        if(mode != nullptr)
+            mode->DEBUG_ReloadScript(file.filename);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+} // namespace vt_system
+
+#endif // DEBUG_FEATURES
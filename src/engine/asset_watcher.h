@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    asset_watcher.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the reloading of the assets changed on disk.
+***
+*** The debug builds watch the files of the images, animations, particle effects
+*** and map scripts loaded, and reload the changed ones without restarting:
+***
+*** - The images are uploaded again in place, in their texture sheets.
+*** - The animation and particle effect definitions are dropped from their
+*** caches, so that the ones created from now on use the changed files.
+*** - The map scripts and data make the active map reload itself.
+***
+*** \note Only the loose files are watched: The files read from the asset
+*** archive aren't reloaded, so delete the archive while editing the assets.
+*** Nothing of this is compiled in the release builds.
+*** ***************************************************************************/
+
+#ifndef __ASSET_WATCHER_HEADER__
+#define __ASSET_WATCHER_HEADER__
+
+#ifdef DEBUG_FEATURES
+
+#include "engine/asset_manifest.h"
+
+#include <ctime>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace vt_system
+{
+
+//! \brief The number of watched files whose modification time is checked each frame.
+const uint32_t ASSET_WATCH_FILES_PER_FRAME = 32;
+
+/** ****************************************************************************
+*** \brief Polls the modification time of the loaded assets, a few of them each frame.
+***
+*** \note To be used by the main thread only.
+*** ***************************************************************************/
+class AssetWatcher
+{
+public:
+    /** \brief Watches a file loaded, if not done yet.
+    *** \param type The kind of asset, telling how to reload it.
+    *** \param filename The file loaded. Nothing is done if it doesn't exist on disk.
+    **/
+    static void Watch(AssetType type, const std::string& filename);
+
+    //! \brief Checks the next watched files, and reloads the changed ones. Called once per frame.
+    static void Update();
+
+private:
+    class WatchedFile
+    {
+    public:
+        std::string filename;
+        AssetType type;
+        std::time_t modification_time;
+    };
+
+    //! \brief The files watched, checked in turn.
+    static std::vector<WatchedFile> _files;
+
+    //! \brief The filenames watched, to watch each one once.
+    static std::set<std::string> _filenames;
+
+    //! \brief The index in _files of the next file to check.
+    static uint32_t _next_file;
+
+    //! \brief Reloads a changed file.
+    static void _Reload(const WatchedFile& file);
+};
+
+} // namespace vt_system
+
+#endif // DEBUG_FEATURES
+
+#endif // __ASSET_WATCHER_HEADER__
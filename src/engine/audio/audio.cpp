@@ -23,12 +23,19 @@
 
 #include "engine/audio/audio.h"
 
+#include "engine/audio/audio_decoder.h"
+
+#include "engine/asset_archive.h"
+#include "engine/asset_manifest.h"
+#include "engine/frame_profiler.h"
 #include "engine/system.h"
 #include "engine/mode_manager.h"
 
 #include "utils/utils_strings.h"
 #include "utils/utils_files.h"
 
+#include <SDL2/SDL.h>
+
 using namespace vt_utils;
 using namespace vt_system;
 using namespace vt_audio::private_audio;
@@ -46,7 +53,19 @@ AudioEngine::AudioEngine() :
     _device(0),
     _context(0),
     _max_sources(MAX_DEFAULT_AUDIO_SOURCES),
-    _active_music(nullptr)
+    _active_voice_count(0),
+    _peak_voice_count(0),
+    _stolen_voice_count(0),
+    _dropped_voice_count(0),
+    _streaming_buffer_count(DEFAULT_STREAMING_BUFFER_COUNT),
+    _streaming_buffer_duration(DEFAULT_STREAMING_BUFFER_DURATION),
+    _static_audio_cache_size(0),
+    _audio_decoder(nullptr),
+    _static_audio_decoding_count(0),
+    _active_music(nullptr),
+    _stream_thread(nullptr),
+    _stream_mutex(nullptr),
+    _stream_thread_quit(false)
 {}
 
 bool AudioEngine::SingletonInitialize()
@@ -142,6 +161,16 @@ bool AudioEngine::SingletonInitialize()
         return false;
     }
 
+    // Start decoding the static audio and refilling the streaming buffers in the background.
+    _audio_decoder = new AudioDecoder();
+
+    _stream_mutex = SDL_CreateMutex();
+    if(_stream_mutex) {
+        _stream_thread = SDL_CreateThread(_StreamThread, "AudioStream", this);
+        if(!_stream_thread)
+            PRINT_WARNING << "Couldn't create the audio streaming thread: " << SDL_GetError() << std::endl;
+    }
+
     return true;
 } // bool AudioEngine::SingletonInitialize()
 
@@ -150,6 +179,20 @@ AudioEngine::~AudioEngine()
     if(!AUDIO_ENABLE)
         return;
 
+    // Stop the streaming thread before any audio is deleted
+    if(_stream_thread) {
+        SDL_LockMutex(_stream_mutex);
+        _stream_thread_quit = true;
+        SDL_UnlockMutex(_stream_mutex);
+        SDL_WaitThread(_stream_thread, nullptr);
+        _stream_thread = nullptr;
+    }
+
+    if(_audio_decoder) {
+        delete _audio_decoder;
+        _audio_decoder = nullptr;
+    }
+
     // Delete all entries in the sound cache
     for(std::map<std::string, private_audio::AudioCacheElement>::iterator i = _audio_cache.begin(); i != _audio_cache.end(); ++i) {
         delete i->second.audio;
@@ -199,9 +242,25 @@ AudioEngine::~AudioEngine()
         }
     }
 
+    // Delete the decoded static audio buffers, now that no descriptor uses them.
+    for(std::map<std::string, StaticAudioCacheElement>::iterator it = _static_audio_cache.begin();
+            it != _static_audio_cache.end(); ++it) {
+        if(it->second.reference_count > 0) {
+            PRINT_WARNING << "This static audio buffer was still used: " << it->first << std::endl;
+        }
+        delete it->second.buffer;
+    }
+    _static_audio_cache.clear();
+    _static_audio_cache_size = 0;
+
     alcMakeContextCurrent(0);
     alcDestroyContext(_context);
     alcCloseDevice(_device);
+
+    if(_stream_mutex) {
+        SDL_DestroyMutex(_stream_mutex);
+        _stream_mutex = nullptr;
+    }
 }
 
 void AudioEngine::Update()
@@ -209,13 +268,58 @@ void AudioEngine::Update()
     if(!AUDIO_ENABLE)
         return;
 
+    PROFILE_SCOPE("AudioEngine::Update");
+
+    AudioStreamLock lock;
+
+    // Fill the static buffers decoded in the background since the last update
+    if(_static_audio_decoding_count > 0) {
+        std::map<std::string, StaticAudioCacheElement>::iterator it = _static_audio_cache.begin();
+        for(; it != _static_audio_cache.end(); ++it) {
+            if(it->second.decoding && _audio_decoder->IsReady(it->first))
+                _PublishStaticBuffer(it->first, it->second);
+        }
+    }
+
+    _active_voice_count = 0;
     for(std::vector<AudioSource *>::iterator i = _audio_sources.begin(); i != _audio_sources.end(); ++i) {
         if((*i)->owner) {
             (*i)->owner->_Update();
+            if((*i)->owner && (*i)->owner->IsPlaying())
+                ++_active_voice_count;
+        }
+    }
+    if(_active_voice_count > _peak_voice_count)
+        _peak_voice_count = _active_voice_count;
+}
+
+void AudioEngine::_UpdateStreams()
+{
+    for(std::vector<AudioSource *>::iterator i = _audio_sources.begin(); i != _audio_sources.end(); ++i) {
+        if((*i)->owner) {
+            (*i)->owner->_UpdateStream();
         }
     }
 }
 
+int AudioEngine::_StreamThread(void* data)
+{
+    AudioEngine* audio_engine = static_cast<AudioEngine*>(data);
+
+    while(true) {
+        SDL_LockMutex(audio_engine->_stream_mutex);
+        if(audio_engine->_stream_thread_quit) {
+            SDL_UnlockMutex(audio_engine->_stream_mutex);
+            break;
+        }
+        audio_engine->_UpdateStreams();
+        SDL_UnlockMutex(audio_engine->_stream_mutex);
+
+        SDL_Delay(AUDIO_STREAM_UPDATE_TIME);
+    }
+    return 0;
+}
+
 void AudioEngine::SetSoundVolume(float volume)
 {
     if(volume < 0.0f) {
@@ -254,6 +358,21 @@ void AudioEngine::SetMusicVolume(float volume)
     }
 }
 
+void AudioEngine::SetStreamingBuffers(uint32_t count, uint32_t duration)
+{
+    if(count < MIN_STREAMING_BUFFER_COUNT || count > MAX_STREAMING_BUFFER_COUNT) {
+        IF_PRINT_WARNING(AUDIO_DEBUG) << "invalid streaming buffer count: " << count << std::endl;
+        count = (count < MIN_STREAMING_BUFFER_COUNT) ? MIN_STREAMING_BUFFER_COUNT : MAX_STREAMING_BUFFER_COUNT;
+    }
+    if(duration == 0) {
+        IF_PRINT_WARNING(AUDIO_DEBUG) << "invalid streaming buffer duration: " << duration << std::endl;
+        duration = DEFAULT_STREAMING_BUFFER_DURATION;
+    }
+
+    _streaming_buffer_count = count;
+    _streaming_buffer_duration = duration;
+}
+
 void AudioEngine::PauseAllSounds()
 {
     for(std::vector<SoundDescriptor *>::iterator i = _registered_sounds.begin();
@@ -332,7 +451,8 @@ void AudioEngine::FadeOutAllSounds(float time)
 {
     for(std::vector<SoundDescriptor *>::iterator it = _registered_sounds.begin();
             it != _registered_sounds.end(); ++it) {
-        if(*it)
+        // The stopped sounds would be left fading out, as only the ones with a source are updated.
+        if(*it && ((*it)->IsPlaying() || (*it)->GetState() == AUDIO_STATE_PAUSED))
             (*it)->FadeOut(time);
     }
 }
@@ -382,6 +502,9 @@ bool AudioEngine::LoadMusic(const std::string &filename, vt_mode_manager::GameMo
 
 void AudioEngine::PlaySound(const std::string &filename)
 {
+    // The sounds already cached are needed as well.
+    vt_system::AssetManifest::RecordAsset(vt_system::ASSET_SOUND, filename);
+
     std::map<std::string, AudioCacheElement>::iterator element = _audio_cache.find(filename);
 
     if(element == _audio_cache.end()) {
@@ -403,6 +526,8 @@ void AudioEngine::PlaySound(const std::string &filename)
 
 void AudioEngine::PlayMusic(const std::string &filename)
 {
+    vt_system::AssetManifest::RecordAsset(vt_system::ASSET_MUSIC, filename);
+
     std::map<std::string, AudioCacheElement>::iterator element = _audio_cache.find(filename);
 
     if(element == _audio_cache.end()) {
@@ -560,6 +685,9 @@ void AudioEngine::DEBUG_PrintInfo()
     PRINT_WARNING << "*** Audio Information ***" << std::endl;
 
     PRINT_WARNING << "Maximum number of sources:   " << _max_sources << std::endl;
+    PRINT_WARNING << "Peak number of voices:       " << _peak_voice_count << std::endl;
+    PRINT_WARNING << "Stolen voices:               " << _stolen_voice_count << std::endl;
+    PRINT_WARNING << "Dropped voices:              " << _dropped_voice_count << std::endl;
     PRINT_WARNING << "Default audio device:        " << alcGetString(_device, ALC_DEFAULT_DEVICE_SPECIFIER) << std::endl;
     PRINT_WARNING << "OpenAL Version:              " << alGetString(AL_VERSION) << std::endl;
     PRINT_WARNING << "OpenAL Renderer:             " << alGetString(AL_RENDERER) << std::endl;
@@ -587,7 +715,7 @@ void AudioEngine::DEBUG_PrintInfo()
     }
 }
 
-private_audio::AudioSource* AudioEngine::_AcquireAudioSource()
+private_audio::AudioSource* AudioEngine::_AcquireAudioSource(AudioDescriptor* requester, bool steal_playing)
 {
     // Find and return the first source that does not have an owner
     for(std::vector<AudioSource *>::iterator i = _audio_sources.begin(); i != _audio_sources.end(); ++i) {
@@ -601,17 +729,181 @@ private_audio::AudioSource* AudioEngine::_AcquireAudioSource()
         }
     }
 
-    // Return nullptr in the (extremely rare) case that all sources are owned and actively playing or paused
-    return nullptr;
+    // Then take the source of a stopped audio, which will acquire another one when played again
+    for(std::vector<AudioSource *>::iterator i = _audio_sources.begin(); i != _audio_sources.end(); ++i) {
+        if((*i)->owner != requester && (*i)->owner->GetState() == AUDIO_STATE_STOPPED) {
+            _StealAudioSource(*i);
+            return *i;
+        }
+    }
+
+    if(!steal_playing)
+        return nullptr;
+
+    // Last, take the source of the least important playing audio, if it is less important than the requester.
+    // The paused audio keep their source, so that they can be resumed.
+    AudioSource* stolen_source = nullptr;
+    AUDIO_PRIORITY lowest_priority = requester->GetPriority();
+    float lowest_volume = requester->GetAudibleVolume();
+    for(std::vector<AudioSource *>::iterator i = _audio_sources.begin(); i != _audio_sources.end(); ++i) {
+        AudioDescriptor* descriptor = (*i)->owner;
+        if(descriptor == requester || !descriptor->IsPlaying())
+            continue;
+
+        AUDIO_PRIORITY priority = descriptor->GetPriority();
+        float volume = descriptor->GetAudibleVolume();
+        if(priority < lowest_priority || (priority == lowest_priority && volume < lowest_volume)) {
+            stolen_source = *i;
+            lowest_priority = priority;
+            lowest_volume = volume;
+        }
+    }
+
+    if(stolen_source == nullptr) {
+        // Return nullptr in the case that all sources are owned by more important audio playing or paused
+        ++_dropped_voice_count;
+        return nullptr;
+    }
+
+    _StealAudioSource(stolen_source);
+    ++_stolen_voice_count;
+    return stolen_source;
+}
+
+void AudioEngine::_StealAudioSource(AudioSource* source)
+{
+    AudioDescriptor* descriptor = source->owner;
+    if(descriptor->GetState() != AUDIO_STATE_STOPPED) {
+        alSourceStop(source->source);
+        descriptor->_state = AUDIO_STATE_STOPPED;
+    }
+    descriptor->_source = nullptr;
+    source->Reset();
+}
+
+
+
+AudioBuffer* AudioEngine::_AcquireStaticBuffer(AudioInput* input, ALenum format)
+{
+    std::map<std::string, StaticAudioCacheElement>::iterator it = _static_audio_cache.find(input->GetFilename());
+    if(it != _static_audio_cache.end()) {
+        ++it->second.reference_count;
+        return it->second.buffer;
+    }
+
+    StaticAudioCacheElement element(nullptr, input->GetDataSize(), format, input->GetSamplesPerSecond());
+
+    // Let the workers decode the audio, several files at once
+    if(_audio_decoder && _audio_decoder->Request(input->GetFilename())) {
+        element.decoding = true;
+        ++_static_audio_decoding_count;
+    } else {
+        // Create space in memory for the audio data to be read and passed to the OpenAL buffer
+        uint8_t* data = new uint8_t[input->GetDataSize()];
+        bool all_data_read = false;
+        if(input->Read(data, input->GetTotalNumberSamples(), all_data_read) != input->GetTotalNumberSamples()) {
+            IF_PRINT_WARNING(AUDIO_DEBUG) << "failed to read entire audio data stream for file: " << input->GetFilename() << std::endl;
+            delete[] data;
+            return nullptr;
+        }
+
+        element.buffer = new AudioBuffer();
+        element.buffer->FillBuffer(data, format, input->GetDataSize(), input->GetSamplesPerSecond());
+        delete[] data;
+    }
+
+    if(element.buffer == nullptr)
+        element.buffer = new AudioBuffer();
+
+    _static_audio_cache.insert(std::make_pair(input->GetFilename(), element));
+    _static_audio_cache_size += input->GetDataSize();
+    _TrimStaticAudioCache();
+    return element.buffer;
+}
+
+bool AudioEngine::_IsStaticBufferDecoding(AudioBuffer* buffer)
+{
+    std::map<std::string, StaticAudioCacheElement>::iterator it = _FindStaticBuffer(buffer);
+    return (it != _static_audio_cache.end() && it->second.decoding);
+}
+
+void AudioEngine::_FinishStaticBuffer(AudioBuffer* buffer)
+{
+    std::map<std::string, StaticAudioCacheElement>::iterator it = _FindStaticBuffer(buffer);
+    if(it != _static_audio_cache.end() && it->second.decoding)
+        _PublishStaticBuffer(it->first, it->second);
+}
+
+void AudioEngine::_PublishStaticBuffer(const std::string& filename, StaticAudioCacheElement& element)
+{
+    element.decoding = false;
+    --_static_audio_decoding_count;
+
+    std::vector<uint8_t> data;
+    if(!_audio_decoder->Take(filename, data) || data.empty()) {
+        IF_PRINT_WARNING(AUDIO_DEBUG) << "failed to decode the audio data stream for file: " << filename << std::endl;
+        return;
+    }
+    element.buffer->FillBuffer(&data[0], element.format, data.size(), element.samples_per_second);
 }
 
+std::map<std::string, StaticAudioCacheElement>::iterator AudioEngine::_FindStaticBuffer(AudioBuffer* buffer)
+{
+    std::map<std::string, StaticAudioCacheElement>::iterator it = _static_audio_cache.begin();
+    for(; it != _static_audio_cache.end(); ++it) {
+        if(it->second.buffer == buffer)
+            break;
+    }
+    return it;
+}
 
+void AudioEngine::_ReleaseStaticBuffer(AudioBuffer* buffer)
+{
+    std::map<std::string, StaticAudioCacheElement>::iterator it = _FindStaticBuffer(buffer);
+    if(it == _static_audio_cache.end() || it->second.reference_count == 0) {
+        IF_PRINT_WARNING(AUDIO_DEBUG) << "released a static audio buffer which wasn't acquired" << std::endl;
+        return;
+    }
+
+    --it->second.reference_count;
+    it->second.last_use_time = SDL_GetTicks();
+    _TrimStaticAudioCache();
+}
+
+void AudioEngine::_TrimStaticAudioCache()
+{
+    while(_static_audio_cache_size > STATIC_AUDIO_CACHE_MAX_MEMORY) {
+        // Find the least recently used buffer which isn't used anymore
+        std::map<std::string, StaticAudioCacheElement>::iterator oldest = _static_audio_cache.end();
+        std::map<std::string, StaticAudioCacheElement>::iterator it = _static_audio_cache.begin();
+        for(; it != _static_audio_cache.end(); ++it) {
+            if(it->second.reference_count > 0)
+                continue;
+            if(oldest == _static_audio_cache.end() || it->second.last_use_time < oldest->second.last_use_time)
+                oldest = it;
+        }
+
+        // Every buffer left is used
+        if(oldest == _static_audio_cache.end())
+            return;
+
+        if(oldest->second.decoding) {
+            _audio_decoder->Cancel(oldest->first);
+            --_static_audio_decoding_count;
+        }
+        _static_audio_cache_size -= oldest->second.size;
+        delete oldest->second.buffer;
+        _static_audio_cache.erase(oldest);
+    }
+}
 
 bool AudioEngine::_LoadAudio(const std::string &filename, bool is_music, vt_mode_manager::GameMode *gm)
 {
-    if(!DoesFileExist(filename))
+    if(!vt_system::DoesAssetExist(filename))
         return false;
 
+    vt_system::AssetManifest::RecordAsset(is_music ? vt_system::ASSET_MUSIC : vt_system::ASSET_SOUND, filename);
+
     std::map<std::string, private_audio::AudioCacheElement>::iterator it = _audio_cache.find(filename);
     if(it != _audio_cache.end()) {
 
@@ -32,6 +32,8 @@
 
 #include <map>
 
+struct SDL_Thread;
+
 //! \brief All related audio engine code is wrapped within this namespace
 namespace vt_audio
 {
@@ -50,9 +52,17 @@ extern bool AUDIO_ENABLE;
 namespace private_audio
 {
 
+class AudioDecoder;
+
 //! \brief The maximum default number of audio sources that the engine tries to create
 const uint16_t MAX_DEFAULT_AUDIO_SOURCES = 64;
 
+//! \brief The time between two refills of the streaming buffers by the streaming thread, in milliseconds.
+const uint32_t AUDIO_STREAM_UPDATE_TIME = 10;
+
+//! \brief The memory the decoded static audio buffers may use once no descriptor uses them anymore, in bytes.
+const uint32_t STATIC_AUDIO_CACHE_MAX_MEMORY = 32 * 1024 * 1024;
+
 
 
 //! \brief A container class for an element of the LRU audio cache managed by the AudioEngine class
@@ -69,6 +79,32 @@ public:
     AudioDescriptor *audio;
 };
 
+//! \brief A container class for a decoded static audio buffer, shared by the descriptors of the same file
+class StaticAudioCacheElement
+{
+public:
+    StaticAudioCacheElement(AudioBuffer *buf, uint32_t buffer_size, ALenum buffer_format, uint32_t frequency) :
+        buffer(buf), size(buffer_size), format(buffer_format), samples_per_second(frequency),
+        reference_count(1), last_use_time(0), decoding(false) {}
+
+    //! \brief The OpenAL buffer holding the decoded audio
+    AudioBuffer *buffer;
+
+    //! \brief The size of the decoded audio in bytes, its format and frequency
+    uint32_t size;
+    ALenum format;
+    uint32_t samples_per_second;
+
+    //! \brief The number of audio descriptors using the buffer
+    uint32_t reference_count;
+
+    //! \brief The time the buffer was last released, to evict the least recently used buffers first
+    uint32_t last_use_time;
+
+    //! \brief True while the audio is decoded in the background, the buffer being still empty
+    bool decoding;
+};
+
 } // namespace private_audio
 
 /** ****************************************************************************
@@ -91,6 +127,7 @@ class AudioEngine : public vt_utils::Singleton<AudioEngine>
     friend class SoundDescriptor;
     friend class MusicDescriptor;
     friend class Effects;
+    friend class private_audio::AudioStreamLock;
 
 public:
     ~AudioEngine();
@@ -100,7 +137,7 @@ public:
     **/
     bool SingletonInitialize();
 
-    //! \brief Updates various parts of the audio state, such as streaming buffers
+    //! \brief Updates various parts of the audio state, such as fades and effects
     void Update();
 
     float GetSoundVolume() const {
@@ -121,6 +158,20 @@ public:
     **/
     void SetMusicVolume(float volume);
 
+    /** \brief Sets the streaming buffers of the audio loaded afterwards
+    *** \param count The number of buffers, clamped to [MIN_STREAMING_BUFFER_COUNT, MAX_STREAMING_BUFFER_COUNT]
+    *** \param duration The duration of each buffer, in milliseconds
+    **/
+    void SetStreamingBuffers(uint32_t count, uint32_t duration);
+
+    uint32_t GetStreamingBufferCount() const {
+        return _streaming_buffer_count;
+    }
+
+    uint32_t GetStreamingBufferDuration() const {
+        return _streaming_buffer_duration;
+    }
+
     /** \name Global Audio State Manipulation Functions
     *** \brief Performs specified operation on all sounds and music.
     ***
@@ -327,6 +378,38 @@ public:
     //! \brief Prints information about the audio properties and settings of the user's machine
     void DEBUG_PrintInfo();
 
+    /** \name Voice usage statistics
+    *** The number of sources playing at the last update and at most, the number of playing audio
+    *** whose source was stolen, and the number of audio which couldn't play for lack of a source.
+    *** They tell whether the game could run with fewer sources.
+    **/
+    //@{
+    uint16_t GetMaxSources() const {
+        return _max_sources;
+    }
+
+    uint16_t GetActiveVoiceCount() const {
+        return _active_voice_count;
+    }
+
+    uint16_t GetPeakVoiceCount() const {
+        return _peak_voice_count;
+    }
+
+    uint32_t GetStolenVoiceCount() const {
+        return _stolen_voice_count;
+    }
+
+    uint32_t GetDroppedVoiceCount() const {
+        return _dropped_voice_count;
+    }
+
+    //! \brief Returns the number of static audio buffers still decoded in the background.
+    uint32_t GetDecodingAudioCount() const {
+        return _static_audio_decoding_count;
+    }
+    //@}
+
 private:
     //! \note Constructors are kept private since this class is a singleton
     //@{
@@ -355,6 +438,18 @@ private:
     //! \brief Contains the maximum number of available audio sources that can exist simultaneously
     uint16_t _max_sources;
 
+    //! \brief The voice usage statistics
+    //@{
+    uint16_t _active_voice_count;
+    uint16_t _peak_voice_count;
+    uint32_t _stolen_voice_count;
+    uint32_t _dropped_voice_count;
+    //@}
+
+    //! \brief The number of streaming buffers, and their duration in milliseconds, of the audio loaded for streaming
+    uint32_t _streaming_buffer_count;
+    uint32_t _streaming_buffer_duration;
+
     //! \brief The listener properties used by audio which plays in a multi-dimensional space
     //@{
     float _listener_position[3];
@@ -368,6 +463,16 @@ private:
     //! \brief Contains all available audio sources
     std::vector<private_audio::AudioSource *> _audio_sources;
 
+    /** \brief The thread refilling the streaming buffers, so that they don't run dry during a long frame
+    *** The mutex protects the audio descriptors state, and the quit flag. It is taken through AudioStreamLock.
+    *** The thread is nullptr when it couldn't be created, and the buffers are then refilled in Update().
+    **/
+    //@{
+    SDL_Thread* _stream_thread;
+    SDL_mutex* _stream_mutex;
+    bool _stream_thread_quit;
+    //@}
+
     /** \brief Lists of pointers to all audio descriptor objects which have been created by the user
     *** These lists are kept so that when the global sound or music volume levels are changed, all
     *** sound and music objects will also have their volumes updated.
@@ -391,10 +496,32 @@ private:
     **/
     std::map<std::string, private_audio::AudioCacheElement> _audio_cache;
 
+    /** \brief The decoded static audio buffers, by filename
+    *** The buffers stay decoded once no descriptor uses them anymore, so that the sounds
+    *** reloaded at each game mode change, like the battle ones, aren't decoded again.
+    *** The least recently used of those are deleted when the cache memory goes over
+    *** STATIC_AUDIO_CACHE_MAX_MEMORY.
+    **/
+    std::map<std::string, private_audio::StaticAudioCacheElement> _static_audio_cache;
+
+    //! \brief The memory used by the decoded static audio buffers, in bytes
+    uint32_t _static_audio_cache_size;
+
+    //! \brief The worker threads decoding the static audio, and the number of buffers waiting for them
+    private_audio::AudioDecoder *_audio_decoder;
+    uint32_t _static_audio_decoding_count;
+
     /** \brief Acquires an available audio source that may be used
+    *** \param requester The audio descriptor requesting the source
+    *** \param steal_playing When true and no source is free, the source of the playing audio
+    *** with the lowest priority, then the lowest audible volume, is taken if it is below the requester ones.
     *** \return A pointer to the available source, or nullptr if no available source could be found
+    *** The sources of the stopped audio are taken before failing, since they are only kept to be played again.
     **/
-    private_audio::AudioSource *_AcquireAudioSource();
+    private_audio::AudioSource *_AcquireAudioSource(AudioDescriptor *requester, bool steal_playing);
+
+    //! \brief Takes the source back from its audio descriptor, stopping it.
+    void _StealAudioSource(private_audio::AudioSource *source);
 
     /** \brief A helper function to LoadSound and LoadMusic that takes care of the messy details of cache managment
     *** \param filename The filename of the audio to load
@@ -405,6 +532,40 @@ private:
     **/
     bool _LoadAudio(const std::string &filename, bool is_music, vt_mode_manager::GameMode *gm = nullptr);
 
+    /** \brief Gives the decoded buffer of a static audio file, decoding it when it isn't cached
+    *** \param input The initialized audio input of the file
+    *** \param format The OpenAL format of the audio data
+    *** \return The shared buffer, or nullptr if the audio couldn't be decoded.
+    *** The buffer must be given back with _ReleaseStaticBuffer().
+    *** The audio is decoded in the background when possible, the buffer is then filled
+    *** by Update() once decoded, or by _FinishStaticBuffer() when needed earlier.
+    **/
+    private_audio::AudioBuffer *_AcquireStaticBuffer(private_audio::AudioInput *input, ALenum format);
+
+    //! \brief Tells whether a static audio buffer is still being decoded in the background.
+    bool _IsStaticBufferDecoding(private_audio::AudioBuffer *buffer);
+
+    //! \brief Waits for a static audio buffer to be decoded, and fills it, before it is attached to a source.
+    void _FinishStaticBuffer(private_audio::AudioBuffer *buffer);
+
+    //! \brief Fills a static audio buffer with its audio decoded in the background, waiting for it if needed.
+    void _PublishStaticBuffer(const std::string &filename, private_audio::StaticAudioCacheElement &element);
+
+    //! \brief Returns the cache element of a static buffer, or the end of the cache if it isn't in.
+    std::map<std::string, private_audio::StaticAudioCacheElement>::iterator _FindStaticBuffer(private_audio::AudioBuffer *buffer);
+
+    //! \brief Tells a static audio buffer is no longer used by a descriptor.
+    void _ReleaseStaticBuffer(private_audio::AudioBuffer *buffer);
+
+    //! \brief Deletes the least recently used unused static buffers, until the cache fits in its memory.
+    void _TrimStaticAudioCache();
+
+    //! \brief Refills the buffers of every streamed audio playing. Called with the stream mutex taken.
+    void _UpdateStreams();
+
+    //! \brief The streaming thread function, refilling the buffers every AUDIO_STREAM_UPDATE_TIME.
+    static int _StreamThread(void* data);
+
 }; // class AudioEngine : public vt_utils::Singleton<AudioEngine>
 
 } // namespace vt_audio
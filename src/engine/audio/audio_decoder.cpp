@@ -0,0 +1,246 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    audio_decoder.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for decoding the static audio files in background threads.
+*** ***************************************************************************/
+
+#include "engine/audio/audio_decoder.h"
+
+#include "engine/audio/audio_input.h"
+
+#include "utils/exception.h"
+#include "utils/utils_common.h"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+
+namespace vt_audio
+{
+
+extern bool AUDIO_DEBUG;
+
+namespace private_audio
+{
+
+//! \brief The maximum number of worker threads, one core being left to the main thread.
+const int32_t AUDIO_DECODER_MAX_THREADS = 4;
+
+AudioDecoder::AudioDecoder() :
+    _mutex(SDL_CreateMutex()),
+    _job_queued(SDL_CreateCond()),
+    _job_done(SDL_CreateCond()),
+    _quit(false)
+{
+    if (_mutex == nullptr || _job_queued == nullptr || _job_done == nullptr) {
+        PRINT_ERROR << "Couldn't create the audio decoder synchronization objects: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    const int32_t number_of_threads = std::max(1, std::min(AUDIO_DECODER_MAX_THREADS, SDL_GetCPUCount() - 1));
+    for (int32_t i = 0; i < number_of_threads; ++i) {
+        SDL_Thread* thread = SDL_CreateThread(_WorkerThread, "AudioDecoder", this);
+        if (thread == nullptr) {
+            IF_PRINT_WARNING(AUDIO_DEBUG) << "Couldn't create an audio decoder thread: " << SDL_GetError() << std::endl;
+            break;
+        }
+        _threads.push_back(thread);
+    }
+}
+
+AudioDecoder::~AudioDecoder()
+{
+    // Stop the workers once their current file is decoded.
+    if (_mutex != nullptr) {
+        SDL_LockMutex(_mutex);
+        _quit = true;
+        SDL_CondBroadcast(_job_queued);
+        SDL_UnlockMutex(_mutex);
+    }
+
+    for (uint32_t i = 0; i < _threads.size(); ++i)
+        SDL_WaitThread(_threads[i], nullptr);
+    _threads.clear();
+
+    for (auto it = _jobs.begin(); it != _jobs.end(); ++it)
+        delete it->second;
+    _jobs.clear();
+    _queue.clear();
+
+    if (_job_done != nullptr)
+        SDL_DestroyCond(_job_done);
+    if (_job_queued != nullptr)
+        SDL_DestroyCond(_job_queued);
+    if (_mutex != nullptr)
+        SDL_DestroyMutex(_mutex);
+}
+
+bool AudioDecoder::Request(const std::string& filename)
+{
+    if (_threads.empty())
+        return false;
+
+    SDL_LockMutex(_mutex);
+
+    if (_jobs.find(filename) == _jobs.end()) {
+        _Job* job = new _Job(filename);
+        _jobs[filename] = job;
+        _queue.push_back(job);
+        SDL_CondSignal(_job_queued);
+    }
+
+    SDL_UnlockMutex(_mutex);
+    return true;
+}
+
+bool AudioDecoder::IsReady(const std::string& filename) const
+{
+    if (_threads.empty())
+        return false;
+
+    SDL_LockMutex(_mutex);
+    auto it = _jobs.find(filename);
+    const bool ready = (it != _jobs.end() && it->second->done);
+    SDL_UnlockMutex(_mutex);
+
+    return ready;
+}
+
+bool AudioDecoder::Take(const std::string& filename, std::vector<uint8_t>& data)
+{
+    if (_threads.empty())
+        return false;
+
+    SDL_LockMutex(_mutex);
+
+    auto it = _jobs.find(filename);
+    if (it == _jobs.end()) {
+        SDL_UnlockMutex(_mutex);
+        return false;
+    }
+
+    _Job* job = it->second;
+    while (!job->done)
+        SDL_CondWait(_job_done, _mutex);
+
+    _jobs.erase(it);
+    SDL_UnlockMutex(_mutex);
+
+    // The job isn't shared anymore.
+    const bool success = job->success;
+    if (success)
+        data.swap(job->data);
+    else
+        IF_PRINT_WARNING(AUDIO_DEBUG) << "Couldn't decode audio file: " << filename << std::endl;
+
+    delete job;
+    return success;
+}
+
+void AudioDecoder::Cancel(const std::string& filename)
+{
+    if (_threads.empty())
+        return;
+
+    SDL_LockMutex(_mutex);
+
+    auto it = _jobs.find(filename);
+    if (it != _jobs.end()) {
+        _Job* job = it->second;
+        _jobs.erase(it);
+
+        auto queued = std::find(_queue.begin(), _queue.end(), job);
+        if (queued != _queue.end()) {
+            _queue.erase(queued);
+            delete job;
+        } else if (job->done) {
+            delete job;
+        } else {
+            // Being decoded: the worker will delete it.
+            job->cancelled = true;
+        }
+    }
+
+    SDL_UnlockMutex(_mutex);
+}
+
+int AudioDecoder::_WorkerThread(void* audio_decoder)
+{
+    static_cast<AudioDecoder*>(audio_decoder)->_Work();
+    return 0;
+}
+
+void AudioDecoder::_Work()
+{
+    SDL_LockMutex(_mutex);
+
+    while (true) {
+        while (!_quit && _queue.empty())
+            SDL_CondWait(_job_queued, _mutex);
+
+        if (_quit)
+            break;
+
+        _Job* job = _queue.front();
+        _queue.pop_front();
+
+        // Decode without holding the lock. Nobody else touches the job
+        // until it is marked as done.
+        SDL_UnlockMutex(_mutex);
+        const bool success = _Decode(job->filename, job->data);
+        SDL_LockMutex(_mutex);
+
+        if (job->cancelled) {
+            delete job;
+            continue;
+        }
+
+        job->success = success;
+        job->done = true;
+        SDL_CondBroadcast(_job_done);
+    }
+
+    SDL_UnlockMutex(_mutex);
+}
+
+bool AudioDecoder::_Decode(const std::string& filename, std::vector<uint8_t>& data)
+{
+    AudioInput* input = CreateAudioInput(filename);
+    if (input == nullptr)
+        return false;
+
+    bool success = input->Initialize();
+    if (success) {
+        data.resize(input->GetDataSize());
+        bool all_data_read = false;
+        success = (data.empty() ||
+                   input->Read(&data[0], input->GetTotalNumberSamples(), all_data_read) == input->GetTotalNumberSamples());
+    }
+
+    delete input;
+    return success;
+}
+
+AudioDecoder::AudioDecoder(const AudioDecoder&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+AudioDecoder& AudioDecoder::operator=(const AudioDecoder&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace private_audio
+
+} // namespace vt_audio
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    audio_decoder.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for decoding the static audio files in background threads.
+***
+*** Decoding a whole Ogg file is done entirely on the CPU, so the static sounds
+*** loaded one after another at boot or battle start are decoded by worker
+*** threads, several at once. Only the filling of the OpenAL buffers with the
+*** decoded data is done by the main thread.
+*** ***************************************************************************/
+
+#ifndef __AUDIO_DECODER_HEADER__
+#define __AUDIO_DECODER_HEADER__
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+namespace vt_audio
+{
+
+namespace private_audio
+{
+
+/** ****************************************************************************
+*** \brief A pool of threads decoding entire audio files in memory.
+***
+*** Audio files are requested when loaded, decoded in the background, and then
+*** taken by the main thread when they are played or once decoded, waiting only
+*** if their decoding isn't finished yet.
+*** ***************************************************************************/
+class AudioDecoder
+{
+public:
+    AudioDecoder();
+    ~AudioDecoder();
+
+    /** \brief Starts decoding an audio file in the background.
+    *** \return False if there are no worker threads, the file must then be decoded by the caller.
+    *** \note Nothing is done if the file was already requested.
+    **/
+    bool Request(const std::string& filename);
+
+    //! \brief Tells whether a requested file is decoded and can be taken without waiting.
+    bool IsReady(const std::string& filename) const;
+
+    /** \brief Takes a requested file data, waiting for its decoding to finish if needed.
+    *** \param filename The audio file requested.
+    *** \param data Filled with the decoded audio data.
+    *** \return False if the file wasn't requested or couldn't be decoded.
+    **/
+    bool Take(const std::string& filename, std::vector<uint8_t>& data);
+
+    //! \brief Forgets a requested file that finally isn't needed.
+    void Cancel(const std::string& filename);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    AudioDecoder(const AudioDecoder& audio_decoder);
+    AudioDecoder& operator=(const AudioDecoder& audio_decoder);
+
+    //! \brief An audio file to decode, shared between the main thread and a worker.
+    class _Job
+    {
+    public:
+        _Job(const std::string& filename_) :
+            filename(filename_),
+            done(false),
+            success(false),
+            cancelled(false)
+        {}
+
+        std::string filename;
+        std::vector<uint8_t> data;
+
+        //! \brief Set by the worker once the file is decoded, successfully or not.
+        bool done;
+        bool success;
+
+        //! \brief Set when the file isn't needed anymore while being decoded.
+        //! The worker then deletes the job itself.
+        bool cancelled;
+    };
+
+    //! \brief The requested files not taken yet, by filename.
+    std::map<std::string, _Job*> _jobs;
+
+    //! \brief The requested files not being decoded yet, in request order.
+    std::deque<_Job*> _queue;
+
+    //! \brief The worker threads.
+    std::vector<SDL_Thread*> _threads;
+
+    //! \brief Protects all the members above and the jobs.
+    SDL_mutex* _mutex;
+
+    //! \brief Signaled when a job is queued, or when the workers must stop.
+    SDL_cond* _job_queued;
+
+    //! \brief Signaled when a job is done.
+    SDL_cond* _job_done;
+
+    //! \brief Tells the workers to stop.
+    bool _quit;
+
+    //! \brief The entry point of the worker threads.
+    static int _WorkerThread(void* audio_decoder);
+
+    //! \brief Decodes the queued files until told to stop.
+    void _Work();
+
+    //! \brief Decodes a whole audio file.
+    static bool _Decode(const std::string& filename, std::vector<uint8_t>& data);
+};
+
+} // namespace private_audio
+
+} // namespace vt_audio
+
+#endif // __AUDIO_DECODER_HEADER__
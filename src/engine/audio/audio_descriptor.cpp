@@ -25,11 +25,14 @@
 #include "audio_descriptor.h"
 
 #include "audio.h"
+#include "engine/memory_stats.h"
 #include "engine/system.h"
 
 #include "utils/utils_common.h"
 #include "utils/utils_strings.h"
 
+#include <SDL2/SDL.h>
+
 #include <cstring>
 
 using namespace vt_audio::private_audio;
@@ -40,12 +43,30 @@ namespace vt_audio
 namespace private_audio
 {
 
+////////////////////////////////////////////////////////////////////////////////
+// AudioStreamLock class methods
+////////////////////////////////////////////////////////////////////////////////
+
+AudioStreamLock::AudioStreamLock() :
+    _mutex(AudioManager ? AudioManager->_stream_mutex : nullptr)
+{
+    if(_mutex)
+        SDL_LockMutex(_mutex);
+}
+
+AudioStreamLock::~AudioStreamLock()
+{
+    if(_mutex)
+        SDL_UnlockMutex(_mutex);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // AudioBuffer class methods
 ////////////////////////////////////////////////////////////////////////////////
 
 AudioBuffer::AudioBuffer() :
-    buffer(0)
+    buffer(0),
+    size(0)
 {
     if(AudioManager->CheckALError()) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "OpenAL error detected before buffer generation: " << AudioManager->CreateALErrorString() << std::endl;
@@ -65,6 +86,17 @@ AudioBuffer::~AudioBuffer()
     if(IsValid()) {
         alDeleteBuffers(1, &buffer);
     }
+    vt_system::MemoryStats::Remove(vt_system::MEMORY_AUDIO, size);
+}
+
+void AudioBuffer::FillBuffer(uint8_t *data, ALenum format, uint32_t size_, uint32_t frequency)
+{
+    alBufferData(buffer, format, data, size_, frequency);
+
+    // The streams refill their buffers with data of about the same size.
+    vt_system::MemoryStats::Remove(vt_system::MEMORY_AUDIO, size);
+    vt_system::MemoryStats::Add(vt_system::MEMORY_AUDIO, size_);
+    size = size_;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,7 +151,10 @@ AudioDescriptor::AudioDescriptor() :
     _volume(1.0f),
     _fade_effect_time(0.0f),
     _original_volume(0.0f),
-    _stream_buffer_size(0)
+    _fade_applied_volume(0.0f),
+    _priority(AUDIO_PRIORITY_COMBAT),
+    _stream_buffer_size(0),
+    _stream_buffer_count(0)
 {
     _position[0] = 0.0f;
     _position[1] = 0.0f;
@@ -144,7 +179,10 @@ AudioDescriptor::AudioDescriptor(const AudioDescriptor &copy) :
     _volume(copy._volume),
     _fade_effect_time(copy._fade_effect_time),
     _original_volume(copy._original_volume),
-    _stream_buffer_size(0)
+    _fade_applied_volume(copy._fade_applied_volume),
+    _priority(copy._priority),
+    _stream_buffer_size(0),
+    _stream_buffer_count(0)
 {
     _position[0] = 0.0f;
     _position[1] = 0.0f;
@@ -167,25 +205,15 @@ bool AudioDescriptor::LoadAudio(const std::string &filename, AUDIO_LOAD load_typ
     if(!AUDIO_ENABLE)
         return true;
 
+    AudioStreamLock lock;
+
     // Clean out any audio resources being used before trying to set new ones
     FreeAudio();
 
-    // Load the input file for the audio
-    if(filename.size() <= 3) {  // Name of file is at least 3 letters (so the extension is in there)
-        IF_PRINT_WARNING(AUDIO_DEBUG) << "file name argument is too short: " << filename << std::endl;
-        return false;
-    }
-    // Convert the file extension to uppercase and use it to create the proper input type
-    std::string file_extension = filename.substr(filename.size() - 3, 3);
-    file_extension = vt_utils::Upcase(file_extension);
-
-    // Based on the extension of the file, load properly one
-    if(file_extension.compare("WAV") == 0) {
-        _input = new WavFile(filename);
-    } else if(file_extension.compare("OGG") == 0) {
-        _input = new OggFile(filename);
-    } else {
-        IF_PRINT_WARNING(AUDIO_DEBUG) << "failed due to unsupported input file extension: " << file_extension << std::endl;
+    // Load the input file for the audio, based on the extension of the file
+    _input = CreateAudioInput(filename);
+    if(_input == nullptr) {
+        IF_PRINT_WARNING(AUDIO_DEBUG) << "failed due to unsupported input file extension: " << filename << std::endl;
         return false;
     }
 
@@ -211,35 +239,30 @@ bool AudioDescriptor::LoadAudio(const std::string &filename, AUDIO_LOAD load_typ
 
     // Load the audio data depending upon the load type requested
     if(load_type == AUDIO_LOAD_STATIC) {
-        // For static sounds just 1 buffer is needed. We create it as an array here, so that
-        // later we can delete it with a call of delete[], similar to the streaming cases
-        _buffer = new AudioBuffer[1];
-
-        // Create space in memory for the audio data to be read and passed to the OpenAL buffer
-        _data = new uint8_t[_input->GetDataSize()];
-        bool all_data_read = false;
-        if(_input->Read(_data, _input->GetTotalNumberSamples(), all_data_read) != _input->GetTotalNumberSamples()) {
-            IF_PRINT_WARNING(AUDIO_DEBUG) << "failed to read entire audio data stream for file: " << filename << std::endl;
+        // For static sounds just 1 buffer is needed. It is shared with the other descriptors
+        // of the same file, and kept decoded by the audio engine once freed.
+        _buffer = AudioManager->_AcquireStaticBuffer(_input, _format);
+        if(_buffer == nullptr) {
+            IF_PRINT_WARNING(AUDIO_DEBUG) << "failed to decode the audio data for file: " << filename << std::endl;
             return false;
         }
 
-        // Pass the buffer data to the OpenAL buffer
-        _buffer->FillBuffer(_data, _format, _input->GetDataSize(), _input->GetSamplesPerSecond());
-        delete[] _data;
-        _data = nullptr;
-
-        // Attempt to acquire a source for the new audio to use
-        _AcquireSource();
-        if(_source == nullptr) {
-            IF_PRINT_WARNING(AUDIO_DEBUG) << "could not acquire audio source for new audio file: " << filename << std::endl;
+        // Attempt to acquire a source for the new audio to use.
+        // When the audio is being decoded in the background, the source is acquired when played,
+        // so that the loading doesn't wait for the decoding.
+        if(!AudioManager->_IsStaticBufferDecoding(_buffer)) {
+            _AcquireSource();
+            if(_source == nullptr) {
+                IF_PRINT_WARNING(AUDIO_DEBUG) << "could not acquire audio source for new audio file: " << filename << std::endl;
+            }
         }
     } // if (load_type == AUDIO_LOAD_STATIC)
 
     // Stream the audio from the file data
     else if(load_type == AUDIO_LOAD_STREAM_FILE) {
-        _buffer = new AudioBuffer[NUMBER_STREAMING_BUFFERS]; // For streaming we need to use multiple buffers
+        _SetStreamingBuffers(stream_buffer_size);
+        _buffer = new AudioBuffer[_stream_buffer_count]; // For streaming we need to use multiple buffers
         _stream = new AudioStream(_input, _looping);
-        _stream_buffer_size = stream_buffer_size;
 
         _data = new uint8_t[_stream_buffer_size * _input->GetSampleSize()];
 
@@ -252,9 +275,9 @@ bool AudioDescriptor::LoadAudio(const std::string &filename, AUDIO_LOAD load_typ
 
     // Allocate memory for the audio data to remain in and stream it from that location
     else if(load_type == AUDIO_LOAD_STREAM_MEMORY) {
-        _buffer = new AudioBuffer[NUMBER_STREAMING_BUFFERS]; // For streaming we need to use multiple buffers
+        _SetStreamingBuffers(stream_buffer_size);
+        _buffer = new AudioBuffer[_stream_buffer_count]; // For streaming we need to use multiple buffers
         _stream = new AudioStream(_input, _looping);
-        _stream_buffer_size = stream_buffer_size;
 
         _data = new uint8_t[_stream_buffer_size * _input->GetSampleSize()];
 
@@ -284,6 +307,8 @@ bool AudioDescriptor::LoadAudio(const std::string &filename, AUDIO_LOAD load_typ
 
 void AudioDescriptor::FreeAudio()
 {
+    AudioStreamLock lock;
+
     // First, remove any effects.
     RemoveEffects();
 
@@ -300,7 +325,11 @@ void AudioDescriptor::FreeAudio()
     }
 
     if(_buffer != nullptr) {
-        delete[] _buffer;
+        // The static buffers belong to the audio engine cache
+        if(_stream != nullptr)
+            delete[] _buffer;
+        else
+            AudioManager->_ReleaseStaticBuffer(_buffer);
         _buffer = nullptr;
     }
 
@@ -318,6 +347,8 @@ void AudioDescriptor::FreeAudio()
         delete[] _data;
         _data = nullptr;
     }
+
+    _free_stream_buffers.clear();
 }
 
 bool AudioDescriptor::Play()
@@ -325,11 +356,13 @@ bool AudioDescriptor::Play()
     if(!AUDIO_ENABLE)
         return true;
 
+    AudioStreamLock lock;
+
     if(_state == AUDIO_STATE_PLAYING)
         return true;
 
     if(!_source) {
-        _AcquireSource();
+        _AcquireSource(true);
         if(!_source) {
             IF_PRINT_WARNING(AUDIO_DEBUG) << "did not have access to valid AudioSource" << std::endl;
             return false;
@@ -357,6 +390,8 @@ bool AudioDescriptor::Play()
 
 void AudioDescriptor::Stop()
 {
+    AudioStreamLock lock;
+
     if(_state == AUDIO_STATE_STOPPED || _state == AUDIO_STATE_UNLOADED)
         return;
 
@@ -379,6 +414,8 @@ void AudioDescriptor::Stop()
 
 void AudioDescriptor::Pause()
 {
+    AudioStreamLock lock;
+
     if(_state == AUDIO_STATE_PAUSED || _state == AUDIO_STATE_UNLOADED)
         return;
 
@@ -404,6 +441,8 @@ void AudioDescriptor::Resume()
 
 void AudioDescriptor::Rewind()
 {
+    AudioStreamLock lock;
+
     if(_source == nullptr) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "did not have access to valid AudioSource" << std::endl;
         return;
@@ -417,6 +456,8 @@ void AudioDescriptor::Rewind()
 
 void AudioDescriptor::SetLooping(bool loop)
 {
+    AudioStreamLock lock;
+
     if(_looping == loop)
         return;
 
@@ -433,6 +474,8 @@ void AudioDescriptor::SetLooping(bool loop)
 
 void AudioDescriptor::SetLoopStart(uint32_t loop_start)
 {
+    AudioStreamLock lock;
+
     if(_stream == nullptr) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "the audio data was not loaded with streaming properties, this operation is not permitted" << std::endl;
         return;
@@ -442,6 +485,8 @@ void AudioDescriptor::SetLoopStart(uint32_t loop_start)
 
 void AudioDescriptor::SetLoopEnd(uint32_t loop_end)
 {
+    AudioStreamLock lock;
+
     if(_stream == nullptr) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "the audio data was not loaded with streaming properties, this operation is not permitted" << std::endl;
         return;
@@ -451,6 +496,8 @@ void AudioDescriptor::SetLoopEnd(uint32_t loop_end)
 
 void AudioDescriptor::SeekSample(uint32_t sample)
 {
+    AudioStreamLock lock;
+
     if(!_input)
         return;
     if(sample >= _input->GetTotalNumberSamples()) {
@@ -473,6 +520,8 @@ void AudioDescriptor::SeekSample(uint32_t sample)
 
 uint32_t AudioDescriptor::GetCurrentSampleNumber() const
 {
+    AudioStreamLock lock;
+
     if(_stream) {
         return _stream->GetCurrentSamplePosition();
     } else if(_source != nullptr) {
@@ -493,6 +542,8 @@ uint32_t AudioDescriptor::GetCurrentSampleNumber() const
 
 void AudioDescriptor::SeekSecond(float second)
 {
+    AudioStreamLock lock;
+
     if(second < 0.0f) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "function received invalid argument that was less than 0.0f: " << second << std::endl;
         return;
@@ -564,6 +615,13 @@ void AudioDescriptor::SetDirection(const ALfloat direction[ALFLOAT3D])
     }
 }
 
+float AudioDescriptor::GetAudibleVolume() const
+{
+    if(IsSound())
+        return _volume * AudioManager->GetSoundVolume();
+    return _volume * AudioManager->GetMusicVolume();
+}
+
 void AudioDescriptor::AddGameModeOwner(vt_mode_manager::GameMode *gm)
 {
     // Don't accept null references.
@@ -619,6 +677,8 @@ bool AudioDescriptor::RemoveGameModeOwner(vt_mode_manager::GameMode* gm)
 
 void AudioDescriptor::FadeIn(float time)
 {
+    AudioStreamLock lock;
+
     // If the sound is not playing, then start it.
     // Note: Only audio descriptors being played are updated.
     if(_state != AUDIO_STATE_PLAYING)
@@ -629,10 +689,13 @@ void AudioDescriptor::FadeIn(float time)
 
     _state = AUDIO_STATE_FADE_IN;
     _fade_effect_time = time;
+    _fade_applied_volume = GetVolume();
 }
 
 void AudioDescriptor::FadeOut(float time)
 {
+    AudioStreamLock lock;
+
     _original_volume = GetVolume();
 
     if (_original_volume <= 0.0f) {
@@ -642,6 +705,7 @@ void AudioDescriptor::FadeOut(float time)
 
     _fade_effect_time = time;
     _state = AUDIO_STATE_FADE_OUT;
+    _fade_applied_volume = _original_volume;
 }
 
 void AudioDescriptor::RemoveEffects()
@@ -698,6 +762,7 @@ void AudioDescriptor::DEBUG_PrintInfo()
     if(_stream != nullptr) {
         PRINT_WARNING << "Audio load type:    streamed" << std::endl;
         PRINT_WARNING << "Stream buffer size (samples): " << _stream_buffer_size << std::endl;
+        PRINT_WARNING << "Stream buffer count: " << _stream_buffer_count << std::endl;
     } else {
         PRINT_WARNING << "Audio load type:    static" << std::endl;
     }
@@ -737,7 +802,8 @@ void AudioDescriptor::_Update()
         if(AudioManager->CheckALError()) {
             IF_PRINT_WARNING(AUDIO_DEBUG) << "getting the source's state failed: " << AudioManager->CreateALErrorString() << std::endl;
         }
-        if(source_state != AL_PLAYING) {
+        // A streamed audio whose buffers ran dry is restarted once they are refilled.
+        if(source_state != AL_PLAYING && (!_stream || _stream->GetEndOfStream())) {
             _state = AUDIO_STATE_STOPPED;
         }
     }
@@ -758,21 +824,22 @@ void AudioDescriptor::_Update()
         }
     }
 
-    // Only streaming audio that is being played requires periodic updates
+    // Only streaming audio that is being played requires periodic updates.
+    // Once the end of stream is reached, the audio stops with the source, after the buffers decoded ahead.
     if(!_stream)
         return;
 
-    ALint queued = 0;
-    alGetSourcei(_source->source, AL_BUFFERS_QUEUED, &queued);
-    if(AudioManager->CheckALError()) {
-        IF_PRINT_WARNING(AUDIO_DEBUG) << "getting queued sources failed: " << AudioManager->CreateALErrorString() << std::endl;
-    }
+    // Without a streaming thread, the buffers are refilled once per frame.
+    if(!AudioManager->_stream_thread)
+        _UpdateStream();
+} // void AudioDescriptor::_Update()
 
-    // If there are no more buffers and the end of stream was reached, stop the sound
-    if(queued != 0 && _stream->GetEndOfStream()) {
-        _state = AUDIO_STATE_STOPPED;
+void AudioDescriptor::_UpdateStream()
+{
+    if(!_stream || !_source)
+        return;
+    if(_state != AUDIO_STATE_PLAYING && _state != AUDIO_STATE_FADE_IN && _state != AUDIO_STATE_FADE_OUT)
         return;
-    }
 
     ALint buffers_processed = 0;
     alGetSourcei(_source->source, AL_BUFFERS_PROCESSED, &buffers_processed);
@@ -780,38 +847,51 @@ void AudioDescriptor::_Update()
         IF_PRINT_WARNING(AUDIO_DEBUG) << "getting processed sources failed: " << AudioManager->CreateALErrorString() << std::endl;
     }
 
-    // If any buffers have finished playing, attempt to refill them
-    if(buffers_processed > 0) {
+    // Every buffer which finished playing can be filled again
+    for(ALint i = 0; i < buffers_processed; ++i) {
         ALuint buffer_finished;
         alSourceUnqueueBuffers(_source->source, 1, &buffer_finished);
         if(AudioManager->CheckALError()) {
             IF_PRINT_WARNING(AUDIO_DEBUG) << "unqueuing a source failed: " << AudioManager->CreateALErrorString() << std::endl;
+            break;
         }
+        _free_stream_buffers.push_back(buffer_finished);
+    }
 
+    // Decode ahead into every free buffer
+    bool buffers_refilled = false;
+    while(!_free_stream_buffers.empty()) {
         uint32_t size = _stream->FillBuffer(_data, _stream_buffer_size);
-        if(size > 0) {  // Make sure that there is data available to fill
-            alBufferData(buffer_finished, _format, _data, size * _input->GetSampleSize(), _input->GetSamplesPerSecond());
-            if(AudioManager->CheckALError()) {
-                IF_PRINT_WARNING(AUDIO_DEBUG) << "buffering data failed: " << AudioManager->CreateALErrorString() << std::endl;
-            }
-            alSourceQueueBuffers(_source->source, 1, &buffer_finished);
-            if(AudioManager->CheckALError()) {
-                IF_PRINT_WARNING(AUDIO_DEBUG) << "queueing a source failed: " << AudioManager->CreateALErrorString() << std::endl;
-            }
+        if(size == 0) // No more data available to fill
+            break;
+
+        ALuint buffer = _free_stream_buffers.back();
+        alBufferData(buffer, _format, _data, size * _input->GetSampleSize(), _input->GetSamplesPerSecond());
+        if(AudioManager->CheckALError()) {
+            IF_PRINT_WARNING(AUDIO_DEBUG) << "buffering data failed: " << AudioManager->CreateALErrorString() << std::endl;
+        }
+        alSourceQueueBuffers(_source->source, 1, &buffer);
+        if(AudioManager->CheckALError()) {
+            IF_PRINT_WARNING(AUDIO_DEBUG) << "queueing a source failed: " << AudioManager->CreateALErrorString() << std::endl;
         }
+        _free_stream_buffers.pop_back();
+        buffers_refilled = true;
+    }
 
-        // This ensures that if a streaming audio piece is stopped because the buffers ran out
-        // of audio data for the source to play, the audio will be automatically replayed again.
-        ALint state;
-        alGetSourcei(_source->source, AL_SOURCE_STATE, &state);
-        if(state != AL_PLAYING) {
-            alSourcePlay(_source->source);
-            if(AudioManager->CheckALError()) {
-                IF_PRINT_WARNING(AUDIO_DEBUG) << "playing a source failed: " << AudioManager->CreateALErrorString() << std::endl;
-            }
+    if(!buffers_refilled)
+        return;
+
+    // This ensures that if a streaming audio piece is stopped because the buffers ran out
+    // of audio data for the source to play, the audio will be automatically replayed again.
+    ALint state;
+    alGetSourcei(_source->source, AL_SOURCE_STATE, &state);
+    if(state != AL_PLAYING) {
+        alSourcePlay(_source->source);
+        if(AudioManager->CheckALError()) {
+            IF_PRINT_WARNING(AUDIO_DEBUG) << "playing a source failed: " << AudioManager->CreateALErrorString() << std::endl;
         }
     }
-} // void AudioDescriptor::_Update()
+} // void AudioDescriptor::_UpdateStream()
 
 
 void AudioDescriptor::_HandleFadeStates()
@@ -824,7 +904,7 @@ void AudioDescriptor::_HandleFadeStates()
             return;
         }
 
-        float time_elapsed = (float)vt_system::SystemManager->GetUpdateTime();
+        float time_elapsed = (float)vt_system::SystemManager->GetFrameTime();
         float new_volume = GetVolume() - (_original_volume - (_original_volume - (time_elapsed / _fade_effect_time)));
 
         // Stop the audio, and terminate the effect if the volume drops to 0.0f or below
@@ -835,7 +915,7 @@ void AudioDescriptor::_HandleFadeStates()
         }
         // Otherwise, update the volume for the audio
         else {
-            SetVolume(new_volume);
+            _SetFadeVolume(new_volume);
             return;
         }
     }
@@ -847,7 +927,7 @@ void AudioDescriptor::_HandleFadeStates()
             return;
         }
 
-        float time_elapsed = (float)vt_system::SystemManager->GetUpdateTime();
+        float time_elapsed = (float)vt_system::SystemManager->GetFrameTime();
         float new_volume = GetVolume() + (time_elapsed / _fade_effect_time);
 
 
@@ -859,12 +939,25 @@ void AudioDescriptor::_HandleFadeStates()
         }
         // Otherwise, update the volume for the audio
         else {
-            SetVolume(new_volume);
+            _SetFadeVolume(new_volume);
         }
     }
 }
 
-void AudioDescriptor::_AcquireSource()
+void AudioDescriptor::_SetFadeVolume(float volume)
+{
+    // The volume is kept exact, so that the fade lasts the same.
+    if(volume < _fade_applied_volume * AUDIO_FADE_VOLUME_STEP
+            && volume > _fade_applied_volume / AUDIO_FADE_VOLUME_STEP) {
+        _SetVolumeControl(volume);
+        return;
+    }
+
+    _fade_applied_volume = volume;
+    SetVolume(volume);
+}
+
+void AudioDescriptor::_AcquireSource(bool steal_playing)
 {
     if(_source != nullptr) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "function was invoked when object already had a source acquired" << std::endl;
@@ -876,7 +969,7 @@ void AudioDescriptor::_AcquireSource()
         return;
     }
 
-    _source = AudioManager->_AcquireAudioSource();
+    _source = AudioManager->_AcquireAudioSource(this, steal_playing);
     if(_source == nullptr) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "could not acquire audio source for new audio file: " << _input->GetFilename() << std::endl;
         return;
@@ -884,8 +977,11 @@ void AudioDescriptor::_AcquireSource()
 
     _source->owner = this;
     _SetSourceProperties();
-    if(_stream == nullptr)
+    if(_stream == nullptr) {
+        // The buffer can't be filled anymore once attached
+        AudioManager->_FinishStaticBuffer(_buffer);
         alSourcei(_source->source, AL_BUFFER, _buffer->buffer);
+    }
     else
         _PrepareStreamingBuffers();
 }
@@ -926,6 +1022,19 @@ void AudioDescriptor::_SetSourceProperties()
 
 
 
+void AudioDescriptor::_SetStreamingBuffers(uint32_t stream_buffer_size)
+{
+    _stream_buffer_count = AudioManager->GetStreamingBufferCount();
+
+    if(stream_buffer_size > 0)
+        _stream_buffer_size = stream_buffer_size;
+    else
+        _stream_buffer_size = _input->GetSamplesPerSecond() * AudioManager->GetStreamingBufferDuration() / 1000;
+
+    if(_stream_buffer_size == 0)
+        _stream_buffer_size = 1;
+}
+
 void AudioDescriptor::_PrepareStreamingBuffers()
 {
     if(_stream == nullptr) {
@@ -950,13 +1059,18 @@ void AudioDescriptor::_PrepareStreamingBuffers()
     }
     alSourcei(_source->source, AL_BUFFER, 0);
 
-    // Fill each buffer with audio data
-    for(uint32_t i = 0; i < NUMBER_STREAMING_BUFFERS; i++) {
-        uint32_t read = _stream->FillBuffer(_data, _stream_buffer_size);
+    // Fill the first buffers with audio data, the others are filled ahead of the playback by _UpdateStream()
+    _free_stream_buffers.clear();
+    for(uint32_t i = 0; i < _stream_buffer_count; i++) {
+        uint32_t read = 0;
+        if(i < STREAMING_PRELOAD_BUFFER_COUNT)
+            read = _stream->FillBuffer(_data, _stream_buffer_size);
+
         if(read > 0) {
             _buffer[i].FillBuffer(_data, _format, read * _input->GetSampleSize(), _input->GetSamplesPerSecond());
-            if(_source != nullptr)
-                alSourceQueueBuffers(_source->source, 1, &_buffer[i].buffer);
+            alSourceQueueBuffers(_source->source, 1, &_buffer[i].buffer);
+        } else {
+            _free_stream_buffers.push_back(_buffer[i].buffer);
         }
     }
 
@@ -1030,6 +1144,7 @@ MusicDescriptor::MusicDescriptor() :
     AudioDescriptor()
 {
     _looping = true;
+    _priority = AUDIO_PRIORITY_MUSIC;
     AudioManager->_registered_music.push_back(this);
 }
 
@@ -39,6 +39,8 @@
 
 #include <vector>
 
+struct SDL_mutex;
+
 namespace vt_mode_manager {
 class GameMode;
 }
@@ -74,6 +76,21 @@ enum AUDIO_LOAD {
     AUDIO_LOAD_STREAM_MEMORY  = 2
 };
 
+/** \brief The audio categories, from the lowest priority to the highest
+*** When no audio source is free, a playing audio may take the source of a lower priority one,
+*** or of a quieter one of the same priority.
+**/
+enum AUDIO_PRIORITY {
+    //! \brief Ambient loops, like the map sound objects
+    AUDIO_PRIORITY_AMBIENT    = 0,
+    //! \brief Combat and other game sounds, the default for sounds
+    AUDIO_PRIORITY_COMBAT     = 1,
+    //! \brief Menu and interface sounds
+    AUDIO_PRIORITY_UI         = 2,
+    //! \brief Music, the default for music
+    AUDIO_PRIORITY_MUSIC      = 3
+};
+
 //! \brief ALfloat per 3D OpenAL sound vectors (position, direction, velocity)
 const uint32_t ALFLOAT3D = 3;
 typedef ALfloat ALfloatArray[ALFLOAT3D];
@@ -83,11 +100,41 @@ namespace private_audio
 
 class AudioEffect;
 
-//! \brief The default buffer size (in bytes) for streaming buffers
-const uint32_t DEFAULT_BUFFER_SIZE = 8192;
+//! \brief The default number of buffers, and their duration in milliseconds, of the streamed audio descriptors.
+//! The streaming thread keeps them filled, so that about 2 seconds are decoded ahead of the playback.
+const uint32_t DEFAULT_STREAMING_BUFFER_COUNT = 8;
+const uint32_t DEFAULT_STREAMING_BUFFER_DURATION = 250;
+
+//! \brief The allowed number of streaming buffers.
+const uint32_t MIN_STREAMING_BUFFER_COUNT = 2;
+const uint32_t MAX_STREAMING_BUFFER_COUNT = 32;
+
+//! \brief The number of streaming buffers filled when starting or seeking, the others being filled by the streaming thread.
+const uint32_t STREAMING_PRELOAD_BUFFER_COUNT = 2;
 
-//! \brief The number of buffers to use for streaming audio descriptors
-const uint32_t NUMBER_STREAMING_BUFFERS = 4;
+//! \brief The volume ratio, about half a decibel, beyond which a fading volume is sent to the OpenAL source.
+//! The smaller changes can't be heard, and are only accumulated.
+const float AUDIO_FADE_VOLUME_STEP = 1.06f;
+
+/** ****************************************************************************
+*** \brief Keeps the streaming thread away from the audio descriptors while in scope
+***
+*** Every audio descriptor function changing the source, the stream or the
+*** state takes it. The lock is recursive, so that those functions can call
+*** each other.
+*** ***************************************************************************/
+class AudioStreamLock
+{
+public:
+    AudioStreamLock();
+    ~AudioStreamLock();
+
+private:
+    SDL_mutex* _mutex;
+
+    AudioStreamLock(const AudioStreamLock&);
+    AudioStreamLock& operator=(const AudioStreamLock&);
+};
 
 /** ****************************************************************************
 *** \brief Represents an OpenAL buffer
@@ -111,9 +158,7 @@ public:
     *** \param size The size of the data in number of bytes
     *** \param frequency The audio frequency of the data in samples per second
     **/
-    void FillBuffer(uint8_t *data, ALenum format, uint32_t size, uint32_t frequency) {
-        alBufferData(buffer, format, data, size, frequency);
-    }
+    void FillBuffer(uint8_t *data, ALenum format, uint32_t size, uint32_t frequency);
 
     //! \brief Returns true if this class object holds a reference to a valid OpenAL buffer
     bool IsValid() const {
@@ -122,6 +167,9 @@ public:
 
     //! \brief The ID of the OpenAL buffer
     ALuint buffer;
+
+    //! \brief The size of the data last filled in the buffer, in bytes
+    uint32_t size;
 }; // class AudioBuffer
 
 
@@ -219,13 +267,14 @@ public:
     /** \brief Loads a new piece of audio data from a file
     *** \param filename The name of the file that contains the new audio data (should have a .wav or .ogg file extension)
     *** \param load_type The type of loading to perform (default == AUDIO_LOAD_STATIC)
-    *** \param stream_buffer_size If the loading type is streaming, the buffer size to use (default == DEFAULT_BUFFER_SIZE)
+    *** \param stream_buffer_size If the loading type is streaming, the buffer size to use in samples.
+    *** When 0, the buffer duration set in the audio engine is used.
     *** \return True if the audio was successfully loaded, false if there was an error
     ***
     *** The action taken by this function depends on the load type selected. For static sounds, a single OpenAL buffer is
     *** filled. For streaming, the file/memory is prepared.
     **/
-    virtual bool LoadAudio(const std::string &filename, AUDIO_LOAD load_type = AUDIO_LOAD_STATIC, uint32_t stream_buffer_size = private_audio::DEFAULT_BUFFER_SIZE);
+    virtual bool LoadAudio(const std::string &filename, AUDIO_LOAD load_type = AUDIO_LOAD_STATIC, uint32_t stream_buffer_size = 0);
 
     /** \brief Frees all data resources and resets class parameters
     ***
@@ -246,6 +295,11 @@ public:
         return _state;
     }
 
+    //! \brief Returns true if the audio is playing, fading in or fading out.
+    bool IsPlaying() const {
+        return (_state == AUDIO_STATE_PLAYING || _state == AUDIO_STATE_FADE_IN || _state == AUDIO_STATE_FADE_OUT);
+    }
+
     /** \name Audio State Manipulation Functions
     *** \brief Performs specified operation on the audio
     ***
@@ -310,6 +364,18 @@ public:
     **/
     virtual void SetVolume(float volume) = 0;
 
+    //! \brief Returns the volume heard, using the global sound or music volume.
+    float GetAudibleVolume() const;
+
+    //! \brief The priority used when all audio sources are taken.
+    AUDIO_PRIORITY GetPriority() const {
+        return _priority;
+    }
+
+    void SetPriority(AUDIO_PRIORITY priority) {
+        _priority = priority;
+    }
+
     /** \name Functions for 3D Spatial Audio
     *** These functions manipulate and retrieve the 3d properties of the audio. Note that only audio which
     *** are mono channel will be affected by these methods. Stereo channel audio will see no difference.
@@ -384,7 +450,7 @@ protected:
     //! \brief The current state of the audio (playing, stopped, etc.)
     AUDIO_STATE _state;
 
-    //! \brief A pointer to the buffer(s) being used by the audio (1 buffer for static sounds, 2 for streamed ones)
+    //! \brief A pointer to the buffer(s) being used by the audio (1 buffer shared by the audio engine for static sounds, _stream_buffer_count for streamed ones)
     private_audio::AudioBuffer *_buffer;
 
     //! \brief A pointer to the source object being used by the audio
@@ -423,8 +489,18 @@ protected:
     //! \brief The volume of the audio when the fade effect was registered
     float _original_volume;
 
-    //! \brief Size of the streaming buffer, if the audio was loaded for streaming
+    //! \brief The fading volume last sent to the OpenAL source.
+    float _fade_applied_volume;
+
+    //! \brief The priority used when all audio sources are taken
+    AUDIO_PRIORITY _priority;
+
+    //! \brief Size of the streaming buffer in samples, and number of buffers, if the audio was loaded for streaming
     uint32_t _stream_buffer_size;
+    uint32_t _stream_buffer_count;
+
+    //! \brief The streaming buffers not queued on the source, waiting to be filled
+    std::vector<ALuint> _free_stream_buffers;
 
     //! \brief The 3D orientation properties of the audio
     //@{
@@ -455,20 +531,30 @@ protected:
 
 private:
     /** \brief Updates the audio during playback
+    *** This function handles the state, fades and effects of the audio in the play state.
+    *** The streaming buffers are refilled by the streaming thread, or by this function without one.
+    **/
+    void _Update();
+
+    /** \brief Refills the streaming buffers which finished playing
     *** This function is only useful for streaming audio that is currently in the play state. If either of these two
     *** conditions are not met, the function will return since it has nothing to do.
     **/
-    void _Update();
+    void _UpdateStream();
 
     //! \brief Handles the fading states volumes update.
     void _HandleFadeStates();
 
+    //! \brief Sets the volume while fading, only updating the source once the change can be heard.
+    void _SetFadeVolume(float volume);
+
     /** \brief Acquires an audio source for playback
     *** This function is called whenever an audio piece is loaded and whenever the Play operation is specified on
     *** the audio, but the audio currently does not have a source. It is not guaranteed that the source acquisition
     *** will be successful, as all other sources may be occupied by other audio.
+    *** \param steal_playing When true, the source of a playing audio of lower priority may be taken.
     **/
-    void _AcquireSource();
+    void _AcquireSource(bool steal_playing = false);
 
     /** \brief Sets all of the relevant properties for the OpenAL source
     *** This function should be called whenever a new source is allocated for the audio to use.
@@ -482,6 +568,11 @@ private:
     *** ones must be refilled. This function should only be called for streaming audio.
     **/
     void _PrepareStreamingBuffers();
+
+    /** \brief Sets the streaming buffers count and size, from the audio engine settings.
+    *** \param stream_buffer_size The buffer size in samples, or 0 to use the audio engine buffer duration.
+    **/
+    void _SetStreamingBuffers(uint32_t stream_buffer_size);
 }; // class AudioDescriptor
 
 
@@ -531,7 +622,7 @@ public:
 
     MusicDescriptor(const MusicDescriptor &copy);
 
-    bool LoadAudio(const std::string &filename, AUDIO_LOAD load_type = AUDIO_LOAD_STREAM_FILE, uint32_t stream_buffer_size = private_audio::DEFAULT_BUFFER_SIZE);
+    bool LoadAudio(const std::string &filename, AUDIO_LOAD load_type = AUDIO_LOAD_STREAM_FILE, uint32_t stream_buffer_size = 0);
 
     bool IsSound() const {
         return false;
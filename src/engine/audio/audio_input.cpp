@@ -24,7 +24,11 @@
 
 #include "audio_input.h"
 
+#include "engine/asset_archive.h"
+#include "engine/memory_stats.h"
+
 #include "utils/utils_common.h"
+#include "utils/utils_strings.h"
 
 #include <cstring>
 #include <SDL_endian.h>
@@ -62,6 +66,21 @@ AudioInput::AudioInput() :
 #define SWAP_U16_FROM_LITTLE(x) { }
 #endif
 
+AudioInput* CreateAudioInput(const std::string& filename)
+{
+    // Name of file is at least 3 letters (so the extension is in there)
+    if(filename.size() <= 3)
+        return nullptr;
+
+    // Convert the file extension to uppercase and use it to create the proper input type
+    std::string file_extension = vt_utils::Upcase(filename.substr(filename.size() - 3, 3));
+    if(file_extension.compare("WAV") == 0)
+        return new WavFile(filename);
+    else if(file_extension.compare("OGG") == 0)
+        return new OggFile(filename);
+    return nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // WavFile class methods
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,40 +91,38 @@ bool WavFile::Initialize()
 
     char buffer[4];
 
-    _file_input.open(_filename.c_str(), std::ios::binary);
-    if(_file_input.fail()) {
-        _file_input.clear();
+    _file_input = vt_system::OpenAsset(_filename);
+    if(!_file_input)
         return false;
-    }
 
     // Check that the initial chunk ID is "RIFF" -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     if(buffer[0] != 'R' || buffer[1] != 'I' || buffer[2] != 'F' || buffer[3] != 'F') {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "failed because initial chunk ID was not \"RIFF\"" << std::endl;
         return false;
     }
 
     // Get chunk size (file size - 8) -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     memcpy(&size, buffer, 4);
     SWAP_U32_FROM_LITTLE(size);
 
     // Check format to be "WAVE" -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     if(buffer[0] != 'W' || buffer[1] != 'A' || buffer[2] != 'V' || buffer[3] != 'E') {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "failed because file format was not \"WAVE\"" << std::endl;
         return false;
     }
 
     // Check SubChunk ID to be "fmt " -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     if(buffer[0] != 'f' || buffer[1] != 'm' || buffer[2] != 't' || buffer[3] != ' ') {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "failed because initial subchunk ID was not \"fmt \"" << std::endl;
         return false;
     }
 
     // Check subchunk size (to be 16) -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     memcpy(&size, buffer, 4);
     SWAP_U32_FROM_LITTLE(size);
     if(size != 16) {
@@ -114,7 +131,7 @@ bool WavFile::Initialize()
     }
 
     // Check audio format (only PCM supported currently) -- 2 bytes
-    _file_input.read(buffer, 2);
+    SDL_RWread(_file_input, buffer, 1, 2);
     size = 0;
     memcpy(&size, buffer, 2);
     SWAP_U32_FROM_LITTLE(size);
@@ -124,7 +141,7 @@ bool WavFile::Initialize()
     }
 
     // Get the number of channels (only mono and stereo supported) -- 2 bytes
-    _file_input.read(buffer, 2);
+    SDL_RWread(_file_input, buffer, 1, 2);
     memcpy(&_number_channels, buffer, 2);
     SWAP_U16_FROM_LITTLE(_number_channels);
     if(_number_channels != 1 && _number_channels != 2) {
@@ -133,23 +150,23 @@ bool WavFile::Initialize()
     }
 
     // Get sample rate (usually 11025, 22050, or 44100 Hz) -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     memcpy(&_samples_per_second, buffer, 4);
     SWAP_U32_FROM_LITTLE(_samples_per_second);
 
     // Get byte rate -- 4 bytes
     uint32_t byte_rate;
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     memcpy(&byte_rate, buffer, 4);
     SWAP_U32_FROM_LITTLE(byte_rate);
 
     // Get block alignment (channels * bits_per_sample / 8) -- 2 bytes
-    _file_input.read(buffer, 2);
+    SDL_RWread(_file_input, buffer, 1, 2);
     memcpy(&_sample_size, buffer, 2);
     SWAP_U16_FROM_LITTLE(_sample_size);
 
     // Get bits per sample -- 2 bytes
-    _file_input.read(buffer, 2);
+    SDL_RWread(_file_input, buffer, 1, 2);
     memcpy(&_bits_per_sample, buffer, 2);
     SWAP_U16_FROM_LITTLE(_bits_per_sample);
     if(_sample_size != (_number_channels * _bits_per_sample) / 8) {
@@ -158,18 +175,18 @@ bool WavFile::Initialize()
     }
 
     // Check subchunk 2 ID (to be "data") -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     if(buffer[0] != 'd' || buffer[1] != 'a' || buffer[2] != 't' || buffer[3] != 'a') {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "failed because subchunk 2 ID was not \"data\"" << std::endl;
         return false;
     }
 
     // Check subchunk 2 size -- 4 bytes
-    _file_input.read(buffer, 4);
+    SDL_RWread(_file_input, buffer, 1, 4);
     memcpy(&_data_size, buffer, 4);
     SWAP_U32_FROM_LITTLE(_data_size);
 
-    _data_init = _file_input.tellg();
+    _data_init = SDL_RWtell(_file_input);
     _total_number_samples = _data_size / _sample_size;
     _play_time = static_cast<float>(_total_number_samples) / static_cast<float>(_samples_per_second);
     return true;
@@ -186,17 +203,14 @@ void WavFile::Seek(uint32_t sample_position)
         return;
     }
 
-    _file_input.clear();
-    _file_input.seekg(static_cast<std::streamoff>(sample + _data_init), std::ios_base::beg);
+    SDL_RWseek(_file_input, static_cast<Sint64>(sample) + _data_init, RW_SEEK_SET);
 }
 
 
 
 uint32_t WavFile::Read(uint8_t *buffer, uint32_t size, bool &end)
 {
-    _file_input.read(reinterpret_cast<char *>(buffer), size * _sample_size);
-
-    uint32_t read = _file_input.gcount() / _sample_size;
+    uint32_t read = static_cast<uint32_t>(SDL_RWread(_file_input, buffer, 1, size * _sample_size)) / _sample_size;
     end = (read != size);
 
 #ifdef __BIG_ENDIAN__
@@ -217,6 +231,32 @@ uint32_t WavFile::Read(uint8_t *buffer, uint32_t size, bool &end)
 // OggFile class methods
 ////////////////////////////////////////////////////////////////////////////////
 
+//! \brief The vorbisfile callbacks reading a SDL stream, using the C types they expect.
+//@{
+static size_t _StreamRead(void* buffer, size_t size, size_t count, void* stream)
+{
+    return SDL_RWread(static_cast<SDL_RWops *>(stream), buffer, size, count);
+}
+
+static int _StreamSeek(void* stream, ogg_int64_t offset, int whence)
+{
+    // The SEEK_SET, SEEK_CUR and SEEK_END values are the same as the RW_SEEK ones.
+    return SDL_RWseek(static_cast<SDL_RWops *>(stream), offset, whence) < 0 ? -1 : 0;
+}
+
+static int _StreamClose(void* stream)
+{
+    return SDL_RWclose(static_cast<SDL_RWops *>(stream));
+}
+
+static long _StreamTell(void* stream)
+{
+    return static_cast<long>(SDL_RWtell(static_cast<SDL_RWops *>(stream)));
+}
+
+static const ov_callbacks _STREAM_CALLBACKS = { _StreamRead, _StreamSeek, _StreamClose, _StreamTell };
+//@}
+
 OggFile::OggFile(const std::string& file_name) :
     AudioInput(),
     _read_buffer_position(0),
@@ -241,41 +281,18 @@ bool OggFile::Initialize()
 {
     _initialized = false;
 
-    // Windows requires a special loading method in order load ogg files
-    // properly when dynamically linking vorbis libs. The workaround is
-    // to use the ov_open_callbacks function
-#ifdef _WIN32
-    // Callbacks struct defining the open, closing, seeking and location behaviors.
-    ov_callbacks callbacks =  {
-        (size_t ( *)(void *, size_t, size_t, void *)) fread,
-        (int ( *)(void *, ogg_int64_t, int)) _FileSeekWrapper,
-        (int ( *)(void *)) fclose,
-        (long( *)(void *)) ftell
-    };
-
-    FILE *file = fopen(_filename.c_str(), "rb");
-
-    if (!file)
-        return false;
-
-    if(ov_open_callbacks(file, &_vorbis_file, nullptr, 0, callbacks) < 0) {
-        fclose(file);
-        IF_PRINT_WARNING(AUDIO_DEBUG) << "input file does not appear to be an Ogg bitstream: " << _filename << std::endl;
-        return false;
-    }
-#else
-    // File loading code for non Win32 platforms.  Much simpler.
-    FILE *file = fopen(_filename.c_str(), "rb");
+    // The file is read through the SDL stream callbacks, from the asset archive memory when packed.
+    // This also avoids giving FILE pointers to dynamically linked vorbis libs on Windows.
+    SDL_RWops* file = vt_system::OpenAsset(_filename);
 
     if (!file)
         return false;
 
-    if(ov_open(file, &_vorbis_file, nullptr, 0) < 0) {
-        fclose(file);
+    if(ov_open_callbacks(file, &_vorbis_file, nullptr, 0, _STREAM_CALLBACKS) < 0) {
+        SDL_RWclose(file);
         IF_PRINT_WARNING(AUDIO_DEBUG) << "input file does not appear to be an Ogg bitstream: " << _filename << std::endl;
         return false;
     }
-#endif
 
     _number_channels = _vorbis_file.vi->channels;
     _samples_per_second = _vorbis_file.vi->rate;
@@ -361,62 +378,48 @@ uint32_t OggFile::Read(uint8_t *buffer, uint32_t size, bool &end)
     return read / _sample_size;
 } // uint32_t OggFile::Read(uint8_t* buffer, uint32_t size, bool& end)
 
-
-#ifdef _WIN32
-int OggFile::_FileSeekWrapper(FILE *file, ogg_int64_t off, int whence)
-{
-    if(file == nullptr) {
-        IF_PRINT_WARNING(AUDIO_DEBUG) << "file pointer was nullptr in argument list" << std::endl;
-        return -1;
-    } else {
-        return fseek(file, static_cast<long>(off), whence);
-    }
-}
-#endif
-
 ////////////////////////////////////////////////////////////////////////////////
 // AudioMemory class methods
 ////////////////////////////////////////////////////////////////////////////////
 
 
+std::map<std::string, std::weak_ptr<const std::vector<uint8_t> > > AudioMemory::_shared_audio_data;
+
 AudioMemory::AudioMemory(AudioInput *input) :
     AudioInput(),
-    _audio_data(nullptr),
     _data_position(0)
 {
-    _filename = input->GetFilename();
-    _samples_per_second = input->GetSamplesPerSecond();
-    _bits_per_sample = input->GetBitsPerSample();
-    _number_channels = static_cast<uint8_t>(input->GetNumberChannels());
-    _total_number_samples = input->GetTotalNumberSamples();
-    _sample_size = input->GetSampleSize();
-    _play_time = input->GetPlayTime();
-    _data_size = input->GetDataSize();
-
-    _audio_data = new uint8_t[input->GetDataSize()];
+    _CopyProperties(*input);
+
+    // Use the data of the file if already in memory
+    std::map<std::string, std::weak_ptr<const std::vector<uint8_t> > >::iterator it = _shared_audio_data.find(_filename);
+    if(it != _shared_audio_data.end())
+        _audio_data = it->second.lock();
+    if(_audio_data)
+        return;
+
+    // The data is accounted until the last audio memory using it is gone.
+    vt_system::MemoryStats::Add(vt_system::MEMORY_AUDIO, _data_size);
+    const uint32_t data_size = _data_size;
+    std::shared_ptr<std::vector<uint8_t> > audio_data(new std::vector<uint8_t>(_data_size),
+                                                      [data_size](std::vector<uint8_t> *released) {
+        vt_system::MemoryStats::Remove(vt_system::MEMORY_AUDIO, data_size);
+        delete released;
+    });
     bool all_data_read = false;
-    input->Read(_audio_data, input->GetTotalNumberSamples(), all_data_read);
-    if(all_data_read == false) {
+    if(_data_size > 0 && input->Read(&(*audio_data)[0], _total_number_samples, all_data_read) != _total_number_samples) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "failed to read entire audio data stream for file: " << _filename << std::endl;
     }
+    _audio_data = audio_data;
+    _shared_audio_data[_filename] = _audio_data;
 }
 
 AudioMemory::AudioMemory(const AudioMemory &audio_memory) :
     AudioInput(),
-    _audio_data(nullptr),
+    _audio_data(audio_memory._audio_data),
     _data_position(0)
 {
-    _filename = audio_memory._filename;
-    _samples_per_second = audio_memory.GetSamplesPerSecond();
-    _bits_per_sample = audio_memory.GetBitsPerSample();
-    _number_channels = static_cast<uint8_t>(audio_memory.GetNumberChannels());
-    _total_number_samples = audio_memory.GetTotalNumberSamples();
-    _sample_size = audio_memory.GetSampleSize();
-    _play_time = audio_memory.GetPlayTime();
-    _data_size = audio_memory.GetDataSize();
-
-    _audio_data = new uint8_t[_data_size];
-    memcpy(_audio_data, audio_memory._audio_data, _data_size);
+    _CopyProperties(audio_memory);
 }
 
 AudioMemory &AudioMemory::operator=(const AudioMemory &audio_memory)
@@ -424,22 +427,10 @@ AudioMemory &AudioMemory::operator=(const AudioMemory &audio_memory)
     if(this == &audio_memory)  // Handle self-assignment case
         return *this;
 
-    if(_audio_data != nullptr) {
-        delete[] _audio_data;
-        _audio_data = nullptr;
-    }
-    _filename = audio_memory._filename;
-    _samples_per_second = audio_memory.GetSamplesPerSecond();
-    _bits_per_sample = audio_memory.GetBitsPerSample();
-    _number_channels = static_cast<uint8_t>(audio_memory.GetNumberChannels());
-    _total_number_samples = audio_memory.GetTotalNumberSamples();
-    _sample_size = audio_memory.GetSampleSize();
-    _play_time = audio_memory.GetPlayTime();
-    _data_size = audio_memory.GetDataSize();
-
+    _ReleaseAudioData();
+    _CopyProperties(audio_memory);
+    _audio_data = audio_memory._audio_data;
     _data_position = audio_memory._data_position;
-    _audio_data = new uint8_t[_data_size];
-    memcpy(_audio_data, audio_memory._audio_data, _data_size);
 
     return *this;
 }
@@ -447,17 +438,38 @@ AudioMemory &AudioMemory::operator=(const AudioMemory &audio_memory)
 
 AudioMemory::~AudioMemory()
 {
-    if(_audio_data != nullptr) {
-        delete[] _audio_data;
-        _audio_data = nullptr;
-    }
+    _ReleaseAudioData();
+}
+
+void AudioMemory::_ReleaseAudioData()
+{
+    if(!_audio_data)
+        return;
+
+    // Forget the file data once the last audio memory using it is gone
+    _audio_data.reset();
+    std::map<std::string, std::weak_ptr<const std::vector<uint8_t> > >::iterator it = _shared_audio_data.find(_filename);
+    if(it != _shared_audio_data.end() && it->second.expired())
+        _shared_audio_data.erase(it);
+}
+
+void AudioMemory::_CopyProperties(const AudioInput& input)
+{
+    _filename = input.GetFilename();
+    _samples_per_second = input.GetSamplesPerSecond();
+    _bits_per_sample = input.GetBitsPerSample();
+    _number_channels = input.GetNumberChannels();
+    _total_number_samples = input.GetTotalNumberSamples();
+    _sample_size = input.GetSampleSize();
+    _play_time = input.GetPlayTime();
+    _data_size = input.GetDataSize();
 }
 
 
 
 void AudioMemory::Seek(uint32_t sample_position)
 {
-    if(_data_position >= _total_number_samples) {
+    if(sample_position >= _total_number_samples) {
         IF_PRINT_WARNING(AUDIO_DEBUG) << "attempted to seek postion beyond the maximum number of samples: "
                                       << sample_position << std::endl;
         return;
@@ -474,7 +486,8 @@ uint32_t AudioMemory::Read(uint8_t *buffer, uint32_t size, bool &end)
     uint32_t read = (_total_number_samples - _data_position >= size) ? size : (_total_number_samples - _data_position);
 
     // Copy the data in the buffer and move the read cursor
-    memcpy(buffer, buffer + _data_position * _sample_size, read * _sample_size);
+    if(read > 0)
+        memcpy(buffer, &(*_audio_data)[_data_position * _sample_size], read * _sample_size);
     _data_position += read;
     end = (_data_position == _total_number_samples);
 
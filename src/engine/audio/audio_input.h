@@ -27,8 +27,12 @@
 #define __AUDIO_INPUT_HEADER__
 
 #include <vorbis/vorbisfile.h>
+#include <SDL2/SDL_rwops.h>
 
 #include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace vt_audio
 {
@@ -152,14 +156,16 @@ class WavFile : public AudioInput
 {
 public:
     explicit WavFile(const std::string& file_name) :
-        AudioInput() {
+        AudioInput(),
+        _file_input(nullptr),
+        _data_init(0) {
         _filename = file_name;
     }
 
     ~WavFile()
     {
-        if (_file_input.is_open())
-            _file_input.close();
+        if (_file_input)
+            SDL_RWclose(_file_input);
     }
 
     //! \brief Inherited functions from AudioInput class
@@ -173,11 +179,11 @@ public:
     //@}
 
 private:
-    //! \brief The input I/O stream for the file
-    std::ifstream _file_input;
+    //! \brief The input stream for the file, read from the asset archive when packed
+    SDL_RWops* _file_input;
 
     //! \brief The offset to where the data begins in the file (past the header information)
-    std::streampos _data_init;
+    Sint64 _data_init;
 }; // class WavFile : public AudioInput
 
 
@@ -220,20 +226,6 @@ private:
     //! \brief Tells whether the ogg/vorbis structures are successfully allocated.
     //! It is used to know whether they can be deallocated.
     bool _initialized;
-
-#ifdef _WIN32
-    /** \brief A wrapper function for file seek operations
-    *** \param ffile A pointer to the FILE struct which represents the input stream
-    *** \param off The number of bytes to offset from the stream's origin
-    *** \param whence The position to read, added to the off paramater to determine the actual seek position
-    *** \return The return value of the fseek function, or -1 if the file pointer was invalid
-    ***
-    *** \note This function is required and used only by the Windows platform. It is static out
-    *** of necessity (it gets used as a function pointer) and uses the normally forbidden int type
-    *** since it is a wrapper to a C function which expects those types.
-    */
-    static int _FileSeekWrapper(FILE *file, ogg_int64_t off, int whence);
-#endif
 }; // class OggFile : public AudioInput
 
 
@@ -244,6 +236,10 @@ private:
 *** stored, and then operates off of that data. This is useful for efficient
 *** streaming operations so that I/O files containing the data do not need to
 *** be continually accessed.
+***
+*** The audio data is immutable, and shared by the copies of the class and by
+*** the other audio memory objects of the same file, so that it is never
+*** duplicated.
 *** ***************************************************************************/
 class AudioMemory : public AudioInput
 {
@@ -251,10 +247,12 @@ public:
     /** \brief The class must be constructed using existing audio input data
     *** \param input A pointer to the already initialized AudioInput for this class to use
     *** This constructor will allocate enough memory to hold the entire audio data and
-    *** fill that memory with the audio data read from the input argument
+    *** fill that memory with the audio data read from the input argument, unless
+    *** another audio memory object already holds the data of the same file.
     **/
     explicit AudioMemory(AudioInput* input);
 
+    //! \brief The copies share the audio data.
     explicit AudioMemory(const AudioMemory& audio_memory);
     AudioMemory &operator=(const AudioMemory &other_audio_memory);
 
@@ -274,12 +272,26 @@ public:
 
 private:
     //! \brief The memory location where all the audio is stored
-    uint8_t *_audio_data;
+    std::shared_ptr<const std::vector<uint8_t> > _audio_data;
 
     //! \brief Position in the data where the next read operation will be performed
     uint32_t _data_position;
+
+    //! \brief The audio data of the files in memory, as long as an audio memory object uses it
+    static std::map<std::string, std::weak_ptr<const std::vector<uint8_t> > > _shared_audio_data;
+
+    //! \brief Copies the audio properties of another input.
+    void _CopyProperties(const AudioInput& input);
+
+    //! \brief Stops using the audio data, and forgets the file data if no other audio memory uses it.
+    void _ReleaseAudioData();
 }; // class AudioMemory : public AudioInput
 
+/** \brief Creates the file audio input matching the filename extension
+*** \return The uninitialized audio input, or nullptr if the file extension isn't supported
+**/
+AudioInput* CreateAudioInput(const std::string& filename);
+
 } // namespace private_audio
 
 } // namespace vt_audio
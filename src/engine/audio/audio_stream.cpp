@@ -55,28 +55,47 @@ AudioStream::AudioStream(AudioInput *input, bool loop) :
 uint32_t AudioStream::FillBuffer(uint8_t *buffer, uint32_t size)
 {
     uint32_t num_samples_read = 0; // The number of samples which have been read
+    bool empty_read = false; // Whether the last read didn't give any sample
 
     while(num_samples_read < size) {
-        // If looping is enabled and the end of the stream has been reached, seek to the starting position
-        if(_looping && (_read_position == _loop_end_position || _read_position == _audio_input->GetTotalNumberSamples())) {
+        // If looping is enabled and the end of the stream has been reached, seek to the starting position,
+        // so that the buffer holds both the loop end and start without any gap.
+        if(_looping && (_read_position >= _loop_end_position || _read_position >= _audio_input->GetTotalNumberSamples())) {
             _audio_input->Seek(_loop_start_position);
             _read_position = _loop_start_position;
+            _end_of_stream = false;
         }
 
         // Determine the number of samples we should request for the input to read
         uint32_t remaining_data = (_looping) ? _loop_end_position : _audio_input->GetTotalNumberSamples();
-        remaining_data -= _read_position;
+        remaining_data = (remaining_data > _read_position) ? remaining_data - _read_position : 0;
 
         // The number of samples to request the audio input to read
         uint32_t read_samples = (size - num_samples_read < remaining_data) ? size - num_samples_read : remaining_data;
-        num_samples_read += _audio_input->Read(buffer + num_samples_read * _audio_input->GetSampleSize(),
-                                               read_samples, _end_of_stream);
-        _read_position += num_samples_read;
+        uint32_t samples_read = 0;
+        if(read_samples > 0) {
+            samples_read = _audio_input->Read(buffer + num_samples_read * _audio_input->GetSampleSize(),
+                                              read_samples, _end_of_stream);
+        } else if(!_looping) {
+            _end_of_stream = true;
+        }
+        num_samples_read += samples_read;
+        _read_position += samples_read;
 
         // Detect early exit condition
         if(_looping == false && _end_of_stream) {
             return num_samples_read;
         }
+
+        // An input failing to give any sample, or an empty loop, would never fill the buffer.
+        // A single empty read is expected when reaching the loop end.
+        if(samples_read == 0) {
+            if(empty_read)
+                return num_samples_read;
+            empty_read = true;
+        } else {
+            empty_read = false;
+        }
     }
 
     return num_samples_read;
@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    benchmark.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the scripted benchmarks.
+*** ***************************************************************************/
+
+#include "engine/benchmark.h"
+
+#include "engine/memory_stats.h"
+#include "engine/system.h"
+#include "engine/video/video.h"
+
+#include "common/random_streams.h"
+#include "common/script_call_profiler.h"
+
+#include "script/script_read.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_timer.h>
+#include <SDL2/SDL_video.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+//! \brief The heap allocations count, incremented by the global operator new.
+static SDL_atomic_t _allocation_count;
+
+//! \brief Allocates heap memory, counting the allocation.
+static void* _AllocateCounted(size_t size)
+{
+    SDL_AtomicIncRef(&_allocation_count);
+    return malloc(size > 0 ? size : 1);
+}
+
+// The global operators are replaced to count the heap allocations, the memory
+// still being the one of malloc(). Only an atomic increment is added.
+void* operator new(size_t size)
+{
+    void* memory = _AllocateCounted(size);
+    if(!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    void* memory = _AllocateCounted(size);
+    if(!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+    return _AllocateCounted(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+    return _AllocateCounted(size);
+}
+
+void operator delete(void* memory) throw()
+{
+    free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+    free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) throw()
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) throw()
+{
+    free(memory);
+}
+
+namespace vt_system
+{
+
+uint32_t GetAllocationCount()
+{
+    return static_cast<uint32_t>(SDL_AtomicGet(&_allocation_count));
+}
+
+//! \brief The minimum, average, percentiles and maximum of some measures.
+class BenchmarkSummary
+{
+public:
+    explicit BenchmarkSummary(const std::vector<float>& values) :
+        minimum(0.0f),
+        average(0.0f),
+        percentile_95(0.0f),
+        percentile_99(0.0f),
+        maximum(0.0f)
+    {
+        if(values.empty())
+            return;
+
+        std::vector<float> sorted_values(values);
+        std::sort(sorted_values.begin(), sorted_values.end());
+
+        float total = 0.0f;
+        for(uint32_t i = 0; i < sorted_values.size(); ++i)
+            total += sorted_values[i];
+
+        minimum = sorted_values.front();
+        average = total / sorted_values.size();
+        percentile_95 = sorted_values[sorted_values.size() * 95 / 100];
+        percentile_99 = sorted_values[sorted_values.size() * 99 / 100];
+        maximum = sorted_values.back();
+    }
+
+    float minimum;
+    float average;
+    float percentile_95;
+    float percentile_99;
+    float maximum;
+};
+
+//! \brief Converts some counters for their summary.
+static std::vector<float> _ToFloats(const std::vector<uint32_t>& values)
+{
+    return std::vector<float>(values.begin(), values.end());
+}
+
+//! \brief Writes a summary as a JSON object.
+static void _WriteJSONSummary(std::ofstream& file, const BenchmarkSummary& summary)
+{
+    file << "{ \"min\": " << summary.minimum
+         << ", \"avg\": " << summary.average
+         << ", \"p95\": " << summary.percentile_95
+         << ", \"p99\": " << summary.percentile_99
+         << ", \"max\": " << summary.maximum << " }";
+}
+
+Benchmark::Benchmark() :
+    _frame_count(BENCHMARK_DEFAULT_FRAMES),
+    _warmup_frames(BENCHMARK_DEFAULT_WARMUP_FRAMES),
+    _update_time(BENCHMARK_DEFAULT_UPDATE_TIME),
+    _running(false),
+    _frame_number(0),
+    _last_frame_counter(0),
+    _last_allocation_count(0)
+{
+}
+
+bool Benchmark::Start(const std::string& scenario, uint32_t frame_count)
+{
+    // The scenarios are found by name, unless a file is given.
+    std::string filename = scenario;
+    _scenario_name = scenario;
+    if(scenario.size() < 4 || scenario.compare(scenario.size() - 4, 4, ".lua") != 0)
+        filename = "data/benchmarks/" + scenario + ".lua";
+    else
+        _scenario_name = scenario.substr(0, scenario.size() - 4);
+    if(_scenario_name.find_last_of("/\\") != std::string::npos)
+        _scenario_name = _scenario_name.substr(_scenario_name.find_last_of("/\\") + 1);
+
+    vt_script::ReadScriptDescriptor scenario_script;
+    if(!scenario_script.OpenFile(filename)) {
+        PRINT_ERROR << "Couldn't open the benchmark scenario: " << filename << std::endl;
+        return false;
+    }
+
+    if(scenario_script.DoesUIntExist("frames"))
+        _frame_count = scenario_script.ReadUInt("frames");
+    if(scenario_script.DoesUIntExist("warmup_frames"))
+        _warmup_frames = scenario_script.ReadUInt("warmup_frames");
+    if(scenario_script.DoesUIntExist("update_time"))
+        _update_time = scenario_script.ReadUInt("update_time");
+    if(frame_count > 0)
+        _frame_count = frame_count;
+    if(_frame_count == 0 || _update_time == 0) {
+        PRINT_ERROR << "Invalid frame count or update time in the benchmark scenario: " << filename << std::endl;
+        scenario_script.CloseFile();
+        return false;
+    }
+
+    // The scenario starts from the same random numbers on each run.
+    srand(static_cast<unsigned int>(vt_common::GetRandomSeed()));
+
+    if(!scenario_script.RunScriptFunction("StartBenchmark")) {
+        PRINT_ERROR << "Couldn't start the benchmark scenario: " << filename << std::endl;
+        scenario_script.CloseFile();
+        return false;
+    }
+    scenario_script.CloseFile();
+
+    // Each frame advances the game by the same time, as fast as possible.
+    SystemManager->SetFixedUpdateTime(_update_time);
+    SDL_GL_SetSwapInterval(0);
+
+    _frame_times.reserve(_frame_count);
+    _draw_calls.reserve(_frame_count);
+    _texture_binds.reserve(_frame_count);
+    _allocations.reserve(_frame_count);
+
+    // The high-water marks include the modes loading during the warmup frames.
+    MemoryStats::ResetHighWater();
+
+    // The script calls are only timed once the warmup frames are run.
+    vt_common::ScriptCallProfiler::SetEnabled(true);
+    vt_common::ScriptCallProfiler::Reset();
+
+    _running = true;
+    _frame_number = 0;
+    _last_frame_counter = SDL_GetPerformanceCounter();
+    _last_allocation_count = GetAllocationCount();
+    return true;
+}
+
+bool Benchmark::EndFrame()
+{
+    if(!_running)
+        return false;
+
+    const uint64_t counter = SDL_GetPerformanceCounter();
+    const uint32_t allocation_count = GetAllocationCount();
+
+    if(_frame_number >= _warmup_frames) {
+        const vt_video::private_video::RenderFrameStats& render_stats = VideoManager->GetRenderStats().GetLastFrame();
+        _frame_times.push_back(static_cast<float>(counter - _last_frame_counter) * 1000.0f /
+                               static_cast<float>(SDL_GetPerformanceFrequency()));
+        _draw_calls.push_back(render_stats.draw_calls);
+        _texture_binds.push_back(render_stats.texture_binds);
+        _allocations.push_back(allocation_count - _last_allocation_count);
+    }
+
+    ++_frame_number;
+    if(_frame_number == _warmup_frames)
+        vt_common::ScriptCallProfiler::Reset();
+    _last_frame_counter = counter;
+    _last_allocation_count = allocation_count;
+    return _frame_times.size() < _frame_count;
+}
+
+bool Benchmark::Stop(const std::string& results_filename)
+{
+    if(!_running)
+        return true;
+    _running = false;
+    SystemManager->SetFixedUpdateTime(0);
+
+    if(_frame_times.size() < _frame_count) {
+        PRINT_WARNING << "The benchmark was stopped after " << _frame_times.size()
+                      << " measured frames out of " << _frame_count << std::endl;
+    }
+
+    _PrintResults();
+    if(results_filename.empty())
+        return true;
+    return _SaveResults(results_filename);
+}
+
+void Benchmark::_PrintResults()
+{
+    const BenchmarkSummary frame_times(_frame_times);
+    const BenchmarkSummary draw_calls(_ToFloats(_draw_calls));
+    const BenchmarkSummary texture_binds(_ToFloats(_texture_binds));
+    const BenchmarkSummary allocations(_ToFloats(_allocations));
+
+    std::cout << "Benchmark '" << _scenario_name << "': " << _frame_times.size() << " frames of "
+              << _update_time << " ms" << std::endl
+              << "Frame times in milliseconds: min " << frame_times.minimum
+              << ", average " << frame_times.average
+              << ", 95% " << frame_times.percentile_95
+              << ", 99% " << frame_times.percentile_99
+              << ", max " << frame_times.maximum << std::endl
+              << "Per frame: " << draw_calls.average << " draw calls, "
+              << texture_binds.average << " texture binds, "
+              << allocations.average << " allocations (max " << allocations.maximum << ")" << std::endl
+              << "Memory high-water mark: " << MemoryStats::GetTotalHighWater() / 1024 << " KB" << std::endl;
+}
+
+bool Benchmark::_SaveResults(const std::string& filename)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    if(!file.is_open()) {
+        PRINT_ERROR << "Couldn't open the benchmark results file: " << filename << std::endl;
+        return false;
+    }
+
+    // The scenario name is given by the user, and isn't escaped.
+    file << "{" << std::endl
+         << "  \"scenario\": \"" << _scenario_name << "\"," << std::endl
+         << "  \"frames\": " << _frame_times.size() << "," << std::endl
+         << "  \"update_time\": " << _update_time << "," << std::endl
+         << "  \"random_seed\": " << vt_common::GetRandomSeed() << "," << std::endl
+         << "  \"frame_time_ms\": ";
+    _WriteJSONSummary(file, BenchmarkSummary(_frame_times));
+    file << "," << std::endl << "  \"draw_calls\": ";
+    _WriteJSONSummary(file, BenchmarkSummary(_ToFloats(_draw_calls)));
+    file << "," << std::endl << "  \"texture_binds\": ";
+    _WriteJSONSummary(file, BenchmarkSummary(_ToFloats(_texture_binds)));
+    file << "," << std::endl << "  \"allocations\": ";
+    _WriteJSONSummary(file, BenchmarkSummary(_ToFloats(_allocations)));
+    file << "," << std::endl << "  \"memory_high_water_bytes\": { ";
+    for(uint32_t i = 0; i < MEMORY_TAG_TOTAL; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        file << "\"" << GetMemoryTagName(tag) << "\": " << MemoryStats::GetHighWater(tag) << ", ";
+    }
+    file << "\"total\": " << MemoryStats::GetTotalHighWater() << " }," << std::endl << "  \"script_calls\": ";
+    vt_common::ScriptCallProfiler::WriteJSON(file);
+    file << std::endl << "}" << std::endl;
+
+    file.close();
+    if(file.fail()) {
+        PRINT_ERROR << "Couldn't write the benchmark results file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Benchmark::Benchmark(const Benchmark&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+Benchmark& Benchmark::operator=(const Benchmark&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_system
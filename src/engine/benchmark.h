@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    benchmark.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the scripted benchmarks.
+***
+*** A benchmark scenario is a Lua file, found in data/benchmarks/, pushing the
+*** game modes to measure from its StartBenchmark() function instead of the
+*** boot menu. It may also set:
+*** - frames: The number of frames measured.
+*** - warmup_frames: The number of frames run before measuring, to let the
+***   modes load and fade in.
+*** - update_time: The game time each frame advances, in milliseconds.
+***
+*** The frames aren't paced nor synced with the display, and each advances the
+*** game by the same time, so that the benchmarks are comparable from one run to
+*** the next. Use --random-seed to reproduce the random numbers as well.
+*** ***************************************************************************/
+
+#ifndef __BENCHMARK_HEADER__
+#define __BENCHMARK_HEADER__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vt_system
+{
+
+//! \brief The frames measured by default, about 30 seconds of game time.
+const uint32_t BENCHMARK_DEFAULT_FRAMES = 1800;
+
+//! \brief The frames run before measuring by default.
+const uint32_t BENCHMARK_DEFAULT_WARMUP_FRAMES = 120;
+
+//! \brief The game time advanced by each frame by default, in milliseconds.
+const uint32_t BENCHMARK_DEFAULT_UPDATE_TIME = 16;
+
+//! \brief The number of heap allocations made by the game since it started.
+uint32_t GetAllocationCount();
+
+/** ****************************************************************************
+*** \brief Runs a benchmark scenario, measuring each of its frames.
+***
+*** The main loop reports the end of each frame, and exits once all the frames
+*** are measured. The frame times, the draw calls, the texture binds and the
+*** heap allocations of each frame are then summed up, and the script function
+*** calls are timed.
+*** ***************************************************************************/
+class Benchmark
+{
+public:
+    Benchmark();
+
+    /** \brief Loads a scenario and pushes its game modes.
+    *** \param scenario The scenario name in data/benchmarks/, or the path of its Lua file.
+    *** \param frame_count The number of frames to measure, or 0 to keep the scenario one.
+    *** \return False if the scenario couldn't be started.
+    **/
+    bool Start(const std::string& scenario, uint32_t frame_count);
+
+    bool IsRunning() const {
+        return _running;
+    }
+
+    /** \brief Measures the frame which just ended.
+    *** \return False once all the frames are measured.
+    **/
+    bool EndFrame();
+
+    /** \brief Stops the benchmark, and prints its results.
+    *** \param results_filename The file to save the results in, as JSON, if not empty.
+    *** \return False if the results couldn't be saved.
+    **/
+    bool Stop(const std::string& results_filename);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    Benchmark(const Benchmark& benchmark);
+    Benchmark& operator=(const Benchmark& benchmark);
+
+    std::string _scenario_name;
+
+    uint32_t _frame_count;
+    uint32_t _warmup_frames;
+    uint32_t _update_time;
+
+    bool _running;
+
+    //! \brief The frames run, including the warmup ones.
+    uint32_t _frame_number;
+
+    //! \brief The performance counter and the allocation count when the last frame ended.
+    uint64_t _last_frame_counter;
+    uint32_t _last_allocation_count;
+
+    //! \brief The measures of each frame.
+    //@{
+    std::vector<float> _frame_times;
+    std::vector<uint32_t> _draw_calls;
+    std::vector<uint32_t> _texture_binds;
+    std::vector<uint32_t> _allocations;
+    //@}
+
+    //! \brief Prints the frame times and the other measures.
+    void _PrintResults();
+
+    //! \brief Saves the results as JSON.
+    bool _SaveResults(const std::string& filename);
+};
+
+} // namespace vt_system
+
+#endif // __BENCHMARK_HEADER__
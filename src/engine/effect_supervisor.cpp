@@ -22,6 +22,8 @@
 
 #include "utils/utils_random.h"
 
+#include <algorithm>
+
 using namespace vt_video;
 
 namespace vt_mode_manager
@@ -44,6 +46,15 @@ EffectSupervisor::EffectSupervisor()
     _info.overlay.y_parallax = 0.0f;
     _info.overlay.is_parallax = false;
 
+    // Weather
+    _info.weather.type = WEATHER_NONE;
+    _info.weather.intensity = 0.0f;
+    _info.weather.wind_x = 0.0f;
+    _info.weather.wind_y = 0.0f;
+    _info.weather.time = 0.0f;
+    _info.weather.x_shift = 0.0f;
+    _info.weather.y_shift = 0.0f;
+
     // Shake members
     _shake.x = 0.0f;
     _shake.y = 0.0f;
@@ -76,6 +87,28 @@ void EffectSupervisor::DisableAmbientOverlay()
 }
 
 
+void EffectSupervisor::EnableWeather(int32_t type, float intensity,
+                                     float wind_x, float wind_y,
+                                     const Color& color)
+{
+    if(type <= WEATHER_NONE || type >= WEATHER_TOTAL) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "Invalid weather type: " << type << std::endl;
+        return;
+    }
+
+    // Changing the weather keeps it going smoothly.
+    _info.weather.type = static_cast<WeatherType>(type);
+    _info.weather.intensity = std::min(std::max(intensity, 0.0f), 1.0f);
+    _info.weather.wind_x = wind_x;
+    _info.weather.wind_y = wind_y;
+    _info.weather.color = color;
+}
+
+void EffectSupervisor::DisableWeather()
+{
+    _info.weather.type = WEATHER_NONE;
+}
+
 void EffectSupervisor::EnableLightingOverlay(const Color &color)
 {
     _info.light.color = color;
@@ -91,6 +124,8 @@ void EffectSupervisor::DisableLightingOverlay()
 
 void EffectSupervisor::Update(uint32_t frame_time)
 {
+    // Before the ambient overlay update resets the parallax values.
+    _UpdateWeather(frame_time);
     _UpdateAmbientOverlay(frame_time);
     _UpdateShake(frame_time);
 }
@@ -137,22 +172,42 @@ void EffectSupervisor::_UpdateAmbientOverlay(uint32_t frame_time)
         _info.overlay.y_shift += height;
 }
 
+void EffectSupervisor::_UpdateWeather(uint32_t frame_time)
+{
+    if(_info.weather.type == WEATHER_NONE)
+        return;
+
+    // The time wraps around to keep the shader precise enough.
+    const float WEATHER_TIME_PERIOD = 600.0f;
+    _info.weather.time += static_cast<float>(frame_time) / 1000.0f;
+    if(_info.weather.time >= WEATHER_TIME_PERIOD)
+        _info.weather.time -= WEATHER_TIME_PERIOD;
+
+    _info.weather.x_shift += _info.overlay.x_parallax;
+    _info.weather.y_shift += _info.overlay.y_parallax;
+}
+
 void EffectSupervisor::DrawEffects()
 {
-    // Draw the textured ambient overlay
-    if(_info.overlay.active) {
-        VideoManager->PushState();
-        VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_TOP, 0);
-        VideoManager->SetStandardCoordSys();
-        float width = _ambient_overlay_img.GetWidth();
-        float height = _ambient_overlay_img.GetHeight();
-        for(float x = _info.overlay.x_shift; x <= VIDEO_STANDARD_RES_WIDTH; x = x + width) {
-            for(float y = _info.overlay.y_shift; y <= VIDEO_STANDARD_RES_HEIGHT; y = y + height) {
-                VideoManager->Move(x, y);
-                _ambient_overlay_img.Draw();
-            }
-        }
-        VideoManager->PopState();
+    // Draw the weather under the overlays, so that it gets lit like the rest of the scene.
+    if(_info.weather.type != WEATHER_NONE) {
+        VideoManager->DrawWeather(static_cast<uint32_t>(_info.weather.type),
+                                  _info.weather.time, _info.weather.intensity,
+                                  _info.weather.wind_x, _info.weather.wind_y,
+                                  _info.weather.x_shift + _shake.x,
+                                  _info.weather.y_shift + _shake.y,
+                                  _info.weather.color);
+    }
+
+    // Draw the textured ambient overlay tiles, and the light overlay over them, at once.
+    // Without the ambient overlays, the light overlay is still drawn below.
+    if(_info.overlay.active && VideoManager->AreAmbientOverlaysEnabled()) {
+        // The tiles follow the screen shaking, like the images.
+        VideoManager->DrawAmbientEffects(_ambient_overlay_img,
+                                         _info.overlay.x_shift + _shake.x,
+                                         _info.overlay.y_shift + _shake.y,
+                                         _info.light.active ? _info.light.color : Color::clear);
+        return;
     }
 
     // Draw the light overlay
@@ -171,6 +226,7 @@ void EffectSupervisor::DisableEffects()
 {
     DisableAmbientOverlay();
     DisableLightingOverlay();
+    DisableWeather();
     StopShaking();
 }
 
@@ -54,9 +54,37 @@ struct AmbientLightInfo {
     vt_video::Color color;
 };
 
+//! \brief The procedural weathers drawn by the effect supervisor, each in a single shader pass.
+enum WeatherType {
+    WEATHER_NONE = 0,
+    WEATHER_RAIN = 1,
+    WEATHER_SNOW = 2,
+    WEATHER_FOG = 3,
+    WEATHER_HEAT_HAZE = 4,
+    WEATHER_TOTAL = 5
+};
+
+struct AmbientWeatherInfo {
+    //! The weather drawn, or WEATHER_NONE
+    WeatherType type;
+    //! The weather density, in [0.0f, 1.0f]
+    float intensity;
+    //! The wind velocity (in pixel per second)
+    float wind_x;
+    float wind_y;
+    //! The weather color, whose alpha scales its opacity
+    vt_video::Color color;
+    //! The weather time, in seconds
+    float time;
+    //! The weather origin, following the camera movements
+    float x_shift;
+    float y_shift;
+};
+
 struct AmbientEffectsInfo {
     AmbientOverlayInfo overlay;
     AmbientLightInfo light;
+    AmbientWeatherInfo weather;
 };
 
 
@@ -89,6 +117,20 @@ public:
     //! \brief disables the textured ambient overlay
     void DisableAmbientOverlay();
 
+    /** \brief Enables a procedural weather drawn over the whole screen, replacing the current one.
+    *** \param type The weather type, one of the WEATHER_* values.
+    *** \param intensity The weather density, in [0.0f, 1.0f].
+    *** \param wind_x, wind_y The wind velocity, in pixels per second.
+    *** \param color The weather color, whose alpha scales the weather opacity.
+    *** The weather follows the camera movements, like the world it falls on.
+    **/
+    void EnableWeather(int32_t type, float intensity,
+                       float wind_x, float wind_y,
+                       const vt_video::Color& color);
+
+    //! \brief disables the procedural weather
+    void DisableWeather();
+
     //! \brief Adds to the overlay parallax values. Used by the map mode when the camera is moving.
     void AddParallax(float x, float y) {
         _info.overlay.x_parallax += x;
@@ -150,6 +192,9 @@ private:
     **/
     void _UpdateAmbientOverlay(uint32_t frame_time);
 
+    //! \brief Updates the weather time and origin.
+    void _UpdateWeather(uint32_t frame_time);
+
     //! Image used as ambient overlay
     vt_video::StillImage _ambient_overlay_img;
 
@@ -98,7 +98,28 @@ void BindEngineCode()
             .def("CreateAnimation", &ScriptSupervisor::CreateAnimation)
             .def("CreateText", (vt_video::TextImage*(ScriptSupervisor:: *)(const std::string&, const vt_video::TextStyle&))&ScriptSupervisor::CreateText)
             .def("CreateText", (vt_video::TextImage*(ScriptSupervisor:: *)(const vt_utils::ustring&, const vt_video::TextStyle&))&ScriptSupervisor::CreateText)
+            .def("CreateLayer", &ScriptSupervisor::CreateLayer)
+            .def("DrawImages", &ScriptSupervisor::DrawImages)
+            .def("DrawTransformedImages", &ScriptSupervisor::DrawTransformedImages)
             .def("SetDrawFlag", &ScriptSupervisor::SetDrawFlag)
+
+            // Namespace constants
+            .enum_("constants") [
+                // Layer draw stages
+                luabind::value("SCRIPT_LAYER_BACKGROUND", SCRIPT_LAYER_BACKGROUND),
+                luabind::value("SCRIPT_LAYER_FOREGROUND", SCRIPT_LAYER_FOREGROUND),
+                luabind::value("SCRIPT_LAYER_POST_EFFECTS", SCRIPT_LAYER_POST_EFFECTS)
+            ],
+
+            luabind::class_<ScriptLayer>("ScriptLayer")
+            .def("SetPosition", &ScriptLayer::SetPosition)
+            .def("SetVelocity", &ScriptLayer::SetVelocity)
+            .def("SetWrapSize", &ScriptLayer::SetWrapSize)
+            .def("SetBlendMode", &ScriptLayer::SetBlendMode)
+            .def("SetColor", &ScriptLayer::SetColor)
+            .def("SetColorAnimation", &ScriptLayer::SetColorAnimation)
+            .def("SetVisible", &ScriptLayer::SetVisible)
+            .def("IsVisible", &ScriptLayer::IsVisible)
         ];
 
         luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_mode_manager")
@@ -108,6 +129,8 @@ void BindEngineCode()
             .def("DisableLightingOverlay", &EffectSupervisor::DisableLightingOverlay)
             .def("EnableAmbientOverlay", &EffectSupervisor::EnableAmbientOverlay)
             .def("DisableAmbientOverlay", &EffectSupervisor::DisableAmbientOverlay)
+            .def("EnableWeather", &EffectSupervisor::EnableWeather)
+            .def("DisableWeather", &EffectSupervisor::DisableWeather)
             .def("DisableEffects", &EffectSupervisor::DisableEffects)
             .def("GetCameraXMovement", &EffectSupervisor::GetCameraXMovement)
             .def("GetCameraYMovement", &EffectSupervisor::GetCameraYMovement)
@@ -121,7 +144,12 @@ void BindEngineCode()
                 luabind::value("SHAKE_FALLOFF_EASE", SHAKE_FALLOFF_EASE),
                 luabind::value("SHAKE_FALLOFF_LINEAR", SHAKE_FALLOFF_LINEAR),
                 luabind::value("SHAKE_FALLOFF_GRADUAL", SHAKE_FALLOFF_GRADUAL),
-                luabind::value("SHAKE_FALLOFF_SUDDEN", SHAKE_FALLOFF_SUDDEN)
+                luabind::value("SHAKE_FALLOFF_SUDDEN", SHAKE_FALLOFF_SUDDEN),
+                // Weather types
+                luabind::value("WEATHER_RAIN", WEATHER_RAIN),
+                luabind::value("WEATHER_SNOW", WEATHER_SNOW),
+                luabind::value("WEATHER_FOG", WEATHER_FOG),
+                luabind::value("WEATHER_HEAT_HAZE", WEATHER_HEAT_HAZE)
             ]
         ];
 
@@ -143,6 +171,7 @@ void BindEngineCode()
         [
             luabind::class_<ParticleManager>("ParticleManager")
             .def("AddParticleEffect", &ParticleManager::AddParticleEffect)
+            .def("PreloadParticleEffect", &ParticleManager::PreloadParticleEffect)
             .def("StopAll", &ParticleManager::StopAll)
         ];
 
@@ -162,6 +191,7 @@ void BindEngineCode()
             .def("GetEffectSupervisor", &GameMode::GetEffectSupervisor)
             .def("GetParticleManager", &GameMode::GetParticleManager)
             .def("GetIndicatorSupervisor", &GameMode::GetIndicatorSupervisor)
+            .def("LoadTextureAtlas", &GameMode::LoadTextureAtlas)
         ];
 
         luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_mode_manager")
@@ -169,7 +199,7 @@ void BindEngineCode()
             luabind::class_<ModeEngine>("GameModeManager")
             // The adopt policy set on the GameMode pointer is permitting to avoid
             // a memory corruption after the call time.
-            .def("Push", &ModeEngine::Push, luabind::adopt(_2))
+            .def("Push", (void(ModeEngine:: *)(GameMode*, bool, bool))&ModeEngine::Push, luabind::adopt(_2))
             .def("Pop", &ModeEngine::Pop)
             .def("PopAll", &ModeEngine::PopAll)
             .def("GetTop", &ModeEngine::GetTop)
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    frame_pacer.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for pacing the main loop frames.
+*** ***************************************************************************/
+
+#include "frame_pacer.h"
+
+#include <SDL2/SDL_events.h>
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+
+namespace vt_system
+{
+
+//! \brief The weight of the last frame in the averaged sleep and busy times.
+const float FRAME_PACING_AVERAGE_WEIGHT = 0.05f;
+
+//! \brief The frame rate cap when none is set.
+const uint32_t DEFAULT_FRAMES_PER_SECOND = 60;
+
+FramePacer::FramePacer() :
+    _frame_ticks(SDL_GetPerformanceFrequency() / DEFAULT_FRAMES_PER_SECOND),
+    _frame_rate_ticks(_frame_ticks),
+    _frame_cap(0),
+    _next_frame_tick(SDL_GetPerformanceCounter()),
+    _frame_start_tick(_next_frame_tick),
+    _idle_start_tick(_next_frame_tick),
+    _throttled(false),
+    _sleep_time(0.0f),
+    _busy_time(0.0f),
+    _work_time(0.0f)
+{
+}
+
+void FramePacer::SetFrameRate(uint32_t frames_per_second)
+{
+    if(frames_per_second == 0)
+        frames_per_second = DEFAULT_FRAMES_PER_SECOND;
+    _frame_rate_ticks = SDL_GetPerformanceFrequency() / frames_per_second;
+    _UpdateFrameTicks();
+}
+
+void FramePacer::SetFrameCap(uint32_t frames_per_second)
+{
+    if(frames_per_second == _frame_cap)
+        return;
+    _frame_cap = frames_per_second;
+    _UpdateFrameTicks();
+}
+
+float FramePacer::GetFrameBudget() const
+{
+    return static_cast<float>(_frame_ticks) * 1000.0f / SDL_GetPerformanceFrequency();
+}
+
+float FramePacer::GetRemainingTime() const
+{
+    const uint64_t frequency = SDL_GetPerformanceFrequency();
+    const uint64_t frame_ticks = _throttled ? frequency / IDLE_FRAMES_PER_SECOND : _frame_ticks;
+    const uint64_t elapsed = SDL_GetPerformanceCounter() - _frame_start_tick;
+    if(elapsed >= frame_ticks)
+        return 0.0f;
+    return static_cast<float>(frame_ticks - elapsed) * 1000.0f / frequency;
+}
+
+void FramePacer::_UpdateFrameTicks()
+{
+    _frame_ticks = _frame_rate_ticks;
+    if(_frame_cap > 0)
+        _frame_ticks = std::max(_frame_ticks, SDL_GetPerformanceFrequency() / _frame_cap);
+}
+
+void FramePacer::FrameRendered()
+{
+    const float work_time = static_cast<float>(SDL_GetPerformanceCounter() - _frame_start_tick) * 1000.0f
+                            / SDL_GetPerformanceFrequency();
+    _work_time += (work_time - _work_time) * FRAME_PACING_AVERAGE_WEIGHT;
+}
+
+void FramePacer::WaitForNextFrame(bool idle, bool paced_by_display)
+{
+    const uint64_t frequency = SDL_GetPerformanceFrequency();
+    const uint64_t frame_end = SDL_GetPerformanceCounter();
+    uint64_t frame_tick = frame_end;
+
+    // The screen must stay still for a while, so that the animations started
+    // by the last input, like the menu cursor moves, are smooth.
+    if(!idle)
+        _idle_start_tick = frame_tick;
+    const bool was_throttled = _throttled;
+    _throttled = idle && (frame_tick - _idle_start_tick) * 1000 >= IDLE_THROTTLE_DELAY * frequency;
+
+    // Waking up starts a new pacing right away, rather than waiting for the end of the slow frame.
+    if(was_throttled && !_throttled)
+        _next_frame_tick = frame_tick;
+
+    if(paced_by_display && !_throttled) {
+        _next_frame_tick = frame_tick;
+    } else {
+        const uint64_t frame_ticks = _throttled ? frequency / IDLE_FRAMES_PER_SECOND : _frame_ticks;
+        if(frame_tick < _next_frame_tick) {
+            // Sleep the whole milliseconds left, the remaining fraction being shorter than
+            // the sleep granularity. The throttled frames wake up on the first input event.
+            const uint64_t wait_ms = (_next_frame_tick - frame_tick) * 1000 / frequency;
+            if(wait_ms > 0) {
+                if(_throttled)
+                    SDL_WaitEventTimeout(nullptr, static_cast<int>(wait_ms));
+                else
+                    SDL_Delay(static_cast<uint32_t>(wait_ms));
+            }
+            frame_tick = SDL_GetPerformanceCounter();
+        }
+
+        // A late frame starts a new pacing from now, rather than
+        // rendering the missed frames in a burst to catch up.
+        _next_frame_tick += frame_ticks;
+        if(_next_frame_tick + frame_ticks < frame_tick)
+            _next_frame_tick = frame_tick + frame_ticks;
+    }
+
+    const float busy_time = static_cast<float>(frame_end - _frame_start_tick) * 1000.0f / frequency;
+    const float sleep_time = static_cast<float>(frame_tick - frame_end) * 1000.0f / frequency;
+    _busy_time += (busy_time - _busy_time) * FRAME_PACING_AVERAGE_WEIGHT;
+    _sleep_time += (sleep_time - _sleep_time) * FRAME_PACING_AVERAGE_WEIGHT;
+    _frame_start_tick = frame_tick;
+}
+
+} // namespace vt_system
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    frame_pacer.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for pacing the main loop frames.
+***
+*** The frames are paced by the buffer swaps when VSync is on, and otherwise
+*** capped to the display refresh rate, sleeping in between to be nice with
+*** the CPU % used. A lower frame cap can be set, which is kept even with VSync.
+***
+*** When the screen stays still for a while, waiting for the player input like
+*** on the pause screen, the frame rate drops to a few frames per second to save
+*** power. Any input event wakes the game up right away.
+*** ***************************************************************************/
+
+#ifndef __FRAME_PACER_HEADER__
+#define __FRAME_PACER_HEADER__
+
+#include <cstdint>
+
+namespace vt_system
+{
+
+//! \brief The frame rate of a still screen, once throttled.
+const uint32_t IDLE_FRAMES_PER_SECOND = 10;
+
+//! \brief The time the screen must stay still before being throttled, in milliseconds.
+const uint32_t IDLE_THROTTLE_DELAY = 500;
+
+/** ****************************************************************************
+*** \brief Waits for the time to start each frame, and measures the time spent sleeping.
+*** ***************************************************************************/
+class FramePacer
+{
+public:
+    FramePacer();
+
+    //! \brief Sets the frame rate cap, used when the frames aren't paced by the display.
+    void SetFrameRate(uint32_t frames_per_second);
+
+    /** \brief Sets a frame rate cap lower than the display one, or 0 for none.
+    *** The frames must then be paced even with VSync on, see IsCapped().
+    **/
+    void SetFrameCap(uint32_t frames_per_second);
+
+    //! \brief Whether the frame cap set is below the display frame rate.
+    bool IsCapped() const {
+        return _frame_ticks > _frame_rate_ticks;
+    }
+
+    //! \brief The time a frame may take at the capped frame rate, in milliseconds.
+    float GetFrameBudget() const;
+
+    /** \brief The time left before the current frame deadline, in milliseconds, or 0 when late.
+    *** The throttled frames have the whole still screen frame duration.
+    **/
+    float GetRemainingTime() const;
+
+    /** \brief Waits until the next frame should start.
+    *** \param idle Whether the screen is still, only changing on input.
+    *** \param paced_by_display Whether the buffer swaps already wait for the display,
+    *** or the frames shouldn't wait at all, as in fast replays.
+    *** The still screens are throttled after IDLE_THROTTLE_DELAY, even when paced by the display.
+    **/
+    void WaitForNextFrame(bool idle, bool paced_by_display);
+
+    //! \brief Whether the frame rate is currently lowered for a still screen.
+    bool IsThrottled() const {
+        return _throttled;
+    }
+
+    //! \brief The time spent sleeping per frame, averaged over the last frames, in milliseconds.
+    float GetSleepTime() const {
+        return _sleep_time;
+    }
+
+    //! \brief The time spent running the frames, averaged over the last frames, in milliseconds.
+    float GetBusyTime() const {
+        return _busy_time;
+    }
+
+    //! \brief Measures the time the frame took until rendered, without the buffer swap wait.
+    void FrameRendered();
+
+    //! \brief The time spent running the frames until rendered, averaged over the last frames, in milliseconds.
+    //! Unlike the busy time, it doesn't grow with the VSync waits.
+    float GetWorkTime() const {
+        return _work_time;
+    }
+
+private:
+    //! \brief The performance counter ticks per frame, when not throttled.
+    uint64_t _frame_ticks;
+
+    //! \brief The ticks per frame at the display frame rate, and the frame cap set.
+    uint64_t _frame_rate_ticks;
+    uint32_t _frame_cap;
+
+    //! \brief When the next frame should start.
+    uint64_t _next_frame_tick;
+
+    //! \brief When the current frame started, once the wait was over.
+    uint64_t _frame_start_tick;
+
+    //! \brief Since when the screen is still.
+    uint64_t _idle_start_tick;
+
+    bool _throttled;
+
+    //! \brief The averaged sleep and busy times, in milliseconds.
+    float _sleep_time;
+    float _busy_time;
+    float _work_time;
+
+    //! \brief Sets the ticks per frame from the display frame rate and the frame cap.
+    void _UpdateFrameTicks();
+};
+
+} // namespace vt_system
+
+#endif // __FRAME_PACER_HEADER__
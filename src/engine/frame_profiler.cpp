@@ -0,0 +1,460 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    frame_profiler.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for timing the parts of each frame.
+*** ***************************************************************************/
+
+#include "engine/frame_profiler.h"
+
+#include "engine/log_backend.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+#include "utils/utils_strings.h"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+using namespace vt_utils;
+
+namespace vt_system
+{
+
+extern bool SYSTEM_DEBUG;
+
+bool FrameProfiler::_enabled = false;
+bool FrameProfiler::_overlay_shown = false;
+bool FrameProfiler::_recording_trace = false;
+std::string FrameProfiler::_overlay_text;
+
+namespace
+{
+
+//! \brief The scopes a thread can record between two frames, the oldest being dropped beyond.
+//! A power of two, so that the write index can wrap around.
+const uint32_t THREAD_SCOPES_SIZE = 16384;
+
+//! \brief The scopes kept in a trace at most, so that a forgotten recording doesn't eat the memory.
+const uint32_t MAX_TRACE_SCOPES = 2000000;
+
+//! \brief The weight of the last frame in the averaged overlay timings.
+const float OVERLAY_SMOOTHING = 0.1f;
+
+//! \brief The frames between two refreshes of the overlay text, so that it stays readable.
+const uint32_t OVERLAY_REFRESH_FRAMES = 15;
+
+//! \brief The frames a scope stays in the overlay once it isn't timed anymore.
+const uint32_t OVERLAY_SCOPE_LIFETIME = 120;
+
+//! \brief Separates the names of the scopes in their path, sorted before any printable character.
+const char OVERLAY_PATH_SEPARATOR = '\x01';
+
+//! \brief A scope recorded by a thread.
+class RecordedScope
+{
+public:
+    RecordedScope() :
+        name(nullptr),
+        start(0),
+        end(0)
+    {}
+
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+//! \brief The scopes recorded by a thread, written by that thread only.
+class ThreadScopes
+{
+public:
+    ThreadScopes() :
+        scopes(THREAD_SCOPES_SIZE),
+        read(0),
+        index(0),
+        main_thread(false)
+    {
+        SDL_AtomicSet(&written, 0);
+    }
+
+    //! \brief The ring buffer of the recorded scopes.
+    std::vector<RecordedScope> scopes;
+
+    //! \brief The number of scopes written, wrapping around.
+    SDL_atomic_t written;
+
+    //! \brief The number of scopes read by the main thread.
+    uint32_t read;
+
+    uint32_t index;
+    bool main_thread;
+};
+
+//! \brief A scope recorded in a trace.
+class TraceScope
+{
+public:
+    TraceScope(const RecordedScope& scope, uint32_t thread_) :
+        name(scope.name),
+        start(scope.start),
+        end(scope.end),
+        thread(thread_)
+    {}
+
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    uint32_t thread;
+};
+
+//! \brief The averaged timing of a scope shown in the overlay.
+class OverlayScope
+{
+public:
+    OverlayScope() :
+        name(nullptr),
+        depth(0),
+        average_ms(-1.0f),
+        calls(0),
+        frame_ms(0.0f),
+        frame_calls(0),
+        frames_unseen(0)
+    {}
+
+    const char* name;
+    uint32_t depth;
+    float average_ms;
+    uint32_t calls;
+
+    //! \brief The time and calls of the last frame.
+    float frame_ms;
+    uint32_t frame_calls;
+
+    uint32_t frames_unseen;
+};
+
+//! \brief Tells the threads where their scopes are.
+SDL_TLSID thread_scopes_id = 0;
+
+//! \brief The scopes of every thread which recorded one, and their lock.
+std::vector<ThreadScopes*> thread_scopes;
+SDL_mutex* thread_scopes_mutex = nullptr;
+
+SDL_threadID main_thread_id = 0;
+
+//! \brief The recorded trace, and when it started.
+std::vector<TraceScope> trace_scopes;
+uint64_t trace_start = 0;
+
+//! \brief The overlay scopes, by path so that the children follow their parent.
+std::map<std::string, OverlayScope> overlay_scopes;
+uint32_t overlay_frames = 0;
+
+//! \brief The scopes of a thread read this frame, kept to reuse the memory.
+std::vector<RecordedScope> frame_scopes;
+
+bool IsScopeBefore(const RecordedScope& first, const RecordedScope& second)
+{
+    // A parent starting with its child comes first.
+    if (first.start != second.start)
+        return first.start < second.start;
+    return first.end > second.end;
+}
+
+std::string GetThreadName(const ThreadScopes& thread)
+{
+    return thread.main_thread ? "Main thread" : "Thread " + NumberToString(thread.index);
+}
+
+//! \brief Adds the scopes of a thread read this frame to the overlay, as a tree.
+void AddOverlayScopes(const ThreadScopes& thread)
+{
+    std::sort(frame_scopes.begin(), frame_scopes.end(), IsScopeBefore);
+
+    const double ticks_per_ms = SDL_GetPerformanceFrequency() / 1000.0;
+
+    // The other threads are shown under their name, with their total time.
+    std::string root;
+    uint32_t root_depth = 0;
+    OverlayScope* thread_scope = nullptr;
+    if (!thread.main_thread) {
+        root = GetThreadName(thread);
+        root_depth = 1;
+        thread_scope = &overlay_scopes[root];
+        thread_scope->name = nullptr;
+        thread_scope->depth = 0;
+        thread_scope->frame_calls = 1;
+    }
+
+    // The ends and paths of the scopes containing the current one.
+    std::vector<std::pair<uint64_t, std::string> > parents;
+    for (uint32_t i = 0; i < frame_scopes.size(); ++i) {
+        const RecordedScope& scope = frame_scopes[i];
+        while (!parents.empty() && parents.back().first <= scope.start)
+            parents.pop_back();
+
+        const float ms = static_cast<float>((scope.end - scope.start) / ticks_per_ms);
+        if (parents.empty() && thread_scope != nullptr)
+            thread_scope->frame_ms += ms;
+
+        std::string path = (parents.empty() ? root : parents.back().second);
+        path += OVERLAY_PATH_SEPARATOR;
+        path += scope.name;
+
+        OverlayScope& overlay_scope = overlay_scopes[path];
+        overlay_scope.name = scope.name;
+        overlay_scope.depth = root_depth + parents.size();
+        overlay_scope.frame_ms += ms;
+        ++overlay_scope.frame_calls;
+
+        parents.push_back(std::make_pair(scope.end, path));
+    }
+}
+
+//! \brief Averages the overlay scopes of the frame, and refreshes the overlay text once in a while.
+void UpdateOverlay(std::string& overlay_text)
+{
+    for (auto it = overlay_scopes.begin(); it != overlay_scopes.end();) {
+        OverlayScope& scope = it->second;
+        if (scope.frame_calls > 0) {
+            scope.average_ms = (scope.average_ms < 0.0f) ? scope.frame_ms :
+                               scope.average_ms * (1.0f - OVERLAY_SMOOTHING) + scope.frame_ms * OVERLAY_SMOOTHING;
+            scope.calls = scope.frame_calls;
+            scope.frames_unseen = 0;
+        }
+        else {
+            scope.average_ms *= 1.0f - OVERLAY_SMOOTHING;
+            if (++scope.frames_unseen > OVERLAY_SCOPE_LIFETIME) {
+                it = overlay_scopes.erase(it);
+                continue;
+            }
+        }
+        scope.frame_ms = 0.0f;
+        scope.frame_calls = 0;
+        ++it;
+    }
+
+    if (++overlay_frames < OVERLAY_REFRESH_FRAMES)
+        return;
+    overlay_frames = 0;
+
+    overlay_text = "CPU ms:";
+    for (auto it = overlay_scopes.begin(); it != overlay_scopes.end(); ++it) {
+        const OverlayScope& scope = it->second;
+        overlay_text += "\n" + std::string(scope.depth * 2, ' ')
+                        + (scope.name != nullptr ? std::string(scope.name) : it->first) + " "
+                        // Rounded to a hundredth of a millisecond.
+                        + NumberToString(static_cast<int32_t>(scope.average_ms * 100.0f) / 100.0f);
+        if (scope.calls > 1)
+            overlay_text += " (x" + NumberToString(scope.calls) + ")";
+    }
+
+    overlay_text += "\nLog lines: " + NumberToString(LogBackend::GetWrittenLines())
+                    + " (" + NumberToString(LogBackend::GetSuppressedLines()) + " suppressed, "
+                    + NumberToString(LogBackend::GetDroppedLines()) + " dropped)";
+}
+
+//! \brief Writes a name as a JSON string.
+void WriteJsonString(std::ofstream& file, const char* text)
+{
+    file << '"';
+    for (const char* c = text; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\')
+            file << '\\';
+        file << *c;
+    }
+    file << '"';
+}
+
+bool WriteTrace(const std::string& filename)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        PRINT_WARNING << "Couldn't open the trace file: " << filename << std::endl;
+        return false;
+    }
+
+    const double ticks_per_us = SDL_GetPerformanceFrequency() / 1000000.0;
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[";
+
+    // Name the threads first.
+    for (uint32_t i = 0; i < thread_scopes.size(); ++i) {
+        file << (i == 0 ? "\n" : ",\n")
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread_scopes[i]->index
+             << ",\"args\":{\"name\":\"" << GetThreadName(*thread_scopes[i]) << "\"}}";
+    }
+
+    for (uint32_t i = 0; i < trace_scopes.size(); ++i) {
+        const TraceScope& scope = trace_scopes[i];
+        file << ",\n{\"name\":";
+        WriteJsonString(file, scope.name);
+        file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << scope.thread
+             << ",\"ts\":" << (scope.start - trace_start) / ticks_per_us
+             << ",\"dur\":" << (scope.end - scope.start) / ticks_per_us << "}";
+    }
+
+    file << "\n]}" << std::endl;
+    return !file.fail();
+}
+
+} // namespace
+
+void FrameProfiler::ToggleOverlay()
+{
+    _overlay_shown = !_overlay_shown;
+    overlay_scopes.clear();
+    overlay_frames = OVERLAY_REFRESH_FRAMES;
+    _overlay_text.clear();
+    _UpdateEnabled();
+}
+
+void FrameProfiler::ToggleTraceRecording(const std::string& filename)
+{
+    if (!_recording_trace) {
+        trace_scopes.clear();
+        trace_start = SDL_GetPerformanceCounter();
+        _recording_trace = true;
+        _UpdateEnabled();
+        IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Started recording a trace for: " << filename << std::endl;
+        return;
+    }
+
+    _recording_trace = false;
+    _UpdateEnabled();
+
+    // The threads may add themselves while their names are written.
+    SDL_LockMutex(thread_scopes_mutex);
+    const bool written = WriteTrace(filename);
+    SDL_UnlockMutex(thread_scopes_mutex);
+
+    if (written)
+        IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Wrote " << trace_scopes.size() << " scopes to: " << filename << std::endl;
+
+    // Give the memory back.
+    std::vector<TraceScope>().swap(trace_scopes);
+}
+
+void FrameProfiler::AddScope(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadScopes* thread = static_cast<ThreadScopes*>(SDL_TLSGet(thread_scopes_id));
+    if (thread == nullptr) {
+        // The scopes are kept until the game exits, as the main thread may still read them.
+        thread = new ThreadScopes();
+        thread->main_thread = (SDL_ThreadID() == main_thread_id);
+
+        SDL_LockMutex(thread_scopes_mutex);
+        thread->index = thread_scopes.size();
+        thread_scopes.push_back(thread);
+        SDL_UnlockMutex(thread_scopes_mutex);
+
+        SDL_TLSSet(thread_scopes_id, thread, nullptr);
+    }
+
+    // SDL_AtomicAdd() is a full barrier, so the main thread never reads the scope half written.
+    const uint32_t written = static_cast<uint32_t>(SDL_AtomicGet(&thread->written));
+    RecordedScope& scope = thread->scopes[written % THREAD_SCOPES_SIZE];
+    scope.name = name;
+    scope.start = start;
+    scope.end = end;
+    SDL_AtomicAdd(&thread->written, 1);
+}
+
+void FrameProfiler::EndFrame()
+{
+    if (!_enabled)
+        return;
+
+    SDL_LockMutex(thread_scopes_mutex);
+
+    for (uint32_t i = 0; i < thread_scopes.size(); ++i) {
+        ThreadScopes& thread = *thread_scopes[i];
+        const uint32_t written = static_cast<uint32_t>(SDL_AtomicGet(&thread.written));
+
+        // The scopes overwritten since the last frame are lost.
+        if (written - thread.read > THREAD_SCOPES_SIZE) {
+            IF_PRINT_WARNING(SYSTEM_DEBUG) << "Dropped " << (written - thread.read - THREAD_SCOPES_SIZE)
+                                           << " scopes of the thread " << thread.index << std::endl;
+            thread.read = written - THREAD_SCOPES_SIZE;
+        }
+
+        frame_scopes.clear();
+        for (; thread.read != written; ++thread.read) {
+            const RecordedScope& scope = thread.scopes[thread.read % THREAD_SCOPES_SIZE];
+            if (_recording_trace && scope.start >= trace_start && trace_scopes.size() < MAX_TRACE_SCOPES)
+                trace_scopes.push_back(TraceScope(scope, thread.index));
+            if (_overlay_shown)
+                frame_scopes.push_back(scope);
+        }
+
+        if (_overlay_shown)
+            AddOverlayScopes(thread);
+    }
+
+    SDL_UnlockMutex(thread_scopes_mutex);
+
+    if (_overlay_shown)
+        UpdateOverlay(_overlay_text);
+}
+
+void FrameProfiler::_UpdateEnabled()
+{
+    const bool enabled = _overlay_shown || _recording_trace;
+    if (enabled == _enabled)
+        return;
+
+    if (enabled) {
+        if (thread_scopes_mutex == nullptr) {
+            thread_scopes_mutex = SDL_CreateMutex();
+            thread_scopes_id = SDL_TLSCreate();
+            main_thread_id = SDL_ThreadID();
+        }
+
+        // Skip the scopes recorded before it was last disabled.
+        SDL_LockMutex(thread_scopes_mutex);
+        for (uint32_t i = 0; i < thread_scopes.size(); ++i)
+            thread_scopes[i]->read = static_cast<uint32_t>(SDL_AtomicGet(&thread_scopes[i]->written));
+        SDL_UnlockMutex(thread_scopes_mutex);
+    }
+
+    _enabled = enabled;
+}
+
+ProfileScope::ProfileScope(const char* name) :
+    _name(name),
+    _start(FrameProfiler::IsEnabled() ? SDL_GetPerformanceCounter() : 0)
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (_start != 0)
+        FrameProfiler::AddScope(_name, _start, SDL_GetPerformanceCounter());
+}
+
+ProfileScope::ProfileScope(const ProfileScope&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+ProfileScope& ProfileScope::operator=(const ProfileScope&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_system
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    frame_profiler.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for timing the parts of each frame.
+***
+*** The engine and game modes code is marked with PROFILE_SCOPE() markers,
+*** timing the rest of their block. Each thread records its scopes in its own
+*** buffer, read by the main thread once per frame, so that no lock is taken
+*** while recording.
+***
+*** The scopes of the main thread are shown as a tree in an overlay, averaged
+*** over the last frames, and the scopes of every thread can be recorded into
+*** a Chrome trace events JSON file, readable by chrome://tracing.
+***
+*** \note The markers are only compiled with the debug features, and they do
+*** nothing until the overlay is shown or a trace is recorded.
+*** ***************************************************************************/
+
+#ifndef __FRAME_PROFILER_HEADER__
+#define __FRAME_PROFILER_HEADER__
+
+#include <cstdint>
+#include <string>
+
+#ifdef DEBUG_FEATURES
+#define PROFILE_SCOPE_CONCAT_(a, b) a##b
+#define PROFILE_SCOPE_CONCAT(a, b) PROFILE_SCOPE_CONCAT_(a, b)
+//! \brief Times the rest of the block. The name must be a string literal.
+#define PROFILE_SCOPE(name) vt_system::ProfileScope PROFILE_SCOPE_CONCAT(_profile_scope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+namespace vt_system
+{
+
+/** ****************************************************************************
+*** \brief Gathers the scopes timed by each thread.
+***
+*** Everything but the scopes recording must be called by the main thread.
+*** ***************************************************************************/
+class FrameProfiler
+{
+public:
+    //! \brief Whether the scopes are recorded, for the overlay or a trace.
+    static bool IsEnabled() {
+        return _enabled;
+    }
+
+    //! \brief Shows or hides the overlay.
+    static void ToggleOverlay();
+
+    static bool IsOverlayShown() {
+        return _overlay_shown;
+    }
+
+    /** \brief Starts recording a trace, or writes the recorded one to the file.
+    *** \param filename The Chrome trace events JSON file to write.
+    **/
+    static void ToggleTraceRecording(const std::string& filename);
+
+    static bool IsRecordingTrace() {
+        return _recording_trace;
+    }
+
+    /** \brief Adds a scope of the calling thread.
+    *** \param name The name of the scope. Must be a string literal.
+    *** \param start The performance counter when the scope started.
+    *** \param end The performance counter when the scope ended.
+    **/
+    static void AddScope(const char* name, uint64_t start, uint64_t end);
+
+    //! \brief Reads the scopes recorded by every thread since the last frame.
+    static void EndFrame();
+
+    //! \brief The overlay text, as of the last frame.
+    static const std::string& GetOverlayText() {
+        return _overlay_text;
+    }
+
+private:
+    static bool _enabled;
+    static bool _overlay_shown;
+    static bool _recording_trace;
+
+    static std::string _overlay_text;
+
+    //! \brief Enables the recording when the overlay or the trace needs it.
+    static void _UpdateEnabled();
+};
+
+/** ****************************************************************************
+*** \brief Times a scope for the frame profiler, from its creation to its destruction.
+***
+*** Use the PROFILE_SCOPE() macro rather than this class, so that the scope
+*** is compiled out without the debug features.
+*** ***************************************************************************/
+class ProfileScope
+{
+public:
+    //! \param name The name of the scope. Must be a string literal.
+    explicit ProfileScope(const char* name);
+
+    ~ProfileScope();
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ProfileScope(const ProfileScope& profile_scope);
+    ProfileScope& operator=(const ProfileScope& profile_scope);
+
+    const char* _name;
+
+    //! \brief The performance counter at creation, 0 when the profiler is disabled.
+    uint64_t _start;
+};
+
+} // namespace vt_system
+
+#endif // __FRAME_PROFILER_HEADER__
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    hitch_recorder.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for reporting the frames taking too long.
+*** ***************************************************************************/
+
+#include "engine/hitch_recorder.h"
+
+#include "engine/audio/audio.h"
+#include "engine/frame_profiler.h"
+#include "engine/job_system.h"
+#include "engine/log_backend.h"
+#include "engine/lua_heap.h"
+#include "engine/mode_manager.h"
+#include "engine/system.h"
+#include "engine/video/video.h"
+
+#include "common/app_settings.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+#include "utils/utils_strings.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace vt_system
+{
+
+uint32_t HitchRecorder::_threshold = HITCH_DEFAULT_THRESHOLD;
+uint32_t HitchRecorder::_report_count = 0;
+float HitchRecorder::_last_frame_time = 0.0f;
+
+namespace
+{
+
+//! \brief What is known about a past frame.
+class HitchFrame
+{
+public:
+    HitchFrame() :
+        frame_time(0.0f),
+        update_time(0),
+        lua_gc_time(0.0f),
+        pending_uploads(0),
+        decoding_audio(0),
+        mode_type(vt_mode_manager::MODE_MANAGER_DUMMY_MODE),
+        loading(false)
+    {}
+
+    //! \brief The frame duration, and the game time it advanced, in milliseconds.
+    float frame_time;
+    uint32_t update_time;
+
+    //! \brief The time spent collecting the Lua garbage, in milliseconds.
+    float lua_gc_time;
+
+    //! \brief The images waiting to be reuploaded, and the static audio still decoded.
+    uint32_t pending_uploads;
+    uint32_t decoding_audio;
+
+    //! \brief The active game mode type, and whether game modes were loading.
+    uint8_t mode_type;
+    bool loading;
+};
+
+//! \brief The ring of the last frames, and the index of the next frame written.
+std::vector<HitchFrame> frames(HITCH_HISTORY_FRAMES);
+uint32_t next_frame = 0;
+
+//! \brief The number of frames recorded, up to the ring size.
+uint32_t frame_count = 0;
+
+//! \brief The performance counter when the last frame ended, 0 before the first one.
+uint64_t last_frame_end = 0;
+
+//! \brief The ticks when the last report was written.
+uint32_t last_report_ticks = 0;
+
+} // namespace
+
+void HitchRecorder::EndFrame()
+{
+    const uint64_t now = SDL_GetPerformanceCounter();
+    const float frame_time = last_frame_end == 0 ? 0.0f :
+                             static_cast<float>(now - last_frame_end) * 1000.0f / SDL_GetPerformanceFrequency();
+    last_frame_end = now;
+    _last_frame_time = frame_time;
+
+    if(_threshold == 0)
+        return;
+
+    HitchFrame& frame = frames[next_frame];
+    frame.frame_time = frame_time;
+    frame.update_time = SystemManager->GetFrameTime();
+    frame.lua_gc_time = LuaHeap::GetLastStepTime();
+    frame.pending_uploads = vt_video::TextureManager->GetPendingUploadCount();
+    frame.decoding_audio = vt_audio::AudioManager->GetDecodingAudioCount();
+    frame.mode_type = vt_mode_manager::ModeManager->GetGameType();
+    frame.loading = vt_mode_manager::ModeManager->IsLoading();
+    next_frame = (next_frame + 1) % HITCH_HISTORY_FRAMES;
+    if(frame_count < HITCH_HISTORY_FRAMES)
+        ++frame_count;
+
+    // The still screens are throttled on purpose, and the frame cap makes the frames last longer.
+    const FramePacer& frame_pacer = SystemManager->GetFramePacer();
+    if(frame_time <= static_cast<float>(_threshold) || frame_pacer.IsThrottled()
+            || frame_time <= frame_pacer.GetFrameBudget() * 1.5f)
+        return;
+
+    if(_report_count >= HITCH_MAX_REPORTS)
+        return;
+    const uint32_t ticks = SDL_GetTicks();
+    if(_report_count > 0 && ticks - last_report_ticks < HITCH_REPORT_INTERVAL)
+        return;
+    last_report_ticks = ticks;
+
+    _WriteReport(frame_time);
+}
+
+void HitchRecorder::_WriteReport(float frame_time)
+{
+    const std::string directory = vt_common::GetUserDataPath() + "hitches/";
+    if(!vt_utils::DoesFileExist(directory))
+        vt_utils::MakeDirectory(directory);
+    const std::string filename = directory + "hitch_" + vt_utils::NumberToString(_report_count % HITCH_MAX_REPORTS) + ".txt";
+    ++_report_count;
+
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1);
+
+    const std::time_t date = std::time(nullptr);
+    char date_text[64];
+    if(std::strftime(date_text, sizeof(date_text), "%Y-%m-%d %H:%M:%S", std::localtime(&date)) == 0)
+        date_text[0] = '\0';
+    report << "Hitch of " << frame_time << " ms (threshold: " << _threshold << " ms) on " << date_text << std::endl;
+
+    vt_mode_manager::GameMode* mode = vt_mode_manager::ModeManager->GetTop();
+    report << "Game mode: " << vt_mode_manager::GetGameModeName(vt_mode_manager::ModeManager->GetGameType());
+    if(mode && !mode->GetReportDescription().empty())
+        report << " (" << mode->GetReportDescription() << ")";
+    report << std::endl;
+
+    const FramePacer& frame_pacer = SystemManager->GetFramePacer();
+    report << "Frame budget: " << frame_pacer.GetFrameBudget() << " ms, work time: "
+           << frame_pacer.GetWorkTime() << " ms, render scale: " << vt_video::VideoManager->GetCurrentRenderScale() << "%" << std::endl;
+    report << "Log lines: " << LogBackend::GetWrittenLines() << " (" << LogBackend::GetSuppressedLines()
+           << " suppressed, " << LogBackend::GetDroppedLines() << " dropped)" << std::endl;
+
+    report << std::endl << "Frame, duration (ms), game time (ms), Lua GC (ms), pending uploads, audio decoding, mode" << std::endl;
+    for(uint32_t i = 0; i < frame_count; ++i) {
+        const uint32_t index = (next_frame + HITCH_HISTORY_FRAMES - frame_count + i) % HITCH_HISTORY_FRAMES;
+        const HitchFrame& frame = frames[index];
+        report << static_cast<int32_t>(i + 1) - static_cast<int32_t>(frame_count) << ", "
+               << frame.frame_time << ", " << frame.update_time << ", " << frame.lua_gc_time << ", "
+               << frame.pending_uploads << ", " << frame.decoding_audio << ", " << vt_mode_manager::GetGameModeName(frame.mode_type)
+               << (frame.loading ? " (loading)" : "") << std::endl;
+    }
+
+#ifdef DEBUG_FEATURES
+    if(FrameProfiler::IsEnabled())
+        report << std::endl << "Profiler scopes:" << std::endl << FrameProfiler::GetOverlayText() << std::endl;
+#endif
+
+    // Writing the file could make the next frame hitch as well.
+    const std::string text = report.str();
+    vt_system::JobManager->Schedule([filename, text]() {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+        file << text;
+        file.close();
+        if(file.fail())
+            PRINT_WARNING << "Couldn't write the hitch report: " << filename << std::endl;
+    });
+
+    IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Hitch of " << frame_time << " ms reported in: " << filename << std::endl;
+}
+
+} // namespace vt_system
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    hitch_recorder.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for reporting the frames taking too long.
+***
+*** The main loop reports the end of each frame. A few numbers are kept about
+*** the last frames: Their duration, the game time they advanced, the Lua
+*** garbage collection time, the assets still loaded in the background and the
+*** active game mode.
+***
+*** When a frame takes longer than the threshold, those frames are written to a
+*** report in the hitches/ folder of the user data, along with the game mode
+*** description, like the map file, and the profiler scopes when recorded. The
+*** report is written by a worker thread, and only a few reports are written
+*** per game session, so that the recorder can be left on in every build.
+*** ***************************************************************************/
+
+#ifndef __HITCH_RECORDER_HEADER__
+#define __HITCH_RECORDER_HEADER__
+
+#include <cstdint>
+#include <string>
+
+namespace vt_system
+{
+
+//! \brief The frame duration beyond which a hitch is reported by default, in milliseconds.
+const uint32_t HITCH_DEFAULT_THRESHOLD = 33;
+
+//! \brief The number of frames written in a report, the hitch being the last one.
+const uint32_t HITCH_HISTORY_FRAMES = 120;
+
+//! \brief The reports written per game session at most, the older ones being overwritten.
+const uint32_t HITCH_MAX_REPORTS = 8;
+
+//! \brief The time between two reports at least, in milliseconds, as a hitch rarely comes alone.
+const uint32_t HITCH_REPORT_INTERVAL = 10000;
+
+/** ****************************************************************************
+*** \brief Writes a report about the last frames when a frame takes too long.
+***
+*** \note Must be used by the main thread only.
+*** ***************************************************************************/
+class HitchRecorder
+{
+public:
+    //! \brief Sets the frame duration beyond which a hitch is reported, in milliseconds, or 0 to never report.
+    static void SetThreshold(uint32_t milliseconds) {
+        _threshold = milliseconds;
+    }
+
+    static uint32_t GetThreshold() {
+        return _threshold;
+    }
+
+    //! \brief Records the frame which just ended, and reports it if it took too long.
+    static void EndFrame();
+
+    //! \brief Returns the number of reports written since the game started.
+    static uint32_t GetReportCount() {
+        return _report_count;
+    }
+
+    //! \brief Returns the duration of the last frame, from the end of the previous one, in milliseconds.
+    static float GetLastFrameTime() {
+        return _last_frame_time;
+    }
+
+private:
+    static uint32_t _threshold;
+    static uint32_t _report_count;
+    static float _last_frame_time;
+
+    //! \brief Writes the report of the last frames, the last one being the hitch.
+    static void _WriteReport(float frame_time);
+};
+
+} // namespace vt_system
+
+#endif // __HITCH_RECORDER_HEADER__
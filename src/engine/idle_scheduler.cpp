@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    idle_scheduler.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for running the deferred work in the frames slack time.
+*** ***************************************************************************/
+
+#include "engine/idle_scheduler.h"
+
+#include "engine/frame_profiler.h"
+#include "engine/system.h"
+
+#include "utils/utils_common.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace vt_system
+{
+
+namespace
+{
+
+//! \brief The slice duration beyond which a task is reported in debug mode, in milliseconds.
+const float IDLE_SLOW_SLICE_TIME = 2.0f;
+
+//! \brief A task submitted, until it is done or cancelled.
+class IdleTask
+{
+public:
+    IdleTask() :
+        name(nullptr),
+        priority(IDLE_PRIORITY_NORMAL),
+        deadline_ticks(0),
+        owner(nullptr)
+    {}
+
+    const char* name;
+
+    //! \brief The slice function, empty once the task is done or cancelled.
+    IdleScheduler::Task task;
+
+    IDLE_PRIORITY priority;
+
+    //! \brief The ticks from which the task runs without slack.
+    uint32_t deadline_ticks;
+
+    const void* owner;
+};
+
+//! \brief The tasks, in the submission order.
+std::vector<IdleTask> tasks;
+
+//! \brief Whether the tasks are being run, during which they are only marked as done.
+bool running = false;
+
+//! \brief Tells whether a deadline is over, the ticks wrapping around.
+bool IsOverdue(const IdleTask& idle_task, uint32_t ticks)
+{
+    return static_cast<int32_t>(ticks - idle_task.deadline_ticks) >= 0;
+}
+
+//! \brief Returns the index of the most urgent task, or -1 if none is left.
+int32_t FindNextTask()
+{
+    int32_t next = -1;
+    for(uint32_t i = 0; i < tasks.size(); ++i) {
+        if(!tasks[i].task)
+            continue;
+        if(next < 0 || tasks[i].priority < tasks[next].priority ||
+                (tasks[i].priority == tasks[next].priority &&
+                 static_cast<int32_t>(tasks[i].deadline_ticks - tasks[next].deadline_ticks) < 0))
+            next = static_cast<int32_t>(i);
+    }
+    return next;
+}
+
+//! \brief Runs a slice of a task, and forgets it once done.
+void RunSlice(uint32_t index)
+{
+#ifdef DEBUG_FEATURES
+    ProfileScope profile_scope(tasks[index].name);
+#endif
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    // Copied, as the task may submit other ones, moving the tasks around.
+    IdleScheduler::Task task = tasks[index].task;
+    const bool done = task();
+
+    if(done)
+        tasks[index].task = nullptr;
+
+    const float slice_time = static_cast<float>(SDL_GetPerformanceCounter() - start) * 1000.0f /
+                             static_cast<float>(SDL_GetPerformanceFrequency());
+    if(slice_time > IDLE_SLOW_SLICE_TIME) {
+        IF_PRINT_DEBUG(SYSTEM_DEBUG) << "The idle task: " << tasks[index].name << " took "
+                                     << slice_time << " ms to run a slice" << std::endl;
+    }
+}
+
+//! \brief Removes the tasks done or cancelled.
+void RemoveFinishedTasks()
+{
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                               [](const IdleTask& idle_task) { return !idle_task.task; }),
+                tasks.end());
+}
+
+} // namespace
+
+void IdleScheduler::Submit(const char* name, const Task& task, IDLE_PRIORITY priority,
+                           uint32_t deadline, const void* owner)
+{
+    if(!task)
+        return;
+
+    IdleTask idle_task;
+    idle_task.name = name;
+    idle_task.task = task;
+    idle_task.priority = priority;
+    idle_task.deadline_ticks = SDL_GetTicks() + deadline;
+    idle_task.owner = owner;
+    tasks.push_back(idle_task);
+}
+
+void IdleScheduler::CancelTasks(const void* owner)
+{
+    if(owner == nullptr)
+        return;
+
+    for(uint32_t i = 0; i < tasks.size(); ++i) {
+        if(tasks[i].owner == owner)
+            tasks[i].task = nullptr;
+    }
+
+    if(!running)
+        RemoveFinishedTasks();
+}
+
+void IdleScheduler::Run(float available_time)
+{
+    if(tasks.empty())
+        return;
+
+    PROFILE_SCOPE("Idle tasks");
+    running = true;
+
+    const uint64_t frequency = SDL_GetPerformanceFrequency();
+    const uint64_t start = SDL_GetPerformanceCounter();
+
+    // The overdue tasks get a slice whatever the time left. Only those submitted
+    // before are run, the new ones being appended.
+    const uint32_t ticks = SDL_GetTicks();
+    const uint32_t task_count = tasks.size();
+    for(uint32_t i = 0; i < task_count; ++i) {
+        if(tasks[i].task && IsOverdue(tasks[i], ticks))
+            RunSlice(i);
+    }
+
+    // Then the slack time goes to the most urgent tasks.
+    while(true) {
+        const float elapsed = static_cast<float>(SDL_GetPerformanceCounter() - start) * 1000.0f /
+                              static_cast<float>(frequency);
+        if(available_time - elapsed < IDLE_MIN_SLICE_TIME)
+            break;
+
+        const int32_t next = FindNextTask();
+        if(next < 0)
+            break;
+        RunSlice(static_cast<uint32_t>(next));
+    }
+
+    running = false;
+    RemoveFinishedTasks();
+}
+
+uint32_t IdleScheduler::GetPendingTaskCount()
+{
+    uint32_t count = 0;
+    for(uint32_t i = 0; i < tasks.size(); ++i) {
+        if(tasks[i].task)
+            ++count;
+    }
+    return count;
+}
+
+} // namespace vt_system
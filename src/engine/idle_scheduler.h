@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    idle_scheduler.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for running the deferred work in the frames slack time.
+***
+*** The work which isn't needed right away, like generating the map minimap, is
+*** submitted as a task run one slice at a time. Once a frame is updated, the
+*** main loop runs the task slices fitting in the time left before the frame
+*** deadline, the most urgent tasks first. A task whose deadline is over gets
+*** one slice per frame anyway, so that it ends even when no frame has slack.
+***
+*** The tasks run on the main thread, and may use the OpenGL context and the
+*** Lua state. The work not needing them should be scheduled on the job system.
+*** ***************************************************************************/
+
+#ifndef __IDLE_SCHEDULER_HEADER__
+#define __IDLE_SCHEDULER_HEADER__
+
+#include <cstdint>
+#include <functional>
+
+namespace vt_system
+{
+
+//! \brief The task priorities, the higher ones running first.
+enum IDLE_PRIORITY {
+    IDLE_PRIORITY_HIGH = 0,
+    IDLE_PRIORITY_NORMAL = 1,
+    IDLE_PRIORITY_LOW = 2
+};
+
+//! \brief The time left in a frame under which no slice is started, in milliseconds.
+const float IDLE_MIN_SLICE_TIME = 0.5f;
+
+//! \brief The time kept at the end of a frame for the buffer swap and the frame reports, in milliseconds.
+const float IDLE_FRAME_MARGIN = 1.0f;
+
+/** ****************************************************************************
+*** \brief Runs the deferred tasks in the time left in the frames.
+***
+*** \note Must be used by the main thread only.
+*** ***************************************************************************/
+class IdleScheduler
+{
+public:
+    //! \brief Runs a slice of a task, and returns true once the task is done.
+    //! A slice should take well under a millisecond.
+    typedef std::function<bool()> Task;
+
+    /** \brief Submits a task, run starting from the next frames.
+    *** \param name The task name, shown in the profiler. Must be a string literal.
+    *** \param task The function running a slice of the task.
+    *** \param priority The tasks of a higher priority get the slack time first.
+    *** \param deadline The time from now after which the task runs without slack, in milliseconds.
+    *** \param owner The object the task uses, whose destruction must cancel it, or nullptr.
+    **/
+    static void Submit(const char* name, const Task& task, IDLE_PRIORITY priority,
+                       uint32_t deadline, const void* owner);
+
+    //! \brief Cancels the tasks of an owner, which is being destroyed.
+    static void CancelTasks(const void* owner);
+
+    /** \brief Runs the task slices fitting in the given time, and one slice of the overdue ones.
+    *** \param available_time The time left in the frame, in milliseconds.
+    **/
+    static void Run(float available_time);
+
+    //! \brief Returns the number of tasks not done yet.
+    static uint32_t GetPendingTaskCount();
+};
+
+} // namespace vt_system
+
+#endif // __IDLE_SCHEDULER_HEADER__
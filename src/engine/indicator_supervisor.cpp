@@ -179,6 +179,61 @@ void IndicatorText::Draw()
     _text_image.Draw(_alpha_color);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// IndicatorNumber class
+////////////////////////////////////////////////////////////////////////////////
+
+IndicatorNumber::IndicatorNumber() :
+    IndicatorElement(0.0f, 0.0f, DAMAGE_INDICATOR)
+{}
+
+
+
+void IndicatorNumber::Reset(float x_position, float y_position, uint32_t amount,
+                            const TextStyle& style, INDICATOR_TYPE indicator_type)
+{
+    _timer.Initialize(INDICATOR_TIME);
+    _alpha_color.SetAlpha(0.0f);
+    _force.x = 0.0f;
+    _force.y = INITIAL_FORCE;
+    _origin_position.x = x_position;
+    _origin_position.y = y_position;
+    _relative_position.x = 0.0f;
+    _relative_position.y = 0.0f;
+    _use_parallax = false;
+    _indicator_type = indicator_type;
+
+    _text = vt_utils::MakeUnicodeString(vt_utils::NumberToString(amount));
+    _style = style;
+    _draw_style = style;
+}
+
+
+
+float IndicatorNumber::ElementHeight() const
+{
+    FontProperties* font_properties = _style.GetFontProperties();
+    return font_properties != nullptr ? static_cast<float>(font_properties->height) : 0.0f;
+}
+
+
+
+void IndicatorNumber::Draw()
+{
+    if (_text.empty() || _alpha_color.GetAlpha() <= 0.0f)
+        return;
+
+    Color color = _style.GetColor();
+    color.SetAlpha(color.GetAlpha() * _alpha_color.GetAlpha());
+    _draw_style.SetColor(color);
+
+    VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, VIDEO_BLEND, 0);
+    VideoManager->Move(_origin_position.x + _relative_position.x,
+                       _origin_position.y - _relative_position.y);
+
+    TextManager->Draw(_text, _draw_style);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // IndicatorImage class
 ////////////////////////////////////////////////////////////////////////////////
@@ -294,6 +349,10 @@ IndicatorSupervisor::~IndicatorSupervisor()
         delete _active_queue[i];
     _active_queue.clear();
 
+    for(uint32_t i = 0; i < _number_pool.size(); ++i)
+        delete _number_pool[i];
+    _number_pool.clear();
+
     for(uint32_t i = 0; i < _short_notices.size(); ++i)
         delete _short_notices[i];
     _short_notices.clear();
@@ -313,7 +372,7 @@ void IndicatorSupervisor::Update()
     // Remove all expired elements from the active queue
     while(_active_queue.empty() == false) {
         if(_active_queue.front()->IsExpired()) {
-            delete _active_queue.front();
+            _ReleaseElement(_active_queue.front());
             _active_queue.pop_front();
         } else {
             // If the front element is not expired, no other elements should be expired either
@@ -391,6 +450,34 @@ bool IndicatorSupervisor::_FixPotentialIndicatorOverlapping(IndicatorElement* el
     return true;
 }
 
+IndicatorNumber* IndicatorSupervisor::_GetNumberIndicator(float x_position, float y_position, uint32_t amount,
+                                                          const TextStyle& style, INDICATOR_TYPE indicator_type)
+{
+    IndicatorNumber* indicator = nullptr;
+    if (_number_pool.empty()) {
+        indicator = new IndicatorNumber();
+    }
+    else {
+        indicator = _number_pool.back();
+        _number_pool.pop_back();
+    }
+
+    indicator->Reset(x_position, y_position, amount, style, indicator_type);
+    return indicator;
+}
+
+void IndicatorSupervisor::_ReleaseElement(IndicatorElement* element)
+{
+    // Only the number indicators use those types.
+    INDICATOR_TYPE type = element->GetType();
+    if ((type == DAMAGE_INDICATOR || type == HEALING_INDICATOR)
+            && _number_pool.size() < INDICATOR_NUMBER_POOL_SIZE) {
+        _number_pool.push_back(static_cast<IndicatorNumber*>(element));
+        return;
+    }
+    delete element;
+}
+
 void IndicatorSupervisor::Draw()
 {
     for(uint32_t i = 0; i < _active_queue.size(); i++)
@@ -407,9 +494,7 @@ void IndicatorSupervisor::AddDamageIndicator(float x_position, float y_position,
     if (amount == 0)
         return;
 
-    std::string text = vt_utils::NumberToString(amount);
-
-    IndicatorText* indicator = new IndicatorText(x_position, y_position, text, style, DAMAGE_INDICATOR);
+    IndicatorNumber* indicator = _GetNumberIndicator(x_position, y_position, amount, style, DAMAGE_INDICATOR);
     indicator->SetUseParallax(use_parallax);
 
     _wait_queue.push_back(indicator);
@@ -423,9 +508,7 @@ void IndicatorSupervisor::AddHealingIndicator(float x_position, float y_position
     if(amount == 0)
         return;
 
-    std::string text = vt_utils::NumberToString(amount);
-
-    IndicatorText* indicator = new IndicatorText(x_position, y_position, text, style, HEALING_INDICATOR);
+    IndicatorNumber* indicator = _GetNumberIndicator(x_position, y_position, amount, style, HEALING_INDICATOR);
     indicator->SetUseParallax(use_parallax);
 
     _wait_queue.push_back(indicator);
@@ -29,6 +29,7 @@
 #include "modes/battle/battle_damage.h"
 
 #include <deque>
+#include <vector>
 
 namespace vt_common
 {
@@ -41,6 +42,9 @@ namespace vt_mode_manager
 //! \brief The total amount of time (in milliseconds) that the display sequence lasts for indicator elements
 const uint32_t INDICATOR_TIME = 3000;
 
+//! \brief The maximum number of damage and healing indicators kept for reuse once expired
+const uint32_t INDICATOR_NUMBER_POOL_SIZE = 32;
+
 /** \brief the indicator types.
 *** According to the indicator type, the draw position computation won't be the same
 **/
@@ -208,6 +212,48 @@ protected:
 
 
 
+/** ****************************************************************************
+*** \brief Displays a damage or healing amount
+***
+*** Unlike IndicatorText, the number isn't rendered into its own texture: It is
+*** drawn every frame from the font glyph atlas, whose glyphs are queued in a
+*** single batch. Number indicators are reused by the indicator supervisor once
+*** expired, so that a busy battle doesn't create any texture or indicator.
+*** ***************************************************************************/
+class IndicatorNumber : public IndicatorElement
+{
+public:
+    IndicatorNumber();
+
+    ~IndicatorNumber()
+    {}
+
+    /** \brief Sets up the indicator to display a new amount, as a newly created one.
+    *** \param x_position, y_position The indicator base position on screen.
+    *** \param amount The amount to display.
+    *** \param style The style to draw the amount with.
+    *** \param indicator_type Either DAMAGE_INDICATOR or HEALING_INDICATOR.
+    **/
+    void Reset(float x_position, float y_position, uint32_t amount,
+               const vt_video::TextStyle& style, INDICATOR_TYPE indicator_type);
+
+    //! \brief Returns the height of the font the amount is drawn with
+    float ElementHeight() const;
+
+    //! \brief Draws the amount from the font glyphs
+    void Draw();
+
+private:
+    //! \brief The amount digits
+    vt_utils::ustring _text;
+
+    //! \brief The style given, and the one drawn with, modulated by the indicator alpha.
+    vt_video::TextStyle _style;
+    vt_video::TextStyle _draw_style;
+}; // class IndicatorNumber : public IndicatorElement
+
+
+
 /** ****************************************************************************
 *** \brief Displays an image indicator
 ***
@@ -418,6 +464,9 @@ private:
     //! \brief A FIFO queue container of all elements that have begun and are going through their display sequence
     std::deque<IndicatorElement *> _active_queue;
 
+    //! \brief The expired number indicators, kept for reuse by the damage and healing indicators.
+    std::vector<IndicatorNumber *> _number_pool;
+
     //! \brief A FIFO container used to display a short message with optional icons.
     std::deque<vt_common::ShortNoticeWindow *> _short_notices;
 
@@ -425,6 +474,13 @@ private:
     //! \param element the Indicator Element which is about to be added.
     //! \return whether there were overlapping elements whose positions were fixed.
     bool _FixPotentialIndicatorOverlapping(IndicatorElement* element);
+
+    //! \brief Gives a number indicator set up with the given values, reusing an expired one when possible.
+    IndicatorNumber* _GetNumberIndicator(float x_position, float y_position, uint32_t amount,
+                                         const vt_video::TextStyle& style, INDICATOR_TYPE indicator_type);
+
+    //! \brief Deletes an expired element, or keeps it for reuse when it is a number indicator.
+    void _ReleaseElement(IndicatorElement* element);
 }; // class IndicatorSupervisor
 
 } // namespace vt_mode_manager
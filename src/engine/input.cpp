@@ -21,12 +21,18 @@
 #include "script/script_read.h"
 #include "engine/mode_manager.h"
 #include "engine/system.h"
+#include "engine/frame_profiler.h"
+#include "engine/memory_stats.h"
 
 #include "modes/mode_help_window.h"
 
 #include "utils/utils_files.h"
 #include "common/app_settings.h"
 
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+
 using namespace vt_utils;
 using namespace vt_video;
 using namespace vt_script;
@@ -51,6 +57,7 @@ InputEngine::InputEngine()
 
     _any_keyboard_key_press = false;
     _any_joystick_key_press = false;
+    _any_event = false;
 
     _last_axis_moved      = -1;
     _up_state             = false;
@@ -103,6 +110,12 @@ InputEngine::InputEngine()
     _hat_down_state = false;
     _hat_left_state = false;
     _hat_right_state = false;
+
+    _event_queue_start = 0;
+    _event_queue_size = 0;
+    _handled_press_timestamp = 0;
+    _drawn_press_timestamp = 0;
+    _latency_sample_count = 0;
 }
 
 InputEngine::~InputEngine()
@@ -222,6 +235,58 @@ bool InputEngine::RestoreDefaultJoyButtons()
     return true;
 }
 
+void InputEngine::PollEvents()
+{
+    SDL_Event event;
+    while(SDL_PollEvent(&event)) {
+        if(_event_queue_size == INPUT_EVENT_QUEUE_SIZE) {
+            // Keep the quit requests, as the game would otherwise not close.
+            if(event.type != SDL_QUIT) {
+                IF_PRINT_WARNING(INPUT_DEBUG) << "The input queue is full, dropping an event of type: "
+                                              << event.type << std::endl;
+                continue;
+            }
+            _event_queue_start = (_event_queue_start + 1) % INPUT_EVENT_QUEUE_SIZE;
+            --_event_queue_size;
+        }
+
+        InputEvent& input_event = _event_queue[(_event_queue_start + _event_queue_size) % INPUT_EVENT_QUEUE_SIZE];
+        input_event.event = event;
+        input_event.timestamp = SDL_GetPerformanceCounter();
+        ++_event_queue_size;
+    }
+}
+
+void InputEngine::FramePresented()
+{
+    if(_drawn_press_timestamp != 0) {
+        _latency_samples[_latency_sample_count % INPUT_LATENCY_SAMPLES] =
+            static_cast<float>(SDL_GetPerformanceCounter() - _drawn_press_timestamp) * 1000.0f /
+            static_cast<float>(SDL_GetPerformanceFrequency());
+        ++_latency_sample_count;
+    }
+
+    // The presses handled this frame are shown by the next one.
+    _drawn_press_timestamp = _handled_press_timestamp;
+    _handled_press_timestamp = 0;
+}
+
+bool InputEngine::GetInputLatency(float &average, float &maximum) const
+{
+    if(_latency_sample_count == 0)
+        return false;
+
+    const uint32_t sample_count = std::min(_latency_sample_count, INPUT_LATENCY_SAMPLES);
+    average = 0.0f;
+    maximum = 0.0f;
+    for(uint32_t i = 0; i < sample_count; ++i) {
+        average += _latency_samples[i];
+        maximum = std::max(maximum, _latency_samples[i]);
+    }
+    average /= static_cast<float>(sample_count);
+    return true;
+}
+
 // Handles all of the event processing for the game.
 void InputEngine::EventHandler()
 {
@@ -233,6 +298,7 @@ void InputEngine::EventHandler()
 
     _any_keyboard_key_press = false;
     _any_joystick_key_press = false;
+    _any_event = false;
 
     _up_press             = false;
     _up_release           = false;
@@ -260,18 +326,52 @@ void InputEngine::EventHandler()
 
     // NOTE: We don't reinit the D-Pad/hat values on purpose here.
 
-    // Loops until there are no remaining events to process
-    while(SDL_PollEvent(&event)) {
-        if(event.type == SDL_QUIT) {
-            _key_event = event;
-            _quit_press = true;
-            break;
-        } else if(event.type == SDL_KEYUP || event.type == SDL_KEYDOWN) {
-            _key_event = event;
-            _KeyEventHandler(event.key);
-        } else {
-            _joystick_event = event;
-            _JoystickEventHandler(event);
+    PollEvents();
+    _frame_inputs.clear();
+
+    Replay& replay = SystemManager->GetReplay();
+    if(replay.IsReplaying()) {
+        // Only the recorded input is replayed, but closing the window still quits.
+        bool quit = false;
+        for(; _event_queue_size > 0; --_event_queue_size) {
+            if(_event_queue[_event_queue_start].event.type == SDL_QUIT)
+                quit = true;
+            _event_queue_start = (_event_queue_start + 1) % INPUT_EVENT_QUEUE_SIZE;
+        }
+
+        std::vector<SDL_Event> events = replay.GetFrameEvents();
+        if(quit) {
+            event.type = SDL_QUIT;
+            events.push_back(event);
+        }
+        for(uint32_t i = 0; i < events.size(); ++i) {
+            _any_event = true;
+            if(!_HandleEvent(events[i]))
+                break;
+        }
+    } else {
+        // Handles the queued events in order, the second event of a same key or button waiting for the next frame.
+        while(_event_queue_size > 0) {
+            const InputEvent& input_event = _event_queue[_event_queue_start];
+            if(_IsInputHandledThisFrame(input_event.event))
+                break;
+
+            event = input_event.event;
+            if((event.type == SDL_KEYDOWN || event.type == SDL_JOYBUTTONDOWN) && _handled_press_timestamp == 0)
+                _handled_press_timestamp = input_event.timestamp;
+            _event_queue_start = (_event_queue_start + 1) % INPUT_EVENT_QUEUE_SIZE;
+            --_event_queue_size;
+
+            // The window events only matter to the video engine, which isn't replayed.
+            // The events are recorded in the frame handling them.
+            if(replay.IsRecording() && (event.type == SDL_QUIT || event.type == SDL_KEYUP ||
+                    event.type == SDL_KEYDOWN ||
+                    (event.type >= SDL_JOYAXISMOTION && event.type <= SDL_JOYDEVICEREMOVED)))
+                replay.RecordEvent(event);
+
+            _any_event = true;
+            if(!_HandleEvent(event))
+                break;
         }
     }
 
@@ -297,6 +397,46 @@ void InputEngine::EventHandler()
 
 
 
+bool InputEngine::_IsInputHandledThisFrame(const SDL_Event &event)
+{
+    // The joystick axes only matter by their last position.
+    std::pair<uint32_t, int32_t> input;
+    if(event.type == SDL_KEYDOWN || event.type == SDL_KEYUP)
+        input = std::make_pair(static_cast<uint32_t>(SDL_KEYDOWN), static_cast<int32_t>(event.key.keysym.sym));
+    else if(event.type == SDL_JOYBUTTONDOWN || event.type == SDL_JOYBUTTONUP)
+        input = std::make_pair(static_cast<uint32_t>(SDL_JOYBUTTONDOWN), static_cast<int32_t>(event.jbutton.button));
+    else if(event.type == SDL_JOYHATMOTION)
+        input = std::make_pair(static_cast<uint32_t>(SDL_JOYHATMOTION), static_cast<int32_t>(event.jhat.hat));
+    else
+        return false;
+
+    if(std::find(_frame_inputs.begin(), _frame_inputs.end(), input) != _frame_inputs.end())
+        return true;
+    _frame_inputs.push_back(input);
+    return false;
+}
+
+bool InputEngine::_HandleEvent(SDL_Event &event)
+{
+    if(event.type == SDL_QUIT) {
+        _key_event = event;
+        _quit_press = true;
+        return false;
+    } else if(event.type == SDL_KEYUP || event.type == SDL_KEYDOWN) {
+        _key_event = event;
+        _KeyEventHandler(event.key);
+    } else if(event.type == SDL_WINDOWEVENT) {
+        if(event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+            VideoManager->OnWindowResized();
+    } else {
+        _joystick_event = event;
+        _JoystickEventHandler(event);
+    }
+    return true;
+}
+
+
+
 // Handles all keyboard events for the game
 void InputEngine::_KeyEventHandler(SDL_KeyboardEvent &key_event)
 {
@@ -337,6 +477,10 @@ void InputEngine::_KeyEventHandler(SDL_KeyboardEvent &key_event)
                 // Display and cycle through the texture sheets
                 TextureManager->DEBUG_NextTexSheet();
                 return;
+            } else if(key_event.keysym.sym == SDLK_e) {
+                // Start or stop exporting the rendering statistics of each frame
+                VideoManager->ToggleRenderStatsExport(GetUserDataPath() + "render_stats.csv");
+                return;
             }
 #endif
 
@@ -402,6 +546,27 @@ void InputEngine::_KeyEventHandler(SDL_KeyboardEvent &key_event)
                 help_window->Hide();
             return;
         }
+#ifdef DEBUG_FEATURES
+        else if(key_event.keysym.sym == SDLK_F2) {
+            // Show the time spent in each part of the frame
+            FrameProfiler::ToggleOverlay();
+            return;
+        } else if(key_event.keysym.sym == SDLK_F3) {
+            // Start or stop recording a trace of the frames
+            FrameProfiler::ToggleTraceRecording(GetUserDataPath() + "frame_trace.json");
+            return;
+        } else if(key_event.keysym.sym == SDLK_F4) {
+            // Show the memory used by each subsystem
+            MemoryStats::ToggleOverlay();
+            return;
+        } else if(key_event.keysym.sym == SDLK_F5) {
+            // Write the memory used by each subsystem and texture sheet
+            const std::string filename = GetUserDataPath() + "memory_report.txt";
+            if(MemoryStats::WriteReport(filename, TextureManager->GetMemoryReport()))
+                IF_PRINT_DEBUG(SYSTEM_DEBUG) << "Wrote the memory report to: " << filename << std::endl;
+            return;
+        }
+#endif
     } else { // Key was released
 
         if(key_event.keysym.sym == _key.up) {
@@ -25,6 +25,8 @@
 #include <SDL2/SDL_joystick.h>
 #include <SDL2/SDL_events.h>
 
+#include <vector>
+
 //! All calls to the input engine are wrapped in this namespace.
 namespace vt_input
 {
@@ -41,6 +43,20 @@ extern bool INPUT_DEBUG;
 namespace private_input
 {
 
+//! \brief The number of events the input queue can hold, far more than a frame ever gets.
+const uint32_t INPUT_EVENT_QUEUE_SIZE = 256;
+
+//! \brief The number of key presses the input latency is measured over.
+const uint32_t INPUT_LATENCY_SAMPLES = 32;
+
+//! \brief An event read from the SDL queue, with the performance counter when it was read.
+class InputEvent
+{
+public:
+    SDL_Event event;
+    uint64_t timestamp;
+};
+
 /** ***************************************************************************
 *** \brief Retains information about the user-defined key settings.
 ***
@@ -124,6 +140,11 @@ public:
 *** - press   :: for when a key/button was previously untouched, but has since been pressed
 *** - release :: for when a key/button was previously held down, but has since been released
 ***
+*** The SDL events are first read into a queue, in their order of arrival. A
+*** frame handles them in that order, but stops at the second event of a same
+*** key or button: A key pressed and released within a frame is then held for
+*** that frame, and released the next one, rather than never seen held.
+***
 *** The names of the primary game input events and their purposes are listed below:
 ***
 *** - up           :: Moves a cursor/sprite upwards
@@ -191,6 +212,9 @@ private:
     //! Any joystick key pressed (registered or not)
     bool _any_joystick_key_press;
 
+    //! Whether any input event was handled by the last EventHandler() call.
+    bool _any_event;
+
     //! Any joystick axis moved
     int8_t _last_axis_moved;
 
@@ -251,6 +275,26 @@ private:
     bool _hat_right_state;
     //@}
 
+    /** \brief The events read from SDL and not handled yet, in their order of arrival.
+    *** A ring buffer of _event_queue_size events, starting at _event_queue_start.
+    **/
+    private_input::InputEvent _event_queue[private_input::INPUT_EVENT_QUEUE_SIZE];
+    uint32_t _event_queue_start;
+    uint32_t _event_queue_size;
+
+    //! \brief The keys, buttons and hats, by event type and code, handled by the current EventHandler() call.
+    std::vector<std::pair<uint32_t, int32_t> > _frame_inputs;
+
+    /** \brief The timestamp of the oldest press handled by the last EventHandler() call,
+    *** and of the one shown by the frame being presented, or 0 if none.
+    **/
+    uint64_t _handled_press_timestamp;
+    uint64_t _drawn_press_timestamp;
+
+    //! \brief The latest input latencies, in milliseconds.
+    float _latency_samples[private_input::INPUT_LATENCY_SAMPLES];
+    uint32_t _latency_sample_count;
+
     /** \brief Most recent SDL joystick event
      **/
     SDL_Event _joystick_event;
@@ -268,6 +312,17 @@ private:
     **/
     void _JoystickEventHandler(SDL_Event &js_event);
 
+    /** \brief Dispatches an input event to the handlers above
+    *** \param event The event to process
+    *** \return False when the event asks to quit, the remaining events of the frame being ignored
+    **/
+    bool _HandleEvent(SDL_Event &event);
+
+    /** \brief Tells whether an event is of a key, button or hat already handled this frame,
+    *** and registers its input otherwise.
+    **/
+    bool _IsInputHandledThisFrame(const SDL_Event &event);
+
     /** \brief Sets a new key over an older one. If the same key is used elsewhere, the older one is removed
     *** \param old_key key to be replaced (_key.up for example)
     *** \param new_key key to replace the old value
@@ -327,6 +382,12 @@ public:
     bool AnyJoystickKeyPress() const
     { return _any_joystick_key_press; }
 
+    /** \brief Checks if any input event, such as a key press or release, was handled this frame
+    *** \return True if any event was handled
+    **/
+    bool AnyEvent() const
+    { return _any_event; }
+
     /** \brief Returns the last joystick axis that has moved
     *** \return True if any joystick axis has moved
     **/
@@ -349,6 +410,28 @@ public:
     **/
     void EventHandler();
 
+    /** \brief Reads the events waiting in the SDL queue into the input queue, timestamping them.
+    ***
+    *** EventHandler() reads them as well. Reading them as soon as the frame wait
+    *** ends only timestamps them more accurately.
+    **/
+    void PollEvents();
+
+    /** \brief Measures the input latency, from the key presses reading to their display.
+    ***
+    *** The presses handled while updating a frame are shown by the next one. The
+    *** latency is measured until its buffers are swapped: The display adds its own.
+    *** \note To be called once the buffers of each frame are swapped.
+    **/
+    void FramePresented();
+
+    /** \brief Gives the input latency of the latest key presses.
+    *** \param average The average latency, in milliseconds.
+    *** \param maximum The maximum latency, in milliseconds.
+    *** \return False if no key press was measured yet.
+    **/
+    bool GetInputLatency(float &average, float &maximum) const;
+
     /** \name   Input state member access functions
     *** \return True if the input event key/button is being held down
     **/
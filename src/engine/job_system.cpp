@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    job_system.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the engine job system.
+*** ***************************************************************************/
+
+#include "engine/job_system.h"
+
+#include "engine/frame_profiler.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+
+using namespace vt_system::private_system;
+
+namespace vt_system
+{
+
+JobSystem *JobManager = nullptr;
+bool JOB_DEBUG = false;
+
+//! \brief The number of chunks given to each thread by ParallelFor(), so that
+//! the threads finishing first can steal the chunks left.
+const uint32_t PARALLEL_FOR_CHUNKS_PER_THREAD = 4;
+
+bool JobHandle::IsDone() const
+{
+    return _counter == nullptr || SDL_AtomicGet(&_counter->pending) == 0;
+}
+
+JobSystem::JobSystem() :
+    _queued_jobs(nullptr),
+    _main_thread_mutex(nullptr),
+    _dependency_mutex(nullptr),
+    _done_mutex(nullptr),
+    _job_done(nullptr),
+    _main_thread_id(0)
+{
+    IF_PRINT_DEBUG(JOB_DEBUG) << "constructor invoked" << std::endl;
+    SDL_AtomicSet(&_next_worker, 0);
+    SDL_AtomicSet(&_quit, 0);
+}
+
+JobSystem::~JobSystem()
+{
+    IF_PRINT_DEBUG(JOB_DEBUG) << "destructor invoked" << std::endl;
+
+    // The workers run every queued job before stopping.
+    SDL_AtomicSet(&_quit, 1);
+    for (uint32_t i = 0; i < _workers.size(); ++i)
+        SDL_SemPost(_queued_jobs);
+    for (uint32_t i = 0; i < _workers.size(); ++i)
+        SDL_WaitThread(_workers[i]->thread, nullptr);
+
+    for (uint32_t i = 0; i < _workers.size(); ++i) {
+        SDL_DestroyMutex(_workers[i]->mutex);
+        delete _workers[i];
+    }
+    _workers.clear();
+
+    // Without workers, the main thread jobs run the jobs they schedule right away.
+    if (_main_thread_mutex != nullptr) {
+        Job job;
+        while (_TakeMainThreadJob(job))
+            _Run(job);
+    }
+
+    if (_job_done != nullptr)
+        SDL_DestroyCond(_job_done);
+    if (_done_mutex != nullptr)
+        SDL_DestroyMutex(_done_mutex);
+    if (_dependency_mutex != nullptr)
+        SDL_DestroyMutex(_dependency_mutex);
+    if (_main_thread_mutex != nullptr)
+        SDL_DestroyMutex(_main_thread_mutex);
+    if (_queued_jobs != nullptr)
+        SDL_DestroySemaphore(_queued_jobs);
+}
+
+bool JobSystem::SingletonInitialize()
+{
+    _main_thread_id = SDL_ThreadID();
+
+    _queued_jobs = SDL_CreateSemaphore(0);
+    _main_thread_mutex = SDL_CreateMutex();
+    _dependency_mutex = SDL_CreateMutex();
+    _done_mutex = SDL_CreateMutex();
+    _job_done = SDL_CreateCond();
+    if (_queued_jobs == nullptr || _main_thread_mutex == nullptr || _dependency_mutex == nullptr ||
+            _done_mutex == nullptr || _job_done == nullptr) {
+        PRINT_ERROR << "Couldn't create the job system synchronization objects: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // The main thread runs jobs as well while waiting for them.
+    // The workers don't look at the worker list before a job is queued,
+    // so it can be filled while they are starting.
+    const int32_t number_of_workers = SDL_GetCPUCount() - 1;
+    for (int32_t i = 0; i < number_of_workers; ++i) {
+        _Worker *worker = new _Worker();
+        worker->system = this;
+        worker->index = _workers.size();
+        worker->mutex = SDL_CreateMutex();
+        if (worker->mutex != nullptr)
+            worker->thread = SDL_CreateThread(_WorkerThread, "JobWorker", worker);
+
+        if (worker->thread == nullptr) {
+            IF_PRINT_WARNING(JOB_DEBUG) << "Couldn't create a job worker thread: " << SDL_GetError() << std::endl;
+            if (worker->mutex != nullptr)
+                SDL_DestroyMutex(worker->mutex);
+            delete worker;
+            break;
+        }
+
+        worker->thread_id = SDL_GetThreadID(worker->thread);
+        _workers.push_back(worker);
+    }
+
+    IF_PRINT_DEBUG(JOB_DEBUG) << "Started " << _workers.size() << " job workers." << std::endl;
+    return true;
+}
+
+JobHandle JobSystem::Schedule(const std::function<void()> &job,
+                              const JobHandle &dependency)
+{
+    return _Schedule(job, false, dependency);
+}
+
+JobHandle JobSystem::ScheduleOnMainThread(const std::function<void()> &job,
+                                          const JobHandle &dependency)
+{
+    return _Schedule(job, true, dependency);
+}
+
+JobHandle JobSystem::ParallelFor(uint32_t count, uint32_t grain,
+                                 const std::function<void(uint32_t, uint32_t)> &job,
+                                 const JobHandle &dependency)
+{
+    if (count == 0)
+        return JobHandle();
+
+    const uint32_t number_of_chunks = (_workers.size() + 1) * PARALLEL_FOR_CHUNKS_PER_THREAD;
+    const uint32_t chunk_size = std::max(std::max(grain, static_cast<uint32_t>(1)),
+                                         (count + number_of_chunks - 1) / number_of_chunks);
+
+    // The whole range is counted before any chunk can be done.
+    std::shared_ptr<JobCounter> counter = std::make_shared<JobCounter>();
+    SDL_AtomicSet(&counter->pending, (count + chunk_size - 1) / chunk_size);
+
+    for (uint32_t begin = 0; begin < count; begin += chunk_size) {
+        const uint32_t end = std::min(count, begin + chunk_size);
+        Job chunk;
+        chunk.function = [job, begin, end]() { job(begin, end); };
+        chunk.counter = counter;
+        _Enqueue(chunk, dependency);
+    }
+
+    return JobHandle(counter);
+}
+
+void JobSystem::Wait(const JobHandle &handle)
+{
+    const bool main_thread = IsMainThread();
+    const int32_t worker = _GetCurrentWorker();
+
+    while (!handle.IsDone()) {
+        Job job;
+        if ((main_thread && _TakeMainThreadJob(job)) || _TakeJob(worker, job)) {
+            _Run(job);
+            continue;
+        }
+
+        // The remaining jobs are being run by other threads.
+        // The timeout catches the jobs queued in the meantime.
+        SDL_LockMutex(_done_mutex);
+        if (!handle.IsDone())
+            SDL_CondWaitTimeout(_job_done, _done_mutex, 1);
+        SDL_UnlockMutex(_done_mutex);
+    }
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+    // Only the jobs already queued are run, so that a job scheduling
+    // itself again can't hang the frame.
+    SDL_LockMutex(_main_thread_mutex);
+    size_t number_of_jobs = _main_thread_jobs.size();
+    SDL_UnlockMutex(_main_thread_mutex);
+
+    Job job;
+    while (number_of_jobs > 0 && _TakeMainThreadJob(job)) {
+        _Run(job);
+        --number_of_jobs;
+    }
+}
+
+JobHandle JobSystem::_Schedule(const std::function<void()> &job, bool main_thread,
+                               const JobHandle &dependency)
+{
+    std::shared_ptr<JobCounter> counter = std::make_shared<JobCounter>();
+    SDL_AtomicSet(&counter->pending, 1);
+
+    Job new_job;
+    new_job.function = job;
+    new_job.counter = counter;
+    new_job.main_thread = main_thread;
+    _Enqueue(new_job, dependency);
+
+    return JobHandle(counter);
+}
+
+void JobSystem::_Enqueue(const Job &job, const JobHandle &dependency)
+{
+    if (!dependency.IsDone()) {
+        // The last job of the dependency takes the lock once its counter reaches zero,
+        // so either it finds this job, or this job sees the dependency done.
+        SDL_LockMutex(_dependency_mutex);
+        if (!dependency.IsDone()) {
+            dependency._counter->dependents.push_back(job);
+            SDL_UnlockMutex(_dependency_mutex);
+            return;
+        }
+        SDL_UnlockMutex(_dependency_mutex);
+    }
+
+    _Push(job);
+}
+
+void JobSystem::_Push(const Job &job)
+{
+    if (job.main_thread) {
+        SDL_LockMutex(_main_thread_mutex);
+        _main_thread_jobs.push_back(job);
+        SDL_UnlockMutex(_main_thread_mutex);
+        return;
+    }
+
+    if (_workers.empty()) {
+        _Run(job);
+        return;
+    }
+
+    // The workers keep the jobs they schedule, the others are spread over them.
+    int32_t worker = _GetCurrentWorker();
+    if (worker < 0)
+        worker = static_cast<uint32_t>(SDL_AtomicAdd(&_next_worker, 1)) % _workers.size();
+
+    SDL_LockMutex(_workers[worker]->mutex);
+    _workers[worker]->jobs.push_back(job);
+    SDL_UnlockMutex(_workers[worker]->mutex);
+
+    SDL_SemPost(_queued_jobs);
+}
+
+bool JobSystem::_TakeJob(int32_t worker, Job &job)
+{
+    if (_workers.empty())
+        return false;
+
+    // The newest job of its own queue is likely still in the worker cache.
+    if (worker >= 0) {
+        _Worker *own_worker = _workers[worker];
+        SDL_LockMutex(own_worker->mutex);
+        if (!own_worker->jobs.empty()) {
+            job = own_worker->jobs.back();
+            own_worker->jobs.pop_back();
+            SDL_UnlockMutex(own_worker->mutex);
+            return true;
+        }
+        SDL_UnlockMutex(own_worker->mutex);
+    }
+
+    // Steal the oldest job of another worker, starting from the next one
+    // so that the thieves don't all empty the same queue.
+    const uint32_t first = (worker >= 0) ? worker + 1 : 0;
+    for (uint32_t i = 0; i < _workers.size(); ++i) {
+        _Worker *victim = _workers[(first + i) % _workers.size()];
+        if (victim->index == worker)
+            continue;
+
+        SDL_LockMutex(victim->mutex);
+        if (!victim->jobs.empty()) {
+            job = victim->jobs.front();
+            victim->jobs.pop_front();
+            SDL_UnlockMutex(victim->mutex);
+            return true;
+        }
+        SDL_UnlockMutex(victim->mutex);
+    }
+
+    return false;
+}
+
+bool JobSystem::_TakeMainThreadJob(Job &job)
+{
+    SDL_LockMutex(_main_thread_mutex);
+    const bool found = !_main_thread_jobs.empty();
+    if (found) {
+        job = _main_thread_jobs.front();
+        _main_thread_jobs.pop_front();
+    }
+    SDL_UnlockMutex(_main_thread_mutex);
+    return found;
+}
+
+void JobSystem::_Run(const Job &job)
+{
+    {
+        PROFILE_SCOPE("Job");
+        job.function();
+    }
+
+    // SDL_AtomicAdd() returns the previous value.
+    if (SDL_AtomicAdd(&job.counter->pending, -1) != 1)
+        return;
+
+    std::vector<Job> dependents;
+    SDL_LockMutex(_dependency_mutex);
+    dependents.swap(job.counter->dependents);
+    SDL_UnlockMutex(_dependency_mutex);
+
+    for (uint32_t i = 0; i < dependents.size(); ++i)
+        _Push(dependents[i]);
+
+    SDL_LockMutex(_done_mutex);
+    SDL_CondBroadcast(_job_done);
+    SDL_UnlockMutex(_done_mutex);
+}
+
+int32_t JobSystem::_GetCurrentWorker() const
+{
+    const SDL_threadID thread_id = SDL_ThreadID();
+    for (uint32_t i = 0; i < _workers.size(); ++i) {
+        if (_workers[i]->thread_id == thread_id)
+            return i;
+    }
+    return -1;
+}
+
+int JobSystem::_WorkerThread(void *worker)
+{
+    _Worker *job_worker = static_cast<_Worker *>(worker);
+    job_worker->system->_Work(job_worker->index);
+    return 0;
+}
+
+void JobSystem::_Work(int32_t worker)
+{
+    while (true) {
+        SDL_SemWait(_queued_jobs);
+
+        // The jobs taken by other threads leave extra wake ups, which find nothing.
+        Job job;
+        while (_TakeJob(worker, job))
+            _Run(job);
+
+        if (SDL_AtomicGet(&_quit) != 0)
+            break;
+    }
+}
+
+} // namespace vt_system
@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    job_system.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the engine job system.
+***
+*** The job system runs small independent tasks on a worker thread per core.
+*** Each worker has its own queue, taking its newest jobs first, and steals the
+*** oldest jobs of the other workers once its queue is empty.
+***
+*** The jobs touching the OpenGL context or the Lua state must be scheduled on
+*** the main thread, which runs them once per frame or while waiting for a job.
+*** ***************************************************************************/
+
+#ifndef __JOB_SYSTEM_HEADER__
+#define __JOB_SYSTEM_HEADER__
+
+#include "utils/singleton.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_thread.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//! All calls to the job system are wrapped in this namespace.
+namespace vt_system
+{
+
+class JobSystem;
+
+//! \brief The singleton pointer responsible for running the jobs.
+extern JobSystem *JobManager;
+
+//! \brief Determines whether the job system should print debug statements or not.
+extern bool JOB_DEBUG;
+
+namespace private_system
+{
+
+class JobCounter;
+
+//! \brief A job to run, and the counter of its handle.
+class Job
+{
+public:
+    Job() :
+        main_thread(false)
+    {}
+
+    std::function<void()> function;
+    std::shared_ptr<JobCounter> counter;
+
+    //! \brief Whether the job must run on the main thread.
+    bool main_thread;
+};
+
+//! \brief Counts the jobs of a handle not done yet, and holds the jobs depending on them.
+class JobCounter
+{
+public:
+    JobCounter()
+    {
+        SDL_AtomicSet(&pending, 0);
+    }
+
+    SDL_atomic_t pending;
+
+    //! \brief The jobs queued once the counter reaches zero. Protected by the job system.
+    std::vector<Job> dependents;
+};
+
+} // namespace private_system
+
+/** ****************************************************************************
+*** \brief Refers to a set of scheduled jobs, to wait for them or to depend on them.
+***
+*** A default constructed handle refers to no job and is always done.
+*** ***************************************************************************/
+class JobHandle
+{
+    friend class JobSystem;
+
+public:
+    JobHandle()
+    {}
+
+    //! \brief Whether all the jobs of the handle are done.
+    bool IsDone() const;
+
+private:
+    explicit JobHandle(const std::shared_ptr<private_system::JobCounter> &counter) :
+        _counter(counter)
+    {}
+
+    //! \brief The number of jobs of the handle not done yet, and their dependent jobs.
+    std::shared_ptr<private_system::JobCounter> _counter;
+};
+
+/** ****************************************************************************
+*** \brief Runs jobs on a pool of worker threads and on the main thread.
+***
+*** The jobs are run in any order, unless they depend on each other. A job only
+*** starts once all the jobs of its dependency handle are done.
+***
+*** \note Without workers, on a single core, the jobs are run right away by the
+*** thread scheduling them.
+***
+*** \note This class is a singleton.
+*** ***************************************************************************/
+class JobSystem : public vt_utils::Singleton<JobSystem>
+{
+    friend class vt_utils::Singleton<JobSystem>;
+
+public:
+    //! \brief Runs the pending jobs before stopping the workers.
+    ~JobSystem();
+
+    //! \brief Starts the workers. Must be called by the main thread.
+    bool SingletonInitialize();
+
+    /** \brief Schedules a job on a worker thread.
+    *** \param job The function to run. It mustn't use the OpenGL context or the Lua state.
+    *** \param dependency The jobs to run before this one.
+    *** \return The handle of the job.
+    **/
+    JobHandle Schedule(const std::function<void()> &job,
+                       const JobHandle &dependency = JobHandle());
+
+    /** \brief Schedules a job on the main thread, run by RunMainThreadJobs() or Wait().
+    *** \param job The function to run. It can use the OpenGL context and the Lua state.
+    *** \param dependency The jobs to run before this one.
+    *** \return The handle of the job.
+    **/
+    JobHandle ScheduleOnMainThread(const std::function<void()> &job,
+                                   const JobHandle &dependency = JobHandle());
+
+    /** \brief Splits a range in chunks processed by worker jobs.
+    *** \param count The size of the range, from 0 to count - 1.
+    *** \param grain The minimum size of the chunks, to keep jobs big enough.
+    *** \param job The function processing a chunk, given its begin and its end (excluded).
+    *** \param dependency The jobs to run before the chunks.
+    *** \return The handle of all the chunk jobs.
+    **/
+    JobHandle ParallelFor(uint32_t count, uint32_t grain,
+                          const std::function<void(uint32_t, uint32_t)> &job,
+                          const JobHandle &dependency = JobHandle());
+
+    /** \brief Returns once the jobs of the handle are done.
+    *** The waiting thread runs the queued jobs in the meantime, including the
+    *** main thread ones when waiting from the main thread.
+    **/
+    void Wait(const JobHandle &handle);
+
+    //! \brief Runs the jobs scheduled on the main thread. Called once per frame by the main loop.
+    void RunMainThreadJobs();
+
+    //! \brief The number of worker threads, 0 on a single core.
+    uint32_t GetWorkerCount() const {
+        return _workers.size();
+    }
+
+    //! \brief Whether the calling thread is the main one.
+    bool IsMainThread() const {
+        return SDL_ThreadID() == _main_thread_id;
+    }
+
+private:
+    JobSystem();
+
+    //! \brief A worker thread and its queue.
+    class _Worker
+    {
+    public:
+        _Worker() :
+            system(nullptr),
+            index(0),
+            thread(nullptr),
+            thread_id(0),
+            mutex(nullptr)
+        {}
+
+        JobSystem *system;
+        int32_t index;
+        SDL_Thread *thread;
+        SDL_threadID thread_id;
+
+        //! \brief The jobs queued on the worker, the newest ones at the back.
+        std::deque<private_system::Job> jobs;
+
+        //! \brief Protects the jobs.
+        SDL_mutex *mutex;
+    };
+
+    //! \brief The workers.
+    std::vector<_Worker *> _workers;
+
+    //! \brief The worker receiving the next job scheduled from another thread.
+    SDL_atomic_t _next_worker;
+
+    //! \brief Counts the jobs queued on the workers, waking them up.
+    SDL_semaphore *_queued_jobs;
+
+    //! \brief The jobs scheduled on the main thread, oldest first, and their lock.
+    std::deque<private_system::Job> _main_thread_jobs;
+    SDL_mutex *_main_thread_mutex;
+
+    //! \brief Protects the dependent jobs of every counter.
+    SDL_mutex *_dependency_mutex;
+
+    //! \brief Signaled when the last job of a handle is done.
+    SDL_mutex *_done_mutex;
+    SDL_cond *_job_done;
+
+    SDL_threadID _main_thread_id;
+
+    //! \brief Tells the workers to stop once their queues are empty.
+    SDL_atomic_t _quit;
+
+    //! \brief Schedules a job once its dependency is done.
+    JobHandle _Schedule(const std::function<void()> &job, bool main_thread,
+                        const JobHandle &dependency);
+
+    //! \brief Adds a job to the dependent jobs of the handle, or queues it when the handle is done.
+    void _Enqueue(const private_system::Job &job, const JobHandle &dependency);
+
+    //! \brief Queues a job whose dependency is done.
+    void _Push(const private_system::Job &job);
+
+    //! \brief Takes a job from the given worker queue, or steals one from another worker.
+    //! \param worker The worker taking the job, or -1 for a thread which isn't a worker.
+    bool _TakeJob(int32_t worker, private_system::Job &job);
+
+    //! \brief Takes the oldest main thread job.
+    bool _TakeMainThreadJob(private_system::Job &job);
+
+    //! \brief Runs a job, and queues its dependent jobs once its handle is done.
+    void _Run(const private_system::Job &job);
+
+    //! \brief Returns the index of the calling worker thread, or -1.
+    int32_t _GetCurrentWorker() const;
+
+    //! \brief The entry point of the worker threads.
+    static int _WorkerThread(void *worker);
+
+    //! \brief Runs the queued jobs until told to stop.
+    void _Work(int32_t worker);
+};
+
+} // namespace vt_system
+
+#endif // __JOB_SYSTEM_HEADER__
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    load_trace.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for timing the stages of the game modes loadings.
+*** ***************************************************************************/
+
+#include "engine/load_trace.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include <cstdio>
+
+namespace vt_system
+{
+
+bool LoadTrace::_enabled = false;
+
+LoadTrace::LoadTrace(const std::string& name) :
+    _stage_start(0)
+{
+    if(!_enabled)
+        return;
+
+    _name = name;
+    _stage_start = SDL_GetPerformanceCounter();
+}
+
+LoadTrace::~LoadTrace()
+{
+    if(!_enabled || _stages.empty())
+        return;
+
+    printf("\n===== %s\n", _name.c_str());
+    double total = 0.0;
+    for(uint32_t i = 0; i < _stages.size(); ++i) {
+        printf("  %-32s %8.1f ms\n", _stages[i].first, _stages[i].second);
+        total += _stages[i].second;
+    }
+    printf("  %-32s %8.1f ms\n", "Total", total);
+}
+
+void LoadTrace::EndStage(const char* stage_name)
+{
+    if(!_enabled)
+        return;
+
+    const uint64_t now = SDL_GetPerformanceCounter();
+    const double duration = static_cast<double>(now - _stage_start) * 1000.0 /
+                            static_cast<double>(SDL_GetPerformanceFrequency());
+    _stages.push_back(std::make_pair(stage_name, duration));
+    _stage_start = now;
+}
+
+} // namespace vt_system
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    load_trace.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for timing the stages of the game modes loadings.
+***
+*** The loadings are timed like the startup stages, and printed along with them
+*** when the game is started with --startup-trace.
+*** ***************************************************************************/
+
+#ifndef __LOAD_TRACE_HEADER__
+#define __LOAD_TRACE_HEADER__
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vt_system
+{
+
+/** ****************************************************************************
+*** \brief Times consecutive stages of a loading, and prints them once done.
+***
+*** Nothing is timed nor printed unless the trace is enabled.
+*** ***************************************************************************/
+class LoadTrace
+{
+public:
+    //! \param name What is loaded, printed as the trace title.
+    explicit LoadTrace(const std::string& name);
+
+    //! \brief Prints the stages ended, when enabled.
+    ~LoadTrace();
+
+    /** \brief Ends the current stage, the next one starting right away.
+    *** \param stage_name The stage name. Must be a string literal.
+    **/
+    void EndStage(const char* stage_name);
+
+    static void SetEnabled(bool enabled) {
+        _enabled = enabled;
+    }
+
+    static bool IsEnabled() {
+        return _enabled;
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    LoadTrace(const LoadTrace& trace);
+    LoadTrace& operator=(const LoadTrace& trace);
+
+    std::string _name;
+
+    //! \brief The performance counter at the start of the current stage.
+    uint64_t _stage_start;
+
+    //! \brief The stages ended, and their duration in milliseconds.
+    std::vector<std::pair<const char*, double> > _stages;
+
+    static bool _enabled;
+};
+
+} // namespace vt_system
+
+#endif // __LOAD_TRACE_HEADER__
@@ -0,0 +1,313 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    log_backend.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for writing the warnings and errors in the background.
+*** ***************************************************************************/
+
+#include "engine/log_backend.h"
+
+#include <SDL2/SDL.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vt_system
+{
+
+namespace
+{
+
+//! \brief The call sites a thread keeps the rate limit of, forgotten all at once beyond.
+const uint32_t MAX_LOG_SITES = 1024;
+
+//! \brief The longest call site key, for the lines without the usual prefix.
+const uint32_t MAX_LOG_SITE_KEY = 128;
+
+//! \brief A line queued by a thread.
+class LogLine
+{
+public:
+    char text[LOG_LINE_SIZE];
+    uint32_t length;
+};
+
+//! \brief The lines written by a call site during the current second.
+class LogSite
+{
+public:
+    LogSite() :
+        second(0),
+        lines(0),
+        suppressed(0)
+    {}
+
+    uint32_t second;
+    uint32_t lines;
+    uint32_t suppressed;
+};
+
+//! \brief The lines of a thread, queued by that thread only.
+class ThreadLog
+{
+public:
+    ThreadLog() :
+        lines(LOG_RING_SIZE)
+    {
+        SDL_AtomicSet(&written, 0);
+        SDL_AtomicSet(&read, 0);
+    }
+
+    //! \brief The line being assembled.
+    std::string line;
+
+    //! \brief The rate limit of the call sites, by key.
+    std::unordered_map<std::string, LogSite> sites;
+
+    //! \brief The ring buffer of the queued lines.
+    std::vector<LogLine> lines;
+
+    //! \brief The number of lines queued, and written by the writer thread, wrapping around.
+    SDL_atomic_t written;
+    SDL_atomic_t read;
+};
+
+//! \brief Tells the threads where their lines are.
+SDL_TLSID thread_log_id = 0;
+
+//! \brief The lines of every thread which logged one, and their lock, also serializing the writes.
+std::vector<ThreadLog*> thread_logs;
+SDL_mutex* thread_logs_mutex = nullptr;
+
+SDL_Thread* writer_thread = nullptr;
+SDL_atomic_t writer_running;
+
+SDL_atomic_t written_lines;
+SDL_atomic_t suppressed_lines;
+SDL_atomic_t dropped_lines;
+
+//! \brief The std::cerr buffer replaced, where the lines are written.
+std::streambuf* console_buffer = nullptr;
+
+//! \brief Writes the lines queued by every thread.
+void FlushLines()
+{
+    SDL_LockMutex(thread_logs_mutex);
+    if (console_buffer == nullptr) {
+        SDL_UnlockMutex(thread_logs_mutex);
+        return;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < thread_logs.size(); ++i) {
+        ThreadLog& thread = *thread_logs[i];
+        const uint32_t written = static_cast<uint32_t>(SDL_AtomicGet(&thread.written));
+        uint32_t read = static_cast<uint32_t>(SDL_AtomicGet(&thread.read));
+        for (; read != written; ++read) {
+            const LogLine& line = thread.lines[read % LOG_RING_SIZE];
+            console_buffer->sputn(line.text, line.length);
+            console_buffer->sputc('\n');
+            ++count;
+        }
+        // SDL_AtomicSet() is a full barrier, so the slots are only reused once written.
+        SDL_AtomicSet(&thread.read, static_cast<int>(read));
+    }
+
+    if (count > 0) {
+        console_buffer->pubsync();
+        SDL_AtomicAdd(&written_lines, static_cast<int>(count));
+    }
+
+    SDL_UnlockMutex(thread_logs_mutex);
+}
+
+int WriterThread(void* /*data*/)
+{
+    while (SDL_AtomicGet(&writer_running) != 0) {
+        FlushLines();
+        SDL_Delay(LOG_FLUSH_INTERVAL);
+    }
+    return 0;
+}
+
+ThreadLog* GetThreadLog()
+{
+    ThreadLog* thread = static_cast<ThreadLog*>(SDL_TLSGet(thread_log_id));
+    if (thread == nullptr) {
+        // The lines are kept until the game exits, as the writer thread may still read them.
+        thread = new ThreadLog();
+
+        SDL_LockMutex(thread_logs_mutex);
+        thread_logs.push_back(thread);
+        SDL_UnlockMutex(thread_logs_mutex);
+
+        SDL_TLSSet(thread_log_id, thread, nullptr);
+    }
+    return thread;
+}
+
+//! \brief Queues a line, or drops it when the thread ring is full.
+void QueueLine(ThreadLog& thread, const std::string& text)
+{
+    const uint32_t written = static_cast<uint32_t>(SDL_AtomicGet(&thread.written));
+    const uint32_t read = static_cast<uint32_t>(SDL_AtomicGet(&thread.read));
+    if (written - read >= LOG_RING_SIZE) {
+        SDL_AtomicAdd(&dropped_lines, 1);
+        return;
+    }
+
+    LogLine& line = thread.lines[written % LOG_RING_SIZE];
+    line.length = std::min(static_cast<uint32_t>(text.length()), LOG_LINE_SIZE);
+    std::memcpy(line.text, text.data(), line.length);
+    // SDL_AtomicAdd() is a full barrier, so the writer thread never reads the line half copied.
+    SDL_AtomicAdd(&thread.written, 1);
+}
+
+//! \brief Returns the "WARNING: file:function:line:" prefix of a line, telling its call site.
+std::string GetSiteKey(const std::string& line)
+{
+    // The level is followed by ": ", and the location by another one.
+    size_t end = line.find(": ");
+    if (end != std::string::npos)
+        end = line.find(": ", end + 2);
+    return line.substr(0, std::min(end, static_cast<size_t>(MAX_LOG_SITE_KEY)));
+}
+
+//! \brief Queues the line assembled, unless its call site wrote too many lines this second.
+void SubmitLine(ThreadLog& thread)
+{
+    const std::string key = GetSiteKey(thread.line);
+    const uint32_t second = SDL_GetTicks() / 1000;
+
+    if (thread.sites.size() >= MAX_LOG_SITES && thread.sites.find(key) == thread.sites.end())
+        thread.sites.clear();
+    LogSite& site = thread.sites[key];
+
+    if (site.second != second) {
+        if (site.suppressed > 0) {
+            std::ostringstream summary;
+            summary << key << ": " << site.suppressed << " similar lines suppressed";
+            QueueLine(thread, summary.str());
+        }
+        site.second = second;
+        site.lines = 0;
+        site.suppressed = 0;
+    }
+
+    if (site.lines >= LOG_SITE_LINES_PER_SECOND) {
+        ++site.suppressed;
+        SDL_AtomicAdd(&suppressed_lines, 1);
+    }
+    else {
+        ++site.lines;
+        QueueLine(thread, thread.line);
+
+        // The errors often come right before giving up, so they're written at once.
+        if (thread.line.compare(0, 5, "ERROR") == 0)
+            FlushLines();
+    }
+
+    thread.line.clear();
+}
+
+void AppendText(const char* text, std::streamsize length)
+{
+    ThreadLog& thread = *GetThreadLog();
+    for (std::streamsize i = 0; i < length; ++i) {
+        if (text[i] == '\n')
+            SubmitLine(thread);
+        else
+            thread.line += text[i];
+    }
+}
+
+//! \brief The buffer replacing the std::cerr one, handing the text to the thread logging it.
+class LogStreamBuffer : public std::streambuf
+{
+protected:
+    int_type overflow(int_type character) override
+    {
+        if (!traits_type::eq_int_type(character, traits_type::eof())) {
+            const char c = traits_type::to_char_type(character);
+            AppendText(&c, 1);
+        }
+        return traits_type::not_eof(character);
+    }
+
+    std::streamsize xsputn(const char* text, std::streamsize length) override
+    {
+        AppendText(text, length);
+        return length;
+    }
+};
+
+LogStreamBuffer log_buffer;
+
+} // namespace
+
+void LogBackend::Start()
+{
+    if (console_buffer != nullptr)
+        return;
+
+    if (thread_logs_mutex == nullptr) {
+        thread_logs_mutex = SDL_CreateMutex();
+        thread_log_id = SDL_TLSCreate();
+    }
+
+    SDL_AtomicSet(&writer_running, 1);
+    writer_thread = SDL_CreateThread(WriterThread, "LogWriter", nullptr);
+    // Without the writer thread, std::cerr is left as it is.
+    if (writer_thread == nullptr)
+        return;
+
+    console_buffer = std::cerr.rdbuf(&log_buffer);
+}
+
+void LogBackend::Stop()
+{
+    if (console_buffer == nullptr)
+        return;
+
+    std::cerr.rdbuf(console_buffer);
+
+    SDL_AtomicSet(&writer_running, 0);
+    SDL_WaitThread(writer_thread, nullptr);
+    writer_thread = nullptr;
+
+    FlushLines();
+    SDL_LockMutex(thread_logs_mutex);
+    console_buffer = nullptr;
+    SDL_UnlockMutex(thread_logs_mutex);
+}
+
+uint32_t LogBackend::GetWrittenLines()
+{
+    return static_cast<uint32_t>(SDL_AtomicGet(&written_lines));
+}
+
+uint32_t LogBackend::GetSuppressedLines()
+{
+    return static_cast<uint32_t>(SDL_AtomicGet(&suppressed_lines));
+}
+
+uint32_t LogBackend::GetDroppedLines()
+{
+    return static_cast<uint32_t>(SDL_AtomicGet(&dropped_lines));
+}
+
+} // namespace vt_system
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    log_backend.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for writing the warnings and errors in the background.
+***
+*** PRINT_WARNING, PRINT_ERROR and IF_PRINT_WARNING() write to std::cerr. Once
+*** started, the backend takes over the std::cerr stream buffer: Each thread
+*** assembles its lines and queues them in its own ring, emptied by a writer
+*** thread, so that logging never waits for the console.
+***
+*** The lines of a same call site, told by their "WARNING: file:function:line:"
+*** prefix, are rate limited, so that a misbehaving script flooding a warning
+*** every frame doesn't flood the console. The lines skipped are counted, and
+*** the counters are shown in the profiler overlay.
+***
+*** The error lines are written right away, along with the lines queued before
+*** them, so that they aren't lost if the game crashes right after.
+*** ***************************************************************************/
+
+#ifndef __LOG_BACKEND_HEADER__
+#define __LOG_BACKEND_HEADER__
+
+#include <cstdint>
+
+namespace vt_system
+{
+
+//! \brief The lines a thread can have waiting to be written. The next ones are dropped.
+const uint32_t LOG_RING_SIZE = 64;
+
+//! \brief The longest line written, the longer ones being truncated.
+const uint32_t LOG_LINE_SIZE = 512;
+
+//! \brief The lines a call site can write each second. The next ones are only counted.
+const uint32_t LOG_SITE_LINES_PER_SECOND = 10;
+
+//! \brief How often the writer thread writes the queued lines, in milliseconds.
+const uint32_t LOG_FLUSH_INTERVAL = 50;
+
+/** ****************************************************************************
+*** \brief Writes the lines sent to std::cerr from a background thread.
+***
+*** \note The lines may be logged from any thread.
+*** ***************************************************************************/
+class LogBackend
+{
+public:
+    //! \brief Redirects std::cerr to the backend, and starts the writer thread.
+    static void Start();
+
+    //! \brief Writes the queued lines, stops the writer thread and restores std::cerr.
+    static void Stop();
+
+    //! \brief Returns the lines written since the start.
+    static uint32_t GetWrittenLines();
+
+    //! \brief Returns the lines skipped by the call sites rate limit.
+    static uint32_t GetSuppressedLines();
+
+    //! \brief Returns the lines dropped because their thread ring was full.
+    static uint32_t GetDroppedLines();
+};
+
+} // namespace vt_system
+
+#endif // __LOG_BACKEND_HEADER__
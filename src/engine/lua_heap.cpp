@@ -0,0 +1,276 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    lua_heap.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the Lua state allocator and garbage collection pacing.
+*** ***************************************************************************/
+
+#include "engine/lua_heap.h"
+
+#include "engine/frame_profiler.h"
+
+#include <luabind/lua_include.hpp>
+
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace vt_system
+{
+
+float LuaHeap::_last_step_time = 0.0f;
+
+namespace
+{
+
+//! \brief The block sizes of the pools, in bytes. Multiples of 16, to keep the blocks aligned.
+const uint32_t LUA_POOL_BLOCK_SIZES[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+const uint32_t LUA_POOL_COUNT = sizeof(LUA_POOL_BLOCK_SIZES) / sizeof(LUA_POOL_BLOCK_SIZES[0]);
+const uint32_t LUA_POOL_MAX_BLOCK_SIZE = 256;
+
+//! \brief The size of the slabs the blocks of a pool are carved from, in bytes.
+const size_t LUA_POOL_SLAB_SIZE = 64 * 1024;
+
+//! \brief A slab, whose blocks all belong to one pool.
+class LuaSlab
+{
+public:
+    char* start;
+    uint32_t pool;
+
+    bool operator<(const LuaSlab& slab) const {
+        return start < slab.start;
+    }
+};
+
+//! \brief A pool of blocks of a single size.
+class LuaPool
+{
+public:
+    LuaPool() :
+        free_blocks(nullptr),
+        next_block(nullptr),
+        slab_end(nullptr)
+    {}
+
+    //! \brief The freed blocks, each holding the address of the next one.
+    void* free_blocks;
+
+    //! \brief The blocks of the last slab never handed out yet.
+    char* next_block;
+    char* slab_end;
+};
+
+//! \brief The original allocation function of the state.
+lua_Alloc _system_alloc = nullptr;
+void* _system_alloc_data = nullptr;
+
+lua_State* _state = nullptr;
+
+LuaPool _pools[LUA_POOL_COUNT];
+
+//! \brief The slabs, sorted by address, to find the pool a block belongs to.
+std::vector<LuaSlab> _slabs;
+
+//! \brief The pool of each block size, by 16 bytes step.
+uint8_t _pool_by_size[LUA_POOL_MAX_BLOCK_SIZE / 16 + 1];
+
+//! \brief Whether a garbage collection cycle is being stepped through.
+bool _collecting = false;
+
+//! \brief The heap size starting the next garbage collection cycle, in kilobytes.
+int32_t _next_cycle_heap = LUA_GC_MIN_HEAP;
+
+//! \brief Returns the pool of a block size, or -1 when too large for the pools.
+int32_t _GetPool(size_t size)
+{
+    if(size > LUA_POOL_MAX_BLOCK_SIZE)
+        return -1;
+    return _pool_by_size[(size + 15) / 16];
+}
+
+//! \brief Returns the pool a block was handed out from, or -1 when allocated by the original allocator.
+int32_t _FindBlockPool(void* block)
+{
+    LuaSlab key;
+    key.start = static_cast<char*>(block);
+    std::vector<LuaSlab>::const_iterator it = std::upper_bound(_slabs.begin(), _slabs.end(), key);
+    if(it == _slabs.begin())
+        return -1;
+    --it;
+    if(static_cast<char*>(block) >= it->start + LUA_POOL_SLAB_SIZE)
+        return -1;
+    return static_cast<int32_t>(it->pool);
+}
+
+void* _AllocateBlock(size_t size)
+{
+    const int32_t pool_id = _GetPool(size);
+    if(pool_id < 0)
+        return _system_alloc(_system_alloc_data, nullptr, 0, size);
+
+    LuaPool& pool = _pools[pool_id];
+    if(pool.free_blocks != nullptr) {
+        void* block = pool.free_blocks;
+        std::memcpy(&pool.free_blocks, block, sizeof(void*));
+        return block;
+    }
+
+    const uint32_t block_size = LUA_POOL_BLOCK_SIZES[pool_id];
+    if(pool.next_block == nullptr || pool.next_block + block_size > pool.slab_end) {
+        char* slab_start = static_cast<char*>(_system_alloc(_system_alloc_data, nullptr, 0, LUA_POOL_SLAB_SIZE));
+        if(slab_start == nullptr)
+            return nullptr;
+
+        LuaSlab slab;
+        slab.start = slab_start;
+        slab.pool = static_cast<uint32_t>(pool_id);
+        _slabs.insert(std::upper_bound(_slabs.begin(), _slabs.end(), slab), slab);
+
+        pool.next_block = slab_start;
+        pool.slab_end = slab_start + LUA_POOL_SLAB_SIZE;
+    }
+
+    void* block = pool.next_block;
+    pool.next_block += block_size;
+    return block;
+}
+
+void _FreeBlock(void* block, size_t size)
+{
+    const int32_t pool_id = _FindBlockPool(block);
+    if(pool_id < 0) {
+        _system_alloc(_system_alloc_data, block, size, 0);
+        return;
+    }
+
+    LuaPool& pool = _pools[pool_id];
+    std::memcpy(block, &pool.free_blocks, sizeof(void*));
+    pool.free_blocks = block;
+}
+
+//! \brief The allocation function given to the state, following the lua_Alloc contract.
+void* _LuaPoolAlloc(void*, void* block, size_t old_size, size_t new_size)
+{
+    if(new_size == 0) {
+        if(block != nullptr)
+            _FreeBlock(block, old_size);
+        return nullptr;
+    }
+
+    if(block == nullptr)
+        return _AllocateBlock(new_size);
+
+    // The block is kept when it's still of the right size.
+    const int32_t pool_id = _FindBlockPool(block);
+    const int32_t new_pool_id = _GetPool(new_size);
+    if(pool_id >= 0 && pool_id == new_pool_id)
+        return block;
+    if(pool_id < 0 && new_pool_id < 0)
+        return _system_alloc(_system_alloc_data, block, old_size, new_size);
+
+    // On failure, the original block must be left untouched.
+    void* new_block = _AllocateBlock(new_size);
+    if(new_block == nullptr)
+        return nullptr;
+    std::memcpy(new_block, block, std::min(old_size, new_size));
+    _FreeBlock(block, old_size);
+    return new_block;
+}
+
+//! \brief Starts the next cycle once the heap has grown enough since the end of the last one.
+void _EndCycle()
+{
+    _collecting = false;
+    _next_cycle_heap = std::max(LUA_GC_MIN_HEAP,
+                                static_cast<int32_t>(static_cast<float>(lua_gc(_state, LUA_GCCOUNT, 0)) * LUA_GC_PAUSE));
+
+    // The Lua 5.1 collections restart the automatic collector.
+    lua_gc(_state, LUA_GCSTOP, 0);
+}
+
+} // namespace
+
+void LuaHeap::Install(lua_State* state)
+{
+    if(state == nullptr || _state != nullptr)
+        return;
+
+    uint32_t pool_id = 0;
+    for(uint32_t i = 0; i < sizeof(_pool_by_size); ++i) {
+        while(LUA_POOL_BLOCK_SIZES[pool_id] < i * 16)
+            ++pool_id;
+        _pool_by_size[i] = static_cast<uint8_t>(pool_id);
+    }
+
+    _state = state;
+    _system_alloc = lua_getallocf(state, &_system_alloc_data);
+    lua_setallocf(state, _LuaPoolAlloc, nullptr);
+
+    _EndCycle();
+}
+
+void LuaHeap::Step()
+{
+    _last_step_time = 0.0f;
+    if(_state == nullptr)
+        return;
+
+    const int32_t heap = lua_gc(_state, LUA_GCCOUNT, 0);
+    if(!_collecting && heap < _next_cycle_heap)
+        return;
+
+    const uint64_t start = SDL_GetPerformanceCounter();
+    uint64_t now = start;
+
+    // The heap grows faster than it is collected: Finish the cycle at once.
+    if(heap > _next_cycle_heap * 2) {
+        Collect();
+        now = SDL_GetPerformanceCounter();
+    } else {
+        PROFILE_SCOPE("Lua GC");
+        _collecting = true;
+
+        const uint64_t budget = static_cast<uint64_t>(LUA_GC_FRAME_BUDGET * static_cast<float>(SDL_GetPerformanceFrequency()) / 1000.0f);
+        while(now - start < budget) {
+            const bool cycle_done = lua_gc(_state, LUA_GCSTEP, LUA_GC_STEP_SIZE) != 0;
+            now = SDL_GetPerformanceCounter();
+            if(cycle_done) {
+                _EndCycle();
+                break;
+            }
+        }
+
+        if(_collecting)
+            lua_gc(_state, LUA_GCSTOP, 0);
+    }
+
+    _last_step_time = static_cast<float>(now - start) * 1000.0f / static_cast<float>(SDL_GetPerformanceFrequency());
+}
+
+void LuaHeap::Collect()
+{
+    if(_state == nullptr)
+        return;
+
+    PROFILE_SCOPE("Lua full GC");
+    lua_gc(_state, LUA_GCCOLLECT, 0);
+    _EndCycle();
+}
+
+uint32_t LuaHeap::GetSlabCount()
+{
+    return static_cast<uint32_t>(_slabs.size());
+}
+
+} // namespace vt_system
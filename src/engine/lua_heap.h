@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    lua_heap.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the Lua state allocator and garbage collection pacing.
+***
+*** The small blocks of the Lua state (strings, tables, closures...) are handed
+*** out from size class pools, carved in slabs, instead of the system heap.
+*** The larger ones, and those allocated before the pools were installed, are
+*** still handled by the original allocation function of the state.
+***
+*** The automatic garbage collection is stopped: Instead, the collector is
+*** stepped once per frame within a time budget, and full collections are run
+*** during the mode transitions, while the screen is faded out.
+*** ***************************************************************************/
+
+#ifndef __LUA_HEAP_HEADER__
+#define __LUA_HEAP_HEADER__
+
+#include <cstdint>
+
+struct lua_State;
+
+namespace vt_system
+{
+
+//! \brief The time the garbage collector may run each frame, in milliseconds.
+const float LUA_GC_FRAME_BUDGET = 1.0f;
+
+//! \brief The work done by each garbage collection step, in kilobytes of allocations.
+const int32_t LUA_GC_STEP_SIZE = 8;
+
+//! \brief How much the heap may grow after a collection before the next one starts. The Lua default.
+const float LUA_GC_PAUSE = 2.0f;
+
+//! \brief The heap size under which no collection starts, in kilobytes.
+const int32_t LUA_GC_MIN_HEAP = 1024;
+
+/** ****************************************************************************
+*** \brief The allocator and garbage collector pacing of the Lua state.
+***
+*** \note The Lua state is only ever used by the main thread, and so is this class.
+*** ***************************************************************************/
+class LuaHeap
+{
+public:
+    /** \brief Replaces the allocation function of the state by the pools one,
+    *** and stops the automatic garbage collection.
+    *** \note To be called once the state is created, before accounting its memory.
+    **/
+    static void Install(lua_State* state);
+
+    //! \brief Runs the garbage collector steps of the frame, within LUA_GC_FRAME_BUDGET.
+    static void Step();
+
+    //! \brief Runs a full garbage collection, when a frame may take longer.
+    static void Collect();
+
+    //! \brief Returns the time spent collecting during the last step, in milliseconds.
+    static float GetLastStepTime() {
+        return _last_step_time;
+    }
+
+    //! \brief Returns the number of slabs carved into pool blocks.
+    static uint32_t GetSlabCount();
+
+private:
+    static float _last_step_time;
+};
+
+} // namespace vt_system
+
+#endif // __LUA_HEAP_HEADER__
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    memory_arena.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the game modes memory arenas.
+*** ***************************************************************************/
+
+#include "memory_arena.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+
+#include <new>
+
+namespace vt_mode_manager
+{
+
+//! \brief Rounds a size up to the arena alignment, big enough to hold a free chunk pointer.
+static size_t _RoundSize(size_t size)
+{
+    if(size == 0)
+        size = 1;
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+MemoryArena::MemoryArena(size_t block_size) :
+    _block_size(_RoundSize(block_size)),
+    _current(nullptr),
+    _remaining(0),
+    _used_size(0),
+    _reserved_size(0)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+    for(uint32_t i = 0; i < _blocks.size(); ++i)
+        ::operator delete(_blocks[i]);
+    _blocks.clear();
+}
+
+MemoryArena::MemoryArena(const MemoryArena&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+MemoryArena& MemoryArena::operator=(const MemoryArena&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+void* MemoryArena::Allocate(size_t size)
+{
+    size = _RoundSize(size);
+    _used_size += size;
+
+    // Reuse the memory deallocated with the same size first.
+    std::map<size_t, void *>::iterator it = _free_chunks.find(size);
+    if(it != _free_chunks.end()) {
+        void* chunk = it->second;
+        void* next = *static_cast<void **>(chunk);
+        if(next)
+            it->second = next;
+        else
+            _free_chunks.erase(it);
+        return chunk;
+    }
+
+    // The big allocations get their own block, keeping the current one.
+    if(size > _block_size / 4)
+        return _AddBlock(size);
+
+    if(size > _remaining) {
+        _current = _AddBlock(_block_size);
+        _remaining = _block_size;
+    }
+
+    void* memory = _current;
+    _current += size;
+    _remaining -= size;
+    return memory;
+}
+
+void MemoryArena::Deallocate(void* pointer, size_t size)
+{
+    if(!pointer)
+        return;
+
+    size = _RoundSize(size);
+    _used_size -= size;
+
+    void*& first = _free_chunks[size];
+    *static_cast<void **>(pointer) = first;
+    first = pointer;
+}
+
+char* MemoryArena::_AddBlock(size_t size)
+{
+    // The global operator new memory is aligned for any standard type.
+    char* block = static_cast<char *>(::operator new(size));
+    _blocks.push_back(block);
+    _reserved_size += size;
+    return block;
+}
+
+} // namespace vt_mode_manager
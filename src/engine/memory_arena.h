@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    memory_arena.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the game modes memory arenas.
+***
+*** The objects living as long as a game mode, like the map objects and events,
+*** are allocated one after the other in big memory blocks owned by the game
+*** mode, rather than one by one on the heap. The blocks are all freed at once
+*** with the game mode.
+***
+*** \note The objects destructors must still be called before their game mode
+*** is destroyed, the arena only handles the memory.
+*** ***************************************************************************/
+
+#ifndef __MEMORY_ARENA_HEADER__
+#define __MEMORY_ARENA_HEADER__
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace vt_mode_manager
+{
+
+//! \brief The alignment of every arena allocation, enough for any standard type.
+const size_t ARENA_ALIGNMENT = 16;
+
+//! \brief The default size of the arena memory blocks.
+const size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+/** ****************************************************************************
+*** \brief Allocates memory by bumping a pointer in big blocks, freed all at once.
+***
+*** The memory deallocated before the arena destruction is kept, and reused by
+*** the next allocations of the same size, so that the objects created and
+*** deleted over and over by a game mode don't make the arena grow.
+***
+*** \note The arena isn't thread-safe, and is meant to be used by the main thread.
+*** ***************************************************************************/
+class MemoryArena
+{
+public:
+    //! \param block_size The size of the memory blocks.
+    explicit MemoryArena(size_t block_size = ARENA_BLOCK_SIZE);
+
+    //! \brief Frees all the memory blocks.
+    ~MemoryArena();
+
+    /** \brief Allocates memory aligned on ARENA_ALIGNMENT.
+    *** The allocations bigger than a quarter of a block get their own block.
+    **/
+    void* Allocate(size_t size);
+
+    /** \brief Keeps the memory for the next allocations of the same size.
+    *** \param pointer Memory returned by Allocate(), or nullptr.
+    *** \param size The size given to Allocate().
+    **/
+    void Deallocate(void* pointer, size_t size);
+
+    //! \brief The memory allocated and not deallocated, in bytes.
+    size_t GetUsedSize() const {
+        return _used_size;
+    }
+
+    //! \brief The memory of all the blocks, in bytes.
+    size_t GetReservedSize() const {
+        return _reserved_size;
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    MemoryArena(const MemoryArena& arena);
+    MemoryArena& operator=(const MemoryArena& arena);
+
+    //! \brief The size of the blocks.
+    size_t _block_size;
+
+    //! \brief The memory blocks.
+    std::vector<char *> _blocks;
+
+    //! \brief The free part of the last block.
+    char* _current;
+    size_t _remaining;
+
+    /** \brief The deallocated memory, by rounded size.
+    *** Each free chunk stores the pointer to the next one of the same size.
+    **/
+    std::map<size_t, void *> _free_chunks;
+
+    size_t _used_size;
+    size_t _reserved_size;
+
+    //! \brief Adds a block of at least the given size, returning its memory.
+    char* _AddBlock(size_t size);
+};
+
+/** ****************************************************************************
+*** \brief A standard allocator giving the memory of an arena to the containers.
+***
+*** The containers must not outlive their arena. Their deallocated memory is
+*** reused by the arena for the next allocations of the same size.
+*** ***************************************************************************/
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    explicit ArenaAllocator(MemoryArena& arena) :
+        _arena(&arena)
+    {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) :
+        _arena(other.GetArena())
+    {}
+
+    T* allocate(size_t count) {
+        return static_cast<T *>(_arena->Allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        _arena->Deallocate(pointer, count * sizeof(T));
+    }
+
+    MemoryArena* GetArena() const {
+        return _arena;
+    }
+
+private:
+    MemoryArena* _arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& first, const ArenaAllocator<U>& second)
+{
+    return first.GetArena() == second.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& first, const ArenaAllocator<U>& second)
+{
+    return first.GetArena() != second.GetArena();
+}
+
+} // namespace vt_mode_manager
+
+#endif // __MEMORY_ARENA_HEADER__
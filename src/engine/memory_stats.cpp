@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    memory_stats.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the memory accounting per subsystem.
+*** ***************************************************************************/
+
+#include "engine/memory_stats.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_strings.h"
+
+#include <luabind/lua_include.hpp>
+
+#include <SDL2/SDL.h>
+
+#include <fstream>
+
+using namespace vt_utils;
+
+namespace vt_system
+{
+
+bool MemoryStats::_overlay_shown = false;
+std::string MemoryStats::_overlay_text;
+uint32_t MemoryStats::_overlay_refresh_time = 0;
+
+namespace
+{
+
+//! \brief The milliseconds between two refreshes of the overlay text.
+const uint32_t OVERLAY_REFRESH_TIME = 500;
+
+//! \brief The bytes used by each tag, and by all of them, with their high-water marks.
+//! \note They're kept as 32 bit atomics, which is plenty for a single tag.
+SDL_atomic_t _used[MEMORY_TAG_TOTAL];
+SDL_atomic_t _high_water[MEMORY_TAG_TOTAL];
+SDL_atomic_t _total_used = { 0 };
+SDL_atomic_t _total_high_water = { 0 };
+
+//! \brief The allocation function of the Lua state being tracked.
+lua_Alloc _lua_alloc = nullptr;
+void* _lua_alloc_data = nullptr;
+
+//! \brief Raises a high-water mark up to the given value.
+void _RaiseHighWater(SDL_atomic_t& high_water, int value)
+{
+    int current = SDL_AtomicGet(&high_water);
+    while(value > current && !SDL_AtomicCAS(&high_water, current, value))
+        current = SDL_AtomicGet(&high_water);
+}
+
+//! \brief Accounts the Lua heap changes, before calling the state allocation function.
+void* _LuaAlloc(void* data, void* memory, size_t old_size, size_t new_size)
+{
+    void* new_memory = _lua_alloc(data, memory, old_size, new_size);
+
+    // The old size is only a block size when there is a block.
+    const size_t previous_size = memory != nullptr ? old_size : 0;
+    if(new_size == 0) {
+        MemoryStats::Remove(MEMORY_LUA, previous_size);
+    } else if(new_memory != nullptr) {
+        if(new_size > previous_size)
+            MemoryStats::Add(MEMORY_LUA, new_size - previous_size);
+        else
+            MemoryStats::Remove(MEMORY_LUA, previous_size - new_size);
+    }
+    return new_memory;
+}
+
+//! \brief Prints bytes as kilobytes.
+std::string _ToKilobytes(int64_t bytes)
+{
+    return NumberToString(static_cast<int32_t>((bytes + 512) / 1024)) + " KB";
+}
+
+} // namespace
+
+const char* GetMemoryTagName(MemoryTag tag)
+{
+    switch(tag) {
+    case MEMORY_TEXTURES_GPU:
+        return "textures_gpu";
+    case MEMORY_TEXTURES_CPU:
+        return "textures_cpu";
+    case MEMORY_AUDIO:
+        return "audio";
+    case MEMORY_LUA:
+        return "lua";
+    case MEMORY_PARTICLES:
+        return "particles";
+    case MEMORY_TEXT:
+        return "text";
+    case MEMORY_MAP:
+        return "map";
+    default:
+        return "unknown";
+    }
+}
+
+void MemoryStats::Add(MemoryTag tag, size_t bytes)
+{
+    const int value = static_cast<int>(bytes);
+    _RaiseHighWater(_high_water[tag], SDL_AtomicAdd(&_used[tag], value) + value);
+    _RaiseHighWater(_total_high_water, SDL_AtomicAdd(&_total_used, value) + value);
+}
+
+void MemoryStats::Remove(MemoryTag tag, size_t bytes)
+{
+    const int value = static_cast<int>(bytes);
+    SDL_AtomicAdd(&_used[tag], -value);
+    SDL_AtomicAdd(&_total_used, -value);
+}
+
+int64_t MemoryStats::GetUsed(MemoryTag tag)
+{
+    return SDL_AtomicGet(&_used[tag]);
+}
+
+int64_t MemoryStats::GetHighWater(MemoryTag tag)
+{
+    return SDL_AtomicGet(&_high_water[tag]);
+}
+
+int64_t MemoryStats::GetTotalUsed()
+{
+    return SDL_AtomicGet(&_total_used);
+}
+
+int64_t MemoryStats::GetTotalHighWater()
+{
+    return SDL_AtomicGet(&_total_high_water);
+}
+
+void MemoryStats::ResetHighWater()
+{
+    for(uint32_t i = 0; i < MEMORY_TAG_TOTAL; ++i)
+        SDL_AtomicSet(&_high_water[i], SDL_AtomicGet(&_used[i]));
+    SDL_AtomicSet(&_total_high_water, SDL_AtomicGet(&_total_used));
+}
+
+void MemoryStats::TrackLuaState(lua_State* state)
+{
+    if(state == nullptr || _lua_alloc != nullptr)
+        return;
+
+    _lua_alloc = lua_getallocf(state, &_lua_alloc_data);
+    lua_setallocf(state, _LuaAlloc, _lua_alloc_data);
+
+    // The blocks already allocated will be removed when freed.
+    Add(MEMORY_LUA, static_cast<size_t>(lua_gc(state, LUA_GCCOUNT, 0)) * 1024 +
+        static_cast<size_t>(lua_gc(state, LUA_GCCOUNTB, 0)));
+}
+
+const std::string& MemoryStats::GetOverlayText()
+{
+    const uint32_t ticks = SDL_GetTicks();
+    if(!_overlay_text.empty() && ticks - _overlay_refresh_time < OVERLAY_REFRESH_TIME)
+        return _overlay_text;
+    _overlay_refresh_time = ticks;
+
+    _overlay_text = "Memory: used / high-water";
+    for(uint32_t i = 0; i < MEMORY_TAG_TOTAL; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        _overlay_text += std::string("\n") + GetMemoryTagName(tag) + ": "
+                         + _ToKilobytes(GetUsed(tag)) + " / " + _ToKilobytes(GetHighWater(tag));
+    }
+    _overlay_text += "\ntotal: " + _ToKilobytes(GetTotalUsed()) + " / " + _ToKilobytes(GetTotalHighWater());
+    return _overlay_text;
+}
+
+bool MemoryStats::WriteReport(const std::string& filename, const std::string& details)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    if(!file.is_open()) {
+        PRINT_ERROR << "Couldn't open the memory report file: " << filename << std::endl;
+        return false;
+    }
+
+    file << "Memory used, in bytes (high-water mark):" << std::endl;
+    for(uint32_t i = 0; i < MEMORY_TAG_TOTAL; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        file << GetMemoryTagName(tag) << ": " << GetUsed(tag) << " (" << GetHighWater(tag) << ")" << std::endl;
+    }
+    file << "total: " << GetTotalUsed() << " (" << GetTotalHighWater() << ")" << std::endl;
+
+    if(!details.empty())
+        file << std::endl << details;
+
+    file.close();
+    if(file.fail()) {
+        PRINT_ERROR << "Couldn't write the memory report file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace vt_system
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    memory_stats.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the memory accounting per subsystem.
+***
+*** The subsystems holding most of the memory add and remove the bytes they
+*** allocate under their tag, either explicitly or through MemoryTagAllocator
+*** for their containers. The memory used and its high-water mark are kept for
+*** each tag, shown in a debug overlay, dumped on demand and emitted by the
+*** benchmarks.
+***
+*** \note The tags don't overlap: The text textures lie in the texture sheets,
+*** and are thus part of the GPU textures, detailed per sheet in the dump.
+*** ***************************************************************************/
+
+#ifndef __MEMORY_STATS_HEADER__
+#define __MEMORY_STATS_HEADER__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+
+struct lua_State;
+
+namespace vt_system
+{
+
+//! \brief The subsystems whose memory is accounted.
+enum MemoryTag {
+    //! The texture sheets and render targets, in video memory.
+    MEMORY_TEXTURES_GPU = 0,
+    //! The image pixels in system memory: Decoded, evicted or read back images.
+    MEMORY_TEXTURES_CPU = 1,
+    //! The OpenAL buffers, and the audio data streamed from memory.
+    MEMORY_AUDIO = 2,
+    //! The Lua heap.
+    MEMORY_LUA = 3,
+    //! The particle blocks and drawing arrays.
+    MEMORY_PARTICLES = 4,
+    //! The glyph atlas pages.
+    MEMORY_TEXT = 5,
+    //! The map tiles and collision grids, and the baked map data.
+    MEMORY_MAP = 6,
+    MEMORY_TAG_TOTAL = 7
+};
+
+//! \brief Returns the name of a tag, as shown in the overlay and written in the reports.
+const char* GetMemoryTagName(MemoryTag tag);
+
+/** ****************************************************************************
+*** \brief Keeps the memory used by each subsystem.
+***
+*** The counters may be updated from any thread, as the images and sounds are
+*** also decoded by the job system workers.
+*** ***************************************************************************/
+class MemoryStats
+{
+public:
+    static void Add(MemoryTag tag, size_t bytes);
+    static void Remove(MemoryTag tag, size_t bytes);
+
+    //! \brief Returns the bytes currently used under a tag.
+    static int64_t GetUsed(MemoryTag tag);
+
+    //! \brief Returns the most bytes used under a tag since the last reset.
+    static int64_t GetHighWater(MemoryTag tag);
+
+    //! \brief Returns the bytes used by every tag, and their most since the last reset.
+    static int64_t GetTotalUsed();
+    static int64_t GetTotalHighWater();
+
+    //! \brief Restarts the high-water marks from the memory currently used.
+    static void ResetHighWater();
+
+    /** \brief Accounts the Lua heap, by wrapping the allocation function of the state.
+    *** \note The memory already allocated by the state is accounted as well.
+    **/
+    static void TrackLuaState(lua_State* state);
+
+    //! \brief Shows or hides the overlay.
+    static void ToggleOverlay() {
+        _overlay_shown = !_overlay_shown;
+    }
+
+    static bool IsOverlayShown() {
+        return _overlay_shown;
+    }
+
+    //! \brief The overlay text, only refreshed a few times per second so that it stays readable.
+    static const std::string& GetOverlayText();
+
+    /** \brief Writes the memory used and the high-water marks of each tag to a text file.
+    *** \param details Text appended to the report, like the texture sheets list.
+    *** \return False if the file couldn't be written.
+    **/
+    static bool WriteReport(const std::string& filename, const std::string& details);
+
+private:
+    static bool _overlay_shown;
+    static std::string _overlay_text;
+    static uint32_t _overlay_refresh_time;
+};
+
+/** ****************************************************************************
+*** \brief A standard allocator accounting the memory of the containers of a subsystem.
+***
+*** E.g.: std::vector<uint8_t, MemoryTagAllocator<uint8_t, MEMORY_TEXTURES_CPU> >
+*** \note Copying and swapping such containers keeps the accounting right, as
+*** each allocation is removed from the tag by the container freeing it.
+*** ***************************************************************************/
+template<typename T, MemoryTag TAG>
+class MemoryTagAllocator
+{
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind {
+        typedef MemoryTagAllocator<U, TAG> other;
+    };
+
+    MemoryTagAllocator() {}
+
+    template<typename U>
+    MemoryTagAllocator(const MemoryTagAllocator<U, TAG>&) {}
+
+    T* allocate(size_t count) {
+        T* memory = static_cast<T*>(::operator new(count * sizeof(T)));
+        MemoryStats::Add(TAG, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count) {
+        MemoryStats::Remove(TAG, count * sizeof(T));
+        ::operator delete(memory);
+    }
+
+    // Needed by the VS2013 containers.
+    size_t max_size() const {
+        return static_cast<size_t>(-1) / sizeof(T);
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* element, Args&&... args) {
+        ::new(static_cast<void*>(element)) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U* element) {
+        element->~U();
+    }
+};
+
+template<typename T, typename U, MemoryTag TAG>
+bool operator==(const MemoryTagAllocator<T, TAG>&, const MemoryTagAllocator<U, TAG>&)
+{
+    return true;
+}
+
+template<typename T, typename U, MemoryTag TAG>
+bool operator!=(const MemoryTagAllocator<T, TAG>&, const MemoryTagAllocator<U, TAG>&)
+{
+    return false;
+}
+
+} // namespace vt_system
+
+#endif // __MEMORY_STATS_HEADER__
@@ -18,12 +18,23 @@
 #include "mode_manager.h"
 
 #include "system.h"
+#include "asset_manifest.h"
+#include "frame_profiler.h"
+#include "idle_scheduler.h"
+#include "lua_heap.h"
 
 #include "engine/video/video.h"
 #include "engine/audio/audio.h"
 
 #include "modes/mode_help_window.h"
 
+#include "common/global/global.h"
+
+#include "script/script.h"
+
+#include <algorithm>
+#include <map>
+
 using namespace vt_utils;
 using namespace vt_system;
 using namespace vt_video;
@@ -37,6 +48,71 @@ bool MODE_MANAGER_DEBUG = false;
 
 const uint32_t FADE_IN_OUT_TIME = 800;
 
+namespace
+{
+
+//! \brief The number of living game modes owning each script global table.
+std::map<std::string, uint32_t> script_tablespace_owners;
+
+//! \brief The number of living game modes which loaded each texture atlas.
+std::map<std::string, uint32_t> texture_atlas_owners;
+
+//! \brief Draws the loading progress as a thin bar at the bottom of the faded out screen.
+void DrawLoadingBar(float progress)
+{
+    const float LOADING_BAR_WIDTH = 256.0f;
+    const float LOADING_BAR_HEIGHT = 4.0f;
+    const float left = (VIDEO_STANDARD_RES_WIDTH - LOADING_BAR_WIDTH) / 2.0f;
+    const float bottom = VIDEO_STANDARD_RES_HEIGHT - 48.0f;
+
+    VideoManager->PushState();
+    VideoManager->SetStandardCoordSys();
+    VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, VIDEO_BLEND, 0);
+    VideoManager->DrawRectangleOutline(left - 1.0f, left + LOADING_BAR_WIDTH + 1.0f,
+                                       bottom + 1.0f, bottom - LOADING_BAR_HEIGHT - 1.0f, 1, Color::gray);
+    VideoManager->Move(left, bottom);
+    VideoManager->DrawRectangle(LOADING_BAR_WIDTH * progress, LOADING_BAR_HEIGHT, Color::white);
+    VideoManager->PopState();
+}
+
+//! \brief Returns the share of the jobs done, from 0.0f to 1.0f.
+float GetJobsProgress(const std::vector<vt_system::JobHandle>& jobs)
+{
+    if(jobs.empty())
+        return 1.0f;
+
+    uint32_t done_jobs = 0;
+    for(uint32_t i = 0; i < jobs.size(); ++i) {
+        if(jobs[i].IsDone())
+            ++done_jobs;
+    }
+    return static_cast<float>(done_jobs) / static_cast<float>(jobs.size());
+}
+
+} // namespace
+
+const char* GetGameModeName(uint8_t mode_type)
+{
+    switch(mode_type) {
+    case MODE_MANAGER_BOOT_MODE:
+        return "boot";
+    case MODE_MANAGER_MAP_MODE:
+        return "map";
+    case MODE_MANAGER_BATTLE_MODE:
+        return "battle";
+    case MODE_MANAGER_MENU_MODE:
+        return "menu";
+    case MODE_MANAGER_SHOP_MODE:
+        return "shop";
+    case MODE_MANAGER_PAUSE_MODE:
+        return "pause";
+    case MODE_MANAGER_SAVE_MODE:
+        return "save";
+    default:
+        return "none";
+    }
+}
+
 // ****************************************************************************
 // ***** GameMode class
 // ****************************************************************************
@@ -64,9 +140,67 @@ GameMode::~GameMode()
     IF_PRINT_WARNING(MODE_MANAGER_DEBUG)
             << "MODE MANAGER: GameMode destructor invoked" << std::endl;
 
+    // The loading jobs may still use the game mode.
+    for(uint32_t i = 0; i < _loading_jobs.size(); ++i) {
+        if(!_loading_jobs[i].IsDone())
+            vt_system::JobManager->Wait(_loading_jobs[i]);
+    }
+
+    // As well as the deferred tasks it submitted.
+    IdleScheduler::CancelTasks(this);
+    vt_system::AssetManifest::CancelUnusedImages(this);
+
+    // The script functions watching events are freed with the script tables.
+    if(vt_global::GlobalManager)
+        vt_global::GlobalManager->GetGameEvents().UnwatchEvents(this);
+
     // Tells the audio manager that the mode is ending
     // to permit freeing self-managed audio files.
     AudioManager->RemoveGameModeOwner(this);
+
+    // Drops the script tables no other game mode uses, for the garbage collector to free them.
+    for(uint32_t i = 0; i < _script_tablespaces.size(); ++i) {
+        std::map<std::string, uint32_t>::iterator it = script_tablespace_owners.find(_script_tablespaces[i]);
+        if(it == script_tablespace_owners.end() || --it->second > 0)
+            continue;
+
+        script_tablespace_owners.erase(it);
+        vt_script::ScriptManager->DropGlobalTable(_script_tablespaces[i]);
+    }
+
+    for(uint32_t i = 0; i < _texture_atlases.size(); ++i) {
+        std::map<std::string, uint32_t>::iterator it = texture_atlas_owners.find(_texture_atlases[i]);
+        if(it == texture_atlas_owners.end() || --it->second > 0)
+            continue;
+
+        texture_atlas_owners.erase(it);
+        TextureManager->UnloadTextureAtlas(_texture_atlases[i]);
+    }
+}
+
+void GameMode::OwnScriptTablespace(const std::string& tablespace)
+{
+    if(tablespace.empty() ||
+            std::find(_script_tablespaces.begin(), _script_tablespaces.end(), tablespace) != _script_tablespaces.end())
+        return;
+
+    _script_tablespaces.push_back(tablespace);
+    ++script_tablespace_owners[tablespace];
+}
+
+bool GameMode::LoadTextureAtlas(const std::string& filename)
+{
+    if(std::find(_texture_atlases.begin(), _texture_atlases.end(), filename) != _texture_atlases.end())
+        return true;
+
+    if(!TextureManager->LoadTextureAtlas(filename)) {
+        PRINT_WARNING << "Couldn't load the texture atlas: " << filename << std::endl;
+        return false;
+    }
+
+    _texture_atlases.push_back(filename);
+    ++texture_atlas_owners[filename];
+    return true;
 }
 
 
@@ -95,6 +229,21 @@ void GameMode::Deactivate()
 {
 }
 
+bool GameMode::UpdateLoading()
+{
+    for(uint32_t i = 0; i < _loading_jobs.size(); ++i) {
+        if(!_loading_jobs[i].IsDone())
+            return false;
+    }
+    _loading_jobs.clear();
+    return true;
+}
+
+float GameMode::GetLoadingProgress() const
+{
+    return GetJobsProgress(_loading_jobs);
+}
+
 EffectSupervisor& GameMode::GetEffectSupervisor()
 {
     return _effect_supervisor;
@@ -128,6 +277,9 @@ ModeEngine::ModeEngine()
     _state_change = false;
     _fade_out = false;
     _fade_out_finished = false;
+    _loading = false;
+    _loading_progress = 1.0f;
+    _loading_indicator = DrawLoadingBar;
 
     // Initialized in Push()
     _help_window = 0;
@@ -150,6 +302,8 @@ ModeEngine::~ModeEngine()
         delete _push_stack.back();
         _push_stack.pop_back();
     }
+    _push_factories.clear();
+    _push_loading_jobs.clear();
 
     delete _help_window;
 }
@@ -169,6 +323,8 @@ bool ModeEngine::SingletonInitialize()
         delete _push_stack.back();
         _push_stack.pop_back();
     }
+    _push_factories.clear();
+    _push_loading_jobs.clear();
 
     // Reset the pop counter
     _pop_count = 0;
@@ -206,6 +362,8 @@ void ModeEngine::PopAll()
 void ModeEngine::Push(GameMode *gm, bool fade_out, bool fade_in)
 {
     _push_stack.push_back(gm);
+    _push_factories.push_back(std::function<GameMode *()>());
+    _push_loading_jobs.push_back(std::vector<vt_system::JobHandle>());
 
     _state_change = true;
 
@@ -226,6 +384,20 @@ void ModeEngine::Push(GameMode *gm, bool fade_out, bool fade_in)
         _help_window = new HelpWindow();
 }
 
+void ModeEngine::Push(const std::function<GameMode *()>& mode_factory, bool fade_out, bool fade_in)
+{
+    // Built once faded out.
+    Push(static_cast<GameMode *>(nullptr), fade_out, fade_in);
+    _push_factories.back() = mode_factory;
+}
+
+void ModeEngine::Push(const std::function<GameMode *()>& mode_factory, const std::vector<vt_system::JobHandle>& loading_jobs,
+                      bool fade_out, bool fade_in)
+{
+    Push(mode_factory, fade_out, fade_in);
+    _push_loading_jobs.back() = loading_jobs;
+}
+
 
 // Returns the mode type of the game mode on the top of the stack
 uint8_t ModeEngine::GetGameType()
@@ -269,13 +441,21 @@ GameMode *ModeEngine::Get(uint32_t index)
 // Checks if any game modes need to be pushed or popped off the stack, then updates the top stack mode.
 void ModeEngine::Update()
 {
+    PROFILE_SCOPE("ModeEngine::Update");
+
     // Check whether the fade out is done.
+    const bool faded_out = _fade_out_finished;
     if(_fade_out && VideoManager->IsLastFadeTransitional() &&
             !VideoManager->IsFading()) {
         _fade_out = false;
         _fade_out_finished = true;
     }
 
+    // Let the pushed game modes load, from the fade out start until they're all ready.
+    // The active game mode isn't updated anymore once faded out.
+    if(_state_change && !_UpdatePushedModesLoading(faded_out) && _fade_out_finished)
+        return;
+
     // If a Push() or Pop() function was called, we need to adjust the state of the game stack.
     if(_fade_out_finished && _state_change) {
         // Pop however many game modes we need to from the top of the stack
@@ -298,8 +478,14 @@ void ModeEngine::Update()
 
             _game_stack.push_back(_push_stack.back());
             _push_stack.pop_back();
+            _push_factories.pop_back();
+            _push_loading_jobs.pop_back();
         }
 
+        // Collect the scripts of the popped modes while the screen is faded out,
+        // the update timer being reset below.
+        LuaHeap::Collect();
+
         // Make sure there is a game mode on the stack,
         // otherwise we'll get a segmentation fault.
         if(_game_stack.empty()) {
@@ -336,12 +522,72 @@ void ModeEngine::Update()
 
 void ModeEngine::Draw()
 {
+    PROFILE_SCOPE("ModeEngine::Draw");
+
     if(_game_stack.empty())
         return;
 
     _game_stack.back()->Draw();
 }
 
+bool ModeEngine::_UpdatePushedModesLoading(bool faded_out)
+{
+    bool loaded = true;
+    float progress = 0.0f;
+
+    for(uint32_t i = 0; i < _push_stack.size(); ++i) {
+        if(_push_stack[i] == nullptr) {
+            // Let a frame be drawn once faded out, showing the loading indicator, before
+            // stalling the game with the construction. The construction also waits for
+            // the loading jobs, so that it doesn't block on them.
+            const float jobs_progress = GetJobsProgress(_push_loading_jobs[i]);
+            if(!faded_out || !_fade_out_finished || jobs_progress < 1.0f) {
+                if(!_push_loading_jobs[i].empty())
+                    progress += jobs_progress;
+                loaded = false;
+                continue;
+            }
+            _push_loading_jobs[i].clear();
+
+            if(_push_factories[i])
+                _push_stack[i] = _push_factories[i]();
+            _push_factories[i] = nullptr;
+            if(_push_stack[i] == nullptr) {
+                PRINT_WARNING << "No game mode was created for a push" << std::endl;
+                _push_stack.erase(_push_stack.begin() + i);
+                _push_factories.erase(_push_factories.begin() + i);
+                _push_loading_jobs.erase(_push_loading_jobs.begin() + i);
+                --i;
+                continue;
+            }
+        }
+
+        if(!_push_stack[i]->UpdateLoading())
+            loaded = false;
+        progress += _push_stack[i]->GetLoadingProgress();
+    }
+
+    _loading = !loaded;
+    _loading_progress = _push_stack.empty() ? 1.0f : progress / _push_stack.size();
+    return loaded;
+}
+
+bool ModeEngine::IsIdle() const
+{
+    if(_game_stack.empty() || _state_change || _loading || VideoManager->IsFading())
+        return false;
+
+    return _game_stack.back()->IsIdle();
+}
+
+void ModeEngine::DrawLoadingIndicator()
+{
+    if(!_loading || !_fade_out_finished || !_loading_indicator)
+        return;
+
+    _loading_indicator(_loading_progress);
+}
+
 void ModeEngine::DrawEffects()
 {
     if(_game_stack.empty())
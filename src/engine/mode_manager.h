@@ -22,6 +22,10 @@
 #include "engine/video/particle_manager.h"
 #include "engine/script_supervisor.h"
 #include "engine/indicator_supervisor.h"
+#include "engine/job_system.h"
+#include "engine/memory_arena.h"
+
+#include <functional>
 
 //! All calls to the mode management code are wrapped inside this namespace
 namespace vt_mode_manager
@@ -48,6 +52,9 @@ const uint8_t MODE_MANAGER_PAUSE_MODE  = 6;
 const uint8_t MODE_MANAGER_SAVE_MODE   = 7;
 //@}
 
+//! \brief Returns the name of a mode type, as written in the performance reports.
+const char* GetGameModeName(uint8_t mode_type);
+
 /** ***************************************************************************
 *** \brief An abstract class that all game mode classes inherit from.
 ***
@@ -104,6 +111,18 @@ public:
     //! \brief Called when a game mode is made inactive
     virtual void Deactivate();
 
+    /** \brief Continues loading the game mode, before it is put on the stack.
+    *** \return True once the game mode is loaded. By default, once its loading jobs are done.
+    ***
+    *** This is called once per frame by the ModeEngine from the moment the game mode is pushed,
+    *** during the fade out, and the game stack is only changed once every pushed game mode is loaded.
+    *** The game modes can spread their loading over several frames this way.
+    **/
+    virtual bool UpdateLoading();
+
+    //! \brief Returns the loading progress of the game mode, from 0.0f to 1.0f.
+    virtual float GetLoadingProgress() const;
+
     //! \brief Returns the effect supervisor.
     EffectSupervisor& GetEffectSupervisor();
 
@@ -116,22 +135,86 @@ public:
     //! \brief Returns the indicator supervisor.
     IndicatorSupervisor& GetIndicatorSupervisor();
 
+    //! \brief Returns the memory arena of the objects living as long as the game mode.
+    MemoryArena& GetMemoryArena() {
+        return _memory_arena;
+    }
+
     //! \brief Makes the game mode reload the different texts.
     //! Used when changing the language in the options.
     virtual void ReloadTranslatedTexts()
     {}
 
+#ifdef DEBUG_FEATURES
+    /** \brief Makes the game mode reload a script file it uses, which changed on disk.
+    *** Called by the asset watcher, on the active game mode only.
+    **/
+    virtual void DEBUG_ReloadScript(const std::string& /*filename*/)
+    {}
+#endif
+
     //! \brief Tells whether user input is accepted in dialogues.
     //! Used by the common dialogue supervisor.
     virtual bool AcceptUserInputInDialogues() const {
         return true;
     }
 
+    /** \brief Tells whether the game mode shows a still screen, only changing on user input.
+    *** The still screens are redrawn at a low frame rate, to save power.
+    **/
+    virtual bool IsIdle() const {
+        return false;
+    }
+
+    //! \brief Describes what the game mode shows, like the map file, in the hitch reports.
+    virtual std::string GetReportDescription() const {
+        return std::string();
+    }
+
+    /** \brief Makes a script global table live as long as the game mode.
+    *** \param tablespace The name of the global table, like the tablespace of a script the game mode opened.
+    ***
+    *** The table is dropped from the Lua state once the last game mode owning it is destroyed,
+    *** so that the scripts of the past game modes don't stay reachable until they are loaded again.
+    **/
+    void OwnScriptTablespace(const std::string& tablespace);
+
+    /** \brief Loads a texture atlas baked by tools/bake-texture-atlas.py, living as long as the game mode.
+    *** \param filename The Lua manifest of the atlas.
+    *** \return False if the atlas couldn't be loaded.
+    ***
+    *** The atlas images are then used instead of reading their own files. The atlas is
+    *** unloaded once the last game mode which loaded it is destroyed.
+    **/
+    bool LoadTextureAtlas(const std::string& filename);
+
 protected:
     //! Indicates what 'mode' this object is in (what type of inherited class).
     uint8_t _mode_type;
 
+    /** \brief Makes the game mode wait for a job before being put on the stack.
+    *** The job can load the resources not needing the OpenGL context or the Lua state
+    *** while the previous game mode fades out.
+    **/
+    void _AddLoadingJob(const vt_system::JobHandle& job) {
+        _loading_jobs.push_back(job);
+    }
+
 private:
+    /** \brief The memory of the objects living as long as the game mode.
+    *** Declared first, so that it is freed after the other members.
+    **/
+    MemoryArena _memory_arena;
+
+    //! \brief The jobs to wait for before putting the game mode on the stack.
+    std::vector<vt_system::JobHandle> _loading_jobs;
+
+    //! \brief The script global tables owned by the game mode.
+    std::vector<std::string> _script_tablespaces;
+
+    //! \brief The texture atlases loaded by the game mode.
+    std::vector<std::string> _texture_atlases;
+
     //! \brief Handles all the custom scripted animation for the given mode.
     ScriptSupervisor _script_supervisor;
 
@@ -189,8 +272,22 @@ private:
     std::vector<GameMode *> _game_stack;
 
     //! A vector of game modes to push to the stack on the next call to ModeEngine#Update().
+    //! The game modes pushed as a factory are nullptr until built.
     std::vector<GameMode *> _push_stack;
 
+    //! The factories of the game modes pushed as such, empty for the others. Same size as the push stack.
+    std::vector<std::function<GameMode *()> > _push_factories;
+
+    //! The jobs each factory waits for before being called. Same size as the push stack.
+    std::vector<std::vector<vt_system::JobHandle> > _push_loading_jobs;
+
+    //! \brief Whether the pushed game modes are still loading, and their average progress.
+    bool _loading;
+    float _loading_progress;
+
+    //! \brief Draws the loading progress, while the pushed game modes are loading.
+    std::function<void(float)> _loading_indicator;
+
     //! True if a state change occured and we need to change the active game mode.
     bool _state_change;
 
@@ -211,6 +308,12 @@ private:
     //! \brief A window showing help according to the current game mode.
     HelpWindow *_help_window;
 
+    /** \brief Builds the game modes pushed as factories, and continues loading the pushed game modes.
+    *** \param faded_out Whether the fade out was already finished on the previous update.
+    *** \return True once all the pushed game modes are loaded.
+    **/
+    bool _UpdatePushedModesLoading(bool faded_out);
+
 public:
     ~ModeEngine();
 
@@ -239,6 +342,42 @@ public:
     **/
     void Push(GameMode *gm, bool fade_out = false, bool fade_in = false);
 
+    /** \brief Pushes a new GameMode object built once the fade out is done.
+    *** \param mode_factory The function creating the game mode, or returning nullptr on failure.
+    *** \param fade_out Tells whether a fade out should be processed before adding the game mode
+    *** \param fade_in Tells whether a fade in should be processed after the fade in effect
+    *** \note Game modes slow to create should be pushed this way, so that their
+    *** construction doesn't freeze the fade out.
+    **/
+    void Push(const std::function<GameMode *()>& mode_factory, bool fade_out = false, bool fade_in = false);
+
+    /** \brief Pushes a new GameMode object built once the fade out is done and its loading jobs are.
+    *** \param mode_factory The function creating the game mode, or returning nullptr on failure.
+    *** \param loading_jobs The jobs loading what the game mode needs without the OpenGL context
+    *** or the Lua state, started at push time so that they run during the fade out.
+    *** \param fade_out Tells whether a fade out should be processed before adding the game mode
+    *** \param fade_in Tells whether a fade in should be processed after the fade in effect
+    **/
+    void Push(const std::function<GameMode *()>& mode_factory, const std::vector<vt_system::JobHandle>& loading_jobs,
+              bool fade_out = false, bool fade_in = false);
+
+    /** \brief Sets the function drawing the loading progress, from 0.0f to 1.0f, while the
+    *** pushed game modes are loading once faded out. A progress bar is drawn by default.
+    **/
+    void SetLoadingIndicator(const std::function<void(float)>& loading_indicator) {
+        _loading_indicator = loading_indicator;
+    }
+
+    //! \brief Tells whether pushed game modes are still loading.
+    bool IsLoading() const {
+        return _loading;
+    }
+
+    /** \brief Tells whether the screen is still, only changing on user input.
+    *** This is the case when the active game mode is idle, and no game mode change nor fade is on its way.
+    **/
+    bool IsIdle() const;
+
     /**  \brief  Gets the type of the currently active game mode.
     ***  \return The value of the mode_type member of the GameMode object on the top of the stack.
     **/
@@ -271,6 +410,9 @@ public:
     //! \brief Calls the DrawPostEffects() function on the active game mode.
     void DrawPostEffects();
 
+    //! \brief Draws the loading indicator over the fade, while the pushed game modes are loading.
+    void DrawLoadingIndicator();
+
     //! \brief give the help window pointer, permitting to use it anytime.
     HelpWindow *GetHelpWindow() {
         return _help_window;
@@ -0,0 +1,296 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    performance_telemetry.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for gathering the game performance while playing.
+*** ***************************************************************************/
+
+#include "engine/performance_telemetry.h"
+
+#include "engine/job_system.h"
+#include "engine/memory_stats.h"
+#include "engine/mode_manager.h"
+#include "engine/system.h"
+#include "engine/video/video.h"
+
+#include "common/app_settings.h"
+
+#include "utils/utils_common.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace vt_system
+{
+
+bool PerformanceTelemetry::_enabled = false;
+
+namespace
+{
+
+//! \brief The time between two checks of the place shown, and of the memory used there, in milliseconds.
+const uint32_t TELEMETRY_PLACE_INTERVAL = 1000;
+
+//! \brief The frame durations of a game mode and place.
+class FrameHistogram
+{
+public:
+    FrameHistogram() :
+        frame_count(0),
+        total_time(0.0),
+        max_time(0.0f),
+        peak_memory(0)
+    {
+        std::fill(buckets, buckets + TELEMETRY_FRAME_BUCKET_COUNT, 0);
+    }
+
+    uint32_t buckets[TELEMETRY_FRAME_BUCKET_COUNT];
+    uint32_t frame_count;
+
+    //! \brief The frames total and longest durations, in milliseconds.
+    double total_time;
+    float max_time;
+
+    //! \brief The most memory used by the accounted subsystems there, in bytes.
+    int64_t peak_memory;
+};
+
+//! \brief The durations of a kind of loading of something.
+class LoadingDurations
+{
+public:
+    LoadingDurations() :
+        count(0),
+        total_time(0.0),
+        max_time(0.0f)
+    {}
+
+    uint32_t count;
+
+    //! \brief The total and longest durations, in milliseconds.
+    double total_time;
+    float max_time;
+};
+
+//! \brief The frame histograms, by game mode name and description.
+std::map<std::string, FrameHistogram> histograms;
+
+//! \brief The loading durations, by category and name.
+std::map<std::pair<std::string, std::string>, LoadingDurations> durations;
+
+//! \brief The game mode counted last, and its histogram, looked up again when it changes.
+vt_mode_manager::GameMode* current_mode = nullptr;
+FrameHistogram* current_histogram = nullptr;
+
+//! \brief The ticks when the place was last checked, and when the file was last written.
+uint32_t last_place_ticks = 0;
+uint32_t last_write_ticks = 0;
+
+//! \brief Writes a string as a JSON one, escaping the characters which need it.
+void WriteJSONString(std::ostream& stream, const std::string& text)
+{
+    stream << "\"";
+    for(uint32_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if(c == '"' || c == '\\')
+            stream << "\\" << c;
+        else if(static_cast<unsigned char>(c) < 0x20)
+            stream << " ";
+        else
+            stream << c;
+    }
+    stream << "\"";
+}
+
+//! \brief Returns the histogram of the game mode shown, and the place it shows.
+FrameHistogram* GetHistogram(vt_mode_manager::GameMode* mode)
+{
+    if(mode == nullptr)
+        return &histograms["none"];
+
+    std::string key = vt_mode_manager::GetGameModeName(mode->GetGameType());
+    const std::string description = mode->GetReportDescription();
+    if(!description.empty())
+        key += ": " + description;
+    return &histograms[key];
+}
+
+} // namespace
+
+void PerformanceTelemetry::SetEnabled(bool enabled)
+{
+    if(_enabled == enabled)
+        return;
+
+    // Write what was gathered, the game exiting being no longer waited for.
+    if(!enabled)
+        Write(true);
+
+    _enabled = enabled;
+    current_mode = nullptr;
+    current_histogram = nullptr;
+    last_write_ticks = SDL_GetTicks();
+}
+
+void PerformanceTelemetry::EndFrame(float frame_time)
+{
+    if(!_enabled)
+        return;
+
+    // The place is looked up only when the game mode changed, or from time to time,
+    // as a game mode may load another place, like the maps do.
+    vt_mode_manager::GameMode* mode = vt_mode_manager::ModeManager->GetTop();
+    const uint32_t ticks = SDL_GetTicks();
+    const bool check_place = ticks - last_place_ticks >= TELEMETRY_PLACE_INTERVAL;
+    if(mode != current_mode || current_histogram == nullptr || check_place) {
+        current_mode = mode;
+        current_histogram = GetHistogram(mode);
+    }
+
+    // The loading frames and the still screens, throttled on purpose, aren't the place ones.
+    if(vt_mode_manager::ModeManager->IsLoading() || SystemManager->GetFramePacer().IsThrottled())
+        return;
+
+    FrameHistogram& histogram = *current_histogram;
+    uint32_t bucket = 0;
+    while(bucket < TELEMETRY_FRAME_BUCKET_COUNT - 1 && frame_time > TELEMETRY_FRAME_BUCKET_BOUNDS[bucket])
+        ++bucket;
+    ++histogram.buckets[bucket];
+    ++histogram.frame_count;
+    histogram.total_time += frame_time;
+    histogram.max_time = std::max(histogram.max_time, frame_time);
+
+    if(check_place) {
+        last_place_ticks = ticks;
+        histogram.peak_memory = std::max(histogram.peak_memory, MemoryStats::GetTotalUsed());
+    }
+
+    if(ticks - last_write_ticks >= TELEMETRY_WRITE_INTERVAL) {
+        last_write_ticks = ticks;
+        Write(true);
+    }
+}
+
+void PerformanceTelemetry::AddDuration(const std::string& category, const std::string& name, float duration)
+{
+    if(!_enabled)
+        return;
+
+    LoadingDurations& loading = durations[std::make_pair(category, name)];
+    ++loading.count;
+    loading.total_time += duration;
+    loading.max_time = std::max(loading.max_time, duration);
+}
+
+void PerformanceTelemetry::Write(bool in_background)
+{
+    if(!_enabled)
+        return;
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+
+    json << "{" << std::endl
+         << "  \"date\": " << static_cast<int64_t>(std::time(nullptr)) << "," << std::endl
+         << "  \"screen\": \"" << vt_video::VideoManager->GetScreenWidth() << "x"
+         << vt_video::VideoManager->GetScreenHeight() << "\"," << std::endl
+         << "  \"graphics_quality\": " << vt_video::VideoManager->GetGraphicsQuality() << "," << std::endl;
+
+    json << "  \"frame_bucket_bounds_ms\": [ ";
+    for(uint32_t i = 0; i < TELEMETRY_FRAME_BUCKET_COUNT - 1; ++i)
+        json << (i > 0 ? ", " : "") << TELEMETRY_FRAME_BUCKET_BOUNDS[i];
+    json << " ]," << std::endl;
+
+    json << "  \"places\": [";
+    for(std::map<std::string, FrameHistogram>::const_iterator it = histograms.begin(); it != histograms.end(); ++it) {
+        const FrameHistogram& histogram = it->second;
+        if(histogram.frame_count == 0)
+            continue;
+
+        json << (it == histograms.begin() ? "" : ",") << std::endl << "    { \"place\": ";
+        WriteJSONString(json, it->first);
+        json << ", \"frames\": " << histogram.frame_count
+             << ", \"avg_ms\": " << histogram.total_time / histogram.frame_count
+             << ", \"max_ms\": " << histogram.max_time
+             << ", \"peak_memory_bytes\": " << histogram.peak_memory
+             << ", \"buckets\": [ ";
+        for(uint32_t i = 0; i < TELEMETRY_FRAME_BUCKET_COUNT; ++i)
+            json << (i > 0 ? ", " : "") << histogram.buckets[i];
+        json << " ] }";
+    }
+    json << std::endl << "  ]," << std::endl;
+
+    json << "  \"loadings\": [";
+    typedef std::map<std::pair<std::string, std::string>, LoadingDurations>::const_iterator DurationIterator;
+    for(DurationIterator it = durations.begin(); it != durations.end(); ++it) {
+        const LoadingDurations& loading = it->second;
+        json << (it == durations.begin() ? "" : ",") << std::endl << "    { \"category\": ";
+        WriteJSONString(json, it->first.first);
+        json << ", \"name\": ";
+        WriteJSONString(json, it->first.second);
+        json << ", \"count\": " << loading.count
+             << ", \"avg_ms\": " << loading.total_time / loading.count
+             << ", \"max_ms\": " << loading.max_time << " }";
+    }
+    json << std::endl << "  ]," << std::endl;
+
+    json << "  \"memory_high_water_bytes\": { ";
+    for(uint32_t i = 0; i < MEMORY_TAG_TOTAL; ++i) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        json << "\"" << GetMemoryTagName(tag) << "\": " << MemoryStats::GetHighWater(tag) << ", ";
+    }
+    json << "\"total\": " << MemoryStats::GetTotalHighWater() << " }" << std::endl << "}" << std::endl;
+
+    const std::string filename = vt_common::GetUserDataPath() + "performance_telemetry.json";
+    const std::string text = json.str();
+    const std::function<void()> write_file = [filename, text]() {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+        file << text;
+        file.close();
+        if(file.fail())
+            PRINT_WARNING << "Couldn't write the performance telemetry file: " << filename << std::endl;
+    };
+
+    if(in_background)
+        JobManager->Schedule(write_file);
+    else
+        write_file();
+}
+
+TelemetryTimer::TelemetryTimer(const char* category, const std::string& name) :
+    _category(category),
+    _start(0)
+{
+    if(!PerformanceTelemetry::IsEnabled())
+        return;
+
+    _name = name;
+    _start = SDL_GetPerformanceCounter();
+}
+
+TelemetryTimer::~TelemetryTimer()
+{
+    if(_start == 0)
+        return;
+
+    const float duration = static_cast<float>(SDL_GetPerformanceCounter() - _start) * 1000.0f /
+                           static_cast<float>(SDL_GetPerformanceFrequency());
+    PerformanceTelemetry::AddDuration(_category, _name, duration);
+}
+
+} // namespace vt_system
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    performance_telemetry.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for gathering the game performance while playing.
+***
+*** When the player enables it in the performance options, the frame durations
+*** are counted in a histogram per game mode and place, like the map files or
+*** the battle enemies, along with the peak memory used there. The map loads,
+*** battle starts, saves and loads are timed as well.
+***
+*** The figures are written to performance_telemetry.json in the user data
+*** folder every minute and when the game exits. Nothing is sent anywhere: The
+*** player may choose to share the file.
+*** ***************************************************************************/
+
+#ifndef __PERFORMANCE_TELEMETRY_HEADER__
+#define __PERFORMANCE_TELEMETRY_HEADER__
+
+#include <cstdint>
+#include <string>
+
+namespace vt_system
+{
+
+//! \brief The frame duration histogram buckets upper bounds, in milliseconds, the last bucket having none.
+const uint32_t TELEMETRY_FRAME_BUCKET_BOUNDS[] = { 8, 12, 17, 20, 25, 34, 50, 100 };
+const uint32_t TELEMETRY_FRAME_BUCKET_COUNT = sizeof(TELEMETRY_FRAME_BUCKET_BOUNDS) / sizeof(TELEMETRY_FRAME_BUCKET_BOUNDS[0]) + 1;
+
+//! \brief The time between two writes of the telemetry file, in milliseconds.
+const uint32_t TELEMETRY_WRITE_INTERVAL = 60000;
+
+/** ****************************************************************************
+*** \brief Gathers the frame durations, the loading times and the peak memory.
+***
+*** \note Must be used by the main thread only.
+*** ***************************************************************************/
+class PerformanceTelemetry
+{
+public:
+    //! \brief Starts or stops gathering. The figures already gathered are written when stopping.
+    static void SetEnabled(bool enabled);
+
+    static bool IsEnabled() {
+        return _enabled;
+    }
+
+    /** \brief Counts the frame which just ended, and writes the file from time to time.
+    *** \param frame_time The frame duration, in milliseconds.
+    **/
+    static void EndFrame(float frame_time);
+
+    /** \brief Counts a loading duration.
+    *** \param category The kind of loading, like "map_load".
+    *** \param name What was loaded, like the map file.
+    *** \param duration The loading duration, in milliseconds.
+    **/
+    static void AddDuration(const std::string& category, const std::string& name, float duration);
+
+    /** \brief Writes the figures gathered so far to the telemetry file.
+    *** \param in_background Whether a worker job writes the file, so that the frame doesn't wait for it.
+    **/
+    static void Write(bool in_background);
+
+private:
+    static bool _enabled;
+};
+
+/** ****************************************************************************
+*** \brief Times a loading for the telemetry, from its creation to its destruction.
+***
+*** Nothing is timed unless the telemetry is enabled.
+*** ***************************************************************************/
+class TelemetryTimer
+{
+public:
+    //! \param category The kind of loading. Must be a string literal.
+    //! \param name What is loaded.
+    TelemetryTimer(const char* category, const std::string& name);
+
+    ~TelemetryTimer();
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    TelemetryTimer(const TelemetryTimer& timer);
+    TelemetryTimer& operator=(const TelemetryTimer& timer);
+
+    const char* _category;
+    std::string _name;
+
+    //! \brief The performance counter at creation, 0 when the telemetry is disabled.
+    uint64_t _start;
+};
+
+} // namespace vt_system
+
+#endif // __PERFORMANCE_TELEMETRY_HEADER__
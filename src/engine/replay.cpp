@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    replay.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for recording and replaying game sessions.
+*** ***************************************************************************/
+
+#include "engine/replay.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace vt_system
+{
+
+//! \brief The magic at the start of the replay files.
+const char REPLAY_MAGIC[4] = { 'V', 'T', 'R', 'P' };
+
+//! \brief The most events a replayed frame can have, to detect the corrupted files.
+const uint32_t REPLAY_MAX_FRAME_EVENTS = 4096;
+
+template <typename T>
+static void _WriteValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool _ReadValue(std::ifstream& file, T& value)
+{
+    file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return file.good();
+}
+
+Replay::Replay() :
+    _recording(false),
+    _replaying(false),
+    _fast(false),
+    _random_seed(0),
+    _frame_started(false),
+    _frame_update_time(0),
+    _last_frame_counter(0)
+{
+}
+
+Replay::~Replay()
+{
+    Stop();
+}
+
+bool Replay::StartRecording(const std::string& filename, uint64_t random_seed)
+{
+    Stop();
+
+    _record_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!_record_file.is_open()) {
+        PRINT_ERROR << "Couldn't open the replay file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    _filename = filename;
+    _random_seed = random_seed;
+    _record_file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    _WriteValue(_record_file, REPLAY_VERSION);
+    _WriteValue(_record_file, static_cast<uint16_t>(sizeof(SDL_Event)));
+    _WriteValue(_record_file, _random_seed);
+
+    _recording = true;
+    _frame_started = false;
+    _frame_events.clear();
+    return true;
+}
+
+bool Replay::StartReplaying(const std::string& filename, bool fast)
+{
+    Stop();
+
+    _replay_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!_replay_file.is_open()) {
+        PRINT_ERROR << "Couldn't open the replay file: " << filename << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(REPLAY_MAGIC)];
+    uint16_t version = 0;
+    uint16_t event_size = 0;
+    _replay_file.read(magic, sizeof(magic));
+    if (!_replay_file.good() || memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 ||
+            !_ReadValue(_replay_file, version) || !_ReadValue(_replay_file, event_size) ||
+            !_ReadValue(_replay_file, _random_seed)) {
+        PRINT_ERROR << "Not a replay file: " << filename << std::endl;
+        _replay_file.close();
+        return false;
+    }
+
+    if (version != REPLAY_VERSION || event_size != sizeof(SDL_Event)) {
+        PRINT_ERROR << "The replay file wasn't recorded by this game version: " << filename << std::endl;
+        _replay_file.close();
+        return false;
+    }
+
+    _filename = filename;
+    _replaying = true;
+    _fast = fast;
+    _frame_events.clear();
+    _frame_times.clear();
+    _last_frame_counter = 0;
+    return true;
+}
+
+void Replay::Stop()
+{
+    if (_recording) {
+        if (_frame_started)
+            _WriteFrame();
+        _record_file.close();
+        if (_record_file.fail())
+            PRINT_ERROR << "Couldn't write the replay file: " << _filename << std::endl;
+        _recording = false;
+    }
+
+    if (_replaying) {
+        _replay_file.close();
+        _replaying = false;
+        _PrintFrameTimes();
+    }
+
+    _frame_started = false;
+    _frame_events.clear();
+}
+
+void Replay::RecordFrame(uint32_t update_time)
+{
+    if (!_recording)
+        return;
+
+    if (_frame_started)
+        _WriteFrame();
+
+    _frame_started = true;
+    _frame_update_time = update_time;
+    _frame_events.clear();
+}
+
+void Replay::RecordEvent(const SDL_Event& event)
+{
+    // The events before the first frame are part of it.
+    if (_recording)
+        _frame_events.push_back(event);
+}
+
+bool Replay::ReadFrame(uint32_t& update_time)
+{
+    if (!_replaying)
+        return false;
+
+    // The time spent since the previous frame was read is the one of the previous frame.
+    const uint64_t counter = SDL_GetPerformanceCounter();
+    if (_last_frame_counter > 0) {
+        _frame_times.push_back(static_cast<float>(counter - _last_frame_counter) * 1000.0f /
+                               static_cast<float>(SDL_GetPerformanceFrequency()));
+    }
+    _last_frame_counter = counter;
+
+    _frame_events.clear();
+
+    uint32_t event_count = 0;
+    if (!_ReadValue(_replay_file, update_time) || !_ReadValue(_replay_file, event_count) ||
+            event_count > REPLAY_MAX_FRAME_EVENTS) {
+        if (!_replay_file.eof())
+            PRINT_ERROR << "Corrupted replay file: " << _filename << std::endl;
+        Stop();
+        return false;
+    }
+
+    _frame_events.resize(event_count);
+    for (uint32_t i = 0; i < event_count; ++i) {
+        if (!_ReadValue(_replay_file, _frame_events[i])) {
+            PRINT_ERROR << "Truncated replay file: " << _filename << std::endl;
+            Stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void Replay::_WriteFrame()
+{
+    _WriteValue(_record_file, _frame_update_time);
+    _WriteValue(_record_file, static_cast<uint32_t>(_frame_events.size()));
+    for (uint32_t i = 0; i < _frame_events.size(); ++i)
+        _WriteValue(_record_file, _frame_events[i]);
+}
+
+void Replay::_PrintFrameTimes()
+{
+    if (_frame_times.empty())
+        return;
+
+    float total = 0.0f;
+    for (uint32_t i = 0; i < _frame_times.size(); ++i)
+        total += _frame_times[i];
+
+    std::vector<float> frame_times(_frame_times);
+    std::sort(frame_times.begin(), frame_times.end());
+
+    std::cout << "Replayed " << frame_times.size() << " frames in " << total / 1000.0f
+              << " seconds (" << (_fast ? "as fast as possible" : "real time") << ")." << std::endl
+              << "Frame times in milliseconds: average " << total / frame_times.size()
+              << ", median " << frame_times[frame_times.size() / 2]
+              << ", 95% " << frame_times[frame_times.size() * 95 / 100]
+              << ", 99% " << frame_times[frame_times.size() * 99 / 100]
+              << ", max " << frame_times.back() << std::endl;
+}
+
+Replay::Replay(const Replay&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+Replay& Replay::operator=(const Replay&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_system
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    replay.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for recording and replaying game sessions.
+***
+*** A replay holds the random seed of the session, then the update time and
+*** the input events of each frame. Replaying it feeds the game the same
+*** update times and events, so that the game logic goes through the same
+*** states, and measures the real time of each frame to give a repeatable
+*** frame time profile.
+***
+*** The file starts with the "VTRP" magic, the format version (2 bytes), the
+*** size of the SDL events (2 bytes) and the random seed (8 bytes). Each frame
+*** is then its update time (4 bytes), its event count (4 bytes) and its raw
+*** events, all in the native byte order: The replays are meant to be played
+*** by the game binary which recorded them.
+***
+*** \note What doesn't depend on the update time, the input or the random
+*** seed isn't replayed: The audio streaming, the background threads, and
+*** the Lua random numbers unless the scripts seed them from the game.
+*** ***************************************************************************/
+
+#ifndef __REPLAY_HEADER__
+#define __REPLAY_HEADER__
+
+#include <SDL2/SDL_events.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace vt_system
+{
+
+//! \brief The version of the replay files written.
+const uint16_t REPLAY_VERSION = 1;
+
+/** ****************************************************************************
+*** \brief Records or replays the update times and the input events of a session.
+***
+*** The system engine reports each update through it, and the input engine
+*** each event it handles.
+*** ***************************************************************************/
+class Replay
+{
+public:
+    Replay();
+
+    //! \brief Stops recording or replaying.
+    ~Replay();
+
+    /** \brief Starts recording a session into a file.
+    *** \param random_seed The random seed the session starts with.
+    *** \return False if the file couldn't be opened.
+    **/
+    bool StartRecording(const std::string& filename, uint64_t random_seed);
+
+    /** \brief Starts replaying a session from a file.
+    *** \param fast Whether the frames are played as fast as possible instead of in real time.
+    *** \return False if the file couldn't be opened, or isn't a replay of this game binary.
+    **/
+    bool StartReplaying(const std::string& filename, bool fast);
+
+    /** \brief Stops recording or replaying.
+    *** The frame time profile is printed once a replay is stopped.
+    **/
+    void Stop();
+
+    bool IsRecording() const {
+        return _recording;
+    }
+
+    bool IsReplaying() const {
+        return _replaying;
+    }
+
+    //! \brief Whether the replay is played as fast as possible.
+    bool IsFast() const {
+        return _replaying && _fast;
+    }
+
+    //! \brief The random seed the replayed session started with.
+    uint64_t GetRandomSeed() const {
+        return _random_seed;
+    }
+
+    //! \brief Records the update time of a new frame, the previous one being written.
+    void RecordFrame(uint32_t update_time);
+
+    /** \brief Reads the update time and the events of the next replayed frame.
+    *** \return False once all the frames are replayed, the replay being stopped.
+    **/
+    bool ReadFrame(uint32_t& update_time);
+
+    //! \brief Records an input event of the current frame.
+    void RecordEvent(const SDL_Event& event);
+
+    //! \brief The input events of the replayed frame.
+    const std::vector<SDL_Event>& GetFrameEvents() const {
+        return _frame_events;
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    Replay(const Replay& replay);
+    Replay& operator=(const Replay& replay);
+
+    std::string _filename;
+
+    std::ofstream _record_file;
+    std::ifstream _replay_file;
+
+    bool _recording;
+    bool _replaying;
+    bool _fast;
+
+    uint64_t _random_seed;
+
+    //! \brief The current frame, written once the next one starts when recording.
+    //@{
+    bool _frame_started;
+    uint32_t _frame_update_time;
+    std::vector<SDL_Event> _frame_events;
+    //@}
+
+    //! \brief The performance counter when the last replayed frame was read.
+    uint64_t _last_frame_counter;
+
+    //! \brief The real time of each replayed frame, in milliseconds.
+    std::vector<float> _frame_times;
+
+    //! \brief Writes the current frame to the record file.
+    void _WriteFrame();
+
+    //! \brief Prints the average and the percentiles of the replayed frame times.
+    void _PrintFrameTimes();
+};
+
+} // namespace vt_system
+
+#endif // __REPLAY_HEADER__
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    script_array.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for reading the Lua arrays given to the batched bindings.
+*** ***************************************************************************/
+
+#include "engine/script_array.h"
+
+namespace vt_system
+{
+
+ScriptArray::ScriptArray(const luabind::object& table) :
+    _state(nullptr),
+    _stack_index(0),
+    _size(0)
+{
+    if(!table.is_valid() || luabind::type(table) != LUA_TTABLE)
+        return;
+
+    _state = table.interpreter();
+    table.push(_state);
+    _stack_index = lua_gettop(_state);
+
+    // The array ends at the first nil element, as with the # operator.
+    while(true) {
+        lua_rawgeti(_state, _stack_index, _size + 1);
+        const bool is_nil = lua_isnil(_state, -1);
+        lua_pop(_state, 1);
+        if(is_nil)
+            break;
+        ++_size;
+    }
+}
+
+ScriptArray::~ScriptArray()
+{
+    if(_state)
+        lua_remove(_state, _stack_index);
+}
+
+bool ScriptArray::IsNumber(uint32_t index) const
+{
+    if(index >= _size)
+        return false;
+
+    lua_rawgeti(_state, _stack_index, index + 1);
+    const bool is_number = lua_type(_state, -1) == LUA_TNUMBER;
+    lua_pop(_state, 1);
+    return is_number;
+}
+
+float ScriptArray::GetNumber(uint32_t index) const
+{
+    if(index >= _size)
+        return 0.0f;
+
+    lua_rawgeti(_state, _stack_index, index + 1);
+    const float number = lua_type(_state, -1) == LUA_TNUMBER ? static_cast<float>(lua_tonumber(_state, -1)) : 0.0f;
+    lua_pop(_state, 1);
+    return number;
+}
+
+} // namespace vt_system
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    script_array.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for reading the Lua arrays given to the batched bindings.
+***
+*** The batched bindings, like MapMode:SetObjectsPosition() or
+*** ScriptSupervisor:DrawImages(), take a whole Lua array in one call, so that a
+*** script moving dozens of sprites or drawing dozens of images crosses into
+*** C++ once. The array elements are read with the raw Lua API: Only the bound
+*** objects, like the sprites, go through a luabind conversion.
+*** ***************************************************************************/
+
+#ifndef __SCRIPT_ARRAY_HEADER__
+#define __SCRIPT_ARRAY_HEADER__
+
+#include "script/script.h"
+
+namespace vt_system
+{
+
+/** ****************************************************************************
+*** \brief Reads the elements of a Lua array, from 0 to its size.
+***
+*** The array stays pushed on the Lua stack while the reader exists.
+*** Anything but a table is read as an empty array.
+*** ***************************************************************************/
+class ScriptArray
+{
+public:
+    explicit ScriptArray(const luabind::object& table);
+
+    ~ScriptArray();
+
+    //! \brief Returns the number of elements, up to the first nil one.
+    uint32_t GetSize() const {
+        return _size;
+    }
+
+    bool IsNumber(uint32_t index) const;
+
+    //! \brief Returns the element as a number, or 0 when it isn't one.
+    float GetNumber(uint32_t index) const;
+
+    //! \brief Returns the element as a bound C++ object, or nullptr when it isn't one.
+    template <typename T> T* GetPointer(uint32_t index) const;
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ScriptArray(const ScriptArray& array);
+    ScriptArray& operator=(const ScriptArray& array);
+
+    //! \brief The Lua state, and the array stack index, nullptr when not a table.
+    lua_State* _state;
+    int32_t _stack_index;
+
+    uint32_t _size;
+};
+
+template <typename T> T* ScriptArray::GetPointer(uint32_t index) const
+{
+    if(index >= _size)
+        return nullptr;
+
+    lua_rawgeti(_state, _stack_index, index + 1);
+    luabind::object element(luabind::from_stack(_state, -1));
+    lua_pop(_state, 1);
+
+    try {
+        return luabind::object_cast<T*>(element);
+    } catch(const luabind::cast_failed&) {
+        return nullptr;
+    }
+}
+
+} // namespace vt_system
+
+#endif // __SCRIPT_ARRAY_HEADER__
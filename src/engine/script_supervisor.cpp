@@ -15,11 +15,118 @@
 
 #include "engine/script_supervisor.h"
 
+#include "engine/frame_profiler.h"
 #include "engine/mode_manager.h"
+#include "engine/script_array.h"
+#include "engine/system.h"
 
+#include "common/script_call_profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vt_utils;
 using namespace vt_video;
 using namespace vt_script;
 
+ScriptLayer::ScriptLayer(ImageDescriptor* image, SCRIPT_LAYER_STAGE stage) :
+    _image(image),
+    _stage(stage),
+    _x(0.0f),
+    _y(0.0f),
+    _x_offset(0.0f),
+    _y_offset(0.0f),
+    _x_velocity(0.0f),
+    _y_velocity(0.0f),
+    _wrap_width(0.0f),
+    _wrap_height(0.0f),
+    _blend_flags(VIDEO_BLEND),
+    _color(Color::white),
+    _first_color(Color::white),
+    _second_color(Color::white),
+    _color_period(0),
+    _color_time(0),
+    _visible(true)
+{
+}
+
+void ScriptLayer::SetWrapSize(float width, float height)
+{
+    _wrap_width = std::max(0.0f, width);
+    _wrap_height = std::max(0.0f, height);
+}
+
+void ScriptLayer::SetBlendMode(int32_t blend_mode)
+{
+    if(blend_mode != VIDEO_NO_BLEND && blend_mode != VIDEO_BLEND && blend_mode != VIDEO_BLEND_ADD) {
+        PRINT_WARNING << "Invalid layer blend mode: " << blend_mode << std::endl;
+        return;
+    }
+    _blend_flags = DrawFlags(static_cast<VIDEO_DRAW_FLAGS>(blend_mode));
+}
+
+void ScriptLayer::SetColorAnimation(const Color& first_color, const Color& second_color, uint32_t period)
+{
+    _first_color = first_color;
+    _second_color = second_color;
+    _color = first_color;
+    _color_period = period;
+    _color_time = 0;
+}
+
+void ScriptLayer::Update(uint32_t elapsed_time)
+{
+    const float elapsed_seconds = static_cast<float>(elapsed_time) / 1000.0f;
+    _x_offset += _x_velocity * elapsed_seconds;
+    _y_offset += _y_velocity * elapsed_seconds;
+
+    // Keep the offsets within one period, so that they never lose precision.
+    if(_wrap_width > 0.0f) {
+        _x_offset = std::fmod(_x_offset, _wrap_width);
+        if(_x_offset < 0.0f)
+            _x_offset += _wrap_width;
+    }
+    if(_wrap_height > 0.0f) {
+        _y_offset = std::fmod(_y_offset, _wrap_height);
+        if(_y_offset < 0.0f)
+            _y_offset += _wrap_height;
+    }
+
+    if(_color_period == 0)
+        return;
+
+    // Go to the second color, and back.
+    _color_time = (_color_time + elapsed_time) % (2 * _color_period);
+    float ratio = static_cast<float>(_color_time) / static_cast<float>(_color_period);
+    if(ratio > 1.0f)
+        ratio = 2.0f - ratio;
+    for(uint32_t i = 0; i < 4; ++i)
+        _color[i] = Lerp(ratio, _first_color[i], _second_color[i]);
+}
+
+void ScriptLayer::Draw() const
+{
+    VideoManager->SetDrawFlags(_blend_flags);
+
+    const float x = _x + _x_offset;
+    const float y = _y + _y_offset;
+    VideoManager->Move(x, y);
+    _image->Draw(_color);
+
+    if(_wrap_width > 0.0f) {
+        VideoManager->Move(x - _wrap_width, y);
+        _image->Draw(_color);
+    }
+    if(_wrap_height > 0.0f) {
+        VideoManager->Move(x, y - _wrap_height);
+        _image->Draw(_color);
+    }
+    if(_wrap_width > 0.0f && _wrap_height > 0.0f) {
+        VideoManager->Move(x - _wrap_width, y - _wrap_height);
+        _image->Draw(_color);
+    }
+}
+
 ScriptSupervisor::~ScriptSupervisor()
 {
     // Free the created images before destruction.
@@ -29,6 +136,8 @@ ScriptSupervisor::~ScriptSupervisor()
         delete _still_images[i];
     for(uint32_t i = 0; i < _animated_images.size(); ++i)
         delete _animated_images[i];
+    for(uint32_t i = 0; i < _layers.size(); ++i)
+        delete _layers[i];
 
     // Free every luabind object pointers before freeing the scripts,
     // so that no object may trigger a segmentation fault
@@ -37,6 +146,7 @@ ScriptSupervisor::~ScriptSupervisor()
     _restart_functions.clear();
     _update_functions.clear();
     _draw_background_functions.clear();
+    _draw_static_background_functions.clear();
     _draw_foreground_functions.clear();
     _draw_post_effects_functions.clear();
 
@@ -53,6 +163,8 @@ void ScriptSupervisor::Initialize(vt_mode_manager::GameMode *gm)
         // Clears out old script data
         std::string tablespace = ScriptEngine::GetTableSpace(_script_filenames[i]);
         ScriptManager->DropGlobalTable(tablespace);
+        if(gm)
+            gm->OwnScriptTablespace(tablespace);
 
         ReadScriptDescriptor* scene_script = new ReadScriptDescriptor();
         if(!scene_script->OpenFile(_script_filenames[i])) {
@@ -72,6 +184,7 @@ void ScriptSupervisor::Initialize(vt_mode_manager::GameMode *gm)
         _restart_functions.push_back(scene_script->ReadFunctionPointer("Restart"));
         _update_functions.push_back(scene_script->ReadFunctionPointer("Update"));
         _draw_background_functions.push_back(scene_script->ReadFunctionPointer("DrawBackground"));
+        _draw_static_background_functions.push_back(scene_script->ReadFunctionPointer("DrawStaticBackground"));
         _draw_foreground_functions.push_back(scene_script->ReadFunctionPointer("DrawForeground"));
         _draw_post_effects_functions.push_back(scene_script->ReadFunctionPointer("DrawPostEffects"));
 
@@ -80,9 +193,10 @@ void ScriptSupervisor::Initialize(vt_mode_manager::GameMode *gm)
 
         // Trigger the Initialize functions in the loading order.
         luabind::object init_function = scene_script->ReadFunctionPointer("Initialize");
-        if(init_function.is_valid() && gm)
+        if(init_function.is_valid() && gm) {
+            vt_common::ScriptCallTimer timer("scene Initialize", init_function);
             luabind::call_function<void>(init_function, gm);
-        else
+        } else
             PRINT_ERROR << "Couldn't initialize the scene component" << std::endl; // Should never happen
     }
 }
@@ -95,41 +209,159 @@ void ScriptSupervisor::SetDrawFlag(vt_video::VIDEO_DRAW_FLAGS draw_flag)
 void ScriptSupervisor::Reset()
 {
     // Updates custom scripts
-    for(uint32_t i = 0; i < _reset_functions.size(); ++i)
+    for(uint32_t i = 0; i < _reset_functions.size(); ++i) {
+        vt_common::ScriptCallTimer timer("scene Reset", _reset_functions[i]);
         ReadScriptDescriptor::RunScriptObject(_reset_functions[i]);
+    }
 }
 
 void ScriptSupervisor::Restart()
 {
     // Updates custom scripts
-    for(uint32_t i = 0; i < _restart_functions.size(); ++i)
+    for(uint32_t i = 0; i < _restart_functions.size(); ++i) {
+        vt_common::ScriptCallTimer timer("scene Restart", _restart_functions[i]);
         ReadScriptDescriptor::RunScriptObject(_restart_functions[i]);
+    }
 }
 
 void ScriptSupervisor::Update()
 {
+    PROFILE_SCOPE("ScriptSupervisor::Update");
+
+    // Updates the layers natively
+    const uint32_t elapsed_time = vt_system::SystemManager->GetUpdateTime();
+    for(uint32_t i = 0; i < _layer_images.size(); ++i)
+        _layer_images[i]->Update();
+    for(uint32_t i = 0; i < _layers.size(); ++i)
+        _layers[i]->Update(elapsed_time);
+
     // Updates custom scripts
-    for(uint32_t i = 0; i < _update_functions.size(); ++i)
+    for(uint32_t i = 0; i < _update_functions.size(); ++i) {
+        vt_common::ScriptCallTimer timer("scene Update", _update_functions[i]);
         ReadScriptDescriptor::RunScriptObject(_update_functions[i]);
+    }
 }
 
 void ScriptSupervisor::DrawBackground()
 {
+    PROFILE_SCOPE("ScriptSupervisor::DrawBackground");
+
+    _DrawLayers(SCRIPT_LAYER_BACKGROUND);
+
     // Handles custom scripted draw before sprites
-    for(uint32_t i = 0; i < _draw_background_functions.size(); ++i)
+    for(uint32_t i = 0; i < _draw_background_functions.size(); ++i) {
+        vt_common::ScriptCallTimer timer("scene DrawBackground", _draw_background_functions[i]);
         ReadScriptDescriptor::RunScriptObject(_draw_background_functions[i]);
+    }
+}
+
+void ScriptSupervisor::DrawStaticBackground()
+{
+    PROFILE_SCOPE("ScriptSupervisor::DrawStaticBackground");
+
+    for(uint32_t i = 0; i < _draw_static_background_functions.size(); ++i) {
+        if(!_draw_static_background_functions[i].is_valid())
+            continue;
+        vt_common::ScriptCallTimer timer("scene DrawStaticBackground", _draw_static_background_functions[i]);
+        ReadScriptDescriptor::RunScriptObject(_draw_static_background_functions[i]);
+    }
+}
+
+bool ScriptSupervisor::HasStaticBackground() const
+{
+    for(uint32_t i = 0; i < _draw_static_background_functions.size(); ++i) {
+        if(_draw_static_background_functions[i].is_valid())
+            return true;
+    }
+    return false;
 }
 
 void ScriptSupervisor::DrawForeground()
 {
-    for(uint32_t i = 0; i < _draw_foreground_functions.size(); ++i)
+    PROFILE_SCOPE("ScriptSupervisor::DrawForeground");
+
+    _DrawLayers(SCRIPT_LAYER_FOREGROUND);
+
+    for(uint32_t i = 0; i < _draw_foreground_functions.size(); ++i) {
+        vt_common::ScriptCallTimer timer("scene DrawForeground", _draw_foreground_functions[i]);
         ReadScriptDescriptor::RunScriptObject(_draw_foreground_functions[i]);
+    }
 }
 
 void ScriptSupervisor::DrawPostEffects()
 {
-    for(uint32_t i = 0; i < _draw_post_effects_functions.size(); ++i)
+    PROFILE_SCOPE("ScriptSupervisor::DrawPostEffects");
+
+    _DrawLayers(SCRIPT_LAYER_POST_EFFECTS);
+
+    for(uint32_t i = 0; i < _draw_post_effects_functions.size(); ++i) {
+        vt_common::ScriptCallTimer timer("scene DrawPostEffects", _draw_post_effects_functions[i]);
         ReadScriptDescriptor::RunScriptObject(_draw_post_effects_functions[i]);
+    }
+}
+
+void ScriptSupervisor::_DrawLayers(SCRIPT_LAYER_STAGE stage)
+{
+    const DrawState draw_state = VideoManager->GetDrawState();
+    for(uint32_t i = 0; i < _layers.size(); ++i) {
+        if(_layers[i]->GetStage() == stage && _layers[i]->IsVisible())
+            _layers[i]->Draw();
+    }
+    VideoManager->SetDrawState(draw_state);
+}
+
+ScriptLayer* ScriptSupervisor::CreateLayer(ImageDescriptor* image, uint32_t stage)
+{
+    if(image == nullptr || stage >= SCRIPT_LAYER_TOTAL) {
+        PRINT_WARNING << "Invalid layer image or draw stage: " << stage << std::endl;
+        return nullptr;
+    }
+
+    ScriptLayer* layer = new ScriptLayer(image, static_cast<SCRIPT_LAYER_STAGE>(stage));
+    _layers.push_back(layer);
+    if(std::find(_layer_images.begin(), _layer_images.end(), image) == _layer_images.end())
+        _layer_images.push_back(image);
+    return layer;
+}
+
+void ScriptSupervisor::DrawImages(ImageDescriptor* image, const luabind::object& positions, const Color& color)
+{
+    if(image == nullptr)
+        return;
+
+    const vt_system::ScriptArray array(positions);
+    if(array.GetSize() % 2 != 0)
+        PRINT_WARNING << "The positions array size isn't a multiple of 2: " << array.GetSize() << std::endl;
+
+    for(uint32_t i = 0; i + 1 < array.GetSize(); i += 2) {
+        VideoManager->Move(array.GetNumber(i), array.GetNumber(i + 1));
+        image->Draw(color);
+    }
+}
+
+void ScriptSupervisor::DrawTransformedImages(ImageDescriptor* image, const luabind::object& transforms, const Color& color)
+{
+    if(image == nullptr)
+        return;
+
+    const vt_system::ScriptArray array(transforms);
+    if(array.GetSize() % 5 != 0)
+        PRINT_WARNING << "The transforms array size isn't a multiple of 5: " << array.GetSize() << std::endl;
+
+    Color draw_color = color;
+    for(uint32_t i = 0; i + 4 < array.GetSize(); i += 5) {
+        VideoManager->PushMatrix();
+        VideoManager->Move(array.GetNumber(i), array.GetNumber(i + 1));
+        const float angle = array.GetNumber(i + 2);
+        if(angle != 0.0f)
+            VideoManager->Rotate(angle);
+        const float scale = array.GetNumber(i + 3);
+        if(scale != 1.0f)
+            VideoManager->Scale(scale, scale);
+        draw_color.SetAlpha(color.GetAlpha() * array.GetNumber(i + 4));
+        image->Draw(draw_color);
+        VideoManager->PopMatrix();
+    }
 }
 
 // Images loading
@@ -27,6 +27,117 @@ namespace vt_mode_manager {
 class GameMode;
 }
 
+//! \brief The draw stages a script layer can be drawn at.
+enum SCRIPT_LAYER_STAGE {
+    SCRIPT_LAYER_BACKGROUND = 0,
+    SCRIPT_LAYER_FOREGROUND = 1,
+    SCRIPT_LAYER_POST_EFFECTS = 2,
+    SCRIPT_LAYER_TOTAL = 3
+};
+
+/** ****************************************************************************
+*** \brief An image created once by a script, then moved and drawn by the engine.
+***
+*** Clouds, fog or flashes only change when the script says so: Their layer
+*** scrolls them and animates their color every frame, without calling the
+*** script's draw functions, and the layers of a stage are drawn one after
+*** the other, so that the ones sharing a texture sheet are batched.
+***
+*** \note The layers are drawn before the script draw functions of their stage,
+*** using the draw flags and coordinate system set by the game mode for them.
+*** The animations of the layers are updated by the script supervisor.
+*** ***************************************************************************/
+class ScriptLayer
+{
+public:
+    ScriptLayer(vt_video::ImageDescriptor* image, SCRIPT_LAYER_STAGE stage);
+
+    //! \brief Sets the position of the layer image, before scrolling.
+    void SetPosition(float x, float y) {
+        _x = x;
+        _y = y;
+    }
+
+    //! \brief Sets the scrolling speed, in pixels per second.
+    void SetVelocity(float x_velocity, float y_velocity) {
+        _x_velocity = x_velocity;
+        _y_velocity = y_velocity;
+    }
+
+    /** \brief Makes the layer scroll over and over, every width and height pixels.
+    *** The image is then drawn again one width and height before its position,
+    *** so that it covers the area it scrolled away from. 0 keeps it scrolling away.
+    **/
+    void SetWrapSize(float width, float height);
+
+    //! \brief Sets the blend mode: VIDEO_NO_BLEND, VIDEO_BLEND or VIDEO_BLEND_ADD.
+    void SetBlendMode(int32_t blend_mode);
+
+    //! \brief Sets the color the image is drawn with, stopping any color animation.
+    void SetColor(const vt_video::Color& color) {
+        _color = color;
+        _color_period = 0;
+    }
+
+    /** \brief Makes the color go from the first color to the second, and back, over and over.
+    *** \param period The time in milliseconds to go from one color to the other.
+    *** 0 stops the animation on the first color.
+    **/
+    void SetColorAnimation(const vt_video::Color& first_color, const vt_video::Color& second_color, uint32_t period);
+
+    void SetVisible(bool visible) {
+        _visible = visible;
+    }
+
+    bool IsVisible() const {
+        return _visible;
+    }
+
+    SCRIPT_LAYER_STAGE GetStage() const {
+        return _stage;
+    }
+
+    vt_video::ImageDescriptor* GetImage() const {
+        return _image;
+    }
+
+    //! \brief Scrolls the layer and animates its color.
+    void Update(uint32_t elapsed_time);
+
+    //! \brief Draws the layer image, and its wrapped copies.
+    void Draw() const;
+
+private:
+    //! \brief The image drawn, created and owned by the script supervisor.
+    vt_video::ImageDescriptor* _image;
+
+    SCRIPT_LAYER_STAGE _stage;
+
+    //! \brief The position of the image, its scrolling offset, and the scrolling speed.
+    float _x;
+    float _y;
+    float _x_offset;
+    float _y_offset;
+    float _x_velocity;
+    float _y_velocity;
+
+    //! \brief The scrolling period on both axes, or 0.
+    float _wrap_width;
+    float _wrap_height;
+
+    //! \brief The blend mode, applied when drawing.
+    vt_video::DrawFlags _blend_flags;
+
+    //! \brief The current color, and the colors and period of its animation.
+    vt_video::Color _color;
+    vt_video::Color _first_color;
+    vt_video::Color _second_color;
+    uint32_t _color_period;
+    uint32_t _color_time;
+
+    bool _visible;
+};
+
 class ScriptSupervisor
 {
 public:
@@ -68,6 +179,15 @@ public:
     **/
     void DrawBackground();
 
+    /** \brief Draws the background images which don't change from one frame to the next.
+    *** The game mode may cache those, and only draw them again once one of
+    *** the scripts tells it they changed.
+    **/
+    void DrawStaticBackground();
+
+    //! \brief Tells whether any of the scripts draws a static background.
+    bool HasStaticBackground() const;
+
     /** \brief Draws all foreground images and animations
     *** The images and effects drawn by this function will be drawn over sprites,
     *** but not over the post effects and the gui.
@@ -104,6 +224,29 @@ public:
         return CreateText(vt_utils::MakeUnicodeString(text), style);
     }
 
+    /** \brief Creates a layer drawing an image natively, each frame, at a draw stage.
+    *** \param image An image or an animation created by this supervisor.
+    *** \param stage The SCRIPT_LAYER_STAGE to draw the layer at.
+    *** \return The layer to set up, or nullptr if the image or the stage is invalid.
+    *** \note the object life cycle is handled by the engine, not the script.
+    **/
+    ScriptLayer* CreateLayer(vt_video::ImageDescriptor* image, uint32_t stage);
+
+    /** \brief Draws an image at many positions in one script call.
+    *** \param image The image to draw.
+    *** \param positions The positions, as { x, y, x, y, ... }.
+    *** \param color The color the image is drawn with.
+    **/
+    void DrawImages(vt_video::ImageDescriptor* image, const luabind::object& positions, const vt_video::Color& color);
+
+    /** \brief Draws an image many times with a transform each, in one script call.
+    *** \param image The image to draw.
+    *** \param transforms The transforms, as { x, y, angle, scale, alpha, x, y, angle, scale, alpha, ... },
+    *** the angle being in degrees, and the alpha multiplying the color one.
+    *** \param color The color the image is drawn with.
+    **/
+    void DrawTransformedImages(vt_video::ImageDescriptor* image, const luabind::object& transforms, const vt_video::Color& color);
+
     //! \brief Used to permit changing a draw flag at boot time. Use with caution.
     void SetDrawFlag(vt_video::VIDEO_DRAW_FLAGS draw_flag);
 
@@ -111,6 +254,12 @@ private:
     //! \brief Contains a collection of custom created images
     std::vector<vt_video::TextImage*> _text_images;
 
+    //! \brief The layers created, in their drawing order.
+    std::vector<ScriptLayer*> _layers;
+
+    //! \brief The images of the layers, each one once, to update them once per frame.
+    std::vector<vt_video::ImageDescriptor*> _layer_images;
+
     //! \brief Contains a collection of custom created images
     std::vector<vt_video::StillImage*> _still_images;
 
@@ -146,6 +295,12 @@ private:
     **/
     std::vector<luabind::object> _draw_background_functions;
 
+    /** \brief Script functions which assists with the #DrawStaticBackground method
+    *** Those functions draw the background images which don't change from one frame
+    *** to the next, and may thus be cached by the game mode.
+    **/
+    std::vector<luabind::object> _draw_static_background_functions;
+
     /** \brief Script functions which assists with the #DrawForeground method
     *** Those functions execute any code that needs to be performed on a draw call.
     *** This permits custom visual effects over the characters and enemies sprites.
@@ -161,6 +316,9 @@ private:
     /** \brief Scripts objects keeping the corresponding lua coroutines alive.
     **/
     std::vector<vt_script::ReadScriptDescriptor*> _scene_scripts;
+
+    //! \brief Draws the visible layers of a stage, keeping the draw flags.
+    void _DrawLayers(SCRIPT_LAYER_STAGE stage);
 };
 
 #endif
@@ -29,6 +29,8 @@
 
 #include "mode_manager.h"
 
+#include <unordered_map>
+
 // Gettext
 #ifndef DISABLE_TRANSLATIONS
 #include <libintl.h>
@@ -65,12 +67,38 @@ const char* ngettext(const char* text_when_singular, const char* text_when_plura
 }
 #endif
 
+//! \brief The maximum number of translations kept, the caches being emptied when full.
+const size_t TRANSLATION_CACHE_SIZE = 2048;
+
+//! \brief The translations already looked up, and already converted to unicode, in the current locale.
+static std::unordered_map<std::string, std::string> _translations;
+static std::unordered_map<std::string, ustring> _unicode_translations;
+
+//! \brief Forgets the translations looked up, to be called whenever the locale changes.
+static void _ClearTranslations()
+{
+    _translations.clear();
+    _unicode_translations.clear();
+}
+
+//! \brief Returns the cached translation of a non empty text, looking it up if needed.
+static const std::string& _GetTranslation(const std::string& text)
+{
+    auto it = _translations.find(text);
+    if (it != _translations.end())
+        return it->second;
+
+    if (_translations.size() >= TRANSLATION_CACHE_SIZE)
+        _translations.clear();
+    return _translations.insert(std::make_pair(text, std::string(gettext(text.c_str())))).first->second;
+}
+
 std::string Translate(const std::string& text)
 {
     // Don't translate an empty string as it will return the PO meta data.
     if (text.empty())
         return std::string();
-    return std::string(gettext(text.c_str()));
+    return _GetTranslation(text);
 }
 
 ustring UTranslate(const std::string& text)
@@ -78,7 +106,14 @@ ustring UTranslate(const std::string& text)
     // Don't translate an empty string as it will return the PO meta data.
     if (text.empty())
         return ustring();
-    return MakeUnicodeString(Translate(text));
+
+    auto it = _unicode_translations.find(text);
+    if (it != _unicode_translations.end())
+        return it->second;
+
+    if (_unicode_translations.size() >= TRANSLATION_CACHE_SIZE)
+        _unicode_translations.clear();
+    return _unicode_translations.insert(std::make_pair(text, MakeUnicodeString(_GetTranslation(text)))).first->second;
 }
 
 // Use: context|text
@@ -88,7 +123,7 @@ std::string CTranslate(const std::string& text)
     if (text.empty())
         return std::string();
 
-    std::string translation = gettext(text.c_str());
+    const std::string& translation = _GetTranslation(text);
 
     size_t sep_id = translation.find_first_of('|', 0);
 
@@ -115,9 +150,7 @@ template<typename T> std::string _VTranslate(const std::string& text, const T& a
     if (text.empty())
         return std::string();
 
-    std::string translation = gettext(text.c_str());
-
-    translation = strprintf(translation.c_str(), arg1);
+    std::string translation = strprintf(_GetTranslation(text).c_str(), arg1);
 
     return translation;
 }
@@ -128,9 +161,7 @@ template<typename T> std::string _VTranslate(const std::string& text, const T& a
     if (text.empty())
         return std::string();
 
-    std::string translation = gettext(text.c_str());
-
-    translation = strprintf(translation.c_str(), arg1, arg2);
+    std::string translation = strprintf(_GetTranslation(text).c_str(), arg1, arg2);
 
     return translation;
 }
@@ -142,8 +173,7 @@ template<typename T> std::string _VTranslate(const std::string& text, const T& a
         return std::string();
     }
 
-    std::string translation = gettext(text.c_str());
-    translation = strprintf(translation.c_str(), arg1, arg2, arg3);
+    std::string translation = strprintf(_GetTranslation(text).c_str(), arg1, arg2, arg3);
     return translation;
 }
 
@@ -196,7 +226,8 @@ SystemTimer::SystemTimer() :
     _number_loops(0),
     _mode_owner(nullptr),
     _time_expired(0),
-    _times_completed(0)
+    _times_completed(0),
+    _auto_timer_index(-1)
 {}
 
 SystemTimer::SystemTimer(uint32_t duration, int32_t loops) :
@@ -206,7 +237,8 @@ SystemTimer::SystemTimer(uint32_t duration, int32_t loops) :
     _number_loops(loops),
     _mode_owner(nullptr),
     _time_expired(0),
-    _times_completed(0)
+    _times_completed(0),
+    _auto_timer_index(-1)
 {}
 
 SystemTimer::~SystemTimer()
@@ -362,7 +394,10 @@ void SystemTimer::_UpdateTimer(uint32_t time)
 
 SystemEngine::SystemEngine():
     _last_update(0),
+    _logic_time_accumulator(0),
     _update_time(1), // Set to 1 to avoid hanging the system.
+    _frame_time(1),
+    _fixed_update_time(0),
     _hours_played(0),
     _minutes_played(0),
     _seconds_played(0),
@@ -477,6 +512,9 @@ std::string _Reinitl10n(const std::string& lang)
 #else
     bind_text_domain_path = LOCALEDIR;
 #endif
+    // The translations may come from another catalog now.
+    _ClearTranslations();
+
 #ifndef DISABLE_TRANSLATIONS
     bindtextdomain(APPSHORTNAME, bind_text_domain_path.c_str());
     bind_textdomain_codeset(APPSHORTNAME, "UTF-8");
@@ -515,6 +553,7 @@ bool SystemEngine::SetLanguageLocale(const std::string& lang)
         return false;
 
     _current_language_locale = lang;
+    _ClearTranslations();
 
 #ifndef DISABLE_TRANSLATIONS
 
@@ -564,19 +603,25 @@ bool SystemEngine::SingletonInitialize()
 
 void SystemEngine::InitializeTimers()
 {
-    _last_update = SDL_GetTicks();
+    _last_update = SDL_GetPerformanceCounter();
+    _logic_time_accumulator = 0;
     _update_time = 1; // Set to non-zero, otherwise bad things may happen...
+    _frame_time = 1;
     _hours_played = 0;
     _minutes_played = 0;
     _seconds_played = 0;
     _milliseconds_played = 0;
+    for(uint32_t i = 0; i < _auto_system_timers.size(); ++i)
+        _auto_system_timers[i]->_auto_timer_index = -1;
     _auto_system_timers.clear();
 }
 
 void SystemEngine::InitializeUpdateTimer()
 {
-    _last_update = SDL_GetTicks();
+    _last_update = SDL_GetPerformanceCounter();
+    _logic_time_accumulator = 0;
     _update_time = 1;
+    _frame_time = 1;
 }
 
 void SystemEngine::AddAutoTimer(SystemTimer *timer)
@@ -590,9 +635,13 @@ void SystemEngine::AddAutoTimer(SystemTimer *timer)
         return;
     }
 
-    if(_auto_system_timers.insert(timer).second == false) {
+    if(timer->_auto_timer_index >= 0) {
         IF_PRINT_WARNING(SYSTEM_DEBUG) << "timer already existed in auto system timer container" << std::endl;
+        return;
     }
+
+    timer->_auto_timer_index = _auto_system_timers.size();
+    _auto_system_timers.push_back(timer);
 }
 
 void SystemEngine::RemoveAutoTimer(SystemTimer *timer)
@@ -605,17 +654,70 @@ void SystemEngine::RemoveAutoTimer(SystemTimer *timer)
         IF_PRINT_WARNING(SYSTEM_DEBUG) << "timer did not have auto update feature enabled" << std::endl;
     }
 
-    if(_auto_system_timers.erase(timer) == 0) {
+    // A copied timer has the index of the original one, without being in the container.
+    const int32_t index = timer->_auto_timer_index;
+    if(index < 0 || static_cast<uint32_t>(index) >= _auto_system_timers.size() ||
+            _auto_system_timers[index] != timer) {
         IF_PRINT_WARNING(SYSTEM_DEBUG) << "timer was not found in auto system timer container" << std::endl;
+        return;
+    }
+
+    // Move the last timer in its place.
+    SystemTimer* last_timer = _auto_system_timers.back();
+    _auto_system_timers[index] = last_timer;
+    last_timer->_auto_timer_index = index;
+    _auto_system_timers.pop_back();
+    timer->_auto_timer_index = -1;
+}
+
+uint32_t SystemEngine::ComputeLogicUpdates()
+{
+    const uint64_t now = SDL_GetPerformanceCounter();
+    const uint64_t elapsed = now - _last_update;
+    _last_update = now;
+    _frame_time = 0;
+
+    // The replayed and fixed update times are run once per frame, whatever the time really spent.
+    if(_replay.IsReplaying() || _fixed_update_time > 0) {
+        _logic_time_accumulator = 0;
+        return 1;
+    }
+
+    // Measure the time with the high resolution counter, and keep the part below an update
+    // for the next frame: The logic updates then add up to the real time, without any drift,
+    // even when the frames last a fractional number of updates.
+    const uint64_t update_ticks = SDL_GetPerformanceFrequency() * SYSTEM_LOGIC_UPDATE_TIME / 1000;
+    _logic_time_accumulator += elapsed;
+    uint64_t updates = _logic_time_accumulator / update_ticks;
+    if(updates > SYSTEM_MAX_LOGIC_UPDATES_PER_FRAME) {
+        // Drop the time that can't be caught up with, rather than falling further behind.
+        updates = SYSTEM_MAX_LOGIC_UPDATES_PER_FRAME;
+        _logic_time_accumulator %= update_ticks;
+    } else {
+        _logic_time_accumulator -= updates * update_ticks;
     }
+
+    return static_cast<uint32_t>(updates);
 }
 
 void SystemEngine::UpdateTimers()
 {
     // Update the update game timer
-    uint32_t tmp = _last_update;
-    _last_update = SDL_GetTicks();
-    _update_time = _last_update - tmp;
+    if(_replay.IsReplaying()) {
+        if(!_replay.ReadFrame(_update_time)) {
+            // The whole replay was played.
+            ExitGame();
+            _update_time = 1;
+        }
+    } else if(_fixed_update_time > 0) {
+        _update_time = _fixed_update_time;
+    } else {
+        _update_time = SYSTEM_LOGIC_UPDATE_TIME;
+    }
+    _frame_time += _update_time;
+
+    if(_replay.IsRecording())
+        _replay.RecordFrame(_update_time);
 
     // Update the game play timer
     _milliseconds_played += _update_time;
@@ -632,24 +734,28 @@ void SystemEngine::UpdateTimers()
         }
     }
 
-    // Update all SystemTimer objects
-    for(std::set<SystemTimer *>::iterator i = _auto_system_timers.begin(); i != _auto_system_timers.end(); ++i)
-        (*i)->_AutoUpdate();
+    // Update all the running SystemTimer objects
+    for(uint32_t i = 0; i < _auto_system_timers.size(); ++i) {
+        SystemTimer* timer = _auto_system_timers[i];
+        if(timer->IsRunning())
+            timer->_AutoUpdate();
+    }
 }
 
 void SystemEngine::ExamineSystemTimers()
 {
     GameMode* active_mode = ModeManager->GetTop();
 
-    for(std::set<SystemTimer *>::iterator i = _auto_system_timers.begin(); i != _auto_system_timers.end(); ++i) {
-        GameMode* timer_mode = (*i)->GetModeOwner();
+    for(uint32_t i = 0; i < _auto_system_timers.size(); ++i) {
+        SystemTimer* timer = _auto_system_timers[i];
+        GameMode* timer_mode = timer->GetModeOwner();
         if(timer_mode == nullptr)
             continue;
 
         if(timer_mode == active_mode)
-            (*i)->Run();
+            timer->Run();
         else
-            (*i)->Pause();
+            timer->Pause();
     }
 }
 
@@ -25,10 +25,13 @@
 #ifndef __SYSTEM_HEADER__
 #define __SYSTEM_HEADER__
 
+#include "engine/frame_pacer.h"
+#include "engine/replay.h"
+
 #include "utils/ustring.h"
 #include "utils/singleton.h"
 
-#include <set>
+#include <vector>
 #include <map>
 
 namespace vt_mode_manager {
@@ -69,6 +72,18 @@ const int32_t SYSTEM_TIMER_NO_LOOPS = 0;
 **/
 const int32_t SYSTEM_TIMER_INFINITE_LOOP = -1;
 
+/** \brief The time that each game logic update advances the game by, in milliseconds
+*** The main loop runs as many logic updates of this length as the real time elapsed allows,
+*** the time left being carried over to the next frame.
+**/
+const uint32_t SYSTEM_LOGIC_UPDATE_TIME = 5;
+
+/** \brief The maximum number of logic updates run for a single frame
+*** The time elapsed beyond it is dropped, so that a slow frame doesn't make the next one
+*** even slower by catching up with it.
+**/
+const uint32_t SYSTEM_MAX_LOGIC_UPDATES_PER_FRAME = 20;
+
 //! \brief All of the possible states which a SystemTimer classs object may be in
 enum SYSTEM_TIMER_STATE {
     SYSTEM_TIMER_INVALID  = -1,
@@ -394,6 +409,9 @@ protected:
     //! \brief Incremented by one each time the timer reaches the finished state
     uint32_t _times_completed;
 
+    //! \brief The index of the timer in the auto system timers, or -1 when it isn't in them.
+    int32_t _auto_timer_index;
+
     /** \brief Updates the timer if it is running and has auto updating enabled
     *** This method can only be invoked by the SystemEngine class.
     **/
@@ -458,13 +476,40 @@ public:
     **/
     void RemoveAutoTimer(SystemTimer *timer);
 
+    /** \brief Measures the real time elapsed since the last frame and returns the number of logic updates to run.
+    *** This function should only be called <b>once</b> for each cycle through the main game loop.
+    *** Each logic update then calls UpdateTimers() and advances the game by SYSTEM_LOGIC_UPDATE_TIME.
+    *** When replaying, or when the update time is fixed, a single update is run per frame.
+    **/
+    uint32_t ComputeLogicUpdates();
+
     /** \brief Updates the game timer variables.
-    *** This function should only be called <b>once</b> for each cycle through the main game loop. Since
+    *** This function should only be called <b>once</b> for each logic update of the main game loop. Since
     *** it is called inside the loop in main.cpp, you should have no reason to call this function anywhere
     *** else.
     **/
     void UpdateTimers();
 
+    /** \brief Makes every timer update advance the game by a fixed time, whatever the time really spent.
+    *** \param update_time The time of each update in milliseconds, or 0 to follow the real time again.
+    *** This is used to simulate the game faster than it would run, as nothing waits for the real time then.
+    **/
+    void SetFixedUpdateTime(uint32_t update_time) {
+        _fixed_update_time = update_time;
+    }
+
+    /** \brief The session replay, recording or replaying the update times and the input events.
+    *** When replaying, the timer updates take the recorded update times instead of the real ones.
+    **/
+    Replay& GetReplay() {
+        return _replay;
+    }
+
+    //! \brief The main loop frame pacer, lowering the frame rate of the still screens.
+    FramePacer& GetFramePacer() {
+        return _frame_pacer;
+    }
+
     /** \brief Checks all system timers for whether they should be paused or resumed
     *** This function is typically called whenever the ModeEngine class has changed the active game mode.
     *** When this is done, all system timers that are owned by the active game mode are resumed, all timers with
@@ -484,6 +529,13 @@ public:
         return _update_time;
     }
 
+    /** \brief Retrieves the game time that the last frame advanced by, for the once per frame updates.
+    *** \return The sum of the update times of the logic updates run since the last ComputeLogicUpdates() call.
+    **/
+    inline uint32_t GetFrameTime() const {
+        return _frame_time;
+    }
+
     /** \brief Sets the play time of a game instance
     *** \param h The amount of hours to set.
     *** \param m The amount of minutes to set.
@@ -610,12 +662,27 @@ public:
 private:
     SystemEngine();
 
-    //! \brief The last time that the UpdateTimers function was called, in milliseconds.
-    uint32_t _last_update;
+    //! \brief The last time that the ComputeLogicUpdates function was called, in performance counter ticks.
+    uint64_t _last_update;
+
+    //! \brief The performance counter ticks elapsed but not run as logic updates yet.
+    uint64_t _logic_time_accumulator;
 
     //! \brief The number of milliseconds that have transpired on the last timer update.
     uint32_t _update_time;
 
+    //! \brief The number of milliseconds that the logic updates of the current frame have advanced by.
+    uint32_t _frame_time;
+
+    //! \brief The time each update advances the game by, in milliseconds. 0 when following the real time.
+    uint32_t _fixed_update_time;
+
+    //! \brief The session replay, see GetReplay().
+    Replay _replay;
+
+    //! \brief The main loop frame pacer, see GetFramePacer().
+    FramePacer _frame_pacer;
+
     /** \name Play time members
     *** \brief Timers that retain the total amount of time that the user has been playing
     *** When the player starts a new game or loads an existing game, these timers are reset.
@@ -654,10 +721,11 @@ private:
     //! \brief Sets the number of game slots that will be available to the player.
     uint32_t _game_save_slots;
 
-    /** \brief A set container for all SystemTimer objects that have automatic updating enabled
-    *** The timers in this container are updated on each call to UpdateTimers().
+    /** \brief All the SystemTimer objects that have automatic updating enabled, in no particular order
+    *** The timers in this container are updated on each call to UpdateTimers(). Each timer knows its index,
+    *** so that it is removed by moving the last timer in its place, without searching or allocating anything.
     **/
-    std::set<SystemTimer *> _auto_system_timers;
+    std::vector<SystemTimer *> _auto_system_timers;
 }; // class SystemEngine : public vt_utils::Singleton<SystemEngine>
 
 } // namepsace vt_system
@@ -20,6 +20,7 @@
 
 #include "color.h"
 #include "coord_sys.h"
+#include "draw_state.h"
 #include "screen_rect.h"
 
 namespace vt_video
@@ -45,14 +46,8 @@ namespace private_video
 class Context
 {
 public:
-    //! \brief Flag to indicate whether normal alpha blending is to take place.
-    int8_t blend;
-
-    //! \brief Draw alignment flags to determine where an element is drawn relative to the cursor.
-    int8_t x_align, y_align;
-
-    //! \brief Draw flip flags to determine if an element should be drawn flipped across an axis.
-    int8_t x_flip, y_flip;
+    //! \brief The alignment, flip and blending flags determining how an element is drawn relative to the cursor.
+    DrawState draw_state;
 
     //! \brief The coordinate system being used by this context.
     CoordSys coordinate_system;
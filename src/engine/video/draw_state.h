@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    draw_state.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the DrawState and DrawFlags classes.
+***
+*** The alignment, flip and blending draw flags are packed into a single byte,
+*** so that setting, saving and restoring them is a couple of bit operations.
+*** ***************************************************************************/
+
+#ifndef __DRAW_STATE_HEADER__
+#define __DRAW_STATE_HEADER__
+
+#include "video_utils.h"
+
+namespace vt_video
+{
+
+/** ****************************************************************************
+*** \brief A set of draw flags, applied at once to the current draw state.
+***
+*** Only the fields given a flag are changed when applied, the others are kept.
+*** Build it once, e.g. as a static constant, and hand it to
+*** VideoEngine::SetDrawFlags() every frame:
+***
+*** static const DrawFlags flags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, VIDEO_BLEND);
+*** VideoManager->SetDrawFlags(flags);
+*** ***************************************************************************/
+class DrawFlags
+{
+public:
+    //! \brief The bits of each field in the packed state.
+    //@{
+    static const uint8_t X_ALIGN_SHIFT = 0;
+    static const uint8_t X_ALIGN_MASK = 0x03;
+    static const uint8_t Y_ALIGN_SHIFT = 2;
+    static const uint8_t Y_ALIGN_MASK = 0x0C;
+    static const uint8_t X_FLIP_MASK = 0x10;
+    static const uint8_t Y_FLIP_MASK = 0x20;
+    static const uint8_t BLEND_SHIFT = 6;
+    static const uint8_t BLEND_MASK = 0xC0;
+    //@}
+
+    //! \brief Builds the set out of up to five flags. VIDEO_DRAW_FLAGS_INVALID ones are ignored.
+    explicit DrawFlags(VIDEO_DRAW_FLAGS first = VIDEO_DRAW_FLAGS_INVALID,
+                       VIDEO_DRAW_FLAGS second = VIDEO_DRAW_FLAGS_INVALID,
+                       VIDEO_DRAW_FLAGS third = VIDEO_DRAW_FLAGS_INVALID,
+                       VIDEO_DRAW_FLAGS fourth = VIDEO_DRAW_FLAGS_INVALID,
+                       VIDEO_DRAW_FLAGS fifth = VIDEO_DRAW_FLAGS_INVALID):
+        _bits(0),
+        _mask(0)
+    {
+        Set(first).Set(second).Set(third).Set(fourth).Set(fifth);
+    }
+
+    //! \brief Adds a flag to the set, replacing the one given for the same field.
+    DrawFlags& Set(VIDEO_DRAW_FLAGS flag) {
+        switch(flag) {
+        case VIDEO_X_LEFT:
+            _SetField(X_ALIGN_MASK, 0 << X_ALIGN_SHIFT);
+            break;
+        case VIDEO_X_CENTER:
+            _SetField(X_ALIGN_MASK, 1 << X_ALIGN_SHIFT);
+            break;
+        case VIDEO_X_RIGHT:
+            _SetField(X_ALIGN_MASK, 2 << X_ALIGN_SHIFT);
+            break;
+
+        case VIDEO_Y_BOTTOM:
+            _SetField(Y_ALIGN_MASK, 0 << Y_ALIGN_SHIFT);
+            break;
+        case VIDEO_Y_CENTER:
+            _SetField(Y_ALIGN_MASK, 1 << Y_ALIGN_SHIFT);
+            break;
+        case VIDEO_Y_TOP:
+            _SetField(Y_ALIGN_MASK, 2 << Y_ALIGN_SHIFT);
+            break;
+
+        case VIDEO_X_NOFLIP:
+            _SetField(X_FLIP_MASK, 0);
+            break;
+        case VIDEO_X_FLIP:
+            _SetField(X_FLIP_MASK, X_FLIP_MASK);
+            break;
+
+        case VIDEO_Y_NOFLIP:
+            _SetField(Y_FLIP_MASK, 0);
+            break;
+        case VIDEO_Y_FLIP:
+            _SetField(Y_FLIP_MASK, Y_FLIP_MASK);
+            break;
+
+        case VIDEO_NO_BLEND:
+            _SetField(BLEND_MASK, 0 << BLEND_SHIFT);
+            break;
+        case VIDEO_BLEND:
+            _SetField(BLEND_MASK, 1 << BLEND_SHIFT);
+            break;
+        case VIDEO_BLEND_ADD:
+            _SetField(BLEND_MASK, 2 << BLEND_SHIFT);
+            break;
+
+        default:
+            break;
+        }
+        return *this;
+    }
+
+    //! \brief The values of the fields set, and which fields are set.
+    //@{
+    uint8_t GetBits() const {
+        return _bits;
+    }
+
+    uint8_t GetMask() const {
+        return _mask;
+    }
+    //@}
+
+private:
+    void _SetField(uint8_t mask, uint8_t bits) {
+        _bits = (_bits & ~mask) | bits;
+        _mask |= mask;
+    }
+
+    uint8_t _bits;
+    uint8_t _mask;
+}; // class DrawFlags
+
+/** ****************************************************************************
+*** \brief The current draw flags, packed into a single byte.
+***
+*** Copying it is enough to save the draw flags and restore them later, see
+*** VideoEngine::GetDrawState() and VideoEngine::SetDrawState().
+***
+*** \note The default state is left and bottom aligned, not flipped and not blended.
+*** ***************************************************************************/
+class DrawState
+{
+public:
+    DrawState():
+        _bits(0)
+    {}
+
+    //! \brief Changes the fields given a flag in the set, and keeps the other ones.
+    void Apply(const DrawFlags& flags) {
+        _bits = (_bits & ~flags.GetMask()) | flags.GetBits();
+    }
+
+    //! \brief Returns -1, 0 or 1 when aligned to the left, center or right.
+    int8_t GetXAlign() const {
+        return static_cast<int8_t>((_bits & DrawFlags::X_ALIGN_MASK) >> DrawFlags::X_ALIGN_SHIFT) - 1;
+    }
+
+    //! \brief Returns -1, 0 or 1 when aligned to the bottom, center or top.
+    int8_t GetYAlign() const {
+        return static_cast<int8_t>((_bits & DrawFlags::Y_ALIGN_MASK) >> DrawFlags::Y_ALIGN_SHIFT) - 1;
+    }
+
+    bool IsXFlipped() const {
+        return (_bits & DrawFlags::X_FLIP_MASK) != 0;
+    }
+
+    bool IsYFlipped() const {
+        return (_bits & DrawFlags::Y_FLIP_MASK) != 0;
+    }
+
+    //! \brief Returns VIDEO_NO_BLEND, VIDEO_BLEND or VIDEO_BLEND_ADD.
+    VIDEO_DRAW_FLAGS GetBlendMode() const {
+        switch((_bits & DrawFlags::BLEND_MASK) >> DrawFlags::BLEND_SHIFT) {
+        case 1:
+            return VIDEO_BLEND;
+        case 2:
+            return VIDEO_BLEND_ADD;
+        default:
+            return VIDEO_NO_BLEND;
+        }
+    }
+
+    bool IsBlending() const {
+        return (_bits & DrawFlags::BLEND_MASK) != 0;
+    }
+
+    bool operator==(const DrawState& other) const {
+        return _bits == other._bits;
+    }
+
+    bool operator!=(const DrawState& other) const {
+        return _bits != other._bits;
+    }
+
+private:
+    uint8_t _bits;
+}; // class DrawState
+
+} // namespace vt_video
+
+#endif // __DRAW_STATE_HEADER__
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_debug.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the OpenGL error checking.
+*** ***************************************************************************/
+
+#include "gl_debug.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_strings.h"
+
+#include <cassert>
+
+namespace vt_video
+{
+namespace gl
+{
+
+bool GL_DEBUG = false;
+
+//! \brief Whether glGetError() must be called by the draw paths.
+static bool poll_errors = false;
+
+#ifndef __APPLE__
+//! \brief Prints the messages sent by the driver through KHR_debug.
+static void GLAPIENTRY _DebugMessageCallback(GLenum /*source*/,
+                                             GLenum type,
+                                             GLuint id,
+                                             GLenum severity,
+                                             GLsizei /*length*/,
+                                             const GLchar* message,
+                                             const void* /*user_param*/)
+{
+    // Ignore the notifications, they are only informative.
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION)
+        return;
+
+    if (type == GL_DEBUG_TYPE_ERROR) {
+        PRINT_ERROR << "OpenGL error " << vt_utils::NumberToString(id) << ": "
+                    << message << std::endl;
+        assert(type != GL_DEBUG_TYPE_ERROR);
+    }
+    else {
+        PRINT_WARNING << "OpenGL message " << vt_utils::NumberToString(id) << ": "
+                      << message << std::endl;
+    }
+}
+#endif
+
+void InitializeDebugOutput()
+{
+    poll_errors = false;
+
+    if (!GL_DEBUG)
+        return;
+
+#ifndef __APPLE__
+    if (GLEW_KHR_debug) {
+        // Report the errors in the call stack of the faulty GL call.
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageCallback(_DebugMessageCallback, nullptr);
+        return;
+    }
+#endif
+
+    // Fall back to polling the errors after each GL call.
+    PRINT_WARNING << "KHR_debug is not supported, OpenGL errors will be polled." << std::endl;
+    poll_errors = true;
+}
+
+GLenum GetError()
+{
+    if (!poll_errors)
+        return GL_NO_ERROR;
+
+    return glGetError();
+}
+
+} // namespace gl
+
+} // namespace vt_video
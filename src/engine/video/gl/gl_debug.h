@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_debug.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the OpenGL error checking.
+***
+*** Calling glGetError() forces a round trip to the driver, and often a flush
+*** of the rendering pipeline. The draw paths therefore only check for errors
+*** when the --gl-debug option is given. In that case, the KHR_debug callback
+*** reports the errors when available, and glGetError() is called otherwise.
+*** ***************************************************************************/
+
+#ifndef __GL_DEBUG_HEADER__
+#define __GL_DEBUG_HEADER__
+
+#include "utils/gl_include.h"
+
+namespace vt_video
+{
+namespace gl
+{
+
+//! \brief Enables the OpenGL error checking. Set by the --gl-debug option.
+extern bool GL_DEBUG;
+
+/** \brief Sets up the error reporting for the current OpenGL context.
+*** \note This must be called once GLEW is initialized.
+**/
+void InitializeDebugOutput();
+
+/** \brief Returns the last OpenGL error when errors are polled.
+*** \return GL_NO_ERROR when the error checking is disabled,
+*** or when the errors are reported by the KHR_debug callback.
+**/
+GLenum GetError();
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_DEBUG_HEADER__
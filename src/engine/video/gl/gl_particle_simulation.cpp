@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_particle_simulation.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the particle state simulated on the GPU.
+*** ***************************************************************************/
+
+#include "gl_particle_simulation.h"
+
+#include "gl_debug.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+#include "utils/utils_strings.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace vt_video
+{
+namespace gl
+{
+
+//! \brief The number of floats of each attribute of a simulated particle, in the order of the simulation program attributes.
+const unsigned SIMULATION_ATTRIBUTES = 9;
+const unsigned SIMULATION_ATTRIBUTE_FLOATS[SIMULATION_ATTRIBUTES] = { 2, 2, 1, 4, 2, 1, 1, 1, 1 };
+
+//! \brief The index of the seed in a simulated particle. A negative seed marks a dead particle.
+const unsigned SIMULATION_SEED_FLOAT = PARTICLE_INSTANCE_FLOATS + 3;
+
+//! \brief The index of the emission in a simulated particle. -1 means the slot hasn't emitted yet.
+const unsigned SIMULATION_EMISSION_FLOAT = PARTICLE_INSTANCE_FLOATS + 5;
+
+ParticleSimulation::ParticleSimulation(unsigned number_of_particles) :
+    _current(0),
+    _number_of_particles(number_of_particles),
+    _valid(false)
+{
+    _vaos[0] = 0;
+    _vaos[1] = 0;
+    _buffers[0] = 0;
+    _buffers[1] = 0;
+
+    if (!IsSupported() || _number_of_particles == 0)
+        return;
+
+#ifndef __APPLE__
+    bool errors = false;
+
+    // Create the vertex array objects.
+    glGenVertexArrays(2, _vaos);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        errors = true;
+        PRINT_ERROR << "Failed to create the particle simulation vertex array objects." << std::endl;
+        assert(error == GL_NO_ERROR);
+    }
+
+    // Create the vertex buffer objects.
+    if (!errors) {
+        glGenBuffers(2, _buffers);
+
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            errors = true;
+            PRINT_ERROR << "Failed to create the particle simulation buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vaos[0]) << std::endl;
+            assert(error == GL_NO_ERROR);
+        }
+    }
+
+    // Every particle starts dead, so that the slots emit at their own times.
+    if (!errors) {
+        std::vector<float> particles(_number_of_particles * PARTICLE_SIMULATION_FLOATS, 0.0f);
+        for (unsigned i = 0; i < _number_of_particles; ++i) {
+            particles[i * PARTICLE_SIMULATION_FLOATS + SIMULATION_SEED_FLOAT] = -1.0f;
+            particles[i * PARTICLE_SIMULATION_FLOATS + SIMULATION_EMISSION_FLOAT] = -1.0f;
+        }
+
+        const unsigned stride = PARTICLE_SIMULATION_FLOATS * sizeof(float);
+        for (unsigned i = 0; i < 2 && !errors; ++i) {
+            glBindVertexArray(_vaos[i]);
+            glBindBuffer(GL_ARRAY_BUFFER, _buffers[i]);
+            glBufferData(GL_ARRAY_BUFFER, _number_of_particles * stride, &particles[0], GL_DYNAMIC_COPY);
+
+            uintptr_t offset = 0;
+            for (GLuint j = 0; j < SIMULATION_ATTRIBUTES; ++j) {
+                glEnableVertexAttribArray(j);
+                glVertexAttribPointer(j, SIMULATION_ATTRIBUTE_FLOATS[j], GL_FLOAT, false, stride,
+                                      reinterpret_cast<const void*>(offset));
+                offset += SIMULATION_ATTRIBUTE_FLOATS[j] * sizeof(float);
+            }
+
+            error = glGetError();
+            if (error != GL_NO_ERROR) {
+                errors = true;
+                PRINT_ERROR << "Failed to allocate the particle simulation buffer. VAO ID: " <<
+                               vt_utils::NumberToString(_vaos[i]) << " Buffer ID: " <<
+                               vt_utils::NumberToString(_buffers[i]) <<
+                               std::endl;
+                assert(error == GL_NO_ERROR);
+            }
+        }
+    }
+
+    // Unbind the vertex array object and the buffer from the pipeline.
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _valid = !errors;
+#endif
+}
+
+ParticleSimulation::~ParticleSimulation()
+{
+#ifndef __APPLE__
+    for (unsigned i = 0; i < 2; ++i) {
+        if (_vaos[i] != 0)
+            glDeleteVertexArrays(1, &_vaos[i]);
+        if (_buffers[i] != 0)
+            glDeleteBuffers(1, &_buffers[i]);
+        _vaos[i] = 0;
+        _buffers[i] = 0;
+    }
+#endif
+}
+
+bool ParticleSimulation::IsSupported()
+{
+#ifndef __APPLE__
+    return GLEW_VERSION_3_0;
+#else
+    return false;
+#endif
+}
+
+void ParticleSimulation::Step()
+{
+    assert(_valid);
+    if (!_valid)
+        return;
+
+#ifndef __APPLE__
+    const unsigned next = 1 - _current;
+
+    // Only the transform feedback output matters.
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    glBindVertexArray(_vaos[_current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _buffers[next]);
+
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, _number_of_particles);
+    glEndTransformFeedback();
+
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        PRINT_ERROR << "Failed to simulate the particles. VAO ID: " <<
+                       vt_utils::NumberToString(_vaos[_current]) << " Buffer ID: " <<
+                       vt_utils::NumberToString(_buffers[next]) <<
+                       std::endl;
+        assert(error == GL_NO_ERROR);
+        return;
+    }
+
+    _current = next;
+#endif
+}
+
+ParticleSimulation::ParticleSimulation(const ParticleSimulation&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+ParticleSimulation& ParticleSimulation::operator=(const ParticleSimulation&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace gl
+
+} // namespace vt_video
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_particle_simulation.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the particle state simulated on the GPU.
+***
+*** The particles of a system simulated on the GPU are kept in two vertex
+*** buffers. Each step, the simulation program reads one of them as points
+*** and writes the advanced particles to the other with transform feedback,
+*** the rasterizer being disabled. The last written buffer is then drawn as
+*** the instances of the particle shader, so no particle ever goes through
+*** the CPU.
+*** ***************************************************************************/
+
+#ifndef __GL_PARTICLE_SIMULATION_HEADER__
+#define __GL_PARTICLE_SIMULATION_HEADER__
+
+#include "gl_particle_system.h"
+
+namespace vt_video
+{
+namespace gl
+{
+
+//! \brief The number of floats per simulated particle: The particle instance,
+//! then velocity (2), time (1), seed (1), rotation angle (1) and emission (1).
+const unsigned PARTICLE_SIMULATION_FLOATS = PARTICLE_INSTANCE_FLOATS + 6;
+
+//! \brief The number of samples of the keyframed properties given to the simulation program.
+const unsigned PARTICLE_SIMULATION_KEYFRAMES = 16;
+
+//! \brief A class for the state of a particle system simulated on the GPU.
+class ParticleSimulation
+{
+public:
+    //! \param number_of_particles The maximum number of particles, all dead at first.
+    explicit ParticleSimulation(unsigned number_of_particles);
+    ~ParticleSimulation();
+
+    //! \brief Whether transform feedback is available.
+    static bool IsSupported();
+
+    //! \brief Whether the buffers were created.
+    bool IsValid() const {
+        return _valid;
+    }
+
+    //! \brief Advances every particle once, with the simulation program currently loaded.
+    void Step();
+
+    //! \brief The buffer holding the particles, PARTICLE_SIMULATION_FLOATS floats each.
+    GLuint GetParticleBuffer() const {
+        return _buffers[_current];
+    }
+
+    unsigned GetNumberOfParticles() const {
+        return _number_of_particles;
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ParticleSimulation(const ParticleSimulation& particle_simulation);
+    ParticleSimulation& operator=(const ParticleSimulation& particle_simulation);
+
+    //! \brief The two particle buffers, and the vertex array objects reading each of them.
+    GLuint _vaos[2];
+    GLuint _buffers[2];
+
+    //! \brief The index of the buffer holding the current particles.
+    unsigned _current;
+
+    unsigned _number_of_particles;
+
+    bool _valid;
+};
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_PARTICLE_SIMULATION_HEADER__
@@ -15,12 +15,21 @@
 
 #include "gl_particle_system.h"
 
+#include "gl_stream_buffer.h"
+#include "gl_debug.h"
+
+#include "utils/utils_common.h"
 #include "utils/exception.h"
 #include "utils/utils_strings.h"
-#include "utils/utils_common.h"
 
 #include <cassert>
-#include <vector>
+#include <cstdint>
+
+#ifdef __APPLE__
+#   define glBindVertexArray    glBindVertexArrayAPPLE
+#   define glGenVertexArrays    glGenVertexArraysAPPLE
+#   define glDeleteVertexArrays glDeleteVertexArraysAPPLE
+#endif
 
 namespace vt_video
 {
@@ -30,205 +39,124 @@ namespace gl
 //! \brief constants.
 const unsigned VERTICES_PER_PARTICLE = 4;
 const unsigned INDICES_PER_PARTICLE = 6;
-const unsigned POSITIONS_PER_VERTEX = 3;
-const unsigned TEXTURE_COORDINATES_PER_VERTEX = 2;
-const unsigned COLORS_PER_VERTEX = 4;
 
-#ifdef __APPLE__
-#define glBindVertexArray glBindVertexArrayAPPLE
-#define glGenVertexArrays glGenVertexArraysAPPLE
-#define glGenerateMipmap glGenerateMipmapEXT
-#define glDeleteVertexArrays glDeleteVertexArraysAPPLE
+//! \brief The number of floats of each part of a particle instance.
+const unsigned INSTANCE_POSITION_FLOATS = 2;
+const unsigned INSTANCE_SIZE_FLOATS = 2;
+const unsigned INSTANCE_ROTATION_FLOATS = 1;
+const unsigned INSTANCE_COLOR_FLOATS = 4;
+const unsigned INSTANCE_STRIDE = PARTICLE_INSTANCE_FLOATS * sizeof(float);
+
+//! \brief Sets an attribute divisor, with the core or the extension entry point.
+static void _VertexAttribDivisor(GLuint index, GLuint divisor)
+{
+#ifndef __APPLE__
+    if (GLEW_VERSION_3_3)
+        glVertexAttribDivisor(index, divisor);
+    else
+        glVertexAttribDivisorARB(index, divisor);
+#else
+    (void)index;
+    (void)divisor;
+#endif
+}
+
+//! \brief Draws instances, with the core or the extension entry point.
+static void _DrawElementsInstanced(GLsizei count, GLsizei number_of_instances)
+{
+#ifndef __APPLE__
+    if (GLEW_VERSION_3_1)
+        glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, number_of_instances);
+    else
+        glDrawElementsInstancedARB(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, number_of_instances);
+#else
+    (void)count;
+    (void)number_of_instances;
 #endif
+}
 
-ParticleSystem::ParticleSystem() :
-    _number_of_indices(0),
+ParticleSystem::ParticleSystem(StreamBuffer* stream_buffer) :
+    _stream_buffer(stream_buffer),
+    _instancing(false),
     _vao(0),
-    _vertex_position_buffer(0),
-    _vertex_texture_coordinate_buffer(0),
-    _vertex_color_buffer(0),
-    _index_buffer(0)
+    _quad_buffer(0),
+    _index_buffer(0),
+    _instance_buffer(0)
 {
-    bool errors = false;
+    assert(_stream_buffer != nullptr);
 
-    // Create the vertex array object.
-    if (!errors) {
-        GLuint arrays[1] = { 0 };
-        glGenVertexArrays(1, arrays);
+#ifndef __APPLE__
+    _instancing = (GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays) &&
+                  (GLEW_VERSION_3_1 || GLEW_ARB_draw_instanced);
+#endif
+    if (!_instancing)
+        return;
 
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to create the vertex array object." << std::endl;
-            assert(error == GL_NO_ERROR);
-        } else {
-            // Store the result.
-            _vao = arrays[0];
-        }
-    }
+    bool errors = false;
 
-    // Bind the vertex array object.
-    if (!errors) {
+    // The unit quad corners, in the order of the expanded vertices:
+    // Upper-left, upper-right, lower-right, then lower-left.
+    const float corners[VERTICES_PER_PARTICLE * 2] = {
+        -1.0f, -1.0f,
+         1.0f, -1.0f,
+         1.0f,  1.0f,
+        -1.0f,  1.0f
+    };
+    const GLuint indices[INDICES_PER_PARTICLE] = { 0, 1, 2, 0, 2, 3 };
+
+    // Create the vertex array object.
+    GLuint arrays[1] = { 0 };
+    glGenVertexArrays(1, arrays);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        errors = true;
+        PRINT_ERROR << "Failed to create the particle vertex array object." << std::endl;
+        assert(error == GL_NO_ERROR);
+    } else {
+        _vao = arrays[0];
         glBindVertexArray(_vao);
     }
 
     // Create the vertex buffer objects.
     if (!errors) {
-        GLuint buffers[4] = { 0 };
-        glGenBuffers(4, buffers);
+        GLuint buffers[3] = { 0 };
+        glGenBuffers(3, buffers);
 
-        GLenum error = glGetError();
+        error = glGetError();
         if (error != GL_NO_ERROR) {
             errors = true;
-            PRINT_ERROR << "Failed to create the vertex array object's position, texture coordinate, color, and index buffers. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) <<
-                           std::endl;
+            PRINT_ERROR << "Failed to create the particle buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vao) << std::endl;
             assert(error == GL_NO_ERROR);
         } else {
-            // Store the results.
-            _vertex_position_buffer = buffers[0];
-            _vertex_texture_coordinate_buffer = buffers[1];
-            _vertex_color_buffer = buffers[2];
-            _index_buffer = buffers[3];
+            _quad_buffer = buffers[0];
+            _index_buffer = buffers[1];
+            _instance_buffer = buffers[2];
         }
     }
 
-    // Bind the vertex position buffer.
-    if (!errors) {
-        glBindBuffer(GL_ARRAY_BUFFER, _vertex_position_buffer);
-    }
-
-    // Set up the vertex position data.
-    if (!errors) {
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to store the vertex position data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_position_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
-
-    // Store the vertex position data into slot 0.
-    if (!errors) {
-        glVertexAttribPointer(0, 3, GL_FLOAT, false, 0, nullptr);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to set the vertex position data attribute pointer. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_position_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
-
-    // Enable the attribute index.
+    // The corners are in slot 0. The instance attributes, in slots 1 to 4,
+    // advance once per instance. Their pointers are set at each draw.
     if (!errors) {
+        glBindBuffer(GL_ARRAY_BUFFER, _quad_buffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
-    }
-
-    // Bind the vertex texture coordinate buffer.
-    if (!errors) {
-        glBindBuffer(GL_ARRAY_BUFFER, _vertex_texture_coordinate_buffer);
-    }
-
-    // Set up the vertex texture coordinate data.
-    if (!errors) {
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to store the vertex texture coordinate data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_texture_coordinate_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
-
-    // Store the vertex texture coordinate data into slot 1.
-    if (!errors) {
-        glVertexAttribPointer(1, 2, GL_FLOAT, false, 0, nullptr);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to set the vertex texture coordinate data attribute pointer. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_texture_coordinate_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
+        glVertexAttribPointer(0, 2, GL_FLOAT, false, 0, nullptr);
 
-    // Enable the attribute index.
-    if (!errors) {
-        glEnableVertexAttribArray(1);
-    }
-
-    // Bind the vertex color buffer.
-    if (!errors) {
-        glBindBuffer(GL_ARRAY_BUFFER, _vertex_color_buffer);
-    }
-
-    // Set up the vertex color data.
-    if (!errors) {
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to store the vertex color data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_color_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
-
-    // Store the vertex color data into slot 2.
-    if (!errors) {
-        glVertexAttribPointer(2, 4, GL_FLOAT, false, 0, nullptr);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to set the vertex color data attribute pointer. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_color_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
+        for (GLuint i = 1; i <= 4; ++i) {
+            glEnableVertexAttribArray(i);
+            _VertexAttribDivisor(i, 1);
         }
-    }
-
-    // Enable the attribute index.
-    if (!errors) {
-        glEnableVertexAttribArray(2);
-    }
 
-    // Bind the index buffer.
-    if (!errors) {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
-    }
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
-    // Set up the index data.
-    if (!errors) {
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
-        _number_of_indices = 0;
-
-        GLenum error = glGetError();
+        error = glGetError();
         if (error != GL_NO_ERROR) {
-            PRINT_ERROR << "Failed to store the index data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_index_buffer) <<
-                           std::endl;
+            errors = true;
+            PRINT_ERROR << "Failed to allocate the particle buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vao) << std::endl;
             assert(error == GL_NO_ERROR);
         }
     }
@@ -239,6 +167,10 @@ ParticleSystem::ParticleSystem() :
     // Unbind the active buffers from the pipeline.
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Fall back to the expanded vertices.
+    if (errors)
+        _instancing = false;
 }
 
 ParticleSystem::~ParticleSystem()
@@ -249,48 +181,14 @@ ParticleSystem::~ParticleSystem()
         _vao = 0;
     }
 
-    if (_vertex_position_buffer != 0) {
-        const GLuint buffers[] = { _vertex_position_buffer };
-        glDeleteBuffers(1, buffers);
-        _vertex_position_buffer = 0;
-    }
-
-    if (_vertex_texture_coordinate_buffer != 0) {
-        const GLuint buffers[] = { _vertex_texture_coordinate_buffer };
-        glDeleteBuffers(1, buffers);
-        _vertex_texture_coordinate_buffer = 0;
-    }
-
-    if (_vertex_color_buffer != 0) {
-        const GLuint buffers[] = { _vertex_color_buffer };
-        glDeleteBuffers(1, buffers);
-        _vertex_color_buffer = 0;
-    }
-
-    if (_index_buffer != 0) {
-        const GLuint buffers[] = { _index_buffer };
-        glDeleteBuffers(1, buffers);
-        _index_buffer = 0;
+    const GLuint buffers[] = { _quad_buffer, _index_buffer, _instance_buffer };
+    for (unsigned i = 0; i < 3; ++i) {
+        if (buffers[i] != 0)
+            glDeleteBuffers(1, &buffers[i]);
     }
-}
-
-void ParticleSystem::Draw()
-{
-    // Bind the vertex array object.
-    glBindVertexArray(_vao);
-
-    // Bind the index buffer.
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
-
-    // Draw the particle system.
-    glDrawElements(GL_TRIANGLES, _number_of_indices, GL_UNSIGNED_INT, nullptr);
-
-    // Unbind the vertex array object from the pipeline.
-    glBindVertexArray(0);
-
-    // Unbind the active buffers from the pipeline.
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    _quad_buffer = 0;
+    _index_buffer = 0;
+    _instance_buffer = 0;
 }
 
 void ParticleSystem::Draw(float* vertex_positions,
@@ -298,139 +196,85 @@ void ParticleSystem::Draw(float* vertex_positions,
                           float* vertex_colors,
                           unsigned number_of_vertices)
 {
-    bool errors = false;
-
     assert(vertex_positions != nullptr);
     assert(vertex_texture_coordinates != nullptr);
     assert(vertex_colors != nullptr);
     assert(number_of_vertices % VERTICES_PER_PARTICLE == 0);
 
-    // Bind the vertex position buffer.
-    glBindBuffer(GL_ARRAY_BUFFER, _vertex_position_buffer);
-
-    // Update the vertex position data.
-    if (!errors) {
-        glBufferData(GL_ARRAY_BUFFER,
-                     number_of_vertices * POSITIONS_PER_VERTEX * sizeof(float),
-                     vertex_positions,
-                     GL_DYNAMIC_DRAW);
-
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to update the vertex position data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_position_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
-
-    // Bind the vertex texture coordinate buffer.
-    if (!errors) {
-        glBindBuffer(GL_ARRAY_BUFFER, _vertex_texture_coordinate_buffer);
-    }
-
-    // Update the vertex texture coordinate data.
-    if (!errors) {
-        glBufferData(GL_ARRAY_BUFFER,
-                     number_of_vertices * TEXTURE_COORDINATES_PER_VERTEX * sizeof(float),
-                     vertex_texture_coordinates,
-                     GL_DYNAMIC_DRAW);
+    _stream_buffer->DrawQuads(vertex_positions, vertex_texture_coordinates, vertex_colors,
+                              number_of_vertices / VERTICES_PER_PARTICLE);
+}
 
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to update the vertex texture coordinate data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_texture_coordinate_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
+void ParticleSystem::DrawInstances(const float* instances,
+                                   unsigned number_of_instances)
+{
+    assert(instances != nullptr);
+    assert(_instancing);
+
+    if (number_of_instances == 0)
+        return;
+
+    // Orphan the previous instances, still read by the GPU, and upload the new ones.
+    const unsigned size = number_of_instances * INSTANCE_STRIDE;
+    glBindBuffer(GL_ARRAY_BUFFER, _instance_buffer);
+    glBufferData(GL_ARRAY_BUFFER, size, instances, GL_STREAM_DRAW);
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        PRINT_ERROR << "Failed to update the particle instance buffer. VAO ID: " <<
+                       vt_utils::NumberToString(_vao) << " Buffer ID: " <<
+                       vt_utils::NumberToString(_instance_buffer) <<
+                       std::endl;
+        assert(error == GL_NO_ERROR);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
     }
 
-    // Bind the vertex color buffer.
-    if (!errors) {
-        glBindBuffer(GL_ARRAY_BUFFER, _vertex_color_buffer);
-    }
+    _DrawInstances(INSTANCE_STRIDE, number_of_instances);
+}
 
-    // Update the vertex color data.
-    if (!errors) {
-        glBufferData(GL_ARRAY_BUFFER,
-                     number_of_vertices * COLORS_PER_VERTEX * sizeof(float),
-                     vertex_colors,
-                     GL_DYNAMIC_DRAW);
+void ParticleSystem::DrawBufferInstances(GLuint buffer,
+                                         unsigned stride,
+                                         unsigned number_of_instances)
+{
+    assert(buffer != 0);
+    assert(stride >= PARTICLE_INSTANCE_FLOATS);
+    assert(_instancing);
 
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to update the vertex color data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_vertex_color_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
+    if (number_of_instances == 0)
+        return;
 
-    // Create the index buffer's data.
-    std::vector<unsigned> indices;
-    indices.reserve(number_of_vertices / VERTICES_PER_PARTICLE * INDICES_PER_PARTICLE);
-    if (!errors) {
-        // For each particle...
-        unsigned number_of_particles = number_of_vertices / VERTICES_PER_PARTICLE;
-        for (unsigned i = 0; i < number_of_particles; ++i)
-        {
-            // Compute the starting index of the particle.
-            unsigned index = i * VERTICES_PER_PARTICLE;
-
-            //
-            // Store the particle's indices.
-            //
-
-            // Triangle one.
-            indices.push_back(index + 0);
-            indices.push_back(index + 1);
-            indices.push_back(index + 2);
-
-            // Triangle two.
-            indices.push_back(index + 0);
-            indices.push_back(index + 2);
-            indices.push_back(index + 3);
-        }
-    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    _DrawInstances(stride * sizeof(float), number_of_instances);
+}
 
-    // Bind the index buffer.
-    if (!errors) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
-    }
+void ParticleSystem::_DrawInstances(unsigned stride, unsigned number_of_instances)
+{
+    // Bind the vertex array object.
+    glBindVertexArray(_vao);
 
-    // Update the index data.
-    if (!errors) {
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     indices.size() * sizeof(unsigned),
-                     &indices.front(),
-                     GL_DYNAMIC_DRAW);
-        _number_of_indices = indices.size();
+    // Point the instance attributes to the bound instances.
+    const uintptr_t position_offset = 0;
+    const uintptr_t size_offset = position_offset + INSTANCE_POSITION_FLOATS * sizeof(float);
+    const uintptr_t rotation_offset = size_offset + INSTANCE_SIZE_FLOATS * sizeof(float);
+    const uintptr_t color_offset = rotation_offset + INSTANCE_ROTATION_FLOATS * sizeof(float);
+    glVertexAttribPointer(1, INSTANCE_POSITION_FLOATS, GL_FLOAT, false, stride,
+                          reinterpret_cast<const void*>(position_offset));
+    glVertexAttribPointer(2, INSTANCE_SIZE_FLOATS, GL_FLOAT, false, stride,
+                          reinterpret_cast<const void*>(size_offset));
+    glVertexAttribPointer(3, INSTANCE_ROTATION_FLOATS, GL_FLOAT, false, stride,
+                          reinterpret_cast<const void*>(rotation_offset));
+    glVertexAttribPointer(4, INSTANCE_COLOR_FLOATS, GL_FLOAT, false, stride,
+                          reinterpret_cast<const void*>(color_offset));
+
+    // Draw the particles.
+    _DrawElementsInstanced(INDICES_PER_PARTICLE, number_of_instances);
 
-        GLenum error = glGetError();
-        if (error != GL_NO_ERROR) {
-            errors = true;
-            PRINT_ERROR << "Failed to update the index data. VAO ID: " <<
-                           vt_utils::NumberToString(_vao) << " Buffer ID: " <<
-                           vt_utils::NumberToString(_index_buffer) <<
-                           std::endl;
-            assert(error == GL_NO_ERROR);
-        }
-    }
+    // Unbind the vertex array object from the pipeline.
+    glBindVertexArray(0);
 
-    // Unbind the buffers from the pipeline.
+    // Unbind the active buffer from the pipeline.
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    // Draw the particle system.
-    if (!errors) {
-        Draw();
-    }
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem&)
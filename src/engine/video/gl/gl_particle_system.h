@@ -11,6 +11,11 @@
 *** \file    gl_particle_system.h
 *** \author  Authenticate, James Lammlein
 *** \brief   Header file for buffers for a particle system.
+***
+*** When the driver supports instanced arrays, each particle is sent once as an
+*** instance of a static unit quad, and the vertex shader expands and rotates
+*** it. Otherwise, the four vertices of each particle are expanded on the CPU
+*** and streamed like the sprites.
 *** ***************************************************************************/
 
 #ifndef __GL_PARTICLE_SYSTEM_HEADER__
@@ -18,42 +23,72 @@
 
 #include "utils/gl_include.h"
 
-#include <cstddef>
-
 namespace vt_video
 {
 namespace gl
 {
 
+// Forward declarations.
+class StreamBuffer;
+
+//! \brief The number of floats per particle instance: Position (2), half size (2), rotation (1), then color (4).
+const unsigned PARTICLE_INSTANCE_FLOATS = 9;
+
 //! \brief A class for drawing a particle system.
 class ParticleSystem
 {
 public:
-    ParticleSystem();
+    //! \param stream_buffer The buffer the particle vertices are streamed to.
+    explicit ParticleSystem(StreamBuffer* stream_buffer);
     ~ParticleSystem();
 
-    //! \brief Draws all sprites in a particle system.
-    void Draw();
-
     //! \brief Draws all sprites in a particle system.
     void Draw(float* vertex_positions,
               float* vertex_texture_coordinates,
               float* vertex_colors,
               unsigned number_of_vertices);
 
+    //! \brief Whether DrawInstances() can be used.
+    bool IsInstancingSupported() const {
+        return _instancing;
+    }
+
+    /** \brief Draws the particles as instances of the unit quad.
+    *** \param instances PARTICLE_INSTANCE_FLOATS floats per particle.
+    *** \param number_of_instances The number of particles to draw.
+    **/
+    void DrawInstances(const float* instances,
+                       unsigned number_of_instances);
+
+    /** \brief Draws the particles as instances of the unit quad, from a buffer already in video memory.
+    *** \param buffer Holds the instances, each starting with the PARTICLE_INSTANCE_FLOATS floats.
+    *** \param stride The number of floats between two instances.
+    *** \param number_of_instances The number of particles to draw.
+    **/
+    void DrawBufferInstances(GLuint buffer,
+                             unsigned stride,
+                             unsigned number_of_instances);
+
 private:
     //! \brief The copy constructor and assignment operator are hidden by design
     //! to cause compilation errors when attempting to copy or assign this class.
     ParticleSystem(const ParticleSystem& particle_system);
     ParticleSystem& operator=(const ParticleSystem& particle_system);
 
-    size_t _number_of_indices;
+    //! \brief Draws the instances of the buffer bound to GL_ARRAY_BUFFER, stride given in bytes.
+    void _DrawInstances(unsigned stride, unsigned number_of_instances);
+
+    //! \brief The buffer the particle vertices are streamed to. Not owned.
+    StreamBuffer* _stream_buffer;
+
+    //! \brief Whether instanced arrays and instanced draws are available.
+    bool _instancing;
 
+    //! \brief The instanced path objects: The unit quad corners and indices, and the per-instance buffer.
     GLuint _vao;
-    GLuint _vertex_position_buffer;
-    GLuint _vertex_texture_coordinate_buffer;
-    GLuint _vertex_color_buffer;
+    GLuint _quad_buffer;
     GLuint _index_buffer;
+    GLuint _instance_buffer;
 };
 
 } // namespace gl
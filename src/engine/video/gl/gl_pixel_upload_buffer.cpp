@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_pixel_upload_buffer.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the pixel buffer used to upload textures.
+*** ***************************************************************************/
+
+#include "gl_pixel_upload_buffer.h"
+
+#include "gl_debug.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+#include "utils/utils_strings.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace vt_video
+{
+namespace gl
+{
+
+//
+// Constants.
+//
+
+//! \brief The size in bytes of the ring buffer. A 1024x1024 RGBA image takes half of it.
+const unsigned PIXEL_UPLOAD_BUFFER_SIZE = 8 * 1024 * 1024;
+
+//! \brief The alignment in bytes of each upload within the ring.
+const unsigned PIXEL_UPLOAD_ALIGNMENT = 16;
+
+PixelUploadBuffer::PixelUploadBuffer() :
+    _buffer(0),
+    _offset(0),
+    _map_buffer_range(false)
+{
+#ifndef __APPLE__
+    // Pixel buffer objects are core since OpenGL 2.1.
+    if (!GLEW_VERSION_2_1 && !GLEW_ARB_pixel_buffer_object)
+        return;
+
+    _map_buffer_range = GLEW_VERSION_3_0 || GLEW_ARB_map_buffer_range;
+#endif
+
+    GLuint buffers[1] = { 0 };
+    glGenBuffers(1, buffers);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        PRINT_ERROR << "Failed to create the pixel upload buffer." << std::endl;
+        assert(error == GL_NO_ERROR);
+        return;
+    }
+
+    _buffer = buffers[0];
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, PIXEL_UPLOAD_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+
+    error = glGetError();
+    if (error != GL_NO_ERROR) {
+        PRINT_ERROR << "Failed to allocate the pixel upload buffer. Buffer ID: " <<
+                       vt_utils::NumberToString(_buffer) << std::endl;
+        assert(error == GL_NO_ERROR);
+
+        // Fall back to direct uploads.
+        glDeleteBuffers(1, buffers);
+        _buffer = 0;
+    }
+
+    // Unbind the buffer, so that the other pixel transfers use client memory.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+PixelUploadBuffer::~PixelUploadBuffer()
+{
+    if (_buffer != 0) {
+        const GLuint buffers[] = { _buffer };
+        glDeleteBuffers(1, buffers);
+        _buffer = 0;
+    }
+}
+
+void PixelUploadBuffer::TexSubImage(int32_t x, int32_t y, int32_t width, int32_t height,
+                                    GLenum format, const void* pixels)
+{
+    assert(pixels != nullptr);
+    assert(format == GL_RGB || format == GL_RGBA);
+
+    const unsigned bytes_per_pixel = (format == GL_RGB) ? 3 : 4;
+    const unsigned size = static_cast<unsigned>(width) * static_cast<unsigned>(height) * bytes_per_pixel;
+
+    if (_buffer == 0 || size > PIXEL_UPLOAD_BUFFER_SIZE) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, pixels);
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+
+    // When the ring is full, orphan its storage: The driver allocates a new one
+    // while the previous uploads are still being transferred.
+    _offset = (_offset + PIXEL_UPLOAD_ALIGNMENT - 1) & ~(PIXEL_UPLOAD_ALIGNMENT - 1);
+    if (_offset + size > PIXEL_UPLOAD_BUFFER_SIZE) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, PIXEL_UPLOAD_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+        _offset = 0;
+    }
+
+    bool errors = false;
+
+    void* data = nullptr;
+    if (_map_buffer_range) {
+        // That range was never written since the storage was orphaned,
+        // so there is no need to synchronize with the GPU.
+        data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, _offset, size,
+                                GL_MAP_WRITE_BIT |
+                                GL_MAP_INVALIDATE_RANGE_BIT |
+                                GL_MAP_UNSYNCHRONIZED_BIT);
+    }
+
+    if (data != nullptr) {
+        memcpy(data, pixels, size);
+
+        // The buffer content is undefined when the unmapping fails.
+        errors = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_FALSE);
+    } else {
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, _offset, size, pixels);
+    }
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        errors = true;
+        PRINT_ERROR << "Failed to update the pixel upload buffer. Buffer ID: " <<
+                       vt_utils::NumberToString(_buffer) << std::endl;
+        assert(error == GL_NO_ERROR);
+    }
+
+    if (!errors) {
+        // The pixels pointer is an offset within the bound unpack buffer.
+        const uintptr_t offset = _offset;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE,
+                        reinterpret_cast<const void*>(offset));
+    }
+
+    // Unbind the buffer, so that the other pixel transfers use client memory.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (errors) {
+        // Upload the pixels directly rather than losing them.
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    _offset += size;
+}
+
+PixelUploadBuffer::PixelUploadBuffer(const PixelUploadBuffer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+PixelUploadBuffer& PixelUploadBuffer::operator=(const PixelUploadBuffer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace gl
+
+} // namespace vt_video
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_pixel_upload_buffer.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the pixel buffer used to upload textures.
+***
+*** Uploading client memory with glTexSubImage2D() blocks until the driver
+*** has copied or transferred all the pixels. Staging them in a pixel unpack
+*** buffer first lets glTexSubImage2D() return immediately, the transfer to
+*** the texture then happening asynchronously.
+*** The buffer is used as a ring, like the vertex stream buffer: each upload
+*** is written after the previous ones, and the storage is orphaned once full.
+*** ***************************************************************************/
+
+#ifndef __GL_PIXEL_UPLOAD_BUFFER_HEADER__
+#define __GL_PIXEL_UPLOAD_BUFFER_HEADER__
+
+#include "utils/gl_include.h"
+
+namespace vt_video
+{
+namespace gl
+{
+
+//! \brief A class for uploading pixels to textures asynchronously.
+class PixelUploadBuffer
+{
+public:
+    PixelUploadBuffer();
+    ~PixelUploadBuffer();
+
+    /** \brief Uploads pixels to a part of the currently bound 2D texture.
+    *** \param x The x offset of the pixels within the texture.
+    *** \param y The y offset of the pixels within the texture.
+    *** \param width The width of the pixels rectangle.
+    *** \param height The height of the pixels rectangle.
+    *** \param format Either GL_RGB or GL_RGBA, with one byte per component.
+    *** \param pixels The tightly packed pixels, which can be freed once the call returns.
+    *** \note The pixels are uploaded directly when pixel buffers aren't
+    *** supported, or when they don't fit in the ring.
+    **/
+    void TexSubImage(int32_t x, int32_t y, int32_t width, int32_t height,
+                     GLenum format, const void* pixels);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    PixelUploadBuffer(const PixelUploadBuffer& pixel_upload_buffer);
+    PixelUploadBuffer& operator=(const PixelUploadBuffer& pixel_upload_buffer);
+
+    //! \brief The pixel unpack buffer, or 0 when unsupported.
+    GLuint _buffer;
+
+    //! \brief The offset in bytes where the next pixels are written.
+    unsigned _offset;
+
+    //! \brief Whether glMapBufferRange() is available.
+    bool _map_buffer_range;
+};
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_PIXEL_UPLOAD_BUFFER_HEADER__
@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_program_binary_cache.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the cache of the linked shader programs.
+*** ***************************************************************************/
+
+#include "gl_program_binary_cache.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace vt_video
+{
+namespace gl
+{
+
+bool ProgramBinaryCache::_enabled = false;
+std::string ProgramBinaryCache::_directory;
+std::string ProgramBinaryCache::_driver;
+
+namespace
+{
+
+//! \brief The header of a cached program file, followed by the program binary.
+class ProgramBinaryHeader
+{
+public:
+    uint32_t version;
+    uint32_t format;
+    uint64_t key;
+    uint32_t length;
+};
+
+//! \brief FNV-1a steps over a string, and over its end, so that "a" + "bc" differs from "ab" + "c".
+uint64_t _HashString(uint64_t hash, const std::string& value)
+{
+    for (size_t i = 0; i < value.length(); ++i)
+        hash = (hash ^ static_cast<unsigned char>(value[i])) * 1099511628211ull;
+    return (hash ^ 0xFFu) * 1099511628211ull;
+}
+
+std::string _GetGLString(GLenum name)
+{
+    const GLubyte* value = glGetString(name);
+    return value != nullptr ? reinterpret_cast<const char*>(value) : std::string();
+}
+
+} // namespace
+
+void ProgramBinaryCache::Initialize(const std::string& directory)
+{
+    _enabled = false;
+
+#ifndef __APPLE__
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+        return;
+
+    // Some drivers support the functions, but no binary format at all.
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    if (format_count <= 0)
+        return;
+
+    if (!vt_utils::DoesFileExist(directory))
+        vt_utils::MakeDirectory(directory);
+    if (!vt_utils::DoesFileExist(directory)) {
+        PRINT_WARNING << "Couldn't create the shader cache directory: " << directory << std::endl;
+        return;
+    }
+
+    _directory = directory;
+    _driver = _GetGLString(GL_VENDOR) + "\n" + _GetGLString(GL_RENDERER) + "\n" + _GetGLString(GL_VERSION);
+    _enabled = true;
+#else
+    (void)directory;
+#endif
+}
+
+uint64_t ProgramBinaryCache::ComputeKey(const std::string& vertex_source,
+                                        const std::string& fragment_source,
+                                        const std::vector<std::string>& attributes,
+                                        const std::vector<std::string>& feedback_varyings)
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = _HashString(hash, _driver);
+    hash = _HashString(hash, vertex_source);
+    hash = _HashString(hash, fragment_source);
+    for (uint32_t i = 0; i < attributes.size(); ++i)
+        hash = _HashString(hash, attributes[i]);
+    hash = _HashString(hash, std::string());
+    for (uint32_t i = 0; i < feedback_varyings.size(); ++i)
+        hash = _HashString(hash, feedback_varyings[i]);
+    return hash;
+}
+
+bool ProgramBinaryCache::Load(GLuint program, uint64_t key)
+{
+    if (!_enabled)
+        return false;
+
+#ifndef __APPLE__
+    std::ifstream file(_GetFilename(key).c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    ProgramBinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.version != PROGRAM_BINARY_CACHE_VERSION || header.key != key || header.length == 0)
+        return false;
+
+    std::vector<char> binary(header.length);
+    file.read(&binary[0], header.length);
+    if (!file)
+        return false;
+
+    glProgramBinary(program, header.format, &binary[0], header.length);
+
+    // The driver may reject the binaries of another build of itself.
+    GLint is_linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+    glGetError();
+    return is_linked != 0;
+#else
+    (void)program;
+    (void)key;
+    return false;
+#endif
+}
+
+void ProgramBinaryCache::PrepareLink(GLuint program)
+{
+    if (!_enabled)
+        return;
+
+#ifndef __APPLE__
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#else
+    (void)program;
+#endif
+}
+
+void ProgramBinaryCache::Store(GLuint program, uint64_t key)
+{
+    if (!_enabled)
+        return;
+
+#ifndef __APPLE__
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, &binary[0]);
+    if (glGetError() != GL_NO_ERROR || length <= 0)
+        return;
+
+    ProgramBinaryHeader header;
+    header.version = PROGRAM_BINARY_CACHE_VERSION;
+    header.format = format;
+    header.key = key;
+    header.length = static_cast<uint32_t>(length);
+
+    const std::string filename = _GetFilename(key);
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(&binary[0], length);
+    file.close();
+
+    // A partly written file is rejected when loaded.
+    if (file.fail())
+        PRINT_WARNING << "Couldn't write the cached shader program: " << filename << std::endl;
+#else
+    (void)program;
+    (void)key;
+#endif
+}
+
+std::string ProgramBinaryCache::_GetFilename(uint64_t key)
+{
+    std::ostringstream filename;
+    filename << _directory << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return filename.str();
+}
+
+} // namespace gl
+
+} // namespace vt_video
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_program_binary_cache.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the cache of the linked shader programs.
+***
+*** The shader programs linked by the driver are saved in the user cache
+*** directory, and loaded back by the next runs instead of compiling and
+*** linking their shaders again.
+***
+*** Each program is saved in its own file, named after a hash of the driver
+*** vendor, renderer and version, of the shaders sources, and of the attributes
+*** and outputs bound. An updated driver or an edited shader thus simply
+*** misses the cache, and the program is linked and saved again.
+*** ***************************************************************************/
+
+#ifndef __GL_PROGRAM_BINARY_CACHE_HEADER__
+#define __GL_PROGRAM_BINARY_CACHE_HEADER__
+
+#include "utils/gl_include.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vt_video
+{
+namespace gl
+{
+
+//! \brief The version of the cached program files, to change when their layout changes.
+const uint32_t PROGRAM_BINARY_CACHE_VERSION = 1;
+
+/** ****************************************************************************
+*** \brief Saves and loads the linked shader programs with glGetProgramBinary
+*** and glProgramBinary, when the driver supports them.
+***
+*** \note To be used by the thread owning the OpenGL context only.
+*** ***************************************************************************/
+class ProgramBinaryCache
+{
+public:
+    /** \brief Enables the cache when the driver supports the program binaries.
+    *** \param directory The directory of the cached programs, created if needed.
+    *** \note To be called once the OpenGL functions are loaded.
+    **/
+    static void Initialize(const std::string& directory);
+
+    static bool IsEnabled() {
+        return _enabled;
+    }
+
+    //! \brief Returns the cache key of a program, which includes the driver identity.
+    static uint64_t ComputeKey(const std::string& vertex_source,
+                               const std::string& fragment_source,
+                               const std::vector<std::string>& attributes,
+                               const std::vector<std::string>& feedback_varyings);
+
+    /** \brief Loads a cached program binary in a program.
+    *** \return False if the program isn't cached, or the driver rejected its binary.
+    *** The program must then be linked from its shaders.
+    **/
+    static bool Load(GLuint program, uint64_t key);
+
+    //! \brief Asks the driver to keep the binary of a program about to be linked.
+    static void PrepareLink(GLuint program);
+
+    //! \brief Saves the binary of a linked program.
+    static void Store(GLuint program, uint64_t key);
+
+private:
+    static bool _enabled;
+
+    //! \brief The directory of the cached programs, ending with a slash.
+    static std::string _directory;
+
+    //! \brief The driver vendor, renderer and version, part of the keys.
+    static std::string _driver;
+
+    static std::string _GetFilename(uint64_t key);
+};
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_PROGRAM_BINARY_CACHE_HEADER__
@@ -15,6 +15,8 @@
 
 #include "gl_render_target.h"
 
+#include "engine/memory_stats.h"
+
 #include "utils/utils_common.h"
 #include "utils/exception.h"
 #include "utils/utils_strings.h"
@@ -26,10 +28,17 @@ namespace vt_video
 namespace gl
 {
 
+//! \brief Returns the video memory used by a render target, with its 32 bit color and depth buffers.
+static size_t GetRenderTargetMemorySize(unsigned width, unsigned height)
+{
+    return static_cast<size_t>(width) * height * 8;
+}
+
 RenderTarget::RenderTarget(unsigned width,
                            unsigned height) :
     _width(width),
     _height(height),
+    _filter(GL_LINEAR),
     _framebuffer(0),
     _texture(0),
     _renderbuffer_depth(0)
@@ -78,8 +87,8 @@ RenderTarget::RenderTarget(unsigned width,
     }
 
     // Initialize the texture filtering.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _filter);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
@@ -133,10 +142,14 @@ RenderTarget::RenderTarget(unsigned width,
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    vt_system::MemoryStats::Add(vt_system::MEMORY_TEXTURES_GPU, GetRenderTargetMemorySize(_width, _height));
 }
 
 RenderTarget::~RenderTarget()
 {
+    vt_system::MemoryStats::Remove(vt_system::MEMORY_TEXTURES_GPU, GetRenderTargetMemorySize(_width, _height));
+
     if (_framebuffer != 0) {
         const GLuint framebuffers[] = { _framebuffer };
         glDeleteFramebuffers(1, framebuffers);
@@ -171,8 +184,15 @@ void RenderTarget::BindTexture()
 void RenderTarget::Resize(unsigned width,
                           unsigned height)
 {
+    // The storage is only reallocated when the size changes.
+    if (width == _width && height == _height)
+        return;
+
     bool errors = false;
 
+    vt_system::MemoryStats::Remove(vt_system::MEMORY_TEXTURES_GPU, GetRenderTargetMemorySize(_width, _height));
+    vt_system::MemoryStats::Add(vt_system::MEMORY_TEXTURES_GPU, GetRenderTargetMemorySize(width, height));
+
     _width = width;
     _height = height;
 
@@ -221,6 +241,18 @@ void RenderTarget::Resize(unsigned width,
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void RenderTarget::SetFilter(GLint filter)
+{
+    if (filter == _filter)
+        return;
+    _filter = filter;
+
+    BindTexture();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _filter);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 unsigned RenderTarget::GetWidth() const
 {
     return _width;
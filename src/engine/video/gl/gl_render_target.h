@@ -41,6 +41,10 @@ public:
     void Resize(unsigned width,
                 unsigned height);
 
+    //! \brief Sets the texture filter used when the render target is drawn at another size.
+    //! \param filter GL_LINEAR or GL_NEAREST.
+    void SetFilter(GLint filter);
+
     //! \brief Gets the width of the render target.
     unsigned GetWidth() const;
 
@@ -56,6 +60,9 @@ private:
     unsigned _width;
     unsigned _height;
 
+    //! \brief The texture filter, GL_LINEAR by default.
+    GLint _filter;
+
     GLuint _framebuffer;
     GLuint _texture;
     GLuint _renderbuffer_depth;
@@ -28,13 +28,30 @@ namespace gl
 {
 
 Shader::Shader(GLenum type, const std::string &data) :
-    _shader(0)
+    _shader(0),
+    _type(type),
+    _source(data)
 {
+}
+
+Shader::~Shader()
+{
+    if (_shader != 0) {
+        glDeleteShader(_shader);
+        _shader = 0;
+    }
+}
+
+bool Shader::_Compile() const
+{
+    if (_shader != 0)
+        return true;
+
     bool errors = false;
 
     // Create the shader.
     if (!errors) {
-        _shader = glCreateShader(type);
+        _shader = glCreateShader(_type);
 
         GLenum error = glGetError();
         if (error != GL_NO_ERROR) {
@@ -46,8 +63,8 @@ Shader::Shader(GLenum type, const std::string &data) :
 
     // Send the source code to the shader.
     if (!errors) {
-        const GLint length[] = { static_cast<GLint>(data.length()) };
-        const GLchar* strings[] = { data.c_str() };
+        const GLint length[] = { static_cast<GLint>(_source.length()) };
+        const GLchar* strings[] = { _source.c_str() };
 
         glShaderSource(_shader, 1, strings, length);
 
@@ -77,14 +94,14 @@ Shader::Shader(GLenum type, const std::string &data) :
 
     // Check for shader syntax errors.
     if (errors)
-        return;
+        return false;
 
     GLint is_compiled = -1;
     glGetShaderiv(_shader, GL_COMPILE_STATUS, &is_compiled);
 
     // Return if the shader compilation went well
     if (is_compiled != 0)
-        return;
+        return true;
 
     // Retrieve the compiler output.
     GLint length = 0;
@@ -104,14 +121,7 @@ Shader::Shader(GLenum type, const std::string &data) :
     log = nullptr;
 
     assert(is_compiled != 0);
-}
-
-Shader::~Shader()
-{
-    if (_shader != 0) {
-        glDeleteShader(_shader);
-        _shader = 0;
-    }
+    return false;
 }
 
 Shader::Shader(const Shader&)
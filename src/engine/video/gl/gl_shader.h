@@ -28,7 +28,9 @@ namespace gl
 // Forward declarations.
 class ShaderProgram;
 
-//! \brief A class for an OpenGL shader.
+/** \brief A class for an OpenGL shader.
+*** The shader is only compiled once a program not found in the program binary cache needs it.
+**/
 class Shader
 {
     friend class ShaderProgram;
@@ -37,8 +39,21 @@ public:
     Shader(GLenum type, const std::string &data);
     ~Shader();
 
+    const std::string& GetSource() const {
+        return _source;
+    }
+
 private:
-    GLuint _shader;
+    //! \brief The OpenGL shader, 0 until compiled.
+    mutable GLuint _shader;
+
+    GLenum _type;
+    std::string _source;
+
+    /** \brief Compiles the shader, if not done yet.
+    *** \return False if the shader couldn't be compiled.
+    **/
+    bool _Compile() const;
 
     //
     // The copy constructor and assignment operator are hidden by design
@@ -45,6 +45,287 @@ namespace shader_definitions
         "    gl_TexCoord[0].xy = in_TexCoords.xy;\n"
         "}\n";
 
+    const char PARTICLE_VERTEX[] =
+        "#version 110\n"
+        "\n"
+        "//\n"
+        "// Expands a particle instance into a rotated quad.\n"
+        "// The texture rectangle is (u1, v1, u2, v2), shared by every particle.\n"
+        "//\n"
+        "\n"
+        "uniform mat4 u_Model;\n"
+        "uniform mat4 u_View;\n"
+        "uniform mat4 u_Projection;\n"
+        "uniform vec4 u_TextureRect;\n"
+        "\n"
+        "attribute vec2 in_Corner;\n"
+        "attribute vec2 in_Position;\n"
+        "attribute vec2 in_HalfSize;\n"
+        "attribute float in_Rotation;\n"
+        "attribute vec4 in_Color;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 corner = in_Corner * in_HalfSize;\n"
+        "    float cos_angle = cos(in_Rotation);\n"
+        "    float sin_angle = sin(in_Rotation);\n"
+        "    vec2 vertex = in_Position + vec2(corner.x * cos_angle - corner.y * sin_angle,\n"
+        "                                     corner.x * sin_angle + corner.y * cos_angle);\n"
+        "\n"
+        "    gl_Position       = u_Projection * (u_View * (u_Model * vec4(vertex, 0.0, 1.0)));\n"
+        "    gl_FrontColor     = in_Color;\n"
+        "    gl_TexCoord[0].xy = mix(u_TextureRect.xy, u_TextureRect.zw, in_Corner * 0.5 + 0.5);\n"
+        "}\n";
+
+    const char PARTICLE_SIMULATION_VERTEX[] =
+        "#version 130\n"
+        "\n"
+        "//\n"
+        "// Advances a particle by one step, and respawns it once it has expired.\n"
+        "// The outputs are captured by transform feedback, in the layout of the inputs,\n"
+        "// and their first nine floats are the instance read by the particle shader.\n"
+        "// The per-particle random values are drawn again each step from the particle\n"
+        "// seed, so that only the seed has to be stored.\n"
+        "//\n"
+        "\n"
+        "// Delta time, random number of the step, emitting, system age.\n"
+        "uniform vec4 u_Step;\n"
+        "// Emission rate, or 0.0 to emit whenever possible, emission period of a slot.\n"
+        "uniform vec4 u_Emission;\n"
+        "// Shape, radius, effect orientation, spin.\n"
+        "uniform vec4 u_EmitterShape;\n"
+        "// Position, second position.\n"
+        "uniform vec4 u_EmitterPosition;\n"
+        "// Initial speed, its variation, orientation, angle variation.\n"
+        "uniform vec4 u_EmitterSpeed;\n"
+        "// Omnidirectional, random initial angle, position variation.\n"
+        "uniform vec4 u_EmitterFlags;\n"
+        "// Lifetime, its variation, wave motion used, attractor falloff.\n"
+        "uniform vec4 u_Lifetime;\n"
+        "// Acceleration, its variation.\n"
+        "uniform vec4 u_Acceleration;\n"
+        "// Wind velocity, its variation.\n"
+        "uniform vec4 u_Wind;\n"
+        "// Damping, its variation, wave length, its variation.\n"
+        "uniform vec4 u_Damping;\n"
+        "// Wave amplitude, its variation, tangential acceleration, its variation.\n"
+        "uniform vec4 u_Wave;\n"
+        "// Radial acceleration, its variation, attractor.\n"
+        "uniform vec4 u_Radial;\n"
+        "// Image half size, rotation used, rotate to velocity.\n"
+        "uniform vec4 u_Render;\n"
+        "// Speed scale, its minimum, its maximum, speed scale used.\n"
+        "uniform vec4 u_SpeedScale;\n"
+        "\n"
+        "// The keyframed properties, sampled over the particle lifetime.\n"
+        "// Sizes are (size, size variation), rotations (speed, speed variation, unused).\n"
+        "uniform vec4 u_KeyframeColor[16];\n"
+        "uniform vec4 u_KeyframeColorVariation[16];\n"
+        "uniform vec4 u_KeyframeSize[16];\n"
+        "uniform vec4 u_KeyframeRotation[16];\n"
+        "\n"
+        "in vec2 in_Position;\n"
+        "in vec2 in_HalfSize;\n"
+        "in float in_Rotation;\n"
+        "in vec4 in_Color;\n"
+        "in vec2 in_Velocity;\n"
+        "in float in_Time;\n"
+        "in float in_Seed;\n"
+        "in float in_Angle;\n"
+        "in float in_Emission;\n"
+        "\n"
+        "out vec2 out_Position;\n"
+        "out vec2 out_HalfSize;\n"
+        "out float out_Rotation;\n"
+        "out vec4 out_Color;\n"
+        "out vec2 out_Velocity;\n"
+        "out float out_Time;\n"
+        "out float out_Seed;\n"
+        "out float out_Angle;\n"
+        "out float out_Emission;\n"
+        "\n"
+        "const float TWO_PI = 6.2831853;\n"
+        "const float HALF_PI = 1.5707963;\n"
+        "\n"
+        "// A random number in [0, 1), from the seed and the property index.\n"
+        "float Random(float seed, float index)\n"
+        "{\n"
+        "    return fract(sin(seed * 78.233 + index * 12.9898) * 43758.5453);\n"
+        "}\n"
+        "\n"
+        "// A random number in [-1, 1).\n"
+        "float Variation(float seed, float index)\n"
+        "{\n"
+        "    return Random(seed, index) * 2.0 - 1.0;\n"
+        "}\n"
+        "\n"
+        "vec2 Rotate(vec2 point, float angle)\n"
+        "{\n"
+        "    float cos_angle = cos(angle);\n"
+        "    float sin_angle = sin(angle);\n"
+        "    return vec2(point.x * cos_angle - point.y * sin_angle,\n"
+        "                point.x * sin_angle + point.y * cos_angle);\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    float delta_time = u_Step.x;\n"
+        "    float age = u_Step.w;\n"
+        "\n"
+        "    vec2 position = in_Position;\n"
+        "    vec2 velocity = in_Velocity;\n"
+        "    float time = in_Time;\n"
+        "    float seed = in_Seed;\n"
+        "    float angle = in_Angle;\n"
+        "    float emission = in_Emission;\n"
+        "\n"
+        "    // A dead particle has a negative seed.\n"
+        "    float lifetime = u_Lifetime.x + u_Lifetime.y * Variation(seed, 0.0);\n"
+        "    bool alive = seed >= 0.0 && time <= lifetime;\n"
+        "    bool respawned = false;\n"
+        "\n"
+        "    // Each slot emits at fixed times in the emission period, and an expired\n"
+        "    // particle waits for the next one, unless it has missed one while alive.\n"
+        "    if (!alive && u_Step.z > 0.5) {\n"
+        "        float slot_emission = 0.0;\n"
+        "        bool due = true;\n"
+        "        if (u_Emission.x > 0.0) {\n"
+        "            float offset = float(gl_VertexID) / u_Emission.x;\n"
+        "            slot_emission = floor((age - offset) / u_Emission.y);\n"
+        "            due = age >= offset && slot_emission > emission;\n"
+        "        }\n"
+        "\n"
+        "        if (due) {\n"
+        "            respawned = true;\n"
+        "            emission = slot_emission;\n"
+        "            seed = Random(fract(float(gl_VertexID) * 0.618034), u_Step.y);\n"
+        "            lifetime = u_Lifetime.x + u_Lifetime.y * Variation(seed, 0.0);\n"
+        "\n"
+        "            float r1 = Random(seed, 1.0);\n"
+        "            float r2 = Random(seed, 2.0);\n"
+        "            float shape = u_EmitterShape.x;\n"
+        "            vec2 circle = vec2(cos(r1 * TWO_PI), sin(r1 * TWO_PI));\n"
+        "            if (shape < 0.5)\n"
+        "                position = u_EmitterPosition.xy;\n"
+        "            else if (shape < 1.5 || shape > 4.5)\n"
+        "                position = mix(u_EmitterPosition.xy, u_EmitterPosition.zw, vec2(r1, r2));\n"
+        "            else if (shape < 2.5)\n"
+        "                position = u_EmitterShape.y * circle + u_EmitterPosition.xy;\n"
+        "            else if (shape < 3.5)\n"
+        "                position = u_EmitterPosition.xy * circle + u_EmitterPosition.zw;\n"
+        "            else\n"
+        "                position = u_EmitterShape.y * sqrt(r2) * circle + u_EmitterPosition.xy;\n"
+        "\n"
+        "            position += u_EmitterFlags.zw * vec2(Variation(seed, 3.0), Variation(seed, 4.0));\n"
+        "            position = Rotate(position, u_EmitterShape.z);\n"
+        "\n"
+        "            float speed = u_EmitterSpeed.x + u_EmitterSpeed.y * Variation(seed, 5.0);\n"
+        "            float direction = u_EmitterSpeed.z + u_EmitterSpeed.w * Variation(seed, 6.0);\n"
+        "            if (u_EmitterFlags.x > 0.5)\n"
+        "                direction = Random(seed, 6.0) * TWO_PI;\n"
+        "            velocity = speed * vec2(cos(direction), sin(direction));\n"
+        "\n"
+        "            angle = u_EmitterFlags.y > 0.5 ? Random(seed, 7.0) * TWO_PI : 0.0;\n"
+        "            time = 0.0;\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    if (!alive && !respawned) {\n"
+        "        // The particle isn't emitted anymore, and is drawn as an empty quad.\n"
+        "        out_Position = position;\n"
+        "        out_HalfSize = vec2(0.0);\n"
+        "        out_Rotation = 0.0;\n"
+        "        out_Color = vec4(0.0);\n"
+        "        out_Velocity = velocity;\n"
+        "        out_Time = time;\n"
+        "        out_Seed = -1.0;\n"
+        "        out_Angle = angle;\n"
+        "        out_Emission = emission;\n"
+        "        return;\n"
+        "    }\n"
+        "\n"
+        "    // The keyframed properties, at the particle time.\n"
+        "    float keyframe = clamp(time / lifetime, 0.0, 1.0) * 15.0;\n"
+        "    int k = min(int(keyframe), 14);\n"
+        "    float a = keyframe - float(k);\n"
+        "\n"
+        "    vec4 size_sample = mix(u_KeyframeSize[k], u_KeyframeSize[k + 1], a);\n"
+        "    vec2 size = size_sample.xy + size_sample.zw * vec2(Variation(seed, 8.0), Variation(seed, 9.0));\n"
+        "    vec4 rotation_sample = mix(u_KeyframeRotation[k], u_KeyframeRotation[k + 1], a);\n"
+        "    float rotation_speed = rotation_sample.x + rotation_sample.y * Variation(seed, 10.0);\n"
+        "    vec4 color = mix(u_KeyframeColor[k], u_KeyframeColor[k + 1], a) +\n"
+        "                 mix(u_KeyframeColorVariation[k], u_KeyframeColorVariation[k + 1], a) *\n"
+        "                 vec4(Variation(seed, 11.0), Variation(seed, 12.0), Variation(seed, 13.0), Variation(seed, 14.0));\n"
+        "\n"
+        "    vec2 wind = u_Wind.xy + u_Wind.zw * vec2(Variation(seed, 15.0), Variation(seed, 16.0));\n"
+        "    vec2 combined_velocity = velocity + wind;\n"
+        "\n"
+        "    if (!respawned) {\n"
+        "        float rotation_direction = 1.0;\n"
+        "        if (u_EmitterShape.w > 1.5)\n"
+        "            rotation_direction = Random(seed, 17.0) < 0.5 ? -1.0 : 1.0;\n"
+        "        else if (u_EmitterShape.w > 0.5)\n"
+        "            rotation_direction = -1.0;\n"
+        "        angle += rotation_speed * rotation_direction * delta_time;\n"
+        "\n"
+        "        float wave_half_amplitude = 0.5 * (u_Wave.x + u_Wave.y * Variation(seed, 18.0));\n"
+        "        if (u_Lifetime.z > 0.5 && wave_half_amplitude > 0.0) {\n"
+        "            float wave_length = u_Damping.z + u_Damping.w * Variation(seed, 19.0);\n"
+        "            vec2 tangent = vec2(-combined_velocity.y, combined_velocity.x);\n"
+        "            float tangent_length = length(tangent);\n"
+        "            if (tangent_length > 0.0)\n"
+        "                combined_velocity += tangent / tangent_length * wave_half_amplitude * sin(TWO_PI / wave_length * time);\n"
+        "        }\n"
+        "\n"
+        "        position += combined_velocity * delta_time;\n"
+        "\n"
+        "        vec2 acceleration = u_Acceleration.xy + u_Acceleration.zw * vec2(Variation(seed, 20.0), Variation(seed, 21.0));\n"
+        "        velocity += acceleration * delta_time;\n"
+        "\n"
+        "        float radial = u_Radial.x + u_Radial.y * Variation(seed, 22.0);\n"
+        "        float tangential = u_Wave.z + u_Wave.w * Variation(seed, 23.0);\n"
+        "        if (radial != 0.0 || tangential != 0.0) {\n"
+        "            vec2 to_particle = position - u_Radial.zw;\n"
+        "            float attractor_distance = length(to_particle);\n"
+        "            if (attractor_distance != 0.0)\n"
+        "                to_particle /= attractor_distance;\n"
+        "\n"
+        "            float attraction = u_Lifetime.w != 0.0 ? 1.0 - u_Lifetime.w * attractor_distance : 1.0;\n"
+        "            if (attraction > 0.0)\n"
+        "                velocity += to_particle * radial * delta_time * attraction;\n"
+        "            velocity += vec2(-to_particle.y, to_particle.x) * tangential * delta_time;\n"
+        "        }\n"
+        "\n"
+        "        float damping = u_Damping.x + u_Damping.y * Variation(seed, 24.0);\n"
+        "        if (damping != 1.0)\n"
+        "            velocity *= pow(damping, delta_time);\n"
+        "\n"
+        "        time += delta_time;\n"
+        "    }\n"
+        "\n"
+        "    // The instance drawn.\n"
+        "    vec2 half_size = u_Render.xy * size;\n"
+        "    float rotation = 0.0;\n"
+        "    if (u_Render.z > 0.5) {\n"
+        "        rotation = angle;\n"
+        "        if (u_Render.w > 0.5) {\n"
+        "            rotation += HALF_PI + atan(combined_velocity.y, combined_velocity.x);\n"
+        "            if (u_SpeedScale.w > 0.5)\n"
+        "                half_size.y *= clamp(u_SpeedScale.x * length(combined_velocity), u_SpeedScale.y, u_SpeedScale.z);\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    out_Position = position;\n"
+        "    out_HalfSize = half_size;\n"
+        "    out_Rotation = rotation;\n"
+        "    out_Color = color;\n"
+        "    out_Velocity = velocity;\n"
+        "    out_Time = time;\n"
+        "    out_Seed = seed;\n"
+        "    out_Angle = angle;\n"
+        "    out_Emission = emission;\n"
+        "}\n";
+
     const char SOLID_FRAGMENT[] =
         "#version 110\n"
         "\n"
@@ -122,11 +403,12 @@ namespace shader_definitions
         "}\n";
 
     const char SPRITE_GRAYSCALE_FRAGMENT[] =
-        "\n"
         "#version 110\n"
         "\n"
         "//\n"
-        "// Samples a texture and converts to grayscale for a fragment's output.\n"
+        "// Samples a texture and converts it to grayscale for a fragment's output.\n"
+        "// The texel is converted before the colors are applied, so that\n"
+        "// grayscale images can still be tinted and faded.\n"
         "//\n"
         "\n"
         "uniform vec4 u_Color;\n"
@@ -134,7 +416,12 @@ namespace shader_definitions
         "\n"
         "void main(void)\n"
         "{\n"
-        "        gl_FragColor.rgba = vec4(texture2D(u_Texture, gl_TexCoord[0].xy));\n"
+        "        vec4 texel = texture2D(u_Texture, gl_TexCoord[0].xy);\n"
+        "\n"
+        "        // Grayscale filter\n"
+        "        float sum = dot(texel.rgb, vec3(0.299, 0.587, 0.114));\n"
+        "\n"
+        "        gl_FragColor = vec4(sum, sum, sum, texel.a);\n"
         "        gl_FragColor *= gl_Color;\n"
         "        gl_FragColor *= u_Color;\n"
         "\n"
@@ -143,17 +430,219 @@ namespace shader_definitions
         "        {\n"
         "            discard;\n"
         "        }\n"
+        "}\n";
+
+    const char AMBIENT_EFFECTS_FRAGMENT[] =
+        "#version 110\n"
         "\n"
-        "        // Grayscale filter\n"
-        "        gl_FragColor.r *= 0.299;\n"
-        "        gl_FragColor.g *= 0.587;\n"
-        "        gl_FragColor.b *= 0.114;\n"
+        "//\n"
+        "// Tiles the ambient overlay, and applies the light overlay color over it.\n"
+        "// The overlay texture rectangle is (u1, v1, u2, v2), repeated every texture\n"
+        "// coordinate unit. The light color is clear when there is no light overlay.\n"
+        "// Both overlays are premultiplied into a single output, to be blended\n"
+        "// with (GL_ONE, GL_ONE_MINUS_SRC_ALPHA) like two normal blendings would.\n"
+        "//\n"
         "\n"
-        "        float sum = gl_FragColor.r + gl_FragColor.g + gl_FragColor.b;\n"
+        "uniform vec4 u_Color;\n"
+        "uniform sampler2D u_Texture;\n"
+        "uniform vec4 u_TextureRect;\n"
         "\n"
-        "        gl_FragColor.r = sum;\n"
-        "        gl_FragColor.g = sum;\n"
-        "        gl_FragColor.b = sum;\n"
+        "void main(void)\n"
+        "{\n"
+        "        vec2 tile = fract(gl_TexCoord[0].xy);\n"
+        "        vec4 overlay = texture2D(u_Texture, mix(u_TextureRect.xy, u_TextureRect.zw, tile));\n"
+        "        overlay *= gl_Color;\n"
+        "\n"
+        "        float alpha = 1.0 - (1.0 - overlay.a) * (1.0 - u_Color.a);\n"
+        "\n"
+        "        // Alpha Test\n"
+        "        if (alpha <= 0.0)\n"
+        "        {\n"
+        "            discard;\n"
+        "        }\n"
+        "\n"
+        "        gl_FragColor.rgb = u_Color.rgb * u_Color.a + overlay.rgb * overlay.a * (1.0 - u_Color.a);\n"
+        "        gl_FragColor.a = alpha;\n"
+        "}\n";
+
+    const char TEXT_DISTANCE_FIELD_FRAGMENT[] =
+        "#version 110\n"
+        "\n"
+        "//\n"
+        "// Draws text from the signed distance fields of its glyphs, stored in the\n"
+        "// texture alpha channel, 0.5 being the glyph edges. The vertex colors are\n"
+        "// the text color. The shadow is the same glyph sampled u_ShadowOffset away,\n"
+        "// in texture coordinates, and drawn under the text in the same pass.\n"
+        "//\n"
+        "\n"
+        "uniform vec4 u_Color;\n"
+        "uniform sampler2D u_Texture;\n"
+        "uniform vec4 u_ShadowColor;\n"
+        "uniform vec4 u_ShadowOffset;\n"
+        "\n"
+        "float Coverage(float distance, float smoothing)\n"
+        "{\n"
+        "        return clamp((distance - 0.5) / smoothing + 0.5, 0.0, 1.0);\n"
+        "}\n"
+        "\n"
+        "void main(void)\n"
+        "{\n"
+        "        float distance = texture2D(u_Texture, gl_TexCoord[0].xy).a;\n"
+        "        float shadow_distance = texture2D(u_Texture, gl_TexCoord[0].xy - u_ShadowOffset.xy).a;\n"
+        "\n"
+        "        // The edges are smoothed over about a pixel, whatever the text size.\n"
+        "        float smoothing = max(fwidth(distance), 0.001);\n"
+        "\n"
+        "        vec4 color = gl_Color * u_Color;\n"
+        "        color.a *= Coverage(distance, smoothing);\n"
+        "        float shadow_alpha = u_ShadowColor.a * Coverage(shadow_distance, smoothing);\n"
+        "\n"
+        "        // The text is blended over its shadow.\n"
+        "        float alpha = color.a + shadow_alpha * (1.0 - color.a);\n"
+        "\n"
+        "        // Alpha Test\n"
+        "        if (alpha <= 0.0)\n"
+        "        {\n"
+        "            discard;\n"
+        "        }\n"
+        "\n"
+        "        gl_FragColor.rgb = (color.rgb * color.a + u_ShadowColor.rgb * shadow_alpha * (1.0 - color.a)) / alpha;\n"
+        "        gl_FragColor.a = alpha;\n"
+        "}\n";
+
+    const char WEATHER_FRAGMENT[] =
+        "#version 110\n"
+        "\n"
+        "//\n"
+        "// Draws a procedural weather over the whole viewport: Rain streaks, snow\n"
+        "// flakes, fog or heat haze, according to the weather type.\n"
+        "// The texture coordinates are the standard screen coordinates, in pixels,\n"
+        "// from the weather origin shifted by the camera movements.\n"
+        "// The output is premultiplied, to be blended with (GL_ONE, GL_ONE_MINUS_SRC_ALPHA).\n"
+        "//\n"
+        "\n"
+        "uniform vec4 u_Color;\n"
+        "// Weather type, time in seconds, intensity in [0, 1], unused.\n"
+        "uniform vec4 u_Weather;\n"
+        "// Wind velocity in pixels per second, unused.\n"
+        "uniform vec4 u_Wind;\n"
+        "\n"
+        "float hash(vec2 p)\n"
+        "{\n"
+        "    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);\n"
+        "}\n"
+        "\n"
+        "float noise(vec2 p)\n"
+        "{\n"
+        "    vec2 i = floor(p);\n"
+        "    vec2 f = fract(p);\n"
+        "    f = f * f * (3.0 - 2.0 * f);\n"
+        "    return mix(mix(hash(i), hash(i + vec2(1.0, 0.0)), f.x),\n"
+        "               mix(hash(i + vec2(0.0, 1.0)), hash(i + vec2(1.0, 1.0)), f.x), f.y);\n"
+        "}\n"
+        "\n"
+        "float fbm(vec2 p)\n"
+        "{\n"
+        "    float value = 0.0;\n"
+        "    float amplitude = 0.5;\n"
+        "    for (int i = 0; i < 4; ++i) {\n"
+        "        value += amplitude * noise(p);\n"
+        "        p *= 2.0;\n"
+        "        amplitude *= 0.5;\n"
+        "    }\n"
+        "    return value;\n"
+        "}\n"
+        "\n"
+        "// Thin streaks falling in columns, slanted by the wind, on three depths.\n"
+        "float rain(vec2 p, float time, float intensity)\n"
+        "{\n"
+        "    float alpha = 0.0;\n"
+        "    for (int layer = 0; layer < 3; ++layer) {\n"
+        "        float depth = 1.0 + float(layer) * 0.5;\n"
+        "        float speed = 1100.0 / depth;\n"
+        "        vec2 q = p * depth;\n"
+        "        q.x -= q.y * u_Wind.x / speed;\n"
+        "        float column = floor(q.x / 7.0);\n"
+        "        float offset = hash(vec2(column, float(layer)));\n"
+        "        float present = step(hash(vec2(column, float(layer) + 11.0)), intensity);\n"
+        "        float phase = fract((q.y - time * speed * (0.8 + 0.4 * offset)) / 300.0 + offset);\n"
+        "        float streak = smoothstep(0.0, 0.01, phase) * (1.0 - smoothstep(0.02, 0.09, phase));\n"
+        "        float thin = 1.0 - smoothstep(0.05, 0.15, abs(fract(q.x / 7.0) - 0.5));\n"
+        "        alpha += present * streak * thin * (0.7 / depth);\n"
+        "    }\n"
+        "    return alpha;\n"
+        "}\n"
+        "\n"
+        "// Round flakes falling and swaying, one per grid cell at most, on three depths.\n"
+        "float snow(vec2 p, float time, float intensity)\n"
+        "{\n"
+        "    float alpha = 0.0;\n"
+        "    for (int layer = 0; layer < 3; ++layer) {\n"
+        "        float cell_size = 48.0 - float(layer) * 12.0;\n"
+        "        vec2 drift = u_Wind.xy + vec2(0.0, 60.0 - float(layer) * 15.0);\n"
+        "        vec2 q = (p - time * drift) / cell_size + float(layer) * 0.37;\n"
+        "        vec2 cell = floor(q);\n"
+        "        float seed = hash(cell + float(layer) * 17.0);\n"
+        "        vec2 center = vec2(hash(cell + 3.1), hash(cell + 7.7)) * 0.6 + 0.2;\n"
+        "        center.x += sin(time * 1.5 + seed * 6.2832) * 0.15;\n"
+        "        float radius = 0.06 + 0.06 * hash(cell + 1.3);\n"
+        "        float flake = 1.0 - smoothstep(radius * 0.4, radius, length(fract(q) - center));\n"
+        "        alpha += step(seed, intensity) * flake * (1.0 - float(layer) * 0.25);\n"
+        "    }\n"
+        "    return alpha;\n"
+        "}\n"
+        "\n"
+        "// Layered noise drifting along the wind.\n"
+        "float fog(vec2 p, float time, float intensity)\n"
+        "{\n"
+        "    float density = fbm((p - time * u_Wind.xy) / 256.0 + vec2(time * 0.02, 0.0));\n"
+        "    return smoothstep(0.35, 0.85, density) * intensity;\n"
+        "}\n"
+        "\n"
+        "// Shimmering bands rising through the screen.\n"
+        "float heat_haze(vec2 p, float time, float intensity)\n"
+        "{\n"
+        "    float waves = sin(p.y * 0.06 + time * 3.0 + noise(p / 48.0 + vec2(0.0, time)) * 6.0);\n"
+        "    return (0.5 + 0.5 * waves) * 0.25 * intensity;\n"
+        "}\n"
+        "\n"
+        "void main(void)\n"
+        "{\n"
+        "        vec2 p = gl_TexCoord[0].xy;\n"
+        "        float time = u_Weather.y;\n"
+        "        float intensity = u_Weather.z;\n"
+        "\n"
+        "        float alpha = 0.0;\n"
+        "        if (u_Weather.x < 1.5)\n"
+        "            alpha = rain(p, time, intensity);\n"
+        "        else if (u_Weather.x < 2.5)\n"
+        "            alpha = snow(p, time, intensity);\n"
+        "        else if (u_Weather.x < 3.5)\n"
+        "            alpha = fog(p, time, intensity);\n"
+        "        else\n"
+        "            alpha = heat_haze(p, time, intensity);\n"
+        "\n"
+        "        alpha = clamp(alpha, 0.0, 1.0) * u_Color.a;\n"
+        "\n"
+        "        // Alpha Test\n"
+        "        if (alpha <= 0.0)\n"
+        "        {\n"
+        "            discard;\n"
+        "        }\n"
+        "\n"
+        "        gl_FragColor = vec4(u_Color.rgb * alpha, alpha);\n"
+        "}\n";
+
+    const char DISCARD_FRAGMENT[] =
+        "#version 130\n"
+        "\n"
+        "//\n"
+        "// Outputs nothing, for the programs only run for their transform feedback.\n"
+        "//\n"
+        "\n"
+        "void main(void)\n"
+        "{\n"
+        "        discard;\n"
         "}\n";
 
 } // namespace shader_definition
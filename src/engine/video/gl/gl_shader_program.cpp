@@ -15,6 +15,8 @@
 
 #include "gl_shader_program.h"
 
+#include "gl_debug.h"
+#include "gl_program_binary_cache.h"
 #include "gl_shader.h"
 
 #include "utils/utils_common.h"
@@ -31,16 +33,35 @@ namespace gl
 
 ShaderProgram::ShaderProgram(const Shader* vertex_shader,
                              const Shader* fragment_shader,
-                             const std::vector<std::string>& attributes) :
+                             const std::vector<std::string>& attributes,
+                             const std::vector<std::string>& feedback_varyings) :
     _program(0),
+    _shaders_attached(false),
+    _from_cache(false),
+    _attributes(attributes),
+    _feedback_varyings(feedback_varyings),
     _vertex_shader(vertex_shader),
     _fragment_shader(fragment_shader)
 {
-    bool errors = false;
-
     assert(_vertex_shader != nullptr);
     assert(_fragment_shader != nullptr);
 
+    // Initialize the uniforms cache.
+    for (uint32_t i = 0; i < shader_uniforms::Count; ++i) {
+        _uniforms[i].location = -1;
+        _uniforms[i].is_set = false;
+        memset(_uniforms[i].data, 0, sizeof(_uniforms[i].data));
+        _uniforms[i].integer = 0;
+    }
+}
+
+bool ShaderProgram::Build()
+{
+    if (_program != 0)
+        return true;
+
+    bool errors = false;
+
     // Create the program.
     if (!errors) {
         _program = glCreateProgram();
@@ -53,9 +74,24 @@ ShaderProgram::ShaderProgram(const Shader* vertex_shader,
         }
     }
 
+    // Load the program linked by a previous run, if any.
+    const uint64_t cache_key = ProgramBinaryCache::ComputeKey(_vertex_shader->GetSource(),
+                                                              _fragment_shader->GetSource(),
+                                                              _attributes, _feedback_varyings);
+    if (!errors && ProgramBinaryCache::Load(_program, cache_key)) {
+        _from_cache = true;
+        _CacheUniformLocations();
+        return true;
+    }
+
+    // Compile the shaders, unless already done for another program.
+    if (!errors && (!_vertex_shader->_Compile() || !_fragment_shader->_Compile()))
+        errors = true;
+
     // Attach the vertex shader.
     if (!errors) {
         glAttachShader(_program, _vertex_shader->_shader);
+        _shaders_attached = true;
 
         GLenum error = glGetError();
         if (error != GL_NO_ERROR) {
@@ -86,9 +122,9 @@ ShaderProgram::ShaderProgram(const Shader* vertex_shader,
     // Bind the attributes.
     if (!errors) {
         std::vector<std::string>::const_iterator i;
-        i = attributes.begin();
+        i = _attributes.begin();
         GLuint count = 0;
-        while (i != attributes.end() && !errors) {
+        while (i != _attributes.end() && !errors) {
             glBindAttribLocation(_program, count, i->c_str());
 
             GLenum error = glGetError();
@@ -106,8 +142,33 @@ ShaderProgram::ShaderProgram(const Shader* vertex_shader,
         }
     }
 
+    // Declare the transform feedback outputs.
+    if (!errors && !_feedback_varyings.empty()) {
+#ifndef __APPLE__
+        std::vector<const char*> varyings;
+        for (uint32_t i = 0; i < _feedback_varyings.size(); ++i)
+            varyings.push_back(_feedback_varyings[i].c_str());
+        glTransformFeedbackVaryings(_program, varyings.size(), &varyings[0], GL_INTERLEAVED_ATTRIBS);
+
+        GLenum error = glGetError();
+        if (error != GL_NO_ERROR) {
+            errors = true;
+            PRINT_ERROR << "Failed to set the shader program transform feedback varyings. Shader Program ID: " <<
+                           vt_utils::NumberToString(_program) <<
+                           std::endl;
+            assert(error == GL_NO_ERROR);
+        }
+#else
+        errors = true;
+        PRINT_ERROR << "Transform feedback isn't supported on this platform. Shader Program ID: " <<
+                       vt_utils::NumberToString(_program) <<
+                       std::endl;
+#endif
+    }
+
     // Link the shader program.
     if (!errors) {
+        ProgramBinaryCache::PrepareLink(_program);
         glLinkProgram(_program);
 
         GLenum error = glGetError();
@@ -122,14 +183,17 @@ ShaderProgram::ShaderProgram(const Shader* vertex_shader,
 
     // Check for linkage errors.
     if (errors)
-        return;
+        return false;
 
     GLint is_linked = -1;
     glGetProgramiv(_program, GL_LINK_STATUS, &is_linked);
 
-    // Return if linkage went well
-    if (is_linked != 0)
-        return;
+    // Resolve the uniform locations, and save the program for the next runs, if linkage went well
+    if (is_linked != 0) {
+        _CacheUniformLocations();
+        ProgramBinaryCache::Store(_program, cache_key);
+        return true;
+    }
 
     // Retrieve the linker output.
     GLint length = 0;
@@ -149,12 +213,15 @@ ShaderProgram::ShaderProgram(const Shader* vertex_shader,
     log = nullptr;
 
     assert(is_linked != 0);
+    return false;
 }
 
 ShaderProgram::~ShaderProgram()
 {
-    glDetachShader(_program, _vertex_shader->_shader);
-    glDetachShader(_program, _fragment_shader->_shader);
+    if (_shaders_attached) {
+        glDetachShader(_program, _vertex_shader->_shader);
+        glDetachShader(_program, _fragment_shader->_shader);
+    }
 
     if (_program != 0) {
         glDeleteProgram(_program);
@@ -166,9 +233,13 @@ bool ShaderProgram::Load()
 {
     bool result = true;
 
+    // The programs not warmed up yet are built when first used.
+    if (_program == 0)
+        Build();
+
     glUseProgram(_program);
 
-    GLenum error = glGetError();
+    GLenum error = GetError();
     if (error != GL_NO_ERROR) {
         result = false;
         PRINT_ERROR << "Failed to load the shader program. Shader Program ID: " <<
@@ -184,10 +255,10 @@ bool ShaderProgram::UpdateUniform(const std::string& uniform, float value)
 {
     bool result = true;
 
-    GLint location = glGetUniformLocation(_program, uniform.c_str());
+    GLint location = _GetUniformLocation(uniform);
     glUniform1f(location, value);
 
-    GLenum error = glGetError();
+    GLenum error = GetError();
     if (error != GL_NO_ERROR) {
         result = false;
         PRINT_ERROR << "Failed to update the shader program uniform. Shader Program ID: " <<
@@ -203,10 +274,10 @@ bool ShaderProgram::UpdateUniform(const std::string& uniform, int32_t value)
 {
     bool result = true;
 
-    GLint location = glGetUniformLocation(_program, uniform.c_str());
+    GLint location = _GetUniformLocation(uniform);
     glUniform1i(location, value);
 
-    GLenum error = glGetError();
+    GLenum error = GetError();
     if (error != GL_NO_ERROR) {
         result = false;
         PRINT_ERROR << "Failed to update the shader program uniform. Shader Program ID: " <<
@@ -222,7 +293,7 @@ bool ShaderProgram::UpdateUniform(const std::string& uniform, const float* data,
 {
     bool result = false;
 
-    GLint location = glGetUniformLocation(_program, uniform.c_str());
+    GLint location = _GetUniformLocation(uniform);
 
     // This function currently only supports matrices and vectors.
     assert(data != nullptr && (length == 4 || length == 16));
@@ -241,7 +312,7 @@ bool ShaderProgram::UpdateUniform(const std::string& uniform, const float* data,
         }
     }
 
-    GLenum error = glGetError();
+    GLenum error = GetError();
     if (error != GL_NO_ERROR) {
         result = false;
         PRINT_ERROR << "Failed to update the shader program uniform. Shader Program ID: " <<
@@ -253,6 +324,126 @@ bool ShaderProgram::UpdateUniform(const std::string& uniform, const float* data,
     return result;
 }
 
+bool ShaderProgram::UpdateUniformArray(const std::string& uniform, const float* data, uint32_t count)
+{
+    bool result = true;
+
+    GLint location = _GetUniformLocation(uniform);
+
+    assert(data != nullptr);
+    if (data == nullptr)
+        return false;
+
+    glUniform4fv(location, count, data);
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        result = false;
+        PRINT_ERROR << "Failed to update the shader program uniform array. Shader Program ID: " <<
+                       vt_utils::NumberToString(_program) << " Uniform Name: " << uniform <<
+                       std::endl;
+        assert(error == GL_NO_ERROR);
+    }
+
+    return result;
+}
+
+bool ShaderProgram::UpdateUniform(shader_uniforms::ShaderUniforms uniform, int32_t value)
+{
+    assert(uniform < shader_uniforms::Count);
+
+    _CachedUniform& cached = _uniforms[uniform];
+
+    // The program doesn't use this uniform, or the value is already uploaded.
+    if (cached.location == -1 || (cached.is_set && cached.integer == value))
+        return true;
+
+    bool result = true;
+
+    glUniform1i(cached.location, value);
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        result = false;
+        PRINT_ERROR << "Failed to update the shader program uniform. Shader Program ID: " <<
+                       vt_utils::NumberToString(_program) << " Uniform Name: " <<
+                       shader_uniforms::Names[uniform] << std::endl;
+        assert(error == GL_NO_ERROR);
+    } else {
+        cached.is_set = true;
+        cached.integer = value;
+    }
+
+    return result;
+}
+
+bool ShaderProgram::UpdateUniform(shader_uniforms::ShaderUniforms uniform, const float* data, uint32_t length)
+{
+    assert(uniform < shader_uniforms::Count);
+
+    // This function currently only supports matrices and vectors.
+    assert(data != nullptr && (length == 4 || length == 16));
+    if (data == nullptr || (length != 4 && length != 16))
+        return false;
+
+    _CachedUniform& cached = _uniforms[uniform];
+
+    // The program doesn't use this uniform, or the value is already uploaded.
+    if (cached.location == -1 ||
+            (cached.is_set && memcmp(cached.data, data, length * sizeof(float)) == 0))
+        return true;
+
+    bool result = true;
+
+    if (length == 4) {
+        // The vector case.
+        glUniform4f(cached.location, data[0], data[1], data[2], data[3]);
+    }
+    else {
+        // The matrix case.
+        glUniformMatrix4fv(cached.location, 1, true, data);
+    }
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        result = false;
+        PRINT_ERROR << "Failed to update the shader program uniform. Shader Program ID: " <<
+                       vt_utils::NumberToString(_program) << " Uniform Name: " <<
+                       shader_uniforms::Names[uniform] << std::endl;
+        assert(error == GL_NO_ERROR);
+    } else {
+        cached.is_set = true;
+        memcpy(cached.data, data, length * sizeof(float));
+    }
+
+    return result;
+}
+
+void ShaderProgram::_CacheUniformLocations()
+{
+    for (uint32_t i = 0; i < shader_uniforms::Count; ++i) {
+        _uniforms[i].location = glGetUniformLocation(_program, shader_uniforms::Names[i]);
+        _uniforms[i].is_set = false;
+    }
+}
+
+GLint ShaderProgram::_GetUniformLocation(const std::string& uniform)
+{
+    // The value is about to be updated without the cache knowing about it.
+    for (uint32_t i = 0; i < shader_uniforms::Count; ++i) {
+        if (uniform == shader_uniforms::Names[i])
+            _uniforms[i].is_set = false;
+    }
+
+    std::map<std::string, GLint>::const_iterator it = _uniform_locations.find(uniform);
+    if (it != _uniform_locations.end())
+        return it->second;
+
+    GLint location = glGetUniformLocation(_program, uniform.c_str());
+    _uniform_locations[uniform] = location;
+    return location;
+}
+
 ShaderProgram::ShaderProgram(const ShaderProgram&)
 {
     throw vt_utils::Exception("Not Implemented!",
@@ -16,8 +16,11 @@
 #ifndef __GL_SHADER_PROGRAM_HEADER__
 #define __GL_SHADER_PROGRAM_HEADER__
 
+#include "gl_shader_uniforms.h"
+
 #include "utils/gl_include.h"
 
+#include <map>
 #include <vector>
 #include <string>
 
@@ -29,24 +32,93 @@ namespace gl
 // Forward declarations.
 class Shader;
 
-//! \brief A class for an OpenGL shader program.
+/** \brief A class for an OpenGL shader program.
+*** The program is built by Build(), or by its first Load(), from the program binary
+*** cache when possible, or else by compiling its shaders and linking them.
+**/
 class ShaderProgram
 {
 public:
+    /** \param feedback_varyings The vertex shader outputs captured by transform feedback,
+    *** interleaved in the given order. Requires OpenGL 3.0 when not empty.
+    **/
     ShaderProgram(const Shader* vertex_shader,
                   const Shader* fragment_shader,
-                  const std::vector<std::string>& attributes);
+                  const std::vector<std::string>& attributes,
+                  const std::vector<std::string>& feedback_varyings = std::vector<std::string>());
     ~ShaderProgram();
 
+    /** \brief Creates and links the program, if not done yet.
+    *** \return False if the program couldn't be linked.
+    **/
+    bool Build();
+
+    //! \brief Tells whether Build() was done.
+    bool IsBuilt() const {
+        return _program != 0;
+    }
+
+    //! \brief Tells whether the program was loaded from the program binary cache.
+    bool IsFromCache() const {
+        return _from_cache;
+    }
+
+    //! \brief Uses the program, building it first if needed.
     bool Load();
 
     bool UpdateUniform(const std::string& uniform, float value);
     bool UpdateUniform(const std::string& uniform, int32_t value);
     bool UpdateUniform(const std::string& uniform, const float* data, uint32_t length);
 
+    //! \brief Updates a uniform array of vectors, with 4 floats per vector.
+    bool UpdateUniformArray(const std::string& uniform, const float* data, uint32_t count);
+
+    /** \brief Updates one of the common uniforms using its cached location.
+    *** The value is only uploaded when it differs from the last uploaded one.
+    *** Uniforms not used by the program are silently ignored.
+    **/
+    bool UpdateUniform(shader_uniforms::ShaderUniforms uniform, int32_t value);
+    bool UpdateUniform(shader_uniforms::ShaderUniforms uniform, const float* data, uint32_t length);
+
 private:
+    //! \brief The cached state of one of the common uniforms.
+    struct _CachedUniform {
+        //! \brief The uniform location, or -1 if the program doesn't use it.
+        GLint location;
+
+        //! \brief Whether a value has already been uploaded.
+        bool is_set;
+
+        //! \brief The last uploaded value.
+        float data[16];
+        int32_t integer;
+    };
+
+    //! \brief Resolves the common uniforms locations. Called once the program is linked.
+    void _CacheUniformLocations();
+
+    /** \brief Returns the location of a uniform, looking it up only once.
+    *** The matching common uniform cached value, if any, is invalidated.
+    **/
+    GLint _GetUniformLocation(const std::string& uniform);
+
     GLuint _program;
 
+    //! \brief Whether the shaders were attached, to detach them.
+    bool _shaders_attached;
+
+    bool _from_cache;
+
+    //! \brief The attributes and outputs bound, kept until the program is built.
+    std::vector<std::string> _attributes;
+    std::vector<std::string> _feedback_varyings;
+
+    //! \brief The common uniforms, indexed by shader_uniforms::ShaderUniforms.
+    _CachedUniform _uniforms[shader_uniforms::Count];
+
+    //! \brief The locations of the other uniforms, by name.
+    std::map<std::string, GLint> _uniform_locations;
+
     const Shader* _vertex_shader;
     const Shader* _fragment_shader;
 
@@ -29,6 +29,11 @@ enum ShaderPrograms
     SolidGrayscale,
     Sprite,
     SpriteGrayscale,
+    Particle,
+    ParticleSimulation,
+    AmbientEffects,
+    Weather,
+    TextDistanceField,
     Count
 };
 
@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_shader_uniforms.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the uniforms shared by the shader programs.
+*** ***************************************************************************/
+
+#ifndef __GL_SHADER_UNIFORMS_HEADER__
+#define __GL_SHADER_UNIFORMS_HEADER__
+
+namespace vt_video
+{
+namespace gl
+{
+namespace shader_uniforms
+{
+
+//! \brief The uniforms whose locations are resolved when the program is linked.
+enum ShaderUniforms
+{
+    Model = 0,
+    View,
+    Projection,
+    Color,
+    Texture,
+    TextureRect,
+    Count
+};
+
+//! \brief The uniform names, in the same order as the enumeration above.
+const char* const Names[Count] =
+{
+    "u_Model",
+    "u_View",
+    "u_Projection",
+    "u_Color",
+    "u_Texture",
+    "u_TextureRect"
+};
+
+} // namespace shader_uniforms
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_SHADER_UNIFORMS_HEADER__
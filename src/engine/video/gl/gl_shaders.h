@@ -26,10 +26,16 @@ namespace shaders
 enum Shaders
 {
     VertexDefault = 0,
+    VertexParticle,
+    VertexParticleSimulation,
     FragmentSolid,
     FragmentSolidGrayscale,
     FragmentSprite,
     FragmentSpriteGrayscale,
+    FragmentDiscard,
+    FragmentAmbientEffects,
+    FragmentWeather,
+    FragmentTextDistanceField,
     Count
 };
 
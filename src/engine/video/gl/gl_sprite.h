@@ -23,16 +23,17 @@ namespace vt_video
 namespace gl
 {
 
+// Forward declarations.
+class StreamBuffer;
+
 //! \brief A class for drawing a sprite.
 class Sprite
 {
 public:
-    Sprite();
+    //! \param stream_buffer The buffer the sprite vertices are streamed to.
+    explicit Sprite(StreamBuffer* stream_buffer);
     ~Sprite();
 
-    //! \brief Draws a sprite.
-    void Draw();
-
     //! \brief Draws a sprite.
     void Draw(float* vertex_positions,
               float* vertex_texture_coordinates,
@@ -44,11 +45,8 @@ private:
     Sprite(const Sprite& sprite);
     Sprite& operator=(const Sprite& sprite);
 
-    GLuint _vao;
-    GLuint _vertex_position_buffer;
-    GLuint _vertex_texture_coordinate_buffer;
-    GLuint _vertex_color_buffer;
-    GLuint _index_buffer;
+    //! \brief The buffer the sprite vertices are streamed to. Not owned.
+    StreamBuffer* _stream_buffer;
 };
 
 } // namespace gl
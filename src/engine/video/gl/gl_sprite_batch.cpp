@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_sprite_batch.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for batched sprite buffers.
+*** ***************************************************************************/
+
+#include "gl_sprite_batch.h"
+
+#include "gl_stream_buffer.h"
+
+#include "utils/exception.h"
+
+#include <cassert>
+
+namespace vt_video
+{
+namespace gl
+{
+
+//
+// Constants.
+//
+
+//! \brief The maximum number of sprites drawn by a single draw call.
+const unsigned MAX_SPRITES_PER_BATCH = 1024;
+
+const unsigned BATCH_VERTICES_PER_SPRITE = 4;
+const unsigned BATCH_POSITIONS_PER_VERTEX = 3;
+const unsigned BATCH_TEXTURE_COORDINATES_PER_VERTEX = 2;
+const unsigned BATCH_COLORS_PER_VERTEX = 4;
+
+SpriteBatch::SpriteBatch(StreamBuffer* stream_buffer) :
+    _stream_buffer(stream_buffer),
+    _shader_program(nullptr),
+    _texture_id(0),
+    _number_of_sprites(0)
+{
+    assert(_stream_buffer != nullptr);
+
+    _vertex_positions.reserve(MAX_SPRITES_PER_BATCH * BATCH_VERTICES_PER_SPRITE * BATCH_POSITIONS_PER_VERTEX);
+    _vertex_texture_coordinates.reserve(MAX_SPRITES_PER_BATCH * BATCH_VERTICES_PER_SPRITE * BATCH_TEXTURE_COORDINATES_PER_VERTEX);
+    _vertex_colors.reserve(MAX_SPRITES_PER_BATCH * BATCH_VERTICES_PER_SPRITE * BATCH_COLORS_PER_VERTEX);
+}
+
+SpriteBatch::~SpriteBatch()
+{
+}
+
+void SpriteBatch::SetState(ShaderProgram* shader_program, GLuint texture_id)
+{
+    assert(IsEmpty());
+    _shader_program = shader_program;
+    _texture_id = texture_id;
+}
+
+bool SpriteBatch::IsFull() const
+{
+    return _number_of_sprites >= MAX_SPRITES_PER_BATCH;
+}
+
+void SpriteBatch::AddSprite(const float* vertex_positions,
+                            const float* vertex_texture_coordinates,
+                            const float* vertex_colors)
+{
+    assert(vertex_positions != nullptr);
+    assert(vertex_texture_coordinates != nullptr);
+    assert(vertex_colors != nullptr);
+    assert(!IsFull());
+
+    _vertex_positions.insert(_vertex_positions.end(), vertex_positions,
+                             vertex_positions + BATCH_VERTICES_PER_SPRITE * BATCH_POSITIONS_PER_VERTEX);
+    _vertex_texture_coordinates.insert(_vertex_texture_coordinates.end(), vertex_texture_coordinates,
+                                       vertex_texture_coordinates + BATCH_VERTICES_PER_SPRITE * BATCH_TEXTURE_COORDINATES_PER_VERTEX);
+    _vertex_colors.insert(_vertex_colors.end(), vertex_colors,
+                          vertex_colors + BATCH_VERTICES_PER_SPRITE * BATCH_COLORS_PER_VERTEX);
+
+    ++_number_of_sprites;
+}
+
+void SpriteBatch::Draw()
+{
+    if (IsEmpty())
+        return;
+
+    // Draw all the sprites.
+    _stream_buffer->DrawQuads(&_vertex_positions[0],
+                              &_vertex_texture_coordinates[0],
+                              &_vertex_colors[0],
+                              _number_of_sprites);
+
+    Clear();
+}
+
+void SpriteBatch::Clear()
+{
+    _vertex_positions.clear();
+    _vertex_texture_coordinates.clear();
+    _vertex_colors.clear();
+    _number_of_sprites = 0;
+}
+
+SpriteBatch::SpriteBatch(const SpriteBatch&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+SpriteBatch& SpriteBatch::operator=(const SpriteBatch&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace gl
+
+} // namespace vt_video
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_sprite_batch.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for batched sprite buffers.
+***
+*** The sprite batch accumulates quads sharing the same shader program and
+*** texture sheet and draws them all using a single draw call.
+*** The quads' vertex positions must already be transformed by the model
+*** matrix, and their vertex colors modulated by the draw color.
+*** ***************************************************************************/
+
+#ifndef __GL_SPRITE_BATCH_HEADER__
+#define __GL_SPRITE_BATCH_HEADER__
+
+#include "utils/gl_include.h"
+
+#include <vector>
+
+namespace vt_video
+{
+namespace gl
+{
+
+// Forward declarations.
+class ShaderProgram;
+class StreamBuffer;
+
+//! \brief A class for drawing many sprites at once.
+class SpriteBatch
+{
+public:
+    //! \param stream_buffer The buffer the queued sprites are streamed to when drawn.
+    explicit SpriteBatch(StreamBuffer* stream_buffer);
+    ~SpriteBatch();
+
+    /** \brief Sets the render state shared by all the sprites of the batch.
+    *** \note This must only be called when the batch is empty.
+    **/
+    void SetState(ShaderProgram* shader_program, GLuint texture_id);
+
+    /** \brief Queues a sprite in the batch.
+    *** \param vertex_positions 4 vertices of 3 floats, already transformed.
+    *** \param vertex_texture_coordinates 4 vertices of 2 floats.
+    *** \param vertex_colors 4 vertices of 4 floats, already modulated.
+    *** \note The batch must not be full.
+    **/
+    void AddSprite(const float* vertex_positions,
+                   const float* vertex_texture_coordinates,
+                   const float* vertex_colors);
+
+    //! \brief Draws all the queued sprites in one draw call and empties the batch.
+    void Draw();
+
+    //! \brief Empties the batch without drawing it.
+    void Clear();
+
+    bool IsEmpty() const {
+        return _number_of_sprites == 0;
+    }
+
+    bool IsFull() const;
+
+    ShaderProgram* GetShaderProgram() const {
+        return _shader_program;
+    }
+
+    GLuint GetTextureId() const {
+        return _texture_id;
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    SpriteBatch(const SpriteBatch& sprite_batch);
+    SpriteBatch& operator=(const SpriteBatch& sprite_batch);
+
+    //! \brief The buffer the queued sprites are streamed to. Not owned.
+    StreamBuffer* _stream_buffer;
+
+    //! \brief The render state shared by the queued sprites.
+    ShaderProgram* _shader_program;
+    GLuint _texture_id;
+
+    //! \brief The number of sprites currently queued.
+    unsigned _number_of_sprites;
+
+    //! \brief The client-side vertex data of the queued sprites.
+    std::vector<float> _vertex_positions;
+    std::vector<float> _vertex_texture_coordinates;
+    std::vector<float> _vertex_colors;
+};
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_SPRITE_BATCH_HEADER__
@@ -0,0 +1,254 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_static_sprite_buffer.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for sprite geometry kept in video memory.
+*** ***************************************************************************/
+
+#include "gl_static_sprite_buffer.h"
+
+#include "gl_debug.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+#include "utils/utils_strings.h"
+
+#include <cassert>
+#include <vector>
+
+#ifdef __APPLE__
+#   define glBindVertexArray    glBindVertexArrayAPPLE
+#   define glGenVertexArrays    glGenVertexArraysAPPLE
+#   define glDeleteVertexArrays glDeleteVertexArraysAPPLE
+#endif
+
+namespace vt_video
+{
+namespace gl
+{
+
+//
+// Constants.
+//
+
+const unsigned STATIC_VERTICES_PER_SPRITE = 4;
+const unsigned STATIC_INDICES_PER_SPRITE = 6;
+const unsigned STATIC_POSITIONS_PER_VERTEX = 3;
+const unsigned STATIC_TEXTURE_COORDINATES_PER_VERTEX = 2;
+
+StaticSpriteBuffer::StaticSpriteBuffer() :
+    _vao(0),
+    _vertex_position_buffer(0),
+    _vertex_texture_coordinate_buffer(0),
+    _index_buffer(0),
+    _number_of_sprites(0)
+{
+    bool errors = false;
+
+    // Create the vertex array object.
+    GLuint arrays[1] = { 0 };
+    glGenVertexArrays(1, arrays);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        errors = true;
+        PRINT_ERROR << "Failed to create the static sprite buffer vertex array object." << std::endl;
+        assert(error == GL_NO_ERROR);
+    } else {
+        _vao = arrays[0];
+        glBindVertexArray(_vao);
+    }
+
+    // Create the vertex buffer objects.
+    if (!errors) {
+        GLuint buffers[3] = { 0 };
+        glGenBuffers(3, buffers);
+
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            errors = true;
+            PRINT_ERROR << "Failed to create the static sprite buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vao) << std::endl;
+            assert(error == GL_NO_ERROR);
+        } else {
+            _vertex_position_buffer = buffers[0];
+            _vertex_texture_coordinate_buffer = buffers[1];
+            _index_buffer = buffers[2];
+        }
+    }
+
+    // Set up the vertex attributes into slots 0 and 1.
+    // The color slot is left disabled, so the constant attribute value is used.
+    if (!errors) {
+        glBindBuffer(GL_ARRAY_BUFFER, _vertex_position_buffer);
+        glVertexAttribPointer(0, STATIC_POSITIONS_PER_VERTEX, GL_FLOAT, false, 0, nullptr);
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vertex_texture_coordinate_buffer);
+        glVertexAttribPointer(1, STATIC_TEXTURE_COORDINATES_PER_VERTEX, GL_FLOAT, false, 0, nullptr);
+        glEnableVertexAttribArray(1);
+
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            PRINT_ERROR << "Failed to set up the static sprite buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vao) << std::endl;
+            assert(error == GL_NO_ERROR);
+        }
+    }
+
+    // Unbind the vertex array object from the pipeline.
+    glBindVertexArray(0);
+
+    // Unbind the active buffers from the pipeline.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+StaticSpriteBuffer::~StaticSpriteBuffer()
+{
+    if (_vao != 0) {
+        const GLuint arrays[] = { _vao };
+        glDeleteVertexArrays(1, arrays);
+        _vao = 0;
+    }
+
+    const GLuint buffers[] = { _vertex_position_buffer,
+                               _vertex_texture_coordinate_buffer,
+                               _index_buffer };
+    for (unsigned i = 0; i < 3; ++i) {
+        if (buffers[i] != 0)
+            glDeleteBuffers(1, &buffers[i]);
+    }
+
+    _vertex_position_buffer = 0;
+    _vertex_texture_coordinate_buffer = 0;
+    _index_buffer = 0;
+}
+
+bool StaticSpriteBuffer::Upload(const float* vertex_positions,
+                                const float* vertex_texture_coordinates,
+                                unsigned number_of_sprites)
+{
+    _number_of_sprites = 0;
+
+    if (number_of_sprites == 0)
+        return true;
+
+    assert(vertex_positions != nullptr);
+    assert(vertex_texture_coordinates != nullptr);
+
+    // Two triangles per sprite.
+    std::vector<GLuint> indices(number_of_sprites * STATIC_INDICES_PER_SPRITE);
+    for (unsigned i = 0; i < number_of_sprites; ++i) {
+        const GLuint vertex = i * STATIC_VERTICES_PER_SPRITE;
+        GLuint* index = &indices[i * STATIC_INDICES_PER_SPRITE];
+
+        index[0] = vertex + 0; // Triangle One.
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex + 0; // Triangle Two.
+        index[4] = vertex + 2;
+        index[5] = vertex + 3;
+    }
+
+    const unsigned number_of_vertices = number_of_sprites * STATIC_VERTICES_PER_SPRITE;
+
+    glBindVertexArray(_vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertex_position_buffer);
+    glBufferData(GL_ARRAY_BUFFER, number_of_vertices * STATIC_POSITIONS_PER_VERTEX * sizeof(float),
+                 vertex_positions, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertex_texture_coordinate_buffer);
+    glBufferData(GL_ARRAY_BUFFER, number_of_vertices * STATIC_TEXTURE_COORDINATES_PER_VERTEX * sizeof(float),
+                 vertex_texture_coordinates, GL_DYNAMIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+
+    bool result = true;
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        result = false;
+        PRINT_ERROR << "Failed to upload the static sprite buffers. VAO ID: " <<
+                       vt_utils::NumberToString(_vao) << std::endl;
+        assert(error == GL_NO_ERROR);
+    } else {
+        _number_of_sprites = number_of_sprites;
+    }
+
+    // Unbind the vertex array object from the pipeline.
+    glBindVertexArray(0);
+
+    // Unbind the active buffers from the pipeline.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    return result;
+}
+
+void StaticSpriteBuffer::UpdateTextureCoordinates(unsigned sprite_index,
+                                                  const float* vertex_texture_coordinates)
+{
+    assert(sprite_index < _number_of_sprites);
+    assert(vertex_texture_coordinates != nullptr);
+
+    const unsigned sprite_size = STATIC_VERTICES_PER_SPRITE * STATIC_TEXTURE_COORDINATES_PER_VERTEX * sizeof(float);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertex_texture_coordinate_buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, sprite_index * sprite_size, sprite_size, vertex_texture_coordinates);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        PRINT_ERROR << "Failed to update the static sprite texture coordinates. VAO ID: " <<
+                       vt_utils::NumberToString(_vao) << " Sprite: " <<
+                       vt_utils::NumberToString(sprite_index) << std::endl;
+        assert(error == GL_NO_ERROR);
+    }
+}
+
+void StaticSpriteBuffer::Draw()
+{
+    if (_number_of_sprites == 0)
+        return;
+
+    // Bind the vertex array object.
+    glBindVertexArray(_vao);
+
+    // The sprites are drawn using a white vertex color.
+    glVertexAttrib4f(2, 1.0f, 1.0f, 1.0f, 1.0f);
+
+    // Draw all the sprites.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+    glDrawElements(GL_TRIANGLES, _number_of_sprites * STATIC_INDICES_PER_SPRITE, GL_UNSIGNED_INT, nullptr);
+
+    // Unbind the vertex array object from the pipeline.
+    glBindVertexArray(0);
+
+    // Unbind the active buffers from the pipeline.
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+StaticSpriteBuffer::StaticSpriteBuffer(const StaticSpriteBuffer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+StaticSpriteBuffer& StaticSpriteBuffer::operator=(const StaticSpriteBuffer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace gl
+
+} // namespace vt_video
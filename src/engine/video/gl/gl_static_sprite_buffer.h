@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_static_sprite_buffer.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for sprite geometry kept in video memory.
+***
+*** Unlike the sprite batch, the geometry is uploaded once and drawn as many
+*** times as needed. Only the texture coordinates can be updated afterwards.
+*** The sprites are drawn using a white vertex color.
+*** ***************************************************************************/
+
+#ifndef __GL_STATIC_SPRITE_BUFFER_HEADER__
+#define __GL_STATIC_SPRITE_BUFFER_HEADER__
+
+#include "utils/gl_include.h"
+
+namespace vt_video
+{
+namespace gl
+{
+
+//! \brief A class for drawing sprites whose positions never change.
+class StaticSpriteBuffer
+{
+public:
+    StaticSpriteBuffer();
+    ~StaticSpriteBuffer();
+
+    /** \brief Uploads the sprites geometry, replacing the previous one.
+    *** \param vertex_positions 4 vertices of 3 floats per sprite.
+    *** \param vertex_texture_coordinates 4 vertices of 2 floats per sprite.
+    *** \param number_of_sprites The number of sprites to upload.
+    **/
+    bool Upload(const float* vertex_positions,
+                const float* vertex_texture_coordinates,
+                unsigned number_of_sprites);
+
+    /** \brief Replaces the texture coordinates of one sprite.
+    *** \param vertex_texture_coordinates 4 vertices of 2 floats.
+    **/
+    void UpdateTextureCoordinates(unsigned sprite_index,
+                                  const float* vertex_texture_coordinates);
+
+    //! \brief Draws all the sprites in one draw call.
+    void Draw();
+
+    unsigned GetNumberOfSprites() const {
+        return _number_of_sprites;
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    StaticSpriteBuffer(const StaticSpriteBuffer& buffer);
+    StaticSpriteBuffer& operator=(const StaticSpriteBuffer& buffer);
+
+    GLuint _vao;
+    GLuint _vertex_position_buffer;
+    GLuint _vertex_texture_coordinate_buffer;
+    GLuint _index_buffer;
+
+    //! \brief The number of sprites uploaded.
+    unsigned _number_of_sprites;
+};
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_STATIC_SPRITE_BUFFER_HEADER__
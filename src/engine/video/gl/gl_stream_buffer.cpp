@@ -0,0 +1,319 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_stream_buffer.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the streamed vertex buffer.
+*** ***************************************************************************/
+
+#include "gl_stream_buffer.h"
+
+#include "gl_debug.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+#include "utils/utils_strings.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __APPLE__
+#   define glBindVertexArray    glBindVertexArrayAPPLE
+#   define glGenVertexArrays    glGenVertexArraysAPPLE
+#   define glDeleteVertexArrays glDeleteVertexArraysAPPLE
+#endif
+
+namespace vt_video
+{
+namespace gl
+{
+
+//
+// Constants.
+//
+
+//! \brief The size in bytes of the ring buffer.
+const unsigned STREAM_BUFFER_SIZE = 4 * 1024 * 1024;
+
+//! \brief The maximum number of quads drawn by a single draw call.
+const unsigned STREAM_MAX_QUADS_PER_DRAW = 16384;
+
+const unsigned STREAM_VERTICES_PER_QUAD = 4;
+const unsigned STREAM_INDICES_PER_QUAD = 6;
+const unsigned STREAM_POSITIONS_PER_VERTEX = 3;
+const unsigned STREAM_TEXTURE_COORDINATES_PER_VERTEX = 2;
+const unsigned STREAM_COLORS_PER_VERTEX = 4;
+
+//! \brief The interleaved vertex layout: Position, texture coordinates, then color.
+const unsigned STREAM_VERTEX_STRIDE = sizeof(StreamVertex);
+static_assert(sizeof(StreamVertex) == 16, "The stream vertices must stay packed");
+
+//! \brief The components of the streamed positions, the z coordinate being dropped.
+const unsigned STREAM_PACKED_POSITIONS_PER_VERTEX = 2;
+
+namespace
+{
+
+//! \brief Converts a float in [0, 1] to a normalized integer, clamping it.
+GLushort PackUnsignedShort(float value)
+{
+    return static_cast<GLushort>(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f);
+}
+
+GLubyte PackUnsignedByte(float value)
+{
+    return static_cast<GLubyte>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+} // namespace
+
+StreamBuffer::StreamBuffer() :
+    _vao(0),
+    _vertex_buffer(0),
+    _index_buffer(0),
+    _offset(0),
+    _map_buffer_range(false)
+{
+    bool errors = false;
+
+#ifndef __APPLE__
+    _map_buffer_range = GLEW_VERSION_3_0 || GLEW_ARB_map_buffer_range;
+#endif
+
+    // The indices never change: Two triangles per quad.
+    std::vector<GLuint> indices(STREAM_MAX_QUADS_PER_DRAW * STREAM_INDICES_PER_QUAD);
+    for (unsigned i = 0; i < STREAM_MAX_QUADS_PER_DRAW; ++i) {
+        const GLuint vertex = i * STREAM_VERTICES_PER_QUAD;
+        GLuint* index = &indices[i * STREAM_INDICES_PER_QUAD];
+
+        index[0] = vertex + 0; // Triangle One.
+        index[1] = vertex + 1;
+        index[2] = vertex + 2;
+        index[3] = vertex + 0; // Triangle Two.
+        index[4] = vertex + 2;
+        index[5] = vertex + 3;
+    }
+
+    // Create the vertex array object.
+    GLuint arrays[1] = { 0 };
+    glGenVertexArrays(1, arrays);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        errors = true;
+        PRINT_ERROR << "Failed to create the stream buffer vertex array object." << std::endl;
+        assert(error == GL_NO_ERROR);
+    } else {
+        _vao = arrays[0];
+        glBindVertexArray(_vao);
+    }
+
+    // Create the vertex buffer objects.
+    if (!errors) {
+        GLuint buffers[2] = { 0 };
+        glGenBuffers(2, buffers);
+
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            errors = true;
+            PRINT_ERROR << "Failed to create the stream buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vao) << std::endl;
+            assert(error == GL_NO_ERROR);
+        } else {
+            _vertex_buffer = buffers[0];
+            _index_buffer = buffers[1];
+        }
+    }
+
+    // Allocate the buffers storage and enable the vertex attributes in slots 0, 1 and 2.
+    // The attribute pointers are set at each draw, since they depend on the write offset.
+    if (!errors) {
+        glBindBuffer(GL_ARRAY_BUFFER, _vertex_buffer);
+        glBufferData(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+
+        error = glGetError();
+        if (error != GL_NO_ERROR) {
+            PRINT_ERROR << "Failed to allocate the stream buffers. VAO ID: " <<
+                           vt_utils::NumberToString(_vao) << std::endl;
+            assert(error == GL_NO_ERROR);
+        }
+    }
+
+    // Unbind the vertex array object from the pipeline.
+    glBindVertexArray(0);
+
+    // Unbind the active buffers from the pipeline.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    if (_vao != 0) {
+        const GLuint arrays[] = { _vao };
+        glDeleteVertexArrays(1, arrays);
+        _vao = 0;
+    }
+
+    if (_vertex_buffer != 0) {
+        const GLuint buffers[] = { _vertex_buffer };
+        glDeleteBuffers(1, buffers);
+        _vertex_buffer = 0;
+    }
+
+    if (_index_buffer != 0) {
+        const GLuint buffers[] = { _index_buffer };
+        glDeleteBuffers(1, buffers);
+        _index_buffer = 0;
+    }
+}
+
+void StreamBuffer::DrawQuads(const float* vertex_positions,
+                             const float* vertex_texture_coordinates,
+                             const float* vertex_colors,
+                             unsigned number_of_quads)
+{
+    assert(vertex_positions != nullptr);
+    assert(vertex_texture_coordinates != nullptr);
+    assert(vertex_colors != nullptr);
+
+    // Split the quads the index buffer doesn't cover.
+    while (number_of_quads > 0) {
+        unsigned quads = std::min(number_of_quads, STREAM_MAX_QUADS_PER_DRAW);
+        _DrawQuads(vertex_positions, vertex_texture_coordinates, vertex_colors, quads);
+
+        const unsigned vertices = quads * STREAM_VERTICES_PER_QUAD;
+        vertex_positions += vertices * STREAM_POSITIONS_PER_VERTEX;
+        vertex_texture_coordinates += vertices * STREAM_TEXTURE_COORDINATES_PER_VERTEX;
+        vertex_colors += vertices * STREAM_COLORS_PER_VERTEX;
+        number_of_quads -= quads;
+    }
+}
+
+void StreamBuffer::_DrawQuads(const float* vertex_positions,
+                              const float* vertex_texture_coordinates,
+                              const float* vertex_colors,
+                              unsigned number_of_quads)
+{
+    const unsigned number_of_vertices = number_of_quads * STREAM_VERTICES_PER_QUAD;
+    const unsigned size = number_of_vertices * STREAM_VERTEX_STRIDE;
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertex_buffer);
+
+    // When the ring is full, orphan its storage: The driver allocates a new one
+    // while the GPU keeps reading the vertices of the previous draws.
+    if (_offset + size > STREAM_BUFFER_SIZE) {
+        glBufferData(GL_ARRAY_BUFFER, STREAM_BUFFER_SIZE, nullptr, GL_STREAM_DRAW);
+        _offset = 0;
+    }
+
+    // Get the memory to write the interleaved vertices to.
+    StreamVertex* vertices = nullptr;
+    if (_map_buffer_range) {
+        // That range was never written since the storage was orphaned,
+        // so there is no need to synchronize with the GPU.
+        vertices = static_cast<StreamVertex*>(glMapBufferRange(GL_ARRAY_BUFFER, _offset, size,
+                                                        GL_MAP_WRITE_BIT |
+                                                        GL_MAP_INVALIDATE_RANGE_BIT |
+                                                        GL_MAP_UNSYNCHRONIZED_BIT));
+    }
+
+    const bool mapped = (vertices != nullptr);
+    if (!mapped) {
+        _vertices.resize(number_of_vertices);
+        vertices = &_vertices[0];
+    }
+
+    // Interleave and pack the vertex attributes.
+    // The GPU clamps the vertex colors anyway, and the textures aren't repeated.
+    for (unsigned i = 0; i < number_of_vertices; ++i) {
+        StreamVertex& vertex = vertices[i];
+        vertex.x = vertex_positions[0];
+        vertex.y = vertex_positions[1];
+        vertex.u = PackUnsignedShort(vertex_texture_coordinates[0]);
+        vertex.v = PackUnsignedShort(vertex_texture_coordinates[1]);
+        for (unsigned j = 0; j < STREAM_COLORS_PER_VERTEX; ++j)
+            vertex.color[j] = PackUnsignedByte(vertex_colors[j]);
+
+        vertex_positions += STREAM_POSITIONS_PER_VERTEX;
+        vertex_texture_coordinates += STREAM_TEXTURE_COORDINATES_PER_VERTEX;
+        vertex_colors += STREAM_COLORS_PER_VERTEX;
+    }
+
+    bool errors = false;
+
+    if (mapped) {
+        // The buffer content is undefined when the unmapping fails.
+        errors = (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, _offset, size, vertices);
+    }
+
+    GLenum error = GetError();
+    if (error != GL_NO_ERROR) {
+        errors = true;
+        PRINT_ERROR << "Failed to update the stream buffer. VAO ID: " <<
+                       vt_utils::NumberToString(_vao) << " Buffer ID: " <<
+                       vt_utils::NumberToString(_vertex_buffer) <<
+                       std::endl;
+        assert(error == GL_NO_ERROR);
+    }
+
+    if (!errors) {
+        // Bind the vertex array object.
+        glBindVertexArray(_vao);
+
+        // Point the vertex attributes to the vertices just written.
+        const uintptr_t position_offset = _offset;
+        const uintptr_t texture_coordinate_offset = position_offset + offsetof(StreamVertex, u);
+        const uintptr_t color_offset = position_offset + offsetof(StreamVertex, color);
+        glVertexAttribPointer(0, STREAM_PACKED_POSITIONS_PER_VERTEX, GL_FLOAT, false, STREAM_VERTEX_STRIDE,
+                              reinterpret_cast<const void*>(position_offset));
+        glVertexAttribPointer(1, STREAM_TEXTURE_COORDINATES_PER_VERTEX, GL_UNSIGNED_SHORT, true, STREAM_VERTEX_STRIDE,
+                              reinterpret_cast<const void*>(texture_coordinate_offset));
+        glVertexAttribPointer(2, STREAM_COLORS_PER_VERTEX, GL_UNSIGNED_BYTE, true, STREAM_VERTEX_STRIDE,
+                              reinterpret_cast<const void*>(color_offset));
+
+        // Draw the quads.
+        glDrawElements(GL_TRIANGLES, number_of_quads * STREAM_INDICES_PER_QUAD, GL_UNSIGNED_INT, nullptr);
+
+        // Unbind the vertex array object from the pipeline.
+        glBindVertexArray(0);
+    }
+
+    // Unbind the active buffer from the pipeline.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _offset += size;
+}
+
+StreamBuffer::StreamBuffer(const StreamBuffer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+StreamBuffer& StreamBuffer::operator=(const StreamBuffer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace gl
+
+} // namespace vt_video
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    gl_stream_buffer.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the streamed vertex buffer.
+***
+*** The stream buffer is a large vertex buffer used as a ring: each draw
+*** appends its interleaved vertices after the previous ones, mapping only the
+*** written range without synchronization when the driver supports it.
+*** Once the buffer is full, its storage is orphaned and writing starts over,
+*** so the driver never waits for the GPU to release vertices still in use.
+*** ***************************************************************************/
+
+#ifndef __GL_STREAM_BUFFER_HEADER__
+#define __GL_STREAM_BUFFER_HEADER__
+
+#include "utils/gl_include.h"
+
+#include <vector>
+
+namespace vt_video
+{
+namespace gl
+{
+
+/** \brief The packed vertex streamed to the GPU, 16 bytes instead of 9 floats.
+*** The z coordinate is dropped, the shaders getting the default 0 instead.
+*** The texture coordinates are normalized 16-bit integers, and the color 8-bit ones.
+**/
+class StreamVertex
+{
+public:
+    GLfloat x;
+    GLfloat y;
+    GLushort u;
+    GLushort v;
+    GLubyte color[4];
+};
+
+//! \brief A class for streaming quads to the GPU every frame.
+class StreamBuffer
+{
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    /** \brief Streams quads and draws them.
+    *** \param vertex_positions 4 vertices of 3 floats per quad, the z coordinate being ignored.
+    *** \param vertex_texture_coordinates 4 vertices of 2 floats per quad, clamped to [0, 1].
+    *** \param vertex_colors 4 vertices of 4 floats per quad, clamped to [0, 1].
+    *** \param number_of_quads The number of quads to draw.
+    **/
+    void DrawQuads(const float* vertex_positions,
+                   const float* vertex_texture_coordinates,
+                   const float* vertex_colors,
+                   unsigned number_of_quads);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    StreamBuffer(const StreamBuffer& stream_buffer);
+    StreamBuffer& operator=(const StreamBuffer& stream_buffer);
+
+    //! \brief Streams and draws at most the number of quads the index buffer covers.
+    void _DrawQuads(const float* vertex_positions,
+                    const float* vertex_texture_coordinates,
+                    const float* vertex_colors,
+                    unsigned number_of_quads);
+
+    GLuint _vao;
+    GLuint _vertex_buffer;
+    GLuint _index_buffer;
+
+    //! \brief The offset in bytes where the next vertices are written.
+    unsigned _offset;
+
+    //! \brief Whether glMapBufferRange() is available.
+    bool _map_buffer_range;
+
+    //! \brief The interleaved vertices, when the buffer can't be mapped.
+    std::vector<StreamVertex> _vertices;
+};
+
+} // namespace gl
+
+} // namespace vt_video
+
+#endif // __GL_STREAM_BUFFER_HEADER__
@@ -25,6 +25,16 @@
 #include <cstring>
 #include <math.h>
 
+// SSE2 and NEON are part of the base instruction sets of x86-64 and ARMv8,
+// so the vectorized position transforms are chosen when compiling.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define VT_VIDEO_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define VT_VIDEO_NEON
+#   include <arm_neon.h>
+#endif
+
 namespace vt_video
 {
 namespace gl
@@ -76,22 +86,39 @@ Transform::Transform(float m00, float m01, float m02, float m03,
     _row3[3] = m33;
 }
 
+bool Transform::operator==(const Transform& transform) const
+{
+    return memcmp(_row0, transform._row0, sizeof(_row0)) == 0 &&
+           memcmp(_row1, transform._row1, sizeof(_row1)) == 0 &&
+           memcmp(_row2, transform._row2, sizeof(_row2)) == 0 &&
+           memcmp(_row3, transform._row3, sizeof(_row3)) == 0;
+}
+
+// The transforms below are multiplied on the right by a matrix only touching
+// the first two columns, or only the last one. So only the columns changed are
+// computed, rather than doing a full 4x4 multiplication.
+
 void Transform::Translate(float x, float y)
 {
-    Transform translation;
-    translation._row0[3] = x;
-    translation._row1[3] = y;
+    float* rows[4] = { _row0, _row1, _row2, _row3 };
+    for (unsigned i = 0; i < 4; ++i)
+        rows[i][3] += rows[i][0] * x + rows[i][1] * y;
+}
 
-    _Multiply(translation);
+void Transform::SetTranslation(float x, float y)
+{
+    Reset();
+    _row0[3] = x;
+    _row1[3] = y;
 }
 
 void Transform::Scale(float sx, float sy)
 {
-    Transform scale;
-    scale._row0[0] = sx;
-    scale._row1[1] = sy;
-
-    _Multiply(scale);
+    float* rows[4] = { _row0, _row1, _row2, _row3 };
+    for (unsigned i = 0; i < 4; ++i) {
+        rows[i][0] *= sx;
+        rows[i][1] *= sy;
+    }
 }
 
 void Transform::Rotate(float angle)
@@ -103,13 +130,13 @@ void Transform::Rotate(float angle)
     float cosa = cosf(angle_radians);
     float sina = sinf(angle_radians);
 
-    Transform rotation;
-    rotation._row0[0] = cosa;
-    rotation._row0[1] = -sina;
-    rotation._row1[0] = sina;
-    rotation._row1[1] = cosa;
-
-    _Multiply(rotation);
+    float* rows[4] = { _row0, _row1, _row2, _row3 };
+    for (unsigned i = 0; i < 4; ++i) {
+        const float col0 = rows[i][0];
+        const float col1 = rows[i][1];
+        rows[i][0] = col0 * cosa + col1 * sina;
+        rows[i][1] = col1 * cosa - col0 * sina;
+    }
 }
 
 void Transform::Reset()
@@ -143,6 +170,80 @@ void Transform::Apply(float* buffer) const
     memcpy(buffer, _row3, sizeof(_row3));
 }
 
+void Transform::TransformPosition(const float* position, float* result) const
+{
+    assert(position != nullptr);
+    assert(result != nullptr);
+
+    const float x = position[0];
+    const float y = position[1];
+    const float z = position[2];
+
+    result[0] = _row0[0] * x + _row0[1] * y + _row0[2] * z + _row0[3];
+    result[1] = _row1[0] * x + _row1[1] * y + _row1[2] * z + _row1[3];
+    result[2] = _row2[0] * x + _row2[1] * y + _row2[2] * z + _row2[3];
+}
+
+void Transform::TransformPositions(const float* positions, float* results, unsigned count) const
+{
+    assert(positions != nullptr);
+    assert(results != nullptr);
+
+    unsigned i = 0;
+
+    // Each position is computed as column0 * x + column1 * y + column2 * z + column3.
+    // A full register is stored for every position but the last one, whose fourth
+    // lane would be written past the results: the next position overwrites it.
+#if defined(VT_VIDEO_SSE2)
+    // The rows are aligned, but the owner may be allocated with a smaller alignment,
+    // so they are loaded without assuming it.
+    __m128 column0 = _mm_loadu_ps(_row0);
+    __m128 column1 = _mm_loadu_ps(_row1);
+    __m128 column2 = _mm_loadu_ps(_row2);
+    __m128 column3 = _mm_loadu_ps(_row3);
+    _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+    for (; i + 1 < count; ++i) {
+        const __m128 x = _mm_set1_ps(positions[i * 3]);
+        const __m128 y = _mm_set1_ps(positions[i * 3 + 1]);
+        const __m128 z = _mm_set1_ps(positions[i * 3 + 2]);
+
+        const __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, x), _mm_mul_ps(column1, y)),
+                                         _mm_add_ps(_mm_mul_ps(column2, z), column3));
+        _mm_storeu_ps(results + i * 3, result);
+    }
+#elif defined(VT_VIDEO_NEON)
+    const float32x4x2_t rows01 = vtrnq_f32(vld1q_f32(_row0), vld1q_f32(_row1));
+    const float32x4x2_t rows23 = vtrnq_f32(vld1q_f32(_row2), vld1q_f32(_row3));
+    const float32x4_t column0 = vcombine_f32(vget_low_f32(rows01.val[0]), vget_low_f32(rows23.val[0]));
+    const float32x4_t column1 = vcombine_f32(vget_low_f32(rows01.val[1]), vget_low_f32(rows23.val[1]));
+    const float32x4_t column2 = vcombine_f32(vget_high_f32(rows01.val[0]), vget_high_f32(rows23.val[0]));
+    const float32x4_t column3 = vcombine_f32(vget_high_f32(rows01.val[1]), vget_high_f32(rows23.val[1]));
+
+    for (; i + 1 < count; ++i) {
+        float32x4_t result = vmlaq_n_f32(column3, column0, positions[i * 3]);
+        result = vmlaq_n_f32(result, column1, positions[i * 3 + 1]);
+        result = vmlaq_n_f32(result, column2, positions[i * 3 + 2]);
+        vst1q_f32(results + i * 3, result);
+    }
+#endif
+
+    // Copied once, so that the compiler knows they don't alias the results.
+    const float r00 = _row0[0], r01 = _row0[1], r02 = _row0[2], r03 = _row0[3];
+    const float r10 = _row1[0], r11 = _row1[1], r12 = _row1[2], r13 = _row1[3];
+    const float r20 = _row2[0], r21 = _row2[1], r22 = _row2[2], r23 = _row2[3];
+
+    for (; i < count; ++i) {
+        const float x = positions[i * 3];
+        const float y = positions[i * 3 + 1];
+        const float z = positions[i * 3 + 2];
+
+        results[i * 3] = r00 * x + r01 * y + r02 * z + r03;
+        results[i * 3 + 1] = r10 * x + r11 * y + r12 * z + r13;
+        results[i * 3 + 2] = r20 * x + r21 * y + r22 * z + r23;
+    }
+}
+
 void Transform::_Multiply(const Transform& transform)
 {
     // Allocate space for the result.
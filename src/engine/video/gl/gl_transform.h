@@ -44,9 +44,18 @@ public:
               float m20, float m21, float m22, float m23,
               float m30, float m31, float m32, float m33);
 
+    //! \brief Comparison operators.
+    bool operator==(const Transform& transform) const;
+    bool operator!=(const Transform& transform) const {
+        return !(*this == transform);
+    }
+
     //! \brief Moves the current transform by x and y.
     void Translate(float x, float y);
 
+    //! \brief Resets the transform to a translation by x and y.
+    void SetTranslation(float x, float y);
+
     //! \brief Scales the current transform by sx and sy.
     void Scale(float sx, float sy);
 
@@ -59,14 +68,22 @@ public:
     //! \brief Applies the transform to the buffer.  The buffer must have at least 16 elements!
     void Apply(float* buffer) const;
 
+    //! \brief Transforms a 3D position (with w = 1).  Both buffers must have at least 3 elements!
+    void TransformPosition(const float* position, float* result) const;
+
+    //! \brief Transforms several 3D positions (with w = 1), stored one after another.
+    //! Both buffers must have at least 3 * count elements, and must not overlap!
+    void TransformPositions(const float* positions, float* results, unsigned count) const;
+
 private:
     //! \brief A helper function to multiply transforms.
     void _Multiply(const Transform& transform);
 
-    float _row0[4];
-    float _row1[4];
-    float _row2[4];
-    float _row3[4];
+    //! \brief The matrix rows, aligned so that each one is loaded as a single SIMD register.
+    alignas(16) float _row0[4];
+    alignas(16) float _row1[4];
+    alignas(16) float _row2[4];
+    alignas(16) float _row3[4];
 };
 
 } // namespace gl
@@ -0,0 +1,323 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    glyph_atlas.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the glyph atlases used to draw text.
+*** ***************************************************************************/
+
+#include "engine/video/glyph_atlas.h"
+
+#include "engine/memory_stats.h"
+#include "engine/video/texture_controller.h"
+#include "engine/video/video.h"
+
+#include "utils/exception.h"
+
+#ifdef __APPLE__
+#   include <SDL_ttf.h>
+#else
+#   include <SDL2/SDL_ttf.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+//! \brief The empty pixels kept around each glyph, so that linear filtering doesn't bleed the neighbours.
+const int32_t GLYPH_ATLAS_PADDING = 1;
+
+GlyphAtlas::GlyphAtlas(TTF_Font* ttf_font, bool distance_field) :
+    _ttf_font(ttf_font),
+    _distance_field(distance_field),
+    _cursor_x(0),
+    _cursor_y(0),
+    _row_height(0)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    Clear();
+}
+
+const Glyph* GlyphAtlas::GetGlyph(uint16_t character)
+{
+    auto it = _glyphs.find(character);
+    if (it != _glyphs.end())
+        return &it->second;
+
+    Glyph glyph;
+    if (!_RasterizeGlyph(character, glyph))
+        return nullptr;
+
+    return &(_glyphs[character] = glyph);
+}
+
+int32_t GlyphAtlas::GetKerning(uint16_t previous_character, uint16_t character) const
+{
+    if (!TTF_GetFontKerning(_ttf_font))
+        return 0;
+
+    return TTF_GetFontKerningSizeGlyphs(_ttf_font, previous_character, character);
+}
+
+const GlyphMetrics* GlyphAtlas::GetGlyphMetrics(uint16_t character)
+{
+    auto it = _metrics.find(character);
+    if (it != _metrics.end())
+        return &it->second;
+
+    GlyphMetrics metrics;
+    int32_t min_y = 0, max_y = 0;
+    if (TTF_GlyphMetrics(_ttf_font, character, &metrics.min_x, &metrics.max_x, &min_y, &max_y, &metrics.advance) != 0) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_GlyphMetrics() failed for character: " << character << std::endl;
+        return nullptr;
+    }
+
+    return &(_metrics[character] = metrics);
+}
+
+int32_t GlyphAtlas::CalculateTextWidth(const uint16_t* text, size_t length)
+{
+    int32_t pen_x = 0;
+    int32_t min_x = 0;
+    int32_t max_x = 0;
+
+    for (size_t i = 0; i < length; ++i) {
+        const GlyphMetrics* metrics = GetGlyphMetrics(text[i]);
+        if (metrics == nullptr)
+            continue;
+
+        if (i > 0)
+            pen_x += GetKerning(text[i - 1], text[i]);
+
+        min_x = std::min(min_x, pen_x + metrics->min_x);
+        max_x = std::max(max_x, pen_x + std::max(metrics->advance, metrics->max_x));
+        pen_x += metrics->advance;
+    }
+
+    return max_x - min_x;
+}
+
+void GlyphAtlas::CalculateCharOffsets(const uint16_t* text, size_t length, std::vector<float>& offsets)
+{
+    offsets.assign(length + 1, 0.0f);
+
+    int32_t pen_x = 0;
+    int32_t min_x = 0;
+    int32_t max_x = 0;
+
+    // Same accumulation as CalculateTextWidth(), recording the width after each character.
+    for (size_t i = 0; i < length; ++i) {
+        const GlyphMetrics* metrics = GetGlyphMetrics(text[i]);
+        if (metrics != nullptr) {
+            if (i > 0)
+                pen_x += GetKerning(text[i - 1], text[i]);
+
+            min_x = std::min(min_x, pen_x + metrics->min_x);
+            max_x = std::max(max_x, pen_x + std::max(metrics->advance, metrics->max_x));
+            pen_x += metrics->advance;
+        }
+
+        offsets[i + 1] = static_cast<float>(max_x - min_x);
+    }
+}
+
+void GlyphAtlas::Clear()
+{
+    for (uint32_t i = 0; i < _pages.size(); ++i) {
+        TextureManager->_DeleteTexture(_pages[i]);
+        vt_system::MemoryStats::Remove(vt_system::MEMORY_TEXT, GLYPH_ATLAS_PAGE_SIZE * GLYPH_ATLAS_PAGE_SIZE * 4);
+    }
+
+    _pages.clear();
+    _glyphs.clear();
+    _metrics.clear();
+
+    _cursor_x = 0;
+    _cursor_y = 0;
+    _row_height = 0;
+}
+
+bool GlyphAtlas::_RasterizeGlyph(uint16_t character, Glyph& glyph)
+{
+    const GlyphMetrics* metrics = GetGlyphMetrics(character);
+    if (metrics == nullptr)
+        return false;
+
+    glyph.advance = metrics->advance;
+
+    // Whitespaces only move the pen.
+    if (metrics->max_x <= metrics->min_x)
+        return true;
+
+    // Render the glyph alone, with the full line height, so that it lines up
+    // exactly as it would within a string rendered at once.
+    const uint16_t text[] = { character, 0 };
+    const SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* surface = TTF_RenderUNICODE_Blended(_ttf_font, text, white);
+    if (surface == nullptr) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_RenderUNICODE_Blended() failed" << std::endl;
+        return false;
+    }
+
+    const int32_t border = _distance_field ? DISTANCE_FIELD_BORDER : 0;
+    const int32_t width = surface->w + 2 * border;
+    const int32_t height = surface->h + 2 * border;
+    if (width + 2 * GLYPH_ATLAS_PADDING > GLYPH_ATLAS_PAGE_SIZE ||
+            height + 2 * GLYPH_ATLAS_PADDING > GLYPH_ATLAS_PAGE_SIZE) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "glyph too big for the atlas: " << width << "x" << height << std::endl;
+        SDL_FreeSurface(surface);
+        return false;
+    }
+
+    // Go to the next row, or to a new page, when the glyph doesn't fit.
+    if (!_pages.empty() && _cursor_x + width + GLYPH_ATLAS_PADDING > GLYPH_ATLAS_PAGE_SIZE) {
+        _cursor_x = GLYPH_ATLAS_PADDING;
+        _cursor_y += _row_height + GLYPH_ATLAS_PADDING;
+        _row_height = 0;
+    }
+
+    if (_pages.empty() || _cursor_y + height + GLYPH_ATLAS_PADDING > GLYPH_ATLAS_PAGE_SIZE) {
+        if (!_AddPage()) {
+            SDL_FreeSurface(surface);
+            return false;
+        }
+    }
+
+    // Copy the glyph in the page.
+    TextureManager->_BindTexture(_pages.back());
+
+    SDL_LockSurface(surface);
+    if (_distance_field) {
+        std::vector<uint8_t> pixels;
+        _ComputeDistanceField(surface, pixels);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, _cursor_x, _cursor_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+    }
+    else {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, surface->pitch / surface->format->BytesPerPixel);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, _cursor_x, _cursor_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    VideoManager->GetRenderStats().AddUploadedBytes(width * height * 4);
+    SDL_UnlockSurface(surface);
+
+    SDL_FreeSurface(surface);
+    surface = nullptr;
+
+    // SDL_ttf moves the first glyph of a string right by its negative bearing.
+    glyph.texture_id = _pages.back();
+    glyph.offset_x = std::min(metrics->min_x, 0) - border;
+    glyph.offset_y = -border;
+    glyph.width = width;
+    glyph.height = height;
+    glyph.u1 = static_cast<float>(_cursor_x) / GLYPH_ATLAS_PAGE_SIZE;
+    glyph.v1 = static_cast<float>(_cursor_y) / GLYPH_ATLAS_PAGE_SIZE;
+    glyph.u2 = static_cast<float>(_cursor_x + width) / GLYPH_ATLAS_PAGE_SIZE;
+    glyph.v2 = static_cast<float>(_cursor_y + height) / GLYPH_ATLAS_PAGE_SIZE;
+
+    _cursor_x += width + GLYPH_ATLAS_PADDING;
+    _row_height = std::max(_row_height, height);
+
+    return true;
+}
+
+void GlyphAtlas::_ComputeDistanceField(SDL_Surface* surface, std::vector<uint8_t>& pixels)
+{
+    const int32_t width = surface->w + 2 * DISTANCE_FIELD_BORDER;
+    const int32_t height = surface->h + 2 * DISTANCE_FIELD_BORDER;
+
+    // Whether each texel, border included, is inside the glyph.
+    // TTF_RenderUNICODE_Blended() renders 32 bits pixels.
+    std::vector<bool> inside(width * height, false);
+    for (int32_t y = 0; y < surface->h; ++y) {
+        const uint8_t* row = static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch;
+        for (int32_t x = 0; x < surface->w; ++x) {
+            const uint32_t pixel = reinterpret_cast<const uint32_t*>(row)[x];
+            const uint32_t alpha = (pixel & surface->format->Amask) >> surface->format->Ashift;
+            inside[(y + DISTANCE_FIELD_BORDER) * width + x + DISTANCE_FIELD_BORDER] = alpha >= 128;
+        }
+    }
+
+    // The spread is small: The nearest texel on the other side of the edge
+    // is searched around each texel.
+    const float max_distance = static_cast<float>(DISTANCE_FIELD_SPREAD);
+    pixels.assign(width * height * 4, 255);
+    for (int32_t y = 0; y < height; ++y) {
+        for (int32_t x = 0; x < width; ++x) {
+            const bool texel_inside = inside[y * width + x];
+            float distance_squared = (max_distance + 0.5f) * (max_distance + 0.5f);
+
+            for (int32_t dy = -DISTANCE_FIELD_SPREAD; dy <= DISTANCE_FIELD_SPREAD; ++dy) {
+                const int32_t sy = y + dy;
+                if (sy < 0 || sy >= height)
+                    continue;
+                for (int32_t dx = -DISTANCE_FIELD_SPREAD; dx <= DISTANCE_FIELD_SPREAD; ++dx) {
+                    const int32_t sx = x + dx;
+                    if (sx < 0 || sx >= width || inside[sy * width + sx] == texel_inside)
+                        continue;
+                    distance_squared = std::min(distance_squared, static_cast<float>(dx * dx + dy * dy));
+                }
+            }
+
+            // The edge lies halfway between the two texels.
+            float distance = std::min(std::sqrt(distance_squared) - 0.5f, max_distance);
+            if (!texel_inside)
+                distance = -distance;
+
+            const float value = 0.5f + 0.5f * distance / max_distance;
+            pixels[(y * width + x) * 4 + 3] = static_cast<uint8_t>(std::max(0.0f, std::min(value, 1.0f)) * 255.0f + 0.5f);
+        }
+    }
+}
+
+bool GlyphAtlas::_AddPage()
+{
+    GLuint texture_id = TextureManager->_CreateBlankGLTexture(GLYPH_ATLAS_PAGE_SIZE, GLYPH_ATLAS_PAGE_SIZE);
+    if (texture_id == INVALID_TEXTURE_ID) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to create a new glyph atlas page" << std::endl;
+        return false;
+    }
+
+    // Clear the page, as the padding around the glyphs is sampled when filtering.
+    std::vector<uint8_t> pixels(GLYPH_ATLAS_PAGE_SIZE * GLYPH_ATLAS_PAGE_SIZE * 4, 0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, GLYPH_ATLAS_PAGE_SIZE, GLYPH_ATLAS_PAGE_SIZE,
+                    GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+
+    _pages.push_back(texture_id);
+    vt_system::MemoryStats::Add(vt_system::MEMORY_TEXT, GLYPH_ATLAS_PAGE_SIZE * GLYPH_ATLAS_PAGE_SIZE * 4);
+
+    _cursor_x = GLYPH_ATLAS_PADDING;
+    _cursor_y = GLYPH_ATLAS_PADDING;
+    _row_height = 0;
+
+    return true;
+}
+
+GlyphAtlas::GlyphAtlas(const GlyphAtlas&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+GlyphAtlas& GlyphAtlas::operator=(const GlyphAtlas&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace private_video
+
+} // namespace vt_video
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    glyph_atlas.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the glyph atlases used to draw text.
+***
+*** A glyph atlas rasterizes each glyph of a font only once, the first time it
+*** is needed, into shared texture pages. A line of text can then be drawn as
+*** one quad per glyph, without any CPU rasterization nor texture upload.
+***
+*** The distance field atlases store, instead of the glyph coverage, the signed
+*** distance to the glyph edges. A single one per font file, rasterized at
+*** DISTANCE_FIELD_FONT_SIZE, draws the text of every size of that font, and
+*** its shadow in the same pass.
+*** ***************************************************************************/
+
+#ifndef __GLYPH_ATLAS_HEADER__
+#define __GLYPH_ATLAS_HEADER__
+
+#include "utils/gl_include.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+typedef struct _TTF_Font TTF_Font;
+struct SDL_Surface;
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+//! \brief The width and height of an atlas texture page.
+const int32_t GLYPH_ATLAS_PAGE_SIZE = 512;
+
+//! \brief The font size the distance field glyphs are rasterized at.
+const int32_t DISTANCE_FIELD_FONT_SIZE = 32;
+
+//! \brief The distance to the glyph edges stored in the distance fields, in pixels.
+const int32_t DISTANCE_FIELD_SPREAD = 4;
+
+/** \brief The pixels kept around each distance field glyph, in pixels.
+*** The part beyond the spread leaves room for the shadow drawn in the same
+*** quad, which can thus be offset by up to DISTANCE_FIELD_BORDER - DISTANCE_FIELD_SPREAD.
+**/
+const int32_t DISTANCE_FIELD_BORDER = 10;
+
+/** ****************************************************************************
+*** \brief Where a glyph lies in the atlas and how to place it.
+***
+*** Glyphs are rasterized with the full line height of their font, so that
+*** their top edge is simply the top edge of the line being drawn.
+*** ***************************************************************************/
+class Glyph
+{
+public:
+    Glyph() :
+        texture_id(0),
+        offset_x(0),
+        offset_y(0),
+        width(0),
+        height(0),
+        advance(0),
+        u1(0.0f), v1(0.0f),
+        u2(0.0f), v2(0.0f)
+    {}
+
+    //! \brief The atlas page texture containing the glyph, or 0 if the glyph has no pixels.
+    GLuint texture_id;
+
+    //! \brief The horizontal offset of the glyph's left edge from the pen position.
+    int32_t offset_x;
+
+    //! \brief The vertical offset of the glyph's top edge from the line top, only set for the distance fields.
+    int32_t offset_y;
+
+    //! \brief The size of the glyph in pixels.
+    int32_t width, height;
+
+    //! \brief How far the pen moves after the glyph, in pixels.
+    int32_t advance;
+
+    //! \brief The texture coordinates of the glyph in its page.
+    float u1, v1, u2, v2;
+};
+
+//! \brief The horizontal metrics of a glyph, as given by SDL_ttf.
+class GlyphMetrics
+{
+public:
+    GlyphMetrics() :
+        min_x(0),
+        max_x(0),
+        advance(0)
+    {}
+
+    //! \brief The horizontal extent of the glyph pixels, relative to the pen position.
+    int32_t min_x, max_x;
+
+    //! \brief How far the pen moves after the glyph, in pixels.
+    int32_t advance;
+};
+
+/** ****************************************************************************
+*** \brief Caches the rasterized glyphs of one font in texture pages.
+***
+*** The atlas is owned by the FontProperties of its font, and must be reset
+*** whenever the font is closed or changed.
+*** ***************************************************************************/
+class GlyphAtlas
+{
+public:
+    /** \param ttf_font The font of the glyphs. Not owned.
+    *** \param distance_field Whether the signed distance fields of the glyphs
+    *** are stored, rather than their coverage. Their texels then hold the
+    *** distance in the alpha channel, 0.5 being the glyph edge, inside a
+    *** DISTANCE_FIELD_BORDER around the glyph.
+    **/
+    GlyphAtlas(TTF_Font* ttf_font, bool distance_field = false);
+    ~GlyphAtlas();
+
+    bool IsDistanceField() const {
+        return _distance_field;
+    }
+
+    /** \brief Returns a glyph, rasterizing it first if it isn't in the atlas yet.
+    *** \param character The unicode character of the glyph.
+    *** \return The glyph, or nullptr if it couldn't be rasterized.
+    **/
+    const Glyph* GetGlyph(uint16_t character);
+
+    /** \brief Returns the metrics of a glyph, without rasterizing it.
+    *** \param character The unicode character of the glyph.
+    *** \return The metrics, or nullptr if the font doesn't provide them.
+    **/
+    const GlyphMetrics* GetGlyphMetrics(uint16_t character);
+
+    /** \brief Returns the kerning to apply between two consecutive characters.
+    *** \return The offset to add to the pen position, in pixels.
+    **/
+    int32_t GetKerning(uint16_t previous_character, uint16_t character) const;
+
+    /** \brief Calculates the width of a line of text from the cached glyph metrics.
+    *** \param text A unicode string.
+    *** \param length The number of characters of the string to measure.
+    *** \return The width in pixels, computed the same way as TTF_SizeUNICODE() does.
+    **/
+    int32_t CalculateTextWidth(const uint16_t* text, size_t length);
+
+    /** \brief Calculates the width of every prefix of a line of text in a single pass.
+    *** \param text A unicode string.
+    *** \param length The number of characters of the string to measure.
+    *** \param offsets Filled with length + 1 values, offsets[i] being the width of the i first characters.
+    **/
+    void CalculateCharOffsets(const uint16_t* text, size_t length, std::vector<float>& offsets);
+
+    //! \brief Frees all the glyphs and texture pages.
+    void Clear();
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    GlyphAtlas(const GlyphAtlas& glyph_atlas);
+    GlyphAtlas& operator=(const GlyphAtlas& glyph_atlas);
+
+    //! \brief The font the glyphs are rasterized with. Not owned.
+    TTF_Font* _ttf_font;
+
+    //! \brief Whether the glyphs distance fields are stored.
+    bool _distance_field;
+
+    //! \brief The glyphs already requested, rasterized or not.
+    std::map<uint16_t, Glyph> _glyphs;
+
+    //! \brief The metrics of the glyphs already measured.
+    std::map<uint16_t, GlyphMetrics> _metrics;
+
+    //! \brief The atlas texture pages, the last one being the one currently filled.
+    std::vector<GLuint> _pages;
+
+    //! \brief Where the next glyph goes in the current page, filled row by row.
+    int32_t _cursor_x;
+    int32_t _cursor_y;
+
+    //! \brief The height of the tallest glyph of the current row.
+    int32_t _row_height;
+
+    /** \brief Rasterizes a glyph and copies it in the current page.
+    *** \param character The unicode character to rasterize.
+    *** \param glyph The glyph to fill in.
+    *** \return False if the glyph couldn't be rasterized.
+    **/
+    bool _RasterizeGlyph(uint16_t character, Glyph& glyph);
+
+    /** \brief Computes the distance field of a rendered glyph.
+    *** \param surface The glyph rendered by SDL_ttf, locked.
+    *** \param pixels The RGBA texels to fill, of the surface size plus the border.
+    **/
+    static void _ComputeDistanceField(SDL_Surface* surface, std::vector<uint8_t>& pixels);
+
+    //! \brief Adds a new empty texture page and makes it the current one.
+    bool _AddPage();
+};
+
+} // namespace private_video
+
+} // namespace vt_video
+
+#endif // __GLYPH_ATLAS_HEADER__
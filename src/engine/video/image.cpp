@@ -18,6 +18,9 @@
 #include "image.h"
 
 #include "script/script_read.h"
+#include "engine/asset_archive.h"
+#include "engine/asset_manifest.h"
+#include "engine/asset_watcher.h"
 #include "engine/system.h"
 #include "engine/video/color.h"
 
@@ -29,6 +32,10 @@
 
 #include <SDL_image.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
 using namespace vt_utils;
 using namespace vt_video::private_video;
 using namespace vt_common;
@@ -36,6 +43,9 @@ using namespace vt_common;
 namespace vt_video
 {
 
+//! \brief The draw size ratio, to the texture size, below which an image sheet gets mipmaps.
+const float VIDEO_MIPMAP_MINIFICATION = 0.9f;
+
 // -----------------------------------------------------------------------------
 // ImageDescriptor class
 // -----------------------------------------------------------------------------
@@ -59,15 +69,7 @@ ImageDescriptor::ImageDescriptor() :
 
 ImageDescriptor::~ImageDescriptor()
 {
-    // The destructor for the inherited class should have disabled grayscale mode
-    // If it didn't, the grayscale image might not have been properly dereferenced
-    // and/or removed from texture memory
-    if(_grayscale) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "grayscale mode was still enabled when destructor was invoked "
-                                      << "-- possible memory leak" << std::endl;
-    }
-
-    // Remove the reference to the original, colored texture
+    // Remove the reference to the texture
     if(_texture != nullptr)
         _RemoveTextureReference();
 
@@ -142,12 +144,6 @@ ImageDescriptor &ImageDescriptor::operator=(const ImageDescriptor &copy)
 
 void ImageDescriptor::Clear()
 {
-    // This will also remove a reference to the grayscale version of the image
-    // FIXME: This is triggering a crash when several images using the same file
-    // are in different states.
-    //if (_grayscale)
-    //    _DisableGrayscale();
-
     if(_texture != nullptr)
         _RemoveTextureReference();
 
@@ -209,7 +205,7 @@ bool ImageDescriptor::GetImageInfo(const std::string& filename,
     cols = 0;
     bpp = 0;
 
-    SDL_Surface* surf = IMG_Load(filename.c_str());
+    SDL_Surface* surf = IMG_Load_RW(vt_system::OpenAsset(filename), 1);
 
     if (!surf) {
         PRINT_ERROR << "Couldn't load image " << filename
@@ -264,21 +260,40 @@ bool ImageDescriptor::LoadMultiImageFromElementSize(std::vector<StillImage>& ima
             i->_width = static_cast<float>(elem_width);
     }
 
-    return _LoadMultiImage(images, filename, grid_rows, grid_cols);
+    return _LoadMultiImage(images, filename, TextureManager->InternImagePath(filename), grid_rows, grid_cols);
 } // bool ImageDescriptor::LoadMultiImageFromElementSize(...)
 
 
 bool ImageDescriptor::LoadMultiImageFromElementGrid(std::vector<StillImage>& images, const std::string &filename,
         const uint32_t grid_rows, const uint32_t grid_cols)
 {
-    if(!DoesFileExist(filename)) {
+    return LoadMultiImageFromElementGrid(images, filename, TextureManager->InternImagePath(filename),
+                                         grid_rows, grid_cols);
+}
+
+bool ImageDescriptor::LoadMultiImageFromElementGrid(std::vector<StillImage>& images, const std::string &filename,
+        uint32_t path_id, const uint32_t grid_rows, const uint32_t grid_cols)
+{
+    if(!vt_system::DoesAssetExist(filename)) {
         PRINT_WARNING << "Multi-image file not found: "
                       << filename << std::endl;
         return false;
     }
-    // First retrieve the dimensions of the multi image (in pixels)
+    if(grid_rows == 0 || grid_cols == 0) {
+        PRINT_WARNING << "Invalid grid size for multi image file: " << filename << std::endl;
+        return false;
+    }
+
+    // First retrieve the dimensions of the multi image (in pixels),
+    // given by its texture when it's already loaded.
     uint32_t img_height, img_width, bpp;
-    if (!GetImageInfo(filename, img_height, img_width, bpp)) {
+    ImageTexture* multi_image_texture = (grid_rows <= MULTI_IMAGE_MAX_GRID_SIZE && grid_cols <= MULTI_IMAGE_MAX_GRID_SIZE) ?
+        TextureManager->_GetImageTexture(path_id, GetMultiImageTag(grid_rows, grid_cols)) : nullptr;
+    if (multi_image_texture != nullptr) {
+        img_height = multi_image_texture->height;
+        img_width = multi_image_texture->width;
+    }
+    else if (!GetImageInfo(filename, img_height, img_width, bpp)) {
         PRINT_WARNING << "Couldn't load image file info: "
                       << filename << std::endl;
         return false;
@@ -307,7 +322,7 @@ bool ImageDescriptor::LoadMultiImageFromElementGrid(std::vector<StillImage>& ima
             i->_width = static_cast<float>(elem_width);
     }
 
-    return _LoadMultiImage(images, filename, grid_rows, grid_cols);
+    return _LoadMultiImage(images, filename, path_id, grid_rows, grid_cols);
 }
 
 bool ImageDescriptor::SaveMultiImage(const std::vector<StillImage *>& images,
@@ -371,7 +386,7 @@ bool ImageDescriptor::SaveMultiImage(const std::vector<StillImage *>& images,
     // and malloc enough memory for the entire sheet so that we can copy over the texture sheet from video memory to
     // system memory.
     ImageTexture *img = images[0]->_image_texture;
-    GLuint tex_id = img->texture_sheet->tex_id;
+    TexSheet *sheet = img->texture_sheet;
 
     ImageMemory texture;
     ImageMemory save;
@@ -388,7 +403,7 @@ bool ImageDescriptor::SaveMultiImage(const std::vector<StillImage *>& images,
         return false;
     }
 
-    TextureManager->_BindTexture(tex_id);
+    TextureManager->_BindTexSheet(sheet);
     texture.GlGetTexImage();
 
     uint32_t i = 0; // i is used to count through the images vector to get the image to save
@@ -396,13 +411,13 @@ bool ImageDescriptor::SaveMultiImage(const std::vector<StillImage *>& images,
         for(uint32_t y = 0; y < grid_columns; y++) {
             img = images[i]->_image_texture;
 
-            // Check if this image has a different texture ID than the last. If it does, we need to re-grab the texture
+            // Check if this image has a different texture sheet than the last. If it does, we need to re-grab the texture
             // memory for the texture sheet that the new image is contained within and store it in the texture.pixels
             // buffer, which is CPU system memory.
-            if(tex_id != img->texture_sheet->tex_id) {
-                // Get new texture ID
-                TextureManager->_BindTexture(img->texture_sheet->tex_id);
-                tex_id = img->texture_sheet->tex_id;
+            if(sheet != img->texture_sheet) {
+                // Get new texture sheet
+                TextureManager->_BindTexSheet(img->texture_sheet);
+                sheet = img->texture_sheet;
 
                 // If the new texture is bigger, reallocate memory
                 if(texture.GetSize2D() < img->texture_sheet->height * img->texture_sheet->width) {
@@ -458,19 +473,21 @@ void ImageDescriptor::_RemoveTextureReference()
         return;
     }
 
-    if(_texture->RemoveReference()) {
-        _texture->texture_sheet->RemoveTexture(_texture);
+    // The multi image elements are released with their whole multi image.
+    BaseTexture *texture = _texture->RemoveReference() ? _texture->ReleaseRegion() : nullptr;
+    if(texture != nullptr) {
+        texture->texture_sheet->RemoveTexture(texture);
 
         // If the image exceeds 512 in either width or height, it has an un-shared texture sheet, which we
         // should now delete that the image is being removed
-        if(_texture->width > 512 || _texture->height > 512) {
-            TextureManager->_RemoveSheet(_texture->texture_sheet);
+        if(texture->width > 512 || texture->height > 512) {
+            TextureManager->_RemoveSheet(texture->texture_sheet);
         }
 //      else {
 //          // TODO: Otherise simply mark the image as free in the texture sheet
 //          texture->texture_sheet->FreeTexture(texture);
 //      }
-        delete _texture;
+        delete texture;
     }
 
     _texture = nullptr;
@@ -483,9 +500,9 @@ void ImageDescriptor::_DrawOrientation() const
     // Fix the image offset according to the current context alignment.
     // Takes the image width/height and divides it by 2 (equal to * 0.5f)
     // and applies the offset (left, right, center/top, bottom, center).
-    Position2D align_offset (((current_context.x_align + 1) * _width) * 0.5f
+    Position2D align_offset (((current_context.draw_state.GetXAlign() + 1) * _width) * 0.5f
                              * -current_context.coordinate_system.GetHorizontalDirection(),
-                             ((current_context.y_align + 1) * _height) * 0.5f
+                             ((current_context.draw_state.GetYAlign() + 1) * _height) * 0.5f
                              * -current_context.coordinate_system.GetVerticalDirection());
 
     VideoManager->MoveRelative(align_offset.x, align_offset.y);
@@ -494,10 +511,10 @@ void ImageDescriptor::_DrawOrientation() const
     // screen shaking, and the orientation of the current coordinate system
     Position2D shake_offset;
 
-    if(current_context.x_flip) {
+    if(current_context.draw_state.IsXFlipped()) {
         shake_offset.x = _width;
     }
-    if(current_context.y_flip) {
+    if(current_context.draw_state.IsYFlipped()) {
         shake_offset.y = _height;
     }
 
@@ -560,16 +577,17 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const
     assert(draw_color != nullptr);
 
     // Set the blending parameters.
-    if (VideoManager->_current_context.blend) {
+    const DrawState& draw_state = VideoManager->_current_context.draw_state;
+    if (draw_state.IsBlending()) {
         VideoManager->EnableBlending();
-        if (VideoManager->_current_context.blend == 1) {
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+        if (draw_state.GetBlendMode() == VIDEO_BLEND) {
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
         } else {
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
         }
     } else if (_blend) {
         VideoManager->EnableBlending();
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+        VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
     } else {
         VideoManager->DisableBlending();
     }
@@ -586,14 +604,14 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const
         float t1 = _texture->v1 + (_v2 * (_texture->v2 - _texture->v1));
 
         // Swap x texture coordinates if x flipping is enabled.
-        if (VideoManager->_current_context.x_flip) {
+        if (draw_state.IsXFlipped()) {
             float temp = s0;
             s0 = s1;
             s1 = temp;
         }
 
         // Swap y texture coordinates if y flipping is enabled.
-        if (VideoManager->_current_context.y_flip) {
+        if (draw_state.IsYFlipped()) {
             float temp = t0;
             t0 = t1;
             t1 = temp;
@@ -619,11 +637,24 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const
 
         // Enable texturing and bind the texture.
         VideoManager->EnableTexture2D();
-        TextureManager->_BindTexture(_texture->texture_sheet->tex_id);
-        _texture->texture_sheet->Smooth(_smooth);
+        TexSheet* texture_sheet = _texture->texture_sheet;
+        TextureManager->_BindTexSheet(texture_sheet);
+        texture_sheet->Smooth(_smooth);
+
+        // The smoothed images drawn smaller than their texture are sampled from mipmaps,
+        // with fewer texels read and less aliasing.
+        if(_smooth && !texture_sheet->mipmapped) {
+            const float pixels_per_unit = VideoManager->GetViewportWidth()
+                                          / VideoManager->_current_context.coordinate_system.GetWidth();
+            const float texture_width = _texture->width * std::fabs(_u2 - _u1);
+            if(std::fabs(_width) * pixels_per_unit < texture_width * VIDEO_MIPMAP_MINIFICATION)
+                texture_sheet->EnableMipmaps();
+        }
+        texture_sheet->UpdateMipmaps();
 
-        // Load the sprite shader program.
-        shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Sprite);
+        // Load the sprite shader program, converting the texture to grayscale if needed.
+        shader_program = VideoManager->LoadShaderProgram(_grayscale ? gl::shader_programs::SpriteGrayscale
+                                                                    : gl::shader_programs::Sprite);
         assert(shader_program != nullptr);
     } else {
         //
@@ -634,7 +665,8 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const
         VideoManager->DisableTexture2D();
 
         // Load the solid shader program.
-        shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Solid);
+        shader_program = VideoManager->LoadShaderProgram(_grayscale ? gl::shader_programs::SolidGrayscale
+                                                                    : gl::shader_programs::Solid);
         assert(shader_program != nullptr);
     }
 
@@ -659,7 +691,8 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const
         VideoManager->UnloadShaderProgram();
 
         // Load the solid shader program.
-        shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Solid);
+        shader_program = VideoManager->LoadShaderProgram(_grayscale ? gl::shader_programs::SolidGrayscale
+                                                                    : gl::shader_programs::Solid);
         assert(shader_program != nullptr);
 
         // Draw the image.
@@ -670,118 +703,72 @@ void ImageDescriptor::_DrawTexture(const Color* draw_color) const
     VideoManager->UnloadShaderProgram();
 }
 
-bool ImageDescriptor::_LoadMultiImage(std::vector<StillImage>& images, const std::string &filename,
+bool ImageDescriptor::_IsMultiImageLoaded(uint32_t path_id, uint32_t grid_rows, uint32_t grid_cols)
+{
+    return TextureManager->_IsImageTextureRegistered(path_id, GetMultiImageTag(grid_rows, grid_cols));
+}
+
+bool ImageDescriptor::_LoadMultiImage(std::vector<StillImage>& images, const std::string &filename, uint32_t path_id,
                                       const uint32_t grid_rows, const uint32_t grid_cols)
 {
-    uint32_t current_image;
-    uint32_t x, y;
-
-    bool need_load = false;
-
-    // 1D vectors storing info for each image element
-    std::vector<std::string> tags;
-    std::vector<bool> loaded;
-
-    // Construct the tags for each image element and figure out which elements are not
-    // already in texture memory and need to be loaded
-    size_t elements = grid_rows * grid_cols;
-    tags.reserve(elements);
-    loaded.reserve(elements);
-    for(x = 0; x < grid_rows; x++) {
-        for(y = 0; y < grid_cols; y++) {
-            tags.push_back("<X" + NumberToString(x) + "_" + NumberToString(grid_rows) + ">" +
-                           "<Y" + NumberToString(y) + "_" + NumberToString(grid_cols) + ">");
-
-            if(TextureManager->_IsImageTextureRegistered(filename + tags.back())) {
-                loaded.push_back(true);
-            } else {
-                loaded.push_back(false);
-                need_load = true;
-            }
-        }
+    vt_system::AssetManifest::RecordAsset(vt_system::ASSET_IMAGE, filename);
+
+    // The tag packs the grid size.
+    if(grid_rows > MULTI_IMAGE_MAX_GRID_SIZE || grid_cols > MULTI_IMAGE_MAX_GRID_SIZE) {
+        PRINT_WARNING << "Multi images can't have more than " << MULTI_IMAGE_MAX_GRID_SIZE
+                      << " rows or columns: " << filename << std::endl;
+        return false;
     }
 
-    // If the image elements are not all loaded, then load the multi image file
-    // from disk and create enough memory to copy over individual sub-image elements from it
-    ImageMemory multi_image;
-    ImageMemory sub_image;
-    if(need_load) {
-        if(multi_image.LoadImage(filename) == false) {
+    const uint32_t tag = GetMultiImageTag(grid_rows, grid_cols);
+    ImageTexture *multi_image_texture = TextureManager->_GetImageTexture(path_id, tag);
+    if(multi_image_texture != nullptr) {
+        // The file might have been prefetched before its elements were loaded elsewhere.
+        TextureManager->CancelPrefetchedImage(filename);
+    } else {
+        // Upload the whole multi image at once, its elements being rectangles of it.
+        ImageMemory multi_image;
+        if(TextureManager->_LoadImageMemory(filename, multi_image) == false) {
             IF_PRINT_WARNING(VIDEO_DEBUG) << "Failed to load multi image file: " << filename << std::endl;
             return false;
         }
 
-        try {
-            sub_image.Resize(multi_image.GetWidth() / grid_cols, multi_image.GetHeight() / grid_rows, false);
-        }
-        catch(std::exception& e)
-        {
-            PRINT_ERROR << "Failed to malloc memory for multi image file: " << filename << std::endl
-                        << e.what() << std::endl;
+        multi_image_texture = new ImageTexture(filename, path_id, tag, multi_image.GetWidth(), multi_image.GetHeight());
+        if(TextureManager->_InsertImageInTexSheet(multi_image_texture, multi_image, images.at(0)._is_static) == nullptr) {
+            IF_PRINT_WARNING(VIDEO_DEBUG) << "Call to TextureController::_InsertImageInTexSheet failed -- " <<
+                                          "aborting multi image load operation" << std::endl;
+            delete multi_image_texture;
             return false;
         }
-    }
 
-    // One by one, get the subimages
-    current_image = 0;
-    for(x = 0; x < grid_rows; x++) {
-        for(y = 0; y < grid_cols; y++) {
-            ImageTexture *img;
-
-            // If this image already exists in a texture sheet somewhere, add a reference to it
-            // and add a new ImageElement to the current StillImage
-            if(loaded[current_image]) {
-                img = TextureManager->_GetImageTexture(filename + tags[current_image]);
-
-                if(img == nullptr) {
-                    IF_PRINT_WARNING(VIDEO_DEBUG) << "A nullptr image was found in the TextureManager's _images container "
-                                                  << "-- aborting multi image load operation" << std::endl;
-                    return false;
-                }
-
-                images.at(current_image)._filename = filename;
-                images.at(current_image)._texture = img;
-                images.at(current_image)._image_texture = img;
-            }
-
-            // We have to first extract this image from the larger multi image and add it to a texture sheet.
-            // Then we can add the image data to the StillImage being constructed
-            else {
-                images.at(current_image)._filename = filename;
-
-                sub_image.CopyFrom(multi_image,
-                                   multi_image.GetWidth() * (x * multi_image.GetHeight() / grid_rows)
-                                       + multi_image.GetWidth() * y / grid_cols);
-
-                img = new ImageTexture(filename, tags[current_image], sub_image.GetWidth(), sub_image.GetHeight());
-
-                // Try to insert the image in a texture sheet
-                TexSheet *sheet = TextureManager->_InsertImageInTexSheet(img, sub_image, images.at(current_image)._is_static);
-
-                if(sheet == nullptr) {
-                    IF_PRINT_WARNING(VIDEO_DEBUG) << "Call to TextureController::_InsertImageInTexSheet failed -- " <<
-                                                  "aborting multi image load operation" << std::endl;
-                    delete img;
-                    return false;
-                }
-
-                images.at(current_image)._texture = img;
-                images.at(current_image)._image_texture = img;
+        const uint32_t element_width = multi_image.GetWidth() / grid_cols;
+        const uint32_t element_height = multi_image.GetHeight() / grid_rows;
+        multi_image_texture->elements.reserve(grid_rows * grid_cols);
+        for(uint32_t x = 0; x < grid_rows; ++x) {
+            for(uint32_t y = 0; y < grid_cols; ++y) {
+                ImageTexture *element = new ImageTexture(multi_image_texture,
+                                                         y * element_width, x * element_height,
+                                                         element_width, element_height);
+                // Tells the map tiles which hide the ones under them.
+                element->opaque = multi_image.IsOpaque(y * element_width, x * element_height,
+                                                       element_width, element_height);
+                multi_image_texture->elements.push_back(element);
             }
+        }
+    }
 
-            img->AddReference();
+    for(uint32_t i = 0; i < multi_image_texture->elements.size(); ++i) {
+        ImageTexture *img = multi_image_texture->elements[i];
 
-            // Finally, do a grayscale conversion for the image if grayscale mode is enabled
-            if(images.at(current_image)._grayscale) {
-                // Set _grayscale to false so that the call doesn't think that the grayscale image is already loaded
-                // It will be set back to true by the _EnableGrayscale call
-                images.at(current_image)._grayscale = false;
-                images.at(current_image)._EnableGrayscale();
-            }
+        // The multi image is referenced once by each element in use.
+        if(img->ref_count == 0)
+            multi_image_texture->AddReference();
+        img->AddReference();
 
-            current_image++;
-        } // for (y = 0; y < grid_cols; y++)
-    } // for (x = 0; x < grid_rows; x++)
+        images.at(i)._filename = filename;
+        images.at(i)._texture = img;
+        images.at(i)._image_texture = img;
+    }
 
     return true;
 }
@@ -832,10 +819,16 @@ bool StillImage::Load(const std::string &filename)
         return true;
     }
 
+    vt_system::AssetManifest::RecordAsset(vt_system::ASSET_IMAGE, _filename);
+
     // 1. Check if an image with the same filename has already been loaded.
     // If so, point to that and increment its reference
-    _image_texture = TextureManager->_GetImageTexture(_filename);
+    const uint32_t path_id = TextureManager->InternImagePath(_filename);
+    _image_texture = TextureManager->_GetImageTexture(path_id);
     if(_image_texture != nullptr) {
+        // The file might have been prefetched before being loaded elsewhere.
+        TextureManager->CancelPrefetchedImage(_filename);
+
         _texture = _image_texture;
 
         if(_image_texture == nullptr) {
@@ -856,15 +849,14 @@ bool StillImage::Load(const std::string &filename)
 
     // 2. The image file needs to be loaded from disk
     ImageMemory img_data;
-    if(img_data.LoadImage(_filename) == false) {
+    if(TextureManager->_LoadImageMemory(_filename, img_data) == false) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "call to ImageMemory::LoadImage() failed for file: " << _filename << std::endl;
         return false;
     }
 
-    // Create a new texture image and store it in a texture sheet. If the _grayscale member of this class is true,
-    // we first load the color copy of the image to a texture sheet. Then we'll convert the image data to grayscale
-    // and save that image data to texture memory as well
-    _image_texture = new ImageTexture(_filename, "", img_data.GetWidth(), img_data.GetHeight());
+    // Create a new texture image and store it in a texture sheet. Grayscale images use the same texture,
+    // as they are converted when drawn.
+    _image_texture = new ImageTexture(_filename, path_id, IMAGE_TAG_NONE, img_data.GetWidth(), img_data.GetHeight());
     _texture = _image_texture;
 
     if(TextureManager->_InsertImageInTexSheet(_image_texture, img_data, _is_static) == nullptr) {
@@ -884,28 +876,18 @@ bool StillImage::Load(const std::string &filename)
     if(IsFloatEqual(_height, 0.0f))
         _height = static_cast<float>(img_data.GetHeight());
 
-    // If we don't need to create a grayscale version, we finished successfully
-    if(_grayscale == false) {
-        return true;
-    }
-
-    // 3. If we reached this point, we must now create a grayscale version of this image
-    img_data.ConvertToGrayscale();
-    ImageTexture *gray_image = new ImageTexture(_filename, "<G>", img_data.GetWidth(), img_data.GetHeight());
-    if(TextureManager->_InsertImageInTexSheet(gray_image, img_data, _is_static) == nullptr) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextureController::_InsertImageInTexSheet() failed for file: " << _filename << std::endl;
+    return true;
+}
 
-        TextureManager->_UnregisterImageTexture(gray_image);
-        delete gray_image;
-        _RemoveTextureReference(); // sets _texture to nullptr
-        _image_texture = nullptr;
+bool StillImage::IsOpaque() const
+{
+    if(_texture == nullptr || !_texture->opaque)
         return false;
-    }
-
-    _image_texture = gray_image;
-    _texture = _image_texture;
-    _image_texture->AddReference();
 
+    for(uint32_t i = 0; i < 4; ++i) {
+        if(!IsFloatEqual(_color[i][3], 1.0f))
+            return false;
+    }
     return true;
 }
 
@@ -969,70 +951,13 @@ bool StillImage::Save(const std::string &filename) const
 
 void StillImage::_EnableGrayscale()
 {
-    if(_grayscale)
-        return;
-
+    // The texture is converted to grayscale by the shader when drawn.
     _grayscale = true;
-
-    // If no image texture is available we are done here (when Load() is next called, grayscale will automatically be enabled)
-    if(_image_texture == nullptr)
-        return;
-
-    // Check if a grayscale version of this image already exists in texture memory and if so, update the ImageTexture pointer and reference
-    std::string search_key = _filename + _image_texture->tags + "<G>";
-    std::string tags = _image_texture->tags;
-    ImageTexture *temp_texture = _image_texture;
-    if((_image_texture = TextureManager->_GetImageTexture(search_key)) != nullptr) {
-        // NOTE: We do not decrement the reference to the colored image, because we want to guarantee that
-        // it remains referenced in texture memory while its grayscale counterpart is being used
-        _texture = _image_texture;
-        _image_texture->AddReference();
-        return;
-    }
-
-    // If no grayscale version exists, create a copy of the image, convert it to grayscale, and add the gray copy to texture memory
-    ImageMemory gray_img;
-    gray_img.CopyFromImage(temp_texture);
-    gray_img.ConvertToGrayscale();
-
-    ImageTexture* new_img = new ImageTexture(_filename, tags + "<G>", gray_img.GetWidth(), gray_img.GetHeight());
-
-    if(TextureManager->_InsertImageInTexSheet(new_img, gray_img, _is_static) == nullptr) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to insert new grayscale image into texture sheet" << std::endl;
-        delete new_img;
-
-        return;
-    }
-
-    _image_texture = new_img;
-    _texture = _image_texture;
-    _image_texture->AddReference();
 }
 
 void StillImage::_DisableGrayscale()
 {
-    if(_grayscale == false)
-        return;
-
     _grayscale = false;
-
-    // If no image data is loaded, we're finished
-    if(_image_texture == nullptr)
-        return;
-
-    std::string search_key = _image_texture->filename + _image_texture->tags.substr(0, _image_texture->tags.length() - 3);
-    if((_image_texture = TextureManager->_GetImageTexture(search_key)) == nullptr) {
-        PRINT_WARNING << "non-grayscale version of image was not found in texture memory: "
-                      << GetFilename() << std::endl;
-        return;
-    }
-
-    // Remove the reference to the grayscale version and grab the reference to the original color image
-    _RemoveTextureReference();
-
-    // No reference change is needed for the color image, since the color texture did not have a reference
-    // decrement when the grayscale version was enabled
-    _texture = _image_texture;
 }
 
 void StillImage::SetWidthKeepRatio(float width)
@@ -1051,6 +976,8 @@ void StillImage::SetHeightKeepRatio(float height)
 // AnimatedImage class
 // -----------------------------------------------------------------------------
 
+std::map<std::string, std::shared_ptr<const AnimationScriptDef> > AnimatedImage::_animation_script_defs;
+
 AnimatedImage::AnimatedImage(const bool grayscale)
 {
     Clear();
@@ -1072,59 +999,100 @@ void AnimatedImage::Clear()
     ImageDescriptor::Clear();
     _frame_index = 0;
     _frame_counter = 0;
+    _clock = nullptr;
+    _clock_start = 0;
     // clear all animation frame images
     for(std::vector<AnimationFrame>::iterator it = _frames.begin(); it != _frames.end(); ++it)
         (*it).image.Clear();
+    _ClearFrames();
+}
+
+void AnimatedImage::_ClearFrames()
+{
     _frames.clear();
+    _frame_end_times.clear();
+    _terminal_frame = -1;
     _animation_time = 0;
 }
 
-bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
+void AnimatedImage::SetClock(const AnimationClock* clock)
 {
-    vt_script::ReadScriptDescriptor image_script;
-    if(!image_script.OpenFile(filename))
-        return false;
+    // Go on from the frame reached with the previous clock.
+    _EvaluateClock();
+    _clock = clock;
+    _SyncClockStart();
+}
 
-    if(!image_script.DoesTableExist("animation")) {
-        PRINT_WARNING << "No animation table in " << filename << std::endl;
-        image_script.CloseFile();
-        return false;
+void AnimatedImage::_SyncClockStart()
+{
+    if(!_clock)
+        return;
+
+    uint32_t frame_start = 0;
+    if(_frame_index > 0 && _frame_index <= _frame_end_times.size())
+        frame_start = _frame_end_times[_frame_index - 1];
+    _clock_start = _clock->GetTime() - (frame_start + _frame_counter);
+}
+
+void AnimatedImage::_SetAnimationTime(uint32_t time) const
+{
+    if(_frame_end_times.empty()) {
+        _frame_index = 0;
+        _frame_counter = 0;
+        return;
     }
 
-    image_script.OpenTable("animation");
+    if(_terminal_frame >= 0) {
+        // The terminator frame is displayed 'forever' once reached.
+        const uint32_t terminal_frame = static_cast<uint32_t>(_terminal_frame);
+        const uint32_t terminal_start = terminal_frame == 0 ? 0 : _frame_end_times[terminal_frame - 1];
+        if(time >= terminal_start) {
+            _frame_index = terminal_frame;
+            _frame_counter = 0;
+            return;
+        }
+    }
+    else {
+        // No frame time is 0 here, so the animation length isn't either.
+        time %= _frame_end_times.back();
+    }
 
-    std::string image_filename = image_script.ReadString("image_filename");
-    if (image_script.DoesBoolExist("blended_animation"))
-        _blended_animation = image_script.ReadBool("blended_animation");
+    // The first frame ending after the given time.
+    const uint32_t index = std::upper_bound(_frame_end_times.begin(), _frame_end_times.end(), time)
+                           - _frame_end_times.begin();
+    _frame_index = index;
+    _frame_counter = time - (index == 0 ? 0 : _frame_end_times[index - 1]);
+}
 
-    if(!vt_utils::DoesFileExist(image_filename)) {
-        PRINT_WARNING << "The image file doesn't exist: " << image_filename << std::endl;
-        image_script.CloseTable();
-        image_script.CloseFile();
+bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
+{
+    vt_system::AssetManifest::RecordAsset(vt_system::ASSET_ANIMATION, filename);
+
+    std::shared_ptr<const AnimationScriptDef> animation_def = _GetAnimationScriptDef(filename);
+    if(animation_def == nullptr)
         return false;
-    }
 
-    uint32_t rows = image_script.ReadUInt("rows");
-    uint32_t columns = image_script.ReadUInt("columns");
+    const std::string& image_filename = animation_def->image_filename;
+    if (animation_def->is_blended_animation_set)
+        _blended_animation = animation_def->blended_animation;
 
-    if(!image_script.DoesTableExist("frames")) {
-        image_script.CloseTable();
-        image_script.CloseFile();
-        PRINT_WARNING << "No 'frames' table in file: " << filename << std::endl;
+    if(!vt_system::DoesAssetExist(image_filename)) {
+        PRINT_WARNING << "The image file doesn't exist: " << image_filename << std::endl;
         return false;
     }
 
     std::vector<StillImage> image_frames;
     // Load the image data
-    if(!ImageDescriptor::LoadMultiImageFromElementGrid(image_frames, image_filename, rows, columns)) {
+    if(!ImageDescriptor::LoadMultiImageFromElementGrid(image_frames, image_filename, animation_def->image_path_id,
+                                                       animation_def->rows, animation_def->columns)) {
         PRINT_WARNING << "Couldn't load elements from image file: " << image_filename
                       << " (in file: " << filename << ")" << std::endl;
         return false;
     }
 
     // Load requested dimensions and setup default ones if not set
-    float frame_width = image_script.ReadFloat("frame_width");
-    float frame_height = image_script.ReadFloat("frame_height");
+    float frame_width = animation_def->frame_width;
+    float frame_height = animation_def->frame_height;
 
     if(IsFloatEqual(frame_width, 0.0f) && IsFloatEqual(frame_height, 0.0f)) {
         // If the animation dimensions are not set, we're using the first frame size.
@@ -1132,9 +1100,88 @@ bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
         frame_height = image_frames.begin()->GetHeight();
     }
 
-    std::vector<uint32_t> frames_ids;
-    std::vector<uint32_t> frames_duration;
-    std::vector<std::pair<float, float> > frames_offsets;
+    // Actually create the animation data
+    _ClearFrames();
+    ResetAnimation();
+
+    std::vector<const AnimationScriptDef::Frame *> frames;
+    for(uint32_t i = 0; i < animation_def->frames.size(); ++i) {
+        const AnimationScriptDef::Frame& frame = animation_def->frames[i];
+        if(frame.id >= image_frames.size()) {
+            PRINT_WARNING << "Invalid frame (" << i << ") in file: "
+                          << filename << std::endl;
+            PRINT_WARNING << "Request for frame id: " << frame.id << ", duration: "
+                          << frame.duration << " is not possible." << std::endl;
+            continue;
+        }
+
+        // First copy the image data raw
+        if(AddFrame(image_frames[frame.id], frame.duration))
+            frames.push_back(&frame);
+    }
+
+    // Once copied and only at that time, setup the data offsets to avoid the case
+    // where the offsets might be applied several times on the same origin image,
+    // breaking the offset resizing when the dimensions are different from the original image.
+    for (uint32_t i = 0; i < _frames.size(); ++i)
+        _frames[i].image.SetDrawOffsets(frames[i]->x_offset, frames[i]->y_offset);
+
+    // Then only, set the dimensions
+    SetDimensions(frame_width, frame_height);
+
+    return true;
+}
+
+std::string AnimatedImage::PrefetchAnimationScript(const std::string &filename)
+{
+    std::shared_ptr<const AnimationScriptDef> animation_def = _GetAnimationScriptDef(filename);
+    if(animation_def == nullptr || !vt_system::DoesAssetExist(animation_def->image_filename))
+        return std::string();
+
+    if(!_IsMultiImageLoaded(animation_def->image_path_id, animation_def->rows, animation_def->columns))
+        TextureManager->PrefetchImage(animation_def->image_filename);
+    return animation_def->image_filename;
+}
+
+std::shared_ptr<const AnimationScriptDef> AnimatedImage::_GetAnimationScriptDef(const std::string &filename)
+{
+    std::map<std::string, std::shared_ptr<const AnimationScriptDef> >::const_iterator it = _animation_script_defs.find(filename);
+    if(it != _animation_script_defs.end())
+        return it->second;
+
+    vt_script::ReadScriptDescriptor image_script;
+    if(!image_script.OpenFile(filename))
+        return nullptr;
+
+    if(!image_script.DoesTableExist("animation")) {
+        PRINT_WARNING << "No animation table in " << filename << std::endl;
+        image_script.CloseFile();
+        return nullptr;
+    }
+
+    std::shared_ptr<AnimationScriptDef> animation_def = std::make_shared<AnimationScriptDef>();
+
+    image_script.OpenTable("animation");
+
+    animation_def->image_filename = image_script.ReadString("image_filename");
+    animation_def->image_path_id = TextureManager->InternImagePath(animation_def->image_filename);
+    if (image_script.DoesBoolExist("blended_animation")) {
+        animation_def->is_blended_animation_set = true;
+        animation_def->blended_animation = image_script.ReadBool("blended_animation");
+    }
+
+    animation_def->rows = image_script.ReadUInt("rows");
+    animation_def->columns = image_script.ReadUInt("columns");
+
+    if(!image_script.DoesTableExist("frames")) {
+        image_script.CloseTable();
+        image_script.CloseFile();
+        PRINT_WARNING << "No 'frames' table in file: " << filename << std::endl;
+        return nullptr;
+    }
+
+    animation_def->frame_width = image_script.ReadFloat("frame_width");
+    animation_def->frame_height = image_script.ReadFloat("frame_height");
 
     image_script.OpenTable("frames");
     uint32_t num_frames = image_script.GetTableSize();
@@ -1152,7 +1199,8 @@ bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
         if (image_script.DoesFloatExist("y_offset"))
             y_offset = image_script.ReadFloat("y_offset");
 
-        if(frame_id < 0 || frame_duration < 0 || frame_id >= (int32_t)image_frames.size()) {
+        // The frame ids are checked against the image grid when loading the animations.
+        if(frame_id < 0 || frame_duration < 0) {
             PRINT_WARNING << "Invalid frame (" << frames_table_id << ") in file: "
                           << filename << std::endl;
             PRINT_WARNING << "Request for frame id: " << frame_id << ", duration: "
@@ -1160,9 +1208,8 @@ bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
             continue;
         }
 
-        frames_ids.push_back((uint32_t)frame_id);
-        frames_duration.push_back((uint32_t)frame_duration);
-        frames_offsets.push_back(std::make_pair(x_offset, y_offset));
+        animation_def->frames.push_back(AnimationScriptDef::Frame(static_cast<uint32_t>(frame_id),
+                                        static_cast<uint32_t>(frame_duration), x_offset, y_offset));
 
         image_script.CloseTable(); // frames[frame_table_id] table
     }
@@ -1171,31 +1218,18 @@ bool AnimatedImage::LoadFromAnimationScript(const std::string &filename)
     image_script.CloseAllTables();
     image_script.CloseFile();
 
-    // Actually create the animation data
-    _frames.clear();
-    ResetAnimation();
-    // First copy the image data raw
-    for(uint32_t i = 0; i < frames_ids.size(); ++i)
-        AddFrame(image_frames[frames_ids[i]], frames_duration[i]);
-
-    // Once copied and only at that time, setup the data offsets to avoid the case
-    // where the offsets might be applied several times on the same origin image,
-    // breaking the offset resizing when the dimensions are different from the original image.
-    for (uint32_t i = 0; i < _frames.size(); ++i)
-        _frames[i].image.SetDrawOffsets(frames_offsets[i].first, frames_offsets[i].second);
+#ifdef DEBUG_FEATURES
+    vt_system::AssetWatcher::Watch(vt_system::ASSET_ANIMATION, filename);
+#endif
 
-    // Then only, set the dimensions
-    SetDimensions(frame_width, frame_height);
-
-    return true;
+    _animation_script_defs[filename] = animation_def;
+    return animation_def;
 }
 
-
 bool AnimatedImage::LoadFromFrameSize(const std::string &filename, const std::vector<uint32_t>& timings,
                                       const uint32_t frame_width, const uint32_t frame_height, const uint32_t trim)
 {
     // Make the multi image call
-    // TODO: Handle the case where the _grayscale member is true so all frames are loaded in grayscale format
     std::vector<StillImage> image_frames;
     if(ImageDescriptor::LoadMultiImageFromElementSize(image_frames, filename, frame_width, frame_height) == false) {
         return false;
@@ -1211,7 +1245,7 @@ bool AnimatedImage::LoadFromFrameSize(const std::string &filename, const std::ve
         return false;
     }
 
-    _frames.clear();
+    _ClearFrames();
     ResetAnimation();
 
     // Add the loaded frame image and timing information
@@ -1239,11 +1273,10 @@ bool AnimatedImage::LoadFromFrameGrid(const std::string &filename, const std::ve
         return false;
     }
 
-    _frames.clear();
+    _ClearFrames();
     ResetAnimation();
 
     // Make the multi image call
-    // TODO: Handle the case where the _grayscale member is true so all frames are loaded in grayscale format
     std::vector<StillImage> image_frames;
     if(ImageDescriptor::LoadMultiImageFromElementGrid(image_frames, filename, frame_rows, frame_cols) == false) {
         return false;
@@ -1278,6 +1311,8 @@ void AnimatedImage::Draw(const Color& draw_color) const
         return;
     }
 
+    _EvaluateClock();
+
     if (!_blended_animation || _frames[_frame_index].frame_time <= 4
             || _frame_counter > _frames[_frame_index].frame_time / 4) {
         _frames[_frame_index].image.Draw(draw_color);
@@ -1348,6 +1383,10 @@ void AnimatedImage::Update(uint32_t elapsed_time)
     if(_frames.size() <= 1)
         return;
 
+    // The animations bound to a clock follow it instead.
+    if(_clock)
+        return;
+
     // If the frame time is 0, it means the frame is a terminator and should be displayed 'forever'.
     if (_frames[_frame_index].frame_time == 0) {
         return;
@@ -1388,8 +1427,8 @@ bool AnimatedImage::AddFrame(const std::string &frame, uint32_t frame_time)
     AnimationFrame new_frame;
     new_frame.frame_time = frame_time;
     new_frame.image = img;
-    _frames.push_back(new_frame);
-    _animation_time += frame_time;
+    new_frame.image.SetGrayscale(_grayscale);
+    _AddFrame(new_frame);
     return true;
 }
 
@@ -1402,13 +1441,23 @@ bool AnimatedImage::AddFrame(const StillImage &frame, uint32_t frame_time)
 
     AnimationFrame new_frame;
     new_frame.image = frame;
+    new_frame.image.SetGrayscale(_grayscale);
     new_frame.frame_time = frame_time;
 
-    _frames.push_back(new_frame);
-    _animation_time += frame_time;
+    _AddFrame(new_frame);
     return true;
 }
 
+void AnimatedImage::_AddFrame(const AnimationFrame& frame)
+{
+    if(frame.frame_time == 0 && _terminal_frame < 0)
+        _terminal_frame = static_cast<int32_t>(_frames.size());
+
+    _frames.push_back(frame);
+    _animation_time += frame.frame_time;
+    _frame_end_times.push_back(_animation_time);
+}
+
 void AnimatedImage::SetWidth(float width)
 {
     _width = width;
@@ -1473,9 +1522,10 @@ void AnimatedImage::RandomizeAnimationFrame() {
     if (nb_frames <= 1)
         return;
 
-    uint32_t index = vt_utils::RandomBoundedInteger(0, nb_frames - 1);
+    uint32_t index = GetRandomStream(RANDOM_STREAM_ANIMATIONS).BoundedInteger(0, nb_frames - 1);
     _frame_index = index;
     _frame_counter = 0;
+    _SyncClockStart();
 }
 
 // -----------------------------------------------------------------------------
@@ -1486,6 +1536,8 @@ void CompositeImage::Clear()
 {
     ImageDescriptor::Clear();
     _elements.clear();
+    _flattened.Clear();
+    _flattened_valid = false;
 }
 
 
@@ -1501,6 +1553,24 @@ void CompositeImage::Draw(const Color &draw_color) const
     if(IsFloatEqual(draw_color[3], 0.0f))
         return;
 
+    if(_flatten && _DrawFlattened(draw_color))
+        return;
+
+    if(draw_color == Color::white) {
+        _DrawElements(_color);
+    }
+    else {
+        Color modulated_colors[4];
+        modulated_colors[0] = _color[0] * draw_color;
+        modulated_colors[1] = _color[1] * draw_color;
+        modulated_colors[2] = _color[2] * draw_color;
+        modulated_colors[3] = _color[3] * draw_color;
+        _DrawElements(modulated_colors);
+    }
+} // void CompositeImage::Draw(const Color& draw_color) const
+
+void CompositeImage::_DrawElements(const Color* colors) const
+{
     CoordSys coord_sys = VideoManager->_current_context.coordinate_system;
 
     Position2D shake(VideoManager->_shake_offset.x
@@ -1510,9 +1580,9 @@ void CompositeImage::Draw(const Color &draw_color) const
                      * (coord_sys.GetTop() - coord_sys.GetBottom())
                      / VIDEO_STANDARD_RES_HEIGHT);
 
-    Position2D align_offset(((VideoManager->_current_context.x_align + 1) * _width) * 0.5f
+    Position2D align_offset(((VideoManager->_current_context.draw_state.GetXAlign() + 1) * _width) * 0.5f
                             * -coord_sys.GetHorizontalDirection(),
-                            ((VideoManager->_current_context.y_align + 1) * _height) * 0.5f
+                            ((VideoManager->_current_context.draw_state.GetYAlign() + 1) * _height) * 0.5f
                             * -coord_sys.GetVerticalDirection());
 
     // Save the draw cursor position as we move to draw each element
@@ -1523,13 +1593,13 @@ void CompositeImage::Draw(const Color &draw_color) const
     for(uint32_t i = 0; i < _elements.size(); ++i) {
         Position2D offset;
 
-        if(VideoManager->_current_context.x_flip) {
+        if(VideoManager->_current_context.draw_state.IsXFlipped()) {
             offset.x = _width - _elements[i].offset.x - _elements[i].image.GetWidth();
         } else {
             offset.x = _elements[i].offset.x;
         }
 
-        if(VideoManager->_current_context.y_flip) {
+        if(VideoManager->_current_context.draw_state.IsYFlipped()) {
             offset.y = _height - _elements[i].offset.y - _elements[i].image.GetHeight();
         } else {
             offset.y = _elements[i].offset.y;
@@ -1552,20 +1622,43 @@ void CompositeImage::Draw(const Color &draw_color) const
 
         VideoManager->Scale(scale.x, scale.y);
 
-        if(draw_color == Color::white)
-            _elements[i].image._DrawTexture(_color);
-        else {
-            Color modulated_colors[4];
-            modulated_colors[0] = _color[0] * draw_color;
-            modulated_colors[1] = _color[1] * draw_color;
-            modulated_colors[2] = _color[2] * draw_color;
-            modulated_colors[3] = _color[3] * draw_color;
-            _elements[i].image._DrawTexture(modulated_colors);
-        }
+        _elements[i].image._DrawTexture(colors);
         VideoManager->PopMatrix();
     }
     VideoManager->PopMatrix();
-} // void CompositeImage::Draw(const Color& draw_color) const
+}
+
+bool CompositeImage::_DrawFlattened(const Color& draw_color) const
+{
+    // The vertex colors would otherwise span the whole composite, instead of each element.
+    if(!(_color[0] == _color[1] && _color[0] == _color[2] && _color[0] == _color[3]))
+        return false;
+
+    const CoordSys& coord_sys = VideoManager->_current_context.coordinate_system;
+    const float x_scale = VideoManager->_viewport_width / std::fabs(coord_sys.GetRight() - coord_sys.GetLeft());
+    const float y_scale = VideoManager->_viewport_height / std::fabs(coord_sys.GetTop() - coord_sys.GetBottom());
+
+    if(!_flattened_valid || !IsFloatEqual(_flattened_x_scale, x_scale) || !IsFloatEqual(_flattened_y_scale, y_scale)) {
+        _flattened.Clear();
+        _flattened_valid = true;
+        _flattened_x_scale = x_scale;
+        _flattened_y_scale = y_scale;
+
+        if(!_elements.empty() && _width > 0.0f && _height > 0.0f)
+            _flattened = VideoManager->_FlattenCompositeImage(*this,
+                                                              static_cast<uint32_t>(std::ceil(_width * x_scale)),
+                                                              static_cast<uint32_t>(std::ceil(_height * y_scale)));
+    }
+
+    // Nothing to draw, or the flattening failed.
+    if(_flattened._texture == nullptr)
+        return _elements.empty();
+
+    for(uint32_t i = 0; i < 4; ++i)
+        _flattened._color[i] = _color[i];
+    _flattened.Draw(draw_color);
+    return true;
+}
 
 
 
@@ -1581,6 +1674,7 @@ void CompositeImage::SetWidth(float width)
     if(_elements.size() == 1) {
         _width = width;
         _elements[0].image.SetWidth(width);
+        _flattened_valid = false;
         return;
     }
 
@@ -1596,6 +1690,7 @@ void CompositeImage::SetWidth(float width)
             i->image.SetWidth(width * (_width / i->image.GetWidth()));
     }
     _width = width;
+    _flattened_valid = false;
 }
 
 void CompositeImage::SetHeight(float height)
@@ -1610,6 +1705,7 @@ void CompositeImage::SetHeight(float height)
     if(_elements.size() == 1) {
         _height = height;
         _elements[0].image.SetHeight(height);
+        _flattened_valid = false;
         return;
     }
 
@@ -1625,6 +1721,7 @@ void CompositeImage::SetHeight(float height)
             i->image.SetHeight(height * (_height / i->image.GetHeight()));
     }
     _height = height;
+    _flattened_valid = false;
 }
 
 void CompositeImage::SetColor(const Color &color)
@@ -1645,6 +1742,21 @@ void CompositeImage::SetVertexColors(const Color &tl, const Color &tr, const Col
     }
 }
 
+void CompositeImage::SortElementsByTexture(uint32_t first_element)
+{
+    if(first_element >= _elements.size())
+        return;
+
+    std::stable_sort(_elements.begin() + first_element, _elements.end(),
+                     [](const ImageElement& first, const ImageElement& second) {
+        TexSheet* first_sheet = first.image._texture ? first.image._texture->texture_sheet : nullptr;
+        TexSheet* second_sheet = second.image._texture ? second.image._texture->texture_sheet : nullptr;
+        return std::less<TexSheet*>()(first_sheet, second_sheet);
+    });
+}
+
+
+
 void CompositeImage::AddImage(const StillImage &img, float x_offset, float y_offset, float u1, float v1, float u2, float v2)
 {
     if(x_offset < 0.0f || y_offset < 0.0f) {
@@ -1653,6 +1765,7 @@ void CompositeImage::AddImage(const StillImage &img, float x_offset, float y_off
     }
 
     _elements.push_back(ImageElement(img, x_offset, y_offset));
+    _flattened_valid = false;
 
     StillImage &new_image = _elements.back().image;
 
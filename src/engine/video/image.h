@@ -54,6 +54,9 @@
 
 #include "common/position_2d.h"
 
+#include <map>
+#include <memory>
+
 namespace vt_mode_manager
 {
 class ParticleSystem;
@@ -94,6 +97,7 @@ class StillImage;
 class ImageDescriptor
 {
     friend class VideoEngine;
+    friend class StaticImageLayer;
 
 public:
     ImageDescriptor();
@@ -242,6 +246,13 @@ public:
     static bool LoadMultiImageFromElementGrid(std::vector<StillImage>& images, const std::string &filename,
             const uint32_t grid_rows, const uint32_t grid_cols);
 
+    /** \brief Loads a multi image, whose filename path id was already interned
+    *** \param path_id The id of filename given by TextureController::InternImagePath()
+    *** \note The image file isn't read at all when its elements are already loaded.
+    **/
+    static bool LoadMultiImageFromElementGrid(std::vector<StillImage>& images, const std::string &filename,
+            uint32_t path_id, const uint32_t grid_rows, const uint32_t grid_cols);
+
     /** \brief Saves a vector of images into a single image file (a multi image)
     *** \param images A reference to the vector of StillImage pointers to save into a multi image
     *** \param filename The name of the multi image file to write (.png of .jpg extension required)
@@ -323,15 +334,19 @@ protected:
 
     virtual void _DisableGrayscale() = 0;
 
+    //! \brief Tells whether the elements of a multi image are already in texture memory.
+    static bool _IsMultiImageLoaded(uint32_t path_id, uint32_t grid_rows, uint32_t grid_cols);
+
 private:
     /** \brief A helper function to the public LoadMultiImage* calls
     *** \param images Reference to the vector of StillImages to be loaded
     *** \param filename The name of the multi image file to read
+    *** \param path_id The interned path id of filename
     *** \param grid_rows The number of rows of image elements in the multi image
     *** \param grid_cols The number of columns of image elements in the multi image
     *** \return True if the image file was loaded and parsed successfully, false if there was an error.
     **/
-    static bool _LoadMultiImage(std::vector<StillImage>& images, const std::string &filename,
+    static bool _LoadMultiImage(std::vector<StillImage>& images, const std::string &filename, uint32_t path_id,
                                 const uint32_t grid_rows, const uint32_t grid_cols);
 }; // class ImageDescriptor
 
@@ -398,6 +413,9 @@ public:
         return _filename;
     }
 
+    //! \brief Tells whether the image hides what is drawn under it, its pixels and vertex colors being all opaque.
+    bool IsOpaque() const;
+
     /** \brief Returns the color of a particular vertex
     *** \param c The Color object to place the color in.
     *** \param index The vertex index of the color to fetch
@@ -490,10 +508,10 @@ protected:
     //! \brief X and y draw position offsets of this element
     vt_common::Position2D _offset;
 
-    //! \brief Enables grayscaling for the image then reloads it
+    //! \brief Draws the image with the grayscale shader from now on
     void _EnableGrayscale() override;
 
-    //! \brief Disables grayscaling for the image then reloads it
+    //! \brief Draws the image in color again
     void _DisableGrayscale() override;
 };
 
@@ -513,6 +531,62 @@ public:
     StillImage image;
 }; // class AnimationFrame
 
+/** ****************************************************************************
+*** \brief The content of an animation script, read once and shared by every
+*** animation loaded from it.
+*** ***************************************************************************/
+class AnimationScriptDef
+{
+public:
+    AnimationScriptDef() :
+        image_path_id(private_video::INVALID_IMAGE_PATH),
+        is_blended_animation_set(false),
+        blended_animation(false),
+        rows(0),
+        columns(0),
+        frame_width(0.0f),
+        frame_height(0.0f)
+    {
+    }
+
+    //! \brief A frame of the animation, referring to an element of the image grid.
+    class Frame
+    {
+    public:
+        Frame(uint32_t id, uint32_t duration, float x_offset, float y_offset) :
+            id(id),
+            duration(duration),
+            x_offset(x_offset),
+            y_offset(y_offset)
+        {
+        }
+
+        uint32_t id;
+        uint32_t duration;
+        float x_offset;
+        float y_offset;
+    };
+
+    std::string image_filename;
+
+    //! \brief The interned path id of image_filename.
+    uint32_t image_path_id;
+
+    //! \brief Whether the script tells if the frames are blended. Left unchanged otherwise.
+    bool is_blended_animation_set;
+    bool blended_animation;
+
+    //! \brief The image grid dimensions.
+    uint32_t rows;
+    uint32_t columns;
+
+    //! \brief The requested frame dimensions, both 0.0f when not set.
+    float frame_width;
+    float frame_height;
+
+    std::vector<Frame> frames;
+};
+
 /** ****************************************************************************
 *** \brief Represents a single element in a composite image
 *** ***************************************************************************/
@@ -540,6 +614,34 @@ public:
 
 } // namespace private_video
 
+/** ****************************************************************************
+*** \brief A clock shared by the animations of a game mode, advanced once per update.
+***
+*** The animations bound to a clock aren't updated: Their current frame is found
+*** from the clock time when they are drawn, so that the animations off-screen
+*** cost nothing.
+*** ***************************************************************************/
+class AnimationClock
+{
+public:
+    AnimationClock() :
+        _time(0)
+    {}
+
+    //! \brief Advances the clock by the given number of milliseconds.
+    void Update(uint32_t elapsed_time) {
+        _time += elapsed_time;
+    }
+
+    //! \brief Returns the clock time, in milliseconds.
+    uint32_t GetTime() const {
+        return _time;
+    }
+
+private:
+    uint32_t _time;
+};
+
 /** ****************************************************************************
 *** \brief Represents an animated image with both frames and timing information
 ***
@@ -612,6 +714,19 @@ public:
      */
     bool LoadFromAnimationScript(const std::string &filename);
 
+    /** \brief Reads an animation script, and starts decoding its image in the background,
+    *** so that loading the animation later on doesn't stall.
+    *** \return The image file of the animation, or an empty string if the script couldn't be read.
+    **/
+    static std::string PrefetchAnimationScript(const std::string &filename);
+
+    /** \brief Drops a cached animation script, so that it is read again by the next animation loading it.
+    *** \note The animations already loaded are left as they are.
+    **/
+    static void InvalidateAnimationScript(const std::string &filename) {
+        _animation_script_defs.erase(filename);
+    }
+
     /** \brief Draws the current frame image which is modulated by a color
     *** \param draw_color The color to modulate the image by
     **/
@@ -634,15 +749,24 @@ public:
     void ResetAnimation() {
         _frame_index = 0;
         _frame_counter = 0;
+        _SyncClockStart();
     }
 
+    /** \brief Binds the animation to a clock, or unbinds it when nullptr.
+    *** A bound animation goes on from its current frame, following the clock time:
+    *** Update() then does nothing, and the current frame is looked up from the clock
+    *** when the animation is drawn or its frame is requested.
+    *** \note The clock must outlive the animation, or be unbound beforehand.
+    **/
+    void SetClock(const AnimationClock* clock);
+
     /** \brief Called every frame to update the animation's current frame
     *** This will automatically synchronize the animation according to the time passed
     *** since the last call.
     *** \param elapsed_time Used to force a certain amount of time, i.e: accelerate an animation.
     *** The function will use actual elapsed time if equal to 0.
     *** \note This method will do nothing if there are no frames contained in the animation,
-    *** or if the _loops_finished member is set to true.
+    *** or if the animation is bound to a clock.
     **/
     void Update(uint32_t elapsed_time);
     void Update() {
@@ -681,11 +805,13 @@ public:
 
     //! \brief Retuns a pointer to the StillImage representing the current frame
     StillImage *GetCurrentFrame() const {
+        _EvaluateClock();
         return GetFrame(_frame_index);
     }
 
     //! \brief Returns the index number of the current frame in the animation.
     uint32_t GetCurrentFrameIndex() const {
+        _EvaluateClock();
         return _frame_index;
     }
 
@@ -704,6 +830,7 @@ public:
 
     //! \brief Returns the number of milliseconds that the current frame has been shown for.
     uint32_t GetTimeProgress() const {
+        _EvaluateClock();
         return _frame_counter;
     }
 
@@ -713,6 +840,7 @@ public:
     *** a divide by zero exception at run-time.
     **/
     float GetPercentProgress() const {
+        _EvaluateClock();
         return static_cast<float>(_frame_counter) / _frames[_frame_index].frame_time;
     }
 
@@ -723,6 +851,7 @@ public:
 
     //! \brief Returns true if the animation has ended.
     bool IsAnimationFinished() const {
+        _EvaluateClock();
         return _frames[_frame_index].frame_time == 0;
     }
 
@@ -782,6 +911,7 @@ public:
         if(index > _frames.size()) return;
         _frame_index = index;
         _frame_counter = 0;
+        _SyncClockStart();
     }
 
     /** \brief Sets a random frame index to the animation.
@@ -796,6 +926,15 @@ public:
     **/
     void SetTimeProgress(uint32_t time) {
         _frame_counter = time;
+        _SyncClockStart();
+    }
+
+    /** \brief Shows the frame reached the given number of milliseconds after the animation start.
+    *** This permits to draw a single animation for several users, each one at its own time.
+    **/
+    void SetAnimationTime(uint32_t time) {
+        _SetAnimationTime(time);
+        _SyncClockStart();
     }
 
     //! \brief Sets whether the animation frames will blend from one to another.
@@ -811,10 +950,25 @@ public:
 
 private:
     //! \brief The index of which animation frame to display.
-    uint32_t _frame_index;
+    //! \note Mutable, since the animations bound to a clock find it when drawn.
+    mutable uint32_t _frame_index;
 
     //! \brief Counts how long each frame has been shown for.
-    uint32_t _frame_counter;
+    mutable uint32_t _frame_counter;
+
+    //! \brief The clock followed by the animation, or nullptr when it is updated.
+    const AnimationClock* _clock;
+
+    //! \brief The clock time at which the first frame of the animation was shown.
+    uint32_t _clock_start;
+
+    /** \brief The time at which each frame ends, from the start of the first frame.
+    *** Searched to find the frame shown at a given time.
+    **/
+    std::vector<uint32_t> _frame_end_times;
+
+    //! \brief The index of the first frame whose time is 0, shown 'forever' once reached. -1 if none.
+    int32_t _terminal_frame;
 
     //! \brief Tells whether the animation frames are blended one with another.
     bool _blended_animation;
@@ -830,6 +984,32 @@ private:
 
     //! \brief Disables grayscale for all image frames
     void _DisableGrayscale();
+
+    //! \brief Sets the current frame from the clock time, when bound to a clock.
+    void _EvaluateClock() const {
+        if(_clock)
+            _SetAnimationTime(_clock->GetTime() - _clock_start);
+    }
+
+    //! \brief Sets the clock start from the current frame, so that the animation goes on from it.
+    void _SyncClockStart();
+
+    //! \brief Sets the current frame from the time elapsed since the start of the first frame.
+    void _SetAnimationTime(uint32_t time) const;
+
+    //! \brief Removes all the frames.
+    void _ClearFrames();
+
+    //! \brief Appends a frame, and its end time.
+    void _AddFrame(const private_video::AnimationFrame& frame);
+
+    //! \brief The animation scripts read so far, by filename.
+    static std::map<std::string, std::shared_ptr<const private_video::AnimationScriptDef> > _animation_script_defs;
+
+    /** \brief Returns the content of an animation script, reading it if it isn't cached yet.
+    *** \return nullptr if the script couldn't be read.
+    **/
+    static std::shared_ptr<const private_video::AnimationScriptDef> _GetAnimationScriptDef(const std::string &filename);
 };
 
 /** ****************************************************************************
@@ -848,8 +1028,14 @@ private:
 *** ***************************************************************************/
 class CompositeImage : public ImageDescriptor
 {
+    friend class VideoEngine;
+
 public:
-    CompositeImage()
+    CompositeImage() :
+        _flatten(false),
+        _flattened_valid(false),
+        _flattened_x_scale(0.0f),
+        _flattened_y_scale(0.0f)
     {
     }
 
@@ -928,10 +1114,56 @@ public:
     void AddImage(const StillImage &img, float x_offset, float y_offset, float u1 = 0.0f, float v1 = 0.0f,
                   float u2 = 1.0f, float v2 = 1.0f);
 
+    /** \brief Reorders the elements so that the ones using the same texture sheet are drawn in a row.
+    *** \param first_element The elements before this one are left untouched, to keep them drawn first.
+    ***
+    *** The sprite draws of consecutive elements are then batched together. Only call this
+    *** when the reordered elements don't overlap each other, as their draw order changes.
+    **/
+    void SortElementsByTexture(uint32_t first_element = 0);
+
+    //! \brief Returns the number of image elements.
+    uint32_t GetNumElements() const {
+        return static_cast<uint32_t>(_elements.size());
+    }
+
+    /** \brief Draws the elements once in a texture region of their own, then drawn instead of them.
+    ***
+    *** Worth it for the composites of many elements seldom changed, such as the menu windows,
+    *** drawn then with a single sprite. The region is drawn again when the composite is drawn
+    *** after its elements or dimensions changed, or at another screen resolution.
+    *** \note Stays enabled when the elements are cleared.
+    **/
+    void Flatten() {
+        _flatten = true;
+        _flattened_valid = false;
+    }
+
 private:
     //! \brief A container for each element in the composite image
     std::vector<private_video::ImageElement> _elements;
 
+    //! \brief Whether the elements are drawn through the flattened image.
+    bool _flatten;
+
+    //! \brief The elements drawn in a texture region, when flattened.
+    mutable StillImage _flattened;
+
+    //! \brief Whether the flattened image matches the current elements.
+    mutable bool _flattened_valid;
+
+    //! \brief The number of pixels per coordinate unit the flattened image was drawn at.
+    mutable float _flattened_x_scale;
+    mutable float _flattened_y_scale;
+
+    //! \brief Draws the elements at the draw cursor, with the given vertex colors.
+    void _DrawElements(const Color* colors) const;
+
+    /** \brief Draws the flattened image, drawing the elements in it first when needed.
+    *** \return False when the elements must be drawn instead.
+    **/
+    bool _DrawFlattened(const Color& draw_color) const;
+
     void _EnableGrayscale() override
     {}
 
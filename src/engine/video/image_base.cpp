@@ -18,6 +18,9 @@
 #include "image_base.h"
 
 #include "video.h"
+#include "gl/gl_pixel_upload_buffer.h"
+
+#include "engine/asset_archive.h"
 
 #include "utils/utils_common.h"
 
@@ -27,6 +30,16 @@
 #include <SDL2/SDL_endian.h>
 #include <png.h>
 
+// SSE2 and NEON are part of the base instruction sets of x86-64 and ARMv8,
+// so the vectorized pixel conversions are chosen when compiling.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define VT_VIDEO_SSE2
+#   include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   define VT_VIDEO_NEON
+#   include <arm_neon.h>
+#endif
+
 using namespace vt_utils;
 
 namespace vt_video
@@ -35,6 +48,168 @@ namespace vt_video
 namespace private_video
 {
 
+// -----------------------------------------------------------------------------
+// Pixel conversions
+// -----------------------------------------------------------------------------
+
+/** \brief Converts ARGB8888 pixels, stored as BGRA bytes, to RGBA bytes.
+*** The color of fully transparent pixels is also made black, so that OpenGL
+*** doesn't average it with the neighbour pixels when smoothing, which would
+*** show white edges on sprites.
+**/
+static void ConvertBGRAToRGBA(const uint8_t* src, uint8_t* dst, size_t number_of_pixels)
+{
+    size_t i = 0;
+
+#if defined(VT_VIDEO_SSE2)
+    const __m128i mask_alpha_green = _mm_set1_epi32(static_cast<int32_t>(0xFF00FF00));
+    const __m128i mask_red_blue = _mm_set1_epi32(0x00FF00FF);
+    const __m128i mask_alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= number_of_pixels; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+
+        // Swap the red and blue bytes of each pixel.
+        const __m128i red_blue = _mm_and_si128(pixels, mask_red_blue);
+        __m128i result = _mm_or_si128(_mm_and_si128(pixels, mask_alpha_green),
+                                      _mm_or_si128(_mm_slli_epi32(red_blue, 16), _mm_srli_epi32(red_blue, 16)));
+
+        // Clear the fully transparent pixels.
+        const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(pixels, mask_alpha), zero);
+        result = _mm_andnot_si128(transparent, result);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), result);
+    }
+#elif defined(VT_VIDEO_NEON)
+    for (; i + 16 <= number_of_pixels; i += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(src + i * 4);
+        const uint8x16_t transparent = vceqq_u8(pixels.val[3], vdupq_n_u8(0));
+
+        uint8x16x4_t result;
+        result.val[0] = vbicq_u8(pixels.val[2], transparent);
+        result.val[1] = vbicq_u8(pixels.val[1], transparent);
+        result.val[2] = vbicq_u8(pixels.val[0], transparent);
+        result.val[3] = pixels.val[3];
+
+        vst4q_u8(dst + i * 4, result);
+    }
+#endif
+
+    for (; i < number_of_pixels; ++i) {
+        const uint8_t* src_pixel = src + i * 4;
+        uint8_t* dst_pixel = dst + i * 4;
+
+        if (src_pixel[3] == 0) {
+            dst_pixel[0] = 0;
+            dst_pixel[1] = 0;
+            dst_pixel[2] = 0;
+        } else {
+            dst_pixel[0] = src_pixel[2];
+            dst_pixel[1] = src_pixel[1];
+            dst_pixel[2] = src_pixel[0];
+        }
+        dst_pixel[3] = src_pixel[3];
+    }
+}
+
+/** \brief Computes the grayscale value of a pixel: 0.30R + 0.59G + 0.11B.
+*** The division by 100 is done as (sum * 41944) >> 22, which is exact
+*** for all the possible sums.
+**/
+static inline uint8_t GetGrayscaleValue(uint8_t red, uint8_t green, uint8_t blue)
+{
+    const uint32_t sum = (30 * red) + (59 * green) + (11 * blue);
+    return static_cast<uint8_t>((sum * 41944) >> 22);
+}
+
+//! \brief Converts RGBA pixels to grayscale in place, leaving the alpha values unmodified.
+static void ConvertRGBAToGrayscale(uint8_t* pixels, size_t number_of_pixels)
+{
+    size_t i = 0;
+
+#if defined(VT_VIDEO_SSE2)
+    const __m128i mask_byte = _mm_set1_epi32(0xFF);
+    const __m128i mask_alpha = _mm_set1_epi32(static_cast<int32_t>(0xFF000000));
+    const __m128i red_factor = _mm_set1_epi32(30);
+    const __m128i green_factor = _mm_set1_epi32(59);
+    const __m128i blue_factor = _mm_set1_epi32(11);
+    const __m128i divisor = _mm_set1_epi32(41944);
+
+    for (; i + 4 <= number_of_pixels; i += 4) {
+        __m128i* address = reinterpret_cast<__m128i*>(pixels + i * 4);
+        const __m128i rgba = _mm_loadu_si128(address);
+
+        // The sums fit in the low 16 bits of each pixel lane.
+        const __m128i red = _mm_and_si128(rgba, mask_byte);
+        const __m128i green = _mm_and_si128(_mm_srli_epi32(rgba, 8), mask_byte);
+        const __m128i blue = _mm_and_si128(_mm_srli_epi32(rgba, 16), mask_byte);
+        const __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(red, red_factor),
+                                                        _mm_mullo_epi16(green, green_factor)),
+                                          _mm_mullo_epi16(blue, blue_factor));
+        const __m128i value = _mm_srli_epi32(_mm_mulhi_epu16(sum, divisor), 6);
+
+        const __m128i result = _mm_or_si128(_mm_or_si128(value, _mm_slli_epi32(value, 8)),
+                                            _mm_or_si128(_mm_slli_epi32(value, 16), _mm_and_si128(rgba, mask_alpha)));
+        _mm_storeu_si128(address, result);
+    }
+#elif defined(VT_VIDEO_NEON)
+    const uint16x4_t divisor = vdup_n_u16(41944);
+
+    for (; i + 8 <= number_of_pixels; i += 8) {
+        uint8x8x4_t rgba = vld4_u8(pixels + i * 4);
+
+        uint16x8_t sum = vmull_u8(rgba.val[0], vdup_n_u8(30));
+        sum = vmlal_u8(sum, rgba.val[1], vdup_n_u8(59));
+        sum = vmlal_u8(sum, rgba.val[2], vdup_n_u8(11));
+
+        const uint16x8_t quotient = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(sum), divisor), 16),
+                                                 vshrn_n_u32(vmull_u16(vget_high_u16(sum), divisor), 16));
+        const uint8x8_t value = vmovn_u16(vshrq_n_u16(quotient, 6));
+
+        rgba.val[0] = value;
+        rgba.val[1] = value;
+        rgba.val[2] = value;
+        vst4_u8(pixels + i * 4, rgba);
+    }
+#endif
+
+    for (; i < number_of_pixels; ++i) {
+        uint8_t* pixel = pixels + i * 4;
+        const uint8_t value = GetGrayscaleValue(pixel[0], pixel[1], pixel[2]);
+        pixel[0] = value;
+        pixel[1] = value;
+        pixel[2] = value;
+    }
+}
+
+//! \brief Drops the alpha values of RGBA pixels in place, the pixels being packed at the start of the buffer.
+static void ConvertRGBAToRGB(uint8_t* pixels, size_t number_of_pixels)
+{
+    size_t i = 0;
+
+#if defined(VT_VIDEO_NEON)
+    // Each step writes before the next pixels to read, so it works in place.
+    for (; i + 16 <= number_of_pixels; i += 16) {
+        const uint8x16x4_t rgba = vld4q_u8(pixels + i * 4);
+
+        uint8x16x3_t rgb;
+        rgb.val[0] = rgba.val[0];
+        rgb.val[1] = rgba.val[1];
+        rgb.val[2] = rgba.val[2];
+        vst3q_u8(pixels + i * 3, rgb);
+    }
+#endif
+
+    const uint8_t* src_pixel = pixels + i * 4;
+    uint8_t* dst_pixel = pixels + i * 3;
+    for (; i < number_of_pixels; ++i, src_pixel += 4, dst_pixel += 3) {
+        dst_pixel[0] = src_pixel[0];
+        dst_pixel[1] = src_pixel[1];
+        dst_pixel[2] = src_pixel[2];
+    }
+}
+
 // -----------------------------------------------------------------------------
 // ImageMemory class
 // -----------------------------------------------------------------------------
@@ -73,7 +248,7 @@ bool ImageMemory::LoadImage(const std::string& filename)
         IF_PRINT_WARNING(VIDEO_DEBUG) << "_pixels member was not empty upon function invocation" << std::endl;
     }
 
-    SDL_Surface* temp_surf = IMG_Load(filename.c_str());
+    SDL_Surface* temp_surf = IMG_Load_RW(vt_system::OpenAsset(filename), 1);
     if (temp_surf == nullptr) {
         PRINT_ERROR << "Couldn't load image file: " << filename << std::endl;
         return false;
@@ -94,53 +269,50 @@ bool ImageMemory::LoadImage(const std::string& filename)
     Resize(alpha_surf->w, alpha_surf->h, 3 == alpha_surf->format->BytesPerPixel);
 
     // convert the data so that it works in our format
-    uint8_t* img_pixel = nullptr;
-    uint8_t* dst_pixel = nullptr;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    if (alpha_format) { // ARGB8888, one row at a time
+        for (uint32_t y = 0; y < _height; ++y) {
+            const uint8_t* img_row = static_cast<const uint8_t *>(alpha_surf->pixels) + y * alpha_surf->pitch;
+            ConvertBGRAToRGBA(img_row, &_pixels[y * _width * GetBytesPerPixel()], _width);
+        }
+    } else {
+#else
+    {
+#endif
+        uint8_t* img_pixel = nullptr;
+        uint8_t* dst_pixel = nullptr;
 
-    for (uint32_t y = 0; y < _height; ++y) {
-        for (uint32_t x = 0; x < _width; ++x) {
-            img_pixel = static_cast<uint8_t *>(alpha_surf->pixels) + y * alpha_surf->pitch + x * alpha_surf->format->BytesPerPixel;
-            dst_pixel = &_pixels[(y * _width + x) * GetBytesPerPixel()];
+        for (uint32_t y = 0; y < _height; ++y) {
+            for (uint32_t x = 0; x < _width; ++x) {
+                img_pixel = static_cast<uint8_t *>(alpha_surf->pixels) + y * alpha_surf->pitch + x * alpha_surf->format->BytesPerPixel;
+                dst_pixel = &_pixels[(y * _width + x) * GetBytesPerPixel()];
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            if (alpha_format) {
-                dst_pixel[0] = img_pixel[0];
-                dst_pixel[1] = img_pixel[1];
-                dst_pixel[2] = img_pixel[2];
-                dst_pixel[3] = img_pixel[3];
-            } else {
-                dst_pixel[2] = img_pixel[0];
-                dst_pixel[1] = img_pixel[1];
-                dst_pixel[0] = img_pixel[2];
-                dst_pixel[3] = img_pixel[3];
-            }
-#else
-            if (alpha_format) { // ARGB8888
-#ifdef __APPLE__
-                dst_pixel[3] = img_pixel[3];
-                dst_pixel[0] = img_pixel[2];
-                dst_pixel[1] = img_pixel[1];
-                dst_pixel[2] = img_pixel[0];
+                if (alpha_format) {
+                    dst_pixel[0] = img_pixel[0];
+                    dst_pixel[1] = img_pixel[1];
+                    dst_pixel[2] = img_pixel[2];
+                    dst_pixel[3] = img_pixel[3];
+                } else {
+                    dst_pixel[2] = img_pixel[0];
+                    dst_pixel[1] = img_pixel[1];
+                    dst_pixel[0] = img_pixel[2];
+                    dst_pixel[3] = img_pixel[3];
+                }
 #else
-                dst_pixel[2] = img_pixel[0];
-                dst_pixel[1] = img_pixel[1];
-                dst_pixel[0] = img_pixel[2];
-                dst_pixel[3] = img_pixel[3];
-#endif
-            } else {
                 dst_pixel[0] = img_pixel[0];
                 dst_pixel[1] = img_pixel[1];
                 dst_pixel[2] = img_pixel[2];
                 dst_pixel[3] = img_pixel[3];
-            }
 #endif
-            // GL_LINEAR white artifact removal
-            // Make the r,g,b values black to prevent OpenGL to make linear average with
-            // another color when smoothing.
-            // This is removing the white edges often seen on sprites.
-            if (dst_pixel[3] == 0) {
-                dst_pixel[0] = 0;
-                dst_pixel[1] = 0;
-                dst_pixel[2] = 0;
+                // GL_LINEAR white artifact removal
+                // Make the r,g,b values black to prevent OpenGL to make linear average with
+                // another color when smoothing.
+                // This is removing the white edges often seen on sprites.
+                if (dst_pixel[3] == 0) {
+                    dst_pixel[0] = 0;
+                    dst_pixel[1] = 0;
+                    dst_pixel[2] = 0;
+                }
             }
         }
     }
@@ -300,36 +472,19 @@ void ImageMemory::ConvertToGrayscale()
     // We are going to increment through the loop by 'bytes_per_pixel'.
     // So, the size of the array must be divisible by 'bytes_per_pixel'.
     assert(_pixels.size() % bytes_per_pixel == 0);
-    if (_pixels.size() % bytes_per_pixel == 0) {
-
-        auto current_pixel = _pixels.begin();
-        auto end_pixel = _pixels.end();
-
-        while (current_pixel != end_pixel) {
-
-            //
-            // Calculate the grayscale value for this pixel based on RGB values: 0.30R + 0.59G + 0.11B.
-            //
-
-            uint8_t red   = *(current_pixel + 0);
-            uint8_t green = *(current_pixel + 1);
-            uint8_t blue  = *(current_pixel + 2);
-
-            // Compute the sum.
-            uint32_t sum = (30 * red) + (59 * green) + (11 * blue);
-
-            // Scale the sum.
-            uint8_t value = static_cast<uint8_t>(sum * 0.01f);
+    if (_pixels.size() % bytes_per_pixel != 0)
+        return;
 
-            // Store the result.
-            *(current_pixel + 0) = value;
-            *(current_pixel + 1) = value;
-            *(current_pixel + 2) = value;
-            // *(current_pixel + 3) for RGBA is the alpha value and is left unmodified.
+    if (!_rgb_format) {
+        ConvertRGBAToGrayscale(&_pixels[0], _width * _height);
+        return;
+    }
 
-            // Increment to the next pixel.
-            current_pixel = current_pixel + bytes_per_pixel;
-        }
+    for (uint8_t* pixel = &_pixels[0]; pixel != &_pixels[0] + _pixels.size(); pixel += bytes_per_pixel) {
+        const uint8_t value = GetGrayscaleValue(pixel[0], pixel[1], pixel[2]);
+        pixel[0] = value;
+        pixel[1] = value;
+        pixel[2] = value;
     }
 }
 
@@ -347,24 +502,47 @@ void ImageMemory::RGBAToRGB()
         return;
     }
 
-    uint8_t* pixel_index = &_pixels[0];
-    uint8_t* pixel_source = pixel_index;
-
-    for(uint32_t i = 0; i < _height * _width; ++i, pixel_index += 4) {
-        int32_t index = 3 * i;
-        pixel_source[index] = *pixel_index;
-        pixel_source[index + 1] = *(pixel_index + 1);
-        pixel_source[index + 2] = *(pixel_index + 2);
-    }
+    ConvertRGBAToRGB(&_pixels[0], _height * _width);
 
     // Reduce the memory consumed by 1/4
     // since we no longer need to contain alpha data
-    _pixels.resize(_width * _height * GetBytesPerPixel());
-    std::vector<uint8_t> new_pixels(_pixels);
+    _pixels.resize(_width * _height * 3);
+    Pixels new_pixels(_pixels);
     std::swap(_pixels, new_pixels);
     _rgb_format = true;
 }
 
+bool ImageMemory::IsOpaque() const
+{
+    if(_pixels.empty())
+        return false;
+    if(_rgb_format)
+        return true;
+
+    for(size_t i = 3; i < _pixels.size(); i += 4) {
+        if(_pixels[i] != 255)
+            return false;
+    }
+    return true;
+}
+
+bool ImageMemory::IsOpaque(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const
+{
+    if(_pixels.empty() || x + width > _width || y + height > _height)
+        return false;
+    if(_rgb_format)
+        return true;
+
+    for(uint32_t row = y; row < y + height; ++row) {
+        const size_t line_end = (static_cast<size_t>(row) * _width + x + width) * 4;
+        for(size_t i = (static_cast<size_t>(row) * _width + x) * 4 + 3; i < line_end; i += 4) {
+            if(_pixels[i] != 255)
+                return false;
+        }
+    }
+    return true;
+}
+
 void ImageMemory::CopyFromTexture(TexSheet *texture)
 {
     assert(texture != nullptr);
@@ -376,7 +554,7 @@ void ImageMemory::CopyFromTexture(TexSheet *texture)
                     << std::endl;
     }
 
-    TextureManager->_BindTexture(texture->tex_id);
+    TextureManager->_BindTexSheet(texture);
     glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &_pixels[0]);
 }
 
@@ -396,7 +574,7 @@ void ImageMemory::CopyFromImage(BaseTexture *img)
     uint32_t dst_bytes = img->width * GetBytesPerPixel();
     uint32_t src_offset = (img->y * _width + img->x) * GetBytesPerPixel();
 
-    std::vector<uint8_t> img_pixels;
+    Pixels img_pixels;
     try {
         img_pixels.reserve(img->width * img->height * GetBytesPerPixel());
     }
@@ -407,9 +585,9 @@ void ImageMemory::CopyFromImage(BaseTexture *img)
     }
 
     for (uint32_t i = 0; i < img->height; ++i) {
-        std::vector<uint8_t>::const_iterator start =
+        Pixels::const_iterator start =
             _pixels.begin() + i * src_bytes + src_offset;
-        std::vector<uint8_t>::const_iterator end = start + dst_bytes;
+        Pixels::const_iterator end = start + dst_bytes;
         img_pixels.insert(img_pixels.end(), start, end);
     }
 
@@ -459,6 +637,15 @@ void ImageMemory::GlGetTexImage()
 
 void ImageMemory::GlTexSubImage(int32_t x, int32_t y)
 {
+    VideoManager->GetRenderStats().AddUploadedBytes(_pixels.size());
+
+    // Stage the pixels when possible, so that the call doesn't wait for the transfer.
+    if (TextureManager->_pixel_upload_buffer != nullptr) {
+        TextureManager->_pixel_upload_buffer->TexSubImage(x, y, _width, _height,
+                                                          _rgb_format ? GL_RGB : GL_RGBA, &_pixels[0]);
+        return;
+    }
+
     glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, _width, _height,
                     _rgb_format ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, &_pixels[0]);
 }
@@ -469,15 +656,20 @@ void ImageMemory::GlReadPixels(int32_t x, int32_t y)
                  _rgb_format ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, &_pixels[0]);
 }
 
+void ImageMemory::GlGetBufferSubData()
+{
+    glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, _pixels.size(), &_pixels[0]);
+}
+
 void ImageMemory::VerticalFlip()
 {
-    std::vector<uint8_t> flipped;
+    Pixels flipped;
     flipped.reserve(_pixels.size());
 
     for (uint32_t i = 1; i <= _height; ++i) {
-        std::vector<uint8_t>::const_iterator start =
+        Pixels::const_iterator start =
             _pixels.end() - (i * _width * GetBytesPerPixel());
-        std::vector<uint8_t>::const_iterator end =
+        Pixels::const_iterator end =
             start + _width * GetBytesPerPixel();
         flipped.insert(flipped.end(), start, end);
     }
@@ -499,6 +691,7 @@ BaseTexture::BaseTexture() :
     u2(0.0f),
     v2(0.0f),
     smooth(false),
+    opaque(false),
     ref_count(0)
 {}
 
@@ -513,6 +706,7 @@ BaseTexture::BaseTexture(uint32_t width_, uint32_t height_) :
     u2(0.0f),
     v2(0.0f),
     smooth(false),
+    opaque(false),
     ref_count(0)
 {}
 
@@ -529,6 +723,7 @@ BaseTexture::BaseTexture(TexSheet *texture_sheet_,
     u2(0.0f),
     v2(0.0f),
     smooth(false),
+    opaque(false),
     ref_count(0)
 {}
 
@@ -557,16 +752,19 @@ bool BaseTexture::RemoveReference()
 // -----------------------------------------------------------------------------
 
 ImageTexture::ImageTexture(const std::string &filename_,
-                           const std::string &tags_,
+                           uint32_t path_id_,
+                           uint32_t tag_,
                            int32_t width_, int32_t height_) :
     BaseTexture(width_, height_),
     filename(filename_),
-    tags(tags_)
+    path_id(path_id_),
+    tag(tag_),
+    multi_image(nullptr)
 {
     if(VIDEO_DEBUG) {
-        if(TextureManager->_IsImageTextureRegistered(filename + tags))
+        if(TextureManager->_IsImageTextureRegistered(path_id, tag))
             PRINT_WARNING << "constructor invoked when ImageTexture was already referenced for: "
-                          << filename << tags << std::endl;
+                          << filename << " (tag: " << tag << ")" << std::endl;
     }
 
     TextureManager->_RegisterImageTexture(this);
@@ -574,27 +772,68 @@ ImageTexture::ImageTexture(const std::string &filename_,
 
 ImageTexture::ImageTexture(TexSheet *texture_sheet_,
                            const std::string &filename_,
-                           const std::string &tags_,
+                           uint32_t path_id_,
+                           uint32_t tag_,
                            int32_t width_, int32_t height_) :
     BaseTexture(texture_sheet_, width_, height_),
     filename(filename_),
-    tags(tags_)
+    path_id(path_id_),
+    tag(tag_),
+    multi_image(nullptr)
 {
     if(VIDEO_DEBUG) {
-        if(TextureManager->_IsImageTextureRegistered(filename + tags))
+        if(TextureManager->_IsImageTextureRegistered(path_id, tag))
             PRINT_WARNING << "constructor invoked when ImageTexture was already referenced for: "
-                          << filename << tags << std::endl;
+                          << filename << " (tag: " << tag << ")" << std::endl;
     }
 
     TextureManager->_RegisterImageTexture(this);
 }
 
+ImageTexture::ImageTexture(ImageTexture *multi_image_,
+                           int32_t x_offset, int32_t y_offset,
+                           int32_t width_, int32_t height_) :
+    BaseTexture(multi_image_->texture_sheet, width_, height_),
+    filename(multi_image_->filename),
+    path_id(multi_image_->path_id),
+    tag(multi_image_->tag),
+    multi_image(multi_image_)
+{
+    x = multi_image->x + x_offset;
+    y = multi_image->y + y_offset;
+    smooth = multi_image->smooth;
+
+    // Same texel centers than the images placed in the sheets.
+    const float sheet_width = static_cast<float>(texture_sheet->width);
+    const float sheet_height = static_cast<float>(texture_sheet->height);
+    u1 = static_cast<float>(x + 0.5f) / sheet_width;
+    u2 = static_cast<float>(x + width - 0.5f) / sheet_width;
+    v1 = static_cast<float>(y + 0.5f) / sheet_height;
+    v2 = static_cast<float>(y + height - 0.5f) / sheet_height;
+}
+
 ImageTexture::~ImageTexture()
 {
+    // The elements only live in their multi image.
+    if(multi_image != nullptr)
+        return;
+
+    for(uint32_t i = 0; i < elements.size(); ++i)
+        delete elements[i];
+
     // Remove this instance from the texture manager
     TextureManager->_UnregisterImageTexture(this);
 }
 
+BaseTexture *ImageTexture::ReleaseRegion()
+{
+    if(multi_image == nullptr)
+        return this;
+
+    // The multi image is referenced once by each of its referenced elements.
+    return multi_image->RemoveReference() ? multi_image : nullptr;
+}
+
 } // namespace private_video
 
 } // namespace vt_video
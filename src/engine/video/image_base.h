@@ -43,6 +43,8 @@
 #include "color.h"
 #include "texture.h"
 
+#include "engine/memory_stats.h"
+
 #include <string>
 #include <vector>
 
@@ -52,6 +54,24 @@ namespace vt_video
 namespace private_video
 {
 
+//! \brief The path id of no image file, never registered.
+const uint32_t INVALID_IMAGE_PATH = 0;
+
+//! \brief The tag of the images loaded from a whole image file.
+const uint32_t IMAGE_TAG_NONE = 0;
+
+//! \brief The largest number of rows and columns of a multi image, as packed in its tag.
+const uint32_t MULTI_IMAGE_MAX_GRID_SIZE = 0xFFFF;
+
+/** \brief Returns the tag of a multi image file split in a grid of elements.
+*** The rows and columns are each packed in 16 bits. The number of rows isn't 0,
+*** so the tag differs from IMAGE_TAG_NONE.
+**/
+inline uint32_t GetMultiImageTag(uint32_t rows, uint32_t cols)
+{
+    return (rows << 16) | cols;
+}
+
 /** ****************************************************************************
 *** \brief A wrapper around an image buffer in system memory
 ***
@@ -72,9 +92,6 @@ public:
     ImageMemory();
     explicit ImageMemory(const SDL_Surface* surface);
 
-    ~ImageMemory()
-    {}
-
     size_t GetWidth() const {
         return _width;
     }
@@ -91,6 +108,15 @@ public:
         return _rgb_format ? 3 : 4;
     }
 
+    //! \brief Returns the pixels, row by row, to fill or read them directly.
+    uint8_t* GetPixels() {
+        return _pixels.data();
+    }
+
+    const uint8_t* GetPixels() const {
+        return _pixels.data();
+    }
+
     /** \brief Loads raw image data from a file and stores the data in the class members
     *** \param filename The name of the image file to load.
     *** \return True if the image was loaded successfully, false if it was not
@@ -119,6 +145,12 @@ public:
     **/
     void RGBAToRGB();
 
+    //! \brief Tells whether all the pixels are fully opaque.
+    bool IsOpaque() const;
+
+    //! \brief Tells whether all the pixels of a rectangle of the image are fully opaque.
+    bool IsOpaque(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const;
+
     /** \brief Set the class members by making a copy of a texture sheet
     *** \param texture A pointer to the TexSheet to be copied
     ***
@@ -150,6 +182,9 @@ public:
     //! \brief Wrapper of glReadPixels on the image pixels at the given coordinates.
     void GlReadPixels(int32_t x, int32_t y);
 
+    //! \brief Wrapper of glGetBufferSubData on the image pixels, from the bound pixel pack buffer.
+    void GlGetBufferSubData();
+
     //! \brief Copy a texture at given pixel coordinates.
     void CopyFrom(const ImageMemory& src, uint32_t src_offset, uint32_t dst_bytes, uint32_t dst_offset);
     void CopyFrom(const ImageMemory& src, uint32_t src_offset);
@@ -158,6 +193,9 @@ public:
     void VerticalFlip();
 
 private:
+    //! \brief The pixels buffer type, accounted as system memory textures.
+    typedef std::vector<uint8_t, vt_system::MemoryTagAllocator<uint8_t, vt_system::MEMORY_TEXTURES_CPU> > Pixels;
+
     //! \brief The width of the image data (in pixels)
     size_t _width;
 
@@ -165,7 +203,7 @@ private:
     size_t _height;
 
     //! \brief Buffer of data, usually of size width * height * 4 (RGBA, 8 bits per component)
-    std::vector<uint8_t> _pixels;
+    Pixels _pixels;
 
     //! \brief Set to true if the data is in RGB format, false if the data is in RGBA format.
     bool _rgb_format;
@@ -225,6 +263,9 @@ public:
     //! \brief True if the image should be drawn smoothed (using GL_LINEAR)
     bool smooth;
 
+    //! \brief True if all the image pixels were found opaque when it was inserted in its texture sheet.
+    bool opaque;
+
     /** \brief The number of times that this image is refereced by ImageDescriptors
     *** This is used to determine when the image may be safely deleted.
     **/
@@ -242,6 +283,14 @@ public:
         ref_count++;
     }
 
+    /** \brief Returns the texture to remove from its sheet and delete, once this one isn't referenced anymore.
+    *** \return This texture, or the one whose sheet region holds it when they're released together,
+    *** or nullptr when that one is still referenced.
+    **/
+    virtual BaseTexture *ReleaseRegion() {
+        return this;
+    }
+
 private:
     BaseTexture(const BaseTexture &copy);
     BaseTexture &operator=(const BaseTexture &copy);
@@ -252,12 +301,12 @@ private:
 *** \brief Represents a single image that is loaded and stored in a texture sheet.
 ***
 *** This object is intended to reperesent a texture image that was created by
-*** loading an image file. The TextureManager singleton keeps a std::map of all
-*** ImageTexture objects created, using the concatenated filename and tags of
+*** loading an image file. The TextureManager singleton keeps a hash map of all
+*** ImageTexture objects created, using the interned path id and the tag of
 *** each object as the map key. When creating a new ImageTexture object, you
 *** should generally do the following:
 ***
-*** -# First make sure that the filename + tags is not already located in the
+*** -# First make sure that the path id + tag is not already located in the
 ***    image map in the TextureController class
 *** -# Invoke the class constructor if the map search found no matching entry
 *** -# Call the TextureManager to insert the new image into a texture sheet
@@ -272,8 +321,14 @@ private:
 class ImageTexture : public BaseTexture
 {
 public:
-    ImageTexture(const std::string &filename_, const std::string &tags_, int32_t width_, int32_t height_);
-    ImageTexture(TexSheet *texture_sheet_, const std::string &filename_, const std::string &tags_, int32_t width_, int32_t height_);
+    ImageTexture(const std::string &filename_, uint32_t path_id_, uint32_t tag_, int32_t width_, int32_t height_);
+    ImageTexture(TexSheet *texture_sheet_, const std::string &filename_, uint32_t path_id_, uint32_t tag_,
+                 int32_t width_, int32_t height_);
+
+    /** \brief Creates an element of a multi image texture, at the given pixel offsets in it.
+    *** \note The element isn't registered in the TextureManager, nor placed in the texture sheet.
+    **/
+    ImageTexture(ImageTexture *multi_image_, int32_t x_offset, int32_t y_offset, int32_t width_, int32_t height_);
 
     virtual ~ImageTexture() override;
 
@@ -287,21 +342,26 @@ public:
     **/
     std::string filename;
 
-    /** \brief Retains various tags used to uniquely identify the image when certain properties are applied
-    ***
-    *** Tags should always be presented in the same order, since the tag information is used in the key
-    *** to lookup the image in the TextureManager's image map. The list of tags below is sorted from highest
-    *** priority (should be at the beginning of the tag) to lowest priority (should be at the end of the tag).
-    ***
-    *** -# \<Xrow_ROWS>: used for multi image elements. "row" is the row number of this particular element
-    ***    while "ROWS" is the total number of rows of elements in the multi image
-    *** -# \<Ycol_COLS>: used for multi image elements. "col" is the column number of this particular element
-    ***    while "COLS" is the total number of columns of elements in the multi image
-    *** -# \<G>: used to indicate that this image texture has been converted to grayscale mode
-    ***
-    *** \note Please remember to document new tags here when they are added
+    /** \brief The id of the filename interned by the TextureManager, or a unique id
+    *** for the images created procedurally. Part of the key in the TextureManager's image map.
+    **/
+    uint32_t path_id;
+
+    /** \brief Tells how the image file was loaded, as the same file may be loaded both ways.
+    *** Either IMAGE_TAG_NONE for a single image, or a multi image tag given by GetMultiImageTag().
     **/
-    std::string tags;
+    uint32_t tag;
+
+    /** \brief The multi image texture holding this element, or nullptr.
+    *** The whole multi image is uploaded as one region of the texture sheet, and its elements
+    *** are rectangles of that region: They are deleted with it, once none of them is referenced.
+    **/
+    ImageTexture *multi_image;
+
+    //! \brief The elements of a multi image texture, in row major order.
+    std::vector<ImageTexture *> elements;
+
+    BaseTexture *ReleaseRegion() override;
 
 private:
     ImageTexture(const ImageTexture &copy);
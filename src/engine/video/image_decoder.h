@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    image_decoder.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for decoding image files in background threads.
+***
+*** Decoding image files is done entirely on the CPU, so it can happen in
+*** worker threads while the main thread keeps on loading. Only the upload
+*** of the decoded pixels to a texture sheet needs the OpenGL context, and
+*** thus the main thread.
+*** ***************************************************************************/
+
+#ifndef __IMAGE_DECODER_HEADER__
+#define __IMAGE_DECODER_HEADER__
+
+#include "image_base.h"
+
+#include <deque>
+#include <map>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+/** ****************************************************************************
+*** \brief A pool of threads decoding image files into ImageMemory buffers.
+***
+*** Images are requested early, decoded in the background, and then taken
+*** by the main thread when it actually needs them, waiting only if their
+*** decoding isn't finished yet.
+*** ***************************************************************************/
+class ImageDecoder
+{
+public:
+    ImageDecoder();
+    ~ImageDecoder();
+
+    /** \brief Starts decoding an image file in the background.
+    *** \param filename The image file to decode.
+    *** \note Nothing is done if the image was already requested.
+    **/
+    void Request(const std::string& filename);
+
+    //! \brief Tells whether an image was requested and not taken yet.
+    bool IsRequested(const std::string& filename) const;
+
+    //! \brief Tells whether a requested image is decoded and can be taken without waiting.
+    bool IsReady(const std::string& filename) const;
+
+    /** \brief Takes a requested image, waiting for its decoding to finish if needed.
+    *** \param filename The image file requested.
+    *** \param image The image memory where to place the decoded pixels.
+    *** \return False if the image wasn't requested or couldn't be decoded.
+    **/
+    bool Take(const std::string& filename, ImageMemory& image);
+
+    //! \brief Forgets a requested image that finally isn't needed.
+    void Cancel(const std::string& filename);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ImageDecoder(const ImageDecoder& image_decoder);
+    ImageDecoder& operator=(const ImageDecoder& image_decoder);
+
+    //! \brief An image to decode, shared between the main thread and a worker.
+    class _Job
+    {
+    public:
+        _Job(const std::string& filename_) :
+            filename(filename_),
+            done(false),
+            success(false),
+            cancelled(false)
+        {}
+
+        std::string filename;
+        ImageMemory image;
+
+        //! \brief Set by the worker once the image is decoded, successfully or not.
+        bool done;
+        bool success;
+
+        //! \brief Set when the image isn't needed anymore while being decoded.
+        //! The worker then deletes the job itself.
+        bool cancelled;
+    };
+
+    //! \brief The requested images not taken yet, by filename.
+    std::map<std::string, _Job*> _jobs;
+
+    //! \brief The requested images not being decoded yet, in request order.
+    std::deque<_Job*> _queue;
+
+    //! \brief The worker threads.
+    std::vector<SDL_Thread*> _threads;
+
+    //! \brief Protects all the members above and the jobs.
+    SDL_mutex* _mutex;
+
+    //! \brief Signaled when a job is queued, or when the workers must stop.
+    SDL_cond* _job_queued;
+
+    //! \brief Signaled when a job is done.
+    SDL_cond* _job_done;
+
+    //! \brief Tells the workers to stop.
+    bool _quit;
+
+    //! \brief The entry point of the worker threads.
+    static int _WorkerThread(void* image_decoder);
+
+    //! \brief Decodes the queued images until told to stop.
+    void _Work();
+};
+
+} // namespace private_video
+
+} // namespace vt_video
+
+#endif // __IMAGE_DECODER_HEADER__
@@ -14,11 +14,11 @@
 *** \author  Yohann Ferreira, yohann ferreira orange fr
 *** \brief   Header file for particle data
 ***
-*** This file contains structure(s) for representing a single particle. In theory,
-*** we should be able to just have one structure which holds all properties for
-*** a particle, but in fact we have two: one for the position, and one for everything
-*** else. The reason is that having the positions separated is more efficient
-*** for rendering.
+*** This file contains the structures representing the particles of a system.
+*** The particle properties are stored one array per property rather than one
+*** structure per particle, so that the particle system can update a property
+*** of every particle in a tight loop, and the vertices used for rendering are
+*** kept in their own arrays.
 *** **************************************************************************/
 
 #ifndef __PARTICLE_HEADER__
@@ -26,6 +26,12 @@
 
 #include "particle_keyframe.h"
 
+#include "engine/memory_stats.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 namespace vt_mode_manager
 {
 
@@ -72,116 +78,214 @@ public:
 };
 
 /*!***************************************************************************
- *  \brief this is the structure we use to represent a particle
+ *  \brief The random variations of a particle keyframed properties. They are
+ *         drawn once when the particle spawns, between -1.0 and 1.0, and scale
+ *         the keyframed variations all along the particle life.
  *****************************************************************************/
 
-class Particle
+class ParticleVariation
 {
 public:
-    Particle():
-        pos(0.0f, 0.0f),
-        size(0.0f, 0.0f),
-        velocity(0.0f, 0.0f),
-        combined_velocity(0.0f, 0.0f),
-        rotation_angle(0.0f),
-        rotation_speed(0.0f),
-        time(0.0f),
-        lifetime(0.0f),
-        wave_length_coefficient(0.0f),
-        wave_half_amplitude(0.0f),
-        acceleration(0.0f, 0.0f),
-        tangential_acceleration(0.0f),
-        radial_acceleration(0.0f),
-        wind_velocity(0.0f, 0.0f),
-        damping(0.0f),
-        rotation_direction(0.0f),
-        current_size_variation(0.0f, 0.0f),
-        next_size_variation(0.0f, 0.0f),
-        current_rotation_speed_variation(0.0f),
-        next_rotation_speed_variation(0.0f),
-        current_keyframe(nullptr),
-        next_keyframe(nullptr)
+    ParticleVariation():
+        size_variation(0.0f, 0.0f),
+        rotation_speed_variation(0.0f)
     {}
 
-    //! position
-    vt_common::Position2D pos;
+    vt_common::Position2D size_variation;
+    float rotation_speed_variation;
+    vt_video::Color color_variation;
+};
 
-    //! size
-    vt_common::Position2D size;
+//! \brief The number of particle properties stored as floats.
+const uint32_t PARTICLE_FLOAT_PROPERTIES = 22;
 
-    //! velocity
-    vt_common::Position2D velocity;
+/*!***************************************************************************
+ *  \brief The storage of the particles of a system, handed out and recycled
+ *         by the particle pool so that spawning a system doesn't allocate it.
+ *
+ *  The floats hold PARTICLE_FLOAT_PROPERTIES arrays of capacity elements,
+ *  one after the other.
+ *****************************************************************************/
 
-    //! store the combined velocity (particle + wind + wave) so we only have
-    //! to calculate it once
-    vt_common::Position2D combined_velocity;
+class ParticleBlock
+{
+public:
+    explicit ParticleBlock(uint32_t block_capacity) :
+        capacity(block_capacity),
+        floats(block_capacity * PARTICLE_FLOAT_PROPERTIES, 0.0f),
+        color(block_capacity),
+        variation(block_capacity)
+    {}
 
-    //! color
-    vt_video::Color color;
+    //! \brief Resets every particle, before the block is used again.
+    void Clear() {
+        std::fill(floats.begin(), floats.end(), 0.0f);
+        std::fill(color.begin(), color.end(), vt_video::Color());
+        std::fill(variation.begin(), variation.end(), ParticleVariation());
+    }
 
-    //! current rotation angle
-    float rotation_angle;
+    //! The number of particles the block can hold.
+    uint32_t capacity;
 
-    //! rotation speed
-    float rotation_speed;
+    std::vector<float, vt_system::MemoryTagAllocator<float, vt_system::MEMORY_PARTICLES> > floats;
+    std::vector<vt_video::Color, vt_system::MemoryTagAllocator<vt_video::Color, vt_system::MEMORY_PARTICLES> > color;
+    std::vector<ParticleVariation, vt_system::MemoryTagAllocator<ParticleVariation, vt_system::MEMORY_PARTICLES> > variation;
+};
 
-    //! seconds since particle was spawned
-    float time;
+/*!***************************************************************************
+ *  \brief The particles of a system, stored as one array per property.
+ *
+ *  The particle system updates each property of every particle in its own
+ *  loop, so keeping the properties apart lets those loops go through
+ *  contiguous floats the compiler can vectorize. The element i of each array
+ *  belongs to the particle i. The arrays point into a particle block.
+ *****************************************************************************/
 
-    //! lifetime (when the particle is supposed to die)
-    float lifetime;
+class ParticleStreams
+{
+public:
+    ParticleStreams() {
+        Attach(nullptr);
+    }
 
-    //! this is 2 * pi / wavelength. The reason we store this weird
-    //! number instead of the wavelength is because that's what we
-    //! will ultimately plug into the sin function
-    float wave_length_coefficient;
+    //! \brief Points the arrays into the given block, or at nothing when it is nullptr.
+    void Attach(ParticleBlock *block) {
+        pos_x = _Property(block, 0);
+        pos_y = _Property(block, 1);
+        velocity_x = _Property(block, 2);
+        velocity_y = _Property(block, 3);
+        combined_velocity_x = _Property(block, 4);
+        combined_velocity_y = _Property(block, 5);
+        wind_velocity_x = _Property(block, 6);
+        wind_velocity_y = _Property(block, 7);
+        acceleration_x = _Property(block, 8);
+        acceleration_y = _Property(block, 9);
+        tangential_acceleration = _Property(block, 10);
+        radial_acceleration = _Property(block, 11);
+        damping = _Property(block, 12);
+        wave_length_coefficient = _Property(block, 13);
+        wave_half_amplitude = _Property(block, 14);
+        time = _Property(block, 15);
+        lifetime = _Property(block, 16);
+        rotation_angle = _Property(block, 17);
+        rotation_speed = _Property(block, 18);
+        rotation_direction = _Property(block, 19);
+        size_x = _Property(block, 20);
+        size_y = _Property(block, 21);
+        color = block ? &block->color[0] : nullptr;
+        variation = block ? &block->variation[0] : nullptr;
+    }
 
-    //! half the amplitude of the wave. We store half the amplitude
-    //! instead of the whole amplitude because that's what gets multiplied
-    //! with the sin function
-    float wave_half_amplitude;
+    //! \brief Copies the particle src over the particle dest.
+    void Move(size_t src, size_t dest) {
+        pos_x[dest] = pos_x[src];
+        pos_y[dest] = pos_y[src];
+        velocity_x[dest] = velocity_x[src];
+        velocity_y[dest] = velocity_y[src];
+        combined_velocity_x[dest] = combined_velocity_x[src];
+        combined_velocity_y[dest] = combined_velocity_y[src];
+        wind_velocity_x[dest] = wind_velocity_x[src];
+        wind_velocity_y[dest] = wind_velocity_y[src];
+        acceleration_x[dest] = acceleration_x[src];
+        acceleration_y[dest] = acceleration_y[src];
+        tangential_acceleration[dest] = tangential_acceleration[src];
+        radial_acceleration[dest] = radial_acceleration[src];
+        damping[dest] = damping[src];
+        wave_length_coefficient[dest] = wave_length_coefficient[src];
+        wave_half_amplitude[dest] = wave_half_amplitude[src];
+        time[dest] = time[src];
+        lifetime[dest] = lifetime[src];
+        rotation_angle[dest] = rotation_angle[src];
+        rotation_speed[dest] = rotation_speed[src];
+        rotation_direction[dest] = rotation_direction[src];
+        size_x[dest] = size_x[src];
+        size_y[dest] = size_y[src];
+        color[dest] = color[src];
+        variation[dest] = variation[src];
+    }
+
+    //! position
+    float *pos_x;
+    float *pos_y;
+
+    //! velocity
+    float *velocity_x;
+    float *velocity_y;
+
+    //! store the combined velocity (particle + wind + wave) so we only have
+    //! to calculate it once
+    float *combined_velocity_x;
+    float *combined_velocity_y;
+
+    //! wind velocity. this gets added to the particle's velocity each frame.
+    //! note that different particles might also have a slightly different wind
+    //! velocity, if the system has some wind velocity variation
+    float *wind_velocity_x;
+    float *wind_velocity_y;
 
     //! acceleration, i.e. change in velocity per second. The most common use
     //! for this is for simulating gravity. If you have multiple constant
     //! forces acting on particles, then this vector should be the sum of
     //! those forces.
-    vt_common::Position2D acceleration;
+    float *acceleration_x;
+    float *acceleration_y;
 
     //! tangential acceleration- just like normal acceleration, except it
     //! is applied in the tangent direction. positive = clockwise.
-    float tangential_acceleration;
+    float *tangential_acceleration;
 
     //! radial acceleration- acceleration towards (negative) or away (positive)
     //! from an attractor. Note that the default attractor is the emitter position.
     //! The client can set an attractor for the entire effect by calling
     //! ParticleEffect::SetAttractor(x,y)
-    float radial_acceleration;
-
-    //! wind velocity. this gets added to the particle's velocity each frame.
-    //! note that different particles might also have a slightly different wind
-    //! velocity, if the system has some wind velocity variation
-    vt_common::Position2D wind_velocity;
+    float *radial_acceleration;
 
     //! damping- the particle's velocity gets multiplied by this value each second.
     //! So for example, a damping of .6 means that a particle slows down by 40% each
     //! second.
-    float damping;
+    float *damping;
+
+    //! this is 2 * pi / wavelength. The reason we store this weird
+    //! number instead of the wavelength is because that's what we
+    //! will ultimately plug into the sin function
+    float *wave_length_coefficient;
+
+    //! half the amplitude of the wave. We store half the amplitude
+    //! instead of the whole amplitude because that's what gets multiplied
+    //! with the sin function
+    float *wave_half_amplitude;
+
+    //! seconds since particle was spawned
+    float *time;
+
+    //! lifetime (when the particle is supposed to die)
+    float *lifetime;
+
+    //! current rotation angle
+    float *rotation_angle;
+
+    //! rotation speed
+    float *rotation_speed;
 
     //! when a particle is created, it is given a rotation direction: either
     //! 1 (clockwise) or -1 (counterclockwise)
-    float rotation_direction;
-
-    //! property variations
-    vt_common::Position2D current_size_variation;
-    vt_common::Position2D next_size_variation;
-    float current_rotation_speed_variation;
-    float next_rotation_speed_variation;
-    vt_video::Color current_color_variation;
-    vt_video::Color next_color_variation;
-
-    //! keep track of current and next keyframes
-    ParticleKeyframe *current_keyframe;
-    ParticleKeyframe *next_keyframe;
+    float *rotation_direction;
+
+    //! size
+    float *size_x;
+    float *size_y;
+
+    //! color
+    vt_video::Color *color;
+
+    //! random variations of the keyframed properties
+    ParticleVariation *variation;
+
+private:
+    //! \brief Returns the array of the given float property in the block.
+    static float *_Property(ParticleBlock *block, uint32_t property) {
+        return block ? &block->floats[property * block->capacity] : nullptr;
+    }
 };
 
 } // vt_mode_manager
@@ -17,24 +17,30 @@
 
 #include "engine/video/particle_effect.h"
 
+#include "engine/video/particle_manager.h"
 #include "engine/video/particle_system.h"
 #include "engine/video/video.h"
 
 #include "script/script_read.h"
+#include "engine/asset_archive.h"
 #include "engine/system.h"
 
 #include "utils/utils_files.h"
 
+#include <algorithm>
+
 using namespace vt_script;
 using namespace vt_video;
 
 namespace vt_mode_manager
 {
 
-bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
+//! \brief The time between two updates of an effect that isn't drawn, in seconds.
+const float PARTICLE_OFFSCREEN_UPDATE_INTERVAL = 0.25f;
+
+bool ParticleEffect::_LoadEffectDef(const std::string &particle_file, ParticleEffectDef &effect_def)
 {
-    _effect_def.Clear();
-    _loaded = false;
+    effect_def.Clear();
 
     // Make sure the corresponding tables are empty
     ScriptManager->DropGlobalTable("systems");
@@ -50,10 +56,10 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
 
     // Read the particle image rectangle when existing
     if (particle_script.OpenTable("map_effect_collision")) {
-        _effect_def.effect_collision_width = particle_script.ReadFloat("effect_collision_width");
-        _effect_def.effect_collision_height = particle_script.ReadFloat("effect_collision_height");
-        _effect_def.effect_width = particle_script.ReadFloat("effect_width");
-        _effect_def.effect_height = particle_script.ReadFloat("effect_height");
+        effect_def.effect_collision_width = particle_script.ReadFloat("effect_collision_width");
+        effect_def.effect_collision_height = particle_script.ReadFloat("effect_collision_height");
+        effect_def.effect_width = particle_script.ReadFloat("effect_width");
+        effect_def.effect_height = particle_script.ReadFloat("effect_height");
         particle_script.CloseTable(); // map_effect_collision
     }
 
@@ -61,8 +67,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
         PRINT_WARNING << "Could not find the 'systems' array in particle effect "
                       << particle_file << std::endl;
         particle_script.CloseFile();
-        _effect_def.Clear();
-        _loaded = false;
+        effect_def.Clear();
         return false;
     }
 
@@ -73,8 +78,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
                       << particle_file << std::endl;
         particle_script.CloseTable();
         particle_script.CloseFile();
-        _effect_def.Clear();
-        _loaded = false;
+        effect_def.Clear();
         return false;
     }
 
@@ -85,8 +89,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
                           << " in particle effect " << particle_file << std::endl;
             particle_script.CloseAllTables();
             particle_script.CloseFile();
-            _effect_def.Clear();
-            _loaded = false;
+            effect_def.Clear();
             return false;
         }
         particle_script.OpenTable(sys);
@@ -97,8 +100,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
                           << sys << " in particle effect " << particle_file << std::endl;
             particle_script.CloseAllTables();
             particle_script.CloseFile();
-            _effect_def.Clear();
-            _loaded = false;
+            effect_def.Clear();
             return false;
         }
         particle_script.OpenTable("emitter");
@@ -164,8 +166,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
                           << sys << " in particle effect " << particle_file << std::endl;
             particle_script.CloseAllTables();
             particle_script.CloseFile();
-            _effect_def.Clear();
-            _loaded = false;
+            effect_def.Clear();
             return false;
         }
         particle_script.OpenTable("keyframes");
@@ -195,6 +196,8 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
         // pop the keyframes table
         particle_script.CloseTable();
 
+        sys_def.BakeKeyframeTable();
+
         // open up the animation_frames table
         particle_script.ReadStringVector("animation_frames", sys_def.animation_frame_filenames);
 
@@ -203,8 +206,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
                           << particle_file << std::endl;
             particle_script.CloseAllTables();
             particle_script.CloseFile();
-            _effect_def.Clear();
-            _loaded = false;
+            effect_def.Clear();
             return false;
         }
 
@@ -214,15 +216,14 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
         std::vector<std::string>::const_iterator it, it_end;
         for(it = sys_def.animation_frame_filenames.begin(),
                 it_end = sys_def.animation_frame_filenames.end(); it != it_end; ++it) {
-            if(!vt_utils::DoesFileExist(*it)) {
+            if(!vt_system::DoesAssetExist(*it)) {
                 PRINT_WARNING << "Could not find file: "
                               << *it << " in system #" << sys << " in particle effect "
                               << particle_file << std::endl;
                 particle_script.CloseAllTables();
                 particle_script.CloseFile();
-                _effect_def.Clear();
-                _loaded = false;
-                return false;
+                effect_def.Clear();
+                    return false;
             }
         }
 
@@ -231,8 +232,7 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
                           << particle_file << std::endl;
             particle_script.CloseAllTables();
             particle_script.CloseFile();
-            _effect_def.Clear();
-            _loaded = false;
+            effect_def.Clear();
             return false;
         }
 
@@ -328,13 +328,18 @@ bool ParticleEffect::_LoadEffectDef(const std::string &particle_file)
         sys_def.use_stencil = particle_script.ReadBool("use_stencil");
         sys_def.random_initial_angle = particle_script.ReadBool("random_initial_angle");
 
+        // Optional: lets the GPU simulate the particles, when it can.
+        sys_def.gpu_simulated = particle_script.DoesBoolExist("gpu_simulated") &&
+                                particle_script.ReadBool("gpu_simulated");
+
         // pop the system table
         particle_script.CloseTable();
 
-        _effect_def._systems.push_back(sys_def);
+        sys_def.ComputeBounds();
+
+        effect_def._systems.push_back(sys_def);
     }
 
-    _loaded = true;
     return true;
 }
 
@@ -362,8 +367,8 @@ bool ParticleEffect::_CreateEffect()
 
     // Initialize systems
     _systems.clear();
-    std::vector<ParticleSystemDef>::iterator it = _effect_def._systems.begin();
-    for(; it != _effect_def._systems.end(); ++it) {
+    std::vector<ParticleSystemDef>::const_iterator it = _effect_def->_systems.begin();
+    for(; it != _effect_def->_systems.end(); ++it) {
         if((*it).enabled) {
             ParticleSystem sys(&(*it));
             if(!sys.IsAlive()) {
@@ -379,14 +384,31 @@ bool ParticleEffect::_CreateEffect()
         }
     }
 
+    // The area covered by every system, to know when the effect is off-screen.
+    for(uint32_t i = 0; i < _systems.size(); ++i) {
+        vt_common::Rectangle2D bounds = _systems[i].GetBounds();
+        if(i == 0) {
+            _bounds = bounds;
+        } else {
+            _bounds.left = std::min(_bounds.left, bounds.left);
+            _bounds.right = std::max(_bounds.right, bounds.right);
+            _bounds.top = std::min(_bounds.top, bounds.top);
+            _bounds.bottom = std::max(_bounds.bottom, bounds.bottom);
+        }
+    }
+
     _alive = true;
     _age = 0.0f;
+    _drawn = true;
+    _pending_time = 0.0f;
     return true;
 }
 
 bool ParticleEffect::LoadEffect(const std::string &filename)
 {
-    if(!_LoadEffectDef(filename)) {
+    _effect_def = ParticleManager::GetEffectDef(filename);
+    _loaded = (_effect_def != nullptr);
+    if(!_loaded) {
         PRINT_WARNING << "Failed to load particle definition file: "
                       << filename << std::endl;
         return false;
@@ -401,8 +423,26 @@ bool ParticleEffect::LoadEffect(const std::string &filename)
     return true;
 }
 
+bool ParticleEffect::IsOnScreen() const
+{
+    const CoordSys &coord_sys = VideoManager->GetCoordSys();
+    vt_common::Rectangle2D screen(std::min(coord_sys.GetLeft(), coord_sys.GetRight()),
+                                  std::max(coord_sys.GetLeft(), coord_sys.GetRight()),
+                                  std::min(coord_sys.GetTop(), coord_sys.GetBottom()),
+                                  std::max(coord_sys.GetTop(), coord_sys.GetBottom()));
+
+    vt_common::Rectangle2D bounds(_pos.x + _bounds.left, _pos.x + _bounds.right,
+                                  _pos.y + _bounds.top, _pos.y + _bounds.bottom);
+    return bounds.IntersectsWith(screen);
+}
+
 void ParticleEffect::Draw()
 {
+    // Don't draw what can't be seen. The effect is then updated less often.
+    if(!IsOnScreen())
+        return;
+    _drawn = true;
+
     // Move to the effect's location.
     VideoManager->Move(_pos.x, _pos.y);
 
@@ -422,14 +462,30 @@ void ParticleEffect::Update()
 
 void ParticleEffect::Update(float frame_time)
 {
-    _age += frame_time;
-    _num_particles = 0;
+    if(!_alive) {
+        _age += frame_time;
+        _num_particles = 0;
+        return;
+    }
 
-    if(!_alive)
+    // An effect that wasn't drawn since the last update is only updated a few times
+    // per second, and fully catches up when drawn again.
+    _pending_time += frame_time;
+    bool drawn = _drawn;
+    _drawn = false;
+    if(!drawn && _pending_time < PARTICLE_OFFSCREEN_UPDATE_INTERVAL) {
+        ParticleManager::CountParticles(_num_particles);
         return;
+    }
+    frame_time = _pending_time;
+    _pending_time = 0.0f;
+
+    _age += frame_time;
+    _num_particles = 0;
 
     vt_mode_manager::EffectParameters effect_parameters;
     effect_parameters.orientation = _orientation;
+    effect_parameters.emission_density = ParticleManager::GetEmissionDensity();
 
     // note we subtract the effect position to put the attractor point in effect
     // space instead of screen space
@@ -451,9 +507,20 @@ void ParticleEffect::Update(float frame_time)
             ++iSystem;
         }
     }
+
+    ParticleManager::CountParticles(_num_particles);
 }
 
 
+bool ParticleEffect::IsGpuSimulated() const
+{
+    for(uint32_t i = 0; i < _systems.size(); ++i) {
+        if(_systems[i].IsGpuSimulated())
+            return true;
+    }
+    return false;
+}
+
 void ParticleEffect::_Destroy()
 {
     _alive = false;
@@ -463,8 +530,13 @@ void ParticleEffect::_Destroy()
     _attractor.y = 0.0f;
     _age = 0.0f;
     _orientation = 0.0f;
+    _num_particles = 0;
+    _bounds = vt_common::Rectangle2D();
+    _drawn = true;
+    _pending_time = 0.0f;
 
     _systems.clear();
+    _effect_def.reset();
 
     _loaded = false;
 }
@@ -513,6 +585,15 @@ bool ParticleEffect::Start()
     return _CreateEffect();
 }
 
+bool ParticleEffect::UsesStencil() const
+{
+    for(uint32_t i = 0; i < _systems.size(); ++i) {
+        if(_systems[i].UsesStencil())
+            return true;
+    }
+    return false;
+}
+
 const vt_common::Position2D& ParticleEffect::GetPosition() const
 {
     return _pos;
@@ -38,6 +38,8 @@
 
 #include "engine/video/particle_system.h"
 
+#include <memory>
+
 namespace vt_script {
 class ReadScriptDescriptor;
 }
@@ -202,9 +204,24 @@ public:
         return _num_particles;
     }
 
+    /*!
+     *  \brief returns true if one of the systems is simulated on the GPU. The
+     *  effect must then be updated by the thread owning the OpenGL context.
+     */
+    bool IsGpuSimulated() const;
+
+    //! \brief returns true if one of the systems tests or modifies the stencil buffer.
+    bool UsesStencil() const;
+
     //! \brief return the position of the effect into x and y
     const vt_common::Position2D& GetPosition() const;
 
+    /*!
+     *  \brief returns true if the area the particles can cover intersects with
+     *         the screen, in the current coordinate system
+     */
+    bool IsOnScreen() const;
+
     /*!
      *  \brief return the age of the system, i.e. how many seconds it has been since
      *         it was created
@@ -216,18 +233,18 @@ public:
 
     //! \brief Get the overall effect collision width/height in pixels.
     float GetEffectCollisionWidth() const {
-        return _effect_def.effect_collision_width;
+        return _effect_def ? _effect_def->effect_collision_width : 0.0f;
     }
     float GetEffectCollisionHeight() const {
-        return _effect_def.effect_collision_height;
+        return _effect_def ? _effect_def->effect_collision_height : 0.0f;
     }
 
     //! \brief Get the overall effect image width/height in pixels.
     float GetEffectWidth() const {
-        return _effect_def.effect_width;
+        return _effect_def ? _effect_def->effect_width : 0.0f;
     }
     float GetEffectHeight() const {
-        return _effect_def.effect_height;
+        return _effect_def ? _effect_def->effect_height : 0.0f;
     }
 
 
@@ -245,6 +262,8 @@ public:
     void Update(float frame_time);
     void Update();
 private:
+    friend class ParticleManager;
+
     /*!
      * \brief destroys the effect. This is private so that only the ParticleManager class
      *         can destroy effects.
@@ -252,23 +271,25 @@ private:
     void _Destroy();
 
     /*!
-     * \brief loads an effect definition from a particle file
+     * \brief loads an effect definition from a particle file. It is only used by the
+     *        ParticleManager, which caches the definitions.
      * \param filename file to load the effect from
+     * \param effect_def the definition to fill
      * \return Whether the effect def is valid
      */
-    bool _LoadEffectDef(const std::string &filename);
+    static bool _LoadEffectDef(const std::string &filename, ParticleEffectDef &effect_def);
 
     /** Creates the effect based on the particle effect definition.
-    *** _LoadEffectDef() must be called before this one.
+    *** The definition must be set before this one.
     **/
     bool _CreateEffect();
 
     //! \brief Helper function used to read a color subtable.
-    vt_video::Color _ReadColor(vt_script::ReadScriptDescriptor &particle_script,
+    static vt_video::Color _ReadColor(vt_script::ReadScriptDescriptor &particle_script,
                                 const std::string &param_name);
 
-    //! The effect definition
-    ParticleEffectDef _effect_def;
+    //! The effect definition, shared by every effect loaded from the same file.
+    std::shared_ptr<const ParticleEffectDef> _effect_def;
 
     //! list of subsystems that make up the effect. (for example, a fire effect might consist
     //! of a flame + smoke + embers)
@@ -294,6 +315,16 @@ private:
 
     //! number of active particles (this is updated on each call to Update())
     int32_t _num_particles;
+
+    //! the area the particles of every system can cover, relative to the effect position
+    vt_common::Rectangle2D _bounds;
+
+    //! whether the effect was drawn since the last update. If not, it is off-screen
+    //! and only updated every PARTICLE_OFFSCREEN_UPDATE_INTERVAL seconds.
+    bool _drawn;
+
+    //! the time not yet given to the systems, while the effect is off-screen
+    float _pending_time;
 }; // class ParticleEffect
 
 }  // namespace vt_mode_manager
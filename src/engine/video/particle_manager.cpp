@@ -19,15 +19,86 @@
 
 #include "engine/video/video.h"
 #include "engine/video/particle_effect.h"
+#include "engine/video/particle_updater.h"
+
+#include "engine/asset_manifest.h"
+#include "engine/asset_watcher.h"
+#include "engine/frame_profiler.h"
 
 #include "utils/utils_common.h"
 
+#include <SDL2/SDL_atomic.h>
+
+#include <algorithm>
+#include <functional>
+
 using namespace vt_script;
 using namespace vt_video;
 
 namespace vt_mode_manager
 {
 
+std::map<std::string, std::shared_ptr<const ParticleEffectDef> > ParticleManager::_effect_defs;
+
+ParticlePool ParticleManager::_particle_pool;
+
+float ParticleManager::_emission_density = 1.0f;
+
+//! \brief The frame time above which the particle emission is thinned out, in milliseconds.
+const int32_t PARTICLE_TARGET_FRAME_TIME = 20;
+
+//! \brief The number of particles updated per frame above which the emission is thinned out on long frames.
+const int32_t PARTICLE_BUDGET = 4000;
+
+//! \brief The lowest emission density, and how much it changes per frame.
+const float PARTICLE_MIN_EMISSION_DENSITY = 0.25f;
+const float PARTICLE_EMISSION_DENSITY_DECREASE = 0.05f;
+const float PARTICLE_EMISSION_DENSITY_INCREASE = 0.01f;
+
+//! \brief The particles counted by the effects updated since the last emission density update.
+static SDL_atomic_t _counted_particles = { 0 };
+
+void ParticleManager::CountParticles(int32_t num_particles)
+{
+    SDL_AtomicAdd(&_counted_particles, num_particles);
+}
+
+void ParticleManager::_UpdateEmissionDensity(int32_t frame_time)
+{
+    int32_t num_particles = SDL_AtomicSet(&_counted_particles, 0);
+
+    // The particle density setting caps the emission, right when it is lowered.
+    const float max_density = VideoManager->GetParticleDensity() / 100.0f;
+    if(frame_time > PARTICLE_TARGET_FRAME_TIME) {
+        if(num_particles > PARTICLE_BUDGET)
+            _emission_density = std::max(PARTICLE_MIN_EMISSION_DENSITY,
+                                         _emission_density - PARTICLE_EMISSION_DENSITY_DECREASE);
+    } else {
+        _emission_density += PARTICLE_EMISSION_DENSITY_INCREASE;
+    }
+    _emission_density = std::min(max_density, _emission_density);
+}
+
+std::shared_ptr<const ParticleEffectDef> ParticleManager::GetEffectDef(const std::string &effect_filename)
+{
+    vt_system::AssetManifest::RecordAsset(vt_system::ASSET_PARTICLE_EFFECT, effect_filename);
+
+    std::map<std::string, std::shared_ptr<const ParticleEffectDef> >::const_iterator it = _effect_defs.find(effect_filename);
+    if(it != _effect_defs.end())
+        return it->second;
+
+    std::shared_ptr<ParticleEffectDef> effect_def = std::make_shared<ParticleEffectDef>();
+    if(!ParticleEffect::_LoadEffectDef(effect_filename, *effect_def))
+        return nullptr;
+
+#ifdef DEBUG_FEATURES
+    vt_system::AssetWatcher::Watch(vt_system::ASSET_PARTICLE_EFFECT, effect_filename);
+#endif
+
+    _effect_defs[effect_filename] = effect_def;
+    return effect_def;
+}
+
 bool ParticleManager::AddParticleEffect(const std::string &effect_filename, float x, float y)
 {
 
@@ -57,40 +128,89 @@ void ParticleManager::_DEBUG_ShowParticleStats()
 
 void ParticleManager::Draw() const
 {
+    PROFILE_SCOPE("ParticleManager::Draw");
+
     VideoManager->PushState();
     VideoManager->SetStandardCoordSys();
     VideoManager->DisableScissoring();
 
-    std::vector<ParticleEffect *>::const_iterator it = _active_effects.begin();
+    VideoManager->FlushSpriteBatch();
 
-    glClearStencil(0);
-    glClear(GL_STENCIL_BUFFER_BIT);
+    // List the systems of the visible effects, and clear the stencil buffer only when used.
+    _draw_items.clear();
+    bool stencil_used = false;
+    for(uint32_t i = 0; i < _active_effects.size(); ++i) {
+        ParticleEffect *effect = _active_effects[i];
+        if(!effect->IsOnScreen())
+            continue;
+        effect->_drawn = true;
 
-    while(it != _active_effects.end()) {
-        (*it)->Draw();
-        ++it;
+        for(uint32_t j = 0; j < effect->_systems.size(); ++j) {
+            _draw_items.push_back(_DrawItem(effect, &effect->_systems[j]));
+            stencil_used = stencil_used || effect->_systems[j].UsesStencil();
+        }
+    }
+
+    if(stencil_used) {
+        glClearStencil(0);
+        glClear(GL_STENCIL_BUFFER_BIT);
+    }
+
+    // Group the consecutive order independent systems by texture sheet, so that
+    // they share their blending state and texture binds.
+    std::vector<_DrawItem>::iterator it = _draw_items.begin();
+    while(it != _draw_items.end()) {
+        if(!it->system->IsOrderIndependent()) {
+            ++it;
+            continue;
+        }
+
+        std::vector<_DrawItem>::iterator run_end = it;
+        while(run_end != _draw_items.end() && run_end->system->IsOrderIndependent())
+            ++run_end;
+
+        std::stable_sort(it, run_end, [](const _DrawItem &a, const _DrawItem &b) {
+            return std::less<const private_video::TexSheet *>()(a.system->GetTextureSheet(),
+                                                                b.system->GetTextureSheet());
+        });
+        it = run_end;
     }
 
+    for(uint32_t i = 0; i < _draw_items.size(); ++i) {
+        const vt_common::Position2D &position = _draw_items[i].effect->GetPosition();
+        VideoManager->Move(position.x, position.y);
+        _draw_items[i].system->Draw();
+    }
+
+    VideoManager->DisableStencilTest();
+
     VideoManager->PopState();
 }
 
 void ParticleManager::Update(int32_t frame_time)
 {
+    PROFILE_SCOPE("ParticleManager::Update");
+
     float frame_time_seconds = static_cast<float>(frame_time) / 1000.0f;
 
-    std::vector<ParticleEffect *>::iterator it = _active_effects.begin();
+    _UpdateEmissionDensity(frame_time);
 
-    _num_particles = 0;
+    std::vector<ParticleEffect *>::iterator it = _active_effects.begin();
 
     while(it != _active_effects.end()) {
-        if(!(*it)->IsAlive()) {
+        if(!(*it)->IsAlive())
             it = _active_effects.erase(it);
-        } else {
-            (*it)->Update(frame_time_seconds);
-            _num_particles += (*it)->GetNumParticles();
+        else
             ++it;
-        }
     }
+
+    // The effects are independent, so they are updated in parallel.
+    // This returns once they are all updated, before they are drawn.
+    VideoManager->GetParticleUpdater()->Update(_active_effects, frame_time_seconds);
+
+    _num_particles = 0;
+    for(it = _active_effects.begin(); it != _active_effects.end(); ++it)
+        _num_particles += (*it)->GetNumParticles();
 }
 
 void ParticleManager::StopAll(bool kill_immediate)
@@ -22,14 +22,20 @@
 #ifndef __PARTICLE_MANAGER_HEADER__
 #define __PARTICLE_MANAGER_HEADER__
 
+#include "particle_pool.h"
+
 #include <string>
 #include <vector>
+#include <map>
+#include <memory>
 #include <cstdint>
 
 namespace vt_mode_manager
 {
 
 class ParticleEffect;
+class ParticleEffectDef;
+class ParticleSystem;
 
 /*!***************************************************************************
  *  \brief ParticleManager, used internally by video engine to store/update/draw
@@ -87,6 +93,45 @@ public:
         return _num_particles;
     }
 
+    /** \brief Loads a particle effect definition into the cache, so that the effects
+    *** spawned later from that file don't have to read it.
+    *** \return whether the definition is valid
+    **/
+    bool PreloadParticleEffect(const std::string &effect_filename) {
+        return GetEffectDef(effect_filename) != nullptr;
+    }
+
+    /** \brief Returns the particle effect definition of a file, loading it if it isn't cached yet.
+    *** The definitions are shared by every effect instance, whatever the game mode.
+    *** \return nullptr if the definition couldn't be loaded.
+    **/
+    static std::shared_ptr<const ParticleEffectDef> GetEffectDef(const std::string &effect_filename);
+
+    /** \brief Drops a cached particle effect definition, so that it is read again by the next effect using it.
+    *** \note The effects already created keep the definition they were created from.
+    **/
+    static void InvalidateEffectDef(const std::string &effect_filename) {
+        _effect_defs.erase(effect_filename);
+    }
+
+    /** \brief Returns the share of the particles the systems emit, from 1.0f down to a quarter.
+    *** It is lowered while the frames are too long and the particle budget is exceeded,
+    *** and raised back once the frames are short enough, up to the particle density setting.
+    **/
+    static float GetEmissionDensity() {
+        return _emission_density;
+    }
+
+    /** \brief Adds the particles of an updated effect to the ones counted against the budget.
+    *** Called by every effect update, from any thread, whether the effect is managed here or not.
+    **/
+    static void CountParticles(int32_t num_particles);
+
+    //! \brief Returns the storage shared by every particle system, whatever the game mode.
+    static ParticlePool &GetParticlePool() {
+        return _particle_pool;
+    }
+
 private:
     /*!
      *  \brief destroys the system. Called by VideoEngine's destructor
@@ -98,15 +143,45 @@ private:
     **/
     void _DEBUG_ShowParticleStats();
 
+    /** \brief Updates the emission density from the frame time and the particles counted
+    *** since the last call. Done once per frame, by the particle manager of the current mode.
+    **/
+    static void _UpdateEmissionDensity(int32_t frame_time);
+
+    //! \brief A system to draw, and the effect it belongs to.
+    class _DrawItem
+    {
+    public:
+        _DrawItem(ParticleEffect *effect_, ParticleSystem *system_) :
+            effect(effect_),
+            system(system_)
+        {}
+
+        ParticleEffect *effect;
+        ParticleSystem *system;
+    };
+
     //! All the effects currently being managed.
     std::vector<ParticleEffect *> _all_effects;
 
     std::vector<ParticleEffect *> _active_effects;
 
+    //! The systems of the visible effects, in drawing order. Kept to avoid reallocating it each frame.
+    mutable std::vector<_DrawItem> _draw_items;
+
     //! Total number of particles among all the active effects. This is updated
     //! during each call to Update(), so that when GetNumParticles() is called,
     //! we can just return this value instead of having to calculate it
     int32_t _num_particles;
+
+    //! The particle effect definitions loaded so far, by filename.
+    static std::map<std::string, std::shared_ptr<const ParticleEffectDef> > _effect_defs;
+
+    //! The particle blocks and drawing arrays of the particle systems.
+    static ParticlePool _particle_pool;
+
+    //! The share of the particles the systems emit.
+    static float _emission_density;
 };
 
 }  // namespace vt_mode_manager
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    particle_pool.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the storage shared by the particle systems.
+*** ***************************************************************************/
+
+#include "engine/video/particle_pool.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+
+#include <SDL2/SDL.h>
+
+namespace vt_mode_manager
+{
+
+//! \brief The capacity of the smallest blocks.
+const uint32_t PARTICLE_POOL_MIN_CAPACITY = 32;
+
+//! \brief The number of unused blocks kept for each capacity.
+const uint32_t PARTICLE_POOL_MAX_FREE_BLOCKS = 8;
+
+ParticlePool::ParticlePool() :
+    _mutex(SDL_CreateMutex())
+{
+    if (_mutex == nullptr)
+        PRINT_ERROR << "Couldn't create the particle pool mutex: " << SDL_GetError() << std::endl;
+}
+
+ParticlePool::~ParticlePool()
+{
+    std::map<uint32_t, std::vector<ParticleBlock *> >::iterator it = _free_blocks.begin();
+    for (; it != _free_blocks.end(); ++it) {
+        for (uint32_t i = 0; i < it->second.size(); ++i)
+            delete it->second[i];
+    }
+    _free_blocks.clear();
+
+    if (_mutex != nullptr)
+        SDL_DestroyMutex(_mutex);
+}
+
+std::shared_ptr<ParticleBlock> ParticlePool::AcquireBlock(uint32_t number_of_particles)
+{
+    uint32_t capacity = PARTICLE_POOL_MIN_CAPACITY;
+    while (capacity < number_of_particles)
+        capacity *= 2;
+
+    ParticleBlock *block = nullptr;
+
+    if (_mutex != nullptr)
+        SDL_LockMutex(_mutex);
+
+    std::vector<ParticleBlock *> &free_blocks = _free_blocks[capacity];
+    if (!free_blocks.empty()) {
+        block = free_blocks.back();
+        free_blocks.pop_back();
+    }
+
+    if (_mutex != nullptr)
+        SDL_UnlockMutex(_mutex);
+
+    if (block != nullptr)
+        block->Clear();
+    else
+        block = new ParticleBlock(capacity);
+
+    return std::shared_ptr<ParticleBlock>(block, [this](ParticleBlock *released) {
+        _ReleaseBlock(released);
+    });
+}
+
+void ParticlePool::_ReleaseBlock(ParticleBlock *block)
+{
+    if (_mutex != nullptr)
+        SDL_LockMutex(_mutex);
+
+    std::vector<ParticleBlock *> &free_blocks = _free_blocks[block->capacity];
+    if (free_blocks.size() < PARTICLE_POOL_MAX_FREE_BLOCKS) {
+        free_blocks.push_back(block);
+        block = nullptr;
+    }
+
+    if (_mutex != nullptr)
+        SDL_UnlockMutex(_mutex);
+
+    delete block;
+}
+
+ParticleVertex *ParticlePool::GetVertices(uint32_t number_of_vertices)
+{
+    if (_vertices.size() < number_of_vertices)
+        _vertices.resize(number_of_vertices);
+    return _vertices.empty() ? nullptr : &_vertices[0];
+}
+
+ParticleTexCoord *ParticlePool::GetTexCoords(uint32_t number_of_vertices)
+{
+    if (_texcoords.size() < number_of_vertices)
+        _texcoords.resize(number_of_vertices);
+    return _texcoords.empty() ? nullptr : &_texcoords[0];
+}
+
+vt_video::Color *ParticlePool::GetColors(uint32_t number_of_vertices)
+{
+    if (_colors.size() < number_of_vertices)
+        _colors.resize(number_of_vertices);
+    return _colors.empty() ? nullptr : &_colors[0];
+}
+
+float *ParticlePool::GetInstanceFloats(uint32_t number_of_floats)
+{
+    if (_instance_floats.size() < number_of_floats)
+        _instance_floats.resize(number_of_floats);
+    return _instance_floats.empty() ? nullptr : &_instance_floats[0];
+}
+
+ParticlePool::ParticlePool(const ParticlePool &)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+ParticlePool &ParticlePool::operator=(const ParticlePool &)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_mode_manager
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    particle_pool.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the storage shared by the particle systems.
+***
+*** Hit effects and other short-lived systems would otherwise allocate and free
+*** their particle arrays every time they are spawned. The pool hands out
+*** particle blocks, whose capacities are rounded up to powers of two, and
+*** keeps the released ones until a system of the same capacity needs them.
+*** The systems being drawn one after another by the main thread, they also
+*** share the arrays their particles are expanded into before being drawn.
+*** ***************************************************************************/
+
+#ifndef __PARTICLE_POOL_HEADER__
+#define __PARTICLE_POOL_HEADER__
+
+#include "particle.h"
+
+#include <map>
+#include <memory>
+
+struct SDL_mutex;
+
+namespace vt_mode_manager
+{
+
+/** ****************************************************************************
+*** \brief The particle blocks and the drawing arrays of every particle system.
+***
+*** The blocks may be acquired and released by any thread, since the systems
+*** are destroyed while their effects are updated. The drawing arrays must
+*** only be used by the main thread, and only grow.
+*** ***************************************************************************/
+class ParticlePool
+{
+public:
+    ParticlePool();
+    ~ParticlePool();
+
+    /** \brief Returns a cleared block of at least the given capacity, recycled when possible.
+    *** The block goes back to the pool when the last copy of the pointer is released.
+    **/
+    std::shared_ptr<ParticleBlock> AcquireBlock(uint32_t number_of_particles);
+
+    //! \brief Return drawing arrays of at least the given number of elements.
+    ParticleVertex *GetVertices(uint32_t number_of_vertices);
+    ParticleTexCoord *GetTexCoords(uint32_t number_of_vertices);
+    vt_video::Color *GetColors(uint32_t number_of_vertices);
+    float *GetInstanceFloats(uint32_t number_of_floats);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ParticlePool(const ParticlePool &particle_pool);
+    ParticlePool &operator=(const ParticlePool &particle_pool);
+
+    //! \brief Keeps the block for later, or deletes it when enough blocks of its capacity are kept.
+    void _ReleaseBlock(ParticleBlock *block);
+
+    //! \brief The unused blocks, by capacity.
+    std::map<uint32_t, std::vector<ParticleBlock *> > _free_blocks;
+
+    //! \brief Protects the unused blocks.
+    SDL_mutex *_mutex;
+
+    //! \brief The arrays the particles are expanded into before being drawn.
+    //! The vertex arrays hold four vertices per particle.
+    std::vector<ParticleVertex, vt_system::MemoryTagAllocator<ParticleVertex, vt_system::MEMORY_PARTICLES> > _vertices;
+    std::vector<ParticleTexCoord, vt_system::MemoryTagAllocator<ParticleTexCoord, vt_system::MEMORY_PARTICLES> > _texcoords;
+    std::vector<vt_video::Color, vt_system::MemoryTagAllocator<vt_video::Color, vt_system::MEMORY_PARTICLES> > _colors;
+    std::vector<float, vt_system::MemoryTagAllocator<float, vt_system::MEMORY_PARTICLES> > _instance_floats;
+};
+
+} // namespace vt_mode_manager
+
+#endif // __PARTICLE_POOL_HEADER__
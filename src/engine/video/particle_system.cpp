@@ -18,11 +18,17 @@
 #include "particle_system.h"
 
 #include "particle_keyframe.h"
+#include "particle_manager.h"
 #include "engine/video/video.h"
+#include "engine/video/gl/gl_particle_simulation.h"
+#include "engine/video/gl/gl_particle_system.h"
+#include "engine/video/gl/gl_shader_program.h"
 
 #include "utils/utils_random.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 
 using namespace vt_utils;
 using namespace vt_video;
@@ -31,7 +37,101 @@ using namespace vt_common;
 namespace vt_mode_manager
 {
 
-bool ParticleSystem::_Create(ParticleSystemDef *sys_def)
+void ParticleSystemDef::BakeKeyframeTable()
+{
+    keyframe_table.assign(PARTICLE_KEYFRAME_TABLE_SIZE, ParticleKeyframe());
+    if(keyframes.empty())
+        return;
+
+    const size_t num_keyframes = keyframes.size();
+    size_t k = 0;
+
+    for(uint32_t i = 0; i < PARTICLE_KEYFRAME_TABLE_SIZE; ++i) {
+        float time = static_cast<float>(i) / static_cast<float>(PARTICLE_KEYFRAME_TABLE_SIZE - 1);
+
+        // find the first keyframe whose time is larger than the sample one
+        while(k < num_keyframes && keyframes[k].time <= time)
+            ++k;
+
+        ParticleKeyframe &sample = keyframe_table[i];
+
+        // before the first keyframe, or after the last one, the properties are held constant
+        if(k == 0 || k == num_keyframes) {
+            sample = keyframes[k == 0 ? 0 : num_keyframes - 1];
+            sample.time = time;
+            continue;
+        }
+
+        const ParticleKeyframe &current = keyframes[k - 1];
+        const ParticleKeyframe &next = keyframes[k];
+        float cur_a = (time - current.time) / (next.time - current.time);
+
+        sample.time = time;
+        sample.rotation_speed = Lerp(cur_a, current.rotation_speed, next.rotation_speed);
+        sample.rotation_speed_variation = Lerp(cur_a, current.rotation_speed_variation, next.rotation_speed_variation);
+        sample.size.x = Lerp(cur_a, current.size.x, next.size.x);
+        sample.size.y = Lerp(cur_a, current.size.y, next.size.y);
+        sample.size_variation.x = Lerp(cur_a, current.size_variation.x, next.size_variation.x);
+        sample.size_variation.y = Lerp(cur_a, current.size_variation.y, next.size_variation.y);
+        for(int32_t c = 0; c < 4; ++c) {
+            sample.color[c] = Lerp(cur_a, current.color[c], next.color[c]);
+            sample.color_variation[c] = Lerp(cur_a, current.color_variation[c], next.color_variation[c]);
+        }
+    }
+}
+
+void ParticleSystemDef::ComputeBounds()
+{
+    // Start with the area the particles are emitted in.
+    switch(emitter._shape) {
+    case EMITTER_SHAPE_CIRCLE:
+    case EMITTER_SHAPE_FILLED_CIRCLE:
+        bounds = vt_common::Rectangle2D(emitter._pos.x - emitter._radius, emitter._pos.x + emitter._radius,
+                                        emitter._pos.y - emitter._radius, emitter._pos.y + emitter._radius);
+        break;
+    case EMITTER_SHAPE_ELLIPSE:
+        bounds = vt_common::Rectangle2D(emitter._pos2.x - fabs(emitter._pos.x), emitter._pos2.x + fabs(emitter._pos.x),
+                                        emitter._pos2.y - fabs(emitter._pos.y), emitter._pos2.y + fabs(emitter._pos.y));
+        break;
+    case EMITTER_SHAPE_LINE:
+    case EMITTER_SHAPE_FILLED_RECTANGLE:
+        bounds = vt_common::Rectangle2D(std::min(emitter._pos.x, emitter._pos2.x), std::max(emitter._pos.x, emitter._pos2.x),
+                                        std::min(emitter._pos.y, emitter._pos2.y), std::max(emitter._pos.y, emitter._pos2.y));
+        break;
+    default:
+        bounds = vt_common::Rectangle2D(emitter._pos.x, emitter._pos.x, emitter._pos.y, emitter._pos.y);
+        break;
+    }
+
+    // Then add how far a particle can travel in any direction during its life.
+    float lifetime = particle_lifetime + fabs(particle_lifetime_variation);
+    float speed = fabs(emitter._initial_speed) + fabs(emitter._initial_speed_variation)
+                  + fabs(wind_velocity.x) + fabs(wind_velocity_variation.x)
+                  + fabs(wind_velocity.y) + fabs(wind_velocity_variation.y);
+    if(wave_motion_used)
+        speed += fabs(wave_amplitude) + fabs(wave_amplitude_variation);
+    float acceleration_length = fabs(acceleration.x) + fabs(acceleration_variation.x)
+                                + fabs(acceleration.y) + fabs(acceleration_variation.y)
+                                + fabs(tangential_acceleration) + fabs(tangential_acceleration_variation)
+                                + fabs(radial_acceleration) + fabs(radial_acceleration_variation);
+    float travel = speed * lifetime + 0.5f * acceleration_length * lifetime * lifetime
+                   + std::max(fabs(emitter._variation.x), fabs(emitter._variation.y));
+
+    bounds.left -= travel;
+    bounds.right += travel;
+    bounds.top -= travel;
+    bounds.bottom += travel;
+
+    max_particle_size = 0.0f;
+    for(uint32_t k = 0; k < keyframes.size(); ++k) {
+        max_particle_size = std::max(max_particle_size, fabs(keyframes[k].size.x) + fabs(keyframes[k].size_variation.x));
+        max_particle_size = std::max(max_particle_size, fabs(keyframes[k].size.y) + fabs(keyframes[k].size_variation.y));
+    }
+    if(speed_scale_used)
+        max_particle_size *= std::max(1.0f, max_speed_scale);
+}
+
+bool ParticleSystem::_Create(const ParticleSystemDef *sys_def)
 {
     // Make sure the system def is valid before initializing.
     if(!sys_def) {
@@ -43,10 +143,37 @@ bool ParticleSystem::_Create(ParticleSystemDef *sys_def)
     _system_def = sys_def;
     _num_particles = 0;
 
-    _particles.resize(_system_def->max_particles);
-    _particle_vertices.resize(_system_def->max_particles * 4);
-    _particle_texcoords.resize(_system_def->max_particles * 4);
-    _particle_colors.resize(_system_def->max_particles * 4);
+    // The keyframe table is needed to update the particles.
+    if(_system_def->keyframe_table.empty()) {
+        _Destroy();
+        return false;
+    }
+
+    // Each system draws its own random numbers, so that it can be updated in any thread.
+    // Its stream is seeded here, on the main thread, from the particle stream.
+    _random.Seed(GetRandomStream(RANDOM_STREAM_PARTICLES).NextUInt64());
+
+    // Let the GPU simulate the particles when asked to, and when it can.
+    if(_system_def->gpu_simulated && _system_def->max_particles > 0) {
+        if(VideoManager->IsParticleSimulationSupported()) {
+            _simulation = std::make_shared<gl::ParticleSimulation>(_system_def->max_particles);
+            if(!_simulation->IsValid())
+                _simulation.reset();
+        }
+
+        if(!_simulation)
+            IF_PRINT_WARNING(VIDEO_DEBUG) << "The particles can't be simulated on the GPU,"
+                                          << " the CPU simulates them instead." << std::endl;
+    }
+
+    if(_simulation) {
+        // The particles only live in video memory.
+        _ResampleSimulationKeyframes();
+    } else if(_system_def->max_particles > 0) {
+        // Recycle the storage of a dead system rather than allocating it.
+        _particle_block = ParticleManager::GetParticlePool().AcquireBlock(_system_def->max_particles);
+        _particles.Attach(_particle_block.get());
+    }
 
     _alive = true;
     _stopped = false;
@@ -69,11 +196,56 @@ bool ParticleSystem::_Create(ParticleSystemDef *sys_def)
     return true;
 }
 
+bool ParticleSystem::UsesStencil() const
+{
+    return _system_def->use_stencil || _system_def->modify_stencil;
+}
+
+bool ParticleSystem::IsOrderIndependent() const
+{
+    // Additive blending sums up the particles whatever the order they are drawn in.
+    return _system_def->blend_mode != VIDEO_NO_BLEND && _system_def->blend_mode != VIDEO_BLEND
+           && !UsesStencil();
+}
+
+const private_video::TexSheet *ParticleSystem::GetTextureSheet() const
+{
+    if (_animation.GetNumFrames() == 0)
+        return nullptr;
+    const private_video::ImageTexture *img = _animation.GetFrame(_animation.GetCurrentFrameIndex())->_image_texture;
+    return img ? img->texture_sheet : nullptr;
+}
+
+vt_common::Rectangle2D ParticleSystem::GetBounds() const
+{
+    // Grow the particle centers area by the largest particle, whatever its rotation.
+    float half_extent = 0.0f;
+    for(uint32_t j = 0; j < _animation.GetNumFrames(); ++j) {
+        const private_video::ImageTexture *img = _animation.GetFrame(j)->_image_texture;
+        if(img == nullptr)
+            continue;
+        float width = static_cast<float>(img->width);
+        float height = static_cast<float>(img->height);
+        half_extent = std::max(half_extent, 0.5f * sqrtf(width * width + height * height));
+    }
+    half_extent *= _system_def->max_particle_size;
+
+    vt_common::Rectangle2D bounds = _system_def->bounds;
+    bounds.left -= half_extent;
+    bounds.right += half_extent;
+    bounds.top -= half_extent;
+    bounds.bottom += half_extent;
+    return bounds;
+}
+
 void ParticleSystem::Draw()
 {
     if (!_alive || !_system_def->enabled || _age < _system_def->emitter._start_time || _num_particles <= 0)
         return;
 
+    // Particle systems aren't batched, so draw the queued sprites first.
+    VideoManager->FlushSpriteBatch();
+
     // Set the blending parameters.
     if (_system_def->blend_mode == VIDEO_NO_BLEND) {
         VideoManager->DisableBlending();
@@ -81,28 +253,28 @@ void ParticleSystem::Draw()
         VideoManager->EnableBlending();
 
         if (_system_def->blend_mode == VIDEO_BLEND)
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         else
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive.
+            VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive.
     }
 
     if (_system_def->use_stencil) {
         VideoManager->EnableStencilTest();
-        glStencilFunc(GL_EQUAL, 1, 0xFFFFFFFF);
-        glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+        VideoManager->SetStencilFunc(GL_EQUAL, 1, 0xFFFFFFFF);
+        VideoManager->SetStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
     } else if (_system_def->modify_stencil) {
         VideoManager->EnableStencilTest();
 
         if (_system_def->stencil_op == VIDEO_STENCIL_OP_INCREASE)
-            glStencilOp(GL_INCR, GL_KEEP, GL_KEEP);
+            VideoManager->SetStencilOp(GL_INCR, GL_KEEP, GL_KEEP);
         else if (_system_def->stencil_op == VIDEO_STENCIL_OP_DECREASE)
-            glStencilOp(GL_DECR, GL_KEEP, GL_KEEP);
+            VideoManager->SetStencilOp(GL_DECR, GL_KEEP, GL_KEEP);
         else if (_system_def->stencil_op == VIDEO_STENCIL_OP_ZERO)
-            glStencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
+            VideoManager->SetStencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
         else
-            glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+            VideoManager->SetStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 
-        glStencilFunc(GL_NEVER, 1, 0xFFFFFFFF);
+        VideoManager->SetStencilFunc(GL_NEVER, 1, 0xFFFFFFFF);
     } else {
         VideoManager->DisableStencilTest();
     }
@@ -114,7 +286,7 @@ void ParticleSystem::Draw()
 
     StillImage* id = _animation.GetFrame(_animation.GetCurrentFrameIndex());
     private_video::ImageTexture* img = id->_image_texture;
-    TextureManager->_BindTexture(img->texture_sheet->tex_id);
+    TextureManager->_BindTexSheet(img->texture_sheet);
 
     float frame_progress = _animation.GetPercentProgress();
 
@@ -129,26 +301,64 @@ void ParticleSystem::Draw()
     float img_width_half = img_width * 0.5f;
     float img_height_half = img_height * 0.5f;
 
+    // Let the GPU expand the particles when possible.
+    if (_simulation || VideoManager->IsParticleInstancingSupported()) {
+        float *instances = nullptr;
+        if (!_simulation) {
+            instances = ParticleManager::GetParticlePool().GetInstanceFloats(_num_particles * gl::PARTICLE_INSTANCE_FLOATS);
+            _FillInstances(instances, img_width_half, img_height_half);
+        }
+
+        gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Particle);
+        assert(shader_program != nullptr);
+
+        float texture_rect[4] = { u1, v1, u2, v2 };
+        float color_scale = _system_def->smooth_animation ? 1.0f - frame_progress : 1.0f;
+        _DrawInstances(shader_program, texture_rect, Color(color_scale, color_scale, color_scale, 1.0f), instances);
+
+        // Blend in the next frame.
+        if (_system_def->smooth_animation) {
+            uint32_t findex = (_animation.GetCurrentFrameIndex() + 1) % _animation.GetNumFrames();
+            private_video::ImageTexture *img2 = _animation.GetFrame(findex)->_image_texture;
+            TextureManager->_BindTexSheet(img2->texture_sheet);
+
+            texture_rect[0] = img2->u1;
+            texture_rect[1] = img2->v1;
+            texture_rect[2] = img2->u2;
+            texture_rect[3] = img2->v2;
+            _DrawInstances(shader_program, texture_rect, Color(frame_progress, frame_progress, frame_progress, 1.0f), instances);
+        }
+
+        VideoManager->UnloadShaderProgram();
+        return;
+    }
+
+    // The systems are drawn one by one, so they share the vertex arrays.
+    ParticlePool &particle_pool = ParticleManager::GetParticlePool();
+    ParticleVertex *particle_vertices = particle_pool.GetVertices(_num_particles * 4);
+    ParticleTexCoord *particle_texcoords = particle_pool.GetTexCoords(_num_particles * 4);
+    Color *particle_colors = particle_pool.GetColors(_num_particles * 4);
+
     // Fill the vertex array.
     if (_system_def->rotation_used) {
         int32_t v = 0;
 
         for (int32_t j = 0; j < _num_particles; ++j) {
-            float scaled_width_half  = img_width_half * _particles[j].size.x;
-            float scaled_height_half = img_height_half * _particles[j].size.y;
+            float scaled_width_half  = img_width_half * _particles.size_x[j];
+            float scaled_height_half = img_height_half * _particles.size_y[j];
 
-            float rotation_angle = _particles[j].rotation_angle;
+            float rotation_angle = _particles.rotation_angle[j];
 
             if(_system_def->rotate_to_velocity) {
                 // Calculate the angle based on the velocity.
-                rotation_angle += UTILS_HALF_PI + atan2f(_particles[j].combined_velocity.y,
-                                                         _particles[j].combined_velocity.x);
+                rotation_angle += UTILS_HALF_PI + atan2f(_particles.combined_velocity_y[j],
+                                                         _particles.combined_velocity_x[j]);
 
                 // Calculate the scaling due to speed.
                 if(_system_def->speed_scale_used) {
                     // Speed is the magnitude of velocity.
-                    float speed = sqrtf(_particles[j].combined_velocity.x * _particles[j].combined_velocity.x
-                                        + _particles[j].combined_velocity.y * _particles[j].combined_velocity.y);
+                    float speed = sqrtf(_particles.combined_velocity_x[j] * _particles.combined_velocity_x[j]
+                                        + _particles.combined_velocity_y[j] * _particles.combined_velocity_y[j]);
                     float scale_factor = _system_def->speed_scale * speed;
 
                     if (scale_factor < _system_def->min_speed_scale)
@@ -161,62 +371,62 @@ void ParticleSystem::Draw()
             }
 
             // The upper-left vertex.
-            _particle_vertices[v]._x = -scaled_width_half;
-            _particle_vertices[v]._y = -scaled_height_half;
-            RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-            _particle_vertices[v]._x += _particles[j].pos.x;
-            _particle_vertices[v]._y += _particles[j].pos.y;
+            particle_vertices[v]._x = -scaled_width_half;
+            particle_vertices[v]._y = -scaled_height_half;
+            RotatePoint(particle_vertices[v]._x, particle_vertices[v]._y, rotation_angle);
+            particle_vertices[v]._x += _particles.pos_x[j];
+            particle_vertices[v]._y += _particles.pos_y[j];
             ++v;
 
             // The upper-right vertex.
-            _particle_vertices[v]._x = scaled_width_half;
-            _particle_vertices[v]._y = -scaled_height_half;
-            RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-            _particle_vertices[v]._x += _particles[j].pos.x;
-            _particle_vertices[v]._y += _particles[j].pos.y;
+            particle_vertices[v]._x = scaled_width_half;
+            particle_vertices[v]._y = -scaled_height_half;
+            RotatePoint(particle_vertices[v]._x, particle_vertices[v]._y, rotation_angle);
+            particle_vertices[v]._x += _particles.pos_x[j];
+            particle_vertices[v]._y += _particles.pos_y[j];
             ++v;
 
             // The lower-right vertex.
-            _particle_vertices[v]._x = scaled_width_half;
-            _particle_vertices[v]._y = scaled_height_half;
-            RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-            _particle_vertices[v]._x += _particles[j].pos.x;
-            _particle_vertices[v]._y += _particles[j].pos.y;
+            particle_vertices[v]._x = scaled_width_half;
+            particle_vertices[v]._y = scaled_height_half;
+            RotatePoint(particle_vertices[v]._x, particle_vertices[v]._y, rotation_angle);
+            particle_vertices[v]._x += _particles.pos_x[j];
+            particle_vertices[v]._y += _particles.pos_y[j];
             ++v;
 
             // The lower-left vertex.
-            _particle_vertices[v]._x = -scaled_width_half;
-            _particle_vertices[v]._y = scaled_height_half;
-            RotatePoint(_particle_vertices[v]._x, _particle_vertices[v]._y, rotation_angle);
-            _particle_vertices[v]._x += _particles[j].pos.x;
-            _particle_vertices[v]._y += _particles[j].pos.y;
+            particle_vertices[v]._x = -scaled_width_half;
+            particle_vertices[v]._y = scaled_height_half;
+            RotatePoint(particle_vertices[v]._x, particle_vertices[v]._y, rotation_angle);
+            particle_vertices[v]._x += _particles.pos_x[j];
+            particle_vertices[v]._y += _particles.pos_y[j];
             ++v;
         }
     } else {
         int32_t v = 0;
 
         for (int32_t j = 0; j < _num_particles; ++j) {
-            float scaled_width_half  = img_width_half * _particles[j].size.x;
-            float scaled_height_half = img_height_half * _particles[j].size.y;
+            float scaled_width_half  = img_width_half * _particles.size_x[j];
+            float scaled_height_half = img_height_half * _particles.size_y[j];
 
             // The upper-left vertex.
-            _particle_vertices[v]._x = _particles[j].pos.x - scaled_width_half;
-            _particle_vertices[v]._y = _particles[j].pos.y - scaled_height_half;
+            particle_vertices[v]._x = _particles.pos_x[j] - scaled_width_half;
+            particle_vertices[v]._y = _particles.pos_y[j] - scaled_height_half;
             ++v;
 
             // The upper-right vertex.
-            _particle_vertices[v]._x = _particles[j].pos.x + scaled_width_half;
-            _particle_vertices[v]._y = _particles[j].pos.y - scaled_height_half;
+            particle_vertices[v]._x = _particles.pos_x[j] + scaled_width_half;
+            particle_vertices[v]._y = _particles.pos_y[j] - scaled_height_half;
             ++v;
 
             // The lower-right vertex.
-            _particle_vertices[v]._x = _particles[j].pos.x + scaled_width_half;
-            _particle_vertices[v]._y = _particles[j].pos.y + scaled_height_half;
+            particle_vertices[v]._x = _particles.pos_x[j] + scaled_width_half;
+            particle_vertices[v]._y = _particles.pos_y[j] + scaled_height_half;
             ++v;
 
             // lower-left vertex
-            _particle_vertices[v]._x = _particles[j].pos.x - scaled_width_half;
-            _particle_vertices[v]._y = _particles[j].pos.y + scaled_height_half;
+            particle_vertices[v]._x = _particles.pos_x[j] - scaled_width_half;
+            particle_vertices[v]._y = _particles.pos_y[j] + scaled_height_half;
             ++v;
         }
     }
@@ -225,18 +435,18 @@ void ParticleSystem::Draw()
 
     int32_t c = 0;
     for (int32_t j = 0; j < _num_particles; ++j) {
-        Color color = _particles[j].color;
+        Color color = _particles.color[j];
 
         if (_system_def->smooth_animation)
             color = color * (1.0f - frame_progress);
 
-        _particle_colors[c] = color;
+        particle_colors[c] = color;
         ++c;
-        _particle_colors[c] = color;
+        particle_colors[c] = color;
         ++c;
-        _particle_colors[c] = color;
+        particle_colors[c] = color;
         ++c;
-        _particle_colors[c] = color;
+        particle_colors[c] = color;
         ++c;
     }
 
@@ -245,23 +455,23 @@ void ParticleSystem::Draw()
     int32_t t = 0;
     for (int32_t j = 0; j < _num_particles; ++j) {
         // The upper-left vertex.
-        _particle_texcoords[t]._t0 = u1;
-        _particle_texcoords[t]._t1 = v1;
+        particle_texcoords[t]._t0 = u1;
+        particle_texcoords[t]._t1 = v1;
         ++t;
 
         // The upper-right vertex.
-        _particle_texcoords[t]._t0 = u2;
-        _particle_texcoords[t]._t1 = v1;
+        particle_texcoords[t]._t0 = u2;
+        particle_texcoords[t]._t1 = v1;
         ++t;
 
         // The lower-right vertex.
-        _particle_texcoords[t]._t0 = u2;
-        _particle_texcoords[t]._t1 = v2;
+        particle_texcoords[t]._t0 = u2;
+        particle_texcoords[t]._t1 = v2;
         ++t;
 
         // The lower-left vertex.
-        _particle_texcoords[t]._t0 = u1;
-        _particle_texcoords[t]._t1 = v2;
+        particle_texcoords[t]._t0 = u1;
+        particle_texcoords[t]._t1 = v2;
         ++t;
     }
 
@@ -271,9 +481,9 @@ void ParticleSystem::Draw()
 
     // Draw the particle system.
     VideoManager->DrawParticleSystem(shader_program,
-                                     reinterpret_cast<float*>(&_particle_vertices[0]),
-                                     reinterpret_cast<float*>(&_particle_texcoords[0]),
-                                     reinterpret_cast<float*>(&_particle_colors[0]),
+                                     reinterpret_cast<float*>(particle_vertices),
+                                     reinterpret_cast<float*>(particle_texcoords),
+                                     reinterpret_cast<float*>(particle_colors),
                                      _num_particles * 4);
 
     if (_system_def->smooth_animation) {
@@ -282,7 +492,7 @@ void ParticleSystem::Draw()
 
         StillImage *id2 = _animation.GetFrame(findex);
         private_video::ImageTexture *img2 = id2->_image_texture;
-        TextureManager->_BindTexture(img2->texture_sheet->tex_id);
+        TextureManager->_BindTexSheet(img2->texture_sheet);
 
         u1 = img2->u1;
         u2 = img2->u2;
@@ -292,46 +502,46 @@ void ParticleSystem::Draw()
         t = 0;
         for (int32_t j = 0; j < _num_particles; ++j) {
             // The upper-left vertex.
-            _particle_texcoords[t]._t0 = u1;
-            _particle_texcoords[t]._t1 = v1;
+            particle_texcoords[t]._t0 = u1;
+            particle_texcoords[t]._t1 = v1;
             ++t;
 
             // The upper-right vertex.
-            _particle_texcoords[t]._t0 = u2;
-            _particle_texcoords[t]._t1 = v1;
+            particle_texcoords[t]._t0 = u2;
+            particle_texcoords[t]._t1 = v1;
             ++t;
 
             // The lower-right vertex.
-            _particle_texcoords[t]._t0 = u2;
-            _particle_texcoords[t]._t1 = v2;
+            particle_texcoords[t]._t0 = u2;
+            particle_texcoords[t]._t1 = v2;
             ++t;
 
             // The lower-left vertex.
-            _particle_texcoords[t]._t0 = u1;
-            _particle_texcoords[t]._t1 = v2;
+            particle_texcoords[t]._t0 = u1;
+            particle_texcoords[t]._t1 = v2;
             ++t;
         }
 
         c = 0;
         for (int32_t j = 0; j < _num_particles; ++j) {
-            Color color = _particles[j].color;
+            Color color = _particles.color[j];
             color = color * frame_progress;
 
-            _particle_colors[c] = color;
+            particle_colors[c] = color;
             ++c;
-            _particle_colors[c] = color;
+            particle_colors[c] = color;
             ++c;
-            _particle_colors[c] = color;
+            particle_colors[c] = color;
             ++c;
-            _particle_colors[c] = color;
+            particle_colors[c] = color;
             ++c;
         }
 
         // Draw the particle system.
         VideoManager->DrawParticleSystem(shader_program,
-                                         reinterpret_cast<float*>(&_particle_vertices[0]),
-                                         reinterpret_cast<float*>(&_particle_texcoords[0]),
-                                         reinterpret_cast<float*>(&_particle_colors[0]),
+                                         reinterpret_cast<float*>(particle_vertices),
+                                         reinterpret_cast<float*>(particle_texcoords),
+                                         reinterpret_cast<float*>(particle_colors),
                                          _num_particles * 4);
     }
 
@@ -339,6 +549,64 @@ void ParticleSystem::Draw()
     VideoManager->UnloadShaderProgram();
 }
 
+void ParticleSystem::_DrawInstances(gl::ShaderProgram *shader_program, const float *texture_rect,
+                                    const Color &color, const float *instances)
+{
+    if (_simulation)
+        VideoManager->DrawSimulatedParticles(shader_program, _simulation.get(), texture_rect, color);
+    else
+        VideoManager->DrawParticleInstances(shader_program, instances, _num_particles,
+                                            texture_rect, color);
+}
+
+void ParticleSystem::_FillInstances(float *instances, float img_width_half, float img_height_half)
+{
+    float *instance = instances;
+
+    for (int32_t j = 0; j < _num_particles; ++j) {
+        float scaled_width_half  = img_width_half * _particles.size_x[j];
+        float scaled_height_half = img_height_half * _particles.size_y[j];
+        float rotation_angle = 0.0f;
+
+        if (_system_def->rotation_used) {
+            rotation_angle = _particles.rotation_angle[j];
+
+            if (_system_def->rotate_to_velocity) {
+                // Calculate the angle based on the velocity.
+                rotation_angle += UTILS_HALF_PI + atan2f(_particles.combined_velocity_y[j],
+                                                         _particles.combined_velocity_x[j]);
+
+                // Calculate the scaling due to speed.
+                if (_system_def->speed_scale_used) {
+                    // Speed is the magnitude of velocity.
+                    float speed = sqrtf(_particles.combined_velocity_x[j] * _particles.combined_velocity_x[j]
+                                        + _particles.combined_velocity_y[j] * _particles.combined_velocity_y[j]);
+                    float scale_factor = _system_def->speed_scale * speed;
+
+                    if (scale_factor < _system_def->min_speed_scale)
+                        scale_factor = _system_def->min_speed_scale;
+                    if (scale_factor > _system_def->max_speed_scale)
+                        scale_factor = _system_def->max_speed_scale;
+
+                    scaled_height_half *= scale_factor;
+                }
+            }
+        }
+
+        const Color &color = _particles.color[j];
+
+        *instance++ = _particles.pos_x[j];
+        *instance++ = _particles.pos_y[j];
+        *instance++ = scaled_width_half;
+        *instance++ = scaled_height_half;
+        *instance++ = rotation_angle;
+        *instance++ = color[0];
+        *instance++ = color[1];
+        *instance++ = color[2];
+        *instance++ = color[3];
+    }
+}
+
 //-----------------------------------------------------------------------------
 // Update: updates particle positions and properties, and emits/kills particles
 //-----------------------------------------------------------------------------
@@ -357,6 +625,13 @@ void ParticleSystem::Update(float frame_time, const EffectParameters &params)
 
     _animation.Update();
 
+    // the particles simulated on the GPU are only advanced there
+    if(_simulation) {
+        _UpdateSimulation(frame_time, params);
+        _last_update_time = _age;
+        return;
+    }
+
     // update properties of existing particles
     _UpdateParticles(frame_time, params);
 
@@ -364,7 +639,8 @@ void ParticleSystem::Update(float frame_time, const EffectParameters &params)
     int32_t num_particles_to_emit = 0;
     if(!_stopped) {
         if(_system_def->emitter._emitter_mode == EMITTER_MODE_ALWAYS) {
-            num_particles_to_emit = _system_def->max_particles - _num_particles;
+            int32_t max_particles = static_cast<int32_t>(_system_def->max_particles * params.emission_density);
+            num_particles_to_emit = std::max(0, max_particles - _num_particles);
         } else if(_system_def->emitter._emitter_mode != EMITTER_MODE_BURST) {
             float time_low  = _last_update_time * _system_def->emitter._emission_rate;
             float time_high = _age * _system_def->emitter._emission_rate;
@@ -379,6 +655,16 @@ void ParticleSystem::Update(float frame_time, const EffectParameters &params)
         } else {
             num_particles_to_emit = _system_def->max_particles;
         }
+
+        // thin out the emission when the particle budget is exceeded, drawing the
+        // fractional particle at random so that slow emitters still emit
+        if(_system_def->emitter._emitter_mode != EMITTER_MODE_ALWAYS
+                && params.emission_density < 1.0f && num_particles_to_emit > 0) {
+            float scaled_num_particles = num_particles_to_emit * params.emission_density;
+            num_particles_to_emit = static_cast<int32_t>(scaled_num_particles);
+            if(_random.Float(0.0f, 1.0f) < scaled_num_particles - num_particles_to_emit)
+                ++num_particles_to_emit;
+        }
     }
 
     // kill expired particles. If there are particles waiting to be emitted, then instead of
@@ -414,218 +700,332 @@ void ParticleSystem::_Destroy()
 
     _alive = false;
     _stopped = false;
+    _stop_age = -1.0f;
 
-    _particles.clear();
-    _particle_vertices.clear();
+    _particles.Attach(nullptr);
+    _particle_block.reset();
+    _simulation.reset();
+    _simulation_keyframes.clear();
     // Don't delete it, since it's handled by the ParticleEffectDef
     _system_def = 0;
 }
 
-void ParticleSystem::_UpdateParticles(float t, const EffectParameters &params)
+//! \brief Updates a vec4 uniform of the particle simulation program.
+static void _UpdateVector(gl::ShaderProgram *shader_program, const std::string &uniform,
+                          float x, float y, float z, float w)
 {
-    for(int32_t j = 0; j < _num_particles; ++j) {
-        // calculate a time for the particle from 0 to 1 since this is what
-        // the keyframes are based on
-        float scaled_time = _particles[j].time / _particles[j].lifetime;
-
-        // figure out which keyframe we're on
-        if(_particles[j].next_keyframe) {
-            ParticleKeyframe *old_next = _particles[j].next_keyframe;
-
-            // check if we need to advance the keyframe
-            if(scaled_time >= _particles[j].next_keyframe->time) {
-                // figure out what keyframe we're on
-                size_t num_keyframes = _system_def->keyframes.size();
-
-                size_t k;
-                for(k = 0; k < num_keyframes; ++k) {
-                    if(_system_def->keyframes[k].time > scaled_time) {
-                        _particles[j].current_keyframe = &_system_def->keyframes[k - 1];
-                        _particles[j].next_keyframe    = &_system_def->keyframes[k];
-                        break;
-                    }
-                }
+    const float data[4] = { x, y, z, w };
+    shader_program->UpdateUniform(uniform, data, 4);
+}
 
-                // if we didn't find any keyframe whose time is larger than this
-                // particle's time, then we are on the last one
-                if(k == num_keyframes) {
-                    _particles[j].current_keyframe = &_system_def->keyframes[k - 1];
-                    _particles[j].next_keyframe = nullptr;
-
-                    // set all of the keyframed properties to the value stored in the last
-                    // keyframe
-                    _particles[j].color          = _particles[j].current_keyframe->color;
-                    _particles[j].rotation_speed = _particles[j].current_keyframe->rotation_speed;
-                    _particles[j].size         = _particles[j].current_keyframe->size;
-                }
+void ParticleSystem::_UpdateSimulation(float frame_time, const EffectParameters &params)
+{
+    const ParticleEmitter &emitter = _system_def->emitter;
 
-                // if we skipped ahead only 1 keyframe, then inherit the current variations
-                // from the next ones
-                if(_particles[j].current_keyframe == old_next) {
-                    _particles[j].current_color_variation = _particles[j].next_color_variation;
-                    _particles[j].current_rotation_speed_variation = _particles[j].next_rotation_speed_variation;
-                    _particles[j].current_size_variation = _particles[j].next_size_variation;
-                } else {
-                    _particles[j].current_rotation_speed_variation = RandomFloat(-_particles[j].current_keyframe->rotation_speed_variation, _particles[j].current_keyframe->rotation_speed_variation);
-                    for(int32_t c = 0; c < 4; ++c)
-                        _particles[j].current_color_variation[c] = RandomFloat(-_particles[j].current_keyframe->color_variation[c], _particles[j].current_keyframe->color_variation[c]);
-                    _particles[j].current_size_variation.x = RandomFloat(-_particles[j].current_keyframe->size_variation.x,
-                                                                         _particles[j].current_keyframe->size_variation.x);
-                    _particles[j].current_size_variation.y = RandomFloat(-_particles[j].current_keyframe->size_variation.y,
-                                                                         _particles[j].current_keyframe->size_variation.y);
-                }
+    if(emitter._emitter_mode == EMITTER_MODE_ONE_SHOT && _age > _system_def->system_lifetime)
+        _stopped = true;
 
-                // if there is a next keyframe, generate variations for it
-                if(_particles[j].next_keyframe) {
-                    _particles[j].next_rotation_speed_variation = RandomFloat(-_particles[j].next_keyframe->rotation_speed_variation, _particles[j].next_keyframe->rotation_speed_variation);
-                    for(int32_t c = 0; c < 4; ++c)
-                        _particles[j].next_color_variation[c] = RandomFloat(-_particles[j].next_keyframe->color_variation[c], _particles[j].next_keyframe->color_variation[c]);
-                    _particles[j].next_size_variation.x = RandomFloat(-_particles[j].next_keyframe->size_variation.x,
-                                                                      _particles[j].next_keyframe->size_variation.x);
-                    _particles[j].next_size_variation.y = RandomFloat(-_particles[j].next_keyframe->size_variation.y,
-                                                                      _particles[j].next_keyframe->size_variation.y);
-                }
-            }
+    // The particles aren't counted, so the system dies once the longest
+    // particle lifetime has elapsed since it was stopped.
+    if(_stopped) {
+        if(_stop_age < 0.0f)
+            _stop_age = _age;
+
+        if(_age - _stop_age > _system_def->particle_lifetime + _system_def->particle_lifetime_variation) {
+            _num_particles = 0;
+            _alive = false;
+            return;
         }
+    }
+    _num_particles = _system_def->max_particles;
+
+    // The looping and one shot modes give each particle slot its own emission times,
+    // spread over the time the emission rate takes to fill every slot.
+    bool emitting = !_stopped;
+    float emission_rate = 0.0f;
+    float emission_period = 0.0f;
+    if(emitter._emitter_mode == EMITTER_MODE_LOOPING || emitter._emitter_mode == EMITTER_MODE_ONE_SHOT) {
+        if(emitter._emission_rate > 0.0f) {
+            emission_rate = emitter._emission_rate;
+            emission_period = static_cast<float>(_system_def->max_particles) / emission_rate;
+        } else {
+            emitting = false;
+        }
+    }
+
+    int32_t spin = 2;
+    if(emitter._spin == EMITTER_SPIN_CLOCKWISE)
+        spin = 0;
+    else if(emitter._spin == EMITTER_SPIN_COUNTERCLOCKWISE)
+        spin = 1;
+
+    Position2D attractor = emitter._center;
+    if(_system_def->user_defined_attractor)
+        attractor = params.attractor;
+
+    StillImage* id = _animation.GetFrame(_animation.GetCurrentFrameIndex());
+    private_video::ImageTexture* img = id->_image_texture;
+
+    gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::ParticleSimulation);
+    assert(shader_program != nullptr);
+
+    _UpdateVector(shader_program, "u_Step", frame_time, _random.Float(0.0f, 1.0f), emitting ? 1.0f : 0.0f, _age);
+    _UpdateVector(shader_program, "u_Emission", emission_rate, emission_period, 0.0f, 0.0f);
+    _UpdateVector(shader_program, "u_EmitterShape", static_cast<float>(emitter._shape), emitter._radius,
+                  params.orientation, static_cast<float>(spin));
+    _UpdateVector(shader_program, "u_EmitterPosition", emitter._pos.x, emitter._pos.y,
+                  emitter._pos2.x, emitter._pos2.y);
+    _UpdateVector(shader_program, "u_EmitterSpeed", emitter._initial_speed, emitter._initial_speed_variation,
+                  emitter._orientation + params.orientation, emitter._angle_variation);
+    _UpdateVector(shader_program, "u_EmitterFlags", emitter._omnidirectional ? 1.0f : 0.0f,
+                  _system_def->random_initial_angle ? 1.0f : 0.0f, emitter._variation.x, emitter._variation.y);
+    _UpdateVector(shader_program, "u_Lifetime", _system_def->particle_lifetime, _system_def->particle_lifetime_variation,
+                  _system_def->wave_motion_used ? 1.0f : 0.0f, _system_def->attractor_falloff);
+    _UpdateVector(shader_program, "u_Acceleration", _system_def->acceleration.x, _system_def->acceleration.y,
+                  _system_def->acceleration_variation.x, _system_def->acceleration_variation.y);
+    _UpdateVector(shader_program, "u_Wind", _system_def->wind_velocity.x, _system_def->wind_velocity.y,
+                  _system_def->wind_velocity_variation.x, _system_def->wind_velocity_variation.y);
+    _UpdateVector(shader_program, "u_Damping", _system_def->damping, _system_def->damping_variation,
+                  _system_def->wave_length, _system_def->wave_length_variation);
+    _UpdateVector(shader_program, "u_Wave", _system_def->wave_amplitude, _system_def->wave_amplitude_variation,
+                  _system_def->tangential_acceleration, _system_def->tangential_acceleration_variation);
+    _UpdateVector(shader_program, "u_Radial", _system_def->radial_acceleration,
+                  _system_def->radial_acceleration_variation, attractor.x, attractor.y);
+    _UpdateVector(shader_program, "u_Render", static_cast<float>(img->width) * 0.5f,
+                  static_cast<float>(img->height) * 0.5f, _system_def->rotation_used ? 1.0f : 0.0f,
+                  _system_def->rotate_to_velocity ? 1.0f : 0.0f);
+    _UpdateVector(shader_program, "u_SpeedScale", _system_def->speed_scale, _system_def->min_speed_scale,
+                  _system_def->max_speed_scale, _system_def->speed_scale_used ? 1.0f : 0.0f);
+
+    const uint32_t num_samples = gl::PARTICLE_SIMULATION_KEYFRAMES;
+    const float *keyframes = &_simulation_keyframes[0];
+    shader_program->UpdateUniformArray("u_KeyframeColor", keyframes, num_samples);
+    shader_program->UpdateUniformArray("u_KeyframeColorVariation", keyframes + num_samples * 4, num_samples);
+    shader_program->UpdateUniformArray("u_KeyframeSize", keyframes + num_samples * 8, num_samples);
+    shader_program->UpdateUniformArray("u_KeyframeRotation", keyframes + num_samples * 12, num_samples);
+
+    VideoManager->SimulateParticles(shader_program, _simulation.get());
+    VideoManager->UnloadShaderProgram();
 
-        // if we aren't already at the last keyframe, interpolate to figure out the
-        // current keyframed properties
-        if(_particles[j].next_keyframe) {
-            // figure out how far we are from the current to the next (0.0 to 1.0)
-            float cur_a = (scaled_time - _particles[j].current_keyframe->time) /
-                          (_particles[j].next_keyframe->time - _particles[j].current_keyframe->time);
-
-            _particles[j].rotation_speed = Lerp(cur_a, _particles[j].current_keyframe->rotation_speed
-                                                + _particles[j].current_rotation_speed_variation,
-                                                _particles[j].next_keyframe->rotation_speed
-                                                + _particles[j].next_rotation_speed_variation);
-            _particles[j].size.x         = Lerp(cur_a, _particles[j].current_keyframe->size.x
-                                                + _particles[j].current_size_variation.x,
-                                                _particles[j].next_keyframe->size.x
-                                                + _particles[j].next_size_variation.x);
-            _particles[j].size.y         = Lerp(cur_a, _particles[j].current_keyframe->size.y
-                                                + _particles[j].current_size_variation.y,
-                                                _particles[j].next_keyframe->size.y
-                                                + _particles[j].next_size_variation.y);
-            _particles[j].color[0]       = Lerp(cur_a, _particles[j].current_keyframe->color[0]
-                                                + _particles[j].current_color_variation[0],
-                                                _particles[j].next_keyframe->color[0]
-                                                + _particles[j].next_color_variation[0]);
-            _particles[j].color[1]       = Lerp(cur_a, _particles[j].current_keyframe->color[1]
-                                                + _particles[j].current_color_variation[1],
-                                                _particles[j].next_keyframe->color[1]
-                                                + _particles[j].next_color_variation[1]);
-            _particles[j].color[2]       = Lerp(cur_a, _particles[j].current_keyframe->color[2]
-                                                + _particles[j].current_color_variation[2],
-                                                _particles[j].next_keyframe->color[2]
-                                                + _particles[j].next_color_variation[2]);
-            _particles[j].color[3]       = Lerp(cur_a, _particles[j].current_keyframe->color[3]
-                                                + _particles[j].current_color_variation[3],
-                                                _particles[j].next_keyframe->color[3]
-                                                + _particles[j].next_color_variation[3]);
+    // every particle has been emitted by this first step
+    if(emitter._emitter_mode == EMITTER_MODE_BURST)
+        Stop();
+}
+
+void ParticleSystem::_ResampleSimulationKeyframes()
+{
+    const uint32_t num_samples = gl::PARTICLE_SIMULATION_KEYFRAMES;
+    const ParticleKeyframe *table = &_system_def->keyframe_table[0];
+    const float last_sample = static_cast<float>(PARTICLE_KEYFRAME_TABLE_SIZE - 1);
+
+    _simulation_keyframes.assign(num_samples * 16, 0.0f);
+    float *colors = &_simulation_keyframes[0];
+    float *color_variations = colors + num_samples * 4;
+    float *sizes = color_variations + num_samples * 4;
+    float *rotations = sizes + num_samples * 4;
+
+    for(uint32_t i = 0; i < num_samples; ++i) {
+        float sample = static_cast<float>(i) * last_sample / static_cast<float>(num_samples - 1);
+        int32_t k = static_cast<int32_t>(sample);
+        if(k > static_cast<int32_t>(PARTICLE_KEYFRAME_TABLE_SIZE) - 2)
+            k = PARTICLE_KEYFRAME_TABLE_SIZE - 2;
+
+        const ParticleKeyframe &current = table[k];
+        const ParticleKeyframe &next = table[k + 1];
+        float cur_a = sample - static_cast<float>(k);
+
+        for(int32_t c = 0; c < 4; ++c) {
+            colors[i * 4 + c] = Lerp(cur_a, current.color[c], next.color[c]);
+            color_variations[i * 4 + c] = Lerp(cur_a, current.color_variation[c], next.color_variation[c]);
         }
 
-        _particles[j].rotation_angle += _particles[j].rotation_speed * _particles[j].rotation_direction * t;
+        sizes[i * 4] = Lerp(cur_a, current.size.x, next.size.x);
+        sizes[i * 4 + 1] = Lerp(cur_a, current.size.y, next.size.y);
+        sizes[i * 4 + 2] = Lerp(cur_a, current.size_variation.x, next.size_variation.x);
+        sizes[i * 4 + 3] = Lerp(cur_a, current.size_variation.y, next.size_variation.y);
 
-        Position2D wind_velocity = _particles[j].wind_velocity;
+        rotations[i * 4] = Lerp(cur_a, current.rotation_speed, next.rotation_speed);
+        rotations[i * 4 + 1] = Lerp(cur_a, current.rotation_speed_variation, next.rotation_speed_variation);
+    }
+}
 
-        _particles[j].combined_velocity.x = _particles[j].velocity.x + wind_velocity.x;
-        _particles[j].combined_velocity.y = _particles[j].velocity.y + wind_velocity.y;
+void ParticleSystem::_UpdateKeyframes()
+{
+    const ParticleKeyframe *table = &_system_def->keyframe_table[0];
+    const float last_sample = static_cast<float>(PARTICLE_KEYFRAME_TABLE_SIZE - 1);
+
+    for(int32_t j = 0; j < _num_particles; ++j) {
+        // find the two samples around the particle time, scaled from 0 to 1
+        // since this is what the keyframes are based on
+        float sample = _particles.time[j] / _particles.lifetime[j] * last_sample;
+        if(sample < 0.0f)
+            sample = 0.0f;
+        else if(sample > last_sample)
+            sample = last_sample;
+
+        int32_t k = static_cast<int32_t>(sample);
+        if(k > static_cast<int32_t>(PARTICLE_KEYFRAME_TABLE_SIZE) - 2)
+            k = PARTICLE_KEYFRAME_TABLE_SIZE - 2;
+
+        const ParticleKeyframe &current = table[k];
+        const ParticleKeyframe &next = table[k + 1];
+        const ParticleVariation &variation = _particles.variation[j];
+        float cur_a = sample - static_cast<float>(k);
+
+        _particles.rotation_speed[j] = Lerp(cur_a, current.rotation_speed, next.rotation_speed)
+                                       + variation.rotation_speed_variation
+                                       * Lerp(cur_a, current.rotation_speed_variation, next.rotation_speed_variation);
+        _particles.size_x[j]         = Lerp(cur_a, current.size.x, next.size.x)
+                                       + variation.size_variation.x
+                                       * Lerp(cur_a, current.size_variation.x, next.size_variation.x);
+        _particles.size_y[j]         = Lerp(cur_a, current.size.y, next.size.y)
+                                       + variation.size_variation.y
+                                       * Lerp(cur_a, current.size_variation.y, next.size_variation.y);
+        for(int32_t c = 0; c < 4; ++c) {
+            _particles.color[j][c]   = Lerp(cur_a, current.color[c], next.color[c])
+                                       + variation.color_variation[c]
+                                       * Lerp(cur_a, current.color_variation[c], next.color_variation[c]);
+        }
+    }
+}
+
+void ParticleSystem::_UpdateParticles(float t, const EffectParameters &params)
+{
+    if(_num_particles <= 0)
+        return;
+
+    _UpdateKeyframes();
+
+    // Each property is updated for every particle in its own loop, over
+    // contiguous arrays, so that the compiler can vectorize the loops.
+    const int32_t num_particles = _num_particles;
+
+    float *pos_x = &_particles.pos_x[0];
+    float *pos_y = &_particles.pos_y[0];
+    float *velocity_x = &_particles.velocity_x[0];
+    float *velocity_y = &_particles.velocity_y[0];
+    float *combined_velocity_x = &_particles.combined_velocity_x[0];
+    float *combined_velocity_y = &_particles.combined_velocity_y[0];
+    const float *wind_velocity_x = &_particles.wind_velocity_x[0];
+    const float *wind_velocity_y = &_particles.wind_velocity_y[0];
+    const float *acceleration_x = &_particles.acceleration_x[0];
+    const float *acceleration_y = &_particles.acceleration_y[0];
+    const float *radial_acceleration = &_particles.radial_acceleration[0];
+    const float *tangential_acceleration = &_particles.tangential_acceleration[0];
+    const float *damping = &_particles.damping[0];
+    const float *wave_length_coefficient = &_particles.wave_length_coefficient[0];
+    const float *wave_half_amplitude = &_particles.wave_half_amplitude[0];
+    float *time = &_particles.time[0];
+    float *rotation_angle = &_particles.rotation_angle[0];
+    const float *rotation_speed = &_particles.rotation_speed[0];
+    const float *rotation_direction = &_particles.rotation_direction[0];
+
+    for(int32_t j = 0; j < num_particles; ++j)
+        rotation_angle[j] += rotation_speed[j] * rotation_direction[j] * t;
+
+    for(int32_t j = 0; j < num_particles; ++j) {
+        combined_velocity_x[j] = velocity_x[j] + wind_velocity_x[j];
+        combined_velocity_y[j] = velocity_y[j] + wind_velocity_y[j];
+    }
+
+    if(_system_def->wave_motion_used) {
+        for(int32_t j = 0; j < num_particles; ++j) {
+            if(wave_half_amplitude[j] <= 0.0f)
+                continue;
 
-        if(_system_def->wave_motion_used && _particles[j].wave_half_amplitude > 0.0f) {
             // find the magnitude of the wave velocity
-            float wave_speed = _particles[j].wave_half_amplitude
-                               * sinf(_particles[j].wave_length_coefficient * _particles[j].time);
+            float wave_speed = wave_half_amplitude[j] * sinf(wave_length_coefficient[j] * time[j]);
 
             // now the wave velocity is just that wave speed times the particle's tangential vector
             // Note the inverted x and y assignments
-            Position2D tangent(-_particles[j].combined_velocity.y,
-                               _particles[j].combined_velocity.x);
-            float speed = sqrtf(tangent.GetLength2());
-            tangent.x /= speed;
-            tangent.y /= speed;
-
-            Position2D wave_velocity(tangent.x * wave_speed,
-                                     tangent.y * wave_speed);
+            float tangent_x = -combined_velocity_y[j];
+            float tangent_y = combined_velocity_x[j];
+            float speed = sqrtf(tangent_x * tangent_x + tangent_y * tangent_y);
 
-            _particles[j].combined_velocity.x += wave_velocity.x;
-            _particles[j].combined_velocity.y += wave_velocity.y;
+            combined_velocity_x[j] += tangent_x / speed * wave_speed;
+            combined_velocity_y[j] += tangent_y / speed * wave_speed;
         }
+    }
+
+    for(int32_t j = 0; j < num_particles; ++j) {
+        pos_x[j] += combined_velocity_x[j] * t;
+        pos_y[j] += combined_velocity_y[j] * t;
+    }
+
+    // client-specified acceleration (dv = a * t)
+    for(int32_t j = 0; j < num_particles; ++j) {
+        velocity_x[j] += acceleration_x[j] * t;
+        velocity_y[j] += acceleration_y[j] * t;
+    }
 
-        _particles[j].pos.x += (_particles[j].combined_velocity.x) * t;
-        _particles[j].pos.y += (_particles[j].combined_velocity.y) * t;
+    // radial acceleration: calculate unit vector from emitter center to this particle,
+    // and scale by the radial acceleration, if there is any. The particle values
+    // can only be non-zero when the system ones or their variations are.
+    bool system_radial = (_system_def->radial_acceleration != 0.0f
+                          || _system_def->radial_acceleration_variation != 0.0f);
+    bool system_tangential = (_system_def->tangential_acceleration != 0.0f
+                              || _system_def->tangential_acceleration_variation != 0.0f);
 
+    if(system_radial || system_tangential) {
+        Position2D attractor = _system_def->emitter._center;
+        if(_system_def->user_defined_attractor)
+            attractor = params.attractor;
 
-        // client-specified acceleration (dv = a * t)
-        _particles[j].velocity.x += _particles[j].acceleration.x * t;
-        _particles[j].velocity.y += _particles[j].acceleration.y * t;
+        const float falloff = _system_def->attractor_falloff;
 
-        // radial acceleration: calculate unit vector from emitter center to this particle,
-        // and scale by the radial acceleration, if there is any
+        for(int32_t j = 0; j < num_particles; ++j) {
+            bool use_radial     = (radial_acceleration[j] != 0.0f);
+            bool use_tangential = (tangential_acceleration[j] != 0.0f);
 
-        bool use_radial     = (_particles[j].radial_acceleration != 0.0f);
-        bool use_tangential = (_particles[j].tangential_acceleration != 0.0f);
+            if(!use_radial && !use_tangential)
+                continue;
 
-        if(use_radial || use_tangential) {
             // unit vector from attractor to particle
-            Position2D attractor_to_particle;
-
-            if(_system_def->user_defined_attractor) {
-                attractor_to_particle.x = _particles[j].pos.x - params.attractor.x;
-                attractor_to_particle.y = _particles[j].pos.y - params.attractor.y;
-            } else {
-                attractor_to_particle.x = _particles[j].pos.x - _system_def->emitter._center.x;
-                attractor_to_particle.y = _particles[j].pos.y - _system_def->emitter._center.y;
-            }
+            float to_particle_x = pos_x[j] - attractor.x;
+            float to_particle_y = pos_y[j] - attractor.y;
 
-            float distance = sqrtf(attractor_to_particle.GetLength2());
+            float distance = sqrtf(to_particle_x * to_particle_x + to_particle_y * to_particle_y);
 
             if(distance != 0.0f) {
-                attractor_to_particle.x /= distance;
-                attractor_to_particle.y /= distance;
+                to_particle_x /= distance;
+                to_particle_y /= distance;
             }
 
             // radial acceleration
             if(use_radial) {
-                if(_system_def->attractor_falloff != 0.0f) {
-                    float attraction = 1.0f - _system_def->attractor_falloff * distance;
-                    if(attraction > 0.0f) {
-                        _particles[j].velocity.x += attractor_to_particle.x
-                                                    * _particles[j].radial_acceleration
-                                                    * t * attraction;
-                        _particles[j].velocity.y += attractor_to_particle.y
-                                                    * _particles[j].radial_acceleration
-                                                    * t * attraction;
-                    }
-                } else {
-                    _particles[j].velocity.x += attractor_to_particle.x
-                                                * _particles[j].radial_acceleration * t;
-                    _particles[j].velocity.y += attractor_to_particle.y
-                                                * _particles[j].radial_acceleration * t;
+                float attraction = 1.0f;
+                if(falloff != 0.0f)
+                    attraction = 1.0f - falloff * distance;
+
+                if(attraction > 0.0f) {
+                    velocity_x[j] += to_particle_x * radial_acceleration[j] * t * attraction;
+                    velocity_y[j] += to_particle_y * radial_acceleration[j] * t * attraction;
                 }
             }
 
-            // tangential acceleration
+            // tangential acceleration: the tangent vector is simply the perpendicular vector
+            // Note the inversion of x and y
             if(use_tangential) {
-                // tangent vector is simply perpendicular vector
-                // Note the inversion of x and y
-                Position2D tangent(-attractor_to_particle.y,
-                                   attractor_to_particle.x);
-
-                _particles[j].velocity.x += tangent.x * _particles[j].tangential_acceleration * t;
-                _particles[j].velocity.y += tangent.y * _particles[j].tangential_acceleration * t;
+                velocity_x[j] += -to_particle_y * tangential_acceleration[j] * t;
+                velocity_y[j] += to_particle_x * tangential_acceleration[j] * t;
             }
         }
+    }
 
-        // damp the velocity
+    // damp the velocity
+    if(_system_def->damping != 1.0f || _system_def->damping_variation != 0.0f) {
+        for(int32_t j = 0; j < num_particles; ++j) {
+            if(damping[j] == 1.0f)
+                continue;
 
-        if(_particles[j].damping != 1.0f) {
-            _particles[j].velocity.x *= pow(_particles[j].damping, t);
-            _particles[j].velocity.y *= pow(_particles[j].damping, t);
+            float damping_factor = powf(damping[j], t);
+            velocity_x[j] *= damping_factor;
+            velocity_y[j] *= damping_factor;
         }
-
-        _particles[j].time += t;
     }
+
+    for(int32_t j = 0; j < num_particles; ++j)
+        time[j] += t;
 }
 
 
@@ -639,20 +1039,21 @@ void ParticleSystem::_UpdateParticles(float t, const EffectParameters &params)
 void ParticleSystem::_KillParticles(int32_t &num, const EffectParameters &params)
 {
     // check each active particle to see if it is expired
-    for(int32_t j = 0; j < _num_particles; ++j) {
-        if(_particles[j].time > _particles[j].lifetime) {
-            if(num > 0) {
-                // if we still have particles to emit, then instead of killing the particle,
-                // respawn it as a new one
-                _RespawnParticle(j, params);
-                --num;
-            } else {
-                // kill the particle, i.e. move the particle at the end of the array to this
-                // particle's spot, and decrement _num_particles
-                if(j != _num_particles - 1)
-                    _MoveParticle(_num_particles - 1, j);
-                --_num_particles;
-            }
+    for(int32_t j = 0; j < _num_particles;) {
+        if(_particles.time[j] <= _particles.lifetime[j]) {
+            ++j;
+        } else if(num > 0) {
+            // if we still have particles to emit, then instead of killing the particle,
+            // respawn it as a new one
+            _RespawnParticle(j, params);
+            --num;
+            ++j;
+        } else {
+            // kill the particle, i.e. move the particle at the end of the arrays to this
+            // particle's spot, and decrement _num_particles. The moved particle is checked next.
+            if(j != _num_particles - 1)
+                _MoveParticle(_num_particles - 1, j);
+            --_num_particles;
         }
     }
 }
@@ -679,7 +1080,7 @@ void ParticleSystem::_EmitParticles(int32_t num, const EffectParameters &params)
 
 void ParticleSystem::_MoveParticle(int32_t src, int32_t dest)
 {
-    _particles[dest] = _particles[src];
+    _particles.Move(src, dest);
 }
 
 
@@ -694,31 +1095,31 @@ void ParticleSystem::_RespawnParticle(int32_t i, const EffectParameters &params)
 
     switch(emitter._shape) {
     case EMITTER_SHAPE_POINT: {
-        _particles[i].pos.x = emitter._pos.x;
-        _particles[i].pos.y = emitter._pos.y;
+        _particles.pos_x[i] = emitter._pos.x;
+        _particles.pos_y[i] = emitter._pos.y;
         break;
     }
     case EMITTER_SHAPE_LINE: {
-        _particles[i].pos.x = RandomFloat(emitter._pos.x, emitter._pos2.x);
-        _particles[i].pos.y = RandomFloat(emitter._pos.y, emitter._pos2.y);
+        _particles.pos_x[i] = _random.Float(emitter._pos.x, emitter._pos2.x);
+        _particles.pos_y[i] = _random.Float(emitter._pos.y, emitter._pos2.y);
         break;
     }
     case EMITTER_SHAPE_CIRCLE: {
-        float angle = RandomFloat(0.0f, UTILS_2PI);
-        _particles[i].pos.x = emitter._radius * cosf(angle);
-        _particles[i].pos.y = emitter._radius * sinf(angle);
+        float angle = _random.Float(0.0f, UTILS_2PI);
+        _particles.pos_x[i] = emitter._radius * cosf(angle);
+        _particles.pos_y[i] = emitter._radius * sinf(angle);
         // Apply offset
-        _particles[i].pos.x += emitter._pos.x;
-        _particles[i].pos.y += emitter._pos.y;
+        _particles.pos_x[i] += emitter._pos.x;
+        _particles.pos_y[i] += emitter._pos.y;
         break;
     }
     case EMITTER_SHAPE_ELLIPSE: {
-        float angle = RandomFloat(0.0f, UTILS_2PI);
-        _particles[i].pos.x = emitter._pos.x * cosf(angle);
-        _particles[i].pos.y = emitter._pos.y * sinf(angle);
+        float angle = _random.Float(0.0f, UTILS_2PI);
+        _particles.pos_x[i] = emitter._pos.x * cosf(angle);
+        _particles.pos_y[i] = emitter._pos.y * sinf(angle);
         // Apply offset
-        _particles[i].pos.x += emitter._pos2.x;
-        _particles[i].pos.y += emitter._pos2.y;
+        _particles.pos_x[i] += emitter._pos2.x;
+        _particles.pos_y[i] += emitter._pos2.y;
         break;
     }
     case EMITTER_SHAPE_FILLED_CIRCLE: {
@@ -729,18 +1130,18 @@ void ParticleSystem::_RespawnParticle(int32_t i, const EffectParameters &params)
         // this may need to be replaced by a speedier algorithm later on
         do {
             float half_radius = emitter._radius * 0.5f;
-            _particles[i].pos.x = RandomFloat(-half_radius, half_radius);
-            _particles[i].pos.y = RandomFloat(-half_radius, half_radius);
-        } while(_particles[i].pos.x * _particles[i].pos.x +
-                _particles[i].pos.y * _particles[i].pos.y > radius_squared);
+            _particles.pos_x[i] = _random.Float(-half_radius, half_radius);
+            _particles.pos_y[i] = _random.Float(-half_radius, half_radius);
+        } while(_particles.pos_x[i] * _particles.pos_x[i] +
+                _particles.pos_y[i] * _particles.pos_y[i] > radius_squared);
         // Apply offset
-        _particles[i].pos.x += emitter._pos.x;
-        _particles[i].pos.y += emitter._pos.y;
+        _particles.pos_x[i] += emitter._pos.x;
+        _particles.pos_y[i] += emitter._pos.y;
         break;
     }
     case EMITTER_SHAPE_FILLED_RECTANGLE: {
-        _particles[i].pos.x = RandomFloat(emitter._pos.x, emitter._pos2.x);
-        _particles[i].pos.y = RandomFloat(emitter._pos.y, emitter._pos2.y);
+        _particles.pos_x[i] = _random.Float(emitter._pos.x, emitter._pos2.x);
+        _particles.pos_y[i] = _random.Float(emitter._pos.y, emitter._pos2.y);
         break;
     }
     default:
@@ -748,155 +1149,118 @@ void ParticleSystem::_RespawnParticle(int32_t i, const EffectParameters &params)
     };
 
 
-    _particles[i].pos.x += RandomFloat(-emitter._variation.x, emitter._variation.x);
-    _particles[i].pos.y += RandomFloat(-emitter._variation.y, emitter._variation.y);
+    _particles.pos_x[i] += _random.Float(-emitter._variation.x, emitter._variation.x);
+    _particles.pos_y[i] += _random.Float(-emitter._variation.y, emitter._variation.y);
 
     if(params.orientation != 0.0f)
-        RotatePoint(_particles[i].pos.x, _particles[i].pos.y, params.orientation);
+        RotatePoint(_particles.pos_x[i], _particles.pos_y[i], params.orientation);
 
-    _particles[i].color = _system_def->keyframes[0].color;
+    _particles.time[i] = 0.0f;
 
-    _particles[i].rotation_speed  = _system_def->keyframes[0].rotation_speed;
-    _particles[i].time            = 0.0f;
-    _particles[i].size            = _system_def->keyframes[0].size;
+    // draw the property variations, used all along the particle life
+    float variations[7];
+    _random.Floats(variations, 7, -1.0f, 1.0f);
 
-    if(_system_def->random_initial_angle)
-        _particles[i].rotation_angle = RandomFloat(0.0f, UTILS_2PI);
-    else
-        _particles[i].rotation_angle = 0.0f;
+    ParticleVariation &variation = _particles.variation[i];
+    variation.size_variation.x = variations[0];
+    variation.size_variation.y = variations[1];
+    variation.rotation_speed_variation = variations[2];
+    for(int32_t j = 0; j < 4; ++j)
+        variation.color_variation[j] = variations[3 + j];
 
-    _particles[i].current_keyframe = &_system_def->keyframes[0];
+    const ParticleKeyframe &first_keyframe = _system_def->keyframe_table[0];
+    _particles.size_x[i] = first_keyframe.size.x + variation.size_variation.x * first_keyframe.size_variation.x;
+    _particles.size_y[i] = first_keyframe.size.y + variation.size_variation.y * first_keyframe.size_variation.y;
+    _particles.rotation_speed[i] = first_keyframe.rotation_speed
+                                   + variation.rotation_speed_variation * first_keyframe.rotation_speed_variation;
+    for(int32_t j = 0; j < 4; ++j)
+        _particles.color[i][j] = first_keyframe.color[j] + variation.color_variation[j] * first_keyframe.color_variation[j];
 
-    if(_system_def->keyframes.size() > 1)
-        _particles[i].next_keyframe = &_system_def->keyframes[1];
+    if(_system_def->random_initial_angle)
+        _particles.rotation_angle[i] = _random.Float(0.0f, UTILS_2PI);
     else
-        _particles[i].next_keyframe = nullptr;
+        _particles.rotation_angle[i] = 0.0f;
 
     float speed = _system_def->emitter._initial_speed;
-    speed += RandomFloat(-emitter._initial_speed_variation, emitter._initial_speed_variation);
+    speed += _random.Float(-emitter._initial_speed_variation, emitter._initial_speed_variation);
 
     if(_system_def->emitter._spin == EMITTER_SPIN_CLOCKWISE) {
-        _particles[i].rotation_direction = 1.0f;
+        _particles.rotation_direction[i] = 1.0f;
     } else if(_system_def->emitter._spin == EMITTER_SPIN_COUNTERCLOCKWISE) {
-        _particles[i].rotation_direction = -1.0f;
+        _particles.rotation_direction[i] = -1.0f;
     } else {
-        _particles[i].rotation_direction = static_cast<float>(2 * (rand() % 2)) - 1.0f;
+        _particles.rotation_direction[i] = _random.Sign();
     }
 
     // figure out the orientation
     float angle = 0.0f;
 
     if(emitter._omnidirectional) {
-        angle = RandomFloat(0.0f, UTILS_2PI);
+        angle = _random.Float(0.0f, UTILS_2PI);
     }
     else {
         angle = emitter._orientation + params.orientation;
 
         if(!IsFloatEqual(emitter._angle_variation, 0.0f))
-            angle += RandomFloat(-emitter._angle_variation, emitter._angle_variation);
+            angle += _random.Float(-emitter._angle_variation, emitter._angle_variation);
     }
 
-    _particles[i].velocity.x = speed * cosf(angle);
-    _particles[i].velocity.y = speed * sinf(angle);
-
-    // figure out property variations
-
-    _particles[i].current_size_variation.x  = RandomFloat(-_system_def->keyframes[0].size_variation.x,
-            _system_def->keyframes[0].size_variation.x);
-    _particles[i].current_size_variation.y  = RandomFloat(-_system_def->keyframes[0].size_variation.y,
-            _system_def->keyframes[0].size_variation.y);
-
-    for(int32_t j = 0; j < 4; ++j) {
-        _particles[i].current_color_variation[j] = RandomFloat(-_system_def->keyframes[0].color_variation[j],
-                _system_def->keyframes[0].color_variation[j]);
-    }
-
-    _particles[i].current_rotation_speed_variation = RandomFloat(-_system_def->keyframes[0].rotation_speed_variation,
-            _system_def->keyframes[0].rotation_speed_variation);
-
-    if(_system_def->keyframes.size() > 1) {
-        // figure out the next keyframe's variations
-        _particles[i].next_size_variation.x  = RandomFloat(-_system_def->keyframes[1].size_variation.x,
-                                               _system_def->keyframes[1].size_variation.x);
-        _particles[i].next_size_variation.y  = RandomFloat(-_system_def->keyframes[1].size_variation.y,
-                                               _system_def->keyframes[1].size_variation.y);
-
-        for(int32_t j = 0; j < 4; ++j) {
-            _particles[i].next_color_variation[j] = RandomFloat(-_system_def->keyframes[1].color_variation[j],
-                                                    _system_def->keyframes[1].color_variation[j]);
-        }
-
-        _particles[i].next_rotation_speed_variation = RandomFloat(-_system_def->keyframes[1].rotation_speed_variation,
-                _system_def->keyframes[1].rotation_speed_variation);
-    } else {
-        // if there's only 1 keyframe, then apply the variations now
-        for(int32_t j = 0; j < 4; ++j) {
-            _particles[i].color[j] += RandomFloat(-_particles[i].current_color_variation[j],
-                                                  _particles[i].current_color_variation[j]);
-        }
-
-        _particles[i].size.x += RandomFloat(-_particles[i].current_size_variation.x,
-                                            _particles[i].current_size_variation.x);
-        _particles[i].size.y += RandomFloat(-_particles[i].current_size_variation.y,
-                                            _particles[i].current_size_variation.y);
-
-        _particles[i].rotation_speed += RandomFloat(-_particles[i].current_rotation_speed_variation,
-                                        _particles[i].current_rotation_speed_variation);
-    }
+    _particles.velocity_x[i] = speed * cosf(angle);
+    _particles.velocity_y[i] = speed * sinf(angle);
 
-    _particles[i].tangential_acceleration = _system_def->tangential_acceleration;
+    _particles.tangential_acceleration[i] = _system_def->tangential_acceleration;
     if(_system_def->tangential_acceleration_variation != 0.0f)
-        _particles[i].tangential_acceleration += RandomFloat(-_system_def->tangential_acceleration_variation,
+        _particles.tangential_acceleration[i] += _random.Float(-_system_def->tangential_acceleration_variation,
                 _system_def->tangential_acceleration_variation);
 
-    _particles[i].radial_acceleration = _system_def->radial_acceleration;
+    _particles.radial_acceleration[i] = _system_def->radial_acceleration;
     if(_system_def->radial_acceleration_variation != 0.0f)
-        _particles[i].radial_acceleration += RandomFloat(-_system_def->radial_acceleration_variation,
+        _particles.radial_acceleration[i] += _random.Float(-_system_def->radial_acceleration_variation,
                                              _system_def->radial_acceleration_variation);
 
-    _particles[i].acceleration.x = _system_def->acceleration.x;
+    _particles.acceleration_x[i] = _system_def->acceleration.x;
     if(_system_def->acceleration_variation.x != 0.0f)
-        _particles[i].acceleration.x += RandomFloat(-_system_def->acceleration_variation.x,
+        _particles.acceleration_x[i] += _random.Float(-_system_def->acceleration_variation.x,
                                         _system_def->acceleration_variation.x);
 
-    _particles[i].acceleration.y = _system_def->acceleration.y;
+    _particles.acceleration_y[i] = _system_def->acceleration.y;
     if(_system_def->acceleration_variation.y != 0.0f)
-        _particles[i].acceleration.y += RandomFloat(-_system_def->acceleration_variation.y,
+        _particles.acceleration_y[i] += _random.Float(-_system_def->acceleration_variation.y,
                                         _system_def->acceleration_variation.y);
 
-    _particles[i].wind_velocity.x = _system_def->wind_velocity.x;
+    _particles.wind_velocity_x[i] = _system_def->wind_velocity.x;
     if(_system_def->wind_velocity_variation.x != 0.0f)
-        _particles[i].wind_velocity.x += RandomFloat(-_system_def->wind_velocity_variation.x,
+        _particles.wind_velocity_x[i] += _random.Float(-_system_def->wind_velocity_variation.x,
                                          _system_def->wind_velocity_variation.x);
 
-    _particles[i].wind_velocity.y = _system_def->wind_velocity.y;
+    _particles.wind_velocity_y[i] = _system_def->wind_velocity.y;
     if(_system_def->wind_velocity_variation.y != 0.0f)
-        _particles[i].wind_velocity.y += RandomFloat(-_system_def->wind_velocity_variation.y,
+        _particles.wind_velocity_y[i] += _random.Float(-_system_def->wind_velocity_variation.y,
                                          _system_def->wind_velocity_variation.y);
 
-    _particles[i].damping = _system_def->damping;
+    _particles.damping[i] = _system_def->damping;
     if(_system_def->damping_variation != 0.0f)
-        _particles[i].damping += RandomFloat(-_system_def->damping_variation,
-                                             _system_def->damping_variation);
+        _particles.damping[i] += _random.Float(-_system_def->damping_variation,
+                                               _system_def->damping_variation);
 
     if(_system_def->wave_motion_used) {
-        _particles[i].wave_length_coefficient = _system_def->wave_length;
+        _particles.wave_length_coefficient[i] = _system_def->wave_length;
         if(_system_def->wave_length_variation != 0.0f)
-            _particles[i].wave_length_coefficient += RandomFloat(-_system_def->wave_length_variation,
+            _particles.wave_length_coefficient[i] += _random.Float(-_system_def->wave_length_variation,
                     _system_def->wave_length_variation);
 
-        _particles[i].wave_length_coefficient = UTILS_2PI / _particles[i].wave_length_coefficient;
+        _particles.wave_length_coefficient[i] = UTILS_2PI / _particles.wave_length_coefficient[i];
 
-        _particles[i].wave_half_amplitude = _system_def->wave_amplitude;
+        _particles.wave_half_amplitude[i] = _system_def->wave_amplitude;
         if(_system_def->wave_amplitude != 0.0f)
-            _particles[i].wave_half_amplitude += RandomFloat(-_system_def->wave_amplitude_variation,
+            _particles.wave_half_amplitude[i] += _random.Float(-_system_def->wave_amplitude_variation,
                                                  _system_def->wave_amplitude_variation);
-        _particles[i].wave_half_amplitude *= 0.5f;
+        _particles.wave_half_amplitude[i] *= 0.5f;
     }
 
-    _particles[i].lifetime = _system_def->particle_lifetime
-                             + RandomFloat(-_system_def->particle_lifetime_variation,
-                                           _system_def->particle_lifetime_variation);
+    _particles.lifetime[i] = _system_def->particle_lifetime
+                             + _random.Float(-_system_def->particle_lifetime_variation,
+                                             _system_def->particle_lifetime_variation);
 }
 
 }  // namespace vt_mode_manager
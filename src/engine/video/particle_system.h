@@ -35,9 +35,26 @@
 
 #include "engine/video/image.h"
 
+#include "common/random_streams.h"
+#include "common/rectangle_2d.h"
+
+#include <memory>
+
+namespace vt_video
+{
+namespace gl
+{
+class ParticleSimulation;
+class ShaderProgram;
+}
+}
+
 namespace vt_mode_manager
 {
 
+//! \brief The number of samples of the keyframed properties over a particle life.
+const uint32_t PARTICLE_KEYFRAME_TABLE_SIZE = 64;
+
 //! \brief Specifies the stencil operation to use and describes how the stencil buffer is modified
 enum VIDEO_STENCIL_OP {
     VIDEO_STENCIL_OP_INVALID = -1,
@@ -68,7 +85,8 @@ class EffectParameters
 public:
     EffectParameters():
         orientation(0.0f),
-        attractor(0.0f, 0.0f)
+        attractor(0.0f, 0.0f),
+        emission_density(1.0f)
     {}
 
     //! orientation of the effect, called with ParticleEffect::SetOrientation()
@@ -76,6 +94,10 @@ public:
 
     //! attraction point, particles gravitate towards this
     vt_common::Position2D attractor;
+
+    //! share of the particles to emit, lowered by the particle manager when the particle
+    //! budget is exceeded. Not applied to the systems simulated on the GPU.
+    float emission_density;
 };
 
 
@@ -116,12 +138,23 @@ public:
         modify_stencil(false),
         stencil_op(VIDEO_STENCIL_OP_INVALID),
         use_stencil(false),
-        random_initial_angle(false)
+        random_initial_angle(false),
+        gpu_simulated(false),
+        max_particle_size(0.0f)
     {}
 
     ~ParticleSystemDef()
     {}
 
+    /** \brief Computes the area the particle centers can reach, from the emitter shape and
+    *** the highest speed and lifetime of the particles. Must be called once the whole
+    *** definition is loaded.
+    **/
+    void ComputeBounds();
+
+    //! \brief Fills the keyframe table from the keyframes. Must be called once they are loaded.
+    void BakeKeyframeTable();
+
     //! Is this system supposed to be displayed
     bool enabled;
 
@@ -133,6 +166,12 @@ public:
     //! contain at least 1 keyframe (in that case, the properties are all held constant)
     std::vector<ParticleKeyframe> keyframes;
 
+    //! The keyframed properties sampled at a fixed rate over the particle lifetime,
+    //! the first sample at time 0.0 and the last one at time 1.0. It is baked from
+    //! the keyframes by BakeKeyframeTable(), so that the particles only have to
+    //! interpolate between two neighbouring samples.
+    std::vector<ParticleKeyframe> keyframe_table;
+
     //! How to blend the particles: VIDEO_NO_BLEND, VIDEO_BLEND, or VIDEO_BLEND_ADD
     //! For most effects, we want VIDEO_BLEND_ADD
     int32_t blend_mode;
@@ -260,6 +299,20 @@ public:
     //! have an angle of zero when they spawn
     bool random_initial_angle;
 
+    //! true if the particles should be emitted, moved and drawn by the GPU, without ever
+    //! going through the CPU. The random values are then drawn by the GPU, the filled
+    //! circle emitter shape spreads the particles evenly over the whole circle, and only
+    //! an upper bound of the number of particles is known. Falls back to the CPU when
+    //! the GPU can't do it.
+    bool gpu_simulated;
+
+    //! The area the particle centers can reach, relative to the effect position, in pixels.
+    //! Conservative, since damping and attractors are ignored.
+    vt_common::Rectangle2D bounds;
+
+    //! The largest size factor a particle can have, from the keyframes.
+    float max_particle_size;
+
     //! Array telling how long each animation should last for
     std::vector<int32_t> animation_frame_times;
 
@@ -276,7 +329,7 @@ public:
     /*!
      * \brief Constructor
      */
-    explicit ParticleSystem(ParticleSystemDef* sys_def) {
+    explicit ParticleSystem(const ParticleSystemDef* sys_def) {
         _Destroy();
         _Create(sys_def);
     }
@@ -320,12 +373,41 @@ public:
 
     /*!
      *  \brief returns how many particles are alive in this system
+     *  When the GPU simulates the system, the particles aren't counted,
+     *  and the maximum number of particles is returned until the system dies.
      * \return the number of particles in this system
      */
     int32_t GetNumParticles() const {
         return _num_particles;
     }
 
+    /*!
+     *  \brief returns true if the GPU simulates the particles. Such a system
+     *  must then be updated by the thread owning the OpenGL context.
+     */
+    bool IsGpuSimulated() const {
+        return _simulation != nullptr;
+    }
+
+    //! \brief returns true if the system tests or modifies the stencil buffer
+    bool UsesStencil() const;
+
+    /*!
+     *  \brief returns true if the system can be drawn before or after the other
+     *         order independent systems with the same result: additive systems
+     *         not using the stencil buffer
+     */
+    bool IsOrderIndependent() const;
+
+    //! \brief returns the texture sheet of the current animation frame, or nullptr
+    const vt_video::private_video::TexSheet *GetTextureSheet() const;
+
+    /*!
+     *  \brief returns the area the particles can cover, relative to the effect position
+     *  \return the bounds of the system, in pixels
+     */
+    vt_common::Rectangle2D GetBounds() const;
+
     /*!
      *  \brief returns the number of seconds since this system was created
      * \return the age of the system
@@ -341,7 +423,7 @@ private:
      * \param sys_def particle definition to base the system off of
      * \return success/failure
      */
-    bool _Create(ParticleSystemDef *sys_def);
+    bool _Create(const ParticleSystemDef *sys_def);
 
     /*!
      *  \brief destroys the system
@@ -379,13 +461,27 @@ private:
 
     /*!
      *  \brief helper function to move a particle from element src to element dest
-     *         in the array. This is required any time we kill a particle, because
-     *         killing particles leaves a hole in the array
+     *         in the arrays. This is required any time we kill a particle, because
+     *         killing particles leaves a hole in the arrays
      * \param src where to move the particle from
      * \param dest where to move the particle to
      */
     void _MoveParticle(int32_t src, int32_t dest);
 
+    /*!
+     *  \brief helper function filling the particle instances drawn by the GPU
+     * \param instances the array to fill, gl::PARTICLE_INSTANCE_FLOATS floats per particle
+     * \param img_width_half half the width of the particle image
+     * \param img_height_half half the height of the particle image
+     */
+    void _FillInstances(float *instances, float img_width_half, float img_height_half);
+
+    /*!
+     *  \brief helper function to update the keyframed properties of the particles:
+     *         color, size and rotation speed, from the system keyframe table
+     */
+    void _UpdateKeyframes();
+
     /*!
      *  \brief creates a new particle at element i in the particle array
      * \param i index of the particle to respawn
@@ -393,11 +489,33 @@ private:
      */
     void _RespawnParticle(int32_t i, const EffectParameters &params);
 
+    /*!
+     *  \brief helper function to Update() advancing the particles simulated on the GPU
+     * \param frame_time the current frame time
+     * \param params the effect parameters to use for this update (orientation and attractor point)
+     */
+    void _UpdateSimulation(float frame_time, const EffectParameters &params);
+
+    /*!
+     *  \brief resamples the keyframe table into the smaller one given to the simulation program
+     */
+    void _ResampleSimulationKeyframes();
+
+    /*!
+     *  \brief helper function drawing the particle instances, simulated on the GPU or filled on the CPU
+     * \param shader_program the particle shader program, already loaded
+     * \param texture_rect the texture coordinates (u1, v1, u2, v2) of the particles
+     * \param color the color every particle color is multiplied by
+     * \param instances the particle instances filled on the CPU, if any
+     */
+    void _DrawInstances(vt_video::gl::ShaderProgram *shader_program, const float *texture_rect,
+                        const vt_video::Color &color, const float *instances);
+
     //! The system definition, contains information like the emitter properties, lifetime of
     //! particles, particle keyframes, etc. Basically everything which isn't instance-specific
     //! Note that this pointer shouldn't be deleted by the particle system, since it's handled by
     //! the corresponding ParticleEffectDef instance.
-    ParticleSystemDef *_system_def;
+    const ParticleSystemDef *_system_def;
 
     //! Animation for each particle. If it's non-animated, it just has 1 frame
     vt_video::AnimatedImage _animation;
@@ -406,15 +524,28 @@ private:
     //! we might set a particle quota for the system which is higher than what's actually there.)
     int32_t _num_particles;
 
-    //! The array of particle vertices. Note that this array contains FOUR vertices per particle.
-    //! This is used for rendering the particles with OpenGL
-    std::vector<ParticleVertex> _particle_vertices;
-    std::vector<vt_video::Color> _particle_colors;
-    std::vector<ParticleTexCoord> _particle_texcoords;
+    //! The storage of the particles, from the particle pool. It is shared by the copies of the
+    //! system, and goes back to the pool with the last of them.
+    std::shared_ptr<ParticleBlock> _particle_block;
+
+    //! The particle properties, one array per property, pointing into the particle block.
+    ParticleStreams _particles;
+
+    //! The random numbers of the particle properties. Each system has its own stream,
+    //! so that several systems can be updated by different threads at once.
+    vt_common::RandomStream _random;
+
+    //! The particles, when the GPU simulates them. It is shared by the copies of the system,
+    //! since the GPU buffers can't be copied.
+    std::shared_ptr<vt_video::gl::ParticleSimulation> _simulation;
+
+    //! The keyframe table resampled for the simulation program: the colors, the color
+    //! variations, the sizes and the rotation speeds, each gl::PARTICLE_SIMULATION_KEYFRAMES vec4s.
+    std::vector<float> _simulation_keyframes;
 
-    //! This array holds everything except positions and colors. The reason we keep positions and
-    //! colors separate is so that they can be efficiently fed to OpenGL for rendering.
-    std::vector<Particle> _particles;
+    //! The system age when it was stopped, used to know when the simulated particles have all expired.
+    //! Negative while the system isn't stopped.
+    float _stop_age;
 
     //! if stopped is true, no new particles should be emitted
     bool _stopped;
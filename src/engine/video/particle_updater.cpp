@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    particle_updater.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for updating the particle effects in job workers.
+*** ***************************************************************************/
+
+#include "engine/video/particle_updater.h"
+
+#include "engine/job_system.h"
+#include "engine/video/particle_effect.h"
+
+#include "utils/exception.h"
+
+namespace vt_mode_manager
+{
+
+void ParticleUpdater::Update(const std::vector<ParticleEffect *> &effects, float frame_time)
+{
+    // Without workers, or with a single effect, the effects are simply updated in order.
+    if (vt_system::JobManager->GetWorkerCount() == 0 || effects.size() < 2) {
+        for (uint32_t i = 0; i < effects.size(); ++i)
+            effects[i]->Update(frame_time);
+        return;
+    }
+
+    std::vector<ParticleEffect *> gpu_effects;
+    _cpu_effects.clear();
+    for (uint32_t i = 0; i < effects.size(); ++i) {
+        if (effects[i]->IsGpuSimulated())
+            gpu_effects.push_back(effects[i]);
+        else
+            _cpu_effects.push_back(effects[i]);
+    }
+
+    // Each effect is a job of its own, their sizes varying a lot.
+    vt_system::JobHandle job = vt_system::JobManager->ParallelFor(_cpu_effects.size(), 1,
+        [this, frame_time](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                _cpu_effects[i]->Update(frame_time);
+        });
+
+    // The OpenGL context is only current in this thread.
+    for (uint32_t i = 0; i < gpu_effects.size(); ++i)
+        gpu_effects[i]->Update(frame_time);
+
+    // Help the workers, then wait for the effects they are still updating.
+    vt_system::JobManager->Wait(job);
+    _cpu_effects.clear();
+}
+
+ParticleUpdater::ParticleUpdater(const ParticleUpdater &)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+ParticleUpdater &ParticleUpdater::operator=(const ParticleUpdater &)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_mode_manager
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    particle_updater.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for updating the particle effects in job workers.
+***
+*** The particle effects don't share anything while they are updated, each
+*** system drawing its own random numbers, so the effects of a particle
+*** manager are spread over the job workers and the main thread.
+*** The update returns once every effect is done, before anything is drawn.
+*** ***************************************************************************/
+
+#ifndef __PARTICLE_UPDATER_HEADER__
+#define __PARTICLE_UPDATER_HEADER__
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_mode_manager
+{
+
+class ParticleEffect;
+
+/** ****************************************************************************
+*** \brief Spreads the update of particle effects over the job workers.
+***
+*** The effects with systems simulated on the GPU are updated by the main
+*** thread, which owns the OpenGL context, while the workers update the others.
+*** ***************************************************************************/
+class ParticleUpdater
+{
+public:
+    ParticleUpdater()
+    {}
+
+    /** \brief Updates the effects, and returns once they are all updated.
+    *** \param effects The effects to update, all alive.
+    *** \param frame_time The elapsed time since the last update, in seconds.
+    **/
+    void Update(const std::vector<ParticleEffect *> &effects, float frame_time);
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ParticleUpdater(const ParticleUpdater &particle_updater);
+    ParticleUpdater &operator=(const ParticleUpdater &particle_updater);
+
+    //! \brief The effects updated by the workers this frame, kept to reuse the memory.
+    std::vector<ParticleEffect *> _cpu_effects;
+};
+
+} // namespace vt_mode_manager
+
+#endif // __PARTICLE_UPDATER_HEADER__
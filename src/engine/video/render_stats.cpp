@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    render_stats.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the per frame rendering statistics.
+*** ***************************************************************************/
+
+#include "engine/video/render_stats.h"
+
+#include "utils/utils_common.h"
+#include "utils/exception.h"
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+//! \brief The number of frames the timer queries are left to the GPU before waiting for them.
+const uint32_t RENDER_STATS_MAX_PENDING_FRAMES = 3;
+
+//! \brief The names of the passes.
+const char* RENDER_PASS_NAMES[RENDER_PASS_TOTAL] = {
+    "other", "tiles", "objects", "lights", "post_effects", "gui"
+};
+
+const char* GetRenderPassName(RenderPass pass)
+{
+    if (pass < RENDER_PASS_OTHER || pass >= RENDER_PASS_TOTAL)
+        return "invalid";
+
+    return RENDER_PASS_NAMES[pass];
+}
+
+RenderStats::RenderStats() :
+    _current_pass(RENDER_PASS_OTHER),
+    _timers_supported(false),
+    _timers_checked(false),
+    _timers_requested(false),
+    _timers_running(false)
+{
+}
+
+RenderStats::~RenderStats()
+{
+    StopCsvExport();
+
+    if (!_timers_supported)
+        return;
+
+    if (_timers_running)
+        glEndQuery(GL_TIME_ELAPSED);
+
+    for (uint32_t i = 0; i < _current.queries.size(); ++i)
+        _free_queries.push_back(_current.queries[i].id);
+
+    for (auto it = _pending_frames.begin(); it != _pending_frames.end(); ++it) {
+        for (uint32_t i = 0; i < it->queries.size(); ++i)
+            _free_queries.push_back(it->queries[i].id);
+    }
+
+    if (!_free_queries.empty())
+        glDeleteQueries(_free_queries.size(), &_free_queries[0]);
+}
+
+void RenderStats::SetPass(RenderPass pass)
+{
+    if (pass == _current_pass)
+        return;
+
+    _current_pass = pass;
+
+    if (_timers_running) {
+        glEndQuery(GL_TIME_ELAPSED);
+        _BeginQuery();
+    }
+}
+
+void RenderStats::EndFrame()
+{
+    if (_timers_running)
+        glEndQuery(GL_TIME_ELAPSED);
+
+    const uint32_t frame_number = _current.stats.frame_number;
+    _pending_frames.push_back(_current);
+    _current = _Frame();
+    _current.stats.frame_number = frame_number + 1;
+
+    // Only wait for the GPU when too many frames are pending.
+    while (!_pending_frames.empty()) {
+        const bool wait = _pending_frames.size() > RENDER_STATS_MAX_PENDING_FRAMES;
+        if (!_ResolveFrame(_pending_frames.front(), wait))
+            break;
+
+        _last_frame = _pending_frames.front().stats;
+        _WriteCsvLine(_last_frame);
+        _pending_frames.pop_front();
+    }
+
+    // The first frame ends once the OpenGL context exists.
+    if (!_timers_checked) {
+#ifdef __APPLE__
+        _timers_supported = false;
+#else
+        // Timer queries are core since OpenGL 3.3.
+        _timers_supported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+#endif
+        _timers_checked = true;
+    }
+
+    _timers_running = _timers_requested && _timers_supported;
+    _current_pass = RENDER_PASS_OTHER;
+    if (_timers_running)
+        _BeginQuery();
+}
+
+bool RenderStats::StartCsvExport(const std::string& filename)
+{
+    StopCsvExport();
+
+    _csv_file.open(filename.c_str(), std::ios::out | std::ios::trunc);
+    if (!_csv_file.is_open()) {
+        PRINT_WARNING << "Couldn't open the render statistics file: " << filename << std::endl;
+        return false;
+    }
+
+    _csv_file << "frame,draw_calls,texture_binds,shader_switches,state_changes,uploaded_bytes";
+    for (uint32_t i = 0; i < RENDER_PASS_TOTAL; ++i)
+        _csv_file << "," << GetRenderPassName(static_cast<RenderPass>(i)) << "_ms";
+    _csv_file << std::endl;
+
+    return true;
+}
+
+void RenderStats::StopCsvExport()
+{
+    if (_csv_file.is_open())
+        _csv_file.close();
+}
+
+void RenderStats::_BeginQuery()
+{
+    GLuint id = 0;
+    if (_free_queries.empty()) {
+        glGenQueries(1, &id);
+    } else {
+        id = _free_queries.back();
+        _free_queries.pop_back();
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, id);
+    _current.queries.push_back(_Query(id, _current_pass));
+}
+
+bool RenderStats::_ResolveFrame(_Frame& frame, bool wait)
+{
+    if (frame.queries.empty())
+        return true;
+
+    if (!wait) {
+        for (uint32_t i = 0; i < frame.queries.size(); ++i) {
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(frame.queries[i].id, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE)
+                return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < RENDER_PASS_TOTAL; ++i)
+        frame.stats.gpu_times[i] = 0.0f;
+
+    for (uint32_t i = 0; i < frame.queries.size(); ++i) {
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(frame.queries[i].id, GL_QUERY_RESULT, &nanoseconds);
+        frame.stats.gpu_times[frame.queries[i].pass] += static_cast<float>(nanoseconds) / 1000000.0f;
+        _free_queries.push_back(frame.queries[i].id);
+    }
+    frame.queries.clear();
+
+    return true;
+}
+
+void RenderStats::_WriteCsvLine(const RenderFrameStats& stats)
+{
+    if (!_csv_file.is_open())
+        return;
+
+    _csv_file << stats.frame_number << ","
+              << stats.draw_calls << ","
+              << stats.texture_binds << ","
+              << stats.shader_switches << ","
+              << stats.state_changes << ","
+              << stats.uploaded_bytes;
+
+    // The times not measured are left empty.
+    for (uint32_t i = 0; i < RENDER_PASS_TOTAL; ++i) {
+        _csv_file << ",";
+        if (stats.gpu_times[i] >= 0.0f)
+            _csv_file << stats.gpu_times[i];
+    }
+    _csv_file << "\n";
+}
+
+RenderStats::RenderStats(const RenderStats&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+RenderStats& RenderStats::operator=(const RenderStats&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace private_video
+
+} // namespace vt_video
@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    render_stats.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the per frame rendering statistics.
+***
+*** The video engine counts the draw calls, texture binds, shader switches,
+*** blending and stencil state changes and uploaded texture bytes of each
+*** frame, and measures the GPU time spent in each render pass with timer
+*** queries. Those queries are only resolved a few frames later, so that
+*** reading them back never stalls the pipeline.
+*** ***************************************************************************/
+
+#ifndef __RENDER_STATS_HEADER__
+#define __RENDER_STATS_HEADER__
+
+#include "utils/gl_include.h"
+
+#include <deque>
+#include <fstream>
+#include <vector>
+
+namespace vt_video
+{
+
+//! \brief The parts of a frame whose GPU time is measured separately.
+enum RenderPass {
+    //! Everything not part of another pass.
+    RENDER_PASS_OTHER = 0,
+    RENDER_PASS_TILES = 1,
+    RENDER_PASS_OBJECTS = 2,
+    RENDER_PASS_LIGHTS = 3,
+    RENDER_PASS_POST_EFFECTS = 4,
+    RENDER_PASS_GUI = 5,
+    RENDER_PASS_TOTAL = 6
+};
+
+namespace private_video
+{
+
+//! \brief Returns the name of a render pass, as shown in the statistics.
+const char* GetRenderPassName(RenderPass pass);
+
+//! \brief The statistics of one rendered frame.
+class RenderFrameStats
+{
+public:
+    RenderFrameStats() :
+        frame_number(0),
+        draw_calls(0),
+        texture_binds(0),
+        shader_switches(0),
+        state_changes(0),
+        uploaded_bytes(0)
+    {
+        for (uint32_t i = 0; i < RENDER_PASS_TOTAL; ++i)
+            gpu_times[i] = -1.0f;
+    }
+
+    uint32_t frame_number;
+
+    uint32_t draw_calls;
+    uint32_t texture_binds;
+    uint32_t shader_switches;
+
+    //! \brief The blending and stencil state changes.
+    uint32_t state_changes;
+
+    //! \brief The bytes of pixels uploaded to textures.
+    uint32_t uploaded_bytes;
+
+    //! \brief The GPU time spent in each pass, in milliseconds, or a negative value when not measured.
+    float gpu_times[RENDER_PASS_TOTAL];
+};
+
+/** ****************************************************************************
+*** \brief Gathers the rendering statistics of each frame.
+***
+*** The counters are always kept, as they're cheap. The timer queries are only
+*** issued while enabled, and when the driver supports them.
+*** ***************************************************************************/
+class RenderStats
+{
+public:
+    RenderStats();
+    ~RenderStats();
+
+    void AddDrawCall() {
+        ++_current.stats.draw_calls;
+    }
+
+    void AddTextureBind() {
+        ++_current.stats.texture_binds;
+    }
+
+    void AddShaderSwitch() {
+        ++_current.stats.shader_switches;
+    }
+
+    void AddStateChange() {
+        ++_current.stats.state_changes;
+    }
+
+    void AddUploadedBytes(uint32_t bytes) {
+        _current.stats.uploaded_bytes += bytes;
+    }
+
+    /** \brief Attributes the GPU work issued from now on to another pass.
+    *** \note The queued sprites must be flushed beforehand, so that they are
+    *** accounted in the pass they were queued in.
+    **/
+    void SetPass(RenderPass pass);
+
+    RenderPass GetPass() const {
+        return _current_pass;
+    }
+
+    //! \brief Ends the current frame, and resolves the timer queries of the previous ones when ready.
+    void EndFrame();
+
+    //! \brief Sets whether the GPU time is measured, from the next frame on.
+    void SetTimersEnabled(bool enabled) {
+        _timers_requested = enabled;
+    }
+
+    //! \brief Returns the last frame whose statistics are complete.
+    const RenderFrameStats& GetLastFrame() const {
+        return _last_frame;
+    }
+
+    //! \brief Tells whether the GPU time can be measured on this driver.
+    bool AreTimersSupported() const {
+        return _timers_supported;
+    }
+
+    /** \brief Starts writing the statistics of every frame to a CSV file.
+    *** \return False if the file couldn't be opened.
+    **/
+    bool StartCsvExport(const std::string& filename);
+
+    //! \brief Stops writing the statistics, and closes the CSV file.
+    void StopCsvExport();
+
+    bool IsExportingCsv() const {
+        return _csv_file.is_open();
+    }
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    RenderStats(const RenderStats& render_stats);
+    RenderStats& operator=(const RenderStats& render_stats);
+
+    //! \brief A GPU time measurement of a part of a pass.
+    class _Query
+    {
+    public:
+        _Query(GLuint id_, RenderPass pass_) :
+            id(id_),
+            pass(pass_)
+        {}
+
+        GLuint id;
+        RenderPass pass;
+    };
+
+    //! \brief A frame whose timer queries aren't resolved yet.
+    class _Frame
+    {
+    public:
+        RenderFrameStats stats;
+        std::vector<_Query> queries;
+    };
+
+    //! \brief The statistics of the frame being drawn.
+    _Frame _current;
+
+    //! \brief The pass the GPU work is currently attributed to.
+    RenderPass _current_pass;
+
+    //! \brief The frames ended, oldest first, waiting for their timer queries.
+    std::deque<_Frame> _pending_frames;
+
+    //! \brief The last frame whose statistics are complete.
+    RenderFrameStats _last_frame;
+
+    //! \brief The timer queries not used by any pending frame.
+    std::vector<GLuint> _free_queries;
+
+    //! \brief Whether the timer queries are supported, checked once the OpenGL context exists.
+    bool _timers_supported;
+    bool _timers_checked;
+
+    //! \brief Whether the GPU time should be measured, and whether it is for the current frame.
+    bool _timers_requested;
+    bool _timers_running;
+
+    //! \brief The file the statistics are exported to, when open.
+    std::ofstream _csv_file;
+
+    //! \brief Starts a timer query for the current pass.
+    void _BeginQuery();
+
+    //! \brief Computes the GPU times of a frame, and recycles its queries.
+    //! \param wait Whether to wait for the results if they aren't available yet.
+    //! \return False if the results weren't available and wait is false.
+    bool _ResolveFrame(_Frame& frame, bool wait);
+
+    //! \brief Writes the statistics of a frame to the CSV file.
+    void _WriteCsvLine(const RenderFrameStats& stats);
+};
+
+} // namespace private_video
+
+} // namespace vt_video
+
+#endif // __RENDER_STATS_HEADER__
@@ -0,0 +1,234 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    screenshot_writer.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for saving screenshots without stalling the game.
+*** ***************************************************************************/
+
+#include "engine/video/screenshot_writer.h"
+
+#include "engine/video/video.h"
+
+#include "utils/exception.h"
+
+#include <SDL2/SDL.h>
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+//! \brief The number of frames a screen reading is left to the GPU before being resolved.
+const uint32_t SCREENSHOT_READBACK_FRAMES = 2;
+
+ScreenshotWriter::ScreenshotWriter() :
+    _pixel_buffers(false),
+    _thread(nullptr),
+    _mutex(SDL_CreateMutex()),
+    _job_queued(SDL_CreateCond()),
+    _quit(false)
+{
+#ifdef __APPLE__
+    _pixel_buffers = true;
+#else
+    // Pixel buffer objects are core since OpenGL 2.1.
+    _pixel_buffers = GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object;
+#endif
+
+    if (_mutex == nullptr || _job_queued == nullptr) {
+        PRINT_ERROR << "Couldn't create the screenshot writer synchronization objects: " << SDL_GetError() << std::endl;
+        return;
+    }
+
+    _thread = SDL_CreateThread(_WorkerThread, "ScreenshotWriter", this);
+    if (_thread == nullptr)
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "Couldn't create the screenshot writer thread: " << SDL_GetError() << std::endl;
+}
+
+ScreenshotWriter::~ScreenshotWriter()
+{
+    // Don't lose the screenshots just taken.
+    while (!_readings.empty()) {
+        _Resolve(_readings.front());
+        _readings.pop_front();
+    }
+
+    // The worker saves the queued screenshots before stopping.
+    if (_thread != nullptr) {
+        SDL_LockMutex(_mutex);
+        _quit = true;
+        SDL_CondSignal(_job_queued);
+        SDL_UnlockMutex(_mutex);
+
+        SDL_WaitThread(_thread, nullptr);
+        _thread = nullptr;
+    }
+
+    for (auto it = _jobs.begin(); it != _jobs.end(); ++it)
+        delete *it;
+    _jobs.clear();
+
+    if (_job_queued != nullptr)
+        SDL_DestroyCond(_job_queued);
+    if (_mutex != nullptr)
+        SDL_DestroyMutex(_mutex);
+}
+
+void ScreenshotWriter::Capture(const std::string& filename, int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "Invalid screenshot size: " << width << "x" << height << std::endl;
+        return;
+    }
+
+    // The RGB rows aren't a multiple of 4 bytes for every width.
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    if (!_pixel_buffers) {
+        _Job* job = new _Job();
+        job->filename = filename;
+        job->image.Resize(width, height, true);
+        job->image.GlReadPixels(x, y);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        _Queue(job);
+        return;
+    }
+
+    _Reading reading;
+    reading.filename = filename;
+    reading.width = width;
+    reading.height = height;
+    reading.frames_left = SCREENSHOT_READBACK_FRAMES;
+
+    glGenBuffers(1, &reading.buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, reading.buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 3, nullptr, GL_STREAM_READ);
+
+    // With a pack buffer bound, the pixels are copied into it asynchronously.
+    glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    if (VideoManager->CheckGLError()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "An OpenGL error occured: "
+                                      << VideoManager->CreateGLErrorString() << std::endl;
+        glDeleteBuffers(1, &reading.buffer);
+        return;
+    }
+
+    _readings.push_back(reading);
+}
+
+void ScreenshotWriter::Update()
+{
+    for (auto it = _readings.begin(); it != _readings.end(); ++it) {
+        if (it->frames_left > 0)
+            --it->frames_left;
+    }
+
+    while (!_readings.empty() && _readings.front().frames_left == 0) {
+        _Resolve(_readings.front());
+        _readings.pop_front();
+    }
+}
+
+void ScreenshotWriter::_Resolve(const _Reading& reading)
+{
+    _Job* job = new _Job();
+    job->filename = reading.filename;
+    job->image.Resize(reading.width, reading.height, true);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, reading.buffer);
+    job->image.GlGetBufferSubData();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    GLuint buffer = reading.buffer;
+    glDeleteBuffers(1, &buffer);
+
+    if (VideoManager->CheckGLError()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "An OpenGL error occured: "
+                                      << VideoManager->CreateGLErrorString() << std::endl;
+        delete job;
+        return;
+    }
+
+    _Queue(job);
+}
+
+void ScreenshotWriter::_Queue(_Job* job)
+{
+    if (_thread == nullptr) {
+        _Save(job);
+        delete job;
+        return;
+    }
+
+    SDL_LockMutex(_mutex);
+    _jobs.push_back(job);
+    SDL_CondSignal(_job_queued);
+    SDL_UnlockMutex(_mutex);
+}
+
+void ScreenshotWriter::_Save(_Job* job)
+{
+    // OpenGL reads the screen upside down.
+    job->image.VerticalFlip();
+    if (!job->image.SaveImage(job->filename))
+        PRINT_WARNING << "Couldn't save the screenshot: " << job->filename << std::endl;
+}
+
+int ScreenshotWriter::_WorkerThread(void* screenshot_writer)
+{
+    static_cast<ScreenshotWriter*>(screenshot_writer)->_Work();
+    return 0;
+}
+
+void ScreenshotWriter::_Work()
+{
+    SDL_LockMutex(_mutex);
+
+    while (true) {
+        while (!_quit && _jobs.empty())
+            SDL_CondWait(_job_queued, _mutex);
+
+        if (_jobs.empty())
+            break;
+
+        _Job* job = _jobs.front();
+        _jobs.pop_front();
+
+        // Save without holding the lock, the job belonging to the worker now.
+        SDL_UnlockMutex(_mutex);
+        _Save(job);
+        delete job;
+        SDL_LockMutex(_mutex);
+    }
+
+    SDL_UnlockMutex(_mutex);
+}
+
+ScreenshotWriter::ScreenshotWriter(const ScreenshotWriter&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+ScreenshotWriter& ScreenshotWriter::operator=(const ScreenshotWriter&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace private_video
+
+} // namespace vt_video
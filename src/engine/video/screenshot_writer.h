@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    screenshot_writer.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for saving screenshots without stalling the game.
+***
+*** Reading the screen back synchronously waits for the GPU to finish drawing
+*** the frame, and encoding the PNG file takes a few more frames of CPU time.
+*** Screenshots are thus read into pixel buffers, resolved a couple of frames
+*** later, once the GPU is done with them, and saved by a worker thread.
+*** ***************************************************************************/
+
+#ifndef __SCREENSHOT_WRITER_HEADER__
+#define __SCREENSHOT_WRITER_HEADER__
+
+#include "image_base.h"
+
+#include <deque>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+namespace vt_video
+{
+
+namespace private_video
+{
+
+/** ****************************************************************************
+*** \brief Reads the screen back asynchronously and saves it to PNG files.
+*** ***************************************************************************/
+class ScreenshotWriter
+{
+public:
+    ScreenshotWriter();
+
+    //! \brief Saves the pending screenshots before returning.
+    ~ScreenshotWriter();
+
+    /** \brief Starts reading a part of the screen back, to save it later.
+    *** \param filename The PNG file to save the screenshot to.
+    *** \param x The left edge of the screen rectangle, in pixels.
+    *** \param y The bottom edge of the screen rectangle, in pixels.
+    *** \param width The width of the screen rectangle.
+    *** \param height The height of the screen rectangle.
+    *** \note The screen is read synchronously when pixel buffers aren't supported.
+    **/
+    void Capture(const std::string& filename, int32_t x, int32_t y, int32_t width, int32_t height);
+
+    //! \brief Resolves the screen readings done long enough ago, and hands them to the worker.
+    //! Must be called once per frame.
+    void Update();
+
+private:
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    ScreenshotWriter(const ScreenshotWriter& screenshot_writer);
+    ScreenshotWriter& operator=(const ScreenshotWriter& screenshot_writer);
+
+    //! \brief A screen reading not resolved yet.
+    class _Reading
+    {
+    public:
+        _Reading() :
+            buffer(0),
+            width(0),
+            height(0),
+            frames_left(0)
+        {}
+
+        std::string filename;
+
+        //! \brief The pixel pack buffer the screen is read into.
+        GLuint buffer;
+
+        int32_t width, height;
+
+        //! \brief The number of frames to wait before the pixels can be mapped without stalling.
+        uint32_t frames_left;
+    };
+
+    //! \brief A screenshot to save, owned by the worker once queued.
+    class _Job
+    {
+    public:
+        std::string filename;
+        ImageMemory image;
+    };
+
+    //! \brief Whether pixel pack buffers are supported.
+    bool _pixel_buffers;
+
+    //! \brief The screen readings not resolved yet, oldest first. Only used by the main thread.
+    std::deque<_Reading> _readings;
+
+    //! \brief The screenshots to save, oldest first.
+    std::deque<_Job*> _jobs;
+
+    //! \brief The thread saving the screenshots, or nullptr when it couldn't be created.
+    SDL_Thread* _thread;
+
+    //! \brief Protects the jobs and the quit flag.
+    SDL_mutex* _mutex;
+
+    //! \brief Signaled when a job is queued, or when the worker must stop.
+    SDL_cond* _job_queued;
+
+    //! \brief Tells the worker to stop once all the jobs are saved.
+    bool _quit;
+
+    /** \brief Copies the pixels of a reading into a new job, and queues it.
+    *** \note This waits for the GPU if the reading isn't finished yet.
+    **/
+    void _Resolve(const _Reading& reading);
+
+    //! \brief Queues a screenshot to save, or saves it right away without worker thread.
+    void _Queue(_Job* job);
+
+    //! \brief Flips the screenshot the right way up and saves it.
+    static void _Save(_Job* job);
+
+    //! \brief The entry point of the worker thread.
+    static int _WorkerThread(void* screenshot_writer);
+
+    //! \brief Saves the queued screenshots until told to stop.
+    void _Work();
+};
+
+} // namespace private_video
+
+} // namespace vt_video
+
+#endif // __SCREENSHOT_WRITER_HEADER__
@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    static_image_layer.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for layers of images kept in video memory.
+*** ***************************************************************************/
+
+#include "engine/video/static_image_layer.h"
+
+#include "engine/video/video.h"
+#include "engine/video/gl/gl_shader_program.h"
+#include "engine/video/gl/gl_shader_programs.h"
+#include "engine/video/gl/gl_static_sprite_buffer.h"
+
+#include <algorithm>
+
+namespace vt_video
+{
+
+StaticImageLayer::StaticImageLayer() :
+    _finalized(false)
+{
+}
+
+StaticImageLayer::~StaticImageLayer()
+{
+    Clear();
+}
+
+int32_t StaticImageLayer::AddImage(const StillImage& image, float x, float y)
+{
+    if (_finalized) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "attempted to add an image to a finalized layer" << std::endl;
+        return -1;
+    }
+
+    float texture_coordinates[8];
+    if (!_GetTextureCoordinates(image, texture_coordinates)) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "attempted to add an image without texture: "
+                                      << image.GetFilename() << std::endl;
+        return -1;
+    }
+
+    const ImageDescriptor& descriptor = image;
+    private_video::TexSheet* texture_sheet = descriptor._texture->texture_sheet;
+
+    // Find the images sharing the same texture sheet.
+    uint32_t sheet_index = 0;
+    while (sheet_index < _sheets.size() && _sheets[sheet_index].texture_sheet != texture_sheet)
+        ++sheet_index;
+
+    if (sheet_index == _sheets.size()) {
+        _sheets.push_back(_SheetGeometry());
+        _sheets.back().image = image;
+        _sheets.back().texture_sheet = texture_sheet;
+        _sheets.back().smooth = descriptor._smooth;
+        _sheets.back().sprite_buffer = nullptr;
+    }
+
+    _SheetGeometry& sheet = _sheets[sheet_index];
+
+    const float width = image.GetWidth();
+    const float height = image.GetHeight();
+
+    // The vertex positions, in the same order as the images drawn one by one.
+    const float vertex_positions[] =
+    {
+        x,         y + height, 0.0f, // Vertex One.
+        x + width, y + height, 0.0f, // Vertex Two.
+        x + width, y,          0.0f, // Vertex Three.
+        x,         y,          0.0f  // Vertex Four.
+    };
+
+    sheet.vertex_positions.insert(sheet.vertex_positions.end(),
+                                  vertex_positions, vertex_positions + 12);
+    sheet.vertex_texture_coordinates.insert(sheet.vertex_texture_coordinates.end(),
+                                            texture_coordinates, texture_coordinates + 8);
+
+    const uint32_t sprite_index = sheet.vertex_texture_coordinates.size() / 8 - 1;
+    _images.push_back(std::make_pair(sheet_index, sprite_index));
+
+    return static_cast<int32_t>(_images.size() - 1);
+}
+
+bool StaticImageLayer::SetImage(uint32_t index, const StillImage& image)
+{
+    if (index >= _images.size())
+        return false;
+
+    _SheetGeometry& sheet = _sheets[_images[index].first];
+    const uint32_t sprite_index = _images[index].second;
+
+    const ImageDescriptor& descriptor = image;
+    if (descriptor._texture == nullptr || descriptor._texture->texture_sheet != sheet.texture_sheet) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "the new image doesn't lie in the same texture sheet: "
+                                      << image.GetFilename() << std::endl;
+        return false;
+    }
+
+    float texture_coordinates[8];
+    _GetTextureCoordinates(image, texture_coordinates);
+
+    if (!_finalized) {
+        std::copy(texture_coordinates, texture_coordinates + 8,
+                  sheet.vertex_texture_coordinates.begin() + sprite_index * 8);
+        return true;
+    }
+
+    sheet.sprite_buffer->UpdateTextureCoordinates(sprite_index, texture_coordinates);
+    return true;
+}
+
+void StaticImageLayer::Finalize()
+{
+    if (_finalized)
+        return;
+
+    for (uint32_t i = 0; i < _sheets.size(); ++i) {
+        _SheetGeometry& sheet = _sheets[i];
+
+        sheet.sprite_buffer = new gl::StaticSpriteBuffer();
+        sheet.sprite_buffer->Upload(&sheet.vertex_positions[0],
+                                    &sheet.vertex_texture_coordinates[0],
+                                    sheet.vertex_texture_coordinates.size() / 8);
+
+        // The geometry now lives in video memory.
+        std::vector<float>().swap(sheet.vertex_positions);
+        std::vector<float>().swap(sheet.vertex_texture_coordinates);
+    }
+
+    _finalized = true;
+}
+
+void StaticImageLayer::Draw() const
+{
+    if (!_finalized || _sheets.empty())
+        return;
+
+    Context& current_context = VideoManager->_current_context;
+
+    VideoManager->PushMatrix();
+
+    // Apply the screen shaking, as the images drawn one by one would.
+    if (VideoManager->IsScreenShaking()) {
+        const CoordSys& coordinate_system = current_context.coordinate_system;
+        float x = VideoManager->_shake_offset.x
+                  * (coordinate_system.GetRight() - coordinate_system.GetLeft())
+                  / VIDEO_STANDARD_RES_WIDTH;
+        float y = VideoManager->_shake_offset.y
+                  * (coordinate_system.GetTop() - coordinate_system.GetBottom())
+                  / VIDEO_STANDARD_RES_HEIGHT;
+        VideoManager->MoveRelative(x * coordinate_system.GetHorizontalDirection(),
+                                   y * coordinate_system.GetVerticalDirection());
+    }
+
+    // Set the blending parameters.
+    VideoManager->EnableBlending();
+    if (current_context.draw_state.GetBlendMode() == VIDEO_BLEND_ADD)
+        VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
+    else
+        VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Normal blending
+
+    VideoManager->EnableTexture2D();
+
+    gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Sprite);
+    assert(shader_program != nullptr);
+
+    for (uint32_t i = 0; i < _sheets.size(); ++i) {
+        const _SheetGeometry& sheet = _sheets[i];
+
+        TextureManager->_BindTexSheet(sheet.texture_sheet);
+        sheet.texture_sheet->Smooth(sheet.smooth);
+        sheet.texture_sheet->UpdateMipmaps();
+
+        VideoManager->DrawStaticSprites(shader_program, sheet.sprite_buffer);
+    }
+
+    VideoManager->UnloadShaderProgram();
+
+    VideoManager->PopMatrix();
+}
+
+void StaticImageLayer::Clear()
+{
+    for (uint32_t i = 0; i < _sheets.size(); ++i)
+        delete _sheets[i].sprite_buffer;
+
+    _sheets.clear();
+    _images.clear();
+    _finalized = false;
+}
+
+bool StaticImageLayer::ShareTextureSheet(const StillImage& first, const StillImage& second)
+{
+    const ImageDescriptor& first_descriptor = first;
+    const ImageDescriptor& second_descriptor = second;
+    if (first_descriptor._texture == nullptr || second_descriptor._texture == nullptr)
+        return false;
+
+    return first_descriptor._texture->texture_sheet == second_descriptor._texture->texture_sheet;
+}
+
+bool StaticImageLayer::_GetTextureCoordinates(const StillImage& image,
+                                              float* vertex_texture_coordinates)
+{
+    const ImageDescriptor& descriptor = image;
+    const private_video::BaseTexture* texture = descriptor._texture;
+    if (texture == nullptr)
+        return false;
+
+    // Same computation as when drawing the image.
+    float s0 = texture->u1 + (descriptor._u1 * (texture->u2 - texture->u1));
+    float s1 = texture->u1 + (descriptor._u2 * (texture->u2 - texture->u1));
+    float t0 = texture->v1 + (descriptor._v1 * (texture->v2 - texture->v1));
+    float t1 = texture->v1 + (descriptor._v2 * (texture->v2 - texture->v1));
+
+    // Vertex One.
+    vertex_texture_coordinates[0] = s0;
+    vertex_texture_coordinates[1] = t1;
+
+    // Vertex Two.
+    vertex_texture_coordinates[2] = s1;
+    vertex_texture_coordinates[3] = t1;
+
+    // Vertex Three.
+    vertex_texture_coordinates[4] = s1;
+    vertex_texture_coordinates[5] = t0;
+
+    // Vertex Four.
+    vertex_texture_coordinates[6] = s0;
+    vertex_texture_coordinates[7] = t0;
+
+    return true;
+}
+
+StaticImageLayer::StaticImageLayer(const StaticImageLayer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+}
+
+StaticImageLayer& StaticImageLayer::operator=(const StaticImageLayer&)
+{
+    throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
+    return *this;
+}
+
+} // namespace vt_video
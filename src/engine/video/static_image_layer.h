@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See http://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    static_image_layer.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for layers of images kept in video memory.
+***
+*** A static image layer stores the geometry of many still images placed at
+*** fixed positions, like map tiles, directly in video memory. The layer is then
+*** drawn using one draw call per texture sheet used by its images.
+*** ***************************************************************************/
+
+#ifndef __STATIC_IMAGE_LAYER_HEADER__
+#define __STATIC_IMAGE_LAYER_HEADER__
+
+#include "image.h"
+
+namespace vt_video
+{
+
+namespace gl {
+class StaticSpriteBuffer;
+}
+
+namespace private_video {
+class TexSheet;
+}
+
+/** ****************************************************************************
+*** \brief A set of still images drawn at fixed positions.
+***
+*** Images are first added, then the layer is finalized, which uploads its
+*** geometry to video memory. Afterwards, only the images themselves can be
+*** changed, e.g. to follow the frames of an animation, provided the new image
+*** lies in the same texture sheet.
+***
+*** \note The layer expects a coordinate system whose origin is at the top-left
+*** corner, like the standard one. The images' own draw colors, offsets and
+*** flipping flags are ignored.
+*** ***************************************************************************/
+class StaticImageLayer
+{
+public:
+    StaticImageLayer();
+    ~StaticImageLayer();
+
+    /** \brief Adds an image to the layer.
+    *** \param image The image to add. It must be loaded.
+    *** \param x The x position of the image left edge, relative to the layer origin.
+    *** \param y The y position of the image top edge, relative to the layer origin.
+    *** \return The index of the image in the layer, or -1 if it couldn't be added.
+    **/
+    int32_t AddImage(const StillImage& image, float x, float y);
+
+    /** \brief Changes the image drawn at the given index.
+    *** \param index The image index, as returned by AddImage().
+    *** \param image The new image, which must lie in the same texture sheet.
+    *** \return false if the image couldn't be changed.
+    **/
+    bool SetImage(uint32_t index, const StillImage& image);
+
+    //! \brief Uploads the layer geometry. No images can be added afterwards.
+    void Finalize();
+
+    //! \brief Draws the layer using the current draw cursor position as its origin.
+    void Draw() const;
+
+    //! \brief Removes all the images from the layer.
+    void Clear();
+
+    bool IsEmpty() const {
+        return _images.empty();
+    }
+
+    /** \brief Tells whether two images lie in the same texture sheet.
+    *** Only then can one image replace the other in a layer.
+    **/
+    static bool ShareTextureSheet(const StillImage& first, const StillImage& second);
+
+private:
+    //! \brief The images sharing one texture sheet.
+    struct _SheetGeometry {
+        //! \brief The first image added, keeping the texture sheet referenced.
+        StillImage image;
+
+        //! \brief The texture sheet of the images.
+        private_video::TexSheet* texture_sheet;
+
+        //! \brief Whether the texture sheet is smoothed when drawing the images.
+        bool smooth;
+
+        //! \brief The images vertices, until the layer is finalized.
+        std::vector<float> vertex_positions;
+        std::vector<float> vertex_texture_coordinates;
+
+        //! \brief The images vertices in video memory, once the layer is finalized.
+        gl::StaticSpriteBuffer* sprite_buffer;
+    };
+
+    //! \brief Computes the texture coordinates of the four vertices of an image.
+    static bool _GetTextureCoordinates(const StillImage& image,
+                                       float* vertex_texture_coordinates);
+
+    //! \brief The geometry, by texture sheet.
+    std::vector<_SheetGeometry> _sheets;
+
+    //! \brief The sheet index and the index within the sheet, of each image.
+    std::vector<std::pair<uint32_t, uint32_t> > _images;
+
+    //! \brief Whether the geometry has been uploaded.
+    bool _finalized;
+
+    //! \brief The copy constructor and assignment operator are hidden by design
+    //! to cause compilation errors when attempting to copy or assign this class.
+    StaticImageLayer(const StaticImageLayer& layer);
+    StaticImageLayer& operator=(const StaticImageLayer& layer);
+};
+
+} // namespace vt_video
+
+#endif // __STATIC_IMAGE_LAYER_HEADER__
@@ -24,8 +24,11 @@
 
 #include "text.h"
 #include "video.h"
+#include "glyph_atlas.h"
 
 #include "script/script_read.h"
+#include "engine/asset_archive.h"
+#include "engine/frame_profiler.h"
 #include "engine/system.h"
 
 #ifdef __APPLE__
@@ -34,6 +37,9 @@
 #   include <SDL2/SDL_ttf.h>
 #endif
 
+#include <algorithm>
+#include <limits>
+
 // The script filename used to configure the text styles used in game.
 const std::string _font_script_filename = "data/config/fonts.lua";
 
@@ -49,6 +55,9 @@ TextSupervisor *TextManager = nullptr;
 const uint16_t NEW_LINE = '\n';
 const uint16_t SPACE_CHAR = 0x20;
 
+//! \brief The maximum number of wrapped texts kept by the text supervisor.
+const size_t TEXT_LAYOUT_CACHE_SIZE = 512;
+
 // -----------------------------------------------------------------------------
 // FontProperties class
 // -----------------------------------------------------------------------------
@@ -59,7 +68,10 @@ FontProperties::FontProperties() :
     ascent(0),
     descent(0),
     ttf_font(nullptr),
-    font_size(0)
+    font_size(0),
+    glyph_atlas(nullptr),
+    distance_field(true),
+    distance_field_font(nullptr)
 {
 }
 
@@ -70,11 +82,18 @@ FontProperties::~FontProperties()
 
 void FontProperties::ClearFont()
 {
+    // Free the glyphs rasterized with the font.
+    if (glyph_atlas) {
+        delete glyph_atlas;
+        glyph_atlas = nullptr;
+    }
+
     // Free the font.
     if (ttf_font)
         TTF_CloseFont(ttf_font);
 
     ttf_font = nullptr;
+    distance_field_font = nullptr;
 }
 
 FontProperties::FontProperties(const FontProperties&)
@@ -391,6 +410,7 @@ void TextElement::SetTexture(TextTexture *texture)
 
 TextImage::TextImage() :
     ImageDescriptor(),
+    _has_source_text(false),
     _style(TextManager->GetDefaultStyle()),
     _max_width(vt_video::VIDEO_STANDARD_RES_WIDTH)
 {
@@ -399,6 +419,7 @@ TextImage::TextImage() :
 TextImage::TextImage(const ustring& text, const TextStyle& style) :
     ImageDescriptor(),
     _text(text),
+    _has_source_text(false),
     _style(style),
     _max_width(vt_video::VIDEO_STANDARD_RES_WIDTH)
 {
@@ -408,6 +429,8 @@ TextImage::TextImage(const ustring& text, const TextStyle& style) :
 TextImage::TextImage(const std::string& text, const TextStyle& style) :
     ImageDescriptor(),
     _text(MakeUnicodeString(text)),
+    _source_text(text),
+    _has_source_text(true),
     _style(style),
     _max_width(vt_video::VIDEO_STANDARD_RES_WIDTH)
 {
@@ -417,6 +440,8 @@ TextImage::TextImage(const std::string& text, const TextStyle& style) :
 TextImage::TextImage(const TextImage &copy) :
     ImageDescriptor(copy),
     _text(copy._text),
+    _source_text(copy._source_text),
+    _has_source_text(copy._has_source_text),
     _style(copy._style),
     _max_width(copy._max_width)
 {
@@ -438,6 +463,8 @@ TextImage &TextImage::operator=(const TextImage &copy)
     _text_sections.clear();
 
     _text = copy._text;
+    _source_text = copy._source_text;
+    _has_source_text = copy._has_source_text;
     _style = copy._style;
     _max_width = copy._max_width;
     for(uint32_t i = 0; i < copy._text_sections.size(); ++i)
@@ -450,6 +477,8 @@ void TextImage::Clear()
 {
     ImageDescriptor::Clear();
     _text.clear();
+    _source_text.clear();
+    _has_source_text = false;
     for(uint32_t i = 0; i < _text_sections.size(); ++i)
         delete _text_sections[i];
 
@@ -500,6 +529,8 @@ void TextImage::SetWordWrapWidth(uint32_t width)
 
 void TextImage::_Regenerate()
 {
+    PROFILE_SCOPE("TextImage::_Regenerate");
+
     _width = 0.0f;
     _height = 0.0f;
 
@@ -528,14 +559,16 @@ void TextImage::_Regenerate()
         if((*line_iter) == ustring(&NEW_LINE) || (*line_iter).empty()) {
             new_element->SetDimensions(0.0f, static_cast<float>(fp->line_skip));
         }
-        // Otherwise, create a new TextTexture to be managed by the new element
+        // Otherwise, share the identical line already rendered, or create a new TextTexture to be managed by the new element
         else {
-            // PRINT_DEBUG << **line_iter << std::endl;
-            TextTexture *texture = new TextTexture(*line_iter, _style);
-            if(texture->Regenerate() == false) {
-                IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextTexture::_Regenerate() failed" << std::endl;
+            TextTexture *texture = TextureManager->_GetSharedTextTexture(*line_iter, _style);
+            if(texture == nullptr) {
+                texture = new TextTexture(*line_iter, _style);
+                if(texture->Regenerate() == false) {
+                    IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TextTexture::_Regenerate() failed" << std::endl;
+                }
+                TextureManager->_RegisterTextTexture(texture);
             }
-            TextureManager->_RegisterTextTexture(texture);
 
             // Resize the TextImage width if this line is wider than the current width
             if(texture->width > _width)
@@ -554,30 +587,20 @@ void TextImage::_Regenerate()
 // TextSupervisor class
 // -----------------------------------------------------------------------------
 
-TextSupervisor::TextSupervisor() :
-    _text_texture(0),
-    _text_texture_width(0),
-    _text_texture_height(0)
+TextSupervisor::TextSupervisor()
 {
-    glGenTextures(1, &_text_texture);
-    if (_text_texture == 0) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to glGenTextures() failed" << std::endl;
-        assert(_text_texture != 0);
-    }
+    // Never equal to any shadow, so that the first one is set.
+    for (uint32_t i = 0; i < 8; ++i)
+        _distance_field_shadow[i] = std::numeric_limits<float>::quiet_NaN();
 }
 
 TextSupervisor::~TextSupervisor()
 {
-    // Clean up the text texture.
-    if (_text_texture != 0) {
-        GLuint textures[] = { _text_texture };
-        glDeleteTextures(1, textures);
-        _text_texture = 0;
-    }
-
     // Remove all loaded fonts.  Then, shutdown the SDL_ttf library.
     for (auto it = _font_map.begin(); it != _font_map.end(); ++it)
         delete it->second;
+    for (auto it = _distance_field_fonts.begin(); it != _distance_field_fonts.end(); ++it)
+        delete it->second;
 
     TTF_Quit();
 }
@@ -594,6 +617,9 @@ bool TextSupervisor::SingletonInitialize()
 
 bool TextSupervisor::LoadFonts(const std::string& locale_name)
 {
+    // The locale changes how the text is wrapped.
+    _text_layouts.clear();
+
     vt_script::ReadScriptDescriptor font_script;
 
     //Checking the file existence and validity.
@@ -696,7 +722,12 @@ bool TextSupervisor::LoadFonts(const std::string& locale_name)
             std::string font_file = font_script.ReadString("font");
             uint32_t font_size = font_script.ReadInt("size");
 
-            if(!_LoadFont(style_names[i], font_file, font_size)) {
+            // The fonts looking better rasterized at their size can opt out of the distance fields.
+            bool distance_field = true;
+            if (font_script.DoesBoolExist("distance_field"))
+                distance_field = font_script.ReadBool("distance_field");
+
+            if(!_LoadFont(style_names[i], font_file, font_size, distance_field)) {
                 // Check whether the default font is invalid
                 if(style_default == style_names[i]) {
                     font_script.CloseAllTables();
@@ -724,6 +755,15 @@ bool TextSupervisor::LoadFonts(const std::string& locale_name)
 
     font_script.CloseFile();
 
+    // The default text style is always used, so open it now to check it.
+    if(_GetFontProperties(style_default) == nullptr) {
+        PRINT_ERROR << "The default text style '" << style_default
+                    << "' couldn't be loaded in file: "
+                    << _font_script_filename
+                    << std::endl;
+        return false;
+    }
+
     // Setup the default font
     SetDefaultStyle(TextStyle(style_default, Color::white, VIDEO_TEXT_SHADOW_BLACK, 1, -2));
     return true;
@@ -731,7 +771,8 @@ bool TextSupervisor::LoadFonts(const std::string& locale_name)
 
 bool TextSupervisor::_LoadFont(const std::string& textstyle_name,
                                const std::string& font_filename,
-                               uint32_t font_size)
+                               uint32_t font_size,
+                               bool distance_field)
 {
     if(font_size == 0) {
         PRINT_ERROR << "Attempted to load a text style of size zero: "
@@ -740,20 +781,50 @@ bool TextSupervisor::_LoadFont(const std::string& textstyle_name,
     }
 
     // Check whether the TextStyle name is not already taken
-    bool reload = false;
     auto it = _font_map.find(textstyle_name);
     if(it != _font_map.end()) {
-        reload = true;
+        FontProperties *fp = it->second;
+        if (fp == nullptr) {
+            PRINT_ERROR << "Invalid Font Properties instance for text style: "
+                        << textstyle_name << std::endl;
+            return false;
+        }
 
         // Let's check whether the requested font is exactly the same than before
         // and do nothing in this case so we don't hurt performance.
-        FontProperties *fp = it->second;
-        if (fp && fp->font_filename == font_filename && fp->font_size == font_size)
+        if (fp->font_filename == font_filename && fp->font_size == font_size) {
+            if (fp->distance_field != distance_field) {
+                fp->distance_field = distance_field;
+                if (fp->ttf_font != nullptr)
+                    fp->distance_field_font = distance_field ? _GetDistanceFieldFont(font_filename) : nullptr;
+            }
             return true;
+        }
+
+        // The text styles already using the font point to it, so it is reloaded now.
+        fp->distance_field = distance_field;
+        if (fp->ttf_font != nullptr)
+            return _OpenFont(fp, font_filename, font_size);
+
+        fp->font_filename = font_filename;
+        fp->font_size = font_size;
+        return true;
     }
 
-    // Attempt to load the font
-    TTF_Font *font = TTF_OpenFont(font_filename.c_str(), font_size);
+    // The font will be opened on first use.
+    FontProperties* fp = new FontProperties();
+    fp->font_filename = font_filename;
+    fp->font_size = font_size;
+    fp->distance_field = distance_field;
+    _font_map[textstyle_name] = fp;
+    return true;
+}
+
+bool TextSupervisor::_OpenFont(FontProperties* font_properties, const std::string& font_filename, uint32_t font_size,
+                               bool distance_field_atlas)
+{
+    // Attempt to load the font, read from the archive memory as long as it is open when packed.
+    TTF_Font *font = TTF_OpenFontRW(vt_system::OpenAsset(font_filename), 1, font_size);
     if(font == nullptr) {
         PRINT_ERROR << "Call to TTF_OpenFont() failed to load the font file: "
                     << font_filename  << std::endl
@@ -761,32 +832,44 @@ bool TextSupervisor::_LoadFont(const std::string& textstyle_name,
         return false;
     }
 
-    // Get or Create a new FontProperties object for this font and set all of the properties according to SDL_ttf
-    FontProperties* fp = reload ? it->second : new FontProperties();
-
-    if (fp == nullptr) {
-        PRINT_ERROR << "Invalid Font Properties instance for text style: "
-                    << textstyle_name << std::endl;
-        return false;
-    }
-
     // We first clear the font before setting a new one in case of a reload.
-    if (reload)
-        fp->ClearFont();
+    // The text wrapped with the old font must be wrapped again.
+    if (font_properties->ttf_font != nullptr) {
+        font_properties->ClearFont();
+        _text_layouts.clear();
+    }
 
-    fp->ttf_font = font;
-    fp->font_filename = font_filename;
-    fp->font_size = font_size;
-    fp->height = TTF_FontHeight(font);
-    fp->line_skip = TTF_FontLineSkip(font);
-    fp->ascent = TTF_FontAscent(font);
-    fp->descent = TTF_FontDescent(font);
+    // Set all of the properties according to SDL_ttf
+    font_properties->ttf_font = font;
+    font_properties->font_filename = font_filename;
+    font_properties->font_size = font_size;
+    font_properties->height = TTF_FontHeight(font);
+    font_properties->line_skip = TTF_FontLineSkip(font);
+    font_properties->ascent = TTF_FontAscent(font);
+    font_properties->descent = TTF_FontDescent(font);
+    font_properties->glyph_atlas = new GlyphAtlas(font, distance_field_atlas);
+
+    // The font itself is then only used to measure and wrap the text.
+    if (font_properties->distance_field && !distance_field_atlas)
+        font_properties->distance_field_font = _GetDistanceFieldFont(font_filename);
+    return true;
+}
 
-    // If the text style is new, we add it to the font cache map
-    if (!reload)
-        _font_map[textstyle_name] = fp;
+FontProperties* TextSupervisor::_GetDistanceFieldFont(const std::string& font_filename)
+{
+    auto it = _distance_field_fonts.find(font_filename);
+    if (it != _distance_field_fonts.end())
+        return it->second;
+
+    FontProperties* fp = new FontProperties();
+    fp->distance_field = false;
+    if (!_OpenFont(fp, font_filename, DISTANCE_FIELD_FONT_SIZE, true)) {
+        delete fp;
+        return nullptr;
+    }
 
-    return true;
+    _distance_field_fonts[font_filename] = fp;
+    return fp;
 }
 
 void TextSupervisor::_FreeFont(const std::string &font_name)
@@ -800,6 +883,7 @@ void TextSupervisor::_FreeFont(const std::string &font_name)
 
     // Free the font and remove it from the font cache
     delete it->second;
+    _text_layouts.clear();
 
     // Remove the data from the map once freed.
     _font_map.erase(it);
@@ -807,22 +891,41 @@ void TextSupervisor::_FreeFont(const std::string &font_name)
 
 FontProperties *TextSupervisor::_GetFontProperties(const std::string &font_name)
 {
-    if(_IsFontValid(font_name) == false) {
+    auto it = _font_map.find(font_name);
+    if(it == _font_map.end()) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "argument font name was invalid: "
                                       << font_name << std::endl;
         return nullptr;
     }
 
-    return _font_map[font_name];
+    // Open the font on first use. A font that can't be opened is forgotten,
+    // as if it had never been loaded.
+    FontProperties* fp = it->second;
+    if(fp != nullptr && fp->ttf_font == nullptr) {
+        const std::string font_filename = fp->font_filename;
+        if(!_OpenFont(fp, font_filename, fp->font_size)) {
+            PRINT_WARNING << "The text style '" << font_name
+                          << "' couldn't be loaded." << std::endl;
+            delete fp;
+            _font_map.erase(it);
+            return nullptr;
+        }
+    }
+
+    return fp;
 }
 
-void TextSupervisor::Draw(const ustring &text, const TextStyle &style)
+void TextSupervisor::Draw(const ustring &text, size_t start, size_t length, const TextStyle &style)
 {
-    if (text.empty()) {
+    PROFILE_SCOPE("TextSupervisor::Draw");
+
+    if (start >= text.length() || length == 0) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "empty string was passed to function" << std::endl;
         return;
     }
 
+    const size_t text_end = (length < text.length() - start) ? start + length : text.length();
+
     FontProperties *fp = style.GetFontProperties();
     if (fp == nullptr || fp->ttf_font == nullptr) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "failed because font was invalid: " << style.GetFontName() << std::endl;
@@ -831,23 +934,22 @@ void TextSupervisor::Draw(const ustring &text, const TextStyle &style)
 
     VideoManager->PushState();
 
-    // Break the string into lines and render the shadow and text for each line
-    uint16_t buffer[2048];
-    size_t last_line = 0;
+    // Break the string into lines and render the shadow and text for each line.
+    // The lines are drawn in place, without copying them.
+    size_t last_line = start;
     do {
-        // Find the next new line character in the string and save the line
+        // Find the next new line character in the string
         size_t next_line;
-        for(next_line = last_line; next_line < text.length(); next_line++) {
+        for(next_line = last_line; next_line < text_end; next_line++) {
             if(text[next_line] == NEW_LINE)
                 break;
-
-            buffer[next_line - last_line] = text[next_line];
         }
-        buffer[next_line - last_line] = 0;
+        const uint16_t* line = text.c_str() + last_line;
+        const size_t line_length = next_line - last_line;
         last_line = next_line + 1;
 
         // If this line is empty, skip on to the next one
-        if(buffer[0] == 0) {
+        if(line_length == 0) {
             VideoManager->MoveRelative(0, -fp->line_skip * VideoManager->_current_context.coordinate_system.GetVerticalDirection());
             continue;
         }
@@ -855,13 +957,20 @@ void TextSupervisor::Draw(const ustring &text, const TextStyle &style)
         // Save the draw cursor position before drawing this text.
         VideoManager->PushMatrix();
 
+        // The distance field glyphs draw the text and its shadow at once.
+        if (fp->distance_field_font != nullptr) {
+            if (style.GetShadowStyle() != VIDEO_TEXT_SHADOW_NONE)
+                _RenderDistanceFieldText(line, line_length, fp, style.GetColor(), style.GetShadowOffsetX(), style.GetShadowOffsetY(), style.GetShadowColor());
+            else
+                _RenderDistanceFieldText(line, line_length, fp, style.GetColor(), 0.0f, 0.0f, Color::clear);
+        }
         // If text shadows are enabled...
-        if (style.GetShadowStyle() != VIDEO_TEXT_SHADOW_NONE) {
+        else if (style.GetShadowStyle() != VIDEO_TEXT_SHADOW_NONE) {
             // Draw the text with its shadow.
-            _RenderText(buffer, fp, style.GetColor(), style.GetShadowOffsetX(), style.GetShadowOffsetY(), style.GetShadowColor());
+            _RenderText(line, line_length, fp, style.GetColor(), style.GetShadowOffsetX(), style.GetShadowOffsetY(), style.GetShadowColor());
         } else {
             // Draw the text.
-            _RenderText(buffer, fp, style.GetColor());
+            _RenderText(line, line_length, fp, style.GetColor());
         }
 
         // Restore the position of the draw cursor.
@@ -870,7 +979,7 @@ void TextSupervisor::Draw(const ustring &text, const TextStyle &style)
         // Move the draw cursor one line down.
         VideoManager->MoveRelative(0, -fp->line_skip * VideoManager->_current_context.coordinate_system.GetVerticalDirection());
 
-    } while (last_line < text.length());
+    } while (last_line < text_end);
 
     VideoManager->PopState();
 }
@@ -882,6 +991,11 @@ int32_t TextSupervisor::CalculateTextWidth(TTF_Font* ttf_font, const vt_utils::u
         return -1;
     }
 
+    // Use the cached glyph metrics when the font is known.
+    GlyphAtlas* glyph_atlas = _GetGlyphAtlas(ttf_font);
+    if (glyph_atlas != nullptr)
+        return glyph_atlas->CalculateTextWidth(text.c_str(), text.length());
+
     int32_t width;
     if(TTF_SizeUNICODE(ttf_font, text.c_str(), &width, nullptr) == -1) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "Call to TTF_SizeUNICODE failed with TTF error: " << TTF_GetError() << std::endl;
@@ -891,6 +1005,20 @@ int32_t TextSupervisor::CalculateTextWidth(TTF_Font* ttf_font, const vt_utils::u
     return width;
 }
 
+void TextSupervisor::CalculateCharOffsets(TTF_Font* ttf_font, const vt_utils::ustring& text, std::vector<float>& offsets)
+{
+    // Accumulate the cached glyph metrics once when the font is known.
+    GlyphAtlas* glyph_atlas = _GetGlyphAtlas(ttf_font);
+    if (glyph_atlas != nullptr) {
+        glyph_atlas->CalculateCharOffsets(text.c_str(), text.length(), offsets);
+        return;
+    }
+
+    offsets.assign(text.length() + 1, 0.0f);
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] = static_cast<float>(CalculateTextWidth(ttf_font, text.substr(0, i)));
+}
+
 int32_t TextSupervisor::CalculateTextWidth(TTF_Font* ttf_font, const std::string &text)
 {
     if(ttf_font == nullptr) {
@@ -917,6 +1045,15 @@ std::vector<vt_utils::ustring> TextSupervisor::WrapText(const vt_utils::ustring&
         return lines_array;
     }
 
+    // Reuse the lines if the text was already wrapped the same way.
+    TextLayoutKey key;
+    key.ttf_font = ttf_font;
+    key.max_width = max_width;
+    key.text = text;
+    auto layout = _text_layouts.find(key);
+    if (layout != _text_layouts.end())
+        return layout->second;
+
     // We split the text using new lines in a first row
     ustring temp_text = text;
     uint32_t text_length = temp_text.length();
@@ -965,7 +1102,7 @@ std::vector<vt_utils::ustring> TextSupervisor::WrapText(const vt_utils::ustring&
         bool interwords_spaces = vt_system::SystemManager->GetLocaleProperty(locale).UsesInterWordsSpaces();
 
         while(!temp_line.empty()) {
-            int32_t text_width = TextManager->CalculateTextWidth(ttf_font, temp_line);
+            int32_t text_width = CalculateTextWidth(ttf_font, temp_line);
 
             // If the text can fit in the text box, add the whole line and return
             if(text_width < (int32_t)max_width) {
@@ -984,7 +1121,7 @@ std::vector<vt_utils::ustring> TextSupervisor::WrapText(const vt_utils::ustring&
                 // If we meet a space character (0x20), we can wrap the text
                 // If the current language don't have any spaces in the sentence, check all words.
                 if (!interwords_spaces || temp_line[num_wrapped_chars] == SPACE_CHAR) {
-                    int32_t text_width = TextManager->CalculateTextWidth(ttf_font, wrapped_line);
+                    int32_t text_width = CalculateTextWidth(ttf_font, wrapped_line);
 
                     if(text_width < (int32_t)max_width) {
                         // We haven't gone past the breaking point: mark this as a possible breaking point
@@ -1002,7 +1139,7 @@ std::vector<vt_utils::ustring> TextSupervisor::WrapText(const vt_utils::ustring&
             } // while (num_wrapped_chars < line_length)
 
             // Figure out the number of characters in the wrapped line and construct the wrapped line
-            text_width = TextManager->CalculateTextWidth(ttf_font, wrapped_line);
+            text_width = CalculateTextWidth(ttf_font, wrapped_line);
             if(text_width >= (int32_t)max_width && last_breakable_index != -1) {
                 num_wrapped_chars = last_breakable_index;
             }
@@ -1023,210 +1160,132 @@ std::vector<vt_utils::ustring> TextSupervisor::WrapText(const vt_utils::ustring&
         } // while (temp_line.empty() == false)
     } // for each lines of text
 
+    // Keep the wrapped lines for the next time, within bounds.
+    if (_text_layouts.size() >= TEXT_LAYOUT_CACHE_SIZE)
+        _text_layouts.clear();
+    _text_layouts[key] = wrapped_lines_array;
+
     // Returns the wrapped lines.
     return wrapped_lines_array;
 }
 
-void TextSupervisor::_RenderText(const uint16_t* text, FontProperties* font_properties, const Color& color)
+void TextSupervisor::PrepareGlyphs(const ustring& text, const TextStyle& style)
 {
-    if (text == nullptr || *text == 0) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, empty or null string" << std::endl;
-        assert(text != nullptr && *text != 0);
+    FontProperties* font_properties = style.GetFontProperties();
+    if (font_properties == nullptr || font_properties->glyph_atlas == nullptr)
         return;
+
+    // The glyphs are drawn from the distance field font when there is one.
+    GlyphAtlas* glyph_atlas = font_properties->glyph_atlas;
+    if (font_properties->distance_field_font != nullptr)
+        glyph_atlas = font_properties->distance_field_font->glyph_atlas;
+
+    // The glyphs are rasterized in the atlas on their first use.
+    for (size_t i = 0; i < text.length(); ++i) {
+        if (text[i] != NEW_LINE)
+            glyph_atlas->GetGlyph(text[i]);
     }
+}
 
-    if (font_properties == nullptr || font_properties->ttf_font == nullptr) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, nullptr font properties or nullptr ttf font" << std::endl;
-        assert(font_properties != nullptr && font_properties->ttf_font != nullptr);
-        return;
+size_t TextSupervisor::TextLayoutKeyHash::operator()(const TextLayoutKey& key) const
+{
+    // FNV-1a over the characters, mixed with the font and the width.
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < key.text.length(); ++i)
+        hash = (hash ^ key.text[i]) * 16777619u;
+
+    hash = (hash ^ key.max_width) * 16777619u;
+    return hash ^ std::hash<TTF_Font*>()(key.ttf_font);
+}
+
+GlyphAtlas* TextSupervisor::_GetGlyphAtlas(TTF_Font* ttf_font) const
+{
+    for (auto it = _font_map.begin(); it != _font_map.end(); ++it) {
+        if (it->second != nullptr && it->second->ttf_font == ttf_font)
+            return it->second->glyph_atlas;
     }
+    return nullptr;
+}
 
-    // Render the text.
-    const SDL_Color white = { 255, 255, 255, 255 };
-    SDL_Surface* surface = TTF_RenderUNICODE_Blended(font_properties->ttf_font, text, white);
-    if (surface == nullptr) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_RenderUNICODE_Blended() failed" << std::endl;
-        assert(surface != nullptr);
+void TextSupervisor::_RenderText(const uint16_t* text, size_t length, FontProperties* font_properties, const Color& color)
+{
+    if (text == nullptr || length == 0) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, empty or null string" << std::endl;
+        assert(text != nullptr && length != 0);
         return;
     }
 
-    // Retrieve the size of the text.
-    int32_t font_width = 0, font_height = 0;
-    if (TTF_SizeUNICODE(font_properties->ttf_font, text, &font_width, &font_height) != 0) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_SizeUNICODE() failed" << std::endl;
-        SDL_FreeSurface(surface);
-        assert(false);
+    if (font_properties == nullptr || font_properties->ttf_font == nullptr || font_properties->glyph_atlas == nullptr) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, nullptr font properties or nullptr ttf font" << std::endl;
+        assert(font_properties != nullptr && font_properties->ttf_font != nullptr && font_properties->glyph_atlas != nullptr);
         return;
     }
 
+    // Retrieve the size of the text.
+    const int32_t font_width = font_properties->glyph_atlas->CalculateTextWidth(text, length);
+    const int32_t font_height = font_properties->height;
+
     // Enable texturing.
     VideoManager->EnableTexture2D();
 
-    // Bind the OpenGL texture.
-    TextureManager->_BindTexture(_text_texture);
-
-    // Lock the SDL surface.
-    SDL_LockSurface(surface);
-
-    //
-    // Send the surface pixel data to OpenGL.
-    //
-
-    if (_text_texture_width == static_cast<GLuint>(surface->w) &&
-        _text_texture_height == static_cast<GLuint>(surface->h)) {
-        // The size of the old texture is the same.  Just update the pixel data.
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _text_texture_width, _text_texture_height, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
-    } else {
-        // The size of the old texture is different.  Update the storage definition as well as the pixel data.
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, surface->w, surface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
-    }
-
-    // Update the texture's width and height.
-    _text_texture_width = surface->w;
-    _text_texture_height = surface->h;
-
-    // Unlock the SDL surface.
-    SDL_UnlockSurface(surface);
-
-    // Update some of the OpenGL texture parameters.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
     // Enable blending.
     VideoManager->EnableBlending();
 
     // Update the blending function.
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Push the matrix stack.
     VideoManager->PushMatrix();
 
     // Update the transmation matrix.
     CoordSys& coordinate_system = VideoManager->_current_context.coordinate_system;
-    float x_offset = ((VideoManager->_current_context.x_align + 1) * font_width) * 0.5f * -coordinate_system.GetHorizontalDirection();
-    float y_offset = ((VideoManager->_current_context.y_align + 1) * font_height) * 0.5f * -coordinate_system.GetVerticalDirection();
+    float x_offset = ((VideoManager->_current_context.draw_state.GetXAlign() + 1) * font_width) * 0.5f * -coordinate_system.GetHorizontalDirection();
+    float y_offset = ((VideoManager->_current_context.draw_state.GetYAlign() + 1) * font_height) * 0.5f * -coordinate_system.GetVerticalDirection();
     VideoManager->MoveRelative(x_offset, y_offset);
 
     // Load the shader program.
     gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Sprite);
     assert(shader_program != nullptr);
 
-    // The vertex positions.
-    float vertex_positions[] =
-    {
-        0.0f,                           0.0f,                            0.0f, // Vertex One.
-        static_cast<float>(font_width), 0.0f,                            0.0f, // Vertex Two.
-        static_cast<float>(font_width), static_cast<float>(font_height), 0.0f, // Vertex Three.
-        0.0f,                           static_cast<float>(font_height), 0.0f  // Vertex Four.
-    };
-
-    // The vertex texture coordinates.
-    float vertex_texture_coordinates[] =
-    {
-        0.0f, 0.0f, // Vertex One.
-        1.0f, 0.0f, // Vertex Two.
-        1.0f, 1.0f, // Vertex Three.
-        0.0f, 1.0f  // Vertex Four.
-    };
-
-    // The vertex colors.
-    float vertex_colors[] =
-    {
-        1.0f, 1.0f, 1.0f, 1.0f, // Vertex One.
-        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Two.
-        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Three.
-        1.0f, 1.0f, 1.0f, 1.0f  // Vertex Four.
-    };
-
     // Draw the text.
-    VideoManager->DrawSprite(shader_program, vertex_positions, vertex_texture_coordinates, vertex_colors, color);
+    _DrawGlyphs(text, length, font_properties, shader_program, color);
 
     // Unload the shader program.
     VideoManager->UnloadShaderProgram();
 
     // Restore the transformation stack.
     VideoManager->PopMatrix();
-
-    // Clean up.
-    if (surface != nullptr) {
-        SDL_FreeSurface(surface);
-        surface = nullptr;
-    }
 }
 
-void TextSupervisor::_RenderText(const uint16_t* text, FontProperties* font_properties,
+void TextSupervisor::_RenderText(const uint16_t* text, size_t length, FontProperties* font_properties,
                                  const Color& color,
                                  float shadow_offset_x, float shadow_offset_y,
                                  const Color& color_shadow)
 {
-    if (text == nullptr || *text == 0) {
+    if (text == nullptr || length == 0) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, empty or null string" << std::endl;
-        assert(text != nullptr && *text != 0);
+        assert(text != nullptr && length != 0);
         return;
     }
 
-    if (font_properties == nullptr || font_properties->ttf_font == nullptr) {
+    if (font_properties == nullptr || font_properties->ttf_font == nullptr || font_properties->glyph_atlas == nullptr) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, nullptr font properties or nullptr ttf font" << std::endl;
-        assert(font_properties != nullptr && font_properties->ttf_font != nullptr);
-        return;
-    }
-
-    // Render the text.
-    const SDL_Color white = { 255, 255, 255, 255 };
-    SDL_Surface* surface = TTF_RenderUNICODE_Blended(font_properties->ttf_font, text, white);
-    if (surface == nullptr) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_RenderUNICODE_Blended() failed" << std::endl;
-        assert(surface != nullptr);
+        assert(font_properties != nullptr && font_properties->ttf_font != nullptr && font_properties->glyph_atlas != nullptr);
         return;
     }
 
     // Retrieve the size of the text.
-    int32_t font_width = 0, font_height = 0;
-    if (TTF_SizeUNICODE(font_properties->ttf_font, text, &font_width, &font_height) != 0) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TTF_SizeUNICODE() failed" << std::endl;
-        SDL_FreeSurface(surface);
-        assert(false);
-        return;
-    }
+    const int32_t font_width = font_properties->glyph_atlas->CalculateTextWidth(text, length);
+    const int32_t font_height = font_properties->height;
 
     // Enable texturing.
     VideoManager->EnableTexture2D();
 
-    // Bind the OpenGL texture.
-    TextureManager->_BindTexture(_text_texture);
-
-    // Lock the SDL surface.
-    SDL_LockSurface(surface);
-
-    //
-    // Send the surface pixel data to OpenGL.
-    //
-
-    if (_text_texture_width == static_cast<GLuint>(surface->w) &&
-        _text_texture_height == static_cast<GLuint>(surface->h)) {
-        // The size of the old texture is the same.  Just update the pixel data.
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _text_texture_width, _text_texture_height, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
-    } else {
-        // The size of the old texture is different.  Update the storage definition as well as the pixel data.
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, surface->w, surface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
-    }
-
-    // Update the texture's width and height.
-    _text_texture_width = surface->w;
-    _text_texture_height = surface->h;
-
-    // Unlock the SDL surface.
-    SDL_UnlockSurface(surface);
-
-    // Update some of the OpenGL texture parameters.
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
     // Enable blending.
     VideoManager->EnableBlending();
 
     // Update the blending function.
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     //
     // Draw the shadow first.
@@ -1242,43 +1301,16 @@ void TextSupervisor::_RenderText(const uint16_t* text, FontProperties* font_prop
 
     // Update the transmation matrix.
     CoordSys& coordinate_system = VideoManager->_current_context.coordinate_system;
-    float x_offset = ((VideoManager->_current_context.x_align + 1) * font_width) * 0.5f * -coordinate_system.GetHorizontalDirection();
-    float y_offset = ((VideoManager->_current_context.y_align + 1) * font_height) * 0.5f * -coordinate_system.GetVerticalDirection();
+    float x_offset = ((VideoManager->_current_context.draw_state.GetXAlign() + 1) * font_width) * 0.5f * -coordinate_system.GetHorizontalDirection();
+    float y_offset = ((VideoManager->_current_context.draw_state.GetYAlign() + 1) * font_height) * 0.5f * -coordinate_system.GetVerticalDirection();
     VideoManager->MoveRelative(x_offset, y_offset);
 
     // Load the shader program.
     gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Sprite);
     assert(shader_program != nullptr);
 
-    // The vertex positions.
-    float vertex_positions[] =
-    {
-        0.0f,                           0.0f,                            0.0f, // Vertex One.
-        static_cast<float>(font_width), 0.0f,                            0.0f, // Vertex Two.
-        static_cast<float>(font_width), static_cast<float>(font_height), 0.0f, // Vertex Three.
-        0.0f,                           static_cast<float>(font_height), 0.0f  // Vertex Four.
-    };
-
-    // The vertex texture coordinates.
-    float vertex_texture_coordinates[] =
-    {
-        0.0f, 0.0f, // Vertex One.
-        1.0f, 0.0f, // Vertex Two.
-        1.0f, 1.0f, // Vertex Three.
-        0.0f, 1.0f  // Vertex Four.
-    };
-
-    // The vertex colors.
-    float vertex_colors[] =
-    {
-        1.0f, 1.0f, 1.0f, 1.0f, // Vertex One.
-        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Two.
-        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Three.
-        1.0f, 1.0f, 1.0f, 1.0f  // Vertex Four.
-    };
-
     // Draw the shadow.
-    VideoManager->DrawSprite(shader_program, vertex_positions, vertex_texture_coordinates, vertex_colors, color_shadow);
+    _DrawGlyphs(text, length, font_properties, shader_program, color_shadow);
 
     // Restore the transformation stack.
     VideoManager->PopMatrix();
@@ -1294,18 +1326,203 @@ void TextSupervisor::_RenderText(const uint16_t* text, FontProperties* font_prop
     VideoManager->MoveRelative(x_offset, y_offset);
 
     // Draw the text.
-    VideoManager->DrawSprite(shader_program, vertex_positions, vertex_texture_coordinates, vertex_colors, color);
+    _DrawGlyphs(text, length, font_properties, shader_program, color);
 
     // Unload the shader program.
     VideoManager->UnloadShaderProgram();
 
     // Restore the transformation stack.
     VideoManager->PopMatrix();
+}
 
-    // Clean up.
-    if (surface != nullptr) {
-        SDL_FreeSurface(surface);
-        surface = nullptr;
+void TextSupervisor::_RenderDistanceFieldText(const uint16_t* text, size_t length, FontProperties* font_properties,
+                                              const Color& color,
+                                              float shadow_offset_x, float shadow_offset_y,
+                                              const Color& color_shadow)
+{
+    if (text == nullptr || length == 0) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, empty or null string" << std::endl;
+        assert(text != nullptr && length != 0);
+        return;
+    }
+
+    if (font_properties == nullptr || font_properties->glyph_atlas == nullptr || font_properties->distance_field_font == nullptr) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "invalid argument, nullptr font properties or no distance field font" << std::endl;
+        assert(font_properties != nullptr && font_properties->glyph_atlas != nullptr && font_properties->distance_field_font != nullptr);
+        return;
+    }
+
+    // The layout comes from the font of the text style, the glyphs from the distance field font.
+    GlyphAtlas* glyph_atlas = font_properties->glyph_atlas;
+    FontProperties* distance_field_font = font_properties->distance_field_font;
+    GlyphAtlas* distance_field_atlas = distance_field_font->glyph_atlas;
+
+    // The size of a distance field texel on screen.
+    const float scale = static_cast<float>(font_properties->font_size) / DISTANCE_FIELD_FONT_SIZE;
+
+    // Retrieve the size of the text.
+    const int32_t font_width = glyph_atlas->CalculateTextWidth(text, length);
+    const int32_t font_height = font_properties->height;
+
+    // Enable texturing.
+    VideoManager->EnableTexture2D();
+
+    // Enable blending.
+    VideoManager->EnableBlending();
+
+    // Update the blending function.
+    VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Push the matrix stack.
+    VideoManager->PushMatrix();
+
+    // Update the transmation matrix.
+    CoordSys& coordinate_system = VideoManager->_current_context.coordinate_system;
+    float x_offset = ((VideoManager->_current_context.draw_state.GetXAlign() + 1) * font_width) * 0.5f * -coordinate_system.GetHorizontalDirection();
+    float y_offset = ((VideoManager->_current_context.draw_state.GetYAlign() + 1) * font_height) * 0.5f * -coordinate_system.GetVerticalDirection();
+    VideoManager->MoveRelative(x_offset, y_offset);
+
+    // Load the shader program.
+    gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::TextDistanceField);
+    assert(shader_program != nullptr);
+
+    // The shadow offset in texels, limited to the room left around the glyphs.
+    const float max_offset = static_cast<float>(DISTANCE_FIELD_BORDER - DISTANCE_FIELD_SPREAD);
+    const float offset_x = coordinate_system.GetHorizontalDirection() * shadow_offset_x / scale;
+    const float offset_y = coordinate_system.GetVerticalDirection() * shadow_offset_y / scale;
+    const float* shadow_colors = color_shadow.GetColors();
+    const float shadow[8] = {
+        std::max(-max_offset, std::min(offset_x, max_offset)) / GLYPH_ATLAS_PAGE_SIZE,
+        std::max(-max_offset, std::min(offset_y, max_offset)) / GLYPH_ATLAS_PAGE_SIZE,
+        0.0f, 0.0f,
+        shadow_colors[0], shadow_colors[1], shadow_colors[2], shadow_colors[3]
+    };
+
+    // The queued lines are drawn with their own shadow first.
+    if (!std::equal(shadow, shadow + 8, _distance_field_shadow)) {
+        VideoManager->FlushSpriteBatch();
+        shader_program->UpdateUniform("u_ShadowOffset", shadow, 4);
+        shader_program->UpdateUniform("u_ShadowColor", shadow + 4, 4);
+        std::copy(shadow, shadow + 8, _distance_field_shadow);
+    }
+
+    // The vertex colors.
+    float vertex_colors[] =
+    {
+        1.0f, 1.0f, 1.0f, 1.0f, // Vertex One.
+        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Two.
+        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Three.
+        1.0f, 1.0f, 1.0f, 1.0f  // Vertex Four.
+    };
+
+    // The distance field glyphs are placed on the baseline of the text style font.
+    const float baseline = static_cast<float>(font_properties->ascent);
+    const float glyph_baseline = static_cast<float>(distance_field_font->ascent);
+
+    int32_t pen_x = 0;
+    for (const uint16_t* character = text; character != text + length; ++character) {
+        const GlyphMetrics* metrics = glyph_atlas->GetGlyphMetrics(*character);
+        if (metrics == nullptr)
+            continue;
+
+        if (character != text)
+            pen_x += glyph_atlas->GetKerning(*(character - 1), *character);
+
+        const Glyph* glyph = distance_field_atlas->GetGlyph(*character);
+        if (glyph != nullptr && glyph->texture_id != 0) {
+            TextureManager->_BindTexture(glyph->texture_id);
+
+            const float left = static_cast<float>(pen_x) + glyph->offset_x * scale;
+            const float right = left + glyph->width * scale;
+            const float top = baseline - (glyph_baseline - glyph->offset_y) * scale;
+            const float bottom = top + glyph->height * scale;
+
+            // The vertex positions.
+            float vertex_positions[] =
+            {
+                left,  top,    0.0f, // Vertex One.
+                right, top,    0.0f, // Vertex Two.
+                right, bottom, 0.0f, // Vertex Three.
+                left,  bottom, 0.0f  // Vertex Four.
+            };
+
+            // The vertex texture coordinates.
+            float vertex_texture_coordinates[] =
+            {
+                glyph->u1, glyph->v1, // Vertex One.
+                glyph->u2, glyph->v1, // Vertex Two.
+                glyph->u2, glyph->v2, // Vertex Three.
+                glyph->u1, glyph->v2  // Vertex Four.
+            };
+
+            VideoManager->DrawSprite(shader_program, vertex_positions, vertex_texture_coordinates, vertex_colors, color);
+        }
+
+        pen_x += metrics->advance;
+    }
+
+    // Unload the shader program.
+    VideoManager->UnloadShaderProgram();
+
+    // Restore the transformation stack.
+    VideoManager->PopMatrix();
+}
+
+void TextSupervisor::_DrawGlyphs(const uint16_t* text, size_t length, FontProperties* font_properties,
+                                 gl::ShaderProgram* shader_program, const Color& color)
+{
+    GlyphAtlas* glyph_atlas = font_properties->glyph_atlas;
+    assert(glyph_atlas != nullptr);
+
+    // The vertex colors.
+    float vertex_colors[] =
+    {
+        1.0f, 1.0f, 1.0f, 1.0f, // Vertex One.
+        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Two.
+        1.0f, 1.0f, 1.0f, 1.0f, // Vertex Three.
+        1.0f, 1.0f, 1.0f, 1.0f  // Vertex Four.
+    };
+
+    // Queue one quad per glyph. Consecutive glyphs share the same atlas page,
+    // so the whole line ends up in the same sprite batch.
+    int32_t pen_x = 0;
+    for (const uint16_t* character = text; character != text + length; ++character) {
+        const Glyph* glyph = glyph_atlas->GetGlyph(*character);
+        if (glyph == nullptr)
+            continue;
+
+        if (character != text)
+            pen_x += glyph_atlas->GetKerning(*(character - 1), *character);
+
+        if (glyph->texture_id != 0) {
+            TextureManager->_BindTexture(glyph->texture_id);
+
+            const float left = static_cast<float>(pen_x + glyph->offset_x);
+            const float right = left + static_cast<float>(glyph->width);
+            const float bottom = static_cast<float>(glyph->height);
+
+            // The vertex positions.
+            float vertex_positions[] =
+            {
+                left,  0.0f,   0.0f, // Vertex One.
+                right, 0.0f,   0.0f, // Vertex Two.
+                right, bottom, 0.0f, // Vertex Three.
+                left,  bottom, 0.0f  // Vertex Four.
+            };
+
+            // The vertex texture coordinates.
+            float vertex_texture_coordinates[] =
+            {
+                glyph->u1, glyph->v1, // Vertex One.
+                glyph->u2, glyph->v1, // Vertex Two.
+                glyph->u2, glyph->v2, // Vertex Three.
+                glyph->u1, glyph->v2  // Vertex Four.
+            };
+
+            VideoManager->DrawSprite(shader_program, vertex_positions, vertex_texture_coordinates, vertex_colors, color);
+        }
+
+        pen_x += glyph->advance;
     }
 }
 
@@ -27,6 +27,7 @@
 #include "utils/ustring.h"
 
 #include <map>
+#include <unordered_map>
 
 typedef struct _TTF_Font TTF_Font;
 
@@ -35,6 +36,14 @@ namespace vt_video
 
 class TextSupervisor;
 
+namespace gl {
+class ShaderProgram;
+}
+
+namespace private_video {
+class GlyphAtlas;
+}
+
 //! \brief The singleton pointer for the instance of the text supervisor
 extern TextSupervisor *TextManager;
 
@@ -91,6 +100,18 @@ public:
     //! \brief Used to know the font size currently used.
     uint32_t font_size;
 
+    //! \brief The glyphs of the font already rasterized, used to draw text directly.
+    private_video::GlyphAtlas* glyph_atlas;
+
+    //! \brief Whether the text is drawn from the distance field glyphs of the font file.
+    bool distance_field;
+
+    /** \brief The font file opened at DISTANCE_FIELD_FONT_SIZE, whose glyph atlas
+    *** stores distance fields, or nullptr when not drawing with them.
+    *** It is shared by the text styles of the font file, and owned by the TextSupervisor.
+    **/
+    FontProperties* distance_field_font;
+
 private:
     //! \brief The copy constructor and assignment operator are hidden by design
     //! to cause compilation errors when attempting to copy or assign this class.
@@ -405,6 +426,8 @@ public:
 
     //! \brief Sets the text contained
     void SetText(const vt_utils::ustring& text) {
+        _has_source_text = false;
+
         // Don't do anything if it's the same text
         if (_text == text)
             return;
@@ -414,14 +437,22 @@ public:
     }
 
     void SetText(const vt_utils::ustring& text, const TextStyle& text_style) {
+        _has_source_text = false;
         _text = text;
         _style = text_style;
         _Regenerate();
     }
 
-    //! \brief Sets the text (std::string version)
+    /** \brief Sets the text (std::string version)
+    *** The labels set again with the same text every frame aren't converted again.
+    **/
     void SetText(const std::string& text) {
+        if (_has_source_text && _source_text == text)
+            return;
+
         SetText(vt_utils::MakeUnicodeString(text));
+        _source_text = text;
+        _has_source_text = true;
     }
 
     //! \brief Sets the texts style - regenerating text if present.
@@ -432,6 +463,8 @@ public:
 
     void SetText(const std::string& text, const TextStyle& text_style) {
         SetText(vt_utils::MakeUnicodeString(text), text_style);
+        _source_text = text;
+        _has_source_text = true;
     }
 
     //! \brief Set the maximum permitted width to the text image
@@ -461,6 +494,10 @@ private:
     //! \brief The unicode string of the text to render
     vt_utils::ustring _text;
 
+    //! \brief The UTF-8 text _text was converted from, when set as such.
+    std::string _source_text;
+    bool _has_source_text;
+
     //! \brief The style to render the text in
     TextStyle _style;
 
@@ -535,7 +572,17 @@ public:
     *** \param text The text string to draw in unicode format
     *** \param style A reference to the TextStyle to use for drawing the string
     **/
-    void Draw(const vt_utils::ustring &text, const TextStyle &style);
+    inline void Draw(const vt_utils::ustring &text, const TextStyle &style) {
+        Draw(text, 0, text.length(), style);
+    }
+
+    /** \brief Draws a part of a unicode string of text, without copying it
+    *** \param text The text string to draw a part of
+    *** \param start The index of the first character to draw
+    *** \param length The number of characters to draw, clamped to the end of the string
+    *** \param style A reference to the TextStyle to use for drawing the string
+    **/
+    void Draw(const vt_utils::ustring &text, size_t start, size_t length, const TextStyle &style);
 
     /** \brief Renders and draws a standard string of text to the screen in the default text style
     *** \param text The text string to draw in standard format
@@ -566,11 +613,25 @@ public:
     **/
     int32_t CalculateTextWidth(TTF_Font* ttf_font, const std::string& text);
 
+    /** \brief Calculates the rendered width of every prefix of a unicode string
+    *** \param ttf_font The True Type SDL font object
+    *** \param text The text string in unicode format
+    *** \param offsets Filled with text.length() + 1 values, offsets[i] being the width of the i first characters
+    **/
+    void CalculateCharOffsets(TTF_Font* ttf_font, const vt_utils::ustring& text, std::vector<float>& offsets);
+
     /** \brief Returns the text as a vector of lines which text width is inferior or equal to the given pixel max width.
     *** \param text The ustring text
     *** \param ttf_font The True Type SDL font object
+    *** \note The result is cached until the fonts are reloaded.
     **/
     std::vector<vt_utils::ustring> WrapText(const vt_utils::ustring& text, TTF_Font* ttf_font, uint32_t max_width);
+
+    /** \brief Rasterizes the glyphs of a text ahead of time, so that drawing it later doesn't stall.
+    *** \param text The text to draw later on
+    *** \param style The text style it will be drawn with
+    **/
+    void PrepareGlyphs(const vt_utils::ustring& text, const TextStyle& style);
     //@}
 
     //! \name Class member access methods
@@ -589,15 +650,6 @@ private:
 
     // ---------- Private members
 
-    //! \brief A texture used to draw text to the screen.
-    GLuint _text_texture;
-
-    //! \brief The text texture's width.
-    GLuint _text_texture_width;
-
-    //! \brief The text texture's height.
-    GLuint _text_texture_height;
-
     //! \brief The default text style
     TextStyle _default_style;
 
@@ -606,13 +658,61 @@ private:
     **/
     std::map<std::string, FontProperties *> _font_map;
 
-    /** \brief Loads or Reloads a font file from disk with a specific size and name
+    //! \brief Identifies a text wrapped by WrapText().
+    class TextLayoutKey
+    {
+    public:
+        TTF_Font* ttf_font;
+        uint32_t max_width;
+        vt_utils::ustring text;
+
+        bool operator==(const TextLayoutKey& key) const {
+            return ttf_font == key.ttf_font && max_width == key.max_width && text == key.text;
+        }
+    };
+
+    class TextLayoutKeyHash
+    {
+    public:
+        size_t operator()(const TextLayoutKey& key) const;
+    };
+
+    /** \brief The fonts whose glyph atlases store distance fields, by font filename.
+    *** A single one per font file is enough for every text style using it.
+    **/
+    std::map<std::string, FontProperties *> _distance_field_fonts;
+
+    //! \brief The shadow uniforms last set in the distance field text program,
+    //! so that the lines drawn with the same ones stay in the same sprite batch.
+    float _distance_field_shadow[8];
+
+    //! \brief The lines of the texts already wrapped, so that menus and dialogues don't wrap them again.
+    std::unordered_map<TextLayoutKey, std::vector<vt_utils::ustring>, TextLayoutKeyHash> _text_layouts;
+
+    /** \brief Declares or changes the font file and size of a text style
     *** \param Text style name The name which to refer to the text style after it is loaded
     *** \param font_filename The filename of the TTF font filename to load
     *** \param size The point size to set the font after it is loaded
-    *** \return True if the font was successfully loaded, or false if there was an error
+    *** \param distance_field Whether the text is drawn from the distance field glyphs of the font file
+    *** \return True if the font was successfully set, or false if there was an error
+    ***
+    *** The font is only opened once the text style is used, by _GetFontProperties().
+    *** A text style already used is reloaded right away, since text styles point to it.
+    **/
+    bool _LoadFont(const std::string& textstyle_name, const std::string& font_filename, uint32_t size,
+                   bool distance_field);
+
+    /** \brief Opens a font file, and sets it in the given font properties
+    *** \param distance_field_atlas Whether the glyph atlas of the font stores distance fields.
+    *** \return False if the font couldn't be opened. The font properties are left untouched then.
     **/
-    bool _LoadFont(const std::string& textstyle_name, const std::string& font_filename, uint32_t size);
+    bool _OpenFont(FontProperties* font_properties, const std::string& font_filename, uint32_t font_size,
+                   bool distance_field_atlas = false);
+
+    /** \brief Returns the distance field font of a font file, opening it on first use.
+    *** \return nullptr if the font file couldn't be opened.
+    **/
+    FontProperties* _GetDistanceFieldFont(const std::string& font_filename);
 
     /** \brief Removes a loaded font from memory and frees up associated resources
     *** \param font_name The reference name of the font to unload
@@ -623,16 +723,18 @@ private:
     void _FreeFont(const std::string &font_name);
 
     /** \brief Renders a unicode string to the screen.
-    *** \param text A pointer to a unicode string to draw.
+    *** \param text A pointer to a unicode string to draw, not necessarily null-terminated.
+    *** \param length The number of characters to draw.
     *** \param font_properties A pointer to the properties of the font to use in drawing the text.
     *** \param color The color to render the text in.
     ***
     *** This method is intended for drawing only a single line of text.
     **/
-    void _RenderText(const uint16_t* text, FontProperties* font_properties, const Color& color);
+    void _RenderText(const uint16_t* text, size_t length, FontProperties* font_properties, const Color& color);
 
     /** \brief Renders a unicode, shadowed string to the screen.
-    *** \param text A pointer to a unicode string to draw.
+    *** \param text A pointer to a unicode string to draw, not necessarily null-terminated.
+    *** \param length The number of characters to draw.
     *** \param font_properties A pointer to the properties of the font to use in drawing the text.
     *** \param color The color to render the text in.
     *** \param shadow_offset_x The X offset for the text's shadow.
@@ -641,11 +743,39 @@ private:
     ***
     *** This method is intended for drawing only a single line of text.
     **/
-    void _RenderText(const uint16_t* text, FontProperties* font_properties,
+    void _RenderText(const uint16_t* text, size_t length, FontProperties* font_properties,
                      const Color& color,
                      float shadow_offset_x, float shadow_offset_y,
                      const Color& color_shadow);
 
+    /** \brief Renders a unicode string, and its shadow if any, from the distance field glyphs.
+    *** \param text A pointer to a unicode string to draw, not necessarily null-terminated.
+    *** \param length The number of characters to draw.
+    *** \param font_properties A pointer to the properties of the font to use in drawing the text.
+    *** It must have a distance field font.
+    *** \param color The color to render the text in.
+    *** \param shadow_offset_x The X offset for the text's shadow.
+    *** \param shadow_offset_y The Y offset for the text's shadow.
+    *** \param color_shadow The color to render the text's shadow in, clear for no shadow.
+    ***
+    *** Each glyph and its shadow are drawn with a single quad, sized for the text style.
+    *** This method is intended for drawing only a single line of text.
+    **/
+    void _RenderDistanceFieldText(const uint16_t* text, size_t length, FontProperties* font_properties,
+                                  const Color& color,
+                                  float shadow_offset_x, float shadow_offset_y,
+                                  const Color& color_shadow);
+
+    /** \brief Queues the glyphs of a unicode string, starting at the current draw position.
+    *** \param text A pointer to a unicode string to draw, not necessarily null-terminated.
+    *** \param length The number of characters to draw.
+    *** \param font_properties A pointer to the properties of the font to use in drawing the text.
+    *** \param shader_program The shader program to draw the glyphs with.
+    *** \param color The color to render the text in.
+    **/
+    void _DrawGlyphs(const uint16_t* text, size_t length, FontProperties* font_properties,
+                     gl::ShaderProgram* shader_program, const Color& color);
+
     /** \brief Renders a unicode string to a pixel array.
     *** \param text The unicdoe string to render.
     *** \param style The text style to render the string in.
@@ -662,6 +792,12 @@ private:
         return (_font_map.find(font_name) != _font_map.end());
     }
 
+    /** \brief Get the glyph atlas of a loaded font
+    *** \param ttf_font The True Type SDL font object
+    *** \return The glyph atlas, or nullptr if the font isn't one of the loaded fonts
+    **/
+    private_video::GlyphAtlas* _GetGlyphAtlas(TTF_Font* ttf_font) const;
+
     /** \brief Get the font properties for a loaded font
     *** \param font_name The name reference of the loaded font
     *** \return A pointer to the FontProperties object with the requested data, or nullptr if the properties could not be fetched
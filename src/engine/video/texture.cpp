@@ -19,9 +19,13 @@
 
 #include "video.h"
 
+#include "engine/memory_stats.h"
+
 #include "utils/utils_common.h"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace vt_utils;
 
@@ -42,15 +46,26 @@ TexSheet::TexSheet(uint32_t sheet_width, uint32_t sheet_height, GLuint sheet_id,
     type(sheet_type),
     is_static(sheet_static),
     smoothed(false),
-    loaded(true)
+    mipmapped(false),
+    loaded(true),
+    last_used_frame(0),
+    _evicted_image(nullptr),
+    _mipmaps_outdated(false)
 {
+    if (tex_id != INVALID_TEXTURE_ID)
+        vt_system::MemoryStats::Add(vt_system::MEMORY_TEXTURES_GPU, GetMemorySize());
+
     Smooth();
 }
 
 TexSheet::~TexSheet()
 {
     // Unload the OpenGL texture from memory.
+    if (tex_id != INVALID_TEXTURE_ID)
+        vt_system::MemoryStats::Remove(vt_system::MEMORY_TEXTURES_GPU, GetMemorySize());
     TextureManager->_DeleteTexture(tex_id);
+
+    delete _evicted_image;
 }
 
 bool TexSheet::Unload()
@@ -61,6 +76,7 @@ bool TexSheet::Unload()
     }
 
     TextureManager->_DeleteTexture(tex_id);
+    vt_system::MemoryStats::Remove(vt_system::MEMORY_TEXTURES_GPU, GetMemorySize());
     tex_id = INVALID_TEXTURE_ID;
     loaded = false;
     return true;
@@ -83,14 +99,29 @@ bool TexSheet::Reload()
     }
 
     tex_id = id;
+    vt_system::MemoryStats::Add(vt_system::MEMORY_TEXTURES_GPU, GetMemorySize());
+
+    // Take the evicted pixels first, so that binding the sheet doesn't try to restore it again.
+    ImageMemory *evicted_image = _evicted_image;
+    _evicted_image = nullptr;
+
+    // Restore the texture filtering, and the mipmaps once the pixels are back.
+    TextureManager->_BindTexSheet(this);
+    _ApplyFiltering();
+    _mipmaps_outdated = mipmapped;
 
-    // Restore texture smoothing if applied.
-    bool was_smoothed = smoothed;
-    smoothed = false;
-    Smooth(was_smoothed);
+    // Upload back the evicted pixels at once
+    if(evicted_image != nullptr) {
+        bool success = CopyRect(0, 0, *evicted_image);
+        delete evicted_image;
 
+        if(success == false) {
+            PRINT_ERROR << "call to TexSheet::CopyRect() failed" << std::endl;
+            return false;
+        }
+    }
     // Reload all of the images that belong to this texture
-    if(TextureManager->_ReloadImagesToSheet(this) == false) {
+    else if(TextureManager->_ReloadImagesToSheet(this) == false) {
         PRINT_ERROR << "call to TextureController::_ReloadImagesToSheet() failed" << std::endl;
         return false;
     }
@@ -99,11 +130,41 @@ bool TexSheet::Reload()
     return true;
 }
 
+bool TexSheet::Evict()
+{
+    if (loaded == false) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "attempted to evict an unloaded texture sheet" << std::endl;
+        return false;
+    }
+
+    ImageMemory *evicted_image = new ImageMemory();
+    try {
+        evicted_image->CopyFromTexture(this);
+    }
+    catch(std::exception &e) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to allocate the memory to evict a texture sheet" << std::endl;
+        delete evicted_image;
+        return false;
+    }
+
+    if(Unload() == false) {
+        delete evicted_image;
+        return false;
+    }
+
+    _evicted_image = evicted_image;
+    return true;
+}
+
 bool TexSheet::CopyRect(int32_t x, int32_t y, ImageMemory& data)
 {
-    TextureManager->_BindTexture(tex_id);
+    // The sheet might still be used by queued sprites.
+    VideoManager->FlushSpriteBatch();
+
+    TextureManager->_BindTexSheet(this);
 
     data.GlTexSubImage(x, y);
+    _mipmaps_outdated = mipmapped;
 
     if(VideoManager->CheckGLError()) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occured: " << VideoManager->CreateGLErrorString() << std::endl;
@@ -115,7 +176,10 @@ bool TexSheet::CopyRect(int32_t x, int32_t y, ImageMemory& data)
 
 bool TexSheet::CopyScreenRect(int32_t x, int32_t y, const ScreenRect &screen_rect)
 {
-    TextureManager->_BindTexture(tex_id);
+    // Draw the queued sprites before copying the screen.
+    VideoManager->FlushSpriteBatch();
+
+    TextureManager->_BindTexSheet(this);
 
     glCopyTexSubImage2D(
         GL_TEXTURE_2D, // target
@@ -127,6 +191,7 @@ bool TexSheet::CopyScreenRect(int32_t x, int32_t y, const ScreenRect &screen_rec
         screen_rect.width, // width in pixels of image
         screen_rect.height // height in pixels of image
     );
+    _mipmaps_outdated = mipmapped;
 
     if(VideoManager->CheckGLError()) {
         IF_PRINT_WARNING(VIDEO_DEBUG) << "an OpenGL error occured: " << VideoManager->CreateGLErrorString() << std::endl;
@@ -140,13 +205,50 @@ void TexSheet::Smooth(bool flag)
 {
     // If setting has changed, set the appropriate filtering
     if(smoothed != flag) {
+        // The filtering applies to the queued sprites as well.
+        VideoManager->FlushSpriteBatch();
+
         smoothed = flag;
-        GLenum filtering_type = smoothed ? GL_LINEAR : GL_NEAREST;
+        TextureManager->_BindTexSheet(this);
+        _ApplyFiltering();
+    }
+}
+
+void TexSheet::EnableMipmaps()
+{
+    if(mipmapped || !loaded || _GetMipmapMaxLevel() == 0)
+        return;
+
+    // The filtering applies to the queued sprites as well.
+    VideoManager->FlushSpriteBatch();
 
-        TextureManager->_BindTexture(tex_id);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filtering_type);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filtering_type);
+    const uint32_t memory_size = GetMemorySize();
+    mipmapped = true;
+    vt_system::MemoryStats::Add(vt_system::MEMORY_TEXTURES_GPU, GetMemorySize() - memory_size);
+
+    TextureManager->_BindTexSheet(this);
+    _GenerateMipmaps();
+    _ApplyFiltering();
+}
+
+void TexSheet::_GenerateMipmaps()
+{
+    _mipmaps_outdated = false;
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void TexSheet::_ApplyFiltering()
+{
+    // The nearest filtering keeps the pixel art sharp, so it never samples the mipmaps.
+    GLenum min_filtering_type = smoothed ? GL_LINEAR : GL_NEAREST;
+    if(mipmapped) {
+        if(smoothed)
+            min_filtering_type = GL_LINEAR_MIPMAP_LINEAR;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _GetMipmapMaxLevel());
     }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filtering_type);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, smoothed ? GL_LINEAR : GL_NEAREST);
 }
 
 void TexSheet::DEBUG_Draw() const
@@ -433,27 +535,32 @@ FixedTexNode *FixedTexSheet::_RemoveOpenNode()
     return node;
 }
 
+int32_t FixedTexSheet::_GetMipmapMaxLevel() const
+{
+    int32_t level = 0;
+    while(level < 16 && ((_texture_width | _texture_height) & (1 << level)) == 0)
+        ++level;
+    return level;
+}
+
 // -----------------------------------------------------------------------------
 // VariableTexSheet class
 // -----------------------------------------------------------------------------
 
 VariableTexSheet::VariableTexSheet(int32_t sheet_width, int32_t sheet_height, GLuint sheet_id, TexSheetType sheet_type, bool sheet_static) :
-    TexSheet(sheet_width, sheet_height, sheet_id, sheet_type, sheet_static)
+    TexSheet(sheet_width, sheet_height, sheet_id, sheet_type, sheet_static),
+    _merged_free_rects(false),
+    _tight_layout(false)
 {
-    _block_width = width / 16;
-    _block_height = height / 16;
-    _blocks = new VariableTexNode[_block_width * _block_height];
+    _block_width = 0;
+    _block_height = 0;
+    _free_rects.push_back(TexRect(0, 0, width, height));
 }
 
 VariableTexSheet::~VariableTexSheet()
 {
     if (GetNumberTextures() != 0)
         IF_PRINT_WARNING(VIDEO_DEBUG) << "texture sheet being deleted when it has a non-zero allocated texture count: " << GetNumberTextures() << std::endl;
-
-    if (_blocks != nullptr) {
-        delete [] _blocks;
-        _blocks = nullptr;
-    }
 }
 
 bool VariableTexSheet::AddTexture(BaseTexture *img, ImageMemory &data)
@@ -480,67 +587,159 @@ bool VariableTexSheet::InsertTexture(BaseTexture *img)
     }
 
     // Don't allow insertions into a texture sheet containing a texture larger than 512x512.
-    // Texture sheets with this property may only be used by one texture at a time
-    if(_block_width > 32 || _block_height > 32) {  // 32 blocks == 512 pixels
-        if(_blocks[0].free_image == false)
-            return false;
+    // Texture sheets with this property may only be used by one texture at a time,
+    // unlike the larger sheets of the sprite atlas holding smaller textures.
+    if(width > 512 || height > 512) {
+        for(std::set<BaseTexture *>::const_iterator i = _textures.begin(); i != _textures.end(); ++i) {
+            if(_freed_textures.find(*i) != _freed_textures.end())
+                continue;
+            if(img->width > 512 || img->height > 512 || (*i)->width > 512 || (*i)->height > 512)
+                return false;
+        }
     }
 
     // Attempt to find an open region in the texture sheet to fit this texture
-    int32_t block_x = -1, block_y = -1;
-    int32_t w = (img->width + 15) / 16;
-    int32_t h = (img->height + 15) / 16;
-
-    // This is a brute force algorithm to try and find space to allocate the texture.
-    // If this becomes a bottleneck, we may wish to use a more intellegent algorithm here.
-    bool continue_search = true;
-    for(int32_t y = 0; y < _block_height - h + 1 && continue_search; y++) {
-        for(int32_t x = 0; x < _block_width - w + 1; x++) {
-            int32_t furthest_blocker = -1;
-
-            bool continue_neighbor_search = true;
-            for(int32_t dy = 0; dy < h && continue_neighbor_search; dy++) {
-                for(int32_t dx = 0; dx < w; dx++) {
-                    if(_blocks[(x + dx) + ((y + dy) * _block_width)].free_image == false) {
-                        furthest_blocker = x + dx;
-                        continue_neighbor_search = false;
-                        break;
-                    }
-                }
-            }
+    const int32_t rect_width = _GetPaddedSize(img->width, width);
+    const int32_t rect_height = _GetPaddedSize(img->height, height);
+    TexRect rect;
+    if(_FindPosition(rect_width, rect_height, rect) == false && _merged_free_rects) {
+        // The merged free rectangles may not be the largest ones anymore
+        _RebuildFreeRects();
+    }
 
-            if(furthest_blocker == -1) {
-                block_x = x;
-                block_y = y;
-                continue_search = false;
-                break;
-            }
-        }
+    if(_FindPosition(rect_width, rect_height, rect) == false) {
+        if(_freed_textures.empty())
+            return false;
+
+        // Give the space of the freed textures to the new one, and try again
+        while(!_freed_textures.empty())
+            RemoveTexture(*_freed_textures.begin());
+        _RebuildFreeRects();
+
+        if(_FindPosition(rect_width, rect_height, rect) == false)
+            return false;
     }
 
-    // If either of these conditions is true, it means we were unable to allocate enough space to insert this texture
-    if(block_x == -1 || block_y == -1)
+    _PlaceTexture(img, rect);
+    return true;
+} // bool VariableTexSheet::InsertTexture(BaseTexture* img)
+
+
+
+bool VariableTexSheet::InsertTextureAt(BaseTexture *img, int32_t x, int32_t y)
+{
+    if(img == nullptr) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "nullptr pointer was given as function argument" << std::endl;
         return false;
+    }
 
-    // Go through each block that is to be occupied by the new texture and set its properties
-    for(int32_t y = block_y; y < block_y + h; y++) {
-        for(int32_t x = block_x; x < block_x + w; x++) {
-            int32_t index = x + (y * _block_width);
+    // The baked positions can't be padded.
+    _tight_layout = true;
 
-            // If the texture pointer for the block is not nullptr, this means it contains a freed texture.
-            // Now we must remove that texture entirely since we are overwriting at least one of its blocks.
-            if(_blocks[index].image) {
-                RemoveTexture(_blocks[index].image);
-            }
+    // The whole rectangle must be free
+    TexRect rect(x, y, img->width, img->height);
+    bool is_free = false;
+    for(uint32_t i = 0; i < _free_rects.size() && !is_free; ++i)
+        is_free = rect.IsContainedIn(_free_rects[i]);
+
+    if(is_free == false)
+        return false;
+
+    _PlaceTexture(img, rect);
+    return true;
+}
+
+
+
+void VariableTexSheet::RemoveTexture(BaseTexture *img)
+{
+    if(img == nullptr) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "nullptr pointer was given as function argument" << std::endl;
+        return;
+    }
+
+    if(_textures.erase(img) == 0) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "texture pointer argument was not contained within this texture sheet" << std::endl;
+        return;
+    }
+    _freed_textures.erase(img);
+
+    // Start over from a single free rectangle once the sheet is empty
+    if(_textures.empty()) {
+        _RebuildFreeRects();
+        return;
+    }
+
+    _FreeRect(_GetUsedRect(img));
+    _merged_free_rects = true;
+}
 
-            _blocks[index].free_image = false;
-            _blocks[index].image = img;
+
+
+float VariableTexSheet::GetOccupancy() const
+{
+    int64_t used_area = 0;
+    for(std::set<BaseTexture *>::const_iterator i = _textures.begin(); i != _textures.end(); ++i)
+        used_area += static_cast<int64_t>((*i)->width) * (*i)->height;
+
+    return static_cast<float>(used_area) / (static_cast<float>(width) * static_cast<float>(height));
+}
+
+
+
+float VariableTexSheet::GetFragmentation() const
+{
+    const float free_area = (1.0f - GetOccupancy()) * static_cast<float>(width) * static_cast<float>(height);
+    if(free_area <= 0.0f)
+        return 0.0f;
+
+    int64_t largest_free_area = 0;
+    for(uint32_t i = 0; i < _free_rects.size(); ++i)
+        largest_free_area = std::max(largest_free_area, static_cast<int64_t>(_free_rects[i].width) * _free_rects[i].height);
+
+    return std::max(0.0f, 1.0f - static_cast<float>(largest_free_area) / free_area);
+}
+
+
+
+bool VariableTexSheet::_FindPosition(int32_t rect_width, int32_t rect_height, TexRect &rect) const
+{
+    // Best short side fit: Choose the free rectangle leaving the smallest leftover on one side,
+    // and in case of ties, the smallest leftover on the other side.
+    int32_t best_short_side = std::numeric_limits<int32_t>::max();
+    int32_t best_long_side = std::numeric_limits<int32_t>::max();
+    bool found = false;
+
+    for(uint32_t i = 0; i < _free_rects.size(); ++i) {
+        const TexRect &free_rect = _free_rects[i];
+        if(free_rect.width < rect_width || free_rect.height < rect_height)
+            continue;
+
+        int32_t leftover_x = free_rect.width - rect_width;
+        int32_t leftover_y = free_rect.height - rect_height;
+        int32_t short_side = std::min(leftover_x, leftover_y);
+        int32_t long_side = std::max(leftover_x, leftover_y);
+
+        if(short_side < best_short_side || (short_side == best_short_side && long_side < best_long_side)) {
+            rect = TexRect(free_rect.x, free_rect.y, rect_width, rect_height);
+            best_short_side = short_side;
+            best_long_side = long_side;
+            found = true;
         }
     }
 
+    return found;
+}
+
+
+
+void VariableTexSheet::_PlaceTexture(BaseTexture *img, const TexRect &rect)
+{
+    _PlaceRect(rect);
+
     // Calculate the pixel and uv coordinates for the newly inserted texture
-    img->x = block_x * 16;
-    img->y = block_y * 16;
+    img->x = rect.x;
+    img->y = rect.y;
 
     float sheet_width = static_cast<float>(width);
     float sheet_height = static_cast<float>(height);
@@ -552,46 +751,125 @@ bool VariableTexSheet::InsertTexture(BaseTexture *img)
 
     img->texture_sheet = this;
     _textures.insert(img);
+}
 
-    return true;
-} // bool VariableTexSheet::InsertTexture(BaseTexture* img)
 
 
+void VariableTexSheet::_RebuildFreeRects()
+{
+    _free_rects.clear();
+    _free_rects.push_back(TexRect(0, 0, width, height));
 
-void VariableTexSheet::RemoveTexture(BaseTexture *img)
+    for(std::set<BaseTexture *>::const_iterator i = _textures.begin(); i != _textures.end(); ++i)
+        _PlaceRect(_GetUsedRect(*i));
+
+    _merged_free_rects = false;
+}
+
+int32_t VariableTexSheet::_GetPaddedSize(int32_t size, uint32_t sheet_size) const
+{
+    if(_tight_layout)
+        return size;
+
+    const int32_t alignment = 1 << VARIABLE_TEXSHEET_MIPMAP_LEVEL;
+    return std::min((size + alignment - 1) & ~(alignment - 1), static_cast<int32_t>(sheet_size));
+}
+
+TexRect VariableTexSheet::_GetUsedRect(const BaseTexture *img) const
 {
-    _SetBlockProperties(img, nullptr, true);
-    _textures.erase(img);
+    return TexRect(img->x, img->y, _GetPaddedSize(img->width, width), _GetPaddedSize(img->height, height));
 }
 
 
 
-void VariableTexSheet::_SetBlockProperties(BaseTexture *tex, BaseTexture *new_tex, bool free)
+void VariableTexSheet::_PlaceRect(const TexRect &used)
 {
-    if(tex == nullptr) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "nullptr pointer was given as function argument" << std::endl;
-        return;
-    }
+    std::vector<TexRect> split_rects;
 
-    if(_textures.find(tex) == _textures.end()) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "texture pointer argument was not contained within this texture sheet" << std::endl;
+    for(uint32_t i = 0; i < _free_rects.size();) {
+        const TexRect free_rect = _free_rects[i];
+        if(!free_rect.Intersects(used)) {
+            ++i;
+            continue;
+        }
+
+        // Keep the largest free rectangles on each side of the used one
+        if(used.x > free_rect.x)
+            split_rects.push_back(TexRect(free_rect.x, free_rect.y, used.x - free_rect.x, free_rect.height));
+        if(used.x + used.width < free_rect.x + free_rect.width)
+            split_rects.push_back(TexRect(used.x + used.width, free_rect.y,
+                                          free_rect.x + free_rect.width - used.x - used.width, free_rect.height));
+        if(used.y > free_rect.y)
+            split_rects.push_back(TexRect(free_rect.x, free_rect.y, free_rect.width, used.y - free_rect.y));
+        if(used.y + used.height < free_rect.y + free_rect.height)
+            split_rects.push_back(TexRect(free_rect.x, used.y + used.height,
+                                          free_rect.width, free_rect.y + free_rect.height - used.y - used.height));
+
+        _free_rects[i] = _free_rects.back();
+        _free_rects.pop_back();
     }
 
-    // Calculate upper-left corner in blocks
-    int32_t block_x = tex->x / 16;
-    int32_t block_y = tex->y / 16;
+    const uint32_t first_new_rect = _free_rects.size();
+    _free_rects.insert(_free_rects.end(), split_rects.begin(), split_rects.end());
+    _PruneFreeRects(first_new_rect);
+}
 
-    // Calculate width and height in blocks
-    int32_t w = (tex->width  + 15) / 16;
-    int32_t h = (tex->height + 15) / 16;
 
-    for(int32_t y = block_y; y < block_y + h; y++) {
-        for(int32_t x = block_x; x < block_x + w; x++) {
-            int32_t index = x + y * _block_width;
-            if(_blocks[index].image == tex) {
-                _blocks[index].free_image = free;
-                _blocks[index].image = new_tex;
+
+void VariableTexSheet::_FreeRect(const TexRect &freed)
+{
+    // Grow the freed rectangle with the free rectangles sharing one of its whole edges
+    TexRect rect = freed;
+    bool merged = true;
+    while(merged) {
+        merged = false;
+
+        for(uint32_t i = 0; i < _free_rects.size(); ++i) {
+            const TexRect &free_rect = _free_rects[i];
+
+            if(rect.x == free_rect.x && rect.width == free_rect.width &&
+                    (rect.y + rect.height == free_rect.y || free_rect.y + free_rect.height == rect.y)) {
+                rect.y = std::min(rect.y, free_rect.y);
+                rect.height += free_rect.height;
+                merged = true;
+            } else if(rect.y == free_rect.y && rect.height == free_rect.height &&
+                    (rect.x + rect.width == free_rect.x || free_rect.x + free_rect.width == rect.x)) {
+                rect.x = std::min(rect.x, free_rect.x);
+                rect.width += free_rect.width;
+                merged = true;
             }
+
+            if(merged) {
+                _free_rects.erase(_free_rects.begin() + i);
+                break;
+            }
+        }
+    }
+
+    _free_rects.push_back(rect);
+    _PruneFreeRects(_free_rects.size() - 1);
+}
+
+
+
+void VariableTexSheet::_PruneFreeRects(uint32_t first_new_rect)
+{
+    // The rectangles before the new ones are known not to contain each other.
+    for(uint32_t i = 0; i < _free_rects.size();) {
+        bool contained = false;
+        uint32_t j = (i < first_new_rect) ? first_new_rect : 0;
+        for(; j < _free_rects.size() && !contained; ++j) {
+            // Of two identical rectangles, only the first one is kept
+            if(i != j && _free_rects[i].IsContainedIn(_free_rects[j]))
+                contained = (j < i || !_free_rects[j].IsContainedIn(_free_rects[i]));
+        }
+
+        if(contained) {
+            _free_rects.erase(_free_rects.begin() + i);
+            if(i < first_new_rect)
+                --first_new_rect;
+        } else {
+            ++i;
         }
     }
 }
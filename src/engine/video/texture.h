@@ -36,8 +36,8 @@
 *** This sheet allows textures of any size to be inserted, but has slower
 *** performance than the FixedTexSheet.
 ***
-*** - <b>VariableTexNode</b>: represents a texture node entry for the
-*** VariableTexSheet class.
+*** - <b>TexRect</b>: represents a rectangle of pixels used to pack the
+*** textures of the VariableTexSheet class.
 *** ***************************************************************************/
 
 #ifndef __TEXTURE_HEADER__
@@ -46,6 +46,7 @@
 #include "utils/gl_include.h"
 
 #include <set>
+#include <vector>
 
 namespace vt_video
 {
@@ -61,6 +62,12 @@ class ImageMemory;
 //! \brief Used to indicate an invalid texture ID
 const GLuint INVALID_TEXTURE_ID = 0xFFFFFFFF;
 
+/** \brief The last mipmap level of the variable texture sheets.
+*** Their image rectangles are padded to a multiple of (1 << level) pixels,
+*** so that no texel of those levels mixes two images.
+**/
+const int32_t VARIABLE_TEXSHEET_MIPMAP_LEVEL = 2;
+
 //! \brief Represents the different image sizes that a texture sheet can hold
 enum TexSheetType {
     VIDEO_TEXSHEET_INVALID = -1,
@@ -160,6 +167,24 @@ public:
     **/
     bool Reload();
 
+    /** \brief Copies the pixels of the sheet to system memory, then unloads its OpenGL texture
+    *** \return Success/failure
+    *** \note The pixels are uploaded back by the next call to Reload(), instead of reloading
+    *** every image from its file. This also keeps the content of the images made from the screen.
+    **/
+    bool Evict();
+
+    //! \brief Tells whether the pixels of the sheet are kept in system memory instead of video memory
+    bool IsEvicted() const {
+        return _evicted_image != nullptr;
+    }
+
+    //! \brief Returns the size in bytes the sheet takes in video memory when loaded, its mipmaps included
+    uint32_t GetMemorySize() const {
+        const uint32_t size = width * height * 4;
+        return mipmapped ? size + size / 3 : size;
+    }
+
     /** \brief Copies pixel data of an image over to a sub-rectangle in the texture sheet
     *** \param x X coordinate of the texture sheet where to copy the pixel data to
     *** \param y Y coordinate of the texture sheet where to copy the pixel data to
@@ -193,6 +218,17 @@ public:
     **/
     void Smooth(bool flag = true);
 
+    /** \brief Makes the sheet sample mipmaps while smoothed, for its images drawn smaller than their size.
+    *** Does nothing when the sheet layout leaves no mipmap level without bleeding between its images.
+    **/
+    void EnableMipmaps();
+
+    //! \brief Generates the mipmaps again if the sheet pixels changed since. The sheet must be bound.
+    void UpdateMipmaps() {
+        if(_mipmaps_outdated)
+            _GenerateMipmaps();
+    }
+
     /** \brief Draws the entire texture sheet to the screen
     *** This is used for debugging, as it draws all images contained within the texture to the screen.
     *** It ignores any blending or lighting properties that are enabled in the VideoManager
@@ -216,12 +252,34 @@ public:
     //! \brief True if this texture sheet is currently set to GL_LINEAR
     bool smoothed;
 
+    //! \brief True once the sheet has mipmaps, sampled while smoothed
+    bool mipmapped;
+
     //! \brief Flag indicating if texture sheet is loaded or not
     bool loaded;
 
+    //! \brief The number of the last frame during which the sheet was bound, used to evict the least recently used sheets
+    uint32_t last_used_frame;
+
 protected:
+    //! \brief The pixels of the sheet while it is evicted, or nullptr
+    ImageMemory *_evicted_image;
+
     //! \brief The width and height of the sheet in number of texture blocks
     int32_t _block_width, _block_height;
+
+    //! \brief Returns the last mipmap level whose texels each cover a single image, 0 when there is none.
+    virtual int32_t _GetMipmapMaxLevel() const = 0;
+
+private:
+    //! \brief Set when the sheet pixels changed since the mipmaps were generated
+    bool _mipmaps_outdated;
+
+    //! \brief Generates the mipmaps from the sheet pixels. The sheet must be bound.
+    void _GenerateMipmaps();
+
+    //! \brief Sets the filtering of the sheet from its smoothing and mipmaps. The sheet must be bound.
+    void _ApplyFiltering();
 }; // class TexSheet
 
 
@@ -317,6 +375,10 @@ public:
     uint32_t GetNumberTextures();
     //@}
 
+protected:
+    //! \brief The blocks being aligned, the levels up to the largest power of 2 dividing their size are used.
+    int32_t _GetMipmapMaxLevel() const;
+
 private:
     //! \brief The width and height of each texture block, in number of pixels
     int32_t _texture_width, _texture_height;
@@ -351,32 +413,51 @@ private:
 };
 
 /** ****************************************************************************
-*** \brief Keeps track of which images are used/freed in the variable texture mem manager
+*** \brief A rectangle of pixels within a variable texture sheet
 *** ***************************************************************************/
-class VariableTexNode
+class TexRect
 {
 public:
-    VariableTexNode() :
-        image(nullptr),
-        free_image(true)
+    TexRect() :
+        x(0), y(0), width(0), height(0)
     {
     }
 
-    //! \brief A pointer to the image.
-    BaseTexture *image;
+    TexRect(int32_t x_, int32_t y_, int32_t width_, int32_t height_) :
+        x(x_), y(y_), width(width_), height(height_)
+    {
+    }
 
-    //! \brief Set to true if the image is freed.
-    bool free_image;
+    //! \brief Tells whether the rectangle lies entirely within another one.
+    bool IsContainedIn(const TexRect &rect) const {
+        return x >= rect.x && y >= rect.y &&
+               x + width <= rect.x + rect.width &&
+               y + height <= rect.y + rect.height;
+    }
+
+    //! \brief Tells whether the rectangle overlaps another one.
+    bool Intersects(const TexRect &rect) const {
+        return x < rect.x + rect.width && rect.x < x + width &&
+               y < rect.y + rect.height && rect.y < y + height;
+    }
+
+    //! \brief The upper-left corner of the rectangle, in pixels
+    int32_t x, y;
+
+    //! \brief The size of the rectangle, in pixels
+    int32_t width, height;
 };
 
 /** ****************************************************************************
 *** \brief Used to manage texture sheets of variable image sizes
 ***
-*** This class divides a texture sheet up into 16x16 pixel blocks, and keeps
-*** track of which images have allocated which blocks. This is done to reduce
-*** the time complexity for doing texture insertion and removal operations, but
-*** the downside is that it may leave some space in the texture sheet occupied
-*** but unused for images that are not divisible by 16 in width or height.
+*** This class packs the images using the MaxRects algorithm: It keeps the list
+*** of the largest free rectangles of the sheet, which may overlap each other,
+*** and places each new image in the free rectangle it fits the best, comparing
+*** the shortest leftover side first. The free rectangles crossed by the image
+*** are then split around it. Removing an image gives its rectangle back and
+*** merges it with the free rectangles it is aligned with. When an image then
+*** doesn't fit, the free rectangles are computed again from the images left.
 *** ***************************************************************************/
 class VariableTexSheet : public TexSheet
 {
@@ -405,11 +486,12 @@ public:
     void RemoveTexture(BaseTexture *img);
 
     void FreeTexture(BaseTexture *img) {
-        _SetBlockProperties(img, img, true);
+        if(_textures.find(img) != _textures.end())
+            _freed_textures.insert(img);
     }
 
     void RestoreTexture(BaseTexture *img) {
-        _SetBlockProperties(img, img, false);
+        _freed_textures.erase(img);
     }
 
     uint32_t GetNumberTextures() {
@@ -417,23 +499,80 @@ public:
     }
     //@}
 
-private:
-    /** \brief The list of 16x16 pixel blocks in the sheet.
-    *** The size of this structure is: (width / 16) * (height / 16)
+    /** \brief Inserts a new texture at a given position, as laid out by a baked texture atlas
+    *** \param img A pointer to the new image to insert
+    *** \param x The x coordinate of the image in the sheet, in pixels
+    *** \param y The y coordinate of the image in the sheet, in pixels
+    *** \return False if that part of the sheet isn't free
+    *** \note Like InsertTexture(), this doesn't copy any pixel data.
     **/
-    VariableTexNode *_blocks;
+    bool InsertTextureAt(BaseTexture *img, int32_t x, int32_t y);
+
+    //! \brief Returns the ratio of the sheet area used by the textures, between 0.0f and 1.0f
+    float GetOccupancy() const;
+
+    /** \brief Returns how scattered the free area of the sheet is, between 0.0f and 1.0f
+    *** 0.0f means the free area is a single rectangle, and values close to 1.0f mean
+    *** that only small images can still be inserted despite the free area.
+    **/
+    float GetFragmentation() const;
+
+protected:
+    int32_t _GetMipmapMaxLevel() const {
+        return _tight_layout ? 0 : VARIABLE_TEXSHEET_MIPMAP_LEVEL;
+    }
+
+private:
+    //! \brief The largest free rectangles of the sheet, which may overlap each other.
+    std::vector<TexRect> _free_rects;
 
     /** \brief A set containing each texture that has been inserted into this class
     *** This container is used to be able to quickly determine if a texture is loaded by an object of this class
     **/
     std::set<BaseTexture *> _textures;
 
-    /** \brief Updates the properties of all of the blocks associated with a given texture
-    *** \param tex The texture to update
-    *** \param new_tex The texture pointer to set the block to
-    *** \param new_image The boolean value to set the free status flag to
+    //! \brief The textures marked as freed, whose space is given to new textures when the sheet is full
+    std::set<BaseTexture *> _freed_textures;
+
+    //! \brief Set once removed textures were merged back into the free rectangles, which may then not be the largest ones
+    bool _merged_free_rects;
+
+    /** \brief Set once a texture was inserted at a given position, as in the baked atlases.
+    *** The image rectangles aren't padded from then on, and the sheet can't have mipmaps.
+    **/
+    bool _tight_layout;
+
+    //! \brief Returns an image size padded for the mipmaps, within the sheet size.
+    int32_t _GetPaddedSize(int32_t size, uint32_t sheet_size) const;
+
+    //! \brief Returns the rectangle an inserted texture takes, its padding included.
+    TexRect _GetUsedRect(const BaseTexture *img) const;
+
+    /** \brief Finds where a rectangle of the given size fits the best
+    *** \param width The width of the rectangle to place
+    *** \param height The height of the rectangle to place
+    *** \param rect Set to the chosen position and the given size
+    *** \return False if there is no room for such a rectangle
+    **/
+    bool _FindPosition(int32_t width, int32_t height, TexRect &rect) const;
+
+    //! \brief Inserts a texture in a free rectangle and computes its texture coordinates
+    void _PlaceTexture(BaseTexture *img, const TexRect &rect);
+
+    //! \brief Splits the free rectangles overlapped by a newly used rectangle
+    void _PlaceRect(const TexRect &used);
+
+    //! \brief Gives a rectangle back to the free rectangles, merging it with its aligned neighbours
+    void _FreeRect(const TexRect &freed);
+
+    //! \brief Computes the largest free rectangles again from the textures of the sheet
+    void _RebuildFreeRects();
+
+    /** \brief Removes the free rectangles contained within other ones
+    *** \param first_new_rect The index of the first free rectangle which may be contained in,
+    *** or contain, another one. The rectangles before it are only checked against the ones after.
     **/
-    void _SetBlockProperties(BaseTexture *tex, BaseTexture *new_tex, bool free);
+    void _PruneFreeRects(uint32_t first_new_rect);
 };
 
 } // namespace private_video
@@ -18,9 +18,17 @@
 #include "texture_controller.h"
 #include "utils/utils_files.h"
 
+#include "engine/asset_watcher.h"
 #include "engine/mode_manager.h"
+#include "engine/video/gl/gl_pixel_upload_buffer.h"
+#include "engine/video/image_decoder.h"
 #include "engine/video/video.h"
 
+#include "script/script_read.h"
+
+#include <algorithm>
+#include <sstream>
+
 using namespace vt_video::private_video;
 
 namespace vt_video
@@ -29,13 +37,32 @@ namespace vt_video
 //! \brief A pointer to the texture controller.
 TextureController* TextureManager = nullptr;
 
+//! \brief The number of frames a texture sheet must stay unused before being evicted, about 5 seconds.
+const uint32_t TEXTURE_EVICTION_IDLE_FRAMES = 300;
+
 TextureController::TextureController() :
-    _debug_current_sheet(-1)
+    _debug_current_sheet(-1),
+    _bound_texture_id(0),
+    _image_decoder(nullptr),
+    _pixel_upload_buffer(nullptr),
+    _upload_budget(VIDEO_DEFAULT_UPLOAD_BUDGET),
+    _next_procedural_path_id(0x80000000),
+    _capture_sheet(nullptr),
+    _capture_sheet_used(false),
+    _sprite_atlas_active(false),
+    _texture_memory_budget(0),
+    _frame_number(0)
 {
 }
 
 TextureController::~TextureController()
 {
+    // Stop decoding the prefetched images.
+    if (_image_decoder != nullptr) {
+        delete _image_decoder;
+        _image_decoder = nullptr;
+    }
+
     IF_PRINT_DEBUG(VIDEO_DEBUG) << "Deleting all remaining ImageTextures, a total of: " << _images.size() << std::endl;
 
     // Invoking the ImageTexture destructor will erase the entry in the _images map that corresponds to that object
@@ -50,10 +77,21 @@ TextureController::~TextureController()
     for(std::vector<TexSheet *>::iterator i = _tex_sheets.begin(); i != _tex_sheets.end(); ++i) {
         delete *i;
     }
+
+    if (_pixel_upload_buffer != nullptr) {
+        delete _pixel_upload_buffer;
+        _pixel_upload_buffer = nullptr;
+    }
 }
 
 bool TextureController::SingletonInitialize()
 {
+    // Start the image decoding threads.
+    _image_decoder = new ImageDecoder();
+
+    // Stage the texture uploads, so that they don't block the main thread.
+    _pixel_upload_buffer = new gl::PixelUploadBuffer();
+
     // Create a default set of texture sheets
     if(_CreateTexSheet(512, 512, VIDEO_TEXSHEET_32x32, false) == nullptr) {
         PRINT_ERROR << "could not create default 32x32 texture sheet" << std::endl;
@@ -130,7 +168,9 @@ void TextureController::DEBUG_ShowTexSheet()
     VideoManager->Move(0.0f, 368.0f);
     VideoManager->Scale(sheet->width / 2.0f, sheet->height / 2.0f);
 
-    sheet->DEBUG_Draw();
+    // Showing an evicted sheet mustn't restore it.
+    if (sheet->loaded)
+        sheet->DEBUG_Draw();
 
     VideoManager->PopMatrix();
 
@@ -165,13 +205,281 @@ void TextureController::DEBUG_ShowTexSheet()
     VideoManager->MoveRelative(0, 20);
     TextManager->Draw(buf);
 
+    VariableTexSheet *variable_sheet = dynamic_cast<VariableTexSheet *>(sheet);
+    if (variable_sheet != nullptr) {
+        sprintf(buf, "  Packing: %d textures, %.0f%% used, %.0f%% fragmented",
+                variable_sheet->GetNumberTextures(),
+                variable_sheet->GetOccupancy() * 100.0f,
+                variable_sheet->GetFragmentation() * 100.0f);
+        VideoManager->MoveRelative(0, 20);
+        TextManager->Draw(buf);
+    }
+
     sprintf(buf, "  TexID:   %d", sheet->tex_id);
     VideoManager->MoveRelative(0, 20);
     TextManager->Draw(buf);
 
+    if (sheet->loaded)
+        sprintf(buf, "  State:   Resident, used %u frames ago", _frame_number - sheet->last_used_frame);
+    else if (sheet->IsEvicted())
+        sprintf(buf, "  State:   Evicted");
+    else
+        sprintf(buf, "  State:   Unloaded");
+    VideoManager->MoveRelative(0, 20);
+    TextManager->Draw(buf);
+
+    uint32_t evicted_sheets = 0;
+    for (uint32_t i = 0; i < _tex_sheets.size(); ++i) {
+        if (_tex_sheets[i]->IsEvicted())
+            ++evicted_sheets;
+    }
+
+    sprintf(buf, "  Memory:  %u KB used, %u KB budget, %u of %u sheets evicted",
+            GetTextureMemoryUsage() / 1024, _texture_memory_budget / 1024,
+            evicted_sheets, static_cast<uint32_t>(_tex_sheets.size()));
+    VideoManager->MoveRelative(0, 20);
+    TextManager->Draw(buf);
+
     VideoManager->PopState();
 }
 
+uint32_t TextureController::GetTextureMemoryUsage() const
+{
+    uint32_t bytes = 0;
+    for(uint32_t i = 0; i < _tex_sheets.size(); ++i) {
+        if(_tex_sheets[i]->loaded)
+            bytes += _tex_sheets[i]->GetMemorySize();
+    }
+    return bytes;
+}
+
+std::string TextureController::GetMemoryReport() const
+{
+    // The bytes of each sheet used by the rendered texts.
+    std::map<const TexSheet *, uint32_t> text_bytes;
+    for(std::set<TextTexture *>::const_iterator it = _text_images.begin(); it != _text_images.end(); ++it)
+        text_bytes[(*it)->texture_sheet] += (*it)->width * (*it)->height * 4;
+
+    std::ostringstream report;
+    report << "Texture sheets, in bytes:" << std::endl;
+    for(uint32_t i = 0; i < _tex_sheets.size(); ++i) {
+        TexSheet *sheet = _tex_sheets[i];
+        std::map<const TexSheet *, uint32_t>::const_iterator text_it = text_bytes.find(sheet);
+        report << "sheet " << i << ": " << sheet->width << "x" << sheet->height
+               << (sheet->is_static ? " static" : "")
+               << (sheet->IsEvicted() ? " evicted (cpu)" : (sheet->loaded ? " resident (gpu)" : " unloaded"))
+               << ", " << sheet->GetMemorySize() << ", " << sheet->GetNumberTextures() << " images"
+               << ", text " << (text_it != text_bytes.end() ? text_it->second : 0) << std::endl;
+    }
+    return report.str();
+}
+
+#ifdef DEBUG_FEATURES
+bool TextureController::DEBUG_ReloadImageFile(const std::string& filename)
+{
+    ImageMemory file_image;
+    if(!file_image.LoadImage(filename)) {
+        PRINT_WARNING << "Couldn't reload the changed image: " << filename << std::endl;
+        return false;
+    }
+
+    const uint32_t path_id = _FindImagePath(filename);
+    std::vector<ImageTexture *> images;
+    for(std::unordered_map<uint64_t, ImageTexture *>::iterator i = _images.begin(); i != _images.end(); ++i) {
+        ImageTexture *img = i->second;
+        if(img->path_id != path_id || img->texture_sheet == nullptr)
+            continue;
+
+        // The images are packed in their sheets: They can't grow nor shrink in place.
+        if(file_image.GetWidth() != img->width || file_image.GetHeight() != img->height) {
+            PRINT_WARNING << "The size of the changed image differs, reload the game mode to see it: "
+                          << filename << std::endl;
+            return false;
+        }
+        images.push_back(img);
+    }
+
+    bool success = true;
+    for(uint32_t i = 0; i < images.size(); ++i) {
+        TexSheet *sheet = images[i]->texture_sheet;
+        if(!sheet->loaded)
+            continue;
+
+        // The pixels kept by an evicted sheet are restored first, to be overwritten.
+        _BindTexSheet(sheet);
+        if(_ReloadImage(images[i]) == false)
+            success = false;
+    }
+
+    IF_PRINT_DEBUG(VIDEO_DEBUG) << "Reloaded " << images.size() << " images of the changed file: " << filename << std::endl;
+    return success;
+}
+#endif
+
+void TextureController::PrefetchImage(const std::string& filename)
+{
+    if (_image_decoder == nullptr || filename.empty() || _IsImageTextureRegistered(_FindImagePath(filename)))
+        return;
+
+    _image_decoder->Request(filename);
+}
+
+uint32_t TextureController::InternImagePath(const std::string& filename)
+{
+    std::unordered_map<std::string, uint32_t>::const_iterator it = _image_path_ids.find(filename);
+    if (it != _image_path_ids.end())
+        return it->second;
+
+    const uint32_t path_id = static_cast<uint32_t>(_image_path_ids.size()) + 1;
+    _image_path_ids.insert(std::make_pair(filename, path_id));
+    return path_id;
+}
+
+bool TextureController::IsImageReady(const std::string& filename) const
+{
+    if (_image_decoder == nullptr || !_image_decoder->IsRequested(filename))
+        return true;
+
+    return _image_decoder->IsReady(filename);
+}
+
+void TextureController::CancelPrefetchedImage(const std::string& filename)
+{
+    if (_image_decoder != nullptr)
+        _image_decoder->Cancel(filename);
+}
+
+bool TextureController::LoadTextureAtlas(const std::string& filename)
+{
+    if (_texture_atlases.find(filename) != _texture_atlases.end()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "texture atlas already loaded: " << filename << std::endl;
+        return true;
+    }
+
+    vt_script::ReadScriptDescriptor atlas_script;
+    if (!atlas_script.OpenFile(filename))
+        return false;
+
+    if (!atlas_script.OpenTable("atlas")) {
+        PRINT_WARNING << "No atlas table in " << filename << std::endl;
+        atlas_script.CloseFile();
+        return false;
+    }
+
+    std::string image_filename = atlas_script.ReadString("image_filename");
+
+    ImageMemory atlas_image;
+    if (!_LoadImageMemory(image_filename, atlas_image)) {
+        PRINT_WARNING << "Couldn't load the texture atlas image: " << image_filename << std::endl;
+        atlas_script.CloseAllTables();
+        atlas_script.CloseFile();
+        return false;
+    }
+
+    // The atlas gets its own static sheet, laid out exactly as baked.
+    VariableTexSheet* sheet = dynamic_cast<VariableTexSheet*>(_CreateTexSheet(atlas_image.GetWidth(), atlas_image.GetHeight(),
+                                                                                 VIDEO_TEXSHEET_ANY, true));
+    if (sheet == nullptr) {
+        PRINT_WARNING << "Couldn't create the texture sheet of the atlas: " << filename << std::endl;
+        atlas_script.CloseAllTables();
+        atlas_script.CloseFile();
+        return false;
+    }
+
+    _TextureAtlas& atlas = _texture_atlases[filename];
+    atlas.sheet = sheet;
+    std::vector<ImageTexture*>& atlas_images = atlas.images;
+
+    // The images are indexed by their filename.
+    std::vector<std::string> image_filenames;
+    atlas_script.ReadTableKeys("images", image_filenames);
+    atlas_script.OpenTable("images");
+    for (uint32_t i = 0; i < image_filenames.size(); ++i) {
+        const std::string& image = image_filenames[i];
+        if (!atlas_script.OpenTable(image))
+            continue;
+
+        int32_t x = atlas_script.ReadInt("x");
+        int32_t y = atlas_script.ReadInt("y");
+        int32_t width = atlas_script.ReadInt("width");
+        int32_t height = atlas_script.ReadInt("height");
+
+        atlas_script.CloseTable(); // images[i]
+
+        // Images already loaded keep their texture, and the bigger ones need their own sheet.
+        const uint32_t path_id = InternImagePath(image);
+        if (_IsImageTextureRegistered(path_id) || width > 512 || height > 512)
+            continue;
+
+        ImageTexture* img = new ImageTexture(image, path_id, IMAGE_TAG_NONE, width, height);
+        if (!sheet->InsertTextureAt(img, x, y)) {
+            IF_PRINT_WARNING(VIDEO_DEBUG) << "Invalid position of " << image << " in texture atlas: " << filename << std::endl;
+            delete img;
+            continue;
+        }
+
+        // The atlas keeps its images until it is unloaded.
+        img->AddReference();
+        atlas_images.push_back(img);
+    }
+    atlas_script.CloseTable(); // images
+
+    atlas_script.CloseAllTables();
+    atlas_script.CloseFile();
+
+    // When every image was skipped, the sheet isn't needed.
+    if (atlas_images.empty()) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "No image to load from texture atlas: " << filename << std::endl;
+        UnloadTextureAtlas(filename);
+        return true;
+    }
+
+    // Upload all the images at once.
+    if (!sheet->CopyRect(0, 0, atlas_image)) {
+        PRINT_WARNING << "Couldn't upload the texture atlas image: " << image_filename << std::endl;
+        UnloadTextureAtlas(filename);
+        return false;
+    }
+
+    return true;
+}
+
+void TextureController::UnloadTextureAtlas(const std::string& filename)
+{
+    auto it = _texture_atlases.find(filename);
+    if (it == _texture_atlases.end())
+        return;
+
+    TexSheet* sheet = it->second.sheet;
+    std::vector<ImageTexture*>& atlas_images = it->second.images;
+    for (uint32_t i = 0; i < atlas_images.size(); ++i) {
+        ImageTexture* img = atlas_images[i];
+
+        // The images still in use are removed once released.
+        if (img->RemoveReference()) {
+            sheet->RemoveTexture(img);
+            delete img;
+        }
+    }
+    _texture_atlases.erase(it);
+
+    if (sheet != nullptr && sheet->GetNumberTextures() == 0)
+        _RemoveSheet(sheet);
+}
+
+void TextureController::BeginSpriteAtlas()
+{
+    // The sheets of the sprites released since the last atlas are reclaimed.
+    for (uint32_t i = 0; i < _sprite_atlas_sheets.size();) {
+        if (_sprite_atlas_sheets[i]->GetNumberTextures() == 0)
+            _RemoveSheet(_sprite_atlas_sheets[i]);
+        else
+            ++i;
+    }
+
+    _sprite_atlas_active = true;
+}
+
 GLuint TextureController::_CreateBlankGLTexture(int32_t width, int32_t height)
 {
     GLuint tex_id;
@@ -206,14 +514,39 @@ GLuint TextureController::_CreateBlankGLTexture(int32_t width, int32_t height)
 
 void TextureController::_BindTexture(GLuint tex_id)
 {
+    // Consecutive images often lie in the same texture sheet.
+    if (tex_id == _bound_texture_id)
+        return;
+
+    // The queued sprites are drawn with the texture they were queued with.
+    VideoManager->FlushSpriteBatch();
+
     glBindTexture(GL_TEXTURE_2D, tex_id);
+    _bound_texture_id = tex_id;
+    VideoManager->GetRenderStats().AddTextureBind();
+}
+
+void TextureController::_BindTexSheet(TexSheet *sheet)
+{
+    // Restore the sheet when it was evicted from video memory.
+    if(sheet->IsEvicted() && sheet->Reload() == false)
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to restore an evicted texture sheet" << std::endl;
+
+    sheet->last_used_frame = _frame_number;
+    _BindTexture(sheet->tex_id);
 }
 
 void TextureController::_DeleteTexture(GLuint tex_id)
 {
     if (tex_id != 0) {
+        // The texture might still be used by queued sprites.
+        VideoManager->FlushSpriteBatch();
+
         GLuint textures[] = { tex_id };
         glDeleteTextures(1, textures);
+
+        if (tex_id == _bound_texture_id)
+            _bound_texture_id = 0;
     }
 }
 
@@ -263,6 +596,17 @@ void TextureController::_RemoveSheet(TexSheet *sheet)
         return;
     }
 
+    // Keep the last capture sheet for the next capture.
+    if(sheet == _capture_sheet && _capture_sheet_used && sheet->GetNumberTextures() == 0) {
+        _capture_sheet_used = false;
+        return;
+    }
+    if(sheet == _capture_sheet)
+        _capture_sheet = nullptr;
+
+    _sprite_atlas_sheets.erase(std::remove(_sprite_atlas_sheets.begin(), _sprite_atlas_sheets.end(), sheet),
+                               _sprite_atlas_sheets.end());
+
     std::vector<TexSheet *>::iterator i = _tex_sheets.begin();
 
     while(i != _tex_sheets.end()) {
@@ -277,8 +621,33 @@ void TextureController::_RemoveSheet(TexSheet *sheet)
     IF_PRINT_WARNING(VIDEO_DEBUG) << "could not find texture sheet to delete" << std::endl;
 }
 
+TexSheet *TextureController::_CreateCaptureSheet(int32_t width, int32_t height)
+{
+    // Copying the screen in the same texture avoids reallocating it.
+    if(_capture_sheet != nullptr && !_capture_sheet_used) {
+        if(_capture_sheet->loaded && static_cast<int32_t>(_capture_sheet->width) == width
+                && static_cast<int32_t>(_capture_sheet->height) == height) {
+            _capture_sheet_used = true;
+            return _capture_sheet;
+        }
+        _RemoveSheet(_capture_sheet);
+    }
+
+    TexSheet *sheet = _CreateTexSheet(width, height, VIDEO_TEXSHEET_ANY, false);
+    if(sheet == nullptr)
+        return nullptr;
+
+    // A capture still in use keeps its sheet, given back later.
+    _capture_sheet = sheet;
+    _capture_sheet_used = true;
+    return sheet;
+}
+
 TexSheet *TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMemory &load_info, bool is_static)
 {
+    // Tells the map tiles which hide the ones under them.
+    image->opaque = load_info.IsOpaque();
+
     // Image sizes larger than 512 in either dimension require their own texture sheet
     if(load_info.GetWidth() > 512 || load_info.GetHeight() > 512) {
         int32_t round_width = vt_utils::RoundUpPow2(load_info.GetWidth());
@@ -299,6 +668,22 @@ TexSheet *TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
         }
     }
 
+    // Pack the images of the sprites being loaded together, whatever their size.
+    if(_sprite_atlas_active && !is_static) {
+        for(uint32_t i = 0; i < _sprite_atlas_sheets.size(); ++i) {
+            if(_sprite_atlas_sheets[i]->AddTexture(image, load_info))
+                return _sprite_atlas_sheets[i];
+        }
+
+        TexSheet *sheet = _CreateTexSheet(VIDEO_SPRITE_ATLAS_SIZE, VIDEO_SPRITE_ATLAS_SIZE, VIDEO_TEXSHEET_ANY, false);
+        if(sheet != nullptr) {
+            _sprite_atlas_sheets.push_back(sheet);
+            if(sheet->AddTexture(image, load_info))
+                return sheet;
+        }
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "could not add an image to the sprite atlas" << std::endl;
+    }
+
     // Determine the type of texture sheet that should hold this image
     TexSheetType type;
 
@@ -320,7 +705,8 @@ TexSheet *TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
             continue;
         }
 
-        if(sheet->type == type && sheet->is_static == is_static) {
+        if(sheet->type == type && sheet->is_static == is_static
+                && std::find(_sprite_atlas_sheets.begin(), _sprite_atlas_sheets.end(), sheet) == _sprite_atlas_sheets.end()) {
             if(sheet->AddTexture(image, load_info)) {
                 return sheet;
             }
@@ -345,114 +731,127 @@ TexSheet *TextureController::_InsertImageInTexSheet(BaseTexture *image, ImageMem
 
 bool TextureController::_ReloadImagesToSheet(TexSheet *sheet)
 {
-    // Delete images
-    std::map<std::string, std::pair<ImageMemory, ImageMemory> > multi_image_info;
-
     bool success = true;
-    for(std::map<std::string, ImageTexture *>::iterator i = _images.begin(); i != _images.end(); ++i) {
+    for(std::unordered_map<uint64_t, ImageTexture *>::iterator i = _images.begin(); i != _images.end(); ++i) {
         // Only operate on images which belong to the requested TexSheet
         if(i->second->texture_sheet != sheet) {
             continue;
         }
 
-        ImageTexture *img = i->second;
-        ImageMemory load_info;
-        bool is_multi_image = (img->tags.find("<X", 0) != img->filename.npos);
-
-        // Multi Images require a different reloading process
-        if(is_multi_image) {
-            ImageMemory image;
-
-            if(multi_image_info.find(img->filename) == multi_image_info.end()) {
-                // Load the image
-                if(load_info.LoadImage(img->filename) == false) {
-                    IF_PRINT_WARNING(VIDEO_DEBUG) << "call to _LoadRawImage() failed" << std::endl;
-                    success = false;
-                    continue;
-                }
-
-                // Copy the part of the image in a buffer
-                try {
-                    image.Resize(img->width, img->height, false);
-                }
-                catch( std::exception &e ) {
-                    IF_PRINT_WARNING(VIDEO_DEBUG) << "Resize failed." << std::endl;
-                    success = false;
-                    continue;
-                }
-
-                multi_image_info[img->filename] = std::make_pair(load_info, image);
-            } else {
-                load_info = multi_image_info[img->filename].first;
-                image = multi_image_info[img->filename].second;
-            }
-
-            uint16_t pos0, pos1; // Used to find the start and end positions of a sub-string
-            uint32_t x, y; //
-            uint32_t rows, cols;
+        // Spread the uploads over the next frames when they're budgeted
+        if(_upload_budget > 0) {
+            _pending_reloads.push_back(i->first);
+            continue;
+        }
 
-            pos0 = img->tags.find("<X", 0);
-            pos1 = img->tags.find('_', pos0);
-            x = std::stoi(img->tags.substr(pos0 + 2, pos1));
+        if(_ReloadImage(i->second) == false)
+            success = false;
+    }
 
-            pos0 = img->tags.find("<Y", 0);
-            pos1 = img->tags.find('_', pos0);
-            y = std::stoi(img->tags.substr(pos0 + 2, pos1));
+    // Regenerate all font textures
+    for(std::set<TextTexture *>::iterator i = _text_images.begin(); i != _text_images.end(); ++i) {
+        if((*i)->texture_sheet == sheet) {
+            if((*i)->Reload() == false) {
+                IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to reload a TextTexture" << std::endl;
+                success = false;
+            }
+        }
+    }
 
-            rows = load_info.GetHeight() / image.GetHeight();
-            cols = load_info.GetWidth() / image.GetWidth();
+    return success;
+} // bool TextureController::_ReloadImagesToSheet(TexSheet* sheet)
 
-            image.CopyFrom(load_info,
-                           load_info.GetWidth() * (x * load_info.GetHeight() / rows)
-                               + load_info.GetWidth() * y / cols);
+bool TextureController::_ReloadImage(ImageTexture *img)
+{
+    bool success = true;
+    TexSheet *sheet = img->texture_sheet;
+    ImageMemory load_info;
 
-            // Convert to grayscale if needed
-            if(img->tags.find("<G>", 0) != img->filename.npos)
-                image.ConvertToGrayscale();
+    IF_PRINT_DEBUG(VIDEO_DEBUG) << " Reloading image " << img->filename << std::endl;
 
-            // Copy the image into the texture sheet
-            if(sheet->CopyRect(img->x, img->y, image) == false) {
-                IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed" << std::endl;
-                success = false;
-            }
-        } // if (is_multi_image)
+    if(load_info.LoadImage(img->filename) == false) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to _LoadRawImage() failed" << std::endl;
+        success = false;
+    }
 
-        // Reload a normal image file
-        else {
-            std::string fname = img->filename;
+    if(sheet->CopyRect(img->x, img->y, load_info) == false) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed" << std::endl;
+        success = false;
+    }
 
-            IF_PRINT_DEBUG(VIDEO_DEBUG) << " Reloading image " << fname << std::endl;
+    return success;
+} // bool TextureController::_ReloadImage(ImageTexture* img)
 
-            if(load_info.LoadImage(fname) == false) {
-                IF_PRINT_WARNING(VIDEO_DEBUG) << "call to _LoadRawImage() failed" << std::endl;
-                success = false;
-            }
+void TextureController::_UpdateTextureResidency()
+{
+    ++_frame_number;
 
-            // Convert to grayscale if needed
-            if(img->tags.find("<G>", 0) != img->filename.npos)
-                load_info.ConvertToGrayscale();
+    // Evicting a sheet while its images are reuploaded would lose them.
+    if(_texture_memory_budget == 0 || !_pending_reloads.empty())
+        return;
 
-            if(sheet->CopyRect(img->x, img->y, load_info) == false) {
-                IF_PRINT_WARNING(VIDEO_DEBUG) << "call to TexSheet::CopyRect() failed" << std::endl;
-                success = false;
-            }
+    uint32_t resident_bytes = GetTextureMemoryUsage();
+    while(resident_bytes > _texture_memory_budget) {
+        // Find the least recently used sheet which isn't static, nor used lately.
+        TexSheet *coldest_sheet = nullptr;
+        for(std::vector<TexSheet *>::iterator i = _tex_sheets.begin(); i != _tex_sheets.end(); ++i) {
+            TexSheet *sheet = *i;
+            if(!sheet->loaded || sheet->is_static || sheet->GetNumberTextures() == 0)
+                continue;
+            if(sheet->last_used_frame + TEXTURE_EVICTION_IDLE_FRAMES > _frame_number)
+                continue;
+            if(coldest_sheet == nullptr || sheet->last_used_frame < coldest_sheet->last_used_frame)
+                coldest_sheet = sheet;
         }
-    } // for (std::map<string, ImageTexture*>::iterator i = _images.begin(); i != _images.end(); i++)
 
-    // Regenerate all font textures
-    for(std::set<TextTexture *>::iterator i = _text_images.begin(); i != _text_images.end(); ++i) {
-        if((*i)->texture_sheet == sheet) {
-            if((*i)->Reload() == false) {
-                IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to reload a TextTexture" << std::endl;
-                success = false;
-            }
+        // Every sheet is in use: The budget is simply too small.
+        if(coldest_sheet == nullptr)
+            break;
+
+        const uint32_t idle_frames = _frame_number - coldest_sheet->last_used_frame;
+        if(coldest_sheet->Evict() == false) {
+            IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to evict a texture sheet" << std::endl;
+            break;
         }
+
+        IF_PRINT_DEBUG(VIDEO_DEBUG) << "Evicted a texture sheet unused for " << idle_frames << " frames" << std::endl;
+        resident_bytes -= coldest_sheet->GetMemorySize();
     }
+}
 
-    return success;
-} // bool TextureController::_ReloadImagesToSheet(TexSheet* sheet)
+void TextureController::_UpdatePendingUploads()
+{
+    if(_pending_reloads.empty())
+        return;
+
+    // Always upload at least one image, so that the reload progresses whatever the budget.
+    uint32_t uploaded_bytes = 0;
+    while(!_pending_reloads.empty() && (uploaded_bytes == 0 || uploaded_bytes < _upload_budget)) {
+        const uint64_t key = _pending_reloads.front();
+        _pending_reloads.pop_front();
+
+        // The image might have been deleted, or its sheet unloaded, meanwhile.
+        std::unordered_map<uint64_t, ImageTexture *>::const_iterator it = _images.find(key);
+        if(it == _images.end())
+            continue;
+        ImageTexture *img = it->second;
+        if(img->texture_sheet == nullptr || !img->texture_sheet->loaded)
+            continue;
+
+        if(_ReloadImage(img) == false)
+            IF_PRINT_WARNING(VIDEO_DEBUG) << "failed to reload image: " << img->filename << std::endl;
+
+        uploaded_bytes += img->width * img->height * 4;
+    }
+}
 
+bool TextureController::_LoadImageMemory(const std::string& filename, ImageMemory& image)
+{
+    if (_image_decoder != nullptr && _image_decoder->IsRequested(filename))
+        return _image_decoder->Take(filename, image);
 
+    return image.LoadImage(filename);
+}
 
 void TextureController::_RegisterImageTexture(ImageTexture *img)
 {
@@ -461,13 +860,15 @@ void TextureController::_RegisterImageTexture(ImageTexture *img)
         return;
     }
 
-    std::string nametag = img->filename + img->tags;
-    if(_IsImageTextureRegistered(nametag)) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "this ImageTexture was already registered: " << nametag << std::endl;
+    if(!_images.insert(std::make_pair(_GetImageTextureKey(img->path_id, img->tag), img)).second) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "this ImageTexture was already registered: " << img->filename
+                                      << " (tag: " << img->tag << ")" << std::endl;
         return;
     }
 
-    _images[nametag] = img;
+#ifdef DEBUG_FEATURES
+    vt_system::AssetWatcher::Watch(vt_system::ASSET_IMAGE, img->filename);
+#endif
 }
 
 
@@ -479,10 +880,11 @@ void TextureController::_UnregisterImageTexture(ImageTexture *img)
         return;
     }
 
-    std::string nametag = img->filename + img->tags;
-    std::map<std::string, private_video::ImageTexture *>::iterator img_iter = _images.find(nametag);
-    if(img_iter == _images.end()) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "this ImageTexture was not registered: " << nametag << std::endl;
+    // An image unregistered early may have been replaced under its key meanwhile.
+    std::unordered_map<uint64_t, private_video::ImageTexture *>::iterator img_iter =
+        _images.find(_GetImageTextureKey(img->path_id, img->tag));
+    if(img_iter == _images.end() || img_iter->second != img) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "this ImageTexture was not registered: " << img->filename << std::endl;
         return;
     }
     _images.erase(img_iter);
@@ -503,6 +905,7 @@ void TextureController::_RegisterTextTexture(TextTexture *tex)
     }
 
     _text_images.insert(tex);
+    _shared_text_images.insert(std::make_pair(_HashTextTexture(tex->string, tex->style), tex));
 }
 
 
@@ -520,6 +923,58 @@ void TextureController::_UnregisterTextTexture(TextTexture *tex)
         return;
     }
     _text_images.erase(tex_iter);
+
+    typedef std::unordered_multimap<size_t, TextTexture *>::iterator SharedTextIterator;
+    std::pair<SharedTextIterator, SharedTextIterator> range =
+        _shared_text_images.equal_range(_HashTextTexture(tex->string, tex->style));
+    for(SharedTextIterator it = range.first; it != range.second; ++it) {
+        if(it->second == tex) {
+            _shared_text_images.erase(it);
+            break;
+        }
+    }
+}
+
+
+
+TextTexture *TextureController::_GetSharedTextTexture(const vt_utils::ustring &string, const TextStyle &style) const
+{
+    typedef std::unordered_multimap<size_t, TextTexture *>::const_iterator SharedTextIterator;
+    std::pair<SharedTextIterator, SharedTextIterator> range =
+        _shared_text_images.equal_range(_HashTextTexture(string, style));
+    for(SharedTextIterator it = range.first; it != range.second; ++it) {
+        const TextTexture* tex = it->second;
+
+        // Only share the textures actually rendered.
+        if(tex->texture_sheet == nullptr)
+            continue;
+
+        if(tex->string == string
+                && tex->style.GetFontName() == style.GetFontName()
+                && tex->style.GetColor() == style.GetColor()
+                && tex->style.GetShadowStyle() == style.GetShadowStyle()
+                && tex->style.GetShadowOffsetX() == style.GetShadowOffsetX()
+                && tex->style.GetShadowOffsetY() == style.GetShadowOffsetY())
+            return it->second;
+    }
+    return nullptr;
+}
+
+
+
+size_t TextureController::_HashTextTexture(const vt_utils::ustring &string, const TextStyle &style)
+{
+    // FNV-1a over the characters, mixed with the font, the shadow and the color.
+    size_t hash = 2166136261u;
+    for(size_t i = 0; i < string.length(); ++i)
+        hash = (hash ^ string[i]) * 16777619u;
+
+    hash = (hash ^ std::hash<std::string>()(style.GetFontName())) * 16777619u;
+    hash = (hash ^ static_cast<size_t>(style.GetShadowStyle())) * 16777619u;
+    const Color& color = style.GetColor();
+    for(int32_t i = 0; i < 4; ++i)
+        hash = (hash ^ static_cast<size_t>(color[i] * 255.0f)) * 16777619u;
+    return hash;
 }
 
 
@@ -23,11 +23,14 @@
 #define __TEXTURE_CONTROLLER_HEADER__
 
 #include "utils/singleton.h"
+#include "utils/ustring.h"
 
 #include "texture.h"
 #include "image_base.h"
 
+#include <deque>
 #include <map>
+#include <unordered_map>
 
 namespace vt_mode_manager {
 class ParticleSystem;
@@ -36,10 +39,25 @@ class ParticleSystem;
 namespace vt_video
 {
 
+namespace gl {
+class PixelUploadBuffer;
+}
+
+class TextStyle;
+
 namespace private_video {
+class GlyphAtlas;
+class ImageDecoder;
 class TextTexture;
 }
 
+//! \brief The width and height of the texture sheets of the sprite atlas.
+const int32_t VIDEO_SPRITE_ATLAS_SIZE = 2048;
+
+//! \brief The bytes of images reuploaded per frame by default when the texture sheets are reloaded,
+//! about a 1024x1024 sheet.
+const uint32_t VIDEO_DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024;
+
 class TextureController : public vt_utils::Singleton<TextureController>
 {
     friend class vt_utils::Singleton<TextureController>;
@@ -49,8 +67,10 @@ class TextureController : public vt_utils::Singleton<TextureController>
     friend class StillImage;
     friend class private_video::ImageTexture;
     friend class private_video::TextTexture;
+    friend class private_video::GlyphAtlas;
     friend class TextSupervisor;
     friend class TextImage;
+    friend class StaticImageLayer;
     friend class private_video::TexSheet;
     friend class private_video::FixedTexSheet;
     friend class private_video::VariableTexSheet;
@@ -73,21 +93,185 @@ public:
     **/
     void DEBUG_ShowTexSheet();
 
+#ifdef DEBUG_FEATURES
+    /** \brief Uploads again, in place, the images of a file which changed on disk.
+    *** \param filename The image file, whose size must not have changed.
+    *** \return False if the file couldn't be loaded, or its size changed: Its images are then left as they were.
+    *** \note Called by the asset watcher. The images of an unloaded texture sheet are read when it's reloaded.
+    **/
+    bool DEBUG_ReloadImageFile(const std::string& filename);
+#endif
+
+    /** \brief Starts decoding an image file in the background, so that loading it later doesn't stall.
+    *** \param filename The image file that will be loaded soon.
+    *** \note Loading the image afterwards only waits for the end of its decoding, if needed,
+    *** and uploads it to a texture sheet. Nothing is done if the image is already loaded.
+    **/
+    void PrefetchImage(const std::string& filename);
+
+    /** \brief Returns the id of an image file path, interning it the first time.
+    *** \note The ids stay valid until the game exits. Code loading the same files often
+    *** can keep their ids, and give them to the loading functions to skip hashing the paths.
+    **/
+    uint32_t InternImagePath(const std::string& filename);
+
+    /** \brief Tells whether a prefetched image is decoded, so that loading it won't wait.
+    *** \note This is also true for images which aren't being decoded at all.
+    **/
+    bool IsImageReady(const std::string& filename) const;
+
+    /** \brief Forgets a prefetched image which finally doesn't need to be loaded.
+    *** \param filename The prefetched image file.
+    **/
+    void CancelPrefetchedImage(const std::string& filename);
+
+    /** \brief Loads a texture atlas baked offline by tools/bake-texture-atlas.py
+    *** \param filename The Lua manifest of the atlas, giving the atlas image and where each image lies in it
+    *** \return False if the atlas couldn't be loaded
+    *** \note The images of the atlas are uploaded at once, and loading them afterwards
+    *** only references the atlas without reading their own file. Images already loaded are skipped.
+    **/
+    bool LoadTextureAtlas(const std::string& filename);
+
+    /** \brief Releases the images of a texture atlas
+    *** \param filename The Lua manifest of the atlas
+    *** \note The images still in use stay loaded until they are released.
+    **/
+    void UnloadTextureAtlas(const std::string& filename);
+
+    /** \brief Packs the images loaded from now on together, in the sprite atlas sheets.
+    *** Used while a map loads, so that the animation frames of its sprites share as few
+    *** texture sheets as possible, and that crowds of sprites are drawn in a single batch.
+    *** \note The images already loaded keep their texture sheet, as well as the static ones
+    *** and the ones larger than 512 pixels. The sprite atlas sheets left empty are released.
+    **/
+    void BeginSpriteAtlas();
+
+    //! \brief Stops packing the images loaded in the sprite atlas sheets.
+    void EndSpriteAtlas() {
+        _sprite_atlas_active = false;
+    }
+
+    /** \brief Sets how many bytes of images can be reuploaded per frame when texture sheets are reloaded.
+    *** \param bytes The upload budget per frame, or 0 to reload the sheets at once.
+    *** \note A non-zero budget spreads the reloads over the next frames, leaving the sheets
+    *** partly blank meanwhile. At least one image is reuploaded per frame whatever the budget.
+    **/
+    void SetUploadBudget(uint32_t bytes) {
+        _upload_budget = bytes;
+    }
+
+    uint32_t GetUploadBudget() const {
+        return _upload_budget;
+    }
+
+    //! \brief Tells whether images are still waiting to be reuploaded to their texture sheet.
+    bool HasPendingUploads() const {
+        return !_pending_reloads.empty();
+    }
+
+    //! \brief Returns the number of images waiting to be reuploaded to their texture sheet.
+    uint32_t GetPendingUploadCount() const {
+        return static_cast<uint32_t>(_pending_reloads.size());
+    }
+
+    /** \brief Sets the video memory the texture sheets may use before the least recently used ones are evicted.
+    *** \param bytes The texture memory budget, or 0 to keep every sheet resident.
+    *** \note Only the sheets which aren't static and have been unused for a while are evicted.
+    *** Their pixels are kept in system memory, and restored the next time they are bound.
+    **/
+    void SetTextureMemoryBudget(uint32_t bytes) {
+        _texture_memory_budget = bytes;
+    }
+
+    uint32_t GetTextureMemoryBudget() const {
+        return _texture_memory_budget;
+    }
+
+    //! \brief Returns the video memory used by the resident texture sheets, in bytes.
+    uint32_t GetTextureMemoryUsage() const;
+
+    /** \brief Returns the memory used by each texture sheet, as written in the memory reports.
+    *** The part of each sheet used by the rendered texts is given as well.
+    **/
+    std::string GetMemoryReport() const;
+
 private:
     virtual ~TextureController() override;
 
     //! \brief A vector containing all of the texture sheets currently being managed by this class
     std::vector<private_video::TexSheet *> _tex_sheets;
 
-    //! \brief A STL map containing all of the images currently being managed by this class
-    std::map<std::string, private_video::ImageTexture *> _images;
+    //! \brief All of the images currently being managed by this class, by their path id and tag key.
+    std::unordered_map<uint64_t, private_video::ImageTexture *> _images;
+
+    //! \brief The ids of the image file paths interned, counting from 1.
+    std::unordered_map<std::string, uint32_t> _image_path_ids;
+
+    //! \brief The next id given to an image created procedurally, never interned to not pile up their names.
+    uint32_t _next_procedural_path_id;
 
     //! \brief A STL set containing all of the text images currently being managed by this class
     std::set<private_video::TextTexture *> _text_images;
 
+    //! \brief The rendered text textures, indexed by their string and style hash, to share the identical ones.
+    std::unordered_multimap<size_t, private_video::TextTexture *> _shared_text_images;
+
     //! \brief An index to _tex_sheets of the current texture sheet being shown in debug mode. -1 indicates no sheet
     int32_t _debug_current_sheet;
 
+    /** \brief The OpenGL ID of the texture currently bound.
+    *** Code binding textures without _BindTexture() must update it.
+    **/
+    GLuint _bound_texture_id;
+
+    //! \brief The worker threads decoding the prefetched images.
+    private_video::ImageDecoder* _image_decoder;
+
+    //! \brief The pixel buffer staging the uploads to the texture sheets.
+    gl::PixelUploadBuffer* _pixel_upload_buffer;
+
+    //! \brief The number of bytes of images reuploaded per frame, or 0 for no limit.
+    uint32_t _upload_budget;
+
+    //! \brief The keys of the images waiting to be reuploaded to their texture sheet.
+    std::deque<uint64_t> _pending_reloads;
+
+    //! \brief A loaded texture atlas: its own texture sheet, and the images it references in it.
+    class _TextureAtlas
+    {
+    public:
+        _TextureAtlas() :
+            sheet(nullptr)
+        {}
+
+        private_video::TexSheet *sheet;
+        std::vector<private_video::ImageTexture *> images;
+    };
+
+    //! \brief The loaded texture atlases, by manifest filename.
+    std::map<std::string, _TextureAtlas> _texture_atlases;
+
+    /** \brief The texture sheet of the last screen capture.
+    *** Once the capture is released, the sheet is kept to copy the next capture in it.
+    **/
+    private_video::TexSheet *_capture_sheet;
+
+    //! \brief Whether _capture_sheet holds a capture in use.
+    bool _capture_sheet_used;
+
+    //! \brief Whether the images loaded are packed in the sprite atlas sheets.
+    bool _sprite_atlas_active;
+
+    //! \brief The texture sheets of the sprite atlas, only receiving images between BeginSpriteAtlas() and EndSpriteAtlas().
+    std::vector<private_video::TexSheet *> _sprite_atlas_sheets;
+
+    //! \brief The video memory the texture sheets may use, or 0 for no limit.
+    uint32_t _texture_memory_budget;
+
+    //! \brief The number of the current frame, used to know when the texture sheets were last bound.
+    uint32_t _frame_number;
+
     // ---------- Private methods
 
     //! \name Texture Operations
@@ -99,12 +283,18 @@ private:
     **/
     GLuint _CreateBlankGLTexture(int32_t width, int32_t height);
 
-    /** \brief A wrapper to glBindTexture() that also adds checking to eliminate redundant texture binding
+    /** \brief A wrapper to glBindTexture() that also draws the queued sprites when the texture changes
     *** \param tex_id The integer handle to the OpenGL texture to bind
-    *** \note Redundancy checks are already implemented by most drivers, but this is a double check "just in case"
+    *** \note Nothing is done when the texture is already bound.
     **/
     void _BindTexture(GLuint tex_id);
 
+    /** \brief Binds a texture sheet, restoring it first if it was evicted from video memory
+    *** \param sheet The texture sheet to bind
+    *** \note The sheet is marked as used during the current frame.
+    **/
+    void _BindTexSheet(private_video::TexSheet *sheet);
+
     /** \brief A wrapper to glDeleteTextures() that also adds checking to eliminate redundant texture binding
     *** \param tex_id The integer handle to the OpenGL texture to delete
      */
@@ -127,6 +317,12 @@ private:
     **/
     void _RemoveSheet(private_video::TexSheet *sheet);
 
+    /** \brief Returns a texture sheet to copy a screen capture in
+    *** \note The sheet of the previous capture is reused when released, and of the same size.
+    *** It is given back to _RemoveSheet() like the other sheets.
+    **/
+    private_video::TexSheet *_CreateCaptureSheet(int32_t width, int32_t height);
+
     /** \brief Inserts an image into a compatible texture sheet
     *** \param image A pointer to the image to insert
     *** \param load_info The attributes of the image to be inserted
@@ -144,34 +340,71 @@ private:
     *** \return True only if every single image owned by the TexSheet was successfully reloaded back into it
     **/
     bool _ReloadImagesToSheet(private_video::TexSheet *sheet);
+
+    /** \brief Reloads a single image back into its texture sheet
+    *** \param img A pointer to the image to reload, the multi images being reloaded whole
+    *** \return True if the image was successfully reloaded
+    **/
+    bool _ReloadImage(private_video::ImageTexture *img);
+
+    //! \brief Reuploads the pending images within the per-frame upload budget. Called once per frame.
+    void _UpdatePendingUploads();
+
+    //! \brief Evicts the least recently used texture sheets while over the texture memory budget. Called once per frame.
+    void _UpdateTextureResidency();
+
+    /** \brief Loads the pixels of an image file, taking them from the prefetched images when possible
+    *** \param filename The image file to load
+    *** \param image The image memory where to place the pixels
+    *** \return True if the image was loaded successfully, false if it was not
+    **/
+    bool _LoadImageMemory(const std::string& filename, private_video::ImageMemory& image);
     //@}
 
     //! \name Image Texture Operations
     //@{
     /** \brief Adds an image texture to the map registery
-    *** \param img A pointer to the ImageTexture to add with its filename and tags members correctly set
+    *** \param img A pointer to the ImageTexture to add with its path id and tag members correctly set
     **/
     void _RegisterImageTexture(vt_video::private_video::ImageTexture *img);
 
     /** \brief Removes an image texture from the map registery
-    *** \param img A pointer to the ImageTexture to remove with its filename and tags members correctly set
+    *** \param img A pointer to the ImageTexture to remove with its path id and tag members correctly set
     **/
     void _UnregisterImageTexture(vt_video::private_video::ImageTexture *img);
 
+    //! \brief Returns the key of an image in the map registery.
+    static uint64_t _GetImageTextureKey(uint32_t path_id, uint32_t tag) {
+        return (static_cast<uint64_t>(path_id) << 32) | tag;
+    }
+
+    //! \brief Returns the id of an image file path already interned, or INVALID_IMAGE_PATH.
+    uint32_t _FindImagePath(const std::string& filename) const {
+        std::unordered_map<std::string, uint32_t>::const_iterator it = _image_path_ids.find(filename);
+        return it != _image_path_ids.end() ? it->second : private_video::INVALID_IMAGE_PATH;
+    }
+
+    //! \brief Returns a unique path id for an image created procedurally.
+    uint32_t _GetProceduralImagePath() {
+        return _next_procedural_path_id++;
+    }
+
     /** \brief Determines if an ImageTexture is currently registered
-    *** \param nametag The filename + tag string data to use as the map key
+    *** \param path_id The interned path id of the image file
+    *** \param tag The part of the image file, IMAGE_TAG_NONE for the whole file
     *** \return True if the ImageTexture is already registered, false if it is not
     **/
-    bool _IsImageTextureRegistered(const std::string &nametag) const {
-        return (_images.find(nametag) != _images.end());
+    bool _IsImageTextureRegistered(uint32_t path_id, uint32_t tag = private_video::IMAGE_TAG_NONE) const {
+        return (_images.find(_GetImageTextureKey(path_id, tag)) != _images.end());
     }
 
-    /** \brief Return the ImageTexture stored under the given nametag (filename + tag)
-    *** \return A pointer to the registered ImageTexture object, or nullptr if the nametag could not be found
+    /** \brief Return the ImageTexture stored under the given path id and tag
+    *** \return A pointer to the registered ImageTexture object, or nullptr if it could not be found
      **/
-    vt_video::private_video::ImageTexture *_GetImageTexture(std::string nametag) {
-        if(_IsImageTextureRegistered(nametag)) return _images[nametag];
-        else return nullptr;
+    vt_video::private_video::ImageTexture *_GetImageTexture(uint32_t path_id, uint32_t tag = private_video::IMAGE_TAG_NONE) {
+        std::unordered_map<uint64_t, private_video::ImageTexture *>::const_iterator it =
+            _images.find(_GetImageTextureKey(path_id, tag));
+        return it != _images.end() ? it->second : nullptr;
     }
     //@}
 
@@ -194,6 +427,14 @@ private:
     bool _IsTextTextureRegistered(private_video::TextTexture *tex) const {
         return (_text_images.find(tex) != _text_images.end());
     }
+
+    /** \brief Returns a registered and rendered TextTexture of the given string and style, to share it.
+    *** \return nullptr when there is none. Add a reference to the returned texture to keep it.
+    **/
+    private_video::TextTexture *_GetSharedTextTexture(const vt_utils::ustring &string, const TextStyle &style) const;
+
+    //! \brief Returns the hash of a text texture string and style.
+    static size_t _HashTextTexture(const vt_utils::ustring &string, const TextStyle &style);
     //@}
 }; // class TextureController : public vt_utils::Singleton<TextureController>
 
@@ -20,7 +20,14 @@
 #include "engine/mode_manager.h"
 #include "script/script_read.h"
 #include "engine/system.h"
+#include "engine/frame_profiler.h"
+#include "engine/input.h"
+#include "engine/job_system.h"
+#include "engine/memory_stats.h"
+#include "engine/video/gl/gl_debug.h"
+#include "engine/video/gl/gl_particle_simulation.h"
 #include "engine/video/gl/gl_particle_system.h"
+#include "engine/video/gl/gl_program_binary_cache.h"
 #include "engine/video/gl/gl_render_target.h"
 #include "engine/video/gl/gl_shader.h"
 #include "engine/video/gl/gl_shader_definitions.h"
@@ -28,10 +35,19 @@
 #include "engine/video/gl/gl_shader_programs.h"
 #include "engine/video/gl/gl_shaders.h"
 #include "engine/video/gl/gl_sprite.h"
+#include "engine/video/gl/gl_sprite_batch.h"
+#include "engine/video/gl/gl_static_sprite_buffer.h"
+#include "engine/video/gl/gl_stream_buffer.h"
 #include "engine/video/gl/gl_transform.h"
+#include "engine/video/particle_updater.h"
+#include "engine/video/screenshot_writer.h"
 
 #include "utils/utils_strings.h"
 
+#include "common/app_settings.h"
+
+#include <algorithm>
+
 using namespace vt_utils;
 using namespace vt_video::private_video;
 
@@ -41,6 +57,62 @@ namespace vt_video
 VideoEngine *VideoManager = nullptr;
 bool VIDEO_DEBUG = false;
 
+//! \brief How many times smaller than the viewport the light render target is.
+const int32_t LIGHT_RENDER_TARGET_DIVISOR = 2;
+
+//! \brief The GPU frame time the dynamic render scale keeps the frames under, in milliseconds.
+const float DYNAMIC_RENDER_SCALE_BUDGET = 14.0f;
+
+//! \brief The share of the budget under which the dynamic render scale is raised again.
+//! The fill rate grows with the square of the scale, hence the margin.
+const float DYNAMIC_RENDER_SCALE_RAISE_RATIO = 0.6f;
+
+//! \brief The frames measured before the dynamic render scale changes, as the render targets are resized then.
+const uint32_t DYNAMIC_RENDER_SCALE_FRAMES = 60;
+
+//! \brief The frames measured before the automatic quality level changes, so that it doesn't flicker.
+const uint32_t AUTO_QUALITY_FRAMES = 120;
+
+//! \brief The shares of the frame budget above which the automatic quality level is lowered,
+//! and under which it is raised again.
+const float AUTO_QUALITY_LOWER_RATIO = 0.9f;
+const float AUTO_QUALITY_RAISE_RATIO = 0.5f;
+
+//! \brief The performance settings of an automatic quality level.
+class AutoQualityLevel
+{
+public:
+    uint32_t particle_density;
+    bool light_flares;
+    bool ambient_overlays;
+};
+
+//! \brief The automatic quality levels, from the lowest one.
+const AutoQualityLevel AUTO_QUALITY_LEVELS[] = {
+    { 25, false, false },
+    { 50, false, true },
+    { 75, true, true },
+    { 100, true, true }
+};
+const uint32_t AUTO_QUALITY_LEVEL_COUNT = sizeof(AUTO_QUALITY_LEVELS) / sizeof(AUTO_QUALITY_LEVELS[0]);
+
+//! \brief Returns a size in pixels at a render scale in percents, of at least one pixel.
+static int32_t GetScaledSize(int32_t size, uint32_t scale)
+{
+    return std::max(1, size * static_cast<int32_t>(scale) / 100);
+}
+
+//! \brief Returns the GPU time of a frame, in milliseconds, or a negative value when not measured.
+static float GetFrameGpuTime(const RenderFrameStats& frame)
+{
+    float gpu_time = -1.0f;
+    for (uint32_t i = 0; i < RENDER_PASS_TOTAL; ++i) {
+        if (frame.gpu_times[i] >= 0.0f)
+            gpu_time = std::max(0.0f, gpu_time) + frame.gpu_times[i];
+    }
+    return gpu_time;
+}
+
 //-----------------------------------------------------------------------------
 // Static variable for the Color class
 //-----------------------------------------------------------------------------
@@ -79,16 +151,29 @@ void RotatePoint(float &x, float &y, float angle)
 VideoEngine::VideoEngine():
     _sdl_window(nullptr),
     _secondary_render_target(nullptr),
+    _light_render_target(nullptr),
+    _layer_cache_render_target(nullptr),
+    _layer_cache_valid(false),
     _fps_display(false),
     _fps_sum(0),
     _current_sample(0),
     _number_samples(0),
     _FPS_textimage(nullptr),
+    _render_stats_textimage(nullptr),
+    _profiler_textimage(nullptr),
+    _memory_textimage(nullptr),
     _gl_error_code(GL_NO_ERROR),
     _gl_blend_is_active(false),
     _gl_texture_2d_is_active(false),
     _gl_stencil_test_is_active(false),
     _gl_scissor_test_is_active(false),
+    _gl_blend_source_factor(GL_ONE),
+    _gl_blend_destination_factor(GL_ZERO),
+    _gl_stencil_function(GL_ALWAYS),
+    _gl_stencil_reference(0),
+    _gl_stencil_mask(0xFFFFFFFF),
+    _gl_scissor_rectangle(-1, -1, -1, -1),
+    _gl_viewport(-1, -1, -1, -1),
     _viewport_x_offset(0),
     _viewport_y_offset(0),
     _viewport_width(0),
@@ -104,16 +189,37 @@ VideoEngine::VideoEngine():
     _temp_width(0),
     _temp_height(0),
     _vsync_mode(0),
+    _render_scale(VIDEO_RENDER_SCALE_MAX),
+    _current_render_scale(VIDEO_RENDER_SCALE_MAX),
+    _sharp_upscaling(false),
+    _dynamic_scale_gpu_time(0.0f),
+    _dynamic_scale_frames(0),
+    _dynamic_scale_frame_number(0),
+    _graphics_quality(VIDEO_QUALITY_HIGH),
+    _particle_density(VIDEO_PARTICLE_DENSITY_MAX),
+    _light_flares(true),
+    _ambient_overlays(true),
+    _frame_cap(VIDEO_FRAME_CAP_NONE),
+    _auto_quality_level(0),
+    _auto_quality_gpu_time(0.0f),
+    _auto_quality_gpu_frames(0),
+    _auto_quality_frames(0),
+    _auto_quality_frame_number(0),
     _game_update_mode(false),
+    _stream_buffer(nullptr),
     _sprite(nullptr),
+    _sprite_batch(nullptr),
+    _current_shader_program(nullptr),
+    _solid_program(nullptr),
+    _solid_grayscale_program(nullptr),
     _particle_system(nullptr),
+    _particle_updater(nullptr),
+    _screenshot_writer(nullptr),
+    _submitted_frames(0),
+    _screen_capture_frame(0),
     _initialized(false)
 {
-    _current_context.blend = 0;
-    _current_context.x_align = -1;
-    _current_context.y_align = -1;
-    _current_context.x_flip = 0;
-    _current_context.y_flip = 0;
+    _current_context.draw_state = DrawState();
     _current_context.coordinate_system = CoordSys(0.0f, VIDEO_STANDARD_RES_WIDTH,
                                                   0.0f, VIDEO_STANDARD_RES_HEIGHT);
     _current_context.viewport = ScreenRect(0, 0,
@@ -124,7 +230,12 @@ VideoEngine::VideoEngine():
                                                     VIDEO_STANDARD_RES_HEIGHT);
     _current_context.scissoring_enabled = false;
 
-    _transform_stack.push(gl::Transform());
+    _transform_stack_size = 1;
+    _transform_stack_overflow = 0;
+
+    // The OpenGL default stencil operations.
+    for(uint32_t i = 0; i < 3; ++i)
+        _gl_stencil_ops[i] = GL_KEEP;
 
     for(uint32_t sample = 0; sample < FPS_SAMPLES; sample++)
         _fps_samples[sample] = 0;
@@ -132,20 +243,47 @@ VideoEngine::VideoEngine():
 
 VideoEngine::~VideoEngine()
 {
+    _screen_capture.Clear();
+
+    // Clean up the screenshot writer, saving the pending screenshots.
+    if (_screenshot_writer != nullptr) {
+        delete _screenshot_writer;
+        _screenshot_writer = nullptr;
+    }
+
     // Clean up the sprite.
     if (_sprite != nullptr) {
         delete _sprite;
         _sprite = nullptr;
     }
 
+    // Clean up the sprite batch.
+    if (_sprite_batch != nullptr) {
+        delete _sprite_batch;
+        _sprite_batch = nullptr;
+    }
+
+    // Stop the particle updater threads.
+    if (_particle_updater != nullptr) {
+        delete _particle_updater;
+        _particle_updater = nullptr;
+    }
+
     // Clean up the particle system.
     if (_particle_system != nullptr) {
         delete _particle_system;
         _particle_system = nullptr;
     }
 
+    // Clean up the stream buffer, once nothing uses it anymore.
+    if (_stream_buffer != nullptr) {
+        delete _stream_buffer;
+        _stream_buffer = nullptr;
+    }
+
     // Clean up the shaders and shader programs.
     glUseProgram(0);
+    _current_shader_program = nullptr;
 
     for (std::map<gl::shader_programs::ShaderPrograms, gl::ShaderProgram*>::iterator i = _programs.begin(); i != _programs.end(); ++i) {
         if (i->second != nullptr) {
@@ -154,6 +292,8 @@ VideoEngine::~VideoEngine()
         }
     }
     _programs.clear();
+    _solid_program = nullptr;
+    _solid_grayscale_program = nullptr;
 
     for (std::map<gl::shaders::Shaders, gl::Shader*>::iterator i = _shaders.begin(); i != _shaders.end(); ++i) {
         if (i->second != nullptr) {
@@ -169,6 +309,18 @@ VideoEngine::~VideoEngine()
         _secondary_render_target = nullptr;
     }
 
+    // Clean up the light render target.
+    if (_light_render_target != nullptr) {
+        delete _light_render_target;
+        _light_render_target = nullptr;
+    }
+
+    // Clean up the layer cache render target.
+    if (_layer_cache_render_target != nullptr) {
+        delete _layer_cache_render_target;
+        _layer_cache_render_target = nullptr;
+    }
+
     TextManager->SingletonDestroy();
 
     _rectangle_image.Clear();
@@ -178,6 +330,21 @@ VideoEngine::~VideoEngine()
         _FPS_textimage = nullptr;
     }
 
+    if (_render_stats_textimage != nullptr) {
+        delete _render_stats_textimage;
+        _render_stats_textimage = nullptr;
+    }
+
+    if (_profiler_textimage != nullptr) {
+        delete _profiler_textimage;
+        _profiler_textimage = nullptr;
+    }
+
+    if (_memory_textimage != nullptr) {
+        delete _memory_textimage;
+        _memory_textimage = nullptr;
+    }
+
     TextureManager->SingletonDestroy();
 }
 
@@ -192,15 +359,37 @@ bool VideoEngine::FinalizeInitialization()
     }
 #endif
 
+    // Set up the OpenGL error reporting.
+    gl::InitializeDebugOutput();
+
+    // Create the stream buffer shared by the sprite, the sprite batch and the particle system.
+    _stream_buffer = new gl::StreamBuffer();
+
     // Create the sprite.
-    _sprite = new gl::Sprite();
+    _sprite = new gl::Sprite(_stream_buffer);
+
+    // Create the sprite batch.
+    _sprite_batch = new gl::SpriteBatch(_stream_buffer);
 
     // Create the secondary render target.
     _secondary_render_target = new gl::RenderTarget(VIDEO_STANDARD_RES_WIDTH,
                                                     VIDEO_STANDARD_RES_HEIGHT);
 
+    // Create the light render target.
+    _light_render_target = new gl::RenderTarget(VIDEO_STANDARD_RES_WIDTH / LIGHT_RENDER_TARGET_DIVISOR,
+                                                VIDEO_STANDARD_RES_HEIGHT / LIGHT_RENDER_TARGET_DIVISOR);
+
+    // The render target leaves no texture bound.
+    TextureManager->_bound_texture_id = 0;
+
     // Create the particle system.
-    _particle_system = new gl::ParticleSystem();
+    _particle_system = new gl::ParticleSystem(_stream_buffer);
+
+    // Create the particle effects update threads.
+    _particle_updater = new vt_mode_manager::ParticleUpdater();
+
+    // Create the screenshot writer.
+    _screenshot_writer = new ScreenshotWriter();
 
     //
     // Create the programmable pipeline.
@@ -210,6 +399,9 @@ bool VideoEngine::FinalizeInitialization()
     gl::Shader* default_vertex =
         new gl::Shader(GL_VERTEX_SHADER,
                        gl::shader_definitions::DEFAULT_VERTEX);
+    gl::Shader* particle_vertex =
+        new gl::Shader(GL_VERTEX_SHADER,
+                       gl::shader_definitions::PARTICLE_VERTEX);
     gl::Shader* solid_color_fragment =
         new gl::Shader(GL_FRAGMENT_SHADER,
                        gl::shader_definitions::SOLID_FRAGMENT);
@@ -222,18 +414,46 @@ bool VideoEngine::FinalizeInitialization()
     gl::Shader* sprite_grayscale_fragment =
         new gl::Shader(GL_FRAGMENT_SHADER,
                        gl::shader_definitions::SPRITE_GRAYSCALE_FRAGMENT);
+    gl::Shader* ambient_effects_fragment =
+        new gl::Shader(GL_FRAGMENT_SHADER,
+                       gl::shader_definitions::AMBIENT_EFFECTS_FRAGMENT);
+    gl::Shader* weather_fragment =
+        new gl::Shader(GL_FRAGMENT_SHADER,
+                       gl::shader_definitions::WEATHER_FRAGMENT);
+    gl::Shader* text_distance_field_fragment =
+        new gl::Shader(GL_FRAGMENT_SHADER,
+                       gl::shader_definitions::TEXT_DISTANCE_FIELD_FRAGMENT);
 
     // Store the shaders.
     _shaders[gl::shaders::VertexDefault] = default_vertex;
+    _shaders[gl::shaders::VertexParticle] = particle_vertex;
     _shaders[gl::shaders::FragmentSolid] = solid_color_fragment;
     _shaders[gl::shaders::FragmentSolidGrayscale] = solid_color_grayscale_fragment;
     _shaders[gl::shaders::FragmentSprite] = sprite_fragment;
     _shaders[gl::shaders::FragmentSpriteGrayscale] = sprite_grayscale_fragment;
+    _shaders[gl::shaders::FragmentAmbientEffects] = ambient_effects_fragment;
+    _shaders[gl::shaders::FragmentWeather] = weather_fragment;
+    _shaders[gl::shaders::FragmentTextDistanceField] = text_distance_field_fragment;
+
+    // The simulation shaders need GLSL 1.30, so they are only built when they can be used.
+    const bool particle_simulation = _particle_system->IsInstancingSupported() &&
+                                     gl::ParticleSimulation::IsSupported();
+    if (particle_simulation) {
+        _shaders[gl::shaders::VertexParticleSimulation] =
+            new gl::Shader(GL_VERTEX_SHADER,
+                           gl::shader_definitions::PARTICLE_SIMULATION_VERTEX);
+        _shaders[gl::shaders::FragmentDiscard] =
+            new gl::Shader(GL_FRAGMENT_SHADER,
+                           gl::shader_definitions::DISCARD_FRAGMENT);
+    }
 
     //
     // Create the shader programs.
     //
 
+    // The programs linked by the previous runs are loaded instead of linking their shaders again.
+    gl::ProgramBinaryCache::Initialize(vt_common::GetUserCachePath() + "shaders/");
+
     std::vector<std::string> attributes;
     attributes.push_back("in_Vertex");
     attributes.push_back("in_TexCoords");
@@ -259,6 +479,34 @@ bool VideoEngine::FinalizeInitialization()
                               _shaders[gl::shaders::FragmentSpriteGrayscale],
                               attributes);
 
+    gl::ShaderProgram* ambient_effects_program =
+        new gl::ShaderProgram(_shaders[gl::shaders::VertexDefault],
+                              _shaders[gl::shaders::FragmentAmbientEffects],
+                              attributes);
+
+    gl::ShaderProgram* weather_program =
+        new gl::ShaderProgram(_shaders[gl::shaders::VertexDefault],
+                              _shaders[gl::shaders::FragmentWeather],
+                              attributes);
+
+    gl::ShaderProgram* text_distance_field_program =
+        new gl::ShaderProgram(_shaders[gl::shaders::VertexDefault],
+                              _shaders[gl::shaders::FragmentTextDistanceField],
+                              attributes);
+
+    // The particle instances attributes, in the slots used by gl::ParticleSystem.
+    std::vector<std::string> particle_attributes;
+    particle_attributes.push_back("in_Corner");
+    particle_attributes.push_back("in_Position");
+    particle_attributes.push_back("in_HalfSize");
+    particle_attributes.push_back("in_Rotation");
+    particle_attributes.push_back("in_Color");
+
+    gl::ShaderProgram* particle_program =
+        new gl::ShaderProgram(_shaders[gl::shaders::VertexParticle],
+                              _shaders[gl::shaders::FragmentSprite],
+                              particle_attributes);
+
     //
     // Store the shader programs.
     //
@@ -267,6 +515,47 @@ bool VideoEngine::FinalizeInitialization()
     _programs[gl::shader_programs::SolidGrayscale] = solid_grayscale_program;
     _programs[gl::shader_programs::Sprite] = sprite_program;
     _programs[gl::shader_programs::SpriteGrayscale] = sprite_grayscale_program;
+    _programs[gl::shader_programs::Particle] = particle_program;
+    _programs[gl::shader_programs::AmbientEffects] = ambient_effects_program;
+    _programs[gl::shader_programs::Weather] = weather_program;
+    _programs[gl::shader_programs::TextDistanceField] = text_distance_field_program;
+    _solid_program = solid_program;
+    _solid_grayscale_program = solid_grayscale_program;
+
+    // The simulated particles attributes, in the slots used by gl::ParticleSimulation.
+    // The outputs are written in the same layout.
+    if (particle_simulation) {
+        const char* simulation_names[] = { "Position", "HalfSize", "Rotation", "Color",
+                                           "Velocity", "Time", "Seed", "Angle", "Emission" };
+        std::vector<std::string> simulation_attributes;
+        std::vector<std::string> simulation_varyings;
+        for (uint32_t i = 0; i < sizeof(simulation_names) / sizeof(simulation_names[0]); ++i) {
+            simulation_attributes.push_back(std::string("in_") + simulation_names[i]);
+            simulation_varyings.push_back(std::string("out_") + simulation_names[i]);
+        }
+
+        _programs[gl::shader_programs::ParticleSimulation] =
+            new gl::ShaderProgram(_shaders[gl::shaders::VertexParticleSimulation],
+                                  _shaders[gl::shaders::FragmentDiscard],
+                                  simulation_attributes,
+                                  simulation_varyings);
+    }
+
+    // The programs drawing every frame are built now, the rarely used ones over the next frames.
+    uint32_t cached_programs = 0;
+    const gl::shader_programs::ShaderPrograms startup_programs[] = {
+        gl::shader_programs::Solid, gl::shader_programs::Sprite, gl::shader_programs::Particle,
+        gl::shader_programs::TextDistanceField
+    };
+    for (uint32_t i = 0; i < sizeof(startup_programs) / sizeof(startup_programs[0]); ++i) {
+        gl::ShaderProgram* program = _programs[startup_programs[i]];
+        program->Build();
+        if (program->IsFromCache())
+            ++cached_programs;
+    }
+    IF_PRINT_DEBUG(VIDEO_DEBUG) << "Shader programs loaded from the cache: " << cached_programs << " / "
+                                << sizeof(startup_programs) / sizeof(startup_programs[0]) << std::endl;
+    _WarmUpShaderPrograms();
 
     // Create instances of the various sub-systems
     TextureManager = TextureController::SingletonCreate();
@@ -306,68 +595,29 @@ bool VideoEngine::FinalizeInitialization()
 
 void VideoEngine::SetDrawFlags(int32_t first_flag, ...)
 {
+    DrawFlags flags;
     int32_t flag = first_flag;
     va_list args;
 
     va_start(args, first_flag);
     while(flag != 0) {
-        switch(flag) {
-        case VIDEO_X_LEFT:
-            _current_context.x_align = -1;
-            break;
-        case VIDEO_X_CENTER:
-            _current_context.x_align = 0;
-            break;
-        case VIDEO_X_RIGHT:
-            _current_context.x_align = 1;
-            break;
-
-        case VIDEO_Y_TOP:
-            _current_context.y_align = 1;
-            break;
-        case VIDEO_Y_CENTER:
-            _current_context.y_align = 0;
-            break;
-        case VIDEO_Y_BOTTOM:
-            _current_context.y_align = -1;
-            break;
-
-        case VIDEO_X_NOFLIP:
-            _current_context.x_flip = 0;
-            break;
-        case VIDEO_X_FLIP:
-            _current_context.x_flip = 1;
-            break;
-
-        case VIDEO_Y_NOFLIP:
-            _current_context.y_flip = 0;
-            break;
-        case VIDEO_Y_FLIP:
-            _current_context.y_flip = 1;
-            break;
-
-        case VIDEO_NO_BLEND:
-            _current_context.blend = 0;
-            break;
-        case VIDEO_BLEND:
-            _current_context.blend = 1;
-            break;
-        case VIDEO_BLEND_ADD:
-            _current_context.blend = 2;
-            break;
-
-        default:
+        if (flag > VIDEO_DRAW_FLAGS_INVALID && flag < VIDEO_DRAW_FLAGS_TOTAL) {
+            flags.Set(static_cast<VIDEO_DRAW_FLAGS>(flag));
+        } else {
             IF_PRINT_WARNING(VIDEO_DEBUG) << "Unknown flag in argument list: "
                                           << flag << std::endl;
-            break;
         }
         flag = va_arg(args, int32_t);
     }
     va_end(args);
+
+    _current_context.draw_state.Apply(flags);
 }
 
 void VideoEngine::Clear()
 {
+    FlushSpriteBatch();
+
     glClear(GL_COLOR_BUFFER_BIT |
             GL_DEPTH_BUFFER_BIT |
             GL_STENCIL_BUFFER_BIT);
@@ -375,10 +625,24 @@ void VideoEngine::Clear()
 
 void VideoEngine::Update()
 {
-    uint32_t frame_time = vt_system::SystemManager->GetUpdateTime();
+    uint32_t frame_time = vt_system::SystemManager->GetFrameTime();
 
     _screen_fader.Update(frame_time);
 
+    TextureManager->_UpdatePendingUploads();
+    TextureManager->_UpdateTextureResidency();
+
+    if (_screenshot_writer != nullptr)
+        _screenshot_writer->Update();
+
+    // The game is updated once its frame is drawn.
+    _render_stats.SetTimersEnabled(_fps_display || _render_stats.IsExportingCsv()
+                                   || _render_scale == VIDEO_RENDER_SCALE_DYNAMIC
+                                   || _graphics_quality == VIDEO_QUALITY_AUTO);
+    _render_stats.EndFrame();
+    _UpdateDynamicRenderScale();
+    _UpdateAutoQuality();
+
     if (_fps_display)
         _UpdateFPS();
 }
@@ -390,6 +654,11 @@ void VideoEngine::DrawDebugInfo()
 
     if (_fps_display)
         _DrawFPS();
+
+#ifdef DEBUG_FEATURES
+    _DrawProfilerOverlay();
+    _DrawMemoryOverlay();
+#endif
 }
 
 bool VideoEngine::CheckGLError() {
@@ -480,11 +749,10 @@ bool VideoEngine::ApplySettings()
     _screen_height = _temp_height;
     _fullscreen = _temp_fullscreen;
 
+    // The window mode changes keep the OpenGL context and the textures:
+    // Only the viewport and the render targets follow the new size.
     _UpdateViewportMetrics();
-
-    // Resize the secondary render target.
-    assert(_secondary_render_target != nullptr);
-    _secondary_render_target->Resize(_screen_width, _screen_height);
+    _ResizeRenderTargets();
 
     // Try to apply the VSync mode
     if (_vsync_mode > 2) {
@@ -511,6 +779,26 @@ bool VideoEngine::ApplySettings()
     return true;
 }
 
+void VideoEngine::OnWindowResized()
+{
+    if (!_sdl_window)
+        return;
+
+    int32_t width = 0;
+    int32_t height = 0;
+    SDL_GL_GetDrawableSize(_sdl_window, &width, &height);
+    if (width <= 0 || height <= 0)
+        return;
+    if (width == _screen_width && height == _screen_height)
+        return;
+
+    IF_PRINT_DEBUG(VIDEO_DEBUG) << "Window resized to " << width << "x" << height << std::endl;
+    _screen_width = _temp_width = width;
+    _screen_height = _temp_height = height;
+    _UpdateViewportMetrics();
+    _ResizeRenderTargets();
+}
+
 //-----------------------------------------------------------------------------
 // VideoEngine class - Coordinate system and viewport methods
 //-----------------------------------------------------------------------------
@@ -535,11 +823,17 @@ void VideoEngine::SetCoordSys(const CoordSys &coordinate_system)
     float m13 = -(top + bottom) / (top - bottom);
     float m23 = -(far_z + near_z) / (far_z - near_z);
 
+    gl::Transform projection(m00, 0.0f, 0.0f, m03,
+                             0.0f, m11, 0.0f, m13,
+                             0.0f, 0.0f, m22, m23,
+                             0.0f, 0.0f, 0.0f, 1.0f);
+
+    // The queued sprites use the projection they were queued with.
+    if (projection != _projection)
+        FlushSpriteBatch();
+
     // Store the orthographic projection.
-    _projection = gl::Transform(m00, 0.0f, 0.0f, m03,
-                                0.0f, m11, 0.0f, m13,
-                                0.0f, 0.0f, m22, m23,
-                                0.0f, 0.0f, 0.0f, 1.0f);
+    _projection = projection;
 }
 
 void VideoEngine::GetCurrentViewport(float &x, float &y,
@@ -564,11 +858,28 @@ void VideoEngine::SetViewport(float x, float y, float width, float height)
         return;
     }
 
+    if (_viewport_x_offset != static_cast<int32_t>(x) ||
+            _viewport_y_offset != static_cast<int32_t>(y) ||
+            _viewport_width != static_cast<int32_t>(width) ||
+            _viewport_height != static_cast<int32_t>(height)) {
+        FlushSpriteBatch();
+    }
+
     _viewport_x_offset = x;
     _viewport_y_offset = y;
     _viewport_width = width;
     _viewport_height = height;
 
+    // PopState() restores the viewport every time, even when it didn't change.
+    if (_gl_viewport.left == _viewport_x_offset &&
+            _gl_viewport.top == _viewport_y_offset &&
+            _gl_viewport.width == _viewport_width &&
+            _gl_viewport.height == _viewport_height) {
+        return;
+    }
+
+    _gl_viewport = ScreenRect(_viewport_x_offset, _viewport_y_offset,
+                              _viewport_width, _viewport_height);
     glViewport(_viewport_x_offset, _viewport_y_offset,
                _viewport_width, _viewport_height);
 }
@@ -576,32 +887,40 @@ void VideoEngine::SetViewport(float x, float y, float width, float height)
 void VideoEngine::EnableBlending()
 {
     if(!_gl_blend_is_active) {
+        FlushSpriteBatch();
         glEnable(GL_BLEND);
         _gl_blend_is_active = true;
+        _render_stats.AddStateChange();
     }
 }
 
 void VideoEngine::DisableBlending()
 {
     if(_gl_blend_is_active) {
+        FlushSpriteBatch();
         glDisable(GL_BLEND);
         _gl_blend_is_active = false;
+        _render_stats.AddStateChange();
     }
 }
 
 void VideoEngine::EnableStencilTest()
 {
     if(!_gl_stencil_test_is_active) {
+        FlushSpriteBatch();
         glEnable(GL_STENCIL_TEST);
         _gl_stencil_test_is_active = true;
+        _render_stats.AddStateChange();
     }
 }
 
 void VideoEngine::DisableStencilTest()
 {
     if(_gl_stencil_test_is_active) {
+        FlushSpriteBatch();
         glDisable(GL_STENCIL_TEST);
         _gl_stencil_test_is_active = false;
+        _render_stats.AddStateChange();
     }
 }
 
@@ -621,61 +940,364 @@ void VideoEngine::DisableTexture2D()
     }
 }
 
+void VideoEngine::SetBlendFunc(GLenum source_factor, GLenum destination_factor)
+{
+    if (_gl_blend_source_factor != source_factor ||
+            _gl_blend_destination_factor != destination_factor) {
+        FlushSpriteBatch();
+        glBlendFunc(source_factor, destination_factor);
+        _gl_blend_source_factor = source_factor;
+        _gl_blend_destination_factor = destination_factor;
+        _render_stats.AddStateChange();
+    }
+}
+
+void VideoEngine::SetStencilFunc(GLenum function, GLint reference, GLuint mask)
+{
+    if (_gl_stencil_function != function ||
+            _gl_stencil_reference != reference ||
+            _gl_stencil_mask != mask) {
+        FlushSpriteBatch();
+        glStencilFunc(function, reference, mask);
+        _gl_stencil_function = function;
+        _gl_stencil_reference = reference;
+        _gl_stencil_mask = mask;
+        _render_stats.AddStateChange();
+    }
+}
+
+void VideoEngine::SetStencilOp(GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass)
+{
+    if (_gl_stencil_ops[0] != stencil_fail ||
+            _gl_stencil_ops[1] != depth_fail ||
+            _gl_stencil_ops[2] != depth_pass) {
+        FlushSpriteBatch();
+        glStencilOp(stencil_fail, depth_fail, depth_pass);
+        _gl_stencil_ops[0] = stencil_fail;
+        _gl_stencil_ops[1] = depth_fail;
+        _gl_stencil_ops[2] = depth_pass;
+        _render_stats.AddStateChange();
+    }
+}
+
 void VideoEngine::EnableSecondaryRenderTarget()
 {
     assert(_secondary_render_target != nullptr);
+    FlushSpriteBatch();
     _secondary_render_target->Bind();
+
+    // The screen viewport, scaled like the render target is.
+    const float scale_x = static_cast<float>(_secondary_render_target->GetWidth()) / _screen_width;
+    const float scale_y = static_cast<float>(_secondary_render_target->GetHeight()) / _screen_height;
+    SetViewport(_current_context.viewport.left * scale_x,
+                _current_context.viewport.top * scale_y,
+                std::max(1.0f, _current_context.viewport.width * scale_x),
+                std::max(1.0f, _current_context.viewport.height * scale_y));
 }
 
 void VideoEngine::DisableSecondaryRenderTarget()
 {
+    FlushSpriteBatch();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    SetViewport(_current_context.viewport.left,
+                _current_context.viewport.top,
+                _current_context.viewport.width,
+                _current_context.viewport.height);
 }
 
 void VideoEngine::DrawSecondaryRenderTarget()
 {
-    assert(_sprite != nullptr);
     assert(_secondary_render_target != nullptr);
 
-    float width_render_target = static_cast<float>(_secondary_render_target->GetWidth());
-    float height_render_target = static_cast<float>(_secondary_render_target->GetHeight());
+    // Draw what was queued in the secondary render target.
+    DisableSecondaryRenderTarget();
+
+    float width_screen = static_cast<float>(_screen_width);
+    float height_screen = static_cast<float>(_screen_height);
 
-    // Set up the video manager state.
+    // Set up the video manager state, to upscale the render target over the whole screen.
     vt_video::VideoManager->PushState();
 
-    vt_video::VideoManager->SetViewport(0.0f, 0.0f, width_render_target, height_render_target);
-    vt_video::VideoManager->SetCoordSys(0.0f, width_render_target, height_render_target, 0.0f);
+    vt_video::VideoManager->SetViewport(0.0f, 0.0f, width_screen, height_screen);
+    vt_video::VideoManager->SetCoordSys(0.0f, width_screen, height_screen, 0.0f);
     vt_video::VideoManager->SetDrawFlags(vt_video::VIDEO_X_LEFT, vt_video::VIDEO_Y_TOP, vt_video::VIDEO_BLEND, 0);
 
     VideoManager->EnableBlending();
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    VideoManager->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    _DrawRenderTarget(_secondary_render_target);
+
+    // Restore the state.
+    vt_video::VideoManager->PopState();
+}
+
+void VideoEngine::EnableLightRenderTarget()
+{
+    assert(_light_render_target != nullptr);
+    FlushSpriteBatch();
+
+    // The standard coordinate system then spans the whole light render target.
+    PushState();
+    _light_render_target->Bind();
+    SetViewport(0.0f, 0.0f,
+                static_cast<float>(_light_render_target->GetWidth()),
+                static_cast<float>(_light_render_target->GetHeight()));
+
+    // Start from no light at all.
+    Clear();
+}
+
+void VideoEngine::DrawLightRenderTarget()
+{
+    assert(_light_render_target != nullptr);
+
+    // Draw what was queued in the light render target.
+    FlushSpriteBatch();
+
+    // Go back to the primary render target and its viewport.
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    PopState();
+
+    // The lights were already weighted by their alpha when accumulated.
+    EnableBlending();
+    SetBlendFunc(GL_ONE, GL_ONE);
+
+    _DrawRenderTarget(_light_render_target);
+}
+
+void VideoEngine::EnableLayerCacheRenderTarget()
+{
+    FlushSpriteBatch();
+
+    // The render target is kept at the viewport size.
+    const unsigned width = static_cast<unsigned>(std::max(1, _current_context.viewport.width));
+    const unsigned height = static_cast<unsigned>(std::max(1, _current_context.viewport.height));
+    if (_layer_cache_render_target == nullptr) {
+        _layer_cache_render_target = new gl::RenderTarget(width, height);
+        TextureManager->_bound_texture_id = 0;
+    }
+    else if (_layer_cache_render_target->GetWidth() != width || _layer_cache_render_target->GetHeight() != height) {
+        _layer_cache_render_target->Resize(width, height);
+        TextureManager->_bound_texture_id = 0;
+    }
+    _layer_cache_valid = false;
+
+    // The current coordinate system then spans the whole render target.
+    PushState();
+    _layer_cache_render_target->Bind();
+    SetViewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+
+    Clear();
+}
+
+void VideoEngine::DisableLayerCacheRenderTarget()
+{
+    assert(_layer_cache_render_target != nullptr);
+
+    // Draw what was queued in the layer cache render target.
+    FlushSpriteBatch();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    PopState();
+    _layer_cache_valid = true;
+}
+
+bool VideoEngine::IsLayerCacheRenderTargetValid() const
+{
+    return _layer_cache_valid && _layer_cache_render_target != nullptr
+        && static_cast<int32_t>(_layer_cache_render_target->GetWidth()) == _current_context.viewport.width
+        && static_cast<int32_t>(_layer_cache_render_target->GetHeight()) == _current_context.viewport.height;
+}
+
+void VideoEngine::DrawLayerCacheRenderTarget()
+{
+    assert(_layer_cache_render_target != nullptr);
+    FlushSpriteBatch();
+
+    DisableBlending();
+    _DrawRenderTarget(_layer_cache_render_target);
+}
+
+void VideoEngine::DrawAmbientEffects(const StillImage& overlay,
+                                     float x_shift, float y_shift,
+                                     const Color& light_color)
+{
+    assert(_sprite != nullptr);
+    if (overlay._texture == nullptr)
+        return;
+
+    FlushSpriteBatch();
+
+    gl::ShaderProgram* shader_program = LoadShaderProgram(gl::shader_programs::AmbientEffects);
+    assert(shader_program != nullptr);
+
+    // The quad covers the whole viewport, whatever the coordinate system.
+    float buffer[16] = { 0 };
+    gl::Transform identity;
+    identity.Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
+
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, light_color.GetColors(), 4);
+    const float texture_rect[4] = { overlay._texture->u1, overlay._texture->v1,
+                                    overlay._texture->u2, overlay._texture->v2 };
+    shader_program->UpdateUniform(gl::shader_uniforms::TextureRect, texture_rect, 4);
+
+    EnableBlending();
+    SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    EnableTexture2D();
+    TextureManager->_BindTexSheet(overlay._texture->texture_sheet);
+    overlay._texture->texture_sheet->Smooth(overlay._smooth);
+    overlay._texture->texture_sheet->UpdateMipmaps();
+
+    // The texture coordinates count the overlay tiles from the shifted origin,
+    // in the standard coordinate system.
+    const float width = overlay.GetWidth();
+    const float height = overlay.GetHeight();
+    const float left = -x_shift / width;
+    const float right = (VIDEO_STANDARD_RES_WIDTH - x_shift) / width;
+    const float top = -y_shift / height;
+    const float bottom = (VIDEO_STANDARD_RES_HEIGHT - y_shift) / height;
+
+    float vertex_positions[] =
+    {
+        -1.0f, -1.0f, 0.0f, // Vertex One.
+         1.0f, -1.0f, 0.0f, // Vertex Two.
+         1.0f,  1.0f, 0.0f, // Vertex Three.
+        -1.0f,  1.0f, 0.0f  // Vertex Four.
+    };
+
+    float vertex_texture_coordinates[] =
+    {
+        left, bottom,  // Vertex One.
+        right, bottom, // Vertex Two.
+        right, top,    // Vertex Three.
+        left, top      // Vertex Four.
+    };
+
+    // The overlay is tinted by its image color.
+    float vertex_colors[16];
+    for (uint32_t i = 0; i < 4; ++i) {
+        for (uint32_t j = 0; j < 4; ++j)
+            vertex_colors[i * 4 + j] = overlay._color[i][j];
+    }
+
+    _sprite->Draw(vertex_positions, vertex_texture_coordinates, vertex_colors);
+    _render_stats.AddDrawCall();
+}
+
+void VideoEngine::DrawWeather(uint32_t weather_type, float time, float intensity,
+                              float wind_x, float wind_y,
+                              float x_shift, float y_shift,
+                              const Color& color)
+{
+    assert(_sprite != nullptr);
+    FlushSpriteBatch();
+
+    gl::ShaderProgram* shader_program = LoadShaderProgram(gl::shader_programs::Weather);
+    assert(shader_program != nullptr);
+
+    // The quad covers the whole viewport, whatever the coordinate system.
+    float buffer[16] = { 0 };
+    gl::Transform identity;
+    identity.Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
+
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, color.GetColors(), 4);
+    const float weather[4] = { static_cast<float>(weather_type), time, intensity, 0.0f };
+    shader_program->UpdateUniform("u_Weather", weather, 4);
+    const float wind[4] = { wind_x, wind_y, 0.0f, 0.0f };
+    shader_program->UpdateUniform("u_Wind", wind, 4);
+
+    EnableBlending();
+    SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    DisableTexture2D();
+
+    // The texture coordinates are the standard screen coordinates from the shifted weather origin.
+    const float left = -x_shift;
+    const float right = VIDEO_STANDARD_RES_WIDTH - x_shift;
+    const float top = -y_shift;
+    const float bottom = VIDEO_STANDARD_RES_HEIGHT - y_shift;
+
+    float vertex_positions[] =
+    {
+        -1.0f, -1.0f, 0.0f, // Vertex One.
+         1.0f, -1.0f, 0.0f, // Vertex Two.
+         1.0f,  1.0f, 0.0f, // Vertex Three.
+        -1.0f,  1.0f, 0.0f  // Vertex Four.
+    };
+
+    float vertex_texture_coordinates[] =
+    {
+        left, bottom,  // Vertex One.
+        right, bottom, // Vertex Two.
+        right, top,    // Vertex Three.
+        left, top      // Vertex Four.
+    };
+
+    // The weather is colored by its uniform only.
+    float vertex_colors[16];
+    for (uint32_t i = 0; i < 16; ++i)
+        vertex_colors[i] = 1.0f;
+
+    _sprite->Draw(vertex_positions, vertex_texture_coordinates, vertex_colors);
+    _render_stats.AddDrawCall();
+}
+
+void VideoEngine::SetRenderPass(RenderPass pass)
+{
+    if (pass == _render_stats.GetPass())
+        return;
+
+    // The queued sprites belong to the previous pass.
+    FlushSpriteBatch();
+    _render_stats.SetPass(pass);
+}
+
+void VideoEngine::ToggleRenderStatsExport(const std::string& filename)
+{
+    if (_render_stats.IsExportingCsv()) {
+        _render_stats.StopCsvExport();
+        IF_PRINT_DEBUG(VIDEO_DEBUG) << "Stopped the render statistics export to: " << filename << std::endl;
+    }
+    else if (_render_stats.StartCsvExport(filename)) {
+        IF_PRINT_DEBUG(VIDEO_DEBUG) << "Started the render statistics export to: " << filename << std::endl;
+    }
+}
+
+void VideoEngine::_DrawRenderTarget(gl::RenderTarget* render_target)
+{
+    assert(_sprite != nullptr);
+    assert(render_target != nullptr);
 
     // Load the shader program.
-    gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Sprite);
+    gl::ShaderProgram* shader_program = LoadShaderProgram(gl::shader_programs::Sprite);
     assert(shader_program != nullptr);
 
     // Load the shader uniforms.
     float buffer[16] = { 0 };
     gl::Transform identity;
     identity.Apply(buffer);
-    shader_program->UpdateUniform("u_Model", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
 
     identity.Apply(buffer);
-    shader_program->UpdateUniform("u_View", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
 
     identity.Apply(buffer);
-    shader_program->UpdateUniform("u_Projection", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
 
-    shader_program->UpdateUniform("u_Color", ::vt_video::Color::white.GetColors(), 4);
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, ::vt_video::Color::white.GetColors(), 4);
 
-    // Disable the secondary render target.
-    DisableSecondaryRenderTarget();
-
-    // Bind the secondary render target's texture.
-    _secondary_render_target->BindTexture();
+    // Bind the render target's texture.
+    render_target->BindTexture();
 
     //
-    // Draw a fullscreen quad.
+    // Draw a quad covering the whole viewport.
     //
 
     // The vertex positions.
@@ -706,15 +1328,15 @@ void VideoEngine::DrawSecondaryRenderTarget()
     };
 
     _sprite->Draw(vertex_positions, vertex_texture_coordinates, vertex_colors);
+    _render_stats.AddTextureBind();
+    _render_stats.AddDrawCall();
 
-    // Unbind the secondary render target's texture.
+    // Unbind the render target's texture.
     glBindTexture(GL_TEXTURE_2D, 0);
+    TextureManager->_bound_texture_id = 0;
 
     // Unload the shader program.
-    VideoManager->UnloadShaderProgram();
-
-    // Restore the state.
-    vt_video::VideoManager->PopState();
+    UnloadShaderProgram();
 }
 
 gl::ShaderProgram* VideoEngine::LoadShaderProgram(const gl::shader_programs::ShaderPrograms& shader_program)
@@ -724,15 +1346,51 @@ gl::ShaderProgram* VideoEngine::LoadShaderProgram(const gl::shader_programs::Sha
     assert(_programs.find(shader_program) != _programs.end());
     if (_programs.find(shader_program) != _programs.end()) {
         result = _programs.at(shader_program);
-        result->Load();
+
+        // The queued sprites are drawn with the program they were queued with.
+        if (!_sprite_batch->IsEmpty() && _sprite_batch->GetShaderProgram() != result)
+            FlushSpriteBatch();
+
+        _UseShaderProgram(result);
     }
 
     return result;
 }
 
+void VideoEngine::_WarmUpShaderPrograms()
+{
+    // Build a single program per frame, so that linking one doesn't stall the frame much.
+    for (std::map<gl::shader_programs::ShaderPrograms, gl::ShaderProgram*>::iterator i = _programs.begin(); i != _programs.end(); ++i) {
+        if (i->second->IsBuilt())
+            continue;
+
+        const gl::shader_programs::ShaderPrograms program = i->first;
+        vt_system::JobManager->ScheduleOnMainThread([program]() {
+            if (VideoManager == nullptr)
+                return;
+            std::map<gl::shader_programs::ShaderPrograms, gl::ShaderProgram*>::iterator it = VideoManager->_programs.find(program);
+            if (it != VideoManager->_programs.end())
+                it->second->Build();
+            VideoManager->_WarmUpShaderPrograms();
+        });
+        return;
+    }
+}
+
 void VideoEngine::UnloadShaderProgram()
 {
-    glUseProgram(0);
+    // Every draw loads its own program, so the current one is kept bound:
+    // Consecutive draws using the same program then don't switch programs at all.
+}
+
+void VideoEngine::_UseShaderProgram(gl::ShaderProgram* shader_program)
+{
+    if (shader_program == _current_shader_program)
+        return;
+
+    shader_program->Load();
+    _current_shader_program = shader_program;
+    _render_stats.AddShaderSwitch();
 }
 
 void VideoEngine::DrawParticleSystem(gl::ShaderProgram* shader_program,
@@ -748,22 +1406,140 @@ void VideoEngine::DrawParticleSystem(gl::ShaderProgram* shader_program,
     assert(vertex_colors != nullptr);
     assert(number_of_vertices % 4 == 0);
 
+    // Particle systems aren't batched.
+    assert(_sprite_batch->IsEmpty());
+
     // Load the shader uniforms common to all programs.
     float buffer[16] = { 0 };
-    _transform_stack.top().Apply(buffer);
-    shader_program->UpdateUniform("u_Model", buffer, 16);
+    _GetTransform().Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
 
     gl::Transform identity;
     identity.Apply(buffer);
-    shader_program->UpdateUniform("u_View", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
 
     _projection.Apply(buffer);
-    shader_program->UpdateUniform("u_Projection", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
 
-    shader_program->UpdateUniform("u_Color", reinterpret_cast<const float*>(&::vt_video::Color::white), 4);
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, reinterpret_cast<const float*>(&::vt_video::Color::white), 4);
 
     // Draw the particle system.
     _particle_system->Draw(vertex_positions, vertex_texture_coordinates, vertex_colors, number_of_vertices);
+    _render_stats.AddDrawCall();
+}
+
+bool VideoEngine::IsParticleInstancingSupported() const
+{
+    return _particle_system != nullptr && _particle_system->IsInstancingSupported();
+}
+
+void VideoEngine::DrawParticleInstances(gl::ShaderProgram* shader_program,
+                                        const float* instances,
+                                        unsigned number_of_instances,
+                                        const float* texture_rect,
+                                        const Color& color)
+{
+    assert(_particle_system != nullptr);
+    assert(shader_program != nullptr);
+    assert(instances != nullptr);
+    assert(texture_rect != nullptr);
+
+    // Particle systems aren't batched.
+    assert(_sprite_batch->IsEmpty());
+
+    _UpdateParticleUniforms(shader_program, texture_rect, color);
+
+    // Draw the particle system.
+    _particle_system->DrawInstances(instances, number_of_instances);
+    _render_stats.AddDrawCall();
+}
+
+bool VideoEngine::IsParticleSimulationSupported() const
+{
+    return _programs.find(gl::shader_programs::ParticleSimulation) != _programs.end();
+}
+
+void VideoEngine::SimulateParticles(gl::ShaderProgram* shader_program,
+                                    gl::ParticleSimulation* particle_simulation)
+{
+    assert(shader_program != nullptr);
+    assert(particle_simulation != nullptr);
+    assert(shader_program == _current_shader_program);
+    (void)shader_program;
+
+    particle_simulation->Step();
+    _render_stats.AddDrawCall();
+}
+
+void VideoEngine::DrawSimulatedParticles(gl::ShaderProgram* shader_program,
+                                         const gl::ParticleSimulation* particle_simulation,
+                                         const float* texture_rect,
+                                         const Color& color)
+{
+    assert(_particle_system != nullptr);
+    assert(shader_program != nullptr);
+    assert(particle_simulation != nullptr);
+    assert(texture_rect != nullptr);
+
+    // Particle systems aren't batched.
+    assert(_sprite_batch->IsEmpty());
+
+    _UpdateParticleUniforms(shader_program, texture_rect, color);
+
+    // Draw the particles straight from the simulation buffer.
+    _particle_system->DrawBufferInstances(particle_simulation->GetParticleBuffer(),
+                                          gl::PARTICLE_SIMULATION_FLOATS,
+                                          particle_simulation->GetNumberOfParticles());
+    _render_stats.AddDrawCall();
+}
+
+void VideoEngine::_UpdateParticleUniforms(gl::ShaderProgram* shader_program,
+                                          const float* texture_rect,
+                                          const Color& color)
+{
+    // Load the shader uniforms common to all programs.
+    // Unchanged values aren't uploaded again by the program.
+    float buffer[16] = { 0 };
+    _GetTransform().Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
+
+    gl::Transform identity;
+    identity.Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
+
+    _projection.Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
+
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, color.GetColors(), 4);
+    shader_program->UpdateUniform(gl::shader_uniforms::TextureRect, texture_rect, 4);
+}
+
+void VideoEngine::DrawStaticSprites(gl::ShaderProgram* shader_program,
+                                    gl::StaticSpriteBuffer* sprite_buffer)
+{
+    assert(shader_program != nullptr);
+    assert(sprite_buffer != nullptr);
+
+    // Draw the sprites queued before these ones.
+    FlushSpriteBatch();
+
+    // Load the shader uniforms common to all programs.
+    float buffer[16] = { 0 };
+    _GetTransform().Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
+
+    gl::Transform identity;
+    identity.Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
+
+    _projection.Apply(buffer);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
+
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, ::vt_video::Color::white.GetColors(), 4);
+
+    // Draw the sprites.
+    sprite_buffer->Draw();
+    _render_stats.AddDrawCall();
 }
 
 void VideoEngine::DrawSprite(gl::ShaderProgram* shader_program,
@@ -777,29 +1553,87 @@ void VideoEngine::DrawSprite(gl::ShaderProgram* shader_program,
     assert(vertex_positions != nullptr);
     assert(vertex_texture_coordinates != nullptr);
     assert(vertex_colors != nullptr);
+    assert(_sprite_batch != nullptr);
+
+    // Draw the queued sprites when the render state changes.
+    // The solid programs don't sample any texture, so that their sprites
+    // are batched together whatever texture was bound between them.
+    const bool solid = (shader_program == _solid_program || shader_program == _solid_grayscale_program);
+    const GLuint texture_id = solid ? 0 : TextureManager->_bound_texture_id;
+    if (!_sprite_batch->IsEmpty() &&
+            (_sprite_batch->GetShaderProgram() != shader_program ||
+             _sprite_batch->GetTextureId() != texture_id ||
+             _sprite_batch->IsFull())) {
+        FlushSpriteBatch();
+    }
 
-    // Load the shader uniforms common to all programs.
-    float buffer[16] = { 0 };
-    _transform_stack.top().Apply(buffer);
-    shader_program->UpdateUniform("u_Model", buffer, 16);
+    if (_sprite_batch->IsEmpty())
+        _sprite_batch->SetState(shader_program, texture_id);
+
+    // Apply the model matrix and the color on the CPU,
+    // so that the sprites can share the same uniforms.
+    const gl::Transform& model = _GetTransform();
+    const float* colors = color.GetColors();
 
+    float transformed_positions[12];
+    model.TransformPositions(vertex_positions, transformed_positions, 4);
+
+    float modulated_colors[16];
+    for (unsigned i = 0; i < 4; ++i) {
+        for (unsigned j = 0; j < 4; ++j)
+            modulated_colors[i * 4 + j] = vertex_colors[i * 4 + j] * colors[j];
+    }
+
+    _sprite_batch->AddSprite(transformed_positions, vertex_texture_coordinates, modulated_colors);
+}
+
+void VideoEngine::FlushSpriteBatch()
+{
+    if (_sprite_batch == nullptr || _sprite_batch->IsEmpty())
+        return;
+
+    gl::ShaderProgram* shader_program = _sprite_batch->GetShaderProgram();
+    assert(shader_program != nullptr);
+    _UseShaderProgram(shader_program);
+
+    // The vertices are already transformed and colored.
+    float buffer[16] = { 0 };
     gl::Transform identity;
     identity.Apply(buffer);
-    shader_program->UpdateUniform("u_View", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Model, buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::View, buffer, 16);
 
     _projection.Apply(buffer);
-    shader_program->UpdateUniform("u_Projection", buffer, 16);
+    shader_program->UpdateUniform(gl::shader_uniforms::Projection, buffer, 16);
 
-    shader_program->UpdateUniform("u_Color", color.GetColors(), 4);
+    shader_program->UpdateUniform(gl::shader_uniforms::Color, ::vt_video::Color::white.GetColors(), 4);
 
-    // Draw the sprite.
-    _sprite->Draw(vertex_positions, vertex_texture_coordinates, vertex_colors);
+    // Rebind the texture directly, as render targets bind their own textures.
+    glBindTexture(GL_TEXTURE_2D, _sprite_batch->GetTextureId());
+    TextureManager->_bound_texture_id = _sprite_batch->GetTextureId();
+    _render_stats.AddTextureBind();
+
+    _sprite_batch->Draw();
+    _render_stats.AddDrawCall();
+}
+
+void VideoEngine::SubmitFrame()
+{
+    FlushSpriteBatch();
+
+    // The captures from now on are of the new frame.
+    ++_submitted_frames;
+    _screen_capture.Clear();
+
+    // Start the GPU work now, rather than when the buffers are swapped.
+    glFlush();
 }
 
 void VideoEngine::EnableScissoring()
 {
     _current_context.scissoring_enabled = true;
     if (!_gl_scissor_test_is_active) {
+        FlushSpriteBatch();
         glEnable(GL_SCISSOR_TEST);
         _gl_scissor_test_is_active = true;
     }
@@ -809,6 +1643,7 @@ void VideoEngine::DisableScissoring()
 {
     _current_context.scissoring_enabled = false;
     if (_gl_scissor_test_is_active) {
+        FlushSpriteBatch();
         glDisable(GL_SCISSOR_TEST);
         _gl_scissor_test_is_active = false;
     }
@@ -824,6 +1659,16 @@ void VideoEngine::SetScissorRect(const ScreenRect& screen_rectangle)
 {
     _current_context.scissor_rectangle = screen_rectangle;
 
+    if (_gl_scissor_rectangle.left == screen_rectangle.left &&
+            _gl_scissor_rectangle.top == screen_rectangle.top &&
+            _gl_scissor_rectangle.width == screen_rectangle.width &&
+            _gl_scissor_rectangle.height == screen_rectangle.height) {
+        return;
+    }
+
+    FlushSpriteBatch();
+    _gl_scissor_rectangle = screen_rectangle;
+
     glScissor(static_cast<GLint>(_current_context.scissor_rectangle.left),
               static_cast<GLint>(_current_context.scissor_rectangle.top),
               static_cast<GLsizei>(_current_context.scissor_rectangle.width),
@@ -880,8 +1725,7 @@ void VideoEngine::PopScissoredRect()
 
 void VideoEngine::Move(float x, float y)
 {
-    _transform_stack.top().Reset();
-    _transform_stack.top().Translate(x, y);
+    _GetTransform().SetTranslation(x, y);
 
     _cursor_pos.x = x;
     _cursor_pos.y = y;
@@ -889,7 +1733,7 @@ void VideoEngine::Move(float x, float y)
 
 void VideoEngine::MoveRelative(float x, float y)
 {
-    _transform_stack.top().Translate(x, y);
+    _GetTransform().Translate(x, y);
 
     _cursor_pos.x += x;
     _cursor_pos.y += y;
@@ -897,19 +1741,28 @@ void VideoEngine::MoveRelative(float x, float y)
 
 void VideoEngine::PushMatrix()
 {
-    _transform_stack.push(_transform_stack.top());
+    if (_transform_stack_size >= TRANSFORM_STACK_SIZE) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "the transform stack is full, the transform won't be restored" << std::endl;
+        ++_transform_stack_overflow;
+        return;
+    }
+
+    _transform_stack[_transform_stack_size] = _transform_stack[_transform_stack_size - 1];
+    ++_transform_stack_size;
 }
 
 void VideoEngine::PopMatrix()
 {
-    // Sanity.
-    if (!_transform_stack.empty()) {
-        _transform_stack.pop();
+    if (_transform_stack_overflow > 0) {
+        --_transform_stack_overflow;
+        return;
     }
 
-    // Sanity.
-    if (_transform_stack.empty()) {
-        _transform_stack.push(gl::Transform());
+    // Sanity: the bottom transform is always kept.
+    if (_transform_stack_size > 1) {
+        --_transform_stack_size;
+    } else {
+        _transform_stack[0].Reset();
     }
 }
 
@@ -950,12 +1803,12 @@ void VideoEngine::PopState()
 
 void VideoEngine::Rotate(float angle)
 {
-    _transform_stack.top().Rotate(angle);
+    _GetTransform().Rotate(angle);
 }
 
 void VideoEngine::Scale(float x, float y)
 {
-    _transform_stack.top().Scale(x, y);
+    _GetTransform().Scale(x, y);
 }
 
 void VideoEngine::DrawFadeEffect()
@@ -977,6 +1830,9 @@ StillImage VideoEngine::CaptureScreen()
     // Static variable used to make sure the capture has a unique name in the texture image map
     static uint32_t capture_id = 0;
 
+    // Make sure everything is drawn before the capture.
+    FlushSpriteBatch();
+
     // Get the viewport.
     float viewport_x = 0.0f;
     float viewport_y = 0.0f;
@@ -985,6 +1841,16 @@ StillImage VideoEngine::CaptureScreen()
     vt_video::VideoManager->GetCurrentViewport(viewport_x, viewport_y,
                                                viewport_width, viewport_height);
 
+    // Hand out the capture of this frame again, if done already.
+    // The copies returned share its texture.
+    if (_screen_capture_frame == _submitted_frames && _screen_capture._image_texture != nullptr &&
+            _screen_capture._image_texture->width == static_cast<uint32_t>(viewport_width) &&
+            _screen_capture._image_texture->height == static_cast<uint32_t>(viewport_height)) {
+        StillImage screen_image = _screen_capture;
+        screen_image.SetDimensions(viewport_width, viewport_height);
+        return screen_image;
+    }
+
     StillImage screen_image;
     screen_image.SetDimensions(viewport_width, viewport_height);
 
@@ -996,16 +1862,15 @@ StillImage VideoEngine::CaptureScreen()
 
     // Create a new ImageTexture with a unique filename for this newly captured screen
     ImageTexture* new_image = new ImageTexture("capture_screen" + NumberToString(capture_id),
-                                               "",
+                                               TextureManager->_GetProceduralImagePath(),
+                                               IMAGE_TAG_NONE,
                                                static_cast<int32_t>(viewport_width),
                                                static_cast<int32_t>(viewport_height));
     new_image->AddReference();
 
-    // Create a texture sheet of an appropriate size that can retain the capture
-    TexSheet *temp_sheet = TextureManager->_CreateTexSheet(RoundUpPow2(static_cast<uint32_t>(viewport_width)),
-                                                           RoundUpPow2(static_cast<uint32_t>(viewport_height)),
-                                                           VIDEO_TEXSHEET_ANY,
-                                                           false);
+    // Get a texture sheet of an appropriate size that can retain the capture
+    TexSheet *temp_sheet = TextureManager->_CreateCaptureSheet(RoundUpPow2(static_cast<uint32_t>(viewport_width)),
+                                                               RoundUpPow2(static_cast<uint32_t>(viewport_height)));
     VariableTexSheet *sheet = dynamic_cast<VariableTexSheet *>(temp_sheet);
 
     // Ensure that texture sheet creation succeeded, insert the texture image into the sheet, and copy the screen into the sheet
@@ -1023,6 +1888,7 @@ StillImage VideoEngine::CaptureScreen()
     }
 
     if (sheet->CopyScreenRect(0, 0, screen_rect) == false) {
+        sheet->RemoveTexture(new_image);
         TextureManager->_RemoveSheet(sheet);
         delete new_image;
         throw Exception("call to TexSheet::CopyScreenRect() failed",
@@ -1040,6 +1906,9 @@ StillImage VideoEngine::CaptureScreen()
     new_image->v2 = temp;
 
     ++capture_id;
+
+    _screen_capture = screen_image;
+    _screen_capture_frame = _submitted_frames;
     return screen_image;
 }
 
@@ -1060,12 +1929,13 @@ StillImage VideoEngine::CreateImage(ImageMemory *raw_image,
     still_image.SetDimensions(raw_image->GetWidth(), raw_image->GetHeight());
 
     //Check to see if the image_name exists
-    if(TextureManager->_IsImageTextureRegistered(image_name))
+    const uint32_t path_id = TextureManager->InternImagePath(image_name);
+    if(TextureManager->_IsImageTextureRegistered(path_id))
     {
         //if we are allowed to delete, then we remove the texture
         if(delete_on_exist)
         {
-            ImageTexture* old = TextureManager->_GetImageTexture(image_name);
+            ImageTexture* old = TextureManager->_GetImageTexture(path_id);
             TextureManager->_UnregisterImageTexture(old);
             if(old->RemoveReference())
                 delete old;
@@ -1080,7 +1950,7 @@ StillImage VideoEngine::CreateImage(ImageMemory *raw_image,
     // Create a new texture image.
     // The next few steps are similar to CaptureImage.
     // So, in the future, we may want to do a code cleanup.
-    ImageTexture* new_image = new ImageTexture(image_name, "",
+    ImageTexture* new_image = new ImageTexture(image_name, path_id, IMAGE_TAG_NONE,
                                                raw_image->GetWidth(),
                                                raw_image->GetHeight());
     new_image->AddReference();
@@ -1119,6 +1989,89 @@ StillImage VideoEngine::CreateImage(ImageMemory *raw_image,
     return still_image;
 }
 
+StillImage VideoEngine::_FlattenCompositeImage(const CompositeImage& composite, uint32_t width, uint32_t height)
+{
+    // Static variable used to make sure the flattened images have a unique name in the texture image map
+    static uint32_t flatten_id = 0;
+
+    FlushSpriteBatch();
+
+    // The composite may be drawn in another render target, or in a scaled viewport.
+    GLint framebuffer = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    const ScreenRect viewport(_viewport_x_offset, _viewport_y_offset, _viewport_width, _viewport_height);
+    const vt_common::Position2D shake_offset = _shake_offset;
+
+    ImageMemory pixels;
+    pixels.Resize(width, height, false);
+    {
+        gl::RenderTarget render_target(width, height);
+        TextureManager->_bound_texture_id = 0;
+
+        PushState();
+        render_target.Bind();
+        SetViewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+        SetCoordSys(0.0f, composite._width, composite._height, 0.0f);
+        SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_TOP, VIDEO_X_NOFLIP, VIDEO_Y_NOFLIP, VIDEO_BLEND, 0);
+        DisableScissoring();
+        Move(0.0f, 0.0f);
+        _shake_offset = vt_common::Position2D(0.0f, 0.0f);
+
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        Clear();
+        glClearColor(::vt_video::Color::clear[0],
+                     ::vt_video::Color::clear[1],
+                     ::vt_video::Color::clear[2],
+                     ::vt_video::Color::clear[3]);
+
+        // The alpha is blended as coverage, so that the pixels end up with premultiplied colors.
+        EnableBlending();
+        SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        const Color white[4] = { Color::white, Color::white, Color::white, Color::white };
+        composite._DrawElements(white);
+        FlushSpriteBatch();
+        glBlendFunc(_gl_blend_source_factor, _gl_blend_destination_factor);
+
+        pixels.GlReadPixels(0, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        _shake_offset = shake_offset;
+        PopState();
+        SetViewport(viewport.left, viewport.top, viewport.width, viewport.height);
+    }
+    // The render target texture was bound, and is deleted now.
+    TextureManager->_bound_texture_id = 0;
+
+    // The framebuffer rows start at the bottom, and the images ones at the top.
+    pixels.VerticalFlip();
+    uint8_t* pixel = pixels.GetPixels();
+    for (size_t i = 0; i < pixels.GetSize2D(); ++i, pixel += 4) {
+        if (pixel[3] == 0 || pixel[3] == 255)
+            continue;
+        pixel[0] = static_cast<uint8_t>(std::min(255, pixel[0] * 255 / pixel[3]));
+        pixel[1] = static_cast<uint8_t>(std::min(255, pixel[1] * 255 / pixel[3]));
+        pixel[2] = static_cast<uint8_t>(std::min(255, pixel[2] * 255 / pixel[3]));
+    }
+
+    StillImage flattened;
+    ImageTexture* new_image = new ImageTexture("flattened_composite" + NumberToString(flatten_id++),
+                                               TextureManager->_GetProceduralImagePath(),
+                                               IMAGE_TAG_NONE, width, height);
+    if (TextureManager->_InsertImageInTexSheet(new_image, pixels, false) == nullptr) {
+        IF_PRINT_WARNING(VIDEO_DEBUG) << "could not insert the flattened composite image in a texture sheet" << std::endl;
+        delete new_image;
+        return flattened;
+    }
+    new_image->AddReference();
+
+    flattened._image_texture = new_image;
+    flattened._texture = new_image;
+    flattened._blend = true;
+    flattened.SetDimensions(composite._width, composite._height);
+    return flattened;
+}
+
 bool VideoEngine::IsScreenShaking()
 {
     vt_mode_manager::GameMode *gm = vt_mode_manager::ModeManager->GetTop();
@@ -1151,31 +2104,37 @@ void VideoEngine::SetBrightness(float value)
 
 void VideoEngine::MakeScreenshot(const std::string &filename)
 {
-    private_video::ImageMemory buffer;
+    if (_screenshot_writer == nullptr)
+        return;
+
+    // Make sure everything is drawn before the capture.
+    FlushSpriteBatch();
 
     // Retrieve the width and height of the viewport.
     GLint viewport_dimensions[4]; // viewport_dimensions[2] is the width, [3] is the height
     glGetIntegerv(GL_VIEWPORT, viewport_dimensions);
 
-    // Buffer to store the image before it is flipped
-    buffer.Resize(viewport_dimensions[2], viewport_dimensions[3], true);
+    _screenshot_writer->Capture(filename, viewport_dimensions[0], viewport_dimensions[1],
+                                viewport_dimensions[2], viewport_dimensions[3]);
+}
 
-    // Read the viewport pixel data
-    buffer.GlReadPixels(viewport_dimensions[0], viewport_dimensions[1]);
+gl::ShaderProgram* VideoEngine::_LoadSolidPrimitiveState()
+{
+    EnableBlending();
+    DisableTexture2D();
 
-    if(CheckGLError()) {
-        IF_PRINT_WARNING(VIDEO_DEBUG) << "An OpenGL error occured: "
-                                      << CreateGLErrorString() << std::endl;
-        return;
-    }
+    // Normal blending.
+    SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Vertically flip the image, then swap the flipped and original images
-    buffer.VerticalFlip();
-    buffer.SaveImage(filename);
+    // Load the solid shader program.
+    gl::ShaderProgram* shader_program = LoadShaderProgram(gl::shader_programs::Solid);
+    assert(shader_program != nullptr);
+    return shader_program;
 }
 
-void VideoEngine::DrawLine(float x1, float y1, unsigned width1,
-                           float x2, float y2, unsigned width2, const Color &color)
+void VideoEngine::_QueueLine(gl::ShaderProgram* shader_program,
+                             float x1, float y1, unsigned width1,
+                             float x2, float y2, unsigned width2, const Color &color)
 {
     //
     // Compute the line's vertex positions.
@@ -1183,10 +2142,12 @@ void VideoEngine::DrawLine(float x1, float y1, unsigned width1,
 
     // This is the equation for drawing a line with different starting and ending widths.
     float angle = atan2(static_cast<float>(y2 - y1), static_cast<float>(x2 - x1));
-    float w2sina1 = static_cast<float>(width1) / 2.0f * sin(angle);
-    float w2cosa1 = static_cast<float>(width1) / 2.0f * cos(angle);
-    float w2sina2 = static_cast<float>(width2) / 2.0f * sin(angle);
-    float w2cosa2 = static_cast<float>(width2) / 2.0f * cos(angle);
+    float sin_angle = sin(angle);
+    float cos_angle = cos(angle);
+    float w2sina1 = static_cast<float>(width1) / 2.0f * sin_angle;
+    float w2cosa1 = static_cast<float>(width1) / 2.0f * cos_angle;
+    float w2sina2 = static_cast<float>(width2) / 2.0f * sin_angle;
+    float w2cosa2 = static_cast<float>(width2) / 2.0f * cos_angle;
 
     float vertex_positions[] =
     {
@@ -1198,7 +2159,7 @@ void VideoEngine::DrawLine(float x1, float y1, unsigned width1,
 
     // The vertex texture coordinates.
     // These will be ignored in this case.
-    float vertex_texture_coordinates[] =
+    static float vertex_texture_coordinates[] =
     {
         0.0f, 0.0f, // Vertex One.
         0.0f, 0.0f, // Vertex Two.
@@ -1206,9 +2167,8 @@ void VideoEngine::DrawLine(float x1, float y1, unsigned width1,
         0.0f, 0.0f  // Vertex Four.
     };
 
-    // The vertex colors.
-    // These will be ignored in this case.
-    float vertex_colors[] =
+    // The vertex colors, modulated by the line color.
+    static float vertex_colors[] =
     {
         1.0f, 1.0f, 1.0f, 1.0f, // Vertex One.
         1.0f, 1.0f, 1.0f, 1.0f, // Vertex Two.
@@ -1216,21 +2176,14 @@ void VideoEngine::DrawLine(float x1, float y1, unsigned width1,
         1.0f, 1.0f, 1.0f, 1.0f  // Vertex Four.
     };
 
-    EnableBlending();
-    DisableTexture2D();
-
-    // Normal blending.
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Load the solid shader program.
-    gl::ShaderProgram* shader_program = VideoManager->LoadShaderProgram(gl::shader_programs::Solid);
-    assert(shader_program != nullptr);
-
-    // Draw the line.
+    // Queue the line with the solid primitives drawn before.
     DrawSprite(shader_program, vertex_positions, vertex_texture_coordinates, vertex_colors, color);
+}
 
-    // Unload the shader program.
-    UnloadShaderProgram();
+void VideoEngine::DrawLine(float x1, float y1, unsigned width1,
+                           float x2, float y2, unsigned width2, const Color &color)
+{
+    _QueueLine(_LoadSolidPrimitiveState(), x1, y1, width1, x2, y2, width2, color);
 }
 
 void VideoEngine::DrawGrid(float left, float top, float right, float bottom,
@@ -1243,16 +2196,19 @@ void VideoEngine::DrawGrid(float left, float top, float right, float bottom,
     assert(width_cell_vertical > 0.0f);
     assert(width_line > 0);
 
+    // The render state is set once for all the lines, queued in the same batch.
+    gl::ShaderProgram* shader_program = _LoadSolidPrimitiveState();
+
     // Draw the grid's vertical lines.
     for (float i = left; i <= right; i += width_cell_horizontal)
     {
-        DrawLine(i, top, width_line, i, bottom, width_line, color);
+        _QueueLine(shader_program, i, top, width_line, i, bottom, width_line, color);
     }
 
     // Draw the grid's horizontal lines.
     for (float j = top; j <= bottom; j += width_cell_vertical)
     {
-        DrawLine(left, j, width_line, right, j, width_line, color);
+        _QueueLine(shader_program, left, j, width_line, right, j, width_line, color);
     }
 }
 
@@ -1269,18 +2225,21 @@ void VideoEngine::DrawRectangleOutline(float left, float right,
                                        float bottom, float top,
                                        unsigned width, const Color &color)
 {
-    DrawLine(left, bottom, width, right, bottom, width, color);
-    DrawLine(left, top, width, right, top, width, color);
-    DrawLine(left, bottom, width, left, top, width, color);
-    DrawLine(right, bottom, width, right, top, width, color);
+    gl::ShaderProgram* shader_program = _LoadSolidPrimitiveState();
+    _QueueLine(shader_program, left, bottom, width, right, bottom, width, color);
+    _QueueLine(shader_program, left, top, width, right, top, width, color);
+    _QueueLine(shader_program, left, bottom, width, left, top, width, color);
+    _QueueLine(shader_program, right, bottom, width, right, top, width, color);
 }
 
 void VideoEngine::DrawHalo(const ImageDescriptor &id, const Color &color)
 {
-    char old_blend_mode = _current_context.blend;
-    _current_context.blend = VIDEO_BLEND_ADD;
+    static const DrawFlags additive_blending(VIDEO_BLEND_ADD);
+
+    const DrawState old_draw_state = _current_context.draw_state;
+    _current_context.draw_state.Apply(additive_blending);
     id.Draw(color);
-    _current_context.blend = old_blend_mode;
+    _current_context.draw_state = old_draw_state;
 }
 
 int32_t VideoEngine::_ConvertYAlign(int32_t y_align)
@@ -1315,8 +2274,183 @@ int32_t VideoEngine::_ConvertXAlign(int32_t x_align)
     }
 }
 
+void VideoEngine::SetRenderScale(uint32_t scale)
+{
+    if (scale != VIDEO_RENDER_SCALE_DYNAMIC) {
+        scale = std::min(std::max(scale, VIDEO_RENDER_SCALE_MIN), VIDEO_RENDER_SCALE_MAX);
+        scale -= (scale - VIDEO_RENDER_SCALE_MIN) % VIDEO_RENDER_SCALE_STEP;
+        _current_render_scale = scale;
+    }
+    // The dynamic render scale starts from the one applied.
+    _render_scale = scale;
+    _dynamic_scale_gpu_time = 0.0f;
+    _dynamic_scale_frames = 0;
+}
+
+void VideoEngine::SetGraphicsQuality(uint32_t quality)
+{
+    if (quality >= VIDEO_QUALITY_TOTAL)
+        quality = VIDEO_QUALITY_CUSTOM;
+    _graphics_quality = quality;
+
+    switch (quality) {
+    case VIDEO_QUALITY_LOW:
+        SetRenderScale(VIDEO_RENDER_SCALE_DYNAMIC);
+        _particle_density = VIDEO_PARTICLE_DENSITY_MIN;
+        _light_flares = false;
+        _ambient_overlays = false;
+        _frame_cap = 30;
+        break;
+    case VIDEO_QUALITY_MEDIUM:
+        SetRenderScale(VIDEO_RENDER_SCALE_DYNAMIC);
+        _particle_density = 50;
+        _light_flares = false;
+        _ambient_overlays = true;
+        _frame_cap = VIDEO_FRAME_CAP_NONE;
+        break;
+    case VIDEO_QUALITY_HIGH:
+        SetRenderScale(VIDEO_RENDER_SCALE_MAX);
+        _particle_density = VIDEO_PARTICLE_DENSITY_MAX;
+        _light_flares = true;
+        _ambient_overlays = true;
+        _frame_cap = VIDEO_FRAME_CAP_NONE;
+        break;
+    case VIDEO_QUALITY_AUTO:
+        // The GPU bound frames are handled by the dynamic render scale,
+        // the automatic levels easing both the CPU and the GPU.
+        SetRenderScale(VIDEO_RENDER_SCALE_DYNAMIC);
+        _frame_cap = VIDEO_FRAME_CAP_NONE;
+        _SetAutoQualityLevel(AUTO_QUALITY_LEVEL_COUNT - 1);
+        break;
+    default:
+        break;
+    }
+
+    _auto_quality_gpu_time = 0.0f;
+    _auto_quality_gpu_frames = 0;
+    _auto_quality_frames = 0;
+}
+
+void VideoEngine::SetParticleDensity(uint32_t density)
+{
+    density = std::min(std::max(density, VIDEO_PARTICLE_DENSITY_MIN), VIDEO_PARTICLE_DENSITY_MAX);
+    _particle_density = density - (density - VIDEO_PARTICLE_DENSITY_MIN) % VIDEO_PARTICLE_DENSITY_STEP;
+}
+
+void VideoEngine::_SetAutoQualityLevel(uint32_t level)
+{
+    _auto_quality_level = level;
+    const AutoQualityLevel& settings = AUTO_QUALITY_LEVELS[level];
+    _particle_density = settings.particle_density;
+    _light_flares = settings.light_flares;
+    _ambient_overlays = settings.ambient_overlays;
+}
+
+void VideoEngine::_UpdateAutoQuality()
+{
+    if (_graphics_quality != VIDEO_QUALITY_AUTO)
+        return;
+
+    // The still screens are throttled, and their frame times don't tell anything.
+    const vt_system::FramePacer& frame_pacer = vt_system::SystemManager->GetFramePacer();
+    if (frame_pacer.IsThrottled())
+        return;
+
+    // The frames are measured a few frames late, once each.
+    const RenderFrameStats& frame = _render_stats.GetLastFrame();
+    if (frame.frame_number != _auto_quality_frame_number) {
+        _auto_quality_frame_number = frame.frame_number;
+        const float gpu_time = GetFrameGpuTime(frame);
+        if (gpu_time >= 0.0f) {
+            _auto_quality_gpu_time += gpu_time;
+            ++_auto_quality_gpu_frames;
+        }
+    }
+
+    if (++_auto_quality_frames < AUTO_QUALITY_FRAMES)
+        return;
+
+    // The CPU time is already averaged by the frame pacer.
+    float frame_time = frame_pacer.GetWorkTime();
+    if (_auto_quality_gpu_frames > 0)
+        frame_time = std::max(frame_time, _auto_quality_gpu_time / _auto_quality_gpu_frames);
+    _auto_quality_gpu_time = 0.0f;
+    _auto_quality_gpu_frames = 0;
+    _auto_quality_frames = 0;
+
+    const float frame_budget = frame_pacer.GetFrameBudget();
+    uint32_t level = _auto_quality_level;
+    if (frame_time > frame_budget * AUTO_QUALITY_LOWER_RATIO && level > 0)
+        --level;
+    else if (frame_time < frame_budget * AUTO_QUALITY_RAISE_RATIO && level + 1 < AUTO_QUALITY_LEVEL_COUNT)
+        ++level;
+    if (level == _auto_quality_level)
+        return;
+
+    IF_PRINT_DEBUG(VIDEO_DEBUG) << "Automatic quality level set to " << level << " for a frame time of "
+                                << frame_time << " ms out of " << frame_budget << " ms." << std::endl;
+    _SetAutoQualityLevel(level);
+}
+
+void VideoEngine::_ResizeRenderTargets()
+{
+    // The game world is drawn at the render scale.
+    assert(_secondary_render_target != nullptr);
+    _secondary_render_target->Resize(GetScaledSize(_screen_width, _current_render_scale),
+                                     GetScaledSize(_screen_height, _current_render_scale));
+    _secondary_render_target->SetFilter(_sharp_upscaling ? GL_NEAREST : GL_LINEAR);
+
+    // The light render target only covers the viewport, at an even lower resolution.
+    assert(_light_render_target != nullptr);
+    _light_render_target->Resize(std::max(1, GetScaledSize(_viewport_width, _current_render_scale) / LIGHT_RENDER_TARGET_DIVISOR),
+                                 std::max(1, GetScaledSize(_viewport_height, _current_render_scale) / LIGHT_RENDER_TARGET_DIVISOR));
+
+    // The render targets leave no texture bound.
+    TextureManager->_bound_texture_id = 0;
+}
+
+void VideoEngine::_UpdateDynamicRenderScale()
+{
+    if (_render_scale != VIDEO_RENDER_SCALE_DYNAMIC || !_render_stats.AreTimersSupported())
+        return;
+
+    // The frames are measured a few frames late, once each.
+    const RenderFrameStats& frame = _render_stats.GetLastFrame();
+    if (frame.frame_number == _dynamic_scale_frame_number)
+        return;
+    _dynamic_scale_frame_number = frame.frame_number;
+
+    const float gpu_time = GetFrameGpuTime(frame);
+    if (gpu_time < 0.0f)
+        return;
+
+    _dynamic_scale_gpu_time += gpu_time;
+    if (++_dynamic_scale_frames < DYNAMIC_RENDER_SCALE_FRAMES)
+        return;
+
+    const float average_gpu_time = _dynamic_scale_gpu_time / _dynamic_scale_frames;
+    _dynamic_scale_gpu_time = 0.0f;
+    _dynamic_scale_frames = 0;
+
+    uint32_t scale = _current_render_scale;
+    if (average_gpu_time > DYNAMIC_RENDER_SCALE_BUDGET && scale > VIDEO_RENDER_SCALE_MIN)
+        scale -= VIDEO_RENDER_SCALE_STEP;
+    else if (average_gpu_time < DYNAMIC_RENDER_SCALE_BUDGET * DYNAMIC_RENDER_SCALE_RAISE_RATIO
+             && scale < VIDEO_RENDER_SCALE_MAX)
+        scale += VIDEO_RENDER_SCALE_STEP;
+    if (scale == _current_render_scale)
+        return;
+
+    IF_PRINT_DEBUG(VIDEO_DEBUG) << "Render scale set to " << scale << "% for a GPU frame time of "
+                                << average_gpu_time << " ms." << std::endl;
+    _current_render_scale = scale;
+    _ResizeRenderTargets();
+}
+
 void VideoEngine::_UpdateViewportMetrics()
 {
+    FlushSpriteBatch();
+
     // Test the desired resolution
     // and adds the necessary offsets if it's not a 4:3 one
     float width = _screen_width;
@@ -1377,7 +2511,7 @@ void VideoEngine::_UpdateFPS()
     //! \brief The number of samples to take if we need to play catchup with the current FPS
     const uint32_t FPS_CATCHUP = 20;
 
-    uint32_t frame_time = vt_system::SystemManager->GetUpdateTime();
+    uint32_t frame_time = vt_system::SystemManager->GetFrameTime();
 
     // Calculate the FPS for the current frame
     uint32_t current_fps = 1000;
@@ -1423,6 +2557,48 @@ void VideoEngine::_UpdateFPS()
 
     // The text to display to the screen
     _FPS_textimage->SetText("FPS: " + NumberToString(avg_fps));
+
+    if (!_render_stats_textimage)
+        _render_stats_textimage = new TextImage("", TextStyle("text18", Color::white));
+
+    const RenderFrameStats& stats = _render_stats.GetLastFrame();
+    std::string text = "Draws: " + NumberToString(stats.draw_calls)
+                     + "  Binds: " + NumberToString(stats.texture_binds)
+                     + "  Shaders: " + NumberToString(stats.shader_switches)
+                     + "  States: " + NumberToString(stats.state_changes)
+                     + "  Uploads: " + NumberToString(stats.uploaded_bytes / 1024) + " KB\n";
+
+    if (stats.gpu_times[RENDER_PASS_OTHER] < 0.0f) {
+        text += _render_stats.AreTimersSupported() ? "GPU: measuring..." : "GPU: timers unsupported";
+    }
+    else {
+        float total_time = 0.0f;
+        text += "GPU ms:";
+        for (uint32_t i = 0; i < RENDER_PASS_TOTAL; ++i) {
+            total_time += stats.gpu_times[i];
+            // Rounded to a hundredth of a millisecond.
+            text += std::string(" ") + GetRenderPassName(static_cast<RenderPass>(i)) + " "
+                    + NumberToString(static_cast<int32_t>(stats.gpu_times[i] * 100.0f) / 100.0f);
+        }
+        text += " total " + NumberToString(static_cast<int32_t>(total_time * 100.0f) / 100.0f);
+    }
+
+    // The main loop time spent running the frames, and sleeping in between.
+    const vt_system::FramePacer& frame_pacer = vt_system::SystemManager->GetFramePacer();
+    text += "\nCPU ms: busy " + NumberToString(static_cast<int32_t>(frame_pacer.GetBusyTime() * 100.0f) / 100.0f)
+            + " sleep " + NumberToString(static_cast<int32_t>(frame_pacer.GetSleepTime() * 100.0f) / 100.0f);
+    if (frame_pacer.IsThrottled())
+        text += " (idle)";
+
+    // From the key presses reading to the swap of the frame showing them.
+    float average_latency = 0.0f;
+    float max_latency = 0.0f;
+    if (vt_input::InputManager->GetInputLatency(average_latency, max_latency)) {
+        text += "\nInput latency ms: average " + NumberToString(static_cast<int32_t>(average_latency * 100.0f) / 100.0f)
+                + " max " + NumberToString(static_cast<int32_t>(max_latency * 100.0f) / 100.0f);
+    }
+
+    _render_stats_textimage->SetText(text);
 }
 
 void VideoEngine::_DrawFPS()
@@ -1436,6 +2612,49 @@ void VideoEngine::_DrawFPS()
                  VIDEO_BLEND, 0);
     Move(930.0f, 40.0f); // Upper right hand corner of the screen
     _FPS_textimage->Draw();
+
+    if (_render_stats_textimage) {
+        SetDrawFlags(VIDEO_X_RIGHT, VIDEO_Y_TOP, 0);
+        Move(1014.0f, 45.0f); // Right under the FPS
+        _render_stats_textimage->Draw();
+    }
+    PopState();
+}
+
+void VideoEngine::_DrawProfilerOverlay()
+{
+    if (!vt_system::FrameProfiler::IsOverlayShown())
+        return;
+
+    if (!_profiler_textimage)
+        _profiler_textimage = new TextImage("", TextStyle("text18", Color::white));
+    // The text is only regenerated when the profiler refreshed it.
+    _profiler_textimage->SetText(vt_system::FrameProfiler::GetOverlayText());
+
+    PushState();
+    SetStandardCoordSys();
+    SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_TOP, VIDEO_X_NOFLIP, VIDEO_Y_NOFLIP,
+                 VIDEO_BLEND, 0);
+    Move(10.0f, 10.0f); // Upper left hand corner of the screen
+    _profiler_textimage->Draw();
+    PopState();
+}
+
+void VideoEngine::_DrawMemoryOverlay()
+{
+    if (!vt_system::MemoryStats::IsOverlayShown())
+        return;
+
+    if (!_memory_textimage)
+        _memory_textimage = new TextImage("", TextStyle("text18", Color::white));
+    _memory_textimage->SetText(vt_system::MemoryStats::GetOverlayText());
+
+    PushState();
+    SetStandardCoordSys();
+    SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, VIDEO_X_NOFLIP, VIDEO_Y_NOFLIP,
+                 VIDEO_BLEND, 0);
+    Move(10.0f, 758.0f); // Lower left hand corner of the screen, away from the profiler
+    _memory_textimage->Draw();
     PopState();
 }
 
@@ -40,6 +40,7 @@
 #include "engine/video/gl/gl_shaders.h"
 #include "engine/video/gl/gl_transform.h"
 #include "engine/video/image.h"
+#include "engine/video/render_stats.h"
 #include "engine/video/screen_rect.h"
 #include "engine/video/text.h"
 #include "engine/video/texture_controller.h"
@@ -64,17 +65,26 @@ class MapTransitionEvent;
 
 namespace vt_mode_manager {
 class ModeEngine;
+class ParticleUpdater;
 }
 
 //! \brief All calls to the video engine are wrapped in this namespace.
 namespace vt_video {
 
 namespace gl {
+class ParticleSimulation;
 class ParticleSystem;
 class RenderTarget;
 class Shader;
 class ShaderProgram;
 class Sprite;
+class SpriteBatch;
+class StaticSpriteBuffer;
+class StreamBuffer;
+}
+
+namespace private_video {
+class ScreenshotWriter;
 }
 
 class VideoEngine;
@@ -118,6 +128,7 @@ class VideoEngine : public vt_utils::Singleton<VideoEngine>
 
     friend class ImageDescriptor;
     friend class CompositeImage;
+    friend class StaticImageLayer;
     friend class private_video::TextElement;
     friend class TextImage;
 
@@ -141,9 +152,27 @@ public:
     *** \param first_flag The first (and possibly only) draw flag to set
     *** \param ... Additional draw flags. The list must terminate with a 0.
     *** \note Refer to the VIDEO_DRAW_FLAGS enum for a list of valid flags that this function will accept
+    *** \note Prefer the DrawFlags overload in code run every frame, as it doesn't parse the flags again.
     **/
     void SetDrawFlags(int32_t first_flag, ...);
 
+    //! \brief Applies a prebuilt set of draw flags, leaving the fields it doesn't set untouched.
+    void SetDrawFlags(const DrawFlags& flags) {
+        _current_context.draw_state.Apply(flags);
+    }
+
+    /** \brief Returns the current draw flags, so that they can be restored with SetDrawState().
+    *** This is much cheaper than PushState() and PopState() when only the draw flags are changed.
+    **/
+    DrawState GetDrawState() const {
+        return _current_context.draw_state;
+    }
+
+    //! \brief Replaces all the current draw flags.
+    void SetDrawState(const DrawState& draw_state) {
+        _current_context.draw_state = draw_state;
+    }
+
     /** \brief Clears the contents of the framebuffer.
     **/
     void Clear();
@@ -245,6 +274,84 @@ public:
         return _vsync_mode;
     }
 
+    /** \brief Sets the resolution the game world is drawn at, before being upscaled to the screen.
+    *** \param scale The percentage of the screen resolution, from VIDEO_RENDER_SCALE_MIN
+    *** to VIDEO_RENDER_SCALE_MAX, or VIDEO_RENDER_SCALE_DYNAMIC to lower it only
+    *** while the GPU frame time exceeds its budget.
+    *** \note you must call ApplySettings() to actually apply the change.
+    *** The GUI is always drawn at the screen resolution.
+    **/
+    void SetRenderScale(uint32_t scale);
+
+    //! \brief Gets the render scale setting, in percents, or VIDEO_RENDER_SCALE_DYNAMIC.
+    uint32_t GetRenderScale() const {
+        return _render_scale;
+    }
+
+    //! \brief Gets the render scale the game world is currently drawn at, in percents.
+    uint32_t GetCurrentRenderScale() const {
+        return _current_render_scale;
+    }
+
+    /** \brief Sets whether the game world is upscaled with its nearest pixels, rather than bilinearly.
+    *** The sharp upscaling keeps the pixel art crisp, and is best at 50 %.
+    *** \note you must call ApplySettings() to actually apply the change
+    **/
+    void SetSharpUpscaling(bool sharp) {
+        _sharp_upscaling = sharp;
+    }
+
+    bool IsSharpUpscaling() const {
+        return _sharp_upscaling;
+    }
+
+    /** \brief Sets a graphics quality preset, setting the performance settings below at once.
+    *** \param quality One of the VIDEO_QUALITY values. VIDEO_QUALITY_CUSTOM keeps the current settings.
+    *** \note you must call ApplySettings() to actually apply the render scale.
+    **/
+    void SetGraphicsQuality(uint32_t quality);
+
+    //! \brief Gets the graphics quality preset, one of the VIDEO_QUALITY values.
+    uint32_t GetGraphicsQuality() const {
+        return _graphics_quality;
+    }
+
+    //! \brief Sets the share of the particles the systems may emit, in percents,
+    //! from VIDEO_PARTICLE_DENSITY_MIN to VIDEO_PARTICLE_DENSITY_MAX.
+    void SetParticleDensity(uint32_t density);
+
+    uint32_t GetParticleDensity() const {
+        return _particle_density;
+    }
+
+    //! \brief Sets whether the map lights draw their lens flares, or only their main halo.
+    void SetLightFlares(bool enabled) {
+        _light_flares = enabled;
+    }
+
+    bool AreLightFlaresEnabled() const {
+        return _light_flares;
+    }
+
+    //! \brief Sets whether the textured ambient overlays are drawn. The light overlay always is.
+    void SetAmbientOverlays(bool enabled) {
+        _ambient_overlays = enabled;
+    }
+
+    bool AreAmbientOverlaysEnabled() const {
+        return _ambient_overlays;
+    }
+
+    //! \brief Sets the frame rate cap, in frames per second, or VIDEO_FRAME_CAP_NONE.
+    //! It is kept even with VSync on, when lower than the display frame rate.
+    void SetFrameCap(uint32_t frames_per_second) {
+        _frame_cap = frames_per_second;
+    }
+
+    uint32_t GetFrameCap() const {
+        return _frame_cap;
+    }
+
     //! \brief Returns a reference to the current coordinate system
     const CoordSys& GetCoordSys() const {
         return _current_context.coordinate_system;
@@ -264,6 +371,13 @@ public:
      */
     bool ApplySettings();
 
+    /** \brief Follows the size the window drawable actually got, when it differs from the applied resolution.
+    *** Called on the SDL window size events, as the window managers may resize the windows
+    *** later than requested, or to another size. The OpenGL context is kept: Only the
+    *** viewport and the render targets are resized, and no texture is reloaded.
+    **/
+    void OnWindowResized();
+
     // ---------- Coordinate system and viewport methods
 
     /** \brief Sets the coordinate system to use.
@@ -310,23 +424,115 @@ public:
     void EnableTexture2D();
     void DisableTexture2D();
 
-    //! Enables the secondary render target.
+    //! \brief Sets the blending function, but only if necessary.
+    void SetBlendFunc(GLenum source_factor, GLenum destination_factor);
+
+    //! \brief Sets the stencil test function and operations, but only if necessary.
+    void SetStencilFunc(GLenum function, GLint reference, GLuint mask);
+    void SetStencilOp(GLenum stencil_fail, GLenum depth_fail, GLenum depth_pass);
+
+    /** \brief Enables the secondary render target.
+    ***
+    ***        The game world is drawn in it at the render scale: The viewport
+    ***        is scaled accordingly, so that the coordinate systems still apply.
+    **/
     void EnableSecondaryRenderTarget();
 
-    //! Disables the secondary render target.
+    //! Disables the secondary render target, and restores the screen viewport.
     void DisableSecondaryRenderTarget();
 
     /** \brief Draws the secondary render target onto the primary render target.
     ***
     ***        This function automatically disables the secondary render target
-    ***        before drawing its texture to the primary render target.
+    ***        before upscaling its texture over the whole primary render target.
     **/
     void DrawSecondaryRenderTarget();
 
+    /** \brief Starts accumulating lights in the light render target.
+    ***
+    ***        The light render target is cleared, and every draw call until
+    ***        DrawLightRenderTarget() goes to it, at a lower resolution.
+    ***        This is meant for additively blended images like halos, whose
+    ***        overdraw is this way much cheaper.
+    ***        The video state is saved and must not be popped in between.
+    **/
+    void EnableLightRenderTarget();
+
+    /** \brief Adds the accumulated lights over the primary render target at once.
+    ***
+    ***        This function automatically disables the light render target
+    ***        and restores the video state saved by EnableLightRenderTarget().
+    **/
+    void DrawLightRenderTarget();
+
+    /** \brief Draws the ambient overlay tiled over the whole viewport, and the light overlay over it, in one pass.
+    *** \param overlay The ambient overlay image, tiled and tinted by its color.
+    *** \param x_shift The x position of the top left tile, in the standard coordinate system.
+    *** \param y_shift The y position of the top left tile, in the standard coordinate system.
+    *** \param light_color The light overlay color, or Color::clear when there is none.
+    **/
+    void DrawAmbientEffects(const StillImage& overlay,
+                            float x_shift, float y_shift,
+                            const Color& light_color);
+
+    /** \brief Draws a procedural weather over the whole viewport, in a single shader pass.
+    *** \param weather_type The weather drawn, as one of the vt_mode_manager::WeatherType values.
+    *** \param time The weather time, in seconds, animating it.
+    *** \param intensity The weather density, in [0.0f, 1.0f].
+    *** \param wind_x The wind x velocity, in pixels per second of the standard coordinate system.
+    *** \param wind_y The wind y velocity, in pixels per second of the standard coordinate system.
+    *** \param x_shift The x position of the weather origin, in the standard coordinate system.
+    *** \param y_shift The y position of the weather origin, in the standard coordinate system.
+    *** \param color The weather color, whose alpha scales the weather opacity.
+    **/
+    void DrawWeather(uint32_t weather_type, float time, float intensity,
+                     float wind_x, float wind_y,
+                     float x_shift, float y_shift,
+                     const Color& color);
+
+    /** \brief Starts caching static layers in the layer cache render target.
+    ***
+    ***        The layer cache render target, covering the viewport, is cleared,
+    ***        and every draw call until DisableLayerCacheRenderTarget() goes to it.
+    ***        This is meant for static backgrounds made of several images,
+    ***        which can then be drawn as a single quad every frame.
+    ***        The video state is saved and must not be popped in between.
+    **/
+    void EnableLayerCacheRenderTarget();
+
+    /** \brief Stops caching layers, and restores the video state saved
+    ***        by EnableLayerCacheRenderTarget().
+    **/
+    void DisableLayerCacheRenderTarget();
+
+    //! \brief Tells whether the cached layers can be drawn, i.e. they were cached at the current viewport size.
+    bool IsLayerCacheRenderTargetValid() const;
+
+    //! \brief Draws the cached layers over the whole current viewport, replacing what is below.
+    void DrawLayerCacheRenderTarget();
+
+    /** \brief Attributes the GPU time spent from now on to another render pass.
+    ***        The pass is reset to RENDER_PASS_OTHER at the end of each frame.
+    **/
+    void SetRenderPass(RenderPass pass);
+
+    //! \brief Returns the rendering statistics, so that the video classes can count their operations.
+    private_video::RenderStats& GetRenderStats() {
+        return _render_stats;
+    }
+
+    /** \brief Starts or stops writing the rendering statistics of each frame to a CSV file.
+    *** \param filename The file to write to, overwritten when the export starts.
+    **/
+    void ToggleRenderStatsExport(const std::string& filename);
+
     //! \brief Loads a shader program.
     gl::ShaderProgram* LoadShaderProgram(const gl::shader_programs::ShaderPrograms& shader_program);
 
-    //! \brief Unloads the currently loaded shader program.
+    /** \brief Unloads the currently loaded shader program.
+    *** \note The program actually stays bound until another one is loaded,
+    *** since every draw loads the program it needs.
+    **/
     void UnloadShaderProgram();
 
     //! \brief Draws a particle system.
@@ -336,13 +542,71 @@ public:
                             float* vertex_colors,
                             unsigned number_of_vertices);
 
-    //! \brief Draws a sprite.
+    //! \brief Whether DrawParticleInstances() can be used.
+    bool IsParticleInstancingSupported() const;
+
+    /** \brief Draws a particle system as instances of a unit quad.
+    *** \param instances gl::PARTICLE_INSTANCE_FLOATS floats per particle.
+    *** \param texture_rect The texture coordinates (u1, v1, u2, v2) of every particle.
+    *** \param color The color every particle color is multiplied by.
+    **/
+    void DrawParticleInstances(gl::ShaderProgram* shader_program,
+                               const float* instances,
+                               unsigned number_of_instances,
+                               const float* texture_rect,
+                               const Color& color);
+
+    //! \brief Whether the particle systems can be simulated on the GPU.
+    bool IsParticleSimulationSupported() const;
+
+    //! \brief Returns the worker threads updating the particle effects, shared by every particle manager.
+    vt_mode_manager::ParticleUpdater* GetParticleUpdater() {
+        return _particle_updater;
+    }
+
+    /** \brief Advances the particles simulated on the GPU by one step.
+    *** \param shader_program The particle simulation program, loaded, with its uniforms set.
+    **/
+    void SimulateParticles(gl::ShaderProgram* shader_program,
+                           gl::ParticleSimulation* particle_simulation);
+
+    /** \brief Draws the particles simulated on the GPU, as instances of a unit quad.
+    *** \param texture_rect The texture coordinates (u1, v1, u2, v2) of every particle.
+    *** \param color The color every particle color is multiplied by.
+    **/
+    void DrawSimulatedParticles(gl::ShaderProgram* shader_program,
+                                const gl::ParticleSimulation* particle_simulation,
+                                const float* texture_rect,
+                                const Color& color);
+
+    /** \brief Draws sprites kept in video memory, using the current model matrix.
+    *** The queued sprites are drawn first, to preserve the drawing order.
+    **/
+    void DrawStaticSprites(gl::ShaderProgram* shader_program,
+                           gl::StaticSpriteBuffer* sprite_buffer);
+
+    /** \brief Draws a sprite.
+    *** The sprite is transformed by the current model matrix, modulated by the given color
+    *** and queued in the sprite batch. Consecutive sprites sharing the same shader program
+    *** and texture are then drawn using a single draw call.
+    **/
     void DrawSprite(gl::ShaderProgram* shader_program,
                     float* vertex_positions,
                     float* vertex_texture_coordinates,
                     float* vertex_colors,
                     const Color& color = ::vt_video::Color::white);
 
+    /** \brief Draws every queued sprite.
+    *** \note This must be called before changing any OpenGL state the queued sprites depend on.
+    *** The video engine functions changing such a state already take care of it.
+    **/
+    void FlushSpriteBatch();
+
+    /** \brief Draws every queued sprite and submits the frame to the GPU without waiting for it.
+    *** The game can then be updated while the GPU renders the frame, before the buffers are swapped.
+    **/
+    void SubmitFrame();
+
     /** \brief Enables the scissoring effect in the video engine
     *** Scissoring is where you can specify a rectangle of the screen which is affected
     *** by rendering operations (and hence, specify what area is not affected). Make sure
@@ -413,6 +677,7 @@ public:
     ***
     *** \note This is a very expensive function call. If you only need to push
     *** the current transformation, you should use PushMatrix() and PopMatrix().
+    *** If you only need to restore the draw flags, save them with GetDrawState().
     ***
     *** \note The size of the stack is small (around 32 entries), so you should
     *** try and limit the maximum number of pushed state entries so that this
@@ -464,6 +729,10 @@ public:
     *** captures in memory at the same time. You should be careful not to have too many
     *** screen captures existing at one time, because each image capture requires a relatively
     *** large amount of texutre memory (roughly 3GB for a 1024x768 screen).
+    ***
+    *** \note The captures of a same frame share their texture: The modes pushed
+    *** on top of each other in one update, e.g. a pause over a menu, don't copy
+    *** the screen again.
     **/
     StillImage CaptureScreen();
 
@@ -588,6 +857,7 @@ public:
 
     /** \brief Takes a screenshot and saves the image to a file
     *** \param filename The name of the file, if any, to save the screenshot as. Default is "screenshot.png"
+    *** \note The file is written a few frames later, by a worker thread.
     **/
     void MakeScreenshot(const std::string &filename = "screenshot.png");
 
@@ -609,7 +879,7 @@ public:
      */
     TextStyle GetTextStyle();
 
-    //! \brief toggles the FPS display
+    //! \brief toggles the FPS and rendering statistics display
     void ToggleFPS() {
         _fps_display = !_fps_display;
     }
@@ -643,6 +913,15 @@ private:
     //! The secondary render target.
     gl::RenderTarget* _secondary_render_target;
 
+    //! The lower resolution render target the lights are accumulated in.
+    gl::RenderTarget* _light_render_target;
+
+    //! The render target the static layers are cached in, created once needed.
+    gl::RenderTarget* _layer_cache_render_target;
+
+    //! Whether layers were cached in the layer cache render target since it was resized.
+    bool _layer_cache_valid;
+
     //! The FPS display flag.  If true, FPS is displayed.
     bool _fps_display;
 
@@ -667,6 +946,18 @@ private:
     //! The FPS text
     TextImage* _FPS_textimage;
 
+    //! The rendering statistics of the frames drawn.
+    private_video::RenderStats _render_stats;
+
+    //! The rendering statistics text, shown along with the FPS.
+    TextImage* _render_stats_textimage;
+
+    //! The frame profiler overlay text.
+    TextImage* _profiler_textimage;
+
+    //! The memory accounting overlay text.
+    TextImage* _memory_textimage;
+
     //! \brief Holds the most recently fetched OpenGL error code
     GLenum _gl_error_code;
 
@@ -684,6 +975,22 @@ private:
     //! \brief Holds whether the GL_SCISSOR_TEST state is activated. Used to optimize the drawing logic
     bool _gl_scissor_test_is_active;
 
+    //! \brief Holds the current blending function factors. Used to optimize the drawing logic
+    GLenum _gl_blend_source_factor;
+    GLenum _gl_blend_destination_factor;
+
+    //! \brief Holds the current stencil test function and operations. Used to optimize the drawing logic
+    GLenum _gl_stencil_function;
+    GLint _gl_stencil_reference;
+    GLuint _gl_stencil_mask;
+    GLenum _gl_stencil_ops[3];
+
+    //! \brief Holds the scissor rectangle currently applied to OpenGL.
+    ScreenRect _gl_scissor_rectangle;
+
+    //! \brief Holds the viewport currently applied to OpenGL.
+    ScreenRect _gl_viewport;
+
     //! \brief The x/y offsets, width and height of the current viewport (the drawn part), in pixels
     //! \note the viewport is different from the screen size when in non-4:3 modes.
     int32_t _viewport_x_offset;
@@ -734,6 +1041,36 @@ private:
     //! \brief Stores the current vsync mode.
     uint32_t _vsync_mode;
 
+    //! \brief The render scale setting, in percents, or VIDEO_RENDER_SCALE_DYNAMIC.
+    uint32_t _render_scale;
+
+    //! \brief The render scale the secondary and light render targets are sized at, in percents.
+    uint32_t _current_render_scale;
+
+    //! \brief Whether the secondary render target is upscaled with its nearest pixels.
+    bool _sharp_upscaling;
+
+    //! \brief The GPU time of the frames measured since the dynamic render scale was last evaluated,
+    //! their count, and the number of the last frame measured.
+    float _dynamic_scale_gpu_time;
+    uint32_t _dynamic_scale_frames;
+    uint32_t _dynamic_scale_frame_number;
+
+    //! \brief The graphics quality preset, and the performance settings it sets.
+    uint32_t _graphics_quality;
+    uint32_t _particle_density;
+    bool _light_flares;
+    bool _ambient_overlays;
+    uint32_t _frame_cap;
+
+    //! \brief The automatic quality level, the GPU time of the frames measured since it was
+    //! last evaluated, their count, the frames updated meanwhile and the number of the last frame measured.
+    uint32_t _auto_quality_level;
+    float _auto_quality_gpu_time;
+    uint32_t _auto_quality_gpu_frames;
+    uint32_t _auto_quality_frames;
+    uint32_t _auto_quality_frame_number;
+
     //! \brief The game main loop update mode.
     //! \note update_mode true for performance, false for the CPU-gentle loop.
     //! It is always on performance when VSync is enabled.
@@ -749,14 +1086,52 @@ private:
     gl::Transform _projection;
 
     //! The stack containing transforms. Pushed and popped by PushMatrix/PopMatrix.
-    std::stack<gl::Transform> _transform_stack;
+    //! It never allocates, the current transform being the one at _transform_stack_size - 1.
+    gl::Transform _transform_stack[TRANSFORM_STACK_SIZE];
+    uint32_t _transform_stack_size;
+
+    //! The number of pushes ignored because the transform stack was full, so that their pops are ignored too.
+    uint32_t _transform_stack_overflow;
+
+    //! Returns the current model transform.
+    gl::Transform& _GetTransform() {
+        return _transform_stack[_transform_stack_size - 1];
+    }
+
+    //! The ring buffer the sprite, sprite batch and particle system vertices are streamed through.
+    gl::StreamBuffer* _stream_buffer;
 
     //! The OpenGL buffers and objects to draw a sprite.
     gl::Sprite* _sprite;
 
+    //! The OpenGL buffers and objects to draw sprites in batches.
+    gl::SpriteBatch* _sprite_batch;
+
+    //! The shader program currently in use, to avoid switching programs needlessly.
+    gl::ShaderProgram* _current_shader_program;
+
+    //! The programs drawing without any texture, whose sprites are batched whatever the bound texture.
+    gl::ShaderProgram* _solid_program;
+    gl::ShaderProgram* _solid_grayscale_program;
+
     //! The OpenGL buffers and objects to draw a particle system.
     gl::ParticleSystem* _particle_system;
 
+    //! The worker threads updating the particle effects.
+    vt_mode_manager::ParticleUpdater* _particle_updater;
+
+    //! Reads the screenshots back and saves them without stalling.
+    private_video::ScreenshotWriter* _screenshot_writer;
+
+    /** \brief The last screen captured, shared by the captures of the same frame.
+    *** It is released once the next frame is drawn.
+    **/
+    StillImage _screen_capture;
+
+    //! \brief The number of frames submitted, telling whether _screen_capture is of the current frame.
+    uint32_t _submitted_frames;
+    uint32_t _screen_capture_frame;
+
     //! The OpenGL shaders.
     std::map<gl::shaders::Shaders, gl::Shader*> _shaders;
 
@@ -784,12 +1159,64 @@ private:
     //! \note it also centers the viewport when the resolution isn't a 4:3 one.
     void _UpdateViewportMetrics();
 
+    //! \brief Sizes the secondary and light render targets after the screen and the current render scale.
+    void _ResizeRenderTargets();
+
+    //! \brief Lowers or raises the dynamic render scale according to the GPU frame time.
+    void _UpdateDynamicRenderScale();
+
+    //! \brief Lowers or raises the automatic quality level according to the frame times.
+    void _UpdateAutoQuality();
+
+    //! \brief Applies the performance settings of an automatic quality level.
+    void _SetAutoQualityLevel(uint32_t level);
+
+    //! \brief Makes the given shader program current, unless it already is.
+    void _UseShaderProgram(gl::ShaderProgram* shader_program);
+
+    /** \brief Builds the next shader program not built yet on the next frame, and so on.
+    *** The programs used before are simply built when first loaded.
+    **/
+    void _WarmUpShaderPrograms();
+
+    //! \brief Sets the blending and program used by the solid primitives, and returns the program.
+    gl::ShaderProgram* _LoadSolidPrimitiveState();
+
+    /** \brief Queues a line in the sprite batch, as a quad.
+    *** \param shader_program The program returned by _LoadSolidPrimitiveState().
+    *** The other parameters are the DrawLine() ones.
+    **/
+    void _QueueLine(gl::ShaderProgram* shader_program,
+                    float x1, float y1, unsigned width1,
+                    float x2, float y2, unsigned width2, const Color &color);
+
+    //! \brief Updates the uniforms of the particle program before drawing instances.
+    void _UpdateParticleUniforms(gl::ShaderProgram* shader_program,
+                                 const float* texture_rect,
+                                 const Color& color);
+
+    //! \brief Draws the texture of a render target over the whole current viewport.
+    void _DrawRenderTarget(gl::RenderTarget* render_target);
+
+    /** \brief Draws the elements of a composite image in a new texture region.
+    *** \param width The width of the region, in pixels, spanning the composite width.
+    *** \param height The height of the region, in pixels, spanning the composite height.
+    *** \return The image of the region, without texture when it couldn't be made.
+    **/
+    StillImage _FlattenCompositeImage(const CompositeImage& composite, uint32_t width, uint32_t height);
+
     // Debug info
     //! \brief Updates the FPS counter.
     void _UpdateFPS();
 
-    //! \brief Draws the current average FPS to the screen.
+    //! \brief Draws the current average FPS and the rendering statistics to the screen.
     void _DrawFPS();
+
+    //! \brief Draws the frame profiler timings, when its overlay is shown.
+    void _DrawProfilerOverlay();
+
+    //! \brief Draws the memory used by each subsystem, when its overlay is shown.
+    void _DrawMemoryOverlay();
 };
 
 } // namespace vt_video
@@ -35,9 +35,41 @@ const float VIDEO_STANDARD_RES_HEIGHT = 768.0f;
 const float VIDEO_VIEWPORT_WIDTH  = 800.0f;
 const float VIDEO_VIEWPORT_HEIGHT = 600.0f;
 
+//! \brief The resolutions the game world can be drawn at, in percents of the screen resolution.
+const uint32_t VIDEO_RENDER_SCALE_MIN = 50;
+const uint32_t VIDEO_RENDER_SCALE_MAX = 100;
+const uint32_t VIDEO_RENDER_SCALE_STEP = 10;
+
+//! \brief The render scale setting lowering the resolution while the GPU frame time is too long.
+const uint32_t VIDEO_RENDER_SCALE_DYNAMIC = 0;
+
+//! \brief The share of the particles the systems may emit, in percents.
+const uint32_t VIDEO_PARTICLE_DENSITY_MIN = 25;
+const uint32_t VIDEO_PARTICLE_DENSITY_MAX = 100;
+const uint32_t VIDEO_PARTICLE_DENSITY_STEP = 25;
+
+//! \brief The frame cap setting keeping the display frame rate.
+const uint32_t VIDEO_FRAME_CAP_NONE = 0;
+
+//! \brief The graphics quality presets, setting the render scale, the particle density,
+//! the light flares, the ambient overlays and the frame cap at once.
+enum VIDEO_QUALITY {
+    //! The settings are set one by one.
+    VIDEO_QUALITY_CUSTOM = 0,
+    VIDEO_QUALITY_LOW = 1,
+    VIDEO_QUALITY_MEDIUM = 2,
+    VIDEO_QUALITY_HIGH = 3,
+    //! The particle density, the light flares and the ambient overlays follow the frame times.
+    VIDEO_QUALITY_AUTO = 4,
+    VIDEO_QUALITY_TOTAL = 5
+};
+
 //! \brief The number of FPS samples to retain across frames
 const uint32_t FPS_SAMPLES = 250;
 
+//! \brief The maximum number of transforms pushed with PushMatrix() or PushState() at once.
+const uint32_t TRANSFORM_STACK_SIZE = 32;
+
 //! \brief Draw flags to control x and y alignment, flipping, and texture blending.
 enum VIDEO_DRAW_FLAGS {
     VIDEO_DRAW_FLAGS_INVALID = -1,
@@ -27,8 +27,20 @@
 *** -# Update the game status based on how much time expired from the last update.
 *** ***************************************************************************/
 
+#include "engine/asset_archive.h"
+#include "engine/asset_manifest.h"
+#include "engine/asset_watcher.h"
 #include "engine/audio/audio.h"
+#include "engine/benchmark.h"
+#include "engine/frame_profiler.h"
+#include "engine/hitch_recorder.h"
+#include "engine/idle_scheduler.h"
+#include "engine/performance_telemetry.h"
 #include "engine/input.h"
+#include "engine/job_system.h"
+#include "engine/log_backend.h"
+#include "engine/lua_heap.h"
+#include "engine/memory_stats.h"
 #include "engine/mode_manager.h"
 #include "engine/video/video.h"
 #include "engine/system.h"
@@ -37,12 +49,18 @@
 #include "common/gui/gui.h"
 #include "common/app_settings.h"
 #include "common/app_name.h"
+#include "common/random_streams.h"
+#include "common/script_call_profiler.h"
 
+#include "modes/battle/battle_simulation.h"
 #include "modes/boot/boot.h"
 #include "main_options.h"
+#include "microbenchmarks.h"
 
 #include <SDL2/SDL_image.h>
 
+#include <algorithm>
+
 #ifdef _WIN32
 #include <ctime>
 #include <windows.h>
@@ -76,6 +94,37 @@ void BindModeCode();
 
 } // namespace vt_defs
 
+//! \brief The startup stages and their duration in milliseconds, printed with --startup-trace.
+static std::vector<std::pair<std::string, double> > startup_stages;
+
+//! \brief The performance counter when the current startup stage started.
+static uint64_t startup_stage_start = 0;
+
+//! \brief Ends the current startup stage, the next one starting right away.
+static void EndStartupStage(const std::string& stage_name)
+{
+    const uint64_t now = SDL_GetPerformanceCounter();
+    const double duration = static_cast<double>(now - startup_stage_start) * 1000.0 /
+                            static_cast<double>(SDL_GetPerformanceFrequency());
+    startup_stages.push_back(std::make_pair(stage_name, duration));
+    startup_stage_start = now;
+}
+
+//! \brief Prints the startup stages durations, when requested.
+static void PrintStartupTrace()
+{
+    if(!vt_main::IsStartupTraceEnabled())
+        return;
+
+    printf("\n===== Startup Time\n");
+    double total = 0.0;
+    for(uint32_t i = 0; i < startup_stages.size(); ++i) {
+        printf("  %-32s %8.1f ms\n", startup_stages[i].first.c_str(), startup_stages[i].second);
+        total += startup_stages[i].second;
+    }
+    printf("  %-32s %8.1f ms\n", "Total", total);
+}
+
 /** \brief Reads in all of the saved game settings and sets values in the according game manager classes
 *** \return True if the settings were loaded successfully
 **/
@@ -163,6 +212,33 @@ static bool LoadSettings()
     VideoManager->SetFullscreen(settings.ReadBool("full_screen"));
     if (settings.DoesUIntExist("vsync_mode"))
         VideoManager->SetVSyncMode(settings.ReadUInt("vsync_mode"));
+    if (settings.DoesUIntExist("render_scale"))
+        VideoManager->SetRenderScale(settings.ReadUInt("render_scale"));
+    if (settings.DoesBoolExist("sharp_upscaling"))
+        VideoManager->SetSharpUpscaling(settings.ReadBool("sharp_upscaling"));
+    // The frame times tune the performance settings when no preset was chosen yet.
+    uint32_t graphics_quality = VIDEO_QUALITY_AUTO;
+    if (settings.DoesUIntExist("graphics_quality"))
+        graphics_quality = settings.ReadUInt("graphics_quality");
+    VideoManager->SetGraphicsQuality(graphics_quality);
+    if (VideoManager->GetGraphicsQuality() == VIDEO_QUALITY_CUSTOM) {
+        if (settings.DoesUIntExist("particle_density"))
+            VideoManager->SetParticleDensity(settings.ReadUInt("particle_density"));
+        if (settings.DoesBoolExist("light_flares"))
+            VideoManager->SetLightFlares(settings.ReadBool("light_flares"));
+        if (settings.DoesBoolExist("ambient_overlays"))
+            VideoManager->SetAmbientOverlays(settings.ReadBool("ambient_overlays"));
+        if (settings.DoesUIntExist("frame_cap"))
+            VideoManager->SetFrameCap(settings.ReadUInt("frame_cap"));
+    }
+    if (settings.DoesUIntExist("texture_upload_budget"))
+        TextureManager->SetUploadBudget(std::min(settings.ReadUInt("texture_upload_budget"), 4095u) * 1024);
+    if (settings.DoesUIntExist("texture_memory_budget"))
+        TextureManager->SetTextureMemoryBudget(std::min(settings.ReadUInt("texture_memory_budget"), 4095u) * 1024 * 1024);
+    if (settings.DoesUIntExist("hitch_threshold"))
+        vt_system::HitchRecorder::SetThreshold(settings.ReadUInt("hitch_threshold"));
+    if (settings.DoesBoolExist("performance_telemetry"))
+        vt_system::PerformanceTelemetry::SetEnabled(settings.ReadBool("performance_telemetry"));
     GUIManager->SetUserMenuSkin(settings.ReadString("ui_theme"));
     settings.CloseTable(); // video_settings
 
@@ -256,6 +332,18 @@ static void LoadGUIThemes(const std::string& theme_script_filename)
 
     bool default_theme_found = false;
 
+    // The theme files are read first, so that all their images are decoded in the background
+    // while the previous skins are loaded.
+    struct MenuSkinFiles {
+        std::string id;
+        std::string name;
+        std::string win_border_file;
+        std::string win_background_file;
+        std::string cursor_file;
+        std::string scroll_arrows_file;
+    };
+    std::vector<MenuSkinFiles> skins;
+
     for(uint32_t i = 0; i < theme_ids.size(); ++i) {
         // Skip the default theme value
         if (theme_ids[i] == "default_theme")
@@ -263,32 +351,50 @@ static void LoadGUIThemes(const std::string& theme_script_filename)
 
         theme_script.OpenTable(theme_ids[i]); // Theme name
 
-        std::string theme_name = theme_script.ReadString("name");
-        std::string win_border_file = theme_script.ReadString("win_border_file");
-        std::string win_background_file = theme_script.ReadString("win_background_file");
-        std::string cursor_file = theme_script.ReadString("cursor_file");
-        std::string scroll_arrows_file = theme_script.ReadString("scroll_arrows_file");
+        MenuSkinFiles skin;
+        skin.id = theme_ids[i];
+        skin.name = theme_script.ReadString("name");
+        skin.win_border_file = theme_script.ReadString("win_border_file");
+        skin.win_background_file = theme_script.ReadString("win_background_file");
+        skin.cursor_file = theme_script.ReadString("cursor_file");
+        skin.scroll_arrows_file = theme_script.ReadString("scroll_arrows_file");
+
+        TextureManager->PrefetchImage(skin.win_border_file);
+        TextureManager->PrefetchImage(skin.win_background_file);
+        TextureManager->PrefetchImage(skin.cursor_file);
+        TextureManager->PrefetchImage(skin.scroll_arrows_file);
 
         if (default_theme_id == theme_ids[i])
             default_theme_found = true;
 
-        if (!GUIManager->LoadMenuSkin(theme_ids[i], theme_name, cursor_file,
-                                      scroll_arrows_file, win_border_file,
-                                      win_background_file)) {
-            theme_script.CloseAllTables();
-            theme_script.CloseFile();
-            PRINT_ERROR << "The theme '" << theme_ids[i]
+        skins.push_back(skin);
+
+        theme_script.CloseTable(); // Theme name
+    }
+
+    theme_script.CloseTable(); // themes
+    theme_script.CloseFile();
+
+    for(uint32_t i = 0; i < skins.size(); ++i) {
+        const MenuSkinFiles& skin = skins[i];
+        if (!GUIManager->LoadMenuSkin(skin.id, skin.name, skin.cursor_file,
+                                      skin.scroll_arrows_file, skin.win_border_file,
+                                      skin.win_background_file)) {
+            PRINT_ERROR << "The theme '" << skin.id
                         << "' couldn't be loaded in file: '"
                         << theme_script_filename
                         << "'. Exitting." << std::endl;
             exit(EXIT_FAILURE);
         }
-
-        theme_script.CloseTable(); // Theme name
     }
 
-    theme_script.CloseTable(); // themes
-    theme_script.CloseFile();
+    // The prefetched images not taken by the skins, such as those already loaded, are forgotten.
+    for(uint32_t i = 0; i < skins.size(); ++i) {
+        TextureManager->CancelPrefetchedImage(skins[i].win_border_file);
+        TextureManager->CancelPrefetchedImage(skins[i].win_background_file);
+        TextureManager->CancelPrefetchedImage(skins[i].cursor_file);
+        TextureManager->CancelPrefetchedImage(skins[i].scroll_arrows_file);
+    }
 
     // Query for the user menu skin which could have been set in the user settings lua file.
     std::string user_theme_id = GUIManager->GetUserMenuSkinId();
@@ -327,6 +433,7 @@ static void InitializeEngine()
     }
 
     // Create and initialize singleton class managers
+    JobManager = JobSystem::SingletonCreate();
     AudioManager = AudioEngine::SingletonCreate();
     InputManager = InputEngine::SingletonCreate();
     ScriptManager = ScriptEngine::SingletonCreate();
@@ -336,24 +443,37 @@ static void InitializeEngine()
     GUIManager = GUISystem::SingletonCreate();
     GlobalManager = GameGlobal::SingletonCreate();
 
+    // Start the job workers first, so that the other managers can use them.
+    if(!JobManager->SingletonInitialize()) {
+        throw Exception("ERROR: unable to initialize JobManager",
+                        __FILE__, __LINE__, __FUNCTION__);
+    }
+    EndStartupStage("Job system");
+
     if(!VideoManager->SingletonInitialize()) {
         throw Exception("ERROR: unable to initialize VideoManager",
                         __FILE__, __LINE__, __FUNCTION__);
     }
+    EndStartupStage("Video engine");
 
     if(!AudioManager->SingletonInitialize()) {
         throw Exception("ERROR: unable to initialize AudioManager",
                         __FILE__, __LINE__, __FUNCTION__);
     }
+    EndStartupStage("Audio engine");
 
     if(!ScriptManager->SingletonInitialize()) {
         throw Exception("ERROR: unable to initialize ScriptManager",
                         __FILE__, __LINE__, __FUNCTION__);
     }
+    // The pools allocator is wrapped by the memory accounting.
+    LuaHeap::Install(ScriptManager->GetGlobalState());
+    MemoryStats::TrackLuaState(ScriptManager->GetGlobalState());
 
     vt_defs::BindEngineCode();
     vt_defs::BindCommonCode();
     vt_defs::BindModeCode();
+    EndStartupStage("Script engine and bindings");
 
     if(!SystemManager->SingletonInitialize()) {
         throw Exception("ERROR: unable to initialize SystemManager",
@@ -367,11 +487,13 @@ static void InitializeEngine()
         throw Exception("ERROR: unable to initialize ModeManager",
                         __FILE__, __LINE__, __FUNCTION__);
     }
+    EndStartupStage("System, input and modes");
 
     // Load all the settings from lua. This includes some engine configuration settings.
     if(!LoadSettings())
         throw Exception("ERROR: Unable to load settings file",
                         __FILE__, __LINE__, __FUNCTION__);
+    EndStartupStage("Settings");
 
     // Apply engine configuration settings with delayed initialization calls to the managers
     InputManager->InitializeJoysticks();
@@ -380,8 +502,13 @@ static void InitializeEngine()
         throw Exception("ERROR: Unable to apply video settings",
                         __FILE__, __LINE__, __FUNCTION__);
 
+    // The media images are decoded in the background while the rest is initialized.
+    GlobalManager->PrefetchMediaImages();
+    EndStartupStage("Video settings and shaders");
+
     // Loads the GUI skins.
     LoadGUIThemes("data/config/themes.lua");
+    EndStartupStage("GUI themes");
 
     // NOTE: This function call should have its argument set to false for release builds
     GUIManager->DEBUG_EnableGUIOutlines(false);
@@ -389,9 +516,11 @@ static void InitializeEngine()
     // Loads needed game text styles (fonts + colors + shadows)
     if (!TextManager->LoadFonts(SystemManager->GetLanguageLocale()))
         exit(EXIT_FAILURE);
+    EndStartupStage("Fonts");
 
     // Loads potential emotes
     GlobalManager->GetEmoteHandler().LoadEmotes("data/entities/emotes.lua");
+    EndStartupStage("Emotes");
 
     // Hide the mouse cursor since we don't use or acknowledge mouse input from the user
     SDL_ShowCursor(SDL_DISABLE);
@@ -407,6 +536,7 @@ static void InitializeEngine()
         throw Exception("ERROR: unable to initialize GUIManager",
                         __FILE__, __LINE__, __FUNCTION__);
     }
+    EndStartupStage("GUI manager");
 
     // This loads the game global script, once everything is ready,
     // and will permit to load skills, items and other translatable strings
@@ -414,6 +544,7 @@ static void InitializeEngine()
     if(!GlobalManager->SingletonInitialize())
         throw Exception("ERROR: unable to initialize GlobalManager",
                         __FILE__, __LINE__, __FUNCTION__);
+    EndStartupStage("Global media and scripts");
 
     SystemManager->InitializeTimers();
 }
@@ -433,6 +564,12 @@ int main(int argc, char* argv[])
     // When the program exits, call 'SDL_Quit'.
     atexit(SDL_Quit);
 
+    // Write the warnings and errors from a background thread, until the program exits.
+    vt_system::LogBackend::Start();
+    atexit(vt_system::LogBackend::Stop);
+
+    startup_stage_start = SDL_GetPerformanceCounter();
+
     if(SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
         PRINT_ERROR << "SDL video initialization failed" << std::endl;
         return EXIT_FAILURE;
@@ -472,6 +609,7 @@ int main(int argc, char* argv[])
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 2);
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
     SDL_GL_SetSwapInterval(1);
+    EndStartupStage("Window and OpenGL context");
 
     try {
         // Change to the directory where the game data is stored
@@ -495,8 +633,12 @@ int main(int argc, char* argv[])
         }
 #endif
 
+        // Read the packed assets from memory, when the archive exists.
+        vt_system::MountAssetArchive(vt_system::ASSET_ARCHIVE_FILENAME);
+
         // Initialize the random number generator (note: 'unsigned int' is a required usage in this case)
         srand(static_cast<unsigned int>(time(nullptr)));
+        vt_common::SeedRandomStreams(static_cast<uint64_t>(time(nullptr)));
 
         // This variable will be set by the ParseProgramOptions function
         int32_t return_code = EXIT_FAILURE;
@@ -507,6 +649,8 @@ int main(int argc, char* argv[])
             return static_cast<int>(return_code);
         }
 
+        EndStartupStage("Program options");
+
         // Function call below throws exceptions if any errors occur
         InitializeEngine();
 
@@ -523,75 +667,186 @@ int main(int argc, char* argv[])
     // Set the window handle, apply actual screen resolution
     VideoManager->SetWindowHandle(sdl_window);
     VideoManager->ApplySettings();
+    EndStartupStage("Screen resolution");
 
     // Now the settings are loaded, let's set the windows translated title.
     // tr: The window title only supports UTF-8 characters in SDL2.
     std::string app_fullname = vt_system::Translate("Valyria Tear");
     SDL_SetWindowTitle(sdl_window, app_fullname.c_str());
 
-    SDL_ShowWindow(sdl_window);
-    ModeManager->Push(new BootMode(), false, true);
+    // The replays start from the same random seed as the recorded session.
+    const vt_main::ReplayOptions& replay_options = vt_main::GetReplayOptions();
+    vt_system::Replay& replay = SystemManager->GetReplay();
+    if (!replay_options.replay_filename.empty()) {
+        if (!replay.StartReplaying(replay_options.replay_filename, replay_options.fast))
+            return EXIT_FAILURE;
+        srand(static_cast<unsigned int>(replay.GetRandomSeed()));
+        vt_common::SeedRandomStreams(replay.GetRandomSeed());
+        // Don't wait for the screen refreshes when replaying as fast as possible.
+        if (replay.IsFast())
+            SDL_GL_SetSwapInterval(0);
+    }
+    else if (!replay_options.record_filename.empty()) {
+        if (!replay.StartRecording(replay_options.record_filename, vt_common::GetRandomSeed()))
+            return EXIT_FAILURE;
+        srand(static_cast<unsigned int>(vt_common::GetRandomSeed()));
+    }
+
+    // The battle simulations are run with the window hidden, and the game exits once done.
+    // The benchmarks push their scenario modes instead of the boot menu, and exit once measured.
+    const vt_main::BenchmarkOptions& benchmark_options = vt_main::GetBenchmarkOptions();
+    vt_system::Benchmark benchmark;
+    const vt_main::BattleSimulationOptions& battle_simulation_options = vt_main::GetBattleSimulationOptions();
+    int exit_code = EXIT_SUCCESS;
+    if (battle_simulation_options.battle_count > 0) {
+        try {
+            vt_battle::BattleSimulation battle_simulation(battle_simulation_options.save_filename,
+                                                          battle_simulation_options.enemy_ids,
+                                                          battle_simulation_options.battle_count,
+                                                          vt_common::GetRandomSeed());
+            battle_simulation.SetDifficulty(battle_simulation_options.difficulty);
+            battle_simulation.SetResultsFilename(battle_simulation_options.results_filename);
+            if (!battle_simulation.Run())
+                exit_code = EXIT_FAILURE;
+        } catch(const Exception& e) {
+            std::cerr << e.ToString() << std::endl;
+            exit_code = EXIT_FAILURE;
+        }
+        SystemManager->ExitGame();
+    }
+    else if (!benchmark_options.microbenchmark_filter.empty()) {
+        // Run with the window hidden, as the battle simulations.
+        if (!vt_main::RunMicroBenchmarks(benchmark_options.microbenchmark_filter,
+                                         benchmark_options.results_filename))
+            exit_code = EXIT_FAILURE;
+        SystemManager->ExitGame();
+    }
+    else if (!benchmark_options.scenario.empty()) {
+        SDL_ShowWindow(sdl_window);
+        if (!benchmark.Start(benchmark_options.scenario, benchmark_options.frame_count)) {
+            exit_code = EXIT_FAILURE;
+            SystemManager->ExitGame();
+        }
+    }
+    else {
+        SDL_ShowWindow(sdl_window);
+        ModeManager->Push(new BootMode(), false, true);
+        EndStartupStage("Boot mode");
+        PrintStartupTrace();
+    }
 
-    // Used for a variable game speed,
-    // sleeping when on sufficiently fast hardware, and max FPS.
-    const uint32_t UPDATES_PER_SECOND = 60 + 10; // 10 is a smoothness safety margin
-    const uint32_t SKIP_UPDATE_TICKS = 1000 / UPDATES_PER_SECOND;
-    // The average time assumed to do a game logic cycle
-    const uint32_t MIN_LOGIC_DELAY = 16; // in ms
-    uint32_t update_tick = SDL_GetTicks();
-    uint32_t next_update_tick = update_tick;
+    // The game logic runs in fixed steps, as many per frame as the time the frame took allows.
+    // The frames are paced by the buffer swaps when VSync is on, and otherwise capped
+    // to the display refresh rate, the still screens being throttled.
+    // The frame rate below is the cap used when the display one is unknown.
+    const int32_t DEFAULT_FRAMES_PER_SECOND = 60 + 10; // 10 is a smoothness safety margin
+    SDL_DisplayMode display_mode;
+    const int32_t frames_per_second = (SDL_GetWindowDisplayMode(sdl_window, &display_mode) == 0 &&
+                                       display_mode.refresh_rate > 0) ?
+                                      display_mode.refresh_rate : DEFAULT_FRAMES_PER_SECOND;
+    FramePacer& frame_pacer = SystemManager->GetFramePacer();
+    frame_pacer.SetFrameRate(frames_per_second);
 
     try {
         // This is the main loop for the game.
         // The loop iterates once for every frame drawn to the screen.
         while (SystemManager->NotDone()) {
 
-            update_tick = SDL_GetTicks();
-
-            // If we want to be nice with the CPU % used.
-            if (update_tick <= next_update_tick &&
-                    next_update_tick - update_tick >= MIN_LOGIC_DELAY) {
-                SDL_Delay(next_update_tick - update_tick);
-            }
-
-            // Render capped at UPDATES_PER_SECOND
-            // if the update mode is gentle with the CPU(s).
-            if (update_tick > next_update_tick) {
-
-                // Clear the primary render target.
-                VideoManager->Clear();
-
-                // Draw the game.
-                ModeManager->Draw();
-                ModeManager->DrawEffects();
-                ModeManager->DrawPostEffects();
-                VideoManager->DrawFadeEffect();
-                VideoManager->DrawDebugInfo();
-
-                // Swap the buffers once the draw operations are done.
-                SDL_GL_SwapWindow(sdl_window);
-
-                // Update the game logic
+            // The fast replays and the benchmarks never wait, and render every update.
+            // The replays aren't throttled, to keep their frame times comparable.
+            // A frame cap below the display frame rate is kept even with VSync.
+            const bool fast_replay = replay.IsFast() || benchmark.IsRunning();
+            frame_pacer.SetFrameCap(VideoManager->GetFrameCap());
+            const bool vsync = VideoManager->GetVSyncMode() != 0 && !frame_pacer.IsCapped();
+            const bool idle = !replay.IsReplaying() && !benchmark.IsRunning() && !InputManager->AnyEvent() && ModeManager->IsIdle();
+            frame_pacer.WaitForNextFrame(idle, fast_replay || vsync);
+
+            // Timestamp the input arrived while waiting, before drawing.
+            InputManager->PollEvents();
+
+            // Clear the primary render target.
+            VideoManager->Clear();
+
+            // Draw the game.
+            ModeManager->Draw();
+            VideoManager->SetRenderPass(vt_video::RENDER_PASS_POST_EFFECTS);
+            ModeManager->DrawEffects();
+            ModeManager->DrawPostEffects();
+            VideoManager->SetRenderPass(vt_video::RENDER_PASS_POST_EFFECTS);
+            VideoManager->DrawFadeEffect();
+            ModeManager->DrawLoadingIndicator();
+            VideoManager->SetRenderPass(vt_video::RENDER_PASS_OTHER);
+            VideoManager->DrawDebugInfo();
+
+            // Draw the sprites still queued, and let the GPU render the frame
+            // while the game logic is updated.
+            VideoManager->SubmitFrame();
+
+            // Update the game logic
+
+            // Run the jobs needing the OpenGL context or the Lua state
+            JobManager->RunMainThreadJobs();
+
+#ifdef DEBUG_FEATURES
+            // Reload the assets edited meanwhile
+            AssetWatcher::Update();
+#endif
 
+            // Run the logic updates the time elapsed since the last frame allows,
+            // each one advancing the game by the same time.
+            const uint32_t logic_updates = SystemManager->ComputeLogicUpdates();
+            for (uint32_t i = 0; i < logic_updates; ++i) {
                 // Update timers for correct time-based movement operation
                 SystemManager->UpdateTimers();
 
                 // Process all new events
                 InputManager->EventHandler();
 
-                // Update video
-                VideoManager->Update();
-
-                // Update any streaming audio sources
-                AudioManager->Update();
-
                 // Update the game status
                 ModeManager->Update();
+            }
+
+            // Update video
+            VideoManager->Update();
+
+            // Update any streaming audio sources
+            AudioManager->Update();
+
+            // Report the autosaves written in the background
+            GlobalManager->UpdateAutoSave();
+
+            // Collect the Lua garbage within the frame budget
+            LuaHeap::Step();
+
+            // Run the deferred work in the time left before the frame deadline
+            IdleScheduler::Run(frame_pacer.GetRemainingTime() - IDLE_FRAME_MARGIN);
 
-                // Wait for the next update.
-                next_update_tick += SKIP_UPDATE_TICKS;
+            // Swap the buffers once the frame is rendered, which may wait for the display.
+            // The next frame is then drawn from the updated game state.
+            frame_pacer.FrameRendered();
+            {
+                PROFILE_SCOPE("SDL_GL_SwapWindow");
+                SDL_GL_SwapWindow(sdl_window);
             }
+            InputManager->FramePresented();
+
+#ifdef DEBUG_FEATURES
+            FrameProfiler::EndFrame();
+#endif
+            HitchRecorder::EndFrame();
+            PerformanceTelemetry::EndFrame(HitchRecorder::GetLastFrameTime());
+
+            if (benchmark.IsRunning() && !benchmark.EndFrame())
+                SystemManager->ExitGame();
         } // while (SystemManager->NotDone())
+
+        // Writes the last recorded frame, or prints the replayed frame times.
+        replay.Stop();
+        if (!benchmark.Stop(benchmark_options.results_filename))
+            exit_code = EXIT_FAILURE;
+        vt_common::ScriptCallProfiler::PrintReport();
+        if (!AssetManifest::StopRecording())
+            exit_code = EXIT_FAILURE;
     } catch(const Exception& e) {
 #ifdef WIN32
         MessageBox(nullptr, e.ToString().c_str(), "Unhandled exception",
@@ -605,6 +860,12 @@ int main(int argc, char* argv[])
     // NOTE: Even if the singleton objects do not exist when this function is called, invoking the
     // static Destroy() singleton function will do no harm (it checks that the object exists before deleting it).
 
+    // Run the pending jobs first, while the data they use still exists.
+    JobSystem::SingletonDestroy();
+
+    // Write the last telemetry figures once no background write can overwrite them.
+    PerformanceTelemetry::Write(false);
+
     // Delete the mode manager first so that all game modes free their resources
     ModeEngine::SingletonDestroy();
 
@@ -622,11 +883,14 @@ int main(int argc, char* argv[])
     // before closing the lua state.
     ScriptEngine::SingletonDestroy();
 
+    // Every asset is closed by now.
+    vt_system::UnmountAssetArchive();
+
     // Once finished with OpenGL functions, the SDL_GLContext can be deleted.
     SDL_GL_DeleteContext(glcontext);
 
     // Close and destroy the window.
     SDL_DestroyWindow(sdl_window);
 
-    return EXIT_SUCCESS;
+    return exit_code;
 }
@@ -17,10 +17,13 @@
 
 #include "main_options.h"
 
+#include "engine/asset_manifest.h"
 #include "engine/audio/audio.h"
 #include "engine/video/video.h"
+#include "engine/video/gl/gl_debug.h"
 #include "script/script_write.h"
 #include "engine/input.h"
+#include "engine/load_trace.h"
 #include "engine/system.h"
 #include "engine/mode_manager.h"
 
@@ -28,10 +31,14 @@
 
 #include "common/app_name.h"
 #include "common/app_settings.h"
+#include "common/random_streams.h"
+#include "common/script_call_profiler.h"
 #include "common/global/global.h"
 
 #include <SDL2/SDL_ttf.h>
 
+#include <cstdlib>
+
 namespace vt_battle {
 extern bool BATTLE_DEBUG;
 }
@@ -57,6 +64,34 @@ using namespace vt_common;
 namespace vt_main
 {
 
+static BattleSimulationOptions _battle_simulation_options;
+
+const BattleSimulationOptions& GetBattleSimulationOptions()
+{
+    return _battle_simulation_options;
+}
+
+static ReplayOptions _replay_options;
+
+const ReplayOptions& GetReplayOptions()
+{
+    return _replay_options;
+}
+
+static BenchmarkOptions _benchmark_options;
+
+const BenchmarkOptions& GetBenchmarkOptions()
+{
+    return _benchmark_options;
+}
+
+static bool _startup_trace = false;
+
+bool IsStartupTraceEnabled()
+{
+    return _startup_trace;
+}
+
 bool ParseProgramOptions(int32_t &return_code, int32_t argc, char* argv[])
 {
     // Convert the argument list to a vector of strings for convenience
@@ -76,6 +111,99 @@ bool ParseProgramOptions(int32_t &return_code, int32_t argc, char* argv[])
                 return false;
             }
             i++;
+        } else if(options[i] == "--random-seed") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            // Reproduces the random numbers of a previous run.
+            vt_common::SeedRandomStreams(strtoull(options[i + 1].c_str(), nullptr, 10));
+            i++;
+        } else if(options[i] == "--simulate-battles") {
+            if((i + 3) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires three arguments." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            _battle_simulation_options.save_filename = options[i + 1];
+
+            std::vector<std::string> enemy_ids;
+            if(!ParseSecondaryOptions(options[i + 2], enemy_ids)) {
+                return_code = 1;
+                return false;
+            }
+            _battle_simulation_options.enemy_ids.clear();
+            for(uint32_t j = 0; j < enemy_ids.size(); ++j) {
+                if(!enemy_ids[j].empty())
+                    _battle_simulation_options.enemy_ids.push_back(strtoul(enemy_ids[j].c_str(), nullptr, 10));
+            }
+
+            _battle_simulation_options.battle_count = strtoul(options[i + 3].c_str(), nullptr, 10);
+            // Nothing is played while simulating.
+            vt_audio::AUDIO_ENABLE = false;
+            i += 3;
+        } else if(options[i] == "--simulation-difficulty" || options[i] == "--simulation-results") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            if(options[i] == "--simulation-difficulty")
+                _battle_simulation_options.difficulty = strtoul(options[i + 1].c_str(), nullptr, 10);
+            else
+                _battle_simulation_options.results_filename = options[i + 1];
+            i++;
+        } else if(options[i] == "--record-replay" || options[i] == "--replay") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            if(options[i] == "--record-replay")
+                _replay_options.record_filename = options[i + 1];
+            else
+                _replay_options.replay_filename = options[i + 1];
+            i++;
+        } else if(options[i] == "--record-assets") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            vt_system::AssetManifest::StartRecording(options[i + 1]);
+            i++;
+        } else if(options[i] == "--benchmark" || options[i] == "--benchmark-frames" ||
+                  options[i] == "--benchmark-results" || options[i] == "--microbenchmarks") {
+            if((i + 1) >= options.size()) {
+                std::cerr << "Option " << options[i] << " requires an argument." << std::endl;
+                PrintUsage();
+                return_code = 1;
+                return false;
+            }
+            if(options[i] == "--benchmark")
+                _benchmark_options.scenario = options[i + 1];
+            else if(options[i] == "--microbenchmarks")
+                _benchmark_options.microbenchmark_filter = options[i + 1];
+            else if(options[i] == "--benchmark-frames")
+                _benchmark_options.frame_count = strtoul(options[i + 1].c_str(), nullptr, 10);
+            else
+                _benchmark_options.results_filename = options[i + 1];
+            i++;
+        } else if(options[i] == "--replay-fast") {
+            _replay_options.fast = true;
+        } else if(options[i] == "--profile-scripts") {
+            vt_common::ScriptCallProfiler::SetEnabled(true);
+        } else if(options[i] == "--startup-trace") {
+            _startup_trace = true;
+            vt_system::LoadTrace::SetEnabled(true);
+        } else if(options[i] == "--gl-debug") {
+            vt_video::gl::GL_DEBUG = true;
         } else if(options[i] == "--disable-audio") {
             vt_audio::AUDIO_ENABLE = false;
         } else if(options[i] == "-h" || options[i] == "--help") {
@@ -145,15 +273,36 @@ void PrintUsage()
 {
     std::cout
             << "usage: " APPSHORTNAME " [options]" << std::endl
+            << "  --benchmark <scenario> :: runs a benchmark scenario of data/benchmarks/ instead" << std::endl
+            << "                       of the game, and prints its frame times" << std::endl
+            << "  --benchmark-frames <n>     :: the number of frames the benchmark measures" << std::endl
+            << "  --benchmark-results <file> :: saves the benchmark or microbenchmarks results as JSON" << std::endl
             << "  --debug/-d <args> :: enables debug statements in specified sections of the" << std::endl
             << "                       program, where <args> can be:" << std::endl
             << "                       all, audio, battle, boot, data, global, input," << std::endl
             << "                       map, mode_manager, pause, quit, scene, system" << std::endl
             << "                       utils, video" << std::endl
             << "  --disable-audio   :: disables loading and playing audio" << std::endl
+            << "  --gl-debug        :: checks every OpenGL call for errors (slow)" << std::endl
             << "  --help/-h         :: prints this help menu" << std::endl
             << "  --info/-i         :: prints information about the user's system" << std::endl
-            << "  --reset/-r        :: resets game configuration to use default settings" << std::endl;
+            << "  --profile-scripts :: times the script function calls, and prints a report on exit" << std::endl
+            << "  --microbenchmarks <name|all> :: times the engine hot paths whose name contains" << std::endl
+            << "                       the given text, instead of running the game" << std::endl
+            << "  --random-seed <n> :: seeds the engine random numbers, to reproduce a run" << std::endl
+            << "  --record-assets <file> :: records the assets loaded by each map and battle," << std::endl
+            << "                       for tools/gen-asset-manifest.py --recording" << std::endl
+            << "  --record-replay <file> :: records the session input in a replay file" << std::endl
+            << "  --replay <file>   :: replays a recorded session, and prints its frame times" << std::endl
+            << "  --replay-fast     :: replays the session as fast as possible" << std::endl
+            << "  --reset/-r        :: resets game configuration to use default settings" << std::endl
+            << "  --simulate-battles <save file> <enemy ids> <count>" << std::endl
+            << "                    :: simulates auto-battles of the saved game party against" << std::endl
+            << "                       the enemies, and prints their results. Use with" << std::endl
+            << "                       --random-seed to reproduce them." << std::endl
+            << "  --simulation-difficulty <1-3> :: the game difficulty of the simulated battles" << std::endl
+            << "  --simulation-results <file>   :: saves the simulated battles results as JSON" << std::endl
+            << "  --startup-trace   :: prints the time taken by each startup and map loading stage" << std::endl;
 }
 
 bool PrintSystemInformation()
@@ -28,6 +28,80 @@
 **/
 namespace vt_main {
 
+//! \brief The battles to simulate instead of running the game, see vt_battle::BattleSimulation.
+class BattleSimulationOptions
+{
+public:
+    BattleSimulationOptions() :
+        battle_count(0),
+        difficulty(0)
+    {}
+
+    std::string save_filename;
+    std::vector<uint32_t> enemy_ids;
+
+    //! \brief 0 when no battle simulation was requested.
+    uint32_t battle_count;
+
+    //! \brief The game difficulty of the battles, 0 keeping the settings one.
+    uint32_t difficulty;
+
+    //! \brief The file to save the battle results in, as JSON, if not empty.
+    std::string results_filename;
+};
+
+//! \brief Gives the battles to simulate, as requested by the --simulate-battles option.
+const BattleSimulationOptions& GetBattleSimulationOptions();
+
+//! \brief The session to record or to replay, see vt_system::Replay.
+class ReplayOptions
+{
+public:
+    ReplayOptions() :
+        fast(false)
+    {}
+
+    //! \brief The file to record the session in, if not empty.
+    std::string record_filename;
+
+    //! \brief The file to replay the session from, if not empty.
+    std::string replay_filename;
+
+    //! \brief Whether the session is replayed as fast as possible instead of in real time.
+    bool fast;
+};
+
+//! \brief Gives the session to record or to replay, as requested by the --record-replay and --replay options.
+const ReplayOptions& GetReplayOptions();
+
+//! \brief The benchmark scenario to run instead of the game, see vt_system::Benchmark.
+class BenchmarkOptions
+{
+public:
+    BenchmarkOptions() :
+        frame_count(0)
+    {}
+
+    //! \brief The scenario name or Lua file, empty when no benchmark was requested.
+    std::string scenario;
+
+    //! \brief The number of frames to measure, 0 keeping the scenario one.
+    uint32_t frame_count;
+
+    //! \brief The microbenchmarks to run instead of the game, empty when none was requested.
+    //! See vt_main::RunMicroBenchmarks().
+    std::string microbenchmark_filter;
+
+    //! \brief The file to save the benchmark results in, as JSON, if not empty.
+    std::string results_filename;
+};
+
+//! \brief Gives the benchmark to run, as requested by the --benchmark and --microbenchmarks options.
+const BenchmarkOptions& GetBenchmarkOptions();
+
+//! \brief Tells whether the startup stages durations are printed, as requested by the --startup-trace option.
+bool IsStartupTraceEnabled();
+
 /** \brief Parses command-line options and takes appropriate action on those options
 *** \param return_code A reference to the return code to exit the program with.
 *** \param argc The number of arguments given to the program
@@ -0,0 +1,457 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    microbenchmarks.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the engine hot paths microbenchmarks.
+*** ***************************************************************************/
+
+#include "microbenchmarks.h"
+
+#include "engine/video/video.h"
+#include "engine/video/particle_effect.h"
+
+#include "common/app_settings.h"
+#include "common/global/global.h"
+#include "common/global/global_save_file.h"
+
+#include "modes/map/map_mode.h"
+#include "modes/map/map_object_supervisor.h"
+#include "modes/map/map_sprites/map_virtual_sprite.h"
+#include "modes/map/map_tiles.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_strings.h"
+
+#include <SDL2/SDL_timer.h>
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace vt_utils;
+
+namespace vt_main
+{
+
+//! \brief The files the microbenchmarks use.
+//@{
+const std::string MICROBENCHMARK_IMAGE = "data/battles/battle_scenes/desert_cave/desert_cave.png";
+const std::string MICROBENCHMARK_PARTICLE_EFFECT = "data/visuals/particle_effects/fireflies.lua";
+const std::string MICROBENCHMARK_MAP_DATA = "data/story/ep1/layna_forest/layna_forest_crystal_map.lua";
+const std::string MICROBENCHMARK_MAP_SCRIPT = "data/benchmarks/subscripts/map_walk_script.lua";
+//@}
+
+/** ****************************************************************************
+*** \brief A function repeated to be timed, with the data it needs.
+*** ***************************************************************************/
+class MicroBenchmark
+{
+public:
+    explicit MicroBenchmark(const std::string& name) :
+        _name(name)
+    {}
+
+    virtual ~MicroBenchmark()
+    {}
+
+    const std::string& GetName() const {
+        return _name;
+    }
+
+    //! \brief Prepares the data, which isn't timed. Returns false if the benchmark can't be run.
+    virtual bool SetUp() {
+        return true;
+    }
+
+    //! \brief Runs the timed function the given number of times.
+    virtual void Run(uint64_t iterations) = 0;
+
+    //! \brief Frees the data.
+    virtual void TearDown()
+    {}
+
+private:
+    std::string _name;
+};
+
+//! \brief The timing of a microbenchmark.
+class MicroBenchmarkResult
+{
+public:
+    MicroBenchmarkResult() :
+        iterations(0),
+        time_per_iteration(0.0)
+    {}
+
+    std::string name;
+    uint64_t iterations;
+
+    //! \brief In nanoseconds.
+    double time_per_iteration;
+};
+
+class ImageLoadBenchmark : public MicroBenchmark
+{
+public:
+    ImageLoadBenchmark() :
+        MicroBenchmark("ImageMemory::LoadImage")
+    {}
+
+    void Run(uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i) {
+            vt_video::private_video::ImageMemory image;
+            image.LoadImage(MICROBENCHMARK_IMAGE);
+        }
+    }
+};
+
+class GrayscaleBenchmark : public MicroBenchmark
+{
+public:
+    GrayscaleBenchmark() :
+        MicroBenchmark("ImageMemory::ConvertToGrayscale")
+    {}
+
+    bool SetUp() {
+        return _image.LoadImage(MICROBENCHMARK_IMAGE);
+    }
+
+    // Converting the already grayscaled pixels again takes the same time.
+    void Run(uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i)
+            _image.ConvertToGrayscale();
+    }
+
+private:
+    vt_video::private_video::ImageMemory _image;
+};
+
+class WrapTextBenchmark : public MicroBenchmark
+{
+public:
+    WrapTextBenchmark() :
+        MicroBenchmark("TextSupervisor::WrapText"),
+        _font(nullptr)
+    {}
+
+    bool SetUp() {
+        vt_video::TextStyle style("text20");
+        vt_video::FontProperties* font_properties = style.GetFontProperties();
+        if(!font_properties || !font_properties->ttf_font)
+            return false;
+        _font = font_properties->ttf_font;
+        _text = MakeUnicodeString("Dear chosen one, the time has finally come. For us, it will be but an instant. "
+                                  "For you, it might be decades. May you bring a happy end to this foolish destiny "
+                                  "of ours. As you wish. Follow me.");
+        return true;
+    }
+
+    // The wrapped texts are cached, as when the dialogues are drawn on each frame.
+    void Run(uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i)
+            vt_video::TextManager->WrapText(_text, _font, 400);
+    }
+
+private:
+    TTF_Font* _font;
+    ustring _text;
+};
+
+class ParticleUpdateBenchmark : public MicroBenchmark
+{
+public:
+    ParticleUpdateBenchmark() :
+        MicroBenchmark("ParticleEffect::Update")
+    {}
+
+    bool SetUp() {
+        return _effect.LoadEffect(MICROBENCHMARK_PARTICLE_EFFECT);
+    }
+
+    void Run(uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i)
+            _effect.Update(0.016f);
+    }
+
+private:
+    vt_video::ParticleEffect _effect;
+};
+
+class GameEventsBenchmark : public MicroBenchmark
+{
+public:
+    GameEventsBenchmark() :
+        MicroBenchmark("GameEvents::GetEventValue")
+    {}
+
+    // Many events in many groups, as in a late saved game.
+    bool SetUp() {
+        vt_global::GameEvents& game_events = vt_global::GlobalManager->GetGameEvents();
+        for(uint32_t group = 0; group < 50; ++group) {
+            for(uint32_t event = 0; event < 20; ++event) {
+                _group_names.push_back("microbenchmark_group_" + NumberToString(group));
+                _event_names.push_back("event_" + NumberToString(event));
+                game_events.SetEventValue(_group_names.back(), _event_names.back(), event);
+            }
+        }
+        return true;
+    }
+
+    void Run(uint64_t iterations) {
+        const vt_global::GameEvents& game_events = vt_global::GlobalManager->GetGameEvents();
+        for(uint64_t i = 0; i < iterations; ++i) {
+            const size_t index = static_cast<size_t>(i % _group_names.size());
+            game_events.GetEventValue(_group_names[index], _event_names[index]);
+        }
+    }
+
+private:
+    std::vector<std::string> _group_names;
+    std::vector<std::string> _event_names;
+};
+
+class SaveLoadBenchmark : public MicroBenchmark
+{
+public:
+    SaveLoadBenchmark() :
+        MicroBenchmark("GameGlobal::SaveGame+LoadGame")
+    {}
+
+    bool SetUp() {
+        _filename = vt_common::GetUserDataPath() + "microbenchmark_save.lua";
+        return vt_global::GlobalManager->SaveGame(_filename, 0);
+    }
+
+    void Run(uint64_t iterations) {
+        for(uint64_t i = 0; i < iterations; ++i) {
+            vt_global::GlobalManager->SaveGame(_filename, 0);
+            vt_global::GlobalManager->LoadGame(_filename, 0);
+        }
+    }
+
+    void TearDown() {
+        std::remove(_filename.c_str());
+        std::remove(vt_global::GetBinarySaveFilename(_filename).c_str());
+    }
+
+private:
+    std::string _filename;
+};
+
+/** ****************************************************************************
+*** \brief A microbenchmark run on a real map, loaded beforehand.
+*** ***************************************************************************/
+class MapBenchmark : public MicroBenchmark
+{
+public:
+    explicit MapBenchmark(const std::string& name) :
+        MicroBenchmark(name),
+        _map_mode(nullptr),
+        _grid_width(0),
+        _grid_height(0)
+    {}
+
+    bool SetUp() {
+        _map_mode = new vt_map::MapMode(MICROBENCHMARK_MAP_DATA, MICROBENCHMARK_MAP_SCRIPT,
+                                        vt_map::STAMINA_FULL, false);
+        if(!_map_mode->GetCamera()) {
+            TearDown();
+            return false;
+        }
+
+        // Computes the map frame drawn.
+        _map_mode->Reset();
+        _map_mode->Update();
+
+        _map_mode->GetObjectSupervisor()->GetGridAxis(_grid_width, _grid_height);
+        return _grid_width > 0 && _grid_height > 0;
+    }
+
+    void TearDown() {
+        delete _map_mode;
+        _map_mode = nullptr;
+    }
+
+protected:
+    vt_map::MapMode* _map_mode;
+
+    //! \brief The collision grid size.
+    uint32_t _grid_width;
+    uint32_t _grid_height;
+};
+
+class CollisionBenchmark : public MapBenchmark
+{
+public:
+    CollisionBenchmark() :
+        MapBenchmark("ObjectSupervisor::DetectCollision")
+    {}
+
+    // The camera sprite is checked all over the map.
+    void Run(uint64_t iterations) {
+        vt_map::private_map::ObjectSupervisor* object_supervisor = _map_mode->GetObjectSupervisor();
+        vt_map::private_map::VirtualSprite* camera = _map_mode->GetCamera();
+        for(uint64_t i = 0; i < iterations; ++i) {
+            const float x = static_cast<float>((i * 7) % _grid_width) + 0.5f;
+            const float y = static_cast<float>((i * 13) % _grid_height) + 0.5f;
+            object_supervisor->DetectCollision(camera, x, y);
+        }
+    }
+};
+
+class PathFindingBenchmark : public MapBenchmark
+{
+public:
+    PathFindingBenchmark() :
+        MapBenchmark("ObjectSupervisor::FindPath")
+    {}
+
+    bool SetUp() {
+        if(!MapBenchmark::SetUp())
+            return false;
+
+        // Destinations near and far from the camera.
+        _destinations.clear();
+        for(uint32_t i = 1; i <= 4; ++i) {
+            _destinations.push_back(vt_common::Position2D(_grid_width * i / 5.0f, _grid_height * i / 5.0f));
+            _destinations.push_back(vt_common::Position2D(_grid_width * (5 - i) / 5.0f, _grid_height * i / 5.0f));
+        }
+        return true;
+    }
+
+    void Run(uint64_t iterations) {
+        vt_map::private_map::ObjectSupervisor* object_supervisor = _map_mode->GetObjectSupervisor();
+        vt_map::private_map::VirtualSprite* camera = _map_mode->GetCamera();
+        for(uint64_t i = 0; i < iterations; ++i)
+            object_supervisor->FindPath(camera, _destinations[i % _destinations.size()]);
+    }
+
+private:
+    std::vector<vt_common::Position2D> _destinations;
+};
+
+class DrawLayersBenchmark : public MapBenchmark
+{
+public:
+    DrawLayersBenchmark() :
+        MapBenchmark("TileSupervisor::DrawLayers")
+    {}
+
+    // The queued tiles are submitted to OpenGL on each iteration, as at the end of each pass.
+    void Run(uint64_t iterations) {
+        vt_map::private_map::TileSupervisor* tile_supervisor = _map_mode->GetTileSupervisor();
+        for(uint64_t i = 0; i < iterations; ++i) {
+            tile_supervisor->DrawLayers(&_map_mode->GetMapFrame(), vt_map::private_map::GROUND_LAYER);
+            vt_video::VideoManager->FlushSpriteBatch();
+        }
+    }
+};
+
+//! \brief Times a microbenchmark, raising its iterations until it runs long enough.
+static MicroBenchmarkResult _RunMicroBenchmark(MicroBenchmark& benchmark)
+{
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    MicroBenchmarkResult result;
+    result.name = benchmark.GetName();
+
+    uint64_t iterations = 1;
+    while(true) {
+        const uint64_t start = SDL_GetPerformanceCounter();
+        benchmark.Run(iterations);
+        const double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - start) / frequency;
+
+        if(elapsed >= MICROBENCHMARK_MIN_TIME || iterations >= (static_cast<uint64_t>(1) << 32)) {
+            result.iterations = iterations;
+            result.time_per_iteration = elapsed * 1.0e9 / static_cast<double>(iterations);
+            return result;
+        }
+
+        // Aims a bit above the minimum time, without growing too fast on the first noisy runs.
+        double scale = elapsed > 0.0 ? MICROBENCHMARK_MIN_TIME * 1.4 / elapsed : 10.0;
+        scale = scale < 2.0 ? 2.0 : (scale > 10.0 ? 10.0 : scale);
+        iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+    }
+}
+
+//! \brief Saves the results in the Google Benchmark JSON format.
+static bool _SaveMicroBenchmarkResults(const std::string& filename,
+                                       const std::vector<MicroBenchmarkResult>& results)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    if(!file.is_open()) {
+        PRINT_ERROR << "Couldn't open the microbenchmark results file: " << filename << std::endl;
+        return false;
+    }
+
+    file << "{" << std::endl
+         << "  \"benchmarks\": [" << std::endl;
+    for(uint32_t i = 0; i < results.size(); ++i) {
+        file << "    { \"name\": \"" << results[i].name << "\""
+             << ", \"iterations\": " << results[i].iterations
+             << ", \"real_time\": " << results[i].time_per_iteration
+             << ", \"cpu_time\": " << results[i].time_per_iteration
+             << ", \"time_unit\": \"ns\" }" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    file << "  ]" << std::endl << "}" << std::endl;
+
+    file.close();
+    if(file.fail()) {
+        PRINT_ERROR << "Couldn't write the microbenchmark results file: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RunMicroBenchmarks(const std::string& filter, const std::string& results_filename)
+{
+    std::vector<MicroBenchmark *> benchmarks;
+    benchmarks.push_back(new ImageLoadBenchmark());
+    benchmarks.push_back(new GrayscaleBenchmark());
+    benchmarks.push_back(new WrapTextBenchmark());
+    benchmarks.push_back(new ParticleUpdateBenchmark());
+    benchmarks.push_back(new GameEventsBenchmark());
+    benchmarks.push_back(new SaveLoadBenchmark());
+    benchmarks.push_back(new CollisionBenchmark());
+    benchmarks.push_back(new PathFindingBenchmark());
+    benchmarks.push_back(new DrawLayersBenchmark());
+
+    bool success = true;
+    std::vector<MicroBenchmarkResult> results;
+    for(uint32_t i = 0; i < benchmarks.size(); ++i) {
+        MicroBenchmark* benchmark = benchmarks[i];
+        if(filter != "all" && benchmark->GetName().find(filter) == std::string::npos)
+            continue;
+
+        if(!benchmark->SetUp()) {
+            PRINT_ERROR << "Couldn't set up the microbenchmark: " << benchmark->GetName() << std::endl;
+            success = false;
+            continue;
+        }
+        results.push_back(_RunMicroBenchmark(*benchmark));
+        benchmark->TearDown();
+
+        printf("%-40s %14.1f ns %12llu iterations\n", results.back().name.c_str(),
+               results.back().time_per_iteration, static_cast<unsigned long long>(results.back().iterations));
+    }
+
+    for(uint32_t i = 0; i < benchmarks.size(); ++i)
+        delete benchmarks[i];
+
+    if(results.empty()) {
+        PRINT_WARNING << "No microbenchmark matches: " << filter << std::endl;
+        return false;
+    }
+    if(!results_filename.empty() && !_SaveMicroBenchmarkResults(results_filename, results))
+        return false;
+    return success;
+}
+
+} // namespace vt_main
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    microbenchmarks.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the engine hot paths microbenchmarks.
+***
+*** Each microbenchmark repeats a single engine function, like a collision
+*** check or a text wrap, until it ran long enough to be timed precisely. They
+*** run in the game binary, once the engine is initialized, so that they use
+*** the real data, the real OpenGL context and the real fonts.
+***
+*** The results are printed in nanoseconds per iteration, and may be saved in
+*** the Google Benchmark JSON format, to be compared from one build to another.
+*** \note Only main.cpp should need to include this file.
+*** ***************************************************************************/
+
+#ifndef __MICROBENCHMARKS_HEADER__
+#define __MICROBENCHMARKS_HEADER__
+
+#include <string>
+
+namespace vt_main
+{
+
+//! \brief The minimum time each microbenchmark is run for, in seconds.
+const double MICROBENCHMARK_MIN_TIME = 0.25;
+
+/** \brief Runs the microbenchmarks, and prints their results.
+*** \param filter Only the microbenchmarks whose name contains it are run, or all of them if "all".
+*** \param results_filename The file to save the results in, as JSON, if not empty.
+*** \return False if a microbenchmark couldn't be set up, or the results couldn't be saved.
+**/
+bool RunMicroBenchmarks(const std::string& filter, const std::string& results_filename);
+
+} // namespace vt_main
+
+#endif // __MICROBENCHMARKS_HEADER__
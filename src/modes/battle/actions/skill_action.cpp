@@ -11,6 +11,7 @@
 #include "skill_action.h"
 
 #include "common/global/global_skills.h"
+#include "common/script_call_profiler.h"
 
 #include "utils/ustring.h"
 
@@ -95,6 +96,7 @@ bool SkillAction::ShouldShowSkillNotice() const
 void SkillAction::_InitAnimationScript()
 {
     try {
+        vt_common::ScriptCallTimer timer("skill animation Initialize", _skill->GetID(), _init_function);
         luabind::call_function<void>(_init_function, _actor, _target, _skill);
     } catch(const luabind::error &err) {
         ScriptManager->HandleLuaError(err);
@@ -149,6 +151,7 @@ bool SkillAction::Update()
         return true;
 
     try {
+        vt_common::ScriptCallTimer timer("skill animation Update", _skill->GetID(), _update_function);
         return luabind::call_function<bool>(_update_function);
     } catch(const luabind::error &err) {
         ScriptManager->HandleLuaError(err);
@@ -22,9 +22,12 @@
 
 #include "common/dialogue.h"
 
+#include "engine/asset_manifest.h"
 #include "engine/audio/audio.h"
+#include "engine/frame_profiler.h"
 #include "engine/input.h"
 #include "engine/mode_manager.h"
+#include "engine/performance_telemetry.h"
 #include "script/script.h"
 #include "engine/video/video.h"
 
@@ -43,8 +46,13 @@
 #include "common/global/global.h"
 #include "common/global/actors/global_character.h"
 #include "common/global/actors/global_attack_point.h"
+#include "common/random_streams.h"
 
 #include "utils/utils_random.h"
+#include "utils/utils_strings.h"
+
+#include <algorithm>
+#include <functional>
 
 using namespace vt_utils;
 using namespace vt_audio;
@@ -117,6 +125,8 @@ BattleMode::BattleMode() :
     _command_supervisor(nullptr),
     _dialogue_supervisor(nullptr),
     _battle_finish(nullptr),
+    _battle_objects_dirty(false),
+    _background_dirty(true),
     _current_number_swaps(0),
     _last_enemy_dying(false),
     _stamina_icon_alpha(1.0f),
@@ -129,6 +139,9 @@ BattleMode::BattleMode() :
 {
     _current_instance = this;
 
+    // Start decoding the assets of the battles of this map while the battle is set up.
+    AssetManifest::Prefetch(AssetManifest::GetBattleKey(GlobalManager->GetMapData().GetMapScriptFilename()), this);
+
     _auto_battle_text.SetText(vt_system::UTranslate("Auto-Battle"),
                               vt_video::TextStyle("text20",
                               vt_video::Color::white,
@@ -210,6 +223,7 @@ void BattleMode::_ResetMusicState()
 void BattleMode::Reset()
 {
     _current_instance = this;
+    AssetManifest::SetRecordingKey(AssetManifest::GetBattleKey(GlobalManager->GetMapData().GetMapScriptFilename()));
 
     VideoManager->SetStandardCoordSys();
 
@@ -218,8 +232,14 @@ void BattleMode::Reset()
     if(_state == BATTLE_STATE_INVALID)
         _Initialize();
 
+    // The battle is set up: The images prefetched for the other battles of the map aren't needed.
+    AssetManifest::CancelUnusedImages(this);
+
     // Reset potential battle scripts
     GetScriptSupervisor().Reset();
+
+    // Other modes may have cached their own layers meanwhile.
+    _background_dirty = true;
 }
 
 void BattleMode::RestartBattle()
@@ -239,6 +259,7 @@ void BattleMode::RestartBattle()
     _enemy_actors.clear();
     _enemy_party.clear();
     _ready_queue.clear();
+    _battle_objects_dirty = true;
 
     for(uint32_t i = 0; i < _initial_enemy_actors_info.size(); ++i)
         AddEnemy(_initial_enemy_actors_info[i].enemy_id,
@@ -278,6 +299,8 @@ static bool CompareObjectsYCoord(BattleObject *one, BattleObject *other)
 
 void BattleMode::Update()
 {
+    PROFILE_SCOPE("BattleMode::Update");
+
     // Update potential battle animations
     GlobalManager->GetBattleMedia().Update();
     GameMode::Update();
@@ -303,31 +326,41 @@ void BattleMode::Update()
     if(_dialogue_supervisor->IsDialogueActive())
         _dialogue_supervisor->Update();
 
-    // Update all actors animations and y-sorting
-    _battle_objects.clear();
-    for(uint32_t i = 0; i < _character_actors.size(); ++i) {
+    // Update all actors animations
+    for(uint32_t i = 0; i < _character_actors.size(); ++i)
         _character_actors[i]->Update();
-        _battle_objects.push_back(_character_actors[i]);
-    }
-    for(uint32_t i = 0; i < _enemy_actors.size(); ++i) {
+    for(uint32_t i = 0; i < _enemy_actors.size(); ++i)
         _enemy_actors[i]->Update();
-        _battle_objects.push_back(_enemy_actors[i]);
-    }
-
-    // Add effects (particles and animations)
-    for(std::vector<BattleObject *>::iterator it = _battle_effects.begin();
-            it != _battle_effects.end();) {
-        if((*it)->CanBeRemoved()) {
-            delete (*it);
-            it = _battle_effects.erase(it);
-        } else {
-            (*it)->Update();
-            _battle_objects.push_back(*it);
-            ++it;
+
+    // Update effects (particles and animations)
+    bool effects_done = false;
+    for(uint32_t i = 0; i < _battle_effects.size(); ++i) {
+        if(_battle_effects[i]->CanBeRemoved())
+            effects_done = true;
+        else
+            _battle_effects[i]->Update();
+    }
+
+    // Get rid of the finished effects, compacting the containers once.
+    // The draw order list may hold removed actors when about to be rebuilt.
+    if(effects_done) {
+        if(!_battle_objects_dirty) {
+            _battle_objects.erase(std::remove_if(_battle_objects.begin(), _battle_objects.end(),
+                                                 std::mem_fn(&BattleObject::CanBeRemoved)),
+                                  _battle_objects.end());
+        }
+        for(uint32_t i = 0; i < _battle_effects.size(); ++i) {
+            if(_battle_effects[i]->CanBeRemoved()) {
+                delete _battle_effects[i];
+                _battle_effects[i] = nullptr;
+            }
         }
+        _battle_effects.erase(std::remove(_battle_effects.begin(), _battle_effects.end(),
+                                          static_cast<BattleObject *>(nullptr)),
+                              _battle_effects.end());
     }
 
-    std::sort(_battle_objects.begin(), _battle_objects.end(), CompareObjectsYCoord);
+    _SortBattleObjects();
 
     // If the battle is in scene mode, we only update animation
     if (_scene_mode)
@@ -473,6 +506,8 @@ void BattleMode::Update()
 
 void BattleMode::Draw()
 {
+    PROFILE_SCOPE("BattleMode::Draw");
+
     VideoManager->SetStandardCoordSys();
 
     if(_state == BATTLE_STATE_INITIAL || _state == BATTLE_STATE_EXITING) {
@@ -535,6 +570,7 @@ void BattleMode::AddEnemy(uint32_t new_enemy_id, float position_x, float positio
 
     _enemy_actors.push_back(new_battle_enemy);
     _enemy_party.push_back(new_battle_enemy);
+    _battle_objects_dirty = true;
 
     // Sort the enemies based on their Y location.
     // The player will then be able to target them in that order
@@ -761,8 +797,18 @@ bool BattleMode::isOneCharacterDead() const
     return false;
 }
 
+std::string BattleMode::GetReportDescription() const
+{
+    std::string description = "enemies";
+    for(uint32_t i = 0; i < _enemy_actors.size(); ++i)
+        description += " " + vt_utils::NumberToString(_enemy_actors[i]->GetGlobalEnemy()->GetID());
+    return description;
+}
+
 void BattleMode::_Initialize()
 {
+    vt_system::TelemetryTimer telemetry_timer("battle_start", GetReportDescription());
+
     // Unset a possible last enemy dying sequence.
     _last_enemy_dying = false;
 
@@ -779,6 +825,7 @@ void BattleMode::_Initialize()
         BattleCharacter* new_actor = new BattleCharacter(active_party.GetCharacterAtIndex(i));
         _character_actors.push_back(new_actor);
         _character_party.push_back(new_actor);
+        _battle_objects_dirty = true;
 
     // Sort the characters based on their Y location.
     // The player will then be able to target them in that order
@@ -837,21 +884,24 @@ void BattleMode::_Initialize()
 
         uint32_t max_init_timer = _character_actors[i]->GetIdleStateTime() / 2;
         if (_hero_init_boost)
-            _character_actors[i]->GetStateTimer().Update(RandomBoundedInteger(max_init_timer, max_init_timer * 2));
+            _character_actors[i]->GetStateTimer().Update(vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(max_init_timer, max_init_timer * 2));
         else
-            _character_actors[i]->GetStateTimer().Update(RandomBoundedInteger(0, max_init_timer));
+            _character_actors[i]->GetStateTimer().Update(vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(0, max_init_timer));
     }
     for(uint32_t i = 0; i < _enemy_actors.size(); ++i) {
         uint32_t max_init_timer = _enemy_actors[i]->GetIdleStateTime() / 2;
         if (_enemy_init_boost)
-            _enemy_actors[i]->GetStateTimer().Update(RandomBoundedInteger(max_init_timer, max_init_timer * 2));
+            _enemy_actors[i]->GetStateTimer().Update(vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(max_init_timer, max_init_timer * 2));
         else
-            _enemy_actors[i]->GetStateTimer().Update(RandomBoundedInteger(0, max_init_timer));
+            _enemy_actors[i]->GetStateTimer().Update(vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(0, max_init_timer));
     }
 
     // Init the script component.
     GetScriptSupervisor().Initialize(this);
 
+    // Lay the dialogues created by the scripts out now, rather than when they begin.
+    _dialogue_supervisor->PrepareDialogues();
+
     ChangeState(BATTLE_STATE_INITIAL);
 }
 
@@ -879,6 +929,7 @@ void BattleMode::TriggerBattleParticleEffect(const std::string &effect_filename,
     effect->Start();
 
     _battle_effects.push_back(effect);
+    _battle_objects.push_back(effect);
 }
 
 private_battle::BattleAnimation* BattleMode::CreateBattleAnimation(const std::string& animation_filename)
@@ -889,9 +940,32 @@ private_battle::BattleAnimation* BattleMode::CreateBattleAnimation(const std::st
     animation->SetVisible(false);
 
     _battle_effects.push_back(animation);
+    _battle_objects.push_back(animation);
     return animation;
 }
 
+void BattleMode::_SortBattleObjects()
+{
+    if(_battle_objects_dirty) {
+        _battle_objects.clear();
+        _battle_objects.insert(_battle_objects.end(), _character_actors.begin(), _character_actors.end());
+        _battle_objects.insert(_battle_objects.end(), _enemy_actors.begin(), _enemy_actors.end());
+        _battle_objects.insert(_battle_objects.end(), _battle_effects.begin(), _battle_effects.end());
+        _battle_objects_dirty = false;
+    }
+
+    // Moves each object back past the ones now below it.
+    for(uint32_t i = 1; i < _battle_objects.size(); ++i) {
+        BattleObject* object = _battle_objects[i];
+        uint32_t j = i;
+        while(j > 0 && CompareObjectsYCoord(object, _battle_objects[j - 1])) {
+            _battle_objects[j] = _battle_objects[j - 1];
+            --j;
+        }
+        _battle_objects[j] = object;
+    }
+}
+
 void BattleMode::_DetermineActorLocations()
 {
     float position_x, position_y;
@@ -1025,6 +1099,30 @@ uint32_t BattleMode::_NumberCharactersAlive() const
 }
 
 void BattleMode::_DrawBackgroundGraphics()
+{
+    // The background image alone is a single quad already: Only the scripted
+    // static backgrounds are worth caching. A shaking screen moves every image,
+    // and is drawn directly.
+    if(!GetScriptSupervisor().HasStaticBackground() || VideoManager->IsScreenShaking()) {
+        _DrawStaticBackgroundGraphics();
+    }
+    else {
+        if(_background_dirty || !VideoManager->IsLayerCacheRenderTargetValid()) {
+            VideoManager->EnableLayerCacheRenderTarget();
+            _DrawStaticBackgroundGraphics();
+            VideoManager->DisableLayerCacheRenderTarget();
+            _background_dirty = false;
+        }
+        VideoManager->DrawLayerCacheRenderTarget();
+    }
+
+    VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_TOP, VIDEO_BLEND, 0);
+    VideoManager->SetStandardCoordSys();
+
+    GetScriptSupervisor().DrawBackground();
+}
+
+void BattleMode::_DrawStaticBackgroundGraphics()
 {
     VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_BOTTOM, VIDEO_NO_BLEND, 0);
     VideoManager->Move(0.0f, 768.0f);
@@ -1033,7 +1131,7 @@ void BattleMode::_DrawBackgroundGraphics()
     VideoManager->SetDrawFlags(VIDEO_X_LEFT, VIDEO_Y_TOP, VIDEO_BLEND, 0);
     VideoManager->SetStandardCoordSys();
 
-    GetScriptSupervisor().DrawBackground();
+    GetScriptSupervisor().DrawStaticBackground();
 }
 
 
@@ -1047,6 +1145,9 @@ void BattleMode::_DrawForegroundGraphics()
 
 void BattleMode::_DrawSprites()
 {
+    static const DrawFlags sprite_flags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, VIDEO_BLEND);
+    static const DrawFlags point_flags(VIDEO_X_CENTER, VIDEO_Y_CENTER, VIDEO_BLEND);
+
     BattleMedia& battle_media = GlobalManager->GetBattleMedia();
 
     // Booleans used to determine whether or not the actor selector and attack point selector graphics should be drawn
@@ -1066,7 +1167,7 @@ void BattleMode::_DrawSprites()
 
     // Draw the actor selector graphic
     if(draw_actor_selection) {
-        VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, VIDEO_BLEND, 0);
+        VideoManager->SetDrawFlags(sprite_flags);
         if(IsTargetParty(target.GetType())) {
             const std::deque<BattleActor *>& party_target = target.GetPartyTarget();
             for(uint32_t i = 0; i < party_target.size(); i++) {
@@ -1084,7 +1185,7 @@ void BattleMode::_DrawSprites()
     }
 
     // Draw sprites in order based on their x and y coordinates on the screen (bottom to top)
-    VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_BOTTOM, VIDEO_BLEND, 0);
+    VideoManager->SetDrawFlags(sprite_flags);
     for(uint32_t i = 0; i < _battle_objects.size(); ++i)
         _battle_objects[i]->DrawSprite();
 
@@ -1092,7 +1193,7 @@ void BattleMode::_DrawSprites()
     if(draw_point_selection) {
         uint32_t point = target.GetAttackPoint();
 
-        VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_CENTER, VIDEO_BLEND, 0);
+        VideoManager->SetDrawFlags(point_flags);
         VideoManager->Move(actor_target->GetXLocation(), actor_target->GetYLocation());
         VideoManager->MoveRelative(actor_target->GetAttackPoint(point)->GetXPosition(), -actor_target->GetAttackPoint(point)->GetYPosition());
         battle_media.attack_point_indicator.Draw();
@@ -1209,12 +1310,13 @@ void BattleMode::_DrawStaminaBar()
 
     // Draw all stamina icons in order along with the selector graphic
     VideoManager->SetDrawFlags(VIDEO_X_CENTER, VIDEO_Y_CENTER, 0);
+    const Color stamina_icon_color(1.0f, 1.0f, 1.0f, _stamina_icon_alpha);
 
     for(uint32_t i = 0; i < _character_actors.size(); ++i) {
         if(!_character_actors[i]->IsAlive())
             continue;
 
-        _character_actors[i]->DrawStaminaIcon(Color(1.0f, 1.0f, 1.0f, _stamina_icon_alpha));
+        _character_actors[i]->DrawStaminaIcon(stamina_icon_color);
 
         if(!draw_icon_selection)
             continue;
@@ -1228,7 +1330,7 @@ void BattleMode::_DrawStaminaBar()
         if(!_enemy_actors[i]->IsAlive())
             continue;
 
-        _enemy_actors[i]->DrawStaminaIcon(Color(1.0f, 1.0f, 1.0f, _stamina_icon_alpha));
+        _enemy_actors[i]->DrawStaminaIcon(stamina_icon_color);
 
         if(!draw_icon_selection)
             continue;
@@ -108,6 +108,9 @@ public:
 
     //! \brief This method calls different draw functions depending on the battle state.
     void DrawPostEffects();
+
+    //! \brief Returns the battle enemy ids, in order.
+    std::string GetReportDescription() const override;
     //@}
 
     /** \brief Adds a new active enemy to the battle field
@@ -145,6 +148,11 @@ public:
         return _state;
     }
 
+    //! \brief Makes the characters attack on their own, as when chosen in the battle menu.
+    void SetAutoBattleActive(bool active) {
+        _battle_menu.SetAutoBattleActive(active);
+    }
+
     //! \brief Sets the battle in scene mode, pausing the actors actions and states.
     void SetSceneMode(bool scene_mode) {
         _scene_mode = scene_mode;
@@ -155,6 +163,13 @@ public:
         return _scene_mode;
     }
 
+    /** \brief Tells the battle the static background drawn by its scripts changed.
+    *** It is then drawn again in the next frame, and cached until marked dirty again.
+    **/
+    void SetBackgroundDirty() {
+        _background_dirty = true;
+    }
+
     //! \brief Tells whether user input is accepted in dialogues.
     //! Used by the common dialogue supervisor.
     //! In the battle mode, dialogues can handle input only when in scene mode.
@@ -303,6 +318,12 @@ public:
     void BoostEnemyPartyInitiative() {
         _enemy_init_boost = true;
     }
+
+    //! \brief Gives the ids of the enemies added to the battle, in order.
+    void GetEnemyIds(std::vector<uint32_t>& enemy_ids) const {
+        for(uint32_t i = 0; i < _initial_enemy_actors_info.size(); ++i)
+            enemy_ids.push_back(_initial_enemy_actors_info[i].enemy_id);
+    }
     //@}
 
 private:
@@ -377,10 +398,17 @@ private:
     //@}
 
     /** \brief Vector used to draw all battle objects based on their y coordinate.
-    *** Sorted in the update() method.
+    *** It is kept from one update to the next, so that only the objects which moved
+    *** get sorted again in the update() method.
     **/
     std::vector<private_battle::BattleObject *> _battle_objects;
 
+    //! \brief Set when actors were added or removed, to rebuild the draw order list at the next update.
+    bool _battle_objects_dirty;
+
+    //! \brief Set when the cached static background must be drawn again.
+    bool _background_dirty;
+
     /** \brief The number of character swaps that the player may currently perform
     *** The maximum number of swaps ever allowed is four, thus the value of this class member will always have the range [0, 4].
     *** This member is also used to determine how many swap cards to draw on the battle screen.
@@ -443,6 +471,13 @@ private:
     **/
     void _DetermineActorLocations();
 
+    /** \brief Updates the draw order of the battle objects.
+    *** The list is rebuilt when actors were added or removed. Otherwise, as the
+    *** objects move little from one update to the next, it is only insertion sorted,
+    *** which costs a single pass when no object changed its place.
+    **/
+    void _SortBattleObjects();
+
     //! \brief Returns the number of enemies that are still alive in the battle
     uint32_t _NumberEnemiesAlive() const;
 
@@ -466,6 +501,9 @@ private:
     **/
     void _DrawBackgroundGraphics();
 
+    //! \brief Draws the background image, and the static background of the scripts, cached when possible.
+    void _DrawStaticBackgroundGraphics();
+
     /** \brief Draws all characters, enemy sprites as well as any sprite visuals
     *** In addition to the sprites themselves, this function draws special effects and indicators for the sprites.
     *** For example, the actor selector image and any visible action effects like magic.
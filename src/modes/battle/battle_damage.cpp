@@ -14,6 +14,8 @@
 
 #include "common/global/actors/global_attack_point.h"
 
+#include "common/random_streams.h"
+
 #include "utils/utils_random.h"
 
 using namespace vt_global;
@@ -68,7 +70,7 @@ bool RndEvade(BattleActor* target_actor, float add_eva, float mul_eva, int32_t a
     else if(evasion >= 100.0f)
         evasion = 0.95f;
 
-    return RandomFloat(0.0f, 100.0f) <= evasion;
+    return vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).Float(0.0f, 100.0f) <= evasion;
 }
 
 uint32_t RndPhysicalDamage(BattleActor* attacker, BattleTarget* target_actor)
@@ -126,7 +128,7 @@ uint32_t RndPhysicalDamage(BattleActor* attacker, BattleActor* target_actor,
     total_phys_atk = static_cast<int32_t>(static_cast<float>(total_phys_atk) * mul_atk);
     // Randomize the damage a bit.
     int32_t phys_atk_diff = total_phys_atk / 10;
-    total_phys_atk = RandomBoundedInteger(total_phys_atk - phys_atk_diff, total_phys_atk + phys_atk_diff);
+    total_phys_atk = vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(total_phys_atk - phys_atk_diff, total_phys_atk + phys_atk_diff);
 
     if(total_phys_atk < 0)
         total_phys_atk = 0;
@@ -147,7 +149,7 @@ uint32_t RndPhysicalDamage(BattleActor* attacker, BattleActor* target_actor,
 
     // If the total damage is zero, fall back to causing a small non-zero damage value
     if(total_dmg <= 0)
-        return static_cast<uint32_t>(RandomBoundedInteger(1, 5 + attacker->GetPhysAtk() / 10));
+        return static_cast<uint32_t>(vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(1, 5 + attacker->GetPhysAtk() / 10));
 
     return static_cast<uint32_t>(total_dmg);
 }
@@ -186,7 +188,7 @@ uint32_t RndMagicalDamage(BattleActor* attacker, BattleActor* target_actor, GLOB
     total_mag_atk = static_cast<int32_t>(static_cast<float>(total_mag_atk) * mul_atk);
     // Randomize the damage a bit.
     int32_t mag_atk_diff = total_mag_atk / 10;
-    total_mag_atk = RandomBoundedInteger(total_mag_atk - mag_atk_diff, total_mag_atk + mag_atk_diff);
+    total_mag_atk = vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(total_mag_atk - mag_atk_diff, total_mag_atk + mag_atk_diff);
 
     if(total_mag_atk < 0)
         total_mag_atk = 0;
@@ -209,7 +211,7 @@ uint32_t RndMagicalDamage(BattleActor* attacker, BattleActor* target_actor, GLOB
 
     // If the total damage is zero, fall back to causing a small non-zero damage value
     if(total_dmg <= 0)
-        return static_cast<uint32_t>(RandomBoundedInteger(1, 5 + attacker->GetMagAtk() / 10));
+        return static_cast<uint32_t>(vt_common::GetRandomStream(vt_common::RANDOM_STREAM_BATTLE).BoundedInteger(1, 5 + attacker->GetMagAtk() / 10));
 
     return static_cast<uint32_t>(total_dmg);
 }
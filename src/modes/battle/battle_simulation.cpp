@@ -0,0 +1,275 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software and
+// you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    battle_simulation.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for simulating battles, to tune the enemies and skills.
+*** ***************************************************************************/
+
+#include "modes/battle/battle_simulation.h"
+
+#include "modes/battle/battle.h"
+#include "modes/battle/objects/battle_character.h"
+#include "modes/battle/objects/battle_enemy.h"
+
+#include "engine/system.h"
+
+#include "common/global/global.h"
+#include "common/random_streams.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace vt_system;
+using namespace vt_global;
+
+using namespace vt_battle::private_battle;
+
+namespace vt_battle
+{
+
+//! \brief The game time each simulated update advances by, in milliseconds. About one frame.
+const uint32_t BATTLE_SIMULATION_UPDATE_TIME = 16;
+
+//! \brief The game time after which a battle is given up, in milliseconds.
+const uint32_t BATTLE_SIMULATION_MAX_DURATION = 20 * 60 * 1000;
+
+BattleSimulation::BattleSimulation(const std::string& save_filename, const std::vector<uint32_t>& enemy_ids,
+                                   uint32_t battle_count, uint64_t random_seed) :
+    _save_filename(save_filename),
+    _enemy_ids(enemy_ids),
+    _battle_count(battle_count),
+    _random_seed(random_seed),
+    _difficulty(0),
+    _victories(0),
+    _defeats(0),
+    _timeouts(0)
+{
+}
+
+bool BattleSimulation::Run()
+{
+    if (_enemy_ids.empty()) {
+        PRINT_ERROR << "No enemies to simulate battles against." << std::endl;
+        return false;
+    }
+
+    if (_difficulty > 0)
+        SystemManager->SetGameDifficulty(_difficulty);
+
+    // The battles don't wait for the real time.
+    SystemManager->SetFixedUpdateTime(BATTLE_SIMULATION_UPDATE_TIME);
+
+    bool success = true;
+    for (uint32_t i = 0; i < _battle_count; ++i) {
+        if (!_SimulateBattle(i)) {
+            success = false;
+            break;
+        }
+    }
+
+    SystemManager->SetFixedUpdateTime(0);
+
+    if (!success)
+        return false;
+
+    _PrintReport();
+    return _results_filename.empty() || _SaveResults();
+}
+
+bool BattleSimulation::_SimulateBattle(uint32_t index)
+{
+    if (!GlobalManager->LoadGame(_save_filename, 0)) {
+        PRINT_ERROR << "Couldn't load the saved game to simulate battles with: " << _save_filename << std::endl;
+        return false;
+    }
+
+    const uint64_t seed = _random_seed + index;
+    srand(static_cast<unsigned int>(seed));
+    vt_common::SeedRandomStreams(seed);
+
+    BattleMode* battle = new BattleMode();
+    for (uint32_t i = 0; i < _enemy_ids.size(); ++i)
+        battle->AddEnemy(_enemy_ids[i]);
+
+    if (battle->GetEnemyActors().size() != _enemy_ids.size() || battle->GetCharacterActors().empty()) {
+        PRINT_ERROR << "Couldn't set up the battle to simulate: Invalid enemy or no character." << std::endl;
+        delete battle;
+        return false;
+    }
+
+    battle->SetAutoBattleActive(true);
+    battle->Reset();
+
+    _actor_records.clear();
+    uint32_t character_actions = 0;
+    uint32_t enemy_actions = 0;
+    uint32_t duration = 0;
+
+    BATTLE_STATE state = battle->GetState();
+    while (state != BATTLE_STATE_VICTORY && state != BATTLE_STATE_DEFEAT &&
+            duration < BATTLE_SIMULATION_MAX_DURATION) {
+        SystemManager->ComputeLogicUpdates();
+        SystemManager->UpdateTimers();
+        battle->Update();
+        duration += BATTLE_SIMULATION_UPDATE_TIME;
+
+        // Scripts can add enemies during the battle.
+        std::deque<BattleCharacter*>& characters = battle->GetCharacterActors();
+        for (uint32_t i = 0; i < characters.size(); ++i)
+            _ObserveActor(characters[i], character_actions, _damage_to_characters);
+        std::deque<BattleEnemy*>& enemies = battle->GetEnemyActors();
+        for (uint32_t i = 0; i < enemies.size(); ++i)
+            _ObserveActor(enemies[i], enemy_actions, _damage_to_enemies);
+
+        state = battle->GetState();
+    }
+
+    if (state == BATTLE_STATE_VICTORY)
+        ++_victories;
+    else if (state == BATTLE_STATE_DEFEAT)
+        ++_defeats;
+    else
+        ++_timeouts;
+
+    _character_actions.push_back(character_actions);
+    _enemy_actions.push_back(enemy_actions);
+    _durations.push_back(duration);
+
+    _actor_records.clear();
+    delete battle;
+    return true;
+}
+
+void BattleSimulation::_ObserveActor(const BattleActor* actor, uint32_t& actions, _DamageStats& damage)
+{
+    const uint32_t hit_points = actor->GetHitPoints();
+    const bool acting = (actor->GetState() == ACTOR_STATE_ACTING);
+
+    std::map<const BattleActor*, _ActorRecord>::iterator it = _actor_records.find(actor);
+    if (it == _actor_records.end()) {
+        _ActorRecord& record = _actor_records[actor];
+        record.hit_points = hit_points;
+        record.acting = acting;
+        return;
+    }
+
+    _ActorRecord& record = it->second;
+    if (acting && !record.acting)
+        ++actions;
+    if (hit_points < record.hit_points)
+        damage.hits.push_back(record.hit_points - hit_points);
+
+    record.hit_points = hit_points;
+    record.acting = acting;
+}
+
+//! \brief Prints the average, minimum and maximum of some values.
+static void _PrintValues(const std::string& name, const std::vector<uint32_t>& values, float scale)
+{
+    if (values.empty())
+        return;
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < values.size(); ++i)
+        total += values[i];
+
+    std::cout << name << ": " << (static_cast<float>(total) / values.size()) * scale << " on average, from "
+              << *std::min_element(values.begin(), values.end()) * scale << " to "
+              << *std::max_element(values.begin(), values.end()) * scale << std::endl;
+}
+
+void BattleSimulation::_DamageStats::Print(const std::string& name)
+{
+    if (hits.empty()) {
+        std::cout << name << ": No hit." << std::endl;
+        return;
+    }
+
+    std::sort(hits.begin(), hits.end());
+    _PrintValues(name + " (" + std::to_string(hits.size()) + " hits)", hits, 1.0f);
+    std::cout << "  10%: " << hits[hits.size() / 10]
+              << ", median: " << hits[hits.size() / 2]
+              << ", 90%: " << hits[hits.size() * 9 / 10] << std::endl;
+}
+
+void BattleSimulation::_PrintReport()
+{
+    std::cout << "Simulated " << _battle_count << " battles against the enemies:";
+    for (uint32_t i = 0; i < _enemy_ids.size(); ++i)
+        std::cout << " " << _enemy_ids[i];
+    std::cout << " (random seeds " << _random_seed << " and on)" << std::endl;
+
+    if (_battle_count == 0)
+        return;
+
+    std::cout << "Victories: " << _victories << " (" << (100.0f * _victories / _battle_count) << "%), "
+              << "defeats: " << _defeats << ", timeouts: " << _timeouts << std::endl;
+
+    _PrintValues("Character actions per battle", _character_actions, 1.0f);
+    _PrintValues("Enemy actions per battle", _enemy_actions, 1.0f);
+    _PrintValues("Battle duration in seconds", _durations, 0.001f);
+
+    _damage_to_enemies.Print("Damage to the enemies");
+    _damage_to_characters.Print("Damage to the characters");
+}
+
+//! \brief Writes some values as a JSON array.
+static void _WriteJSONArray(std::ofstream& file, const std::vector<uint32_t>& values)
+{
+    file << "[";
+    for (uint32_t i = 0; i < values.size(); ++i)
+        file << (i > 0 ? ", " : "") << values[i];
+    file << "]";
+}
+
+bool BattleSimulation::_SaveResults()
+{
+    std::ofstream file(_results_filename.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        PRINT_ERROR << "Couldn't open the battle simulation results file: " << _results_filename << std::endl;
+        return false;
+    }
+
+    // The saved game filename is given by the user, and isn't escaped.
+    file << "{" << std::endl
+         << "  \"save_filename\": \"" << _save_filename << "\"," << std::endl
+         << "  \"enemy_ids\": ";
+    _WriteJSONArray(file, _enemy_ids);
+    file << "," << std::endl
+         << "  \"difficulty\": " << SystemManager->GetGameDifficulty() << "," << std::endl
+         << "  \"random_seed\": " << _random_seed << "," << std::endl
+         << "  \"battles\": " << _battle_count << "," << std::endl
+         << "  \"victories\": " << _victories << "," << std::endl
+         << "  \"defeats\": " << _defeats << "," << std::endl
+         << "  \"timeouts\": " << _timeouts << "," << std::endl
+         << "  \"character_actions\": ";
+    _WriteJSONArray(file, _character_actions);
+    file << "," << std::endl << "  \"enemy_actions\": ";
+    _WriteJSONArray(file, _enemy_actions);
+    file << "," << std::endl << "  \"durations\": ";
+    _WriteJSONArray(file, _durations);
+    file << "," << std::endl << "  \"damage_to_characters\": ";
+    _WriteJSONArray(file, _damage_to_characters.hits);
+    file << "," << std::endl << "  \"damage_to_enemies\": ";
+    _WriteJSONArray(file, _damage_to_enemies.hits);
+    file << std::endl << "}" << std::endl;
+
+    file.close();
+    if (file.fail()) {
+        PRINT_ERROR << "Couldn't write the battle simulation results file: " << _results_filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace vt_battle
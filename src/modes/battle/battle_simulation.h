@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software and
+// you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+////////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    battle_simulation.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for simulating battles, to tune the enemies and skills.
+***
+*** The battles are run by the battle mode itself, the characters attacking
+*** on their own as in auto-battle. Nothing is drawn and the game clock moves
+*** by fixed steps, so that the battles run as fast as they can be updated.
+*** ***************************************************************************/
+
+#ifndef __BATTLE_SIMULATION_HEADER__
+#define __BATTLE_SIMULATION_HEADER__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vt_battle
+{
+
+class BattleMode;
+
+namespace private_battle
+{
+class BattleActor;
+}
+
+/** ****************************************************************************
+*** \brief Simulates a series of seeded battles and reports their results.
+***
+*** The saved game is loaded again before each battle, so that every battle
+*** starts with the same party. The battle of index i uses the random seed
+*** plus i, so that any battle can be run again alone.
+*** ***************************************************************************/
+class BattleSimulation
+{
+public:
+    /** \param save_filename The saved game giving the characters party.
+    *** \param enemy_ids The enemies to fight in each battle.
+    *** \param battle_count The number of battles to simulate.
+    *** \param random_seed The random seed of the first battle.
+    **/
+    BattleSimulation(const std::string& save_filename, const std::vector<uint32_t>& enemy_ids,
+                     uint32_t battle_count, uint64_t random_seed);
+
+    //! \brief Sets the game difficulty of the battles, from 1 to 3. 0 keeps the settings one.
+    void SetDifficulty(uint32_t difficulty) {
+        _difficulty = difficulty;
+    }
+
+    /** \brief Sets a file to save the results of every battle in, as JSON.
+    *** This is what tools/simulate-battles.py gathers from the simulations it runs in parallel.
+    **/
+    void SetResultsFilename(const std::string& results_filename) {
+        _results_filename = results_filename;
+    }
+
+    /** \brief Simulates the battles, and prints the report on the standard output.
+    *** \return False if the saved game or the enemies couldn't be loaded, or the results saved.
+    **/
+    bool Run();
+
+private:
+    //! \brief The damage of each hit received by one side.
+    class _DamageStats
+    {
+    public:
+        std::vector<uint32_t> hits;
+
+        //! \brief Prints the hit count, the average and the percentiles of the damage.
+        void Print(const std::string& name);
+    };
+
+    //! \brief What was last seen of an actor, to find its state changes and hits.
+    class _ActorRecord
+    {
+    public:
+        _ActorRecord() :
+            hit_points(0),
+            acting(false)
+        {}
+
+        uint32_t hit_points;
+        bool acting;
+    };
+
+    std::string _save_filename;
+
+    std::vector<uint32_t> _enemy_ids;
+
+    uint32_t _battle_count;
+
+    uint64_t _random_seed;
+
+    uint32_t _difficulty;
+
+    std::string _results_filename;
+
+    //! \brief The battle results.
+    //@{
+    uint32_t _victories;
+    uint32_t _defeats;
+    uint32_t _timeouts;
+    //@}
+
+    //! \brief The actions done in each battle, by each side.
+    std::vector<uint32_t> _character_actions;
+    std::vector<uint32_t> _enemy_actions;
+
+    //! \brief The duration of each battle, in milliseconds of game time.
+    std::vector<uint32_t> _durations;
+
+    _DamageStats _damage_to_characters;
+    _DamageStats _damage_to_enemies;
+
+    //! \brief The actors of the current battle.
+    std::map<const private_battle::BattleActor*, _ActorRecord> _actor_records;
+
+    /** \brief Simulates one battle.
+    *** \return False if the battle couldn't be set up.
+    **/
+    bool _SimulateBattle(uint32_t index);
+
+    /** \brief Looks for the actions started and the hits received by an actor since the last update.
+    *** \param actions Incremented when the actor started an action.
+    **/
+    void _ObserveActor(const private_battle::BattleActor* actor, uint32_t& actions, _DamageStats& damage);
+
+    void _PrintReport();
+
+    //! \brief Saves the results of every battle in the results file.
+    bool _SaveResults();
+};
+
+} // namespace vt_battle
+
+#endif // __BATTLE_SIMULATION_HEADER__
@@ -43,7 +43,8 @@ CommandSettings::CommandSettings(BattleCharacter* character, MenuWindow& window)
     _last_item(0),
     _last_self_target(BattleTarget()),
     _last_character_target(BattleTarget()),
-    _last_enemy_target(BattleTarget())
+    _last_enemy_target(BattleTarget()),
+    _refreshed_skill_points(0xFFFFFFFF)
 {
     _weapon_skill_list.SetOwner(&window);
     _weapon_skill_list.SetPosition(LIST_POSITION_X, LIST_POSITION_Y);
@@ -213,6 +214,10 @@ void CommandSettings::RefreshLists()
 {
     uint32_t require_sp = 0xFFFFFFFF;
     uint32_t current_sp = _character->GetSkillPoints();
+    if(current_sp == _refreshed_skill_points)
+        return;
+    _refreshed_skill_points = current_sp;
+
     std::vector<GlobalSkill *>* skill_list = nullptr;
 
     skill_list = _character->GetGlobalCharacter()->GetWeaponSkills();
@@ -61,6 +61,7 @@ public:
     *** This should be called whenever the character's current skill points has changed or may have
     *** changed. This method will go through all three skill lists and use the character's current
     *** skill points to determine whether each entry should be enabled or disabled.
+    *** \note Nothing is done when the skill points didn't change since the last refresh.
     **/
     void RefreshLists();
 
@@ -148,6 +149,9 @@ private:
     //! \brief The last enemy target that the player selected for this character
     BattleTarget _last_enemy_target;
 
+    //! \brief The character skill points the lists were last refreshed with.
+    uint32_t _refreshed_skill_points;
+
     //! \brief A display list of all usable weapon skills
     vt_gui::OptionBox _weapon_skill_list;
     vt_gui::OptionBox _weapon_target_list;
@@ -51,7 +51,11 @@ CommandSupervisor::CommandSupervisor() :
     _selected_item(nullptr),
     _item_command(_command_window),
     _skill_command(_command_window),
-    _show_information(false)
+    _show_information(false),
+    _info_skill(nullptr),
+    _info_item(nullptr),
+    _info_item_count(0),
+    _info_attack_point(nullptr)
 {
     if(_command_window.Create(512.0f, 128.0f) == false) {
         PRINT_WARNING << "failed to create menu window" << std::endl;
@@ -147,6 +151,7 @@ void CommandSupervisor::Initialize(BattleCharacter *character)
         _CreateCharacterSettings(character);
 
     _ChangeState(COMMAND_STATE_CATEGORY);
+    _ResetActionInformation();
     _active_settings = &(_character_settings.find(character)->second);
     // Update _skill_list to check, if some skills need to be deactivated due to low amount of SP
     _active_settings->RefreshLists();
@@ -470,8 +475,8 @@ void CommandSupervisor::_ChangeState(COMMAND_STATE new_state)
                 return;
             }
         }
+        _CreateActorTargetText();
         _target_options.ResetViewableOption();
-        _UpdateActorTargetText();
     } else if(new_state == COMMAND_STATE_POINT) {
         _CreateAttackPointTargetText();
     }
@@ -655,6 +660,11 @@ void CommandSupervisor::_UpdateActionInformation()
         uint32_t selected_point = _selected_target.GetAttackPoint();
         GlobalAttackPoint* attack_point = actor->GetAttackPoint(selected_point);
 
+        if (attack_point == _info_attack_point)
+            return;
+        _ResetActionInformation();
+        _info_attack_point = attack_point;
+
         _info_header.SetText(attack_point->GetName());
 
          // Set the text
@@ -713,6 +723,11 @@ void CommandSupervisor::_UpdateActionInformation()
         }
 
     } else if(_IsSkillCategorySelected()) {
+        if (_selected_skill == _info_skill)
+            return;
+        _ResetActionInformation();
+        _info_skill = _selected_skill;
+
         _info_header.SetText(_selected_skill->GetName()
                              + MakeUnicodeString(" - "
                              + VTranslate("%s SP", NumberToString(_selected_skill->GetSPRequired()))));
@@ -722,8 +737,14 @@ void CommandSupervisor::_UpdateActionInformation()
         info_text += MakeUnicodeString(VTranslate("Cool Time: %s", _TurnIntoSeconds(_selected_skill->GetCooldownTime())) + "\n\n");
         info_text += _selected_skill->GetDescription();
     } else if(_IsItemCategorySelected()) {
+        if (_selected_item.get() == _info_item && _selected_item->GetBattleCount() == _info_item_count)
+            return;
+        _ResetActionInformation();
+        _info_item = _selected_item.get();
+        _info_item_count = _selected_item->GetBattleCount();
+
         _info_header.SetText(_selected_item->GetGlobalItem().GetName()
-                             + MakeUnicodeString(" x " + NumberToString(_selected_item->GetBattleCount())));
+                             + MakeUnicodeString(" x " + NumberToString(_info_item_count)));
         info_text = MakeUnicodeString(VTranslate("Target Type: %s", GetTargetText(_selected_item->GetTargetType())) + "\n\n");
         info_text += _selected_item->GetGlobalItem().GetDescription();
     } else {
@@ -816,7 +837,7 @@ void CommandSupervisor::_DrawActionInformation()
     }
 }
 
-void CommandSupervisor::_UpdateActorTargetText()
+void CommandSupervisor::_CreateActorTargetText()
 {
     _window_header.SetText(UTranslate("Select Target"));
 
@@ -832,22 +853,36 @@ void CommandSupervisor::_UpdateActorTargetText()
     } else if(IsTargetAlly(_selected_target.GetType())) {
         for(uint32_t i = 0; i < BattleMode::CurrentInstance()->GetCharacterActors().size(); i++) {
             _target_options.AddOption(BattleMode::CurrentInstance()->GetCharacterActors().at(i)->GetName());
-            if(_selected_target.GetType() != GLOBAL_TARGET_ALLY_EVEN_DEAD
-                    && !BattleMode::CurrentInstance()->GetCharacterActors().at(i)->IsAlive()) {
-                _target_options.EnableOption(i, false);
-            }
         }
     } else if(IsTargetFoe(_selected_target.GetType())) {
         for(uint32_t i = 0; i < BattleMode::CurrentInstance()->GetEnemyActors().size(); i++) {
             _target_options.AddOption(BattleMode::CurrentInstance()->GetEnemyActors().at(i)->GetName());
-            if(BattleMode::CurrentInstance()->GetEnemyActors().at(i)->IsAlive() == false) {
-                _target_options.EnableOption(i, false);
-            }
         }
     } else {
         IF_PRINT_WARNING(BATTLE_DEBUG) << "invalid target type: " << _selected_target.GetType() << std::endl;
     }
 
+    _UpdateActorTargetText();
+}
+
+void CommandSupervisor::_UpdateActorTargetText()
+{
+    // The options are kept while selecting, only the actors which died in the meantime are disabled.
+    if(IsTargetParty(_selected_target.GetType()) || IsTargetSelf(_selected_target.GetType())) {
+        // Nothing to do, as the single option stays enabled.
+    } else if(IsTargetAlly(_selected_target.GetType())) {
+        const std::deque<BattleCharacter*>& characters = BattleMode::CurrentInstance()->GetCharacterActors();
+        for(uint32_t i = 0; i < characters.size() && i < _target_options.GetNumberOptions(); i++) {
+            _target_options.EnableOption(i, _selected_target.GetType() == GLOBAL_TARGET_ALLY_EVEN_DEAD
+                                            || characters.at(i)->IsAlive());
+        }
+    } else if(IsTargetFoe(_selected_target.GetType())) {
+        const std::deque<BattleEnemy*>& enemies = BattleMode::CurrentInstance()->GetEnemyActors();
+        for(uint32_t i = 0; i < enemies.size() && i < _target_options.GetNumberOptions(); i++) {
+            _target_options.EnableOption(i, enemies.at(i)->IsAlive());
+        }
+    }
+
     // Clear the shown effects first.
     _selected_target_status_effects.clear();
 
@@ -214,6 +214,13 @@ private:
     //! \brief Stores whether the information window should be shown
     bool _show_information;
 
+    //! \brief The skill, item (and its count) or attack point the information window was last set for.
+    //! The information text is only set again when they changed.
+    vt_global::GlobalSkill* _info_skill;
+    BattleItem* _info_item;
+    uint32_t _info_item_count;
+    vt_global::GlobalAttackPoint* _info_attack_point;
+
     // ---------- Private methods
 
     //! \brief Returns true if the selected action category is a skill action
@@ -279,9 +286,21 @@ private:
     //! \brief Draws visible contents to the screen when the player is viewing information about an action
     void _DrawActionInformation();
 
-    //! \brief Updates the text for _window_header and _selected_target_name to represent information about the selected target
+    //! \brief Sets the text for _window_header and _target_options to represent the possible targets,
+    //! and updates the selected target text. Should be called only when switching to selecting an actor.
+    void _CreateActorTargetText();
+
+    //! \brief Updates the text for _selected_target_name to represent information about the selected target
     void _UpdateActorTargetText();
 
+    //! \brief Makes the information window be set again on next update.
+    void _ResetActionInformation() {
+        _info_skill = nullptr;
+        _info_item = nullptr;
+        _info_item_count = 0;
+        _info_attack_point = nullptr;
+    }
+
     //! \brief Sets the text for _window_header and _target_options to represent information about the selected target.
     //! Should be called only when switching to displaying attack points.
     void _CreateAttackPointTargetText();
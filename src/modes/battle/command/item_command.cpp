@@ -81,9 +81,9 @@ void ItemCommand::ResetItemList()
 {
     _battle_items.clear();
 
-    auto inv_items = GlobalManager->GetInventoryHandler().GetInventoryItems();
+    const auto& inv_items = GlobalManager->GetInventoryHandler().GetInventoryItems();
     for (uint32_t i = 0; i < inv_items.size(); ++i) {
-        std::shared_ptr<GlobalItem> global_item = inv_items.at(i);
+        const std::shared_ptr<GlobalItem>& global_item = inv_items.at(i);
 
         // Only add non key and valid items as items available at battle start.
         if (global_item->GetCount() == 0)
@@ -101,14 +101,46 @@ void ItemCommand::ResetItemList()
 
     // We clear the menu items list as its pointers are now invalid.
     _menu_items.clear();
+    _menu_item_counts.clear();
+}
+
+bool ItemCommand::_UpdateListCounts()
+{
+    // The list is valid as long as it shows the items with a count, in the same order.
+    uint32_t menu_index = 0;
+    for(uint32_t i = 0; i < _battle_items.size(); ++i) {
+        if(_battle_items[i]->GetBattleCount() == 0)
+            continue;
+        if(menu_index >= _menu_items.size() || _menu_items[menu_index] != _battle_items[i])
+            return false;
+        ++menu_index;
+    }
+    if(menu_index != _menu_items.size() || _item_list.GetNumberOptions() != _menu_items.size())
+        return false;
+
+    for(uint32_t i = 0; i < _menu_items.size(); ++i) {
+        uint32_t count = _menu_items[i]->GetBattleCount();
+        if(count == _menu_item_counts[i])
+            continue;
+
+        _menu_item_counts[i] = count;
+        _item_target_list.SetOptionElementText(i, 0, MakeUnicodeString(NumberToString(count)));
+    }
+    return true;
 }
 
 void ItemCommand::ConstructList()
 {
+    if(_UpdateListCounts()) {
+        _ResetListSelection();
+        return;
+    }
+
     _item_list.ClearOptions();
     _item_target_list.ClearOptions();
 
     _menu_items.clear();
+    _menu_item_counts.clear();
 
     uint32_t option_index = 0;
     for(uint32_t i = 0; i < _battle_items.size(); ++i) {
@@ -119,6 +151,7 @@ void ItemCommand::ConstructList()
 
         // Adds the BattleItem pointer to the main item list
         _menu_items.push_back(item);
+        _menu_item_counts.push_back(item->GetBattleCount());
 
         // Adds the item menu option
         _item_list.AddOption();
@@ -138,6 +171,11 @@ void ItemCommand::ConstructList()
         ++option_index;
     }
 
+    _ResetListSelection();
+}
+
+void ItemCommand::_ResetListSelection()
+{
     if(_item_list.GetNumberOptions() == 0) {
         _item_list.SetSelection(-1);
         _item_target_list.SetSelection(-1);
@@ -43,9 +43,9 @@ public:
     ~ItemCommand()
     {}
 
-    /** \brief Constructs the _item_list option box from scratch using the _items container
-    *** This will also reset the selection on the item list to the first element. Typically this only needs to be
-    *** called once, during battle mode initialization.
+    /** \brief Constructs the _item_list option box using the _items container
+    *** This will also reset the selection on the item list to the first element.
+    *** The list is only built again when the items listed changed, the counts being updated in place otherwise.
     **/
     void ConstructList();
 
@@ -86,6 +86,14 @@ public:
     }
 
 private:
+    /** \brief Updates the counts shown in the item lists
+    *** \return false when the items listed changed, and the lists must be constructed again.
+    **/
+    bool _UpdateListCounts();
+
+    //! \brief Selects the first item of the lists, and scrolls back to it.
+    void _ResetListSelection();
+
     /** \brief Container for all available items at battle start
     *** The size of the container does not change, even when the available
     *** count of a specific item becomes zero.
@@ -99,6 +107,9 @@ private:
     **/
     std::vector<std::shared_ptr<BattleItem>> _menu_items;
 
+    //! \brief The battle count of each _menu_items member, as shown in the target list.
+    std::vector<uint32_t> _menu_item_counts;
+
     //! \brief A single line of header text for the item list option box
     vt_gui::OptionBox _item_header;
 
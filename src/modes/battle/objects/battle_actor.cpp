@@ -17,6 +17,8 @@
 
 #include "common/global/actors/global_attack_point.h"
 #include "common/global/global_skills.h"
+#include "common/random_streams.h"
+#include "common/script_call_profiler.h"
 
 #include "utils/utils_random.h"
 
@@ -157,6 +159,7 @@ void BattleActor::ChangeState(ACTOR_STATE new_state)
         // If an AI is used, it will change itself the actor state.
         if (_ai_decide_action.is_valid()) {
             try {
+                ScriptCallTimer timer("actor DecideAction", _global_actor->GetID(), _ai_decide_action);
                 luabind::call_function<void>(_ai_decide_action, BattleMode::CurrentInstance(), this);
             } catch(const luabind::error &e) {
                 PRINT_ERROR << "Error while triggering DecideAction() function of actor id: " << _global_actor->GetID() << std::endl;
@@ -221,6 +224,7 @@ void BattleActor::ChangeState(ACTOR_STATE new_state)
         // Init the death animation script when valid.
         if (_death_init.is_valid()) {
             try {
+                ScriptCallTimer timer("actor death Initialize", _global_actor->GetID(), _death_init);
                 luabind::call_function<void>(_death_init, BattleMode::CurrentInstance(), this);
             } catch(const luabind::error &e) {
                 PRINT_ERROR << "Error while triggering Initialize() function of actor id: " << _global_actor->GetID() << std::endl;
@@ -292,7 +296,7 @@ void BattleActor::RegisterDamage(uint32_t amount, BattleTarget *target)
         } else {
             std::vector<std::pair<GLOBAL_STATUS, float> > status_effects = damaged_point->GetStatusEffects();
             for(std::vector<std::pair<GLOBAL_STATUS, float> >::const_iterator i = status_effects.begin(); i != status_effects.end(); ++i) {
-                if(RandomFloat(0.0f, 100.0f) <= i->second) {
+                if(GetRandomStream(RANDOM_STREAM_BATTLE).Float(0.0f, 100.0f) <= i->second) {
                     ApplyActiveStatusEffect(i->first, GLOBAL_INTENSITY_NEG_MODERATE, 15000);
                 }
             }
@@ -491,6 +495,7 @@ void BattleActor::_UpdateState()
         if (_death_init.is_valid() && _death_update.is_valid()) {
             // Change the state when the animation has finished.
             try {
+                ScriptCallTimer timer("actor death Update", _global_actor->GetID(), _death_update);
                 if (luabind::call_function<bool>(_death_update))
                     ChangeState(ACTOR_STATE_DEAD);
             } catch(const luabind::error &e) {
@@ -742,7 +747,7 @@ void BattleActor::SetAction(uint32_t skill_id, BattleActor* target_actor)
         if(num_points == 1)
             point_target = 0;
         else
-            point_target = RandomBoundedInteger(0, num_points - 1);
+            point_target = GetRandomStream(RANDOM_STREAM_BATTLE).BoundedInteger(0, num_points - 1);
 
         target.SetTarget(this, target_type, target_actor, point_target);
         break;
@@ -820,18 +825,57 @@ void BattleActor::_LoadAIScript()
     _ai_decide_action = _ai_script.ReadFunctionPointer("DecideAction");
 }
 
+// The AI decisions pick the skills and targets among the usable ones by counting
+// them, and then walking up to the randomly chosen one, so that nothing needs
+// to be allocated.
+
+//! \brief Tells whether a skill can be used by an actor with the given skill points.
+static bool IsSkillUsable(const GlobalSkill* skill, uint32_t skill_points)
+{
+    return skill->IsExecutableInBattle() && skill->GetSPRequired() <= skill_points;
+}
+
+//! \brief Returns the number of actors of a party which are alive, or dead.
+static uint32_t CountActors(const std::deque<BattleActor *>& party, bool alive)
+{
+    uint32_t count = 0;
+    for(uint32_t i = 0; i < party.size(); ++i) {
+        if(party[i]->IsAlive() == alive)
+            ++count;
+    }
+    return count;
+}
+
+/** \brief Returns a random actor among the alive, or dead, actors of a party.
+*** \param count The number of such actors, as given by CountActors(). Must not be 0.
+**/
+static BattleActor* PickRandomActor(const std::deque<BattleActor *>& party, bool alive, uint32_t count)
+{
+    uint32_t index = 0;
+    if(count > 1)
+        index = GetRandomStream(RANDOM_STREAM_BATTLE).BoundedInteger(0, count - 1);
+
+    for(uint32_t i = 0; i < party.size(); ++i) {
+        if(party[i]->IsAlive() != alive)
+            continue;
+        if(index == 0)
+            return party[i];
+        --index;
+    }
+    return nullptr;
+}
+
 void BattleActor::_DecideAction()
 {
     const std::vector<GlobalSkill *>& actor_skills = _global_actor->GetSkills();
-    std::vector<GlobalSkill *> usable_skills;
-    std::vector<GlobalSkill*>::const_iterator skill_it = actor_skills.begin();
-    while(skill_it != actor_skills.end()) {
-        if((*skill_it)->IsExecutableInBattle() && (*skill_it)->GetSPRequired() <= GetSkillPoints())
-            usable_skills.push_back(*skill_it);
-        ++skill_it;
+    const uint32_t skill_points = GetSkillPoints();
+    uint32_t usable_skills = 0;
+    for(uint32_t i = 0; i < actor_skills.size(); ++i) {
+        if(IsSkillUsable(actor_skills[i], skill_points))
+            ++usable_skills;
     }
 
-    if(usable_skills.empty()) {
+    if(usable_skills == 0) {
         IF_PRINT_WARNING(BATTLE_DEBUG) << "The actor had no usable skills" << std::endl;
         ChangeState(ACTOR_STATE_IDLE);
         return;
@@ -843,31 +887,16 @@ void BattleActor::_DecideAction()
     std::deque<BattleActor *>& characters = IsEnemy() ? BM->GetEnemyParty() : BM->GetCharacterParty();
     std::deque<BattleActor *>& enemies = IsEnemy() ? BM->GetCharacterParty() : BM->GetEnemyParty();
 
-    std::deque<BattleActor *> alive_characters;
-    std::deque<BattleActor *> dead_characters;
-    std::deque<BattleActor *>::const_iterator it = characters.begin();
-    while(it != characters.end()) {
-        if((*it)->IsAlive())
-            alive_characters.push_back(*it);
-        else
-            dead_characters.push_back(*it);
-        ++it;
-    }
-    if(alive_characters.empty()) {
+    const uint32_t alive_characters = CountActors(characters, true);
+    const uint32_t dead_characters = characters.size() - alive_characters;
+    if(alive_characters == 0) {
         ChangeState(ACTOR_STATE_IDLE);
         return;
     }
 
     // and the enemies depending on their state
-    std::deque<BattleActor *> alive_enemies;
-    it = enemies.begin();
-    while(it != enemies.end()) {
-        if((*it)->IsAlive())
-            alive_enemies.push_back(*it);
-        ++it;
-    }
-
-    if(alive_enemies.empty()) {
+    const uint32_t alive_enemies = CountActors(enemies, true);
+    if(alive_enemies == 0) {
         ChangeState(ACTOR_STATE_IDLE);
         return;
     }
@@ -878,9 +907,17 @@ void BattleActor::_DecideAction()
 
     // Select a random skill to use
     uint32_t skill_index = 0;
-    if(usable_skills.size() > 1)
-        skill_index = RandomBoundedInteger(0, usable_skills.size() - 1);
-    GlobalSkill* skill = usable_skills.at(skill_index);
+    if(usable_skills > 1)
+        skill_index = GetRandomStream(RANDOM_STREAM_BATTLE).BoundedInteger(0, usable_skills - 1);
+    GlobalSkill* skill = nullptr;
+    for(uint32_t i = 0; i < actor_skills.size() && skill == nullptr; ++i) {
+        if(!IsSkillUsable(actor_skills[i], skill_points))
+            continue;
+        if(skill_index == 0)
+            skill = actor_skills[i];
+        else
+            --skill_index;
+    }
 
     // Select the target
     GLOBAL_TARGET target_type = skill->GetTargetType();
@@ -888,10 +925,7 @@ void BattleActor::_DecideAction()
     case GLOBAL_TARGET_FOE_POINT:
     case GLOBAL_TARGET_FOE:
         // Select a random living enemy
-        if(alive_enemies.size() == 1)
-            actor_target = alive_enemies[0];
-        else
-            actor_target = alive_enemies[RandomBoundedInteger(0, alive_enemies.size() - 1)];
+        actor_target = PickRandomActor(enemies, true, alive_enemies);
         break;
     case GLOBAL_TARGET_SELF_POINT:
     case GLOBAL_TARGET_SELF:
@@ -900,30 +934,24 @@ void BattleActor::_DecideAction()
     case GLOBAL_TARGET_ALLY_POINT:
     case GLOBAL_TARGET_ALLY:
         // Select a random living character
-        if(alive_characters.size() == 1)
-            actor_target = alive_characters[0];
-        else
-            actor_target = alive_characters[RandomBoundedInteger(0, alive_characters.size() - 1)];
+        actor_target = PickRandomActor(characters, true, alive_characters);
         break;
     case GLOBAL_TARGET_ALLY_EVEN_DEAD:
         // Select a random ally, living or not
         if(characters.size() == 1)
             actor_target = characters[0];
         else
-            actor_target = characters[RandomBoundedInteger(0, characters.size() - 1)];
+            actor_target = characters[GetRandomStream(RANDOM_STREAM_BATTLE).BoundedInteger(0, characters.size() - 1)];
         break;
     case GLOBAL_TARGET_DEAD_ALLY_ONLY:
-        if (dead_characters.empty()) {
+        if (dead_characters == 0) {
             // Abort the skill since there is no valid targets.
             ChangeState(ACTOR_STATE_IDLE);
             return;
         }
 
-        // Select a random ally, living or not
-        if(dead_characters.size() == 1)
-            actor_target = dead_characters[0];
-        else
-            actor_target = dead_characters[RandomBoundedInteger(0, dead_characters.size() - 1)];
+        // Select a random dead ally
+        actor_target = PickRandomActor(characters, false, dead_characters);
         break;
     case GLOBAL_TARGET_ALL_FOES:
     case GLOBAL_TARGET_ALL_ALLIES:
@@ -947,7 +975,7 @@ void BattleActor::_DecideAction()
         if(num_points == 1)
             point_target = 0;
         else
-            point_target = RandomBoundedInteger(0, num_points - 1);
+            point_target = GetRandomStream(RANDOM_STREAM_BATTLE).BoundedInteger(0, num_points - 1);
 
         target.SetTarget(this, target_type, actor_target, point_target);
         break;
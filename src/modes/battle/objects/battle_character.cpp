@@ -18,6 +18,7 @@
 #include "common/global/global.h"
 #include "common/global/actors/global_character.h"
 #include "common/global/objects/global_weapon.h"
+#include "common/script_call_profiler.h"
 
 #include "engine/video/text.h"
 
@@ -46,12 +47,10 @@ BattleCharacter::BattleCharacter(GlobalCharacter *character) :
     _last_rendered_hp = GetHitPoints();
     _last_rendered_sp = GetSkillPoints();
 
-    _name_text.SetStyle(TextStyle("title22"));
-    _name_text.SetText(GetName());
-    _hit_points_text.SetStyle(TextStyle("text24", VIDEO_TEXT_SHADOW_BLACK));
-    _hit_points_text.SetText(NumberToString(_last_rendered_hp));
-    _skill_points_text.SetStyle(TextStyle("text24", VIDEO_TEXT_SHADOW_BLACK));
-    _skill_points_text.SetText(NumberToString(_last_rendered_sp));
+    _name_text = GlobalManager->Media().GetCharacterNameText(character, "title22");
+    _points_text_style = TextStyle("text24", VIDEO_TEXT_SHADOW_BLACK);
+    _hit_points_text = MakeUnicodeString(NumberToString(_last_rendered_hp));
+    _skill_points_text = MakeUnicodeString(NumberToString(_last_rendered_sp));
 
     _action_selection_text.SetStyle(TextStyle("text20"));
     _action_selection_text.SetText("");
@@ -210,14 +209,14 @@ void BattleCharacter::Update()
     _current_sprite_animation->Update();
     _current_weapon_animation.Update();
 
-    // Update hit and skill points after drawing to reduce GPU stall.
+    // Update the hit and skill points text. Only the glyphs drawn change.
     if(_last_rendered_hp != GetHitPoints()) {
         _last_rendered_hp = GetHitPoints();
-        _hit_points_text.SetText(NumberToString(_last_rendered_hp));
+        _hit_points_text = MakeUnicodeString(NumberToString(_last_rendered_hp));
     }
     if(_last_rendered_sp != GetSkillPoints()) {
         _last_rendered_sp = GetSkillPoints();
-        _skill_points_text.SetText(NumberToString(_last_rendered_sp));
+        _skill_points_text = MakeUnicodeString(NumberToString(_last_rendered_sp));
     }
 
     BattleMode* BM = BattleMode::CurrentInstance();
@@ -332,6 +331,7 @@ void BattleCharacter::DrawSprite()
 
     if(_state == ACTOR_STATE_DYING) {
         try {
+            vt_common::ScriptCallTimer timer("actor death DrawOnSprite", _global_actor->GetID(), _death_draw_on_sprite);
             if (_death_draw_on_sprite.is_valid())
                 luabind::call_function<void>(_death_draw_on_sprite);
         } catch(const luabind::error &e) {
@@ -524,11 +524,11 @@ void BattleCharacter::DrawStatus(uint32_t order, BattleCharacter* character_comm
     VideoManager->SetDrawFlags(VIDEO_X_CENTER, 0);
     // Draw the character's current health on top of the middle of the HP bar.
     VideoManager->Move(356.0f, 687.0f + y_offset);
-    _hit_points_text.Draw();
+    TextManager->Draw(_hit_points_text, _points_text_style);
 
     // Draw the character's current skill points on top of the middle of the SP bar.
     VideoManager->MoveRelative(113.0f, 0.0f);
-    _skill_points_text.Draw();
+    TextManager->Draw(_skill_points_text, _points_text_style);
 
     // Note: if the command menu is visible, it will be drawn over all of the components that follow below. We still perform these draw calls
     // regardless because sometimes even if the battle is in the command state, the command menu may not be drawn if a dialogue is active or if
@@ -118,11 +118,13 @@ protected:
     //! \brief Rendered text of the character's name
     vt_video::TextImage _name_text;
 
-    //! \brief Rendered text of the character's current hit points
-    vt_video::TextImage _hit_points_text;
+    //! \brief The text of the character's current hit and skill points.
+    //! Drawn from the font glyphs, so that the changing values never render a texture.
+    vt_utils::ustring _hit_points_text;
+    vt_utils::ustring _skill_points_text;
 
-    //! \brief Rendered text of the character's current skill points
-    vt_video::TextImage _skill_points_text;
+    //! \brief The style the hit and skill points are drawn with.
+    vt_video::TextStyle _points_text_style;
 
     //! \brief Rendered text of the character's currently selected action
     vt_video::TextImage _action_selection_text;
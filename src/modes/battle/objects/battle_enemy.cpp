@@ -15,6 +15,7 @@
 #include "modes/battle/status_effects/status_effects_supervisor.h"
 
 #include "common/global/global.h"
+#include "common/script_call_profiler.h"
 
 #include "utils/utils_random.h"
 
@@ -92,6 +93,7 @@ void BattleEnemy::ChangeState(ACTOR_STATE new_state)
         // Trigger the death sequence if it is valid
         if (_death_init.is_valid()) {
             try {
+                vt_common::ScriptCallTimer timer("actor death Initialize", _global_actor->GetID(), _death_init);
                 luabind::call_function<void>(_death_init, BattleMode::CurrentInstance(), this);
             } catch(const luabind::error &e) {
                 PRINT_ERROR << "Error while triggering Initialize() function of enemy id: " << _global_actor->GetID() << std::endl;
@@ -220,6 +222,7 @@ void BattleEnemy::DrawSprite()
         _sprite_animations->at(GLOBAL_ENEMY_HURT_HEAVILY).Draw(Color(1.0f, 1.0f, 1.0f, _sprite_alpha));
 
         try {
+            vt_common::ScriptCallTimer timer("actor death DrawOnSprite", _global_actor->GetID(), _death_draw_on_sprite);
             if (_death_draw_on_sprite.is_valid())
                 luabind::call_function<void>(_death_draw_on_sprite);
         } catch(const luabind::error &e) {
@@ -25,10 +25,14 @@ namespace vt_battle
 namespace private_battle
 {
 
+//! \brief The number of seconds left before the time left text is first set.
+const uint32_t INVALID_TIME_LEFT = 0xFFFFFFFF;
+
 ActiveBattleStatusEffect::ActiveBattleStatusEffect():
     GlobalStatusEffect(GLOBAL_STATUS_INVALID, GLOBAL_INTENSITY_NEUTRAL),
     _timer(0),
     _icon_image(nullptr),
+    _time_left_seconds(INVALID_TIME_LEFT),
     _intensity_changed(false)
 {}
 
@@ -36,6 +40,7 @@ ActiveBattleStatusEffect::ActiveBattleStatusEffect(GLOBAL_STATUS type, GLOBAL_IN
     GlobalStatusEffect(type, intensity),
     _timer(0),
     _icon_image(nullptr),
+    _time_left_seconds(INVALID_TIME_LEFT),
     _intensity_changed(false)
 {
     // Check that status effect base value are making it actually active
@@ -90,7 +95,7 @@ ActiveBattleStatusEffect::ActiveBattleStatusEffect(GLOBAL_STATUS type, GLOBAL_IN
 
     _icon_image = GlobalManager->Media().GetStatusIcon(_type, _intensity);
 
-    _time_left_text.SetStyle(TextStyle("text14"));
+    _time_left_style = TextStyle("text14");
 }
 
 void ActiveBattleStatusEffect::SetIntensity(vt_global::GLOBAL_INTENSITY intensity)
@@ -134,8 +139,18 @@ void ActiveBattleStatusEffect::_ProcessIntensityChange(bool reset_timer_only)
 void ActiveBattleStatusEffect::UpdateTimeLeftText()
 {
     uint32_t time_left = _timer.TimeLeft() / 1000;
+    if(time_left == _time_left_seconds)
+        return;
+
+    _time_left_seconds = time_left;
     /// tr: status effect time left string in seconds
-    _time_left_text.SetText(vt_system::VTranslate("%d s", time_left));
+    _time_left_text = vt_utils::MakeUnicodeString(vt_system::VTranslate("%d s", time_left));
+}
+
+void ActiveBattleStatusEffect::DrawTimeLeftText() const
+{
+    if(_time_left_seconds != INVALID_TIME_LEFT)
+        TextManager->Draw(_time_left_text, _time_left_style);
 }
 
 } // namespace private_battle
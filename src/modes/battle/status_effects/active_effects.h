@@ -70,17 +70,16 @@ public:
     //! \note This will cause the timer to reset and also
     void SetIntensity(vt_global::GLOBAL_INTENSITY intensity);
 
-    //! \brief Update the time left text
+    //! \brief Update the time left text, when the displayed number of seconds changed.
     void UpdateTimeLeftText();
 
+    //! \brief Draws the time left text with the font glyphs, without creating a texture for it.
+    void DrawTimeLeftText() const;
+
     const vt_video::TextImage& GetName() const {
         return _name;
     }
 
-    const vt_video::TextImage& GetTimeLeftText() const {
-        return _time_left_text;
-    }
-
     const luabind::object& GetApplyFunction() const {
         return _apply_function;
     }
@@ -130,8 +129,10 @@ private:
     //! \brief A pointer to the icon image that represents the status. Will be nullptr if the status is invalid
     vt_video::StillImage* _icon_image;
 
-    //! \brief Holds the time left text of the effect
-    vt_video::TextImage _time_left_text;
+    //! \brief Holds the time left text of the effect, and the number of seconds it displays
+    vt_utils::ustring _time_left_text;
+    uint32_t _time_left_seconds;
+    vt_video::TextStyle _time_left_style;
 
     //! \brief A flag set to true when the intensity value was changed and cleared when the Update method is called
     bool _intensity_changed;
@@ -263,7 +263,7 @@ void BattleStatusEffectsSupervisor::DrawVertical()
         if (!effect.IsActive())
             continue;
 
-        effect.GetTimeLeftText().Draw();
+        effect.DrawTimeLeftText();
         VideoManager->MoveRelative(35.0f, 0.0f);
         effect.GetIconImage()->Draw();
 
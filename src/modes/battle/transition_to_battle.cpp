@@ -83,7 +83,12 @@ void TransitionToBattleMode::Update()
 
     _position += static_cast<float>(SystemManager->GetUpdateTime()) / 50.0f;
 
+    // Load the battle resources decoded so far, spreading the uploads over the transition.
+    BattleMedia& battle_media = GlobalManager->GetBattleMedia();
+    battle_media.UpdatePreloading();
+
     if(_BM && _transition_timer.IsFinished()) {
+        battle_media.FinishPreloading();
         ModeManager->Pop();
         ModeManager->Push(_BM, true, true);
         _BM = nullptr;
@@ -119,6 +124,13 @@ void TransitionToBattleMode::Reset()
     _transition_timer.Initialize(1500, SYSTEM_TIMER_NO_LOOPS);
     _transition_timer.Run();
 
+    // Start decoding the battle resources in the background while the transition plays.
+    if (_BM) {
+        std::vector<uint32_t> enemy_ids;
+        _BM->GetEnemyIds(enemy_ids);
+        GlobalManager->GetBattleMedia().PreloadBattleResources(enemy_ids);
+    }
+
     // Stop the current map music if it is not the same
     std::string battle_music = GlobalManager->GetBattleMedia().battle_music_filename;
     if (AudioManager->GetActiveMusic() != nullptr &&
@@ -104,6 +104,7 @@ BootMode::BootMode() :
 
     // Get rid of the old table to make sure no old data is used.
     ScriptManager->DropGlobalTable("boot");
+    OwnScriptTablespace("boot");
 
     // Test the existence and validity of the boot script.
     ReadScriptDescriptor boot_script;
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_binary_data.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the baked map data files.
+*** ***************************************************************************/
+
+#include "modes/map/map_binary_data.h"
+
+#include "modes/map/map_utils.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The baked map data header: the magic, the 9 uint32 values and 8 bytes of padding.
+const char BINARY_MAP_DATA_MAGIC[] = "VTMAPBIN";
+const uint32_t BINARY_MAP_DATA_HEADER_SIZE = 48;
+
+//! \brief Returns the size rounded up to the next section alignment.
+static uint64_t _AlignSection(uint64_t size)
+{
+    return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+std::string GetBinaryMapDataFilename(const std::string& map_data_filename)
+{
+    const std::string lua_extension = ".lua";
+    std::string filename = map_data_filename;
+    if(filename.size() > lua_extension.size()
+            && filename.compare(filename.size() - lua_extension.size(), lua_extension.size(), lua_extension) == 0)
+        filename.erase(filename.size() - lua_extension.size());
+    return filename + ".vtmap";
+}
+
+bool IsBinaryMapDataUpToDate(const std::string& filename, const std::string& source_filename)
+{
+    return vt_utils::DoesFileExist(filename)
+           && vt_utils::GetFileModTime(filename) >= vt_utils::GetFileModTime(source_filename);
+}
+
+BinaryMapData::BinaryMapData() :
+    _size(0),
+    _num_tile_columns(0),
+    _num_tile_rows(0),
+    _grid_width(0),
+    _grid_height(0),
+    _collision_offset(0)
+{
+}
+
+bool BinaryMapData::Load(const std::string& filename, const std::string& source_filename)
+{
+    if(!vt_utils::DoesFileExist(filename))
+        return false;
+
+    if(vt_utils::GetFileModTime(filename) < vt_utils::GetFileModTime(source_filename)) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "Ignoring the outdated baked map data file: " << filename << std::endl;
+        return false;
+    }
+
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    if(!file.is_open()) {
+        PRINT_WARNING << "Couldn't open the baked map data file: " << filename << std::endl;
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    const std::streamoff file_size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if(file_size < static_cast<std::streamoff>(BINARY_MAP_DATA_HEADER_SIZE) || file_size > 0x7fffffff) {
+        PRINT_WARNING << "Invalid baked map data file size: " << filename << std::endl;
+        return false;
+    }
+
+    _size = static_cast<uint32_t>(file_size);
+    if(_AlignSection(_size) != _size) {
+        PRINT_WARNING << "Invalid baked map data file size: " << filename << std::endl;
+        return false;
+    }
+    _buffer.assign(_size / sizeof(uint64_t), 0);
+    const char* data = _GetData();
+    if(!file.read(reinterpret_cast<char*>(&_buffer[0]), _size)) {
+        PRINT_WARNING << "Couldn't read the baked map data file: " << filename << std::endl;
+        return false;
+    }
+
+    uint32_t header[9];
+    std::memcpy(header, data + 8, sizeof(header));
+    if(std::memcmp(data, BINARY_MAP_DATA_MAGIC, 8) != 0 || header[0] != BINARY_MAP_DATA_VERSION
+            || header[7] != _size) {
+        PRINT_WARNING << "Invalid or outdated baked map data file: " << filename << std::endl;
+        return false;
+    }
+
+    _num_tile_columns = header[1];
+    _num_tile_rows = header[2];
+    _grid_width = header[3];
+    _grid_height = header[4];
+    const uint32_t num_tilesets = header[5];
+    const uint32_t num_layers = header[6];
+
+    // The collision grid is twice as precise as the tiles.
+    if(_num_tile_columns == 0 || _num_tile_rows == 0
+            || _grid_width != _num_tile_columns * 2 || _grid_height != _num_tile_rows * 2) {
+        PRINT_WARNING << "Invalid map size in the baked map data file: " << filename << std::endl;
+        return false;
+    }
+
+    uint32_t offset = BINARY_MAP_DATA_HEADER_SIZE;
+    _tileset_filenames.clear();
+    for(uint32_t i = 0; i < num_tilesets; ++i) {
+        std::string tileset_filename;
+        if(!_ReadString(offset, tileset_filename)) {
+            PRINT_WARNING << "Invalid tileset filename in the baked map data file: " << filename << std::endl;
+            return false;
+        }
+        _tileset_filenames.push_back(tileset_filename);
+    }
+
+    const uint64_t layer_size = static_cast<uint64_t>(_num_tile_columns) * _num_tile_rows * sizeof(int16_t);
+    _layer_types.clear();
+    _layer_offsets.clear();
+    for(uint32_t i = 0; i < num_layers; ++i) {
+        std::string layer_type;
+        const bool valid_type = _ReadString(offset, layer_type);
+        const uint32_t layer_offset = offset;
+        if(!valid_type || !_Skip(offset, layer_size)) {
+            PRINT_WARNING << "Invalid layer #" << i << " in the baked map data file: " << filename << std::endl;
+            return false;
+        }
+        _layer_types.push_back(layer_type);
+        _layer_offsets.push_back(layer_offset);
+    }
+
+    const uint64_t row_words = (_grid_width + 63) / 64;
+    _collision_offset = offset;
+    if(!_Skip(offset, row_words * _grid_height * sizeof(uint64_t)) || offset != _size) {
+        PRINT_WARNING << "Invalid collision grid in the baked map data file: " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool BinaryMapData::_ReadUInt(uint32_t& offset, uint32_t& value) const
+{
+    if(static_cast<uint64_t>(offset) + sizeof(uint32_t) > _size)
+        return false;
+    std::memcpy(&value, _GetData() + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    return true;
+}
+
+bool BinaryMapData::_ReadString(uint32_t& offset, std::string& value) const
+{
+    uint32_t length = 0;
+    if(!_ReadUInt(offset, length) || static_cast<uint64_t>(offset) + length > _size)
+        return false;
+    value.assign(_GetData() + offset, length);
+    // The string length is part of its section.
+    offset -= sizeof(uint32_t);
+    return _Skip(offset, sizeof(uint32_t) + static_cast<uint64_t>(length));
+}
+
+bool BinaryMapData::_Skip(uint32_t& offset, uint64_t size) const
+{
+    const uint64_t next_offset = _AlignSection(offset + size);
+    if(next_offset > _size)
+        return false;
+    offset = static_cast<uint32_t>(next_offset);
+    return true;
+}
+
+} // namespace private_map
+
+} // namespace vt_map
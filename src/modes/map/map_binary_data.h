@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_binary_data.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the baked map data files.
+***
+*** The map data Lua files (the tile layers, collision grid and tilesets used)
+*** can be baked by tools/bake-map-data.py into a binary file next to them,
+*** loaded at once without going through the script engine. The Lua files are
+*** still used when there is no baked file, or when it is outdated or invalid.
+***
+*** The format is little endian, with every section aligned on 8 bytes:
+*** - The header: "VTMAPBIN", then the uint32 version, number of tile columns
+***   and rows, collision grid width and height, number of tilesets, number of
+***   layers, file size and two reserved values.
+*** - The tileset filenames, each one as a uint32 length followed by the characters.
+*** - The layers, each one as its type string, like the tileset filenames, followed by
+***   the int16 tile indices, row by row.
+*** - The collision grid bits, in uint64 words, row by row: bit (x % 64) of
+***   word (y * row words + x / 64) is set when the element is unwalkable.
+*** ***************************************************************************/
+
+#ifndef __MAP_BINARY_DATA_HEADER__
+#define __MAP_BINARY_DATA_HEADER__
+
+#include "engine/memory_stats.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The baked map data format version, to change whenever the format does.
+const uint32_t BINARY_MAP_DATA_VERSION = 1;
+
+//! \brief Returns the baked map data filename corresponding to a map data Lua file.
+std::string GetBinaryMapDataFilename(const std::string& map_data_filename);
+
+//! \brief Tells whether a baked map data file exists and is newer than the map data Lua file it was baked from.
+bool IsBinaryMapDataUpToDate(const std::string& filename, const std::string& source_filename);
+
+/** ****************************************************************************
+*** \brief The content of a baked map data file.
+***
+*** The whole file is read in one go, and the layers and collision grid are
+*** directly read from that buffer, only validated beforehand.
+*** ***************************************************************************/
+class BinaryMapData
+{
+public:
+    BinaryMapData();
+
+    /** \brief Loads and validates a baked map data file.
+    *** \param filename The baked file to load.
+    *** \param source_filename The map data Lua file it was baked from.
+    *** \return False if the file doesn't exist, is older than the Lua file, or is invalid.
+    **/
+    bool Load(const std::string& filename, const std::string& source_filename);
+
+    uint32_t GetNumTileColumns() const {
+        return _num_tile_columns;
+    }
+
+    uint32_t GetNumTileRows() const {
+        return _num_tile_rows;
+    }
+
+    uint32_t GetGridWidth() const {
+        return _grid_width;
+    }
+
+    uint32_t GetGridHeight() const {
+        return _grid_height;
+    }
+
+    const std::vector<std::string>& GetTilesetFilenames() const {
+        return _tileset_filenames;
+    }
+
+    uint32_t GetNumLayers() const {
+        return _layer_types.size();
+    }
+
+    //! \brief Returns the layer type name, as used in the Lua files. E.g.: "ground".
+    const std::string& GetLayerType(uint32_t layer) const {
+        return _layer_types[layer];
+    }
+
+    //! \brief Returns the layer tile indices: tiles[y * number of tile columns + x]
+    const int16_t* GetLayerTiles(uint32_t layer) const {
+        return reinterpret_cast<const int16_t*>(_GetData() + _layer_offsets[layer]);
+    }
+
+    //! \brief Returns the collision grid bits, laid out like the CollisionGrid ones.
+    const uint64_t* GetCollisionWords() const {
+        return reinterpret_cast<const uint64_t*>(_GetData() + _collision_offset);
+    }
+
+    //! \brief Returns the file size in bytes, i.e. the memory used by the data.
+    uint32_t GetSize() const {
+        return _size;
+    }
+
+private:
+    //! \brief The file content, kept as uint64 words so that each section is aligned.
+    std::vector<uint64_t, vt_system::MemoryTagAllocator<uint64_t, vt_system::MEMORY_MAP> > _buffer;
+
+    //! \brief The file size in bytes.
+    uint32_t _size;
+
+    uint32_t _num_tile_columns;
+    uint32_t _num_tile_rows;
+    uint32_t _grid_width;
+    uint32_t _grid_height;
+
+    std::vector<std::string> _tileset_filenames;
+    std::vector<std::string> _layer_types;
+
+    //! \brief The offsets of each layer tile indices, and of the collision grid bits.
+    std::vector<uint32_t> _layer_offsets;
+    uint32_t _collision_offset;
+
+    //! \brief Returns the file content bytes. Not kept as a member, so that the data can be copied.
+    const char* _GetData() const {
+        return reinterpret_cast<const char*>(_buffer.data());
+    }
+
+    //! \brief Reads a uint32 at the given offset, moving it past the value.
+    bool _ReadUInt(uint32_t& offset, uint32_t& value) const;
+
+    //! \brief Reads a string at the given offset, moving it to the next aligned section.
+    bool _ReadString(uint32_t& offset, std::string& value) const;
+
+    //! \brief Skips a section of the given size, moving the offset to the next aligned section.
+    bool _Skip(uint32_t& offset, uint64_t size) const;
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_BINARY_DATA_HEADER__
@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_clearance_map.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the walkable room around each collision grid element.
+*** ***************************************************************************/
+
+#include "modes/map/map_clearance_map.h"
+
+#include "modes/map/map_collision_grid.h"
+
+#include <algorithm>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+void ClearanceMap::Build(const CollisionGrid& grid)
+{
+    _width = grid.GetWidth();
+    _height = grid.GetHeight();
+    _clearance.assign(_width * _height, 0);
+
+    // From the bottom right corner, an element square is one larger than
+    // the smallest square of its right, bottom and bottom right neighbors.
+    for(uint32_t y = _height; y-- > 0;) {
+        for(uint32_t x = _width; x-- > 0;) {
+            if(grid.IsBlocked(x, y))
+                continue;
+
+            uint32_t neighbor_clearance = 0;
+            if(x + 1 < _width && y + 1 < _height) {
+                neighbor_clearance = std::min(std::min(GetClearance(x + 1, y), GetClearance(x, y + 1)),
+                                              GetClearance(x + 1, y + 1));
+            }
+            _clearance[y * _width + x] = static_cast<uint8_t>(std::min(neighbor_clearance + 1, CLEARANCE_MAX));
+        }
+    }
+}
+
+} // namespace private_map
+
+} // namespace vt_map
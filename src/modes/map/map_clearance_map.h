@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_clearance_map.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the walkable room around each collision grid element.
+***
+*** The path finding, the path graph and the chase flow fields test whether a
+*** sprite collision rectangle is free on the collision grid, for nodes checked
+*** over and over and by sprites of different sizes. The clearance of each grid
+*** element is computed once when the map is loaded, so that most of those tests
+*** are answered with a single lookup, whatever the sprite size.
+*** ***************************************************************************/
+
+#ifndef __MAP_CLEARANCE_MAP_HEADER__
+#define __MAP_CLEARANCE_MAP_HEADER__
+
+#include "engine/memory_stats.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+class CollisionGrid;
+
+//! \brief The largest clearance stored, the larger ones being capped to it.
+const uint32_t CLEARANCE_MAX = 255;
+
+/** ****************************************************************************
+*** \brief The side of the largest walkable square starting at each grid element.
+***
+*** The clearance of an element is the side, in elements, of the largest square
+*** of walkable elements whose top left corner is that element, 0 when the
+*** element itself is unwalkable. A rectangle whose top left element has a
+*** clearance at least as large as its longest side is then walkable, and one
+*** whose top left element has a clearance smaller than its shortest side isn't.
+*** ***************************************************************************/
+class ClearanceMap
+{
+public:
+    ClearanceMap() :
+        _width(0),
+        _height(0)
+    {}
+
+    //! \brief Computes the clearance of every element of the grid.
+    void Build(const CollisionGrid& grid);
+
+    //! \brief Tells whether the map was built for a grid of that size.
+    bool HasSize(uint32_t width, uint32_t height) const {
+        return _width == width && _height == height;
+    }
+
+    //! \brief Returns the clearance of an element. The position must be within the grid.
+    uint32_t GetClearance(uint32_t x, uint32_t y) const {
+        return _clearance[y * _width + x];
+    }
+
+private:
+    //! \brief The grid size, in elements.
+    uint32_t _width;
+    uint32_t _height;
+
+    //! \brief The elements clearances, row by row: _clearance[y * _width + x]
+    std::vector<uint8_t, vt_system::MemoryTagAllocator<uint8_t, vt_system::MEMORY_MAP> > _clearance;
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_CLEARANCE_MAP_HEADER__
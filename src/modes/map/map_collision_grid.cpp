@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_collision_grid.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the bit packed map collision grid.
+*** ***************************************************************************/
+
+#include "modes/map/map_collision_grid.h"
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+void CollisionGrid::Resize(uint32_t width, uint32_t height)
+{
+    _width = width;
+    _height = height;
+    _row_words = (width + 63) / 64;
+    _words.assign(_row_words * height, 0);
+}
+
+void CollisionGrid::Assign(uint32_t width, uint32_t height, const uint64_t* words)
+{
+    _width = width;
+    _height = height;
+    _row_words = (width + 63) / 64;
+    _words.assign(words, words + _row_words * height);
+}
+
+bool CollisionGrid::IsAreaFree(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) const
+{
+    const uint32_t first_word = left >> 6;
+    const uint32_t last_word = right >> 6;
+
+    // The bits of the area in its first and last words of each row.
+    const uint64_t all_bits = ~static_cast<uint64_t>(0);
+    const uint64_t first_mask = all_bits << (left & 63);
+    const uint64_t last_mask = all_bits >> (63 - (right & 63));
+
+    for(uint32_t y = top; y <= bottom; ++y) {
+        const uint64_t* row = &_words[y * _row_words];
+        if(first_word == last_word) {
+            if(row[first_word] & first_mask & last_mask)
+                return false;
+            continue;
+        }
+
+        if(row[first_word] & first_mask)
+            return false;
+        for(uint32_t word = first_word + 1; word < last_word; ++word) {
+            if(row[word])
+                return false;
+        }
+        if(row[last_word] & last_mask)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace private_map
+
+} // namespace vt_map
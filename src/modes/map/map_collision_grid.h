@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_collision_grid.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the bit packed map collision grid.
+*** ***************************************************************************/
+
+#ifndef __MAP_COLLISION_GRID_HEADER__
+#define __MAP_COLLISION_GRID_HEADER__
+
+#include "engine/memory_stats.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+/** ****************************************************************************
+*** \brief The unwalkable elements of the map, one bit per collision grid element.
+***
+*** The rows are stored one after another in 64 bit words, so that an area is
+*** tested a whole row word at a time rather than element by element.
+***
+*** \note The map files store a value per element, but only whether it is zero
+*** is ever used, so a single bit is kept.
+*** ***************************************************************************/
+class CollisionGrid
+{
+public:
+    CollisionGrid() :
+        _width(0),
+        _height(0),
+        _row_words(0)
+    {}
+
+    //! \brief Sizes the grid, with every element walkable.
+    void Resize(uint32_t width, uint32_t height);
+
+    //! \brief Sizes the grid and copies its element bits, laid out like _words.
+    void Assign(uint32_t width, uint32_t height, const uint64_t* words);
+
+    uint32_t GetWidth() const {
+        return _width;
+    }
+
+    uint32_t GetHeight() const {
+        return _height;
+    }
+
+    //! \brief Sets whether an element is unwalkable. The position must be within the grid.
+    void SetBlocked(uint32_t x, uint32_t y, bool blocked) {
+        const uint64_t bit = static_cast<uint64_t>(1) << (x & 63);
+        uint64_t& word = _words[y * _row_words + (x >> 6)];
+        word = blocked ? (word | bit) : (word & ~bit);
+    }
+
+    //! \brief Tells whether an element is unwalkable. The position must be within the grid.
+    bool IsBlocked(uint32_t x, uint32_t y) const {
+        return (_words[y * _row_words + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    /** \brief Tells whether every element of an area is walkable.
+    *** \param left, top, right, bottom The inclusive area bounds, which must be within the grid.
+    **/
+    bool IsAreaFree(uint32_t left, uint32_t top, uint32_t right, uint32_t bottom) const;
+
+private:
+    //! \brief The grid size in elements, and the number of words per row.
+    uint32_t _width;
+    uint32_t _height;
+    uint32_t _row_words;
+
+    //! \brief The element bits, row by row: bit (x % 64) of _words[y * _row_words + x / 64]
+    std::vector<uint64_t, vt_system::MemoryTagAllocator<uint64_t, vt_system::MEMORY_MAP> > _words;
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_COLLISION_GRID_HEADER__
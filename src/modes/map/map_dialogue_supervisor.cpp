@@ -97,9 +97,31 @@ void MapDialogueSupervisor::AddDialogue(SpriteDialogue* dialogue)
         return;
     } else {
         _dialogues.insert(std::make_pair(dialogue->GetDialogueID(), dialogue));
+        _unprepared_dialogues.push_back(dialogue->GetDialogueID());
     }
 }
 
+void MapDialogueSupervisor::PrepareDialogues()
+{
+    for(size_t i = 0; i < _unprepared_dialogues.size(); ++i) {
+        SpriteDialogue* dialogue = GetDialogue(_unprepared_dialogues[i]);
+        if(dialogue == nullptr)
+            continue;
+
+        // Checks the dialogue once, looking up its events ahead of time.
+        dialogue->Validate();
+        _dialogue_window.PrepareDialogue(*dialogue);
+
+        // Upload the speaker portraits already decoded now rather than on the first lines.
+        for(uint32_t j = 0; j < dialogue->GetLineCount(); ++j) {
+            MapSprite* sprite = dialogue->GetLineSpeaker(j);
+            if(sprite != nullptr)
+                sprite->PrepareFacePortrait();
+        }
+    }
+    _unprepared_dialogues.clear();
+}
+
 void MapDialogueSupervisor::StartDialogue(const std::string& dialogue_id)
 {
     SpriteDialogue *dialogue = GetDialogue(dialogue_id);
@@ -158,11 +180,11 @@ void MapDialogueSupervisor::EndDialogue()
 
     map_mode->PopState();
 
-    std::string event_id = _current_dialogue->GetEventAtDialogueEnd();
-    if (!event_id.empty()) {
+    EventReference* end_event = _current_dialogue->GetEventReferenceAtDialogueEnd();
+    if (end_event != nullptr) {
         // Trigger the event after popping the map state, permitting
         // to set a scene state afterward, for instance.
-        map_mode->GetEventSupervisor()->StartEvent(event_id);
+        map_mode->GetEventSupervisor()->StartEvent(*end_event);
     }
 
     _current_dialogue = nullptr;
@@ -255,9 +277,9 @@ void MapDialogueSupervisor::_BeginLine()
 {
     // Starts possible events at new line.
     MapMode* map_mode = MapMode::CurrentInstance();
-    std::string line_event = _current_dialogue->GetLineBeginEvent(_line_counter);
-    if(!line_event.empty() && !map_mode->GetEventSupervisor()->IsEventActive(line_event)) {
-        map_mode->GetEventSupervisor()->StartEvent(line_event);
+    EventReference* line_event = _current_dialogue->GetLineBeginEvent(_line_counter);
+    if(line_event != nullptr && !map_mode->GetEventSupervisor()->IsEventActive(*line_event)) {
+        map_mode->GetEventSupervisor()->StartEvent(*line_event);
     }
 
     // The current speaker id
@@ -312,16 +334,16 @@ void MapDialogueSupervisor::_BeginLine()
 void MapDialogueSupervisor::_EndLine()
 {
     // Execute any scripted events that should occur after this line of dialogue has finished
-    std::string line_event = _current_dialogue->GetLineEndEvent(_line_counter);
-    if(!line_event.empty()) {
-        MapMode::CurrentInstance()->GetEventSupervisor()->StartEvent(line_event);
+    EventReference* line_event = _current_dialogue->GetLineEndEvent(_line_counter);
+    if(line_event != nullptr) {
+        MapMode::CurrentInstance()->GetEventSupervisor()->StartEvent(*line_event);
     }
 
     if(_current_options != nullptr) {
         uint32_t selected_option = _dialogue_window.GetDisplayOptionBox().GetSelection();
-        std::string selected_event = _current_options->GetOptionEvent(selected_option);
-        if(!selected_event.empty()) {
-            MapMode::CurrentInstance()->GetEventSupervisor()->StartEvent(selected_event);
+        EventReference* selected_event = _current_options->GetOptionEvent(selected_option);
+        if(selected_event != nullptr) {
+            MapMode::CurrentInstance()->GetEventSupervisor()->StartEvent(*selected_event);
         }
     }
 
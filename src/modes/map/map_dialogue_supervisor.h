@@ -54,6 +54,12 @@ public:
     **/
     void AddDialogue(SpriteDialogue *dialogue);
 
+    /** \brief Lays the lines of the dialogues added since the last call out ahead of time
+    *** This is to be called once the mode scripts are loaded, since the dialogue lines are
+    *** only added after the dialogue itself.
+    **/
+    void PrepareDialogues();
+
     /** \brief Prepares the dialogue manager to begin processing a new dialogue
     *** \param dialogue_id The id number of the dialogue to begin
     **/
@@ -121,6 +127,9 @@ private:
     //! \brief Holds the text and graphics that should be displayed for the dialogue
     vt_common::DialogueWindow _dialogue_window;
 
+    //! \brief The ids of the dialogues added but not prepared yet
+    std::vector<std::string> _unprepared_dialogues;
+
     //! \brief Keeps in memory whether the emote event has been triggered.
     bool _emote_triggered;
 
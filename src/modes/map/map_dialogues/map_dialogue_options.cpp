@@ -34,14 +34,14 @@ void MapDialogueOptions::AddOptionEvent(const std::string &text, const std::stri
 void MapDialogueOptions::AddOptionEvent(const std::string &text, int32_t next_line, const std::string &event_id)
 {
     DialogueOptions::AddOption(text, next_line);
-    _events.push_back(event_id);
+    _events.push_back(EventReference(event_id));
 }
 
-std::string MapDialogueOptions::GetOptionEvent(uint32_t option) const
+EventReference* MapDialogueOptions::GetOptionEvent(uint32_t option)
 {
-    if (option >= GetNumberOptions())
-        return std::string();
-    return _events[option];
+    if (option >= GetNumberOptions() || _events[option].IsEmpty())
+        return nullptr;
+    return &_events[option];
 }
 
 } // namespace private_map
@@ -13,6 +13,8 @@
 
 #include "common/dialogue.h"
 
+#include "modes/map/map_utils.h"
+
 namespace vt_map
 {
 
@@ -69,8 +71,8 @@ public:
     **/
     void AddOptionEvent(const std::string &text, int32_t next_line, const std::string &event_id);
 
-    //! \name Methods for retrieving properties of a specific line
-    std::string GetOptionEvent(uint32_t option) const;
+    //! \brief Returns the event to start when the option is selected, or nullptr if there is none.
+    EventReference* GetOptionEvent(uint32_t option);
 
     //! \brief Returns the number of options stored by this class
     uint32_t GetNumberOptions() const {
@@ -79,7 +81,7 @@ public:
 
 private:
     //! \brief An optional MapEvent that may occur as a result of selecting each option
-    std::vector<std::string> _events;
+    std::vector<EventReference> _events;
 };
 
 } // namespace private_map
@@ -15,6 +15,7 @@
 #include "modes/map/map_dialogues/map_dialogue_options.h"
 #include "modes/map/map_sprites/map_sprite.h"
 #include "modes/map/map_mode.h"
+#include "modes/map/map_object_supervisor.h"
 
 #include "common/global/global.h"
 
@@ -49,10 +50,24 @@ SpriteDialogue::SpriteDialogue(const std::string& dialogue_event_name) :
     if (seen > 0)
         _dialogue_seen = true;
 
+    // Keeps the seen state, and the sprites dialogue icons, up to date when the event is changed elsewhere.
+    MapMode* map_mode = MapMode::CurrentInstance();
+    vt_global::GlobalManager->GetGameEvents().WatchEvent("dialogues", _event_name, this,
+                                                         [this, map_mode](int32_t value) {
+        _dialogue_seen = (value > 0);
+        map_mode->GetObjectSupervisor()->UpdateSpritesDialogueStatus(GetDialogueID());
+    });
+
     // Auto-registers the dialogue for later deletion handling.
     MapMode::CurrentInstance()->GetDialogueSupervisor()->AddDialogue(this);
 }
 
+SpriteDialogue::~SpriteDialogue()
+{
+    if (!_event_name.empty())
+        vt_global::GlobalManager->GetGameEvents().UnwatchEvents(this);
+}
+
 SpriteDialogue* SpriteDialogue::Create()
 {
     // The object auto register to the object supervisor
@@ -160,8 +175,8 @@ void SpriteDialogue::AddLineTimedEvent(const std::string &text, MapSprite *speak
 {
     Dialogue::AddLineTimed(text, next_line, display_time);
     _speakers.push_back(speaker);
-    _begin_events.push_back(begin_event_id);
-    _end_events.push_back(end_event_id);
+    _begin_events.push_back(EventReference(begin_event_id));
+    _end_events.push_back(EventReference(end_event_id));
     _emote_events.push_back(emote_id);
 }
 
@@ -206,24 +221,32 @@ bool SpriteDialogue::Validate()
         return false;
     }
 
-    // Construct containers that hold all unique sprite and event ids for this dialogue
-    std::set<std::string> event_ids;
+    // Look up all the events referenced, which checks they exist.
+    std::vector<EventReference*> events;
     for(uint32_t i = 0; i < _line_count; i++) {
-        event_ids.insert(_end_events[i]);
+        events.push_back(GetLineBeginEvent(i));
+        events.push_back(GetLineEndEvent(i));
+
+        MapDialogueOptions* options = dynamic_cast<MapDialogueOptions*>(_options[i]);
+        for(uint32_t j = 0; options != nullptr && j < options->GetNumberOptions(); ++j)
+            events.push_back(options->GetOptionEvent(j));
     }
+    events.push_back(GetEventReferenceAtDialogueEnd());
 
-    for(std::set<std::string>::iterator it = event_ids.begin(); it != event_ids.end(); ++it) {
-        if((*it).empty())
+    bool valid = true;
+    EventSupervisor* event_supervisor = MapMode::CurrentInstance()->GetEventSupervisor();
+    for(uint32_t i = 0; i < events.size(); ++i) {
+        if(events[i] == nullptr)
             continue;
 
-        if(MapMode::CurrentInstance()->GetEventSupervisor()->GetEvent(*it) == nullptr) {
+        if(event_supervisor->GetEvent(*events[i]) == nullptr) {
             IF_PRINT_WARNING(MAP_DEBUG) << "Validation failed for dialogue #" << _dialogue_id
-                                        << ": dialogue referenced invalid event with id: " << *it << std::endl;
-            return false;
+                                        << ": dialogue referenced invalid event with id: " << events[i]->event_id << std::endl;
+            valid = false;
         }
     }
 
-    return true;
+    return valid;
 }
 
 } // namespace private_map
@@ -13,6 +13,8 @@
 
 #include "common/dialogue.h"
 
+#include "modes/map/map_utils.h"
+
 namespace vt_map
 {
 
@@ -37,9 +39,7 @@ public:
     //! If empty, the event is not stored.
     explicit SpriteDialogue(const std::string& dialogue_event_name);
 
-    virtual ~SpriteDialogue() override
-    {
-    }
+    virtual ~SpriteDialogue() override;
 
     //! \brief A C++ wrapper made to create a new object from scripting,
     //! without letting Lua handling the object life-cycle.
@@ -196,6 +196,7 @@ public:
     *** \note This function should not be called until after all map sprites have been added. The function checks that each
     *** speaker is valid and stored in the map's object list, so if you perform this check before you've added all the speakers
     *** to the object list of MapMode, the validation will fail.
+    *** The events referenced are looked up at the same time, so that the lines don't look their IDs up when shown.
     **/
     bool Validate();
 
@@ -207,16 +208,16 @@ public:
         else return _speakers[line];
     }
 
-    //! \brief Returns the ID of the event to execute for the line specified (or zero if the line index was invalid)
-    std::string GetLineEndEvent(uint32_t line) const {
-        if(line >= _line_count) return std::string();
-        else return _end_events[line];
+    //! \brief Returns the event to start after the line specified (or nullptr if none, or if the line index was invalid)
+    EventReference* GetLineEndEvent(uint32_t line) {
+        if(line >= _line_count || _end_events[line].IsEmpty()) return nullptr;
+        else return &_end_events[line];
     }
 
-    //! \brief Returns the ID of the event to execute for the line specified (or zero if the line index was invalid)
-    std::string GetLineBeginEvent(uint32_t line) const {
-        if(line >= _line_count) return std::string();
-        else return _begin_events[line];
+    //! \brief Returns the event to start when the line specified begins (or nullptr if none, or if the line index was invalid)
+    EventReference* GetLineBeginEvent(uint32_t line) {
+        if(line >= _line_count || _begin_events[line].IsEmpty()) return nullptr;
+        else return &_begin_events[line];
     }
 
     std::string GetLineEmote(uint32_t line) const {
@@ -248,11 +249,16 @@ public:
     }
 
     void SetEventAtDialogueEnd(const std::string& event_id) {
-        _event_after_dialogue_end = event_id;
+        _event_after_dialogue_end = EventReference(event_id);
     }
 
     const std::string& GetEventAtDialogueEnd() const {
-        return _event_after_dialogue_end;
+        return _event_after_dialogue_end.event_id;
+    }
+
+    //! \brief Returns the event to start after the dialogue's end, or nullptr if there is none.
+    EventReference* GetEventReferenceAtDialogueEnd() {
+        return _event_after_dialogue_end.IsEmpty() ? nullptr : &_event_after_dialogue_end;
     }
     //@}
 
@@ -275,17 +281,17 @@ private:
     std::vector<MapSprite*> _speakers;
 
     //! \brief An optional MapEvent that may occur when a line begins
-    std::vector<std::string> _begin_events;
+    std::vector<EventReference> _begin_events;
 
     //! \brief An optional MapEvent that may occur after each line is completed
-    std::vector<std::string> _end_events;
+    std::vector<EventReference> _end_events;
 
     //! \brief the emote to play on the speaker sprite before starting the line (and if possible).
     std::vector<std::string> _emote_events;
 
     //! \brief The optional event id to trigger after dialogue's end.
     //! This is handly to trigger other scene events after a dialogue.
-    std::string _event_after_dialogue_end;
+    EventReference _event_after_dialogue_end;
 };
 
 } // namespace private_map
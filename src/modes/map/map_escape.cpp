@@ -161,11 +161,14 @@ void EscapeSupervisor::Finish()
     // Escape to given map coordinates.
     vt_audio::AudioManager->PlaySound("data/sounds/warp.ogg");
     vt_global::GlobalManager->GetMapData().SetPreviousLocation(std::string());
-    MapMode* MM = new MapMode(_map_location.GetMapDataFilename(),
-                              _map_location.GetMapScriptFilename(),
-                              MapMode::CurrentInstance()->GetStamina());
+    // The map is only loaded once faded out, so that the fade stays smooth.
+    const std::string map_data_filename = _map_location.GetMapDataFilename();
+    const std::string map_script_filename = _map_location.GetMapScriptFilename();
+    const uint32_t stamina = MapMode::CurrentInstance()->GetStamina();
     vt_mode_manager::ModeManager->Pop();
-    vt_mode_manager::ModeManager->Push(MM, true, true);
+    vt_mode_manager::ModeManager->Push([map_data_filename, map_script_filename, stamina]() {
+        return static_cast<vt_mode_manager::GameMode*>(new MapMode(map_data_filename, map_script_filename, stamina));
+    }, MapMode::StartLoading(map_data_filename, map_script_filename), true, true);
 }
 
 bool EscapeSupervisor::_LoadMapLocationPreview()
@@ -15,6 +15,8 @@
 
 #include "engine/system.h"
 
+#include <algorithm>
+
 namespace vt_map
 {
 
@@ -25,8 +27,10 @@ EventSupervisor::~EventSupervisor()
 {
     _active_events.clear();
     _paused_events.clear();
-    _active_delayed_events.clear();
     _paused_delayed_events.clear();
+    _transition_events.clear();
+    _ended_events.clear();
+    _events.clear();
 
     for(std::map<std::string, MapEvent *>::iterator it = _all_events.begin(); it != _all_events.end(); ++it) {
         delete it->second;
@@ -47,6 +51,19 @@ void EventSupervisor::StartEvent(const std::string &event_id)
     StartEvent(event);
 }
 
+void EventSupervisor::StartEvent(EventReference &reference)
+{
+    MapEvent *event = GetEvent(reference);
+    if(event == nullptr) {
+        PRINT_WARNING << "No event with this ID existed: '" << reference.event_id
+            << "' in map script: "
+            << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
+    }
+
+    StartEvent(event);
+}
+
 void EventSupervisor::StartEvent(const std::string &event_id, uint32_t launch_time)
 {
     MapEvent *event = GetEvent(event_id);
@@ -57,10 +74,7 @@ void EventSupervisor::StartEvent(const std::string &event_id, uint32_t launch_ti
         return;
     }
 
-    if(launch_time == 0)
-        StartEvent(event);
-    else
-        _active_delayed_events.push_back(std::make_pair(static_cast<int32_t>(launch_time), event));
+    StartEvent(event, launch_time);
 }
 
 void EventSupervisor::StartEvent(MapEvent *event, uint32_t launch_time)
@@ -74,7 +88,7 @@ void EventSupervisor::StartEvent(MapEvent *event, uint32_t launch_time)
     if(launch_time == 0)
         StartEvent(event);
     else
-        _active_delayed_events.push_back(std::make_pair(static_cast<int32_t>(launch_time), event));
+        _delayed_events.Add(event, launch_time);
 }
 
 void EventSupervisor::StartEvent(MapEvent *event)
@@ -93,18 +107,16 @@ void EventSupervisor::StartEvent(MapEvent *event)
         return;
     }
 
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end(); ++it) {
-        if((*it) == event) {
-            IF_PRINT_WARNING(MAP_DEBUG) << "The event: '" << event->GetEventID()
-                          << "' is already active and can be active only once at a time. "
-                          << "The StartEvent() call will be ignored."
-                          << std::endl << " You should fix the map script: "
-                          << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
-            return;
-        }
+    if(event->_active_index >= 0) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "The event: '" << event->GetEventID()
+                      << "' is already active and can be active only once at a time. "
+                      << "The StartEvent() call will be ignored."
+                      << std::endl << " You should fix the map script: "
+                      << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+        return;
     }
 
-    _active_events.push_back(event);
+    _AddActiveEvent(event);
     event->_Start();
     _ExamineEventLinks(event, true);
 }
@@ -120,26 +132,18 @@ void EventSupervisor::PauseEvent(const std::string &event_id)
         return;
     }
 
-    // Search for active ones
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        if((*it)->_event_id == event_id) {
-            _paused_events.push_back(*it);
-            it = _active_events.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    MapEvent *event = GetEvent(event_id);
+    if(event == nullptr)
+        return;
 
-    // and for the delayed ones
-    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        if((*it).second->_event_id == event_id) {
-            _paused_delayed_events.push_back(*it);
-            it = _active_delayed_events.erase(it);
-        } else {
-            ++it;
-        }
+    // Pause the active one
+    if(event->_active_index >= 0) {
+        _paused_events.push_back(event);
+        _RemoveActiveEvent(event);
     }
+
+    // and the delayed ones
+    _PauseDelayedEvent(event);
 }
 
 void EventSupervisor::PauseAllEvents(VirtualSprite *sprite)
@@ -158,26 +162,24 @@ void EventSupervisor::PauseAllEvents(VirtualSprite *sprite)
     }
 
     // Starting by active ones.
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        SpriteEvent *event = dynamic_cast<SpriteEvent *>(*it);
+    for(uint32_t i = 0; i < _active_events.size();) {
+        SpriteEvent *event = dynamic_cast<SpriteEvent *>(_active_events[i]);
         if(event && event->GetSprite() == sprite) {
-            _paused_events.push_back(*it);
-            it = _active_events.erase(it);
+            _paused_events.push_back(event);
+            // The last active event takes its place.
+            _RemoveActiveEvent(event);
         } else {
-            ++it;
+            ++i;
         }
     }
 
     // Looking at incoming ones.
-    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        SpriteEvent *event = dynamic_cast<SpriteEvent *>((*it).second);
-        if(event && event->GetSprite() == sprite) {
-            _paused_delayed_events.push_back(*it);
-            it = _active_delayed_events.erase(it);
-        } else {
-            ++it;
-        }
+    std::vector<MapEvent *> delayed_events;
+    _delayed_events.GetEvents(delayed_events);
+    for(uint32_t i = 0; i < delayed_events.size(); ++i) {
+        SpriteEvent *event = dynamic_cast<SpriteEvent *>(delayed_events[i]);
+        if(event && event->GetSprite() == sprite)
+            _PauseDelayedEvent(event);
     }
 }
 
@@ -192,10 +194,15 @@ void EventSupervisor::ResumeEvent(const std::string &event_id)
         return;
     }
 
+    MapEvent *event = GetEvent(event_id);
+    if(event == nullptr)
+        return;
+
     for(std::vector<MapEvent *>::iterator it = _paused_events.begin();
             it != _paused_events.end();) {
-        if((*it)->_event_id == event_id) {
-            _active_events.push_back(*it);
+        if(*it == event) {
+            if(event->_active_index < 0)
+                _AddActiveEvent(event);
             it = _paused_events.erase(it);
         } else {
             ++it;
@@ -203,15 +210,7 @@ void EventSupervisor::ResumeEvent(const std::string &event_id)
     }
 
     // and the delayed ones
-    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _paused_delayed_events.begin();
-            it != _paused_delayed_events.end();) {
-        if((*it).second->_event_id == event_id) {
-            _active_delayed_events.push_back(*it);
-            it = _paused_delayed_events.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    _ResumeDelayedEvent(event);
 }
 
 void EventSupervisor::ResumeAllEvents(VirtualSprite *sprite)
@@ -233,7 +232,8 @@ void EventSupervisor::ResumeAllEvents(VirtualSprite *sprite)
     for(std::vector<MapEvent *>::iterator it = _paused_events.begin(); it != _paused_events.end();) {
         SpriteEvent *event = dynamic_cast<SpriteEvent *>(*it);
         if(event && event->GetSprite() == sprite) {
-            _active_events.push_back(*it);
+            if(event->_active_index < 0)
+                _AddActiveEvent(event);
             it = _paused_events.erase(it);
         } else {
             ++it;
@@ -245,7 +245,7 @@ void EventSupervisor::ResumeAllEvents(VirtualSprite *sprite)
             it != _paused_delayed_events.end();) {
         SpriteEvent *event = dynamic_cast<SpriteEvent *>((*it).second);
         if(event && event->GetSprite() == sprite) {
-            _active_delayed_events.push_back(*it);
+            _delayed_events.Add(event, static_cast<uint32_t>((*it).first));
             it = _paused_delayed_events.erase(it);
         } else {
             ++it;
@@ -266,52 +266,47 @@ void EventSupervisor::EndEvent(const std::string &event_id, bool trigger_event_l
         return;
     }
 
-    // Starting by active ones.
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        if((*it)->_event_id == event_id) {
-            SpriteEvent *sprite_event = dynamic_cast<SpriteEvent *>(*it);
-            // Terminated sprite events need to release their owned sprite.
-            if(sprite_event)
-                sprite_event->Terminate();
+    MapEvent *event = GetEvent(event_id);
+    if(event == nullptr)
+        return;
 
-            MapEvent *terminated_event = *it;
-            it = _active_events.erase(it);
-            // We examine the event links only after the event has been removed from the active list
-            if(trigger_event_links)
-                _ExamineEventLinks(terminated_event, false);
-        } else {
-            ++it;
-        }
-    }
+    // Whether the event was launched, now or later.
+    bool ended = false;
 
-    // Looking at incoming ones.
-    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        if((*it).second->_event_id == event_id) {
-            MapEvent *terminated_event = (*it).second;
-            it = _active_delayed_events.erase(it);
+    // Starting by the active one.
+    if(event->_active_index >= 0) {
+        ended = true;
+        SpriteEvent *sprite_event = dynamic_cast<SpriteEvent *>(event);
+        // Terminated sprite events need to release their owned sprite.
+        if(sprite_event)
+            sprite_event->Terminate();
 
-            // We examine the event links only after the event has been removed from the active list
-            if(trigger_event_links)
-                _ExamineEventLinks(terminated_event, false);
-        } else {
-            ++it;
-        }
+        _RemoveActiveEvent(event);
+        // We examine the event links only after the event has been removed from the active list
+        if(trigger_event_links)
+            _ExamineEventLinks(event, false);
     }
 
+    // Looking at incoming ones.
+    uint32_t delayed_count = _delayed_events.Remove(event);
+    if(delayed_count > 0)
+        ended = true;
+    for(uint32_t i = 0; i < delayed_count && trigger_event_links; ++i)
+        _ExamineEventLinks(event, false);
+
     // And paused ones
     for(std::vector<MapEvent *>::iterator it = _paused_events.begin(); it != _paused_events.end();) {
-        if((*it)->_event_id == event_id) {
+        if(*it == event) {
+            ended = true;
             SpriteEvent *sprite_event = dynamic_cast<SpriteEvent *>(*it);
             // Paused sprite events need to release their owned sprite as they have been previously started.
             if(sprite_event)
                 sprite_event->Terminate();
 
-            MapEvent *terminated_event = *it;
             it = _paused_events.erase(it);
             // We examine the event links only after the event has been removed from the list
             if(trigger_event_links)
-                _ExamineEventLinks(terminated_event, false);
+                _ExamineEventLinks(event, false);
         } else {
             ++it;
         }
@@ -319,17 +314,20 @@ void EventSupervisor::EndEvent(const std::string &event_id, bool trigger_event_l
 
     for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _paused_delayed_events.begin();
             it != _paused_delayed_events.end();) {
-        if((*it).second->_event_id == event_id) {
-            MapEvent *terminated_event = (*it).second;
+        if((*it).second == event) {
+            ended = true;
             it = _paused_delayed_events.erase(it);
 
             // We examine the event links only after the event has been removed from the list
             if(trigger_event_links)
-                _ExamineEventLinks(terminated_event, false);
+                _ExamineEventLinks(event, false);
         } else {
             ++it;
         }
     }
+
+    if(ended)
+        _AddEndedEvent(event);
 }
 
 void EventSupervisor::EndEvent(MapEvent *event, bool trigger_event_links)
@@ -367,26 +365,26 @@ void EventSupervisor::EndAllEvents(VirtualSprite *sprite)
     }
 
     // Starting by active ones.
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        SpriteEvent *event = dynamic_cast<SpriteEvent *>(*it);
+    for(uint32_t i = 0; i < _active_events.size();) {
+        SpriteEvent *event = dynamic_cast<SpriteEvent *>(_active_events[i]);
         if(event && event->GetSprite() == sprite) {
             // Active events need to release their owned sprite upon termination.
             event->Terminate();
 
-            it = _active_events.erase(it);
+            // The last active event takes its place.
+            _RemoveActiveEvent(event);
         } else {
-            ++it;
+            ++i;
         }
     }
 
     // Looking at incoming ones.
-    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        SpriteEvent *event = dynamic_cast<SpriteEvent *>((*it).second);
+    std::vector<MapEvent *> delayed_events;
+    _delayed_events.GetEvents(delayed_events);
+    for(uint32_t i = 0; i < delayed_events.size(); ++i) {
+        SpriteEvent *event = dynamic_cast<SpriteEvent *>(delayed_events[i]);
         if(event && event->GetSprite() == sprite)
-            it = _active_delayed_events.erase(it);
-        else
-            ++it;
+            _delayed_events.Remove(event);
     }
 
     // And paused ones
@@ -417,24 +415,8 @@ void EventSupervisor::Update()
     // Store the events that became active in the delayed event loop.
     std::vector<MapEvent *> events_to_start;
 
-    // Update all launch event timers and start all events whose timers have finished
-    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _active_delayed_events.begin();
-            it != _active_delayed_events.end();) {
-        it->first -= vt_system::SystemManager->GetUpdateTime();
-
-        if(it->first <= 0) {  // Timer has expired
-            MapEvent *start_event = it->second;
-            it = _active_delayed_events.erase(it);
-
-            // We add the event ready to start i a vector, waiting for the loop to end
-            // before starting it.
-            events_to_start.push_back(start_event);
-        } else {
-            ++it;
-        }
-    }
-
-    // Starts the events that became active.
+    // Update the launch timers, and start all events whose timers have finished
+    _delayed_events.Advance(vt_system::SystemManager->GetUpdateTime(), events_to_start);
     for(std::vector<MapEvent *>::iterator it = events_to_start.begin(); it != events_to_start.end(); ++it)
         StartEvent(*it);
 
@@ -445,15 +427,16 @@ void EventSupervisor::Update()
     _is_updating = true;
 
     // Check for active events which have finished
-    for(std::vector<MapEvent *>::iterator it = _active_events.begin(); it != _active_events.end();) {
-        if((*it)->_Update()) {
+    for(uint32_t i = 0; i < _active_events.size();) {
+        MapEvent *event = _active_events[i];
+        if(event->_Update()) {
             // Add it ot the finished events list
-            finished_events.push_back(*it);
+            finished_events.push_back(event);
 
-            // Remove the finished event from the active queue.
-            it = _active_events.erase(it);
+            // Remove the finished event from the active queue, the last active event taking its place.
+            _RemoveActiveEvent(event);
         } else {
-            ++it;
+            ++i;
         }
     }
 
@@ -463,17 +446,45 @@ void EventSupervisor::Update()
     // and the active list has finished parsing, to avoid a crash when adding a new event within the update loop.
     for(std::vector<MapEvent *>::iterator it = finished_events.begin(); it != finished_events.end(); ++it) {
         _ExamineEventLinks(*it, false);
+        _AddEndedEvent(*it);
     }
+
+    _RecycleEndedEvents();
+
+    // Prefetch the maps the camera is getting near to.
+    for(uint32_t i = 0; i < _transition_events.size(); ++i)
+        _transition_events[i]->UpdatePrefetch();
 }
 
 bool EventSupervisor::IsEventActive(const std::string &event_id) const
 {
-    for(std::vector<MapEvent *>::const_iterator it = _active_events.begin(); it != _active_events.end(); ++it) {
-        if((*it)->_event_id == event_id) {
-            return true;
-        }
+    MapEvent *event = GetEvent(event_id);
+    return event != nullptr && event->_active_index >= 0;
+}
+
+bool EventSupervisor::IsEventActive(EventReference &reference) const
+{
+    MapEvent *event = GetEvent(reference);
+    return event != nullptr && event->_active_index >= 0;
+}
+
+MapEvent *EventSupervisor::GetEvent(EventReference &reference) const
+{
+    if(reference.event_id.empty())
+        return nullptr;
+
+    // The event may have been recycled since, the ID then being looked up again.
+    if(reference.event_index >= 0 && _events[reference.event_index] == nullptr)
+        reference.event_index = -1;
+
+    if(reference.event_index < 0) {
+        MapEvent *event = GetEvent(reference.event_id);
+        if(event == nullptr || event->_event_index < 0)
+            return event;
+        reference.event_index = event->_event_index;
     }
-    return false;
+
+    return _events[reference.event_index];
 }
 
 MapEvent *EventSupervisor::GetEvent(const std::string &event_id) const
@@ -502,6 +513,10 @@ bool EventSupervisor::_RegisterEvent(MapEvent* new_event)
     }
 
     _all_events.insert(std::make_pair(new_event->_event_id, new_event));
+    new_event->_event_index = _events.size();
+    _events.push_back(new_event);
+    if(new_event->GetEventType() == MAP_TRANSITION_EVENT)
+        _transition_events.push_back(static_cast<MapTransitionEvent*>(new_event));
     return true;
 }
 
@@ -510,27 +525,121 @@ void EventSupervisor::_ExamineEventLinks(MapEvent *parent_event, bool event_star
     for(uint32_t i = 0; i < parent_event->_event_links.size(); ++i) {
         EventLink &link = parent_event->_event_links[i];
 
-        // Case 1: Start/finish launch member is not equal to the start/finish status of the parent event, so ignore this link
-        if(link.launch_at_start != event_start) {
+        // Start/finish launch member is not equal to the start/finish status of the parent event, so ignore this link
+        if(link.launch_at_start != event_start)
+            continue;
+
+        MapEvent *child = _GetLinkedEvent(parent_event, link);
+        if(child == nullptr)
             continue;
+
+        // The child event is launched immediately, or placed in the event launch timers.
+        StartEvent(child, link.launch_timer);
+    }
+}
+
+MapEvent *EventSupervisor::_GetLinkedEvent(MapEvent *parent_event, EventLink &link)
+{
+    // The child may have been recycled since, the ID then being looked up again.
+    if(link.child_event_index >= 0 && _events[link.child_event_index] == nullptr)
+        link.child_event_index = -1;
+
+    // The child may be created after the link, so its index is only known once launched.
+    if(link.child_event_index < 0) {
+        MapEvent *child = GetEvent(link.child_event_id);
+        if(child == nullptr) {
+            PRINT_WARNING << "Couldn't launch child event, no event with this ID existed: '"
+                          << link.child_event_id << "' from parent event ID: '"
+                          << parent_event->GetEventID()
+                          << "' in map script: "
+                          << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
+            return nullptr;
         }
-        // Case 2: The child event is to be launched immediately
-        else if(link.launch_timer == 0) {
-            StartEvent(link.child_event_id);
+        link.child_event_index = child->_event_index;
+    }
+
+    return _events[link.child_event_index];
+}
+
+void EventSupervisor::_AddActiveEvent(MapEvent *event)
+{
+    event->_active_index = _active_events.size();
+    _active_events.push_back(event);
+}
+
+void EventSupervisor::_RemoveActiveEvent(MapEvent *event)
+{
+    if(event->_active_index < 0)
+        return;
+
+    MapEvent *last_event = _active_events.back();
+    _active_events[event->_active_index] = last_event;
+    last_event->_active_index = event->_active_index;
+    _active_events.pop_back();
+    event->_active_index = -1;
+}
+
+void EventSupervisor::_AddEndedEvent(MapEvent *event)
+{
+    // Unregistered events can't be told apart from the registered ones with the same ID.
+    if(!event->_recycled_on_end || event->_event_index < 0)
+        return;
+
+    if(std::find(_ended_events.begin(), _ended_events.end(), event) == _ended_events.end())
+        _ended_events.push_back(event);
+}
+
+void EventSupervisor::_RecycleEndedEvents()
+{
+    for(uint32_t i = 0; i < _ended_events.size(); ++i) {
+        MapEvent *event = _ended_events[i];
+
+        // The event links may have launched the event again.
+        if(event->_active_index >= 0 || _delayed_events.HasTimer(event))
+            continue;
+        if(std::find(_paused_events.begin(), _paused_events.end(), event) != _paused_events.end())
+            continue;
+        bool paused_delayed = false;
+        for(uint32_t j = 0; j < _paused_delayed_events.size() && !paused_delayed; ++j)
+            paused_delayed = (_paused_delayed_events[j].second == event);
+        if(paused_delayed)
+            continue;
+
+        // Sprite events not releasing their sprite once finished still control it.
+        SpriteEvent *sprite_event = dynamic_cast<SpriteEvent *>(event);
+        if(sprite_event)
+            sprite_event->Terminate();
+
+        // The index isn't reused, so that the links to the event notice it is gone.
+        _all_events.erase(event->_event_id);
+        _events[event->_event_index] = nullptr;
+        if(event->GetEventType() == MAP_TRANSITION_EVENT) {
+            _transition_events.erase(std::remove(_transition_events.begin(), _transition_events.end(),
+                                                 static_cast<MapTransitionEvent *>(event)),
+                                     _transition_events.end());
         }
-        // Case 3: The child event has a timer associated with it and needs to be placed in the event launch container
-        else {
-            MapEvent *child = GetEvent(link.child_event_id);
-            if(child == nullptr) {
-                PRINT_WARNING << "Couldn't launch child event, no event with this ID existed: '"
-                              << link.child_event_id << "' from parent event ID: '"
-                              << parent_event->GetEventID()
-                              << "' in map script: "
-                              << MapMode::CurrentInstance()->GetMapScriptFilename() << std::endl;
-                continue;
-            } else {
-                _active_delayed_events.push_back(std::make_pair(static_cast<int32_t>(link.launch_timer), child));
-            }
+        delete event;
+    }
+    _ended_events.clear();
+}
+
+void EventSupervisor::_PauseDelayedEvent(MapEvent *event)
+{
+    std::vector<uint32_t> remaining_times;
+    _delayed_events.Remove(event, &remaining_times);
+    for(uint32_t i = 0; i < remaining_times.size(); ++i)
+        _paused_delayed_events.push_back(std::make_pair(static_cast<int32_t>(remaining_times[i]), event));
+}
+
+void EventSupervisor::_ResumeDelayedEvent(MapEvent *event)
+{
+    for(std::vector<std::pair<int32_t, MapEvent *> >::iterator it = _paused_delayed_events.begin();
+            it != _paused_delayed_events.end();) {
+        if((*it).second == event) {
+            _delayed_events.Add(event, static_cast<uint32_t>((*it).first));
+            it = _paused_delayed_events.erase(it);
+        } else {
+            ++it;
         }
     }
 }
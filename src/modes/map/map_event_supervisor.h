@@ -11,6 +11,7 @@
 #ifndef __MAP_EVENT_SUPERVISOR_HEADER__
 #define __MAP_EVENT_SUPERVISOR_HEADER__
 
+#include "modes/map/map_event_timer_wheel.h"
 #include "modes/map/map_events.h"
 
 namespace vt_map
@@ -69,6 +70,9 @@ public:
     void StartEvent(MapEvent* event);
     void StartEvent(MapEvent* event, uint32_t launch_time);
 
+    //! \brief Starts the event referenced, looking its ID up only the first time.
+    void StartEvent(EventReference& reference);
+
     /** \brief Pauses the active events by preventing them from updating
     *** \param event_id The ID of the active event(s) to pause
     *** If the event corresponding to the ID is not active, a warning will be issued and no change
@@ -118,6 +122,7 @@ public:
     *** \return True if the event is active, false if it is not or the event could not be found
     **/
     bool IsEventActive(const std::string& event_id) const;
+    bool IsEventActive(EventReference& reference) const;
 
     //! \brief Returns true if any events are active
     bool HasActiveEvent() const {
@@ -126,7 +131,7 @@ public:
 
     //! \brief Returns true if any events are being prepared to be launched after their timers expire
     bool HasActiveDelayedEvent() const {
-        return !_active_delayed_events.empty();
+        return _delayed_events.GetTimerCount() > 0;
     }
 
     /** \brief Returns a pointer to a specified event stored by this class
@@ -135,6 +140,12 @@ public:
     **/
     MapEvent* GetEvent(const std::string& event_id) const;
 
+    /** \brief Returns the event referenced, looking its ID up only when its index isn't known yet,
+    *** or when the event has been recycled since.
+    *** \return The event, or nullptr if no event has the referenced ID.
+    **/
+    MapEvent* GetEvent(EventReference& reference) const;
+
     bool DoesEventExist(const std::string& event_id) const
     { return !(GetEvent(event_id) == nullptr); }
 
@@ -142,16 +153,19 @@ private:
     //! \brief A container for all map events, where the event's ID serves as the key to the std::map
     std::map<std::string, MapEvent*> _all_events;
 
-    //! \brief A list of all events which have started but are not yet finished
+    //! \brief All the map events, indexed by their interned ID: MapEvent::_event_index
+    std::vector<MapEvent*> _events;
+
+    /** \brief A list of all events which have started but are not yet finished
+    *** The order isn't kept, so that an event is removed by swapping it with the last one.
+    **/
     std::vector<MapEvent*> _active_events;
 
     //! \brief A list of all events which have been paused
     std::vector<MapEvent*> _paused_events;
 
-    /** \brief A list of all events that are waiting on their launch timers to expire before being started
-    *** The interger part of this std::pair is the countdown timer for this event to be launched
-    **/
-    std::vector<std::pair<int32_t, MapEvent*> > _active_delayed_events;
+    //! \brief The launch timers of all events that are waiting for them to expire before being started
+    EventTimerWheel _delayed_events;
 
     /** \brief A list of all events that are waiting on their launch timers to expire before being started
     *** The interger part of this std::pair is the countdown timer for this event to be launched
@@ -159,6 +173,12 @@ private:
     **/
     std::vector<std::pair<int32_t, MapEvent*> > _paused_delayed_events;
 
+    //! \brief The map transition events, whose destination may be prefetched.
+    std::vector<MapTransitionEvent*> _transition_events;
+
+    //! \brief The ended events to delete at the end of the update, unless launched again.
+    std::vector<MapEvent*> _ended_events;
+
     /** States whether the event supervisor is parsing the active events queue, thus any modifications
     *** there on active events should be avoided.
     **/
@@ -170,6 +190,25 @@ private:
     **/
     void _ExamineEventLinks(MapEvent* parent_event, bool event_start);
 
+    //! \brief Returns the child event of a link, looking it up from its ID only the first time.
+    MapEvent* _GetLinkedEvent(MapEvent* parent_event, EventLink& link);
+
+    //! \brief Adds an event to the active ones, or removes it by swapping it with the last one.
+    void _AddActiveEvent(MapEvent* event);
+    void _RemoveActiveEvent(MapEvent* event);
+
+    //! \brief Keeps an ended event to delete at the end of the update, when it is recycled on end.
+    void _AddEndedEvent(MapEvent* event);
+
+    /** \brief Deletes the ended events not launched again, so that the next events reuse their memory.
+    *** Their ID is unregistered, and the event links to them look up the ID again.
+    **/
+    void _RecycleEndedEvents();
+
+    //! \brief Moves the delayed launches of an event to the paused ones, or back, keeping their remaining time.
+    void _PauseDelayedEvent(MapEvent* event);
+    void _ResumeDelayedEvent(MapEvent* event);
+
     /** \brief Registers a map event object with the event supervisor
     *** \param new_event A pointer to the new event
     *** \return whether the event was successfully registered.
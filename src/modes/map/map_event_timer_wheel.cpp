@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_event_timer_wheel.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the timer wheel launching the delayed map events.
+*** ***************************************************************************/
+
+#include "modes/map/map_event_timer_wheel.h"
+
+#include <algorithm>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The number of bits of the time given by the slot of the first level, and of the next ones.
+const uint32_t TIMER_WHEEL_FIRST_LEVEL_BITS = 8;
+const uint32_t TIMER_WHEEL_LEVEL_BITS = 6;
+
+//! \brief The number of levels after the first one. They cover 32 bits delays all together.
+const uint32_t TIMER_WHEEL_NEXT_LEVELS = 4;
+
+const uint32_t TIMER_WHEEL_FIRST_LEVEL_SLOTS = 1 << TIMER_WHEEL_FIRST_LEVEL_BITS;
+const uint32_t TIMER_WHEEL_LEVEL_SLOTS = 1 << TIMER_WHEEL_LEVEL_BITS;
+
+//! \brief Returns the first slot of a level after the first one, starting from 1.
+static uint32_t _GetLevelOffset(uint32_t level)
+{
+    return TIMER_WHEEL_FIRST_LEVEL_SLOTS + (level - 1) * TIMER_WHEEL_LEVEL_SLOTS;
+}
+
+//! \brief Returns the position of the bits of the time given by the slot of a level after the first one.
+static uint32_t _GetLevelShift(uint32_t level)
+{
+    return TIMER_WHEEL_FIRST_LEVEL_BITS + (level - 1) * TIMER_WHEEL_LEVEL_BITS;
+}
+
+EventTimerWheel::EventTimerWheel() :
+    _current_time(0),
+    _sequence(0),
+    _free_timer(-1),
+    _timer_count(0),
+    _slots(_GetLevelOffset(TIMER_WHEEL_NEXT_LEVELS + 1), -1)
+{
+}
+
+void EventTimerWheel::Add(MapEvent* event, uint32_t delay)
+{
+    int32_t timer = _free_timer;
+    if(timer >= 0) {
+        _free_timer = _timers[timer].next;
+    } else {
+        timer = _timers.size();
+        _timers.push_back(_Timer());
+    }
+
+    // The current time has already been handled, so the timer can't expire before the next one.
+    _timers[timer].event = event;
+    _timers[timer].due_time = _current_time + std::max(delay, static_cast<uint32_t>(1));
+    _timers[timer].sequence = _sequence++;
+    _Insert(timer);
+    ++_timer_count;
+}
+
+void EventTimerWheel::Advance(uint32_t elapsed_time, std::vector<MapEvent*>& due_events)
+{
+    due_events.clear();
+
+    const uint64_t target_time = _current_time + elapsed_time;
+    std::vector<std::pair<uint64_t, int32_t> > expired_timers;
+    while(_current_time < target_time) {
+        // Without timers, the slots reached don't matter.
+        if(_timer_count == 0) {
+            _current_time = target_time;
+            break;
+        }
+
+        ++_current_time;
+
+        // Each time a level goes round, its next level slot timers get closer.
+        const uint32_t index = _current_time & (TIMER_WHEEL_FIRST_LEVEL_SLOTS - 1);
+        if(index == 0) {
+            for(uint32_t level = 1; level <= TIMER_WHEEL_NEXT_LEVELS; ++level) {
+                const uint32_t level_index = (_current_time >> _GetLevelShift(level)) & (TIMER_WHEEL_LEVEL_SLOTS - 1);
+                _Cascade(_GetLevelOffset(level) + level_index);
+                if(level_index != 0)
+                    break;
+            }
+        }
+
+        // Every timer of the first level slot is due now.
+        if(_slots[index] < 0)
+            continue;
+
+        expired_timers.clear();
+        for(int32_t timer = _slots[index]; timer >= 0; timer = _timers[timer].next)
+            expired_timers.push_back(std::make_pair(_timers[timer].sequence, timer));
+        std::sort(expired_timers.begin(), expired_timers.end());
+
+        for(uint32_t i = 0; i < expired_timers.size(); ++i) {
+            due_events.push_back(_timers[expired_timers[i].second].event);
+            _Release(expired_timers[i].second);
+        }
+    }
+}
+
+uint32_t EventTimerWheel::Remove(MapEvent* event, std::vector<uint32_t>* remaining_times)
+{
+    std::vector<std::pair<uint64_t, int32_t> > removed_timers;
+    for(uint32_t i = 0; i < _timers.size(); ++i) {
+        if(_timers[i].slot >= 0 && _timers[i].event == event)
+            removed_timers.push_back(std::make_pair(_timers[i].sequence, static_cast<int32_t>(i)));
+    }
+    std::sort(removed_timers.begin(), removed_timers.end());
+
+    for(uint32_t i = 0; i < removed_timers.size(); ++i) {
+        const int32_t timer = removed_timers[i].second;
+        if(remaining_times)
+            remaining_times->push_back(static_cast<uint32_t>(_timers[timer].due_time - _current_time));
+        _Release(timer);
+    }
+    return removed_timers.size();
+}
+
+void EventTimerWheel::GetEvents(std::vector<MapEvent*>& events) const
+{
+    events.clear();
+
+    std::vector<std::pair<uint64_t, MapEvent*> > timer_events;
+    for(uint32_t i = 0; i < _timers.size(); ++i) {
+        if(_timers[i].slot >= 0)
+            timer_events.push_back(std::make_pair(_timers[i].sequence, _timers[i].event));
+    }
+    std::sort(timer_events.begin(), timer_events.end());
+
+    for(uint32_t i = 0; i < timer_events.size(); ++i) {
+        if(std::find(events.begin(), events.end(), timer_events[i].second) == events.end())
+            events.push_back(timer_events[i].second);
+    }
+}
+
+bool EventTimerWheel::HasTimer(const MapEvent* event) const
+{
+    for(uint32_t i = 0; i < _timers.size(); ++i) {
+        if(_timers[i].slot >= 0 && _timers[i].event == event)
+            return true;
+    }
+    return false;
+}
+
+void EventTimerWheel::_Insert(int32_t timer)
+{
+    const uint64_t due_time = _timers[timer].due_time;
+    const uint64_t delay = due_time - _current_time;
+
+    // The first level slots are for the next milliseconds, one each.
+    uint32_t slot = due_time & (TIMER_WHEEL_FIRST_LEVEL_SLOTS - 1);
+    if(delay >= TIMER_WHEEL_FIRST_LEVEL_SLOTS) {
+        for(uint32_t level = 1; level <= TIMER_WHEEL_NEXT_LEVELS; ++level) {
+            const uint32_t shift = _GetLevelShift(level);
+            if(level == TIMER_WHEEL_NEXT_LEVELS || delay < (static_cast<uint64_t>(1) << (shift + TIMER_WHEEL_LEVEL_BITS))) {
+                slot = _GetLevelOffset(level) + ((due_time >> shift) & (TIMER_WHEEL_LEVEL_SLOTS - 1));
+                break;
+            }
+        }
+    }
+
+    _timers[timer].slot = slot;
+    _timers[timer].previous = -1;
+    _timers[timer].next = _slots[slot];
+    if(_slots[slot] >= 0)
+        _timers[_slots[slot]].previous = timer;
+    _slots[slot] = timer;
+}
+
+void EventTimerWheel::_Unlink(int32_t timer)
+{
+    _Timer& unlinked = _timers[timer];
+    if(unlinked.previous >= 0)
+        _timers[unlinked.previous].next = unlinked.next;
+    else
+        _slots[unlinked.slot] = unlinked.next;
+    if(unlinked.next >= 0)
+        _timers[unlinked.next].previous = unlinked.previous;
+}
+
+void EventTimerWheel::_Release(int32_t timer)
+{
+    _Unlink(timer);
+    _timers[timer].event = nullptr;
+    _timers[timer].slot = -1;
+    _timers[timer].next = _free_timer;
+    _free_timer = timer;
+    --_timer_count;
+}
+
+void EventTimerWheel::_Cascade(uint32_t slot)
+{
+    int32_t timer = _slots[slot];
+    _slots[slot] = -1;
+    while(timer >= 0) {
+        const int32_t next = _timers[timer].next;
+        _Insert(timer);
+        timer = next;
+    }
+}
+
+} // namespace private_map
+
+} // namespace vt_map
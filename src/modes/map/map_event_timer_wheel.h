@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_event_timer_wheel.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the timer wheel launching the delayed map events.
+***
+*** The delayed events are put in a hierarchical timer wheel: the first level
+*** has a slot per millisecond for the next 256 milliseconds, and each next
+*** level has 64 slots covering 64 times more time. The timers of a level slot
+*** are moved to the lower level when its time comes, so that advancing the
+*** time only looks at the slots actually reached, whatever the number of
+*** delayed events.
+*** ***************************************************************************/
+
+#ifndef __MAP_EVENT_TIMER_WHEEL_HEADER__
+#define __MAP_EVENT_TIMER_WHEEL_HEADER__
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+class MapEvent;
+
+/** ****************************************************************************
+*** \brief Launch timers of the delayed map events.
+***
+*** An event may have several timers at once. The timers are kept in a pool,
+*** linked in their slot list by index.
+*** ***************************************************************************/
+class EventTimerWheel
+{
+public:
+    EventTimerWheel();
+
+    //! \brief Adds a timer for the event, due after the given delay, in milliseconds.
+    void Add(MapEvent* event, uint32_t delay);
+
+    /** \brief Advances the time, and gives the events whose timers expired.
+    *** \param elapsed_time The time elapsed since the last call, in milliseconds.
+    *** \param due_events Filled with the events due, sorted by due time, then by insertion order.
+    **/
+    void Advance(uint32_t elapsed_time, std::vector<MapEvent*>& due_events);
+
+    /** \brief Removes every timer of an event.
+    *** \param remaining_times If not nullptr, filled with the time left before each removed timer expiration.
+    *** \return The number of timers removed.
+    **/
+    uint32_t Remove(MapEvent* event, std::vector<uint32_t>* remaining_times = nullptr);
+
+    //! \brief Gives the events with at least one timer, once each, in insertion order.
+    void GetEvents(std::vector<MapEvent*>& events) const;
+
+    //! \brief Tells whether the event has at least one timer.
+    bool HasTimer(const MapEvent* event) const;
+
+    //! \brief Returns the number of timers.
+    uint32_t GetTimerCount() const {
+        return _timer_count;
+    }
+
+private:
+    class _Timer
+    {
+    public:
+        MapEvent* event;
+
+        //! \brief The time when the timer expires, and its insertion number.
+        uint64_t due_time;
+        uint64_t sequence;
+
+        //! \brief The slot the timer is in, -1 when unused, and its neighbours in the slot list.
+        int32_t slot;
+        int32_t previous;
+        int32_t next;
+    };
+
+    //! \brief The current time, up to which the timers have expired.
+    uint64_t _current_time;
+
+    //! \brief The number of timers added so far, giving their insertion number.
+    uint64_t _sequence;
+
+    //! \brief The timer pool, and the first unused timer of the pool.
+    std::vector<_Timer> _timers;
+    int32_t _free_timer;
+    uint32_t _timer_count;
+
+    //! \brief The first timer of each slot list, -1 when empty. The levels are stored one after another.
+    std::vector<int32_t> _slots;
+
+    //! \brief Links a timer in the slot matching its due time.
+    void _Insert(int32_t timer);
+
+    //! \brief Unlinks a timer from its slot.
+    void _Unlink(int32_t timer);
+
+    //! \brief Unlinks a timer, and gives it back to the pool.
+    void _Release(int32_t timer);
+
+    //! \brief Moves the timers of a slot to the slots matching their due time, now closer.
+    void _Cascade(uint32_t slot);
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_EVENT_TIMER_WHEEL_HEADER__
@@ -23,13 +23,19 @@
 #include "modes/map/map_dialogues/map_sprite_dialogue.h"
 
 #include "modes/map/map_mode.h"
+#include "modes/map/map_prefetcher.h"
 #include "modes/map/map_sprites/map_sprite.h"
+#include "modes/map/map_zones.h"
 
 #include "modes/shop/shop.h"
 #include "modes/battle/battle.h"
 #include "modes/battle/transition_to_battle.h"
 #include "modes/battle/battle_enemy_info.h"
 
+#include "common/script_call_profiler.h"
+
+#include "engine/asset_manifest.h"
+
 using namespace vt_audio;
 using namespace vt_mode_manager;
 using namespace vt_script;
@@ -48,7 +54,10 @@ namespace private_map
 
 MapEvent::MapEvent(const std::string& id, EVENT_TYPE type):
     _event_id(id),
-    _event_type(type)
+    _event_type(type),
+    _event_index(-1),
+    _active_index(-1),
+    _recycled_on_end(false)
 {
     vt_map::MapMode* map_mode = MapMode::CurrentInstance();
     if (!map_mode) {
@@ -178,7 +187,8 @@ MapTransitionEvent::MapTransitionEvent(const std::string& event_id,
     _transition_map_data_filename(data_filename),
     _transition_map_script_filename(script_filename),
     _transition_origin(coming_from),
-    _done(false)
+    _prefetch_zone(nullptr),
+    _prefetched(false)
 {}
 
 MapTransitionEvent* MapTransitionEvent::Create(const std::string& event_id,
@@ -190,31 +200,40 @@ MapTransitionEvent* MapTransitionEvent::Create(const std::string& event_id,
                                   coming_from);
 }
 
+void MapTransitionEvent::UpdatePrefetch()
+{
+    if(_prefetched || _prefetch_zone == nullptr)
+        return;
+
+    VirtualSprite* camera = MapMode::CurrentInstance()->GetCamera();
+    if(camera == nullptr
+            || !_prefetch_zone->IsNearZone(camera->GetXPosition(), camera->GetYPosition(), MAP_PREFETCH_DISTANCE))
+        return;
+
+    MapPrefetcher::Prefetch(_transition_map_data_filename);
+    _prefetched = true;
+}
+
 void MapTransitionEvent::_Start()
 {
     MapMode::CurrentInstance()->PushState(STATE_SCENE);
 
-    VideoManager->_StartTransitionFadeOut(Color::black, MAP_FADE_OUT_TIME);
-    _done = false;
+    // Only create the map once the fade out is done, since the load time can
+    // break the fade smoothness and visible duration. Its data is read meanwhile.
+    vt_global::GlobalManager->GetMapData().SetPreviousLocation(_transition_origin);
+    const std::string map_data_filename = _transition_map_data_filename;
+    const std::string map_script_filename = _transition_map_script_filename;
+    const uint32_t stamina = MapMode::CurrentInstance()->GetStamina();
+    ModeManager->Pop();
+    ModeManager->Push([map_data_filename, map_script_filename, stamina]() {
+        return static_cast<GameMode*>(new MapMode(map_data_filename, map_script_filename, stamina));
+    }, MapMode::StartLoading(map_data_filename, map_script_filename), true, true);
 }
 
 bool MapTransitionEvent::_Update()
 {
-    if(VideoManager->IsFading())
-        return false;
-
-    // Only load the map once the fade out is done, since the load time can
-    // break the fade smoothness and visible duration.
-    if(!_done) {
-        vt_global::GlobalManager->GetMapData().SetPreviousLocation(_transition_origin);
-        MapMode* MM = new MapMode(_transition_map_data_filename,
-                                  _transition_map_script_filename,
-                                  MapMode::CurrentInstance()->GetStamina());
-        ModeManager->Pop();
-        ModeManager->Push(MM, false, true);
-        _done = true;
-    }
-    return true;
+    // Last until the map is replaced, so that the transition isn't started again meanwhile.
+    return !VideoManager->IsFading();
 }
 
 // -----------------------------------------------------------------------------
@@ -244,37 +263,46 @@ void BattleEncounterEvent::AddEnemy(uint32_t enemy_id,
 
 void BattleEncounterEvent::_Start()
 {
-    try {
-        // Check the current map stamina and apply a malus on stamina when it is low
-        MapMode* MM = MapMode::CurrentInstance();
-        if (MM)
-            MM->ApplyPotentialStaminaMalus();
-
-        BattleMode *BM = new BattleMode();
-        for(const auto& enemy : _enemies)
-            BM->AddEnemy(enemy.enemy_id, enemy.position.x, enemy.position.y);
-
-        vt_global::BattleMedia& battle_media =
-            vt_global::GlobalManager->GetBattleMedia();
-        battle_media.SetBackgroundImage(_battle_background);
-        battle_media.SetBattleMusic(_battle_music);
-        for(auto& battle_script : _battle_scripts)
-            BM->GetScriptSupervisor().AddScript(battle_script);
-
-        BM->SetBossBattle(_is_boss);
-
-        TransitionToBattleMode* TM = new TransitionToBattleMode(BM, _is_boss);
-
-        ModeManager->Push(TM);
-    } catch(const luabind::error& e) {
-        PRINT_ERROR << "Error while loading battle encounter event!"
-                    << std::endl;
-        ScriptManager->HandleLuaError(e);
-    } catch(const luabind::cast_failed& e) {
-        PRINT_ERROR << "Error while loading battle encounter event!"
-                    << std::endl;
-        ScriptManager->HandleCastError(e);
-    }
+    // Check the current map stamina and apply a malus on stamina when it is low
+    MapMode* MM = MapMode::CurrentInstance();
+    if (MM)
+        MM->ApplyPotentialStaminaMalus();
+
+    vt_global::BattleMedia& battle_media =
+        vt_global::GlobalManager->GetBattleMedia();
+    battle_media.SetBackgroundImage(_battle_background);
+    battle_media.SetBattleMusic(_battle_music);
+
+    // The battle images start decoding now, and the battle is created on the next update.
+    AssetManifest::PrefetchImages(AssetManifest::GetBattleKey(
+        vt_global::GlobalManager->GetMapData().GetMapScriptFilename()));
+
+    const std::vector<vt_battle::BattleEnemyInfo> enemies = _enemies;
+    const std::vector<std::string> battle_scripts = _battle_scripts;
+    const bool is_boss = _is_boss;
+    ModeManager->Push([enemies, battle_scripts, is_boss]() -> GameMode* {
+        try {
+            BattleMode *BM = new BattleMode();
+            for(const auto& enemy : enemies)
+                BM->AddEnemy(enemy.enemy_id, enemy.position.x, enemy.position.y);
+
+            for(auto& battle_script : battle_scripts)
+                BM->GetScriptSupervisor().AddScript(battle_script);
+
+            BM->SetBossBattle(is_boss);
+
+            return new TransitionToBattleMode(BM, is_boss);
+        } catch(const luabind::error& e) {
+            PRINT_ERROR << "Error while loading battle encounter event!"
+                        << std::endl;
+            ScriptManager->HandleLuaError(e);
+        } catch(const luabind::cast_failed& e) {
+            PRINT_ERROR << "Error while loading battle encounter event!"
+                        << std::endl;
+            ScriptManager->HandleCastError(e);
+        }
+        return nullptr;
+    });
 }
 
 // -----------------------------------------------------------------------------
@@ -320,6 +348,7 @@ void IfEvent::_Start()
     try {
         // We had a timer of 100ms her to avoid launching an event within an event
         // for the sake of the engine loop. That time is unnoticeable, anyway.
+        ScriptCallTimer timer("IfEvent check", _check_function);
         if (luabind::call_function<bool>(_check_function)
             && !_true_event_id.empty() && !events->IsEventActive(_true_event_id)) {
             events->StartEvent(_true_event_id, 100);
@@ -376,6 +405,7 @@ void ScriptedEvent::_Start()
         return;
 
     try {
+        ScriptCallTimer timer("ScriptedEvent start", _start_function);
         luabind::call_function<void>(_start_function);
     } catch(const luabind::error &e) {
         PRINT_ERROR << "Error while loading ScriptedEvent start function"
@@ -394,6 +424,7 @@ bool ScriptedEvent::_Update()
         return true;
 
     try {
+        ScriptCallTimer timer("ScriptedEvent update", _update_function);
         return luabind::call_function<bool>(_update_function);
     } catch(const luabind::error &e) {
         PRINT_ERROR << "Error while loading ScriptedEvent update function"
@@ -407,6 +438,169 @@ bool ScriptedEvent::_Update()
     return true;
 }
 
+// -----------------------------------------------------------------------------
+// ---------- CoroutineEvent Class Methods
+// -----------------------------------------------------------------------------
+
+CoroutineEvent::CoroutineEvent(const std::string& event_id,
+                               const std::string& function) :
+    MapEvent(event_id, COROUTINE_EVENT),
+    _thread(nullptr),
+    _thread_reference(LUA_NOREF),
+    _wait_type(COROUTINE_WAIT_FRAME),
+    _wait_time(0),
+    _wait_sprite(nullptr)
+{
+    ReadScriptDescriptor &map_script = MapMode::CurrentInstance()->GetMapScript();
+    if (!MapMode::CurrentInstance()->OpenMapTablespace(true))
+        return;
+    if (!map_script.OpenTable("map_functions"))
+        return;
+
+    if(!function.empty())
+        _function = map_script.ReadFunctionPointer(function);
+
+    map_script.CloseTable(); // map_functions
+    map_script.CloseTable(); // tablespace
+}
+
+CoroutineEvent::~CoroutineEvent()
+{
+    _ReleaseThread();
+}
+
+CoroutineEvent* CoroutineEvent::Create(const std::string& event_id,
+                                       const std::string& function)
+{
+    return new CoroutineEvent(event_id, function);
+}
+
+void CoroutineEvent::_Start()
+{
+    // A restarted event runs the function from its beginning.
+    _ReleaseThread();
+    if(!_function.is_valid())
+        return;
+
+    lua_State* global_state = ScriptManager->GetGlobalState();
+    _thread = lua_newthread(global_state);
+    _thread_reference = luaL_ref(global_state, LUA_REGISTRYINDEX);
+
+    _function.push(_thread);
+    if(!_Resume())
+        _ReleaseThread();
+}
+
+bool CoroutineEvent::_Update()
+{
+    if(_thread == nullptr)
+        return true;
+
+    // Check what the coroutine waits for natively, without calling the script.
+    switch(_wait_type) {
+    case COROUTINE_WAIT_TIME:
+        _wait_time -= static_cast<int32_t>(SystemManager->GetUpdateTime());
+        if(_wait_time > 0)
+            return false;
+        break;
+    case COROUTINE_WAIT_EVENT:
+        if(MapMode::CurrentInstance()->GetEventSupervisor()->IsEventActive(_wait_event_id))
+            return false;
+        break;
+    case COROUTINE_WAIT_SPRITE:
+        if(_wait_sprite != nullptr && _wait_sprite->GetControlEvent() != nullptr)
+            return false;
+        break;
+    case COROUTINE_WAIT_DIALOGUE:
+        if(MapMode::CurrentInstance()->GetDialogueSupervisor()->GetCurrentDialogue() != nullptr)
+            return false;
+        break;
+    default:
+        break;
+    }
+
+    if(_Resume())
+        return false;
+
+    _ReleaseThread();
+    return true;
+}
+
+bool CoroutineEvent::_Resume()
+{
+    ScriptCallTimer timer("CoroutineEvent resume", _function);
+
+    // The function itself is on the stack when first resumed, and nothing afterwards.
+    const int32_t argument_count = lua_gettop(_thread) > 0 ? lua_gettop(_thread) - 1 : 0;
+#if LUA_VERSION_NUM >= 504
+    int result_count = 0;
+    const int32_t status = lua_resume(_thread, nullptr, argument_count, &result_count);
+#elif LUA_VERSION_NUM >= 502
+    const int32_t status = lua_resume(_thread, nullptr, argument_count);
+#else
+    const int32_t status = lua_resume(_thread, argument_count);
+#endif
+
+    if(status != LUA_YIELD) {
+        if(status != 0) {
+            const char* message = lua_tostring(_thread, -1);
+            PRINT_ERROR << "Error while running the CoroutineEvent " << GetEventID() << ": "
+                        << (message != nullptr ? message : "unknown error") << std::endl;
+        }
+        return false;
+    }
+
+    // Read what the coroutine waits for, among the values it yielded.
+    _wait_type = COROUTINE_WAIT_FRAME;
+    _wait_event_id.clear();
+    _wait_sprite = nullptr;
+    if(lua_gettop(_thread) >= 1 && lua_isnumber(_thread, 1))
+        _wait_type = static_cast<COROUTINE_WAIT_TYPE>(lua_tointeger(_thread, 1));
+
+    switch(_wait_type) {
+    case COROUTINE_WAIT_TIME:
+        _wait_time = lua_gettop(_thread) >= 2 ? static_cast<int32_t>(lua_tointeger(_thread, 2)) : 0;
+        break;
+    case COROUTINE_WAIT_EVENT:
+        if(lua_gettop(_thread) >= 2 && lua_isstring(_thread, 2))
+            _wait_event_id = lua_tostring(_thread, 2);
+        break;
+    case COROUTINE_WAIT_SPRITE:
+        if(lua_gettop(_thread) >= 2) {
+            try {
+                luabind::object sprite(luabind::from_stack(_thread, 2));
+                _wait_sprite = luabind::object_cast<VirtualSprite*>(sprite);
+            } catch(const luabind::cast_failed &e) {
+                PRINT_ERROR << "The CoroutineEvent " << GetEventID()
+                            << " didn't yield a sprite to wait for" << std::endl;
+                ScriptManager->HandleCastError(e);
+            }
+        }
+        break;
+    case COROUTINE_WAIT_FRAME:
+    case COROUTINE_WAIT_DIALOGUE:
+        break;
+    default:
+        PRINT_WARNING << "The CoroutineEvent " << GetEventID()
+                      << " yielded an unknown wait type: " << _wait_type << std::endl;
+        _wait_type = COROUTINE_WAIT_FRAME;
+        break;
+    }
+
+    lua_settop(_thread, 0);
+    return true;
+}
+
+void CoroutineEvent::_ReleaseThread()
+{
+    if(_thread == nullptr)
+        return;
+
+    luaL_unref(ScriptManager->GetGlobalState(), LUA_REGISTRYINDEX, _thread_reference);
+    _thread = nullptr;
+    _thread_reference = LUA_NOREF;
+}
+
 // -----------------------------------------------------------------------------
 // ---------- SpriteEvent Class Methods
 // -----------------------------------------------------------------------------
@@ -483,14 +677,17 @@ ScriptedSpriteEvent* ScriptedSpriteEvent::Create(const std::string& event_id,
 void ScriptedSpriteEvent::_Start()
 {
     SpriteEvent::_Start();
-    if(_start_function.is_valid())
+    if(_start_function.is_valid()) {
+        ScriptCallTimer timer("ScriptedSpriteEvent start", _start_function);
         luabind::call_function<void>(_start_function, _sprite);
+    }
 }
 
 bool ScriptedSpriteEvent::_Update()
 {
     bool finished = false;
     if(_update_function.is_valid()) {
+        ScriptCallTimer timer("ScriptedSpriteEvent update", _update_function);
         finished = luabind::call_function<bool>(_update_function, _sprite);
     } else {
         finished = true;
@@ -42,6 +42,7 @@ namespace private_map
 
 class ContextZone;
 class MapSprite;
+class MapZone;
 class SpriteDialogue;
 class VirtualSprite;
 
@@ -68,7 +69,7 @@ class EventLink
 {
 public:
     EventLink(const std::string &child_id, bool start, uint32_t time) :
-        child_event_id(child_id), launch_at_start(start), launch_timer(time) {}
+        child_event_id(child_id), launch_at_start(start), launch_timer(time), child_event_index(-1) {}
 
     ~EventLink()
     {}
@@ -81,6 +82,9 @@ public:
 
     //! \brief The amount of milliseconds to wait before launching the event (0 means launch instantly)
     uint32_t launch_timer;
+
+    //! \brief The child event index in the event supervisor, looked up from its ID at the first launch. -1 until then.
+    int32_t child_event_index;
 }; // class EventLink
 
 
@@ -112,6 +116,15 @@ public:
     virtual ~MapEvent()
     {}
 
+    //! \brief The map events are allocated in the memory arena of their map.
+    static void* operator new(size_t size) {
+        return AllocateMapMemory(size);
+    }
+
+    static void operator delete(void* pointer, size_t size) {
+        FreeMapMemory(pointer, size);
+    }
+
     const std::string& GetEventID() const {
         return _event_id;
     }
@@ -120,6 +133,19 @@ public:
         return _event_type;
     }
 
+    /** \brief Makes the event supervisor delete the event once it has ended and isn't launched anymore.
+    *** Meant for the events created on the fly by the map scripts, such as the cutscene sprite events,
+    *** so that their memory is reused by the next events rather than kept until the map is left.
+    *** \note The script mustn't use the event once it has ended, its ID can then be used by a new event.
+    **/
+    void SetRecycledOnEnd(bool recycled) {
+        _recycled_on_end = recycled;
+    }
+
+    bool IsRecycledOnEnd() const {
+        return _recycled_on_end;
+    }
+
     /** \brief Declares a child event to be launched immediately at the start of this event
     *** \param child_event_id The event id of the child event
     **/
@@ -182,6 +208,15 @@ private:
 
     //! \brief All child events of this class, represented by EventLink objects
     std::vector<EventLink> _event_links;
+
+    //! \brief The event index in the event supervisor, used as its interned ID. -1 if it isn't registered.
+    int32_t _event_index;
+
+    //! \brief The event position in the event supervisor active events, or -1 when it isn't active.
+    int32_t _active_index;
+
+    //! \brief Whether the event is deleted once it has ended.
+    bool _recycled_on_end;
 }; // class MapEvent
 
 
@@ -428,11 +463,21 @@ public:
                                       const std::string& script_filename,
                                       const std::string& coming_from);
 
+    /** \brief Sets the zone triggering the transition, so that the destination map
+    *** is prefetched once the camera gets near it. See MapPrefetcher.
+    **/
+    void SetPrefetchZone(MapZone* zone) {
+        _prefetch_zone = zone;
+    }
+
+    //! \brief Prefetches the destination map when the camera gets near the prefetch zone.
+    void UpdatePrefetch();
+
 protected:
-    //! \brief Begins the transition process by fading out the screen and music
+    //! \brief Begins the transition process by pushing the new map mode, created once the screen faded out
     void _Start() override;
 
-    //! \brief Once the fading process completes, creates the new map mode to transition to
+    //! \brief Waits for the fade out, after which the map is replaced
     bool _Update() override;
 
     //! \brief The data and script filenames of the map to transition to
@@ -444,8 +489,9 @@ protected:
     **/
     std::string _transition_origin;
 
-    //! \brief tells the update function to trigger the new map.
-    bool _done;
+    //! \brief The zone triggering the transition, if known, and whether the destination was prefetched.
+    MapZone* _prefetch_zone;
+    bool _prefetched;
 }; // class MapTransitionEvent : public MapEvent
 
 
@@ -616,6 +662,77 @@ protected:
     bool _Update() override;
 }; // class ScriptedEvent : public MapEvent
 
+//! \brief What a coroutine event waits for before being resumed.
+enum COROUTINE_WAIT_TYPE {
+    COROUTINE_WAIT_FRAME = 0,
+    COROUTINE_WAIT_TIME = 1,
+    COROUTINE_WAIT_EVENT = 2,
+    COROUTINE_WAIT_SPRITE = 3,
+    COROUTINE_WAIT_DIALOGUE = 4
+};
+
+/** ****************************************************************************
+*** \brief An event running a Lua function as a coroutine, resumed once what it waits for is done.
+***
+*** The function yields what it waits for, and the engine checks it every frame
+*** without calling the script, so that a cutscene only costs a Lua call when
+*** it goes on to its next step:
+***
+*** \code
+*** coroutine.yield(vt_map.CoroutineEvent.WAIT_TIME, 500) -- Waits for 500 ms.
+*** coroutine.yield(vt_map.CoroutineEvent.WAIT_EVENT, "event id") -- Waits for an active event to end.
+*** coroutine.yield(vt_map.CoroutineEvent.WAIT_SPRITE, sprite) -- Waits for the events controlling a sprite to end.
+*** coroutine.yield(vt_map.CoroutineEvent.WAIT_DIALOGUE) -- Waits for the current dialogue to end.
+*** coroutine.yield() -- Waits for the next frame.
+*** \endcode
+***
+*** The event ends with the function, and then triggers its event links.
+*** ***************************************************************************/
+class CoroutineEvent : public MapEvent
+{
+public:
+    /** \param event_id The ID of this event
+    *** \param function The map file's function run as a coroutine
+    **/
+    CoroutineEvent(const std::string& event_id, const std::string& function);
+
+    virtual ~CoroutineEvent() override;
+
+    //! \brief A C++ wrapper made to create a new object from scripting,
+    //! without letting Lua handling the object life-cycle.
+    //! \note We don't permit luabind to use constructors here as it can't currently
+    //! give the object ownership at construction time.
+    static CoroutineEvent* Create(const std::string& event_id,
+                                  const std::string& function);
+
+protected:
+    //! \brief The Lua function run as a coroutine.
+    luabind::object _function;
+
+    //! \brief The Lua thread running the function, and its registry reference keeping it alive.
+    lua_State* _thread;
+    int32_t _thread_reference;
+
+    //! \brief What the coroutine waits for, and its argument.
+    COROUTINE_WAIT_TYPE _wait_type;
+    int32_t _wait_time;
+    std::string _wait_event_id;
+    VirtualSprite* _wait_sprite;
+
+    //! \brief Creates the coroutine and runs it up to its first yield.
+    void _Start() override;
+
+    //! \brief Resumes the coroutine once what it waits for is done. Returns true once it has ended.
+    bool _Update() override;
+
+    //! \brief Resumes the coroutine, and reads what it waits for next.
+    //! \return false once the coroutine has ended, or failed.
+    bool _Resume();
+
+    //! \brief Frees the Lua thread.
+    void _ReleaseThread();
+}; // class CoroutineEvent : public MapEvent
+
 
 /** ****************************************************************************
 *** \brief An abstract event class that represents an event controlling a sprite
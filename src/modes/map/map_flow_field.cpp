@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_flow_field.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the flow field hostile enemies chase the camera with.
+*** ***************************************************************************/
+
+#include "modes/map/map_flow_field.h"
+
+#include "modes/map/map_object_supervisor.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace vt_common;
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The cost of a node not reached.
+const uint32_t FLOW_FIELD_UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+//! \brief The costs of lateral and diagonal moves, the same as FindPath() ones.
+const uint32_t FLOW_FIELD_LATERAL_COST = 10;
+const uint32_t FLOW_FIELD_DIAGONAL_COST = 14;
+
+// The offsets of the eight adjacent nodes, lateral ones first.
+static const int32_t FLOW_FIELD_ADJACENT_X[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+static const int32_t FLOW_FIELD_ADJACENT_Y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+FlowField::FlowField(float coll_half_width, float coll_height) :
+    _coll_half_width(coll_half_width),
+    _coll_height(coll_height),
+    _target_x(-1),
+    _target_y(-1),
+    _left(0),
+    _top(0),
+    _width(0),
+    _height(0)
+{
+}
+
+void FlowField::Update(const ObjectSupervisor& object_supervisor, float target_x, float target_y)
+{
+    const int32_t node_x = static_cast<int32_t>(target_x);
+    const int32_t node_y = static_cast<int32_t>(target_y);
+    if (node_x == _target_x && node_y == _target_y)
+        return;
+
+    _target_x = node_x;
+    _target_y = node_y;
+    _Compute(object_supervisor);
+}
+
+bool FlowField::GetNextStep(float x, float y, Position2D& next_step) const
+{
+    const int32_t node_x = static_cast<int32_t>(x);
+    const int32_t node_y = static_cast<int32_t>(y);
+
+    const uint32_t cost = _GetCost(node_x, node_y);
+    if (cost == FLOW_FIELD_UNREACHABLE)
+        return false;
+
+    uint32_t best_cost = cost;
+    int32_t best_x = node_x;
+    int32_t best_y = node_y;
+    for (uint32_t i = 0; i < 8; ++i) {
+        const int32_t adjacent_x = node_x + FLOW_FIELD_ADJACENT_X[i];
+        const int32_t adjacent_y = node_y + FLOW_FIELD_ADJACENT_Y[i];
+        const uint32_t adjacent_cost = _GetCost(adjacent_x, adjacent_y);
+        if (adjacent_cost < best_cost) {
+            best_cost = adjacent_cost;
+            best_x = adjacent_x;
+            best_y = adjacent_y;
+        }
+    }
+
+    // Already on, or next to, the target node.
+    if (best_cost == 0 || (best_x == node_x && best_y == node_y))
+        return false;
+
+    next_step.x = static_cast<float>(best_x) + 0.5f;
+    next_step.y = static_cast<float>(best_y) + 0.5f;
+    return true;
+}
+
+uint32_t FlowField::_GetCost(int32_t x, int32_t y) const
+{
+    if (x < _left || y < _top || x >= _left + _width || y >= _top + _height)
+        return FLOW_FIELD_UNREACHABLE;
+
+    return _costs[(y - _top) * _width + x - _left];
+}
+
+void FlowField::_Compute(const ObjectSupervisor& object_supervisor)
+{
+    uint32_t grid_width = 0;
+    uint32_t grid_height = 0;
+    object_supervisor.GetGridAxis(grid_width, grid_height);
+
+    // Enemies farther than a screen from the camera aren't updated.
+    const int32_t range_x = static_cast<int32_t>(SCREEN_GRID_X_LENGTH) + 1;
+    const int32_t range_y = static_cast<int32_t>(SCREEN_GRID_Y_LENGTH) + 1;
+    _left = std::max(0, _target_x - range_x);
+    _top = std::max(0, _target_y - range_y);
+    _width = std::max(0, std::min(static_cast<int32_t>(grid_width), _target_x + range_x + 1) - _left);
+    _height = std::max(0, std::min(static_cast<int32_t>(grid_height), _target_y + range_y + 1) - _top);
+
+    _costs.assign(_width * _height, FLOW_FIELD_UNREACHABLE);
+    if (_target_x < _left || _target_y < _top || _target_x >= _left + _width || _target_y >= _top + _height)
+        return;
+
+    // Whether a node was checked against the collision grid, and was free.
+    // 0: not checked yet, 1: free, 2: blocked.
+    std::vector<uint8_t> walkable(_costs.size(), 0);
+
+    typedef std::pair<uint32_t, uint32_t> CostIndex;
+    std::priority_queue<CostIndex, std::vector<CostIndex>, std::greater<CostIndex> > open_nodes;
+
+    // The target node is always reachable, even when the sprite stands partly in a wall.
+    const uint32_t target_index = (_target_y - _top) * _width + _target_x - _left;
+    _costs[target_index] = 0;
+    walkable[target_index] = 1;
+    open_nodes.push(CostIndex(0, target_index));
+
+    while (!open_nodes.empty()) {
+        const CostIndex best = open_nodes.top();
+        open_nodes.pop();
+
+        // Skip the outdated entries of nodes reached through a cheaper path since.
+        if (best.first != _costs[best.second])
+            continue;
+
+        const int32_t best_x = _left + static_cast<int32_t>(best.second) % _width;
+        const int32_t best_y = _top + static_cast<int32_t>(best.second) / _width;
+
+        for (uint32_t i = 0; i < 8; ++i) {
+            const int32_t x = best_x + FLOW_FIELD_ADJACENT_X[i];
+            const int32_t y = best_y + FLOW_FIELD_ADJACENT_Y[i];
+            if (x < _left || y < _top || x >= _left + _width || y >= _top + _height)
+                continue;
+
+            const uint32_t index = (y - _top) * _width + x - _left;
+            const uint32_t cost = best.first + (i < 4 ? FLOW_FIELD_LATERAL_COST : FLOW_FIELD_DIAGONAL_COST);
+            if (cost >= _costs[index])
+                continue;
+
+            if (walkable[index] == 0) {
+                const float center_x = static_cast<float>(x) + 0.5f;
+                const float center_y = static_cast<float>(y) + 0.5f;
+                const vt_common::Rectangle2D rect(center_x - _coll_half_width,
+                                                  center_x + _coll_half_width,
+                                                  center_y - _coll_height,
+                                                  center_y);
+                walkable[index] = object_supervisor.IsGridAreaFree(rect) ? 1 : 2;
+            }
+            if (walkable[index] != 1)
+                continue;
+
+            _costs[index] = cost;
+            open_nodes.push(CostIndex(cost, index));
+        }
+    }
+}
+
+} // namespace private_map
+
+} // namespace vt_map
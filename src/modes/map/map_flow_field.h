@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_flow_field.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the flow field hostile enemies chase the camera with.
+***
+*** Rather than each enemy finding its own path toward the same target, the
+*** cost to reach the target is computed once for every node around it. Each
+*** enemy then only needs to step to its cheapest neighbor node.
+*** ***************************************************************************/
+
+#ifndef __MAP_FLOW_FIELD_HEADER__
+#define __MAP_FLOW_FIELD_HEADER__
+
+#include "common/position_2d.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+class ObjectSupervisor;
+
+/** ****************************************************************************
+*** \brief The Dijkstra costs of reaching a target, around it on the collision grid.
+***
+*** The field only covers the area around the target where enemies are updated,
+*** and only takes the collision grid into account, as the other objects are
+*** avoided by the sprites while moving. It is computed for one collision size,
+*** and only recomputed when the target moves to another node.
+*** ***************************************************************************/
+class FlowField
+{
+public:
+    FlowField(float coll_half_width, float coll_height);
+
+    //! \brief Tells whether the field is computed for sprites with that collision size.
+    bool HasCollisionSize(float coll_half_width, float coll_height) const {
+        return _coll_half_width == coll_half_width && _coll_height == coll_height;
+    }
+
+    /** \brief Recomputes the field if the target changed node since the last call.
+    *** \param object_supervisor The supervisor whose collision grid is used.
+    *** \param target_x The x grid position of the target.
+    *** \param target_y The y grid position of the target.
+    **/
+    void Update(const ObjectSupervisor& object_supervisor, float target_x, float target_y);
+
+    /** \brief Gets the next position to reach from a given position toward the target.
+    *** \param x The x grid position to move from.
+    *** \param y The y grid position to move from.
+    *** \param next_step The center of the neighbor node to move to.
+    *** \return False if the position isn't in the field, can't reach the target,
+    *** or is already next to it, in which case the target should be reached directly.
+    **/
+    bool GetNextStep(float x, float y, vt_common::Position2D& next_step) const;
+
+private:
+    //! \brief The collision size of the sprites the field is computed for, in grid elements.
+    float _coll_half_width;
+    float _coll_height;
+
+    //! \brief The node of the target, or -1 before the first update.
+    int32_t _target_x;
+    int32_t _target_y;
+
+    //! \brief The area of the collision grid covered by the field.
+    int32_t _left;
+    int32_t _top;
+    int32_t _width;
+    int32_t _height;
+
+    //! \brief The cost of reaching the target from each node: _costs[(y - _top) * _width + x - _left]
+    std::vector<uint32_t> _costs;
+
+    //! \brief Returns the cost of a node, or the maximum value when out of the field or unreachable.
+    uint32_t _GetCost(int32_t x, int32_t y) const;
+
+    //! \brief Computes the costs of the nodes around the target.
+    void _Compute(const ObjectSupervisor& object_supervisor);
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_FLOW_FIELD_HEADER__
@@ -14,7 +14,9 @@
 #include "modes/map/map_object_supervisor.h"
 #include "modes/map/map_sprites/map_virtual_sprite.h"
 
+#include "engine/idle_scheduler.h"
 #include "engine/video/video.h"
+#include "common/global/global.h"
 #include "common/gui/menu_window.h"
 
 // Used for the collision to XPM dev function
@@ -22,8 +24,7 @@
 #include "script/script_write.h"
 #endif
 
-#include <SDL2/SDL_image.h>
-#include <SDL2/SDL_endian.h>
+#include <cstring>
 
 using namespace vt_common;
 
@@ -45,58 +46,14 @@ const float MINIMAP_POS_X = 775.0f;
 //! \brief The Y value for the minimap's position.
 const float MINIMAP_POS_Y = 545.0f;
 
-//! \brief Allows for scoped-based control of SDL Surfaces.
-struct SDLSurfaceController {
-    SDL_Surface* _surface;
+//! \brief The white noise image tiled on the unwalkable parts of the procedural minimap.
+const std::string MINIMAP_NOISE_IMAGE = "data/gui/map/minimap_collision.png";
 
-    explicit SDLSurfaceController(const char *str) :
-        _surface(IMG_Load(str))
-    {
-        if (!_surface)
-            PRINT_ERROR << "Couldn't create the white noise image for the collision map: " << SDL_GetError() << std::endl;
-    }
-
-    ~SDLSurfaceController()
-    {
-        if (_surface)
-            SDL_FreeSurface(_surface);
-    }
-
-private:
-    //! \brief The copy constructor and assignment operator are hidden by design
-    //! to cause compilation errors when attempting to copy or assign this class.
-    SDLSurfaceController(const SDLSurfaceController&)
-    {
-        throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
-    }
-    SDLSurfaceController& operator=(const SDLSurfaceController&)
-    {
-        throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
-        return *this;
-    }
-};
+//! \brief The procedural minimap pixel rows filled per idle task slice.
+const uint32_t MINIMAP_ROWS_PER_SLICE = 32;
 
-//! \brief A helper function to prepare a SDL_Surface.
-static bool _PrepareSurface(SDL_Surface* temp_surface)
-{
-    // A white noise texture.
-    const SDLSurfaceController WHITE_NOISE("data/gui/map/minimap_collision.png");
-    SDL_Rect r = { 0, 0, 0, 0 };
-
-    // Prepare the surface with the image.  Tile the white noise image onto the surface with full alpha.
-    for(int x = 0; x < temp_surface->w; x += WHITE_NOISE._surface->w) {
-        r.x = x;
-        for(int y = 0; y < temp_surface->h; y += WHITE_NOISE._surface->h) {
-            r.y = y;
-            if(SDL_BlitSurface(WHITE_NOISE._surface, nullptr, temp_surface, &r)) {
-                PRINT_ERROR << "Couldn't fill a rect on temp_surface: " << SDL_GetError() << std::endl;
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
+//! \brief The time after which the procedural minimap is filled even without frame slack, in milliseconds.
+const uint32_t MINIMAP_CREATION_DEADLINE = 1000;
 
 Minimap::Minimap(const std::string& minimap_image_filename) :
     _current_position(-1.0f, -1.0f),
@@ -108,7 +65,8 @@ Minimap::Minimap(const std::string& minimap_image_filename) :
     _grid_width(0),
     _grid_height(0),
     _current_opacity(nullptr),
-    _map_alpha_scale(1.0f)
+    _map_alpha_scale(1.0f),
+    _procedural_row(0)
 {
     ObjectSupervisor *map_object_supervisor = MapMode::CurrentInstance()->GetObjectSupervisor();
     map_object_supervisor->GetGridAxis(_grid_width, _grid_height);
@@ -116,108 +74,93 @@ Minimap::Minimap(const std::string& minimap_image_filename) :
     // If no minimap image is given, we create one.
     if (minimap_image_filename.empty() ||
             !_minimap_image.Load(minimap_image_filename, _grid_width * _box_x_length, _grid_height * _box_y_length)) {
-        _minimap_image = _CreateProcedurally();
+        _CreateProcedurally();
     }
 
     //setup the map window, if it isn't already created
-    _background.Load("data/gui/map/minimap_background.png");
+    vt_global::GlobalMedia& media = vt_global::GlobalManager->Media();
+    _background = media.GetMinimapBackgroundImage();
     _background.SetStatic(true);
     _background.SetHeight(173.0f);
     _background.SetWidth(235.0f);
 
     //load the location market
-    if(!_location_marker.LoadFromAnimationScript("data/gui/map/minimap_arrows.lua"))
-        PRINT_ERROR << "Could not load marker image!" << std::endl;
+    _location_marker = media.GetMinimapLocationMarker();
     _location_marker.SetWidth(_box_x_length * 5);
     _location_marker.SetHeight(_box_y_length * 5);
     _location_marker.SetFrameIndex(0);
 }
 
-vt_video::StillImage Minimap::_CreateProcedurally()
+Minimap::~Minimap()
 {
-    ObjectSupervisor *map_object_supervisor = MapMode::CurrentInstance()->GetObjectSupervisor();
+    // The procedural minimap may still be filled.
+    vt_system::IdleScheduler::CancelTasks(this);
 
-    float x, y, width, height;
-    vt_video::VideoManager->GetCurrentViewport(x, y, width, height);
+    _minimap_image.Clear();
+    _location_marker.Clear();
+}
 
-    //create a new SDL surface that is the rendering dimensions we want.
-    SDL_Surface *temp_surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
-                                                     _grid_width * _box_x_length, _grid_height * _box_y_length, 32,
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-                                                     0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff);
-#else
-                                                     0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
-#endif
+void Minimap::_CreateProcedurally()
+{
+    ObjectSupervisor *map_object_supervisor = MapMode::CurrentInstance()->GetObjectSupervisor();
 
-    if(!temp_surface) {
-        PRINT_ERROR << "Couldn't create temp_surface for collision map: " << SDL_GetError() << std::endl;
+    // A white noise texture, tiled under the unwalkable cells.
+    if(!_procedural_noise.LoadImage(MINIMAP_NOISE_IMAGE) || _procedural_noise.GetBytesPerPixel() != 4) {
+        PRINT_ERROR << "Couldn't load the white noise image for the collision map: " << MINIMAP_NOISE_IMAGE << std::endl;
         MapMode::CurrentInstance()->ShowMinimap(false);
-        return vt_video::StillImage();
+        return;
     }
 
-    //set the basic rect information
-    SDL_Rect r;
-    r.w = _box_x_length;
-    r.h = _box_y_length;
-    r.x = r.y = 0;
-
-    //very simple. Just go through the entire grid, checking the visible-character's
-    //context against the map-grid's collision context. if this is NOT a colidable location
-    //fill that square in with a full alpha block
-    //note that the ordering needs to be transposed for drawing
-    if (!_PrepareSurface(temp_surface)) {
-        SDL_FreeSurface(temp_surface);
-        MapMode::CurrentInstance()->ShowMinimap(false);
-        return vt_video::StillImage();
-    }
+    // The whole collision grid at once, rather than a point test per cell.
+    map_object_supervisor->GetStaticCollisionGrid(_procedural_collision_grid);
 
-    for(uint32_t row = 0; row < _grid_width; ++row)
-    {
-        r.y = 0;
-        for(uint32_t col = 0; col < _grid_height; ++col)
-        {
-            if(!map_object_supervisor->IsStaticCollision(row, col))
-            {
-
-                if(SDL_FillRect(temp_surface, &r, SDL_MapRGBA(temp_surface->format, 0x00, 0x00, 0x00, 0x00)))
-                {
-                    PRINT_ERROR << "Couldn't fill a rect on temp_surface: " << SDL_GetError() << std::endl;
-                    SDL_FreeSurface(temp_surface);
-                    return vt_video::StillImage();
-                }
-
-            }
-            r.y += _box_y_length;
-        }
-        r.x += _box_x_length;
-    }
+    _procedural_pixels.Resize(_grid_width * _box_x_length, _grid_height * _box_y_length, false);
+    _procedural_row = 0;
+    _procedural_image_name = MapMode::CurrentInstance()->GetMapScriptFilename() + "_cmap";
 
-    //TEST: flush the SDL surface. This forces any pending writes onto the surface to complete
-    //SDL_UpdateRect(temp_surface, 0, 0, 0, 0);
+    // The minimap isn't needed for the first frames of the map, which may then run at full speed.
+    vt_system::IdleScheduler::Submit("Minimap creation", [this]() { return _FillProceduralRows(); },
+                                     vt_system::IDLE_PRIORITY_NORMAL, MINIMAP_CREATION_DEADLINE, this);
+}
 
-    if (!temp_surface) {
-        MapMode::CurrentInstance()->ShowMinimap(false);
-        return vt_video::StillImage();
+bool Minimap::_FillProceduralRows()
+{
+    // Fill the RGBA pixels directly, one row at a time: the noise row tiled along the row,
+    // then the walkable cells of the grid row cleared to full transparency.
+    const size_t row_bytes = _procedural_pixels.GetWidth() * 4;
+    const size_t noise_row_bytes = _procedural_noise.GetWidth() * 4;
+    const size_t box_bytes = _box_x_length * 4;
+    const size_t last_row = std::min(static_cast<size_t>(_procedural_row + MINIMAP_ROWS_PER_SLICE),
+                                     _procedural_pixels.GetHeight());
+    for(size_t y = _procedural_row; y < last_row; ++y) {
+        uint8_t *row = _procedural_pixels.GetPixels() + y * row_bytes;
+        const uint8_t *noise_row = _procedural_noise.GetPixels() + (y % _procedural_noise.GetHeight()) * noise_row_bytes;
+        for(size_t offset = 0; offset < row_bytes; offset += noise_row_bytes)
+            memcpy(row + offset, noise_row, std::min(noise_row_bytes, row_bytes - offset));
+
+        const uint32_t grid_y = y / _box_y_length;
+        for(uint32_t grid_x = 0; grid_x < _grid_width; ++grid_x) {
+            if(!_procedural_collision_grid.IsBlocked(grid_x, grid_y))
+                memset(row + grid_x * box_bytes, 0, box_bytes);
+        }
     }
+    _procedural_row = static_cast<uint32_t>(last_row);
+    if(last_row < _procedural_pixels.GetHeight())
+        return false;
 
-    SDL_LockSurface(temp_surface);
-
-    // Setup a temporary memory space to copy the SDL data into
-    vt_video::private_video::ImageMemory temp_data(temp_surface);
-
-    SDL_UnlockSurface(temp_surface);
-    // At this point, the screen data is set up. We can get rid of unnecessary data here
-    SDL_FreeSurface(temp_surface);
     // Do the image file creation
-    std::string map_name_cmap = MapMode::CurrentInstance()->GetMapScriptFilename() + "_cmap";
-    vt_video::StillImage minimap_image = vt_video::VideoManager->CreateImage(&temp_data, map_name_cmap);
+    _minimap_image = vt_video::VideoManager->CreateImage(&_procedural_pixels, _procedural_image_name);
 
 #ifdef DEBUG_FEATURES
     // Uncomment and compile this to generate XPM minimaps.
-    //_DEV_CreateXPMFromCollisionMap(map_name_cmap + ".xpm");
+    //_DEV_CreateXPMFromCollisionMap(_procedural_image_name + ".xpm");
 #endif
 
-    return minimap_image;
+    // Free the generation data.
+    _procedural_pixels = vt_video::private_video::ImageMemory();
+    _procedural_noise = vt_video::private_video::ImageMemory();
+    _procedural_collision_grid = CollisionGrid();
+    return true;
 }
 
 void Minimap::Draw()
@@ -20,6 +20,8 @@
 #ifndef __MAP_MINIMAP_HEADER__
 #define __MAP_MINIMAP_HEADER__
 
+#include "modes/map/map_collision_grid.h"
+
 #include "engine/video/image.h"
 
 // Forward declerations.
@@ -45,10 +47,7 @@ public:
     **/
     Minimap(const std::string& minimap_image_filename = std::string());
 
-    ~Minimap() {
-        _minimap_image.Clear();
-        _location_marker.Clear();
-    }
+    ~Minimap();
 
     /** updates the map with effect changes and player location information
     *** \param camera a VirtualSprite indicating the camera location
@@ -94,8 +93,23 @@ private:
     //! \brief specifies the additive alpha we get from the map class
     float _map_alpha_scale;
 
-    //! \brief creates the procedural collision minimap image
-    vt_video::StillImage _CreateProcedurally();
+    /** \brief The procedural minimap being generated, along with the rows filled so far.
+    *** The image is only created once every row is filled.
+    **/
+    vt_video::private_video::ImageMemory _procedural_pixels;
+    vt_video::private_video::ImageMemory _procedural_noise;
+    CollisionGrid _procedural_collision_grid;
+    uint32_t _procedural_row;
+    std::string _procedural_image_name;
+
+    /** \brief Starts creating the procedural collision minimap image.
+    *** Its pixels are filled a few rows at a time by an idle task, in the frames slack time.
+    **/
+    void _CreateProcedurally();
+
+    //! \brief Fills the next pixel rows of the procedural minimap, and creates its image once done.
+    //! \return True once the image is created.
+    bool _FillProceduralRows();
 
 #ifdef DEBUG_FEATURES
     //! \brief Writes a XPM file with the minimap equivalient in it.
@@ -22,6 +22,7 @@
 #include "modes/map/map_event_supervisor.h"
 
 #include "modes/map/map_object_supervisor.h"
+#include "modes/map/map_prefetcher.h"
 #include "modes/map/map_objects/map_object.h"
 #include "modes/map/map_objects/map_physical_object.h"
 #include "modes/map/map_objects/map_treasure.h"
@@ -39,11 +40,20 @@
 #include "modes/battle/battle.h"
 #include "modes/battle/transition_to_battle.h"
 
+#include "engine/asset_manifest.h"
+#include "engine/asset_watcher.h"
 #include "engine/audio/audio.h"
+#include "engine/frame_profiler.h"
 #include "engine/input.h"
+#include "engine/job_system.h"
+#include "engine/load_trace.h"
+#include "engine/performance_telemetry.h"
+#include "engine/script_array.h"
 
 #include "common/global/global.h"
 #include "common/global/actors/global_character.h"
+#include "common/global/actors/global_enemy.h"
+#include "common/script_call_profiler.h"
 
 // DEPRECATED: Used only to check old filenames
 #include "utils/utils_files.h"
@@ -66,18 +76,28 @@ using namespace vt_common;
 namespace vt_map
 {
 
-// Common map mode resources files
-const std::string DIALOGUE_ICON_FILE = "data/entities/emotes/dialogue_icon.lua";
-const std::string ACTIVE_SAVE_POINT_FILE1 = "data/entities/map/save_point/save_point3.lua";
-const std::string ACTIVE_SAVE_POINT_FILE2 = "data/entities/map/save_point/save_point2.lua";
-const std::string INACTIVE_SAVE_POINT_FILE1 = "data/entities/map/save_point/save_point1.lua";
-const std::string INACTIVE_SAVE_POINT_FILE2 = "data/entities/map/save_point/save_point2.lua";
-const std::string ACTIVE_ESCAPE_POINT_FILE = "data/entities/map/escape_point/escape_point_active.lua";
-const std::string INACTIVE_ESCAPE_POINT_FILE = "data/entities/map/escape_point/escape_point_inactive.lua";
+//! \brief The draw flags restored between each part of the map drawing.
+const DrawFlags MAP_DRAW_FLAGS(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM);
 
 // Initialize static class variables
 MapMode *MapMode::_current_instance = nullptr;
 
+namespace
+{
+
+//! \brief Returns the map object given at an index of a batched function array, as an object or an object id.
+MapObject* GetArrayObject(const ScriptArray& array, uint32_t index, ObjectSupervisor* object_supervisor)
+{
+    MapObject* object = array.IsNumber(index) ?
+                        object_supervisor->GetObject(static_cast<uint32_t>(array.GetNumber(index))) :
+                        array.GetPointer<MapObject>(index);
+    if(!object)
+        IF_PRINT_WARNING(MAP_DEBUG) << "Invalid map object at index " << index + 1 << " of the array" << std::endl;
+    return object;
+}
+
+} // namespace
+
 // ****************************************************************************
 // ********** MapMode Public Class Methods
 // ****************************************************************************
@@ -115,6 +135,15 @@ MapMode::MapMode(const std::string& data_filename, const std::string& script_fil
     _auto_save_enabled(true)
 {
     _current_instance = this;
+    _script_scheduler.SetScriptFilename(_map_script_filename);
+
+    // Start decoding the map assets while its objects are created.
+    AssetManifest::Prefetch(AssetManifest::GetMapKey(_map_script_filename), this);
+
+#ifdef DEBUG_FEATURES
+    AssetWatcher::Watch(ASSET_SCRIPT, _map_script_filename);
+    AssetWatcher::Watch(ASSET_SCRIPT, _map_data_filename);
+#endif
 
     ResetState();
     PushState(STATE_EXPLORE);
@@ -161,11 +190,15 @@ MapMode::MapMode(const std::string& data_filename, const std::string& script_fil
     // Init the script component.
     GetScriptSupervisor().Initialize(this);
 
+    // Lay the dialogues created by the scripts out now, rather than when they begin.
+    _dialogue_supervisor->PrepareDialogues();
+
     // Init the camera position text style
     _debug_camera_position.SetStyle(TextStyle("title22", Color::white, VIDEO_TEXT_SHADOW_DARK));
 
     if (_auto_save_enabled && permit_autosave) {
-        GlobalManager->AutoSave(_map_data_filename, _map_script_filename, _run_stamina,
+        GlobalManager->AutoSave(_map_data_filename, _map_script_filename,
+                                _map_name, _map_image.GetFilename(), _run_stamina,
                                 _camera != nullptr ? _camera->GetXPosition() : 0,
                                 _camera != nullptr ? _camera->GetYPosition() : 0);
     }
@@ -187,11 +220,19 @@ MapMode::~MapMode()
     // Remove the reference to the luabind object
     // to avoid a potential crash when freeing the lua coroutine
     // when closing the script.
-    _update_function = luabind::object();
+    _script_scheduler.Clear();
 
     // Free the map script file when closing the map.
     _map_script.CloseAllTables();
     _map_script.CloseFile();
+
+    // The battle resources preloaded are only kept for the battles of a same map.
+    GlobalManager->GetBattleMedia().ClearPreloadedResources();
+    GlobalEnemy::ClearArchetypes();
+
+    // The maps prefetched for the transitions not taken.
+    // The next map, if any, already took its own prefetched data when created.
+    MapPrefetcher::Clear();
 }
 
 void MapMode::Deactivate()
@@ -219,6 +260,10 @@ void MapMode::Deactivate()
 void MapMode::Reset()
 {
     _current_instance = this;
+    AssetManifest::SetRecordingKey(AssetManifest::GetMapKey(_map_script_filename));
+
+    // The map is loaded: The images prefetched for it which it didn't load aren't needed.
+    AssetManifest::CancelUnusedImages(this);
 
     // Reload the active and inactive status effects if necessary
     if (!_activated)
@@ -228,11 +273,12 @@ void MapMode::Reset()
 
     // Reset video engine context properties
     VideoManager->SetStandardCoordSys();
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawFlags(MAP_DRAW_FLAGS);
 
     // Make the map location known globally to other code that may need to know this information
     GlobalManager->GetMapData().SetMap(_map_data_filename, _map_script_filename,
-                                       _map_image.GetFilename(), _map_hud_name.GetString());
+                                       _map_image.GetFilename(), _map_hud_name.GetString(),
+                                       _map_name);
 
     _ResetMusicState();
 
@@ -252,44 +298,63 @@ void MapMode::Reset()
         _object_supervisor->ReloadVisiblePartyMember();
 }
 
-void MapMode::_InitResources()
+std::vector<JobHandle> MapMode::StartLoading(const std::string& data_filename,
+                                             const std::string& script_filename)
 {
-    // Load the miscellaneous map graphics.
-    _dialogue_icon.LoadFromAnimationScript(DIALOGUE_ICON_FILE);
-    ScaleToMapZoomRatio(_dialogue_icon);
+    // Taken over by the map mode once created.
+    AssetManifest::PrefetchImages(AssetManifest::GetMapKey(script_filename));
 
-    // Load the save point animation files.
-    AnimatedImage anim;
-    anim.LoadFromAnimationScript(ACTIVE_SAVE_POINT_FILE1);
-    active_save_point_animations.push_back(anim);
+    std::vector<JobHandle> loading_jobs;
+    loading_jobs.push_back(MapPrefetcher::PrefetchMapData(data_filename));
+    return loading_jobs;
+}
 
-    anim.Clear();
-    anim.LoadFromAnimationScript(ACTIVE_SAVE_POINT_FILE2);
-    active_save_point_animations.push_back(anim);
+#ifdef DEBUG_FEATURES
+void MapMode::DEBUG_ReloadScript(const std::string& filename)
+{
+    if(filename != _map_script_filename && filename != _map_data_filename)
+        return;
 
-    anim.Clear();
-    anim.LoadFromAnimationScript(INACTIVE_SAVE_POINT_FILE1);
-    inactive_save_point_animations.push_back(anim);
+    MapDataHandler& map_data = GlobalManager->GetMapData();
+    if(_camera != nullptr) {
+        map_data.SetSaveLocation(static_cast<uint32_t>(_camera->GetXPosition()),
+                                 static_cast<uint32_t>(_camera->GetYPosition()));
+    }
+
+    // The map is popped along with its Lua objects before the new one is built.
+    const std::string map_data_filename = _map_data_filename;
+    const std::string map_script_filename = _map_script_filename;
+    const uint32_t stamina = _run_stamina;
+    ModeManager->Pop();
+    ModeManager->Push([map_data_filename, map_script_filename, stamina]() {
+        return static_cast<vt_mode_manager::GameMode*>(new MapMode(map_data_filename, map_script_filename, stamina, false));
+    }, StartLoading(map_data_filename, map_script_filename));
+}
+#endif
+
+void MapMode::_InitResources()
+{
+    // The common map media are loaded once, and copied by each map:
+    // The copies share their textures, and follow this map zoom ratio and clock.
+    GlobalMedia& media = GlobalManager->Media();
+    media.LoadMapMedia();
 
-    anim.Clear();
-    anim.LoadFromAnimationScript(INACTIVE_SAVE_POINT_FILE2);
-    inactive_save_point_animations.push_back(anim);
+    _dialogue_icon = media.GetMapDialogueIcon();
+    ScaleToMapZoomRatio(_dialogue_icon);
+    _dialogue_icon.SetClock(&_animation_clock);
 
     // Transform the animation size to correspond to the map zoom ratio.
+    active_save_point_animations = media.GetActiveSavePointAnimations();
     for(uint32_t i = 0; i < active_save_point_animations.size(); ++i)
         ScaleToMapZoomRatio(active_save_point_animations[i]);
 
+    inactive_save_point_animations = media.GetInactiveSavePointAnimations();
     for(uint32_t i = 0; i < inactive_save_point_animations.size(); ++i)
         ScaleToMapZoomRatio(inactive_save_point_animations[i]);
 
     // Init escape points resources
-    active_escape_point_anim.Clear();
-    active_escape_point_anim.LoadFromAnimationScript(ACTIVE_ESCAPE_POINT_FILE);
-
-    inactive_escape_point_anim.Clear();
-    inactive_escape_point_anim.LoadFromAnimationScript(INACTIVE_ESCAPE_POINT_FILE);
-
-    // Transform the animation size to correspond to the map zoom ratio.
+    active_escape_point_anim = media.GetActiveEscapePointAnimation();
+    inactive_escape_point_anim = media.GetInactiveEscapePointAnimation();
     ScaleToMapZoomRatio(active_escape_point_anim);
     ScaleToMapZoomRatio(inactive_escape_point_anim);
 }
@@ -335,12 +400,15 @@ void MapMode::_ResetMusicState()
 
 void MapMode::Update()
 {
+    PROFILE_SCOPE("MapMode::Update");
+
     MapDataHandler& map_data = GlobalManager->GetMapData();
 
     // Update the map frame coords
     // NOTE: It's done before handling pause so that the frame is updated at
     // least once before setting the pause mode, avoiding a crash.
     _UpdateMapFrame();
+    _tile_supervisor->StreamChunks(&_map_frame);
 
     // Process quit and pause events unconditional to the state of map mode
     if(InputManager->QuitPress()) {
@@ -357,14 +425,11 @@ void MapMode::Update()
         return;
     }
 
-    _dialogue_icon.Update();
-
-    // Call the map script's update function
-    if(_update_function.is_valid())
-        luabind::call_function<void>(_update_function);
+    // Call the map script's update functions
+    _script_scheduler.Update(SystemManager->GetUpdateTime());
 
-    // Update all animated tile images
-    _tile_supervisor->Update();
+    // Advance the clock of the animated tile images, which are evaluated when drawn.
+    _animation_clock.Update(SystemManager->GetUpdateTime());
     _object_supervisor->Update();
     _object_supervisor->SortObjects();
 
@@ -442,13 +507,13 @@ void MapMode::Draw()
 {
     VideoManager->PushState();
     VideoManager->SetStandardCoordSys();
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawFlags(MAP_DRAW_FLAGS);
     GetScriptSupervisor().DrawBackground();
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawFlags(MAP_DRAW_FLAGS);
     _DrawMapLayers();
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawFlags(MAP_DRAW_FLAGS);
     GetScriptSupervisor().DrawForeground();
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawFlags(MAP_DRAW_FLAGS);
     _object_supervisor->DrawInteractionIcons();
     VideoManager->PopState();
 }
@@ -457,15 +522,23 @@ void MapMode::DrawPostEffects()
 {
     VideoManager->PushState();
     VideoManager->SetStandardCoordSys();
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawFlags(MAP_DRAW_FLAGS);
 
     // Halos are additive blending made, so they should be applied
-    // as post-effects but before the GUI.
-    _object_supervisor->DrawLights();
+    // as post-effects but before the GUI. They are accumulated
+    // at a lower resolution and added over the scene at once.
+    if (_object_supervisor->HasLights()) {
+        VideoManager->SetRenderPass(RENDER_PASS_LIGHTS);
+        VideoManager->EnableLightRenderTarget();
+        _object_supervisor->DrawLights();
+        VideoManager->DrawLightRenderTarget();
+        VideoManager->SetRenderPass(RENDER_PASS_POST_EFFECTS);
+    }
 
     GetScriptSupervisor().DrawPostEffects();
 
     // Draw the gui, unaffected by potential fading effects.
+    VideoManager->SetRenderPass(RENDER_PASS_GUI);
     _DrawGUI();
 
     if(CurrentState() == STATE_DIALOGUE)
@@ -519,6 +592,57 @@ void MapMode::DeleteMapObject(private_map::MapObject* object)
     _object_supervisor->DeleteObject(object);
 }
 
+void MapMode::SetObjectsPosition(const luabind::object& objects_positions)
+{
+    const ScriptArray array(objects_positions);
+    if(array.GetSize() % 3 != 0)
+        PRINT_WARNING << "The array size isn't a multiple of 3: " << array.GetSize() << std::endl;
+
+    for(uint32_t i = 0; i + 2 < array.GetSize(); i += 3) {
+        MapObject* object = GetArrayObject(array, i, _object_supervisor);
+        if(object)
+            object->SetPosition(array.GetNumber(i + 1), array.GetNumber(i + 2));
+    }
+}
+
+void MapMode::SetSpritesDirection(const luabind::object& sprites_directions)
+{
+    const ScriptArray array(sprites_directions);
+    if(array.GetSize() % 2 != 0)
+        PRINT_WARNING << "The array size isn't a multiple of 2: " << array.GetSize() << std::endl;
+
+    for(uint32_t i = 0; i + 1 < array.GetSize(); i += 2) {
+        VirtualSprite* sprite = array.IsNumber(i) ?
+                                _object_supervisor->GetSprite(static_cast<uint32_t>(array.GetNumber(i))) :
+                                array.GetPointer<VirtualSprite>(i);
+        if(!sprite) {
+            IF_PRINT_WARNING(MAP_DEBUG) << "Invalid sprite at index " << i + 1 << " of the array" << std::endl;
+            continue;
+        }
+        sprite->SetDirection(static_cast<uint16_t>(array.GetNumber(i + 1)));
+    }
+}
+
+void MapMode::SetObjectsVisible(const luabind::object& objects, bool visible)
+{
+    const ScriptArray array(objects);
+    for(uint32_t i = 0; i < array.GetSize(); ++i) {
+        MapObject* object = GetArrayObject(array, i, _object_supervisor);
+        if(object)
+            object->SetVisible(visible);
+    }
+}
+
+void MapMode::SetObjectsCollisionMask(const luabind::object& objects, uint32_t collision_mask)
+{
+    const ScriptArray array(objects);
+    for(uint32_t i = 0; i < array.GetSize(); ++i) {
+        MapObject* object = GetArrayObject(array, i, _object_supervisor);
+        if(object)
+            object->SetCollisionMask(collision_mask);
+    }
+}
+
 void MapMode::SetCamera(private_map::VirtualSprite *sprite, uint32_t duration)
 {
     if(_camera == sprite) {
@@ -568,6 +692,23 @@ void MapMode::SetPartyMemberVisibleSprite(private_map::MapSprite* sprite)
     _object_supervisor->SetPartyMemberVisibleSprite(sprite);
 }
 
+void MapMode::AddScriptUpdate(const std::string& function_name, uint32_t interval)
+{
+    if(!OpenMapTablespace(true))
+        return;
+    _script_scheduler.AddPeriodicFunction(_map_script.ReadFunctionPointer(function_name), interval);
+    _map_script.CloseTable(); // tablespace
+}
+
+void MapMode::AddScriptTrigger(const std::string& condition_function_name, const std::string& function_name)
+{
+    if(!OpenMapTablespace(true))
+        return;
+    _script_scheduler.AddTriggeredFunction(_map_script.ReadFunctionPointer(condition_function_name),
+                                           _map_script.ReadFunctionPointer(function_name));
+    _map_script.CloseTable(); // tablespace
+}
+
 void MapMode::SetAllEnemyStatesToDead()
 {
     _object_supervisor->SetAllEnemyStatesToDead();
@@ -652,9 +793,13 @@ void AddEp1ToMapPath(std::string& map_filename)
 
 bool MapMode::_Load()
 {
+    LoadTrace trace("Map Load Time: " + _map_script_filename);
+    vt_system::TelemetryTimer telemetry_timer("map_load", _map_data_filename);
+
     // Map data
     // Clear out all old map data if existing.
     ScriptManager->DropGlobalTable("map_data");
+    OwnScriptTablespace("map_data");
 
 
     // DEPRECATED: Remove this after episode II release
@@ -665,70 +810,65 @@ bool MapMode::_Load()
         AddEp1ToMapPath(_map_script_filename);
     }
 
-    // Open map script file and read in the basic map properties and tile definitions
-    if(!_map_script.OpenFile(_map_data_filename)) {
-        PRINT_ERROR << "Couldn't open map data file: "
-                    << _map_data_filename << std::endl;
-        return false;
+    // Use the baked map data when it is up to date, as it doesn't go through Lua.
+    // It may already have been read while the previous map was played.
+    // Otherwise, it is read by a worker while the map script is run.
+    BinaryMapData binary_map_data;
+    bool binary_map_data_loaded = MapPrefetcher::TakeMapData(_map_data_filename, binary_map_data);
+    const std::string binary_filename = GetBinaryMapDataFilename(_map_data_filename);
+    if(!binary_map_data_loaded && !IsBinaryMapDataUpToDate(binary_filename, _map_data_filename)) {
+        // The map data script is read with the same descriptor, before the map script.
+        if(!_LoadMapDataScript())
+            return false;
+        trace.EndStage("Map data");
+        if(!_OpenMapScript())
+            return false;
+        trace.EndStage("Map script");
     }
+    else {
+        JobHandle map_data_job;
+        if(!binary_map_data_loaded) {
+            const std::string source_filename = _map_data_filename;
+            map_data_job = JobManager->Schedule([&binary_map_data, &binary_map_data_loaded,
+                                                binary_filename, source_filename]() {
+                binary_map_data_loaded = binary_map_data.Load(binary_filename, source_filename);
+            });
+        }
 
-    if(!_map_script.OpenTable("map_data")) {
-        PRINT_ERROR << "Couldn't open table 'map_data' in: "
+        // The worker uses the map data until it's done.
+        const bool script_opened = _OpenMapScript();
+        trace.EndStage("Map script");
+        JobManager->Wait(map_data_job);
+        trace.EndStage("Baked map data wait");
+        if(!script_opened)
+            return false;
+
+        // The very large maps may only build their tiles geometry near the screen.
+        _tile_supervisor->SetStreaming(_map_script.DoesBoolExist("stream_map_tiles")
+                                       && _map_script.ReadBool("stream_map_tiles"));
+
+        if(binary_map_data_loaded) {
+            if(!_object_supervisor->Load(binary_map_data) || !_tile_supervisor->Load(binary_map_data)) {
+                PRINT_ERROR << "Failed to load the baked map data of: "
                     << _map_data_filename << std::endl;
-        _map_script.CloseFile();
-        return false;
-    }
-
-    // Loads the collision grid
-    if(!_object_supervisor->Load(_map_script)) {
-        PRINT_ERROR << "Failed to load the collision grid from: "
-            << _map_data_filename << std::endl;
-        _map_script.CloseFile();
-        return false;
-    }
-
-    // Instruct the supervisor classes to perform their portion of the load operation
-    if(!_tile_supervisor->Load(_map_script)) {
-        PRINT_ERROR << "Failed to load the tile data from: "
-            << _map_data_filename << std::endl;
-        _map_script.CloseFile();
-        return false;
-    }
-
-    _map_script.CloseAllTables();
-    _map_script.CloseFile(); // Free the map data file once everyhting is loaded
-
-    // Map script
-
-    _map_script_tablespace = ScriptEngine::GetTableSpace(_map_script_filename);
-    if(_map_script_tablespace.empty()) {
-        PRINT_ERROR << "Invalid map script namespace in: "
-                    << _map_script_filename << std::endl;
-        return false;
-    }
-
-    // Clear out all old map data if existing.
-    ScriptManager->DropGlobalTable(_map_script_tablespace);
-
-    // Open map script file and read in the basic map properties and tile definitions
-    if(!_map_script.OpenFile(_map_script_filename)) {
-        PRINT_ERROR << "Couldn't open map script file: "
-                    << _map_script_filename << std::endl;
-        return false;
-    }
-
-    if(_map_script.OpenTablespace().empty()) {
-        PRINT_ERROR << "Couldn't open map script namespace in: "
-                    << _map_script_filename << std::endl;
-        _map_script.CloseFile();
-        return false;
+                _map_script.CloseFile();
+                return false;
+            }
+        }
+        else {
+            // The baked map data file is invalid: The map data script is read before the map script again.
+            _map_script.CloseFile();
+            if(!_LoadMapDataScript() || !_OpenMapScript())
+                return false;
+        }
+        trace.EndStage("Map data");
     }
 
     // Loads the map image and translated location names.
     // Test for empty strings to never trigger the default gettext msg string
     // which contains translation info.
-    std::string map_hud_name = _map_script.ReadString("map_name");
-    _map_hud_name.SetText(map_hud_name.empty() ? ustring() : UTranslate(map_hud_name),
+    _map_name = _map_script.ReadString("map_name");
+    _map_hud_name.SetText(_map_name.empty() ? ustring() : UTranslate(_map_name),
                           TextStyle("map_title"));
     std::string map_hud_subname = _map_script.ReadString("map_subname");
     _map_hud_subname.SetText(map_hud_subname.empty() ? ustring() : UTranslate(map_hud_subname),
@@ -746,6 +886,16 @@ bool MapMode::_Load()
         PRINT_WARNING << "Failed to load map music: " << _music_filename << std::endl;
     else if (!_music_filename.empty())
         _music_audio_state = AUDIO_STATE_PLAYING; // Set the default music state to "playing".
+    trace.EndStage("Map image and music");
+
+    // The texture atlases baked for the map, so that the images in them aren't read one by one.
+    if(_map_script.DoesTableExist("texture_atlases")) {
+        std::vector<std::string> texture_atlases;
+        _map_script.ReadStringVector("texture_atlases", texture_atlases);
+        for(uint32_t i = 0; i < texture_atlases.size(); ++i)
+            LoadTextureAtlas(texture_atlases[i]);
+        trace.EndStage("Texture atlases");
+    }
 
     // Call the map script's custom load function and get a reference to all other script function pointers
     luabind::object map_table(luabind::from_stack(_map_script.GetLuaState(), vt_script::private_script::STACK_TOP));
@@ -753,7 +903,10 @@ bool MapMode::_Load()
 
     bool loading_succeeded = true;
     if(function.is_valid()) {
+        // The animation frames of the sprites created are packed together.
+        TextureManager->BeginSpriteAtlas();
         try {
+            ScriptCallTimer timer("map Load", function);
             luabind::call_function<void>(function, this);
         } catch(const luabind::error &e) {
             ScriptManager->HandleLuaError(e);
@@ -762,9 +915,11 @@ bool MapMode::_Load()
             ScriptManager->HandleCastError(e);
             loading_succeeded = false;
         }
+        TextureManager->EndSpriteAtlas();
     } else {
         loading_succeeded = false;
     }
+    trace.EndStage("Map Load() function");
 
     if(!loading_succeeded) {
         PRINT_ERROR << "Invalid map Load() function in "
@@ -776,7 +931,7 @@ bool MapMode::_Load()
         return false;
     }
 
-    _update_function = _map_script.ReadFunctionPointer("Update");
+    _script_scheduler.SetFrameFunction(_map_script.ReadFunctionPointer("Update"));
 
     // If the "home map" flag is set, let's save the map as new home in case of escape.
     if (_map_script.ReadBool("is_home_map")) {
@@ -788,6 +943,78 @@ bool MapMode::_Load()
     return true;
 }
 
+bool MapMode::_OpenMapScript()
+{
+    _map_script_tablespace = ScriptEngine::GetTableSpace(_map_script_filename);
+    if(_map_script_tablespace.empty()) {
+        PRINT_ERROR << "Invalid map script namespace in: "
+                    << _map_script_filename << std::endl;
+        return false;
+    }
+
+    // Clear out all old map data if existing.
+    ScriptManager->DropGlobalTable(_map_script_tablespace);
+    OwnScriptTablespace(_map_script_tablespace);
+
+    // Open map script file and read in the basic map properties and tile definitions
+    if(!_map_script.OpenFile(_map_script_filename)) {
+        PRINT_ERROR << "Couldn't open map script file: "
+                    << _map_script_filename << std::endl;
+        return false;
+    }
+
+    if(_map_script.OpenTablespace().empty()) {
+        PRINT_ERROR << "Couldn't open map script namespace in: "
+                    << _map_script_filename << std::endl;
+        _map_script.CloseFile();
+        return false;
+    }
+    return true;
+}
+
+bool MapMode::_LoadMapDataScript()
+{
+    // Open map script file and read in the basic map properties and tile definitions
+    if(!_map_script.OpenFile(_map_data_filename)) {
+        PRINT_ERROR << "Couldn't open map data file: "
+                    << _map_data_filename << std::endl;
+        return false;
+    }
+
+    if(!_map_script.OpenTable("map_data")) {
+        PRINT_ERROR << "Couldn't open table 'map_data' in: "
+                    << _map_data_filename << std::endl;
+        _map_script.CloseFile();
+        return false;
+    }
+
+    // The map script isn't run yet when the map data isn't baked,
+    // so the very large maps may tell to stream their tiles there as well.
+    if(_map_script.DoesBoolExist("stream_map_tiles"))
+        _tile_supervisor->SetStreaming(_map_script.ReadBool("stream_map_tiles"));
+
+    // Loads the collision grid
+    if(!_object_supervisor->Load(_map_script)) {
+        PRINT_ERROR << "Failed to load the collision grid from: "
+            << _map_data_filename << std::endl;
+        _map_script.CloseFile();
+        return false;
+    }
+
+    // Instruct the supervisor classes to perform their portion of the load operation
+    if(!_tile_supervisor->Load(_map_script)) {
+        PRINT_ERROR << "Failed to load the tile data from: "
+            << _map_data_filename << std::endl;
+        _map_script.CloseFile();
+        return false;
+    }
+
+    _map_script.CloseAllTables();
+    _map_script.CloseFile(); // Free the map data file once everyhting is loaded
+
+    return true;
+}
+
 void MapMode::_CreateMinimap()
 {
     if(_minimap) {
@@ -1188,6 +1415,8 @@ void MapMode::_DrawDebugGrid()
 
 void MapMode::_DrawMapLayers()
 {
+    PROFILE_SCOPE("MapMode::_DrawMapLayers");
+
     VideoManager->PushState();
     VideoManager->SetStandardCoordSys();
 
@@ -1203,9 +1432,11 @@ void MapMode::_DrawMapLayers()
     //       resolutions.
     //
 
+    VideoManager->SetRenderPass(RENDER_PASS_TILES);
     _tile_supervisor->DrawLayers(&_map_frame, GROUND_LAYER);
 
     // Save points are engraved on the ground, and thus shouldn't be drawn after walls.
+    VideoManager->SetRenderPass(RENDER_PASS_OBJECTS);
     _object_supervisor->DrawMapPoints();
 
     _object_supervisor->DrawFlatGroundObjects();
@@ -1213,9 +1444,13 @@ void MapMode::_DrawMapLayers()
     _object_supervisor->DrawPassObjects();
     _object_supervisor->DrawGroundObjects(true); // Second draw pass of ground objects.
 
+    VideoManager->SetRenderPass(RENDER_PASS_TILES);
     _tile_supervisor->DrawLayers(&_map_frame, SKY_LAYER);
 
+    VideoManager->SetRenderPass(RENDER_PASS_OBJECTS);
     _object_supervisor->DrawSkyObjects();
+    _object_supervisor->DrawEmotes();
+    VideoManager->SetRenderPass(RENDER_PASS_OTHER);
 
     if (VideoManager->DebugInfoOn()) {
         _object_supervisor->DrawCollisionArea(&_map_frame);
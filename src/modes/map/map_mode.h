@@ -35,6 +35,7 @@
 #include "map_utils.h"
 #include "map_minimap.h"
 #include "map_status_effects.h"
+#include "map_script_scheduler.h"
 
 #include "engine/audio/audio_descriptor.h"
 
@@ -124,6 +125,16 @@ public:
 
     ~MapMode();
 
+    /** \brief Starts loading what a map needs without the OpenGL context or the Lua state, before it is created.
+    *** \param data_filename The name of the Lua file that retains all data about the map to create
+    *** \param script_filename The name of the Lua file that retains all data about script to load
+    *** \return The loading jobs, to push along with the map mode factory.
+    *** The baked map data is read by a job, and the images listed in the asset manifest are decoded,
+    *** so that both run during the push fade out.
+    **/
+    static std::vector<vt_system::JobHandle> StartLoading(const std::string& data_filename,
+                                                            const std::string& script_filename);
+
     //! \brief Resets appropriate class members. Called whenever the MapMode object is made the active game mode.
     void Reset();
 
@@ -140,6 +151,13 @@ public:
     //! \brief The highest level draw function for stuff unaffected by light and fade effects.
     void DrawPostEffects();
 
+#ifdef DEBUG_FEATURES
+    /** \brief Loads the map again when its script or data file changed on disk,
+    *** with the character where the camera stands if the map script uses the save location.
+    **/
+    void DEBUG_ReloadScript(const std::string& filename) override;
+#endif
+
     // The methods below this line are not intended to be used outside of the map code
 
     //! \brief Empties the state stack and places an invalid state on top
@@ -161,6 +179,25 @@ public:
     //! \brief Removes an object from memory
     void DeleteMapObject(private_map::MapObject* obj);
 
+    /** \name Batched object functions
+    *** These functions change many objects in one script call, the objects
+    *** being given either as map objects or as object ids. The invalid entries
+    *** are skipped with a warning.
+    **/
+    //@{
+    //! \brief Sets the positions of objects given as { object, x, y, object, x, y, ... }.
+    void SetObjectsPosition(const luabind::object& objects_positions);
+
+    //! \brief Sets the directions of sprites given as { sprite, direction, sprite, direction, ... }.
+    void SetSpritesDirection(const luabind::object& sprites_directions);
+
+    //! \brief Shows or hides the objects given as { object, object, ... }.
+    void SetObjectsVisible(const luabind::object& objects, bool visible);
+
+    //! \brief Sets the collision mask of the objects given as { object, object, ... }.
+    void SetObjectsCollisionMask(const luabind::object& objects, uint32_t collision_mask);
+    //@}
+
     //! \brief Vectors containing the save points animations (when the character is in or not).
     std::vector<vt_video::AnimatedImage> active_save_point_animations;
     std::vector<vt_video::AnimatedImage> inactive_save_point_animations;
@@ -221,6 +258,27 @@ public:
         return _map_script_filename;
     }
 
+    std::string GetReportDescription() const override {
+        return _map_data_filename + ", " + _map_script_filename;
+    }
+
+    /** \brief Adds a map script function called at a lower rate than every frame.
+    *** \param function_name The function name, in the map script tablespace.
+    *** \param interval The time between two calls, in milliseconds.
+    **/
+    void AddScriptUpdate(const std::string& function_name, uint32_t interval);
+
+    /** \brief Adds a map script function called once, when a condition function returns true.
+    *** \param condition_function_name The condition function name, in the map script tablespace.
+    *** \param function_name The function name, in the map script tablespace.
+    **/
+    void AddScriptTrigger(const std::string& condition_function_name, const std::string& function_name);
+
+    //! \brief Sets the time the map script update functions may take each frame, in microseconds.
+    void SetScriptUpdateBudget(uint32_t budget) {
+        _script_scheduler.SetBudget(budget);
+    }
+
     private_map::TileSupervisor* GetTileSupervisor() const {
         return _tile_supervisor;
     }
@@ -249,6 +307,11 @@ public:
         return _map_frame;
     }
 
+    //! \brief The clock followed by the map tile animations, advanced by each map update.
+    const vt_video::AnimationClock& GetAnimationClock() const {
+        return _animation_clock;
+    }
+
     private_map::VirtualSprite* GetCamera() const {
         return _camera;
     }
@@ -488,6 +551,9 @@ private:
     vt_video::TextImage _map_hud_name;
     vt_video::TextImage _map_hud_subname;
 
+    //! \brief The untranslated map name, as written in the map script.
+    std::string _map_name;
+
     /** \brief The interface to the file which contains all the map's stored data and subroutines.
     *** This class generally performs a large amount of communication with this script continuously.
     *** The script remains open for as long as the MapMode object exists.
@@ -514,12 +580,13 @@ private:
     //! \brief Handles escape map sub-menu.
     private_map::EscapeSupervisor* _escape_supervisor;
 
-    /** \brief A script function which assists with the MapMode#Update method
-    *** This function implements any custom update code that the specific map needs to be performed.
-    *** The most common operation that this script function performs is to check for trigger conditions
-    *** that cause map events to occur
+    /** \brief Calls the script functions which assist with the MapMode#Update method
+    *** The map script Update() function implements any custom update code that the specific map
+    *** needs to be performed. The most common operation that this script function performs is to
+    *** check for trigger conditions that cause map events to occur, which can also be done
+    *** at a lower rate by the functions added with AddScriptUpdate() and AddScriptTrigger().
     **/
-    luabind::object _update_function;
+    private_map::MapScriptScheduler _script_scheduler;
 
     // ----- Members : Properties and State -----
 
@@ -603,6 +670,9 @@ private:
     //! \brief An icon graphic which appears over the heads of NPCs who have dialogue that has not been read by the player
     vt_video::AnimatedImage _dialogue_icon;
 
+    //! \brief The clock of the map tile animations.
+    vt_video::AnimationClock _animation_clock;
+
     //! \brief Image which underlays the stamina bar for running
     //! \note This pointer is a reference handled by the GlobalMedia class, don't delete it!
     vt_video::StillImage* _stamina_bar_background;
@@ -659,6 +729,14 @@ private:
     //! \brief Loads all map data contained in the Lua file that defines the map
     bool _Load();
 
+    //! \brief Runs the map script file, and opens its tablespace.
+    bool _OpenMapScript();
+
+    /** \brief Loads the collision grid and tile layers from the map data Lua file.
+    *** Used when there is no up to date baked map data file.
+    **/
+    bool _LoadMapDataScript();
+
     /** Triggers the minimap creation either by trying to load the minimap file given.
     *** Or by creating a minimap procedurally.
     **/
@@ -25,8 +25,14 @@
 #include "common/global/global.h"
 #include "common/global/actors/global_character.h"
 
+#include "engine/frame_profiler.h"
+#include "engine/job_system.h"
+#include "engine/system.h"
+
 #include "utils/utils_numeric.h"
 
+#include <limits>
+
 using namespace vt_common;
 
 namespace vt_map
@@ -35,11 +41,65 @@ namespace vt_map
 namespace private_map
 {
 
+//! \brief The distance kept between a swept sprite and the obstacle it stopped against.
+const float SWEEP_CONTACT_DISTANCE = 0.001f;
+
+/** \brief The longest step around an obstacle corner per update.
+*** Without this cap, the step is too long when running and/or with a high walk speed,
+*** and can cause glitches.
+**/
+const float SWEEP_EDGE_STEP = 0.09f;
+
+/** \brief The part cut from the right and bottom sides of the swept grid cells and top and left map bounds,
+*** since a collision rectangle touching them on those sides doesn't overlap them.
+**/
+const float SWEEP_OPEN_SIDE = 0.0001f;
+
+//! \brief The minimum number of sprites moves swept by each job of the movement phase.
+const uint32_t MOVE_SWEEP_GRAIN = 8;
+
+namespace
+{
+
+//! \brief Gives when a segment moving along an axis enters and exits an obstacle segment.
+//! \return False when the segment doesn't move and never overlaps the obstacle.
+bool _GetSweepAxisTimes(float min, float max, float obstacle_min, float obstacle_max, float delta,
+                        float& entry, float& exit)
+{
+    if(delta > 0.0f) {
+        entry = (obstacle_min - max) / delta;
+        exit = (obstacle_max - min) / delta;
+    }
+    else if(delta < 0.0f) {
+        entry = (obstacle_max - min) / delta;
+        exit = (obstacle_min - max) / delta;
+    }
+    else {
+        if(max < obstacle_min || min > obstacle_max)
+            return false;
+        entry = -std::numeric_limits<float>::max();
+        exit = std::numeric_limits<float>::max();
+    }
+    return true;
+}
+
+//! \brief Gives the fraction of a move done when stopping just before the time of impact.
+float _GetContactTime(float time, float normal_delta)
+{
+    if(time <= 0.0f || normal_delta == 0.0f)
+        return 0.0f;
+    return std::max(0.0f, time - SWEEP_CONTACT_DISTANCE / std::fabs(normal_delta));
+}
+
+} // anonymous namespace
+
 ObjectSupervisor::ObjectSupervisor() :
     _num_grid_x_axis(0),
     _num_grid_y_axis(0),
     _last_id(1), //! Every object Id must be > 0 since 0 is reserved for speakerless dialogues.
-    _visible_party_member(nullptr)
+    _visible_party_member(nullptr),
+    _path_generation(0),
+    _ambient_sound_time_remaining(0)
 {}
 
 ObjectSupervisor::~ObjectSupervisor()
@@ -78,6 +138,19 @@ VirtualSprite* ObjectSupervisor::GetSprite(uint32_t object_id)
     return sprite;
 }
 
+void ObjectSupervisor::UpdateSpritesDialogueStatus(const std::string& dialogue_id)
+{
+    for(uint32_t i = 0; i < _all_objects.size(); ++i) {
+        MapObject* object = _all_objects[i];
+        if(object == nullptr || object->GetObjectType() != SPRITE_TYPE)
+            continue;
+
+        MapSprite* sprite = static_cast<MapSprite*>(object);
+        if(sprite->IsReferencingDialogue(dialogue_id))
+            sprite->UpdateDialogueStatus();
+    }
+}
+
 void ObjectSupervisor::RegisterObject(MapObject* object)
 {
     if (!object || object->GetObjectID() <= 0) {
@@ -87,27 +160,35 @@ void ObjectSupervisor::RegisterObject(MapObject* object)
 
     uint32_t obj_id = (uint32_t)object->GetObjectID();
     // Adds the object to the all object collection.
-    if (obj_id >= _all_objects.size())
+    if (obj_id >= _all_objects.size()) {
         _all_objects.resize(obj_id + 1, nullptr);
+        _hot_data.resize(obj_id + 1);
+    }
     _all_objects[obj_id] = object;
 
     switch(object->GetObjectDrawLayer()) {
     case FLATGROUND_OBJECT:
         _flat_ground_objects.push_back(object);
+        _flat_ground_object_ids.push_back(obj_id);
         break;
     case GROUND_OBJECT:
         _ground_objects.push_back(object);
+        _ground_object_ids.push_back(obj_id);
         break;
     case PASS_OBJECT:
         _pass_objects.push_back(object);
+        _pass_object_ids.push_back(obj_id);
         break;
     case SKY_OBJECT:
         _sky_objects.push_back(object);
+        _sky_object_ids.push_back(obj_id);
         break;
     case NO_LAYER_OBJECT:
     default: // Nothing to do. the object is registered in all objects only.
         break;
     }
+
+    UpdateSpatialHash(object);
 }
 
 void ObjectSupervisor::AddAmbientSound(SoundObject* object)
@@ -118,6 +199,7 @@ void ObjectSupervisor::AddAmbientSound(SoundObject* object)
     }
 
     _sound_objects.push_back(object);
+    _UpdateSoundSpatialHash(object);
 }
 
 void ObjectSupervisor::AddLight(Light* light)
@@ -215,8 +297,12 @@ void ObjectSupervisor::DeleteObject(MapObject* object)
         return;
     }
 
+    _spatial_hash.RemoveObject(object);
+
+    std::vector<uint16_t>* object_ids = _GetObjectIdsFromDrawLayer(object->GetObjectDrawLayer());
     for(; it != it_end; ++it) {
         if (*it == object) {
+            object_ids->erase(object_ids->begin() + (it - to_iterate->begin()));
             to_iterate->erase(it);
             break;
         }
@@ -224,12 +310,37 @@ void ObjectSupervisor::DeleteObject(MapObject* object)
     delete object;
 }
 
+//! \brief Insertion sorts the objects in draw order.
+//! The order barely changes from one frame to the next, so this is about linear,
+//! only moving the objects that passed a neighbor. Being stable, objects with the same y
+//! also keep their relative order rather than flickering.
+//! The y positions are read from the hot data, so that the objects themselves aren't touched.
+void ObjectSupervisor::_SortObjectsInDrawOrder(std::vector<MapObject*>& objects, std::vector<uint16_t>& object_ids)
+{
+    for(uint32_t i = 1; i < object_ids.size(); ++i) {
+        const uint16_t object_id = object_ids[i];
+        const float y = _hot_data[object_id].y;
+        if(!(y < _hot_data[object_ids[i - 1]].y))
+            continue;
+
+        MapObject* object = objects[i];
+        uint32_t j = i;
+        do {
+            objects[j] = objects[j - 1];
+            object_ids[j] = object_ids[j - 1];
+            --j;
+        } while(j > 0 && y < _hot_data[object_ids[j - 1]].y);
+        objects[j] = object;
+        object_ids[j] = object_id;
+    }
+}
+
 void ObjectSupervisor::SortObjects()
 {
-    std::sort(_flat_ground_objects.begin(), _flat_ground_objects.end(), MapObject_Ptr_Less());
-    std::sort(_ground_objects.begin(), _ground_objects.end(), MapObject_Ptr_Less());
-    std::sort(_pass_objects.begin(), _pass_objects.end(), MapObject_Ptr_Less());
-    std::sort(_sky_objects.begin(), _sky_objects.end(), MapObject_Ptr_Less());
+    _SortObjectsInDrawOrder(_flat_ground_objects, _flat_ground_object_ids);
+    _SortObjectsInDrawOrder(_ground_objects, _ground_object_ids);
+    _SortObjectsInDrawOrder(_pass_objects, _pass_object_ids);
+    _SortObjectsInDrawOrder(_sky_objects, _sky_object_ids);
 }
 
 bool ObjectSupervisor::Load(vt_script::ReadScriptDescriptor &map_file)
@@ -242,17 +353,60 @@ bool ObjectSupervisor::Load(vt_script::ReadScriptDescriptor &map_file)
     // Construct the collision grid
     map_file.OpenTable("map_grid");
     _num_grid_y_axis = map_file.GetTableSize();
+    std::vector<uint32_t> row;
     for(uint16_t y = 0; y < _num_grid_y_axis; ++y) {
-        _collision_grid.push_back(std::vector<uint32_t>());
-        map_file.ReadUIntVector(y, _collision_grid.back());
+        row.clear();
+        map_file.ReadUIntVector(y, row);
+
+        // The first row gives the grid width.
+        if(y == 0) {
+            _num_grid_x_axis = row.size();
+            _collision_grid.Resize(_num_grid_x_axis, _num_grid_y_axis);
+        }
+        if(row.size() != _num_grid_x_axis) {
+            PRINT_WARNING << "Invalid map grid row size: " << row.size() << " at row: " << y
+                          << " in map file: " << map_file.GetFilename() << std::endl;
+        }
+
+        for(uint32_t x = 0; x < row.size() && x < _num_grid_x_axis; ++x)
+            _collision_grid.SetBlocked(x, y, row[x] > 0);
     }
     map_file.CloseTable();
-    _num_grid_x_axis = _collision_grid[0].size();
+
+    _clearance_map.Build(_collision_grid);
+    _InitializeSpatialHash();
     return true;
 }
 
+bool ObjectSupervisor::Load(const BinaryMapData& map_data)
+{
+    _num_grid_x_axis = map_data.GetGridWidth();
+    _num_grid_y_axis = map_data.GetGridHeight();
+    _collision_grid.Assign(_num_grid_x_axis, _num_grid_y_axis, map_data.GetCollisionWords());
+
+    _clearance_map.Build(_collision_grid);
+    _InitializeSpatialHash();
+    return true;
+}
+
+void ObjectSupervisor::_InitializeSpatialHash()
+{
+    // Now that the grid size is known, bucket the objects created beforehand.
+    _spatial_hash.Initialize(_num_grid_x_axis, _num_grid_y_axis);
+    for(uint32_t i = 0; i < _all_objects.size(); ++i)
+        UpdateSpatialHash(_all_objects[i]);
+
+    _sound_spatial_hash.Initialize(_num_grid_x_axis, _num_grid_y_axis);
+    for(uint32_t i = 0; i < _sound_objects.size(); ++i)
+        _UpdateSoundSpatialHash(_sound_objects[i]);
+}
+
 void ObjectSupervisor::Update()
 {
+    PROFILE_SCOPE("ObjectSupervisor::Update");
+
+    _UpdateMoves();
+
     for(uint32_t i = 0; i < _flat_ground_objects.size(); ++i)
         _flat_ground_objects[i]->Update();
     for(uint32_t i = 0; i < _ground_objects.size(); ++i)
@@ -275,6 +429,89 @@ void ObjectSupervisor::Update()
     _UpdateAmbientSounds();
 }
 
+void ObjectSupervisor::_UpdateMoves()
+{
+    PROFILE_SCOPE("ObjectSupervisor::_UpdateMoves");
+
+    _move_sprites.clear();
+    _move_start_x.clear();
+    _move_start_y.clear();
+    _move_dx.clear();
+    _move_dy.clear();
+
+    // Gather the moves in the draw layers update order.
+    _GatherMoves(_flat_ground_objects);
+    _GatherMoves(_ground_objects);
+    _GatherMoves(_pass_objects);
+    _GatherMoves(_sky_objects);
+
+    const uint32_t move_count = _move_sprites.size();
+    if(move_count == 0)
+        return;
+    _move_sweeps.resize(move_count);
+
+    // The moves are independent of each other against everything but the sprites.
+    vt_system::JobHandle job = vt_system::JobManager->ParallelFor(move_count, MOVE_SWEEP_GRAIN,
+        [this](uint32_t begin, uint32_t end) {
+            std::vector<SweepObstacle> obstacles;
+            std::vector<MapObject*> nearby_objects;
+            for(uint32_t i = begin; i < end; ++i) {
+                _SweepCollision(_move_sprites[i], _move_dx[i], _move_dy[i], SWEEP_STATIC,
+                                obstacles, nearby_objects, _move_sweeps[i]);
+            }
+        });
+    vt_system::JobManager->Wait(job);
+
+    // Finish the moves in order, so that each sprite sees the ones before it already moved.
+    for(uint32_t i = 0; i < move_count; ++i) {
+        VirtualSprite* sprite = _move_sprites[i];
+
+        // A sprite moved meanwhile, e.g. by an event started by the moves before,
+        // is swept again. So are the ones near other sprites.
+        bool sweep_again = (sprite->GetXPosition() != _move_start_x[i]
+                            || sprite->GetYPosition() != _move_start_y[i]);
+        if(!sweep_again) {
+            _GatherSweepObstacles(sprite, _GetSweptArea(sprite, _move_dx[i], _move_dy[i]), SWEEP_SPRITES,
+                                  _sweep_obstacles, _nearby_objects);
+            sweep_again = !_sweep_obstacles.empty();
+        }
+        if(sweep_again)
+            SweepCollision(sprite, _move_dx[i], _move_dy[i], _move_sweeps[i]);
+
+        sprite->FinishMove(_move_dx[i], _move_dy[i], _move_sweeps[i]);
+    }
+}
+
+void ObjectSupervisor::_GatherMoves(const std::vector<MapObject*>& objects)
+{
+    for(uint32_t i = 0; i < objects.size(); ++i) {
+        MapObject* object = objects[i];
+        const MAP_OBJECT_TYPE type = object->GetObjectType();
+        if(type != VIRTUAL_TYPE && type != SPRITE_TYPE && type != ENEMY_TYPE)
+            continue;
+
+        VirtualSprite* sprite = static_cast<VirtualSprite*>(object);
+        float dx = 0.0f;
+        float dy = 0.0f;
+        if(!sprite->StartMove(dx, dy))
+            continue;
+
+        _move_sprites.push_back(sprite);
+        _move_start_x.push_back(sprite->GetXPosition());
+        _move_start_y.push_back(sprite->GetYPosition());
+        _move_dx.push_back(dx);
+        _move_dy.push_back(dy);
+    }
+}
+
+//! \brief Tells whether a visible object image is within the screen edges.
+//! The objects check it again while drawing, but this spares the virtual calls
+//! of the many objects away from the screen.
+static bool _IsOnScreen(const MapObject* object, const Rectangle2D& screen_edges)
+{
+    return object->IsVisible() && object->GetGridImageRectangle().IntersectsWith(screen_edges);
+}
+
 void ObjectSupervisor::DrawMapPoints()
 {
     for(uint32_t i = 0; i < _save_points.size(); ++i) {
@@ -285,42 +522,66 @@ void ObjectSupervisor::DrawMapPoints()
     }
 }
 
-void ObjectSupervisor::DrawFlatGroundObjects()
+//! \brief Tells whether a visible object image is within the screen edges, from its hot data.
+static bool _IsOnScreen(const MapObjectHotData& hot_data, const Rectangle2D& screen_edges)
 {
-    for(uint32_t i = 0; i < _flat_ground_objects.size(); ++i) {
-        _flat_ground_objects[i]->Draw();
+    return hot_data.visible && hot_data.image_rectangle.IntersectsWith(screen_edges);
+}
+
+void ObjectSupervisor::_DrawObjects(const std::vector<MapObject*>& objects, const std::vector<uint16_t>& object_ids)
+{
+    const Rectangle2D& screen_edges = MapMode::CurrentInstance()->GetMapFrame().screen_edges;
+    for(uint32_t i = 0; i < object_ids.size(); ++i) {
+        if(_IsOnScreen(_hot_data[object_ids[i]], screen_edges))
+            objects[i]->Draw();
     }
 }
 
+void ObjectSupervisor::DrawFlatGroundObjects()
+{
+    _DrawObjects(_flat_ground_objects, _flat_ground_object_ids);
+}
+
 void ObjectSupervisor::DrawGroundObjects(const bool second_pass)
 {
-    for(uint32_t i = 0; i < _ground_objects.size(); i++) {
-        if(_ground_objects[i]->IsDrawOnSecondPass() == second_pass) {
+    const Rectangle2D& screen_edges = MapMode::CurrentInstance()->GetMapFrame().screen_edges;
+    for(uint32_t i = 0; i < _ground_object_ids.size(); i++) {
+        const MapObjectHotData& hot_data = _hot_data[_ground_object_ids[i]];
+        if(hot_data.draw_on_second_pass == second_pass && _IsOnScreen(hot_data, screen_edges))
             _ground_objects[i]->Draw();
-        }
     }
 }
 
 void ObjectSupervisor::DrawPassObjects()
 {
-    for(uint32_t i = 0; i < _pass_objects.size(); i++) {
-        _pass_objects[i]->Draw();
-    }
+    _DrawObjects(_pass_objects, _pass_object_ids);
 }
 
 void ObjectSupervisor::DrawSkyObjects()
 {
-    for(uint32_t i = 0; i < _sky_objects.size(); i++) {
-        _sky_objects[i]->Draw();
-    }
+    _DrawObjects(_sky_objects, _sky_object_ids);
 }
 
 void ObjectSupervisor::DrawLights()
 {
-    for(uint32_t i = 0; i < _halos.size(); ++i)
-        _halos[i]->Draw();
-    for(uint32_t i = 0; i < _lights.size(); ++i)
-        _lights[i]->Draw();
+    const Rectangle2D& screen_edges = MapMode::CurrentInstance()->GetMapFrame().screen_edges;
+    for(uint32_t i = 0; i < _halos.size(); ++i) {
+        if(_IsOnScreen(_halos[i], screen_edges))
+            _halos[i]->Draw();
+    }
+    for(uint32_t i = 0; i < _lights.size(); ++i) {
+        if(_IsOnScreen(_lights[i], screen_edges))
+            _lights[i]->Draw();
+    }
+}
+
+void ObjectSupervisor::DrawEmotes()
+{
+    for(uint32_t i = 0; i < _all_objects.size(); ++i) {
+        MapObject* object = _all_objects[i];
+        if(object != nullptr && object->HasEmote())
+            object->DrawEmote();
+    }
 }
 
 void ObjectSupervisor::DrawInteractionIcons()
@@ -334,12 +595,23 @@ void ObjectSupervisor::DrawInteractionIcons()
     if (!map_mode->IsShowGUI() || map_mode->IsCameraOnVirtualFocus())
         return;
 
+    const Rectangle2D& screen_edges = map_mode->GetMapFrame().screen_edges;
     for(uint32_t i = 0; i < _ground_objects.size(); i++) {
-        if (_ground_objects[i]->GetObjectType() == SPRITE_TYPE) {
-            MapSprite* mapSprite = static_cast<MapSprite *>(_ground_objects[i]);
-            mapSprite->DrawDialogIcon();
-        }
-        _ground_objects[i]->DrawInteractionIcon();
+        MapObject* object = _ground_objects[i];
+
+        // The dialogue state is cached by the sprites: Only the ones with an icon to show are checked further.
+        MapSprite* map_sprite = nullptr;
+        if (object->GetObjectType() == SPRITE_TYPE && static_cast<MapSprite *>(object)->ShowsDialogueIcon())
+            map_sprite = static_cast<MapSprite *>(object);
+        if (map_sprite == nullptr && !object->HasInteractionIcon())
+            continue;
+
+        if(!_IsOnScreen(_hot_data[_ground_object_ids[i]], screen_edges))
+            continue;
+
+        if (map_sprite != nullptr)
+            map_sprite->DrawDialogIcon();
+        object->DrawInteractionIcon();
     }
     for(uint32_t i = 0; i < _zones.size(); i++) {
         _zones[i]->DrawInteractionIcon();
@@ -386,41 +658,54 @@ void ObjectSupervisor::_UpdateMapPoints()
 
 void ObjectSupervisor::_UpdateAmbientSounds()
 {
-    // Clear up objects volumes before new update
-    _sound_object_highest_volumes.clear();
+    // The volumes are only updated every now and then, rather than each frame.
+    _ambient_sound_time_remaining -= static_cast<int32_t>(vt_system::SystemManager->GetUpdateTime());
+    if(_ambient_sound_time_remaining > 0)
+        return;
+    _ambient_sound_time_remaining = AMBIENT_SOUND_UPDATE_TIME;
 
-    for(std::vector<SoundObject *>::iterator it = _sound_objects.begin();
-            it != _sound_objects.end(); ++it) {
-        (*it)->UpdateVolume();
-
-        // Register the sound as highest if no other sound was already as high.
-        bool found = false;
-        for(auto it2 = _sound_object_highest_volumes.begin();
-                it2 != _sound_object_highest_volumes.end(); ++it2) {
-            if ((*it)->GetSoundDescriptor() == (*it2)->GetSoundDescriptor()) {
-                found = true;
-                // If we found a higher sound, we swap the reference.
-                if ((*it)->GetSoundVolume() > (*it2)->GetSoundVolume())
-                    *it2 = *it;
-            }
-        }
-        if (!found) {
-            // If the sounds wasn't found, we add it.
-            _sound_object_highest_volumes.push_back(*it);
-        }
+    MapMode *map_mode = MapMode::CurrentInstance();
+    if(!map_mode)
+        return;
+
+    const Rectangle2D& screen_edges = map_mode->GetMapFrame().screen_edges;
+    const Position2D center(screen_edges.left + (screen_edges.right - screen_edges.left) / 2.0f,
+                            screen_edges.top + (screen_edges.bottom - screen_edges.top) / 2.0f);
+
+    // Only the sounds whose audible area contains the camera center can be heard.
+    // The ones elected last time are updated as well, so that they fade out when left behind.
+    _sound_spatial_hash.FindObjects(Rectangle2D(center.x, center.x, center.y, center.y), _nearby_objects);
+    for(uint32_t i = 0; i < _sound_object_highest_volumes.size(); ++i)
+        _nearby_objects.push_back(_sound_object_highest_volumes[i]);
+
+    // Elect the loudest object of each shared sound descriptor.
+    _loudest_sound_objects.clear();
+    for(uint32_t i = 0; i < _nearby_objects.size(); ++i) {
+        SoundObject* sound_object = static_cast<SoundObject*>(_nearby_objects[i]);
+        sound_object->UpdateVolume(center);
+
+        SoundObject*& loudest = _loudest_sound_objects[sound_object->GetSoundDescriptor()];
+        if(!loudest || sound_object->GetSoundVolume() > loudest->GetSoundVolume())
+            loudest = sound_object;
     }
 
     //PRINT_DEBUG << "Number of ambient sounds: " << _sound_objects.size() << std::endl;
-    //PRINT_DEBUG << "Number of selected ambient sounds: " << _sound_object_highest_volumes.size() << std::endl;
+    //PRINT_DEBUG << "Number of selected ambient sounds: " << _loudest_sound_objects.size() << std::endl;
 
-    // Set the volumes of the elected sounds
-    // Since we share sound descriptor instances, all sounds are updated in any case.
-    for(auto it = _sound_object_highest_volumes.begin();
-            it != _sound_object_highest_volumes.end(); ++it) {
-        (*it)->ApplyVolume();
+    // Set the volumes of the elected sounds, and keep the ones still audible for the next update.
+    _sound_object_highest_volumes.clear();
+    for(auto it = _loudest_sound_objects.begin(); it != _loudest_sound_objects.end(); ++it) {
+        it->second->ApplyVolume();
+        if(it->second->GetSoundVolume() > 0.0f)
+            _sound_object_highest_volumes.push_back(it->second);
     }
 }
 
+void ObjectSupervisor::_UpdateSoundSpatialHash(SoundObject* sound_object)
+{
+    _sound_spatial_hash.UpdateObject(sound_object, sound_object->GetAudibleArea());
+}
+
 void ObjectSupervisor::_DrawMapZones()
 {
     for(uint32_t i = 0; i < _zones.size(); ++i)
@@ -454,6 +739,30 @@ MapObject* ObjectSupervisor::_FindNearestMapPoint(const VirtualSprite* sprite)
     return nullptr;
 }
 
+MapObjectDrawLayer ObjectSupervisor::_GetSearchedDrawLayer(MapObjectDrawLayer layer) const
+{
+    // Like _GetObjectsFromDrawLayer(), objects out of any layer are checked against the ground ones.
+    if(layer == NO_LAYER_OBJECT)
+        return GROUND_OBJECT;
+    return layer;
+}
+
+std::vector<uint16_t>* ObjectSupervisor::_GetObjectIdsFromDrawLayer(MapObjectDrawLayer layer)
+{
+    switch(layer) {
+    case FLATGROUND_OBJECT:
+        return &_flat_ground_object_ids;
+    case GROUND_OBJECT:
+        return &_ground_object_ids;
+    case PASS_OBJECT:
+        return &_pass_object_ids;
+    case SKY_OBJECT:
+        return &_sky_object_ids;
+    default:
+        return nullptr;
+    }
+}
+
 std::vector<MapObject*>& ObjectSupervisor::_GetObjectsFromDrawLayer(MapObjectDrawLayer layer)
 {
     switch(layer)
@@ -498,13 +807,17 @@ MapObject *ObjectSupervisor::FindNearestInteractionObject(const VirtualSprite *s
 
     // A vector to hold objects which are inside the search area (either partially or fully)
     std::vector<MapObject *> valid_objects;
-    // A pointer to the vector of objects to search
-    std::vector<MapObject *>* search_vector = &_GetObjectsFromDrawLayer(sprite->GetObjectDrawLayer());
+    // Only the objects near the search area, and on the sprite draw layer, are searched.
+    const MapObjectDrawLayer layer = _GetSearchedDrawLayer(sprite->GetObjectDrawLayer());
+    _spatial_hash.FindObjects(search_area, _nearby_objects);
 
-    for(std::vector<MapObject *>::iterator it = (*search_vector).begin(); it != (*search_vector).end(); ++it) {
+    for(std::vector<MapObject *>::iterator it = _nearby_objects.begin(); it != _nearby_objects.end(); ++it) {
         if(*it == sprite)  // Don't allow the sprite itself to be considered in the search
             continue;
 
+        if((*it)->GetObjectDrawLayer() != layer)
+            continue;
+
         // Don't allow scenery object types to get in the way
         // as this is preventing save points from functioning, for instance
         if((*it)->GetObjectType() >= HALO_TYPE)
@@ -533,7 +846,7 @@ MapObject *ObjectSupervisor::FindNearestInteractionObject(const VirtualSprite *s
         Rectangle2D object_rect = (*it)->GetGridCollisionRectangle();
         if(object_rect.IntersectsWith(search_area))
             valid_objects.push_back(*it);
-    } // for (std::map<MapObject*>::iterator i = _all_objects.begin(); i != _all_objects.end(); i++)
+    } // for (std::vector<MapObject*>::iterator it = _nearby_objects.begin(); it != _nearby_objects.end(); ++it)
 
     if(valid_objects.empty()) {
          // If no sprite was here, try searching a map point.
@@ -584,6 +897,35 @@ bool ObjectSupervisor::IsPositionOccupiedByObject(float x, float y, MapObject* o
     return object->GetGridCollisionRectangle().Contains(Position2D(x, y));
 }
 
+void ObjectSupervisor::UpdateSpatialHash(MapObject* object)
+{
+    if(object && object->GetObjectType() == SOUND_TYPE)
+        _UpdateSoundSpatialHash(static_cast<SoundObject*>(object));
+
+    // Objects out of any draw layer are never searched.
+    if(!object || object->GetObjectDrawLayer() == NO_LAYER_OBJECT)
+        return;
+
+    _spatial_hash.UpdateObject(object);
+    UpdateHotData(object);
+}
+
+void ObjectSupervisor::UpdateHotData(MapObject* object)
+{
+    // The objects not registered yet get their hot data once registered.
+    if(!object || object->GetObjectID() <= 0)
+        return;
+    const uint32_t object_id = static_cast<uint32_t>(object->GetObjectID());
+    if(object_id >= _all_objects.size() || _all_objects[object_id] != object)
+        return;
+
+    MapObjectHotData& hot_data = _hot_data[object_id];
+    hot_data.y = object->GetYPosition();
+    hot_data.image_rectangle = object->GetGridImageRectangle();
+    hot_data.visible = object->IsVisible();
+    hot_data.draw_on_second_pass = object->IsDrawOnSecondPass();
+}
+
 COLLISION_TYPE ObjectSupervisor::GetCollisionFromObjectType(MapObject *obj) const
 {
     if(!obj)
@@ -633,26 +975,23 @@ COLLISION_TYPE ObjectSupervisor::DetectCollision(MapObject* object,
     // Grid based collision is not done for objects in the sky layer
     if(object->GetObjectDrawLayer() != vt_map::SKY_OBJECT && object->GetCollisionMask() & WALL_COLLISION) {
         // Determine if the object's collision rectangle overlaps any unwalkable tiles
-        // Note that because the sprite's collision rectangle was previously determined to be within the map bounds,
-        // the map grid tile indeces referenced in this loop are all valid entries and do not need to be checked for out-of-bounds conditions
-        for(uint32_t y = static_cast<uint32_t>(sprite_rect.top); y <= static_cast<uint32_t>(sprite_rect.bottom); ++y) {
-            for(uint32_t x = static_cast<uint32_t>(sprite_rect.left); x <= static_cast<uint32_t>(sprite_rect.right); ++x) {
-                // Checks the collision grid at the row-column at the object's current context
-                if(_collision_grid[y][x] > 0)
-                    return WALL_COLLISION;
-            }
-        }
+        if(!IsGridAreaFree(sprite_rect))
+            return WALL_COLLISION;
     }
 
-    std::vector<MapObject *>* objects = &_GetObjectsFromDrawLayer(object->GetObjectDrawLayer());
+    // Only the objects near the sprite, and on its draw layer, may collide with it.
+    const MapObjectDrawLayer layer = _GetSearchedDrawLayer(object->GetObjectDrawLayer());
+    _spatial_hash.FindObjects(sprite_rect, _nearby_objects);
 
-    std::vector<vt_map::private_map::MapObject *>::const_iterator it, it_end;
-    for(it = objects->begin(), it_end = objects->end(); it != it_end; ++it) {
-        MapObject *collision_object = *it;
+    for(uint32_t i = 0; i < _nearby_objects.size(); ++i) {
+        MapObject *collision_object = _nearby_objects[i];
         // Check if the object exists and has the no_collision property enabled
         if(!collision_object || collision_object->GetCollisionMask() == NO_COLLISION)
             continue;
 
+        if(collision_object->GetObjectDrawLayer() != layer)
+            continue;
+
         // Object and sprite are the same
         if(collision_object->GetObjectID() == object->GetObjectID())
             continue;
@@ -677,13 +1016,361 @@ COLLISION_TYPE ObjectSupervisor::DetectCollision(MapObject* object,
     return NO_COLLISION;
 }
 
+void ObjectSupervisor::SweepCollision(MapObject* object, float dx, float dy, CollisionSweep& sweep)
+{
+    _SweepCollision(object, dx, dy, SWEEP_ALL, _sweep_obstacles, _nearby_objects, sweep);
+}
+
+void ObjectSupervisor::_SweepCollision(MapObject* object, float dx, float dy, SweepFilter filter,
+                                       std::vector<SweepObstacle>& obstacles, std::vector<MapObject*>& nearby_objects,
+                                       CollisionSweep& sweep) const
+{
+    sweep = CollisionSweep();
+    if(!object)
+        return;
+
+    const float start_x = object->GetXPosition();
+    const float start_y = object->GetYPosition();
+    sweep.x = start_x + dx;
+    sweep.y = start_y + dy;
+    if(dx == 0.0f && dy == 0.0f)
+        return;
+
+    const Rectangle2D start_rect = object->GetGridCollisionRectangle();
+    const Rectangle2D end_rect = object->GetGridCollisionRectangle(sweep.x, sweep.y);
+    const bool straight = (dx == 0.0f || dy == 0.0f);
+    const float edge_step = std::min(std::max(std::fabs(dx), std::fabs(dy)), SWEEP_EDGE_STEP);
+
+    // Gather once the obstacles of the area swept, and of the steps around the obstacle corners.
+    _GatherSweepObstacles(object, _GetSweptArea(object, dx, dy), filter, obstacles, nearby_objects);
+
+    float time = 1.0f;
+    float normal_x = 0.0f;
+    float normal_y = 0.0f;
+    const SweepObstacle* obstacle = _SweepObstacles(obstacles, start_rect, dx, dy, time, normal_x, normal_y);
+    if(!obstacle)
+        return;
+
+    sweep.time = time;
+    sweep.normal_x = normal_x;
+    sweep.normal_y = normal_y;
+    sweep.collision_type = obstacle->collision_type;
+    sweep.collision_object = obstacle->object;
+
+    const float contact_time = _GetContactTime(time, normal_x != 0.0f ? dx : dy);
+    sweep.x = start_x + dx * contact_time;
+    sweep.y = start_y + dy * contact_time;
+
+    if(!straight) {
+        // Slide the rest of the move along the obstacle side hit.
+        const float slide_x = normal_x != 0.0f ? 0.0f : dx * (1.0f - contact_time);
+        const float slide_y = normal_y != 0.0f ? 0.0f : dy * (1.0f - contact_time);
+        const Rectangle2D contact_rect = object->GetGridCollisionRectangle(sweep.x, sweep.y);
+        if(!_SweepObstacles(obstacles, contact_rect, slide_x, slide_y, time, normal_x, normal_y)) {
+            sweep.x += slide_x;
+            sweep.y += slide_y;
+            sweep.collision_type = NO_COLLISION;
+            return;
+        }
+
+        const float slide_time = _GetContactTime(time, normal_x != 0.0f ? slide_x : slide_y);
+        sweep.x += slide_x * slide_time;
+        sweep.y += slide_y * slide_time;
+        return;
+    }
+
+    // Only the walls of the grid and the physical objects have corners to step around,
+    // for playability purpose.
+    if(sweep.collision_type != WALL_COLLISION)
+        return;
+    if(sweep.collision_object && sweep.collision_object->GetObjectType() != PHYSICAL_TYPE)
+        return;
+
+    // Test the two front corners of the destination, and step sideways toward the first free one.
+    float corner_x[2];
+    float corner_y[2];
+    float step_x[2];
+    float step_y[2];
+    if(dx == 0.0f) {
+        corner_y[0] = corner_y[1] = dy < 0.0f ? end_rect.top : end_rect.bottom;
+        corner_x[0] = end_rect.right;
+        corner_x[1] = end_rect.left;
+        step_x[0] = edge_step;
+        step_x[1] = -edge_step;
+        step_y[0] = step_y[1] = 0.0f;
+    }
+    else {
+        corner_x[0] = corner_x[1] = dx < 0.0f ? end_rect.left : end_rect.right;
+        corner_y[0] = end_rect.top;
+        corner_y[1] = end_rect.bottom;
+        step_x[0] = step_x[1] = 0.0f;
+        step_y[0] = -edge_step;
+        step_y[1] = edge_step;
+    }
+
+    for(uint32_t i = 0; i < 2; ++i) {
+        if(!_IsSweptPointFree(obstacles, corner_x[i], corner_y[i]))
+            continue;
+
+        // The step itself must be free.
+        if(!_SweepObstacles(obstacles, start_rect, step_x[i], step_y[i], time, normal_x, normal_y)) {
+            sweep.on_edge = true;
+            sweep.edge_x = start_x + step_x[i];
+            sweep.edge_y = start_y + step_y[i];
+        }
+        return;
+    }
+}
+
+Rectangle2D ObjectSupervisor::_GetSweptArea(const MapObject* object, float dx, float dy) const
+{
+    const Rectangle2D start_rect = object->GetGridCollisionRectangle();
+    const Rectangle2D end_rect = object->GetGridCollisionRectangle(object->GetXPosition() + dx,
+                                                                   object->GetYPosition() + dy);
+    Rectangle2D area(std::min(start_rect.left, end_rect.left), std::max(start_rect.right, end_rect.right),
+                     std::min(start_rect.top, end_rect.top), std::max(start_rect.bottom, end_rect.bottom));
+
+    const float edge_step = std::min(std::max(std::fabs(dx), std::fabs(dy)), SWEEP_EDGE_STEP);
+    if(dx == 0.0f) {
+        area.left -= edge_step;
+        area.right += edge_step;
+    }
+    else if(dy == 0.0f) {
+        area.top -= edge_step;
+        area.bottom += edge_step;
+    }
+    return area;
+}
+
+void ObjectSupervisor::_GatherSweepObstacles(const MapObject* object, const Rectangle2D& area, SweepFilter filter,
+                                             std::vector<SweepObstacle>& obstacles,
+                                             std::vector<MapObject*>& nearby_objects) const
+{
+    obstacles.clear();
+
+    SweepObstacle obstacle;
+    obstacle.object = nullptr;
+    obstacle.collision_type = WALL_COLLISION;
+
+    // The map bounds stop even the objects without collision, so that they won't get out of the map.
+    const float width = static_cast<float>(_num_grid_x_axis);
+    const float height = static_cast<float>(_num_grid_y_axis);
+    const float far_away = width + height + 1.0f;
+    if(filter != SWEEP_SPRITES) {
+        obstacle.rect = Rectangle2D(-far_away, -SWEEP_OPEN_SIDE, -far_away, height + far_away);
+        obstacles.push_back(obstacle);
+        obstacle.rect = Rectangle2D(width, width + far_away, -far_away, height + far_away);
+        obstacles.push_back(obstacle);
+        obstacle.rect = Rectangle2D(-far_away, width + far_away, -far_away, -SWEEP_OPEN_SIDE);
+        obstacles.push_back(obstacle);
+        obstacle.rect = Rectangle2D(-far_away, width + far_away, height, height + far_away);
+        obstacles.push_back(obstacle);
+    }
+
+    if(object->GetCollisionMask() == NO_COLLISION)
+        return;
+
+    // Grid based collision is not done for objects in the sky layer
+    if(filter != SWEEP_SPRITES && object->GetObjectDrawLayer() != vt_map::SKY_OBJECT
+            && object->GetCollisionMask() & WALL_COLLISION) {
+        const int32_t left = std::max(static_cast<int32_t>(std::floor(area.left)), 0);
+        const int32_t top = std::max(static_cast<int32_t>(std::floor(area.top)), 0);
+        const int32_t right = std::min(static_cast<int32_t>(std::floor(area.right)), static_cast<int32_t>(_num_grid_x_axis) - 1);
+        const int32_t bottom = std::min(static_cast<int32_t>(std::floor(area.bottom)), static_cast<int32_t>(_num_grid_y_axis) - 1);
+        for(int32_t y = top; y <= bottom; ++y) {
+            for(int32_t x = left; x <= right; ++x) {
+                if(!_collision_grid.IsBlocked(x, y))
+                    continue;
+                obstacle.rect = Rectangle2D(static_cast<float>(x), static_cast<float>(x + 1) - SWEEP_OPEN_SIDE,
+                                            static_cast<float>(y), static_cast<float>(y + 1) - SWEEP_OPEN_SIDE);
+                obstacles.push_back(obstacle);
+            }
+        }
+    }
+
+    // Only the objects near the sprite, and on its draw layer, may collide with it.
+    const MapObjectDrawLayer layer = _GetSearchedDrawLayer(object->GetObjectDrawLayer());
+    _spatial_hash.FindObjects(area, nearby_objects);
+
+    for(uint32_t i = 0; i < nearby_objects.size(); ++i) {
+        MapObject *collision_object = nearby_objects[i];
+        if(!collision_object || collision_object->GetCollisionMask() == NO_COLLISION)
+            continue;
+
+        if(collision_object->GetObjectDrawLayer() != layer)
+            continue;
+
+        if(collision_object->GetObjectID() == object->GetObjectID())
+            continue;
+
+        // Ignore the objects whose collision type isn't in the sprite collision mask.
+        COLLISION_TYPE collision = GetCollisionFromObjectType(collision_object);
+        if(!(object->GetCollisionMask() & collision))
+            continue;
+
+        const bool is_sprite = (collision == CHARACTER_COLLISION || collision == ENEMY_COLLISION);
+        if((filter == SWEEP_STATIC && is_sprite) || (filter == SWEEP_SPRITES && !is_sprite))
+            continue;
+
+        obstacle.rect = collision_object->GetGridCollisionRectangle();
+        obstacle.object = collision_object;
+        obstacle.collision_type = collision;
+        obstacles.push_back(obstacle);
+    }
+}
+
+const ObjectSupervisor::SweepObstacle* ObjectSupervisor::_SweepObstacles(const std::vector<SweepObstacle>& obstacles,
+                                                                         const Rectangle2D& rect, float dx, float dy,
+                                                                         float& time, float& normal_x, float& normal_y)
+{
+    const SweepObstacle* first_obstacle = nullptr;
+    time = 1.0f;
+    normal_x = 0.0f;
+    normal_y = 0.0f;
+
+    if(dx == 0.0f && dy == 0.0f)
+        return nullptr;
+
+    for(uint32_t i = 0; i < obstacles.size(); ++i) {
+        const SweepObstacle& obstacle = obstacles[i];
+
+        float entry_x, exit_x, entry_y, exit_y;
+        if(!_GetSweepAxisTimes(rect.left, rect.right, obstacle.rect.left, obstacle.rect.right, dx, entry_x, exit_x))
+            continue;
+        if(!_GetSweepAxisTimes(rect.top, rect.bottom, obstacle.rect.top, obstacle.rect.bottom, dy, entry_y, exit_y))
+            continue;
+
+        float entry = std::max(entry_x, entry_y);
+        const float exit = std::min(exit_x, exit_y);
+        if(entry > exit || exit < 0.0f || entry > 1.0f)
+            continue;
+
+        float obstacle_normal_x = 0.0f;
+        float obstacle_normal_y = 0.0f;
+        if(entry < 0.0f) {
+            // Already overlapping: Characters are tangled with the sprite, and let it through,
+            // and the other obstacles only stop the moves not getting out of them.
+            if(obstacle.collision_type == CHARACTER_COLLISION || exit < 1.0f)
+                continue;
+            entry = 0.0f;
+            if(std::fabs(dx) >= std::fabs(dy))
+                obstacle_normal_x = dx > 0.0f ? -1.0f : 1.0f;
+            else
+                obstacle_normal_y = dy > 0.0f ? -1.0f : 1.0f;
+        }
+        else if(entry_x >= entry_y) {
+            obstacle_normal_x = dx > 0.0f ? -1.0f : 1.0f;
+        }
+        else {
+            obstacle_normal_y = dy > 0.0f ? -1.0f : 1.0f;
+        }
+
+        // On ties, the first obstacle gathered wins: The map bounds, then the grid, then the objects.
+        if(first_obstacle && entry >= time)
+            continue;
+
+        first_obstacle = &obstacle;
+        time = entry;
+        normal_x = obstacle_normal_x;
+        normal_y = obstacle_normal_y;
+    }
+
+    return first_obstacle;
+}
+
+bool ObjectSupervisor::_IsSweptPointFree(const std::vector<SweepObstacle>& obstacles, float x, float y) const
+{
+    if(!IsWithinMapBounds(x, y))
+        return false;
+
+    if(_collision_grid.IsBlocked(static_cast<uint32_t>(x), static_cast<uint32_t>(y)))
+        return false;
+
+    // Only the physical objects are considered as walls here, as IsStaticCollision() does.
+    const Position2D point(x, y);
+    for(uint32_t i = 0; i < obstacles.size(); ++i) {
+        const SweepObstacle& obstacle = obstacles[i];
+        if(obstacle.object && obstacle.object->GetObjectType() == PHYSICAL_TYPE && obstacle.rect.Contains(point))
+            return false;
+    }
+    return true;
+}
+
+bool ObjectSupervisor::IsGridAreaFree(const Rectangle2D& rect) const
+{
+    if(rect.left < 0.0f || rect.right >= static_cast<float>(_num_grid_x_axis) ||
+            rect.top < 0.0f || rect.bottom >= static_cast<float>(_num_grid_y_axis)) {
+        return false;
+    }
+
+    // The rectangle being within the map bounds, the grid indices are all valid.
+    const uint32_t left = static_cast<uint32_t>(rect.left);
+    const uint32_t top = static_cast<uint32_t>(rect.top);
+    const uint32_t right = static_cast<uint32_t>(rect.right);
+    const uint32_t bottom = static_cast<uint32_t>(rect.bottom);
+
+    // Most rectangles are told apart by the clearance of their top left element,
+    // the others, far longer than wide or next to a wall corner, are tested element by element.
+    if(_clearance_map.HasSize(_num_grid_x_axis, _num_grid_y_axis)) {
+        const uint32_t clearance = _clearance_map.GetClearance(left, top);
+        const uint32_t width = right - left + 1;
+        const uint32_t height = bottom - top + 1;
+        if(clearance >= std::max(width, height))
+            return true;
+        if(clearance < std::min(width, height) && clearance < CLEARANCE_MAX)
+            return false;
+    }
+
+    return _collision_grid.IsAreaFree(left, top, right, bottom);
+}
+
+bool ObjectSupervisor::GetChaseStep(const MapObject* sprite, const VirtualSprite* target, Position2D& next_step)
+{
+    if(!sprite || !target)
+        return false;
+
+    const float coll_half_width = sprite->GetCollGridHalfWidth();
+    const float coll_height = sprite->GetCollGridHeight();
+
+    // The enemies of a map usually share a few collision sizes, so a field is kept for each.
+    FlowField* field = nullptr;
+    for(uint32_t i = 0; i < _chase_fields.size(); ++i) {
+        if(_chase_fields[i].HasCollisionSize(coll_half_width, coll_height)) {
+            field = &_chase_fields[i];
+            break;
+        }
+    }
+    if(!field) {
+        _chase_fields.push_back(FlowField(coll_half_width, coll_height));
+        field = &_chase_fields.back();
+    }
+
+    field->Update(*this, target->GetXPosition(), target->GetYPosition());
+    return field->GetNextStep(sprite->GetXPosition(), sprite->GetYPosition(), next_step);
+}
+
+const PathGraph& ObjectSupervisor::_GetPathGraph(const MapObject* sprite)
+{
+    const float coll_half_width = sprite->GetCollGridHalfWidth();
+    const float coll_height = sprite->GetCollGridHeight();
+
+    for(uint32_t i = 0; i < _path_graphs.size(); ++i) {
+        if(_path_graphs[i].HasCollisionSize(coll_half_width, coll_height))
+            return _path_graphs[i];
+    }
+
+    // The collision grid doesn't change once loaded, so the graph is built only once.
+    _path_graphs.push_back(PathGraph(coll_half_width, coll_height));
+    _path_graphs.back().Build(*this);
+    return _path_graphs.back();
+}
+
 Path ObjectSupervisor::FindPath(VirtualSprite *sprite, const Position2D& destination, uint32_t max_cost)
 {
-    // NOTE: Refer to the implementation of the A* algorithm to understand
-    // what all these lists and score values are for.
-    static const uint32_t basic_gcost = 10;
+    // The maximum cost of the path between two consecutive path graph entrances.
+    static const uint32_t PATH_SEGMENT_MAX_COST = 8 * PATH_GRAPH_CLUSTER_SIZE;
 
-    // NOTE(bis): On the outer scope, we'll use float based positions,
+    // NOTE: On the outer scope, we'll use float based positions,
     // but we still use integer positions for path finding.
     Path path;
 
@@ -701,73 +1388,132 @@ Path ObjectSupervisor::FindPath(VirtualSprite *sprite, const Position2D& destina
         return path;
     }
 
-    // The starting node of this path discovery
-    PathNode source_node(static_cast<int16_t>(sprite->GetXPosition()), static_cast<int16_t>(sprite->GetYPosition()));
-    // The ending node.
-    PathNode dest(static_cast<int16_t>(destination.x), static_cast<int16_t>(destination.y));
+    // The starting and ending nodes of this path discovery
+    const int32_t source_x = static_cast<int32_t>(sprite->GetXPosition());
+    const int32_t source_y = static_cast<int32_t>(sprite->GetYPosition());
+    const int32_t dest_x = static_cast<int32_t>(destination.x);
+    const int32_t dest_y = static_cast<int32_t>(destination.y);
 
     // Check that the source node is not the same as the destination node
-    if(source_node == dest) {
+    if(source_x == dest_x && source_y == dest_y) {
         IF_PRINT_WARNING(MAP_DEBUG) << "source node coordinates are the same as the destination" << std::endl;
         // return an empty path.
         return path;
     }
 
-    std::vector<PathNode> open_list;
-    std::vector<PathNode> closed_list;
+    // We will try to keep the original offset all along.
+    const float offset_x = vt_utils::GetFloatFraction(destination.x);
+    const float offset_y = vt_utils::GetFloatFraction(destination.y);
+
+    // Long paths are first searched through the clusters of the path graph,
+    // and then only refined between the entrances found.
+    // The graph only knows about the collision grid, so it is useless for sprites ignoring it.
+    const int32_t distance = std::max(std::abs(dest_x - source_x), std::abs(dest_y - source_y));
+    if(max_cost == 0 && distance > static_cast<int32_t>(2 * PATH_GRAPH_CLUSTER_SIZE)
+            && sprite->GetObjectDrawLayer() != vt_map::SKY_OBJECT
+            && (sprite->GetCollisionMask() & WALL_COLLISION)) {
+        const PathGraph& graph = _GetPathGraph(sprite);
+        std::vector<uint32_t> waypoints;
+        if(graph.FindWaypoints(source_x, source_y, dest_x, dest_y, waypoints)) {
+            int32_t segment_x = source_x;
+            int32_t segment_y = source_y;
+            bool refined = true;
+            for(uint32_t i = 0; i < waypoints.size() && refined; ++i) {
+                const int32_t waypoint_x = static_cast<int32_t>(waypoints[i] % _num_grid_x_axis);
+                const int32_t waypoint_y = static_cast<int32_t>(waypoints[i] / _num_grid_x_axis);
+                if(waypoint_x == segment_x && waypoint_y == segment_y)
+                    continue;
+                refined = _FindPathSegment(sprite, segment_x, segment_y, waypoint_x, waypoint_y,
+                                           offset_x, offset_y, PATH_SEGMENT_MAX_COST, path);
+                segment_x = waypoint_x;
+                segment_y = waypoint_y;
+            }
+
+            if(refined && !path.empty()) {
+                path.back() = destination;
+                return path;
+            }
+        }
+        // The entrances may not fit the sprite offset: fall back to a full search.
+        path.clear();
+    }
+
+    if(!_FindPathSegment(sprite, source_x, source_y, dest_x, dest_y, offset_x, offset_y, max_cost, path)) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "could not find path to destination" << std::endl;
+        path.clear();
+        return path;
+    }
+
+    path.back() = destination;
+    return path;
+}
 
-    // The current "best node"
-    PathNode best_node;
-    // Used to hold the eight adjacent nodes
-    PathNode nodes[8];
+bool ObjectSupervisor::_FindPathSegment(VirtualSprite *sprite,
+                                        int32_t source_x, int32_t source_y,
+                                        int32_t dest_x, int32_t dest_y,
+                                        float offset_x, float offset_y,
+                                        uint32_t max_cost, Path& path)
+{
+    // NOTE: Refer to the implementation of the A* algorithm to understand
+    // what all these lists and score values are for.
+    static const uint32_t basic_gcost = 10;
 
-    // Temporary delta variables used in calculation of a node's heuristic (h score)
-    uint32_t x_delta, y_delta;
-    // The number to add to a node's g_score, depending on whether it is a lateral or diagonal movement
-    int16_t g_add;
+    // The offsets of the eight adjacent nodes, lateral ones first.
+    static const int32_t adjacent_x[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+    static const int32_t adjacent_y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
 
-    open_list.push_back(source_node);
+    const int32_t grid_width = static_cast<int32_t>(_num_grid_x_axis);
+    const int32_t grid_height = static_cast<int32_t>(_num_grid_y_axis);
+    const uint32_t source_index = source_y * grid_width + source_x;
+    const uint32_t dest_index = dest_y * grid_width + dest_x;
 
-    // We will try to keep the original offset all along.
-    float offset_x = vt_utils::GetFloatFraction(destination.x);
-    float offset_y = vt_utils::GetFloatFraction(destination.y);
+    _StartPathSearch();
+
+    PathNode& source_node = _path_nodes[source_index];
+    source_node.g_score = 0;
+    source_node.h_score = 0;
+    source_node.f_score = 0;
+    source_node.parent = -1;
+    _PushPathNode(source_index);
 
-    while(open_list.empty() == false) {
-        sort(open_list.begin(), open_list.end());
-        best_node = open_list.back();
-        open_list.pop_back();
-        closed_list.push_back(best_node);
+    bool destination_reached = false;
+    while(!_path_open_heap.empty()) {
+        const uint32_t best_index = _PopPathNode();
+        PathNode& best_node = _path_nodes[best_index];
+        best_node.closed = true;
 
         // Check if destination has been reached, and break out of the loop if so
-        if(best_node == dest)
+        if(best_index == dest_index) {
+            destination_reached = true;
             break;
+        }
 
-        // Setup the coordinates of the 8 adjacent nodes to the best node
-        nodes[0].tile_x = best_node.tile_x - 1;
-        nodes[0].tile_y = best_node.tile_y;
-        nodes[1].tile_x = best_node.tile_x + 1;
-        nodes[1].tile_y = best_node.tile_y;
-        nodes[2].tile_x = best_node.tile_x;
-        nodes[2].tile_y = best_node.tile_y - 1;
-        nodes[3].tile_x = best_node.tile_x;
-        nodes[3].tile_y = best_node.tile_y + 1;
-        nodes[4].tile_x = best_node.tile_x - 1;
-        nodes[4].tile_y = best_node.tile_y - 1;
-        nodes[5].tile_x = best_node.tile_x - 1;
-        nodes[5].tile_y = best_node.tile_y + 1;
-        nodes[6].tile_x = best_node.tile_x + 1;
-        nodes[6].tile_y = best_node.tile_y - 1;
-        nodes[7].tile_x = best_node.tile_x + 1;
-        nodes[7].tile_y = best_node.tile_y + 1;
+        const int32_t best_x = static_cast<int32_t>(best_index) % grid_width;
+        const int32_t best_y = static_cast<int32_t>(best_index) / grid_width;
 
         // Check the eight adjacent nodes
         for(uint8_t i = 0; i < 8; ++i) {
+            const int32_t node_x = best_x + adjacent_x[i];
+            const int32_t node_y = best_y + adjacent_y[i];
+
+            // Nodes out of the map are walls anyway.
+            if(node_x < 0 || node_y < 0 || node_x >= grid_width || node_y >= grid_height)
+                continue;
+
+            const uint32_t node_index = node_y * grid_width + node_x;
+            PathNode& node = _path_nodes[node_index];
+
             // ---------- (A): Check if all tiles are walkable
             // Don't use 0.0f here for both since errors at the border between
             // two positions may occure, especially when running.
-            COLLISION_TYPE collision_type = DetectCollision(sprite,
-                                            ((float)nodes[i].tile_x) + offset_x,
-                                            ((float)nodes[i].tile_y) + offset_y);
+            // The other objects don't move during the search, so the collision is only computed once per node.
+            if(node.collision_generation != _path_generation) {
+                node.collision = DetectCollision(sprite,
+                                                 static_cast<float>(node_x) + offset_x,
+                                                 static_cast<float>(node_y) + offset_y);
+                node.collision_generation = _path_generation;
+            }
+            const COLLISION_TYPE collision_type = node.collision;
 
             // Can't go through walls.
             if(collision_type == WALL_COLLISION)
@@ -775,10 +1521,7 @@ Path ObjectSupervisor::FindPath(VirtualSprite *sprite, const Position2D& destina
 
             // ---------- (B): If this point has been reached, the node is valid for the sprite to move to
             // If this is a lateral adjacent node, g_score is +10, otherwise diagonal adjacent node is +14
-            if(i < 4)
-                g_add = basic_gcost;
-            else
-                g_add = basic_gcost + 4;
+            uint32_t g_add = (i < 4) ? basic_gcost : basic_gcost + 4;
 
             // Add some g cost when there is another sprite there,
             // so the NPC try to get around when possible,
@@ -787,72 +1530,156 @@ Path ObjectSupervisor::FindPath(VirtualSprite *sprite, const Position2D& destina
                     || collision_type == ENEMY_COLLISION)
                 g_add += basic_gcost * 2;
 
+            const uint32_t g_score = best_node.g_score + g_add;
+
             // If the path has reached the maximum length requested, we abort the path
-            if (max_cost > 0 && (uint32_t)(best_node.g_score + g_add) >= max_cost * basic_gcost)
-                return path;
+            if (max_cost > 0 && g_score >= max_cost * basic_gcost)
+                return false;
+
+            const bool visited = (node.generation == _path_generation);
 
             // ---------- (C): Check if the node is already in the closed list
-            if(find(closed_list.begin(), closed_list.end(), nodes[i]) != closed_list.end())
+            if(visited && node.closed)
                 continue;
 
-            // Set the node's parent and calculate its g_score
-            nodes[i].parent_x = best_node.tile_x;
-            nodes[i].parent_y = best_node.tile_y;
-            nodes[i].g_score = best_node.g_score + g_add;
-
             // ---------- (D): Check to see if the node is already on the open list and update it if necessary
-            std::vector<PathNode>::iterator iter = std::find(open_list.begin(), open_list.end(), nodes[i]);
-            if(iter != open_list.end()) {
+            if(visited) {
                 // If its G is higher, it means that the path we are on is better, so switch the parent
-                if(iter->g_score > nodes[i].g_score) {
-                    iter->g_score = nodes[i].g_score;
-                    iter->f_score = nodes[i].g_score + iter->h_score;
-                    iter->parent_x = nodes[i].parent_x;
-                    iter->parent_y = nodes[i].parent_y;
+                if(node.g_score > g_score) {
+                    node.g_score = g_score;
+                    node.f_score = g_score + node.h_score;
+                    node.parent = static_cast<int32_t>(best_index);
+                    _UpdatePathNode(node_index);
                 }
             }
             // ---------- (E): Add the new node to the open list
             else {
                 // Calculate the H and F score of the new node (the heuristic used is diagonal)
-                x_delta = abs(dest.tile_x - nodes[i].tile_x);
-                y_delta = abs(dest.tile_y - nodes[i].tile_y);
+                const uint32_t x_delta = std::abs(dest_x - node_x);
+                const uint32_t y_delta = std::abs(dest_y - node_y);
                 if(x_delta > y_delta)
-                    nodes[i].h_score = 14 * y_delta + 10 * (x_delta - y_delta);
+                    node.h_score = 14 * y_delta + 10 * (x_delta - y_delta);
                 else
-                    nodes[i].h_score = 14 * x_delta + 10 * (y_delta - x_delta);
+                    node.h_score = 14 * x_delta + 10 * (y_delta - x_delta);
 
-                nodes[i].f_score = nodes[i].g_score + nodes[i].h_score;
-                open_list.push_back(nodes[i]);
+                node.g_score = g_score;
+                node.f_score = g_score + node.h_score;
+                node.parent = static_cast<int32_t>(best_index);
+                _PushPathNode(node_index);
             }
         } // for (uint8_t i = 0; i < 8; ++i)
-    } // while (open_list.empty() == false)
+    } // while (!_path_open_heap.empty())
 
-    if(open_list.empty()) {
-        IF_PRINT_WARNING(MAP_DEBUG) << "could not find path to destination" << std::endl;
-        return path;
+    if(!destination_reached)
+        return false;
+
+    // Follow the parent nodes back to the source, which isn't part of the path.
+    const size_t segment_start = path.size();
+    int32_t index = static_cast<int32_t>(dest_index);
+    while(index >= 0 && static_cast<uint32_t>(index) != source_index) {
+        Position2D next_pos(static_cast<float>(index % grid_width) + offset_x,
+                            static_cast<float>(index / grid_width) + offset_y);
+        path.push_back(next_pos);
+
+        index = _path_nodes[index].parent;
     }
+    std::reverse(path.begin() + segment_start, path.end());
 
-    // Add the destination node to the vector.
-    path.push_back(destination);
+    return true;
+}
 
-    // Retain the last node parent, and remove it from the closed list
-    int16_t parent_x = best_node.parent_x;
-    int16_t parent_y = best_node.parent_y;
-    closed_list.pop_back();
+void ObjectSupervisor::_StartPathSearch()
+{
+    // The grid only changes when loading a map, so the nodes are reused by every search.
+    const uint32_t node_count = static_cast<uint32_t>(_num_grid_x_axis) * _num_grid_y_axis;
+    if(_path_nodes.size() != node_count) {
+        _path_nodes.assign(node_count, PathNode());
+        _path_generation = 0;
+    }
 
-    // Go backwards through the closed list following the parent nodes to construct the path
-    for(std::vector<PathNode>::iterator iter = closed_list.end() - 1; iter != closed_list.begin(); --iter) {
-        if(iter->tile_y == parent_y && iter->tile_x == parent_x) {
-            Position2D next_pos(((float)iter->tile_x) + offset_x, ((float)iter->tile_y) + offset_y);
-            path.push_back(next_pos);
+    _path_open_heap.clear();
 
-            parent_x = iter->parent_x;
-            parent_y = iter->parent_y;
+    // When the generation wraps, the old stamps could match again.
+    ++_path_generation;
+    if(_path_generation == 0) {
+        for(uint32_t i = 0; i < _path_nodes.size(); ++i) {
+            _path_nodes[i].generation = 0;
+            _path_nodes[i].collision_generation = 0;
         }
+        _path_generation = 1;
     }
-    std::reverse(path.begin(), path.end());
+}
 
-    return path;
+bool ObjectSupervisor::_IsPathNodeBetter(uint32_t first_index, uint32_t second_index) const
+{
+    const PathNode& first = _path_nodes[first_index];
+    const PathNode& second = _path_nodes[second_index];
+
+    // On ties, prefer the node closest to the destination.
+    if(first.f_score != second.f_score)
+        return first.f_score < second.f_score;
+    return first.h_score < second.h_score;
+}
+
+void ObjectSupervisor::_PushPathNode(uint32_t node_index)
+{
+    PathNode& node = _path_nodes[node_index];
+    node.generation = _path_generation;
+    node.closed = false;
+    node.heap_index = _path_open_heap.size();
+    _path_open_heap.push_back(node_index);
+
+    _UpdatePathNode(node_index);
+}
+
+uint32_t ObjectSupervisor::_PopPathNode()
+{
+    const uint32_t best_index = _path_open_heap.front();
+
+    // Move the last node to the root, and sift it down.
+    const uint32_t last_index = _path_open_heap.back();
+    _path_open_heap.pop_back();
+    if(_path_open_heap.empty())
+        return best_index;
+
+    uint32_t position = 0;
+    const uint32_t heap_size = _path_open_heap.size();
+    while(true) {
+        uint32_t child = position * 2 + 1;
+        if(child >= heap_size)
+            break;
+        if(child + 1 < heap_size && _IsPathNodeBetter(_path_open_heap[child + 1], _path_open_heap[child]))
+            ++child;
+        if(!_IsPathNodeBetter(_path_open_heap[child], last_index))
+            break;
+
+        _path_open_heap[position] = _path_open_heap[child];
+        _path_nodes[_path_open_heap[position]].heap_index = position;
+        position = child;
+    }
+
+    _path_open_heap[position] = last_index;
+    _path_nodes[last_index].heap_index = position;
+
+    return best_index;
+}
+
+void ObjectSupervisor::_UpdatePathNode(uint32_t node_index)
+{
+    // The score only ever decreases, so the node can only move up.
+    uint32_t position = _path_nodes[node_index].heap_index;
+    while(position > 0) {
+        const uint32_t parent = (position - 1) / 2;
+        if(!_IsPathNodeBetter(node_index, _path_open_heap[parent]))
+            break;
+
+        _path_open_heap[position] = _path_open_heap[parent];
+        _path_nodes[_path_open_heap[position]].heap_index = position;
+        position = parent;
+    }
+
+    _path_open_heap[position] = node_index;
+    _path_nodes[node_index].heap_index = position;
 }
 
 void ObjectSupervisor::ReloadVisiblePartyMember()
@@ -902,7 +1729,7 @@ void ObjectSupervisor::DrawCollisionArea(const MapFrame *frame)
             x < static_cast<uint32_t>((frame->tile_x_start + frame->num_draw_x_axis) * 2); ++x) {
 
             // Draw the collision rectangle.
-            if (_collision_grid[y][x] > 0)
+            if (_collision_grid.IsBlocked(x, y))
                 vt_video::VideoManager->DrawRectangle(GRID_LENGTH, GRID_LENGTH,
                                                       vt_video::Color(1.0f, 0.0f, 0.0f, 0.6f));
 
@@ -922,13 +1749,17 @@ bool ObjectSupervisor::IsStaticCollision(float x, float y)
     if (IsMapCollision(static_cast<uint32_t>(x), static_cast<uint32_t>(y)))
         return true;
 
-    std::vector<vt_map::private_map::MapObject *>::const_iterator it, it_end;
-    for(it = _ground_objects.begin(), it_end = _ground_objects.end(); it != it_end; ++it) {
-        MapObject *collision_object = *it;
+    // Only the ground objects near the position may be on it.
+    _spatial_hash.FindObjects(Rectangle2D(x, x, y, y), _nearby_objects);
+    for(uint32_t i = 0; i < _nearby_objects.size(); ++i) {
+        MapObject *collision_object = _nearby_objects[i];
         // Check if the object exists and has the no_collision property enabled
         if(!collision_object || collision_object->GetCollisionMask() == NO_COLLISION)
             continue;
 
+        if(collision_object->GetObjectDrawLayer() != GROUND_OBJECT)
+            continue;
+
         //only check physical objects. we don't care about sprites and enemies, treasure boxes, etc
         if(collision_object->GetObjectType() != PHYSICAL_TYPE)
             continue;
@@ -943,6 +1774,28 @@ bool ObjectSupervisor::IsStaticCollision(float x, float y)
     return false;
 }
 
+void ObjectSupervisor::GetStaticCollisionGrid(CollisionGrid& grid) const
+{
+    grid = _collision_grid;
+
+    for(uint32_t i = 0; i < _ground_objects.size(); ++i) {
+        const MapObject *collision_object = _ground_objects[i];
+        if(!collision_object || collision_object->GetCollisionMask() == NO_COLLISION || collision_object->GetObjectType() != PHYSICAL_TYPE)
+            continue;
+
+        // The cells whose position is within the object collision rectangle, edges included.
+        const Rectangle2D rect = collision_object->GetGridCollisionRectangle();
+        const int32_t left = std::max(static_cast<int32_t>(std::ceil(rect.left)), 0);
+        const int32_t top = std::max(static_cast<int32_t>(std::ceil(rect.top)), 0);
+        const int32_t right = std::min(static_cast<int32_t>(std::floor(rect.right)), static_cast<int32_t>(_num_grid_x_axis) - 1);
+        const int32_t bottom = std::min(static_cast<int32_t>(std::floor(rect.bottom)), static_cast<int32_t>(_num_grid_y_axis) - 1);
+        for(int32_t y = top; y <= bottom; ++y) {
+            for(int32_t x = left; x <= right; ++x)
+                grid.SetBlocked(x, y, true);
+        }
+    }
+}
+
 void ObjectSupervisor::StopSoundObjects()
 {
     for (uint32_t i = 0; i < _sound_object_highest_volumes.size(); ++i) {
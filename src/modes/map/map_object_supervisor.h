@@ -11,10 +11,23 @@
 #ifndef __MAP_OBJECT_SUPERVISOR_HEADER__
 #define __MAP_OBJECT_SUPERVISOR_HEADER__
 
+#include "modes/map/map_binary_data.h"
+#include "modes/map/map_clearance_map.h"
+#include "modes/map/map_collision_grid.h"
+#include "modes/map/map_flow_field.h"
+#include "modes/map/map_path_graph.h"
+#include "modes/map/map_spatial_hash.h"
 #include "modes/map/map_objects/map_object.h"
 
 #include "script/script_read.h"
 
+#include <unordered_map>
+
+namespace vt_audio
+{
+class SoundDescriptor;
+}
+
 namespace vt_map
 {
 
@@ -27,6 +40,78 @@ class EscapePoint;
 class SoundObject;
 class Light;
 
+/** ****************************************************************************
+*** \brief The data of a map object read every frame by the sort and culling passes.
+***
+*** The object supervisor keeps it contiguous, indexed by object id, and the
+*** object setters keep it up to date, so that those passes stream through
+*** it instead of going through each object.
+*** ***************************************************************************/
+class MapObjectHotData
+{
+public:
+    MapObjectHotData() :
+        y(0.0f),
+        visible(false),
+        draw_on_second_pass(false)
+    {}
+
+    //! \brief The object y position, by which the objects are sorted in draw order.
+    float y;
+
+    //! \brief The object image rectangle, in collision grid coordinates.
+    vt_common::Rectangle2D image_rectangle;
+
+    bool visible;
+    bool draw_on_second_pass;
+};
+
+/** ****************************************************************************
+*** \brief The result of a sprite move swept against the collision grid and the objects.
+*** ***************************************************************************/
+class CollisionSweep
+{
+public:
+    CollisionSweep() :
+        time(1.0f),
+        normal_x(0.0f),
+        normal_y(0.0f),
+        collision_type(NO_COLLISION),
+        collision_object(nullptr),
+        x(0.0f),
+        y(0.0f),
+        on_edge(false),
+        edge_x(0.0f),
+        edge_y(0.0f)
+    {}
+
+    //! \brief The fraction of the move done when hitting the first obstacle, 1.0f when nothing was hit.
+    float time;
+
+    //! \brief The normal of the first obstacle side hit, pointing toward the sprite. Null when nothing was hit.
+    float normal_x;
+    float normal_y;
+
+    /** \brief The collision type of the first obstacle hit.
+    *** NO_COLLISION when nothing was hit, or when a diagonal move could slide along the obstacle.
+    **/
+    COLLISION_TYPE collision_type;
+
+    //! \brief The first object hit, nullptr for the collision grid and the map bounds.
+    MapObject* collision_object;
+
+    //! \brief The position reached: The destination, the end of the slide along the obstacle, or the contact with it.
+    float x;
+    float y;
+
+    /** \brief Whether a straight move blocked by a wall can step around the obstacle corner instead,
+    *** and the position of that step.
+    **/
+    bool on_edge;
+    float edge_x;
+    float edge_y;
+};
+
 /** ****************************************************************************
 *** \brief A helper class to MapMode responsible for management of all object and sprite data
 ***
@@ -68,6 +153,9 @@ public:
     **/
     VirtualSprite* GetSprite(uint32_t object_id);
 
+    //! \brief Updates the dialogue status of the map sprites referencing a dialogue whose seen state changed.
+    void UpdateSpritesDialogueStatus(const std::string& dialogue_id);
+
     //! \brief Wrapper to add an object in the all objects vector.
     //! This should only be called by the MapObject constructor.
     void RegisterObject(MapObject* object);
@@ -86,6 +174,11 @@ public:
     //! Called by the Halo object constructor
     void AddHalo(Halo* halo);
 
+    //! \brief Tells whether the map has any halo or light to draw.
+    bool HasLights() const {
+        return !_halos.empty() || !_lights.empty();
+    }
+
     //! \brief Add a save point.
     //! Called by the SavePoint object constructor
     void AddSavePoint(SavePoint* save_point);
@@ -98,7 +191,8 @@ public:
     // Called by the Mazone constructor.
     void AddZone(MapZone* zone);
 
-    //! \brief Sorts objects on all three layers according to their draw order
+    //! \brief Sorts objects on all the layers according to their draw order
+    //! \note Called every frame, and cheap when few objects passed each other since the last call.
     void SortObjects();
 
     /** \brief Loads the collision grid data and saved state of all map objects
@@ -111,6 +205,9 @@ public:
     **/
     bool Load(vt_script::ReadScriptDescriptor &map_file);
 
+    //! \brief Loads the collision grid from a baked map data file.
+    bool Load(const BinaryMapData& map_data);
+
     //! \brief Updates the state of all map zones and objects
     void Update();
 
@@ -129,6 +226,10 @@ public:
     void DrawSkyObjects();
     void DrawLights();
     void DrawInteractionIcons();
+
+    //! \brief Draws the emotes of the objects on screen, after all of the objects
+    //! so that the emotes sharing a texture sheet are drawn at once.
+    void DrawEmotes();
     //@}
 
     /** \brief Finds the nearest interactable map object within a certain distance of a sprite
@@ -171,6 +272,16 @@ public:
     **/
     COLLISION_TYPE GetCollisionFromObjectType(MapObject *obj) const;
 
+    /** \brief Updates the spatial hash buckets of an object whose position or collision size changed.
+    *** \note This is called by the MapObject setters, so it shouldn't be needed elsewhere.
+    **/
+    void UpdateSpatialHash(MapObject* object);
+
+    /** \brief Updates the hot data of an object whose position, image size, visibility or draw pass changed.
+    *** \note This is called by the MapObject setters, and by UpdateSpatialHash(), so it shouldn't be needed elsewhere.
+    **/
+    void UpdateHotData(MapObject* object);
+
     /** \brief Tells the collision type of a sprite when it is at the given position
     *** \param object A pointer to the map object to check
     *** \param x The collision point on the x axis
@@ -185,15 +296,33 @@ public:
     COLLISION_TYPE DetectCollision(MapObject* object, float x, float y,
                                    MapObject **collision_object_ptr = nullptr);
 
+    /** \brief Sweeps the collision rectangle of a sprite along its move,
+    *** against the collision grid, the map bounds and the objects.
+    *** \param object A pointer to the moving sprite
+    *** \param dx The move on the x axis
+    *** \param dy The move on the y axis
+    *** \param sweep Filled with the first obstacle hit, its time of impact and contact normal,
+    *** and the position reached.
+    ***
+    *** The obstacles are gathered once from the grid and the spatial hash, and then
+    *** swept against: A diagonal move blocked slides along the obstacle side hit,
+    *** and a straight move blocked by a wall gets the step around the obstacle corner.
+    *** \note Characters already overlapping the sprite are tangled with it, and let it through.
+    **/
+    void SweepCollision(MapObject* object, float dx, float dy, CollisionSweep& sweep);
+
     /** \brief Finds a path from a sprite's current position to a destination
     *** \param sprite A pointer of the sprite to find the path for
     *** \param dest The destination coordinates
-    *** \param path A vector of PathNode objects storing the path
     *** \param max_cost Tells how far a path node can be computed agains the starting path node.
     *** This is used to avoid heavy computations.
     *** If this param is equal to 0, there is no limitation.
     ***
     *** This algorithm uses the A* algorithm to find a path from a source to a destination.
+    *** The open list is a binary heap of the nodes, which are reused from one search to the next.
+    *** When there is no cost limit and the destination is more than two path graph clusters away,
+    *** the entrances to go through are first found in the path graph, and the A* search is only
+    *** run between consecutive entrances, falling back to a full search if that fails.
     *** This function ignores the position of all other objects and only concerns itself with
     *** which map grid elements are walkable.
     ***
@@ -203,6 +332,20 @@ public:
                   const vt_common::Position2D& destination,
                   uint32_t max_cost = 0);
 
+    /** \brief Gets the next position a sprite chasing a target should move to.
+    *** \param sprite The chasing sprite, whose collision size is used.
+    *** \param target The sprite being chased, usually the camera.
+    *** \param next_step The center of the next grid element to move to.
+    *** \return False when the target should be reached directly, because the sprite
+    *** is next to it, too far away, or can't reach it through the collision grid.
+    ***
+    *** All the sprites chasing the same target share a flow field, only recomputed
+    *** when the target moves to another grid element, so this is O(1) otherwise.
+    *** Only the collision grid is taken into account, not the other objects.
+    **/
+    bool GetChaseStep(const MapObject* sprite, const VirtualSprite* target,
+                      vt_common::Position2D& next_step);
+
     /** \brief Tells the object supervisor that the given sprite pointer
     *** is the party member object.
     *** This later permits to refresh the sprite shown based on the battle
@@ -230,6 +373,9 @@ public:
     //! \brief Tells whether the sprite has got valid collision coordinates.
     bool IsWithinMapBounds(VirtualSprite *sprite) const;
 
+    //! \brief Tells whether a rectangle is within the map bounds and doesn't overlap any collision grid wall.
+    bool IsGridAreaFree(const vt_common::Rectangle2D& rect) const;
+
     //! \brief Draw the collision rectangles. Used for debugging purpose.
     void DrawCollisionArea(const MapFrame *frame);
 
@@ -253,7 +399,13 @@ public:
     //! \brief checks if the location on the grid has a simple map collision. This is different from
     //! IsStaticCollision, in that it DOES NOT check static objects, but only the collision value for the map
     bool IsMapCollision(uint32_t x, uint32_t y)
-    { return (_collision_grid[y][x] > 0); }
+    { return _collision_grid.IsBlocked(x, y); }
+
+    /** \brief Gives the whole collision grid as IsStaticCollision() sees it,
+    *** i.e. with the cells covered by the ground physical objects unwalkable.
+    *** This spares the point tests when every cell is needed, e.g. for the minimap.
+    **/
+    void GetStaticCollisionGrid(CollisionGrid& grid) const;
 
     //! \brief returns a const reference to the ground objects in
     const std::vector<MapObject *>& GetGroundObjects() const
@@ -277,12 +429,62 @@ private:
     //! \brief Updates the ambient sounds volume according to the camera distance.
     void _UpdateAmbientSounds();
 
+    //! \brief Moves an ambient sound to the sound spatial hash buckets its audible area overlaps.
+    void _UpdateSoundSpatialHash(SoundObject* sound_object);
+
     //! \brief Debug: Draws the map zones in orange
     void _DrawMapZones();
 
+    //! \brief Sizes the spatial hash to the loaded collision grid, and adds the objects created beforehand.
+    void _InitializeSpatialHash();
+
     //! \brief Returns the MapObject vector corresponding to the draw layer.
     std::vector<MapObject*>& _GetObjectsFromDrawLayer(MapObjectDrawLayer layer);
 
+    //! \brief Returns the object ids vector corresponding to the draw layer, or nullptr.
+    std::vector<uint16_t>* _GetObjectIdsFromDrawLayer(MapObjectDrawLayer layer);
+
+    //! \brief Insertion sorts the objects of a layer in draw order, along with their ids.
+    void _SortObjectsInDrawOrder(std::vector<MapObject*>& objects, std::vector<uint16_t>& object_ids);
+
+    //! \brief Draws the visible objects of a layer within the screen edges.
+    void _DrawObjects(const std::vector<MapObject*>& objects, const std::vector<uint16_t>& object_ids);
+
+    //! \brief Returns the draw layer whose objects are searched for an object on the given layer.
+    MapObjectDrawLayer _GetSearchedDrawLayer(MapObjectDrawLayer layer) const;
+
+    //! \brief Path finding helpers, managing the nodes and the open list heap.
+    //@{
+    //! \brief Sizes the nodes to the collision grid, and starts a new generation of them.
+    void _StartPathSearch();
+
+    //! \brief Tells whether the first node should be expanded before the second one.
+    bool _IsPathNodeBetter(uint32_t first_index, uint32_t second_index) const;
+
+    //! \brief Opens a node, whose scores are set, in the current generation.
+    void _PushPathNode(uint32_t node_index);
+
+    //! \brief Removes and returns the open node with the best score.
+    uint32_t _PopPathNode();
+
+    //! \brief Moves an open node up the heap after its score decreased.
+    void _UpdatePathNode(uint32_t node_index);
+
+    /** \brief Runs the A* search between two collision grid elements.
+    *** \param offset_x, offset_y The offset kept on each path position.
+    *** \param path The path the positions after the source are appended to, up to the destination.
+    *** \return False if the destination wasn't reached within max_cost, if not 0.
+    **/
+    bool _FindPathSegment(private_map::VirtualSprite *sprite,
+                          int32_t source_x, int32_t source_y,
+                          int32_t dest_x, int32_t dest_y,
+                          float offset_x, float offset_y,
+                          uint32_t max_cost, Path& path);
+
+    //! \brief Returns the path graph for the sprite collision size, building it the first time.
+    const PathGraph& _GetPathGraph(const MapObject* sprite);
+    //@}
+
     /** \brief The number of rows and columns in the collision grid
     *** The number of collision grid rows and columns is always equal to twice
     *** that of the number of rows and columns of tiles (stored in the TileManager).
@@ -299,13 +501,105 @@ private:
     **/
     private_map::MapSprite* _visible_party_member;
 
-    /** \brief A 2D vector indicating which grid element on the map sprites may be occupied by objects.
-    *** Each bit of each element in this grid corresponds to a context. So all together this entire grid
-    *** stores the collision information for all 32 possible map contexts.
-    *** \Note A position in this member is stored like this:
-    *** _collision_grid[y][x]
+    //! \brief The grid elements of the map sprites can't walk on.
+    CollisionGrid _collision_grid;
+
+    //! \brief The walkable room around each element of the collision grid, built when loading.
+    ClearanceMap _clearance_map;
+
+    //! \brief The path finding nodes, one per collision grid element: _path_nodes[y * _num_grid_x_axis + x]
+    std::vector<PathNode> _path_nodes;
+
+    //! \brief The indices of the open path nodes, as a binary heap ordered by score.
+    std::vector<uint32_t> _path_open_heap;
+
+    //! \brief The current path search, telling which nodes were touched by it.
+    uint32_t _path_generation;
+
+    //! \brief The flow fields toward the chased sprite, one per chasing sprite collision size.
+    std::vector<FlowField> _chase_fields;
+
+    //! \brief The hierarchical path finding graphs, one per path finding sprite collision size.
+    std::vector<PathGraph> _path_graphs;
+
+    //! \brief The objects of every draw layer, bucketed by their collision rectangle position.
+    SpatialHash _spatial_hash;
+
+    //! \brief The objects found by the last spatial hash search, kept to avoid reallocations.
+    std::vector<MapObject*> _nearby_objects;
+
+    //! \brief An obstacle gathered by SweepCollision().
+    class SweepObstacle
+    {
+    public:
+        vt_common::Rectangle2D rect;
+
+        //! \brief The obstacle object, nullptr for the collision grid cells and the map bounds.
+        MapObject* object;
+
+        COLLISION_TYPE collision_type;
+    };
+
+    //! \brief The obstacles gathered by the last SweepCollision() call, kept to avoid reallocations.
+    std::vector<SweepObstacle> _sweep_obstacles;
+
+    //! \brief The obstacles gathered for a sweep.
+    enum SweepFilter {
+        //! \brief The map bounds, the collision grid and all the objects.
+        SWEEP_ALL,
+        //! \brief Everything but the sprites, which don't move while the sprites moves are swept.
+        SWEEP_STATIC,
+        //! \brief The sprites only.
+        SWEEP_SPRITES
+    };
+
+    /** \brief Sweeps a sprite move against the obstacles, in the given buffers.
+    *** \note This doesn't change the supervisor, and may thus be called by several
+    *** threads at once, with their own buffers, while nothing is moved.
+    **/
+    void _SweepCollision(MapObject* object, float dx, float dy, SweepFilter filter,
+                         std::vector<SweepObstacle>& obstacles, std::vector<MapObject*>& nearby_objects,
+                         CollisionSweep& sweep) const;
+
+    //! \brief Gives the area swept by a sprite move, and by its steps around the obstacle corners.
+    vt_common::Rectangle2D _GetSweptArea(const MapObject* object, float dx, float dy) const;
+
+    //! \brief Gathers the obstacles of a sprite within the area swept by its move.
+    void _GatherSweepObstacles(const MapObject* object, const vt_common::Rectangle2D& area, SweepFilter filter,
+                               std::vector<SweepObstacle>& obstacles, std::vector<MapObject*>& nearby_objects) const;
+
+    /** \brief Sweeps a rectangle against the gathered obstacles.
+    *** \return The first obstacle hit, filling its time of impact and contact normal,
+    *** or nullptr when the move is free.
     **/
-    std::vector<std::vector<uint32_t> > _collision_grid;
+    static const SweepObstacle* _SweepObstacles(const std::vector<SweepObstacle>& obstacles,
+                                                const vt_common::Rectangle2D& rect, float dx, float dy,
+                                                float& time, float& normal_x, float& normal_y);
+
+    //! \brief Tells whether a point is free of walls, for the steps around the obstacle corners.
+    bool _IsSweptPointFree(const std::vector<SweepObstacle>& obstacles, float x, float y) const;
+
+    /** \brief The movement phase of Update(), run before the objects updates.
+    ***
+    *** The moves wanted by the sprites are gathered, and then swept against the map bounds,
+    *** the collision grid and the other objects in parallel, since nothing moves meanwhile.
+    *** The moves are then finished one sprite after another, in the draw layers order:
+    *** Only the moves near other sprites are swept again against them, as they are moved.
+    **/
+    void _UpdateMoves();
+
+    //! \brief Adds the moves wanted by the sprites of a draw layer to the movement phase buffers.
+    void _GatherMoves(const std::vector<MapObject*>& objects);
+
+    //! \brief The movement phase buffers, one element per moving sprite, kept to avoid reallocations.
+    //@{
+    std::vector<VirtualSprite*> _move_sprites;
+    std::vector<float> _move_start_x;
+    std::vector<float> _move_start_y;
+    std::vector<float> _move_dx;
+    std::vector<float> _move_dy;
+    std::vector<CollisionSweep> _move_sweeps;
+    //@}
 
     /** \brief A map containing pointers to all of the sprites on a map.
     *** This map does not include a pointer to the _virtual_focus object. The
@@ -339,6 +633,19 @@ private:
     **/
     std::vector<MapObject *> _sky_objects;
 
+    /** \brief The ids of the objects of each draw layer, in the same order as the objects.
+    *** The sort and culling passes look the objects hot data up from them.
+    **/
+    //@{
+    std::vector<uint16_t> _flat_ground_object_ids;
+    std::vector<uint16_t> _ground_object_ids;
+    std::vector<uint16_t> _pass_object_ids;
+    std::vector<uint16_t> _sky_object_ids;
+    //@}
+
+    //! \brief The hot data of the registered objects, indexed by object id.
+    std::vector<MapObjectHotData> _hot_data;
+
     //! \brief A container for all of the save points, quite similar as the ground objects container.
     std::vector<SavePoint *> _save_points;
 
@@ -351,9 +658,18 @@ private:
 
     //! \brief Vector used to know at what exact volume a sound should be played
     //! when there are several instances of the same sound in a MapMode.
-    //! They are also used when restarting the MapMode.
+    //! It only holds the sounds audible at the last update, and is also used when restarting the MapMode.
     std::vector<SoundObject*> _sound_object_highest_volumes;
 
+    //! \brief The ambient sounds, bucketed by the area they can be heard within.
+    SpatialHash _sound_spatial_hash;
+
+    //! \brief The loudest sound object of each shared sound descriptor, kept to avoid reallocations.
+    std::unordered_map<vt_audio::SoundDescriptor*, SoundObject*> _loudest_sound_objects;
+
+    //! \brief The time remaining before the next ambient sounds update, in milliseconds.
+    int32_t _ambient_sound_time_remaining;
+
     //! \brief Containers for all of the map source of light, quite similar as the ground objects container.
     std::vector<Halo *> _halos;
     std::vector<Light *> _lights;
@@ -56,8 +56,12 @@ Halo* Halo::Create(const std::string& filename,
 
 void Halo::Update()
 {
-    if(_updatable)
-        _animation.Update();
+    if(!_updatable)
+        return;
+
+    const uint32_t elapsed_time = _GetAnimationUpdateTime();
+    if(elapsed_time > 0)
+        _animation.Update(elapsed_time);
 }
 
 void Halo::Draw()
@@ -42,12 +42,13 @@ Light::Light(const std::string& main_flare_filename,
 
     _a = _b = 0.0f;
     _distance = 0.0f;
+    _angle_computed = false;
 
     // For better eye-candy, randomize a bit the secondary flare distances.
-    _distance_factor_1 = vt_utils::RandomFloat(8.0f, 12.0f);
-    _distance_factor_2 = vt_utils::RandomFloat(17.0f, 23.0f);
-    _distance_factor_3 = vt_utils::RandomFloat(12.0f, 18.0f);
-    _distance_factor_4 = vt_utils::RandomFloat(5.0f, 9.0f);
+    _distance_factors[0] = -vt_utils::RandomFloat(8.0f, 12.0f);
+    _distance_factors[1] = -vt_utils::RandomFloat(17.0f, 23.0f);
+    _distance_factors[2] = vt_utils::RandomFloat(12.0f, 18.0f);
+    _distance_factors[3] = vt_utils::RandomFloat(5.0f, 9.0f);
 
     if(_main_animation.LoadFromAnimationScript(main_flare_filename)) {
         // Setup the image collision for the display update
@@ -98,12 +99,17 @@ void Light::_UpdateLightAngle()
     center.x = frame.screen_edges.left + (frame.screen_edges.right - frame.screen_edges.left) / 2.0f;
     center.y = frame.screen_edges.top + (frame.screen_edges.bottom - frame.screen_edges.top) / 2.0f;
 
-    // Don't update the distance and angle data in that case.
-    if(center.x == _last_center_pos.x && center.y == _last_center_pos.y)
+    // Don't update the distance and angle data when neither the camera nor the light moved.
+    if(_angle_computed
+            && center.x == _last_center_pos.x && center.y == _last_center_pos.y
+            && _tile_position.x == _last_light_pos.x && _tile_position.y == _last_light_pos.y)
         return;
 
+    _angle_computed = true;
     _last_center_pos.x = center.x;
     _last_center_pos.y = center.y;
+    _last_light_pos.x = _tile_position.x;
+    _last_light_pos.y = _tile_position.y;
 
     _distance = sqrtf(_tile_position.GetDistance2(center));
 
@@ -120,6 +126,12 @@ void Light::_UpdateLightAngle()
 
     _b = _tile_position.y - _a * _tile_position.x;
 
+    // The flares are placed along the line, so that drawing them only has to move there.
+    for(uint32_t i = 0; i < FLARE_COUNT; ++i) {
+        _flare_positions[i].x = _tile_position.x + _distance / _distance_factors[i];
+        _flare_positions[i].y = _a * _flare_positions[i].x + _b;
+    }
+
     // Update the flare alpha depending on the distance
     float distance = _distance / 5.0f;
 
@@ -139,9 +151,11 @@ void Light::Update()
     if(!_updatable)
         return;
 
-    _main_animation.Update();
-    _secondary_animation.Update();
-    _UpdateLightAngle();
+    const uint32_t elapsed_time = _GetAnimationUpdateTime();
+    if(elapsed_time > 0) {
+        _main_animation.Update(elapsed_time);
+        _secondary_animation.Update(elapsed_time);
+    }
 }
 
 void Light::Draw()
@@ -153,45 +167,27 @@ void Light::Draw()
     if(!mm)
         return;
 
+    // The angle is only computed for the lights on screen, once they're there.
+    _UpdateLightAngle();
+
     vt_video::VideoManager->SetDrawFlags(vt_video::VIDEO_X_CENTER,
                                          vt_video::VIDEO_Y_CENTER, 0);
 
     vt_video::VideoManager->DrawHalo(*_main_animation.GetCurrentFrame(), _main_color_alpha);
 
-    if(!_secondary_animation.GetCurrentFrame()) {
+    // The lens flares are skipped at the lower graphics qualities.
+    if(!_secondary_animation.GetCurrentFrame() || !vt_video::VideoManager->AreLightFlaresEnabled()) {
         vt_video::VideoManager->SetDrawFlags(vt_video::VIDEO_X_CENTER,
                                              vt_video::VIDEO_Y_BOTTOM, 0);
         return;
     }
 
-    float next_pos_x = _tile_position.x - _distance / _distance_factor_1;
-    float next_pos_y = _a * next_pos_x + _b;
-
-    vt_video::VideoManager->Move(mm->GetScreenXCoordinate(next_pos_x),
-                                 mm->GetScreenYCoordinate(next_pos_y));
-    vt_video::VideoManager->DrawHalo(*_secondary_animation.GetCurrentFrame(),
-                                     _secondary_color_alpha);
-
-    next_pos_x = _tile_position.x - _distance / _distance_factor_2;
-    next_pos_y = _a * next_pos_x + _b;
-    vt_video::VideoManager->Move(mm->GetScreenXCoordinate(next_pos_x),
-                                 mm->GetScreenYCoordinate(next_pos_y));
-    vt_video::VideoManager->DrawHalo(*_secondary_animation.GetCurrentFrame(),
-                                     _secondary_color_alpha);
-
-    next_pos_x = _tile_position.x + _distance / _distance_factor_3;
-    next_pos_y = _a * next_pos_x + _b;
-    vt_video::VideoManager->Move(mm->GetScreenXCoordinate(next_pos_x),
-                                 mm->GetScreenYCoordinate(next_pos_y));
-    vt_video::VideoManager->DrawHalo(*_secondary_animation.GetCurrentFrame(),
-                                     _secondary_color_alpha);
-
-    next_pos_x = _tile_position.x + _distance / _distance_factor_4;
-    next_pos_y = _a * next_pos_x + _b;
-    vt_video::VideoManager->Move(mm->GetScreenXCoordinate(next_pos_x),
-                                 mm->GetScreenYCoordinate(next_pos_y));
-    vt_video::VideoManager->DrawHalo(*_secondary_animation.GetCurrentFrame(),
-                                     _secondary_color_alpha);
+    for(uint32_t i = 0; i < FLARE_COUNT; ++i) {
+        vt_video::VideoManager->Move(mm->GetScreenXCoordinate(_flare_positions[i].x),
+                                     mm->GetScreenYCoordinate(_flare_positions[i].y));
+        vt_video::VideoManager->DrawHalo(*_secondary_animation.GetCurrentFrame(),
+                                         _secondary_color_alpha);
+    }
 
     vt_video::VideoManager->SetDrawFlags(vt_video::VIDEO_X_CENTER,
                                          vt_video::VIDEO_Y_BOTTOM, 0);
@@ -45,11 +45,11 @@ public:
                          const vt_video::Color &main_color,
                          const vt_video::Color &secondary_color);
 
-    //! \brief Updates the object's current animation and orientation
+    //! \brief Updates the object's current animation
     //! \note the actual image resources is handled by the main map object.
     void Update() override;
 
-    //! \brief Draws the object to the screen, if it is visible.
+    //! \brief Draws the object to the screen, if it is visible, updating its orientation first.
     //! \note the actual image resources is handled by the main map object.
     void Draw() override;
 
@@ -58,7 +58,10 @@ public:
     **/
     vt_common::Rectangle2D GetGridImageRectangle() const override;
 private:
-    //! Updates the angle and distance from the camera viewpoint
+    //! \brief The number of secondary flares drawn along the light line.
+    static const uint32_t FLARE_COUNT = 4;
+
+    //! Updates the angle and distance from the camera viewpoint, and the flare positions.
     void _UpdateLightAngle();
 
     //! \brief A reference to the current light animation.
@@ -78,16 +81,21 @@ private:
     //! Distance between the light and the camera viewpoint.
     float _distance;
 
-    //! Random distance factor used to make the secondary flares appear at random places
-    float _distance_factor_1;
-    float _distance_factor_2;
-    float _distance_factor_3;
-    float _distance_factor_4;
+    //! Random distance factor used to make the secondary flares appear at random places,
+    //! negative for the flares before the light, and positive for the ones after.
+    float _distance_factors[FLARE_COUNT];
+
+    //! The secondary flares map position, computed along with the angle.
+    vt_common::Position2D _flare_positions[FLARE_COUNT];
 
-    /** \brief Used for optimization, keeps the last center position.
-    *** So that we update the distance and angle only when this position has changed.
+    /** \brief Used for optimization, keeps the last center and light positions.
+    *** So that we update the distance and angle only when one of these positions has changed.
     **/
     vt_common::Position2D _last_center_pos;
+    vt_common::Position2D _last_light_pos;
+
+    //! Whether the angle was computed at least once, the last positions being meaningless otherwise.
+    bool _angle_computed;
 }; // class Light : public MapObject
 
 } // namespace private_map
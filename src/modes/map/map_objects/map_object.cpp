@@ -44,11 +44,13 @@ MapObject::MapObject(MapObjectDrawLayer layer) :
     _visible(true),
     _collision_mask(ALL_COLLISION),
     _draw_on_second_pass(false),
+    _always_updated(false),
+    _skipped_update_time(0),
     _object_type(OBJECT_TYPE),
     _emote_animation(nullptr),
     _interaction_icon(nullptr),
     _emote_screen_offset(0.0f, 0.0f),
-    _emote_time(0),
+    _emote_start_time(0),
     _draw_layer(layer),
     _grayscale(false)
 {
@@ -66,8 +68,7 @@ MapObject::~MapObject()
 
 void MapObject::Update()
 {
-    if (_interaction_icon)
-        _interaction_icon->Update();
+    // The interaction icon follows the map animation clock.
 }
 
 bool MapObject::ShouldDraw()
@@ -176,8 +177,43 @@ void MapObject::Emote(const std::string &emote_name, vt_map::private_map::ANIM_D
     _emote_screen_offset.x = _emote_screen_offset.x * MAP_ZOOM_RATIO;
     _emote_screen_offset.y = _emote_screen_offset.y * MAP_ZOOM_RATIO;
 
-    _emote_animation->ResetAnimation();
-    _emote_time = _emote_animation->GetAnimationLength();
+    _emote_start_time = MapMode::CurrentInstance()->GetAnimationClock().GetTime();
+}
+
+void MapObject::_UpdateSpatialHash()
+{
+    MapMode* map_mode = MapMode::CurrentInstance();
+    if(map_mode)
+        map_mode->GetObjectSupervisor()->UpdateSpatialHash(this);
+}
+
+void MapObject::_UpdateHotData()
+{
+    MapMode* map_mode = MapMode::CurrentInstance();
+    if(map_mode)
+        map_mode->GetObjectSupervisor()->UpdateHotData(this);
+}
+
+uint32_t MapObject::_GetAnimationUpdateTime()
+{
+    const uint32_t update_time = vt_system::SystemManager->GetUpdateTime();
+
+    if(!_always_updated) {
+        Rectangle2D update_area = MapMode::CurrentInstance()->GetMapFrame().screen_edges;
+        update_area.left -= OBJECT_UPDATE_MARGIN;
+        update_area.right += OBJECT_UPDATE_MARGIN;
+        update_area.top -= OBJECT_UPDATE_MARGIN;
+        update_area.bottom += OBJECT_UPDATE_MARGIN;
+
+        if(!GetGridImageRectangle().IntersectsWith(update_area)) {
+            _skipped_update_time += update_time;
+            return 0;
+        }
+    }
+
+    const uint32_t elapsed_time = update_time + _skipped_update_time;
+    _skipped_update_time = 0;
+    return elapsed_time;
 }
 
 void MapObject::_UpdateEmote()
@@ -185,27 +221,29 @@ void MapObject::_UpdateEmote()
     if(!_emote_animation)
         return;
 
-    _emote_time -= static_cast<int32_t>(vt_system::SystemManager->GetUpdateTime());
-
     // Once the animation has reached its end, we dereference it
-    if(_emote_time <= 0) {
+    const uint32_t emote_time = MapMode::CurrentInstance()->GetAnimationClock().GetTime() - _emote_start_time;
+    if(emote_time >= _emote_animation->GetAnimationLength())
         _emote_animation = nullptr;
-        _emote_time = 0;
-        return;
-    }
-
-    // Otherwise, just update it
-    _emote_animation->Update();
 }
 
-void MapObject::_DrawEmote()
+void MapObject::DrawEmote()
 {
     if(!_emote_animation)
         return;
 
+    // The objects not updated don't end their emotes.
+    const uint32_t emote_time = MapMode::CurrentInstance()->GetAnimationClock().GetTime() - _emote_start_time;
+    if(emote_time >= _emote_animation->GetAnimationLength())
+        return;
+
+    if(!MapObject::ShouldDraw())
+        return;
+
     // Move the emote to the sprite head top, where the offset should applied from.
     vt_video::VideoManager->MoveRelative(_emote_screen_offset.x,
                                          -_img_screen_height + _emote_screen_offset.y);
+    _emote_animation->SetAnimationTime(emote_time);
     _emote_animation->Draw();
 }
 
@@ -217,6 +255,8 @@ void MapObject::SetInteractionIcon(const std::string& animation_filename)
     if (!_interaction_icon->LoadFromAnimationScript(animation_filename)) {
         PRINT_WARNING << "Interaction icon animation filename couldn't be loaded: " << animation_filename << std::endl;
     }
+    // Follows the map clock rather than being updated with the object.
+    _interaction_icon->SetClock(&MapMode::CurrentInstance()->GetAnimationClock());
 }
 
 void MapObject::DrawInteractionIcon()
@@ -97,6 +97,15 @@ public:
     explicit MapObject(MapObjectDrawLayer layer);
     virtual ~MapObject();
 
+    //! \brief The map objects are allocated in the memory arena of their map.
+    static void* operator new(size_t size) {
+        return AllocateMapMemory(size);
+    }
+
+    static void operator delete(void* pointer, size_t size) {
+        FreeMapMemory(pointer, size);
+    }
+
     /** \brief Updates the state of an object.
     *** Many map objects may not actually have a use for this function. For example, animated objects
     *** like a tree will automatically have their frames updated by the video engine in the draw
@@ -185,14 +194,17 @@ public:
     void SetPosition(float x, float y) {
         _tile_position.x = x;
         _tile_position.y = y;
+        _UpdateSpatialHash();
     }
 
     void SetXPosition(float x) {
         _tile_position.x = x;
+        _UpdateSpatialHash();
     }
 
     void SetYPosition(float y) {
         _tile_position.y = y;
+        _UpdateSpatialHash();
     }
 
     //! \brief Set the object image half width (in pixels).
@@ -201,6 +213,7 @@ public:
         _img_pixel_half_width = width;
         _img_screen_half_width = width * MAP_ZOOM_RATIO;
         _img_grid_half_width = width / GRID_LENGTH * MAP_ZOOM_RATIO;
+        _UpdateHotData();
     }
 
     //! \brief Set the object image half width (in pixels).
@@ -209,18 +222,21 @@ public:
         _img_pixel_height = height;
         _img_screen_height = height * MAP_ZOOM_RATIO;
         _img_grid_height = height / GRID_LENGTH * MAP_ZOOM_RATIO;
+        _UpdateHotData();
     }
 
     void SetCollPixelHalfWidth(float collision) {
         _coll_pixel_half_width = collision;
         _coll_screen_half_width = collision * MAP_ZOOM_RATIO;
         _coll_grid_half_width = collision / GRID_LENGTH * MAP_ZOOM_RATIO;
+        _UpdateSpatialHash();
     }
 
     void SetCollPixelHeight(float collision) {
         _coll_pixel_height = collision;
         _coll_screen_height = collision * MAP_ZOOM_RATIO;
         _coll_grid_height = collision / GRID_LENGTH * MAP_ZOOM_RATIO;
+        _UpdateSpatialHash();
     }
 
     void SetUpdatable(bool update) {
@@ -229,6 +245,7 @@ public:
 
     void SetVisible(bool vis) {
         _visible = vis;
+        _UpdateHotData();
     }
 
     // Use a set of COLLISION_TYPE bitmask values
@@ -238,6 +255,13 @@ public:
 
     void SetDrawOnSecondPass(bool pass) {
         _draw_on_second_pass = pass;
+        _UpdateHotData();
+    }
+
+    //! \brief Makes the object animations update every frame, even far from the screen.
+    //! Useful when a script relies on the animation timing, e.g. waiting for it to finish.
+    void SetAlwaysUpdated(bool always_updated) {
+        _always_updated = always_updated;
     }
 
     //! \brief Tells the draw layer for faster deletion from the object supervisor.
@@ -294,6 +318,10 @@ public:
         return _draw_on_second_pass;
     }
 
+    bool IsAlwaysUpdated() const {
+        return _always_updated;
+    }
+
     MAP_OBJECT_TYPE GetType() const {
         return _object_type;
     }
@@ -316,11 +344,19 @@ public:
         return (_emote_animation);
     }
 
+    //! \brief Draws the emote animation over the object, if any and the object is on screen.
+    //! The emotes are drawn together, after the map objects, so that they are batched.
+    void DrawEmote();
+
     //! \brief Loads the current animation file as the new interaction icon of the object.
     void SetInteractionIcon(const std::string& animation_filename);
 
     //! \brief Draws the interaction icon at the top of the sprite, if any.
     void DrawInteractionIcon();
+
+    bool HasInteractionIcon() const {
+        return _interaction_icon != nullptr;
+    }
     //@}
 
 protected:
@@ -392,6 +428,13 @@ protected:
     **/
     bool _draw_on_second_pass;
 
+    //! \brief When false, the animations are only updated near the screen (default == false).
+    bool _always_updated;
+
+    //! \brief The time elapsed since the animations were last updated, in milliseconds,
+    //! while the object was far from the screen.
+    uint32_t _skipped_update_time;
+
     //! \brief This is used to identify the type of map object for inheriting classes.
     MAP_OBJECT_TYPE _object_type;
 
@@ -407,8 +450,9 @@ protected:
     //! (depending on the map object direction)
     vt_common::Position2D _emote_screen_offset;
 
-    //! \brief the time the emote animation will last in milliseconds,
-    int32_t _emote_time;
+    //! \brief The map animation clock time at which the emote started, in milliseconds.
+    //! The emote animations are shared: Each object draws them at its own time instead of updating them.
+    uint32_t _emote_start_time;
 
     //! \brief The object draw layer. Used to know where to register the MapObject,
     //! and when to delete it in the ObjectSupervisor.
@@ -417,11 +461,21 @@ protected:
     //! \brief Tells whether the map object sprite and animation should be displayed grayscaled or not.
     bool _grayscale;
 
-    //! \brief Takes care of updating the emote animation and state.
+    //! \brief Takes care of ending the emote once its animation is over.
     void _UpdateEmote();
 
-    //! \brief Takes care of drawing the emote animation.
-    void _DrawEmote();
+    //! \brief Tells the object supervisor the collision rectangle moved or changed size.
+    void _UpdateSpatialHash();
+
+    //! \brief Tells the object supervisor the data read by the sort and culling passes changed.
+    void _UpdateHotData();
+
+    /** \brief Returns the time to update the object animations with, in milliseconds.
+    *** Far from the screen, the frame time is only accumulated and 0 is returned,
+    *** so that the animations are skipped. The accumulated time is then returned
+    *** at once when the object is back near the screen, or always updated.
+    **/
+    uint32_t _GetAnimationUpdateTime();
 }; // class MapObject
 
 
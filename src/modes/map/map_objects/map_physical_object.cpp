@@ -44,8 +44,12 @@ PhysicalObject* PhysicalObject::Create(MapObjectDrawLayer layer)
 void PhysicalObject::Update()
 {
     MapObject::Update();
-    if(!_animations.empty() && _updatable)
-        _animations[_current_animation_id].Update();
+    if(_animations.empty() || !_updatable)
+        return;
+
+    const uint32_t elapsed_time = _GetAnimationUpdateTime();
+    if(elapsed_time > 0)
+        _animations[_current_animation_id].Update(elapsed_time);
 }
 
 void PhysicalObject::Draw()
@@ -28,7 +28,6 @@ SoundObject::SoundObject(const std::string& sound_filename, float x, float y, fl
     _strength(strength),
     _sound_volume(0.0f),
     _max_sound_volume(1.0f),
-    _time_remaining(0.0f),
     _activated(true),
     _playing(false)
 {
@@ -52,7 +51,9 @@ SoundObject::SoundObject(const std::string& sound_filename, float x, float y, fl
 
     _collision_mask = NO_COLLISION;
 
+    // The ambient loops give their source first when too many audio are playing.
     if (_sound) {
+        _sound->SetPriority(vt_audio::AUDIO_PRIORITY_AMBIENT);
         _sound->SetLooping(true);
         _sound->SetVolume(0.0f);
         _sound->Stop();
@@ -80,7 +81,7 @@ void SoundObject::SetMaxVolume(float max_volume)
         _max_sound_volume = 1.0f;
 }
 
-void SoundObject::UpdateVolume()
+void SoundObject::UpdateVolume(const Position2D& center)
 {
     // Don't activate a sound which is too weak to be heard anyway.
     if (_strength < 1.0f || _max_sound_volume <= 0.0f) {
@@ -93,24 +94,8 @@ void SoundObject::UpdateVolume()
         return;
     }
 
-    // Update the volume only every 100ms
-    _time_remaining -= static_cast<int32_t>(vt_system::SystemManager->GetUpdateTime());
-    if (_time_remaining > 0)
-        return;
-    _time_remaining = 100;
-
     // N.B.: The distance between two point formula is:
     // squareroot((x2 - x1)^2+(y2 - y1)^2)
-    MapMode *mm = MapMode::CurrentInstance();
-    if(!mm)
-        return;
-
-    const MapFrame& frame = mm->GetMapFrame();
-
-    Position2D center;
-    center.x = frame.screen_edges.left + (frame.screen_edges.right - frame.screen_edges.left) / 2.0f;
-    center.y = frame.screen_edges.top + (frame.screen_edges.bottom - frame.screen_edges.top) / 2.0f;
-
     float distance = _tile_position.GetDistance2(center);
     //distance = sqrtf(_distance); <-- We don't actually need it as it is slow.
 
@@ -134,6 +119,12 @@ void SoundObject::UpdateVolume()
     _playing = true;
 }
 
+Rectangle2D SoundObject::GetAudibleArea() const
+{
+    return Rectangle2D(_tile_position.x - _strength, _tile_position.x + _strength,
+                       _tile_position.y - _strength, _tile_position.y + _strength);
+}
+
 void SoundObject::ApplyVolume()
 {
     if (!_sound)
@@ -170,10 +161,8 @@ void SoundObject::Start()
     if (_activated)
         return;
 
+    // The sound state is restored by the next ambient sounds update.
     _activated = true;
-
-    // Restores the sound state
-    UpdateVolume();
 }
 
 } // namespace private_map
@@ -20,6 +20,9 @@ namespace vt_map
 namespace private_map
 {
 
+//! \brief The time between two updates of the ambient sounds volume, in milliseconds.
+const int32_t AMBIENT_SOUND_UPDATE_TIME = 100;
+
 /** ****************************************************************************
 *** \brief Represents a sound source object on the map
 *** ***************************************************************************/
@@ -47,8 +50,13 @@ public:
     static SoundObject* Create(const std::string& sound_filename,
                                float x, float y, float strength);
 
-    //! \brief Updates the object's currently desired volume.
-    void UpdateVolume();
+    /** \brief Updates the object's currently desired volume.
+    *** \param center The camera center position, the volume depends on the distance to.
+    **/
+    void UpdateVolume(const vt_common::Position2D& center);
+
+    //! \brief Returns the area the sound can be heard within, in collision grid coordinates.
+    vt_common::Rectangle2D GetAudibleArea() const;
 
     //! \brief Applies the object's currently desired volume.
     void ApplyVolume();
@@ -97,9 +105,6 @@ private:
     //! \brief The maximal strength of the sound object. (0.0f - 1.0f)
     float _max_sound_volume;
 
-    //! \brief The time remaining before next update
-    int32_t _time_remaining;
-
     //! \brief Tells whether the sound is activated.
     bool _activated;
 
@@ -0,0 +1,344 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_path_graph.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the hierarchical path finding graph.
+*** ***************************************************************************/
+
+#include "modes/map/map_path_graph.h"
+
+#include "modes/map/map_object_supervisor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace vt_common;
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The cost of an element or node not reached.
+const uint32_t PATH_GRAPH_UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+//! \brief The costs of lateral and diagonal moves, the same as FindPath() ones.
+const uint32_t PATH_GRAPH_LATERAL_COST = 10;
+const uint32_t PATH_GRAPH_DIAGONAL_COST = 14;
+
+//! \brief The entrances at least this long get a node at both ends rather than one in the middle.
+const int32_t PATH_GRAPH_LONG_ENTRANCE = 6;
+
+// The offsets of the eight adjacent elements, lateral ones first.
+static const int32_t PATH_GRAPH_ADJACENT_X[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+static const int32_t PATH_GRAPH_ADJACENT_Y[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+
+typedef std::pair<uint32_t, uint32_t> CostIndex;
+typedef std::priority_queue<CostIndex, std::vector<CostIndex>, std::greater<CostIndex> > CostQueue;
+
+//! \brief The diagonal distance heuristic, the same as FindPath() one.
+static uint32_t _ComputeHeuristic(int32_t x, int32_t y, int32_t dest_x, int32_t dest_y)
+{
+    const uint32_t x_delta = std::abs(dest_x - x);
+    const uint32_t y_delta = std::abs(dest_y - y);
+    if (x_delta > y_delta)
+        return PATH_GRAPH_DIAGONAL_COST * y_delta + PATH_GRAPH_LATERAL_COST * (x_delta - y_delta);
+    return PATH_GRAPH_DIAGONAL_COST * x_delta + PATH_GRAPH_LATERAL_COST * (y_delta - x_delta);
+}
+
+PathGraph::PathGraph(float coll_half_width, float coll_height) :
+    _coll_half_width(coll_half_width),
+    _coll_height(coll_height),
+    _grid_width(0),
+    _grid_height(0),
+    _clusters_x(0),
+    _clusters_y(0)
+{
+}
+
+void PathGraph::Build(const ObjectSupervisor& object_supervisor)
+{
+    uint32_t grid_width = 0;
+    uint32_t grid_height = 0;
+    object_supervisor.GetGridAxis(grid_width, grid_height);
+    _grid_width = static_cast<int32_t>(grid_width);
+    _grid_height = static_cast<int32_t>(grid_height);
+    _clusters_x = (grid_width + PATH_GRAPH_CLUSTER_SIZE - 1) / PATH_GRAPH_CLUSTER_SIZE;
+    _clusters_y = (grid_height + PATH_GRAPH_CLUSTER_SIZE - 1) / PATH_GRAPH_CLUSTER_SIZE;
+
+    // Check once where the sprite fits.
+    _walkable.assign(grid_width * grid_height, false);
+    for (int32_t y = 0; y < _grid_height; ++y) {
+        for (int32_t x = 0; x < _grid_width; ++x) {
+            const float center_x = static_cast<float>(x) + 0.5f;
+            const float center_y = static_cast<float>(y) + 0.5f;
+            const Rectangle2D rect(center_x - _coll_half_width, center_x + _coll_half_width,
+                                   center_y - _coll_height, center_y);
+            _walkable[y * _grid_width + x] = object_supervisor.IsGridAreaFree(rect);
+        }
+    }
+
+    _nodes.clear();
+    _cluster_nodes.assign(_clusters_x * _clusters_y, std::vector<uint32_t>());
+
+    // Find the entrances between each cluster and its right and bottom neighbors.
+    std::vector<int32_t> grid_nodes(grid_width * grid_height, -1);
+    for (uint32_t cluster_y = 0; cluster_y < _clusters_y; ++cluster_y) {
+        for (uint32_t cluster_x = 0; cluster_x < _clusters_x; ++cluster_x) {
+            const int32_t left = cluster_x * PATH_GRAPH_CLUSTER_SIZE;
+            const int32_t top = cluster_y * PATH_GRAPH_CLUSTER_SIZE;
+            const int32_t width = std::min<int32_t>(PATH_GRAPH_CLUSTER_SIZE, _grid_width - left);
+            const int32_t height = std::min<int32_t>(PATH_GRAPH_CLUSTER_SIZE, _grid_height - top);
+
+            if (cluster_x + 1 < _clusters_x)
+                _AddEntrances(left + width - 1, top, 0, 1, 1, 0, height, grid_nodes);
+            if (cluster_y + 1 < _clusters_y)
+                _AddEntrances(left, top + height - 1, 1, 0, 0, 1, width, grid_nodes);
+        }
+    }
+
+    // Link the nodes of each cluster with the cost of walking between them.
+    std::vector<uint32_t> costs;
+    for (uint32_t cluster = 0; cluster < _cluster_nodes.size(); ++cluster) {
+        const std::vector<uint32_t>& cluster_nodes = _cluster_nodes[cluster];
+        for (uint32_t i = 0; i < cluster_nodes.size(); ++i) {
+            _Node& node = _nodes[cluster_nodes[i]];
+            _ComputeClusterCosts(node.grid_index % _grid_width, node.grid_index / _grid_width, costs);
+
+            for (uint32_t j = 0; j < cluster_nodes.size(); ++j) {
+                if (i == j)
+                    continue;
+                const uint32_t cost = _GetClusterCost(costs, cluster, _nodes[cluster_nodes[j]].grid_index);
+                if (cost != PATH_GRAPH_UNREACHABLE)
+                    node.edges.push_back(_Edge(cluster_nodes[j], cost));
+            }
+        }
+    }
+}
+
+bool PathGraph::FindWaypoints(int32_t source_x, int32_t source_y,
+                              int32_t dest_x, int32_t dest_y,
+                              std::vector<uint32_t>& waypoints) const
+{
+    waypoints.clear();
+
+    if (source_x < 0 || source_y < 0 || source_x >= _grid_width || source_y >= _grid_height ||
+            dest_x < 0 || dest_y < 0 || dest_x >= _grid_width || dest_y >= _grid_height) {
+        return false;
+    }
+
+    const uint32_t source_cluster = _GetCluster(source_x, source_y);
+    const uint32_t dest_cluster = _GetCluster(dest_x, dest_y);
+    const uint32_t dest_index = dest_y * _grid_width + dest_x;
+
+    // The source and destination are temporarily added to the graph,
+    // linked to the nodes of their clusters.
+    const uint32_t start_node = _nodes.size();
+    const uint32_t goal_node = start_node + 1;
+
+    std::vector<uint32_t> costs;
+    _ComputeClusterCosts(source_x, source_y, costs);
+    std::vector<_Edge> start_edges;
+    const std::vector<uint32_t>& source_nodes = _cluster_nodes[source_cluster];
+    for (uint32_t i = 0; i < source_nodes.size(); ++i) {
+        const uint32_t cost = _GetClusterCost(costs, source_cluster, _nodes[source_nodes[i]].grid_index);
+        if (cost != PATH_GRAPH_UNREACHABLE)
+            start_edges.push_back(_Edge(source_nodes[i], cost));
+    }
+    if (source_cluster == dest_cluster) {
+        const uint32_t cost = _GetClusterCost(costs, source_cluster, dest_index);
+        if (cost != PATH_GRAPH_UNREACHABLE)
+            start_edges.push_back(_Edge(goal_node, cost));
+    }
+
+    // The moves have the same cost both ways, so the costs from the destination are the costs to it.
+    _ComputeClusterCosts(dest_x, dest_y, costs);
+    std::vector<uint32_t> goal_costs(_nodes.size(), PATH_GRAPH_UNREACHABLE);
+    const std::vector<uint32_t>& dest_nodes = _cluster_nodes[dest_cluster];
+    for (uint32_t i = 0; i < dest_nodes.size(); ++i)
+        goal_costs[dest_nodes[i]] = _GetClusterCost(costs, dest_cluster, _nodes[dest_nodes[i]].grid_index);
+
+    // A* on the graph.
+    std::vector<uint32_t> g_scores(_nodes.size() + 2, PATH_GRAPH_UNREACHABLE);
+    std::vector<int32_t> parents(_nodes.size() + 2, -1);
+    CostQueue open_nodes;
+
+    g_scores[start_node] = 0;
+    open_nodes.push(CostIndex(_ComputeHeuristic(source_x, source_y, dest_x, dest_y), start_node));
+
+    while (!open_nodes.empty()) {
+        const uint32_t node = open_nodes.top().second;
+        const uint32_t f_score = open_nodes.top().first;
+        open_nodes.pop();
+
+        if (node == goal_node)
+            break;
+
+        // Skip the outdated entries of nodes reached through a cheaper path since.
+        const int32_t node_x = (node == start_node) ? source_x : static_cast<int32_t>(_nodes[node].grid_index) % _grid_width;
+        const int32_t node_y = (node == start_node) ? source_y : static_cast<int32_t>(_nodes[node].grid_index) / _grid_width;
+        if (f_score != g_scores[node] + _ComputeHeuristic(node_x, node_y, dest_x, dest_y))
+            continue;
+
+        const std::vector<_Edge>& edges = (node == start_node) ? start_edges : _nodes[node].edges;
+        for (uint32_t i = 0; i <= edges.size(); ++i) {
+            uint32_t next = 0;
+            uint32_t cost = 0;
+            if (i < edges.size()) {
+                next = edges[i].node;
+                cost = edges[i].cost;
+            } else if (node != start_node && goal_costs[node] != PATH_GRAPH_UNREACHABLE) {
+                next = goal_node;
+                cost = goal_costs[node];
+            } else {
+                break;
+            }
+
+            const uint32_t g_score = g_scores[node] + cost;
+            if (g_score >= g_scores[next])
+                continue;
+
+            g_scores[next] = g_score;
+            parents[next] = node;
+
+            if (next == goal_node) {
+                open_nodes.push(CostIndex(g_score, next));
+            } else {
+                const uint32_t next_index = _nodes[next].grid_index;
+                open_nodes.push(CostIndex(g_score + _ComputeHeuristic(next_index % _grid_width, next_index / _grid_width,
+                                                                      dest_x, dest_y), next));
+            }
+        }
+    }
+
+    if (g_scores[goal_node] == PATH_GRAPH_UNREACHABLE)
+        return false;
+
+    // Follow the parents back to the source.
+    waypoints.push_back(dest_index);
+    for (int32_t node = parents[goal_node]; node >= 0 && static_cast<uint32_t>(node) != start_node; node = parents[node])
+        waypoints.push_back(_nodes[node].grid_index);
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    return true;
+}
+
+uint32_t PathGraph::_AddNode(int32_t x, int32_t y, std::vector<int32_t>& grid_nodes)
+{
+    const uint32_t grid_index = y * _grid_width + x;
+    if (grid_nodes[grid_index] >= 0)
+        return grid_nodes[grid_index];
+
+    const uint32_t cluster = _GetCluster(x, y);
+    const uint32_t node = _nodes.size();
+    _nodes.push_back(_Node(grid_index, cluster));
+    _cluster_nodes[cluster].push_back(node);
+    grid_nodes[grid_index] = node;
+    return node;
+}
+
+void PathGraph::_AddEntrances(int32_t x, int32_t y, int32_t step_x, int32_t step_y,
+                              int32_t cross_x, int32_t cross_y, int32_t length,
+                              std::vector<int32_t>& grid_nodes)
+{
+    int32_t start = -1;
+    for (int32_t i = 0; i <= length; ++i) {
+        const int32_t border_x = x + step_x * i;
+        const int32_t border_y = y + step_y * i;
+        const bool open = i < length && _IsWalkable(border_x, border_y)
+                          && _IsWalkable(border_x + cross_x, border_y + cross_y);
+
+        if (open) {
+            if (start < 0)
+                start = i;
+            continue;
+        }
+        if (start < 0)
+            continue;
+
+        // The entrance spans [start, i - 1]: link both sides of its middle, or of its ends when long.
+        const int32_t end = i - 1;
+        int32_t positions[2] = { (start + end) / 2, -1 };
+        if (end - start + 1 >= PATH_GRAPH_LONG_ENTRANCE) {
+            positions[0] = start;
+            positions[1] = end;
+        }
+
+        for (uint32_t p = 0; p < 2 && positions[p] >= 0; ++p) {
+            const int32_t first_x = x + step_x * positions[p];
+            const int32_t first_y = y + step_y * positions[p];
+            const uint32_t first = _AddNode(first_x, first_y, grid_nodes);
+            const uint32_t second = _AddNode(first_x + cross_x, first_y + cross_y, grid_nodes);
+            _nodes[first].edges.push_back(_Edge(second, PATH_GRAPH_LATERAL_COST));
+            _nodes[second].edges.push_back(_Edge(first, PATH_GRAPH_LATERAL_COST));
+        }
+        start = -1;
+    }
+}
+
+void PathGraph::_ComputeClusterCosts(int32_t x, int32_t y, std::vector<uint32_t>& costs) const
+{
+    const int32_t left = (x / PATH_GRAPH_CLUSTER_SIZE) * PATH_GRAPH_CLUSTER_SIZE;
+    const int32_t top = (y / PATH_GRAPH_CLUSTER_SIZE) * PATH_GRAPH_CLUSTER_SIZE;
+    const int32_t right = std::min<int32_t>(left + PATH_GRAPH_CLUSTER_SIZE, _grid_width);
+    const int32_t bottom = std::min<int32_t>(top + PATH_GRAPH_CLUSTER_SIZE, _grid_height);
+
+    costs.assign(PATH_GRAPH_CLUSTER_SIZE * PATH_GRAPH_CLUSTER_SIZE, PATH_GRAPH_UNREACHABLE);
+
+    // The start is always reachable, even when the sprite stands partly in a wall.
+    const uint32_t start = (y - top) * PATH_GRAPH_CLUSTER_SIZE + x - left;
+    costs[start] = 0;
+
+    CostQueue open_elements;
+    open_elements.push(CostIndex(0, start));
+    while (!open_elements.empty()) {
+        const CostIndex best = open_elements.top();
+        open_elements.pop();
+        if (best.first != costs[best.second])
+            continue;
+
+        const int32_t best_x = left + static_cast<int32_t>(best.second % PATH_GRAPH_CLUSTER_SIZE);
+        const int32_t best_y = top + static_cast<int32_t>(best.second / PATH_GRAPH_CLUSTER_SIZE);
+        for (uint32_t i = 0; i < 8; ++i) {
+            const int32_t next_x = best_x + PATH_GRAPH_ADJACENT_X[i];
+            const int32_t next_y = best_y + PATH_GRAPH_ADJACENT_Y[i];
+            if (next_x < left || next_y < top || next_x >= right || next_y >= bottom)
+                continue;
+            if (!_walkable[next_y * _grid_width + next_x])
+                continue;
+
+            const uint32_t next = (next_y - top) * PATH_GRAPH_CLUSTER_SIZE + next_x - left;
+            const uint32_t cost = best.first + (i < 4 ? PATH_GRAPH_LATERAL_COST : PATH_GRAPH_DIAGONAL_COST);
+            if (cost >= costs[next])
+                continue;
+
+            costs[next] = cost;
+            open_elements.push(CostIndex(cost, next));
+        }
+    }
+}
+
+uint32_t PathGraph::_GetClusterCost(const std::vector<uint32_t>& costs, uint32_t cluster, uint32_t grid_index) const
+{
+    const int32_t left = (cluster % _clusters_x) * PATH_GRAPH_CLUSTER_SIZE;
+    const int32_t top = (cluster / _clusters_x) * PATH_GRAPH_CLUSTER_SIZE;
+    const int32_t x = static_cast<int32_t>(grid_index) % _grid_width - left;
+    const int32_t y = static_cast<int32_t>(grid_index) / _grid_width - top;
+    return costs[y * PATH_GRAPH_CLUSTER_SIZE + x];
+}
+
+} // namespace private_map
+
+} // namespace vt_map
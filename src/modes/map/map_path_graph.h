@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_path_graph.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the hierarchical path finding graph.
+***
+*** The collision grid is split into square clusters. The walkable segments of
+*** the borders between two clusters are their entrances, and the graph links
+*** the entrances of each cluster with the cost of walking between them. Long
+*** paths are first searched in this small graph, and only then refined on the
+*** collision grid, between consecutive entrances.
+*** ***************************************************************************/
+
+#ifndef __MAP_PATH_GRAPH_HEADER__
+#define __MAP_PATH_GRAPH_HEADER__
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+class ObjectSupervisor;
+
+//! \brief The width and height of the path graph clusters, in collision grid elements.
+const uint32_t PATH_GRAPH_CLUSTER_SIZE = 16;
+
+/** ****************************************************************************
+*** \brief The abstract graph of the entrances between the collision grid clusters.
+***
+*** The graph only takes the collision grid into account, and is built for one
+*** sprite collision size, as walkability depends on it. The grid never changes
+*** once the map is loaded, so the graph is built once and reused by every search.
+*** ***************************************************************************/
+class PathGraph
+{
+public:
+    PathGraph(float coll_half_width, float coll_height);
+
+    //! \brief Tells whether the graph is built for sprites with that collision size.
+    bool HasCollisionSize(float coll_half_width, float coll_height) const {
+        return _coll_half_width == coll_half_width && _coll_height == coll_height;
+    }
+
+    //! \brief Builds the clusters, their entrances and the costs between them.
+    void Build(const ObjectSupervisor& object_supervisor);
+
+    /** \brief Finds the entrances to go through to reach a destination.
+    *** \param source_x The x collision grid position to start from.
+    *** \param source_y The y collision grid position to start from.
+    *** \param dest_x The x collision grid position to reach.
+    *** \param dest_y The y collision grid position to reach.
+    *** \param waypoints Filled with the grid indices (y * grid width + x) of the
+    *** entrances to reach one after another, ending with the destination.
+    *** \return False if the destination can't be reached through the graph.
+    **/
+    bool FindWaypoints(int32_t source_x, int32_t source_y,
+                       int32_t dest_x, int32_t dest_y,
+                       std::vector<uint32_t>& waypoints) const;
+
+private:
+    //! \brief A link between two nodes of the graph.
+    class _Edge
+    {
+    public:
+        _Edge(uint32_t node_, uint32_t cost_) :
+            node(node_),
+            cost(cost_)
+        {}
+
+        uint32_t node;
+        uint32_t cost;
+    };
+
+    //! \brief An entrance side, in one cluster.
+    class _Node
+    {
+    public:
+        _Node(uint32_t grid_index_, uint32_t cluster_) :
+            grid_index(grid_index_),
+            cluster(cluster_)
+        {}
+
+        uint32_t grid_index;
+        uint32_t cluster;
+        std::vector<_Edge> edges;
+    };
+
+    //! \brief The collision size of the sprites the graph is built for, in grid elements.
+    float _coll_half_width;
+    float _coll_height;
+
+    //! \brief The collision grid size, and the number of clusters on each axis.
+    int32_t _grid_width;
+    int32_t _grid_height;
+    uint32_t _clusters_x;
+    uint32_t _clusters_y;
+
+    //! \brief Whether the sprite fits on each collision grid element.
+    std::vector<bool> _walkable;
+
+    //! \brief The graph nodes.
+    std::vector<_Node> _nodes;
+
+    //! \brief The nodes of each cluster: _cluster_nodes[cluster_y * _clusters_x + cluster_x]
+    std::vector<std::vector<uint32_t> > _cluster_nodes;
+
+    //! \brief Returns the cluster of a collision grid element.
+    uint32_t _GetCluster(int32_t x, int32_t y) const {
+        return (y / PATH_GRAPH_CLUSTER_SIZE) * _clusters_x + x / PATH_GRAPH_CLUSTER_SIZE;
+    }
+
+    bool _IsWalkable(int32_t x, int32_t y) const {
+        return x >= 0 && y >= 0 && x < _grid_width && y < _grid_height && _walkable[y * _grid_width + x];
+    }
+
+    //! \brief Returns the node of an entrance side, adding it if needed.
+    uint32_t _AddNode(int32_t x, int32_t y, std::vector<int32_t>& grid_nodes);
+
+    //! \brief Adds the entrances of a border between two clusters.
+    //! \param x, y The first element of the border, on the first cluster side.
+    //! \param step_x, step_y The direction along the border.
+    //! \param cross_x, cross_y The direction from the first cluster to the second one.
+    void _AddEntrances(int32_t x, int32_t y, int32_t step_x, int32_t step_y,
+                       int32_t cross_x, int32_t cross_y, int32_t length,
+                       std::vector<int32_t>& grid_nodes);
+
+    /** \brief Computes the walking costs from an element to every element of its cluster.
+    *** \param costs Filled with the costs, indexed like the cluster elements,
+    *** the maximum value meaning unreachable.
+    **/
+    void _ComputeClusterCosts(int32_t x, int32_t y, std::vector<uint32_t>& costs) const;
+
+    //! \brief Returns the cost of a cluster element, from the costs computed by _ComputeClusterCosts().
+    uint32_t _GetClusterCost(const std::vector<uint32_t>& costs, uint32_t cluster, uint32_t grid_index) const;
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_PATH_GRAPH_HEADER__
@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_prefetcher.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the prefetching of the maps the player may go to.
+*** ***************************************************************************/
+
+#include "modes/map/map_prefetcher.h"
+
+#include "modes/map/map_utils.h"
+
+#include "engine/video/video.h"
+#include "script/script_read.h"
+
+#include "utils/utils_common.h"
+#include "utils/utils_files.h"
+
+#include <algorithm>
+
+using namespace vt_script;
+using namespace vt_system;
+using namespace vt_video;
+
+namespace vt_map
+{
+
+// Defined in map_mode.cpp
+void AddEp1ToMapPath(std::string& map_filename);
+
+namespace private_map
+{
+
+//! \brief The memory used by a decoded tileset image: 512x512 RGBA pixels.
+const uint32_t TILESET_IMAGE_MEMORY = 512 * 512 * 4;
+
+std::deque<MapPrefetcher::_PrefetchedMap> MapPrefetcher::_maps;
+uint32_t MapPrefetcher::_memory_size = 0;
+std::shared_ptr<MapPrefetcher::_LoadingMapData> MapPrefetcher::_loading_map_data;
+JobHandle MapPrefetcher::_loading_map_data_job;
+
+void MapPrefetcher::Prefetch(const std::string& map_data_filename)
+{
+    // Resolve the filename like the map mode does, so that it finds the map.
+    // DEPRECATED: Remove this after episode II release
+    std::string filename = map_data_filename;
+    if(!vt_utils::DoesFileExist(filename))
+        AddEp1ToMapPath(filename);
+
+    if(_FindMap(filename) >= 0)
+        return;
+
+    _PrefetchedMap prefetched_map;
+    prefetched_map.map_data_filename = filename;
+    if(!prefetched_map.map_data.Load(GetBinaryMapDataFilename(filename), filename)) {
+        IF_PRINT_WARNING(MAP_DEBUG) << "Not prefetching the map without up to date baked data: "
+                                    << filename << std::endl;
+        return;
+    }
+
+    if(!_ReadTilesetImages(prefetched_map.map_data.GetTilesetFilenames(), prefetched_map.image_filenames))
+        return;
+
+    prefetched_map.memory_size = prefetched_map.map_data.GetSize()
+                                 + prefetched_map.image_filenames.size() * TILESET_IMAGE_MEMORY;
+    if(prefetched_map.memory_size > MAP_PREFETCH_MAX_MEMORY)
+        return;
+
+    while(_memory_size + prefetched_map.memory_size > MAP_PREFETCH_MAX_MEMORY)
+        _EvictOldestMap();
+
+    for(uint32_t i = 0; i < prefetched_map.image_filenames.size(); ++i)
+        TextureManager->PrefetchImage(prefetched_map.image_filenames[i]);
+
+    _memory_size += prefetched_map.memory_size;
+    _maps.push_back(prefetched_map);
+}
+
+JobHandle MapPrefetcher::PrefetchMapData(const std::string& map_data_filename)
+{
+    // DEPRECATED: Remove this after episode II release
+    std::string filename = map_data_filename;
+    if(!vt_utils::DoesFileExist(filename))
+        AddEp1ToMapPath(filename);
+
+    if(_FindMap(filename) >= 0)
+        return JobHandle();
+    if(_loading_map_data && _loading_map_data->map_data_filename == filename)
+        return _loading_map_data_job;
+
+    // The job keeps its own reference, so that a cleared read can still finish.
+    std::shared_ptr<_LoadingMapData> loading_map_data = std::make_shared<_LoadingMapData>();
+    loading_map_data->map_data_filename = filename;
+    const std::string binary_filename = GetBinaryMapDataFilename(filename);
+    _loading_map_data = loading_map_data;
+    _loading_map_data_job = JobManager->Schedule([loading_map_data, binary_filename]() {
+        loading_map_data->loaded = loading_map_data->map_data.Load(binary_filename,
+                                                                   loading_map_data->map_data_filename);
+    });
+    return _loading_map_data_job;
+}
+
+bool MapPrefetcher::TakeMapData(const std::string& map_data_filename, BinaryMapData& map_data)
+{
+    if(_loading_map_data && _loading_map_data->map_data_filename == map_data_filename) {
+        std::shared_ptr<_LoadingMapData> loading_map_data = _loading_map_data;
+        JobManager->Wait(_loading_map_data_job);
+        _loading_map_data.reset();
+        _loading_map_data_job = JobHandle();
+        if(loading_map_data->loaded) {
+            std::swap(map_data, loading_map_data->map_data);
+            return true;
+        }
+    }
+
+    int32_t index = _FindMap(map_data_filename);
+    if(index < 0)
+        return false;
+
+    // The decoded images are left to the texture manager, which takes them when loading the tilesets.
+    std::swap(map_data, _maps[index].map_data);
+    _memory_size -= _maps[index].memory_size;
+    _maps.erase(_maps.begin() + index);
+    return true;
+}
+
+void MapPrefetcher::Clear()
+{
+    _loading_map_data.reset();
+    _loading_map_data_job = JobHandle();
+
+    while(!_maps.empty())
+        _EvictOldestMap();
+}
+
+int32_t MapPrefetcher::_FindMap(const std::string& map_data_filename)
+{
+    for(uint32_t i = 0; i < _maps.size(); ++i) {
+        if(_maps[i].map_data_filename == map_data_filename)
+            return i;
+    }
+    return -1;
+}
+
+void MapPrefetcher::_EvictOldestMap()
+{
+    if(_maps.empty())
+        return;
+
+    const std::vector<std::string>& image_filenames = _maps.front().image_filenames;
+    for(uint32_t i = 0; i < image_filenames.size(); ++i) {
+        // Keep the images also used by the other prefetched maps.
+        bool shared = false;
+        for(uint32_t j = 1; j < _maps.size() && !shared; ++j) {
+            const std::vector<std::string>& other_filenames = _maps[j].image_filenames;
+            shared = std::find(other_filenames.begin(), other_filenames.end(), image_filenames[i]) != other_filenames.end();
+        }
+        if(!shared)
+            TextureManager->CancelPrefetchedImage(image_filenames[i]);
+    }
+
+    _memory_size -= _maps.front().memory_size;
+    _maps.pop_front();
+}
+
+bool MapPrefetcher::_ReadTilesetImages(const std::vector<std::string>& tileset_filenames,
+                                       std::vector<std::string>& image_filenames)
+{
+    for(uint32_t i = 0; i < tileset_filenames.size(); ++i) {
+        ReadScriptDescriptor tileset_script;
+        if(!tileset_script.OpenFile(tileset_filenames[i]))
+            return false;
+
+        if(!tileset_script.OpenTable("tileset")) {
+            tileset_script.CloseFile();
+            return false;
+        }
+
+        image_filenames.push_back(tileset_script.ReadString("image"));
+        tileset_script.CloseFile();
+    }
+    return true;
+}
+
+} // namespace private_map
+
+} // namespace vt_map
@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_prefetcher.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the prefetching of the maps the player may go to.
+***
+*** When the camera gets near the zone of a map transition, the destination
+*** map data is read and its tileset images are decoded in the background,
+*** so that the map mode created after the transition fade only has to upload
+*** them. The prefetched maps outlive the map mode which requested them.
+*** A map pushed without being prefetched gets its data read by a job during
+*** its push fade out instead.
+*** ***************************************************************************/
+
+#ifndef __MAP_PREFETCHER_HEADER__
+#define __MAP_PREFETCHER_HEADER__
+
+#include "modes/map/map_binary_data.h"
+
+#include "engine/job_system.h"
+
+#include <deque>
+#include <memory>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The memory the prefetched maps can use, data and decoded images, in bytes.
+const uint32_t MAP_PREFETCH_MAX_MEMORY = 64 * 1024 * 1024;
+
+//! \brief The distance to a transition zone from which its destination is prefetched, in grid elements.
+const float MAP_PREFETCH_DISTANCE = 8.0f;
+
+/** ****************************************************************************
+*** \brief Keeps the data of the maps prefetched, until they get loaded.
+***
+*** Only the maps baked by tools/bake-map-data.py are prefetched, since parsing
+*** the Lua map data would stall the current map as much as the transition.
+*** When the memory cap is reached, the oldest prefetched maps are forgotten.
+*** ***************************************************************************/
+class MapPrefetcher
+{
+public:
+    /** \brief Reads a map data and starts decoding its tileset images in the background.
+    *** \param map_data_filename The map data Lua file, as given to the MapMode.
+    **/
+    static void Prefetch(const std::string& map_data_filename);
+
+    /** \brief Starts reading the data of a map about to be loaded, in a job.
+    *** \param map_data_filename The map data Lua file, as given to the MapMode.
+    *** \return The job reading the data, done right away if the map was prefetched already.
+    *** The tileset images are left to the asset manifest, as reading their definitions needs the Lua state.
+    **/
+    static vt_system::JobHandle PrefetchMapData(const std::string& map_data_filename);
+
+    /** \brief Gives the data of a prefetched map, and forgets about it.
+    *** \param map_data_filename The map data Lua file, once resolved by the MapMode.
+    *** \return False if the map wasn't prefetched.
+    **/
+    static bool TakeMapData(const std::string& map_data_filename, BinaryMapData& map_data);
+
+    //! \brief Forgets every prefetched map, and cancels the decoding of their images.
+    static void Clear();
+
+private:
+    class _PrefetchedMap
+    {
+    public:
+        std::string map_data_filename;
+        BinaryMapData map_data;
+        std::vector<std::string> image_filenames;
+        uint32_t memory_size;
+    };
+
+    //! \brief A map data read by a job, shared with it.
+    class _LoadingMapData
+    {
+    public:
+        _LoadingMapData() :
+            loaded(false)
+        {}
+
+        std::string map_data_filename;
+        BinaryMapData map_data;
+        bool loaded;
+    };
+
+    //! \brief The prefetched maps, the oldest first.
+    static std::deque<_PrefetchedMap> _maps;
+
+    //! \brief The map data being read by a job, if any, and the job.
+    static std::shared_ptr<_LoadingMapData> _loading_map_data;
+    static vt_system::JobHandle _loading_map_data_job;
+
+    //! \brief The memory used by the prefetched maps, in bytes.
+    static uint32_t _memory_size;
+
+    //! \brief Returns the prefetched map index, or -1 if it isn't prefetched.
+    static int32_t _FindMap(const std::string& map_data_filename);
+
+    //! \brief Forgets the oldest prefetched map, and cancels its images not used by others.
+    static void _EvictOldestMap();
+
+    //! \brief Returns the image filename of each tileset definition file.
+    static bool _ReadTilesetImages(const std::vector<std::string>& tileset_filenames,
+                                   std::vector<std::string>& image_filenames);
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_PREFETCHER_HEADER__
@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_script_scheduler.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the scheduling of the map script update functions.
+*** ***************************************************************************/
+
+#include "modes/map/map_script_scheduler.h"
+
+#include "modes/map/map_utils.h"
+
+#include "common/script_call_profiler.h"
+
+#include <SDL2/SDL_timer.h>
+
+using namespace vt_script;
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+MapScriptScheduler::MapScriptScheduler() :
+    _trigger_time_remaining(0),
+    _budget(MAP_SCRIPT_DEFAULT_BUDGET),
+    _last_update_time(0),
+    _max_update_time(0),
+    _warning_time_remaining(0)
+{
+}
+
+void MapScriptScheduler::AddPeriodicFunction(const luabind::object& function, uint32_t interval)
+{
+    if(!function.is_valid()) {
+        PRINT_WARNING << "Invalid periodic update function in map script: " << _script_filename << std::endl;
+        return;
+    }
+
+    _PeriodicFunction periodic_function;
+    periodic_function.function = function;
+    periodic_function.interval = interval;
+    periodic_function.time_remaining = 0;
+    _periodic_functions.push_back(periodic_function);
+}
+
+void MapScriptScheduler::AddTriggeredFunction(const luabind::object& condition_function, const luabind::object& function)
+{
+    if(!condition_function.is_valid() || !function.is_valid()) {
+        PRINT_WARNING << "Invalid triggered function in map script: " << _script_filename << std::endl;
+        return;
+    }
+
+    _TriggeredFunction triggered_function;
+    triggered_function.condition_function = condition_function;
+    triggered_function.function = function;
+    _triggered_functions.push_back(triggered_function);
+}
+
+void MapScriptScheduler::Update(uint32_t elapsed_time)
+{
+    const uint64_t start_counter = SDL_GetPerformanceCounter();
+
+    if(_frame_function.is_valid())
+        _CallFunction(_frame_function, false);
+
+    // A periodic function is called at most once per frame, even after a long frame.
+    for(uint32_t i = 0; i < _periodic_functions.size(); ++i) {
+        _periodic_functions[i].time_remaining -= static_cast<int32_t>(elapsed_time);
+        if(_periodic_functions[i].time_remaining > 0)
+            continue;
+        _periodic_functions[i].time_remaining = _periodic_functions[i].interval;
+        _CallFunction(_periodic_functions[i].function, false);
+    }
+
+    _trigger_time_remaining -= static_cast<int32_t>(elapsed_time);
+    if(_trigger_time_remaining <= 0 && !_triggered_functions.empty()) {
+        _trigger_time_remaining = MAP_SCRIPT_TRIGGER_INTERVAL;
+
+        // The triggered functions may add others, so the vector can grow while iterating.
+        for(uint32_t i = 0; i < _triggered_functions.size();) {
+            if(!_CallFunction(_triggered_functions[i].condition_function, true)) {
+                ++i;
+                continue;
+            }
+
+            const luabind::object function = _triggered_functions[i].function;
+            _triggered_functions.erase(_triggered_functions.begin() + i);
+            _CallFunction(function, false);
+        }
+    }
+
+    _last_update_time = (SDL_GetPerformanceCounter() - start_counter) * 1000000 / SDL_GetPerformanceFrequency();
+    if(_last_update_time > _max_update_time)
+        _max_update_time = _last_update_time;
+
+    _warning_time_remaining -= static_cast<int32_t>(elapsed_time);
+    if(_last_update_time > _budget && _warning_time_remaining <= 0) {
+        _warning_time_remaining = MAP_SCRIPT_BUDGET_WARNING_INTERVAL;
+        IF_PRINT_WARNING(MAP_DEBUG) << "The map script update functions took " << _last_update_time
+                                    << " microseconds, over the budget of " << _budget
+                                    << " microseconds, in map script: " << _script_filename << std::endl;
+    }
+}
+
+void MapScriptScheduler::Clear()
+{
+    _frame_function = luabind::object();
+    _periodic_functions.clear();
+    _triggered_functions.clear();
+}
+
+bool MapScriptScheduler::_CallFunction(const luabind::object& function, bool has_result)
+{
+    try {
+        vt_common::ScriptCallTimer timer(has_result ? "map script condition" : "map script update", function);
+        if(has_result)
+            return luabind::call_function<bool>(function);
+        luabind::call_function<void>(function);
+    } catch(const luabind::error &e) {
+        PRINT_ERROR << "Error while calling a map script update function in: "
+                    << _script_filename << std::endl;
+        ScriptManager->HandleLuaError(e);
+    } catch(const luabind::cast_failed &e) {
+        PRINT_ERROR << "Error while calling a map script update function in: "
+                    << _script_filename << std::endl;
+        ScriptManager->HandleCastError(e);
+    }
+    return false;
+}
+
+} // namespace private_map
+
+} // namespace vt_map
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_script_scheduler.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the scheduling of the map script update functions.
+***
+*** The map script Update() function is called every frame. The map scripts
+*** can also register functions called at a lower rate, and functions called
+*** once when a condition function returns true, so that the checks which
+*** don't need to happen every frame don't cost a Lua call each frame.
+*** The time spent in the script calls is measured, and a warning is printed
+*** when it goes over the frame budget.
+*** ***************************************************************************/
+
+#ifndef __MAP_SCRIPT_SCHEDULER_HEADER__
+#define __MAP_SCRIPT_SCHEDULER_HEADER__
+
+#include "script/script.h"
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+//! \brief The default time the map script functions may take each frame, in microseconds.
+const uint32_t MAP_SCRIPT_DEFAULT_BUDGET = 2000;
+
+//! \brief The time between two checks of the trigger conditions, in milliseconds.
+const uint32_t MAP_SCRIPT_TRIGGER_INTERVAL = 100;
+
+//! \brief The minimal time between two over budget warnings, in milliseconds.
+const int32_t MAP_SCRIPT_BUDGET_WARNING_INTERVAL = 5000;
+
+/** ****************************************************************************
+*** \brief Calls the map script update functions, and measures their time.
+*** ***************************************************************************/
+class MapScriptScheduler
+{
+public:
+    MapScriptScheduler();
+
+    //! \brief Sets the function called every frame, usually the map script Update() function.
+    void SetFrameFunction(const luabind::object& function) {
+        _frame_function = function;
+    }
+
+    /** \brief Adds a function called at a given interval.
+    *** \param interval The time between two calls, in milliseconds.
+    **/
+    void AddPeriodicFunction(const luabind::object& function, uint32_t interval);
+
+    /** \brief Adds a function called once, when the condition function returns true.
+    *** The condition is only checked every MAP_SCRIPT_TRIGGER_INTERVAL.
+    **/
+    void AddTriggeredFunction(const luabind::object& condition_function, const luabind::object& function);
+
+    //! \brief Sets the time the functions may take each frame before a warning, in microseconds.
+    void SetBudget(uint32_t budget) {
+        _budget = budget;
+    }
+
+    //! \brief Calls the functions due this frame.
+    void Update(uint32_t elapsed_time);
+
+    //! \brief Removes every function reference, before the script is closed.
+    void Clear();
+
+    //! \brief Returns the time spent in the functions during the last update, and the longest one, in microseconds.
+    uint64_t GetLastUpdateTime() const {
+        return _last_update_time;
+    }
+
+    uint64_t GetMaxUpdateTime() const {
+        return _max_update_time;
+    }
+
+    //! \brief The map script filename, used by the warnings.
+    void SetScriptFilename(const std::string& filename) {
+        _script_filename = filename;
+    }
+
+private:
+    class _PeriodicFunction
+    {
+    public:
+        luabind::object function;
+        uint32_t interval;
+        int32_t time_remaining;
+    };
+
+    class _TriggeredFunction
+    {
+    public:
+        luabind::object condition_function;
+        luabind::object function;
+    };
+
+    //! \brief The function called every frame.
+    luabind::object _frame_function;
+
+    std::vector<_PeriodicFunction> _periodic_functions;
+
+    //! \brief The functions waiting for their condition, and the time before the next check.
+    std::vector<_TriggeredFunction> _triggered_functions;
+    int32_t _trigger_time_remaining;
+
+    //! \brief The frame budget, in microseconds.
+    uint32_t _budget;
+
+    //! \brief The time spent in the functions, in microseconds.
+    uint64_t _last_update_time;
+    uint64_t _max_update_time;
+
+    //! \brief The time before an over budget warning may be printed again, in milliseconds.
+    int32_t _warning_time_remaining;
+
+    std::string _script_filename;
+
+    //! \brief Calls a script function, and returns its boolean result, or false on error.
+    bool _CallFunction(const luabind::object& function, bool has_result);
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_SCRIPT_SCHEDULER_HEADER__
@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_spatial_hash.cpp
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Source file for the spatial hash used to find map objects near a position.
+*** ***************************************************************************/
+
+#include "modes/map/map_spatial_hash.h"
+
+#include "modes/map/map_objects/map_object.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vt_common;
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+SpatialHash::SpatialHash() :
+    _buckets_x(0),
+    _buckets_y(0)
+{
+}
+
+void SpatialHash::Initialize(uint32_t grid_width, uint32_t grid_height)
+{
+    _buckets_x = (grid_width + SPATIAL_HASH_BUCKET_SIZE - 1) / SPATIAL_HASH_BUCKET_SIZE;
+    _buckets_y = (grid_height + SPATIAL_HASH_BUCKET_SIZE - 1) / SPATIAL_HASH_BUCKET_SIZE;
+    _buckets.assign(_buckets_x * _buckets_y, std::vector<MapObject*>());
+    _object_ranges.clear();
+}
+
+void SpatialHash::UpdateObject(MapObject* object)
+{
+    if(object)
+        UpdateObject(object, object->GetGridCollisionRectangle());
+}
+
+void SpatialHash::UpdateObject(MapObject* object, const Rectangle2D& area)
+{
+    if(!object || object->GetObjectID() <= 0 || !IsInitialized())
+        return;
+
+    const uint32_t object_id = static_cast<uint32_t>(object->GetObjectID());
+    if(object_id >= _object_ranges.size())
+        _object_ranges.resize(object_id + 1);
+
+    const _BucketRange range = _GetBucketRange(area);
+    _BucketRange& old_range = _object_ranges[object_id];
+    if(range == old_range)
+        return;
+
+    _RemoveFromBuckets(object, old_range);
+    _AddToBuckets(object, range);
+    old_range = range;
+}
+
+void SpatialHash::RemoveObject(MapObject* object)
+{
+    if(!object || object->GetObjectID() <= 0)
+        return;
+
+    const uint32_t object_id = static_cast<uint32_t>(object->GetObjectID());
+    if(object_id >= _object_ranges.size())
+        return;
+
+    _RemoveFromBuckets(object, _object_ranges[object_id]);
+    _object_ranges[object_id] = _BucketRange();
+}
+
+void SpatialHash::FindObjects(const Rectangle2D& area, std::vector<MapObject*>& objects) const
+{
+    objects.clear();
+    if(!IsInitialized())
+        return;
+
+    const _BucketRange range = _GetBucketRange(area);
+    for(int32_t y = range.top; y <= range.bottom; ++y) {
+        for(int32_t x = range.left; x <= range.right; ++x) {
+            const std::vector<MapObject*>& bucket = _buckets[y * _buckets_x + x];
+            for(uint32_t i = 0; i < bucket.size(); ++i) {
+                // An object overlapping several buckets is only reported
+                // from the first of them also overlapped by the area.
+                const _BucketRange& object_range = _object_ranges[bucket[i]->GetObjectID()];
+                if(x == std::max(range.left, object_range.left) && y == std::max(range.top, object_range.top))
+                    objects.push_back(bucket[i]);
+            }
+        }
+    }
+}
+
+SpatialHash::_BucketRange SpatialHash::_GetBucketRange(const Rectangle2D& rect) const
+{
+    // Positions out of the map are clamped to the border buckets, both for the objects
+    // and the searched areas, so that they are still found.
+    const float bucket_size = static_cast<float>(SPATIAL_HASH_BUCKET_SIZE);
+    _BucketRange range;
+    range.left = std::min(std::max(static_cast<int32_t>(std::floor(rect.left / bucket_size)), 0), _buckets_x - 1);
+    range.right = std::min(std::max(static_cast<int32_t>(std::floor(rect.right / bucket_size)), 0), _buckets_x - 1);
+    range.top = std::min(std::max(static_cast<int32_t>(std::floor(rect.top / bucket_size)), 0), _buckets_y - 1);
+    range.bottom = std::min(std::max(static_cast<int32_t>(std::floor(rect.bottom / bucket_size)), 0), _buckets_y - 1);
+    return range;
+}
+
+void SpatialHash::_AddToBuckets(MapObject* object, const _BucketRange& range)
+{
+    for(int32_t y = range.top; y <= range.bottom; ++y) {
+        for(int32_t x = range.left; x <= range.right; ++x)
+            _buckets[y * _buckets_x + x].push_back(object);
+    }
+}
+
+void SpatialHash::_RemoveFromBuckets(MapObject* object, const _BucketRange& range)
+{
+    for(int32_t y = range.top; y <= range.bottom; ++y) {
+        for(int32_t x = range.left; x <= range.right; ++x) {
+            std::vector<MapObject*>& bucket = _buckets[y * _buckets_x + x];
+            std::vector<MapObject*>::iterator it = std::find(bucket.begin(), bucket.end(), object);
+            if(it != bucket.end()) {
+                // The order doesn't matter, so swap with the last one for a constant time removal.
+                *it = bucket.back();
+                bucket.pop_back();
+            }
+        }
+    }
+}
+
+} // namespace private_map
+
+} // namespace vt_map
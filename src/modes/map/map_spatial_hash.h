@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+//            Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+//                         All Rights Reserved
+//
+// This code is licensed under the GNU GPL version 2. It is free software
+// and you may modify it and/or redistribute it under the terms of this license.
+// See https://www.gnu.org/copyleft/gpl.html for details.
+///////////////////////////////////////////////////////////////////////////////
+
+/** ****************************************************************************
+*** \file    map_spatial_hash.h
+*** \author  Yohann Ferreira, yohann ferreira orange fr
+*** \brief   Header file for the spatial hash used to find map objects near a position.
+***
+*** The collision grid is split into square buckets, each listing the objects
+*** whose collision rectangle overlaps it. Finding the objects in an area then
+*** only requires to look at the few buckets it overlaps, rather than at every
+*** object of the map.
+*** ***************************************************************************/
+
+#ifndef __MAP_SPATIAL_HASH_HEADER__
+#define __MAP_SPATIAL_HASH_HEADER__
+
+#include "common/rectangle_2d.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vt_map
+{
+
+namespace private_map
+{
+
+class MapObject;
+
+//! \brief The width and height of the spatial hash buckets, in collision grid elements.
+const uint32_t SPATIAL_HASH_BUCKET_SIZE = 4;
+
+/** ****************************************************************************
+*** \brief A uniform grid of buckets referencing the map objects overlapping them.
+***
+*** Objects are referenced by their id, and must be updated each time their
+*** position or collision size changes. The buckets an object is in are kept,
+*** so that moving within the same buckets is free.
+*** ***************************************************************************/
+class SpatialHash
+{
+public:
+    SpatialHash();
+
+    //! \brief Sizes the buckets to the collision grid, and empties them.
+    void Initialize(uint32_t grid_width, uint32_t grid_height);
+
+    //! \brief Tells whether the buckets are sized, i.e. whether the collision grid is known.
+    bool IsInitialized() const {
+        return !_buckets.empty();
+    }
+
+    //! \brief Moves the object to the buckets its collision rectangle now overlaps.
+    void UpdateObject(MapObject* object);
+
+    //! \brief Moves the object to the buckets the given area now overlaps, instead of its collision rectangle.
+    void UpdateObject(MapObject* object, const vt_common::Rectangle2D& area);
+
+    //! \brief Removes the object from every bucket.
+    void RemoveObject(MapObject* object);
+
+    /** \brief Finds the objects whose buckets overlap an area.
+    *** \param area The area to look into, in collision grid coordinates.
+    *** \param objects Filled with the objects found. Each object is found once,
+    *** but its collision rectangle may still not intersect the area itself.
+    **/
+    void FindObjects(const vt_common::Rectangle2D& area, std::vector<MapObject*>& objects) const;
+
+private:
+    //! \brief The range of buckets overlapped by an object, inclusive. Empty when right < left.
+    class _BucketRange
+    {
+    public:
+        _BucketRange() :
+            left(0),
+            top(0),
+            right(-1),
+            bottom(-1)
+        {}
+
+        bool IsEmpty() const {
+            return right < left || bottom < top;
+        }
+
+        bool operator==(const _BucketRange& other) const {
+            return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+        }
+
+        int32_t left;
+        int32_t top;
+        int32_t right;
+        int32_t bottom;
+    };
+
+    //! \brief The number of buckets on each axis.
+    int32_t _buckets_x;
+    int32_t _buckets_y;
+
+    //! \brief The objects overlapping each bucket: _buckets[y * _buckets_x + x]
+    std::vector<std::vector<MapObject*> > _buckets;
+
+    //! \brief The buckets each object is currently in, indexed by object id.
+    std::vector<_BucketRange> _object_ranges;
+
+    //! \brief Returns the range of buckets a rectangle overlaps, clamped to the grid.
+    _BucketRange _GetBucketRange(const vt_common::Rectangle2D& rect) const;
+
+    //! \brief Adds or removes an object from the buckets of a range.
+    void _AddToBuckets(MapObject* object, const _BucketRange& range);
+    void _RemoveFromBuckets(MapObject* object, const _BucketRange& range);
+};
+
+} // namespace private_map
+
+} // namespace vt_map
+
+#endif // __MAP_SPATIAL_HASH_HEADER__
@@ -132,6 +132,13 @@ void EnemySprite::ChangeStateDead() {
     if(_zone) _zone->EnemyDead();
 }
 
+bool EnemySprite::_IsNearCamera() const
+{
+    VirtualSprite* camera = MapMode::CurrentInstance()->GetCamera();
+    return fabs(GetXPosition() - camera->GetXPosition()) <= SCREEN_GRID_X_LENGTH
+           && fabs(GetYPosition() - camera->GetYPosition()) <= SCREEN_GRID_Y_LENGTH;
+}
+
 void EnemySprite::_HandleHostileUpdate()
 {
     // Holds the x and y deltas between the sprite and map camera coordinate pairs
@@ -145,10 +152,10 @@ void EnemySprite::_HandleHostileUpdate()
     float abs_ydelta = fabs(ydelta);
 
     // Don't update enemies that are too far away...
-    if (abs_xdelta > SCREEN_GRID_X_LENGTH || abs_ydelta > SCREEN_GRID_Y_LENGTH)
+    if (!_IsNearCamera())
         return;
 
-    // Updates sprite animation and collision fix.
+    // Updates sprite animation, its position being updated by the movement phase.
     MapSprite::Update();
 
     // Test whether the monster has spotted its target.
@@ -173,6 +180,14 @@ void EnemySprite::_HandleHostileUpdate()
         if (this->IsCollidingWith(camera))
             map_mode->StartEnemyEncounter(this);
 
+        // Go around the walls in the way, by heading to the next step
+        // of the flow field shared by all the chasing enemies.
+        Position2D next_step;
+        if (map_mode->GetObjectSupervisor()->GetChaseStep(this, camera, next_step)) {
+            xdelta = GetXPosition() - next_step.x;
+            ydelta = GetYPosition() - next_step.y;
+        }
+
         // Make the monster go toward the character
         if(xdelta > -0.5 && xdelta < 0.5 && ydelta < 0)
             SetDirection(SOUTH);
@@ -297,6 +297,14 @@ private:
     //! \brief Handles behavior when the enemy is in hostile state (seeking for characters)
     void _HandleHostileUpdate();
 
+    //! \brief Tells whether the enemy is near enough the camera to be updated.
+    bool _IsNearCamera() const;
+
+    //! \brief Only the hostile enemies near the camera move.
+    virtual bool _IsMoveUpdated() const override {
+        return _state == HOSTILE && _IsNearCamera();
+    }
+
 };
 
 } // namespace private_map
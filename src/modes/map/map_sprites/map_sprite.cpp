@@ -19,8 +19,10 @@
 #include "common/rectangle_2d.h"
 
 #include "script/script_read.h"
+#include "engine/asset_archive.h"
 #include "engine/system.h"
 #include "engine/video/image.h"
+#include "engine/video/texture_controller.h"
 
 #include "utils/utils_files.h"
 #include "utils/utils_numeric.h"
@@ -59,6 +61,10 @@ MapSprite::~MapSprite()
 {
     if (_face_portrait)
         delete _face_portrait;
+
+    // Cancel the decoding of a portrait never shown.
+    if (!_face_portrait_filename.empty())
+        vt_video::TextureManager->CancelPrefetchedImage(_face_portrait_filename);
 }
 
 MapSprite* MapSprite::Create(MapObjectDrawLayer layer)
@@ -90,7 +96,7 @@ bool _LoadAnimations(std::vector<vt_video::AnimatedImage>& animations, const std
     animations_script.OpenTable("sprite_animation");
 
     std::string image_filename = animations_script.ReadString("image_filename");
-    if(!vt_utils::DoesFileExist(image_filename)) {
+    if(!vt_system::DoesAssetExist(image_filename)) {
         PRINT_WARNING << "The image file doesn't exist: " << image_filename << std::endl;
         animations_script.CloseTable();
         animations_script.CloseFile();
@@ -349,15 +355,39 @@ void MapSprite::ReloadSprite(const std::string& sprite_name)
 
 void MapSprite::LoadFacePortrait(const std::string &filename)
 {
-    if(_face_portrait)
+    if(_face_portrait) {
         delete _face_portrait;
+        _face_portrait = 0;
+    }
+
+    if(!_face_portrait_filename.empty() && _face_portrait_filename != filename)
+        vt_video::TextureManager->CancelPrefetchedImage(_face_portrait_filename);
+
+    // Most portraits are only shown in dialogues, if ever, so they are loaded on their first use.
+    _face_portrait_filename = filename;
+    vt_video::TextureManager->PrefetchImage(filename);
+}
+
+void MapSprite::PrepareFacePortrait()
+{
+    if(!_face_portrait_filename.empty() && vt_video::TextureManager->IsImageReady(_face_portrait_filename))
+        GetFacePortrait();
+}
+
+vt_video::StillImage* MapSprite::GetFacePortrait()
+{
+    if(_face_portrait_filename.empty())
+        return _face_portrait;
 
+    // Takes the decoded image, if still requested.
     _face_portrait = new vt_video::StillImage();
-    if(!_face_portrait->Load(filename)) {
+    if(!_face_portrait->Load(_face_portrait_filename)) {
         delete _face_portrait;
         _face_portrait = 0;
-        PRINT_ERROR << "failed to load face portrait" << std::endl;
+        PRINT_ERROR << "failed to load face portrait: " << _face_portrait_filename << std::endl;
     }
+    _face_portrait_filename.clear();
+    return _face_portrait;
 }
 
 void MapSprite::SetGrayscale(bool grayscale) {
@@ -380,10 +410,11 @@ void MapSprite::SetGrayscale(bool grayscale) {
 
 void MapSprite::Update()
 {
-    // Stores the last value of moved_position to determine when a change in sprite movement between calls to this function occurs
-    bool was_moved = _moved_position;
+    // The last value of moved_position, to determine when a change in sprite movement
+    // between movement updates occurs
+    bool was_moved = _was_moved_position;
 
-    // This call will update the sprite's position and perform collision detection
+    // The sprite's position was already updated by the movement phase.
     VirtualSprite::Update();
 
     // if it's a custom animation, just display that and ignore everything else
@@ -506,19 +537,17 @@ void MapSprite::Draw()
     else
         _animation->at(_current_anim_direction).Draw();
 
-    MapObject::_DrawEmote();
-
     if(vt_video::VideoManager->DebugInfoOn())
         _DrawDebugInfo();
 }
 
 void MapSprite::DrawDialogIcon()
 {
-    if(!MapObject::ShouldDraw())
+    // Other map sprite logical conditions preventing the bubble from being displayed
+    if (!ShowsDialogueIcon())
         return;
 
-    // Other map sprite logical conditions preventing the bubble from being displayed
-    if (!_has_available_dialogue || !_has_unseen_dialogue || _dialogue_started)
+    if(!MapObject::ShouldDraw())
         return;
 
     MapMode* map_mode = MapMode::CurrentInstance();
@@ -571,6 +600,15 @@ void MapSprite::InitiateDialogue()
     IncrementNextDialogue();
 }
 
+bool MapSprite::IsReferencingDialogue(const std::string& dialogue_id) const
+{
+    for(uint32_t i = 0; i < _dialogue_references.size(); ++i) {
+        if(_dialogue_references[i] == dialogue_id)
+            return true;
+    }
+    return false;
+}
+
 void MapSprite::UpdateDialogueStatus()
 {
     _has_available_dialogue = false;
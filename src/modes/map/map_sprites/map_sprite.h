@@ -77,8 +77,14 @@ public:
     //! \brief Clear out all the sprite animation. Useful in case of reloading.
     void ClearAnimations();
 
+    /** \brief Sets the face portrait, decoded in the background until first shown.
+    *** \param filename The portrait image file.
+    **/
     void LoadFacePortrait(const std::string& filename);
 
+    //! \brief Loads the face portrait now if its decoding is done, so that its first dialogue line doesn't.
+    void PrepareFacePortrait();
+
     //! \brief Updates the sprite's position and state.
     virtual void Update() override;
 
@@ -167,13 +173,20 @@ public:
         return _has_unseen_dialogue;
     }
 
+    //! \brief Tells whether the dialogue icon is to be drawn over the sprite, when on screen.
+    bool ShowsDialogueIcon() const {
+        return _has_available_dialogue && _has_unseen_dialogue && !_dialogue_started;
+    }
+
+    //! \brief Tells whether the sprite references the given dialogue.
+    bool IsReferencingDialogue(const std::string& dialogue_id) const;
+
     vt_utils::ustring &GetName() {
         return _name;
     }
 
-    vt_video::StillImage *GetFacePortrait() const {
-        return _face_portrait;
-    }
+    //! \brief Returns the face portrait, loading it on the first call, or nullptr if the sprite has none.
+    vt_video::StillImage *GetFacePortrait();
 
     //! \brief Returns the next dialogue to reference (negative value returned if no dialogues are referenced)
     int16_t GetNextDialogue() const {
@@ -242,6 +255,9 @@ protected:
     **/
     vt_video::StillImage *_face_portrait;
 
+    //! \brief The face portrait file, until the portrait is loaded.
+    std::string _face_portrait_filename;
+
     /** Keeps the map sprite reference name permitting, used to know whether a map sprite needs reloading
     *** when the map sprite name has actually changed.
     **/
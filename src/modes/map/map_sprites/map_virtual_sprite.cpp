@@ -36,6 +36,7 @@ VirtualSprite::VirtualSprite(MapObjectDrawLayer layer) :
     _movement_speed(NORMAL_SPEED),
     _moving(false),
     _moved_position(false),
+    _was_moved_position(false),
     _is_running(false),
     _control_event(nullptr),
     _state_saved(false),
@@ -52,121 +53,21 @@ VirtualSprite::~VirtualSprite()
 
 void VirtualSprite::Update()
 {
-    _moved_position = false;
-
     // Update potential emote animation
     MapObject::_UpdateEmote();
-
-    if(!_updatable || !_moving)
-        return;
-
-    _SetNextPosition();
 } // void VirtualSprite::Update()
 
-bool VirtualSprite::_HandleWallEdges(float& next_pos_x,
-                                     float& next_pos_y,
-                                     float distance_moved,
-                                     MapObject* collision_object)
+bool VirtualSprite::StartMove(float& dx, float& dy)
 {
-    // First we don't deal with sprites edges when it's not a physical sprite
-    if (collision_object && collision_object->GetObjectType() != PHYSICAL_TYPE)
+    if(!_IsMoveUpdated())
         return false;
 
-    // Handles soft edges for straight directions
-    // Set a walk-around direction when the straight one is blocking the sprite,
-    // and when the sprite is on the corner of the obstacle.
-    bool on_edge = false;
-    float edge_next_pos_x = 0.0f;
-    float edge_next_pos_y = 0.0f;
-
-    // Cap the actual distance moved when on an edge to a sane value according to the following checks.
-    // Without this cap, the distance moved is too high when running and/or with a high walk
-    // speed and can cause glitches.
-    float edge_distance_moved = distance_moved;
-    if (edge_distance_moved > 0.09f)
-        edge_distance_moved = 0.09f;
-
-    ObjectSupervisor *object_supervisor = MapMode::CurrentInstance()->GetObjectSupervisor();
-
-    if(_direction & NORTH) {
-        // Test both the north-east and north west cases
-        if(!object_supervisor->IsStaticCollision(_tile_position.x + _coll_grid_half_width,
-                                                 _tile_position.y - _coll_grid_height - distance_moved)) {
-            edge_next_pos_x = _tile_position.x + edge_distance_moved;
-            edge_next_pos_y = _tile_position.y;
-            on_edge = true;
-        }
-        else if (!object_supervisor->IsStaticCollision(_tile_position.x - _coll_grid_half_width,
-                                                       _tile_position.y - _coll_grid_height - distance_moved)) {
-            edge_next_pos_x = _tile_position.x - edge_distance_moved;
-            edge_next_pos_y = _tile_position.y;
-            on_edge = true;
-        }
-    }
-    else if(_direction & SOUTH) {
-        // Test both the south-east and south west cases
-        if(!object_supervisor->IsStaticCollision(_tile_position.x + _coll_grid_half_width,
-                                                 _tile_position.y + distance_moved)) {
-            edge_next_pos_x = _tile_position.x + edge_distance_moved;
-            edge_next_pos_y = _tile_position.y;
-            on_edge = true;
-        }
-        else if (!object_supervisor->IsStaticCollision(_tile_position.x - _coll_grid_half_width,
-                                                       _tile_position.y + distance_moved)) {
-            edge_next_pos_x = _tile_position.x - edge_distance_moved;
-            edge_next_pos_y = _tile_position.y;
-            on_edge = true;
-        }
-    }
-    else if(_direction & EAST) {
-        // Test both the north-east and south-east cases
-        if(!object_supervisor->IsStaticCollision(_tile_position.x + _coll_grid_half_width + distance_moved,
-                                                 _tile_position.y - _coll_grid_height)) {
-            edge_next_pos_x = _tile_position.x;
-            edge_next_pos_y = _tile_position.y - edge_distance_moved;
-            on_edge = true;
-        }
-        else if (!object_supervisor->IsStaticCollision(_tile_position.x + _coll_grid_half_width + distance_moved,
-                                                       _tile_position.y)) {
-            edge_next_pos_x = _tile_position.x;
-            edge_next_pos_y = _tile_position.y + edge_distance_moved;
-            on_edge = true;
-        }
-    }
-    else if(_direction & WEST) {
-        // Test both the north-west and south-west cases
-        if(!object_supervisor->IsStaticCollision(_tile_position.x - _coll_grid_half_width - distance_moved,
-                                                 _tile_position.y - _coll_grid_height)) {
-            edge_next_pos_x = _tile_position.x;
-            edge_next_pos_y = _tile_position.y - edge_distance_moved;
-            on_edge = true;
-        }
-        else if (!object_supervisor->IsStaticCollision(_tile_position.x - _coll_grid_half_width - distance_moved,
-                                                       _tile_position.y)) {
-            edge_next_pos_x = _tile_position.x;
-            edge_next_pos_y = _tile_position.y + edge_distance_moved;
-            on_edge = true;
-        }
-    }
-
-    // If no edge is found, we don't do anything.
-    if (!on_edge)
-        return false;
+    _was_moved_position = _moved_position;
+    _moved_position = false;
 
-    // Final check of the new position chosen
-    if (object_supervisor->DetectCollision(this, edge_next_pos_x, edge_next_pos_y, &collision_object) != NO_COLLISION)
+    if(!_updatable || !_moving)
         return false;
 
-    // Set the new position once all the tests passed.
-    next_pos_x = edge_next_pos_x;
-    next_pos_y = edge_next_pos_y;
-
-    return true;
-}
-
-void VirtualSprite::_SetNextPosition()
-{
-
     // Next sprite's position holders
     float next_pos_x = GetXPosition();
     float next_pos_y = GetYPosition();
@@ -182,37 +83,29 @@ void VirtualSprite::_SetNextPosition()
     else if(_direction & (EAST | MOVING_NORTHEAST | MOVING_SOUTHEAST))
         next_pos_x += distance_moved;
 
+    dx = next_pos_x - GetXPosition();
+    dy = next_pos_y - GetYPosition();
+
     // When not moving, do not check anything else.
-    if(next_pos_x == GetXPosition() && next_pos_y == GetYPosition())
-        return;
+    return dx != 0.0f || dy != 0.0f;
+}
 
-    // We've got the next position, let's check whether the next position
-    // should be revised.
+void VirtualSprite::FinishMove(float dx, float dy, const CollisionSweep& sweep)
+{
+    // The destination, unless the sweep revises it.
+    float next_pos_x = GetXPosition() + dx;
+    float next_pos_y = GetYPosition() + dy;
 
     // Used to know whether we could fall back to a straight move
     // in case of collision.
     bool moving_diagonally = (_direction & (MOVING_NORTHWEST | MOVING_NORTHEAST
                                            | MOVING_SOUTHEAST | MOVING_SOUTHWEST));
 
-    // Handle collision with the first object encountered
-    MapObject* collision_object = nullptr;
+    // The sweep is done in one query: A diagonal move slides along the first obstacle hit,
+    // and a straight move gets the step around its corner.
     MapMode* map_mode = MapMode::CurrentInstance();
-    ObjectSupervisor* object_supervisor = map_mode->GetObjectSupervisor();
-    COLLISION_TYPE collision_type = object_supervisor->DetectCollision(this, next_pos_x,
-                     next_pos_y,
-                     &collision_object);
-    // Try to fall back to straight direction
-    if(moving_diagonally && collision_type != NO_COLLISION) {
-        // Try on x axis
-        if(object_supervisor->DetectCollision(this, _tile_position.x, next_pos_y, &collision_object) == NO_COLLISION) {
-            next_pos_x = _tile_position.x;
-            collision_type = NO_COLLISION;
-        } // and then on y axis
-        else if(object_supervisor->DetectCollision(this, next_pos_x, _tile_position.y, &collision_object) == NO_COLLISION) {
-            next_pos_y = _tile_position.y;
-            collision_type = NO_COLLISION;
-        }
-    }
+    COLLISION_TYPE collision_type = sweep.collision_type;
+    MapObject* collision_object = sweep.collision_object;
 
     // Handles special collision handling first
     if(_control_event) {
@@ -234,6 +127,12 @@ void VirtualSprite::_SetNextPosition()
         }
     }
 
+    // Stop against the obstacle hit, or slide along it, unless a prepared path goes through it.
+    if(sweep.collision_type == NO_COLLISION || collision_type != NO_COLLISION) {
+        next_pos_x = sweep.x;
+        next_pos_y = sweep.y;
+    }
+
     // Try to handle wall and physical collisions after a failed straight or diagonal move
     switch(collision_type) {
     case NO_COLLISION:
@@ -242,22 +141,25 @@ void VirtualSprite::_SetNextPosition()
     case WALL_COLLISION:
         // When being blocked and moving diagonally, the npc is stuck.
         if(moving_diagonally)
-            return;
+            break;
 
         // Don't consider physical objects with an event to avoid sliding on their edges,
         // making them harder to "talk with".
         if (collision_object && this == map_mode->GetCamera()) {
             PhysicalObject *phs = reinterpret_cast<PhysicalObject *>(collision_object);
             if(phs && !phs->GetEventIdWhenTalking().empty())
-                return;
+                break;
         }
 
-        // Fix the direction and destination to walk-around obstacles
-        if (_HandleWallEdges(next_pos_x, next_pos_y, distance_moved, collision_object))
+        // Step around the obstacle corner when on its edge
+        if (sweep.on_edge) {
+            next_pos_x = sweep.edge_x;
+            next_pos_y = sweep.edge_y;
             break;
+        }
         // We don't do any other checks for the player sprite.
         else if (this == map_mode->GetCamera())
-            return;
+            break;
 
         // NPC sprites:
 
@@ -268,7 +170,7 @@ void VirtualSprite::_SetNextPosition()
                 _direction |= vt_utils::RandomBoundedInteger(0, 1) ? EAST : WEST;
             else if(_direction & (EAST | WEST))
                 _direction |= vt_utils::RandomBoundedInteger(0, 1) ? NORTH : SOUTH;
-            return;
+            break;
         }
         // Physical and treasure objects are the only other matching "fake" walls
         else {
@@ -280,7 +182,7 @@ void VirtualSprite::_SetNextPosition()
                 _direction |= diff_x >= 0.0f ? EAST : WEST;
             else if(_direction & (EAST | WEST))
                 _direction |= diff_y >= 0.0f ? SOUTH : NORTH;
-            return;
+            break;
         }
         // Other cases shouldn't happen.
         break;
@@ -298,17 +200,12 @@ void VirtualSprite::_SetNextPosition()
 
         break;
     case CHARACTER_COLLISION:
-        // Check whether the sprite is tangled with another character, even without moving
+        // The characters tangled with the sprite, even without moving, were already let through by the sweep.
         // For instance, when colliding with a path follower npc.
-        // And let it through in that case.
-        if(object_supervisor->CheckObjectCollision(GetGridCollisionRectangle(), collision_object)) {
-            collision_type = NO_COLLISION;
-            break;
-        }
 
         // When the sprite is controlled by the camera, let the player handle the position correction.
         if(this == map_mode->GetCamera())
-            return;
+            break;
 
         // Check whether an enemy has collided with the player
         if(this->GetType() == ENEMY_TYPE && collision_object == map_mode->GetCamera()) {
@@ -322,10 +219,10 @@ void VirtualSprite::_SetNextPosition()
 
         // When being blocked and moving diagonally, the npc is stuck.
         if(moving_diagonally)
-            return;
+            break;
 
         if(!collision_object)  // Should never happen
-            return;
+            break;
 
         // Try a diagonal to avoid the sprite in straight direction by comparing
         // each one coords.
@@ -335,9 +232,13 @@ void VirtualSprite::_SetNextPosition()
             _direction |= diff_x >= 0.0f ? EAST : WEST;
         else if(_direction & (EAST | WEST))
             _direction |= diff_y >= 0.0f ? SOUTH : NORTH;
-        return;
+        break;
     }
 
+    // Stopped against the obstacle hit.
+    if(next_pos_x == GetXPosition() && next_pos_y == GetYPosition())
+        return;
+
     // Inform the overlay system of the parallax movement done if needed
     if(this == map_mode->GetCamera()) {
         float x_parallax = !map_mode->IsCameraXAxisInMapCorner() ?
@@ -19,6 +19,7 @@ namespace vt_map
 namespace private_map
 {
 
+class CollisionSweep;
 class SpriteEvent;
 
 /** ****************************************************************************
@@ -43,9 +44,25 @@ public:
     explicit VirtualSprite(MapObjectDrawLayer layer);
     virtual ~VirtualSprite() override;
 
-    //! \brief Updates the virtual object's position if it is moving, otherwise does nothing.
+    /** \brief Updates the virtual object's emote.
+    *** \note Its position is updated beforehand by the movement phase of ObjectSupervisor::Update().
+    **/
     virtual void Update() override;
 
+    /** \brief Starts the movement update of the sprite, and gives the move wanted along its direction.
+    *** \return False when the sprite isn't moving this update.
+    *** \note Called by the movement phase of ObjectSupervisor::Update() before the objects updates.
+    **/
+    bool StartMove(float& dx, float& dy);
+
+    /** \brief Ends the movement update of the sprite, once its move was swept against the obstacles.
+    *** \param dx The move given by StartMove() on the x axis
+    *** \param dy The move given by StartMove() on the y axis
+    *** \param sweep The move swept against the obstacles
+    *** This handles the collisions, and moves the sprite to the position found.
+    **/
+    void FinishMove(float dx, float dy, const CollisionSweep& sweep);
+
     //! \brief Does nothing since virtual sprites have no image to draw
     virtual void Draw() override
     {
@@ -183,6 +200,9 @@ protected:
     **/
     bool _moved_position;
 
+    //! \brief The _moved_position value of the previous movement update.
+    bool _was_moved_position;
+
     //! \brief Set to true when the sprite is running rather than walking
     bool _is_running;
 
@@ -200,17 +220,12 @@ protected:
     bool _saved_moving;
     //@}
 
-    /** \brief Set the next sprite position, according to the current direction set.
-    *** This function aims at finding the next correct position for the given sprite,
-    *** and avoid the most possible to make it stop, except when walking against a wall.
-    **/
-    void _SetNextPosition();
-
-    /** \brief Handles position corrections when the sprite is on the edge of
-    *** physical obstacles. (NPC sprites, treasure, ... aren't considered here for playability purpose)
+    /** \brief Tells whether the movement of the sprite is updated this update.
+    *** Sprites whose update doesn't move them, e.g. enemies far from the camera, override it.
     **/
-    bool _HandleWallEdges(float& next_pos_x, float& next_pos_y, float distance_moved,
-                          MapObject* collision_object);
+    virtual bool _IsMoveUpdated() const {
+        return true;
+    }
 };
 
 } // namespace private_map
@@ -220,9 +220,9 @@ CharacterIndication::CharacterIndication(vt_global::GlobalCharacter* character,
         _display_time(0),
         _global_character(character)
 {
-    // Loads a copy of the portrait.
+    // Copies the portrait, sharing its texture.
     if (character)
-        _portrait.Load(character->GetPortrait().GetFilename());
+        _portrait = character->GetPortrait();
 
     if (!_portrait.GetFilename().empty())
         _portrait.SetHeightKeepRatio(65.0f);
@@ -272,7 +272,8 @@ void CharacterIndication::Draw() {
 // MapStatusEffectsSupervisor class
 ////////////////////////////////////////////////////////////////////////////////
 
-MapStatusEffectsSupervisor::MapStatusEffectsSupervisor()
+MapStatusEffectsSupervisor::MapStatusEffectsSupervisor() :
+    _portraits_shown(false)
 {
     LoadStatusEffects();
 }
@@ -288,6 +289,7 @@ void MapStatusEffectsSupervisor::LoadStatusEffects()
     _active_status_effects.clear();
     _equipment_status_effects.clear();
     _characters_portraits.clear();
+    _portraits_shown = false;
 
     std::vector<GlobalCharacter*>* characters = GlobalManager->GetCharacterHandler().GetOrderedCharacters();
     if (!characters)
@@ -499,13 +501,24 @@ void MapStatusEffectsSupervisor::UpdateEffects()
 
 void MapStatusEffectsSupervisor::UpdatePortraits()
 {
+    // Most of the time, no effect changed lately and there is nothing to do.
+    if (!_portraits_shown)
+        return;
+
     // Update portrait indicators
-    for (uint32_t i = 0; i < _characters_portraits.size(); ++i)
+    _portraits_shown = false;
+    for (uint32_t i = 0; i < _characters_portraits.size(); ++i) {
         _characters_portraits[i].Update();
+        if (_characters_portraits[i].IsShown())
+            _portraits_shown = true;
+    }
 }
 
 void MapStatusEffectsSupervisor::Draw()
 {
+    if (!_portraits_shown)
+        return;
+
     // Draw character portraits shown when effects changes are triggered.
     for (uint32_t i = 0; i < _characters_portraits.size(); ++i)
         _characters_portraits[i].Draw();
@@ -741,6 +754,7 @@ void MapStatusEffectsSupervisor::_MakeCharacterPortraitAppear(vt_global::GlobalC
     for (uint32_t i = 0; i < _characters_portraits.size(); ++i) {
         if (_characters_portraits[i].GetCharacter() == character) {
             _characters_portraits[i].FadeIn(time);
+            _portraits_shown = true;
             return;
         }
     }
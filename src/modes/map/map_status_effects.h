@@ -238,6 +238,11 @@ public:
 
     void Draw();
 
+    //! \brief Tells whether the portrait is displayed or about to be.
+    bool IsShown() const {
+        return _image_alpha > 0.0f || _fade_in || _display_time > 0;
+    }
+
     vt_global::GlobalCharacter* GetCharacter()
     { return _global_character; }
 private:
@@ -342,6 +347,9 @@ private:
     //! to visually link on what character a status effect change happens.
     std::vector<CharacterIndication> _characters_portraits;
 
+    //! \brief Whether one of the portraits is shown, the portraits being neither updated nor drawn otherwise.
+    bool _portraits_shown;
+
     /** \brief Creates a new status effect and applies it to the actor
     *** \param status The type of the status to create
     *** \param intensity The intensity level that the effect should be initialized at
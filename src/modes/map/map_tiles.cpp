@@ -20,6 +20,10 @@
 #include "modes/map/map_mode.h"
 
 #include "engine/video/video.h"
+#include "engine/video/static_image_layer.h"
+
+#include <algorithm>
+#include <limits>
 
 using namespace vt_utils;
 using namespace vt_script;
@@ -43,12 +47,20 @@ static LAYER_TYPE StringToLayerType(const std::string& type)
 
 TileSupervisor::TileSupervisor() :
     _num_tile_on_x_axis(0),
-    _num_tile_on_y_axis(0)
+    _num_tile_on_y_axis(0),
+    _num_chunk_on_x_axis(0),
+    _num_chunk_on_y_axis(0),
+    _streaming(false),
+    _streamed_chunk_x(std::numeric_limits<uint32_t>::max()),
+    _streamed_chunk_y(std::numeric_limits<uint32_t>::max())
 {
 }
 
 TileSupervisor::~TileSupervisor()
 {
+    // The chunks keep references to the tile textures.
+    _ClearChunks();
+
     // Delete all objects in _tile_images but *not* _animated_tile_images.
     // This is because _animated_tile_images is a subset of _tile_images.
     for(uint32_t i = 0; i < _tile_images.size(); i++)
@@ -65,46 +77,10 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
     _num_tile_on_y_axis = map_file.ReadInt("num_tile_rows");
     _num_tile_on_x_axis = map_file.ReadInt("num_tile_cols");
 
-    // Load all of the tileset images that are used by this map
-
     // Contains all of the tileset filenames used (string does not contain path information or file extensions)
     std::vector<std::string> tileset_filenames;
-    // Temporarily retains all tile images loaded for each tileset. Each inner vector contains 256 StillImage objects
-    std::vector<std::vector<StillImage> > tileset_images;
-
     map_file.ReadStringVector("tileset_filenames", tileset_filenames);
 
-    for(uint32_t i = 0; i < tileset_filenames.size(); i++) {
-        std::string tileset_file = tileset_filenames[i];
-
-        ReadScriptDescriptor tileset_script;
-        if (!tileset_script.OpenFile(tileset_file)) {
-            PRINT_ERROR << "Couldn't open the tileset definition file: " << tileset_file << std::endl;
-            return false;
-        }
-
-        if (!tileset_script.OpenTable("tileset")) {
-            PRINT_ERROR << "Couldn't open the 'tileset' table from file: " << tileset_file << std::endl;
-            tileset_script.CloseFile();
-            return false;
-        }
-
-        std::string image_filename = tileset_script.ReadString("image");
-        tileset_script.CloseFile();
-
-        tileset_images.push_back(std::vector<StillImage>(TILES_PER_TILESET));
-
-        // Each tileset image is 512x512 pixels, yielding 16 * 16 (== 256) 32x32 pixel tiles each
-        if(!ImageDescriptor::LoadMultiImageFromElementGrid(tileset_images[i], image_filename, 16, 16)) {
-            PRINT_ERROR << "failed to load tileset image: " << image_filename << std::endl;
-            return false;
-        }
-
-        for(uint32_t j = 0; j < TILES_PER_TILESET; j++) {
-            tileset_images[i][j].SetDimensions(TILE_LENGTH, TILE_LENGTH);
-        }
-    }
-
     if(!map_file.DoesTableExist("layers")) {
         PRINT_ERROR << "No 'layers' table in the map file." << std::endl;
         return false;
@@ -146,8 +122,8 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
 
         _tile_grid[layer_id].layer_type = layer_type;
 
-        // Add the new tile rows (y axis)
-        _tile_grid[layer_id].tiles.resize(_num_tile_on_y_axis);
+        // Add the new tiles, stored row by row
+        _tile_grid[layer_id].tiles.resize(_num_tile_on_x_axis * _num_tile_on_y_axis);
 
         // Read the tile data
         for(uint32_t y = 0; y < _num_tile_on_y_axis; ++y) {
@@ -169,11 +145,9 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
                 return false;
             }
 
-            // Prepare the columns (x axis)
-            _tile_grid[layer_id].tiles[y].resize(_num_tile_on_x_axis);
-
+            int16_t* row = &_tile_grid[layer_id].tiles[y * _num_tile_on_x_axis];
             for(uint32_t x = 0; x < _num_tile_on_x_axis; ++x) {
-                _tile_grid[layer_id].tiles[y][x] = table_x_indeces[x];
+                row[x] = table_x_indeces[x];
             }
         }
         map_file.CloseTable(); // layers[layer_id]
@@ -181,6 +155,90 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
 
     map_file.CloseTable(); // layers
 
+    return _LoadTiles(tileset_filenames);
+}
+
+bool TileSupervisor::Load(const BinaryMapData& map_data)
+{
+    _num_tile_on_y_axis = map_data.GetNumTileRows();
+    _num_tile_on_x_axis = map_data.GetNumTileColumns();
+
+    // Clears out the tiles grid
+    _tile_grid.clear();
+
+    for(uint32_t layer_id = 0; layer_id < map_data.GetNumLayers(); ++layer_id) {
+        _tile_grid.resize(layer_id + 1);
+
+        LAYER_TYPE layer_type = StringToLayerType(map_data.GetLayerType(layer_id));
+        if(layer_type == INVALID_LAYER) {
+            PRINT_WARNING << "Ignoring unexisting layer type: " << map_data.GetLayerType(layer_id)
+                          << " in the baked map data." << std::endl;
+            continue;
+        }
+
+        _tile_grid[layer_id].layer_type = layer_type;
+
+        // The tiles are stored row by row
+        const int16_t* tiles = map_data.GetLayerTiles(layer_id);
+        _tile_grid[layer_id].tiles.assign(tiles, tiles + _num_tile_on_x_axis * _num_tile_on_y_axis);
+    }
+
+    return _LoadTiles(map_data.GetTilesetFilenames());
+}
+
+bool TileSupervisor::_LoadTiles(const std::vector<std::string>& tileset_filenames)
+{
+    // Load all of the tileset images that are used by this map
+
+    // Temporarily retains all tile images loaded for each tileset. Each inner vector contains 256 StillImage objects
+    std::vector<std::vector<StillImage> > tileset_images;
+
+    // Contains the image filename of each tileset
+    std::vector<std::string> image_filenames;
+
+    for(uint32_t i = 0; i < tileset_filenames.size(); i++) {
+        std::string tileset_file = tileset_filenames[i];
+
+        ReadScriptDescriptor tileset_script;
+        if (!tileset_script.OpenFile(tileset_file)) {
+            PRINT_ERROR << "Couldn't open the tileset definition file: " << tileset_file << std::endl;
+            return false;
+        }
+
+        if (!tileset_script.OpenTable("tileset")) {
+            PRINT_ERROR << "Couldn't open the 'tileset' table from file: " << tileset_file << std::endl;
+            tileset_script.CloseFile();
+            return false;
+        }
+
+        image_filenames.push_back(tileset_script.ReadString("image"));
+        tileset_script.CloseFile();
+    }
+
+    // Decode all the tileset images in the background while they are uploaded one by one
+    for(uint32_t i = 0; i < image_filenames.size(); i++)
+        TextureManager->PrefetchImage(image_filenames[i]);
+
+    for(uint32_t i = 0; i < image_filenames.size(); i++) {
+        const std::string& image_filename = image_filenames[i];
+
+        tileset_images.push_back(std::vector<StillImage>(TILES_PER_TILESET));
+
+        // Each tileset image is 512x512 pixels, yielding 16 * 16 (== 256) 32x32 pixel tiles each
+        if(!ImageDescriptor::LoadMultiImageFromElementGrid(tileset_images[i], image_filename, 16, 16)) {
+            PRINT_ERROR << "failed to load tileset image: " << image_filename << std::endl;
+
+            // Don't keep the remaining decoded images around
+            for(uint32_t j = i + 1; j < image_filenames.size(); j++)
+                TextureManager->CancelPrefetchedImage(image_filenames[j]);
+            return false;
+        }
+
+        for(uint32_t j = 0; j < TILES_PER_TILESET; j++) {
+            tileset_images[i][j].SetDimensions(TILE_LENGTH, TILE_LENGTH);
+        }
+    }
+
     // Determine which tiles in each tileset are referenced in this map
 
     // Used to determine whether each tile is used by the map or not. An entry of -1 indicates that particular tile is not used
@@ -189,13 +247,14 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
     tile_references.assign(tileset_filenames.size() * TILES_PER_TILESET, -1);
 
     // For each layer
-    for(uint32_t layer_id = 0; layer_id < layers_number; ++layer_id) {
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        // The layers left empty because of an invalid type have no tiles
+        const std::vector<int16_t, vt_system::MemoryTagAllocator<int16_t, vt_system::MEMORY_MAP> >& tiles = _tile_grid[layer_id].tiles;
+
         // For each tile id
-        for(uint32_t y = 0; y < _num_tile_on_y_axis; ++y) {
-            for(uint32_t x = 0; x < _num_tile_on_x_axis; ++x) {
-                if(_tile_grid[layer_id].tiles[y][x] >= 0)
-                    tile_references[_tile_grid[layer_id].tiles[y][x] ] = 0;
-            }
+        for(uint32_t i = 0; i < tiles.size(); ++i) {
+            if(tiles[i] >= 0)
+                tile_references[tiles[i]] = 0;
         }
     }
 
@@ -217,13 +276,14 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
 
     // Now, go back and re-assign all tile layer indeces with the translated indeces
     // For each layer
-    for(uint32_t layer_id = 0; layer_id < layers_number; ++layer_id) {
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        // The layers left empty because of an invalid type have no tiles
+        std::vector<int16_t, vt_system::MemoryTagAllocator<int16_t, vt_system::MEMORY_MAP> >& tiles = _tile_grid[layer_id].tiles;
+
         // For each tile id
-        for(uint32_t y = 0; y < _num_tile_on_y_axis; ++y) {
-            for(uint32_t x = 0; x < _num_tile_on_x_axis; ++x) {
-                if(_tile_grid[layer_id].tiles[y][x] >= 0)
-                    _tile_grid[layer_id].tiles[y][x] = tile_references[_tile_grid[layer_id].tiles[y][x] ];
-            }
+        for(uint32_t i = 0; i < tiles.size(); ++i) {
+            if(tiles[i] >= 0)
+                tiles[i] = tile_references[tiles[i]];
         }
     }
 
@@ -267,6 +327,7 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
 
                 AnimatedImage *new_animation = new AnimatedImage();
                 new_animation->SetDimensions(TILE_LENGTH, TILE_LENGTH);
+                new_animation->SetClock(&MapMode::CurrentInstance()->GetAnimationClock());
 
                 // Each pair of entries in the animation info indicate the tile frame index (k) and the time (k+1)
                 for(uint32_t k = 0; k < animation_info.size(); k += 2) {
@@ -310,52 +371,390 @@ bool TileSupervisor::Load(ReadScriptDescriptor &map_file)
     // Remove all tileset images. Any tiles which were not added to _tile_images will no longer exist in memory
     tileset_images.clear();
 
+    _BuildChunks();
+
     return true;
 }
 
-void TileSupervisor::Update()
+void TileSupervisor::_UpdateAnimatedTiles(std::vector<AnimatedTile>& animated_tiles)
 {
-    for(uint32_t i = 0; i < _animated_tile_images.size(); i++) {
-        _animated_tile_images[i]->Update();
+    // Only update the texture coordinates of the tiles whose frame changed.
+    for(uint32_t i = 0; i < animated_tiles.size(); ++i) {
+        AnimatedTile &tile = animated_tiles[i];
+        uint32_t frame_index = tile.animation->GetCurrentFrameIndex();
+        if(frame_index == tile.frame_index)
+            continue;
+
+        tile.chunk->SetImage(tile.index, *tile.animation->GetCurrentFrame());
+        tile.frame_index = frame_index;
+    }
+}
+
+void TileSupervisor::_BuildChunks()
+{
+    _ClearChunks();
+
+    _num_chunk_on_x_axis = (_num_tile_on_x_axis + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+    _num_chunk_on_y_axis = (_num_tile_on_y_axis + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH;
+
+    // Find the animation of each animated tile image.
+    _tile_animations.clear();
+    for(uint32_t i = 0; i < _animated_tile_images.size(); ++i)
+        _tile_animations[_animated_tile_images[i]] = _animated_tile_images[i];
+
+    // Find the tiles hiding what's under them, through all their frames for the animated ones,
+    // and the animated tiles whose frames can't be swapped, as they lie in different texture sheets.
+    std::vector<bool> opaque_tiles(_tile_images.size(), false);
+    _unbaked_tile_images.assign(_tile_images.size(), false);
+    for(uint32_t i = 0; i < _tile_images.size(); ++i) {
+        std::map<const ImageDescriptor *, AnimatedImage *>::const_iterator it = _tile_animations.find(_tile_images[i]);
+        if(it == _tile_animations.end()) {
+            opaque_tiles[i] = static_cast<StillImage *>(_tile_images[i])->IsOpaque();
+            continue;
+        }
+
+        AnimatedImage *animation = it->second;
+        bool opaque = animation->GetNumFrames() > 0;
+        bool same_sheet = true;
+        for(uint32_t j = 0; j < animation->GetNumFrames(); ++j) {
+            opaque = opaque && animation->GetFrame(j)->IsOpaque();
+            if(j > 0)
+                same_sheet = same_sheet && StaticImageLayer::ShareTextureSheet(*animation->GetFrame(0), *animation->GetFrame(j));
+        }
+        opaque_tiles[i] = opaque;
+        _unbaked_tile_images[i] = !same_sheet;
+    }
+
+    // The layers are drawn by type, the ground ones first, whatever the objects drawn in between.
+    _layer_draw_order.assign(_tile_grid.size(), 0);
+    uint32_t draw_order = 0;
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        if(_tile_grid[layer_id].layer_type == GROUND_LAYER)
+            _layer_draw_order[layer_id] = draw_order++;
+    }
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        if(_tile_grid[layer_id].layer_type != GROUND_LAYER)
+            _layer_draw_order[layer_id] = draw_order++;
+    }
+
+    // The draw order of the last opaque tile of each cell: The tiles drawn before it are hidden.
+    const uint32_t num_cells = _num_tile_on_x_axis * _num_tile_on_y_axis;
+    _first_visible_tiles.assign(num_cells, 0);
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        const Layer &layer = _tile_grid[layer_id];
+        if(layer.tiles.size() != num_cells)
+            continue;
+
+        for(uint32_t i = 0; i < num_cells; ++i) {
+            int16_t tile_id = layer.tiles[i];
+            if(tile_id >= 0 && opaque_tiles[tile_id])
+                _first_visible_tiles[i] = std::max(_first_visible_tiles[i], _layer_draw_order[layer_id]);
+        }
+    }
+    uint32_t hidden_tiles = 0;
+
+    // Find the chunks with tiles to bake, and the tiles drawn one by one.
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        Layer &layer = _tile_grid[layer_id];
+        layer.chunks.assign(_num_chunk_on_x_axis * _num_chunk_on_y_axis, nullptr);
+        layer.chunks_with_tiles.assign(layer.chunks.size(), false);
+        layer.animated_tiles.assign(layer.chunks.size(), std::vector<AnimatedTile>());
+        layer.chunk_x_start = _num_chunk_on_x_axis;
+        layer.chunk_x_end = 0;
+        layer.chunk_y_start = _num_chunk_on_y_axis;
+        layer.chunk_y_end = 0;
+
+        if(layer.tiles.size() != num_cells) {
+            layer.chunk_x_start = 0;
+            layer.chunk_y_start = 0;
+            continue;
+        }
+
+        for(uint32_t y = 0; y < _num_tile_on_y_axis; ++y) {
+            const int16_t* row = &layer.tiles[y * _num_tile_on_x_axis];
+            for(uint32_t x = 0; x < _num_tile_on_x_axis; ++x) {
+                int16_t tile_id = row[x];
+                if(tile_id < 0)
+                    continue;
+
+                // Skip the tiles hidden by an opaque one drawn over them.
+                if(_layer_draw_order[layer_id] < _first_visible_tiles[y * _num_tile_on_x_axis + x]) {
+                    ++hidden_tiles;
+                    continue;
+                }
+
+                if(_unbaked_tile_images[tile_id]) {
+                    layer.unbaked_tiles.push_back(std::make_pair(static_cast<uint16_t>(x), static_cast<uint16_t>(y)));
+                    continue;
+                }
+
+                uint32_t chunk_x = x / TILE_CHUNK_LENGTH;
+                uint32_t chunk_y = y / TILE_CHUNK_LENGTH;
+                layer.chunks_with_tiles[chunk_y * _num_chunk_on_x_axis + chunk_x] = true;
+                layer.chunk_x_start = std::min(layer.chunk_x_start, chunk_x);
+                layer.chunk_x_end = std::max(layer.chunk_x_end, chunk_x + 1);
+                layer.chunk_y_start = std::min(layer.chunk_y_start, chunk_y);
+                layer.chunk_y_end = std::max(layer.chunk_y_end, chunk_y + 1);
+            }
+        }
+
+        // Keep an empty range for the layers without tiles.
+        if(layer.chunk_x_end == 0) {
+            layer.chunk_x_start = 0;
+            layer.chunk_y_start = 0;
+        }
+
+        // When streaming, the chunks are built once near the screen.
+        if(_streaming)
+            continue;
+
+        for(uint32_t i = 0; i < layer.chunks.size(); ++i) {
+            if(layer.chunks_with_tiles[i])
+                _BuildChunk(layer_id, i);
+        }
+    }
+
+    IF_PRINT_DEBUG(MAP_DEBUG) << "Skipped " << hidden_tiles << " tiles hidden by opaque tiles" << std::endl;
+
+    // The build data is only needed later on to stream the chunks.
+    if(!_streaming) {
+        _tile_animations.clear();
+        _unbaked_tile_images.clear();
+        _layer_draw_order.clear();
+        std::vector<uint32_t>().swap(_first_visible_tiles);
+    }
+}
+
+void TileSupervisor::_BuildChunk(uint32_t layer_id, uint32_t chunk_index)
+{
+    Layer &layer = _tile_grid[layer_id];
+    const uint32_t chunk_x = chunk_index % _num_chunk_on_x_axis;
+    const uint32_t chunk_y = chunk_index / _num_chunk_on_x_axis;
+    const uint32_t x_end = std::min<uint32_t>((chunk_x + 1) * TILE_CHUNK_LENGTH, _num_tile_on_x_axis);
+    const uint32_t y_end = std::min<uint32_t>((chunk_y + 1) * TILE_CHUNK_LENGTH, _num_tile_on_y_axis);
+
+    StaticImageLayer *chunk = new StaticImageLayer();
+    std::vector<AnimatedTile> &animated_tiles = layer.animated_tiles[chunk_index];
+    animated_tiles.clear();
+
+    for(uint32_t y = chunk_y * TILE_CHUNK_LENGTH; y < y_end; ++y) {
+        const int16_t* row = &layer.tiles[y * _num_tile_on_x_axis];
+        for(uint32_t x = chunk_x * TILE_CHUNK_LENGTH; x < x_end; ++x) {
+            int16_t tile_id = row[x];
+            if(tile_id < 0 || _unbaked_tile_images[tile_id])
+                continue;
+            if(_layer_draw_order[layer_id] < _first_visible_tiles[y * _num_tile_on_x_axis + x])
+                continue;
+
+            // The tile position within its chunk.
+            float tile_x = static_cast<float>((x - chunk_x * TILE_CHUNK_LENGTH) * TILE_LENGTH);
+            float tile_y = static_cast<float>((y - chunk_y * TILE_CHUNK_LENGTH) * TILE_LENGTH);
+
+            ImageDescriptor *image = _tile_images[tile_id];
+            std::map<const ImageDescriptor *, AnimatedImage *>::const_iterator it = _tile_animations.find(image);
+
+            if(it == _tile_animations.end()) {
+                chunk->AddImage(*static_cast<StillImage *>(image), tile_x, tile_y);
+                continue;
+            }
+
+            AnimatedImage *animation = it->second;
+            if(animation->GetNumFrames() == 0)
+                continue;
+
+            AnimatedTile animated_tile;
+            int32_t index = chunk->AddImage(*animation->GetCurrentFrame(), tile_x, tile_y);
+            if(index < 0)
+                continue;
+
+            animated_tile.chunk = chunk;
+            animated_tile.index = static_cast<uint32_t>(index);
+            animated_tile.animation = animation;
+            animated_tile.frame_index = animation->GetCurrentFrameIndex();
+            animated_tiles.push_back(animated_tile);
+        }
+    }
+
+    // Upload the chunk geometry.
+    chunk->Finalize();
+    layer.chunks[chunk_index] = chunk;
+}
+
+void TileSupervisor::_ReleaseChunk(Layer &layer, uint32_t chunk_index)
+{
+    delete layer.chunks[chunk_index];
+    layer.chunks[chunk_index] = nullptr;
+    std::vector<AnimatedTile>().swap(layer.animated_tiles[chunk_index]);
+}
+
+void TileSupervisor::_ClearChunks()
+{
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        Layer &layer = _tile_grid[layer_id];
+        for(uint32_t i = 0; i < layer.chunks.size(); ++i)
+            delete layer.chunks[i];
+        layer.chunks.clear();
+        layer.chunks_with_tiles.clear();
+        layer.chunk_x_start = 0;
+        layer.chunk_x_end = 0;
+        layer.chunk_y_start = 0;
+        layer.chunk_y_end = 0;
+        layer.unbaked_tiles.clear();
+        layer.animated_tiles.clear();
+    }
+    _streamed_chunk_x = std::numeric_limits<uint32_t>::max();
+    _streamed_chunk_y = std::numeric_limits<uint32_t>::max();
+}
+
+void TileSupervisor::_GetFrameChunks(const MapFrame *frame, uint32_t &x_start, uint32_t &x_end,
+                                     uint32_t &y_start, uint32_t &y_end) const
+{
+    const uint32_t tile_x_end = static_cast<uint32_t>(frame->tile_x_start + frame->num_draw_x_axis);
+    const uint32_t tile_y_end = static_cast<uint32_t>(frame->tile_y_start + frame->num_draw_y_axis);
+
+    x_start = static_cast<uint32_t>(frame->tile_x_start) / TILE_CHUNK_LENGTH;
+    y_start = static_cast<uint32_t>(frame->tile_y_start) / TILE_CHUNK_LENGTH;
+    x_end = std::min<uint32_t>((tile_x_end + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH, _num_chunk_on_x_axis);
+    y_end = std::min<uint32_t>((tile_y_end + TILE_CHUNK_LENGTH - 1) / TILE_CHUNK_LENGTH, _num_chunk_on_y_axis);
+}
+
+void TileSupervisor::StreamChunks(const MapFrame *frame)
+{
+    if(!_streaming)
+        return;
+
+    uint32_t x_start, x_end, y_start, y_end;
+    _GetFrameChunks(frame, x_start, x_end, y_start, y_end);
+
+    // The chunks within the stream margin, built ahead of the camera.
+    const uint32_t stream_x_start = x_start > TILE_CHUNK_STREAM_MARGIN ? x_start - TILE_CHUNK_STREAM_MARGIN : 0;
+    const uint32_t stream_y_start = y_start > TILE_CHUNK_STREAM_MARGIN ? y_start - TILE_CHUNK_STREAM_MARGIN : 0;
+    const uint32_t stream_x_end = std::min<uint32_t>(x_end + TILE_CHUNK_STREAM_MARGIN, _num_chunk_on_x_axis);
+    const uint32_t stream_y_end = std::min<uint32_t>(y_end + TILE_CHUNK_STREAM_MARGIN, _num_chunk_on_y_axis);
+
+    uint32_t streamed_chunks = 0;
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        Layer &layer = _tile_grid[layer_id];
+        if(layer.chunks.empty())
+            continue;
+
+        const uint32_t layer_x_start = std::max(stream_x_start, layer.chunk_x_start);
+        const uint32_t layer_x_end = std::min(stream_x_end, layer.chunk_x_end);
+        const uint32_t layer_y_start = std::max(stream_y_start, layer.chunk_y_start);
+        const uint32_t layer_y_end = std::min(stream_y_end, layer.chunk_y_end);
+
+        for(uint32_t y = layer_y_start; y < layer_y_end; ++y) {
+            for(uint32_t x = layer_x_start; x < layer_x_end; ++x) {
+                const uint32_t chunk_index = y * _num_chunk_on_x_axis + x;
+                if(layer.chunks[chunk_index] || !layer.chunks_with_tiles[chunk_index])
+                    continue;
+
+                // The visible chunks can't wait.
+                const bool visible = x >= x_start && x < x_end && y >= y_start && y < y_end;
+                if(!visible && streamed_chunks >= TILE_CHUNKS_STREAMED_PER_FRAME)
+                    continue;
+
+                _BuildChunk(layer_id, chunk_index);
+                if(!visible)
+                    ++streamed_chunks;
+            }
+        }
+    }
+
+    // The far chunks only need to be looked at once the camera went onto other chunks.
+    if(x_start == _streamed_chunk_x && y_start == _streamed_chunk_y)
+        return;
+    _streamed_chunk_x = x_start;
+    _streamed_chunk_y = y_start;
+
+    const uint32_t release_x_start = x_start > TILE_CHUNK_RELEASE_MARGIN ? x_start - TILE_CHUNK_RELEASE_MARGIN : 0;
+    const uint32_t release_y_start = y_start > TILE_CHUNK_RELEASE_MARGIN ? y_start - TILE_CHUNK_RELEASE_MARGIN : 0;
+    const uint32_t release_x_end = x_end + TILE_CHUNK_RELEASE_MARGIN;
+    const uint32_t release_y_end = y_end + TILE_CHUNK_RELEASE_MARGIN;
+
+    for(uint32_t layer_id = 0; layer_id < _tile_grid.size(); ++layer_id) {
+        Layer &layer = _tile_grid[layer_id];
+        for(uint32_t y = layer.chunk_y_start; y < layer.chunk_y_end; ++y) {
+            for(uint32_t x = layer.chunk_x_start; x < layer.chunk_x_end; ++x) {
+                const uint32_t chunk_index = y * _num_chunk_on_x_axis + x;
+                if(!layer.chunks[chunk_index])
+                    continue;
+                if(x < release_x_start || x >= release_x_end || y < release_y_start || y >= release_y_end)
+                    _ReleaseChunk(layer, chunk_index);
+            }
+        }
     }
 }
 
 void TileSupervisor::DrawLayers(const MapFrame *frame, const LAYER_TYPE &layer_type)
 {
     // We'll use the top-left positions to render the tiles.
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_LEFT, VIDEO_Y_TOP, 0);
+    static const DrawFlags tile_flags(VIDEO_BLEND, VIDEO_X_LEFT, VIDEO_Y_TOP);
+    const DrawState previous_draw_state = VideoManager->GetDrawState();
+    VideoManager->SetDrawFlags(tile_flags);
 
     // Map frame ends
     uint32_t y_end = static_cast<uint32_t>(frame->tile_y_start + frame->num_draw_y_axis);
     uint32_t x_end = static_cast<uint32_t>(frame->tile_x_start + frame->num_draw_x_axis);
 
+    // The chunks intersecting the frame.
+    uint32_t chunk_x_start, chunk_x_end, chunk_y_start, chunk_y_end;
+    _GetFrameChunks(frame, chunk_x_start, chunk_x_end, chunk_y_start, chunk_y_end);
+
+    // We substract 0.5 horizontally and 1.0 vertically here
+    // because the video engine will display the map tiles using their
+    // top left coordinates to avoid a position computation flaw when specifying the tile
+    // coordinates from the bottom center point, as the engine does for everything else.
+    // The origin is the top left corner of the map.
+    float x_origin = GRID_LENGTH * (frame->tile_offset.x - 1.0f) - frame->tile_x_start * TILE_LENGTH;
+    float y_origin = GRID_LENGTH * (frame->tile_offset.y - 2.0f) - frame->tile_y_start * TILE_LENGTH;
+    const float chunk_length = static_cast<float>(TILE_CHUNK_LENGTH * TILE_LENGTH);
+
     uint32_t layer_number = _tile_grid.size();
     for(uint32_t layer_id = 0; layer_id < layer_number; ++layer_id) {
 
-        const Layer &layer = _tile_grid.at(layer_id);
-        if(layer.layer_type != layer_type)
+        Layer &layer = _tile_grid.at(layer_id);
+        if(layer.layer_type != layer_type || layer.chunks.empty())
             continue;
 
-        // We substract 0.5 horizontally and 1.0 vertically here
-        // because the video engine will display the map tiles using their
-        // top left coordinates to avoid a position computation flaw when specifying the tile
-        // coordinates from the bottom center point, as the engine does for everything else.
-        VideoManager->Move(GRID_LENGTH * (frame->tile_offset.x - 1.0f),
-                           GRID_LENGTH * (frame->tile_offset.y - 2.0f));
-        for(uint32_t y = static_cast<uint32_t>(frame->tile_y_start); y < y_end; ++y) {
-            for(uint32_t x = static_cast<uint32_t>(frame->tile_x_start); x < x_end; ++x) {
-                // Draw a tile image if it exists at this location
-                if(layer.tiles[y][x] >= 0)
-                    _tile_images[ layer.tiles[y][x] ]->Draw();
-
-                VideoManager->MoveRelative(TILE_LENGTH, 0.0f);
+        // Only look at the visible part of the layer area having tiles.
+        const uint32_t layer_x_start = std::max(chunk_x_start, layer.chunk_x_start);
+        const uint32_t layer_x_end = std::min(chunk_x_end, layer.chunk_x_end);
+        const uint32_t layer_y_start = std::max(chunk_y_start, layer.chunk_y_start);
+        const uint32_t layer_y_end = std::min(chunk_y_end, layer.chunk_y_end);
+
+        for(uint32_t y = layer_y_start; y < layer_y_end; ++y) {
+            for(uint32_t x = layer_x_start; x < layer_x_end; ++x) {
+                const uint32_t chunk_index = y * _num_chunk_on_x_axis + x;
+                // When streaming, a map drawn before being updated builds its visible chunks here.
+                if(!layer.chunks[chunk_index] && _streaming && layer.chunks_with_tiles[chunk_index])
+                    _BuildChunk(layer_id, chunk_index);
+                const StaticImageLayer *chunk = layer.chunks[chunk_index];
+                if(!chunk)
+                    continue;
+
+                // The animated tiles off-screen are left as they are.
+                _UpdateAnimatedTiles(layer.animated_tiles[chunk_index]);
+
+                VideoManager->Move(x_origin + x * chunk_length, y_origin + y * chunk_length);
+                chunk->Draw();
             } // x
-            VideoManager->MoveRelative(-static_cast<float>(frame->num_draw_x_axis) * TILE_LENGTH, TILE_LENGTH);
         } // y
+
+        for(uint32_t i = 0; i < layer.unbaked_tiles.size(); ++i) {
+            uint32_t x = layer.unbaked_tiles[i].first;
+            uint32_t y = layer.unbaked_tiles[i].second;
+            if(x < static_cast<uint32_t>(frame->tile_x_start) || x >= x_end ||
+                    y < static_cast<uint32_t>(frame->tile_y_start) || y >= y_end)
+                continue;
+
+            VideoManager->Move(x_origin + x * TILE_LENGTH, y_origin + y * TILE_LENGTH);
+            _tile_images[ layer.tiles[y * _num_tile_on_x_axis + x] ]->Draw();
+        }
     } // layer_id
 
     // Restore the previous draw flags.
-    VideoManager->SetDrawFlags(VIDEO_BLEND, VIDEO_X_CENTER, VIDEO_Y_BOTTOM, 0);
+    VideoManager->SetDrawState(previous_draw_state);
 }
 
 } // namespace private_map
@@ -21,13 +21,17 @@
 #ifndef __MAP_TILES_HEADER__
 #define __MAP_TILES_HEADER__
 
+#include "modes/map/map_binary_data.h"
 #include "modes/map/map_utils.h"
 
 #include "script/script_read.h"
 
+#include <map>
+
 namespace vt_video {
 class ImageDescriptor;
 class AnimatedImage;
+class StaticImageLayer;
 }
 
 namespace vt_map
@@ -45,15 +49,87 @@ enum LAYER_TYPE {
     INVALID_LAYER = 2
 };
 
+//! \brief The number of tile rows and columns baked together in video memory.
+const uint16_t TILE_CHUNK_LENGTH = 16;
+
+/** \name Tile Chunks Streaming
+*** When streaming, the chunks are only built near the screen:
+*** The visible ones are built at once, and those within the stream margin a few per frame.
+*** The chunks farther than the release margin are released.
+*** The margins are in chunks around the visible ones.
+**/
+//@{
+const uint32_t TILE_CHUNK_STREAM_MARGIN = 1;
+const uint32_t TILE_CHUNK_RELEASE_MARGIN = 3;
+const uint32_t TILE_CHUNKS_STREAMED_PER_FRAME = 2;
+//@}
+
+//! \brief An animated tile baked in a layer chunk.
+class AnimatedTile
+{
+public:
+    //! \brief The chunk containing the tile.
+    vt_video::StaticImageLayer *chunk;
+
+    //! \brief The tile index in the chunk.
+    uint32_t index;
+
+    //! \brief The tile animation, and the frame currently baked in the chunk.
+    vt_video::AnimatedImage *animation;
+    uint32_t frame_index;
+
+    AnimatedTile():
+        chunk(nullptr),
+        index(0),
+        animation(nullptr),
+        frame_index(0)
+    {}
+};
+
 class Layer
 {
 public:
     LAYER_TYPE layer_type;
-    // Represents the tile indeces: i.e: tiles[y][x] = tile_id at (x,y)
-    std::vector< std::vector<int16_t> > tiles;
+
+    /** \brief The tile indeces, row by row: tiles[y * map columns + x] = tile_id at (x,y), or -1 for none.
+    *** Left empty for the layers of an invalid type.
+    **/
+    std::vector<int16_t, vt_system::MemoryTagAllocator<int16_t, vt_system::MEMORY_MAP> > tiles;
+
+    /** \brief The layer tiles geometry, by chunks of TILE_CHUNK_LENGTH x TILE_CHUNK_LENGTH tiles.
+    *** chunks[y * chunk_columns + x] = chunk at (x,y), or nullptr when the chunk has no tiles.
+    *** The chunks are owned by the TileSupervisor.
+    **/
+    std::vector<vt_video::StaticImageLayer *> chunks;
+
+    //! \brief Tells which chunks have tiles to bake, by chunk index, whether they are built or not.
+    std::vector<bool> chunks_with_tiles;
+
+    /** \brief The chunks with tiles all lie within [chunk_x_start, chunk_x_end[ x [chunk_y_start, chunk_y_end[.
+    *** The range is empty for layers without tiles, so that the upper layers, often mostly empty,
+    *** only have their own area looked at when drawn.
+    **/
+    uint32_t chunk_x_start;
+    uint32_t chunk_x_end;
+    uint32_t chunk_y_start;
+    uint32_t chunk_y_end;
+
+    /** \brief The tiles which couldn't be baked in the chunks, and are drawn one by one.
+    *** This happens for animated tiles whose frames lie in different texture sheets.
+    **/
+    std::vector<std::pair<uint16_t, uint16_t> > unbaked_tiles;
+
+    /** \brief The animated tiles baked in each chunk, by chunk index.
+    *** Their frames are only updated when their chunk is drawn.
+    **/
+    std::vector<std::vector<AnimatedTile> > animated_tiles;
 
     Layer():
-        layer_type(GROUND_LAYER)
+        layer_type(GROUND_LAYER),
+        chunk_x_start(0),
+        chunk_x_end(0),
+        chunk_y_start(0),
+        chunk_y_end(0)
     {}
 };
 
@@ -82,12 +158,27 @@ public:
     **/
     bool Load(vt_script::ReadScriptDescriptor &map_file);
 
-    //! \brief Updates all animated tile images
-    void Update();
+    //! \brief Loads the tile layers and tilesets from a baked map data file.
+    bool Load(const BinaryMapData& map_data);
+
+    /** \brief Only builds the layer chunks near the screen, for the very large maps.
+    *** \note To be set before loading the map.
+    **/
+    void SetStreaming(bool streaming) {
+        _streaming = streaming;
+    }
+
+    /** \brief Builds the chunks coming near the screen, and releases the ones gone far from it.
+    *** Does nothing unless streaming. To be called each frame, once the map frame is updated.
+    **/
+    void StreamChunks(const MapFrame *frame);
 
     /** \brief Draws the various tile layers to the screen
     *** \param frame A pointer to the computed information required to draw this frame
     ***
+    *** Only the layer chunks intersecting the frame are drawn, using one draw call
+    *** per chunk and texture sheet.
+    ***
     *** \note This function does not reset the coordinate system and hence require
     *** that the proper coordinate system is already set prior to these function
     *** calls (0.0f, SCREEN_COLS, SCREEN_ROWS, 0.0f). These functions do make
@@ -100,6 +191,32 @@ public:
     //@}
 
 private:
+    /** \brief Loads the tileset images and animations, once the tile layers are read.
+    *** \param tileset_filenames The tileset definition files used by the map layers.
+    **/
+    bool _LoadTiles(const std::vector<std::string>& tileset_filenames);
+
+    /** \brief Bakes the tile layers into chunks kept in video memory.
+    *** \note Called once all the tile images are loaded.
+    **/
+    void _BuildChunks();
+
+    //! \brief Bakes the tiles of a layer chunk into video memory.
+    void _BuildChunk(uint32_t layer_id, uint32_t chunk_index);
+
+    //! \brief Deletes a layer chunk, built again once needed when streaming.
+    void _ReleaseChunk(Layer &layer, uint32_t chunk_index);
+
+    //! \brief Deletes the layers chunks.
+    void _ClearChunks();
+
+    //! \brief Gets the chunks intersecting the frame, in [x_start, x_end[ x [y_start, y_end[.
+    void _GetFrameChunks(const MapFrame *frame, uint32_t &x_start, uint32_t &x_end,
+                         uint32_t &y_start, uint32_t &y_end) const;
+
+    //! \brief Updates the frames of the animated tiles baked in a chunk about to be drawn.
+    void _UpdateAnimatedTiles(std::vector<AnimatedTile>& animated_tiles);
+
     /** \brief The number of columns of tiles in the map.
     *** This number must be greater than or equal to 32 for the map to be valid.
     **/
@@ -117,10 +234,37 @@ private:
     std::vector<vt_video::ImageDescriptor *> _tile_images;
 
     /** \brief Contains all of the animated tile images used on the map.
-    *** The purpose of this vector is to easily update all tile animations without stepping through the
-    *** _tile_images vector, which contains both still and animated images.
+    *** They follow the map animation clock, and are thus never updated.
     **/
     std::vector<vt_video::AnimatedImage *> _animated_tile_images;
+
+    //! \brief The number of chunk columns and rows covering the map.
+    uint16_t _num_chunk_on_x_axis;
+    uint16_t _num_chunk_on_y_axis;
+
+    //! \brief Whether the chunks are only built near the screen.
+    bool _streaming;
+
+    /** \name Chunks Build Data
+    *** Computed once for all the layers, and kept while streaming to build the chunks later.
+    **/
+    //@{
+    //! \brief The animation of each animated tile image.
+    std::map<const vt_video::ImageDescriptor *, vt_video::AnimatedImage *> _tile_animations;
+
+    //! \brief The tiles which can't be baked, drawn one by one instead, by tile id.
+    std::vector<bool> _unbaked_tile_images;
+
+    //! \brief The draw order of each layer, the ground ones first.
+    std::vector<uint32_t> _layer_draw_order;
+
+    //! \brief The draw order of the last opaque tile of each cell: The tiles drawn before it are hidden.
+    std::vector<uint32_t> _first_visible_tiles;
+    //@}
+
+    //! \brief The first visible chunk when the far chunks were last released, when streaming.
+    uint32_t _streamed_chunk_x;
+    uint32_t _streamed_chunk_y;
 }; // class TileSupervisor
 
 } // namespace private_map
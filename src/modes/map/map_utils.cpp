@@ -15,6 +15,8 @@
 
 #include "map_utils.h"
 
+#include "modes/map/map_mode.h"
+
 #include "utils/utils_common.h"
 
 namespace vt_map
@@ -31,6 +33,31 @@ void ScaleToMapZoomRatio(vt_video::ImageDescriptor& img)
                       img.GetHeight() * vt_map::private_map::MAP_ZOOM_RATIO);
 }
 
+void* AllocateMapMemory(size_t size)
+{
+    MapMode* map_mode = MapMode::CurrentInstance();
+    vt_mode_manager::MemoryArena* arena = map_mode ? &map_mode->GetMemoryArena() : nullptr;
+
+    // The memory starts with its arena, as the current map may have changed once it is freed.
+    size += vt_mode_manager::ARENA_ALIGNMENT;
+    char* memory = static_cast<char *>(arena ? arena->Allocate(size) : ::operator new(size));
+    *reinterpret_cast<vt_mode_manager::MemoryArena **>(memory) = arena;
+    return memory + vt_mode_manager::ARENA_ALIGNMENT;
+}
+
+void FreeMapMemory(void* pointer, size_t size)
+{
+    if(!pointer)
+        return;
+
+    char* memory = static_cast<char *>(pointer) - vt_mode_manager::ARENA_ALIGNMENT;
+    vt_mode_manager::MemoryArena* arena = *reinterpret_cast<vt_mode_manager::MemoryArena **>(memory);
+    if(arena)
+        arena->Deallocate(memory, size + vt_mode_manager::ARENA_ALIGNMENT);
+    else
+        ::operator delete(memory);
+}
+
 uint16_t GetOppositeDirection(const uint16_t direction)
 {
     switch(direction) {
@@ -24,6 +24,7 @@
 #include "engine/video/image.h"
 #include "engine/video/video_utils.h"
 
+#include <string>
 #include <vector>
 
 namespace vt_map
@@ -62,6 +63,10 @@ const uint16_t HALF_TILES_ON_Y_AXIS = TILES_ON_Y_AXIS / 2;
 const uint16_t GRID_LENGTH = vt_video::VIDEO_STANDARD_RES_WIDTH / SCREEN_GRID_X_LENGTH;
 // Length of a tile in pixels
 const uint16_t TILE_LENGTH = GRID_LENGTH * 2;
+
+//! \brief The distance from the screen edges, in grid elements, within which
+//! the map object animations are updated every frame.
+const float OBJECT_UPDATE_MARGIN = 8.0f;
 //@}
 
 /** \name Map State Enum
@@ -205,11 +210,31 @@ enum EVENT_TYPE {
     TREASURE_EVENT                  = 13,
     LOOK_AT_SPRITE_EVENT            = 14,
     IF_EVENT                        = 15,
-    TOTAL_EVENT                     = 16
+    COROUTINE_EVENT                 = 16,
+    TOTAL_EVENT                     = 17
 };
 
-//! \brief The number of milliseconds to take to fade out the map
-const uint32_t MAP_FADE_OUT_TIME = 800;
+/** ****************************************************************************
+*** \brief An event referenced by its ID, looked up once, then by its index in the event supervisor.
+***
+*** Used by the dialogues, so that starting their events doesn't look their ID up each time.
+*** ***************************************************************************/
+class EventReference
+{
+public:
+    explicit EventReference(const std::string& id = std::string()) :
+        event_id(id), event_index(-1) {}
+
+    bool IsEmpty() const {
+        return event_id.empty();
+    }
+
+    //! \brief The ID of the event referenced
+    std::string event_id;
+
+    //! \brief The event index in the event supervisor, looked up from its ID at the first use. -1 until then.
+    int32_t event_index;
+}; // class EventReference
 
 //! \brief This function adapts the images to the map scale.
 void ScaleToMapZoomRatio(vt_video::ImageDescriptor& img);
@@ -220,6 +245,15 @@ void ScaleToMapZoomRatio(vt_video::ImageDescriptor& img);
 **/
 uint16_t GetOppositeDirection(const uint16_t direction);
 
+/** \brief Allocates the memory of an object living as long as the current map.
+*** The memory is taken from the current map memory arena, or from the heap when there is no map.
+*** Used by the operator new of the map objects, zones and events.
+**/
+void* AllocateMapMemory(size_t size);
+
+//! \brief Frees memory given by AllocateMapMemory(), with the same size.
+void FreeMapMemory(void* pointer, size_t size);
+
 /** ****************************************************************************
 *** \brief Retains information about how the next map frame should be drawn.
 ***
@@ -257,57 +291,61 @@ public:
 /** ****************************************************************************
 *** \brief A container class for node information in pathfinding.
 ***
-*** This class is used in the MapMode#_FindPath function to find an optimal
-*** path from a given source to a destination. The path finding algorithm
-*** employed is A* and thus many members of this class are particular to the
-*** implementation of that algorithm.
+*** This class is used in the ObjectSupervisor::FindPath() function to find an
+*** optimal path from a given source to a destination. The path finding
+*** algorithm employed is A* and thus many members of this class are particular
+*** to the implementation of that algorithm.
+***
+*** There is one node per collision grid element, kept from one search to the
+*** next. The members are only meaningful when the generation matches the
+*** current search, so that the nodes never need to be cleared.
 *** ***************************************************************************/
 class PathNode
 {
 public:
-    /** \brief The grid coordinates for this node
-    *** These coordinates correspond to the collision grid, where each element
-    *** is a 16x16 pixel space on the map.
-    **/
-    int16_t tile_x, tile_y;
-
     //! \name Path Scoring Members
     //@{
-    //! \brief The total score for this node (f = g + h).
-    int16_t f_score;
-
     //! \brief The score for this node relative to the source.
-    int16_t g_score;
+    uint32_t g_score;
+
+    //! \brief The diagonal distance from this node to the destination.
+    uint32_t h_score;
 
-    //! \brief The Manhattan distance from this node to the destination.
-    int16_t h_score;
+    //! \brief The total score for this node (f = g + h).
+    uint32_t f_score;
     //@}
 
-    //! \brief The grid coordinates for the parent of this node
-    int16_t parent_x, parent_y;
+    //! \brief The index of the parent of this node, or -1 for the source node.
+    int32_t parent;
 
-    // ---------- Methods
+    //! \brief The position of this node in the open list heap, while open.
+    uint32_t heap_index;
 
-    PathNode() : tile_x(-1), tile_y(-1), f_score(0), g_score(0), h_score(0), parent_x(0), parent_y(0)
-    {}
+    //! \brief The search this node was last opened or closed in.
+    uint32_t generation;
 
-    PathNode(int16_t x_, int16_t y_) : tile_x(x_), tile_y(y_), f_score(0), g_score(0), h_score(0), parent_x(0), parent_y(0)
-    {}
+    //! \brief Whether this node is closed, rather than open, in its generation.
+    bool closed;
 
-    //! \brief Overloaded comparison operator, only checks that the tile_x and tile_y members are equal
-    bool operator==(const PathNode &that) const {
-        return ((this->tile_x == that.tile_x) && (this->tile_y == that.tile_y));
-    }
+    //! \brief The search the collision member was computed in.
+    uint32_t collision_generation;
 
-    //! \brief Overloaded comparison operator, only checks that the tile_x or tile_y members are unequal
-    bool operator!=(const PathNode &that) const {
-        return ((this->tile_x != that.tile_x) || (this->tile_y != that.tile_y));
-    }
+    //! \brief The collision of the sprite on this node, cached as it doesn't change during a search.
+    COLLISION_TYPE collision;
 
-    //! \brief Overloaded comparison operator only used for path finding, compares the two f_scores
-    bool operator<(const PathNode &that) const {
-        return this->f_score > that.f_score;
-    }
+    // ---------- Methods
+
+    PathNode() :
+        g_score(0),
+        h_score(0),
+        f_score(0),
+        parent(-1),
+        heap_index(0),
+        generation(0),
+        closed(false),
+        collision_generation(0),
+        collision(NO_COLLISION)
+    {}
 }; // class PathNode
 
 typedef std::vector<vt_common::Position2D> Path;
@@ -21,6 +21,8 @@
 
 #include "utils/utils_random.h"
 
+#include <algorithm>
+
 using namespace vt_utils;
 using namespace vt_common;
 
@@ -70,14 +72,27 @@ void MapZone::AddSection(uint16_t left_col, uint16_t right_col, uint16_t top_row
     }
 
     _sections.push_back(Rectangle2D(left_col, right_col, top_row, bottom_row));
+    _UpdateCells();
 }
 
 bool MapZone::IsInsideZone(float pos_x, float pos_y) const
 {
-    // Check each section of the zone
-    // and check whether the tile position is within the section bounds.
+    const float x = GetFloatInteger(pos_x);
+    const float y = GetFloatInteger(pos_y);
+    if(_cells.empty() || !_bounds.Contains(Position2D(x, y)))
+        return false;
+
+    // The sections have integer edges, so do the tile positions within the bounding box.
+    const uint32_t cell_x = static_cast<uint32_t>(x - _bounds.left);
+    const uint32_t cell_y = static_cast<uint32_t>(y - _bounds.top);
+    return _cells[cell_y * _GetCellsWidth() + cell_x];
+}
+
+bool MapZone::IsNearZone(float pos_x, float pos_y, float distance) const
+{
     for(auto it = _sections.begin(); it != _sections.end(); ++it) {
-        if((*it).Contains(Position2D(GetFloatInteger(pos_x), GetFloatInteger(pos_y)))) {
+        if(pos_x >= it->left - distance && pos_x <= it->right + distance
+                && pos_y >= it->top - distance && pos_y <= it->bottom + distance) {
             return true;
         }
     }
@@ -86,8 +101,7 @@ bool MapZone::IsInsideZone(float pos_x, float pos_y) const
 
 void MapZone::Update()
 {
-    if (_interaction_icon)
-        _interaction_icon->Update();
+    // The interaction icon follows the map animation clock.
 }
 
 void MapZone::Draw()
@@ -105,11 +119,11 @@ void MapZone::Draw()
 void MapZone::RandomPosition(float& x, float& y)
 {
     // Select a random ZoneSection
-    uint16_t i = RandomBoundedInteger(0, _sections.size() - 1);
+    uint16_t i = GetRandomStream(RANDOM_STREAM_MAP).BoundedInteger(0, _sections.size() - 1);
 
     // Select a random x and y position inside that section
-    x = (float)RandomBoundedInteger(_sections[i].left, _sections[i].right);
-    y = (float)RandomBoundedInteger(_sections[i].top, _sections[i].bottom);
+    x = (float)GetRandomStream(RANDOM_STREAM_MAP).BoundedInteger(_sections[i].left, _sections[i].right);
+    y = (float)GetRandomStream(RANDOM_STREAM_MAP).BoundedInteger(_sections[i].top, _sections[i].bottom);
 }
 
 void MapZone::SetInteractionIcon(const std::string& animation_filename)
@@ -120,6 +134,7 @@ void MapZone::SetInteractionIcon(const std::string& animation_filename)
     if (!_interaction_icon->LoadFromAnimationScript(animation_filename)) {
         PRINT_WARNING << "Interaction icon animation filename couldn't be loaded: " << animation_filename << std::endl;
     }
+    _interaction_icon->SetClock(&MapMode::CurrentInstance()->GetAnimationClock());
 }
 
 void MapZone::DrawInteractionIcon()
@@ -167,6 +182,31 @@ bool MapZone::_ShouldDraw(const Rectangle2D& section)
     return true;
 }
 
+void MapZone::_UpdateCells()
+{
+    _bounds = _sections.front();
+    for(uint32_t i = 1; i < _sections.size(); ++i) {
+        _bounds.left = std::min(_bounds.left, _sections[i].left);
+        _bounds.right = std::max(_bounds.right, _sections[i].right);
+        _bounds.top = std::min(_bounds.top, _sections[i].top);
+        _bounds.bottom = std::max(_bounds.bottom, _sections[i].bottom);
+    }
+
+    const uint32_t width = _GetCellsWidth();
+    _cells.assign(width * _GetCellsHeight(), false);
+    for(uint32_t i = 0; i < _sections.size(); ++i) {
+        const Rectangle2D& section = _sections[i];
+        const uint32_t left = static_cast<uint32_t>(section.left - _bounds.left);
+        const uint32_t right = static_cast<uint32_t>(section.right - _bounds.left);
+        const uint32_t top = static_cast<uint32_t>(section.top - _bounds.top);
+        const uint32_t bottom = static_cast<uint32_t>(section.bottom - _bounds.top);
+        for(uint32_t y = top; y <= bottom; ++y) {
+            for(uint32_t x = left; x <= right; ++x)
+                _cells[y * width + x] = true;
+        }
+    }
+}
+
 MapZone::MapZone(const MapZone&)
 {
     throw vt_utils::Exception("Not Implemented!", __FILE__, __LINE__, __FUNCTION__);
@@ -243,7 +283,9 @@ EnemyZone::EnemyZone(uint16_t left_col, uint16_t right_col,
     _spawns_left(-1), // Infinite spawns permitted.
     _spawn_timer(STANDARD_ENEMY_FIRST_SPAWN_TIME),
     _dead_timer(STANDARD_ENEMY_DEAD_TIME),
-    _spawn_zone(nullptr)
+    _spawn_zone(nullptr),
+    _spawn_positions_half_width(-1.0f),
+    _spawn_positions_height(-1.0f)
 {
     // Done so that when the zone updates for the first time, an inactive enemy will immediately be selected and begin spawning
     _dead_timer.Finish();
@@ -272,6 +314,14 @@ EnemyZone* EnemyZone::Create(uint16_t left_col, uint16_t right_col, uint16_t top
     return new EnemyZone(left_col, right_col, top_row, bottom_row);
 }
 
+void EnemyZone::AddSection(uint16_t left_col, uint16_t right_col, uint16_t top_row, uint16_t bottom_row)
+{
+    MapZone::AddSection(left_col, right_col, top_row, bottom_row);
+
+    // The enemies may spawn in the new section.
+    _spawn_positions_half_width = -1.0f;
+}
+
 void EnemyZone::AddEnemy(EnemySprite* enemy, uint8_t enemy_number)
 {
     if(enemy_number == 0) {
@@ -327,6 +377,7 @@ void EnemyZone::AddSpawnSection(uint16_t left_col, uint16_t right_col, uint16_t
     } else {
         _spawn_zone->AddSection(left_col, right_col, top_row, bottom_row);
     }
+    _spawn_positions_half_width = -1.0f;
 }
 
 void EnemyZone::EnemyDead()
@@ -341,10 +392,10 @@ void EnemyZone::EnemyDead()
 void EnemyZone::Update()
 {
     // When spawning an enemy in a random zone location, sometimes it is occupied by another
-    // object or that section is unwalkable. We try only a few different spawn locations before
-    // giving up and waiting for the next call to Update(). Otherwise this function could
-    // potentially take a noticable amount of time to complete
-    const int8_t SPAWN_RETRIES = 50;
+    // object. We try only a few following spawn locations before giving up and waiting for
+    // the next call to Update(). Otherwise this function could potentially take a noticable
+    // amount of time to complete
+    const uint32_t SPAWN_RETRIES = 50;
 
     // Don't update when the zone is disabled.
     if (!_enabled)
@@ -393,31 +444,25 @@ void EnemyZone::Update()
         }
     }
 
-    // Used to retain random position coordinates in the zone
-    float x = 0.0f;
-    float y = 0.0f;
-    // Number of times to try finding a valid spawning location
-    int8_t retries = SPAWN_RETRIES;
     // Holds the result of a collision detection check
-    uint32_t collision = NO_COLLISION;
+    uint32_t collision = WALL_COLLISION;
 
-    // Select a random position inside the zone to place the spawning enemy
+    // Select a random position free of walls inside the zone to place the spawning enemy
     _enemies[index]->SetCollisionMask(WALL_COLLISION | CHARACTER_COLLISION);
-    MapZone* spawning_zone = nullptr;
-    if (!HasSeparateSpawnZone()) {
-        spawning_zone = this;
-    } else {
-        spawning_zone = _spawn_zone;
+    _UpdateSpawnPositions(_enemies[index]);
+
+    // If another object is there, try the next free positions.
+    if (!_spawn_positions.empty()) {
+        const uint32_t start = GetRandomStream(RANDOM_STREAM_MAP).BoundedInteger(0, _spawn_positions.size() - 1);
+        for (uint32_t i = 0; i < SPAWN_RETRIES && i < _spawn_positions.size() && collision != NO_COLLISION; ++i) {
+            const Position2D& position = _spawn_positions[(start + i) % _spawn_positions.size()];
+            _enemies[index]->SetPosition(position.x, position.y);
+            collision = MapMode::CurrentInstance()->GetObjectSupervisor()->DetectCollision(_enemies[index],
+                        _enemies[index]->GetXPosition(),
+                        _enemies[index]->GetYPosition(),
+                        nullptr);
+        }
     }
-    // If there is a collision, retry a different location
-    do {
-        spawning_zone->RandomPosition(x, y);
-        _enemies[index]->SetPosition(x, y);
-        collision = MapMode::CurrentInstance()->GetObjectSupervisor()->DetectCollision(_enemies[index],
-                    _enemies[index]->GetXPosition(),
-                    _enemies[index]->GetYPosition(),
-                    nullptr);
-    } while (collision != NO_COLLISION && --retries > 0);
 
     // Otherwise, spawn the enemy and reset the spawn timer
     if (collision == NO_COLLISION) {
@@ -436,6 +481,31 @@ void EnemyZone::Update()
     }
 } // void EnemyZone::Update()
 
+void EnemyZone::_UpdateSpawnPositions(EnemySprite* enemy)
+{
+    if (enemy->GetCollGridHalfWidth() == _spawn_positions_half_width
+            && enemy->GetCollGridHeight() == _spawn_positions_height) {
+        return;
+    }
+    _spawn_positions_half_width = enemy->GetCollGridHalfWidth();
+    _spawn_positions_height = enemy->GetCollGridHeight();
+    _spawn_positions.clear();
+
+    // Keep every cell of the spawning zone where the enemy is clear of the collision grid.
+    const MapZone* spawning_zone = HasSeparateSpawnZone() ? _spawn_zone : this;
+    const ObjectSupervisor* object_supervisor = MapMode::CurrentInstance()->GetObjectSupervisor();
+    const uint32_t width = spawning_zone->_GetCellsWidth();
+    for (uint32_t i = 0; i < spawning_zone->_cells.size(); ++i) {
+        if (!spawning_zone->_cells[i])
+            continue;
+
+        const float x = spawning_zone->_bounds.left + (i % width);
+        const float y = spawning_zone->_bounds.top + (i / width);
+        if (object_supervisor->IsGridAreaFree(enemy->GetGridCollisionRectangle(x, y)))
+            _spawn_positions.push_back(Position2D(x, y));
+    }
+}
+
 void EnemyZone::Draw()
 {
     // Don't draw when the zone is disabled.
@@ -58,6 +58,15 @@ public:
 
     virtual ~MapZone();
 
+    //! \brief The map zones are allocated in the memory arena of their map.
+    static void* operator new(size_t size) {
+        return AllocateMapMemory(size);
+    }
+
+    static void operator delete(void* pointer, size_t size) {
+        FreeMapMemory(pointer, size);
+    }
+
     //! \brief A C++ wrapper made to create a new object from scripting,
     //! without letting Lua handling the object life-cycle.
     //! \note We don't permit luabind to use constructors here as it can't currently
@@ -86,9 +95,15 @@ public:
     *** \note This function ignores the fractional part of map coordinates for performance reasons. So whenever an object is being
     *** checked as to whether or not it may be found in this zone, the floating point portion of its map coordinates are not taken
     *** into account.
+    ***
+    *** \note The answer is read from a raster of the zone cells, built when a section is added,
+    *** so it doesn't depend on the number of sections.
     **/
     bool IsInsideZone(float pos_x, float pos_y) const;
 
+    //! \brief Returns true if the position is within the given distance of the zone sections, or inside them.
+    bool IsNearZone(float pos_x, float pos_y, float distance) const;
+
     //! \brief Draws the map zone on screen for debugging purpose
     virtual void Draw();
 
@@ -108,12 +123,29 @@ protected:
     //! \brief The rectangular sections which compose the map zone
     std::vector<vt_common::Rectangle2D> _sections;
 
+    //! \brief The bounding box of the sections, and whether each of its cells is in a section:
+    //! _cells[(y - _bounds.top) * width + (x - _bounds.left)], with the edges included.
+    vt_common::Rectangle2D _bounds;
+    std::vector<bool> _cells;
+
     //! \brief Interaction icon
     vt_video::AnimatedImage* _interaction_icon;
 
     //! \brief Tells whether a section is on screen and place the drawing cursor in that case.
     bool _ShouldDraw(const vt_common::Rectangle2D& section);
 
+    //! \brief Returns the number of cells of the bounding box on each axis.
+    uint32_t _GetCellsWidth() const {
+        return static_cast<uint32_t>(_bounds.right - _bounds.left) + 1;
+    }
+
+    uint32_t _GetCellsHeight() const {
+        return static_cast<uint32_t>(_bounds.bottom - _bounds.top) + 1;
+    }
+
+    //! \brief Rebuilds the cells raster from the sections.
+    void _UpdateCells();
+
 private:
     //
     // The copy constructor and assignment operator are hidden by design
@@ -235,6 +267,9 @@ public:
     //! give the object ownership at construction time.
     static EnemyZone* Create(uint16_t left_col, uint16_t right_col, uint16_t top_row, uint16_t bottom_row);
 
+    //! \brief Adds a new zone section, where the enemies may roam and spawn.
+    virtual void AddSection(uint16_t left_col, uint16_t right_col, uint16_t top_row, uint16_t bottom_row) override;
+
     //! \brief Enables/disables the enemy zone.
     void SetEnabled(bool is_enabled) {
         _enabled = is_enabled;
@@ -348,6 +383,17 @@ private:
     //! \brief An optional zone which specifies where enemies may spawn
     MapZone *_spawn_zone;
 
+    /** \brief The spawning zone cells where an enemy doesn't overlap any unwalkable grid element.
+    *** They only depend on the enemy collision size, which they were computed for,
+    *** so that spawning only has to check the other objects.
+    **/
+    std::vector<vt_common::Position2D> _spawn_positions;
+    float _spawn_positions_half_width;
+    float _spawn_positions_height;
+
+    //! \brief Computes the spawn positions again if the enemy collision size differs from the last one.
+    void _UpdateSpawnPositions(EnemySprite* enemy);
+
     /** \brief Contains all of the enemies that may exist in this zone.
     *** \note These sprites will be deleted by the map object manager, not the destructor of this class.
     **/
@@ -161,42 +161,13 @@ MenuMode::MenuMode() :
                                 ~vt_gui::VIDEO_MENU_EDGE_BOTTOM, vt_gui::VIDEO_MENU_EDGE_BOTTOM);
     _main_options_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y - 50));
 
-    // Set up the party window
-    _party_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _party_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+    // The other windows are created when their main menu option is first selected.
+    for(uint32_t i = 0; i < private_menu::MainMenuState::MAIN_OPTIONS_SIZE; ++i)
+        _option_windows_created[i] = false;
+    _CreateOptionWindows(private_menu::MainMenuState::MAIN_OPTIONS_INVENTORY);
 
-    // Set up the party window
-    _battle_formation_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _battle_formation_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the skills window
-    _skills_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _skills_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the skilltree window
-    _skilltree_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _skilltree_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the equipment window
-    _equip_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _equip_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the inventory window
-    _inventory_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _inventory_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the quest window
-    _quest_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _quest_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the quest list window
-    _quest_list_window.Create(360, 448, vt_gui::VIDEO_MENU_EDGE_ALL,
-                              vt_gui::VIDEO_MENU_EDGE_TOP | vt_gui::VIDEO_MENU_EDGE_BOTTOM);
-    _quest_list_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
-
-    // Set up the world map window
-    _world_map_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
-    _world_map_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+    // The world map images are only loaded while the menu is open.
+    vt_global::GlobalManager->GetWorldMapData().PrefetchImages();
 
     _current_menu_state = &_main_menu_state;
 
@@ -215,15 +186,6 @@ MenuMode::MenuMode() :
     _character_window1.Show();
     _character_window2.Show();
     _character_window3.Show();
-    _inventory_window.Show();
-    _quest_list_window.Show();
-    _party_window.Show();
-    _battle_formation_window.Show();
-    _skills_window.Show();
-    _skilltree_window.Show();
-    _equip_window.Show();
-    _quest_window.Show();
-    _world_map_window.Show();
 
     // Init the equipment view members
     _phys_header.SetStyle(vt_video::TextStyle("text18"));
@@ -252,16 +214,26 @@ MenuMode::~MenuMode()
     _character_window1.Destroy();
     _character_window2.Destroy();
     _character_window3.Destroy();
-    _inventory_window.Destroy();
-    _quest_list_window.Destroy();
-    _party_window.Destroy();
-    _battle_formation_window.Destroy();
-    _skills_window.Destroy();
-    _skilltree_window.Destroy();
     _main_options_window.Destroy();
-    _equip_window.Destroy();
-    _quest_window.Destroy();
-    _world_map_window.Destroy();
+    if(_option_windows_created[private_menu::MainMenuState::MAIN_OPTIONS_INVENTORY]) {
+        _inventory_window.Destroy();
+        _equip_window.Destroy();
+    }
+    if(_option_windows_created[private_menu::MainMenuState::MAIN_OPTIONS_SKILLS]) {
+        _skills_window.Destroy();
+        _skilltree_window.Destroy();
+    }
+    if(_option_windows_created[private_menu::MainMenuState::MAIN_OPTIONS_PARTY]) {
+        _party_window.Destroy();
+        _battle_formation_window.Destroy();
+    }
+    if(_option_windows_created[private_menu::MainMenuState::MAIN_OPTIONS_QUESTS]) {
+        _quest_list_window.Destroy();
+        _quest_window.Destroy();
+    }
+    if(_option_windows_created[private_menu::MainMenuState::MAIN_OPTIONS_WORLDMAP])
+        _world_map_window.Destroy();
+    vt_global::GlobalManager->GetWorldMapData().UnloadImages();
 
     _current_instance = nullptr;
 
@@ -669,6 +641,7 @@ void MenuMode::ReloadCharacterWindows()
 void MenuMode::GoToImproveSkillMenu()
 {
     // Permits to go directly to the improve selection
+    _CreateOptionWindows(private_menu::MainMenuState::MAIN_OPTIONS_SKILLS);
     _current_menu_state = &_skills_state;
     _skills_state.GetOptions()->InputRight();
     _skills_state._current_category = private_menu::SkillsState::SKILLS_CATEGORY::SKILLS_OPTIONS_SKILL_GRAPH;
@@ -676,4 +649,67 @@ void MenuMode::GoToImproveSkillMenu()
     _end_battle_mode = true;
 }
 
+void MenuMode::_CreateOptionWindows(uint32_t main_option)
+{
+    if(main_option >= private_menu::MainMenuState::MAIN_OPTIONS_SIZE || _option_windows_created[main_option])
+        return;
+    _option_windows_created[main_option] = true;
+
+    switch(main_option) {
+    case private_menu::MainMenuState::MAIN_OPTIONS_INVENTORY:
+        // Set up the inventory window
+        _inventory_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _inventory_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _inventory_window.Show();
+
+        // Set up the equipment window
+        _equip_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _equip_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _equip_window.Show();
+        break;
+    case private_menu::MainMenuState::MAIN_OPTIONS_SKILLS:
+        // Set up the skills window
+        _skills_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _skills_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _skills_window.Show();
+
+        // Set up the skilltree window
+        _skilltree_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _skilltree_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _skilltree_window.Show();
+        break;
+    case private_menu::MainMenuState::MAIN_OPTIONS_PARTY:
+        // Set up the party window
+        _party_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _party_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _party_window.Show();
+
+        // Set up the battle formation window
+        _battle_formation_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _battle_formation_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _battle_formation_window.Show();
+        break;
+    case private_menu::MainMenuState::MAIN_OPTIONS_QUESTS:
+        // Set up the quest window
+        _quest_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _quest_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _quest_window.Show();
+
+        // Set up the quest list window
+        _quest_list_window.Create(360, 448, vt_gui::VIDEO_MENU_EDGE_ALL,
+                                  vt_gui::VIDEO_MENU_EDGE_TOP | vt_gui::VIDEO_MENU_EDGE_BOTTOM);
+        _quest_list_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _quest_list_window.Show();
+        break;
+    case private_menu::MainMenuState::MAIN_OPTIONS_WORLDMAP:
+        // Set up the world map window
+        _world_map_window.Create(static_cast<float>(win_width * 4 + 16), 448, vt_gui::VIDEO_MENU_EDGE_ALL);
+        _world_map_window.SetPosition(static_cast<float>(win_start_x), static_cast<float>(win_start_y + 10));
+        _world_map_window.Show();
+        break;
+    default:
+        break;
+    }
+}
+
 } // namespace vt_menu
@@ -119,6 +119,13 @@ public:
     void GoToImproveSkillMenu();
 
 private:
+    /** \brief Creates the windows shown by a main menu option, the first time it is selected.
+    *** \param main_option A private_menu::MainMenuState::MAIN_CATEGORY value.
+    *** \note Only the windows of the main view are created with the menu, so that
+    *** opening it doesn't stall on windows the player may not look at.
+    **/
+    void _CreateOptionWindows(uint32_t main_option);
+
     //! \brief A static pointer to the last instantiated MenuMode object
     static MenuMode *_current_instance;
 
@@ -270,6 +277,9 @@ private:
     //! \brief Set the end battle mode
     //! Makes the menu close when the skill tree window is closed.
     bool _end_battle_mode = false;
+
+    //! \brief Tells which main menu options had their windows created, by MAIN_CATEGORY.
+    bool _option_windows_created[private_menu::MainMenuState::MAIN_OPTIONS_SIZE];
     //@}
 };
 
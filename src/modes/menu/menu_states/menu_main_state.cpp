@@ -84,6 +84,7 @@ AbstractMenuState* MainMenuState::GetTransitionState(uint32_t selection)
 void MainMenuState::_OnUpdateState()
 {
     uint32_t draw_window = _options.GetSelection();
+    _menu_mode->_CreateOptionWindows(draw_window);
     switch(draw_window) {
     case MAIN_OPTIONS_WORLDMAP:
     {
@@ -98,6 +99,7 @@ void MainMenuState::_OnUpdateState()
 void MainMenuState::_OnDrawMainWindow()
 {
     uint32_t draw_window = _options.GetSelection();
+    _menu_mode->_CreateOptionWindows(draw_window);
 
     // Draw the chosen window
     switch(draw_window) {
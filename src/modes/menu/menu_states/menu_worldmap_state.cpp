@@ -77,7 +77,9 @@ void WorldMapState::_ActiveWindowUpdate()
     }
 
     //draw the current viewing location information
-    vt_global::WorldMapLocation *current_location = _menu_mode->_world_map_window.GetCurrentViewingLocation();
+    vt_global::WorldMapHandler& worldmap = vt_global::GlobalManager->GetWorldMapData();
+    const uint32_t location_index = _menu_mode->_world_map_window.GetCurrentViewingLocation();
+    const vt_global::WorldMapLocation* current_location = worldmap.GetWorldLocation(location_index);
     if(current_location == nullptr)
     {
         _location_image = nullptr;
@@ -85,7 +87,7 @@ void WorldMapState::_ActiveWindowUpdate()
         return;
     }
     _location_text.SetDisplayText(current_location->_location_name);
-    _location_image = &(current_location->_image);
+    _location_image = worldmap.GetLocationImage(location_index);
 }
 
 } // namespace private_menu
@@ -60,6 +60,12 @@ vt_global::GLOBAL_OBJECT GetObjectTypeFromEquipCategory(EQUIP_CATEGORY category)
 }
 
 EquipWindow::EquipWindow() :
+    _equip(true),
+    _equip_list_outdated(true),
+    _shown_equip_list(false),
+    _shown_character_id(0),
+    _shown_category(0),
+    _shown_revision(0),
     _active_box(EQUIP_ACTIVE_NONE),
     _character(nullptr)
 {
@@ -84,6 +90,7 @@ EquipWindow::EquipWindow() :
 void EquipWindow::Activate(bool new_status, bool equip)
 {
     _equip = equip;
+    _equip_list_outdated = true;
 
     //Activate window and first option box...or deactivate both
     if(new_status) {
@@ -348,60 +355,52 @@ void EquipWindow::_UpdateEquipList()
 {
     InventoryHandler& inventory_handler = GlobalManager->GetInventoryHandler();
 
-    std::vector<ustring> options;
+    // Rebuilding the options loads their icons, so only do it when what they show changed.
+    const bool show_list = (_active_box == EQUIP_ACTIVE_LIST);
+    const uint32_t character_id = _character ? _character->GetID() : 0;
+    const int32_t selected_category = _equip_select.GetSelection();
+    if(!_equip_list_outdated && _shown_equip_list == show_list && _shown_character_id == character_id &&
+            (!show_list || _shown_category == selected_category) && _shown_revision == inventory_handler.GetRevision())
+        return;
+    _equip_list_outdated = false;
+    _shown_equip_list = show_list;
+    _shown_character_id = character_id;
+    _shown_category = selected_category;
+    _shown_revision = inventory_handler.GetRevision();
 
-    if(_active_box == EQUIP_ACTIVE_LIST) {
-        std::vector<std::shared_ptr<GlobalObject>> equipment_list;
+    std::vector<ustring> options;
 
-        EQUIP_CATEGORY category = static_cast<EQUIP_CATEGORY>(_equip_select.GetSelection());
+    if(show_list) {
+        EQUIP_CATEGORY category = static_cast<EQUIP_CATEGORY>(selected_category);
         GLOBAL_OBJECT object_type = GetObjectTypeFromEquipCategory(category);
 
-        switch(_equip_select.GetSelection()) {
-            default:
-                break;
-            case EQUIP_WEAPON: {
-                auto inv = inventory_handler.GetInventoryWeapons();
-                equipment_list = std::vector<std::shared_ptr<GlobalObject>>(inv.begin(), inv.end());
-                break;
-            }
-            case EQUIP_HEAD:
-            case EQUIP_TORSO:
-            case EQUIP_ARMS:
-            case EQUIP_LEGS: {
-                auto inv = inventory_handler.GetInventoryArmors(object_type);
-                equipment_list = std::vector<std::shared_ptr<GlobalObject>>(inv.begin(), inv.end());
-                break;
-            }
-        }
-
         // Clear the replacer ids
         _equip_list_inv_index.clear();
 
-        // Add the options
-        uint32_t gear_size = equipment_list.size();
-        for(uint32_t j = 0; j < gear_size; j++) {
-            uint32_t usability_bitmask = 0;
-            if(_equip_select.GetSelection() == EQUIP_WEAPON) {
-                std::shared_ptr<GlobalWeapon> selected_weapon =
-                    std::dynamic_pointer_cast<GlobalWeapon>(equipment_list.at(j));
-                usability_bitmask = selected_weapon->GetUsableBy();
+        // Only show the equipment the character can equip, as filtered by the inventory.
+        if(object_type != GLOBAL_OBJECT_INVALID && _character) {
+            if(_equip) {
+                _equip_list_inv_index = inventory_handler.GetEquipableObjects(object_type, character_id);
             } else {
-                std::shared_ptr<GlobalArmor> selected_armor =
-                    std::dynamic_pointer_cast<GlobalArmor>(equipment_list.at(j));
-                usability_bitmask = selected_armor->GetUsableBy();
+                const uint32_t gear_size = (object_type == GLOBAL_OBJECT_WEAPON) ?
+                                           inventory_handler.GetInventoryWeapons().size() :
+                                           inventory_handler.GetInventoryArmors(object_type).size();
+                for(uint32_t j = 0; j < gear_size; ++j)
+                    _equip_list_inv_index.push_back(j);
             }
+        }
 
-            // If the character can't equip the item, don't show it.
-            if(_equip && !(usability_bitmask & _character->GetID()))
-                continue;
+        // Add the options
+        for(uint32_t j = 0; j < _equip_list_inv_index.size(); ++j) {
+            const uint32_t inventory_id = _equip_list_inv_index[j];
+            GlobalObject* object = (object_type == GLOBAL_OBJECT_WEAPON) ?
+                                   static_cast<GlobalObject*>(inventory_handler.GetInventoryWeapons()[inventory_id].get()) :
+                                   static_cast<GlobalObject*>(inventory_handler.GetInventoryArmors(object_type)[inventory_id].get());
 
             options.push_back(MakeUnicodeString("<") +
-                              MakeUnicodeString(equipment_list.at(j)->GetIconImage().GetFilename()) +
+                              MakeUnicodeString(object->GetIconImage().GetFilename()) +
                               MakeUnicodeString("><70>") +
-                              equipment_list.at(j)->GetName());
-
-            // Add the actual inventory index
-            _equip_list_inv_index.push_back(j);
+                              object->GetName());
         }
 
         _equip_list.SetOptions(options);
@@ -104,6 +104,14 @@ private:
     //! Since not all the items are displayed in this list.
     std::vector<uint32_t> _equip_list_inv_index;
 
+    //! \brief What the option boxes were last built from, so that they are only rebuilt when it changes:
+    //! Whether the replacement list was shown, the character and equipment category, and the inventory revision.
+    bool _equip_list_outdated;
+    bool _shown_equip_list;
+    uint32_t _shown_character_id;
+    int32_t _shown_category;
+    uint32_t _shown_revision;
+
     //! Flag to specify the active option box
     uint32_t _active_box;
 
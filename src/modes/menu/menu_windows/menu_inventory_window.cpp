@@ -65,6 +65,9 @@ InventoryWindow::InventoryWindow(MenuMode* mm) :
     _menu_mode(mm),
     _active_box(ITEM_ACTIVE_NONE),
     _previous_category(ITEM_ALL),
+    _item_list_outdated(true),
+    _item_list_category(ITEM_ALL),
+    _item_list_revision(0),
     _object(nullptr),
     _object_type(vt_global::GLOBAL_OBJECT_INVALID),
     _character(nullptr),
@@ -210,7 +213,7 @@ void InventoryWindow::Update()
     GlobalMedia& media = GlobalManager->Media();
     InventoryHandler& inventory_handler = GlobalManager->GetInventoryHandler();
 
-    if(inventory_handler.GetInventory().empty()) {
+    if(inventory_handler.IsInventoryEmpty()) {
         // no more items in inventory, exit inventory window
         Activate(false);
         return;
@@ -621,28 +624,33 @@ void InventoryWindow::_UpdateItemText()
 {
     InventoryHandler& inventory_handler = GlobalManager->GetInventoryHandler();
 
-    _item_objects.clear();
-    _inventory_items.ClearOptions();
-
     ITEM_CATEGORY current_selected_category = static_cast<ITEM_CATEGORY>(_item_categories.GetSelection());
     GLOBAL_OBJECT object_type = GetObjectTypeFromItemCategory(current_selected_category);
 
+    // Rebuilding the options loads their icons, so only do it when the list actually changed.
+    if(!_item_list_outdated && _item_list_category == current_selected_category &&
+            _item_list_revision == inventory_handler.GetRevision())
+        return;
+    _item_list_outdated = false;
+    _item_list_category = current_selected_category;
+    _item_list_revision = inventory_handler.GetRevision();
+
+    _item_objects.clear();
+    _inventory_items.ClearOptions();
+
     switch(current_selected_category) {
         case ITEM_ALL: {
-            auto inv = inventory_handler.GetInventory();
-            for (auto it = inv.begin(); it != inv.end(); ++it) {
-                _item_objects.push_back(it->second);
-            }
+            inventory_handler.GetInventoryObjects(_item_objects);
             break;
         }
         case ITEM_ITEM: {
-            auto inv = inventory_handler.GetInventoryItems();
+            const auto& inv = inventory_handler.GetInventoryItems();
             _item_objects = std::vector<std::shared_ptr<GlobalObject>>(inv.begin(), inv.end());
             break;
         }
 
         case ITEM_WEAPON: {
-            auto inv = inventory_handler.GetInventoryWeapons();
+            const auto& inv = inventory_handler.GetInventoryWeapons();
             _item_objects = std::vector<std::shared_ptr<GlobalObject>>(inv.begin(), inv.end());
             break;
         }
@@ -651,13 +659,13 @@ void InventoryWindow::_UpdateItemText()
         case ITEM_TORSO_ARMOR:
         case ITEM_ARMS_ARMOR:
         case ITEM_LEGS_ARMOR: {
-            auto inv = inventory_handler.GetInventoryArmors(object_type);
+            const auto& inv = inventory_handler.GetInventoryArmors(object_type);
             _item_objects = std::vector<std::shared_ptr<GlobalObject>>(inv.begin(), inv.end());
             break;
         }
 
         case ITEM_KEY: {
-        auto inv = inventory_handler.GetInventoryKeyItems();
+            const auto& inv = inventory_handler.GetInventoryKeyItems();
             _item_objects = std::vector<std::shared_ptr<GlobalObject>>(inv.begin(), inv.end());
             break;
         }
@@ -735,7 +743,7 @@ void InventoryWindow::_DrawBottomInfo()
     InventoryHandler& inventory_handler = GlobalManager->GetInventoryHandler();
 
     //if we are out of items, the bottom view should do no work
-    if(inventory_handler.GetInventory().empty() || _item_objects.empty())
+    if(inventory_handler.IsInventoryEmpty() || _item_objects.empty())
         return;
 
     MenuMode* menu = MenuMode::CurrentInstance();
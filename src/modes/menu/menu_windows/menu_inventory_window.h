@@ -109,6 +109,12 @@ private:
     //! holds previous category. we were looking at
     vt_global::ITEM_CATEGORY _previous_category;
 
+    //! \brief The category and inventory revision _item_objects was built from,
+    //! so that the list is only rebuilt when one of them changes.
+    bool _item_list_outdated;
+    vt_global::ITEM_CATEGORY _item_list_category;
+    uint32_t _item_list_revision;
+
     //! The currently selected object
     std::shared_ptr<vt_global::GlobalObject> _object;
 
@@ -124,7 +130,8 @@ private:
     //! Tells whether the character can equip the item
     bool _can_equip;
 
-    //! \brief Updates the item text in the inventory items.
+    //! \brief Updates the item text in the inventory items,
+    //! when the category or the inventory changed since the last time.
     void _UpdateItemText();
 
     //! \brief updates the selected item and character.
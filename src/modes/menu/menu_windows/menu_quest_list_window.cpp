@@ -153,7 +153,7 @@ void QuestListWindow::_UpdateQuestList()
         _quests_list.SetOptionText(selection, spacing + title);
     }
 
-    entry->SetRead();
+    GlobalManager->GetGameQuests().SetQuestLogRead(entry);
 
     // Update the list box.
     _quests_list.Update(SystemManager->GetUpdateTime());
@@ -18,6 +18,7 @@
 #include "common/global/skill_graph/skill_graph.h"
 #include "common/global/actors/global_character.h"
 
+#include <algorithm>
 #include <limits>
 
 using namespace vt_menu::private_menu;
@@ -270,21 +271,27 @@ void SkillGraphWindow::_DrawSkillGraphState()
 //                                       2, Color::white);
 
     // Draw the visible lines
-    for (Line2D node_line : _displayed_node_links) {
-        vt_video::VideoManager->DrawLine(node_line.begin.x,
-                                         node_line.begin.y, 7,
-                                         node_line.end.x,
-                                         node_line.end.y, 7,
-                                         grayed_path);
+    for (uint32_t node_index : _displayed_node_indices) {
+        for (const _SkillNodeLink& node_link : _sorted_node_links[node_index]) {
+            vt_video::VideoManager->DrawLine(node_link.line.begin.x + _view_position.x,
+                                             node_link.line.begin.y + _view_position.y, 7,
+                                             node_link.line.end.x + _view_position.x,
+                                             node_link.line.end.y + _view_position.y, 7,
+                                             grayed_path);
+        }
     }
 
     // Color links between obtained nodes
-    for (Line2D node_line : _colored_displayed_node_links) {
-        vt_video::VideoManager->DrawLine(node_line.begin.x,
-                                         node_line.begin.y, 10,
-                                         node_line.end.x,
-                                         node_line.end.y, 10,
-                                         node_blue);
+    for (uint32_t node_index : _displayed_node_indices) {
+        for (const _SkillNodeLink& node_link : _sorted_node_links[node_index]) {
+            if (!node_link.obtained)
+                continue;
+            vt_video::VideoManager->DrawLine(node_link.line.begin.x + _view_position.x,
+                                             node_link.line.begin.y + _view_position.y, 10,
+                                             node_link.line.end.x + _view_position.x,
+                                             node_link.line.end.y + _view_position.y, 10,
+                                             node_blue);
+        }
     }
 
     Position2D pointer_location(-1.0f, -1.0f);
@@ -351,7 +358,46 @@ void SkillGraphWindow::_ResetSkillGraphView()
         return;
     }
 
-    _UpdateSkillGraphView(false);
+    _BuildSkillGraphLayout();
+    _UpdateSkillGraphView(false, true);
+}
+
+//! \brief Tells whether a skill node is left of a x position, to search the sorted nodes
+static bool isNodeLeftOf(const SkillNode* skill_node, float x)
+{
+    return skill_node->GetXPosition() < x;
+}
+
+void SkillGraphWindow::_BuildSkillGraphLayout()
+{
+    SkillGraph& skill_graph = vt_global::GlobalManager->GetSkillGraph();
+
+    _sorted_skill_nodes = skill_graph.GetSkillNodes();
+    std::stable_sort(_sorted_skill_nodes.begin(), _sorted_skill_nodes.end(),
+                     [](const SkillNode* a, const SkillNode* b) { return a->GetXPosition() < b->GetXPosition(); });
+
+    _sorted_node_links.clear();
+    _sorted_node_links.resize(_sorted_skill_nodes.size());
+    for (uint32_t i = 0; i < _sorted_skill_nodes.size(); ++i) {
+        SkillNode* skill_node = _sorted_skill_nodes[i];
+        const bool node_obtained = _selected_character->IsSkillNodeObtained(skill_node->GetId());
+
+        for (uint32_t link_id : skill_node->GetChildrenNodeLinks()) {
+            SkillNode* linked_node = skill_graph.GetSkillNode(link_id);
+            if (!linked_node)
+                continue;
+
+            _SkillNodeLink node_link;
+            node_link.line.begin = skill_node->GetPosition();
+            node_link.line.end = linked_node->GetPosition();
+            // Prepare the line to be colored if both nodes were acquired by the character
+            node_link.obtained = node_obtained && _selected_character->IsSkillNodeObtained(link_id);
+            _sorted_node_links[i].push_back(node_link);
+        }
+    }
+
+    _displayed_skill_nodes.clear();
+    _displayed_node_indices.clear();
 }
 
 void SkillGraphWindow::_UpdateSkillGraphView(bool scroll, bool force)
@@ -439,53 +485,20 @@ void SkillGraphWindow::_UpdateSkillGraphView(bool scroll, bool force)
     // Do not reload visible nodes more than necessary
     static uint32_t update_timer = 0;
     update_timer += vt_system::SystemManager->GetUpdateTime();
-    if (_view_position == target_position || update_timer >= 200) {
+    if (force || _view_position == target_position || update_timer >= 200) {
         update_timer = 0;
-        // Based on current offset, reload visible nodes
+        // Based on current offset, reload visible nodes, starting from the first one within the view width.
         _displayed_skill_nodes.clear();
-        auto skill_nodes = skill_graph.GetSkillNodes();
-        for (SkillNode* skill_node : skill_nodes) {
+        _displayed_node_indices.clear();
+        auto it = std::lower_bound(_sorted_skill_nodes.begin(), _sorted_skill_nodes.end(),
+                                   min_view.x, isNodeLeftOf);
+        for (; it != _sorted_skill_nodes.end() && (*it)->GetXPosition() <= max_view.x; ++it) {
+            SkillNode* skill_node = *it;
             if (!nodes_rect.Contains(skill_node->GetPosition())) {
                 continue;
             }
             _displayed_skill_nodes.push_back(skill_node);
-        }
-    }
-
-    // Prepare lines coordinates for draw time
-    _displayed_node_links.clear();
-    _colored_displayed_node_links.clear();
-    // default ones (white, grayed out)
-    for (SkillNode* skill_node : _displayed_skill_nodes) {
-        auto node_links = skill_node->GetChildrenNodeLinks();
-        // Don't load anything if there are no links
-        if (node_links.empty())
-            continue;
-
-        // Load line start
-        Line2D node_line;
-        node_line.begin.x = skill_node->GetXPosition() + _view_position.x;
-        node_line.begin.y = skill_node->GetYPosition() + _view_position.y;
-
-        // For each link, add a line end
-        for (uint32_t link_id : node_links) {
-            SkillNode* linked_node = skill_graph.GetSkillNode(link_id);
-            if (!linked_node)
-                continue;
-
-            // Don't draw the line if it goes over the edge.
-            Position2D node_pos = linked_node->GetPosition();
-
-            node_line.end.x = node_pos.x + _view_position.x;
-            node_line.end.y = node_pos.y + _view_position.y;
-
-            // Prepare the line to be colored if both nodes were acquired by the character
-            if (_selected_character->IsSkillNodeObtained(skill_node->GetId())
-                        && _selected_character->IsSkillNodeObtained(link_id)) {
-                _colored_displayed_node_links.push_back(node_line);
-            }
-
-            _displayed_node_links.push_back(node_line);
+            _displayed_node_indices.push_back(static_cast<uint32_t>(it - _sorted_skill_nodes.begin()));
         }
     }
 }
@@ -678,8 +691,9 @@ void SkillGraphWindow::_HandleNodeTransaction()
     _selected_character->AddObtainedSkillNode(current_skill_node->GetId());
     media.PlaySound("confirm");
 
-    // Refresh skill graph view
+    // Refresh skill graph view, with the newly colored links
     _character_node_id = _selected_character->GetSkillNodeLocation();
+    _BuildSkillGraphLayout();
     _UpdateSkillGraphView(true, true);
 
     // Refresh info
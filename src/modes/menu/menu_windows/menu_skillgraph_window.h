@@ -106,12 +106,26 @@ private:
     //! \brief Indicates whether this window is active or not
     bool _active;
 
+    //! \brief A link from a skill node to one of its children, in skill graph coordinates
+    class _SkillNodeLink
+    {
+    public:
+        vt_common::Line2D line;
+
+        //! \brief Whether both nodes were obtained by the character
+        bool obtained;
+    };
+
+    //! \brief The skill nodes sorted by their x position, so that the visible ones are found
+    //! without going through the whole graph. Built once when a character is chosen.
+    std::vector<vt_global::SkillNode*> _sorted_skill_nodes;
+    //! \brief The links to the children of each sorted skill node
+    std::vector<std::vector<_SkillNodeLink> > _sorted_node_links;
+
     //! \brief The currently displayed skill nodes
     std::vector<vt_global::SkillNode*> _displayed_skill_nodes;
-    //! \brief The currently displayed link between the nodes
-    std::vector<vt_common::Line2D> _displayed_node_links;
-    //! \brief The currenty displayed link between nodes obtained by the character
-    std::vector<vt_common::Line2D> _colored_displayed_node_links;
+    //! \brief The index of the currently displayed skill nodes in the sorted ones
+    std::vector<uint32_t> _displayed_node_indices;
 
     //! \brief The skill node description text, icon, ...
     SkillNodeBottomInfo _bottom_info;
@@ -140,6 +154,9 @@ private:
     //! \brief Reset the view centered on the currently selected node.
     void _ResetSkillGraphView();
 
+    //! \brief Sorts the skill nodes and computes their links for the selected character.
+    void _BuildSkillGraphLayout();
+
     //! \brief Update the skill tree view based on the current offset information
     void _UpdateSkillGraphView(bool scroll = true, bool force = false);
 
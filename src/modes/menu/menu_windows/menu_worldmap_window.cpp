@@ -70,18 +70,13 @@ void WorldMapWindow::_DrawViewableLocations(float window_position_x,
                                             float window_position_y)
 {
     WorldMapHandler& worldmap = GlobalManager->GetWorldMapData();
-    const std::vector<std::string> &current_location_ids = worldmap.GetViewableLocationIds();
-    const size_t location_number = current_location_ids.size();
+    const std::vector<uint32_t>& current_locations = worldmap.GetViewableLocations();
+    const size_t location_number = current_locations.size();
     for(uint32_t i = 0; i < location_number; ++i)
     {
-        const WorldMapLocation* location = worldmap.GetWorldLocation(current_location_ids[i]);
-
-        if(location == nullptr) {
-            PRINT_WARNING << "location for id: "
-                << current_location_ids[i]
-                << " is not loaded into global manager" << std::endl;
+        const WorldMapLocation* location = worldmap.GetWorldLocation(current_locations[i]);
+        if(location == nullptr)
             continue;
-        }
 
         // Draw the location marker
         VideoManager->Move(window_position_x + _current_image_offset.x + location->_pos.x,
@@ -159,9 +154,8 @@ void WorldMapWindow::Update()
 
 void WorldMapWindow::_SetSelectedLocation(WORLDMAP_NAVIGATION worldmap_goto)
 {
-    const std::vector<std::string>& current_location_ids =
-        GlobalManager->GetWorldMapData().GetViewableLocationIds();
-    const size_t location_number = current_location_ids.size();
+    const size_t location_number =
+        GlobalManager->GetWorldMapData().GetViewableLocations().size();
     if(location_number == 0)
         return;
     if(worldmap_goto == WORLDMAP_LEFT)
@@ -190,25 +184,23 @@ void WorldMapWindow::Activate(bool new_state)
     // set the pointer to the appropriate location
     // we only do this on activation of the window.
     // after that it is handled by the left / right press
-    const std::string &location_id = worldmap.GetCurrentLocationId();
-    const std::vector<std::string> &current_location_ids = worldmap.GetViewableLocationIds();
-    std::vector<std::string>::const_iterator loc =
-        std::find(current_location_ids.begin(), current_location_ids.end(),
-                  location_id);
-    if(location_id.empty() || loc == current_location_ids.end() )
+    const uint32_t location = worldmap.GetCurrentLocation();
+    const std::vector<uint32_t>& current_locations = worldmap.GetViewableLocations();
+    std::vector<uint32_t>::const_iterator loc =
+        std::find(current_locations.begin(), current_locations.end(), location);
+    if(location == INVALID_WORLD_LOCATION || loc == current_locations.end())
         _location_pointer_index = 0;
     else
-        _location_pointer_index = loc - current_location_ids.begin();
+        _location_pointer_index = loc - current_locations.begin();
 }
 
-vt_global::WorldMapLocation* WorldMapWindow::GetCurrentViewingLocation()
+uint32_t WorldMapWindow::GetCurrentViewingLocation() const
 {
-    WorldMapHandler& worldmap = GlobalManager->GetWorldMapData();
-    const std::vector<std::string>& current_location_ids = worldmap.GetViewableLocationIds();
-    const uint32_t location_number = current_location_ids.size();
-    if(location_number == 0 || _location_pointer_index > location_number)
-        return nullptr;
-    return worldmap.GetWorldLocation(current_location_ids[_location_pointer_index]);
+    const std::vector<uint32_t>& current_locations =
+        GlobalManager->GetWorldMapData().GetViewableLocations();
+    if(_location_pointer_index >= current_locations.size())
+        return INVALID_WORLD_LOCATION;
+    return current_locations[_location_pointer_index];
 }
 
 } // namespace private_menu
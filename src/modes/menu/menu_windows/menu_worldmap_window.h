@@ -80,11 +80,11 @@ public:
     void Activate(bool new_state);
 
     /*!
-    * \brief gets the WorldMapLocation pointer to the currently pointing
-    * location, or nullptr if it deson't exist
-    * \return Pointer to the currently indexes WorldMapLocation
+    * \brief gets the index of the currently pointing world location,
+    * or vt_global::INVALID_WORLD_LOCATION if it doesn't exist
+    * \return The index of the currently pointed WorldMapLocation
     */
-    vt_global::WorldMapLocation* GetCurrentViewingLocation();
+    uint32_t GetCurrentViewingLocation() const;
 
 private:
 
@@ -100,7 +100,7 @@ private:
                                 float window_position_y);
 
     //! \brief pointer to the currently loaded world map image
-    vt_video::StillImage* _current_world_map;
+    const vt_video::StillImage* _current_world_map;
 
     //! \brief the location marker. this is loaded in the ctor
     vt_video::AnimatedImage _location_marker;
@@ -101,6 +101,10 @@ void BindModeCode()
             .def("SetRunningEnabled", &MapMode::SetRunningEnabled)
 
             .def("DeleteMapObject", &MapMode::DeleteMapObject)
+            .def("SetObjectsPosition", &MapMode::SetObjectsPosition)
+            .def("SetSpritesDirection", &MapMode::SetSpritesDirection)
+            .def("SetObjectsVisible", &MapMode::SetObjectsVisible)
+            .def("SetObjectsCollisionMask", &MapMode::SetObjectsCollisionMask)
 
             .def("SetCamera", (void(MapMode:: *)(private_map::VirtualSprite *))&MapMode::SetCamera)
             .def("SetCamera", (void(MapMode:: *)(private_map::VirtualSprite *, uint32_t))&MapMode::SetCamera)
@@ -137,6 +141,9 @@ void BindModeCode()
             .def("GetActiveStatusEffectIntensity", &MapMode::GetActiveStatusEffectIntensity)
             .def("RemoveNegativeActiveStatusEffects", &MapMode::RemoveNegativeActiveStatusEffects)
             .def("SetAllEnemyStatesToDead", &MapMode::SetAllEnemyStatesToDead)
+            .def("AddScriptUpdate", &MapMode::AddScriptUpdate)
+            .def("AddScriptTrigger", &MapMode::AddScriptTrigger)
+            .def("SetScriptUpdateBudget", &MapMode::SetScriptUpdateBudget)
             .def("SetAutoSaveEnabled", &MapMode::SetAutoSaveEnabled)
             .def("GetAutoSaveEnabled", &MapMode::GetAutoSaveEnabled)
 
@@ -222,6 +229,7 @@ void BindModeCode()
             .def("SetVisible", &MapObject::SetVisible)
             .def("SetCollisionMask", &MapObject::SetCollisionMask)
             .def("SetDrawOnSecondPass", &MapObject::SetDrawOnSecondPass)
+            .def("SetAlwaysUpdated", &MapObject::SetAlwaysUpdated)
             .def("GetObjectID", &MapObject::GetObjectID)
             .def("GetXPosition", &MapObject::GetXPosition)
             .def("GetYPosition", &MapObject::GetYPosition)
@@ -233,6 +241,7 @@ void BindModeCode()
             .def("IsVisible", &MapObject::IsVisible)
             .def("GetCollisionMask", &MapObject::GetCollisionMask)
             .def("IsDrawOnSecondPass", &MapObject::IsDrawOnSecondPass)
+            .def("IsAlwaysUpdated", &MapObject::IsAlwaysUpdated)
             .def("Emote", &MapObject::Emote)
             .def("SetGrayscale", &MapObject::SetGrayscale)
             .def("IsGrayscale", &MapObject::IsGrayscale)
@@ -424,6 +433,7 @@ void BindModeCode()
             luabind::class_<MapZone>("MapZone")
             .def("AddSection", &MapZone::AddSection)
             .def("IsInsideZone", &MapZone::IsInsideZone)
+            .def("IsNearZone", &MapZone::IsNearZone)
             .def("SetInteractionIcon", &MapZone::SetInteractionIcon)
             .scope
             [   // Used for static members and nested classes.
@@ -526,6 +536,7 @@ void BindModeCode()
         [
             luabind::class_<MapEvent>("MapEvent")
             .def("GetEventID", &MapEvent::GetEventID)
+            .def("SetRecycledOnEnd", &MapEvent::SetRecycledOnEnd)
             .def("AddEventLinkAtStart", (void(MapEvent:: *)(const std::string &))&MapEvent::AddEventLinkAtStart)
             .def("AddEventLinkAtStart", (void(MapEvent:: *)(const std::string &, uint32_t))&MapEvent::AddEventLinkAtStart)
             .def("AddEventLinkAtEnd", (void(MapEvent:: *)(const std::string &))&MapEvent::AddEventLinkAtEnd)
@@ -555,6 +566,7 @@ void BindModeCode()
         luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_map")
         [
             luabind::class_<MapTransitionEvent, MapEvent>("MapTransitionEvent")
+            .def("SetPrefetchZone", &MapTransitionEvent::SetPrefetchZone)
             .scope
             [   // Used for static members and nested classes.
                 luabind::def("Create", &MapTransitionEvent::Create)
@@ -579,6 +591,23 @@ void BindModeCode()
             ]
         ];
 
+        luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_map")
+        [
+            luabind::class_<CoroutineEvent, MapEvent>("CoroutineEvent")
+            .scope
+            [   // Used for static members and nested classes.
+                luabind::def("Create", &CoroutineEvent::Create)
+            ]
+            .enum_("constants") [
+                // What the coroutine waits for
+                luabind::value("WAIT_FRAME", COROUTINE_WAIT_FRAME),
+                luabind::value("WAIT_TIME", COROUTINE_WAIT_TIME),
+                luabind::value("WAIT_EVENT", COROUTINE_WAIT_EVENT),
+                luabind::value("WAIT_SPRITE", COROUTINE_WAIT_SPRITE),
+                luabind::value("WAIT_DIALOGUE", COROUTINE_WAIT_DIALOGUE)
+            ]
+        ];
+
         luabind::module(vt_script::ScriptManager->GetGlobalState(), "vt_map")
         [
             luabind::class_<SpriteEvent, MapEvent>("SpriteEvent")
@@ -758,6 +787,7 @@ void BindModeCode()
             .def("AreActorStatesPaused", &BattleMode::AreActorStatesPaused)
             .def("IsInSceneMode", &BattleMode::IsInSceneMode)
             .def("SetSceneMode", &BattleMode::SetSceneMode)
+            .def("SetBackgroundDirty", &BattleMode::SetBackgroundDirty)
             .def("GetState", &BattleMode::GetState)
             .def("ChangeState", &BattleMode::ChangeState)
             .def("OpenCommandMenu", &BattleMode::OpenCommandMenu)
@@ -771,6 +801,7 @@ void BindModeCode()
             .def("TriggerBattleParticleEffect", &BattleMode::TriggerBattleParticleEffect)
             .def("CreateBattleAnimation", &BattleMode::CreateBattleAnimation)
             .def("BoostHeroPartyInitiative", &BattleMode::BoostHeroPartyInitiative)
+            .def("SetAutoBattleActive", &BattleMode::SetAutoBattleActive)
             .def("BoostEnemyPartyInitiative", &BattleMode::BoostEnemyPartyInitiative)
 
             // Namespace constants
@@ -133,6 +133,14 @@ void PauseMode::Reset()
     VideoManager->DisableFadeEffect();
 }
 
+bool PauseMode::IsIdle() const
+{
+    if(_option_selected)
+        return false;
+
+    return !_quit_state || (!_options_handler.IsActive() && !_quit_options.IsScrolling());
+}
+
 void PauseMode::Update()
 {
     // If an option has been selected, don't handle input until it has finished.
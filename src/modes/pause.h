@@ -78,6 +78,9 @@ public:
     //! \brief Reload the different translated texts
     void ReloadTranslatedTexts();
 
+    //! \brief The pause screen is still, unless a menu is scrolling or opened.
+    bool IsIdle() const;
+
 private:
     //! \brief When true, the player is presented with quit options. When false, "Paused" is displayed on the screen
     bool _quit_state;
@@ -170,6 +170,18 @@ SaveMode::SaveMode(bool save_mode, uint32_t x_position, uint32_t y_position) :
     _no_valid_saves_message.SetTextAlignment(VIDEO_X_CENTER, VIDEO_Y_BOTTOM);
     _no_valid_saves_message.SetDisplayText(UTranslate("No valid saves found!"));
 
+    // An autosave may still be written when entering.
+    _autosave_message.SetPosition(centered_text_xpos, 650.0f);
+    _autosave_message.SetDimensions(centered_text_width, 30.0f);
+    _autosave_message.SetTextStyle(TextStyle("text20"));
+    _autosave_message.SetAlignment(VIDEO_X_LEFT, VIDEO_Y_CENTER);
+    _autosave_message.SetTextAlignment(VIDEO_X_CENTER, VIDEO_Y_CENTER);
+    if (GlobalManager->IsAutoSaving())
+        _autosave_message.SetDisplayText(UTranslate("Auto-saving..."));
+    GlobalManager->SetAutoSaveCallback([this](bool success) {
+        _OnAutoSaveDone(success);
+    });
+
     // Initialize the save preview text boxes
     _map_name_textbox.SetPosition(600.0f, 580.0f);
     _map_name_textbox.SetDimensions(320.0f, 26.0f);
@@ -222,6 +234,8 @@ SaveMode::SaveMode(bool save_mode, uint32_t x_position, uint32_t y_position) :
 
 SaveMode::~SaveMode()
 {
+    GlobalManager->SetAutoSaveCallback(std::function<void(bool)>());
+
     _window.Destroy();
 
     _left_window.Destroy();
@@ -437,6 +451,9 @@ void SaveMode::DrawPostEffects()
 
         _map_name_textbox.Draw();
 
+        if (!_autosave_message.IsEmpty())
+            _autosave_message.Draw();
+
         if (_time_textbox.IsEmpty() || _drunes_textbox.IsEmpty())
             break;
 
@@ -470,32 +487,33 @@ void SaveMode::DrawPostEffects()
 
 bool SaveMode::_LoadGame(const std::string& filename)
 {
-    if(DoesFileExist(filename)) {
+    if(DoesFileExist(filename) || DoesFileExist(vt_global::GetBinarySaveFilename(filename))) {
         _current_state = SAVE_MODE_FADING_OUT;
         AudioManager->StopActiveMusic();
 
         GlobalManager->LoadGame(filename, _file_list.GetSelection());
 
-        // Create a new map mode, and fade out and in
+        // Create a new map mode once faded out, and fade in
         ModeManager->PopAll();
 
         MapDataHandler& map_data = GlobalManager->GetMapData();
-        try {
-            // Save and restore stamina at load time
-            MapMode* MM = new MapMode(map_data.GetMapDataFilename(),
-                                      map_data.GetMapScriptFilename(),
-                                      map_data.GetSaveStamina(),
-                                      false);
-            ModeManager->Push(MM, true, true);
-        } catch(const luabind::error& e) {
-            PRINT_ERROR << "Map::_Load -- Error loading map data "
-                        << map_data.GetMapDataFilename()
-                        << ", script: " << map_data.GetMapScriptFilename()
-                        << ", returning to BootMode." << std::endl
-                        << "Exception message:" << std::endl;
-            ScriptManager->HandleLuaError(e);
-            ModeManager->Push(new BootMode(), true, true);
-        }
+        const std::string map_data_filename = map_data.GetMapDataFilename();
+        const std::string map_script_filename = map_data.GetMapScriptFilename();
+        // Save and restore stamina at load time
+        const uint32_t stamina = map_data.GetSaveStamina();
+        ModeManager->Push([map_data_filename, map_script_filename, stamina]() -> GameMode* {
+            try {
+                return new MapMode(map_data_filename, map_script_filename, stamina, false);
+            } catch(const luabind::error& e) {
+                PRINT_ERROR << "Map::_Load -- Error loading map data "
+                            << map_data_filename
+                            << ", script: " << map_script_filename
+                            << ", returning to BootMode." << std::endl
+                            << "Exception message:" << std::endl;
+                ScriptManager->HandleLuaError(e);
+                return new BootMode();
+            }
+        }, MapMode::StartLoading(map_data_filename, map_script_filename), true, true);
         return true;
     } else {
         PRINT_ERROR << "BOOT: No saved game file exists, can not load game: "
@@ -505,6 +523,33 @@ bool SaveMode::_LoadGame(const std::string& filename)
 }
 
 
+void SaveMode::_OnAutoSaveDone(bool success)
+{
+    if (success)
+        _autosave_message.ClearText();
+    else
+        _autosave_message.SetDisplayText(UTranslate("Auto-save failed!"));
+
+    // Only the load mode shows the autosaves.
+    if (!success || _save_mode)
+        return;
+
+    // Add the key to the slot now having a valid autosave.
+    uint32_t id = GlobalManager->GetGameSlotId();
+    if (id >= _file_list.GetNumberOptions() || _file_list.GetEmbeddedImage(id) != nullptr)
+        return;
+
+    if (_IsAutoSaveValid(id)) {
+        _file_list.AddOptionElementImage(id, GlobalManager->Media().GetKeyItemIcon());
+        _file_list.GetEmbeddedImage(id)->SetHeightKeepRatio(25);
+        _file_list.AddOptionElementPosition(id, 30);
+    }
+
+    // Checking the autosave previewed it.
+    if (_file_list.GetSelection() > -1)
+        _PreviewGame(_BuildSaveFilename(_file_list.GetSelection()));
+}
+
 void SaveMode::_ClearSaveData(bool selected_file_exists)
 {
     if (selected_file_exists) {
@@ -537,26 +582,56 @@ void AddEp1ToMapPath(std::string& map_filename)
 
 bool SaveMode::_PreviewGame(const std::string& filename)
 {
+    // The preview file is enough when it is up to date.
+    SavePreview preview;
+    if (preview.LoadFile(filename))
+        return _ShowPreview(preview);
+
+    // Otherwise, prefer the binary saved game, when it is up to date.
+    vt_global::SaveFileReader binary_file;
+    if (vt_global::OpenBinarySaveFile(binary_file, filename)) {
+        if (!_ReadBinaryPreview(binary_file, preview)) {
+            PRINT_WARNING << "Invalid binary saved game file: " << binary_file.GetFilename() << std::endl;
+            _ClearSaveData(true);
+            return false;
+        }
+    }
     // Check for the file existence, prevents a useless warning
-    if(!vt_utils::DoesFileExist(filename)) {
+    else if (!vt_utils::DoesFileExist(filename)) {
         _ClearSaveData(false);
         return false;
     }
+    else if (!_ReadLuaPreview(filename, preview)) {
+        _ClearSaveData(true);
+        return false;
+    }
 
+    if (!_ReadMapPreview(preview)) {
+        _ClearSaveData(true);
+        return false;
+    }
+
+    // Write the missing preview, for the next times.
+    preview.SetFileSizes(filename);
+    preview.SaveFile(filename);
+
+    return _ShowPreview(preview);
+}
+
+bool SaveMode::_ReadLuaPreview(const std::string& filename, SavePreview& preview)
+{
     ReadScriptDescriptor file;
 
     // Clear out the save data namespace to avoid loading false information
     // when dealing with a save game that has an invalid namespace
     ScriptManager->DropGlobalTable("save_game1");
+    OwnScriptTablespace("save_game1");
 
-    if(!file.OpenFile(filename)) {
-        _ClearSaveData(true);
+    if(!file.OpenFile(filename))
         return false;
-    }
 
     if(!file.DoesTableExist("save_game1")) {
         file.CloseFile();
-        _ClearSaveData(true);
         return false;
     }
 
@@ -564,35 +639,17 @@ bool SaveMode::_PreviewGame(const std::string& filename)
     file.OpenTable("save_game1");
 
     // The map file, tested after the save game is closed.
-    std::string map_script_filename = file.ReadString("map_script_filename");
-    std::string map_data_filename = file.ReadString("map_data_filename");
-
-    // DEPRECATED: Remove this after episode II release
-    if (!vt_utils::DoesFileExist(map_data_filename)) {
-        AddEp1ToMapPath(map_data_filename);
-    }
-    if(!vt_utils::DoesFileExist(map_script_filename)) {
-        AddEp1ToMapPath(map_script_filename);
-    }
-
-    // Check whether the map data file is available
-    if (!vt_utils::DoesFileExist(map_data_filename)) {
-        file.CloseTable(); // save_game1
-        file.CloseFile();
-        _ClearSaveData(true);
-        return false;
-    }
+    preview.map_script_filename = file.ReadString("map_script_filename");
+    preview.map_data_filename = file.ReadString("map_data_filename");
 
-    // Used to store temp data to populate text boxes
-    int32_t hours = file.ReadInt("play_hours");
-    int32_t minutes = file.ReadInt("play_minutes");
-    int32_t seconds = file.ReadInt("play_seconds");
-    int32_t drunes = file.ReadInt("drunes");
+    preview.play_hours = file.ReadUInt("play_hours");
+    preview.play_minutes = file.ReadUInt("play_minutes");
+    preview.play_seconds = file.ReadUInt("play_seconds");
+    preview.drunes = file.ReadUInt("drunes");
 
     if(!file.DoesTableExist("characters")) {
         file.CloseTable(); // save_game1
         file.CloseFile();
-        _ClearSaveData(true);
         return false;
     }
 
@@ -602,32 +659,26 @@ bool SaveMode::_PreviewGame(const std::string& filename)
     file.ReadUIntVector("order", char_ids);
 
     // Loads only up to the first four slots (Visible battle characters)
-    // i < char_ids.size() &&
-    for(uint32_t i = 0; i < CHARACTERS_SHOWN_SLOTS; ++i) {
-        // Create a new GlobalCharacter object using the provided id
-        // This loads all of the character's "static" data, such as their name, etc.
-
+    for(uint32_t i = 0; i < char_ids.size() && i < CHARACTERS_SHOWN_SLOTS; ++i) {
         // Don't show characters when there are none
-        if (i >= char_ids.size() || !file.DoesTableExist(char_ids[i])) {
-            _character_window[i].SetCharacter(nullptr);
-            continue;
-        }
+        if (!file.DoesTableExist(char_ids[i]))
+            break;
 
         file.OpenTable(char_ids[i]);
 
         // Read in all of the character's stats data
-        GlobalCharacter character = GlobalCharacter(char_ids[i], false);
-        character.SetExperienceLevel(file.ReadUInt("experience_level"));
-        character.SetTotalExperiencePoints(file.ReadUInt("total_experience_points"));
-        character.SetUnspentExperiencePoints(file.ReadUInt("unspent_experience_points"));
-        character.AddExperienceForNextLevel(file.ReadUInt("experience_points_next"));
-
-        character.SetMaxHitPoints(file.ReadUInt("max_hit_points"));
-        character.SetHitPoints(file.ReadUInt("hit_points"));
-        character.SetMaxSkillPoints(file.ReadUInt("max_skill_points"));
-        character.SetSkillPoints(file.ReadUInt("skill_points"));
-
-        _character_window[i].SetCharacter(&character);
+        SavePreviewCharacter character;
+        character.id = char_ids[i];
+        character.experience_level = file.ReadUInt("experience_level");
+        character.total_experience_points = file.ReadUInt("total_experience_points");
+        character.unspent_experience_points = file.ReadUInt("unspent_experience_points");
+        character.experience_for_next_level = file.ReadUInt("experience_points_next");
+
+        character.max_hit_points = file.ReadUInt("max_hit_points");
+        character.hit_points = file.ReadUInt("hit_points");
+        character.max_skill_points = file.ReadUInt("max_skill_points");
+        character.skill_points = file.ReadUInt("skill_points");
+        preview.characters.push_back(character);
 
         file.CloseTable(); // character id
     }
@@ -643,48 +694,128 @@ bool SaveMode::_PreviewGame(const std::string& filename)
     file.CloseTable(); // save_game1
     file.CloseFile();
 
-    std::ostringstream time_text;
-    time_text << (hours < 10 ? "0" : "") << static_cast<uint32_t>(hours) << ":";
-    time_text << (minutes < 10 ? "0" : "") << static_cast<uint32_t>(minutes) << ":";
-    time_text << (seconds < 10 ? "0" : "") << static_cast<uint32_t>(seconds);
-    _time_textbox.SetDisplayText(MakeUnicodeString(time_text.str()));
+    return true;
+}
 
-    std::ostringstream drunes_amount;
-    drunes_amount << drunes;
-    _drunes_textbox.SetDisplayText(MakeUnicodeString(drunes_amount.str()));
+bool SaveMode::_ReadBinaryPreview(vt_global::SaveFileReader& file, SavePreview& preview)
+{
+    if (!file.OpenSection(vt_global::SAVE_SECTION_PLAY_DATA))
+        return false;
+    preview.play_hours = static_cast<uint32_t>(file.ReadUInt());
+    preview.play_minutes = static_cast<uint32_t>(file.ReadUInt());
+    preview.play_seconds = static_cast<uint32_t>(file.ReadUInt());
+    preview.drunes = static_cast<uint32_t>(file.ReadUInt());
+
+    if (!file.OpenSection(vt_global::SAVE_SECTION_MAP_DATA))
+        return false;
+    preview.map_data_filename = file.ReadString();
+    preview.map_script_filename = file.ReadString();
+
+    if (!file.OpenSection(vt_global::SAVE_SECTION_CHARACTERS))
+        return false;
+
+    // The characters are saved in the party order, one after the other.
+    const uint64_t character_count = file.ReadUInt();
+    for(uint32_t i = 0; i < character_count && i < CHARACTERS_SHOWN_SLOTS && !file.IsErrorDetected(); ++i) {
+        uint32_t id = static_cast<uint32_t>(file.ReadUInt());
+        GlobalCharacter character = GlobalCharacter(id, false);
+        if (!character.LoadCharacter(file))
+            return false;
+        preview.AddCharacter(character);
+    }
+
+    return !file.IsErrorDetected();
+}
 
-    // Test the map file
+bool SaveMode::_ReadMapPreview(SavePreview& preview)
+{
+    std::string map_script_filename = preview.map_script_filename;
+    // DEPRECATED: Remove this after episode II release
+    if(!vt_utils::DoesFileExist(map_script_filename)) {
+        AddEp1ToMapPath(map_script_filename);
+    }
 
     // Tests the map file and gets the untranslated map hud name from it.
     ReadScriptDescriptor map_file;
 
-    if(!map_file.OpenFile(map_script_filename)) {
-        _ClearSaveData(true);
+    if(!map_file.OpenFile(map_script_filename))
         return false;
+
+    // The previewed map scripts are run into their tablespace, dropped with the save mode.
+    const std::string tablespace = map_file.OpenTablespace();
+    if (tablespace.empty()) {
+        map_file.CloseFile();
+        return false;
+    }
+    OwnScriptTablespace(tablespace);
+
+    // Read the in-game location of the save, and its potential image.
+    preview.map_name = map_file.ReadString("map_name");
+    preview.map_image_filename = map_file.ReadString("map_image_filename");
+
+    map_file.CloseTable(); // Tablespace
+    map_file.CloseFile();
+
+    return true;
+}
+
+bool SaveMode::_ShowPreview(const SavePreview& preview)
+{
+    std::string map_data_filename = preview.map_data_filename;
+    // DEPRECATED: Remove this after episode II release
+    if (!vt_utils::DoesFileExist(map_data_filename)) {
+        AddEp1ToMapPath(map_data_filename);
     }
 
-    if (map_file.OpenTablespace().empty()) {
+    // Check whether the map data file is available
+    if (!vt_utils::DoesFileExist(map_data_filename)) {
         _ClearSaveData(true);
-        map_file.CloseFile();
         return false;
     }
 
-    // Read the in-game location of the save
-    std::string map_hud_name = map_file.ReadString("map_name");
-    _map_name_textbox.SetDisplayText(UTranslate(map_hud_name));
+    std::ostringstream time_text;
+    time_text << (preview.play_hours < 10 ? "0" : "") << preview.play_hours << ":";
+    time_text << (preview.play_minutes < 10 ? "0" : "") << preview.play_minutes << ":";
+    time_text << (preview.play_seconds < 10 ? "0" : "") << preview.play_seconds;
+    _time_textbox.SetDisplayText(MakeUnicodeString(time_text.str()));
+
+    std::ostringstream drunes_amount;
+    drunes_amount << preview.drunes;
+    _drunes_textbox.SetDisplayText(MakeUnicodeString(drunes_amount.str()));
+
+    _map_name_textbox.SetDisplayText(preview.map_name.empty() ? ustring() : UTranslate(preview.map_name));
 
     // Loads the potential location image
-    std::string map_image_filename = map_file.ReadString("map_image_filename");
-    if (map_image_filename.empty()) {
+    if (preview.map_image_filename.empty()) {
         _location_image.Clear();
     }
     else {
-        if (_location_image.Load(map_image_filename))
+        if (_location_image.Load(preview.map_image_filename))
             _location_image.SetHeightKeepRatio(105.0f);
     }
 
-    map_file.CloseTable(); // Tablespace
-    map_file.CloseFile();
+    for(uint32_t i = 0; i < CHARACTERS_SHOWN_SLOTS; ++i) {
+        // Don't show characters when there are none
+        if (i >= preview.characters.size()) {
+            _character_window[i].SetCharacter(nullptr);
+            continue;
+        }
+
+        // This loads all of the character's "static" data, such as their name, etc.
+        const SavePreviewCharacter& data = preview.characters[i];
+        GlobalCharacter character = GlobalCharacter(data.id, false);
+        character.SetExperienceLevel(data.experience_level);
+        character.SetTotalExperiencePoints(data.total_experience_points);
+        character.SetUnspentExperiencePoints(data.unspent_experience_points);
+        character.AddExperienceForNextLevel(data.experience_for_next_level);
+
+        character.SetMaxHitPoints(data.max_hit_points);
+        character.SetHitPoints(data.hit_points);
+        character.SetMaxSkillPoints(data.max_skill_points);
+        character.SetSkillPoints(data.skill_points);
+
+        _character_window[i].SetCharacter(&character);
+    }
 
     return true;
 }
@@ -693,11 +824,16 @@ bool SaveMode::_IsAutoSaveValid(uint32_t id)
 {
     std::string autosave_filename = _BuildSaveFilename(id, true);
     std::string save_filename = _BuildSaveFilename(id, false);
-    if (!vt_utils::DoesFileExist(autosave_filename) || !vt_utils::DoesFileExist(save_filename))
+
+    // The autosaves are written as binary files only, older ones being Lua files.
+    std::string autosave_file = vt_global::GetBinarySaveFilename(autosave_filename);
+    if (!vt_utils::DoesFileExist(autosave_file))
+        autosave_file = autosave_filename;
+    if (!vt_utils::DoesFileExist(autosave_file) || !vt_utils::DoesFileExist(save_filename))
         return false;
 
     // Check whether the autosave is strictly more recent than the save.
-    if (vt_utils::GetFileModTime(autosave_filename) <= vt_utils::GetFileModTime(_BuildSaveFilename(id)))
+    if (vt_utils::GetFileModTime(autosave_file) <= vt_utils::GetFileModTime(save_filename))
         return false;
 
     // And check whether the autosave is valid.
@@ -754,8 +890,13 @@ std::string SaveMode::_BuildSaveFilename(uint32_t id, bool autosave)
 
 void SaveMode::_DeleteAutoSave(uint32_t id)
 {
+    // Don't let an autosave being written come back afterwards.
+    GlobalManager->WaitForAutoSave();
+
     std::string filename = _BuildSaveFilename(id, true);
     vt_utils::DeleteAFile(filename.c_str());
+    vt_utils::DeleteAFile(vt_global::GetBinarySaveFilename(filename).c_str());
+    vt_utils::DeleteAFile(vt_global::GetSavePreviewFilename(filename).c_str());
 }
 
 } // namespace vt_save
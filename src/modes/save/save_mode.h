@@ -27,6 +27,12 @@
 #include "common/gui/option.h"
 #include "common/character_window.h"
 
+namespace vt_global
+{
+class SaveFileReader;
+class SavePreview;
+}
+
 //! \brief All calls to save mode are wrapped in this namespace.
 namespace vt_save
 {
@@ -67,6 +73,21 @@ private:
     //! \brief Loads preview data for the highlighted game
     bool _PreviewGame(const std::string& filename);
 
+    //! \brief Reads the preview data from a saved game file, when there is no preview file.
+    //! \return false if the saved game is invalid.
+    bool _ReadLuaPreview(const std::string& filename, vt_global::SavePreview& preview);
+    bool _ReadBinaryPreview(vt_global::SaveFileReader& file, vt_global::SavePreview& preview);
+
+    //! \brief Reads the map name and image of a preview from the map script.
+    bool _ReadMapPreview(vt_global::SavePreview& preview);
+
+    //! \brief Shows a previewed game.
+    //! \return false if the map files are invalid. The preview is cleared then.
+    bool _ShowPreview(const vt_global::SavePreview& preview);
+
+    //! \brief Called once an autosave being written is done.
+    void _OnAutoSaveDone(bool success);
+
     //! \brief Clears out the data saves. Used especially when the data is invalid.
     //! \param selected_file_exists Tells whether the selected file exists.
     void _ClearSaveData(bool selected_file_exists);
@@ -124,6 +145,9 @@ private:
     //! \brief Tells the user no saves are valid.
     vt_gui::TextBox _no_valid_saves_message;
 
+    //! \brief Tells the user an autosave is being written, or failed.
+    vt_gui::TextBox _autosave_message;
+
     //! \brief Displays preview info for highlighted game
     vt_gui::TextBox _map_name_textbox;
     vt_gui::TextBox _time_textbox;
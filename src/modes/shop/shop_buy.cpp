@@ -245,16 +245,16 @@ void BuyInterface::Reinitialize()
         }
     }
 
-    // Create the buy displays using the object data that is now ready
-    for(uint32_t i = 0; i < _list_displays.size(); ++i) {
+    // Fill the displays using the object data that is now ready. The existing displays are kept,
+    // so that only the entries which changed get refreshed.
+    for(uint32_t i = object_data.size(); i < _list_displays.size(); ++i)
         delete _list_displays[i];
-    }
-    _list_displays.clear();
+    _list_displays.resize(object_data.size(), nullptr);
 
     for(uint32_t i = 0; i < object_data.size(); ++i) {
-        BuyListDisplay *new_list = new BuyListDisplay();
-        new_list->PopulateList(object_data[i]);
-        _list_displays.push_back(new_list);
+        if(_list_displays[i] == nullptr)
+            _list_displays[i] = new BuyListDisplay();
+        _list_displays[i]->PopulateList(object_data[i]);
     }
 
     if(_number_categories > 0)
@@ -280,13 +280,9 @@ void BuyInterface::MakeActive()
 
 void BuyInterface::TransactionNotification()
 {
+    // The lists are refilled and their selection reset there.
     Reinitialize();
 
-    for(uint32_t i = 0; i < _list_displays.size(); ++i) {
-        _list_displays[i]->ReconstructList();
-        _list_displays[i]->ResetSelection();
-    }
-
     _current_category = _number_categories > 0 ? _number_categories - 1 : 0;
     _view_mode = SHOP_VIEW_MODE_LIST;
 }
@@ -491,37 +487,16 @@ bool BuyInterface::_ChangeSelection(bool up_or_down)
 // ***** BuyListDisplay class methods
 // *****************************************************************************
 
-void BuyListDisplay::ReconstructList()
+void BuyListDisplay::_GetPropertyTexts(ShopObject* object, std::vector<ustring>& texts)
 {
-    _identify_list.ClearOptions();
-    _property_list.ClearOptions();
-
-    for(uint32_t i = 0; i < _objects.size(); i++) {
-        ShopObject* obj = _objects[i];
-        // Add an entry with the icon image of the object (scaled down by 4x to 30x30 pixels) followed by the object name
-        if (obj->GetObject()->GetIconImage().GetFilename().empty()) {
-            _identify_list.AddOption(MakeUnicodeString("<30>") + obj->GetObject()->GetName());
-        }
-        else {
-            _identify_list.AddOption(MakeUnicodeString("<" + obj->GetObject()->GetIconImage().GetFilename() + "><30>")
-                                     + obj->GetObject()->GetName());
-            _identify_list.GetEmbeddedImage(i)->SetDimensions(30.0f, 30.0f);
-        }
-
-        // Add an option for each object property in the order of: price, stock, and number owned.
-        _property_list.AddOption(MakeUnicodeString(NumberToString(obj->GetBuyPrice())));
-        if (obj->IsInfiniteAmount())
-            _property_list.AddOption(MakeUnicodeString("∞"));
-        else
-            _property_list.AddOption(MakeUnicodeString("×" + NumberToString(obj->GetStockCount())));
-        uint32_t own_count = GlobalManager->GetInventoryHandler().HowManyObjectsInInventory(obj->GetObject()->GetID());
-        _property_list.AddOption(MakeUnicodeString("×" + NumberToString(own_count)));
-    }
-
-    if(_objects.empty() == false) {
-        _identify_list.SetSelection(0);
-        _property_list.SetSelection(0);
-    }
+    // Add the properties in the order of: price, stock, and number owned.
+    texts.push_back(MakeUnicodeString(NumberToString(object->GetBuyPrice())));
+    if (object->IsInfiniteAmount())
+        texts.push_back(MakeUnicodeString("∞"));
+    else
+        texts.push_back(MakeUnicodeString("×" + NumberToString(object->GetStockCount())));
+    uint32_t own_count = GlobalManager->GetInventoryHandler().HowManyObjectsInInventory(object->GetObject()->GetID());
+    texts.push_back(MakeUnicodeString("×" + NumberToString(own_count)));
 }
 
 
@@ -157,9 +157,6 @@ public:
     ~BuyListDisplay()
     {}
 
-    //! \brief Reconstructs all option box entries from the object data
-    void ReconstructList();
-
     /** \brief Changes the buy count of the selected object, refreshes the list entry, and updates financial totals
     *** \param less_or_more False to decrease the quantity, true to increase it
     *** \param amount The amount to decrease/increase the quantity by (default value == 1)
@@ -170,6 +167,9 @@ public:
     *** the quantity by 6 (not 10) and return true.
     **/
     bool ChangeBuyQuantity(bool less_or_more, uint32_t amount = 1);
+
+protected:
+    void _GetPropertyTexts(ShopObject* object, std::vector<vt_utils::ustring>& texts);
 }; // class BuyListDisplay : public ObjectListDisplay
 
 } // namespace private_shop
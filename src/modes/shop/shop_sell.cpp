@@ -253,13 +253,16 @@ void SellInterface::Reinitialize()
 {
     _RefreshItemCategories();
 
-    // (Re)create the sell displays and populate them with the object data
-    for(uint32_t i = 0; i < _list_displays.size(); ++i)
+    // Create the missing sell displays and populate them with the object data.
+    // The existing displays are kept, so that only the entries which changed get refreshed.
+    for(uint32_t i = _number_categories; i < _list_displays.size(); ++i)
         delete _list_displays[i];
-    _list_displays.clear();
+    _list_displays.resize(_number_categories, nullptr);
 
-    for(uint32_t i = 0; i < _number_categories; ++i)
-        _list_displays.push_back(new SellListDisplay());
+    for(uint32_t i = 0; i < _number_categories; ++i) {
+        if(_list_displays[i] == nullptr)
+            _list_displays[i] = new SellListDisplay();
+    }
 
     _PopulateLists();
 
@@ -488,32 +491,11 @@ bool SellInterface::_ChangeSelection(bool down)
 // ***** SellListDisplay class methods
 // *****************************************************************************
 
-void SellListDisplay::ReconstructList()
+void SellListDisplay::_GetPropertyTexts(ShopObject* object, std::vector<ustring>& texts)
 {
-    _identify_list.ClearOptions();
-    _property_list.ClearOptions();
-
-    for(uint32_t i = 0; i < _objects.size(); i++) {
-        ShopObject* obj = _objects[i];
-        // Add an entry with the icon image of the object (scaled down by 4x to 30x30 pixels) followed by the object name
-        if (obj->GetObject()->GetIconImage().GetFilename().empty()) {
-            _identify_list.AddOption(MakeUnicodeString("<30>") + obj->GetObject()->GetName());
-        }
-        else {
-            _identify_list.AddOption(MakeUnicodeString("<" + obj->GetObject()->GetIconImage().GetFilename() + "><30>")
-                                     + obj->GetObject()->GetName());
-            _identify_list.GetEmbeddedImage(i)->SetDimensions(30.0f, 30.0f);
-        }
-
-        // Add an option for each object property in the order of: price, and number owned.
-        _property_list.AddOption(MakeUnicodeString(NumberToString(obj->GetSellPrice())));
-        _property_list.AddOption(MakeUnicodeString("×" + NumberToString(obj->GetOwnCount())));
-    }
-
-    if(_objects.empty() == false) {
-        _identify_list.SetSelection(0);
-        _property_list.SetSelection(0);
-    }
+    // Add the properties in the order of: price, and number owned.
+    texts.push_back(MakeUnicodeString(NumberToString(object->GetSellPrice())));
+    texts.push_back(MakeUnicodeString("×" + NumberToString(object->GetOwnCount())));
 }
 
 
@@ -173,9 +173,6 @@ public:
     ~SellListDisplay()
     {}
 
-    //! \brief Reconstructs all option box entries from the object data
-    void ReconstructList();
-
     /** \brief Changes the sell count of the selected object, refreshes the list entry, and updates financial totals
     *** \param less_or_more False to decrease the quantity, true to increase it
     *** \param amount The amount to decrease/increase the quantity by (default value == 1)
@@ -186,6 +183,9 @@ public:
     *** the quantity by 3 (not 8) and return true.
     **/
     bool ChangeSellQuantity(bool more, uint32_t amount = 1);
+
+protected:
+    void _GetPropertyTexts(ShopObject* object, std::vector<vt_utils::ustring>& texts);
 }; // class SellListDisplay : public ObjectListDisplay
 
 } // namespace private_shop
@@ -492,16 +492,75 @@ ObjectListDisplay::ObjectListDisplay()
 void ObjectListDisplay::Clear()
 {
     _objects.clear();
+    _property_texts.clear();
     _identify_list.ClearOptions();
     _property_list.ClearOptions();
 }
 
 void ObjectListDisplay::PopulateList(const std::vector<ShopObject *>& objects)
 {
+    // The identify entries, with their embedded icons, are the costly ones to rebuild.
+    if(objects == _objects && !_objects.empty()) {
+        RefreshProperties();
+        ResetSelection();
+        return;
+    }
+
     _objects = objects;
     ReconstructList();
 }
 
+void ObjectListDisplay::ReconstructList()
+{
+    _identify_list.ClearOptions();
+    _property_list.ClearOptions();
+    _property_texts.clear();
+
+    for(uint32_t i = 0; i < _objects.size(); ++i) {
+        ShopObject* obj = _objects[i];
+        // Add an entry with the icon image of the object (scaled down by 4x to 30x30 pixels) followed by the object name
+        if (obj->GetObject()->GetIconImage().GetFilename().empty()) {
+            _identify_list.AddOption(MakeUnicodeString("<30>") + obj->GetObject()->GetName());
+        }
+        else {
+            _identify_list.AddOption(MakeUnicodeString("<" + obj->GetObject()->GetIconImage().GetFilename() + "><30>")
+                                     + obj->GetObject()->GetName());
+            _identify_list.GetEmbeddedImage(i)->SetDimensions(30.0f, 30.0f);
+        }
+
+        _GetPropertyTexts(obj, _property_texts);
+    }
+
+    for(uint32_t i = 0; i < _property_texts.size(); ++i)
+        _property_list.AddOption(_property_texts[i]);
+
+    if(_objects.empty() == false) {
+        _identify_list.SetSelection(0);
+        _property_list.SetSelection(0);
+    }
+}
+
+void ObjectListDisplay::RefreshProperties()
+{
+    std::vector<ustring> property_texts;
+    property_texts.reserve(_property_texts.size());
+    for(uint32_t i = 0; i < _objects.size(); ++i)
+        _GetPropertyTexts(_objects[i], property_texts);
+
+    if(property_texts.size() != _property_texts.size()) {
+        IF_PRINT_WARNING(SHOP_DEBUG) << "the number of properties changed, reconstructing the list" << std::endl;
+        ReconstructList();
+        return;
+    }
+
+    for(uint32_t i = 0; i < property_texts.size(); ++i) {
+        if(property_texts[i] == _property_texts[i])
+            continue;
+        _property_list.SetOptionText(i, property_texts[i]);
+        _property_texts[i] = property_texts[i];
+    }
+}
+
 ShopObject *ObjectListDisplay::GetSelectedObject()
 {
     if(IsListEmpty())
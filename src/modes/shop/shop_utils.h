@@ -392,9 +392,8 @@ protected:
 *** where a row represents a single object, the identify list has only a single column
 *** while the property list has four columns.
 ***
-*** The deriving class determines what data is placed in both the identify and property
-*** lists. It will define the ReconstructList() and RefreshEntry() methods to achieve
-*** this. The lists are always drawn on the right side of the middle shop window and
+*** The deriving class determines what data is placed in the property list, by
+*** defining the _GetPropertyTexts() method. The lists are always drawn on the right side of the middle shop window and
 *** display no more than eight entries at a time. If desired, a deriving class can
 *** retrieve references to the OptionBox objects representing both lists in this class
 *** and change their default properties to fit one's needs.
@@ -419,13 +418,18 @@ public:
     **/
     void Clear();
 
-    /** \brief Clears the lists and then reconstructs them using the option box data given
+    /** \brief Fills the lists with the given objects and resets the selection
     *** \param objects A reference to a data vector containing the objects to populate the list with
+    *** When the objects are the ones already listed, in the same order, only the property
+    *** entries which changed are refreshed.
     **/
     void PopulateList(const std::vector<ShopObject *>& objects);
 
     //! \brief Reconstructs all option box entries from the object data
-    virtual void ReconstructList() = 0;
+    void ReconstructList();
+
+    //! \brief Refreshes the property entries whose text changed since they were set
+    void RefreshProperties();
 
     /** \brief Returns a pointer to the currently selected shop object
     *** This method may return nullptr if the current selection is invalid or the _objects container is empty
@@ -477,6 +481,15 @@ protected:
 
     //! \brief Contains properties about the object such as price, stock, amount owned, or amount to buy/sell
     vt_gui::OptionBox _property_list;
+
+    //! \brief The texts of the property list entries, to only refresh the ones which changed
+    std::vector<vt_utils::ustring> _property_texts;
+
+    /** \brief Gives the property texts of an object, in the property list column order
+    *** \param object The object to describe
+    *** \param texts The container to append the texts to
+    **/
+    virtual void _GetPropertyTexts(ShopObject* object, std::vector<vt_utils::ustring>& texts) = 0;
 }; // class ObjectListDisplay
 
 } // namespace private_shop
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+#
+# This code is licensed under the GNU GPL version 2. It is free software
+# and you may modify it and/or redistribute it under the terms of this license.
+# See http://www.gnu.org/copyleft/gpl.html for details.
+
+"""Bakes map data Lua files into the binary files loaded by BinaryMapData.
+
+Each baked file is written next to its map data file, with the .vtmap
+extension, and is used by the game as long as it is newer than the Lua file.
+Bake the maps again after editing them, or simply delete their baked file:
+
+    tools/bake-map-data.py data/story
+
+Only the lines written by the map editor are understood, the other ones
+are ignored. The format is described in src/modes/map/map_binary_data.h.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+EXIT_FAILURE = 1
+
+# Must match BINARY_MAP_DATA_VERSION.
+FORMAT_VERSION = 1
+MAGIC = b'VTMAPBIN'
+HEADER_SIZE = 48
+
+TILES_PER_TILESET = 256
+
+NUMBER_LINE = re.compile(r'^map_data\.(num_tile_cols|num_tile_rows)\s*=\s*(\d+)\s*$')
+TILESET_LINE = re.compile(r'^map_data\.tileset_filenames\[(\d+)\]\s*=\s*"([^"]*)"\s*$')
+GRID_LINE = re.compile(r'^map_data\.map_grid\[(\d+)\]\s*=\s*\{([^}]*)\}\s*$')
+LAYER_TYPE_LINE = re.compile(r'^map_data\.layers\[(\d+)\]\.type\s*=\s*"([^"]*)"\s*$')
+LAYER_ROW_LINE = re.compile(r'^map_data\.layers\[(\d+)\]\[(\d+)\]\s*=\s*\{([^}]*)\}\s*$')
+
+
+class MapDataError(Exception):
+    pass
+
+
+def _parse_values(text):
+    return [int(value) for value in text.split(',') if value.strip()]
+
+
+def _sequence(table, first, name):
+    """Returns the values of a Lua table indexed from first, checking there is no gap."""
+    for index in range(first, first + len(table)):
+        if index not in table:
+            raise MapDataError('missing %s[%d]' % (name, index))
+    return [table[index] for index in range(first, first + len(table))]
+
+
+def _parse_map_data(filename):
+    numbers, tilesets, grid, layer_types, layer_rows = {}, {}, {}, {}, {}
+    with open(filename) as map_file:
+        for line in map_file:
+            line = line.strip()
+            match = NUMBER_LINE.match(line)
+            if match:
+                numbers[match.group(1)] = int(match.group(2))
+                continue
+            match = TILESET_LINE.match(line)
+            if match:
+                tilesets[int(match.group(1))] = match.group(2)
+                continue
+            match = GRID_LINE.match(line)
+            if match:
+                grid[int(match.group(1))] = _parse_values(match.group(2))
+                continue
+            match = LAYER_TYPE_LINE.match(line)
+            if match:
+                layer_types[int(match.group(1))] = match.group(2)
+                continue
+            match = LAYER_ROW_LINE.match(line)
+            if match:
+                layer_rows.setdefault(int(match.group(1)), {})[int(match.group(2))] = _parse_values(match.group(3))
+
+    if 'num_tile_cols' not in numbers or 'num_tile_rows' not in numbers:
+        raise MapDataError('no map size')
+    columns, rows = numbers['num_tile_cols'], numbers['num_tile_rows']
+    if columns == 0 or rows == 0:
+        raise MapDataError('empty map')
+
+    # The Lua tileset table starts at 1, while the grid and layers start at 0.
+    tilesets = _sequence(tilesets, 1, 'tileset_filenames')
+    grid = _sequence(grid, 0, 'map_grid')
+    if len(grid) != rows * 2 or any(len(row) != columns * 2 for row in grid):
+        raise MapDataError('the map grid size is not twice the tile size')
+
+    layers = []
+    for layer_id, layer_type in enumerate(_sequence(layer_types, 0, 'layers')):
+        tiles = _sequence(layer_rows.get(layer_id, {}), 0, 'layers[%d]' % layer_id)
+        if len(tiles) != rows or any(len(row) != columns for row in tiles):
+            raise MapDataError('the layers[%d] size is not the map size' % layer_id)
+        for row in tiles:
+            if any(tile < -1 or tile >= len(tilesets) * TILES_PER_TILESET for tile in row):
+                raise MapDataError('invalid tile index in layers[%d]' % layer_id)
+        layers.append((layer_type, tiles))
+
+    return columns, rows, tilesets, grid, layers
+
+
+def _pad(data):
+    return data + b'\0' * (-len(data) % 8)
+
+
+def _pack_string(text):
+    encoded = text.encode('utf-8')
+    return _pad(struct.pack('<I', len(encoded)) + encoded)
+
+
+def _pack_grid(grid):
+    row_words = (len(grid[0]) + 63) // 64
+    data = bytearray()
+    for row in grid:
+        words = [0] * row_words
+        for x, value in enumerate(row):
+            if value > 0:
+                words[x // 64] |= 1 << (x % 64)
+        data += struct.pack('<%dQ' % row_words, *words)
+    return bytes(data)
+
+
+def bake(filename):
+    columns, rows, tilesets, grid, layers = _parse_map_data(filename)
+
+    body = b''.join(_pack_string(tileset) for tileset in tilesets)
+    for layer_type, tiles in layers:
+        body += _pack_string(layer_type)
+        body += _pad(b''.join(struct.pack('<%dh' % columns, *row) for row in tiles))
+    body += _pack_grid(grid)
+
+    size = HEADER_SIZE + len(body)
+    header = MAGIC + struct.pack('<9I', FORMAT_VERSION, columns, rows, columns * 2, rows * 2,
+                                 len(tilesets), len(layers), size, 0)
+    header += b'\0' * (HEADER_SIZE - len(header))
+
+    output = os.path.splitext(filename)[0] + '.vtmap'
+    with open(output, 'wb') as baked_file:
+        baked_file.write(header + body)
+    return output
+
+
+def _list_map_data_files(paths):
+    filenames = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                filenames.extend(os.path.join(root, f) for f in files if f.endswith('_map.lua'))
+        elif os.path.isfile(path):
+            filenames.append(path)
+        else:
+            sys.stderr.write('%s does not exist!\n' % path)
+            sys.exit(EXIT_FAILURE)
+    return sorted(set(filenames))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Bakes map data Lua files into binary files.')
+    parser.add_argument('paths', nargs='+', help='the map data files, or directories of *_map.lua files, to bake')
+    args = parser.parse_args()
+
+    failures = 0
+    for filename in _list_map_data_files(args.paths):
+        try:
+            print('Baked %s' % bake(filename))
+        except MapDataError as error:
+            sys.stderr.write('Skipping %s: %s\n' % (filename, error))
+            failures += 1
+
+    if failures:
+        sys.exit(EXIT_FAILURE)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+#
+# This code is licensed under the GNU GPL version 2. It is free software
+# and you may modify it and/or redistribute it under the terms of this license.
+# See http://www.gnu.org/copyleft/gpl.html for details.
+
+"""Bakes image files into a texture atlas loaded by TextureController::LoadTextureAtlas().
+
+The atlas is made of a PNG image, packing all the images, and of a Lua
+manifest telling where each image lies in it. Run it from the game root
+directory, so that the image filenames match the ones used by the game:
+
+    tools/bake-texture-atlas.py -o data/atlases/village data/entities/map/objects
+
+A map script loads it by listing it in its texture_atlases table:
+
+    texture_atlases = { "data/atlases/village.lua" }
+
+Any other game mode script may call LoadTextureAtlas() on its game mode.
+The atlas stays loaded as long as the game mode which loaded it.
+
+The images larger than 512 pixels are skipped, as the game gives them
+their own texture sheet anyway. Requires Pillow.
+"""
+
+import argparse
+import os
+import sys
+
+from PIL import Image
+
+EXIT_FAILURE = 1
+
+# The biggest image the game shares a texture sheet with others.
+MAX_IMAGE_SIZE = 512
+
+
+class Packer:
+    """Packs rectangles with the MaxRects algorithm, like VariableTexSheet does."""
+
+    def __init__(self, width, height):
+        self.free_rects = [(0, 0, width, height)]
+
+    def insert(self, width, height):
+        """Returns the best position for a rectangle, or None if it doesn't fit."""
+        best = None
+        best_score = None
+        for (x, y, w, h) in self.free_rects:
+            if w < width or h < height:
+                continue
+            leftover_x, leftover_y = w - width, h - height
+            score = (min(leftover_x, leftover_y), max(leftover_x, leftover_y))
+            if best_score is None or score < best_score:
+                best, best_score = (x, y), score
+
+        if best is not None:
+            self._place((best[0], best[1], width, height))
+        return best
+
+    def _place(self, used):
+        ux, uy, uw, uh = used
+        kept, split = [], []
+        for rect in self.free_rects:
+            x, y, w, h = rect
+            if ux >= x + w or x >= ux + uw or uy >= y + h or y >= uy + uh:
+                kept.append(rect)
+                continue
+            if ux > x:
+                split.append((x, y, ux - x, h))
+            if ux + uw < x + w:
+                split.append((ux + uw, y, x + w - ux - uw, h))
+            if uy > y:
+                split.append((x, y, w, uy - y))
+            if uy + uh < y + h:
+                split.append((x, uy + uh, w, y + h - uy - uh))
+
+        rects = kept + split
+        self.free_rects = [r for i, r in enumerate(rects)
+                           if not any(j != i and _contains(o, r) and (j < i or not _contains(r, o))
+                                      for j, o in enumerate(rects))]
+
+
+def _contains(outer, inner):
+    return (inner[0] >= outer[0] and inner[1] >= outer[1] and
+            inner[0] + inner[2] <= outer[0] + outer[2] and
+            inner[1] + inner[3] <= outer[1] + outer[3])
+
+
+def _list_images(paths):
+    filenames = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                filenames.extend(os.path.join(root, f) for f in files if f.lower().endswith('.png'))
+        elif os.path.isfile(path):
+            filenames.append(path)
+        else:
+            sys.stderr.write('%s does not exist!\n' % path)
+            sys.exit(EXIT_FAILURE)
+    # The game uses forward slashes whatever the platform.
+    return sorted(set(f.replace(os.sep, '/') for f in filenames))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Bakes image files into a texture atlas.')
+    parser.add_argument('-o', '--output', required=True,
+                        help='the atlas path without extension, e.g. data/atlases/village')
+    parser.add_argument('-s', '--size', type=int, default=1024,
+                        help='the width and height of the atlas, a power of two (default: 1024)')
+    parser.add_argument('paths', nargs='+', help='the image files, or directories of PNG files, to bake')
+    args = parser.parse_args()
+
+    if args.size <= 0 or args.size & (args.size - 1):
+        sys.stderr.write('The atlas size must be a power of two.\n')
+        sys.exit(EXIT_FAILURE)
+
+    images = []
+    for filename in _list_images(args.paths):
+        image = Image.open(filename).convert('RGBA')
+        if image.width > MAX_IMAGE_SIZE or image.height > MAX_IMAGE_SIZE:
+            print('Skipping %s: larger than %d pixels' % (filename, MAX_IMAGE_SIZE))
+            continue
+        images.append((filename, image))
+
+    # Packing the biggest images first leaves the least wasted space.
+    images.sort(key=lambda item: (max(item[1].width, item[1].height), item[1].width * item[1].height),
+                reverse=True)
+
+    packer = Packer(args.size, args.size)
+    atlas = Image.new('RGBA', (args.size, args.size), (0, 0, 0, 0))
+    placed = []
+    for filename, image in images:
+        position = packer.insert(image.width, image.height)
+        if position is None:
+            print('Skipping %s: the atlas is full' % filename)
+            continue
+        atlas.paste(image, position)
+        placed.append((filename, position, image.size))
+
+    image_filename = args.output + '.png'
+    atlas.save(image_filename)
+
+    with open(args.output + '.lua', 'w') as manifest:
+        manifest.write('-- Texture atlas baked by tools/bake-texture-atlas.py\n')
+        manifest.write('-- Loaded with TextureController::LoadTextureAtlas(). Do not edit.\n\n')
+        manifest.write('atlas = {\n')
+        manifest.write('    image_filename = "%s",\n' % image_filename.replace(os.sep, '/'))
+        manifest.write('    images = {\n')
+        for filename, (x, y), (width, height) in sorted(placed):
+            manifest.write('        ["%s"] = { x = %d, y = %d, width = %d, height = %d },\n'
+                           % (filename, x, y, width, height))
+        manifest.write('    }\n')
+        manifest.write('}\n')
+
+    used_area = sum(width * height for _, _, (width, height) in placed)
+    print('Baked %d of %d images, %.0f%% of the atlas used.'
+          % (len(placed), len(images), 100.0 * used_area / (args.size * args.size)))
+
+
+if __name__ == '__main__':
+    main()
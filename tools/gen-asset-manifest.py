@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+#
+# This code is licensed under the GNU GPL version 2. It is free software
+# and you may modify it and/or redistribute it under the terms of this license.
+# See http://www.gnu.org/copyleft/gpl.html for details.
+
+"""Generates the assets manifest of the maps, and of the battles started from them.
+
+Each map script is scanned for the files it names, and for the sprites and
+objects it creates, whose images and animations are read from
+data/entities/map_sprites.lua and data/entities/map_objects.lua. The battle
+backgrounds, music and scripts it sets, and the files named by those scripts,
+are listed for the battles started from the map:
+
+    tools/gen-asset-manifest.py data data/config/asset_manifest.lua
+
+The assets loaded while playing can be recorded with --record-assets, and
+merged in the manifest, to list the ones no script names literally:
+
+    valyriatear --record-assets assets.tsv
+    tools/gen-asset-manifest.py --recording assets.tsv data data/config/asset_manifest.lua
+
+The manifest is read by src/engine/asset_manifest.cpp.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+EXIT_FAILURE = 1
+
+# Must match GetAssetTypeName() order.
+ASSET_TYPES = ('images', 'animations', 'particle_effects', 'sounds', 'music', 'scripts')
+
+FILE_LITERAL = re.compile(r'"(data/[^"]+\.(?:png|jpg|ogg|wav|lua))"')
+ENTITY_CREATION = re.compile(r'Create(Sprite|Object)\(\s*Map\s*,\s*"([^"]+)"')
+ENTITY_DEFINITION = re.compile(r'^(sprites|objects)\["([^"]+)"\]\s*=\s*{', re.MULTILINE)
+BATTLE_ASSET = re.compile(r'(SetBattleBackground|SetBattleMusicTheme|AddBattleScript)\(\s*"([^"]+)"')
+
+PARTICLE_EFFECTS_DIR = 'data/visuals/particle_effects/'
+MUSIC_DIR = 'data/music/'
+
+
+def _read(filename):
+    with open(filename, encoding='utf-8', errors='replace') as file:
+        return file.read()
+
+
+def _classify(path, root_dir):
+    """Returns the (asset type, file) of a file named by a script, none when it doesn't exist."""
+    filename = os.path.join(root_dir, path)
+    if not os.path.isfile(filename):
+        return []
+
+    extension = os.path.splitext(path)[1].lower()
+    if extension in ('.png', '.jpg'):
+        return [('images', path)]
+    if extension in ('.ogg', '.wav'):
+        return [('music' if path.startswith(MUSIC_DIR) else 'sounds', path)]
+
+    if path.startswith(PARTICLE_EFFECTS_DIR):
+        return [('particle_effects', path)]
+    content = _read(filename)
+    if re.search(r'^\s*animation\s*=', content, re.MULTILINE):
+        return [('animations', path)]
+    # The map sprites animations have their own format: Only their images are prefetched.
+    if re.search(r'^\s*sprite_animation\s*=', content, re.MULTILINE):
+        return [('images', image) for image in FILE_LITERAL.findall(content)
+                if image.endswith(('.png', '.jpg')) and os.path.isfile(os.path.join(root_dir, image))]
+    if re.search(r'^\s*systems\s*=', content, re.MULTILINE):
+        return [('particle_effects', path)]
+    return [('scripts', path)]
+
+
+def _read_entity_files(root_dir):
+    """Returns the files named by each sprite and object definition, by name."""
+    entities = {}
+    for entity_file in ('data/entities/map_sprites.lua', 'data/entities/map_objects.lua'):
+        filename = os.path.join(root_dir, entity_file)
+        if not os.path.isfile(filename):
+            continue
+        content = _read(filename)
+        definitions = list(ENTITY_DEFINITION.finditer(content))
+        for i, definition in enumerate(definitions):
+            end = definitions[i + 1].start() if i + 1 < len(definitions) else len(content)
+            entities[definition.group(2)] = FILE_LITERAL.findall(content[definition.end():end])
+    return entities
+
+
+def _add(manifest, key, path, root_dir):
+    for asset_type, asset in _classify(path, root_dir):
+        manifest.setdefault(key, {}).setdefault(asset_type, set()).add(asset)
+
+
+def scan_map_scripts(data_dir, root_dir):
+    """Returns the manifest of the map scripts found, by manifest key."""
+    entities = _read_entity_files(root_dir)
+    manifest = {}
+    for directory, _, filenames in os.walk(os.path.join(data_dir, 'story')):
+        for filename in sorted(filenames):
+            if not filename.endswith('_script.lua'):
+                continue
+            path = os.path.join(directory, filename)
+            script = os.path.relpath(path, root_dir).replace(os.sep, '/')
+            content = _read(path)
+
+            # Only the map scripts are keyed, as the others are loaded by them.
+            if 'function Load(m)' not in content:
+                continue
+            key = 'map:' + script
+            battle_key = 'battle:' + script
+            for function, asset in BATTLE_ASSET.findall(content):
+                _add(manifest, battle_key, asset, root_dir)
+                battle_script = os.path.join(root_dir, asset)
+                if function == 'AddBattleScript' and os.path.isfile(battle_script):
+                    for battle_asset in FILE_LITERAL.findall(_read(battle_script)):
+                        _add(manifest, battle_key, battle_asset, root_dir)
+
+            for asset in FILE_LITERAL.findall(BATTLE_ASSET.sub('', content)):
+                _add(manifest, key, asset, root_dir)
+            for _, name in ENTITY_CREATION.findall(content):
+                for asset in entities.get(name, ()):
+                    _add(manifest, key, asset, root_dir)
+    return manifest
+
+
+def merge_recording(manifest, recording_filename, root_dir):
+    """Adds the "key<TAB>type<TAB>file" lines written by --record-assets."""
+    count = 0
+    for line in _read(recording_filename).splitlines():
+        fields = line.split('\t')
+        if len(fields) != 3 or fields[1] not in ASSET_TYPES:
+            continue
+        if not os.path.isfile(os.path.join(root_dir, fields[2])):
+            continue
+        manifest.setdefault(fields[0], {}).setdefault(fields[1], set()).add(fields[2])
+        count += 1
+    return count
+
+
+def write_manifest(manifest, manifest_filename):
+    with open(manifest_filename, 'w', encoding='utf-8') as file:
+        file.write('-- Generated by tools/gen-asset-manifest.py: Edit the map scripts, or record the assets, instead.\n\n')
+        file.write('asset_manifest = {\n')
+        for key in sorted(manifest):
+            file.write('    ["%s"] = {\n' % key)
+            for asset_type in ASSET_TYPES:
+                assets = manifest[key].get(asset_type)
+                if not assets:
+                    continue
+                file.write('        %s = {\n' % asset_type)
+                for asset in sorted(assets):
+                    file.write('            "%s",\n' % asset)
+                file.write('        },\n')
+            file.write('    },\n')
+        file.write('}\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--recording', action='append', default=[],
+                        help='an assets recording written by --record-assets, to merge')
+    parser.add_argument('data_dir', help='the data folder to scan')
+    parser.add_argument('manifest', help='the manifest to write, usually data/config/asset_manifest.lua')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.data_dir):
+        print('Not a folder: ' + args.data_dir, file=sys.stderr)
+        return EXIT_FAILURE
+    root_dir = os.path.dirname(os.path.abspath(args.data_dir))
+
+    manifest = scan_map_scripts(args.data_dir, root_dir)
+    for recording in args.recording:
+        if not os.path.isfile(recording):
+            print('No such recording: ' + recording, file=sys.stderr)
+            return EXIT_FAILURE
+        print('Merged %d recorded assets from %s' % (merge_recording(manifest, recording, root_dir), recording))
+
+    write_manifest(manifest, args.manifest)
+    asset_count = sum(len(assets) for entry in manifest.values() for assets in entry.values())
+    print('Listed %d assets of %d maps and battles in %s' % (asset_count, len(manifest), args.manifest))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
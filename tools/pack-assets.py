@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+#
+# This code is licensed under the GNU GPL version 2. It is free software
+# and you may modify it and/or redistribute it under the terms of this license.
+# See http://www.gnu.org/copyleft/gpl.html for details.
+
+"""Packs the images, fonts and sounds of the data folder into the asset archive.
+
+The archive is memory mapped by the game at startup, when found next to the
+data folder, and its files are then used instead of the loose ones. Pack the
+assets again after editing them, or simply delete the archive:
+
+    tools/pack-assets.py data data.vtassets
+
+The Lua files aren't packed, as the script engine reads them from the disk.
+The format is described in src/engine/asset_archive.h.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+EXIT_FAILURE = 1
+
+# Must match ASSET_ARCHIVE_VERSION.
+FORMAT_VERSION = 1
+MAGIC = b'VTASSETS'
+HEADER_SIZE = 32
+ALIGNMENT = 8
+
+PACKED_EXTENSIONS = ('.png', '.jpg', '.ttf', '.otf', '.ogg', '.wav')
+
+
+def _padding(size):
+    return (ALIGNMENT - size % ALIGNMENT) % ALIGNMENT
+
+
+def _find_assets(data_dir, root_dir):
+    """Returns the (archive path, file path) of the files to pack, sorted by archive path."""
+    assets = []
+    for directory, _, filenames in os.walk(data_dir):
+        for filename in filenames:
+            if not filename.lower().endswith(PACKED_EXTENSIONS):
+                continue
+            path = os.path.join(directory, filename)
+            archive_path = os.path.relpath(path, root_dir).replace(os.sep, '/')
+            assets.append((archive_path, path))
+    assets.sort()
+    return assets
+
+
+def pack_assets(data_dir, archive_filename):
+    root_dir = os.path.dirname(os.path.abspath(data_dir))
+    assets = _find_assets(data_dir, root_dir)
+
+    index = []
+    with open(archive_filename, 'wb') as archive:
+        archive.write(b'\0' * HEADER_SIZE)
+        offset = HEADER_SIZE
+        for archive_path, path in assets:
+            with open(path, 'rb') as asset:
+                content = asset.read()
+            archive.write(content)
+            archive.write(b'\0' * _padding(len(content)))
+            index.append((offset, len(content), archive_path.encode('utf-8')))
+            offset += len(content) + _padding(len(content))
+
+        index_offset = offset
+        for content_offset, content_size, archive_path in index:
+            archive.write(struct.pack('<QQI', content_offset, content_size, len(archive_path)))
+            archive.write(archive_path)
+            offset += 20 + len(archive_path)
+
+        archive.seek(0)
+        archive.write(MAGIC + struct.pack('<IIQQ', FORMAT_VERSION, len(index), index_offset, offset))
+
+    return len(index), offset
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('data_dir', help='the data folder to pack')
+    parser.add_argument('archive', help='the archive to write, usually data.vtassets next to the data folder')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.data_dir):
+        print('Not a folder: ' + args.data_dir, file=sys.stderr)
+        return EXIT_FAILURE
+
+    file_count, size = pack_assets(args.data_dir, args.archive)
+    print('Packed %d files in %s (%.1f MB)' % (file_count, args.archive, size / (1024.0 * 1024.0)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2012-2016 by Bertram (Valyria Tear)
+#
+# This code is licensed under the GNU GPL version 2. It is free software
+# and you may modify it and/or redistribute it under the terms of this license.
+# See http://www.gnu.org/copyleft/gpl.html for details.
+
+"""Simulates battle series in parallel, to tune the enemies and skills.
+
+Every combination of saved game (the party build), enemy set and difficulty
+is simulated with the game --simulate-battles option. The battles of each
+combination are split in chunks run by as many game processes as there are
+cores, each one having its own Lua state and random streams. The chunks use
+consecutive random seeds, so the results don't depend on the number of jobs:
+
+    tools/simulate-battles.py --saves party1.lua party2.lua \\
+        --enemies "1 2" "3" --difficulties 1 2 3 --battles 1000 \\
+        --csv results.csv --json results.json
+
+Run it from the directory holding the game data. The game still needs to
+create a hidden window, so use a virtual display (Xvfb) on a server.
+"""
+
+import argparse
+import concurrent.futures
+import csv
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+EXIT_FAILURE = 1
+
+
+class SimulationError(Exception):
+    pass
+
+
+def _run_chunk(game, save, enemies, difficulty, battles, seed, results_dir):
+    """Runs a game process simulating a chunk of battles, and returns its results."""
+    results_filename = os.path.join(results_dir, 'results-%s.json' % seed)
+    command = [game, '--simulate-battles', save, enemies, str(battles),
+               '--random-seed', str(seed), '--simulation-results', results_filename]
+    if difficulty:
+        command += ['--simulation-difficulty', str(difficulty)]
+
+    process = subprocess.run(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                             universal_newlines=True)
+    if process.returncode != 0:
+        raise SimulationError('%s failed: %s' % (' '.join(command), process.stderr.strip()))
+
+    with open(results_filename) as results_file:
+        return json.load(results_file)
+
+
+def _average(values):
+    return sum(values) / len(values) if values else 0.0
+
+
+def _percentile(sorted_values, ratio):
+    return sorted_values[int(len(sorted_values) * ratio)] if sorted_values else 0
+
+
+def _aggregate(save, enemies, difficulty, chunks):
+    """Merges the results of the chunks of a combination into a single row."""
+    def merged(key):
+        return [value for chunk in chunks for value in chunk[key]]
+
+    battles = sum(chunk['battles'] for chunk in chunks)
+    victories = sum(chunk['victories'] for chunk in chunks)
+    row = {
+        'save': save,
+        'enemies': enemies,
+        'difficulty': chunks[0]['difficulty'] if chunks else difficulty,
+        'battles': battles,
+        'victories': victories,
+        'defeats': sum(chunk['defeats'] for chunk in chunks),
+        'timeouts': sum(chunk['timeouts'] for chunk in chunks),
+        'win_rate': victories / battles if battles else 0.0,
+        'character_actions': _average(merged('character_actions')),
+        'enemy_actions': _average(merged('enemy_actions')),
+        'duration_seconds': _average(merged('durations')) / 1000.0,
+    }
+    for side in ('damage_to_enemies', 'damage_to_characters'):
+        hits = sorted(merged(side))
+        row[side + '_hits'] = len(hits)
+        row[side + '_average'] = _average(hits)
+        row[side + '_p10'] = _percentile(hits, 0.1)
+        row[side + '_median'] = _percentile(hits, 0.5)
+        row[side + '_p90'] = _percentile(hits, 0.9)
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--game', default='./valyriatear', help='the game executable')
+    parser.add_argument('--saves', nargs='+', required=True, help='the saved games giving the parties')
+    parser.add_argument('--enemies', nargs='+', required=True,
+                        help='the enemy sets, as space separated enemy ids')
+    parser.add_argument('--difficulties', nargs='+', type=int, default=[0],
+                        help='the game difficulties, from 1 to 3 (default: the settings one)')
+    parser.add_argument('--battles', type=int, default=1000, help='the battles of each combination')
+    parser.add_argument('--chunk', type=int, default=50, help='the battles simulated by each game process')
+    parser.add_argument('--seed', type=int, default=1, help='the random seed of the first battle')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1,
+                        help='the game processes run at once')
+    parser.add_argument('--csv', help='the CSV file to write the results in')
+    parser.add_argument('--json', help='the JSON file to write the results in')
+    args = parser.parse_args()
+
+    if args.battles <= 0 or args.chunk <= 0 or args.jobs <= 0:
+        parser.error('the battles, chunk and jobs must be positive')
+
+    combinations = [(save, enemies, difficulty) for save in args.saves
+                    for enemies in args.enemies for difficulty in args.difficulties]
+
+    rows = []
+    with tempfile.TemporaryDirectory() as results_dir:
+        with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+            futures = {}
+            for index, combination in enumerate(combinations):
+                # Each combination gets its own seed range, whatever the chunking.
+                first_seed = args.seed + index * args.battles
+                for start in range(0, args.battles, args.chunk):
+                    battles = min(args.chunk, args.battles - start)
+                    future = executor.submit(_run_chunk, args.game, *combination, battles=battles,
+                                             seed=first_seed + start, results_dir=results_dir)
+                    futures[future] = combination
+
+            chunks = dict((combination, []) for combination in combinations)
+            try:
+                for future in concurrent.futures.as_completed(futures):
+                    chunks[futures[future]].append(future.result())
+            except SimulationError as error:
+                for future in futures:
+                    future.cancel()
+                print(error, file=sys.stderr)
+                return EXIT_FAILURE
+
+        for combination in combinations:
+            rows.append(_aggregate(*combination, chunks=chunks[combination]))
+
+    for row in rows:
+        print('%s vs [%s], difficulty %s: %.1f%% victories over %d battles, %.1f s on average' %
+              (row['save'], row['enemies'], row['difficulty'], 100.0 * row['win_rate'],
+               row['battles'], row['duration_seconds']))
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as csv_file:
+            writer = csv.DictWriter(csv_file, fieldnames=list(rows[0].keys()))
+            writer.writeheader()
+            writer.writerows(rows)
+    if args.json:
+        with open(args.json, 'w') as json_file:
+            json.dump(rows, json_file, indent=2)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())